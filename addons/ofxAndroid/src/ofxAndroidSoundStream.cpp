@@ -11,9 +11,17 @@
 #include "ofUtils.h"
 #include "ofxAndroidUtils.h"
 #include "ofAppRunner.h"
+#include "ofMath.h"
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <set>
 #include <jni.h>
+#include <dlfcn.h>
+#include <sys/system_properties.h>
+#include <aaudio/AAudio.h>
+#include <SLES/OpenSLES.h>
+#include <SLES/OpenSLES_Android.h>
 
 using namespace std;
 
@@ -21,6 +29,517 @@ using namespace std;
 static ofxAndroidSoundStream* instance = NULL;
 static bool headphonesConnected = false;
 
+//--------------------------------------------------------------
+// native backends, both call nativeAudioCallback() from their audio thread
+struct ofxAndroidSoundStream::NativeBackend{
+	NativeBackend(ofxAndroidSoundStream & stream, const ofSoundStreamSettings & settings)
+	:stream(stream)
+	,settings(settings)
+	,disconnected(false){}
+
+	virtual ~NativeBackend(){}
+	virtual bool open() = 0;
+	virtual bool start() = 0;
+	virtual void stop() = 0;
+	virtual void close() = 0;
+	virtual int getSampleRate() const = 0;
+
+	ofxAndroidSoundStream & stream;
+	ofSoundStreamSettings settings;
+	// set from the audio thread when the device is gone, the stream is
+	// reopened from the main thread
+	std::atomic<bool> disconnected;
+};
+
+namespace{
+	int getAndroidApiLevel(){
+		char sdk[PROP_VALUE_MAX] = {0};
+		if(__system_property_get("ro.build.version.sdk", sdk) == 0){
+			return 0;
+		}
+		return atoi(sdk);
+	}
+
+	// AAudio is loaded at runtime so apps still run on devices older
+	// than 8.0, where libaaudio doesn't exist
+	struct AAudioApi{
+		aaudio_result_t (*createStreamBuilder)(AAudioStreamBuilder **);
+		void (*setDirection)(AAudioStreamBuilder *, aaudio_direction_t);
+		void (*setSampleRate)(AAudioStreamBuilder *, int32_t);
+		void (*setChannelCount)(AAudioStreamBuilder *, int32_t);
+		void (*setFormat)(AAudioStreamBuilder *, aaudio_format_t);
+		void (*setSharingMode)(AAudioStreamBuilder *, aaudio_sharing_mode_t);
+		void (*setPerformanceMode)(AAudioStreamBuilder *, aaudio_performance_mode_t);
+		void (*setFramesPerDataCallback)(AAudioStreamBuilder *, int32_t);
+		void (*setDataCallback)(AAudioStreamBuilder *, AAudioStream_dataCallback, void *);
+		void (*setErrorCallback)(AAudioStreamBuilder *, AAudioStream_errorCallback, void *);
+		aaudio_result_t (*openStream)(AAudioStreamBuilder *, AAudioStream **);
+		aaudio_result_t (*deleteBuilder)(AAudioStreamBuilder *);
+		aaudio_result_t (*requestStart)(AAudioStream *);
+		aaudio_result_t (*requestStop)(AAudioStream *);
+		aaudio_result_t (*close)(AAudioStream *);
+		aaudio_result_t (*read)(AAudioStream *, void *, int32_t, int64_t);
+		int32_t (*getSampleRate)(AAudioStream *);
+		int32_t (*getFramesPerBurst)(AAudioStream *);
+		aaudio_result_t (*setBufferSizeInFrames)(AAudioStream *, int32_t);
+		aaudio_sharing_mode_t (*getSharingMode)(AAudioStream *);
+		const char * (*convertResultToText)(aaudio_result_t);
+		bool loaded = false;
+	};
+
+	template<typename Function>
+	bool loadSymbol(void * library, const char * name, Function & function){
+		function = reinterpret_cast<Function>(dlsym(library, name));
+		return function != nullptr;
+	}
+
+	const AAudioApi & getAAudio(){
+		static AAudioApi api = []{
+			AAudioApi api;
+			// AAudio in 8.0 has known issues with low latency streams
+			if(getAndroidApiLevel() < 27){
+				return api;
+			}
+			void * library = dlopen("libaaudio.so", RTLD_NOW);
+			if(!library){
+				return api;
+			}
+			api.loaded =
+				loadSymbol(library, "AAudio_createStreamBuilder", api.createStreamBuilder) &&
+				loadSymbol(library, "AAudioStreamBuilder_setDirection", api.setDirection) &&
+				loadSymbol(library, "AAudioStreamBuilder_setSampleRate", api.setSampleRate) &&
+				loadSymbol(library, "AAudioStreamBuilder_setChannelCount", api.setChannelCount) &&
+				loadSymbol(library, "AAudioStreamBuilder_setFormat", api.setFormat) &&
+				loadSymbol(library, "AAudioStreamBuilder_setSharingMode", api.setSharingMode) &&
+				loadSymbol(library, "AAudioStreamBuilder_setPerformanceMode", api.setPerformanceMode) &&
+				loadSymbol(library, "AAudioStreamBuilder_setFramesPerDataCallback", api.setFramesPerDataCallback) &&
+				loadSymbol(library, "AAudioStreamBuilder_setDataCallback", api.setDataCallback) &&
+				loadSymbol(library, "AAudioStreamBuilder_setErrorCallback", api.setErrorCallback) &&
+				loadSymbol(library, "AAudioStreamBuilder_openStream", api.openStream) &&
+				loadSymbol(library, "AAudioStreamBuilder_delete", api.deleteBuilder) &&
+				loadSymbol(library, "AAudioStream_requestStart", api.requestStart) &&
+				loadSymbol(library, "AAudioStream_requestStop", api.requestStop) &&
+				loadSymbol(library, "AAudioStream_close", api.close) &&
+				loadSymbol(library, "AAudioStream_read", api.read) &&
+				loadSymbol(library, "AAudioStream_getSampleRate", api.getSampleRate) &&
+				loadSymbol(library, "AAudioStream_getFramesPerBurst", api.getFramesPerBurst) &&
+				loadSymbol(library, "AAudioStream_setBufferSizeInFrames", api.setBufferSizeInFrames) &&
+				loadSymbol(library, "AAudioStream_getSharingMode", api.getSharingMode) &&
+				loadSymbol(library, "AAudio_convertResultToText", api.convertResultToText);
+			return api;
+		}();
+		return api;
+	}
+}
+
+//--------------------------------------------------------------
+struct ofxAndroidSoundStream::AAudioBackend: public NativeBackend{
+	AAudioBackend(ofxAndroidSoundStream & stream, const ofSoundStreamSettings & settings)
+	:NativeBackend(stream, settings){}
+
+	~AAudioBackend(){
+		close();
+	}
+
+	AAudioStream * openStream(aaudio_direction_t direction, int numChannels, bool callback){
+		auto & api = getAAudio();
+		AAudioStreamBuilder * builder = nullptr;
+		aaudio_result_t result = api.createStreamBuilder(&builder);
+		if(result != AAUDIO_OK){
+			ofLogError("ofxAndroidSoundStream") << "setup(): couldn't create AAudio stream builder: " << api.convertResultToText(result);
+			return nullptr;
+		}
+		api.setDirection(builder, direction);
+		api.setSampleRate(builder, settings.sampleRate);
+		api.setChannelCount(builder, numChannels);
+		api.setFormat(builder, AAUDIO_FORMAT_PCM_FLOAT);
+		// falls back to shared if the device can't be opened in exclusive mode
+		api.setSharingMode(builder, AAUDIO_SHARING_MODE_EXCLUSIVE);
+		api.setPerformanceMode(builder, AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+		api.setErrorCallback(builder, &AAudioBackend::errorCallback, this);
+		if(callback){
+			api.setFramesPerDataCallback(builder, settings.bufferSize);
+			api.setDataCallback(builder, direction == AAUDIO_DIRECTION_OUTPUT ? &AAudioBackend::outputCallback : &AAudioBackend::inputCallback, this);
+		}
+		AAudioStream * audioStream = nullptr;
+		result = api.openStream(builder, &audioStream);
+		api.deleteBuilder(builder);
+		if(result != AAUDIO_OK){
+			ofLogError("ofxAndroidSoundStream") << "setup(): couldn't open AAudio stream: " << api.convertResultToText(result);
+			return nullptr;
+		}
+		int32_t burst = api.getFramesPerBurst(audioStream);
+		api.setBufferSizeInFrames(audioStream, std::max<int32_t>(burst, settings.bufferSize) * 2);
+		return audioStream;
+	}
+
+	bool open(){
+		auto & api = getAAudio();
+		if(!api.loaded){
+			return false;
+		}
+		bool hasOutput = settings.numOutputChannels > 0;
+		if(settings.numInputChannels > 0){
+			// in full duplex the input is read from the output callback so
+			// audioIn() and audioOut() are called in the same thread
+			input = openStream(AAUDIO_DIRECTION_INPUT, settings.numInputChannels, !hasOutput);
+			if(!input){
+				return false;
+			}
+			inputData.assign(settings.bufferSize * settings.numInputChannels, 0.f);
+		}
+		if(hasOutput){
+			output = openStream(AAUDIO_DIRECTION_OUTPUT, settings.numOutputChannels, true);
+			if(!output){
+				close();
+				return false;
+			}
+		}
+		AAudioStream * opened = output ? output : input;
+		if(api.getSampleRate(opened) != int(settings.sampleRate)){
+			ofLogWarning("ofxAndroidSoundStream") << "setup(): requested sample rate " << settings.sampleRate << " but got " << api.getSampleRate(opened);
+		}
+		if(api.getSharingMode(opened) != AAUDIO_SHARING_MODE_EXCLUSIVE){
+			ofLogVerbose("ofxAndroidSoundStream") << "setup(): AAudio stream opened in shared mode";
+		}
+		return true;
+	}
+
+	bool start(){
+		auto & api = getAAudio();
+		// the input starts first so there's data when the output asks for it
+		if(input && api.requestStart(input) != AAUDIO_OK){
+			return false;
+		}
+		if(output && api.requestStart(output) != AAUDIO_OK){
+			return false;
+		}
+		return true;
+	}
+
+	void stop(){
+		auto & api = getAAudio();
+		if(output){
+			api.requestStop(output);
+		}
+		if(input){
+			api.requestStop(input);
+		}
+	}
+
+	void close(){
+		auto & api = getAAudio();
+		stop();
+		if(output){
+			api.close(output);
+			output = nullptr;
+		}
+		if(input){
+			api.close(input);
+			input = nullptr;
+		}
+	}
+
+	int getSampleRate() const{
+		AAudioStream * opened = output ? output : input;
+		return opened ? getAAudio().getSampleRate(opened) : settings.sampleRate;
+	}
+
+	static aaudio_data_callback_result_t outputCallback(AAudioStream *, void * userData, void * audioData, int32_t numFrames){
+		auto backend = static_cast<AAudioBackend*>(userData);
+		const float * in = nullptr;
+		if(backend->input){
+			size_t numSamples = numFrames * backend->settings.numInputChannels;
+			if(backend->inputData.size() < numSamples){
+				backend->inputData.resize(numSamples);
+			}
+			// non blocking, whatever isn't there yet is silence
+			int32_t numRead = getAAudio().read(backend->input, backend->inputData.data(), numFrames, 0);
+			numRead = std::max<int32_t>(numRead, 0);
+			std::fill(backend->inputData.begin() + numRead * backend->settings.numInputChannels, backend->inputData.begin() + numSamples, 0.f);
+			in = backend->inputData.data();
+		}
+		backend->stream.nativeAudioCallback(in, static_cast<float*>(audioData), numFrames);
+		return AAUDIO_CALLBACK_RESULT_CONTINUE;
+	}
+
+	static aaudio_data_callback_result_t inputCallback(AAudioStream *, void * userData, void * audioData, int32_t numFrames){
+		auto backend = static_cast<AAudioBackend*>(userData);
+		backend->stream.nativeAudioCallback(static_cast<const float*>(audioData), nullptr, numFrames);
+		return AAUDIO_CALLBACK_RESULT_CONTINUE;
+	}
+
+	static void errorCallback(AAudioStream *, void * userData, aaudio_result_t error){
+		// streams can't be closed from their own callbacks
+		if(error == AAUDIO_ERROR_DISCONNECTED){
+			static_cast<AAudioBackend*>(userData)->disconnected = true;
+		}
+	}
+
+	AAudioStream * input = nullptr;
+	AAudioStream * output = nullptr;
+	std::vector<float> inputData;
+};
+
+//--------------------------------------------------------------
+struct ofxAndroidSoundStream::OpenSLBackend: public NativeBackend{
+	OpenSLBackend(ofxAndroidSoundStream & stream, const ofSoundStreamSettings & settings)
+	:NativeBackend(stream, settings)
+	,numBuffers(std::max<size_t>(settings.numBuffers, 2)){}
+
+	~OpenSLBackend(){
+		close();
+	}
+
+	static SLuint32 channelMask(int numChannels){
+		return numChannels == 1 ? SL_SPEAKER_FRONT_CENTER : SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT;
+	}
+
+	// float PCM needs android 5, older devices get 16 bits buffers that
+	// are converted in the callbacks
+	static SLAndroidDataFormat_PCM_EX pcmFormat(const ofSoundStreamSettings & settings, int numChannels, bool isFloat){
+		SLAndroidDataFormat_PCM_EX format;
+		format.formatType = SL_ANDROID_DATAFORMAT_PCM_EX;
+		format.numChannels = numChannels;
+		format.sampleRate = settings.sampleRate * 1000;
+		format.bitsPerSample = isFloat ? 32 : SL_PCMSAMPLEFORMAT_FIXED_16;
+		format.containerSize = format.bitsPerSample;
+		format.channelMask = channelMask(numChannels);
+		format.endianness = SL_BYTEORDER_LITTLEENDIAN;
+		format.representation = isFloat ? SL_ANDROID_PCM_REPRESENTATION_FLOAT : SL_ANDROID_PCM_REPRESENTATION_SIGNED_INT;
+		if(!isFloat){
+			// plain PCM is the only format understood before android 5
+			format.formatType = SL_DATAFORMAT_PCM;
+		}
+		return format;
+	}
+
+	bool openPlayer(bool isFloat){
+		SLDataLocator_AndroidSimpleBufferQueue queueLocator = {SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, SLuint32(numBuffers)};
+		auto format = pcmFormat(settings, settings.numOutputChannels, isFloat);
+		SLDataSource source = {&queueLocator, &format};
+		SLDataLocator_OutputMix mixLocator = {SL_DATALOCATOR_OUTPUTMIX, outputMix};
+		SLDataSink sink = {&mixLocator, nullptr};
+		const SLInterfaceID ids[] = {SL_IID_ANDROIDSIMPLEBUFFERQUEUE, SL_IID_ANDROIDCONFIGURATION};
+		const SLboolean required[] = {SL_BOOLEAN_TRUE, SL_BOOLEAN_FALSE};
+		if((*engine)->CreateAudioPlayer(engine, &player, &source, &sink, 2, ids, required) != SL_RESULT_SUCCESS){
+			player = nullptr;
+			return false;
+		}
+#ifdef SL_ANDROID_KEY_PERFORMANCE_MODE
+		SLAndroidConfigurationItf config;
+		if((*player)->GetInterface(player, SL_IID_ANDROIDCONFIGURATION, &config) == SL_RESULT_SUCCESS){
+			SLuint32 mode = SL_ANDROID_PERFORMANCE_LATENCY;
+			(*config)->SetConfiguration(config, SL_ANDROID_KEY_PERFORMANCE_MODE, &mode, sizeof(mode));
+		}
+#endif
+		if((*player)->Realize(player, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS ||
+		   (*player)->GetInterface(player, SL_IID_PLAY, &play) != SL_RESULT_SUCCESS ||
+		   (*player)->GetInterface(player, SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &playerQueue) != SL_RESULT_SUCCESS ||
+		   (*playerQueue)->RegisterCallback(playerQueue, &OpenSLBackend::playerCallback, this) != SL_RESULT_SUCCESS){
+			(*player)->Destroy(player);
+			player = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	bool openRecorder(bool isFloat){
+		SLDataLocator_IODevice deviceLocator = {SL_DATALOCATOR_IODEVICE, SL_IODEVICE_AUDIOINPUT, SL_DEFAULTDEVICEID_AUDIOINPUT, nullptr};
+		SLDataSource source = {&deviceLocator, nullptr};
+		SLDataLocator_AndroidSimpleBufferQueue queueLocator = {SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, SLuint32(numBuffers)};
+		auto format = pcmFormat(settings, settings.numInputChannels, isFloat);
+		SLDataSink sink = {&queueLocator, &format};
+		const SLInterfaceID ids[] = {SL_IID_ANDROIDSIMPLEBUFFERQUEUE, SL_IID_ANDROIDCONFIGURATION};
+		const SLboolean required[] = {SL_BOOLEAN_TRUE, SL_BOOLEAN_FALSE};
+		if((*engine)->CreateAudioRecorder(engine, &recorder, &source, &sink, 2, ids, required) != SL_RESULT_SUCCESS){
+			recorder = nullptr;
+			return false;
+		}
+		SLAndroidConfigurationItf config;
+		if((*recorder)->GetInterface(recorder, SL_IID_ANDROIDCONFIGURATION, &config) == SL_RESULT_SUCCESS){
+			// the preset with the least processing and latency
+			SLuint32 preset = SL_ANDROID_RECORDING_PRESET_VOICE_RECOGNITION;
+			(*config)->SetConfiguration(config, SL_ANDROID_KEY_RECORDING_PRESET, &preset, sizeof(preset));
+#ifdef SL_ANDROID_KEY_PERFORMANCE_MODE
+			SLuint32 mode = SL_ANDROID_PERFORMANCE_LATENCY;
+			(*config)->SetConfiguration(config, SL_ANDROID_KEY_PERFORMANCE_MODE, &mode, sizeof(mode));
+#endif
+		}
+		if((*recorder)->Realize(recorder, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS ||
+		   (*recorder)->GetInterface(recorder, SL_IID_RECORD, &record) != SL_RESULT_SUCCESS ||
+		   (*recorder)->GetInterface(recorder, SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &recorderQueue) != SL_RESULT_SUCCESS ||
+		   (*recorderQueue)->RegisterCallback(recorderQueue, &OpenSLBackend::recorderCallback, this) != SL_RESULT_SUCCESS){
+			(*recorder)->Destroy(recorder);
+			recorder = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	bool open(){
+		if(settings.numOutputChannels > 2 || settings.numInputChannels > 2){
+			ofLogError("ofxAndroidSoundStream") << "setup(): OpenSL ES only supports mono or stereo streams";
+			return false;
+		}
+		if(slCreateEngine(&engineObject, 0, nullptr, 0, nullptr, nullptr) != SL_RESULT_SUCCESS ||
+		   (*engineObject)->Realize(engineObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS ||
+		   (*engineObject)->GetInterface(engineObject, SL_IID_ENGINE, &engine) != SL_RESULT_SUCCESS){
+			ofLogError("ofxAndroidSoundStream") << "setup(): couldn't create OpenSL ES engine";
+			close();
+			return false;
+		}
+		if(settings.numOutputChannels > 0){
+			if((*engine)->CreateOutputMix(engine, &outputMix, 0, nullptr, nullptr) != SL_RESULT_SUCCESS ||
+			   (*outputMix)->Realize(outputMix, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS){
+				ofLogError("ofxAndroidSoundStream") << "setup(): couldn't create OpenSL ES output mix";
+				close();
+				return false;
+			}
+			outputFloat = openPlayer(true);
+			if(!outputFloat && !openPlayer(false)){
+				ofLogError("ofxAndroidSoundStream") << "setup(): couldn't create OpenSL ES player";
+				close();
+				return false;
+			}
+			outputData.assign(numBuffers * settings.bufferSize * settings.numOutputChannels, 0.f);
+			outputShorts.assign(outputFloat ? 0 : outputData.size(), 0);
+		}
+		if(settings.numInputChannels > 0){
+			inputFloat = openRecorder(true);
+			if(!inputFloat && !openRecorder(false)){
+				ofLogError("ofxAndroidSoundStream") << "setup(): couldn't create OpenSL ES recorder";
+				close();
+				return false;
+			}
+			inputData.assign(numBuffers * settings.bufferSize * settings.numInputChannels, 0.f);
+			inputShorts.assign(inputFloat ? 0 : inputData.size(), 0);
+		}
+		return true;
+	}
+
+	void * outputBuffer(size_t index){
+		size_t offset = index * settings.bufferSize * settings.numOutputChannels;
+		return outputFloat ? (void*)&outputData[offset] : (void*)&outputShorts[offset];
+	}
+
+	void * inputBuffer(size_t index){
+		size_t offset = index * settings.bufferSize * settings.numInputChannels;
+		return inputFloat ? (void*)&inputData[offset] : (void*)&inputShorts[offset];
+	}
+
+	bool start(){
+		if(recorder){
+			size_t bytes = settings.bufferSize * settings.numInputChannels * (inputFloat ? sizeof(float) : sizeof(short));
+			for(size_t i = 0; i < numBuffers; i++){
+				(*recorderQueue)->Enqueue(recorderQueue, inputBuffer(i), bytes);
+			}
+			nextInput = 0;
+			if((*record)->SetRecordState(record, SL_RECORDSTATE_RECORDING) != SL_RESULT_SUCCESS){
+				return false;
+			}
+		}
+		if(player){
+			// starts with silence, every buffer played is refilled from
+			// the callback
+			std::fill(outputData.begin(), outputData.end(), 0.f);
+			std::fill(outputShorts.begin(), outputShorts.end(), 0);
+			size_t bytes = settings.bufferSize * settings.numOutputChannels * (outputFloat ? sizeof(float) : sizeof(short));
+			for(size_t i = 0; i < numBuffers; i++){
+				(*playerQueue)->Enqueue(playerQueue, outputBuffer(i), bytes);
+			}
+			nextOutput = 0;
+			if((*play)->SetPlayState(play, SL_PLAYSTATE_PLAYING) != SL_RESULT_SUCCESS){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void stop(){
+		if(player){
+			(*play)->SetPlayState(play, SL_PLAYSTATE_STOPPED);
+			(*playerQueue)->Clear(playerQueue);
+		}
+		if(recorder){
+			(*record)->SetRecordState(record, SL_RECORDSTATE_STOPPED);
+			(*recorderQueue)->Clear(recorderQueue);
+		}
+	}
+
+	void close(){
+		if(player){
+			(*player)->Destroy(player);
+			player = nullptr;
+		}
+		if(recorder){
+			(*recorder)->Destroy(recorder);
+			recorder = nullptr;
+		}
+		if(outputMix){
+			(*outputMix)->Destroy(outputMix);
+			outputMix = nullptr;
+		}
+		if(engineObject){
+			(*engineObject)->Destroy(engineObject);
+			engineObject = nullptr;
+		}
+	}
+
+	int getSampleRate() const{
+		return settings.sampleRate;
+	}
+
+	static void playerCallback(SLAndroidSimpleBufferQueueItf queue, void * context){
+		auto backend = static_cast<OpenSLBackend*>(context);
+		size_t numSamples = backend->settings.bufferSize * backend->settings.numOutputChannels;
+		size_t offset = backend->nextOutput * numSamples;
+		float * out = &backend->outputData[offset];
+		backend->stream.nativeAudioCallback(nullptr, out, backend->settings.bufferSize);
+		if(!backend->outputFloat){
+			for(size_t i = 0; i < numSamples; i++){
+				backend->outputShorts[offset + i] = short(ofClamp(out[i], -1.f, 1.f) * 32767.f);
+			}
+		}
+		size_t bytes = numSamples * (backend->outputFloat ? sizeof(float) : sizeof(short));
+		(*queue)->Enqueue(queue, backend->outputBuffer(backend->nextOutput), bytes);
+		backend->nextOutput = (backend->nextOutput + 1) % backend->numBuffers;
+	}
+
+	static void recorderCallback(SLAndroidSimpleBufferQueueItf queue, void * context){
+		auto backend = static_cast<OpenSLBackend*>(context);
+		size_t numSamples = backend->settings.bufferSize * backend->settings.numInputChannels;
+		size_t offset = backend->nextInput * numSamples;
+		float * in = &backend->inputData[offset];
+		if(!backend->inputFloat){
+			for(size_t i = 0; i < numSamples; i++){
+				in[i] = (float(backend->inputShorts[offset + i]) + 0.5f) / 32767.5f;
+			}
+		}
+		backend->stream.nativeAudioCallback(in, nullptr, backend->settings.bufferSize);
+		size_t bytes = numSamples * (backend->inputFloat ? sizeof(float) : sizeof(short));
+		(*queue)->Enqueue(queue, backend->inputBuffer(backend->nextInput), bytes);
+		backend->nextInput = (backend->nextInput + 1) % backend->numBuffers;
+	}
+
+	size_t numBuffers;
+	SLObjectItf engineObject = nullptr;
+	SLEngineItf engine = nullptr;
+	SLObjectItf outputMix = nullptr;
+	SLObjectItf player = nullptr;
+	SLPlayItf play = nullptr;
+	SLAndroidSimpleBufferQueueItf playerQueue = nullptr;
+	SLObjectItf recorder = nullptr;
+	SLRecordItf record = nullptr;
+	SLAndroidSimpleBufferQueueItf recorderQueue = nullptr;
+	bool outputFloat = false;
+	bool inputFloat = false;
+	std::vector<float> outputData, inputData;
+	std::vector<short> outputShorts, inputShorts;
+	size_t nextOutput = 0;
+	size_t nextInput = 0;
+};
+
 ofxAndroidSoundStream::ofxAndroidSoundStream(){
 	out_buffer = NULL;
 	in_buffer = NULL;
@@ -36,15 +555,18 @@ ofxAndroidSoundStream::ofxAndroidSoundStream(){
 
 	ofAddListener(ofxAndroidEvents().pause,this,&ofxAndroidSoundStream::pause);
 	ofAddListener(ofxAndroidEvents().resume,this,&ofxAndroidSoundStream::resume);
+	ofAddListener(ofEvents().update,this,&ofxAndroidSoundStream::checkNativeBackend);
 }
 
 ofxAndroidSoundStream::~ofxAndroidSoundStream(){
+	nativeBackend.reset();
 	if(instance==this){
 		instance = NULL;
 	}
 
 	ofRemoveListener(ofxAndroidEvents().pause,this,&ofxAndroidSoundStream::pause);
 	ofRemoveListener(ofxAndroidEvents().resume,this,&ofxAndroidSoundStream::resume);
+	ofRemoveListener(ofEvents().update,this,&ofxAndroidSoundStream::checkNativeBackend);
 }
 
 std::vector<ofSoundDevice> ofxAndroidSoundStream::getDeviceList(ofSoundDevice::Api api) const{
@@ -70,11 +592,9 @@ bool ofxAndroidSoundStream::setup(const ofSoundStreamSettings & settings){
 		return false;
 	}
 
-	// Find the minimum input buffer size allowed by the Android device
-	int input_buffer_size = settings.numInputChannels*getMinInBufferSize(settings.sampleRate,settings.numInputChannels) * 2;
-	// setup size of input circular-buffer
-	input_buffer.setup(input_buffer_size,0);
-	
+	// setup() can be called again, the previous native streams are closed
+	nativeBackend.reset();
+
 	// deallocate and reallocate if setup() is called more than once
 	in_float_buffer.allocate(settings.bufferSize,settings.numInputChannels);
 	in_float_buffer.setSampleRate(settings.sampleRate);
@@ -87,6 +607,44 @@ bool ofxAndroidSoundStream::setup(const ofSoundStreamSettings & settings){
 	totalOutRequestedBufferSize = settings.bufferSize*settings.numOutputChannels;
 	totalInRequestedBufferSize = settings.bufferSize*settings.numInputChannels;
 
+	// native backends first, AAudio is only available from android 8.1
+	auto api = settings.getApi();
+	bool anyApi = api==ofSoundDevice::UNSPECIFIED || api==ofSoundDevice::DEFAULT;
+	if(anyApi || api==ofSoundDevice::ANDROID_AAUDIO){
+		nativeBackend.reset(new AAudioBackend(*this,settings));
+		if(!nativeBackend->open()){
+			nativeBackend.reset();
+		}
+	}
+	if(!nativeBackend && (anyApi || api==ofSoundDevice::ANDROID_OPENSL)){
+		nativeBackend.reset(new OpenSLBackend(*this,settings));
+		if(!nativeBackend->open()){
+			nativeBackend.reset();
+		}
+	}
+	if(nativeBackend){
+		int sampleRate = nativeBackend->getSampleRate();
+		in_float_buffer.setSampleRate(sampleRate);
+		out_float_buffer.setSampleRate(sampleRate);
+		instance = this;
+		isPaused = false;
+		if(!nativeBackend->start()){
+			ofLogError("ofxAndroidSoundStream") << "setup(): couldn't start native audio stream";
+			nativeBackend.reset();
+			return false;
+		}
+		return true;
+	}
+	if(!anyApi && api!=ofSoundDevice::ANDROID_JAVA){
+		ofLogError("ofxAndroidSoundStream") << "setup(): couldn't open stream with api " << toString(api);
+		return false;
+	}
+
+	// Find the minimum input buffer size allowed by the Android device
+	int input_buffer_size = settings.numInputChannels*getMinInBufferSize(settings.sampleRate,settings.numInputChannels) * 2;
+	// setup size of input circular-buffer
+	input_buffer.setup(input_buffer_size,0);
+
 	// JNI: Try to find and call OFAndroidSoundStream.getInstance().setup(outChannels,inChannels,sampleRate,bufferSize,nBuffers)
 	if(!ofGetJavaVMPtr()){
 		ofLogError("ofxAndroidSoundStream") << "setup(): couldn't find java virtual machine";
@@ -125,7 +683,7 @@ bool ofxAndroidSoundStream::setup(const ofSoundStreamSettings & settings){
 }
 
 void ofxAndroidSoundStream::start(){
-	if(isPaused){
+	if(isPaused || nativeBackend){
 		resume();
 	}else{
 		ofSoundStreamSettings settings;
@@ -145,6 +703,13 @@ void ofxAndroidSoundStream::stop(){
 void ofxAndroidSoundStream::close(){
 	pause();
 
+	if(nativeBackend){
+		nativeBackend.reset();
+		// so start() sets the stream up again
+		isPaused = false;
+		return;
+	}
+
 	// JNI: Try to find and call OFAndroidSoundStream.getInstance().stop()
 	if(!ofGetJavaVMPtr()){
 		ofLogError("ofxAndroidSoundStream") << "close(): couldn't find java virtual machine";
@@ -197,13 +762,76 @@ int ofxAndroidSoundStream::getBufferSize() const{
 }
 
 void ofxAndroidSoundStream::pause(){
+	// native streams are stopped so the device is released while the app
+	// is in the background
+	if(nativeBackend && !isPaused){
+		nativeBackend->stop();
+	}
 	isPaused = true;
 }
 
 void ofxAndroidSoundStream::resume(){
+	if(nativeBackend && isPaused){
+		isPaused = false;
+		if(!nativeBackend->start()){
+			ofLogError("ofxAndroidSoundStream") << "resume(): couldn't start native audio stream";
+		}
+	}
 	isPaused = false;
 }
 
+void ofxAndroidSoundStream::checkNativeBackend(ofEventArgs &){
+	if(!nativeBackend || !nativeBackend->disconnected){
+		return;
+	}
+	ofLogNotice("ofxAndroidSoundStream") << "audio device disconnected, reopening stream";
+	nativeBackend->disconnected = false;
+	nativeBackend->close();
+	if(!nativeBackend->open()){
+		ofLogError("ofxAndroidSoundStream") << "couldn't reopen native audio stream";
+		nativeBackend.reset();
+		return;
+	}
+	if(!isPaused){
+		nativeBackend->start();
+	}
+}
+
+void ofxAndroidSoundStream::nativeAudioCallback(const float * in, float * out, int numFrames){
+	if(isPaused){
+		if(out){
+			std::fill(out, out + numFrames * out_float_buffer.getNumChannels(), 0.f);
+		}
+		return;
+	}
+
+	if(in && soundInputPtr){
+		in_float_buffer.copyFrom(in,numFrames,in_float_buffer.getNumChannels(),in_float_buffer.getSampleRate());
+		in_float_buffer.setTickCount(tickCount);
+		soundInputPtr->audioIn(in_float_buffer);
+	}
+
+	if(out){
+		size_t numChannels = out_float_buffer.getNumChannels();
+		if(soundOutputPtr){
+			if(out_float_buffer.getNumFrames() != size_t(numFrames)){
+				out_float_buffer.allocate(numFrames,numChannels);
+			}
+			out_float_buffer.set(0);
+			out_float_buffer.setTickCount(tickCount);
+			soundOutputPtr->audioOut(out_float_buffer);
+			out_float_buffer.copyTo(out,numFrames,numChannels,0);
+		}else{
+			std::fill(out, out + numFrames * numChannels, 0.f);
+		}
+	}
+
+	// with separate input and output callbacks the output one counts ticks
+	if(out || out_float_buffer.getNumChannels()==0){
+		tickCount++;
+	}
+}
+
 
 static const float conv_factor = 1/32767.5f;
 
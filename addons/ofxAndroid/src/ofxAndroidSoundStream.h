@@ -6,7 +6,30 @@
 #include "ofBaseSoundStream.h"
 #include "ofxAndroidCircBuffer.h"
 #include "ofSoundBuffer.h"
+#include "ofEvents.h"
+#include <memory>
 
+/// \brief Sound stream for android
+///
+/// Audio runs natively, without going through java, using AAudio on
+/// android 8.1 and later or OpenSL ES on older devices. The buffers are
+/// float, the streams ask for the low latency (and exclusive, in AAudio)
+/// performance mode and audioIn() / audioOut() are called from the native
+/// audio thread. If neither can be opened the stream falls back to the
+/// java AudioTrack / AudioRecord implementation.
+///
+/// A backend can be forced through the settings:
+///
+/// ~~~~{.cpp}
+/// ofSoundStreamSettings settings;
+/// settings.setApi(ofSoundDevice::ANDROID_OPENSL);
+/// settings.setOutListener(this);
+/// settings.numOutputChannels = 2;
+/// soundStream.setup(settings);
+/// ~~~~
+///
+/// With the native backends numBuffers is ignored, the device buffer is
+/// kept at two callbacks of bufferSize frames.
 class ofxAndroidSoundStream : public ofBaseSoundStream{
 	public:
 		ofxAndroidSoundStream();
@@ -43,6 +66,20 @@ class ofxAndroidSoundStream : public ofBaseSoundStream{
 		ofEvent<bool> headphonesConnectedE;
 
 	private:
+		struct NativeBackend;
+		struct AAudioBackend;
+		struct OpenSLBackend;
+
+		// called by the native backends from the audio thread, in or out
+		// are null if the stream has no input or output or if they come
+		// in different callbacks
+		void nativeAudioCallback(const float * in, float * out, int numFrames);
+		// reopens the native streams from the main thread if the device
+		// was disconnected
+		void checkNativeBackend(ofEventArgs & args);
+
+		std::unique_ptr<NativeBackend> nativeBackend;
+
 		long unsigned long	tickCount;
 		// pointers to OF audio callback classes
 		ofBaseSoundInput *  soundInputPtr;
@@ -11,9 +11,70 @@
 #include "ofAppRunner.h"
 #include "ofUtils.h"
 #include "ofVideoGrabber.h"
+#include "ofGraphics.h"
+#include "ofGLUtils.h"
+#include "ofMatrix4x4.h"
+#include "ofRenderStats.h"
+#include <dlfcn.h>
 
 using namespace std;
 
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911A
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911C
+#endif
+
+namespace{
+	// the android build uses the OpenGL ES 2 headers, the pixel buffer and
+	// fence functions of OpenGL ES 3 are loaded at runtime if the context
+	// has them
+	typedef void * (*glMapBufferRangeType)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+	typedef GLboolean (*glUnmapBufferType)(GLenum target);
+	typedef void * (*glFenceSyncType)(GLenum condition, GLbitfield flags);
+	typedef GLenum (*glClientWaitSyncType)(void * sync, GLbitfield flags, uint64_t timeout);
+	typedef void (*glDeleteSyncType)(void * sync);
+
+	struct GLES3Readback{
+		glMapBufferRangeType mapBufferRange = nullptr;
+		glUnmapBufferType unmapBuffer = nullptr;
+		glFenceSyncType fenceSync = nullptr;
+		glClientWaitSyncType clientWaitSync = nullptr;
+		glDeleteSyncType deleteSync = nullptr;
+		bool loaded = false;
+	};
+
+	const GLES3Readback & getGLES3Readback(){
+		static GLES3Readback gl = []{
+			GLES3Readback gl;
+			if(!ofIsGLProgrammableRenderer() || ofGetGLRenderer()->getGLVersionMajor() < 3){
+				return gl;
+			}
+			gl.mapBufferRange = (glMapBufferRangeType)dlsym(RTLD_DEFAULT, "glMapBufferRange");
+			gl.unmapBuffer = (glUnmapBufferType)dlsym(RTLD_DEFAULT, "glUnmapBuffer");
+			gl.fenceSync = (glFenceSyncType)dlsym(RTLD_DEFAULT, "glFenceSync");
+			gl.clientWaitSync = (glClientWaitSyncType)dlsym(RTLD_DEFAULT, "glClientWaitSync");
+			gl.deleteSync = (glDeleteSyncType)dlsym(RTLD_DEFAULT, "glDeleteSync");
+			gl.loaded = gl.mapBufferRange && gl.unmapBuffer && gl.fenceSync && gl.clientWaitSync && gl.deleteSync;
+			return gl;
+		}();
+		return gl;
+	}
+}
+
 struct ofxAndroidVideoGrabber::Data{
 	bool bIsFrameNew;
 	bool bGrabberInited;
@@ -31,11 +92,27 @@ struct ofxAndroidVideoGrabber::Data{
 	int attemptFramerate;
 	jobject javaVideoGrabber;
 
+	// gpu path, see setUseFbo()
+	bool bUseFbo;
+	ofFbo fbo;
+	bool bPixelsRequested;
+	bool bPixelsNew;
+	GLuint packBuffer;
+	size_t packBufferSize;
+	void * readFence;
+	int readWidth, readHeight;
+
 	Data();
 	~Data();
 	void onAppPause();
 	void onAppResume();
 	void loadTexture();
+	void updateTextureMatrix();
+	void drawToFbo();
+	void updateReadback();
+	bool startReadback();
+	bool collectReadback();
+	void releaseReadback();
 };
 
 map<int,weak_ptr<ofxAndroidVideoGrabber::Data>> & instances(){
@@ -68,7 +145,15 @@ ofxAndroidVideoGrabber::Data::Data()
 ,newPixels(false)
 ,attemptFramerate(-1)
 ,bUsePixels(true)
-,javaVideoGrabber(nullptr){
+,javaVideoGrabber(nullptr)
+,bUseFbo(false)
+,bPixelsRequested(false)
+,bPixelsNew(false)
+,packBuffer(0)
+,packBufferSize(0)
+,readFence(nullptr)
+,readWidth(0)
+,readHeight(0){
 	JNIEnv *env = ofGetJNIEnv();
 
 	jclass javaClass = getJavaClass();
@@ -143,6 +228,114 @@ void ofxAndroidVideoGrabber::Data::loadTexture(){
 
 }
 
+void ofxAndroidVideoGrabber::Data::updateTextureMatrix(){
+	JNIEnv *env = ofGetJNIEnv();
+	jmethodID javaGetTextureMatrix = env->GetMethodID(getJavaClass(),"getTextureMatrix","([F)V");
+	if(!javaGetTextureMatrix){
+		ofLogError("ofxAndroidVideoGrabber") << "update(): couldn't get OFAndroidVideoGrabber getTextureMatrix method";
+		return;
+	}
+	env->CallVoidMethod(javaVideoGrabber,javaGetTextureMatrix,matrixJava);
+	jfloat * m = env->GetFloatArrayElements(matrixJava,0);
+
+	// the SurfaceTexture transform expects texture coordinates that start
+	// at the bottom
+	ofMatrix4x4 textureMatrix(m);
+	ofMatrix4x4 vFlipTextureMatrix;
+	vFlipTextureMatrix.scale(1,-1,1);
+	vFlipTextureMatrix.translate(0,1,0);
+	texture.setTextureMatrix(vFlipTextureMatrix * textureMatrix);
+
+	env->ReleaseFloatArrayElements(matrixJava,m,0);
+}
+
+void ofxAndroidVideoGrabber::Data::drawToFbo(){
+	if(!fbo.isAllocated() || fbo.getWidth()!=width || fbo.getHeight()!=height){
+		fbo.allocate(width,height,GL_RGBA);
+	}
+	fbo.begin();
+	ofPushStyle();
+	ofEnableBlendMode(OF_BLENDMODE_DISABLED);
+	ofSetColor(255);
+	texture.draw(0,0,width,height);
+	ofPopStyle();
+	fbo.end();
+}
+
+void ofxAndroidVideoGrabber::Data::updateReadback(){
+	bPixelsNew = false;
+	if(readFence && !collectReadback()){
+		return;
+	}
+	if(!bPixelsRequested || !fbo.isAllocated()){
+		return;
+	}
+	bPixelsRequested = false;
+	if(!startReadback()){
+		fbo.readToPixels(frontBuffer);
+		bPixelsNew = true;
+	}
+}
+
+bool ofxAndroidVideoGrabber::Data::startReadback(){
+	auto & gl = getGLES3Readback();
+	if(!gl.loaded){
+		return false;
+	}
+	readWidth = fbo.getWidth();
+	readHeight = fbo.getHeight();
+	size_t size = readWidth * readHeight * 4;
+	if(!packBuffer){
+		glGenBuffers(1,&packBuffer);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER,packBuffer);
+	if(packBufferSize!=size){
+		glBufferData(GL_PIXEL_PACK_BUFFER,size,nullptr,GL_STREAM_READ);
+		packBufferSize = size;
+	}
+	fbo.bind();
+	glPixelStorei(GL_PACK_ALIGNMENT,4);
+	of::priv::currentRenderStats().readbacks++;
+	glReadPixels(0,0,readWidth,readHeight,GL_RGBA,GL_UNSIGNED_BYTE,0);
+	fbo.unbind();
+	glBindBuffer(GL_PIXEL_PACK_BUFFER,0);
+	readFence = gl.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+	return true;
+}
+
+bool ofxAndroidVideoGrabber::Data::collectReadback(){
+	auto & gl = getGLES3Readback();
+	GLenum ret = gl.clientWaitSync(readFence,0,0);
+	if(ret!=GL_ALREADY_SIGNALED && ret!=GL_CONDITION_SATISFIED){
+		return false;
+	}
+	gl.deleteSync(readFence);
+	readFence = nullptr;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER,packBuffer);
+	auto mapped = (unsigned char*)gl.mapBufferRange(GL_PIXEL_PACK_BUFFER,0,packBufferSize,GL_MAP_READ_BIT);
+	if(mapped){
+		frontBuffer.setFromPixels(mapped,readWidth,readHeight,OF_PIXELS_RGBA);
+		gl.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+		bPixelsNew = true;
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER,0);
+	return true;
+}
+
+void ofxAndroidVideoGrabber::Data::releaseReadback(){
+	if(readFence){
+		getGLES3Readback().deleteSync(readFence);
+		readFence = nullptr;
+	}
+	if(packBuffer){
+		glDeleteBuffers(1,&packBuffer);
+		packBuffer = 0;
+	}
+	packBufferSize = 0;
+	fbo.clear();
+}
+
 
 ofxAndroidVideoGrabber::ofxAndroidVideoGrabber()
 :data(new Data){
@@ -158,6 +351,8 @@ void ofxAndroidVideoGrabber::Data::onAppPause(){
 	appPaused = true;
 	glDeleteTextures(1, &texture.texData.textureID);
 	texture.texData.textureID = 0;
+	// the fbo is allocated again with the next frame
+	releaseReadback();
 	ofLogVerbose("ofxAndroidVideoGrabber") << "ofPauseVideoGrabbers(): releasing textures";
 }
 
@@ -211,7 +406,7 @@ void ofxAndroidVideoGrabber::update(){
 		data->newPixels = false;
 		data->bIsFrameNew = true;
 
-		if (data->bNewBackFrame && data->bUsePixels) {
+		if (data->bNewBackFrame && data->bUsePixels && !data->bUseFbo) {
 			//std::unique_lock <std::mutex> lck(data->mtx);
 			std::swap(data->backBuffer, data->frontBuffer);
 			data->bNewBackFrame = false;
@@ -221,14 +416,24 @@ void ofxAndroidVideoGrabber::update(){
 		// This will tell the camera api that we are ready for a new frame
 		jmethodID update = ofGetJNIEnv()->GetMethodID(getJavaClass(), "update", "()V");
 		ofGetJNIEnv()->CallVoidMethod(data->javaVideoGrabber, update);
+		data->updateTextureMatrix();
+
+		if(data->bUseFbo){
+			data->drawToFbo();
+		}
 	} else {
 		data->bIsFrameNew = false;
 	}
+
+	if(data->bUseFbo){
+		data->updateReadback();
+	}
 }
 
 void ofxAndroidVideoGrabber::close(){
 	// Release texture
 	glDeleteTextures(1, &data->texture.texData.textureID);
+	data->releaseReadback();
 
     JNIEnv *env = ofGetJNIEnv();
     jclass javaClass = getJavaClass();
@@ -248,6 +453,39 @@ ofTexture *	ofxAndroidVideoGrabber::getTexturePtr(){
 	else return nullptr;
 }
 
+void ofxAndroidVideoGrabber::setUseFbo(bool useFbo){
+	data->bUseFbo = useFbo;
+	if(!useFbo){
+		data->releaseReadback();
+		data->bPixelsRequested = false;
+		data->bPixelsNew = false;
+	}
+}
+
+bool ofxAndroidVideoGrabber::isUsingFbo() const{
+	return data->bUseFbo;
+}
+
+ofFbo & ofxAndroidVideoGrabber::getFbo(){
+	return data->fbo;
+}
+
+const ofFbo & ofxAndroidVideoGrabber::getFbo() const{
+	return data->fbo;
+}
+
+void ofxAndroidVideoGrabber::requestPixels(){
+	if(!data->bUseFbo){
+		ofLogWarning("ofxAndroidVideoGrabber") << "requestPixels(): only needed with setUseFbo(true), pixels are already updated every frame";
+		return;
+	}
+	data->bPixelsRequested = true;
+}
+
+bool ofxAndroidVideoGrabber::isPixelsNew() const{
+	return data->bPixelsNew;
+}
+
 bool ofxAndroidVideoGrabber::supportsTextureRendering(){
 	static bool supportsTexture = false;
 	static bool supportChecked = false;
@@ -690,7 +928,8 @@ Java_cc_openframeworks_OFAndroidVideoGrabber_newFrame(JNIEnv*  env, jobject  thi
 	auto data = instances()[cameraId].lock();
 	if(!data) return 1;
 
-	if(data->bUsePixels) {
+	// with the fbo the frames stay on the GPU, the array isn't even read
+	if(data->bUsePixels && !data->bUseFbo) {
 		jboolean isCopy;
 		auto currentFrame = (unsigned char *) env->GetByteArrayElements(array, &isCopy);
 		//ofLog()<<"Is copy: "<<(isCopy?true:false);
@@ -12,6 +12,7 @@
 #include "ofEvents.h"
 #include "ofTypes.h"
 #include "ofTexture.h"
+#include "ofFbo.h"
 #include <jni.h>
 
 class ofxAndroidVideoGrabber: public ofBaseVideoGrabber{
@@ -79,6 +80,56 @@ public:
 
 	bool supportsTextureRendering();
 
+	/// \brief Keeps the camera frames on the GPU, drawing every new one
+	/// into an fbo
+	///
+	/// The camera texture is an external OES texture, the default shaders
+	/// can draw it but custom ones need samplerExternalOES. The fbo has a
+	/// plain RGBA texture that can be used with any shader and read back.
+	/// In this mode the frames are never converted to RGB in the CPU,
+	/// setUsePixels() is ignored and getPixels() only has the frames asked
+	/// for with requestPixels():
+	///
+	/// ~~~~{.cpp}
+	/// void ofApp::setup(){
+	///     grabber.setUseFbo(true);
+	///     grabber.setup(1280, 720);
+	/// }
+	///
+	/// void ofApp::update(){
+	///     grabber.update();
+	///     if(grabber.isFrameNew()){
+	///         grabber.requestPixels();
+	///     }
+	///     if(grabber.isPixelsNew()){
+	///         tracker.update(grabber.getPixels());
+	///     }
+	/// }
+	///
+	/// void ofApp::draw(){
+	///     blurShader.begin();
+	///     grabber.getFbo().draw(0, 0);
+	///     blurShader.end();
+	/// }
+	/// ~~~~
+	void setUseFbo(bool useFbo);
+	bool isUsingFbo() const;
+
+	/// \brief The fbo the frames are drawn to with setUseFbo(true)
+	ofFbo & getFbo();
+	const ofFbo & getFbo() const;
+
+	/// \brief Starts copying the current frame in the fbo to getPixels()
+	///
+	/// On OpenGL ES 3 the copy goes through a pixel buffer and arrives
+	/// some frames later without stalling, isPixelsNew() is true in the
+	/// update() where it does. On OpenGL ES 2 it's read in
+	/// the next update(), waiting for the GPU.
+	void requestPixels();
+
+	/// \brief true if the last update() got the pixels of requestPixels()
+	bool isPixelsNew() const;
+
 	struct Data;
 private:
 	int getCameraFacing(int facing)const;
@@ -5,6 +5,30 @@
 
 #include "ofxAssimpAnimation.h"
 
+namespace{
+    // the last key at or before time, or the first one, starting from the
+    // key found last time and its next one before searching all of them
+    template<typename Key>
+    unsigned int findKey(const Key * keys, unsigned int numKeys, double time, unsigned int & hint){
+        auto after = [&](unsigned int frame){
+            return frame + 1 >= numKeys || time < keys[frame + 1].mTime;
+        };
+        unsigned int frame;
+        if(hint < numKeys && (hint == 0 || keys[hint].mTime <= time) && after(hint)){
+            frame = hint;
+        }else if(hint + 1 < numKeys && keys[hint + 1].mTime <= time && after(hint + 1)){
+            frame = hint + 1;
+        }else{
+            const Key * next = std::upper_bound(keys, keys + numKeys, time, [](double t, const Key & key){
+                return t < key.mTime;
+            });
+            frame = next == keys ? 0 : (unsigned int)(next - keys - 1);
+        }
+        hint = frame;
+        return frame;
+    }
+}
+
 ofxAssimpAnimation::ofxAssimpAnimation(shared_ptr<const aiScene> scene, aiAnimation * animation) {
     this->scene = scene;
     this->animation = animation;
@@ -23,6 +47,12 @@ ofxAssimpAnimation::ofxAssimpAnimation(shared_ptr<const aiScene> scene, aiAnimat
     if(animation != NULL) {
         durationInSeconds = animation->mDuration;
         durationInMilliSeconds = durationInSeconds * 1000;
+
+        channelNodes.resize(animation->mNumChannels);
+        keyHints.resize(animation->mNumChannels, KeyHint{0, 0, 0});
+        for(unsigned int i = 0; i < animation->mNumChannels; i++) {
+            channelNodes[i] = scene->mRootNode->FindNode(animation->mChannels[i]->mNodeName);
+        }
     }
 }
 
@@ -66,17 +96,15 @@ void ofxAssimpAnimation::update() {
 void ofxAssimpAnimation::updateAnimationNodes() {
 	for(unsigned int i=0; i<animation->mNumChannels; i++) {
         const aiNodeAnim * channel = animation->mChannels[i];
-        aiNode * targetNode = scene->mRootNode->FindNode(channel->mNodeName);
+        aiNode * targetNode = channelNodes[i];
+        if(targetNode == NULL) {
+            continue;
+        }
+        KeyHint & hint = keyHints[i];
         
         aiVector3D presentPosition(0, 0, 0);
         if(channel->mNumPositionKeys > 0) {
-            unsigned int frame = 0;
-            while(frame < channel->mNumPositionKeys - 1) {
-                if(progressInSeconds < channel->mPositionKeys[frame+1].mTime) {
-                    break;
-                }
-                frame++;
-            }
+            unsigned int frame = findKey(channel->mPositionKeys, channel->mNumPositionKeys, progressInSeconds, hint.position);
             
             unsigned int nextFrame = (frame + 1) % channel->mNumPositionKeys;
             const aiVectorKey & key = channel->mPositionKeys[frame];
@@ -95,13 +123,7 @@ void ofxAssimpAnimation::updateAnimationNodes() {
         
         aiQuaternion presentRotation(1, 0, 0, 0);
         if(channel->mNumRotationKeys > 0) {
-            unsigned int frame = 0;
-            while(frame < channel->mNumRotationKeys - 1) {
-                if(progressInSeconds < channel->mRotationKeys[frame+1].mTime) {
-                    break;
-                }
-                frame++;
-            }
+            unsigned int frame = findKey(channel->mRotationKeys, channel->mNumRotationKeys, progressInSeconds, hint.rotation);
             
             unsigned int nextFrame = (frame + 1) % channel->mNumRotationKeys;
             const aiQuatKey& key = channel->mRotationKeys[frame];
@@ -120,13 +142,7 @@ void ofxAssimpAnimation::updateAnimationNodes() {
         
         aiVector3D presentScaling(1, 1, 1);
         if(channel->mNumScalingKeys > 0) {
-            unsigned int frame = 0;
-            while(frame < channel->mNumScalingKeys - 1){
-                if(progressInSeconds < channel->mScalingKeys[frame+1].mTime) {
-                    break;
-                }
-                frame++;
-            }
+            unsigned int frame = findKey(channel->mScalingKeys, channel->mNumScalingKeys, progressInSeconds, hint.scaling);
             
             presentScaling = channel->mScalingKeys[frame].mValue;
         }
@@ -49,6 +49,18 @@ protected:
     
     shared_ptr<const aiScene> scene;
     aiAnimation * animation;
+
+    // the node each channel animates, and the keys used for it last time,
+    // the next search starts from them since they rarely change by more
+    // than one key per frame
+    struct KeyHint{
+        unsigned int position;
+        unsigned int rotation;
+        unsigned int scaling;
+    };
+    vector<aiNode*> channelNodes;
+    vector<KeyHint> keyHints;
+
     float animationCurrTime;
     float animationPrevTime;
     bool bPlay;
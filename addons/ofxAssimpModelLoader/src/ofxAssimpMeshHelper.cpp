@@ -11,7 +11,10 @@ ofxAssimpMeshHelper::ofxAssimpMeshHelper() {
     blendMode = OF_BLENDMODE_ALPHA;
     twoSided = false;
     hasChanged = false;
+    validAnimatedPos = false;
     validCache = false;
+    vboHasBindPose = true;
+    currentLod = 0;
 }
 
 bool ofxAssimpMeshHelper::hasTexture() {
@@ -38,9 +38,46 @@ public:
 
     vector<aiVector3D> animatedPos;
     vector<aiVector3D> animatedNorm;
+    bool validAnimatedPos; // animatedPos and animatedNorm are up to date
 
     ofMesh cachedMesh;
     bool validCache;
     
-    ofMatrix4x4 matrix;
+    ofMatrix4x4 matrix; // of the first node with the mesh
+
+    // transforms of every node that draws the mesh, when there's more than
+    // one they are drawn in a single instanced call reading them from
+    // instanceBuffer at 4 locations from INSTANCE_TRANSFORM_ATTRIBUTE
+    enum{
+        INSTANCE_TRANSFORM_ATTRIBUTE = ofInstancedMesh::TRANSFORM_ATTRIBUTE,
+    };
+    vector<ofMatrix4x4> instances;
+    vector<ofMatrix4x4> uploadedInstances; // what instanceBuffer has
+    ofBufferObject instanceBuffer;
+    ofMaterial instancingMaterial;
+
+    // gpu skinning: the 4 bones that influence each vertex most are
+    // passed to the shader as vertex attributes, and the bone matrices
+    // as a float texture with a column of each matrix per texel
+    enum{
+        BONE_INDICES_ATTRIBUTE = 5,
+        BONE_WEIGHTS_ATTRIBUTE = 6,
+    };
+    vector<aiMatrix4x4> boneMatrices;
+    vector<aiMatrix4x4> boneColumns; // boneMatrices transposed, as uploaded to boneMatricesTexture
+    vector<const aiNode*> boneNodes; // the node of each bone, searched once
+    ofTexture boneMatricesTexture;
+    ofMaterial skinningMaterial;
+    bool vboHasBindPose; // the vbo has the original vertices, not the ones skinned on the cpu
+
+    // levels of detail generated by ofxAssimpModelLoader::setupLod(), their
+    // indices follow the full ones in the vbo and they use the same vertices
+    struct LodLevel{
+        size_t offset;
+        size_t count;
+        float error; // in the coordinates of the mesh
+    };
+    vector<LodLevel> lodLevels;
+    ofBoundingBox lodBounds;
+    size_t currentLod; // 0 is the full mesh, lodLevels[currentLod - 1] otherwise
 };
@@ -6,7 +6,60 @@
 #include <assimp/postprocess.h>
 #include <assimp/config.h>
 
-ofxAssimpModelLoader::ofxAssimpModelLoader(){
+namespace{
+    // ofMaterial vertex hook that skins each vertex with the 4 bones
+    // in its attributes, the bone matrices come from a float texture
+    const string skinningSource = R"(
+IN vec4 boneIndices;
+IN vec4 boneWeights;
+uniform sampler2D boneMatrices;
+
+mat4 getBoneMatrix(float index){
+    int x = int(index) * 4;
+    return mat4(texelFetch(boneMatrices, ivec2(x, 0), 0),
+                texelFetch(boneMatrices, ivec2(x + 1, 0), 0),
+                texelFetch(boneMatrices, ivec2(x + 2, 0), 0),
+                texelFetch(boneMatrices, ivec2(x + 3, 0), 0));
+}
+
+void preVertex(inout vec4 position, inout vec4 normal){
+    mat4 skinning = getBoneMatrix(boneIndices.x) * boneWeights.x
+                  + getBoneMatrix(boneIndices.y) * boneWeights.y
+                  + getBoneMatrix(boneIndices.z) * boneWeights.z
+                  + getBoneMatrix(boneIndices.w) * boneWeights.w;
+    position = skinning * position;
+    normal.xyz = mat3(skinning) * normal.xyz;
+}
+)";
+
+    // ofMaterial vertex hook that places each instance of a mesh shared
+    // by several nodes with the transform of its node
+    const string instancingSource = R"(
+IN mat4 instanceTransform;
+
+void preVertex(inout vec4 position, inout vec4 normal){
+    position = instanceTransform * position;
+    normal.xyz = mat3(instanceTransform) * normal.xyz;
+}
+)";
+
+    // queried the first time from the main thread, so canSkinOnGPU()
+    // can be called from the task pool afterwards
+    GLint getMaxTextureSize(){
+        static GLint maxTextureSize = 0;
+#ifndef TARGET_OPENGLES
+        if(maxTextureSize == 0){
+            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        }
+#endif
+        return maxTextureSize;
+    }
+}
+
+ofxAssimpModelLoader::ofxAssimpModelLoader()
+:bOptimizeTriangleOrder(false)
+,maxUploadTime(2)
+,loadingProgress(0){
 	clear();
 }
 
@@ -17,6 +70,7 @@ ofxAssimpModelLoader::~ofxAssimpModelLoader(){
 //------------------------------------------
 bool ofxAssimpModelLoader::loadModel(string modelName, bool optimize){
     
+    cancelLoading();
     file.open(modelName, ofFile::ReadOnly, true); // Since it may be a binary file we should read it in binary -Ed
     if(!file.exists()) {
         ofLogVerbose("ofxAssimpModelLoader") << "loadModel(): model does not exist: \"" << modelName << "\"";
@@ -47,6 +101,7 @@ bool ofxAssimpModelLoader::loadModel(string modelName, bool optimize){
 bool ofxAssimpModelLoader::loadModel(ofBuffer & buffer, bool optimize, const char * extension){
     
     ofLogVerbose("ofxAssimpModelLoader") << "loadModel(): loading from memory buffer \"." << extension << "\"";
+    cancelLoading();
     
     if(scene.get() != nullptr){
         clear();
@@ -65,6 +120,79 @@ bool ofxAssimpModelLoader::loadModel(ofBuffer & buffer, bool optimize, const cha
     return bOk;
 }
 
+//------------------------------------------
+void ofxAssimpModelLoader::loadModelAsync(string modelName, bool optimize){
+    cancelLoading();
+
+    auto model = make_shared<LoadingModel>();
+    model->file.open(modelName, ofFile::ReadOnly, true);
+    unsigned int flags = initImportProperties(optimize);
+    model->store = store;
+    bool optimizeTriangleOrder = bOptimizeTriangleOrder;
+
+    ofLogVerbose("ofxAssimpModelLoader") << "loadModelAsync(): loading \"" << model->file.getFileName()
+		<< "\" from \"" << model->file.getEnclosingDirectory() << "\"";
+
+    // a model still being loaded is dropped when another one is loaded or
+    // the loader is cleared
+    loading = model;
+    loadGeneration = make_shared<bool>(true);
+    weak_ptr<bool> current = loadGeneration;
+    notifyLoadingProgress(0);
+
+    ofGetTaskPool().submit([this, model, flags, optimizeTriangleOrder, current]{
+        if(!model->file.exists()){
+            return "model does not exist: \"" + model->file.path() + "\"";
+        }
+        model->scene = shared_ptr<const aiScene>(aiImportFileExWithProperties(model->file.getAbsolutePath().c_str(), flags, NULL, model->store.get()), aiReleaseImport);
+        if(!model->scene){
+            return string(aiGetErrorString());
+        }
+        ofTaskPool::runOnMainThread([this, current]{
+            if(!current.expired()){
+                notifyLoadingProgress(0.25f);
+            }
+        });
+        prepareModel(*model, optimizeTriangleOrder);
+        return string();
+    }, [this, model, current](string & error){
+        if(current.expired()){
+            return;
+        }
+        if(!error.empty()){
+            ofLogError("ofxAssimpModelLoader") << "loadModelAsync(): " << error;
+            loading.reset();
+            loadGeneration.reset();
+            bool loaded = false;
+            ofNotifyEvent(loadedEvent, loaded, this);
+            return;
+        }
+        // the meshes are uploaded from update() with a time budget per frame
+        model->meshHelpers.resize(model->meshes.size());
+        notifyLoadingProgress(0.5f);
+        ofAddListener(ofEvents().update, this, &ofxAssimpModelLoader::updateLoading);
+    });
+}
+
+//------------------------------------------
+bool ofxAssimpModelLoader::isLoading() const{
+    return loading != nullptr;
+}
+
+//------------------------------------------
+float ofxAssimpModelLoader::getLoadingProgress() const{
+    return loadingProgress;
+}
+
+//------------------------------------------
+void ofxAssimpModelLoader::setMaxUploadTimePerFrame(float ms){
+    maxUploadTime = ms;
+}
+
+float ofxAssimpModelLoader::getMaxUploadTimePerFrame() const{
+    return maxUploadTime;
+}
+
 unsigned int ofxAssimpModelLoader::initImportProperties(bool optimize) {    
     store.reset(aiCreatePropertyStore(), aiReleasePropertyStore);
     
@@ -83,19 +211,17 @@ unsigned int ofxAssimpModelLoader::initImportProperties(bool optimize) {
 
 bool ofxAssimpModelLoader::processScene() {
     
-    normalizeFactor = ofGetWidth() / 2.0;
-    
     if(scene){
-        loadGLResources();
-        update();
-        calculateDimensions();
-        
-        if(getAnimationCount())
-            ofLogVerbose("ofxAssimpModelLoader") << "loadModel(): scene has " << getAnimationCount() << "animations";
-        else {
-            ofLogVerbose("ofxAssimpModelLoader") << "loadMode(): no animations";
-        }       
-        
+        LoadingModel model;
+        model.scene = scene;
+        model.store = store;
+        model.file = file;
+        prepareModel(model, bOptimizeTriangleOrder);
+        model.meshHelpers.resize(model.meshes.size());
+        for(size_t i = 0; i < model.meshes.size(); i++){
+            loadGLResources(model, i);
+        }
+        finishLoading(model);
         return true;
     }else{
         ofLogError("ofxAssimpModelLoader") << "loadModel(): " + (string) aiGetErrorString();
@@ -173,185 +299,318 @@ void ofxAssimpModelLoader::optimizeScene(){
 }
 
 //-------------------------------------------
-void ofxAssimpModelLoader::loadGLResources(){
+void ofxAssimpModelLoader::prepareModel(LoadingModel & model, bool optimizeTriangleOrder){
+
+	ofLogVerbose("ofxAssimpModelLoader") << "prepareModel(): starting";
+
+    const aiScene * scene = model.scene.get();
+    const string modelFolder = model.file.getEnclosingDirectory();
+    const bool animated = scene->mNumAnimations > 0;
+    model.meshes.resize(scene->mNumMeshes);
+
+    // everything that doesn't need GL, for all the meshes in parallel
+    ofGetTaskPool().parallelFor(0, scene->mNumMeshes, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            aiMesh * mesh = scene->mMeshes[i];
+            LoadingMesh & loadingMesh = model.meshes[i];
+
+            // the texture coordinates are adjusted to the texture once it's loaded
+            aiMeshToOfMesh(mesh, loadingMesh.mesh);
+            loadingMesh.mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+            if(optimizeTriangleOrder && loadingMesh.mesh.hasIndices()){
+                loadingMesh.mesh.optimizeVertexCache();
+                loadingMesh.mesh.optimizeOverdraw();
+            }
+            loadingMesh.indices = loadingMesh.mesh.getIndices();
+
+            // TODO: handle other aiTextureTypes
+            aiMaterial* mtl = scene->mMaterials[mesh->mMaterialIndex];
+            aiString texPath;
+            if(AI_SUCCESS == mtl->GetTexture(aiTextureType_DIFFUSE, 0, &texPath)){
+                string relTexPath = ofFilePath::getEnclosingDirectory(texPath.data,false);
+                string texFile = ofFilePath::getFileName(texPath.data);
+                loadingMesh.texturePath = ofFilePath::join(ofFilePath::join(modelFolder, relTexPath), texFile);
+                if(ofFile::doesFileExist(loadingMesh.texturePath) == false) {
+                    ofLogError("ofxAssimpModelLoader") << "prepareModel(): texture doesn't exist: \""
+                        << model.file.getFileName() + "\" in \"" << loadingMesh.texturePath << "\"";
+                }
+            }
 
-	ofLogVerbose("ofxAssimpModelLoader") << "loadGLResources(): starting";
+            if(animated && mesh->HasBones()){
+                // keep the 4 biggest weights of each vertex, normalized so
+                // they still add up to 1
+                auto & boneIndices = loadingMesh.boneIndices;
+                auto & boneWeights = loadingMesh.boneWeights;
+                boneIndices.assign(mesh->mNumVertices, ofVec4f(0));
+                boneWeights.assign(mesh->mNumVertices, ofVec4f(0));
+                for(unsigned int a = 0; a < mesh->mNumBones; ++a){
+                    const aiBone* bone = mesh->mBones[a];
+                    for(unsigned int b = 0; b < bone->mNumWeights; ++b){
+                        const aiVertexWeight& weight = bone->mWeights[b];
+                        auto & weights = boneWeights[weight.mVertexId];
+                        int smallest = 0;
+                        for(int c = 1; c < 4; c++){
+                            if(weights[c] < weights[smallest]) smallest = c;
+                        }
+                        if(weight.mWeight > weights[smallest]){
+                            weights[smallest] = weight.mWeight;
+                            boneIndices[weight.mVertexId][smallest] = a;
+                        }
+                    }
+                }
+                for(auto & weights: boneWeights){
+                    float total = weights.x + weights.y + weights.z + weights.w;
+                    if(total > 0){
+                        weights /= total;
+                    }
+                }
+            }
+        }
+    }, 1);
 
-    // create new mesh helpers for each mesh, will populate their data later.
-    modelMeshes.resize(scene->mNumMeshes,ofxAssimpMeshHelper());
+    // each texture is decoded once even if several meshes use it
+    for(auto & loadingMesh: model.meshes){
+        if(!loadingMesh.texturePath.empty()){
+            model.images[loadingMesh.texturePath];
+        }
+    }
+    vector<map<string, shared_ptr<const ofPixels>>::iterator> images;
+    for(auto it = model.images.begin(); it != model.images.end(); ++it){
+        images.push_back(it);
+    }
+    ofGetTaskPool().parallelFor(0, images.size(), [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            ofLogVerbose("ofxAssimpModelLoader") << "prepareModel(): loading image from \"" << images[i]->first << "\"";
+            // shared with other models, or several loads, using the same image
+            images[i]->second = ofGetAssetCache().getPixels(images[i]->first);
+        }
+    }, 1);
 
-    // create OpenGL buffers and populate them based on each meshes pertinant info.
-    for (unsigned int i = 0; i < scene->mNumMeshes; ++i){
-        ofLogVerbose("ofxAssimpModelLoader") << "loadGLResources(): loading mesh " << i;
-        // current mesh we are introspecting
-        aiMesh* mesh = scene->mMeshes[i];
+    ofLogVerbose("ofxAssimpModelLoader") << "prepareModel(): finished";
+}
 
-        // the current meshHelper we will be populating data into.
-        ofxAssimpMeshHelper & meshHelper = modelMeshes[i];
-        //ofxAssimpMeshHelper meshHelper;
-		
-        //meshHelper.texture = NULL;
+//-------------------------------------------
+void ofxAssimpModelLoader::loadGLResources(LoadingModel & model, size_t meshIndex){
+    ofLogVerbose("ofxAssimpModelLoader") << "loadGLResources(): loading mesh " << meshIndex;
+    // current mesh we are introspecting
+    aiMesh* mesh = model.scene->mMeshes[meshIndex];
+    LoadingMesh & loadingMesh = model.meshes[meshIndex];
 
-        // Handle material info
-        aiMaterial* mtl = scene->mMaterials[mesh->mMaterialIndex];
-        aiColor4D dcolor, scolor, acolor, ecolor;
+    // the current meshHelper we will be populating data into.
+    ofxAssimpMeshHelper & meshHelper = model.meshHelpers[meshIndex];
 
-        if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_DIFFUSE, &dcolor)){
-            meshHelper.material.setDiffuseColor(aiColorToOfColor(dcolor));
-        }
+    // Handle material info
+    aiMaterial* mtl = model.scene->mMaterials[mesh->mMaterialIndex];
+    aiColor4D dcolor, scolor, acolor, ecolor;
 
-        if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_SPECULAR, &scolor)){
-        	meshHelper.material.setSpecularColor(aiColorToOfColor(scolor));
-        }
+    if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_DIFFUSE, &dcolor)){
+        meshHelper.material.setDiffuseColor(aiColorToOfColor(dcolor));
+    }
 
-        if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_AMBIENT, &acolor)){
-        	meshHelper.material.setAmbientColor(aiColorToOfColor(acolor));
-        }
+    if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_SPECULAR, &scolor)){
+        meshHelper.material.setSpecularColor(aiColorToOfColor(scolor));
+    }
 
-        if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_EMISSIVE, &ecolor)){
-        	meshHelper.material.setEmissiveColor(aiColorToOfColor(ecolor));
-        }
+    if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_AMBIENT, &acolor)){
+        meshHelper.material.setAmbientColor(aiColorToOfColor(acolor));
+    }
 
-        float shininess;
-        if(AI_SUCCESS == aiGetMaterialFloat(mtl, AI_MATKEY_SHININESS, &shininess)){
-			meshHelper.material.setShininess(shininess);
-		}
+    if(AI_SUCCESS == aiGetMaterialColor(mtl, AI_MATKEY_COLOR_EMISSIVE, &ecolor)){
+        meshHelper.material.setEmissiveColor(aiColorToOfColor(ecolor));
+    }
 
-        int blendMode;
-		if(AI_SUCCESS == aiGetMaterialInteger(mtl, AI_MATKEY_BLEND_FUNC, &blendMode)){
-			if(blendMode==aiBlendMode_Default){
-				meshHelper.blendMode=OF_BLENDMODE_ALPHA;
-			}else{
-				meshHelper.blendMode=OF_BLENDMODE_ADD;
-			}
-		}
+    float shininess;
+    if(AI_SUCCESS == aiGetMaterialFloat(mtl, AI_MATKEY_SHININESS, &shininess)){
+        meshHelper.material.setShininess(shininess);
+    }
 
-        // Culling
-        unsigned int max = 1;
-        int two_sided;
-        if((AI_SUCCESS == aiGetMaterialIntegerArray(mtl, AI_MATKEY_TWOSIDED, &two_sided, &max)) && two_sided)
-            meshHelper.twoSided = true;
-        else
-            meshHelper.twoSided = false;
-
-        // Load Textures
-        int texIndex = 0;
-        aiString texPath;
-
-        // TODO: handle other aiTextureTypes
-        if(AI_SUCCESS == mtl->GetTexture(aiTextureType_DIFFUSE, texIndex, &texPath)){
-            ofLogVerbose("ofxAssimpModelLoader") << "loadGLResource(): loading image from \"" << texPath.data << "\"";
-            string modelFolder = file.getEnclosingDirectory();
-            string relTexPath = ofFilePath::getEnclosingDirectory(texPath.data,false);
-            string texFile = ofFilePath::getFileName(texPath.data);
-            string realPath = ofFilePath::join(ofFilePath::join(modelFolder, relTexPath), texFile);
-            
-            if(ofFile::doesFileExist(realPath) == false) {
-                ofLogError("ofxAssimpModelLoader") << "loadGLResource(): texture doesn't exist: \""
-					<< file.getFileName() + "\" in \"" << realPath << "\"";
-            }
-            
-            ofxAssimpTexture assimpTexture;
-            bool bTextureAlreadyExists = false;
-            for(size_t j = 0; j < textures.size(); j++) {
-                assimpTexture = textures[j];
-                if(assimpTexture.getTexturePath() == realPath) {
-                    bTextureAlreadyExists = true;
-                    break;
-                }
+    int blendMode;
+    if(AI_SUCCESS == aiGetMaterialInteger(mtl, AI_MATKEY_BLEND_FUNC, &blendMode)){
+        if(blendMode==aiBlendMode_Default){
+            meshHelper.blendMode=OF_BLENDMODE_ALPHA;
+        }else{
+            meshHelper.blendMode=OF_BLENDMODE_ADD;
+        }
+    }
+
+    // Culling
+    unsigned int max = 1;
+    int two_sided;
+    if((AI_SUCCESS == aiGetMaterialIntegerArray(mtl, AI_MATKEY_TWOSIDED, &two_sided, &max)) && two_sided)
+        meshHelper.twoSided = true;
+    else
+        meshHelper.twoSided = false;
+
+    // Load Textures, decoded by prepareModel()
+    if(!loadingMesh.texturePath.empty()){
+        const string & realPath = loadingMesh.texturePath;
+        ofxAssimpTexture assimpTexture;
+        bool bTextureAlreadyExists = false;
+        for(size_t j = 0; j < model.textures.size(); j++) {
+            assimpTexture = model.textures[j];
+            if(assimpTexture.getTexturePath() == realPath) {
+                bTextureAlreadyExists = true;
+                break;
             }
-            if(bTextureAlreadyExists) {
+        }
+        if(bTextureAlreadyExists) {
+            meshHelper.assimpTexture = assimpTexture;
+            ofLogVerbose("ofxAssimpModelLoader") << "loadGLResource(): texture already loaded: \""
+                << model.file.getFileName() + "\" from \"" << realPath << "\"";
+        } else {
+            // the cache uploads the decoded pixels and drops them once
+            // nothing else holds them
+            bool decoded = model.images[realPath] != nullptr;
+            model.images.erase(realPath);
+            auto texture = decoded ? ofGetAssetCache().getTexture(realPath) : nullptr;
+            if(texture) {
+                model.textures.push_back(ofxAssimpTexture(texture, realPath));
+                assimpTexture = model.textures.back();
                 meshHelper.assimpTexture = assimpTexture;
-                ofLogVerbose("ofxAssimpModelLoader") << "loadGLResource(): texture already loaded: \""
-					<< file.getFileName() + "\" from \"" << realPath << "\"";
+                ofLogVerbose("ofxAssimpModelLoader") << "loadGLResource(): texture loaded, dimensions: "
+                    << texture->getWidth() << "x" << texture->getHeight();
             } else {
-                ofTexture texture;
-                bool bTextureLoadedOk = ofLoadImage(texture, realPath);
-                if(bTextureLoadedOk) {
-                    textures.push_back(ofxAssimpTexture(texture, realPath));
-                    assimpTexture = textures.back();
-                    meshHelper.assimpTexture = assimpTexture;
-                    ofLogVerbose("ofxAssimpModelLoader") << "loadGLResource(): texture loaded, dimensions: "
-						<< texture.getWidth() << "x" << texture.getHeight();
-                } else {
-                    ofLogError("ofxAssimpModelLoader") << "loadGLResource(): couldn't load texture: \""
-						<< file.getFileName() + "\" from \"" << realPath << "\"";
-                }
+                ofLogError("ofxAssimpModelLoader") << "loadGLResource(): couldn't load texture: \""
+                    << model.file.getFileName() + "\" from \"" << realPath << "\"";
             }
         }
+    }
 
-        meshHelper.mesh = mesh;
-        aiMeshToOfMesh(mesh, meshHelper.cachedMesh, &meshHelper);
-        meshHelper.cachedMesh.setMode(OF_PRIMITIVE_TRIANGLES);
-        meshHelper.validCache = true;
-        meshHelper.hasChanged = false;
-
-		int numOfAnimations = scene->mNumAnimations;
-		for (int i = 0; i<numOfAnimations; i++) {
-			aiAnimation * animation = scene->mAnimations[i];
-			animations.push_back(ofxAssimpAnimation(scene, animation));
-		}
-
-        if(hasAnimations()){
-			meshHelper.animatedPos.resize(mesh->mNumVertices);
-			if(mesh->HasNormals()){
-				meshHelper.animatedNorm.resize(mesh->mNumVertices);
-			}
+    meshHelper.mesh = mesh;
+    meshHelper.cachedMesh = std::move(loadingMesh.mesh);
+    if(meshHelper.hasTexture()){
+        ofTexture & tex = meshHelper.getTextureRef();
+        for(auto & texCoord: meshHelper.cachedMesh.getTexCoords()){
+            texCoord = tex.getCoordFromPercent(texCoord.x, texCoord.y);
         }
+    }
+    meshHelper.validCache = true;
+    meshHelper.hasChanged = false;
 
+    bool animated = model.scene->mNumAnimations > 0;
+    if(animated){
+        meshHelper.animatedPos.resize(mesh->mNumVertices);
+        if(mesh->HasNormals()){
+            meshHelper.animatedNorm.resize(mesh->mNumVertices);
+        }
+    }
 
-        int usage;
-        if(getAnimationCount()){
+    int usage;
+    if(animated){
 #ifndef TARGET_OPENGLES
-        	if(!ofIsGLProgrammableRenderer()){
-        		usage = GL_STATIC_DRAW;
-        	}else{
-        		usage = GL_STREAM_DRAW;
-        	}
-#else
-        	usage = GL_DYNAMIC_DRAW;
-#endif
+        if(!ofIsGLProgrammableRenderer()){
+            usage = GL_STATIC_DRAW;
         }else{
-        	usage = GL_STATIC_DRAW;
-
+            usage = GL_STREAM_DRAW;
         }
+#else
+        usage = GL_DYNAMIC_DRAW;
+#endif
+    }else{
+        usage = GL_STATIC_DRAW;
 
-        meshHelper.vbo.setVertexData(&mesh->mVertices[0].x,3,mesh->mNumVertices,usage,sizeof(aiVector3D));
-        if(mesh->HasVertexColors(0)){
-        	meshHelper.vbo.setColorData(&mesh->mColors[0][0].r,mesh->mNumVertices,GL_STATIC_DRAW,sizeof(aiColor4D));
-        }
-        if(mesh->HasNormals()){
-        	meshHelper.vbo.setNormalData(&mesh->mNormals[0].x,mesh->mNumVertices,usage,sizeof(aiVector3D));
-        }
-        if (meshHelper.cachedMesh.hasTexCoords()){			
-			meshHelper.vbo.setTexCoordData(&meshHelper.cachedMesh.getTexCoords()[0].x, mesh->mNumVertices,GL_STATIC_DRAW,sizeof(ofVec2f));
-        }
+    }
 
-        meshHelper.indices.resize(mesh->mNumFaces * 3);
-        int j=0;
-        for (unsigned int x = 0; x < mesh->mNumFaces; ++x){
-			for (unsigned int a = 0; a < mesh->mFaces[x].mNumIndices; ++a){
-				meshHelper.indices[j++]=mesh->mFaces[x].mIndices[a];
-			}
-		}
+    meshHelper.vbo.setVertexData(&mesh->mVertices[0].x,3,mesh->mNumVertices,usage,sizeof(aiVector3D));
+    if(mesh->HasVertexColors(0)){
+        meshHelper.vbo.setColorData(&mesh->mColors[0][0].r,mesh->mNumVertices,GL_STATIC_DRAW,sizeof(aiColor4D));
+    }
+    if(mesh->HasNormals()){
+        meshHelper.vbo.setNormalData(&mesh->mNormals[0].x,mesh->mNumVertices,usage,sizeof(aiVector3D));
+    }
+    if (meshHelper.cachedMesh.hasTexCoords()){
+        meshHelper.vbo.setTexCoordData(&meshHelper.cachedMesh.getTexCoords()[0].x, mesh->mNumVertices,GL_STATIC_DRAW,sizeof(ofVec2f));
+    }
 
+    meshHelper.indices = std::move(loadingMesh.indices);
+    if(!meshHelper.indices.empty()){
         meshHelper.vbo.setIndexData(&meshHelper.indices[0],meshHelper.indices.size(),GL_STATIC_DRAW);
+    }
 
-        //modelMeshes.push_back(meshHelper);
+    if(!loadingMesh.boneIndices.empty()){
+        meshHelper.vbo.setAttributeData(ofxAssimpMeshHelper::BONE_INDICES_ATTRIBUTE, &loadingMesh.boneIndices[0].x, 4, mesh->mNumVertices, GL_STATIC_DRAW);
+        meshHelper.vbo.setAttributeData(ofxAssimpMeshHelper::BONE_WEIGHTS_ATTRIBUTE, &loadingMesh.boneWeights[0].x, 4, mesh->mNumVertices, GL_STATIC_DRAW);
+        loadingMesh.boneIndices = vector<ofVec4f>();
+        loadingMesh.boneWeights = vector<ofVec4f>();
     }
-    
+}
+
+//-------------------------------------------
+void ofxAssimpModelLoader::finishLoading(LoadingModel & model){
+    clear();
+    scene = model.scene;
+    store = model.store;
+    file = model.file;
+    modelMeshes = std::move(model.meshHelpers);
+    textures = std::move(model.textures);
+    for(unsigned int i = 0; i < scene->mNumAnimations; i++){
+        animations.push_back(ofxAssimpAnimation(scene, scene->mAnimations[i]));
+    }
+
+    normalizeFactor = ofGetWidth() / 2.0;
+    update();
+    calculateDimensions();
 
+    if(getAnimationCount())
+        ofLogVerbose("ofxAssimpModelLoader") << "loadModel(): scene has " << getAnimationCount() << "animations";
+    else {
+        ofLogVerbose("ofxAssimpModelLoader") << "loadMode(): no animations";
+    }
 
     ofLogVerbose("ofxAssimpModelLoader") << "loadGLResource(): finished";
 }
 
+//-------------------------------------------
+void ofxAssimpModelLoader::updateLoading(ofEventArgs & args){
+    // keeps the model alive if it's finished and loading is reset
+    auto model = loading;
+    if(!model){
+        return;
+    }
+    size_t numMeshes = model->meshes.size();
+    uint64_t start = ofGetElapsedTimeMicros();
+    while(model->numUploaded < numMeshes){
+        loadGLResources(*model, model->numUploaded++);
+        if(maxUploadTime > 0 && (ofGetElapsedTimeMicros() - start) >= uint64_t(maxUploadTime * 1000)) break;
+    }
+    if(model->numUploaded < numMeshes){
+        notifyLoadingProgress(0.5f + 0.5f * model->numUploaded / numMeshes);
+        return;
+    }
+
+    ofRemoveListener(ofEvents().update, this, &ofxAssimpModelLoader::updateLoading);
+    loading.reset();
+    loadGeneration.reset();
+    finishLoading(*model);
+    notifyLoadingProgress(1);
+    bool loaded = true;
+    ofNotifyEvent(loadedEvent, loaded, this);
+}
+
+//-------------------------------------------
+void ofxAssimpModelLoader::notifyLoadingProgress(float progress){
+    loadingProgress = progress;
+    ofNotifyEvent(loadProgressEvent, progress, this);
+}
+
+//-------------------------------------------
+void ofxAssimpModelLoader::cancelLoading(){
+    if(loading){
+        ofRemoveListener(ofEvents().update, this, &ofxAssimpModelLoader::updateLoading);
+        loading.reset();
+    }
+    loadGeneration.reset();
+}
+
 //-------------------------------------------
 void ofxAssimpModelLoader::clear(){
 
     ofLogVerbose("ofxAssimpModelLoader") << "clear(): deleting GL resources";
 
     // clear out everything.
+    cancelLoading();
     modelMeshes.clear();
+    lodGeneration.reset();
     animations.clear();
     pos.set(0,0,0);
     scale.set(1,1,1);
@@ -365,6 +624,7 @@ void ofxAssimpModelLoader::clear(){
     bUsingNormals = true;
     bUsingTextures = true;
     bUsingColors = true;
+    bUsingGPUSkinning = true;
 
     currentAnimation = -1;
 
@@ -376,13 +636,39 @@ void ofxAssimpModelLoader::clear(){
 //------------------------------------------- update.
 void ofxAssimpModelLoader::update() {
 	if(!scene) return;
+    updateScene();
+    if(hasAnimations() == false) {
+        return;
+    }
+    updateGLResources();
+}
+
+void ofxAssimpModelLoader::updateModels(const vector<ofxAssimpModelLoader*> & models) {
+    getMaxTextureSize();
+    ofGetTaskPool().parallelFor(0, models.size(), [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            if(models[i]->scene){
+                models[i]->updateScene();
+            }
+        }
+    }, 1);
+    for(auto model: models){
+        if(model->scene && model->hasAnimations()){
+            model->updateGLResources();
+        }
+    }
+}
+
+void ofxAssimpModelLoader::updateScene() {
     updateAnimations();
+    for(auto & mesh: modelMeshes){
+        mesh.instances.clear();
+    }
     updateMeshes(scene->mRootNode, ofMatrix4x4());
     if(hasAnimations() == false) {
         return;
     }
     updateBones();
-    updateGLResources();
 }
 
 void ofxAssimpModelLoader::updateAnimations() {
@@ -404,7 +690,8 @@ void ofxAssimpModelLoader::updateMeshes(aiNode * node, ofMatrix4x4 parentMatrix)
     for(unsigned int i = 0; i < node->mNumMeshes; i++) {
         int meshIndex = node->mMeshes[i];
         ofxAssimpMeshHelper & mesh = modelMeshes[meshIndex];
-        mesh.matrix = matrix;
+        mesh.instances.push_back(matrix);
+        mesh.matrix = mesh.instances.front();
     }
     
     for(unsigned int i = 0; i < node->mNumChildren; i++) {
@@ -422,12 +709,19 @@ void ofxAssimpModelLoader::updateBones() {
 		const aiMesh* mesh = modelMeshes[i].mesh;
         
 		// calculate bone matrices
-		vector<aiMatrix4x4> boneMatrices(mesh->mNumBones);
+		vector<aiMatrix4x4> & boneMatrices = modelMeshes[i].boneMatrices;
+		boneMatrices.resize(mesh->mNumBones);
+		vector<const aiNode*> & boneNodes = modelMeshes[i].boneNodes;
+		if(boneNodes.size() != mesh->mNumBones) {
+			// find the corresponding node by looking recursively through the node hierarchy for the same name
+			boneNodes.resize(mesh->mNumBones);
+			for(unsigned int a = 0; a < mesh->mNumBones; ++a) {
+				boneNodes[a] = scene->mRootNode->FindNode(mesh->mBones[a]->mName);
+			}
+		}
 		for(unsigned int a = 0; a < mesh->mNumBones; ++a) {
 			const aiBone* bone = mesh->mBones[a];
-            
-			// find the corresponding node by again looking recursively through the node hierarchy for the same name
-			aiNode* node = scene->mRootNode->FindNode(bone->mName);
+			const aiNode* node = boneNodes[a];
             
 			// start with the mesh-to-bone matrix
 			boneMatrices[a] = bone->mOffsetMatrix;
@@ -441,52 +735,153 @@ void ofxAssimpModelLoader::updateBones() {
 			}
 			modelMeshes[i].hasChanged = true;
 			modelMeshes[i].validCache = false;
+			modelMeshes[i].validAnimatedPos = false;
 		}
-        
-		modelMeshes[i].animatedPos.assign(modelMeshes[i].animatedPos.size(), aiVector3D(0.0f));
-		if(mesh->HasNormals()){
-			modelMeshes[i].animatedNorm.assign(modelMeshes[i].animatedNorm.size(), aiVector3D(0.0f));
+
+		// the vertex shader does the rest, with the matrices laid out
+		// as the texture is uploaded
+		if(canSkinOnGPU(modelMeshes[i])){
+			// aiMatrix4x4 is row major, once transposed each 4 floats are a
+			// column of the matrix in the shader
+			vector<aiMatrix4x4> & boneColumns = modelMeshes[i].boneColumns;
+			boneColumns.resize(boneMatrices.size());
+			for(size_t a = 0; a < boneMatrices.size(); ++a) {
+				boneColumns[a] = boneMatrices[a];
+				boneColumns[a].Transpose();
+			}
+		}else{
+			skinMeshOnCPU(modelMeshes[i]);
 		}
-		// loop through all vertex weights of all bones
-		for(unsigned int a = 0; a < mesh->mNumBones; ++a) {
-			const aiBone* bone = mesh->mBones[a];
-			const aiMatrix4x4& posTrafo = boneMatrices[a];
-            
+	}
+}
+
+void ofxAssimpModelLoader::skinMeshOnCPU(ofxAssimpMeshHelper & meshHelper){
+	if(meshHelper.validAnimatedPos){
+		return;
+	}
+	const aiMesh* mesh = meshHelper.mesh;
+	const vector<aiMatrix4x4> & boneMatrices = meshHelper.boneMatrices;
+
+	meshHelper.animatedPos.assign(meshHelper.animatedPos.size(), aiVector3D(0.0f));
+	if(mesh->HasNormals()){
+		meshHelper.animatedNorm.assign(meshHelper.animatedNorm.size(), aiVector3D(0.0f));
+	}
+	// loop through all vertex weights of all bones
+	for(unsigned int a = 0; a < mesh->mNumBones && a < boneMatrices.size(); ++a) {
+		const aiBone* bone = mesh->mBones[a];
+		const aiMatrix4x4& posTrafo = boneMatrices[a];
+
+		for(unsigned int b = 0; b < bone->mNumWeights; ++b) {
+			const aiVertexWeight& weight = bone->mWeights[b];
+
+			size_t vertexId = weight.mVertexId;
+			const aiVector3D& srcPos = mesh->mVertices[vertexId];
+
+			meshHelper.animatedPos[vertexId] += weight.mWeight * (posTrafo * srcPos);
+		}
+		if(mesh->HasNormals()){
+			// 3x3 matrix, contains the bone matrix without the translation, only with rotation and possibly scaling
+			aiMatrix3x3 normTrafo = aiMatrix3x3( posTrafo);
 			for(unsigned int b = 0; b < bone->mNumWeights; ++b) {
 				const aiVertexWeight& weight = bone->mWeights[b];
-                
 				size_t vertexId = weight.mVertexId;
-				const aiVector3D& srcPos = mesh->mVertices[vertexId];
-                
-				modelMeshes[i].animatedPos[vertexId] += weight.mWeight * (posTrafo * srcPos);
-			}
-			if(mesh->HasNormals()){
-				// 3x3 matrix, contains the bone matrix without the translation, only with rotation and possibly scaling
-				aiMatrix3x3 normTrafo = aiMatrix3x3( posTrafo);
-				for(unsigned int b = 0; b < bone->mNumWeights; ++b) {
-					const aiVertexWeight& weight = bone->mWeights[b];
-					size_t vertexId = weight.mVertexId;
-                    
-					const aiVector3D& srcNorm = mesh->mNormals[vertexId];
-					modelMeshes[i].animatedNorm[vertexId] += weight.mWeight * (normTrafo * srcNorm);
-				}
+
+				const aiVector3D& srcNorm = mesh->mNormals[vertexId];
+				meshHelper.animatedNorm[vertexId] += weight.mWeight * (normTrafo * srcNorm);
 			}
 		}
 	}
+	meshHelper.validAnimatedPos = true;
+}
+
+bool ofxAssimpModelLoader::canSkinOnGPU(const ofxAssimpMeshHelper & meshHelper){
+#ifndef TARGET_OPENGLES
+	if(!bUsingGPUSkinning || !bUsingMaterials || !ofIsGLProgrammableRenderer() || !meshHelper.mesh->HasBones()){
+		return false;
+	}
+	return meshHelper.mesh->mNumBones * 4 <= (unsigned int)getMaxTextureSize();
+#else
+	return false;
+#endif
+}
+
+bool ofxAssimpModelLoader::canDrawInstanced(const ofxAssimpMeshHelper & meshHelper){
+#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
+	// skinned meshes are drawn one by one, the skinning already places
+	// them where their bones are
+	return meshHelper.instances.size() > 1 && !meshHelper.mesh->HasBones()
+		&& ofIsGLProgrammableRenderer() && ofGLSupportsInstancing();
+#else
+	return false;
+#endif
+}
+
+void ofxAssimpModelLoader::uploadInstances(ofxAssimpMeshHelper & meshHelper){
+	auto & instances = meshHelper.instances;
+	auto & uploaded = meshHelper.uploadedInstances;
+	if(uploaded.size() == instances.size()
+		&& memcmp(uploaded.data(), instances.data(), instances.size() * sizeof(ofMatrix4x4)) == 0){
+		return;
+	}
+	bool bind = !meshHelper.instanceBuffer.isAllocated();
+	if(bind){
+		meshHelper.instanceBuffer.allocate();
+	}
+	// the buffer keeps its id when respecified, so the vbo attributes
+	// pointing to it stay valid
+	if(uploaded.size() == instances.size()){
+		meshHelper.instanceBuffer.updateData(0, instances.size() * sizeof(ofMatrix4x4), instances.data());
+	}else{
+		meshHelper.instanceBuffer.setData(instances.size() * sizeof(ofMatrix4x4), instances.data(), GL_DYNAMIC_DRAW);
+	}
+	uploaded = instances;
+	if(bind){
+		// a mat4 takes 4 consecutive locations, one per column
+		for(int i = 0; i < 4; i++){
+			int location = ofxAssimpMeshHelper::INSTANCE_TRANSFORM_ATTRIBUTE + i;
+			meshHelper.vbo.setAttributeBuffer(location, meshHelper.instanceBuffer, 4, sizeof(ofMatrix4x4), i * 4 * sizeof(float));
+			meshHelper.vbo.setAttributeDivisor(location, 1);
+		}
+	}
+}
+
+void ofxAssimpModelLoader::uploadBoneMatrices(ofxAssimpMeshHelper & meshHelper){
+#ifndef TARGET_OPENGLES
+	int width = meshHelper.boneColumns.size() * 4;
+	if(!meshHelper.boneMatricesTexture.isAllocated() || meshHelper.boneMatricesTexture.getWidth() != width){
+		meshHelper.boneMatricesTexture.allocate(width, 1, GL_RGBA32F, false, GL_RGBA, GL_FLOAT);
+		meshHelper.boneMatricesTexture.setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+	}
+	meshHelper.boneMatricesTexture.loadData(&meshHelper.boneColumns[0].a1, width, 1, GL_RGBA);
+#endif
 }
 
 void ofxAssimpModelLoader::updateGLResources(){
     // now upload the result position and normal along with the other vertex attributes into a dynamic vertex buffer, VBO or whatever
     for (unsigned int i = 0; i < modelMeshes.size(); ++i){
-    	if(modelMeshes[i].hasChanged){
-			const aiMesh* mesh = modelMeshes[i].mesh;
+    	ofxAssimpMeshHelper & meshHelper = modelMeshes[i];
+    	if(meshHelper.hasChanged){
+			const aiMesh* mesh = meshHelper.mesh;
 			if(hasAnimations()){
-				modelMeshes[i].vbo.updateVertexData(&modelMeshes[i].animatedPos[0].x,mesh->mNumVertices);
-				if(mesh->HasNormals()){
-					modelMeshes[i].vbo.updateNormalData(&modelMeshes[i].animatedNorm[0].x,mesh->mNumVertices);
+				if(canSkinOnGPU(meshHelper)){
+					if(!meshHelper.vboHasBindPose){
+						meshHelper.vbo.updateVertexData(&mesh->mVertices[0].x,mesh->mNumVertices);
+						if(mesh->HasNormals()){
+							meshHelper.vbo.updateNormalData(&mesh->mNormals[0].x,mesh->mNumVertices);
+						}
+						meshHelper.vboHasBindPose = true;
+					}
+					uploadBoneMatrices(meshHelper);
+				}else{
+					skinMeshOnCPU(meshHelper);
+					meshHelper.vbo.updateVertexData(&meshHelper.animatedPos[0].x,mesh->mNumVertices);
+					if(mesh->HasNormals()){
+						meshHelper.vbo.updateNormalData(&meshHelper.animatedNorm[0].x,mesh->mNumVertices);
+					}
+					meshHelper.vboHasBindPose = false;
 				}
 			}
-			modelMeshes[i].hasChanged = false;
+			meshHelper.hasChanged = false;
     	}
     }
 }
@@ -548,6 +943,109 @@ void ofxAssimpModelLoader::setLoopStateForAllAnimations(ofLoopType state) {
     }
 }
 
+void ofxAssimpModelLoader::setUseGPUSkinning(bool useGPUSkinning) {
+    bUsingGPUSkinning = useGPUSkinning;
+    // upload the pose again with the new method
+    for(auto & mesh: modelMeshes){
+        mesh.hasChanged = true;
+    }
+}
+
+bool ofxAssimpModelLoader::isUsingGPUSkinning() {
+    return bUsingGPUSkinning;
+}
+
+//------------------------------------------
+void ofxAssimpModelLoader::setOptimizeTriangleOrder(bool optimizeTriangleOrder) {
+    bOptimizeTriangleOrder = optimizeTriangleOrder;
+}
+
+bool ofxAssimpModelLoader::isOptimizingTriangleOrder() {
+    return bOptimizeTriangleOrder;
+}
+
+//-------------------------------------------
+void ofxAssimpModelLoader::setupLod(size_t numLevels, float ratio){
+    lodGeneration = make_shared<bool>(true);
+    weak_ptr<bool> current = lodGeneration;
+    for(size_t i = 0; i < modelMeshes.size(); i++){
+        ofxAssimpMeshHelper & meshHelper = modelMeshes[i];
+        meshHelper.lodLevels.clear();
+        meshHelper.currentLod = 0;
+        if(meshHelper.indices.empty() || numLevels < 2){
+            continue;
+        }
+        meshHelper.vbo.setIndexData(&meshHelper.indices[0],meshHelper.indices.size(),GL_STATIC_DRAW);
+
+        // the bind pose, the same triangles work for any pose
+        auto source = make_shared<ofMesh>();
+        source->setMode(OF_PRIMITIVE_TRIANGLES);
+        source->getVertices().resize(meshHelper.mesh->mNumVertices);
+        for(unsigned int v = 0; v < meshHelper.mesh->mNumVertices; ++v){
+            const aiVector3D & p = meshHelper.mesh->mVertices[v];
+            source->getVertices()[v] = glm::vec3(p.x, p.y, p.z);
+        }
+        source->getIndices() = meshHelper.indices;
+        meshHelper.lodBounds = ofBoundingBox(source->getVertices());
+        glm::vec3 size = meshHelper.lodBounds.getSize();
+        float extent = max(size.x, max(size.y, size.z));
+
+        typedef vector<pair<vector<ofIndexType>, float>> Levels;
+        ofGetTaskPool().submit([source, numLevels, ratio, extent]{
+            Levels levels;
+            float error = 0;
+            for(size_t level = 1; level < numLevels; level++){
+                size_t numTriangles = source->getNumIndices() / 3;
+                float levelError;
+                auto levelIndices = source->getSimplifiedIndices(size_t(numTriangles * ratio), 1.f, &levelError);
+                if(levelIndices.empty() || levelIndices.size() / 3 >= numTriangles){
+                    break;
+                }
+                error += levelError * extent;
+                source->getIndices() = levelIndices;
+                levels.emplace_back(std::move(levelIndices), error);
+            }
+            return levels;
+        }, [this, current, i](Levels & levels){
+            if(current.expired() || levels.empty()){
+                return;
+            }
+            ofxAssimpMeshHelper & meshHelper = modelMeshes[i];
+            vector<ofIndexType> allIndices = meshHelper.indices;
+            for(auto & level: levels){
+                meshHelper.lodLevels.push_back({allIndices.size(), level.first.size(), level.second});
+                allIndices.insert(allIndices.end(), level.first.begin(), level.first.end());
+            }
+            meshHelper.vbo.setIndexData(&allIndices[0],allIndices.size(),GL_STATIC_DRAW);
+        });
+    }
+}
+
+//-------------------------------------------
+void ofxAssimpModelLoader::selectLod(const ofCamera & camera, float maxScreenError, ofRectangle viewport){
+    for(auto & mesh: modelMeshes){
+        mesh.currentLod = 0;
+        if(mesh.lodLevels.empty()){
+            continue;
+        }
+        // same transformations as draw(), the instances share the level
+        // of the one closest to the camera
+        float pixels = 0;
+        size_t numInstances = std::max<size_t>(mesh.instances.size(), 1);
+        for(size_t n = 0; n < numInstances; n++){
+            glm::mat4 world = glm::mat4(modelMatrix) * glm::mat4(mesh.instances.empty() ? mesh.matrix : mesh.instances[n]);
+            float scale = max(glm::length(glm::vec3(world[0])), max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+            pixels = max(pixels, ofLodMesh::getPixelsPerUnit(camera, mesh.lodBounds.getTransformed(world), viewport) * scale);
+        }
+        for(size_t level = mesh.lodLevels.size(); level > 0; level--){
+            if(mesh.lodLevels[level - 1].error * pixels <= maxScreenError){
+                mesh.currentLod = level;
+                break;
+            }
+        }
+    }
+}
+
 void ofxAssimpModelLoader::setPositionForAllAnimations(float position) {
     for(size_t i = 0; i < animations.size(); i++) {
         animations[i].setPosition(position);
@@ -618,36 +1116,37 @@ void ofxAssimpModelLoader::getBoundingBoxWithMinVector( aiVector3D* min, aiVecto
 	max->x = max->y = max->z = -1e10f;
 
 	for(auto & mesh: modelMeshes){
+		if(hasAnimations()){
+			skinMeshOnCPU(mesh);
+		}
 		this->getBoundingBoxForNode(mesh, min, max);
 	}
 }
 
 //-------------------------------------------
 void ofxAssimpModelLoader::getBoundingBoxForNode(const ofxAssimpMeshHelper & mesh, aiVector3D* min, aiVector3D* max){
-    if (!hasAnimations()){
-        for(unsigned int i = 0; i < mesh.mesh->mNumVertices; i++){
-            auto vertex = mesh.mesh->mVertices[i];
-            auto tmp = ofVec3f(vertex.x,vertex.y,vertex.z) * mesh.matrix;
-            
+    auto add = [&](const aiVector3D & vertex){
+        // every node that draws the mesh
+        size_t numInstances = std::max<size_t>(mesh.instances.size(), 1);
+        for(size_t n = 0; n < numInstances; n++){
+            auto tmp = ofVec3f(vertex.x,vertex.y,vertex.z) * (mesh.instances.empty() ? mesh.matrix : mesh.instances[n]);
+
             min->x = MIN(min->x,tmp.x);
             min->y = MIN(min->y,tmp.y);
             min->z = MIN(min->z,tmp.z);
-            
+
             max->x = MAX(max->x,tmp.x);
             max->y = MAX(max->y,tmp.y);
             max->z = MAX(max->z,tmp.z);
         }
+    };
+    if (!hasAnimations()){
+        for(unsigned int i = 0; i < mesh.mesh->mNumVertices; i++){
+            add(mesh.mesh->mVertices[i]);
+        }
     } else {
         for (auto & animPos: mesh.animatedPos){
-            auto tmp = ofVec3f(animPos.x,animPos.y,animPos.z) * mesh.matrix;
-            
-            min->x = MIN(min->x,tmp.x);
-            min->y = MIN(min->y,tmp.y);
-            min->z = MIN(min->z,tmp.z);
-
-            max->x = MAX(max->x,tmp.x);
-            max->y = MAX(max->y,tmp.y);
-            max->z = MAX(max->z,tmp.z);
+            add(animPos);
         }
     }
 }
@@ -729,16 +1228,39 @@ void ofxAssimpModelLoader::draw(ofPolyRenderMode renderType) {
     for(size_t i = 0; i < modelMeshes.size(); i++) {
         ofxAssimpMeshHelper & mesh = modelMeshes[i];
         
-        ofPushMatrix();
-        ofMultMatrix(mesh.matrix);
-
         if(bUsingTextures){
             if(mesh.hasTexture()) {
                 mesh.getTextureRef().bind();
             }
         }
         
-        if(bUsingMaterials){
+        // the vbo has to have the bind pose, it could have been skinned on
+        // the cpu if gpu skinning was just enabled
+        bool skinOnGPU = hasAnimations() && canSkinOnGPU(mesh)
+            && mesh.vboHasBindPose && mesh.boneMatricesTexture.isAllocated();
+        // meshes shared by several nodes are drawn in one call
+        bool instanced = !skinOnGPU && canDrawInstanced(mesh);
+        if(skinOnGPU){
+            // the mesh material with the skinning vertex function added
+            auto settings = mesh.material.getSettings();
+            settings.preVertex = skinningSource;
+            settings.customAttributes = {
+                {"boneIndices", ofxAssimpMeshHelper::BONE_INDICES_ATTRIBUTE},
+                {"boneWeights", ofxAssimpMeshHelper::BONE_WEIGHTS_ATTRIBUTE},
+            };
+            mesh.skinningMaterial.setup(settings);
+            mesh.skinningMaterial.setCustomUniformTexture("boneMatrices", mesh.boneMatricesTexture, 1);
+            mesh.skinningMaterial.begin();
+        }else if(instanced && bUsingMaterials){
+            // the mesh material with the instance transform added
+            auto settings = mesh.material.getSettings();
+            settings.preVertex = instancingSource;
+            settings.customAttributes = {
+                {"instanceTransform", ofxAssimpMeshHelper::INSTANCE_TRANSFORM_ATTRIBUTE},
+            };
+            mesh.instancingMaterial.setup(settings);
+            mesh.instancingMaterial.begin();
+        }else if(bUsingMaterials){
             mesh.material.begin();
         }
 
@@ -750,24 +1272,51 @@ void ofxAssimpModelLoader::draw(ofPolyRenderMode renderType) {
         }
         
         ofEnableBlendMode(mesh.blendMode);
-        
-#ifndef TARGET_OPENGLES
-        mesh.vbo.drawElements(GL_TRIANGLES,mesh.indices.size());
-#else
+
+        size_t numIndices = mesh.indices.size();
+        size_t offset = 0;
+        if(mesh.currentLod > 0 && mesh.currentLod <= mesh.lodLevels.size()){
+            numIndices = mesh.lodLevels[mesh.currentLod - 1].count;
+            offset = mesh.lodLevels[mesh.currentLod - 1].offset;
+        }
+
+        GLenum mode = GL_TRIANGLES;
+#ifdef TARGET_OPENGLES
         switch(renderType){
 		    case OF_MESH_FILL:
-		    	mesh.vbo.drawElements(GL_TRIANGLES,mesh.indices.size());
 		    	break;
 		    case OF_MESH_WIREFRAME:
                 //note this won't look the same as on non ES renderers.
                 //there is no easy way to convert GL_TRIANGLES to outlines for each triangle
-		    	mesh.vbo.drawElements(GL_LINES,mesh.indices.size());
+		    	mode = GL_LINES;
 		    	break;
 		    case OF_MESH_POINTS:
-		    	mesh.vbo.drawElements(GL_POINTS,mesh.indices.size());
+		    	mode = GL_POINTS;
 		    	break;
         }
 #endif
+
+        if(instanced){
+            uploadInstances(mesh);
+            // without materials the default shaders read the same attribute
+            auto renderer = static_cast<ofGLProgrammableRenderer*>(ofGetGLRenderer().get());
+            if(!bUsingMaterials){
+                renderer->setInstancing(true, false);
+            }
+            mesh.vbo.drawElementsInstanced(mode,numIndices,mesh.instances.size(),offset);
+            if(!bUsingMaterials){
+                renderer->setInstancing(false, false);
+            }
+        }else{
+            // meshes no node references are still drawn once
+            size_t numInstances = std::max<size_t>(mesh.instances.size(), 1);
+            for(size_t n = 0; n < numInstances; n++){
+                ofPushMatrix();
+                ofMultMatrix(mesh.instances.empty() ? mesh.matrix : mesh.instances[n]);
+                mesh.vbo.drawElements(mode,numIndices,offset);
+                ofPopMatrix();
+            }
+        }
         
         if(bUsingTextures){
             if(mesh.hasTexture()) {
@@ -775,11 +1324,13 @@ void ofxAssimpModelLoader::draw(ofPolyRenderMode renderType) {
             }
         }
         
-        if(bUsingMaterials){
+        if(skinOnGPU){
+            mesh.skinningMaterial.end();
+        }else if(instanced && bUsingMaterials){
+            mesh.instancingMaterial.end();
+        }else if(bUsingMaterials){
             mesh.material.end();
         }
-        
-        ofPopMatrix();
     }
     
     #ifndef TARGET_OPENGLES
@@ -850,6 +1401,9 @@ ofMesh ofxAssimpModelLoader::getCurrentAnimatedMesh(string name){
 				modelMeshes[i].cachedMesh.clearVertices();
 				modelMeshes[i].cachedMesh.clearNormals();
 				if(hasAnimations()){
+					// with gpu skinning the pose is only calculated on the
+					// cpu when it's asked for
+					skinMeshOnCPU(modelMeshes[i]);
 					modelMeshes[i].cachedMesh.addVertices(aiVecVecToOfVecVec(modelMeshes[i].animatedPos));
 					modelMeshes[i].cachedMesh.addNormals(aiVecVecToOfVecVec(modelMeshes[i].animatedNorm));
 				}
@@ -872,6 +1426,9 @@ ofMesh ofxAssimpModelLoader::getCurrentAnimatedMesh(unsigned int num){
 		return ofMesh();
 	}
 	if(!modelMeshes[num].validCache){
+		if(hasAnimations()){
+			skinMeshOnCPU(modelMeshes[num]);
+		}
 		modelMeshes[num].cachedMesh.clearVertices();
 		modelMeshes[num].cachedMesh.clearNormals();
 		modelMeshes[num].cachedMesh.addVertices(aiVecVecToOfVecVec(modelMeshes[num].animatedPos));
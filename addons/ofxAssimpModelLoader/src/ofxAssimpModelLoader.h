@@ -30,11 +30,68 @@ class ofxAssimpModelLoader{
 
         bool loadModel(string modelName, bool optimize=false);
         bool loadModel(ofBuffer & buffer, bool optimize=false, const char * extension="");
+
+        /// Loads a model without blocking the app. The file is imported,
+        /// its meshes converted and its textures decoded in the task pool,
+        /// then they are uploaded from the update event, as many meshes per
+        /// frame as fit in setMaxUploadTimePerFrame(). The current model
+        /// keeps being drawn until the new one replaces it, right before
+        /// loadedEvent is notified. Loading another model or clear() cancel
+        /// it. Has to be called from the main thread.
+        ///
+        /// ~~~~{.cpp}
+        /// void ofApp::setup(){
+        ///     ofAddListener(model.loadedEvent, this, &ofApp::modelLoaded);
+        ///     model.loadModelAsync("city.fbx");
+        /// }
+        ///
+        /// void ofApp::draw(){
+        ///     if(model.isLoading()){
+        ///         ofDrawBitmapString(ofToString(model.getLoadingProgress() * 100, 0) + "%", 20, 20);
+        ///     }
+        ///     model.drawFaces();
+        /// }
+        /// ~~~~
+        void loadModelAsync(string modelName, bool optimize=false);
+        bool isLoading() const;
+
+        /// Progress of the last loadModelAsync() from 0 to 1, the first
+        /// half while importing and the second one while uploading
+        float getLoadingProgress() const;
+
+        /// Maximum milliseconds spent uploading meshes per frame while
+        /// loading asynchronously, 2ms by default, 0 for no limit. At least
+        /// one mesh is uploaded every frame, even if it takes longer.
+        void setMaxUploadTimePerFrame(float ms);
+        float getMaxUploadTimePerFrame() const;
+
+        /// Notified from the main thread with the progress of the model
+        /// being loaded asynchronously
+        ofEvent<float> loadProgressEvent;
+
+        /// Notified once an asynchronous load finishes, false if it failed
+        ofEvent<bool> loadedEvent;
+
         void createEmptyModel();
         void createLightsFromAiModel();
         void optimizeScene();
 
         void update();
+
+        /// Same as calling update() on every model, with the animations,
+        /// bone matrices and cpu skinning of all of them evaluated in
+        /// parallel on the task pool. Only the bone textures and vertices
+        /// are uploaded from the main thread, after all of them finish.
+        /// The models can't share their animations or meshes.
+        ///
+        /// ~~~~{.cpp}
+        /// vector<ofxAssimpModelLoader*> crowd;
+        ///
+        /// void ofApp::update(){
+        ///     ofxAssimpModelLoader::updateModels(crowd);
+        /// }
+        /// ~~~~
+        static void updateModels(const vector<ofxAssimpModelLoader*> & models);
     
         bool hasAnimations();
         unsigned int getAnimationCount();
@@ -45,6 +102,33 @@ class ofxAssimpModelLoader{
         void setPausedForAllAnimations(bool pause);
         void setLoopStateForAllAnimations(ofLoopType state);
         void setPositionForAllAnimations(float position);
+
+        /// Skins the animated meshes in the vertex shader instead of on
+        /// the cpu, enabled by default. It's only used with the
+        /// programmable renderer on desktop GL and with materials enabled,
+        /// otherwise the meshes are skinned on the cpu.
+        void setUseGPUSkinning(bool useGPUSkinning);
+        bool isUsingGPUSkinning();
+
+        /// Generates simplified versions of every mesh on the task pool,
+        /// each with ratio of the triangles of the previous one, see
+        /// ofMesh::getSimplifiedIndices(). They are drawn instead of the
+        /// full meshes after selectLod() and work with animations too.
+        void setupLod(size_t numLevels = 4, float ratio = 0.5f);
+
+        /// Reorders the triangles of every mesh for the vertex cache and
+        /// overdraw, in parallel on the task pool, when the next models
+        /// are loaded, see ofMesh::optimizeVertexCache(). Disabled by
+        /// default, loading with optimize=true lets assimp improve the
+        /// cache locality instead. The vertices keep their order since
+        /// the animations update them in place.
+        void setOptimizeTriangleOrder(bool optimizeTriangleOrder);
+        bool isOptimizingTriangleOrder();
+
+        /// Picks the level of every mesh drawn by the next draw() calls,
+        /// the coarsest one whose error projected from camera is smaller
+        /// than maxScreenError pixels, see ofLodMesh.
+        void selectLod(const ofCamera & camera, float maxScreenError = 1, ofRectangle viewport = ofRectangle());
         OF_DEPRECATED_MSG("Use ofxAssimpAnimation instead", void setAnimation(int animationIndex));
         OF_DEPRECATED_MSG("Use ofxAssimpAnimation instead", void setNormalizedTime(float time));
         OF_DEPRECATED_MSG("Use ofxAssimpAnimation instead", void setTime(float time));
@@ -114,16 +198,47 @@ class ofxAssimpModelLoader{
          
     protected:
         void updateAnimations();
+        void updateScene(); // everything update() does before touching GL
         void updateMeshes(aiNode * node, ofMatrix4x4 parentMatrix);
         void updateBones();
         void updateModelMatrix();
+        void skinMeshOnCPU(ofxAssimpMeshHelper & mesh);
+        bool canSkinOnGPU(const ofxAssimpMeshHelper & mesh);
+        bool canDrawInstanced(const ofxAssimpMeshHelper & mesh);
+        void uploadInstances(ofxAssimpMeshHelper & mesh);
+        void uploadBoneMatrices(ofxAssimpMeshHelper & mesh);
     
         // ai scene setup
         unsigned int initImportProperties(bool optimize);
         bool processScene();
 
+        // cpu side of a model being loaded, imported and converted by
+        // prepareModel() in any thread, then uploaded one mesh at a time
+        struct LoadingMesh{
+            ofMesh mesh;
+            vector<ofIndexType> indices;
+            string texturePath;
+            vector<ofVec4f> boneIndices;
+            vector<ofVec4f> boneWeights;
+        };
+        struct LoadingModel{
+            shared_ptr<const aiScene> scene;
+            shared_ptr<aiPropertyStore> store;
+            ofFile file;
+            vector<LoadingMesh> meshes;
+            map<string, shared_ptr<const ofPixels>> images; // decoded textures by path, from ofGetAssetCache()
+            vector<ofxAssimpMeshHelper> meshHelpers;
+            vector<ofxAssimpTexture> textures;
+            size_t numUploaded = 0;
+        };
+        static void prepareModel(LoadingModel & model, bool optimizeTriangleOrder);
+
         // Initial VBO creation, etc
-        void loadGLResources();
+        void loadGLResources(LoadingModel & model, size_t meshIndex);
+        void finishLoading(LoadingModel & model);
+        void updateLoading(ofEventArgs & args);
+        void notifyLoadingProgress(float progress);
+        void cancelLoading();
     
         // updates the *actual GL resources* for the current animation
         void updateGLResources();
@@ -154,6 +269,14 @@ class ofxAssimpModelLoader{
         bool bUsingNormals;
         bool bUsingColors;
         bool bUsingMaterials;
+        bool bUsingGPUSkinning;
+        bool bOptimizeTriangleOrder;
+        // levels of a previous model still being generated are dropped
+        shared_ptr<bool> lodGeneration;
+        shared_ptr<LoadingModel> loading;
+        shared_ptr<bool> loadGeneration;
+        float maxUploadTime;
+        float loadingProgress;
         float normalizeFactor;
 
         // the main Asset Import scene that does the magic.
@@ -9,16 +9,22 @@
 #include "ofConstants.h"
 
 ofxAssimpTexture::ofxAssimpTexture() {
+    texture = make_shared<ofTexture>();
     texturePath = "";
 }
 
 ofxAssimpTexture::ofxAssimpTexture(ofTexture texture, string texturePath) {
-    this->texture = texture;
+    this->texture = make_shared<ofTexture>(texture);
+    this->texturePath = texturePath;
+}
+
+ofxAssimpTexture::ofxAssimpTexture(shared_ptr<ofTexture> texture, string texturePath) {
+    this->texture = texture ? texture : make_shared<ofTexture>();
     this->texturePath = texturePath;
 }
 
 ofTexture & ofxAssimpTexture::getTextureRef() {
-    return texture;
+    return *texture;
 }
 
 string ofxAssimpTexture::getTexturePath() {
@@ -26,5 +32,5 @@ string ofxAssimpTexture::getTexturePath() {
 }
 
 bool ofxAssimpTexture::hasTexture() {
-    return texture.isAllocated();
+    return texture->isAllocated();
 }
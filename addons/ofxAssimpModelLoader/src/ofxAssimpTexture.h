@@ -15,6 +15,7 @@ public:
     
     ofxAssimpTexture();
     ofxAssimpTexture(ofTexture texture, string texturePath);
+    ofxAssimpTexture(shared_ptr<ofTexture> texture, string texturePath);
 
     ofTexture & getTextureRef();
     string getTexturePath();
@@ -22,7 +23,8 @@ public:
     
 private:
     
-    ofTexture texture;
+    // shared with every mesh and model using the same file
+    shared_ptr<ofTexture> texture;
     string texturePath;
     
 };
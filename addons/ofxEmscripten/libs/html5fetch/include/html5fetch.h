@@ -0,0 +1,16 @@
+#pragma once
+
+extern "C"{
+	typedef void (*html5fetch_chunk_callback)(int id, const char * data, int size);
+	typedef void (*html5fetch_done_callback)(int id, int status, const char * data, int size, const char * headers, const char * error);
+	typedef void (*html5fetch_image_callback)(int id, int width, int height, const char * error);
+
+	extern void html5fetch_set_cache(int enabled);
+	extern void html5fetch_clear_cache();
+
+	extern void html5fetch_request(int id, const char * url, const char * method, const char * headers, const char * body, int bodySize, int useCache, int stream, html5fetch_chunk_callback chunkCallback, html5fetch_done_callback doneCallback);
+	extern void html5fetch_abort(int id);
+
+	extern void html5fetch_load_image(int id, const char * url, html5fetch_image_callback callback);
+	extern void html5fetch_upload_image(int id, int textureId);
+}
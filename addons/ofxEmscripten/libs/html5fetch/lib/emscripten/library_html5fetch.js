@@ -0,0 +1,285 @@
+var LibraryHTML5Fetch = {
+    $FETCH__deps: ['malloc', 'free'],
+    $FETCH: {
+        requests: {},
+        images: {},
+        cacheEnabled: false,
+        db: null,
+
+        openCache: function(){
+        	if(!FETCH.db){
+        		FETCH.db = new Promise(function(resolve){
+        			if(typeof indexedDB === 'undefined'){
+        				resolve(null);
+        				return;
+        			}
+        			try{
+	        			var open = indexedDB.open('openFrameworks_url_cache', 1);
+	        			open.onupgradeneeded = function(){
+	        				open.result.createObjectStore('responses');
+	        			};
+	        			open.onsuccess = function(){ resolve(open.result); };
+	        			open.onerror = function(){ resolve(null); };
+        			}catch(e){
+        				resolve(null);
+        			}
+        		});
+        	}
+        	return FETCH.db;
+        },
+
+        cacheGet: function(url){
+        	return FETCH.openCache().then(function(db){
+        		if(!db) return null;
+        		return new Promise(function(resolve){
+        			try{
+	        			var get = db.transaction('responses', 'readonly').objectStore('responses').get(url);
+	        			get.onsuccess = function(){ resolve(get.result || null); };
+	        			get.onerror = function(){ resolve(null); };
+        			}catch(e){
+        				resolve(null);
+        			}
+        		});
+        	});
+        },
+
+        cachePut: function(url, entry){
+        	FETCH.openCache().then(function(db){
+        		if(!db) return;
+        		try{
+        			db.transaction('responses', 'readwrite').objectStore('responses').put(entry, url);
+        		}catch(e){
+        			// quota exceeded or private mode, the response is just not stored
+        		}
+        	});
+        },
+
+        isStorable: function(headers){
+        	return !/no-store/.test(headers['cache-control'] || '');
+        },
+
+        isFresh: function(entry){
+        	var cacheControl = entry.headers['cache-control'] || '';
+        	if(/no-cache/.test(cacheControl)) return false;
+        	var maxAge = /max-age=(\d+)/.exec(cacheControl);
+        	if(maxAge) return (Date.now() - entry.time) / 1000 < parseInt(maxAge[1]);
+        	if(entry.headers['expires']) return Date.now() < Date.parse(entry.headers['expires']);
+        	return false;
+        },
+
+        parseHeaders: function(str){
+        	var headers = {};
+        	str.split('\r\n').forEach(function(line){
+        		var colon = line.indexOf(':');
+        		if(colon > 0){
+        			headers[line.substring(0, colon).trim()] = line.substring(colon + 1).trim();
+        		}
+        	});
+        	return headers;
+        },
+
+        headersToString: function(headers){
+        	var str = '';
+        	for(var key in headers){
+        		str += key + ': ' + headers[key] + '\r\n';
+        	}
+        	return str;
+        },
+
+        allocateString: function(str){
+        	var size = lengthBytesUTF8(str) + 1;
+        	var ptr = _malloc(size);
+        	stringToUTF8(str, ptr, size);
+        	return ptr;
+        },
+
+        // resolves with {status, statusText, headers, data}, the body is
+        // read in chunks as it arrives and passed to onChunk if it's set
+        // instead of being kept in data
+        load: function(id, url, init, useCache, onChunk){
+        	if(typeof AbortController !== 'undefined'){
+        		var controller = new AbortController();
+        		init.signal = controller.signal;
+        		FETCH.requests[id] = controller;
+        	}else{
+        		FETCH.requests[id] = { abort: function(){} };
+        	}
+        	var cached = useCache && FETCH.cacheEnabled ? FETCH.cacheGet(url) : Promise.resolve(null);
+        	return cached.then(function(entry){
+        		if(entry && FETCH.isFresh(entry)) return entry;
+        		if(entry){
+        			if(entry.headers['etag']) init.headers['If-None-Match'] = entry.headers['etag'];
+        			if(entry.headers['last-modified']) init.headers['If-Modified-Since'] = entry.headers['last-modified'];
+        		}
+        		return fetch(url, init).then(function(response){
+        			if(response.status == 304 && entry){
+        				entry.time = Date.now();
+        				FETCH.cachePut(url, entry);
+        				return entry;
+        			}
+        			var result = { status: response.status, statusText: response.statusText, headers: {}, time: Date.now() };
+        			response.headers.forEach(function(value, key){
+        				result.headers[key.toLowerCase()] = value;
+        			});
+        			var chunks = [];
+        			var length = 0;
+        			var received = function(chunk){
+        				if(onChunk){
+        					onChunk(chunk);
+        				}else{
+        					chunks.push(chunk);
+        					length += chunk.length;
+        				}
+        			};
+        			var finish = function(){
+        				result.data = new Uint8Array(length);
+        				for(var i = 0, offset = 0; i < chunks.length; offset += chunks[i].length, i++){
+        					result.data.set(chunks[i], offset);
+        				}
+        				if(useCache && FETCH.cacheEnabled && !onChunk && response.ok && FETCH.isStorable(result.headers)){
+        					FETCH.cachePut(url, result);
+        				}
+        				return result;
+        			};
+        			if(!response.body || !response.body.getReader){
+        				return response.arrayBuffer().then(function(buffer){
+        					received(new Uint8Array(buffer));
+        					return finish();
+        				});
+        			}
+        			var reader = response.body.getReader();
+        			var pump = function(){
+        				return reader.read().then(function(read){
+        					if(read.done) return finish();
+        					// the request could have been removed while reading
+        					if(!(id in FETCH.requests)){
+        						reader.cancel();
+        						return finish();
+        					}
+        					received(read.value);
+        					return pump();
+        				});
+        			};
+        			return pump();
+        		});
+        	});
+        },
+
+        decode: function(blob){
+        	if(typeof createImageBitmap !== 'undefined'){
+        		return createImageBitmap(blob, { premultiplyAlpha: 'none', colorSpaceConversion: 'none' });
+        	}
+        	// decoded by the browser once loaded, only slower to upload
+        	return new Promise(function(resolve, reject){
+        		var image = new Image();
+        		var src = URL.createObjectURL(blob);
+        		image.onload = function(){ URL.revokeObjectURL(src); resolve(image); };
+        		image.onerror = function(){ URL.revokeObjectURL(src); reject(new Error('can\'t decode image')); };
+        		image.src = src;
+        	});
+        },
+    },
+
+    html5fetch_set_cache: function(enabled){
+    	FETCH.cacheEnabled = enabled != 0;
+    	if(FETCH.cacheEnabled) FETCH.openCache();
+    },
+
+    html5fetch_clear_cache: function(){
+    	FETCH.openCache().then(function(db){
+    		if(!db) return;
+    		try{
+    			db.transaction('responses', 'readwrite').objectStore('responses').clear();
+    		}catch(e){}
+    	});
+    },
+
+    html5fetch_request: function(id, url, method, headers, body, bodySize, useCache, stream, chunkCallback, doneCallback){
+    	var init = {
+    		method: Pointer_stringify(method),
+    		headers: FETCH.parseHeaders(Pointer_stringify(headers)),
+    	};
+    	if(bodySize > 0){
+    		init.body = Module.HEAPU8.slice(body, body + bodySize);
+    	}
+    	var onChunk = null;
+    	if(stream){
+    		onChunk = function(chunk){
+    			var ptr = _malloc(chunk.length);
+    			Module.HEAPU8.set(chunk, ptr);
+    			Runtime.dynCall('viii', chunkCallback, [id, ptr, chunk.length]);
+    			_free(ptr);
+    		};
+    	}
+    	FETCH.load(id, Pointer_stringify(url), init, useCache, onChunk).then(function(result){
+    		if(!(id in FETCH.requests)) return;
+    		delete FETCH.requests[id];
+    		var data = _malloc(Math.max(result.data.length, 1));
+    		Module.HEAPU8.set(result.data, data);
+    		var resultHeaders = FETCH.allocateString(FETCH.headersToString(result.headers));
+    		var error = FETCH.allocateString(result.statusText || '');
+    		Runtime.dynCall('viiiiii', doneCallback, [id, result.status, data, result.data.length, resultHeaders, error]);
+    		_free(error);
+    		_free(resultHeaders);
+    		_free(data);
+    	}).catch(function(e){
+    		if(!(id in FETCH.requests)) return;
+    		delete FETCH.requests[id];
+    		var error = FETCH.allocateString(e.message || String(e));
+    		Runtime.dynCall('viiiiii', doneCallback, [id, -1, 0, 0, 0, error]);
+    		_free(error);
+    	});
+    },
+
+    html5fetch_abort: function(id){
+    	var request = FETCH.requests[id];
+    	if(request){
+    		delete FETCH.requests[id];
+    		request.abort();
+    	}
+    	var image = FETCH.images[id];
+    	if(image){
+    		delete FETCH.images[id];
+    		if(image.close) image.close();
+    	}
+    },
+
+    html5fetch_load_image: function(id, url, callback){
+    	FETCH.load(id, Pointer_stringify(url), { method: 'GET', headers: {} }, true, null).then(function(result){
+    		if(result.status < 200 || result.status >= 300){
+    			throw new Error(result.status + ' ' + result.statusText);
+    		}
+    		var type = result.headers['content-type'] || '';
+    		return FETCH.decode(new Blob([result.data], { type: type }));
+    	}).then(function(image){
+    		if(!(id in FETCH.requests)){
+    			if(image.close) image.close();
+    			return;
+    		}
+    		delete FETCH.requests[id];
+    		FETCH.images[id] = image;
+    		Runtime.dynCall('viiii', callback, [id, image.width, image.height, 0]);
+    	}).catch(function(e){
+    		if(!(id in FETCH.requests)) return;
+    		delete FETCH.requests[id];
+    		var error = FETCH.allocateString(e.message || String(e));
+    		Runtime.dynCall('viiii', callback, [id, 0, 0, error]);
+    		_free(error);
+    	});
+    },
+
+    html5fetch_upload_image: function(id, textureId){
+    	var image = FETCH.images[id];
+    	if(!image) return;
+    	delete FETCH.images[id];
+    	GLctx.bindTexture(GLctx.TEXTURE_2D, GL.textures[textureId]);
+    	GLctx.pixelStorei(GLctx.UNPACK_FLIP_Y_WEBGL, false);
+    	GLctx.pixelStorei(GLctx.UNPACK_PREMULTIPLY_ALPHA_WEBGL, false);
+    	GLctx.texImage2D(GLctx.TEXTURE_2D, 0, GLctx.RGBA, GLctx.RGBA, GLctx.UNSIGNED_BYTE, image);
+    	GLctx.bindTexture(GLctx.TEXTURE_2D, null);
+    	if(image.close) image.close();
+    },
+};
+
+autoAddDeps(LibraryHTML5Fetch, '$FETCH');
+mergeInto(LibraryManager.library, LibraryHTML5Fetch);
@@ -58,7 +58,10 @@ void ofxAppEmscriptenWindow::setup(const ofGLESWindowSettings & settings){
 	EGLint majorVersion;
 	EGLint minorVersion;
 	EGLConfig config;
-	EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE, EGL_NONE };
+	// glesVersion 3 asks for a WebGL 2 context, which turns on VAOs,
+	// instancing and integer textures
+	int glesVersion = settings.glesVersion >= 3 ? 3 : 2;
+	EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, glesVersion, EGL_NONE, EGL_NONE };
 	EGLint attribList[] =
 	   {
 		   EGL_RED_SIZE, EGL_DONT_CARE,
@@ -107,6 +110,12 @@ void ofxAppEmscriptenWindow::setup(const ofGLESWindowSettings & settings){
 
 	// Create a GL context
 	context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs );
+	if ( context == EGL_NO_CONTEXT && glesVersion == 3 ){
+		ofLogWarning("ofxAppEmscriptenWindow") << "the browser doesn't support WebGL 2, falling back to WebGL 1";
+		glesVersion = 2;
+		contextAttribs[1] = glesVersion;
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs );
+	}
 	if ( context == EGL_NO_CONTEXT ){
 		ofLogError() << "couldn't create context";
 	    return;
@@ -121,7 +130,7 @@ void ofxAppEmscriptenWindow::setup(const ofGLESWindowSettings & settings){
 	setWindowShape(settings.width,settings.height);
 
 	_renderer = make_shared<ofGLProgrammableRenderer>(this);
-	((ofGLProgrammableRenderer*)_renderer.get())->setup(2,0);
+	((ofGLProgrammableRenderer*)_renderer.get())->setup(glesVersion,0);
 
     emscripten_set_keydown_callback(0,this,1,&keydown_cb);
     emscripten_set_keyup_callback(0,this,1,&keyup_cb);
@@ -6,10 +6,53 @@
  */
 
 #include "ofxEmscriptenURLFileLoader.h"
-#include <emscripten/emscripten.h>
+#include "ofTexture.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include "html5fetch.h"
+#include <map>
 
 using namespace std;
 
+namespace{
+	struct TextureRequest{
+		string url;
+		function<void(shared_ptr<ofTexture>)> loaded;
+	};
+
+	// requests waiting for the browser, the js side only knows their id so
+	// removed ones are simply not found when their callbacks arrive
+	map<int, ofHttpRequest> & pendingRequests(){
+		static map<int, ofHttpRequest> requests;
+		return requests;
+	}
+
+	map<int, TextureRequest> & pendingTextures(){
+		static map<int, TextureRequest> textures;
+		return textures;
+	}
+
+	void onimage_cb(int id, int width, int height, const char * error){
+		auto it = pendingTextures().find(id);
+		if(it == pendingTextures().end()){
+			html5fetch_abort(id);
+			return;
+		}
+		auto request = std::move(it->second);
+		pendingTextures().erase(it);
+
+		shared_ptr<ofTexture> texture;
+		if(width > 0 && height > 0){
+			texture = make_shared<ofTexture>();
+			texture->allocate(width, height, GL_RGBA);
+			html5fetch_upload_image(id, texture->getTextureData().textureID);
+		}else{
+			ofLogError("ofxEmscriptenURLFileLoader") << "loadTextureAsync(): couldn't load \"" << request.url << "\": " << (error ? error : "");
+		}
+		request.loaded(texture);
+	}
+}
+
 ofxEmscriptenURLFileLoader::ofxEmscriptenURLFileLoader() {
 }
 
@@ -22,11 +65,8 @@ ofHttpResponse ofxEmscriptenURLFileLoader::get(const string & url){
 }
 
 int ofxEmscriptenURLFileLoader::getAsync(const string &  url, const string &  name){
-	ofHttpRequest * req = new ofHttpRequest(url,name,false);
-#if __EMSCRIPTEN_major__>1 || (__EMSCRIPTEN_major__==1 && __EMSCRIPTEN_minor__>22)
-	emscripten_async_wget2_data(url.c_str(), "GET", "", req, true, &onload_cb, &onerror_cb, NULL);
-#endif
-	return req->getId();
+	ofHttpRequest request(url,name,false);
+	return handleRequestAsync(request);
 }
 
 ofHttpResponse ofxEmscriptenURLFileLoader::saveTo(const string &  url, const std::filesystem::path &  path){
@@ -35,65 +75,111 @@ ofHttpResponse ofxEmscriptenURLFileLoader::saveTo(const string &  url, const std
 }
 
 int ofxEmscriptenURLFileLoader::saveAsync(const string &  url, const std::filesystem::path &  path){
-	ofHttpRequest * req = new ofHttpRequest(url,url,true);
-#if __EMSCRIPTEN_major__>1 || (__EMSCRIPTEN_major__==1 && __EMSCRIPTEN_minor__>22)
-	emscripten_async_wget2(url.c_str(), path.c_str(), "GET", "", req, &onload_file_cb, &onerror_file_cb, NULL);
-#endif
-	return 0;
+	ofHttpRequest request(url,path.string(),true);
+	return handleRequestAsync(request);
 }
 
-ofHttpResponse handleRequest(const ofHttpRequest & request){
-	ofLogWarning() << "handleRequest is still not implemented on emscripten";
+ofHttpResponse ofxEmscriptenURLFileLoader::handleRequest(const ofHttpRequest & request){
+	handleRequestAsync(request);
 	return ofHttpResponse();
 }
 
-int handleRequestAsync(const ofHttpRequest & request){
-	ofLogWarning() << "handleRequest is still not implemented on emscripten";
-	return -1;
+int ofxEmscriptenURLFileLoader::handleRequestAsync(const ofHttpRequest & request){
+	string headers;
+	for(auto & header: request.headers){
+		headers += header.first + ": " + header.second + "\r\n";
+	}
+	if(!request.contentType.empty()){
+		headers += "Content-Type: " + request.contentType + "\r\n";
+	}
+	string method = request.method == ofHttpRequest::POST ? "POST" : "GET";
+	bool stream = bool(request.chunkReceived);
+	bool useCache = request.method == ofHttpRequest::GET && request.body.empty() && !request.saveTo && !stream;
+
+	int id = request.getId();
+	pendingRequests()[id] = request;
+	html5fetch_request(id, request.url.c_str(), method.c_str(), headers.c_str(),
+		request.body.c_str(), request.body.size(), useCache, stream, &onchunk_cb, &ondone_cb);
+	return id;
 }
 
 void ofxEmscriptenURLFileLoader::remove(int id){
-
+	html5fetch_abort(id);
+	pendingRequests().erase(id);
+	pendingTextures().erase(id);
 }
 
 void ofxEmscriptenURLFileLoader::clear(){
-
+	for(auto & request: pendingRequests()){
+		html5fetch_abort(request.first);
+	}
+	for(auto & texture: pendingTextures()){
+		html5fetch_abort(texture.first);
+	}
+	pendingRequests().clear();
+	pendingTextures().clear();
 }
 
 void ofxEmscriptenURLFileLoader::stop(){
-
+	clear();
 }
 
-void ofxEmscriptenURLFileLoader::onload_cb(unsigned, void* request, void* data, unsigned int size){
-	ofHttpResponse response;
-	response.data.set((const char*)data,size);
-	response.status = 200;
-	response.request = *(ofHttpRequest*)request;
-	ofNotifyEvent(ofURLResponseEvent(),response);
-	delete (ofHttpRequest*)request;
+void ofxEmscriptenURLFileLoader::setCache(std::shared_ptr<ofHttpCache> cache){
+	// the browser's storage outlives the page, unlike the in memory
+	// file system where the cache would store its files
+	html5fetch_set_cache(cache != nullptr);
 }
 
-void ofxEmscriptenURLFileLoader::onerror_cb(unsigned, void* request, int status, const char* message){
-	ofHttpResponse response;
-	response.status = status;
-	response.error = message;
-	response.request = *(ofHttpRequest*)request;
-	ofNotifyEvent(ofURLResponseEvent(),response);
-	delete (ofHttpRequest*)request;
+void ofxEmscriptenURLFileLoader::onchunk_cb(int id, const char * data, int size){
+	auto it = pendingRequests().find(id);
+	if(it == pendingRequests().end()){
+		return;
+	}
+	it->second.chunkReceived(ofBuffer(data, size));
 }
 
-void ofxEmscriptenURLFileLoader::onload_file_cb(unsigned, void* request, const char* file){
+void ofxEmscriptenURLFileLoader::ondone_cb(int id, int status, const char * data, int size, const char * headers, const char * error){
+	auto it = pendingRequests().find(id);
+	if(it == pendingRequests().end()){
+		return;
+	}
 	ofHttpResponse response;
-	response.status = 200;
-	response.request = *(ofHttpRequest*)request;
-	ofNotifyEvent(ofURLResponseEvent(),response);
-	delete (ofHttpRequest*)request;
-}
+	response.request = std::move(it->second);
+	pendingRequests().erase(it);
 
-void ofxEmscriptenURLFileLoader::onerror_file_cb(unsigned, void* request, int status){
-	ofHttpResponse response;
 	response.status = status;
-	response.request = *(ofHttpRequest*)request;
+	if(error){
+		response.error = error;
+	}
+	if(headers){
+		for(auto & line: ofSplitString(headers, "\r\n", true)){
+			auto colon = line.find(':');
+			if(colon != string::npos){
+				response.headers[ofToLower(line.substr(0, colon))] = ofTrim(line.substr(colon + 1));
+			}
+		}
+	}
+	if(data && size > 0){
+		response.data.set(data, size);
+	}
+	if(response.request.saveTo && status >= 200 && status < 300){
+		ofBufferToFile(response.request.name, response.data, true);
+		response.data.clear();
+	}
+
+	if(response.request.done){
+		try{
+			response.request.done(response);
+		}catch(...){
+
+		}
+	}
 	ofNotifyEvent(ofURLResponseEvent(),response);
-	delete (ofHttpRequest*)request;
+}
+
+int ofxEmscriptenLoadTextureAsync(const std::string & url, std::function<void(std::shared_ptr<ofTexture>)> loaded){
+	ofHttpRequest request(url,url);
+	pendingTextures()[request.getId()] = {url, loaded};
+	html5fetch_load_image(request.getId(), url.c_str(), &onimage_cb);
+	return request.getId();
 }
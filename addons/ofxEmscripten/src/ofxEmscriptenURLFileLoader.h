@@ -7,7 +7,23 @@
 #pragma once
 #include "ofURLFileLoader.h"
 #include "ofBaseTypes.h"
+#include <functional>
+#include <memory>
 
+class ofTexture;
+
+/// \brief Loads urls with the browser's fetch API
+///
+/// Requests never block the page, the body is read as it arrives and
+/// passed to the request's chunkReceived if it's set. Once a cache is set
+/// with ofSetURLCache() GET requests are stored in the browser's IndexedDB
+/// instead of the cache's directory, which wouldn't survive a reload, and
+/// are answered from there following their Cache-Control, ETag and
+/// Last-Modified headers.
+///
+/// The blocking get(), saveTo() and handleRequest() can't wait on the
+/// browser's main thread, they start the request and return an empty
+/// response, the real one is notified through ofURLResponseEvent().
 class ofxEmscriptenURLFileLoader: public ofBaseURLFileLoader {
 public:
 	ofxEmscriptenURLFileLoader();
@@ -21,10 +37,25 @@ public:
 	void remove(int id);
 	void clear();
 	void stop();
+	void setCache(std::shared_ptr<ofHttpCache> cache);
 
 private:
-	static void onload_cb(unsigned, void* request, void* data, unsigned int size);
-	static void onerror_cb(unsigned, void* request, int status, const char* msg);
-	static void onload_file_cb(unsigned, void* request, const char* file);
-	static void onerror_file_cb(unsigned, void* request, int status);
+	static void onchunk_cb(int id, const char * data, int size);
+	static void ondone_cb(int id, int status, const char * data, int size, const char * headers, const char * error);
 };
+
+/// \brief Downloads and decodes the image at url with the browser, out of
+/// the main thread, and uploads it straight to a texture
+///
+/// loaded is called with the texture once it's ready or with nullptr if the
+/// image can't be loaded. The pixels never go through the app's memory, use
+/// ofLoadImage() if they are needed on the CPU:
+///
+/// ~~~~{.cpp}
+/// ofxEmscriptenLoadTextureAsync("https://example.com/sky.jpg", [this](std::shared_ptr<ofTexture> texture){
+///     sky = texture;
+/// });
+/// ~~~~
+///
+/// \returns the id of the request, it can be cancelled with ofRemoveURLRequest()
+int ofxEmscriptenLoadTextureAsync(const std::string & url, std::function<void(std::shared_ptr<ofTexture>)> loaded);
@@ -83,6 +83,11 @@ ofxBaseGui::ofxBaseGui(){
 
 	bRegisteredForMouseEvents = false;
 	needsRedraw = true;
+	needsBatch = true;
+	bBatched = false;
+	bBatchChanged = false;
+	batchShapesStart = batchShapesSize = 0;
+	batchTextStart = batchTextSize = 0;
 
 	/*if(!fontLoaded){
 	    loadFont(OF_TTF_MONO,10,true,true);
@@ -139,6 +144,34 @@ void ofxBaseGui::draw(){
 	render();
 }
 
+bool ofxBaseGui::updateBatch(){
+	currentFrame = ofGetFrameNum();
+	bool batchable = canBatch();
+	if(!needsBatch && batchable == bBatched){
+		return false;
+	}
+	if(needsRedraw){
+		generateDraw();
+		needsRedraw = false;
+	}
+	batch.clear();
+	if(batchable){
+		generateBatch(batch);
+	}
+	bBatched = batchable;
+	needsBatch = false;
+	bBatchChanged = true;
+	return true;
+}
+
+void ofxBaseGui::collectBatches(vector<ofxBaseGui*> & batched, vector<ofxBaseGui*> & unbatched){
+	if(bBatched){
+		batched.push_back(this);
+	}else{
+		unbatched.push_back(this);
+	}
+}
+
 bool ofxBaseGui::isGuiDrawing(){
 	if(ofGetFrameNum() - currentFrame > 1){
 		return false;
@@ -356,6 +389,7 @@ void ofxBaseGui::sizeChangedCB(){
 
 void ofxBaseGui::setNeedsRedraw(){
 	needsRedraw = true;
+	needsBatch = true;
 }
 
 string ofxBaseGui::saveStencilToHex(const ofImage & img){
@@ -5,8 +5,10 @@
 #include "ofParameter.h"
 #include "ofTrueTypeFont.h"
 #include "ofBitmapFont.h"
+#include "ofxGuiBatch.h"
 
 class ofxBaseGui {
+	friend class ofxGuiGroup;
 	public:
 		ofxBaseGui();
 
@@ -86,10 +88,24 @@ class ofxBaseGui {
 		virtual void mouseExited(ofMouseEventArgs &){
 		}
 
+		// regenerates the batch if the control changed since the last
+		// call, returns true if it did
+		virtual bool updateBatch();
+		// the controls that are drawn by putting their batch in the one of
+		// the group and the ones that still have to be drawn by themselves
+		virtual void collectBatches(std::vector<ofxBaseGui*> & batched, std::vector<ofxBaseGui*> & unbatched);
+
 	protected:
 		virtual void render() = 0;
 		virtual bool setValue(float mx, float my, bool bCheckBounds) = 0;
 		virtual void generateDraw() = 0;
+		// controls that can be drawn as plain colored and text triangles
+		// return true and put them in the batch in generateBatch()
+		virtual bool canBatch() const{
+			return false;
+		}
+		virtual void generateBatch(ofxGuiBatch &){
+		}
 
 		bool isGuiDrawing();
 		void bindFontTexture();
@@ -127,8 +143,16 @@ class ofxBaseGui {
 
 		void setNeedsRedraw();
 
+		// the offsets of the batch in the meshes of the group drawing it
+		ofxGuiBatch batch;
+		bool bBatchChanged;
+		std::size_t batchShapesStart, batchShapesSize;
+		std::size_t batchTextStart, batchTextSize;
+
 	private:
 		bool needsRedraw;
+		bool needsBatch;
+		bool bBatched;
 		unsigned long currentFrame;
 		bool bRegisteredForMouseEvents;
 		//std::vector<ofEventListener> coreListeners;
@@ -0,0 +1,84 @@
+#include "ofxGuiBatch.h"
+
+ofxGuiBatch::ofxGuiBatch(){
+	shapes.setMode(OF_PRIMITIVE_TRIANGLES);
+	text.setMode(OF_PRIMITIVE_TRIANGLES);
+}
+
+void ofxGuiBatch::clear(){
+	shapes.clear();
+	text.clear();
+}
+
+void ofxGuiBatch::addRectangle(const ofRectangle & r, const ofColor & color){
+	if(r.width <= 0 || r.height <= 0){
+		return;
+	}
+	glm::vec3 tl(r.getLeft(), r.getTop(), 0);
+	glm::vec3 tr(r.getRight(), r.getTop(), 0);
+	glm::vec3 br(r.getRight(), r.getBottom(), 0);
+	glm::vec3 bl(r.getLeft(), r.getBottom(), 0);
+	shapes.addVertices({tl, tr, br, tl, br, bl});
+	ofFloatColor c = color;
+	shapes.addColors({c, c, c, c, c, c});
+}
+
+void ofxGuiBatch::addOutline(const ofRectangle & r, const ofColor & color){
+	addRectangle(ofRectangle(r.x, r.y, r.width + 1, 1), color);
+	addRectangle(ofRectangle(r.x, r.getBottom(), r.width + 1, 1), color);
+	addRectangle(ofRectangle(r.x, r.y + 1, 1, r.height - 1), color);
+	addRectangle(ofRectangle(r.getRight(), r.y + 1, 1, r.height - 1), color);
+}
+
+void ofxGuiBatch::addLine(const glm::vec3 & from, const glm::vec3 & to, const ofColor & color){
+	glm::vec3 d = to - from;
+	float length = glm::length(d);
+	if(length == 0){
+		return;
+	}
+	// 1 pixel wide in the plane of the gui
+	glm::vec3 n = glm::vec3(-d.y, d.x, 0) / length * 0.5f;
+	glm::vec3 a = from + n;
+	glm::vec3 b = to + n;
+	glm::vec3 c = to - n;
+	glm::vec3 e = from - n;
+	shapes.addVertices({a, b, c, a, c, e});
+	ofFloatColor fc = color;
+	shapes.addColors({fc, fc, fc, fc, fc, fc});
+}
+
+void ofxGuiBatch::addStencil(const ofPixels & stencil, const ofRectangle & r, const ofColor & color){
+	if(!stencil.isAllocated()){
+		return;
+	}
+	float w = r.width / stencil.getWidth();
+	float h = r.height / stencil.getHeight();
+	for(std::size_t y = 0; y < stencil.getHeight(); y++){
+		for(std::size_t x = 0; x < stencil.getWidth(); x++){
+			if(stencil.getColor(x, y).a > 0){
+				addRectangle(ofRectangle(r.x + x * w, r.y + y * h, w, h), color);
+			}
+		}
+	}
+}
+
+void ofxGuiBatch::addText(const ofMesh & textMesh, const ofColor & color){
+	// truetype meshes are indexed and bitmap ones aren't, the batch is
+	// never indexed so the meshes of every control can be appended
+	ofFloatColor c = color;
+	const auto & vertices = textMesh.getVertices();
+	const auto & texCoords = textMesh.getTexCoords();
+	if(textMesh.hasIndices()){
+		for(auto index: textMesh.getIndices()){
+			text.addVertex(vertices[index]);
+			text.addTexCoord(texCoords[index]);
+			text.addColor(c);
+		}
+	}else{
+		text.addVertices(vertices);
+		text.addTexCoords(texCoords);
+		for(std::size_t i = 0; i < vertices.size(); i++){
+			text.addColor(c);
+		}
+	}
+}
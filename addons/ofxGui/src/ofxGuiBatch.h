@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ofMesh.h"
+#include "ofColor.h"
+#include "ofRectangle.h"
+#include "ofPixels.h"
+
+// geometry of a gui control: its shapes as colored triangles and its text
+// as colored triangles textured with the font. the group drawing a panel
+// puts the batches of all its controls in one mesh for the shapes and one
+// for the text, so the whole panel is drawn in two calls
+class ofxGuiBatch {
+	public:
+		ofxGuiBatch();
+
+		void clear();
+
+		void addRectangle(const ofRectangle & r, const ofColor & color);
+		// 1 pixel wide, like a stroked ofPath
+		void addOutline(const ofRectangle & r, const ofColor & color);
+		void addLine(const glm::vec3 & from, const glm::vec3 & to, const ofColor & color);
+		// a square per opaque pixel of the stencil, scaled to r
+		void addStencil(const ofPixels & stencil, const ofRectangle & r, const ofColor & color);
+		// a mesh from ofxBaseGui::getTextMesh()
+		void addText(const ofMesh & textMesh, const ofColor & color);
+
+		ofMesh shapes;
+		ofMesh text;
+};
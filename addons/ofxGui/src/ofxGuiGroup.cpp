@@ -13,11 +13,13 @@ ofxGuiGroup::ofxGuiGroup(){
 	spacingNextElement = 3;
 	header = defaultHeight;
 	bGuiActive = false;
+	bControlsIndexDirty = true;
 }
 
 ofxGuiGroup::ofxGuiGroup(const ofParameterGroup & parameters, const std::string& filename, float x, float y){
 	minimized = false;
 	parent = nullptr;
+	bControlsIndexDirty = true;
 	setup(parameters, filename, x, y);
 }
 
@@ -163,6 +165,7 @@ void ofxGuiGroup::add(ofxBaseGui * element){
 	}
 
 	parameters.add(element->getParameter());
+	bControlsIndexDirty = true;
 	setNeedsRedraw();
 }
 
@@ -222,14 +225,39 @@ void ofxGuiGroup::add(ofParameter <ofFloatColor> & parameter){
 void ofxGuiGroup::clear(){
 	collection.clear();
 	parameters.clear();
+	bControlsIndexDirty = true;
 	b.height = header + spacing + spacingNextElement;
 	sizeChangedCB();
 }
 
+void ofxGuiGroup::updateControlsIndex(){
+	if(!bControlsIndexDirty && indexedControls == collection){
+		return;
+	}
+	controlsIndex.clear();
+	// most controls are a row of the default height
+	controlsIndex.setCellSize(defaultHeight * 2);
+	for(std::size_t i = 0; i < collection.size(); i++){
+		controlsIndex.insert(i, collection[i]->getShape());
+	}
+	indexedControls = collection;
+	hoveredControls.clear();
+	bControlsIndexDirty = false;
+}
+
 bool ofxGuiGroup::mouseMoved(ofMouseEventArgs & args){
 	ofMouseEventArgs a = args;
-	for(std::size_t i = 0; i < collection.size(); i++){
-		if(collection[i]->mouseMoved(a)){
+	updateControlsIndex();
+	// the controls under the mouse and the ones it just left, so they can
+	// update their hover state, in the order of the group
+	controlsIndex.query(glm::vec2(args.x, args.y), controlsUnderMouse);
+	notifiedControls = controlsUnderMouse;
+	notifiedControls.insert(notifiedControls.end(), hoveredControls.begin(), hoveredControls.end());
+	std::sort(notifiedControls.begin(), notifiedControls.end());
+	notifiedControls.erase(std::unique(notifiedControls.begin(), notifiedControls.end()), notifiedControls.end());
+	std::swap(hoveredControls, controlsUnderMouse);
+	for(auto i: notifiedControls){
+		if(i < collection.size() && collection[i]->mouseMoved(a)){
 			return true;
 		}
 	}
@@ -286,8 +314,12 @@ bool ofxGuiGroup::mouseReleased(ofMouseEventArgs & args){
 
 bool ofxGuiGroup::mouseScrolled(ofMouseEventArgs & args){
 	ofMouseEventArgs a = args;
-	for(std::size_t i = 0; i < collection.size(); i++){
-		if(collection[i]->mouseScrolled(a)){
+	updateControlsIndex();
+	// the controls only scroll with the mouse over them
+	controlsIndex.query(glm::vec2(args.x, args.y), controlsUnderMouse);
+	std::sort(controlsUnderMouse.begin(), controlsUnderMouse.end());
+	for(auto i: controlsUnderMouse){
+		if(i < collection.size() && collection[i]->mouseScrolled(a)){
 			return true;
 		}
 	}
@@ -318,25 +350,105 @@ void ofxGuiGroup::generateDraw(){
 	}
 }
 
+void ofxGuiGroup::generateBatch(ofxGuiBatch & batch){
+	batch.addRectangle(ofRectangle(b.x, b.y + spacingNextElement, b.width + 1, b.height), ofColor(thisBorderColor, 180));
+	batch.addRectangle(ofRectangle(b.x, b.y + 1 + spacingNextElement, b.width, header), thisHeaderBackgroundColor);
+	batch.addText(textMesh, thisTextColor);
+}
+
+bool ofxGuiGroup::updateBatch(){
+	bool changed = ofxBaseGui::updateBatch();
+	if(!minimized){
+		for(auto * control: collection){
+			changed |= control->updateBatch();
+		}
+	}
+	return changed;
+}
+
+void ofxGuiGroup::collectBatches(vector<ofxBaseGui*> & batched, vector<ofxBaseGui*> & unbatched){
+	ofxBaseGui::collectBatches(batched, unbatched);
+	if(!minimized){
+		for(auto * control: collection){
+			control->collectBatches(batched, unbatched);
+		}
+	}
+}
+
 void ofxGuiGroup::render(){
-	border.draw();
-	headerBg.draw();
+	renderBatches();
+}
+
+void ofxGuiGroup::renderBatches(){
+	updateBatch();
+	batchedControls.clear();
+	unbatchedControls.clear();
+	collectBatches(batchedControls, unbatchedControls);
+
+	// controls are added, shown or change their number of vertices rarely,
+	// only then the meshes are rebuilt. usually only some values changed
+	// and their vertices are overwritten, which uploads just those ranges
+	bool rebuild = batchedControls != lastBatchedControls;
+	for(std::size_t i = 0; i < batchedControls.size() && !rebuild; i++){
+		auto * control = batchedControls[i];
+		rebuild = control->bBatchChanged &&
+			(control->batch.shapes.getNumVertices() != control->batchShapesSize ||
+			 control->batch.text.getNumVertices() != control->batchTextSize);
+	}
+
+	if(rebuild){
+		ofMesh shapes, text;
+		shapes.setMode(OF_PRIMITIVE_TRIANGLES);
+		text.setMode(OF_PRIMITIVE_TRIANGLES);
+		for(auto * control: batchedControls){
+			control->batchShapesStart = shapes.getNumVertices();
+			control->batchShapesSize = control->batch.shapes.getNumVertices();
+			control->batchTextStart = text.getNumVertices();
+			control->batchTextSize = control->batch.text.getNumVertices();
+			shapes.append(control->batch.shapes);
+			text.append(control->batch.text);
+			control->bBatchChanged = false;
+		}
+		batchShapes.setUsage(GL_DYNAMIC_DRAW);
+		batchText.setUsage(GL_DYNAMIC_DRAW);
+		batchShapes = shapes;
+		batchText = text;
+		lastBatchedControls = batchedControls;
+	}else{
+		for(auto * control: batchedControls){
+			if(!control->bBatchChanged){
+				continue;
+			}
+			const ofMesh & shapes = control->batch.shapes;
+			for(std::size_t i = 0; i < shapes.getNumVertices(); i++){
+				batchShapes.setVertex(control->batchShapesStart + i, shapes.getVertex(i));
+				batchShapes.setColor(control->batchShapesStart + i, shapes.getColor(i));
+			}
+			const ofMesh & text = control->batch.text;
+			for(std::size_t i = 0; i < text.getNumVertices(); i++){
+				batchText.setVertex(control->batchTextStart + i, text.getVertex(i));
+				batchText.setColor(control->batchTextStart + i, text.getColor(i));
+				batchText.setTexCoord(control->batchTextStart + i, text.getTexCoord(i));
+			}
+			control->bBatchChanged = false;
+		}
+	}
+
+	batchShapes.draw();
 
 	ofBlendMode blendMode = ofGetStyle().blendingMode;
 	if(blendMode != OF_BLENDMODE_ALPHA){
 		ofEnableAlphaBlending();
 	}
 	ofColor c = ofGetStyle().color;
-	ofSetColor(thisTextColor);
+	ofSetColor(255);
 
 	bindFontTexture();
-	textMesh.draw();
+	batchText.draw();
 	unbindFontTexture();
 
-	if(!minimized){
-		for(std::size_t i = 0; i < collection.size(); i++){
-			collection[i]->draw();
-		}
+	for(auto * control: unbatchedControls){
+		control->draw();
 	}
 
 	ofSetColor(c);
@@ -481,6 +593,7 @@ void ofxGuiGroup::sizeChangedCB(){
 	if(parent){
 		parent->sizeChangedCB();
 	}
+	bControlsIndexDirty = true;
 	setNeedsRedraw();
 }
 
@@ -509,6 +622,7 @@ void ofxGuiGroup::setPosition(const ofPoint& p){
 	}
 
 	b.setPosition(p);
+	bControlsIndexDirty = true;
 	setNeedsRedraw();
 }
 
@@ -6,6 +6,7 @@
 #include "ofxLabel.h"
 #include "ofParameterGroup.h"
 #include "ofParameter.h"
+#include "ofSpatialGrid.h"
 
 class ofxGuiGroup : public ofxBaseGui {
 	public:
@@ -76,6 +77,9 @@ class ofxGuiGroup : public ofxBaseGui {
 
 		virtual void setPosition(const ofPoint& p);
 		virtual void setPosition(float x, float y);
+
+		virtual bool updateBatch();
+		virtual void collectBatches(std::vector<ofxBaseGui*> & batched, std::vector<ofxBaseGui*> & unbatched);
 	protected:
 		virtual void render();
 		virtual bool setValue(float mx, float my, bool bCheck);
@@ -89,6 +93,11 @@ class ofxGuiGroup : public ofxBaseGui {
 		ControlType & getControlType(const std::string& name);
 
 		virtual void generateDraw();
+		virtual bool canBatch() const{
+			return true;
+		}
+		virtual void generateBatch(ofxGuiBatch & batch);
+		void renderBatches();
 
 		std::vector <ofxBaseGui *> collection;
 		ofParameterGroup parameters;
@@ -99,6 +108,19 @@ class ofxGuiGroup : public ofxBaseGui {
 
 		ofPath border, headerBg;
 		ofVboMesh textMesh;
+
+		// the batches of every control in the group, drawn in one call
+		// for the shapes and one for the text
+		ofVboMesh batchShapes, batchText;
+		std::vector<ofxBaseGui*> batchedControls, unbatchedControls, lastBatchedControls;
+
+		// where the controls are, so the mouse moves and scrolls only go to
+		// the ones under the mouse. rebuilt when the layout changes
+		void updateControlsIndex();
+		ofSpatialGrid controlsIndex;
+		std::vector<ofxBaseGui*> indexedControls;
+		std::vector<std::size_t> controlsUnderMouse, hoveredControls, notifiedControls;
+		bool bControlsIndexDirty;
 };
 
 template <class ControlType>
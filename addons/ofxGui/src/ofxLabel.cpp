@@ -50,6 +50,11 @@ void ofxLabel::generateDraw(){
     textMesh = getTextMesh(name, b.x + textPadding, b.y + b.height / 2 + 4);
 }
 
+void ofxLabel::generateBatch(ofxGuiBatch & batch){
+	batch.addRectangle(b, thisBackgroundColor);
+	batch.addText(textMesh, textColor);
+}
+
 void ofxLabel::render() {
 	ofColor c = ofGetStyle().color;
 
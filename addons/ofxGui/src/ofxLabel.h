@@ -55,6 +55,10 @@ protected:
     void render();
 	ofReadOnlyParameter<std::string, ofxLabel> label;
     void generateDraw();
+    bool canBatch() const{
+    	return true;
+    }
+    void generateBatch(ofxGuiBatch & batch);
     void valueChanged(std::string & value);
     bool setValue(float mx, float my, bool bCheckBounds){return false;}
     ofPath bg;
@@ -76,37 +76,18 @@ void ofxPanel::generateDraw(){
 	textMesh = getTextMesh(getName(), textPadding + b.x, header / 2 + 4 + b.y);
 }
 
-void ofxPanel::render(){
-	border.draw();
-	headerBg.draw();
-
-	ofBlendMode blendMode = ofGetStyle().blendingMode;
-	if(blendMode!=OF_BLENDMODE_ALPHA){
-		ofEnableAlphaBlending();
-	}
-	ofColor c = ofGetStyle().color;
-	ofSetColor(thisTextColor);
-
-	bindFontTexture();
-	textMesh.draw();
-	unbindFontTexture();
-
-	bool texHackEnabled = ofIsTextureEdgeHackEnabled();
-	ofDisableTextureEdgeHack();
-	loadIcon.draw(loadBox);
-	saveIcon.draw(saveBox);
-	if(texHackEnabled){
-		ofEnableTextureEdgeHack();
-	}
-
-	for(std::size_t i = 0; i < collection.size(); i++){
-		collection[i]->draw();
-	}
+void ofxPanel::generateBatch(ofxGuiBatch & batch){
+	batch.addOutline(ofRectangle(b.x,b.y,b.width+1,b.height-spacingNextElement),thisBorderColor);
+	batch.addRectangle(ofRectangle(b.x,b.y+1,b.width,header),ofColor(thisHeaderBackgroundColor,180));
+	batch.addText(textMesh,thisTextColor);
+
+	// the icons are tiny stencils, as squares they don't need their textures
+	batch.addStencil(loadIcon.getPixels(),loadBox,thisTextColor);
+	batch.addStencil(saveIcon.getPixels(),saveBox,thisTextColor);
+}
 
-	ofSetColor(c);
-	if(blendMode!=OF_BLENDMODE_ALPHA){
-		ofEnableBlendMode(blendMode);
-	}
+void ofxPanel::render(){
+	renderBatches();
 }
 
 bool ofxPanel::mouseReleased(ofMouseEventArgs & args){
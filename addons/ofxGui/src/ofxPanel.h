@@ -28,6 +28,7 @@ protected:
 	void render();
 	bool setValue(float mx, float my, bool bCheck);
 	void generateDraw();
+	void generateBatch(ofxGuiBatch & batch);
 	void loadIcons();
 private:
 	ofRectangle loadBox, saveBox;
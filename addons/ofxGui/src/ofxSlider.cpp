@@ -255,6 +255,20 @@ void ofxSlider<Type>::generateText(){
 	}
 }
 
+template<typename Type>
+bool ofxSlider<Type>::canBatch() const{
+	// the input field and the error animation are drawn by themselves
+	return state==Slider && errorTime==0;
+}
+
+template<typename Type>
+void ofxSlider<Type>::generateBatch(ofxGuiBatch & batch){
+	batch.addRectangle(b, thisBackgroundColor);
+	float valAsPct = ofMap( value, value.getMin(), value.getMax(), 0, b.width-2, true );
+	batch.addRectangle(ofRectangle(b.x+1, b.y+1, valAsPct, b.height-2), thisFillColor);
+	batch.addText(textMesh, thisTextColor);
+}
+
 template<typename Type>
 void ofxSlider<Type>::render(){
 	if(state==Slider){
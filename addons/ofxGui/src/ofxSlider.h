@@ -64,6 +64,8 @@ protected:
 	bool setValue(float mx, float my, bool bCheck);
 	virtual void generateDraw();
 	virtual void generateText();
+	virtual bool canBatch() const;
+	virtual void generateBatch(ofxGuiBatch & batch);
 	void valueChanged(Type & value);
 	ofPath bg, bar;
 	ofVboMesh textMesh;
@@ -111,6 +111,21 @@ void ofxToggle::generateDraw(){
 	textMesh = getTextMesh(name, textX, b.y+b.height / 2 + 4);
 }
 
+void ofxToggle::generateBatch(ofxGuiBatch & batch){
+	batch.addRectangle(b, thisBackgroundColor);
+
+	ofRectangle checkbox(b.getPosition()+checkboxRect.getTopLeft(),checkboxRect.width,checkboxRect.height);
+	if(value){
+		batch.addRectangle(checkbox, thisFillColor);
+		batch.addLine(checkbox.getTopLeft(), checkbox.getBottomRight(), thisTextColor);
+		batch.addLine(checkbox.getTopRight(), checkbox.getBottomLeft(), thisTextColor);
+	}else{
+		batch.addOutline(checkbox, thisFillColor);
+	}
+
+	batch.addText(textMesh, thisTextColor);
+}
+
 void ofxToggle::render(){
 	bg.draw();
 	fg.draw();
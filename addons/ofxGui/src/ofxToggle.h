@@ -44,6 +44,10 @@ protected:
 	
 	bool setValue(float mx, float my, bool bCheck);
 	void generateDraw();
+	bool canBatch() const{
+		return true;
+	}
+	void generateBatch(ofxGuiBatch & batch);
 	void valueChanged(bool & value);
 	ofPath bg,fg,cross;
 	ofVboMesh textMesh;
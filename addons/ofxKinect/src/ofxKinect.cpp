@@ -56,8 +56,6 @@ ofxKinect::ofxKinect() {
 	// set defaults
 	bGrabberInited = false;
 
-	bNeedsUpdateVideo = false;
-	bNeedsUpdateDepth = false;
 	bIsFrameNewVideo = false;
 	bIsFrameNewDepth = false;
     
@@ -83,6 +81,8 @@ ofxKinect::ofxKinect() {
 
 	bUseRegistration = false;
 	bNearWhite = true;
+	bUseRawDepthTexture = false;
+	bUseDepthPixels = true;
 
 	pixelFormat = OF_PIXELS_RGB;
 
@@ -115,8 +115,10 @@ bool ofxKinect::init(bool infrared, bool video, bool texture) {
 
 	// allocate
 	depthPixelsRaw.allocate(width, height, 1);
-	depthPixelsRawBack.allocate(width, height, 1);
-	depthPixelsRawIntra.allocate(width, height, 1);
+	for(int i = 0; i < 3; i++) {
+		depthFrames[i].allocate(width, height, 1);
+		depthFrames[i].set(0);
+	}
     
     //We have to do this as freenect has 488 pixels for the IR image height.
     //Instead of having slightly different sizes depending on capture we will crop the last 8 rows of pixels which are empty.
@@ -126,18 +128,17 @@ bool ofxKinect::init(bool infrared, bool video, bool texture) {
     }
     
 	videoPixels.allocate(width, height, videoBytesPerPixel);
-	videoPixelsBack.allocate(width, videoHeight, videoBytesPerPixel);
-	videoPixelsIntra.allocate(width, videoHeight, videoBytesPerPixel);
+	for(int i = 0; i < 3; i++) {
+		videoFrames[i].allocate(width, videoHeight, videoBytesPerPixel);
+		videoFrames[i].set(0);
+	}
 
 	depthPixels.allocate(width, height, 1);
 	distancePixels.allocate(width, height, 1);
 
 	 // set
 	depthPixelsRaw.set(0);
-	depthPixelsRawBack.set(0);
-
 	videoPixels.set(0);
-	videoPixelsBack.set(0);
 
 	depthPixels.set(0);    
 	distancePixels.set(0);
@@ -166,16 +167,20 @@ void ofxKinect::clear() {
 	}
 
 	depthPixelsRaw.clear();
-	depthPixelsRawBack.clear();
-
 	videoPixels.clear();
-	videoPixelsBack.clear();
+	for(int i = 0; i < 3; i++) {
+		depthFrames[i].clear();
+		videoFrames[i].clear();
+	}
+	depthFrames.reset();
+	videoFrames.reset();
 
 	depthPixels.clear();
 	distancePixels.clear();
 
 	depthTex.clear();
 	videoTex.clear();
+	rawDepthTex.clear();
 
 	bGrabberInited = false;
 }
@@ -224,8 +229,8 @@ bool ofxKinect::open(int deviceIndex) {
     bFirstUpdate = true;
     
 	freenect_set_user(kinectDevice, this);
-	freenect_set_depth_buffer(kinectDevice, depthPixelsRawBack.getData());
-	freenect_set_video_buffer(kinectDevice, videoPixelsBack.getData());
+	freenect_set_depth_buffer(kinectDevice, depthFrames.getBack().getData());
+	freenect_set_video_buffer(kinectDevice, videoFrames.getBack().getData());
 	freenect_set_depth_callback(kinectDevice, &grabDepthFrame);
 	freenect_set_video_callback(kinectDevice, &grabVideoFrame);
 
@@ -266,6 +271,8 @@ bool ofxKinect::open(string serial) {
 	bFirstUpdate = true;
     
 	freenect_set_user(kinectDevice, this);
+	freenect_set_depth_buffer(kinectDevice, depthFrames.getBack().getData());
+	freenect_set_video_buffer(kinectDevice, videoFrames.getBack().getData());
 	freenect_set_depth_callback(kinectDevice, &grabDepthFrame);
 	freenect_set_video_callback(kinectDevice, &grabVideoFrame);
 	
@@ -285,9 +292,10 @@ void ofxKinect::close() {
 	deviceId = -1;
 	serial = "";
 	bIsFrameNewVideo = false;
-	bNeedsUpdateVideo = false;
 	bIsFrameNewDepth = false;
-	bNeedsUpdateDepth = false;
+	// the thread stopped, frames it published before are dropped
+	depthFrames.reset();
+	videoFrames.reset();
 }
 
 //---------------------------------------------------------------------------
@@ -351,17 +359,21 @@ void ofxKinect::update() {
         bFirstUpdate = false;
     }
     
+    // takes the newest complete frames from the kinect thread, never waits for it
+    bIsFrameNewVideo = videoFrames.update();
+    bIsFrameNewDepth = depthFrames.update();
+
     //if we aren't grabbing the video stream we don't need to check for video
     bool bVideoOkay = true;
     if( bGrabVideo ){
         bVideoOkay = bGotDataVideo;
-        if( bNeedsUpdateVideo ){
+        if( bIsFrameNewVideo ){
             bVideoOkay = true;
             bGotDataVideo = true;
         }
     }
 
-    if( bNeedsUpdateDepth ){
+    if( bIsFrameNewDepth ){
         bGotDataDepth = true;
     }
     
@@ -373,47 +385,47 @@ void ofxKinect::update() {
 		open(lastDeviceIndex);
 		tryCount++;
 		timeSinceOpen = ofGetElapsedTimef();
+		return;
 	}
 
     // - End handle reconnection
 
-	if(bNeedsUpdateVideo){
-		bIsFrameNewVideo = true;
+	if(bIsFrameNewVideo){
 		tryCount = 0;
-		if(this->lock()) {
-            if( videoPixels.getHeight() == videoPixelsIntra.getHeight() ){
-                swap(videoPixels,videoPixelsIntra);
-            }else{
-				int minimumSize = MIN(videoPixels.size(), videoPixelsIntra.size());
-				memcpy(videoPixels.getData(), videoPixelsIntra.getData(), minimumSize);
-            }
-			bNeedsUpdateVideo = false;
-			this->unlock();
+		// the front frame belongs to this thread until the next update,
+		// swapping only exchanges the memory
+		ofPixels & frame = videoFrames.getFront();
+		if( videoPixels.getHeight() == frame.getHeight() ){
+			swap(videoPixels,frame);
+		}else{
+			int minimumSize = MIN(videoPixels.size(), frame.size());
+			memcpy(videoPixels.getData(), frame.getData(), minimumSize);
 		}
 
 		if(bUseTexture) {
 			videoTex.loadData(videoPixels);
 		}
-	} else {
-		bIsFrameNewVideo = false;
 	}
 
-	if(bNeedsUpdateDepth){
-		bIsFrameNewDepth = true;
+	if(bIsFrameNewDepth){
 		tryCount = 0;
-		if(this->lock()) {
-			swap(depthPixelsRaw, depthPixelsRawIntra);
-			bNeedsUpdateDepth = false;
-			this->unlock();
+		swap(depthPixelsRaw, depthFrames.getFront());
 
+		if(bUseDepthPixels) {
 			updateDepthPixels();
 		}
 
-		if(bUseTexture) {
+		if(bUseTexture && bUseDepthPixels) {
 			depthTex.loadData(depthPixels);
 		}
-	} else {
-		bIsFrameNewDepth = false;
+		if(bUseRawDepthTexture) {
+			if(!rawDepthTex.isAllocated()) {
+				rawDepthTex.allocate(width, height, GL_R16UI, false, GL_RED_INTEGER, GL_UNSIGNED_SHORT);
+				// integer textures can't be filtered
+				rawDepthTex.setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+			}
+			rawDepthTex.loadData(depthPixelsRaw.getData(), width, height, GL_RED_INTEGER);
+		}
 	}
 
 }
@@ -541,6 +553,35 @@ const ofTexture& ofxKinect::getDepthTexture() const{
 	return depthTex;
 }
 
+//---------------------------------------------------------------------------
+ofTexture& ofxKinect::getRawDepthTexture(){
+	if(!rawDepthTex.isAllocated()){
+		ofLogWarning("ofxKinect") << "getRawDepthTexture(): device " << deviceId << " raw depth texture not allocated, enable it with setUseRawDepthTexture()";
+	}
+	return rawDepthTex;
+}
+
+//---------------------------------------------------------------------------
+const ofTexture& ofxKinect::getRawDepthTexture() const{
+	if(!rawDepthTex.isAllocated()){
+		ofLogWarning("ofxKinect") << "getRawDepthTexture(): device " << deviceId << " raw depth texture not allocated, enable it with setUseRawDepthTexture()";
+	}
+	return rawDepthTex;
+}
+
+//---------------------------------------------------------------------------
+void ofxKinect::setUseRawDepthTexture(bool bUse){
+	bUseRawDepthTexture = bUse;
+	if(!bUse){
+		rawDepthTex.clear();
+	}
+}
+
+//---------------------------------------------------------------------------
+void ofxKinect::setUseDepthPixels(bool bUse){
+	bUseDepthPixels = bUse;
+}
+
 //------------------------------------
 ofTexture& ofxKinect::getTextureReference(){
 	return getTexture();
@@ -806,11 +847,10 @@ void ofxKinect::grabDepthFrame(freenect_device *dev, void *depth, uint32_t times
 	ofxKinect* kinect = kinectContext.getKinect(dev);
 
 	if(kinect->kinectDevice == dev) {
-		kinect->lock();
-		swap(kinect->depthPixelsRawBack,kinect->depthPixelsRawIntra);
-		kinect->bNeedsUpdateDepth = true;
-		kinect->unlock();
-		freenect_set_depth_buffer(kinect->kinectDevice,kinect->depthPixelsRawBack.getData());
+		// freenect filled the back frame, publish it and keep filling
+		// whichever frame the main thread isn't reading
+		kinect->depthFrames.publish();
+		freenect_set_depth_buffer(kinect->kinectDevice,kinect->depthFrames.getBack().getData());
     }
 }
 
@@ -820,11 +860,8 @@ void ofxKinect::grabVideoFrame(freenect_device *dev, void *video, uint32_t times
 	ofxKinect* kinect = kinectContext.getKinect(dev);
 
 	if(kinect->kinectDevice == dev) {
-		kinect->lock();
-		swap(kinect->videoPixelsBack,kinect->videoPixelsIntra);
-		kinect->bNeedsUpdateVideo = true;
-		kinect->unlock();
-		freenect_set_video_buffer(kinect->kinectDevice,kinect->videoPixelsBack.getData());
+		kinect->videoFrames.publish();
+		freenect_set_video_buffer(kinect->kinectDevice,kinect->videoFrames.getBack().getData());
 	}
 }
 
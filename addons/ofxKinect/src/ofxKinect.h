@@ -186,6 +186,23 @@ public:
 	OF_DEPRECATED_MSG("Use getDepthTexture() instead", ofTexture& getDepthTextureReference());
 	OF_DEPRECATED_MSG("Use getDepthTexture() instead", const ofTexture& getDepthTextureReference() const);
 
+	/// get the raw depth in millimeters as an unsigned integer texture
+	///
+	/// GL_R16UI with nearest filtering, read it with a usampler2D and
+	/// texelFetch, only updated when enabled with setUseRawDepthTexture()
+	ofTexture& getRawDepthTexture();
+	const ofTexture& getRawDepthTexture() const;
+
+	/// upload the raw depth to an integer texture each frame, to calculate
+	/// on the GPU what would be done with the depth pixels otherwise,
+	/// see ofxKinectPointCloud
+	void setUseRawDepthTexture(bool bUse);
+
+	/// calculate the grayscale depth pixels, the distance pixels and the
+	/// depth texture each frame (default), disable when only the raw
+	/// depth or the raw depth texture are used to skip the conversions
+	void setUseDepthPixels(bool bUse);
+
 /// \section Grayscale Depth Value
 
 	/// set the near value of the pixels in the grayscale depth image to white
@@ -341,7 +358,10 @@ protected:
 	string serial;	///< unique serial number, "" when not connected
 	
 	bool bUseTexture;
+	bool bUseRawDepthTexture;
+	bool bUseDepthPixels;
 	ofTexture depthTex; ///< the depth texture
+	ofTexture rawDepthTex; ///< the depth in millimeters, GL_R16UI
 	ofTexture videoTex; ///< the RGB texture
 	bool bGrabberInited;
 
@@ -375,23 +395,23 @@ protected:
 private:
 
 	friend class ofxKinectContext;
+	friend class ofxKinectPointCloud; ///< reads the registration tables and the raw depth texture
 
 	/// global statics shared between kinect instances
 	static ofxKinectContext kinectContext;
 
 	freenect_device* kinectDevice;      ///< kinect device handle
 
-	ofShortPixels depthPixelsRawIntra;	///< depth back
-	ofPixels videoPixelsIntra;			///< rgb back
-	ofShortPixels depthPixelsRawBack;	///< depth back
-	ofPixels videoPixelsBack;			///< rgb back
+	/// frames handed from the kinect thread to update() without locking,
+	/// freenect writes directly to the back ones
+	ofTripleBuffer<ofShortPixels> depthFrames;
+	ofTripleBuffer<ofPixels> videoFrames;
 
 	vector<unsigned char> depthLookupTable;
 	void updateDepthLookupTable();
 	void updateDepthPixels();
 
 	bool bIsFrameNewVideo, bIsFrameNewDepth;
-	bool bNeedsUpdateVideo, bNeedsUpdateDepth;
 	bool bGrabVideo;
 	bool bUseRegistration;
 	bool bNearWhite;
@@ -0,0 +1,285 @@
+#include "ofxKinectPointCloud.h"
+
+#include "libfreenect_registration.h"
+#include "freenect_internal.h" // for access to freenect_device.registration
+
+namespace {
+	// depth_to_rgb_shift has one entry per millimeter up to 10m, stored
+	// in rows of 1024 since textures can't be that wide everywhere
+	const int maxDepth = 10000;
+	const int shiftRowSize = 1024;
+
+	const string feedbackVertex = R"(#version 150
+uniform usampler2D rawDepth;
+uniform isampler2D registrationTable;
+uniform isampler2D depthToVideoShift;
+uniform int registration;
+uniform float pixelSize;
+uniform vec2 center;
+uniform vec2 clipping;
+
+in vec4 position;
+out vec4 worldPosition;
+out vec2 videoCoord;
+
+void main(){
+	ivec2 p = ivec2(position.xy);
+	float z = float(texelFetch(rawDepth, p, 0).r);
+	// same as freenect_camera_to_world
+	float factor = pixelSize * z;
+	bool valid = z > 0.0 && z >= clipping.x && z <= clipping.y;
+	worldPosition = vec4((position.xy - center) * factor, z, valid ? 1.0 : 0.0);
+
+	videoCoord = position.xy;
+	if(registration == 1 && z > 0.0){
+		// same as freenect_apply_registration without rounding to pixels
+		int depth = min(int(z), )" + ofToString(maxDepth - 1) + R"();
+		ivec2 table = texelFetch(registrationTable, p, 0).xy;
+		int shift = texelFetch(depthToVideoShift, ivec2(depth % )" + ofToString(shiftRowSize) + R"(, depth / )" + ofToString(shiftRowSize) + R"(), 0).r;
+		videoCoord = vec2(float(table.x + shift) / 256.0, float(table.y));
+	}
+	gl_Position = vec4(0.0);
+}
+)";
+
+	const string drawVertex = R"(
+uniform mat4 modelViewProjectionMatrix;
+in vec4 position;
+in vec2 texcoord;
+out vec2 videoCoord;
+
+void main(){
+	videoCoord = texcoord;
+	// invalid points end up outside of the clip space
+	gl_Position = position.w > 0.0 ? modelViewProjectionMatrix * vec4(position.xyz, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);
+}
+)";
+
+	const string drawFragment = R"(
+#ifdef VIDEO_RECT
+uniform sampler2DRect video;
+#else
+uniform sampler2D video;
+#endif
+uniform int useColor;
+uniform vec4 globalColor;
+in vec2 videoCoord;
+out vec4 fragColor;
+
+void main(){
+	if(useColor == 1){
+#ifdef VIDEO_RECT
+		fragColor = globalColor * vec4(texture(video, videoCoord).rgb, 1.0);
+#else
+		fragColor = globalColor * vec4(texture(video, videoCoord / vec2(textureSize(video, 0))).rgb, 1.0);
+#endif
+	}else{
+		fragColor = globalColor;
+	}
+}
+)";
+}
+
+//--------------------------------------------------------------------
+ofxKinectPointCloud::ofxKinectPointCloud() {
+	kinect = nullptr;
+	step = 1;
+	numPoints = 0;
+	bUseRegistration = true;
+	bUseColor = true;
+	bRegistrationUploaded = false;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPointCloud::setup(ofxKinect & kinect, int step) {
+#ifdef TARGET_OPENGLES
+	ofLogError("ofxKinectPointCloud") << "setup(): transform feedback is not supported on OpenGL ES";
+	return false;
+#else
+	if(!ofIsGLProgrammableRenderer()) {
+		ofLogError("ofxKinectPointCloud") << "setup(): needs the programmable renderer, set the GL version to 3.2 or newer";
+		return false;
+	}
+	if(!kinect.isInitialized()) {
+		ofLogError("ofxKinectPointCloud") << "setup(): call init() on the kinect first";
+		return false;
+	}
+
+	ofShader::TransformFeedbackSettings settings;
+	settings.shaderSources[GL_VERTEX_SHADER] = feedbackVertex;
+	settings.varyingsToCapture = { "worldPosition", "videoCoord" };
+	settings.bufferMode = GL_SEPARATE_ATTRIBS;
+	if(!feedbackShader.setup(settings)) {
+		ofLogError("ofxKinectPointCloud") << "setup(): couldn't compile the point cloud shader";
+		return false;
+	}
+
+	bool bVideoRect = kinect.getTexture().isAllocated() && kinect.getTexture().getTextureData().textureTarget != GL_TEXTURE_2D;
+	string header = string("#version 150\n") + (bVideoRect ? "#define VIDEO_RECT\n" : "");
+	if(!drawShader.setupShaderFromSource(GL_VERTEX_SHADER, header + drawVertex)
+		|| !drawShader.setupShaderFromSource(GL_FRAGMENT_SHADER, header + drawFragment)
+		|| !drawShader.bindDefaults()
+		|| !drawShader.linkProgram()) {
+		ofLogError("ofxKinectPointCloud") << "setup(): couldn't compile the draw shader";
+		return false;
+	}
+
+	this->kinect = &kinect;
+	this->step = MAX(step, 1);
+	kinect.setUseRawDepthTexture(true);
+
+	// one point per sampled depth pixel, its coordinate is the input
+	vector<glm::vec2> coords;
+	for(int y = 0; y < kinect.height; y += this->step) {
+		for(int x = 0; x < kinect.width; x += this->step) {
+			coords.push_back(glm::vec2(x, y));
+		}
+	}
+	numPoints = coords.size();
+	pixelCoords.setVertexData(coords.data(), numPoints, GL_STATIC_DRAW);
+
+	positions.allocate(numPoints * sizeof(glm::vec4), GL_DYNAMIC_COPY);
+	texCoords.allocate(numPoints * sizeof(glm::vec2), GL_DYNAMIC_COPY);
+	points.setVertexBuffer(positions, 4, sizeof(glm::vec4));
+	points.setTexCoordBuffer(texCoords, sizeof(glm::vec2));
+
+	bRegistrationUploaded = false;
+	return true;
+#endif
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPointCloud::isSetup() const {
+	return kinect != nullptr;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::setUseRegistration(bool bUse) {
+	bUseRegistration = bUse;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPointCloud::isUsingRegistration() const {
+	return bUseRegistration;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::setUseColor(bool bUse) {
+	bUseColor = bUse;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::uploadRegistration() {
+	// libfreenect calculates the tables when the device is opened
+	if(!kinect->isConnected() || kinect->kinectDevice == NULL) {
+		return;
+	}
+	freenect_registration & registration = kinect->kinectDevice->registration;
+	if(registration.registration_table == NULL || registration.depth_to_rgb_shift == NULL) {
+		return;
+	}
+
+	registrationTable.allocate(kinect->width, kinect->height, GL_RG32I, false, GL_RG_INTEGER, GL_INT);
+	registrationTable.setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+	registrationTable.loadData(registration.registration_table, kinect->width, kinect->height, GL_RG_INTEGER, GL_INT);
+
+	int rows = (maxDepth + shiftRowSize - 1) / shiftRowSize;
+	vector<int32_t> shift(shiftRowSize * rows, 0);
+	memcpy(shift.data(), registration.depth_to_rgb_shift, maxDepth * sizeof(int32_t));
+	depthToVideoShift.allocate(shiftRowSize, rows, GL_R32I, false, GL_RED_INTEGER, GL_INT);
+	depthToVideoShift.setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+	depthToVideoShift.loadData(shift.data(), shiftRowSize, rows, GL_RED_INTEGER, GL_INT);
+
+	bRegistrationUploaded = true;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::update() {
+#ifndef TARGET_OPENGLES
+	if(!isSetup() || !kinect->isFrameNewDepth() || !kinect->rawDepthTex.isAllocated()) {
+		return;
+	}
+	if(!bRegistrationUploaded) {
+		uploadRegistration();
+	}
+	bool bRegister = bUseRegistration && bRegistrationUploaded;
+
+	// without registration the points get the video pixel at the same
+	// coordinate, the textures still need to be bound to something valid
+	const ofTexture & raw = kinect->rawDepthTex;
+	feedbackShader.begin();
+	feedbackShader.setUniformTexture("rawDepth", raw, 0);
+	feedbackShader.setUniformTexture("registrationTable", bRegister ? registrationTable : raw, 1);
+	feedbackShader.setUniformTexture("depthToVideoShift", bRegister ? depthToVideoShift : raw, 2);
+	feedbackShader.setUniform1i("registration", bRegister ? 1 : 0);
+	feedbackShader.setUniform1f("pixelSize", 2 * kinect->getZeroPlanePixelSize() / kinect->getZeroPlaneDistance());
+	feedbackShader.setUniform2f("center", kinect->width / 2, kinect->height / 2);
+	feedbackShader.setUniform2f("clipping", kinect->getNearClipping(), kinect->getFarClipping());
+	feedbackShader.end();
+
+	vector<ofShader::TransformFeedbackBaseBinding> bindings;
+	bindings.push_back(ofShader::TransformFeedbackBaseBinding(positions));
+	bindings.push_back(ofShader::TransformFeedbackBaseBinding(texCoords));
+	bindings[1].index = 1;
+
+	glEnable(GL_RASTERIZER_DISCARD);
+	feedbackShader.beginTransformFeedback(GL_POINTS, bindings);
+	pixelCoords.draw(GL_POINTS, 0, numPoints);
+	feedbackShader.endTransformFeedback(bindings);
+	glDisable(GL_RASTERIZER_DISCARD);
+#endif
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::draw() const {
+	if(!isSetup()) {
+		return;
+	}
+	bool bColor = bUseColor && kinect->getTexture().isAllocated();
+	drawShader.begin();
+	if(bColor) {
+		drawShader.setUniformTexture("video", kinect->getTexture(), 0);
+	}
+	drawShader.setUniform1i("useColor", bColor ? 1 : 0);
+	points.draw(GL_POINTS, 0, numPoints);
+	drawShader.end();
+}
+
+//--------------------------------------------------------------------
+ofVbo & ofxKinectPointCloud::getVbo() {
+	return points;
+}
+
+//--------------------------------------------------------------------
+const ofBufferObject & ofxKinectPointCloud::getPositionBuffer() const {
+	return positions;
+}
+
+//--------------------------------------------------------------------
+const ofBufferObject & ofxKinectPointCloud::getTexCoordBuffer() const {
+	return texCoords;
+}
+
+//--------------------------------------------------------------------
+size_t ofxKinectPointCloud::getNumPoints() const {
+	return numPoints;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::readToPoints(vector<glm::vec3> & result) {
+	result.clear();
+	if(!isSetup()) {
+		return;
+	}
+	const glm::vec4 * data = positions.map<glm::vec4>(GL_READ_ONLY);
+	if(data == nullptr) {
+		ofLogError("ofxKinectPointCloud") << "readToPoints(): couldn't map the positions";
+		return;
+	}
+	for(size_t i = 0; i < numPoints; i++) {
+		if(data[i].w > 0) {
+			result.push_back(glm::vec3(data[i]));
+		}
+	}
+	positions.unmap();
+}
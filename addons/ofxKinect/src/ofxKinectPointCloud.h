@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ofxKinect.h"
+
+/// \class ofxKinectPointCloud
+///
+/// point cloud of a kinect calculated on the GPU
+///
+/// the raw depth is uploaded once per frame as an integer texture (see
+/// ofxKinect::setUseRawDepthTexture()) and a transform feedback pass
+/// writes the world coordinate and the video texture coordinate of each
+/// point to buffers on the GPU without any conversion on the CPU, the
+/// same perspective calculation as ofxKinect::getWorldCoordinateAt()
+///
+/// the points are only read back to the CPU with readToPoints()
+///
+class ofxKinectPointCloud {
+
+public:
+
+	ofxKinectPointCloud();
+
+	/// needs the programmable renderer (GL 3.2 or newer)
+	///
+	/// step: use 1 of every step x step depth pixels
+	bool setup(ofxKinect & kinect, int step = 1);
+	bool isSetup() const;
+
+	/// map each point to the video image with the kinect's calibration,
+	/// on by default, not needed if ofxKinect::setRegistration(true) is
+	/// used since the depth is already aligned to the video then
+	void setUseRegistration(bool bUse);
+	bool isUsingRegistration() const;
+
+	/// color the points with the video texture when drawing (default)
+	void setUseColor(bool bUse);
+
+	/// recalculates the points if the kinect has a new depth frame,
+	/// call after ofxKinect::update()
+	void update();
+
+	/// draws the points in millimeters, points without depth or outside
+	/// of the kinect's depth clipping are skipped
+	void draw() const;
+
+	/// the buffers with the result, position is a vec4 in millimeters
+	/// with w = 1 for valid points and 0 for points without depth or
+	/// outside of the clipping planes, texcoord a vec2 in pixels of the
+	/// video image
+	///
+	/// the vbo draws them as positions and texcoords with any shader
+	ofVbo & getVbo();
+	const ofBufferObject & getPositionBuffer() const;
+	const ofBufferObject & getTexCoordBuffer() const;
+	size_t getNumPoints() const;
+
+	/// downloads the valid points, this stalls until the GPU is done
+	void readToPoints(vector<glm::vec3> & points);
+
+private:
+	void uploadRegistration();
+
+	ofxKinect * kinect;
+	int step;
+	size_t numPoints;
+	bool bUseRegistration;
+	bool bUseColor;
+	bool bRegistrationUploaded;
+
+	ofVbo pixelCoords;          ///< the depth pixel of each point
+	ofBufferObject positions;
+	ofBufferObject texCoords;
+	ofVbo points;
+
+	ofTexture registrationTable; ///< video pixel of each depth pixel, x * 256
+	ofTexture depthToVideoShift;  ///< horizontal shift by depth, x * 256
+
+	ofShader feedbackShader;
+	ofShader drawShader;
+};
@@ -0,0 +1,334 @@
+#include "ofxPointCloudFilter.h"
+#include "ofxKinect.h"
+#include <unordered_map>
+
+namespace {
+	// 21 bits per axis, a million voxels in every direction around 0
+	const int64_t keyOffset = 1 << 20;
+	const uint64_t keyMask = (1 << 21) - 1;
+	const uint64_t invalidKey = ~uint64_t(0);
+
+	uint64_t voxelKey(int64_t x, int64_t y, int64_t z) {
+		return (uint64_t(x + keyOffset) & keyMask)
+			| ((uint64_t(y + keyOffset) & keyMask) << 21)
+			| ((uint64_t(z + keyOffset) & keyMask) << 42);
+	}
+
+	// the voxels are spread over a map per worker by a hash of their key,
+	// each voxel is only ever written by one of them
+	size_t partition(uint64_t key, size_t numPartitions) {
+		return ((key * 0x9E3779B97F4A7C15ull) >> 40) % numPartitions;
+	}
+
+	struct Voxel {
+		glm::vec3 sum;
+		int count;
+	};
+
+	typedef std::unordered_map<uint64_t, Voxel> VoxelMap;
+
+	const int maxNeighbors = 32;
+}
+
+//--------------------------------------------------------------------
+ofxPointCloudFilter::ofxPointCloudFilter() {
+	settings.voxelSize = 10;
+	settings.minPoints = 1;
+	settings.numNeighbors = 8;
+	settings.stdDevMultiplier = 1;
+	numInputPoints = 0;
+	mesh.setMode(OF_PRIMITIVE_POINTS);
+	mesh.setUsage(GL_STREAM_DRAW);
+}
+
+//--------------------------------------------------------------------
+ofxPointCloudFilter::~ofxPointCloudFilter() {
+	if(pending.valid()) {
+		pending.wait();
+	}
+}
+
+//--------------------------------------------------------------------
+void ofxPointCloudFilter::setVoxelSize(float size) {
+	settings.voxelSize = MAX(size, 0);
+}
+
+//--------------------------------------------------------------------
+float ofxPointCloudFilter::getVoxelSize() const {
+	return settings.voxelSize;
+}
+
+//--------------------------------------------------------------------
+void ofxPointCloudFilter::setMinPointsPerVoxel(int points) {
+	settings.minPoints = MAX(points, 1);
+}
+
+//--------------------------------------------------------------------
+void ofxPointCloudFilter::setOutlierRemoval(int numNeighbors, float stdDevMultiplier) {
+	settings.numNeighbors = ofClamp(numNeighbors, 0, maxNeighbors);
+	settings.stdDevMultiplier = stdDevMultiplier;
+}
+
+//--------------------------------------------------------------------
+void ofxPointCloudFilter::addDepth(const ofxKinect & kinect, const glm::mat4 & transform, int step) {
+	// same as freenect_camera_to_world
+	float focal = kinect.getZeroPlaneDistance() / (2 * kinect.getZeroPlanePixelSize());
+	addDepth(kinect.getDistancePixels(), focal, focal, kinect.width / 2, kinect.height / 2,
+		transform, step, kinect.getNearClipping(), kinect.getFarClipping());
+}
+
+//--------------------------------------------------------------------
+void ofxPointCloudFilter::addDepth(const ofFloatPixels & distance, float focalX, float focalY, float centerX, float centerY,
+	const glm::mat4 & transform, int step, float nearClip, float farClip) {
+	if(!distance.isAllocated() || distance.getNumChannels() != 1) {
+		ofLogError("ofxPointCloudFilter") << "addDepth(): the distance pixels have to be allocated and have one channel";
+		return;
+	}
+	inputs.push_back(Input());
+	Input & input = inputs.back();
+	input.distance = distance;
+	input.intrinsics = glm::vec4(focalX, focalY, centerX, centerY);
+	input.clipping = glm::vec2(nearClip, farClip);
+	input.step = MAX(step, 1);
+	input.transform = transform;
+}
+
+//--------------------------------------------------------------------
+void ofxPointCloudFilter::addPoints(const vector<glm::vec3> & points, const glm::mat4 & transform) {
+	inputs.push_back(Input());
+	inputs.back().points = points;
+	inputs.back().transform = transform;
+}
+
+//--------------------------------------------------------------------
+bool ofxPointCloudFilter::update() {
+	bool updated = false;
+	if(pending.valid()) {
+		if(pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			inputs.clear();
+			return false;
+		}
+		Result result = pending.get();
+		numInputPoints = result.numInputPoints;
+		// the vbo is updated in place while the number of points doesn't grow
+		mesh.getVertices() = std::move(result.points);
+		updated = true;
+	}
+
+	if(!inputs.empty()) {
+		auto frame = std::make_shared<vector<Input>>();
+		std::swap(*frame, inputs);
+		Settings current = settings;
+		pending = ofGetTaskPool().submit([frame, current]{
+			return process(*frame, current);
+		});
+	}
+	return updated;
+}
+
+//--------------------------------------------------------------------
+bool ofxPointCloudFilter::isProcessing() const {
+	return pending.valid();
+}
+
+//--------------------------------------------------------------------
+size_t ofxPointCloudFilter::getNumInputPoints() const {
+	return numInputPoints;
+}
+
+//--------------------------------------------------------------------
+size_t ofxPointCloudFilter::getNumPoints() const {
+	return mesh.getNumVertices();
+}
+
+//--------------------------------------------------------------------
+ofVboMesh & ofxPointCloudFilter::getMesh() {
+	return mesh;
+}
+
+//--------------------------------------------------------------------
+const ofVboMesh & ofxPointCloudFilter::getMesh() const {
+	return mesh;
+}
+
+//--------------------------------------------------------------------
+ofxPointCloudFilter::Result ofxPointCloudFilter::process(const vector<Input> & inputs, const Settings & settings) {
+	ofTaskPool & pool = ofGetTaskPool();
+	Result result;
+
+	// ---------------------------- back project and transform every input,
+	// invalid points are NaN so each one has a fixed place
+	vector<size_t> offsets;
+	size_t total = 0;
+	for(auto & input : inputs) {
+		offsets.push_back(total);
+		if(input.distance.isAllocated()) {
+			size_t w = (input.distance.getWidth() + input.step - 1) / input.step;
+			size_t h = (input.distance.getHeight() + input.step - 1) / input.step;
+			total += w * h;
+		} else {
+			total += input.points.size();
+		}
+	}
+
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	vector<glm::vec3> points(total);
+	for(size_t i = 0; i < inputs.size(); i++) {
+		const Input & input = inputs[i];
+		glm::vec3 * dst = points.data() + offsets[i];
+		if(input.distance.isAllocated()) {
+			size_t w = input.distance.getWidth();
+			size_t h = input.distance.getHeight();
+			size_t rowPoints = (w + input.step - 1) / input.step;
+			size_t rows = (h + input.step - 1) / input.step;
+			pool.parallelFor(0, rows, [&](size_t begin, size_t end) {
+				for(size_t row = begin; row < end; row++) {
+					size_t y = row * input.step;
+					const float * z = input.distance.getData() + y * w;
+					glm::vec3 * out = dst + row * rowPoints;
+					for(size_t x = 0, n = 0; x < w; x += input.step, n++) {
+						float d = z[x];
+						if(d <= 0 || d < input.clipping.x || d > input.clipping.y) {
+							out[n] = glm::vec3(nan);
+							continue;
+						}
+						glm::vec4 p((x - input.intrinsics.z) * d / input.intrinsics.x, (y - input.intrinsics.w) * d / input.intrinsics.y, d, 1);
+						out[n] = glm::vec3(input.transform * p);
+					}
+				}
+			});
+		} else {
+			pool.parallelFor(0, input.points.size(), [&](size_t begin, size_t end) {
+				for(size_t n = begin; n < end; n++) {
+					dst[n] = glm::vec3(input.transform * glm::vec4(input.points[n], 1));
+				}
+			});
+		}
+	}
+
+	if(settings.voxelSize <= 0) {
+		for(auto & p : points) {
+			if(!std::isnan(p.x)) {
+				result.points.push_back(p);
+			}
+		}
+		result.numInputPoints = result.points.size();
+		return result;
+	}
+
+	// ---------------------------- average the points of each voxel
+	float scale = 1 / settings.voxelSize;
+	vector<uint64_t> keys(total);
+	std::atomic<size_t> numValid(0);
+	pool.parallelFor(0, total, [&](size_t begin, size_t end) {
+		size_t valid = 0;
+		for(size_t i = begin; i < end; i++) {
+			const glm::vec3 & p = points[i];
+			if(std::isnan(p.x)) {
+				keys[i] = invalidKey;
+			} else {
+				keys[i] = voxelKey(int64_t(std::floor(p.x * scale)), int64_t(std::floor(p.y * scale)), int64_t(std::floor(p.z * scale)));
+				valid++;
+			}
+		}
+		numValid += valid;
+	});
+	result.numInputPoints = numValid;
+
+	size_t numPartitions = pool.getNumThreads() + 1;
+	vector<VoxelMap> voxels(numPartitions);
+	pool.parallelFor(0, numPartitions, [&](size_t begin, size_t end) {
+		for(size_t part = begin; part < end; part++) {
+			VoxelMap & map = voxels[part];
+			map.reserve(numValid / numPartitions);
+			for(size_t i = 0; i < total; i++) {
+				if(keys[i] == invalidKey || partition(keys[i], numPartitions) != part) continue;
+				auto inserted = map.emplace(keys[i], Voxel{points[i], 1});
+				if(!inserted.second) {
+					inserted.first->second.sum += points[i];
+					inserted.first->second.count++;
+				}
+			}
+		}
+	}, 1);
+
+	vector<glm::vec3> centroids;
+	vector<uint64_t> centroidKeys;
+	for(auto & map : voxels) {
+		for(auto & voxel : map) {
+			if(voxel.second.count >= settings.minPoints) {
+				centroids.push_back(voxel.second.sum / float(voxel.second.count));
+				centroidKeys.push_back(voxel.first);
+			}
+		}
+	}
+
+	if(settings.numNeighbors <= 0 || centroids.size() < 2) {
+		result.points = std::move(centroids);
+		return result;
+	}
+
+	// ---------------------------- statistical outlier removal, the mean
+	// distance of each voxel to its closest neighbors, missing neighbors
+	// count as just outside of the search
+	int radius = settings.numNeighbors > 8 ? 2 : 1;
+	int k = settings.numNeighbors;
+	float missing = (radius + 1) * settings.voxelSize;
+	vector<float> meanDistances(centroids.size());
+	pool.parallelFor(0, centroids.size(), [&](size_t begin, size_t end) {
+		float closest[maxNeighbors];
+		for(size_t i = begin; i < end; i++) {
+			uint64_t key = centroidKeys[i];
+			int64_t vx = int64_t(key & keyMask) - keyOffset;
+			int64_t vy = int64_t((key >> 21) & keyMask) - keyOffset;
+			int64_t vz = int64_t((key >> 42) & keyMask) - keyOffset;
+			int found = 0;
+			for(int z = -radius; z <= radius; z++) {
+				for(int y = -radius; y <= radius; y++) {
+					for(int x = -radius; x <= radius; x++) {
+						if(x == 0 && y == 0 && z == 0) continue;
+						uint64_t neighborKey = voxelKey(vx + x, vy + y, vz + z);
+						const VoxelMap & map = voxels[partition(neighborKey, numPartitions)];
+						auto it = map.find(neighborKey);
+						if(it == map.end() || it->second.count < settings.minPoints) continue;
+						float d = glm::distance(centroids[i], it->second.sum / float(it->second.count));
+						// keep the k closest sorted
+						int j = found < k ? found++ : k;
+						if(j == k && d >= closest[k - 1]) continue;
+						if(j == k) j = k - 1;
+						while(j > 0 && closest[j - 1] > d) {
+							closest[j] = closest[j - 1];
+							j--;
+						}
+						closest[j] = d;
+					}
+				}
+			}
+			float sum = 0;
+			for(int j = 0; j < k; j++) {
+				sum += j < found ? closest[j] : missing;
+			}
+			meanDistances[i] = sum / k;
+		}
+	});
+
+	double mean = 0;
+	for(float d : meanDistances) {
+		mean += d;
+	}
+	mean /= meanDistances.size();
+	double variance = 0;
+	for(float d : meanDistances) {
+		variance += (d - mean) * (d - mean);
+	}
+	variance /= meanDistances.size() - 1;
+	float threshold = mean + settings.stdDevMultiplier * std::sqrt(variance);
+
+	result.points.reserve(centroids.size());
+	for(size_t i = 0; i < centroids.size(); i++) {
+		if(meanDistances[i] <= threshold) {
+			result.points.push_back(centroids[i]);
+		}
+	}
+	return result;
+}
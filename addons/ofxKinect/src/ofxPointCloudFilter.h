@@ -0,0 +1,125 @@
+#pragma once
+
+#include "ofMain.h"
+
+class ofxKinect;
+
+/// \class ofxPointCloudFilter
+///
+/// thins and cleans the point clouds of one or more depth sensors on
+/// worker threads
+///
+/// each frame the depth of every sensor is added with its pose, update()
+/// then hands them to the ofTaskPool where they are back projected, fused
+/// and reduced to one point per voxel, the average of the points in it,
+/// and the isolated points are removed with a statistical outlier filter.
+/// the result is uploaded to a mesh that is reused every frame:
+///
+/// ~~~~{.cpp}
+/// void ofApp::update(){
+///     kinect1.update();
+///     kinect2.update();
+///     if(!filter.isProcessing()){
+///         filter.addDepth(kinect1);
+///         filter.addDepth(kinect2, kinect2Pose);
+///     }
+///     filter.update();
+/// }
+///
+/// void ofApp::draw(){
+///     cam.begin();
+///     filter.getMesh().draw();
+///     cam.end();
+/// }
+/// ~~~~
+///
+/// the cloud is one frame behind the sensors, the main thread only copies
+/// the depth pixels and uploads the points that remain
+///
+class ofxPointCloudFilter {
+
+public:
+
+	ofxPointCloudFilter();
+	~ofxPointCloudFilter();
+
+	/// size of the voxels in the units of the points, millimeters for
+	/// ofxKinect, 10 by default, 0 keeps every point
+	void setVoxelSize(float size);
+	float getVoxelSize() const;
+
+	/// voxels with fewer points are dropped, 1 by default
+	void setMinPointsPerVoxel(int points);
+
+	/// removes the voxels whose mean distance to their numNeighbors
+	/// closest voxels is more than stdDevMultiplier standard deviations
+	/// over the mean of the whole cloud, 0 neighbors to disable it
+	///
+	/// the neighbors are searched in the surrounding voxels (5x5x5 when
+	/// numNeighbors is more than 8, 3x3x3 otherwise) so it needs a voxel
+	/// size, 8 neighbors and 1 by default
+	void setOutlierRemoval(int numNeighbors, float stdDevMultiplier = 1);
+
+	/// adds the depth of a kinect in millimeters, transformed by its pose,
+	/// using 1 of every step x step pixels inside the clipping planes
+	void addDepth(const ofxKinect & kinect, const glm::mat4 & transform = glm::mat4(1.0), int step = 1);
+
+	/// adds a depth image of any sensor, with the pinhole intrinsics of
+	/// the camera in pixels, 0 distances are skipped
+	void addDepth(const ofFloatPixels & distance, float focalX, float focalY, float centerX, float centerY,
+		const glm::mat4 & transform = glm::mat4(1.0), int step = 1, float nearClip = 0, float farClip = std::numeric_limits<float>::max());
+
+	/// adds points that are already in 3d, like the ones of
+	/// ofxKinectPointCloud::readToPoints()
+	void addPoints(const vector<glm::vec3> & points, const glm::mat4 & transform = glm::mat4(1.0));
+
+	/// uploads the cloud if the last one finished and starts processing the
+	/// depth and points added since the last call
+	///
+	/// what was added while the previous cloud was still being processed is
+	/// dropped, check isProcessing() to avoid copying it
+	///
+	/// \returns true if the mesh changed
+	bool update();
+
+	/// true while a cloud is being processed
+	bool isProcessing() const;
+
+	/// points in all the input of the last cloud, and the ones left in it
+	size_t getNumInputPoints() const;
+	size_t getNumPoints() const;
+
+	/// the filtered cloud as OF_PRIMITIVE_POINTS, streamed to the GPU
+	ofVboMesh & getMesh();
+	const ofVboMesh & getMesh() const;
+
+private:
+	struct Input {
+		ofFloatPixels distance;
+		glm::vec4 intrinsics; ///< focal x and y, center x and y
+		glm::vec2 clipping;
+		int step = 1;
+		vector<glm::vec3> points;
+		glm::mat4 transform;
+	};
+
+	struct Settings {
+		float voxelSize;
+		int minPoints;
+		int numNeighbors;
+		float stdDevMultiplier;
+	};
+
+	struct Result {
+		vector<glm::vec3> points;
+		size_t numInputPoints = 0;
+	};
+
+	static Result process(const vector<Input> & inputs, const Settings & settings);
+
+	Settings settings;
+	vector<Input> inputs;
+	std::future<Result> pending;
+	size_t numInputPoints;
+	ofVboMesh mesh;
+};
@@ -0,0 +1,120 @@
+#include "ofxMetricsServer.h"
+#include "ofMetrics.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+
+using namespace std;
+
+namespace{
+	// requests bigger than this aren't scrapes
+	const size_t maxRequestSize = 8192;
+}
+
+//--------------------------
+ofxMetricsServer::ofxMetricsServer()
+:port(0)
+,numRequests(0){
+}
+
+//--------------------------
+ofxMetricsServer::~ofxMetricsServer(){
+	close();
+}
+
+//--------------------------
+bool ofxMetricsServer::setup(int port){
+	close();
+	if(!server.Create()){
+		ofLogError("ofxMetricsServer") << "setup(): couldn't create socket";
+		return false;
+	}
+	if(!server.Bind(port) || !server.Listen(16)){
+		ofLogError("ofxMetricsServer") << "setup(): couldn't listen on port " << port;
+		server.Close();
+		return false;
+	}
+	if(!reactor.setup() || !reactor.add(server.GetSocket(), 0)){
+		ofLogError("ofxMetricsServer") << "setup(): couldn't wait for connections";
+		server.Close();
+		return false;
+	}
+	this->port = port;
+	numRequests = 0;
+	startThread();
+	return true;
+}
+
+//--------------------------
+void ofxMetricsServer::close(){
+	if(isThreadRunning()){
+		stopThread();
+		waitForThread(false);
+	}
+	reactor.close();
+	server.Close();
+}
+
+//--------------------------
+int ofxMetricsServer::getPort() const{
+	return port;
+}
+
+//--------------------------
+uint64_t ofxMetricsServer::getNumRequests() const{
+	return numRequests;
+}
+
+//--------------------------
+void ofxMetricsServer::threadedFunction(){
+	vector<ofxTCPReactor::Event> events;
+	while(isThreadRunning()){
+		// short timeout to notice when the thread is stopped
+		if(!reactor.wait(events, 100)){
+			continue;
+		}
+		ofxTCPManager client;
+		if(server.Accept(client)){
+			answer(client);
+			client.Close();
+		}
+	}
+}
+
+//--------------------------
+void ofxMetricsServer::answer(ofxTCPManager & client){
+	// a slow client can't hold the thread for long
+	client.SetTimeoutReceive(2);
+	client.SetTimeoutSend(2);
+
+	string request;
+	char buffer[1024];
+	while(request.find("\r\n\r\n") == string::npos && request.size() < maxRequestSize){
+		int received = client.Receive(buffer, sizeof(buffer));
+		if(received <= 0){
+			return;
+		}
+		request.append(buffer, received);
+	}
+
+	string status = "200 OK";
+	string body;
+	if(request.compare(0, 4, "GET ") != 0){
+		status = "405 Method Not Allowed";
+	}else{
+		auto end = request.find_first_of(" ?", 4);
+		string path = request.substr(4, end == string::npos ? string::npos : end - 4);
+		if(path == "/metrics" || path == "/"){
+			body = ofGetMetrics().getPrometheusText();
+		}else{
+			status = "404 Not Found";
+		}
+	}
+
+	string response = "HTTP/1.1 " + status + "\r\n"
+		"Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+		"Content-Length: " + ofToString(body.size()) + "\r\n"
+		"Connection: close\r\n"
+		"\r\n" + body;
+	client.SendAll(response.c_str(), response.size());
+	numRequests++;
+}
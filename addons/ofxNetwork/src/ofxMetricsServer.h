@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofThread.h"
+#include "ofxTCPManager.h"
+#include "ofxTCPReactor.h"
+#include <atomic>
+
+/// \brief Serves ofGetMetrics() over HTTP in the Prometheus text format
+///
+/// A thread answers every request to /metrics with the current values, so
+/// a Prometheus server or anything else that can scrape an endpoint can
+/// collect them:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofGetMetrics().setEnabled(true);
+///     metricsServer.setup(9100);
+/// }
+/// ~~~~
+///
+/// ~~~~
+/// curl http://localhost:9100/metrics
+/// ~~~~
+///
+/// The values are read without stopping the app, the main thread only
+/// samples the gauge functions every second.
+class ofxMetricsServer: public ofThread{
+public:
+	ofxMetricsServer();
+	~ofxMetricsServer();
+
+	bool setup(int port = 9100);
+	void close();
+
+	int getPort() const;
+
+	/// \brief Requests answered since setup
+	uint64_t getNumRequests() const;
+
+private:
+	void threadedFunction();
+	void answer(ofxTCPManager & client);
+
+	ofxTCPManager server;
+	ofxTCPReactor reactor;
+	int port;
+	std::atomic<uint64_t> numRequests;
+};
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "ofxMetricsServer.h"
 #include "ofxTCPClient.h"
 #include "ofxTCPManager.h"
 #include "ofxTCPServer.h"
+#include "ofxUDPFrameStream.h"
 #include "ofxUDPManager.h"
+#include "ofxUDPReceiver.h"
@@ -1,9 +1,24 @@
 #include "ofxTCPClient.h"
 #include "ofAppRunner.h"
 #include "ofxNetworkUtils.h"
+#include "ofMetrics.h"
+#include <algorithm>
+#include <climits>
 
 using namespace std;
 
+namespace{
+	ofMetricGauge & sendQueueMetric(){
+		static ofMetricGauge & gauge = ofGetMetrics().getGauge("ofxnetwork_tcp_send_queue_bytes", "Bytes queued by every ofxTCPClient with async send");
+		return gauge;
+	}
+
+	ofMetricCounter & sendQueueFullMetric(){
+		static ofMetricCounter & counter = ofGetMetrics().getCounter("ofxnetwork_tcp_send_queue_full_total", "Sends rejected because the queue was full");
+		return counter;
+	}
+}
+
 //--------------------------
 ofxTCPClient::ofxTCPClient(){
 
@@ -17,6 +32,16 @@ ofxTCPClient::ofxTCPClient(){
 
 	partialPrevMsg = "";
 	messageDelimiter = "[/TCP]";
+	frameStart = 0;
+	frameEnd = 0;
+	frameConsumed = 0;
+	maxFrameSize = 64 * 1024 * 1024;
+	asyncSend = false;
+	sendQueueSize = 0;
+	maxSendQueueSize = 4 * 1024 * 1024;
+	sending = false;
+	sendThreadRunning = false;
+	sendFailed = false;
 	memset(tmpBuff,  0, TCP_MAX_MSG_SIZE+1);
 }
 
@@ -53,12 +78,20 @@ bool ofxTCPClient::setup(const ofxTCPSettings & settings){
 	}
 
 	TCPClient.SetNonBlocking(!settings.blocking);
+	if(settings.noDelay){
+		TCPClient.SetNoDelay(true);
+	}
 
 	setMessageDelimiter(settings.messageDelimiter);
+	asyncSend = settings.asyncSend;
+	maxSendQueueSize = settings.maxSendQueueSize;
 
 	port		= settings.port;
 	ipAddr		= settings.address;
 	connected	= true;
+	if(asyncSend){
+		startSendThread();
+	}
 	return true;
 }
 
@@ -79,12 +112,17 @@ bool ofxTCPClient::setupConnectionIdx(int _index, bool blocking){
 
 	TCPClient.SetNonBlocking(!blocking);
 	connected 	= true;
+	if(asyncSend){
+		startSendThread();
+	}
 	return true;
 }
 
 
 //--------------------------
 bool ofxTCPClient::close(){
+	// the send thread can't be writing to the socket while it closes
+	stopSendThread();
 	if( connected ){
 		if( !TCPClient.Close() ){
 			ofLogError("ofxTCPClient") << "close(): couldn't close client";
@@ -92,6 +130,9 @@ bool ofxTCPClient::close(){
 		}else{
             ofLogVerbose("ofxTCPClient") << "closing client";
 			connected = false;
+			frameStart = 0;
+			frameEnd = 0;
+			frameConsumed = 0;
 			return true;
 		}
 	}else{
@@ -120,6 +161,11 @@ bool ofxTCPClient::send(string message){
 	}
 	message = partialPrevMsg + message + messageDelimiter;
 	message += (char)0; //for flash
+	if(asyncSend){
+		partialPrevMsg = "";
+		ofxTCPSendChunk chunk{message.c_str(), message.length()};
+		return queueSend(&chunk, 1, "send");
+	}
 	int ret = TCPClient.SendAll( message.c_str(), message.length() );
     int errorCode = 0;
     if(ret<0) errorCode = ofxNetworkCheckError();
@@ -156,6 +202,17 @@ bool ofxTCPClient::sendRawMsg(const char * msg, int size){
 		ofLogWarning("ofxTCPClient") << "sendRawMsg(): not connected, call setup() first";
 		return false;
 	}
+	if(asyncSend){
+		// whatever was left of a partial send goes first
+		ofxTCPSendChunk chunks[3] = {
+			{tmpBuffSend.getData(), tmpBuffSend.size()},
+			{msg, size_t(size)},
+			{messageDelimiter.c_str(), messageDelimiter.size()},
+		};
+		bool queued = queueSend(chunks, 3, "sendRawMsg");
+		tmpBuffSend.clear();
+		return queued;
+	}
 	tmpBuffSend.append(msg,size);
 	tmpBuffSend.append(messageDelimiter.c_str(),messageDelimiter.size());
 
@@ -185,6 +242,10 @@ bool ofxTCPClient::sendRawMsg(const char * msg, int size){
 //--------------------------
 bool ofxTCPClient::sendRaw(string message){
 	if( message.length() == 0) return false;
+	if(asyncSend){
+		ofxTCPSendChunk chunk{message.c_str(), message.length()};
+		return queueSend(&chunk, 1, "sendRaw");
+	}
     int ret = TCPClient.SendAll(message.c_str(), message.length());
     int errorCode = 0;
     if(ret<0) errorCode = ofxNetworkCheckError();
@@ -200,6 +261,10 @@ bool ofxTCPClient::sendRaw(string message){
 //--------------------------
 bool ofxTCPClient::sendRawBytes(const char* rawBytes, const int numBytes){
 	if( numBytes <= 0) return false;
+	if(asyncSend){
+		ofxTCPSendChunk chunk{rawBytes, size_t(numBytes)};
+		return queueSend(&chunk, 1, "sendRawBytes");
+	}
 	int ret = TCPClient.SendAll(rawBytes, numBytes);
     int errorCode = 0;
     if(ret<0) errorCode = ofxNetworkCheckError();
@@ -213,6 +278,282 @@ bool ofxTCPClient::sendRawBytes(const char* rawBytes, const int numBytes){
 }
 
 
+//--------------------------
+bool ofxTCPClient::sendv(const ofxTCPSendChunk * chunks, size_t numChunks){
+	if( numChunks == 0 ) return false;
+	if(asyncSend){
+		return queueSend(chunks, numChunks, "sendv");
+	}
+	int ret = TCPClient.SendAllV(chunks, numChunks);
+	int errorCode = 0;
+	if(ret<0) errorCode = ofxNetworkCheckError();
+	if( isClosingCondition(ret, errorCode) ){
+		ofLogError("ofxTCPClient") << "sendv(): sending failed";
+		close();
+		return false;
+	}else{
+		return ret >= 0;
+	}
+}
+
+//--------------------------
+bool ofxTCPClient::sendFrame(const char * data, size_t size){
+	ofxTCPSendChunk chunk{data, size};
+	return sendFrame(&chunk, 1);
+}
+
+//--------------------------
+bool ofxTCPClient::sendFrame(const ofBuffer & buffer){
+	return sendFrame(buffer.getData(), buffer.size());
+}
+
+//--------------------------
+bool ofxTCPClient::sendFrame(const ofxTCPSendChunk * chunks, size_t numChunks){
+	size_t size = 0;
+	for(size_t i = 0; i < numChunks; i++){
+		size += chunks[i].size;
+	}
+	if(size > maxFrameSize){
+		ofLogError("ofxTCPClient") << "sendFrame(): frame of " << size << " bytes is bigger than the max frame size " << maxFrameSize;
+		return false;
+	}
+
+	unsigned char header[4] = {
+		(unsigned char)(size >> 24),
+		(unsigned char)(size >> 16),
+		(unsigned char)(size >> 8),
+		(unsigned char)(size),
+	};
+
+	// the header goes in the same system call as the data, most
+	// frames are only a header and one chunk so avoid the allocation
+	const size_t maxLocalChunks = 8;
+	if(numChunks < maxLocalChunks){
+		ofxTCPSendChunk all[maxLocalChunks];
+		all[0] = {(const char*)header, 4};
+		std::copy(chunks, chunks + numChunks, all + 1);
+		return sendv(all, numChunks + 1);
+	}else{
+		vector<ofxTCPSendChunk> all(numChunks + 1);
+		all[0] = {(const char*)header, 4};
+		std::copy(chunks, chunks + numChunks, all.begin() + 1);
+		return sendv(all.data(), all.size());
+	}
+}
+
+//--------------------------
+void ofxTCPClient::setAsyncSend(bool async, size_t maxQueueSize){
+	{
+		std::unique_lock<std::mutex> lock(sendMutex);
+		maxSendQueueSize = maxQueueSize;
+	}
+	if(async == asyncSend){
+		return;
+	}
+	asyncSend = async;
+	if(!connected){
+		return;
+	}
+	if(asyncSend){
+		startSendThread();
+	}else{
+		// what's queued goes out before the next direct send
+		flush(INT_MAX);
+		stopSendThread();
+	}
+}
+
+//--------------------------
+bool ofxTCPClient::isAsyncSend() const{
+	return asyncSend;
+}
+
+//--------------------------
+size_t ofxTCPClient::getSendQueueSize() const{
+	std::unique_lock<std::mutex> lock(sendMutex);
+	return sendQueueSize;
+}
+
+//--------------------------
+size_t ofxTCPClient::getNumQueuedMessages() const{
+	std::unique_lock<std::mutex> lock(sendMutex);
+	return sendQueue.size();
+}
+
+//--------------------------
+bool ofxTCPClient::flush(int timeoutMs){
+	std::unique_lock<std::mutex> lock(sendMutex);
+	auto done = [this]{ return (sendQueue.empty() && !sending) || !sendThreadRunning; };
+	if(timeoutMs == INT_MAX){
+		sendDoneCondition.wait(lock, done);
+	}else{
+		sendDoneCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs), done);
+	}
+	return sendQueue.empty() && !sending;
+}
+
+//--------------------------
+bool ofxTCPClient::setNoDelay(bool noDelay){
+	return TCPClient.SetNoDelay(noDelay);
+}
+
+//--------------------------
+bool ofxTCPClient::setCork(bool cork){
+	return TCPClient.SetCork(cork);
+}
+
+//--------------------------
+bool ofxTCPClient::queueSend(const ofxTCPSendChunk * chunks, size_t numChunks, const char * caller){
+	if(sendFailed){
+		ofLogWarning("ofxTCPClient") << caller << "(): client disconnected";
+		close();
+		return false;
+	}
+	if(!sendThreadRunning){
+		ofLogWarning("ofxTCPClient") << caller << "(): not connected, call setup() first";
+		return false;
+	}
+	size_t size = 0;
+	for(size_t i = 0; i < numChunks; i++){
+		size += chunks[i].size;
+	}
+
+	std::unique_lock<std::mutex> lock(sendMutex);
+	// a message bigger than the limit still goes if nothing is waiting
+	if(sendQueueSize > 0 && sendQueueSize + size > maxSendQueueSize){
+		ofLogVerbose("ofxTCPClient") << caller << "(): send queue full, "
+			<< sendQueue.size() << " messages and " << sendQueueSize << " bytes waiting";
+		sendQueueFullMetric().add();
+		return false;
+	}
+	std::vector<char> buffer;
+	if(!freeSendBuffers.empty()){
+		buffer = std::move(freeSendBuffers.back());
+		freeSendBuffers.pop_back();
+	}
+	buffer.reserve(size);
+	for(size_t i = 0; i < numChunks; i++){
+		buffer.insert(buffer.end(), chunks[i].data, chunks[i].data + chunks[i].size);
+	}
+	sendQueue.push_back(std::move(buffer));
+	sendQueueSize += size;
+	sendQueueMetric().add(size);
+	sendCondition.notify_one();
+	return true;
+}
+
+//--------------------------
+void ofxTCPClient::startSendThread(){
+	if(sendThread.joinable()){
+		if(sendThreadRunning){
+			return;
+		}
+		// stopped after a failed send
+		sendThread.join();
+	}
+	sendFailed = false;
+	sendThreadRunning = true;
+	sendThread = std::thread(&ofxTCPClient::sendThreadFunction, this);
+}
+
+//--------------------------
+void ofxTCPClient::stopSendThread(){
+	if(!sendThread.joinable()){
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock(sendMutex);
+		sendThreadRunning = false;
+		sendCondition.notify_one();
+	}
+	sendThread.join();
+	std::unique_lock<std::mutex> lock(sendMutex);
+	sendQueue.clear();
+	sendQueueMetric().add(-double(sendQueueSize));
+	sendQueueSize = 0;
+	sendDoneCondition.notify_all();
+}
+
+//--------------------------
+void ofxTCPClient::sendThreadFunction(){
+	// iovecs per writev, below IOV_MAX everywhere
+	const size_t maxChunksPerSend = 512;
+	std::deque<std::vector<char>> batch;
+	std::vector<ofxTCPSendChunk> chunks;
+	std::unique_lock<std::mutex> lock(sendMutex);
+	while(true){
+		sendCondition.wait(lock, [this]{ return !sendThreadRunning || !sendQueue.empty(); });
+		if(!sendThreadRunning){
+			break;
+		}
+		// everything queued since the last write goes out together
+		std::swap(batch, sendQueue);
+		sending = true;
+		lock.unlock();
+
+		size_t sentBytes = 0;
+		bool failed = false;
+		for(size_t first = 0; first < batch.size() && !failed && sendThreadRunning; first += maxChunksPerSend){
+			size_t last = std::min(batch.size(), first + maxChunksPerSend);
+			chunks.clear();
+			size_t size = 0;
+			for(size_t i = first; i < last; i++){
+				chunks.push_back({batch[i].data(), batch[i].size()});
+				size += batch[i].size();
+			}
+			while(sendThreadRunning){
+				int ret = TCPClient.SendAllV(chunks.data(), chunks.size());
+				if(ret >= 0){
+					sentBytes += size;
+					break;
+				}
+				// non blocking sockets fail when nothing fits, once part
+				// of the data is out SendAllV waits for the rest itself
+		#ifdef TARGET_WIN32
+				bool wouldBlock = ret == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK;
+		#else
+				bool wouldBlock = ret == SOCKET_ERROR && (errno == EAGAIN || errno == EWOULDBLOCK);
+		#endif
+				if(wouldBlock && TCPClient.WaitWritable(100) != SOCKET_ERROR){
+					continue;
+				}
+				int errorCode = ofxNetworkCheckError();
+				if(isClosingCondition(ret, errorCode)){
+					ofLogWarning("ofxTCPClient") << "send thread: client disconnected";
+				}else{
+					ofLogError("ofxTCPClient") << "send thread: sending failed";
+				}
+				failed = true;
+				break;
+			}
+		}
+
+		lock.lock();
+		size_t done = std::min(sendQueueSize, sentBytes);
+		sendQueueSize -= done;
+		sendQueueMetric().add(-double(done));
+		// keep a few buffers around so queueing doesn't allocate
+		for(auto & buffer : batch){
+			if(freeSendBuffers.size() >= 64){
+				break;
+			}
+			buffer.clear();
+			freeSendBuffers.push_back(std::move(buffer));
+		}
+		batch.clear();
+		sending = false;
+		if(failed){
+			// the main thread closes the connection on the next send
+			sendFailed = true;
+			sendThreadRunning = false;
+			sendQueue.clear();
+			sendQueueMetric().add(-double(sendQueueSize));
+			sendQueueSize = 0;
+		}
+		sendDoneCondition.notify_all();
+	}
+}
+
 //this only works after you have called receive
 //--------------------------
 int ofxTCPClient::getNumReceivedBytes(){
@@ -351,10 +692,81 @@ string ofxTCPClient::receiveRaw(){
 	return tmpBuff;
 }
 
+//--------------------------
+bool ofxTCPClient::receiveFrame(ofxTCPFrame & frame){
+	// the previous frame isn't needed anymore
+	frameStart += frameConsumed;
+	frameConsumed = 0;
+	if(frameStart == frameEnd){
+		frameStart = 0;
+		frameEnd = 0;
+	}
+	if(frameBuffer.empty()){
+		frameBuffer.resize(std::min<size_t>(64 * 1024, maxFrameSize + 4));
+	}
+
+	while(true){
+		size_t available = frameEnd - frameStart;
+		size_t needed = 4;
+		if(available >= 4){
+			const unsigned char * header = (const unsigned char*)frameBuffer.data() + frameStart;
+			size_t size = (size_t(header[0]) << 24) | (size_t(header[1]) << 16) | (size_t(header[2]) << 8) | size_t(header[3]);
+			if(size > maxFrameSize){
+				ofLogError("ofxTCPClient") << "receiveFrame(): frame of " << size << " bytes is bigger than the max frame size " << maxFrameSize << ", closing";
+				close();
+				return false;
+			}
+			needed = 4 + size;
+			if(available >= needed){
+				frame.data = frameBuffer.data() + frameStart + 4;
+				frame.size = size;
+				frameConsumed = needed;
+				return true;
+			}
+		}
+
+		// make room at the end of the buffer for the rest of the frame,
+		// the data left is only moved when it doesn't fit anymore
+		if(frameStart + needed > frameBuffer.size()){
+			if(frameStart > 0){
+				memmove(frameBuffer.data(), frameBuffer.data() + frameStart, available);
+				frameStart = 0;
+				frameEnd = available;
+			}
+			if(needed > frameBuffer.size()){
+				frameBuffer.resize(std::max(needed, frameBuffer.size() * 2));
+			}
+		}
+
+		int received = TCPClient.Receive(frameBuffer.data() + frameEnd, int(std::min<size_t>(frameBuffer.size() - frameEnd, INT_MAX)));
+		if(received > 0){
+			frameEnd += received;
+			continue;
+		}
+
+		int errorCode = 0;
+		if(received<0) errorCode = ofxNetworkCheckError();
+		if(received == 0 || isClosingCondition(received, errorCode)){
+			close();
+		}
+		return false;
+	}
+}
+
+//--------------------------
+void ofxTCPClient::setMaxFrameSize(size_t numBytes){
+	maxFrameSize = std::min<size_t>(numBytes, 0xFFFFFFFF);
+}
+
+//--------------------------
+size_t ofxTCPClient::getMaxFrameSize() const{
+	return maxFrameSize;
+}
+
 //--------------------------
 bool ofxTCPClient::isConnected(){
 	if (connected) {
-		if (!TCPClient.CheckIsConnected()) {
+		if (sendFailed || !TCPClient.CheckIsConnected()) {
 			close();
 		}
 	}
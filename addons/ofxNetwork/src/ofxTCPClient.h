@@ -5,6 +5,11 @@
 #include "ofxTCPSettings.h"
 #include "ofFileUtils.h"
 #include "ofTypes.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #define TCP_MAX_MSG_SIZE 512
 //#define STR_END_MSG "[/TCP]"
@@ -49,6 +54,48 @@ class ofxTCPClient{
 		//if you are trying to send something other than just ascii strings
 		bool sendRawBytes(const char * rawBytes, const int numBytes);
 
+		//sends all the chunks one after the other, ie. a header
+		//and a payload, without copying them together first
+		bool sendv(const ofxTCPSendChunk * chunks, size_t numChunks);
+
+		//length prefixed messages: a 4 byte big endian size
+		//followed by the data. binary safe and the receiver
+		//doesn't need to search for a delimiter, use them with
+		//receiveFrame on the other end
+		bool sendFrame(const char * data, size_t size);
+		bool sendFrame(const ofBuffer & buffer);
+
+		//sends all the chunks as a single frame
+		bool sendFrame(const ofxTCPSendChunk * chunks, size_t numChunks);
+
+		//queue every send and write them from a thread, the
+		//messages queued meanwhile go out together in one system
+		//call and a slow peer doesn't block the caller. sends fail
+		//instead of blocking once maxQueueSize bytes are waiting,
+		//check getSendQueueSize to slow down before that.
+		//what's still queued when closing is dropped, call flush
+		//first to wait for it. close still waits for a write that
+		//already started
+		void setAsyncSend(bool async, size_t maxQueueSize = 4 * 1024 * 1024);
+		bool isAsyncSend() const;
+
+		//bytes and messages queued with async send
+		size_t getSendQueueSize() const;
+		size_t getNumQueuedMessages() const;
+
+		//waits up to timeoutMs for the queue to be sent,
+		//false if there's still something waiting
+		bool flush(int timeoutMs = 1000);
+
+		//disables nagle's algorithm, small messages go out
+		//right away instead of waiting to be merged with the next
+		bool setNoDelay(bool noDelay);
+
+		//while corked only full packets are sent, cork before
+		//many small sends and uncork to send what's left.
+		//linux (TCP_CORK) and osx (TCP_NOPUSH) only
+		bool setCork(bool cork);
+
 
 		//get the message as a string
 		//this will only work with messages coming via
@@ -77,6 +124,16 @@ class ofxTCPClient{
 		//is at least as big as numBytes
 		int receiveRawMsg(char * receiveBuffer, int numBytes);
 
+		//receives a message sent with sendFrame, returns false
+		//if there's no complete one yet. the data is not copied,
+		//frame points into a buffer that is reused for every frame
+		bool receiveFrame(ofxTCPFrame & frame);
+
+		//frames bigger than this close the connection,
+		//64MB by default
+		void setMaxFrameSize(size_t numBytes);
+		size_t getMaxFrameSize() const;
+
 
 		bool isConnected();
 		int getPort();
@@ -95,6 +152,10 @@ private:
         //--------------------------
 		bool setupConnectionIdx(int _index, bool blocking);
 		bool isClosingCondition(int messageSize, int errorCode);
+		bool queueSend(const ofxTCPSendChunk * chunks, size_t numChunks, const char * caller);
+		void startSendThread();
+		void stopSendThread();
+		void sendThreadFunction();
 		friend class ofxTCPServer;
 
 		ofxTCPManager	TCPClient;
@@ -107,4 +168,16 @@ private:
 		bool			connected;
 		std::string 	partialPrevMsg;
 		std::string		messageDelimiter;
+		std::vector<char>	frameBuffer;
+		size_t			frameStart, frameEnd, frameConsumed, maxFrameSize;
+
+		bool			asyncSend;
+		std::thread		sendThread;
+		mutable std::mutex	sendMutex;
+		std::condition_variable	sendCondition, sendDoneCondition;
+		std::deque<std::vector<char>>	sendQueue;
+		std::vector<std::vector<char>>	freeSendBuffers;
+		size_t			sendQueueSize, maxSendQueueSize;
+		bool			sending;
+		std::atomic<bool>	sendThreadRunning, sendFailed;
 };
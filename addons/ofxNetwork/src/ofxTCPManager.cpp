@@ -1,6 +1,7 @@
 #include "ofxTCPManager.h"
 #include <stdio.h>
 #include "ofxNetworkUtils.h"
+#include <vector>
 
 //--------------------------------------------------------------------------------
 bool ofxTCPManager::m_bWinsockInit= false;
@@ -395,6 +396,98 @@ int ofxTCPManager::SendAll(const char* pBuff, const int iSize)
 }
 
 
+//--------------------------------------------------------------------------------
+/// Return values:
+/// SOCKET_TIMEOUT indicates timeout
+/// SOCKET_ERROR in case of a problem.
+///
+/// Once part of the data is out it waits for the socket to be writable
+/// instead of failing even on non-blocking sockets, so the receiver never
+/// gets half a message
+int ofxTCPManager::SendAllV(const ofxTCPSendChunk* pChunks, const size_t numChunks)
+{
+	if (m_hSocket == INVALID_SOCKET) return(SOCKET_ERROR);
+
+#ifdef TARGET_WIN32
+	std::vector<WSABUF> buffers(numChunks);
+	for(size_t i = 0; i < numChunks; i++){
+		buffers[i].buf = (CHAR*)pChunks[i].data;
+		buffers[i].len = (ULONG)pChunks[i].size;
+	}
+#else
+	std::vector<iovec> buffers(numChunks);
+	for(size_t i = 0; i < numChunks; i++){
+		buffers[i].iov_base = (void*)pChunks[i].data;
+		buffers[i].iov_len = pChunks[i].size;
+	}
+#endif
+
+	auto timestamp = ofGetElapsedTimeMicros();
+	auto timeleftSecs = m_dwTimeoutSend;
+	auto timeleftMicros = 0;
+	size_t first = 0;
+	int total = 0;
+
+	while (first < numChunks) {
+		if (m_dwTimeoutSend	!= NO_TIMEOUT){
+			auto ret = WaitSend(timeleftSecs,timeleftMicros);
+			if(ret!=0){
+				return ret;
+			}
+		}
+#ifdef TARGET_WIN32
+		DWORD sent = 0;
+		int ret = WSASend(m_hSocket, buffers.data() + first, DWORD(numChunks - first), &sent, 0, NULL, NULL);
+		if (ret == 0) ret = sent;
+		bool wouldBlock = ret == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+		int ret = writev(m_hSocket, buffers.data() + first, int(numChunks - first));
+		bool wouldBlock = ret == SOCKET_ERROR && (errno == EAGAIN || errno == EWOULDBLOCK);
+#endif
+		if (wouldBlock && total > 0) {
+			if (m_dwTimeoutSend == NO_TIMEOUT && WaitSend(1,0) == SOCKET_ERROR) {
+				return SOCKET_ERROR;
+			}
+			ret = 0;
+		}else if (ret == SOCKET_ERROR) {
+			return SOCKET_ERROR;
+		}
+		total += ret;
+
+		// skip what went out, the first pending buffer might be half sent
+		size_t sent = ret;
+		for (; first < numChunks; first++) {
+#ifdef TARGET_WIN32
+			auto & len = buffers[first].len;
+			auto & base = buffers[first].buf;
+#else
+			auto & len = buffers[first].iov_len;
+			auto & base = buffers[first].iov_base;
+#endif
+			if (sent < len) {
+				base = (char*)base + sent;
+				len -= sent;
+				break;
+			}
+			sent -= len;
+		}
+
+		if (m_dwTimeoutSend	!= NO_TIMEOUT){
+			auto now = ofGetElapsedTimeMicros();
+			auto diff = now - timestamp;
+			if (diff > m_dwTimeoutSend * 1000000){
+				return first < numChunks ? SOCKET_TIMEOUT : total;
+			}
+			float timeFloat = m_dwTimeoutSend - diff/1000000.;
+			timeleftSecs = timeFloat;
+			timeleftMicros = (timeFloat - timeleftSecs) * 1000000;
+		}
+	}
+
+	return total;
+}
+
+
 //--------------------------------------------------------------------------------
 /// Return values:
 /// SOCKET_TIMEOUT indicates timeout
@@ -591,6 +684,43 @@ bool ofxTCPManager::SetSendBufferSize(int sizeInByte) {
 	}
 }
 
+bool ofxTCPManager::SetNoDelay(bool noDelay) {
+	if (m_hSocket == INVALID_SOCKET) return(false);
+
+	int flag = noDelay ? 1 : 0;
+	if ( setsockopt(m_hSocket, IPPROTO_TCP, TCP_NODELAY, (char*)&flag, sizeof(flag)) == 0){
+		return true;
+	}else{
+		ofxNetworkCheckError();
+		return false;
+	}
+}
+
+bool ofxTCPManager::SetCork(bool cork) {
+	if (m_hSocket == INVALID_SOCKET) return(false);
+
+#if defined(TCP_CORK) || defined(TCP_NOPUSH)
+	int flag = cork ? 1 : 0;
+	#ifdef TCP_CORK
+	int option = TCP_CORK;
+	#else
+	int option = TCP_NOPUSH;
+	#endif
+	if ( setsockopt(m_hSocket, IPPROTO_TCP, option, (char*)&flag, sizeof(flag)) == 0){
+		return true;
+	}else{
+		ofxNetworkCheckError();
+		return false;
+	}
+#else
+	return false;
+#endif
+}
+
+int ofxTCPManager::WaitWritable(int timeoutMs) {
+	return WaitSend(timeoutMs / 1000, (timeoutMs % 1000) * 1000);
+}
+
 int ofxTCPManager::GetMaxConnections() {
   return m_iMaxConnections;
 }
@@ -64,6 +64,8 @@ SetTimeoutReceive()
 	#include <sys/socket.h>
 	#include <sys/time.h>
 	#include <sys/ioctl.h>
+	#include <sys/uio.h>
+	#include <netinet/tcp.h>
 
 #ifndef TARGET_ANDROID
 	#include <sys/signal.h>
@@ -162,6 +164,25 @@ typedef InetAddr*			LPINETADDR;
 #define OF_TCP_DEFAULT_TIMEOUT     NO_TIMEOUT
 
 
+//--------------------------------------------------------------------------------
+/// One of the buffers sent one after the other by ofxTCPManager::SendAllV
+struct ofxTCPSendChunk{
+	const char * data;
+	size_t size;
+};
+
+/// A message received with ofxTCPClient::receiveFrame, points into the
+/// client's receive buffer so it's only valid until the next receiveFrame
+struct ofxTCPFrame{
+	const char * data = nullptr;
+	size_t size = 0;
+
+	std::string getText() const{
+		return std::string(data, size);
+	}
+};
+
+
 //--------------------------------------------------------------------------------
 /// Implementation of a TCP socket.
 class ofxTCPManager
@@ -182,6 +203,9 @@ public:
 	int  Send(const char* pBuff, const int iSize);
 	//all data will be sent guaranteed.
 	int  SendAll(const char* pBuff, const int iSize);
+	//same as SendAll for several buffers in one system call, without
+	//copying them together first
+	int  SendAllV(const ofxTCPSendChunk* pChunks, const size_t numChunks);
 	int  PeekReceive(char* pBuff, const int iSize);
 	int  Receive(char* pBuff, const int iSize);
 	int  ReceiveAll(char* pBuff, const int iSize);
@@ -203,12 +227,26 @@ public:
 	int  GetMaxConnections();
 	bool SetNonBlocking(bool useNonBlocking);
     bool IsNonBlocking();
+	//disables nagle's algorithm so small writes go out right away
+	bool SetNoDelay(bool noDelay);
+	//holds partial packets until uncorked, linux and osx only
+	bool SetCork(bool cork);
+	//waits up to timeoutMs for the socket to be writable, 0 when it is,
+	//SOCKET_TIMEOUT or SOCKET_ERROR otherwise
+	int  WaitWritable(int timeoutMs);
 	bool CheckHost(const char *pAddrStr);
 	void CleanUp();
 
 	// Tries to detect half open connection http://stackoverflow.com/a/283387
 	bool CheckIsConnected();
 
+	// the native socket, to wait for it with a reactor
+  #ifdef TARGET_WIN32
+	SOCKET GetSocket() const { return m_hSocket; }
+  #else
+	int GetSocket() const { return m_hSocket; }
+  #endif
+
 
 private:
 	// private copy so this can't be copied to avoid problems with destruction
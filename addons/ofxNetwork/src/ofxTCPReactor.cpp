@@ -0,0 +1,173 @@
+#include "ofxTCPReactor.h"
+#include "ofxNetworkUtils.h"
+#include "ofLog.h"
+
+#if defined(OFX_TCP_REACTOR_EPOLL)
+	#include <sys/epoll.h>
+#elif defined(OFX_TCP_REACTOR_KQUEUE)
+	#include <sys/event.h>
+#endif
+
+using namespace std;
+
+namespace{
+	// events read from the kernel each wait, more stay for the next one
+	const int maxEvents = 256;
+}
+
+//--------------------------
+ofxTCPReactor::ofxTCPReactor(){
+#if defined(OFX_TCP_REACTOR_EPOLL) || defined(OFX_TCP_REACTOR_KQUEUE)
+	fd = -1;
+#endif
+	numSockets = 0;
+}
+
+//--------------------------
+ofxTCPReactor::~ofxTCPReactor(){
+	close();
+}
+
+//--------------------------
+bool ofxTCPReactor::setup(){
+	close();
+#if defined(OFX_TCP_REACTOR_EPOLL)
+	fd = epoll_create1(0);
+#elif defined(OFX_TCP_REACTOR_KQUEUE)
+	fd = kqueue();
+#endif
+#if defined(OFX_TCP_REACTOR_EPOLL) || defined(OFX_TCP_REACTOR_KQUEUE)
+	if(fd < 0){
+		ofxNetworkCheckError();
+		ofLogError("ofxTCPReactor") << "setup(): couldn't create the reactor";
+		return false;
+	}
+#endif
+	return true;
+}
+
+//--------------------------
+void ofxTCPReactor::close(){
+#if defined(OFX_TCP_REACTOR_EPOLL) || defined(OFX_TCP_REACTOR_KQUEUE)
+	if(fd >= 0){
+		::close(fd);
+		fd = -1;
+	}
+#else
+	sockets.clear();
+	ids.clear();
+#endif
+	numSockets = 0;
+}
+
+//--------------------------
+bool ofxTCPReactor::add(Socket socket, int id){
+#if defined(OFX_TCP_REACTOR_EPOLL)
+	epoll_event event;
+	event.events = EPOLLIN | EPOLLRDHUP;
+	event.data.u64 = 0;
+	event.data.fd = id;
+	if(epoll_ctl(fd, EPOLL_CTL_ADD, socket, &event) != 0){
+		ofxNetworkCheckError();
+		ofLogError("ofxTCPReactor") << "add(): couldn't add socket " << id;
+		return false;
+	}
+#elif defined(OFX_TCP_REACTOR_KQUEUE)
+	struct kevent event;
+	EV_SET(&event, socket, EVFILT_READ, EV_ADD, 0, 0, (void*)(intptr_t)id);
+	if(kevent(fd, &event, 1, nullptr, 0, nullptr) != 0){
+		ofxNetworkCheckError();
+		ofLogError("ofxTCPReactor") << "add(): couldn't add socket " << id;
+		return false;
+	}
+#else
+	#ifdef TARGET_WIN32
+	WSAPOLLFD poll;
+	#else
+	pollfd poll;
+	#endif
+	poll.fd = socket;
+	poll.events = POLLIN;
+	poll.revents = 0;
+	sockets.push_back(poll);
+	ids.push_back(id);
+#endif
+	numSockets++;
+	return true;
+}
+
+//--------------------------
+void ofxTCPReactor::remove(Socket socket, int id){
+#if defined(OFX_TCP_REACTOR_EPOLL)
+	if(epoll_ctl(fd, EPOLL_CTL_DEL, socket, nullptr) != 0){
+		return;
+	}
+#elif defined(OFX_TCP_REACTOR_KQUEUE)
+	struct kevent event;
+	EV_SET(&event, socket, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+	if(kevent(fd, &event, 1, nullptr, 0, nullptr) != 0){
+		return;
+	}
+#else
+	size_t i = 0;
+	for(; i < ids.size() && ids[i] != id; i++);
+	if(i == sockets.size()){
+		return;
+	}
+	// the order doesn't matter, the last one takes its place
+	sockets[i] = sockets.back();
+	ids[i] = ids.back();
+	sockets.pop_back();
+	ids.pop_back();
+#endif
+	numSockets--;
+}
+
+//--------------------------
+size_t ofxTCPReactor::size() const{
+	return numSockets;
+}
+
+//--------------------------
+bool ofxTCPReactor::wait(vector<Event> & events, int timeoutMs){
+	events.clear();
+#if defined(OFX_TCP_REACTOR_EPOLL)
+	epoll_event ready[maxEvents];
+	int numReady = epoll_wait(fd, ready, maxEvents, timeoutMs);
+	for(int i = 0; i < numReady; i++){
+		bool closed = (ready[i].events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) != 0;
+		events.push_back({ready[i].data.fd, closed});
+	}
+#elif defined(OFX_TCP_REACTOR_KQUEUE)
+	struct kevent ready[maxEvents];
+	timespec timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_nsec = (timeoutMs % 1000) * 1000000;
+	int numReady = kevent(fd, nullptr, 0, ready, maxEvents, &timeout);
+	for(int i = 0; i < numReady; i++){
+		bool closed = (ready[i].flags & (EV_EOF | EV_ERROR)) != 0;
+		events.push_back({int(intptr_t(ready[i].udata)), closed});
+	}
+#else
+	if(sockets.empty()){
+		return false;
+	}
+	#ifdef TARGET_WIN32
+	int numReady = WSAPoll(sockets.data(), ULONG(sockets.size()), timeoutMs);
+	#else
+	int numReady = ::poll(sockets.data(), sockets.size(), timeoutMs);
+	#endif
+	for(size_t i = 0; numReady > 0 && i < sockets.size(); i++){
+		if(sockets[i].revents){
+			bool closed = (sockets[i].revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+			events.push_back({ids[i], closed});
+			sockets[i].revents = 0;
+		}
+	}
+#endif
+	if(numReady < 0){
+		ofxNetworkCheckError();
+		return false;
+	}
+	return !events.empty();
+}
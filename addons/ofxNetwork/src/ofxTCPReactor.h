@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofxTCPManager.h"
+#include <vector>
+
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+	#define OFX_TCP_REACTOR_EPOLL
+#elif defined(TARGET_OSX) || defined(TARGET_OF_IOS)
+	#define OFX_TCP_REACTOR_KQUEUE
+#else
+	#define OFX_TCP_REACTOR_POLL
+	#ifndef TARGET_WIN32
+		#include <poll.h>
+	#endif
+#endif
+
+/// \brief Waits for any number of sockets to be readable from one thread
+///
+/// Uses epoll on linux and android, kqueue on osx and ios and WSAPoll or
+/// poll everywhere else. Each socket is added with an id that identifies
+/// it in the events returned by wait(). Not thread safe, it's meant to be
+/// used only from the thread that waits.
+class ofxTCPReactor{
+public:
+#ifdef TARGET_WIN32
+	typedef SOCKET Socket;
+#else
+	typedef int Socket;
+#endif
+
+	struct Event{
+		int id;
+		/// the other end closed or the socket has an error, there might
+		/// still be data to read before it's closed
+		bool closed;
+	};
+
+	ofxTCPReactor();
+	~ofxTCPReactor();
+
+	ofxTCPReactor(const ofxTCPReactor &) = delete;
+	ofxTCPReactor & operator=(const ofxTCPReactor &) = delete;
+
+	bool setup();
+	void close();
+
+	bool add(Socket socket, int id);
+	/// \brief Stops waiting for socket, sockets that were closed are
+	/// removed by the kernel already but poll needs the id
+	void remove(Socket socket, int id);
+	std::size_t size() const;
+
+	/// \brief Waits up to timeoutMs for any socket to be readable
+	/// \returns the sockets ready in events, false on timeout or error
+	bool wait(std::vector<Event> & events, int timeoutMs);
+
+private:
+#if defined(OFX_TCP_REACTOR_EPOLL) || defined(OFX_TCP_REACTOR_KQUEUE)
+	int fd;
+#else
+	#ifdef TARGET_WIN32
+	std::vector<WSAPOLLFD> sockets;
+	#else
+	std::vector<pollfd> sockets;
+	#endif
+	std::vector<int> ids;
+#endif
+	std::size_t numSockets;
+};
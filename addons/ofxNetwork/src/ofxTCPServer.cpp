@@ -1,15 +1,23 @@
 #include "ofxTCPServer.h"
 #include "ofxTCPClient.h"
+#include "ofxTCPReactor.h"
+#include "ofxNetworkUtils.h"
 #include "ofUtils.h"
 
 //--------------------------
-ofxTCPServer::ofxTCPServer(){
+ofxTCPServer::ofxTCPServer()
+:messages(4096)
+,disconnections(1024){
 	connected	= false;
 	idCount		= 0;
 	port		= 0;
 	str			= "";
 	messageDelimiter = "[/TCP]";
 	bClientBlocking = false;
+	bClientAsyncSend = false;
+	bClientNoDelay = false;
+	clientMaxSendQueueSize = 4 * 1024 * 1024;
+	bReactor	= false;
 }
 
 //--------------------------
@@ -43,9 +51,22 @@ bool ofxTCPServer::setup(const ofxTCPSettings &settings){
 		return false;
 	}
 
+	bReactor		= settings.reactor;
+	if(bReactor){
+		reactor.reset(new ofxTCPReactor);
+		if(!reactor->setup() || !TCPServer.SetNonBlocking(true)){
+			ofLogError("ofxTCPServer") << "setup(): couldn't setup the reactor";
+			TCPServer.Close();
+			return false;
+		}
+	}
+
 	connected		= true;
 	port           	= settings.port;
 	bClientBlocking	= settings.blocking;
+	bClientAsyncSend = settings.asyncSend;
+	bClientNoDelay	= settings.noDelay;
+	clientMaxSendQueueSize = settings.maxSendQueueSize;
 
 	setMessageDelimiter(settings.messageDelimiter);
 
@@ -87,6 +108,9 @@ bool ofxTCPServer::disconnectClient(int clientID){
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "disconnectClient(): client " << clientID << " doesn't exist";
 		return false;
+	}else if(bReactor){
+		// the server thread closes it when it stops waiting for it
+		return disconnections.send(clientID);
 	}else if(getClient(clientID).close()){
 		TCPConnections.erase(clientID);
 		return true;
@@ -97,6 +121,12 @@ bool ofxTCPServer::disconnectClient(int clientID){
 //--------------------------
 bool ofxTCPServer::disconnectAllClients(){
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
+	if(bReactor){
+		for(auto & conn: TCPConnections){
+			disconnections.send(conn.first);
+		}
+		return true;
+	}
     TCPConnections.clear();
     return true;
 }
@@ -172,6 +202,43 @@ bool ofxTCPServer::sendRawBytesToAll(const char * rawBytes, const int numBytes){
 	return true;
 }
 
+//--------------------------
+bool ofxTCPServer::sendFrame(int clientID, const char * data, size_t size){
+	std::unique_lock<std::mutex> lck( mConnectionsLock );
+	if( !isClientSetup(clientID) ){
+		ofLogWarning("ofxTCPServer") << "sendFrame(): client " << clientID << " doesn't exist";
+		return false;
+	}
+	else{
+		return getClient(clientID).sendFrame(data, size);
+	}
+}
+
+//--------------------------
+bool ofxTCPServer::sendFrame(int clientID, const ofxTCPSendChunk * chunks, size_t numChunks){
+	std::unique_lock<std::mutex> lck( mConnectionsLock );
+	if( !isClientSetup(clientID) ){
+		ofLogWarning("ofxTCPServer") << "sendFrame(): client " << clientID << " doesn't exist";
+		return false;
+	}
+	else{
+		return getClient(clientID).sendFrame(chunks, numChunks);
+	}
+}
+
+//--------------------------
+bool ofxTCPServer::sendFrameToAll(const char * data, size_t size){
+	std::unique_lock<std::mutex> lck( mConnectionsLock );
+	if(TCPConnections.empty()) return false;
+
+	for(auto & conn: TCPConnections){
+		if(conn.second->isConnected()){
+			conn.second->sendFrame(data, size);
+		}
+	}
+	return true;
+}
+
 
 //--------------------------
 bool ofxTCPServer::sendRawMsg(int clientID, const char * rawBytes, const int numBytes){
@@ -232,6 +299,17 @@ int ofxTCPServer::peekReceiveRawBytes(int clientID, char * receiveBytes,  int nu
 	return getClient(clientID).peekReceiveRawBytes(receiveBytes, numBytes);
 }
 
+//--------------------------
+bool ofxTCPServer::receiveFrame(int clientID, ofxTCPFrame & frame){
+	std::unique_lock<std::mutex> lck( mConnectionsLock );
+	if( !isClientSetup(clientID) ){
+		ofLogWarning("ofxTCPServer") << "receiveFrame(): client " << clientID << " doesn't exist";
+		return false;
+	}
+
+	return getClient(clientID).receiveFrame(frame);
+}
+
 //--------------------------
 int ofxTCPServer::receiveRawMsg(int clientID, char * receiveBytes,  int numBytes){
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
@@ -309,9 +387,23 @@ void ofxTCPServer::waitConnectedClient(int ms){
 	}
 }
 
+//--------------------------
+bool ofxTCPServer::receiveMessage(ofxTCPMessage & message){
+	return messages.tryReceive(message);
+}
+
+//--------------------------
+bool ofxTCPServer::isReactor() const{
+	return bReactor;
+}
+
 //don't call this
 //--------------------------
 void ofxTCPServer::threadedFunction(){
+	if(bReactor){
+		threadedReactor();
+		return;
+	}
 
 	ofLogVerbose("ofxTCPServer") << "listening thread started";
 	while( isThreadRunning() ){
@@ -346,7 +438,9 @@ void ofxTCPServer::threadedFunction(){
 			TCPConnections[acceptId] = client;
             TCPConnections[acceptId]->setupConnectionIdx(acceptId, bClientBlocking);
 			TCPConnections[acceptId]->setMessageDelimiter(messageDelimiter);
-			ofLogVerbose("ofxTCPServer") << "client " << acceptId << " connected on port " << TCPConnections[acceptId]->getPort();
+			if(bClientNoDelay) TCPConnections[acceptId]->setNoDelay(true);
+			if(bClientAsyncSend) TCPConnections[acceptId]->setAsyncSend(true, clientMaxSendQueueSize);
+			OFLOG_VERBOSE("ofxTCPServer") << "client " << acceptId << " connected on port " << TCPConnections[acceptId]->getPort();
 			if(acceptId == idCount) idCount++;
 			serverReady.notify_all();
 		}
@@ -358,7 +452,171 @@ void ofxTCPServer::threadedFunction(){
 	ofLogVerbose("ofxTCPServer") << "listening thread stopped";
 }
 
+//--------------------------
+void ofxTCPServer::threadedReactor(){
+	ofLogVerbose("ofxTCPServer") << "reactor thread started";
+	if( !TCPServer.Listen(SOMAXCONN) ){
+		ofLogError("ofxTCPServer") << "listening failed";
+	}
+	reactor->add(TCPServer.GetSocket(), -1);
+	readBuffer.resize(65536);
+	{
+		std::unique_lock<std::mutex> lck( mConnectionsLock );
+		serverReady.notify_one();
+	}
+
+	std::vector<ofxTCPReactor::Event> events;
+	while( isThreadRunning() ){
+		int clientID;
+		while(disconnections.tryReceive(clientID)){
+			closeClient(clientID);
+		}
+
+		// messages that didn't fit in the queue go first
+		while(!pendingMessages.empty() && messages.send(std::move(pendingMessages.front()))){
+			pendingMessages.pop_front();
+		}
+
+		// short timeout to notice when the thread is stopped
+		if(!reactor->wait(events, 50)){
+			continue;
+		}
+		for(auto & event: events){
+			if(event.id < 0){
+				acceptClients();
+			}else{
+				readClient(event.id, event.closed);
+			}
+		}
+	}
+
+	std::unique_lock<std::mutex> lck( mConnectionsLock );
+	TCPConnections.clear();
+	partialMessages.clear();
+	pendingMessages.clear();
+	reactor->close();
+	idCount = 0;
+	connected = false;
+	ofLogVerbose("ofxTCPServer") << "reactor thread stopped";
+}
+
+//--------------------------
+void ofxTCPServer::acceptClients(){
+	// the listening socket is non blocking, accept until there's none left
+	while( isThreadRunning() ){
+		std::shared_ptr<ofxTCPClient> client(new ofxTCPClient);
+		if( !TCPServer.Accept( client->TCPClient ) ){
+			return;
+		}
+		int clientID;
+		{
+			std::unique_lock<std::mutex> lck( mConnectionsLock );
+			clientID = idCount++;
+			TCPConnections[clientID] = client;
+			// the reactor reads, the socket never blocks
+			client->setupConnectionIdx(clientID, false);
+			client->setMessageDelimiter(messageDelimiter);
+			if(bClientNoDelay) client->setNoDelay(true);
+			if(bClientAsyncSend) client->setAsyncSend(true, clientMaxSendQueueSize);
+			serverReady.notify_all();
+		}
+		if(!reactor->add(client->TCPClient.GetSocket(), clientID)){
+			std::unique_lock<std::mutex> lck( mConnectionsLock );
+			TCPConnections.erase(clientID);
+			continue;
+		}
+		OFLOG_VERBOSE("ofxTCPServer") << "client " << clientID << " connected on port " << client->getPort();
+		ofxTCPMessage message;
+		message.type = OFX_TCP_CLIENT_CONNECTED;
+		message.clientID = clientID;
+		pushMessage(std::move(message));
+	}
+}
+
+//--------------------------
+void ofxTCPServer::readClient(int clientID, bool closed){
+	std::shared_ptr<ofxTCPClient> client;
+	{
+		std::unique_lock<std::mutex> lck( mConnectionsLock );
+		auto it = TCPConnections.find(clientID);
+		if(it != TCPConnections.end()){
+			client = it->second;
+		}
+	}
+	if(!client || !client->isConnected()){
+		closeClient(clientID);
+		return;
+	}
+
+	auto & partial = partialMessages[clientID];
+	while(true){
+		int received = client->TCPClient.Receive(readBuffer.data(), readBuffer.size());
+		if(received == 0){
+			closed = true;
+			break;
+		}else if(received < 0){
+			int error = ofxNetworkCheckError();
+			if(error != OFXNETWORK_ERROR(WOULDBLOCK) && error != EAGAIN && error != OFXNETWORK_ERROR(INTR)){
+				closed = true;
+			}
+			break;
+		}
+
+		// only the new data and the end of the previous one, where a
+		// delimiter could have started, are searched
+		size_t start = partial.size() > messageDelimiter.size() ? partial.size() - messageDelimiter.size() + 1 : 0;
+		partial.append(readBuffer.data(), received);
+		size_t consumed = 0;
+		size_t found;
+		while((found = partial.find(messageDelimiter, std::max(start, consumed))) != std::string::npos){
+			ofxTCPMessage message;
+			message.type = OFX_TCP_CLIENT_MESSAGE;
+			message.clientID = clientID;
+			message.message = partial.substr(consumed, found - consumed);
+			pushMessage(std::move(message));
+			consumed = found + messageDelimiter.size();
+		}
+		partial.erase(0, consumed);
 
+		if(received < int(readBuffer.size())){
+			break;
+		}
+	}
 
+	if(closed){
+		closeClient(clientID);
+	}
+}
 
+//--------------------------
+void ofxTCPServer::closeClient(int clientID){
+	std::shared_ptr<ofxTCPClient> client;
+	{
+		std::unique_lock<std::mutex> lck( mConnectionsLock );
+		auto it = TCPConnections.find(clientID);
+		if(it != TCPConnections.end()){
+			client = it->second;
+			TCPConnections.erase(it);
+		}
+	}
+	partialMessages.erase(clientID);
+	if(!client){
+		reactor->remove(INVALID_SOCKET, clientID);
+		return;
+	}
+	reactor->remove(client->TCPClient.GetSocket(), clientID);
+	client->close();
+	OFLOG_VERBOSE("ofxTCPServer") << "client " << clientID << " disconnected";
+	ofxTCPMessage message;
+	message.type = OFX_TCP_CLIENT_DISCONNECTED;
+	message.clientID = clientID;
+	pushMessage(std::move(message));
+}
 
+//--------------------------
+void ofxTCPServer::pushMessage(ofxTCPMessage && message){
+	// the queue is full, they wait here so none is lost or out of order
+	if(!pendingMessages.empty() || !messages.send(std::move(message))){
+		pendingMessages.push_back(std::move(message));
+	}
+}
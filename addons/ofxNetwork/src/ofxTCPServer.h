@@ -4,13 +4,29 @@
 #include "ofThread.h"
 #include "ofxTCPManager.h"
 #include "ofxTCPSettings.h"
+#include "ofThreadChannel.h"
 #include <map>
+#include <deque>
 #include <condition_variable>
 
 #define TCP_MAX_CLIENTS  32
 
 //forward decleration
 class ofxTCPClient;
+class ofxTCPReactor;
+
+enum ofxTCPMessageType{
+	OFX_TCP_CLIENT_CONNECTED,
+	OFX_TCP_CLIENT_MESSAGE,
+	OFX_TCP_CLIENT_DISCONNECTED,
+};
+
+// what a reactor server received, see ofxTCPServer::receiveMessage
+struct ofxTCPMessage{
+	ofxTCPMessageType type = OFX_TCP_CLIENT_MESSAGE;
+	int clientID = -1;
+	std::string message;
+};
 
 class ofxTCPServer : public ofThread{
 
@@ -63,6 +79,11 @@ class ofxTCPServer : public ofThread{
 		bool sendRawBytes(int clientID, const char * rawBytes, const int numBytes);
 		bool sendRawBytesToAll(const char * rawBytes, const int numBytes);
 
+		//length prefixed messages, see ofxTCPClient::sendFrame
+		bool sendFrame(int clientID, const char * data, size_t size);
+		bool sendFrame(int clientID, const ofxTCPSendChunk * chunks, size_t numChunks);
+		bool sendFrameToAll(const char * data, size_t size);
+
 		//the received message length in bytes
 		int getNumReceivedBytes(int clientID);
 
@@ -87,14 +108,36 @@ class ofxTCPServer : public ofThread{
 		//amount of filled-bytes returned
 		int peekReceiveRawBytes(int clientID, char * receiveBytes,  int numBytes);
 
+		//receives a message sent with sendFrame, frame points into
+		//the client's buffer until the next call for the same client
+		bool receiveFrame(int clientID, ofxTCPFrame & frame);
+
 		void waitConnectedClient();
 		void waitConnectedClient(int ms);
 
+		//when set up with settings.reactor, clients are read by the server
+		//thread instead of with receive(clientID) and every message, split
+		//by the message delimiter, comes here together with clients
+		//connecting and disconnecting, in the order they happened.
+		//call it until it returns false, usually in update():
+		//
+		//	ofxTCPMessage msg;
+		//	while(server.receiveMessage(msg)){
+		//		if(msg.type == OFX_TCP_CLIENT_MESSAGE) ...
+		//	}
+		bool receiveMessage(ofxTCPMessage & message);
+		bool isReactor() const;
+
 	private:
 		ofxTCPClient & getClient(int clientID);
 		bool isClientSetup(int clientID);
 
 		void threadedFunction();
+		void threadedReactor();
+		void acceptClients();
+		void readClient(int clientID, bool closed);
+		void closeClient(int clientID);
+		void pushMessage(ofxTCPMessage && message);
 
 		ofxTCPManager			TCPServer;
 		std::map<int,std::shared_ptr<ofxTCPClient> >	TCPConnections;
@@ -105,6 +148,17 @@ class ofxTCPServer : public ofThread{
 		std::string			str;
 		int				idCount, port;
 		bool			bClientBlocking;
+		bool			bClientAsyncSend, bClientNoDelay;
+		size_t			clientMaxSendQueueSize;
 		std::string			messageDelimiter;
 
+		bool			bReactor;
+		std::unique_ptr<ofxTCPReactor> reactor;
+		ofThreadChannel<ofxTCPMessage, ofThreadChannelSPSC> messages;
+		ofThreadChannel<int, ofThreadChannelMPSC> disconnections;
+		// only used from the server thread
+		std::deque<ofxTCPMessage> pendingMessages;
+		std::map<int,std::string> partialMessages;
+		std::vector<char> readBuffer;
+
 };
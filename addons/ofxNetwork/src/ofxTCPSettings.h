@@ -14,6 +14,21 @@ public:
 	int port;
 	bool blocking = false;
 
+	// servers only: one thread waits for every client with epoll, kqueue or
+	// poll and received messages are read with ofxTCPServer::receiveMessage,
+	// there's no limit on the number of clients
+	bool reactor = false;
+
+	// sends are queued and written by a thread for each connection, the
+	// messages queued while it writes go out together in one system call.
+	// sends fail once maxSendQueueSize bytes are waiting, see
+	// ofxTCPClient::setAsyncSend. servers apply it to every client
+	bool asyncSend = false;
+	size_t maxSendQueueSize = 4 * 1024 * 1024;
+
+	// disables nagle's algorithm, small messages go out right away
+	bool noDelay = false;
+
 	std::string messageDelimiter = "[/TCP]";
 
 };
@@ -0,0 +1,430 @@
+#include "ofxUDPFrameStream.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+
+using namespace std;
+
+namespace{
+	// every datagram starts with:
+	//  0 magic 'o' 'f'
+	//  2 version
+	//  3 compression
+	//  4 frame number
+	//  8 frame size in bytes
+	// 12 chunk index
+	// 14 number of chunks
+	// 16 width
+	// 18 height
+	// 20 pixel format, bufferFormat for frames that aren't pixels
+	// 21 reserved
+	// 22 bytes in every chunk but the last
+	// all of them big endian
+	const size_t headerSize = 24;
+	const unsigned char version = 1;
+	const int bufferFormat = 255;
+
+	// IPv4 and UDP headers
+	const size_t ipUdpHeaderSize = 28;
+
+	// datagrams per system call
+	const size_t sendBatchSize = 64;
+
+	void put16(char * dst, uint32_t value){
+		dst[0] = char(value >> 8);
+		dst[1] = char(value);
+	}
+
+	void put32(char * dst, uint32_t value){
+		dst[0] = char(value >> 24);
+		dst[1] = char(value >> 16);
+		dst[2] = char(value >> 8);
+		dst[3] = char(value);
+	}
+
+	uint32_t get16(const char * src){
+		const unsigned char * u = (const unsigned char*)src;
+		return (uint32_t(u[0]) << 8) | uint32_t(u[1]);
+	}
+
+	uint32_t get32(const char * src){
+		const unsigned char * u = (const unsigned char*)src;
+		return (uint32_t(u[0]) << 24) | (uint32_t(u[1]) << 16) | (uint32_t(u[2]) << 8) | uint32_t(u[3]);
+	}
+}
+
+//--------------------------
+ofxUDPFrameSender::ofxUDPFrameSender()
+:payloadSize(OF_UDP_FRAME_MTU - ipUdpHeaderSize - headerSize)
+,frameNumber(0)
+,compression(OFX_UDP_FRAME_UNCOMPRESSED)
+,quality(OF_IMAGE_QUALITY_HIGH){
+}
+
+//--------------------------
+bool ofxUDPFrameSender::setup(const ofxUDPSettings & settings, size_t mtu){
+	if(mtu <= ipUdpHeaderSize + headerSize || mtu > OF_UDP_MAX_PACKET_SIZE - 1){
+		ofLogError("ofxUDPFrameSender") << "setup(): mtu " << mtu << " out of range";
+		return false;
+	}
+	close();
+	if(!udp.Setup(settings)){
+		ofLogError("ofxUDPFrameSender") << "setup(): couldn't setup the socket";
+		return false;
+	}
+	payloadSize = mtu - ipUdpHeaderSize - headerSize;
+	frameNumber = 0;
+	return true;
+}
+
+//--------------------------
+void ofxUDPFrameSender::close(){
+	if(udp.HasSocket()){
+		udp.Close();
+	}
+}
+
+//--------------------------
+void ofxUDPFrameSender::setCompression(ofxUDPFrameCompression compression, ofImageQualityType quality){
+	this->compression = compression;
+	this->quality = quality;
+}
+
+//--------------------------
+ofxUDPFrameCompression ofxUDPFrameSender::getCompression() const{
+	return compression;
+}
+
+//--------------------------
+bool ofxUDPFrameSender::send(const ofPixels & pixels){
+	if(!pixels.isAllocated()){
+		return false;
+	}
+	auto format = pixels.getPixelFormat();
+	if(compression == OFX_UDP_FRAME_JPEG && (format == OF_PIXELS_GRAY || format == OF_PIXELS_RGB)){
+		ofSaveImage(pixels, compressed, OF_IMAGE_FORMAT_JPEG, quality);
+		return sendFrame(compressed.getData(), compressed.size(), pixels.getWidth(), pixels.getHeight(), format, OFX_UDP_FRAME_JPEG);
+	}else{
+		return sendFrame((const char*)pixels.getData(), pixels.getTotalBytes(), pixels.getWidth(), pixels.getHeight(), format, OFX_UDP_FRAME_UNCOMPRESSED);
+	}
+}
+
+//--------------------------
+bool ofxUDPFrameSender::send(const ofBuffer & buffer){
+	return send(buffer.getData(), buffer.size());
+}
+
+//--------------------------
+bool ofxUDPFrameSender::send(const char * data, size_t size){
+	return sendFrame(data, size, 0, 0, bufferFormat, OFX_UDP_FRAME_UNCOMPRESSED);
+}
+
+//--------------------------
+uint32_t ofxUDPFrameSender::getFrameNumber() const{
+	return frameNumber;
+}
+
+//--------------------------
+bool ofxUDPFrameSender::sendFrame(const char * data, size_t size, int width, int height, int format, ofxUDPFrameCompression frameCompression){
+	if(!udp.HasSocket()){
+		ofLogError("ofxUDPFrameSender") << "send(): not setup";
+		return false;
+	}
+	size_t numChunks = max<size_t>(1, (size + payloadSize - 1) / payloadSize);
+	if(numChunks > 0xFFFF || width > 0xFFFF || height > 0xFFFF){
+		ofLogError("ofxUDPFrameSender") << "send(): frame of " << size << " bytes is too big for the mtu";
+		return false;
+	}
+
+	frameNumber++;
+	if(packets.size() < numChunks){
+		packets.resize(numChunks);
+	}
+	for(size_t i = 0; i < numChunks; i++){
+		auto & packet = packets[i];
+		if(packet.data.size() < headerSize + payloadSize){
+			packet.data.resize(headerSize + payloadSize);
+		}
+		size_t offset = i * payloadSize;
+		size_t chunkSize = min(payloadSize, size - offset);
+
+		char * header = packet.data.data();
+		header[0] = 'o';
+		header[1] = 'f';
+		header[2] = char(version);
+		header[3] = char(frameCompression);
+		put32(header + 4, frameNumber);
+		put32(header + 8, uint32_t(size));
+		put16(header + 12, uint32_t(i));
+		put16(header + 14, uint32_t(numChunks));
+		put16(header + 16, uint32_t(width));
+		put16(header + 18, uint32_t(height));
+		header[20] = char(format);
+		header[21] = 0;
+		put16(header + 22, uint32_t(payloadSize));
+		if(chunkSize > 0){
+			memcpy(header + headerSize, data + offset, chunkSize);
+		}
+		packet.size = headerSize + chunkSize;
+	}
+
+	for(size_t sent = 0; sent < numChunks;){
+		int batch = int(min(sendBatchSize, numChunks - sent));
+		int ret = udp.SendMany(packets.data() + sent, batch);
+		if(ret <= 0){
+			ofLogError("ofxUDPFrameSender") << "send(): couldn't send frame " << frameNumber << ", " << sent << " of " << numChunks << " datagrams sent";
+			return false;
+		}
+		sent += ret;
+	}
+	return true;
+}
+
+//--------------------------
+ofxUDPFrameReceiver::ofxUDPFrameReceiver()
+:frames(3)
+,frameNumber(0)
+,bHasFrame(false)
+,bFrameNew(false)
+,bShowIncomplete(false)
+,maxLatency(100000)
+,numDropped(0){
+}
+
+//--------------------------
+bool ofxUDPFrameReceiver::setup(const ofxUDPSettings & settings, size_t mtu){
+	if(mtu <= ipUdpHeaderSize + headerSize || mtu > OF_UDP_MAX_PACKET_SIZE - 1){
+		ofLogError("ofxUDPFrameReceiver") << "setup(): mtu " << mtu << " out of range";
+		return false;
+	}
+	close();
+	// a 1080p frame is around 4000 datagrams uncompressed, room for a couple
+	if(!receiver.setup(settings, mtu - ipUdpHeaderSize, 16384)){
+		ofLogError("ofxUDPFrameReceiver") << "setup(): couldn't setup the socket";
+		return false;
+	}
+	return true;
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::close(){
+	receiver.close();
+	for(auto & frame: frames){
+		frame.used = false;
+	}
+	bHasFrame = false;
+	bFrameNew = false;
+	numDropped = 0;
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::update(){
+	bFrameNew = false;
+	receiver.receiveAll(packets);
+	for(auto & packet: packets){
+		process(packet);
+	}
+
+	auto now = ofGetElapsedTimeMicros();
+	for(auto & frame: frames){
+		if(frame.used && now - frame.started > maxLatency){
+			drop(frame);
+		}
+	}
+}
+
+//--------------------------
+bool ofxUDPFrameReceiver::isNewer(uint32_t number) const{
+	// frame numbers wrap around
+	return !bHasFrame || int32_t(number - frameNumber) > 0;
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::process(const ofxUDPPacket & packet){
+	if(packet.size < headerSize){
+		return;
+	}
+	const char * header = packet.data.data();
+	if(header[0] != 'o' || header[1] != 'f' || (unsigned char)header[2] != version){
+		return;
+	}
+
+	uint32_t number = get32(header + 4);
+	if(!isNewer(number)){
+		// arrived after a newer frame was shown already
+		return;
+	}
+	size_t size = get32(header + 8);
+	size_t index = get16(header + 12);
+	size_t numChunks = get16(header + 14);
+	size_t chunkSize = get16(header + 22);
+	size_t offset = index * chunkSize;
+	if(index >= numChunks || chunkSize == 0 || size > numChunks * chunkSize || offset > size ||
+	   packet.size - headerSize != min(chunkSize, size - offset)){
+		ofLogVerbose("ofxUDPFrameReceiver") << "ignoring malformed datagram from " << packet.getAddress();
+		return;
+	}
+
+	// the frame this belongs to or, for a new one, a free slot or the oldest
+	Frame * frame = nullptr;
+	Frame * slot = nullptr;
+	for(auto & f: frames){
+		if(f.used && f.number == number){
+			frame = &f;
+			break;
+		}
+		if(!f.used){
+			if(!slot || slot->used) slot = &f;
+		}else if(!slot || (slot->used && int32_t(f.number - slot->number) < 0)){
+			slot = &f;
+		}
+	}
+	if(!frame){
+		if(slot->used){
+			if(int32_t(number - slot->number) < 0){
+				return;
+			}
+			drop(*slot);
+		}
+		frame = slot;
+		frame->used = true;
+		frame->number = number;
+		frame->compression = (unsigned char)header[3];
+		frame->format = (unsigned char)header[20];
+		frame->width = get16(header + 16);
+		frame->height = get16(header + 18);
+		frame->numChunks = numChunks;
+		frame->chunkSize = chunkSize;
+		frame->numReceived = 0;
+		frame->started = packet.timestamp;
+		frame->data.resize(size);
+		frame->chunks.assign(numChunks, false);
+	}else if(frame->data.size() != size || frame->numChunks != numChunks || frame->chunkSize != chunkSize){
+		return;
+	}
+
+	if(!frame->chunks[index]){
+		memcpy(frame->data.data() + offset, header + headerSize, packet.size - headerSize);
+		frame->chunks[index] = true;
+		frame->numReceived++;
+	}
+
+	if(frame->numReceived == frame->numChunks){
+		deliver(*frame);
+		// the older ones can't be shown anymore
+		for(auto & f: frames){
+			if(f.used && !isNewer(f.number)){
+				f.used = false;
+				numDropped++;
+			}
+		}
+	}
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::deliver(Frame & frame){
+	frame.used = false;
+	size_t size = frame.data.size();
+
+	if(frame.numReceived < frame.numChunks){
+		// fill the holes with the previous frame if it's the same size
+		const char * previous = nullptr;
+		if(frame.format == bufferFormat && buffer.size() == size){
+			previous = buffer.getData();
+		}else if(frame.format != bufferFormat && pixels.getTotalBytes() == size){
+			previous = (const char*)pixels.getData();
+		}
+		for(size_t i = 0; i < frame.numChunks; i++){
+			if(!frame.chunks[i]){
+				size_t offset = i * frame.chunkSize;
+				size_t chunkSize = min(frame.chunkSize, size - offset);
+				if(previous){
+					memcpy(frame.data.data() + offset, previous + offset, chunkSize);
+				}else{
+					memset(frame.data.data() + offset, 0, chunkSize);
+				}
+			}
+		}
+	}
+
+	if(frame.format == bufferFormat){
+		buffer.set(frame.data.data(), size);
+	}else if(frame.compression == OFX_UDP_FRAME_JPEG){
+		compressed.set(frame.data.data(), size);
+		if(!ofLoadImage(pixels, compressed)){
+			ofLogError("ofxUDPFrameReceiver") << "update(): couldn't decode frame " << frame.number;
+			numDropped++;
+			return;
+		}
+	}else{
+		auto format = ofPixelFormat(frame.format);
+		if(pixels.getWidth() != size_t(frame.width) || pixels.getHeight() != size_t(frame.height) || pixels.getPixelFormat() != format){
+			pixels.allocate(frame.width, frame.height, format);
+		}
+		if(pixels.getTotalBytes() != size){
+			ofLogError("ofxUDPFrameReceiver") << "update(): frame " << frame.number << " has " << size
+				<< " bytes, expected " << pixels.getTotalBytes() << " for " << frame.width << "x" << frame.height;
+			numDropped++;
+			return;
+		}
+		memcpy(pixels.getData(), frame.data.data(), size);
+	}
+
+	frameNumber = frame.number;
+	bHasFrame = true;
+	bFrameNew = true;
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::drop(Frame & frame){
+	if(bShowIncomplete && frame.compression == OFX_UDP_FRAME_UNCOMPRESSED && isNewer(frame.number)){
+		deliver(frame);
+	}else{
+		frame.used = false;
+		numDropped++;
+	}
+}
+
+//--------------------------
+bool ofxUDPFrameReceiver::isFrameNew() const{
+	return bFrameNew;
+}
+
+//--------------------------
+const ofPixels & ofxUDPFrameReceiver::getPixels() const{
+	return pixels;
+}
+
+//--------------------------
+ofPixels & ofxUDPFrameReceiver::getPixels(){
+	return pixels;
+}
+
+//--------------------------
+const ofBuffer & ofxUDPFrameReceiver::getBuffer() const{
+	return buffer;
+}
+
+//--------------------------
+uint32_t ofxUDPFrameReceiver::getFrameNumber() const{
+	return frameNumber;
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::setJitterBufferSize(size_t numFrames){
+	frames.resize(max<size_t>(1, numFrames));
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::setMaxLatency(uint64_t micros){
+	maxLatency = micros;
+}
+
+//--------------------------
+void ofxUDPFrameReceiver::setShowIncompleteFrames(bool showIncomplete){
+	bShowIncomplete = showIncomplete;
+}
+
+//--------------------------
+uint64_t ofxUDPFrameReceiver::getNumFramesDropped() const{
+	return numDropped;
+}
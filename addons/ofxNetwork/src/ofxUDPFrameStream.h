@@ -0,0 +1,157 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofImage.h"
+#include "ofFileUtils.h"
+#include "ofxUDPManager.h"
+#include "ofxUDPReceiver.h"
+
+/// Usual ethernet MTU
+#define OF_UDP_FRAME_MTU		1500
+/// Jumbo frames, every switch and network card in between needs them enabled
+#define OF_UDP_FRAME_JUMBO_MTU	9000
+
+enum ofxUDPFrameCompression{
+	OFX_UDP_FRAME_UNCOMPRESSED,
+	/// only for GRAY and RGB pixels, other formats are sent uncompressed
+	OFX_UDP_FRAME_JPEG,
+};
+
+/// \brief Sends ofPixels or ofBuffer frames over UDP, see ofxUDPFrameReceiver
+///
+/// Each frame is cut in datagrams that fit in the MTU, numbered so the
+/// receiver can put them together in any order. Send to a multicast group,
+/// with ofxUDPSettings::multicast, to reach every node of a video wall with
+/// a single stream.
+///
+/// ~~~~{.cpp}
+/// ofxUDPSettings settings;
+/// settings.sendTo("239.0.0.1", 11999);
+/// settings.multicast = true;
+/// sender.setup(settings);
+///
+/// sender.send(pixels);
+/// ~~~~
+class ofxUDPFrameSender{
+public:
+	ofxUDPFrameSender();
+
+	/// \param mtu biggest IP packet the network carries, the datagrams are
+	/// 28 bytes smaller to leave room for the IP and UDP headers
+	bool setup(const ofxUDPSettings & settings, std::size_t mtu = OF_UDP_FRAME_MTU);
+	void close();
+
+	void setCompression(ofxUDPFrameCompression compression, ofImageQualityType quality = OF_IMAGE_QUALITY_HIGH);
+	ofxUDPFrameCompression getCompression() const;
+
+	bool send(const ofPixels & pixels);
+	bool send(const ofBuffer & buffer);
+	bool send(const char * data, std::size_t size);
+
+	/// \brief Number of the last frame sent, starts at 0
+	uint32_t getFrameNumber() const;
+
+private:
+	bool sendFrame(const char * data, std::size_t size, int width, int height, int format, ofxUDPFrameCompression compression);
+
+	ofxUDPManager udp;
+	std::vector<ofxUDPPacket> packets;
+	ofBuffer compressed;
+	std::size_t payloadSize;
+	uint32_t frameNumber;
+	ofxUDPFrameCompression compression;
+	ofImageQualityType quality;
+};
+
+/// \brief Receives the frames sent by ofxUDPFrameSender
+///
+/// Datagrams are read in a background thread and put together in update().
+/// A few frames are assembled at the same time, so packets arriving out of
+/// order or late don't lose the frame, but a frame is dropped once a newer
+/// one is complete or it's been waiting for longer than the max latency.
+/// Uncompressed frames missing some datagrams can be shown anyway with the
+/// missing parts taken from the previous frame, see setShowIncompleteFrames().
+///
+/// ~~~~{.cpp}
+/// ofxUDPSettings settings;
+/// settings.receiveOn("239.0.0.1", 11999);
+/// settings.multicast = true;
+/// settings.receiveBufferSize = 8 * 1024 * 1024;
+/// receiver.setup(settings);
+///
+/// // in update()
+/// receiver.update();
+/// if(receiver.isFrameNew()){
+/// 	texture.loadData(receiver.getPixels());
+/// }
+/// ~~~~
+class ofxUDPFrameReceiver{
+public:
+	ofxUDPFrameReceiver();
+
+	/// \param mtu same as the sender's
+	bool setup(const ofxUDPSettings & settings, std::size_t mtu = OF_UDP_FRAME_MTU);
+	void close();
+
+	/// \brief Puts together every datagram received since the last call
+	void update();
+	bool isFrameNew() const;
+
+	/// \brief Last frame sent with ofxUDPFrameSender::send(pixels)
+	const ofPixels & getPixels() const;
+	ofPixels & getPixels();
+
+	/// \brief Last frame sent as raw data with ofxUDPFrameSender::send(buffer)
+	const ofBuffer & getBuffer() const;
+
+	/// \brief Number of the last frame received
+	uint32_t getFrameNumber() const;
+
+	/// \brief Frames assembled at the same time, 3 by default. More tolerate
+	/// more reordering, a new frame replaces the oldest one once they're full
+	void setJitterBufferSize(std::size_t numFrames);
+
+	/// \brief How long a frame can wait for its missing datagrams, 100ms by default
+	void setMaxLatency(uint64_t micros);
+
+	/// \brief Show uncompressed frames missing some datagrams once they
+	/// time out instead of dropping them, false by default
+	void setShowIncompleteFrames(bool showIncomplete);
+
+	/// \brief Frames that never completed or arrived after a newer one
+	uint64_t getNumFramesDropped() const;
+
+private:
+	struct Frame{
+		bool used = false;
+		uint32_t number = 0;
+		int compression = 0;
+		int format = 0;
+		int width = 0;
+		int height = 0;
+		std::size_t numChunks = 0;
+		std::size_t chunkSize = 0;
+		std::size_t numReceived = 0;
+		uint64_t started = 0;
+		std::vector<char> data;
+		std::vector<bool> chunks;
+	};
+
+	void process(const ofxUDPPacket & packet);
+	void deliver(Frame & frame);
+	void drop(Frame & frame);
+	bool isNewer(uint32_t number) const;
+
+	ofxUDPReceiver receiver;
+	std::vector<ofxUDPPacket> packets;
+	std::vector<Frame> frames;
+	ofPixels pixels;
+	ofBuffer buffer;
+	ofBuffer compressed;
+	uint32_t frameNumber;
+	bool bHasFrame;
+	bool bFrameNew;
+	bool bShowIncomplete;
+	uint64_t maxLatency;
+	uint64_t numDropped;
+};
@@ -425,6 +425,138 @@ int	ofxUDPManager::Receive(char* pBuff, const int iSize)
 	//	return(recvfrom(m_hSocket, pBuff, iSize, 0));
 }
 
+//--------------------------------------------------------------------------------
+///	Return values:
+///	SOCKET_TIMEOUT indicates timeout
+///	SOCKET_ERROR in	case of	a problem.
+int ofxUDPManager::ReceiveMany(ofxUDPPacket* pPackets, const int numPackets)
+{
+	if (m_hSocket == INVALID_SOCKET){
+		ofLogError("ofxUDPManager") << "INVALID_SOCKET";
+		return(SOCKET_ERROR);
+	}
+	if (numPackets <= 0) return 0;
+
+	if (m_dwTimeoutReceive	!= NO_TIMEOUT){
+		auto ret = WaitReceive(m_dwTimeoutReceive,0);
+		if(ret!=0){
+			return ret;
+		}
+	}
+
+	for (int i = 0; i < numPackets; i++){
+		if (pPackets[i].data.empty()){
+			pPackets[i].data.resize(OF_UDP_MAX_PACKET_SIZE);
+		}
+	}
+
+	int received = 0;
+#ifdef TARGET_LINUX
+	mmsgs.resize(numPackets);
+	iovecs.resize(numPackets);
+	memset(mmsgs.data(), 0, sizeof(mmsghdr) * numPackets);
+	for (int i = 0; i < numPackets; i++){
+		iovecs[i].iov_base = pPackets[i].data.data();
+		iovecs[i].iov_len = pPackets[i].data.size();
+		mmsgs[i].msg_hdr.msg_iov = &iovecs[i];
+		mmsgs[i].msg_hdr.msg_iovlen = 1;
+		mmsgs[i].msg_hdr.msg_name = &pPackets[i].address;
+		mmsgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+	}
+
+	// blocks, if the socket is blocking, only until the first one arrives
+	received = recvmmsg(m_hSocket, mmsgs.data(), numPackets, MSG_WAITFORONE, NULL);
+	if (received < 0){
+		int SocketError = ofxNetworkCheckError();
+		return SocketError == OFXNETWORK_ERROR(WOULDBLOCK) ? 0 : SOCKET_ERROR;
+	}
+	for (int i = 0; i < received; i++){
+		pPackets[i].size = mmsgs[i].msg_len;
+	}
+#else
+	for (; received < numPackets; received++){
+		// after the first one only take what's already queued
+		#ifdef TARGET_WIN32
+			if (received > 0){
+				unsigned long size = 0;
+				if (ioctlsocket(m_hSocket,FIONREAD,&size) != 0 || size == 0) break;
+			}
+			int	nLen= sizeof(sockaddr_in);
+			int flags = 0;
+		#else
+			socklen_t nLen= sizeof(sockaddr_in);
+			int flags = received > 0 ? MSG_DONTWAIT : 0;
+		#endif
+		auto & packet = pPackets[received];
+		int ret = recvfrom(m_hSocket, packet.data.data(), int(packet.data.size()), flags, (sockaddr *)&packet.address, &nLen);
+		if (ret < 0){
+			int SocketError = ofxNetworkCheckError();
+			if ( SocketError == OFXNETWORK_ERROR(WOULDBLOCK) || received > 0 ) break;
+			return SOCKET_ERROR;
+		}
+		packet.size = ret;
+	}
+#endif
+
+	auto now = ofGetElapsedTimeMicros();
+	for (int i = 0; i < received; i++){
+		pPackets[i].timestamp = now;
+	}
+	return received;
+}
+
+//--------------------------------------------------------------------------------
+///	Return values:
+///	SOCKET_TIMEOUT indicates timeout
+///	SOCKET_ERROR in	case of	a problem.
+int ofxUDPManager::SendMany(const ofxUDPPacket* pPackets, const int numPackets)
+{
+	if (m_hSocket == INVALID_SOCKET) return(SOCKET_ERROR);
+	if (numPackets <= 0) return 0;
+
+	if (m_dwTimeoutSend	!= NO_TIMEOUT){
+		auto ret = WaitSend(m_dwTimeoutSend,0);
+		if(ret!=0){
+			return ret;
+		}
+	}
+
+	int sent = 0;
+#ifdef TARGET_LINUX
+	mmsgs.resize(numPackets);
+	iovecs.resize(numPackets);
+	memset(mmsgs.data(), 0, sizeof(mmsghdr) * numPackets);
+	for (int i = 0; i < numPackets; i++){
+		iovecs[i].iov_base = (void*)pPackets[i].data.data();
+		iovecs[i].iov_len = pPackets[i].size;
+		mmsgs[i].msg_hdr.msg_iov = &iovecs[i];
+		mmsgs[i].msg_hdr.msg_iovlen = 1;
+		mmsgs[i].msg_hdr.msg_name = &saClient;
+		mmsgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+	}
+
+	// sendmmsg can stop early when the socket buffer is full
+	while (sent < numPackets){
+		int ret = sendmmsg(m_hSocket, mmsgs.data() + sent, numPackets - sent, 0);
+		if (ret <= 0){
+			ofxNetworkCheckError();
+			break;
+		}
+		sent += ret;
+	}
+#else
+	for (; sent < numPackets; sent++){
+		int ret = sendto(m_hSocket, pPackets[sent].data.data(), int(pPackets[sent].size), 0, (sockaddr *)&saClient, sizeof(sockaddr));
+		if (ret < 0){
+			ofxNetworkCheckError();
+			break;
+		}
+	}
+#endif
+
+	return sent > 0 ? sent : SOCKET_ERROR;
+}
+
 void ofxUDPManager::SetTimeoutSend(int	timeoutInSeconds)
 {
 	m_dwTimeoutSend= timeoutInSeconds;
@@ -640,3 +772,15 @@ int	iSize= sizeof(sockaddr);
 return(getsockname(m_hSocket, (sockaddr *)pInetAddr, &iSize) !=	SOCKET_ERROR);
 }
 */
+
+//--------------------------------------------------------------------------------
+string ofxUDPPacket::getAddress() const
+{
+	return inet_ntoa(address.sin_addr);
+}
+
+//--------------------------------------------------------------------------------
+int ofxUDPPacket::getPort() const
+{
+	return ntohs(address.sin_port);
+}
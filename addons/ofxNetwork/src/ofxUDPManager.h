@@ -67,6 +67,7 @@ x) Close()
 #include <string.h>
 #include <wchar.h>
 #include <stdio.h>
+#include <vector>
 
 #ifndef TARGET_WIN32
 
@@ -83,6 +84,7 @@ x) Close()
 	#include <sys/socket.h>
 	#include <sys/time.h>
 	#include <sys/ioctl.h>
+	#include <sys/uio.h>
 
     //#ifdef TARGET_LINUX
         // linux needs this:
@@ -103,6 +105,24 @@ x) Close()
 
 /// Socket constants.
 #define SOCKET_TIMEOUT			SOCKET_ERROR - 1
+#define OF_UDP_MAX_PACKET_SIZE	65536
+
+//--------------------------------------------------------------------------------
+/// A datagram received with ofxUDPManager::ReceiveMany or sent with SendMany
+struct ofxUDPPacket{
+	/// allocated once and reused, ReceiveMany makes it OF_UDP_MAX_PACKET_SIZE
+	/// if it's empty and never receives more than data.size() bytes
+	std::vector<char> data;
+	/// bytes of data used by the datagram
+	size_t size = 0;
+	/// who sent it
+	sockaddr_in address = {};
+	/// ofGetElapsedTimeMicros() when it was received
+	uint64_t timestamp = 0;
+
+	std::string getAddress() const;
+	int getPort() const;
+};
 
 //--------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------
@@ -134,6 +154,19 @@ public:
 	int  SendAll(const char* pBuff, const int iSize);
 	int  PeekReceive();			//	return number of bytes waiting
 	int  Receive(char* pBuff, const int iSize);
+
+	//	receives up to numPackets datagrams with a single system call where
+	//	possible (recvmmsg on linux). waits for the first one like Receive
+	//	and then takes whatever else is already queued.
+	//	returns the number of packets received, 0 if there was nothing to read
+	//	on a non-blocking socket, SOCKET_TIMEOUT or SOCKET_ERROR
+	int  ReceiveMany(ofxUDPPacket* pPackets, const int numPackets);
+
+	//	sends numPackets datagrams to the connected address, with a single
+	//	system call where possible (sendmmsg on linux).
+	//	returns the number of packets sent, SOCKET_TIMEOUT or SOCKET_ERROR if
+	//	none could be sent
+	int  SendMany(const ofxUDPPacket* pPackets, const int numPackets);
 	void SetTimeoutSend(int timeoutInSeconds);
 	void SetTimeoutReceive(int timeoutInSeconds);
 	int  GetTimeoutSend();
@@ -173,4 +206,9 @@ protected:
 	static bool m_bWinsockInit;
 	bool canGetRemoteAddress;
 
+#ifdef TARGET_LINUX
+	// reused by ReceiveMany and SendMany so batches don't allocate
+	std::vector<struct mmsghdr> mmsgs;
+	std::vector<struct iovec> iovecs;
+#endif
 };
@@ -0,0 +1,126 @@
+#include "ofxUDPReceiver.h"
+#include "ofLog.h"
+
+using namespace std;
+
+namespace{
+	// most packets read with a single system call
+	const int batchSize = 64;
+}
+
+//--------------------------
+ofxUDPReceiver::ofxUDPReceiver()
+:maxPacketSize(OF_UDP_MAX_PACKET_SIZE)
+,numDropped(0){
+}
+
+//--------------------------
+ofxUDPReceiver::~ofxUDPReceiver(){
+	close();
+}
+
+//--------------------------
+bool ofxUDPReceiver::setup(const ofxUDPSettings & settings, size_t maxPacketSize, size_t queueSize){
+	close();
+
+	// the thread needs to wake up every now and then to know if it has to stop
+	ofxUDPSettings threadSettings = settings;
+	threadSettings.blocking = true;
+	if(threadSettings.receiveTimeout == NO_TIMEOUT || threadSettings.receiveTimeout > 1){
+		threadSettings.receiveTimeout = 1;
+	}
+	if(!udp.Setup(threadSettings)){
+		ofLogError("ofxUDPReceiver") << "setup(): couldn't setup the socket";
+		return false;
+	}
+
+	this->maxPacketSize = maxPacketSize;
+	numDropped = 0;
+	received.reset(new ofThreadChannel<ofxUDPPacket, ofThreadChannelSPSC>(queueSize));
+	freePackets.reset(new ofThreadChannel<ofxUDPPacket, ofThreadChannelSPSC>(queueSize));
+	startThread();
+	return true;
+}
+
+//--------------------------
+void ofxUDPReceiver::close(){
+	if(isThreadRunning()){
+		stopThread();
+		waitForThread(false);
+	}
+	if(udp.HasSocket()){
+		udp.Close();
+	}
+	received.reset();
+	freePackets.reset();
+}
+
+//--------------------------
+bool ofxUDPReceiver::receive(ofxUDPPacket & packet){
+	if(!received){
+		return false;
+	}
+	ofxUDPPacket next;
+	if(!received->tryReceive(next)){
+		return false;
+	}
+	swap(packet, next);
+	recycle(std::move(next));
+	return true;
+}
+
+//--------------------------
+size_t ofxUDPReceiver::receiveAll(vector<ofxUDPPacket> & packets){
+	size_t numPackets = 0;
+	if(received){
+		ofxUDPPacket next;
+		while(received->tryReceive(next)){
+			if(numPackets < packets.size()){
+				swap(packets[numPackets], next);
+				recycle(std::move(next));
+			}else{
+				packets.push_back(std::move(next));
+			}
+			numPackets++;
+		}
+	}
+	for(size_t i = numPackets; i < packets.size(); i++){
+		recycle(std::move(packets[i]));
+	}
+	packets.resize(numPackets);
+	return numPackets;
+}
+
+//--------------------------
+uint64_t ofxUDPReceiver::getNumDropped() const{
+	return numDropped;
+}
+
+//--------------------------
+void ofxUDPReceiver::recycle(ofxUDPPacket && packet){
+	// packets that didn't come from here might not be big enough
+	if(freePackets && packet.data.size() == maxPacketSize){
+		freePackets->send(std::move(packet));
+	}
+}
+
+//--------------------------
+void ofxUDPReceiver::threadedFunction(){
+	vector<ofxUDPPacket> batch(batchSize);
+	while(isThreadRunning()){
+		// give a buffer to the packets that were handed over last time
+		for(auto & packet: batch){
+			if(packet.data.empty() && !freePackets->tryReceive(packet)){
+				packet.data.resize(maxPacketSize);
+			}
+		}
+
+		int numPackets = udp.ReceiveMany(batch.data(), batchSize);
+		for(int i = 0; i < numPackets; i++){
+			// send only moves on success, a dropped packet keeps its buffer
+			if(!received->send(std::move(batch[i]))){
+				numDropped++;
+			}
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofThread.h"
+#include "ofThreadChannel.h"
+#include "ofxUDPManager.h"
+#include <atomic>
+#include <memory>
+
+/// \brief Receives UDP packets in a background thread
+///
+/// The thread reads everything queued in the socket at once with
+/// ofxUDPManager::ReceiveMany and hands the packets over through a lock
+/// free queue, so the main loop takes all the packets that arrived since
+/// the last frame with a single receiveAll() and no system calls. Packet
+/// buffers go back to the thread once they are replaced, a steady stream
+/// doesn't allocate.
+///
+/// ~~~~{.cpp}
+/// ofxUDPSettings settings;
+/// settings.receiveOn(6454);
+/// receiver.setup(settings);
+///
+/// // in update()
+/// receiver.receiveAll(packets);
+/// for(auto & packet: packets){
+/// 	parse(packet.data.data(), packet.size);
+/// }
+/// ~~~~
+class ofxUDPReceiver: public ofThread{
+public:
+	ofxUDPReceiver();
+	~ofxUDPReceiver();
+
+	/// \brief Binds like ofxUDPManager::Setup and starts receiving
+	///
+	/// The socket is always blocking with a receive timeout of at most a
+	/// second, which is how long close() can take.
+	/// \param maxPacketSize datagrams bigger than this are truncated
+	/// \param queueSize packets waiting for the main thread, new ones are
+	/// dropped once it's full
+	bool setup(const ofxUDPSettings & settings, std::size_t maxPacketSize = OF_UDP_MAX_PACKET_SIZE, std::size_t queueSize = 4096);
+	void close();
+
+	/// \brief Takes the oldest packet received, false if there's none
+	///
+	/// The buffer packet had is reused for future packets.
+	bool receive(ofxUDPPacket & packet);
+
+	/// \brief Replaces the contents of packets with every packet received
+	/// since the last call, oldest first
+	///
+	/// The buffers packets had are reused for future packets, so passing the
+	/// same vector every frame does no allocations.
+	/// \returns the number of packets, same as packets.size()
+	std::size_t receiveAll(std::vector<ofxUDPPacket> & packets);
+
+	/// \brief Packets lost because the main thread didn't take them in time
+	uint64_t getNumDropped() const;
+
+private:
+	void threadedFunction();
+	void recycle(ofxUDPPacket && packet);
+
+	ofxUDPManager udp;
+	std::unique_ptr<ofThreadChannel<ofxUDPPacket, ofThreadChannelSPSC>> received;
+	std::unique_ptr<ofThreadChannel<ofxUDPPacket, ofThreadChannelSPSC>> freePackets;
+	std::size_t maxPacketSize;
+	std::atomic<uint64_t> numDropped;
+};
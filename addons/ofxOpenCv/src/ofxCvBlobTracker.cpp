@@ -0,0 +1,175 @@
+#include "ofxCvBlobTracker.h"
+#include "ofxCvContourFinder.h"
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvBlobTracker::ofxCvBlobTracker() {
+    maxDistance = 50;
+    persistence = 0;
+    velocitySmoothing = 0.5;
+    reset();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::setMaxDistance( float distance ) {
+    if( distance <= 0 ) {
+        ofLogError("ofxCvBlobTracker") << "setMaxDistance(): distance has to be bigger than 0";
+        return;
+    }
+    maxDistance = distance;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::setPersistence( int frames ) {
+    persistence = MAX(frames, 0);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::setVelocitySmoothing( float smoothing ) {
+    velocitySmoothing = ofClamp(smoothing, 0, 1);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::reset() {
+    blobs.clear();
+    lost.clear();
+    newIds.clear();
+    deadIds.clear();
+    nextId = 0;
+}
+
+//--------------------------------------------------------------------------------
+ofPoint ofxCvBlobTracker::predict( const ofxCvTrackedBlob& blob ) const {
+    return blob.centroid + blob.velocity * (blob.framesMissing + 1);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::cellOf( const ofPoint& p, int& x, int& y ) const {
+    x = (int)floor(p.x / maxDistance);
+    y = (int)floor(p.y / maxDistance);
+}
+
+//--------------------------------------------------------------------------------
+int64_t ofxCvBlobTracker::cellKey( int x, int y ) const {
+    return (int64_t(x) << 32) | uint32_t(y);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::track( const ofxCvContourFinder& finder ) {
+    track( finder.blobs );
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::track( const vector<ofxCvBlob>& found ) {
+    newIds.clear();
+    deadIds.clear();
+
+    // the candidates are the blobs of the last frame and the lost ones
+    previous.swap( blobs );
+    for( size_t i = 0; i < lost.size(); i++ ) {
+        previous.push_back( std::move(lost[i]) );
+    }
+    lost.clear();
+
+    // anything closer than maxDistance to a predicted position is in the
+    // same cell or in one of the 8 around it
+    cells.clear();
+    for( size_t i = 0; i < previous.size(); i++ ) {
+        int x, y;
+        cellOf( predict(previous[i]), x, y );
+        cells.push_back( std::make_pair(cellKey(x, y), i) );
+    }
+    sort( cells.begin(), cells.end() );
+
+    matches.clear();
+    for( size_t j = 0; j < found.size(); j++ ) {
+        int cx, cy;
+        cellOf( found[j].centroid, cx, cy );
+        for( int y = cy - 1; y <= cy + 1; y++ ) {
+            for( int x = cx - 1; x <= cx + 1; x++ ) {
+                auto range = equal_range( cells.begin(), cells.end(), std::make_pair(cellKey(x, y), size_t(0)),
+                    [](const std::pair<int64_t,size_t>& a, const std::pair<int64_t,size_t>& b){ return a.first < b.first; } );
+                for( auto it = range.first; it != range.second; ++it ) {
+                    float distance = predict(previous[it->second]).distance( found[j].centroid );
+                    if( distance <= maxDistance ) {
+                        matches.push_back( Match{distance, it->second, j} );
+                    }
+                }
+            }
+        }
+    }
+
+    // closest pairs first, each blob is used once
+    sort( matches.begin(), matches.end() );
+    previousMatched.assign( previous.size(), false );
+    foundMatched.assign( found.size(), false );
+    blobs.resize( found.size() );
+    for( size_t i = 0; i < matches.size(); i++ ) {
+        const Match& match = matches[i];
+        if( previousMatched[match.previous] || foundMatched[match.found] ) {
+            continue;
+        }
+        previousMatched[match.previous] = true;
+        foundMatched[match.found] = true;
+
+        ofxCvTrackedBlob& blob = blobs[match.found];
+        blob = std::move( previous[match.previous] );
+        const ofxCvBlob& next = found[match.found];
+        ofPoint delta = (next.centroid - blob.centroid) / (blob.framesMissing + 1);
+        blob.velocity = blob.velocity * velocitySmoothing + delta * (1 - velocitySmoothing);
+        blob.bChanged = blob.area != next.area || blob.nPts != next.nPts
+            || blob.centroid != next.centroid || blob.boundingRect != next.boundingRect;
+        if( blob.bChanged ) {
+            // reuses the memory of the contour
+            static_cast<ofxCvBlob&>(blob) = next;
+        }
+        blob.age++;
+        blob.framesMissing = 0;
+    }
+
+    for( size_t j = 0; j < found.size(); j++ ) {
+        if( !foundMatched[j] ) {
+            ofxCvTrackedBlob& blob = blobs[j];
+            static_cast<ofxCvBlob&>(blob) = found[j];
+            blob.id = nextId++;
+            blob.velocity.set( 0, 0, 0 );
+            blob.age = 0;
+            blob.framesMissing = 0;
+            blob.bChanged = true;
+            newIds.push_back( blob.id );
+        }
+    }
+
+    for( size_t i = 0; i < previous.size(); i++ ) {
+        if( !previousMatched[i] ) {
+            previous[i].framesMissing++;
+            if( previous[i].framesMissing > persistence ) {
+                deadIds.push_back( previous[i].id );
+            } else {
+                lost.push_back( std::move(previous[i]) );
+            }
+        }
+    }
+    previous.clear();
+}
+
+//--------------------------------------------------------------------------------
+const ofxCvTrackedBlob* ofxCvBlobTracker::getBlob( int id ) const {
+    for( size_t i = 0; i < blobs.size(); i++ ) {
+        if( blobs[i].id == id ) {
+            return &blobs[i];
+        }
+    }
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------
+const vector<int>& ofxCvBlobTracker::getNewIds() const {
+    return newIds;
+}
+
+//--------------------------------------------------------------------------------
+const vector<int>& ofxCvBlobTracker::getDeadIds() const {
+    return deadIds;
+}
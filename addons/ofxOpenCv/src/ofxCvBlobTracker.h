@@ -0,0 +1,97 @@
+/*
+* ofxCvBlobTracker.h
+*
+* Gives the blobs found each frame by ofxCvContourFinder (or any other
+* finder) an id that persists between frames, and estimates their
+* velocity. Blobs are matched to the position predicted from their
+* velocity, looking only at the blobs in the neighbouring cells of a
+* spatial hash so it scales to hundreds of blobs a frame.
+*
+*/
+
+#pragma once
+
+#include "ofxCvConstants.h"
+#include "ofxCvBlob.h"
+
+class ofxCvContourFinder;
+
+class ofxCvTrackedBlob : public ofxCvBlob {
+
+    public:
+
+        int                 id;
+        ofPoint             velocity;       // pixels per frame
+        int                 age;            // frames since it was first found
+        int                 framesMissing;  // frames it wasn't found, only while lost
+        bool                bChanged;       // false if identical to the last frame, its contour wasn't copied again
+
+        //----------------------------------------
+        ofxCvTrackedBlob() {
+            id              = -1;
+            age             = 0;
+            framesMissing   = 0;
+            bChanged        = true;
+        }
+};
+
+
+class ofxCvBlobTracker {
+
+  public:
+
+    vector<ofxCvTrackedBlob>  blobs;  // in the same order as the blobs passed to track()
+
+
+    ofxCvBlobTracker();
+
+    // the furthest a blob can move from its predicted position between
+    // two frames and still be the same blob, also the size of the cells
+    // of the spatial hash
+    void  setMaxDistance( float distance );
+    // frames a blob that isn't found is kept around, moving with its
+    // velocity, before its id is dropped
+    void  setPersistence( int frames );
+    // from 0 to 1, how much of the previous velocity is kept each frame
+    void  setVelocitySmoothing( float smoothing );
+
+    void  track( const vector<ofxCvBlob>& found );
+    void  track( const ofxCvContourFinder& finder );
+    void  reset();
+
+    // the blob with that id found in the last frame, nullptr if there's none
+    const ofxCvTrackedBlob*  getBlob( int id ) const;
+    // ids that appeared and ids that were dropped in the last frame
+    const vector<int>&  getNewIds() const;
+    const vector<int>&  getDeadIds() const;
+
+
+  protected:
+
+    ofPoint  predict( const ofxCvTrackedBlob& blob ) const;
+    int64_t  cellKey( int x, int y ) const;
+    void     cellOf( const ofPoint& p, int& x, int& y ) const;
+
+    struct Match {
+        float   distance;
+        size_t  previous;
+        size_t  found;
+        bool operator<( const Match& other ) const { return distance < other.distance; }
+    };
+
+    float  maxDistance;
+    int    persistence;
+    float  velocitySmoothing;
+    int    nextId;
+
+    // kept between frames so their memory is reused
+    vector<ofxCvTrackedBlob>  lost;
+    vector<ofxCvTrackedBlob>  previous;
+    vector<std::pair<int64_t,size_t> >  cells;  // cell of each previous blob, sorted
+    vector<Match>  matches;
+    vector<bool>   previousMatched;
+    vector<bool>   foundMatched;
+    vector<int>    newIds;
+    vector<int>    deadIds;
+
+};
@@ -79,8 +79,7 @@ void ofxCvColorImage::operator -= ( float value ) {
         ofLogError("ofxCvColorImage") << "set(): image not allocated";
 		return;		
     }
-	cvSubS( cvImage, cvScalar(value, value, value), cvImageTemp );
-	swapTemp();
+	cvSubS( cvImage, cvScalar(value, value, value), cvImage );
     flagImageChanged();
 }
 
@@ -90,8 +89,7 @@ void ofxCvColorImage::operator += ( float value ) {
         ofLogError("ofxCvColorImage") << "set(): image not allocated";
 		return;		
     }
-	cvAddS( cvImage, cvScalar(value, value, value), cvImageTemp );
-	swapTemp();
+	cvAddS( cvImage, cvScalar(value, value, value), cvImage );
     flagImageChanged();
 }
 
@@ -4,13 +4,10 @@
 
 
 //--------------------------------------------------------------------------------
-static bool sort_carea_compare( const CvSeq* a, const CvSeq* b) {
+static bool sort_carea_compare( const std::pair<double,size_t>& a, const std::pair<double,size_t>& b) {
 	
-	// use opencv to calc size, then sort based on size
-	float areaa = cvContourArea(a, CV_WHOLE_SEQ);
-	float areab = cvContourArea(b, CV_WHOLE_SEQ);
-	
-	return (areaa > areab);
+	// sort based on the size, the areas are oriented when finding holes
+	return (fabs(a.first) > fabs(b.first));
 }
 
 
@@ -20,18 +17,16 @@ static bool sort_carea_compare( const CvSeq* a, const CvSeq* b) {
 ofxCvContourFinder::ofxCvContourFinder() {
     _width = 0;
     _height = 0;
-	myMoments = (CvMoments*)malloc( sizeof(CvMoments) );
 	reset();
 }
 
 //--------------------------------------------------------------------------------
 ofxCvContourFinder::~ofxCvContourFinder() {
-	free( myMoments );
 }
 
 //--------------------------------------------------------------------------------
 void ofxCvContourFinder::reset() {
-    cvSeqBlobs.clear();
+    candidates.clear();
     blobs.clear();
     nBlobs = 0;
 }
@@ -73,51 +68,80 @@ int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
     inputCopy.setROI( input.getROI() );
     inputCopy = input;
 
-	CvSeq* contour_list = NULL;
-	contour_storage = cvCreateMemStorage( 1000 );
-	storage	= cvCreateMemStorage( 1000 );
+	// a header over the memory of the copy, takes its ROI into account
+	cv::Mat image = cv::cvarrToMat( inputCopy.getCvImage() );
+	return findContoursInCopy( image, minArea, maxArea, nConsidered, bFindHoles, bUseApproximation );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvContourFinder::findContours( const ofxCvMat&  input,
+									  int minArea,
+									  int maxArea,
+									  int nConsidered,
+									  bool bFindHoles,
+                                      bool bUseApproximation) {
+
+	reset();
+	if( !input.isAllocated() || input.getNumChannels() != 1 ) {
+		ofLogError("ofxCvContourFinder") << "findContours(): input needs to be an allocated single channel image";
+		_width = 0;
+		_height = 0;
+		return 0;
+	}
+    _width = input.getWidth();
+    _height = input.getHeight();
+
+	// copyTo only reallocates matCopy when the size changes
+	input.getMat().copyTo( matCopy );
+	return findContoursInCopy( matCopy, minArea, maxArea, nConsidered, bFindHoles, bUseApproximation );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvContourFinder::findContoursInCopy( cv::Mat& image,
+									  int minArea,
+									  int maxArea,
+									  int nConsidered,
+									  bool bFindHoles,
+                                      bool bUseApproximation) {
 
 	int retrieve_mode
         = (bFindHoles) ? CV_RETR_LIST : CV_RETR_EXTERNAL;
-	cvFindContours( inputCopy.getCvImage(), contour_storage, &contour_list,
-                    sizeof(CvContour), retrieve_mode, bUseApproximation ? CV_CHAIN_APPROX_SIMPLE : CV_CHAIN_APPROX_NONE );
-	CvSeq* contour_ptr = contour_list;
-
-	// put the contours from the linked list, into an array for sorting
-	while( (contour_ptr != NULL) ) {
-		float area = cvContourArea(contour_ptr, CV_WHOLE_SEQ, bFindHoles); // oriented=true for holes
-		if(bFindHoles && area < 0) { // areas can be non negative in the case of holes
-			area = fabs(area);
+	cv::findContours( image, contours, retrieve_mode,
+                      bUseApproximation ? CV_CHAIN_APPROX_SIMPLE : CV_CHAIN_APPROX_NONE );
+
+	// put the contours that are big enough into an array for sorting
+	for( size_t i = 0; i < contours.size(); i++ ) {
+		double area = cv::contourArea( contours[i], bFindHoles ); // oriented=true for holes
+		if((fabs(area) > minArea) && (fabs(area) < maxArea)) {
+			candidates.push_back( std::make_pair(area, i) );
 		}
-		if((area > minArea) && (area < maxArea)) {
-			cvSeqBlobs.push_back(contour_ptr);
-		}
-		contour_ptr = contour_ptr->h_next;
 	}
 
 
-	// sort the pointers based on size
-	if( cvSeqBlobs.size() > 1 ) {
-        sort( cvSeqBlobs.begin(), cvSeqBlobs.end(), sort_carea_compare );
+	// sort the contours based on size
+	if( candidates.size() > 1 ) {
+        sort( candidates.begin(), candidates.end(), sort_carea_compare );
 	}
 
 
-	// now, we have cvSeqBlobs.size() contours, sorted by size in the array
-    // cvSeqBlobs let's get the data out and into our structures that we like
-	for( int i = 0; i < MIN(nConsidered, (int)cvSeqBlobs.size()); i++ ) {
-		blobs.push_back( ofxCvBlob() );
-		float area = cvContourArea( cvSeqBlobs[i], CV_WHOLE_SEQ, bFindHoles ); // oriented=true for holes
-		CvRect rect	= cvBoundingRect( cvSeqBlobs[i], 0 );
-		cvMoments( cvSeqBlobs[i], myMoments );
+	// now, we have candidates.size() contours, sorted by size, let's get
+    // the data out and into our structures that we like
+	int n = MIN(nConsidered, (int)candidates.size());
+	blobs.resize( n );
+	for( int i = 0; i < n; i++ ) {
+		const vector<cv::Point>& contour = contours[candidates[i].second];
+		float area = candidates[i].first;
+		cv::Rect rect = cv::boundingRect( contour );
+		cv::Moments moments = cv::moments( contour );
 
 		blobs[i].area                     = bFindHoles ? fabs(area) : area; // only return positive areas
-		blobs[i].length 			      = cvArcLength(cvSeqBlobs[i]);
+		blobs[i].length 			      = cv::arcLength( contour, true );
 		blobs[i].boundingRect.x           = rect.x;
 		blobs[i].boundingRect.y           = rect.y;
 		blobs[i].boundingRect.width       = rect.width;
 		blobs[i].boundingRect.height      = rect.height;
-		blobs[i].centroid.x 			  = (myMoments->m10 / myMoments->m00);
-		blobs[i].centroid.y 			  = (myMoments->m01 / myMoments->m00);
+		blobs[i].centroid.x 			  = (moments.m10 / moments.m00);
+		blobs[i].centroid.y 			  = (moments.m01 / moments.m00);
 
 		if(bFindHoles) {
 			// for some reason, changing the orientation when looking for holes
@@ -131,13 +155,9 @@ int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
 		}
 
 		// get the points for the blob:
-		CvPoint           pt;
-		CvSeqReader       reader;
-		cvStartReadSeq( cvSeqBlobs[i], &reader, 0 );
-
-    	for( int j=0; j < cvSeqBlobs[i]->total; j++ ) {
-			CV_READ_SEQ_ELEM( pt, reader );
-            blobs[i].pts.push_back( ofPoint((float)pt.x, (float)pt.y) );
+		blobs[i].pts.resize( contour.size() );
+    	for( size_t j=0; j < contour.size(); j++ ) {
+            blobs[i].pts[j].set( (float)contour[j].x, (float)contour[j].y );
 		}
 		blobs[i].nPts = blobs[i].pts.size();
 
@@ -145,11 +165,6 @@ int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
 
     nBlobs = blobs.size();
 
-	// Free the storage memory.
-	// Warning: do this inside this function otherwise a strange memory leak
-	if( contour_storage != NULL ) { cvReleaseMemStorage(&contour_storage); }
-	if( storage != NULL ) { cvReleaseMemStorage(&storage); }
-
 	return nBlobs;
 
 }
@@ -13,6 +13,7 @@
 #include "ofxCvConstants.h"
 #include "ofxCvBlob.h"
 #include "ofxCvGrayscaleImage.h"
+#include "ofxCvMat.h"
 #include <algorithm>
 
 class ofxCvContourFinder : public ofBaseDraws {
@@ -37,6 +38,13 @@ class ofxCvContourFinder : public ofBaseDraws {
                                // of the contour, if the contour runs
                                // along a straight line, for example...
 
+    // same for a single channel ofxCvMat, downloads it first if it's
+    // using OpenCL since cv::findContours only runs on the cpu
+    virtual int  findContours( const ofxCvMat& input,
+                               int minArea, int maxArea,
+                               int nConsidered, bool bFindHoles,
+                               bool bUseApproximation = true);
+
     virtual void  draw() const { draw(0,0, _width, _height); };
     virtual void  draw( float x, float y ) const { draw(x,y, _width, _height); };
     virtual void  draw( float x, float y, float w, float h ) const;
@@ -54,14 +62,19 @@ class ofxCvContourFinder : public ofBaseDraws {
     int  _width;
     int  _height;
     ofxCvGrayscaleImage     inputCopy;
-    CvMemStorage*           contour_storage;
-    CvMemStorage*           storage;
-    CvMoments*              myMoments;
-    vector<CvSeq*>          cvSeqBlobs;  //these will become blobs
+    cv::Mat                 matCopy;
+    // kept between calls so their memory is reused
+    vector<vector<cv::Point> >        contours;
+    vector<std::pair<double,size_t> > candidates;  //oriented area and index of the contours that will become blobs
     
     ofPoint  anchor;
     bool  bAnchorIsPct;      
 
     virtual void reset();
+    // finds the contours in image, which gets clobbered
+    int findContoursInCopy( cv::Mat& image,
+                            int minArea, int maxArea,
+                            int nConsidered, bool bFindHoles,
+                            bool bUseApproximation );
 
 };
@@ -0,0 +1,666 @@
+#include "ofxCvGpuBlobFinder.h"
+
+namespace{
+#ifdef TARGET_OPENGLES
+    const string header = "#version 300 es\nprecision highp float;\nprecision highp int;\nprecision highp sampler2D;\n";
+#else
+    const string header = "#version 150\n";
+#endif
+
+    const string passVertex = R"(
+uniform mat4 modelViewProjectionMatrix;
+in vec4 position;
+void main(){
+    gl_Position = modelViewProjectionMatrix * position;
+}
+)";
+
+    const string lumaFunction = R"(
+float luma(ivec2 p){
+    return dot(texelFetch(frame, p, 0).rgb, vec3(0.299, 0.587, 0.114));
+}
+)";
+
+    const string backgroundFragment = R"(
+uniform sampler2D frame;
+uniform sampler2D background;
+uniform float rate;
+out vec4 fragColor;
+)" + lumaFunction + R"(
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    // the background isn't read when learning, it might not be initialized
+    float l = luma(p);
+    fragColor = vec4(rate >= 1.0 ? l : mix(texelFetch(background, p, 0).r, l, rate));
+}
+)";
+
+    const string differenceFragment = R"(
+uniform sampler2D frame;
+uniform sampler2D background;
+out vec4 fragColor;
+)" + lumaFunction + R"(
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    fragColor = vec4(abs(luma(p) - texelFetch(background, p, 0).r));
+}
+)";
+
+    const string blurFragment = R"(
+uniform sampler2D src;
+uniform ivec2 size;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    float sum = 0.0;
+    for(int y = -1; y <= 1; y++){
+        for(int x = -1; x <= 1; x++){
+            sum += texelFetch(src, clamp(p + ivec2(x, y), ivec2(0), size - 1), 0).r;
+        }
+    }
+    fragColor = vec4(sum / 9.0);
+}
+)";
+
+    const string thresholdFragment = R"(
+uniform sampler2D src;
+uniform float threshold;
+out vec4 fragColor;
+void main(){
+    fragColor = vec4(texelFetch(src, ivec2(gl_FragCoord.xy), 0).r > threshold ? 1.0 : 0.0);
+}
+)";
+
+    const string morphologyFragment = R"(
+uniform sampler2D src;
+uniform ivec2 size;
+uniform int dilate;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    float value = texelFetch(src, p, 0).r;
+    for(int y = -1; y <= 1; y++){
+        for(int x = -1; x <= 1; x++){
+            float n = texelFetch(src, clamp(p + ivec2(x, y), ivec2(0), size - 1), 0).r;
+            value = dilate == 1 ? max(value, n) : min(value, n);
+        }
+    }
+    fragColor = vec4(value);
+}
+)";
+
+    // every label is the coordinate of a pixel of its blob, the one with
+    // the biggest index once labeling is done, -1 for the background
+    const string labelInitFragment = R"(
+uniform sampler2D src;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    fragColor = texelFetch(src, p, 0).r > 0.5 ? vec4(vec2(p), 0.0, 1.0) : vec4(-1.0);
+}
+)";
+
+    const string labelFragment = R"(
+uniform sampler2D src;
+uniform ivec2 size;
+out vec4 fragColor;
+float index(vec2 label){
+    return label.y * float(size.x) + label.x;
+}
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    vec2 label = texelFetch(src, p, 0).xy;
+    if(label.x < 0.0){
+        fragColor = vec4(-1.0);
+        return;
+    }
+    for(int y = -1; y <= 1; y++){
+        for(int x = -1; x <= 1; x++){
+            vec2 n = texelFetch(src, clamp(p + ivec2(x, y), ivec2(0), size - 1), 0).xy;
+            if(n.x >= 0.0 && index(n) > index(label)){
+                label = n;
+            }
+        }
+    }
+    // pointer jumping: the pixel the label points to belongs to the same
+    // blob and might have found a bigger label already
+    vec2 jump = texelFetch(src, ivec2(label), 0).xy;
+    if(index(jump) > index(label)){
+        label = jump;
+    }
+    fragColor = vec4(label, 0.0, 1.0);
+}
+)";
+
+    // one point per pixel drawn at the root of its label, blended to
+    // accumulate the statistics of each blob at its root
+    const string statsVertex = R"(
+uniform sampler2D labels;
+uniform ivec2 size;
+uniform int extents;
+in vec4 position;
+out vec4 value;
+void main(){
+    ivec2 p = ivec2(position.xy);
+    vec2 root = texelFetch(labels, p, 0).xy;
+    gl_PointSize = 1.0;
+    if(root.x < 0.0){
+        // outside of the clip space
+        gl_Position = vec4(2.0, 2.0, 0.0, 1.0);
+        value = vec4(0.0);
+        return;
+    }
+    vec2 pos = vec2(p);
+    if(extents == 1){
+        // blended with max, the minimums are stored as distances to the
+        // far edge so everything is positive and bigger is better
+        value = vec4(pos + 1.0, vec2(size) - pos);
+    }else{
+        // offsets to the root keep the sums small enough for a float
+        value = vec4(1.0, pos - root, 0.0);
+    }
+    gl_Position = vec4((root + 0.5) / vec2(size) * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    const string statsFragment = R"(
+in vec4 value;
+out vec4 fragColor;
+void main(){
+    fragColor = value;
+}
+)";
+
+    // base of the pyramid, 1 at the root of every blob with the right area
+    const string countFragment = R"(
+uniform sampler2D labels;
+uniform sampler2D sums;
+uniform ivec2 size;
+uniform vec2 area;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    float root = 0.0;
+    if(p.x < size.x && p.y < size.y && ivec2(texelFetch(labels, p, 0).xy) == p){
+        float count = texelFetch(sums, p, 0).r;
+        root = count > area.x && count < area.y ? 1.0 : 0.0;
+    }
+    fragColor = vec4(root);
+}
+)";
+
+    const string reduceFragment = R"(
+uniform sampler2D src;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy) * 2;
+    fragColor = vec4(texelFetch(src, p, 0).r + texelFetch(src, p + ivec2(1, 0), 0).r
+                   + texelFetch(src, p + ivec2(0, 1), 0).r + texelFetch(src, p + ivec2(1, 1), 0).r);
+}
+)";
+
+    // each output pixel n walks down the pyramid to the n-th root: the
+    // state is the cell in the current level, the index of the root among
+    // the ones in that cell and whether there are enough roots for n
+    const string searchFragment = R"(
+uniform sampler2D state;
+uniform sampler2D level;
+uniform sampler2D top;
+uniform int first;
+out vec4 fragColor;
+void main(){
+    ivec2 slot = ivec2(gl_FragCoord.xy);
+    vec4 s;
+    if(first == 1){
+        float n = float(slot.x);
+        s = vec4(0.0, 0.0, n, n < texelFetch(top, ivec2(0), 0).r ? 1.0 : 0.0);
+    }else{
+        s = texelFetch(state, slot, 0);
+    }
+    ivec2 cell = ivec2(s.xy) * 2;
+    float index = s.z;
+    float count = texelFetch(level, cell, 0).r;
+    if(index >= count){
+        index -= count;
+        cell.x += 1;
+        count = texelFetch(level, cell, 0).r;
+        if(index >= count){
+            index -= count;
+            cell += ivec2(-1, 1);
+            count = texelFetch(level, cell, 0).r;
+            if(index >= count){
+                index -= count;
+                cell.x += 1;
+            }
+        }
+    }
+    fragColor = vec4(vec2(cell), index, s.w);
+}
+)";
+
+    // row 0: area, centroid and 1 for a valid blob, row 1: bounding box
+    const string gatherFragment = R"(
+uniform sampler2D state;
+uniform sampler2D sums;
+uniform sampler2D extents;
+uniform ivec2 size;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    vec4 s = texelFetch(state, ivec2(p.x, 0), 0);
+    if(s.w < 0.5){
+        fragColor = vec4(0.0);
+        return;
+    }
+    ivec2 root = ivec2(s.xy);
+    if(p.y == 0){
+        vec4 sum = texelFetch(sums, root, 0);
+        fragColor = vec4(sum.r, vec2(root) + sum.gb / sum.r, 1.0);
+    }else{
+        vec4 e = texelFetch(extents, root, 0);
+        fragColor = vec4(vec2(size) - e.ba, e.rg - 1.0);
+    }
+}
+)";
+
+    bool setupShader(ofShader & shader, const string & vertex, const string & fragment){
+        // position has to be at the location the renderer uses
+        return shader.setupShaderFromSource(GL_VERTEX_SHADER, header + vertex)
+            && shader.setupShaderFromSource(GL_FRAGMENT_SHADER, header + fragment)
+            && shader.bindDefaults()
+            && shader.linkProgram();
+    }
+
+    ofFbo::Settings fboSettings(int w, int h, GLint internalFormat){
+        ofFbo::Settings settings;
+        settings.width = w;
+        settings.height = h;
+        settings.internalformat = internalFormat;
+        settings.textureTarget = GL_TEXTURE_2D;
+        settings.minFilter = GL_NEAREST;
+        settings.maxFilter = GL_NEAREST;
+        settings.wrapModeHorizontal = GL_CLAMP_TO_EDGE;
+        settings.wrapModeVertical = GL_CLAMP_TO_EDGE;
+        return settings;
+    }
+
+    bool sort_blob_area_compare( const ofxCvBlob& a, const ofxCvBlob& b ){
+        return a.area > b.area;
+    }
+}
+
+//--------------------------------------------------------------------------------
+ofxCvGpuBlobFinder::ofxCvGpuBlobFinder() {
+    _width = 0;
+    _height = 0;
+    maxBlobs = 0;
+    learningRate = 0;
+    threshold = 0.1;
+    blurIterations = 1;
+    erodeIterations = 0;
+    dilateIterations = 0;
+    labelIterations = 24;
+    bAsyncReadback = false;
+    bLearnBackground = true;
+    nConsidered = 0;
+    currentBackground = 0;
+    currentDifference = 0;
+    currentMask = 0;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvGpuBlobFinder::setup( int w, int h, int _maxBlobs ) {
+    if( !ofIsGLProgrammableRenderer() ) {
+        ofLogError("ofxCvGpuBlobFinder") << "setup(): needs the programmable renderer, set the GL version to 3.2 or newer";
+        return false;
+    }
+    if( w < 2 || h < 2 || _maxBlobs < 1 ) {
+        ofLogError("ofxCvGpuBlobFinder") << "setup(): invalid size " << w << "x" << h << " or number of blobs " << _maxBlobs;
+        return false;
+    }
+
+    bool ok = setupShader( backgroundShader, passVertex, backgroundFragment )
+        && setupShader( differenceShader, passVertex, differenceFragment )
+        && setupShader( blurShader, passVertex, blurFragment )
+        && setupShader( thresholdShader, passVertex, thresholdFragment )
+        && setupShader( morphologyShader, passVertex, morphologyFragment )
+        && setupShader( labelInitShader, passVertex, labelInitFragment )
+        && setupShader( labelShader, passVertex, labelFragment )
+        && setupShader( statsShader, statsVertex, statsFragment )
+        && setupShader( countShader, passVertex, countFragment )
+        && setupShader( reduceShader, passVertex, reduceFragment )
+        && setupShader( searchShader, passVertex, searchFragment )
+        && setupShader( gatherShader, passVertex, gatherFragment );
+    if( !ok ) {
+        ofLogError("ofxCvGpuBlobFinder") << "setup(): couldn't compile the shaders";
+        return false;
+    }
+
+    _width = w;
+    _height = h;
+    maxBlobs = _maxBlobs;
+
+    frameCopy.allocate( fboSettings(w, h, GL_RGBA) );
+    for( int i = 0; i < 2; i++ ) {
+        background[i].allocate( fboSettings(w, h, GL_R32F) );
+        difference[i].allocate( fboSettings(w, h, GL_R32F) );
+        mask[i].allocate( fboSettings(w, h, GL_R8) );
+        labels[i].allocate( fboSettings(w, h, GL_RG32F) );
+        search[i].allocate( fboSettings(maxBlobs, 1, GL_RGBA32F) );
+    }
+    sums.allocate( fboSettings(w, h, GL_RGBA32F) );
+    extents.allocate( fboSettings(w, h, GL_RGBA32F) );
+    result.allocate( fboSettings(maxBlobs, 2, GL_RGBA32F) );
+
+    // the pyramid needs a power of 2 square so every cell has 4 children
+    int size = 1;
+    while( size < MAX(w, h) ) {
+        size *= 2;
+    }
+    pyramid.clear();
+    for( ; size >= 1; size /= 2 ) {
+        pyramid.push_back( ofFbo() );
+        pyramid.back().allocate( fboSettings(size, size, GL_R32F) );
+    }
+
+    pixelPoints.clear();
+    pixelPoints.setMode( OF_PRIMITIVE_POINTS );
+    pixelPoints.setUsage( GL_STATIC_DRAW );
+    pixelPoints.getVertices().reserve( w * h );
+    for( int y = 0; y < h; y++ ) {
+        for( int x = 0; x < w; x++ ) {
+            pixelPoints.addVertex( glm::vec3(x, y, 0) );
+        }
+    }
+
+    blobs.clear();
+    bLearnBackground = true;
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvGpuBlobFinder::isSetup() const {
+    return maxBlobs > 0;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::learnBackground() {
+    bLearnBackground = true;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::setBackgroundLearningRate( float rate ) {
+    learningRate = ofClamp(rate, 0, 1);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::setThreshold( float _threshold ) {
+    threshold = _threshold;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::setBlur( int iterations ) {
+    blurIterations = MAX(iterations, 0);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::setErode( int iterations ) {
+    erodeIterations = MAX(iterations, 0);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::setDilate( int iterations ) {
+    dilateIterations = MAX(iterations, 0);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::setLabelIterations( int iterations ) {
+    labelIterations = MAX(iterations, 1);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::setUseAsyncReadback( bool bAsync ) {
+    bAsyncReadback = bAsync;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::beginPass( ofFbo& dst, ofShader& shader ) {
+    dst.begin();
+    shader.begin();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::endPass( ofFbo& dst, ofShader& shader ) {
+    ofDrawRectangle( 0, 0, dst.getWidth(), dst.getHeight() );
+    shader.end();
+    dst.end();
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvGpuBlobFinder::findBlobs( const ofTexture& frame,
+                                   int minArea,
+                                   int maxArea,
+                                   int _nConsidered ) {
+    if( !isSetup() ) {
+        ofLogError("ofxCvGpuBlobFinder") << "findBlobs(): call setup() first";
+        return 0;
+    }
+    if( !frame.isAllocated() ) {
+        ofLogError("ofxCvGpuBlobFinder") << "findBlobs(): frame not allocated";
+        return 0;
+    }
+    nConsidered = _nConsidered;
+
+    ofPushStyle();
+    ofDisableBlendMode();
+    ofFill();
+    ofSetColor(255);
+
+    // copy the frame into a texture of the right size and type
+    frameCopy.begin();
+    frame.draw( 0, 0, _width, _height );
+    frameCopy.end();
+
+    // ---------------------------- background and difference
+    bool bLearn = bLearnBackground;
+    if( bLearn || learningRate > 0 ) {
+        int next = 1 - currentBackground;
+        beginPass( background[next], backgroundShader );
+        backgroundShader.setUniformTexture( "frame", frameCopy.getTexture(), 0 );
+        backgroundShader.setUniformTexture( "background", background[currentBackground].getTexture(), 1 );
+        backgroundShader.setUniform1f( "rate", bLearn ? 1.0f : learningRate );
+        endPass( background[next], backgroundShader );
+        currentBackground = next;
+        bLearnBackground = false;
+    }
+
+    beginPass( difference[0], differenceShader );
+    differenceShader.setUniformTexture( "frame", frameCopy.getTexture(), 0 );
+    differenceShader.setUniformTexture( "background", background[currentBackground].getTexture(), 1 );
+    endPass( difference[0], differenceShader );
+    currentDifference = 0;
+
+    for( int i = 0; i < blurIterations; i++ ) {
+        int next = 1 - currentDifference;
+        beginPass( difference[next], blurShader );
+        blurShader.setUniformTexture( "src", difference[currentDifference].getTexture(), 0 );
+        blurShader.setUniform2i( "size", _width, _height );
+        endPass( difference[next], blurShader );
+        currentDifference = next;
+    }
+
+    // ---------------------------- threshold and morphology
+    beginPass( mask[0], thresholdShader );
+    thresholdShader.setUniformTexture( "src", difference[currentDifference].getTexture(), 0 );
+    thresholdShader.setUniform1f( "threshold", threshold );
+    endPass( mask[0], thresholdShader );
+    currentMask = 0;
+
+    for( int i = 0; i < erodeIterations + dilateIterations; i++ ) {
+        int next = 1 - currentMask;
+        beginPass( mask[next], morphologyShader );
+        morphologyShader.setUniformTexture( "src", mask[currentMask].getTexture(), 0 );
+        morphologyShader.setUniform2i( "size", _width, _height );
+        morphologyShader.setUniform1i( "dilate", i >= erodeIterations ? 1 : 0 );
+        endPass( mask[next], morphologyShader );
+        currentMask = next;
+    }
+
+    // ---------------------------- connected components
+    beginPass( labels[0], labelInitShader );
+    labelInitShader.setUniformTexture( "src", mask[currentMask].getTexture(), 0 );
+    endPass( labels[0], labelInitShader );
+
+    int currentLabels = 0;
+    for( int i = 0; i < labelIterations; i++ ) {
+        int next = 1 - currentLabels;
+        beginPass( labels[next], labelShader );
+        labelShader.setUniformTexture( "src", labels[currentLabels].getTexture(), 0 );
+        labelShader.setUniform2i( "size", _width, _height );
+        endPass( labels[next], labelShader );
+        currentLabels = next;
+    }
+
+    // ---------------------------- statistics of each label at its root
+    glEnable( GL_BLEND );
+    glBlendFunc( GL_ONE, GL_ONE );
+#ifndef TARGET_OPENGLES
+    glEnable( GL_PROGRAM_POINT_SIZE );
+#endif
+    for( int i = 0; i < 2; i++ ) {
+        ofFbo& dst = i == 0 ? sums : extents;
+        dst.begin();
+        ofClear( 0, 0, 0, 0 );
+        glBlendEquation( i == 0 ? GL_FUNC_ADD : GL_MAX );
+        statsShader.begin();
+        statsShader.setUniformTexture( "labels", labels[currentLabels].getTexture(), 0 );
+        statsShader.setUniform2i( "size", _width, _height );
+        statsShader.setUniform1i( "extents", i );
+        pixelPoints.draw();
+        statsShader.end();
+        dst.end();
+    }
+    glBlendEquation( GL_FUNC_ADD );
+#ifndef TARGET_OPENGLES
+    glDisable( GL_PROGRAM_POINT_SIZE );
+#endif
+    ofDisableBlendMode();
+
+    // ---------------------------- compact the roots into result
+    beginPass( pyramid[0], countShader );
+    countShader.setUniformTexture( "labels", labels[currentLabels].getTexture(), 0 );
+    countShader.setUniformTexture( "sums", sums.getTexture(), 1 );
+    countShader.setUniform2i( "size", _width, _height );
+    countShader.setUniform2f( "area", minArea, maxArea );
+    endPass( pyramid[0], countShader );
+
+    for( size_t i = 1; i < pyramid.size(); i++ ) {
+        beginPass( pyramid[i], reduceShader );
+        reduceShader.setUniformTexture( "src", pyramid[i - 1].getTexture(), 0 );
+        endPass( pyramid[i], reduceShader );
+    }
+
+    int currentSearch = 0;
+    for( int i = (int)pyramid.size() - 2; i >= 0; i-- ) {
+        int next = 1 - currentSearch;
+        bool bFirst = i == (int)pyramid.size() - 2;
+        beginPass( search[next], searchShader );
+        searchShader.setUniformTexture( "state", search[currentSearch].getTexture(), 0 );
+        searchShader.setUniformTexture( "level", pyramid[i].getTexture(), 1 );
+        searchShader.setUniformTexture( "top", pyramid.back().getTexture(), 2 );
+        searchShader.setUniform1i( "first", bFirst ? 1 : 0 );
+        endPass( search[next], searchShader );
+        currentSearch = next;
+    }
+
+    beginPass( result, gatherShader );
+    gatherShader.setUniformTexture( "state", search[currentSearch].getTexture(), 0 );
+    gatherShader.setUniformTexture( "sums", sums.getTexture(), 1 );
+    gatherShader.setUniformTexture( "extents", extents.getTexture(), 2 );
+    gatherShader.setUniform2i( "size", _width, _height );
+    endPass( result, gatherShader );
+
+    ofPopStyle();
+
+    // ---------------------------- read back only the statistics
+    if( bAsyncReadback ) {
+        result.readToPixelsAsync();
+        if( result.getAsyncPixels(resultPixels) ) {
+            readBlobs();
+        }
+    } else {
+        result.readToPixels( resultPixels );
+        readBlobs();
+    }
+
+    return blobs.size();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::readBlobs() {
+    blobs.clear();
+    if( resultPixels.getWidth() != (size_t)maxBlobs || resultPixels.getHeight() != 2 ) {
+        return;
+    }
+    const float* stats = resultPixels.getData();
+    const float* bounds = stats + maxBlobs * 4;
+    for( int i = 0; i < maxBlobs && stats[i * 4 + 3] > 0.5f; i++ ) {
+        blobs.push_back( ofxCvBlob() );
+        ofxCvBlob& blob = blobs.back();
+        blob.area                = stats[i * 4];
+        blob.centroid.x          = stats[i * 4 + 1];
+        blob.centroid.y          = stats[i * 4 + 2];
+        blob.boundingRect.x      = bounds[i * 4];
+        blob.boundingRect.y      = bounds[i * 4 + 1];
+        blob.boundingRect.width  = bounds[i * 4 + 2] - bounds[i * 4] + 1;
+        blob.boundingRect.height = bounds[i * 4 + 3] - bounds[i * 4 + 1] + 1;
+    }
+
+    if( blobs.size() > 1 ) {
+        sort( blobs.begin(), blobs.end(), sort_blob_area_compare );
+    }
+    if( (int)blobs.size() > nConsidered ) {
+        blobs.resize( MAX(nConsidered, 0) );
+    }
+}
+
+//--------------------------------------------------------------------------------
+const ofTexture& ofxCvGpuBlobFinder::getBackgroundTexture() const {
+    return background[currentBackground].getTexture();
+}
+
+//--------------------------------------------------------------------------------
+const ofTexture& ofxCvGpuBlobFinder::getDifferenceTexture() const {
+    return difference[currentDifference].getTexture();
+}
+
+//--------------------------------------------------------------------------------
+const ofTexture& ofxCvGpuBlobFinder::getMaskTexture() const {
+    return mask[currentMask].getTexture();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuBlobFinder::draw( float x, float y, float w, float h ) const {
+    float scalex = _width != 0 ? w / _width : 1.0f;
+    float scaley = _height != 0 ? h / _height : 1.0f;
+
+    ofPushStyle();
+    ofPushMatrix();
+    ofTranslate( x, y, 0.0 );
+    ofScale( scalex, scaley, 0.0 );
+
+    // ---------------------------- draw the bounding rectangles and centroids
+    ofNoFill();
+    ofSetHexColor(0xDD00CC);
+    for( size_t i = 0; i < blobs.size(); i++ ) {
+        ofDrawRectangle( blobs[i].boundingRect );
+    }
+    ofFill();
+    ofSetHexColor(0x00FFFF);
+    for( size_t i = 0; i < blobs.size(); i++ ) {
+        ofDrawCircle( blobs[i].centroid.x, blobs[i].centroid.y, 2 / MAX(scalex, scaley) );
+    }
+
+    ofPopMatrix();
+    ofPopStyle();
+}
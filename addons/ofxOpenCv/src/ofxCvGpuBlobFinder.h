@@ -0,0 +1,122 @@
+/*
+* ofxCvGpuBlobFinder.h
+*
+* Background subtraction and blob finding that runs fully on the gpu.
+* Each frame is compared to the background, blurred, thresholded,
+* eroded and dilated and its connected components are labeled with
+* shaders. Only the statistics of the blobs (area, centroid and bounding
+* box) are read back, so a camera frame never has to be downloaded.
+*
+* Needs the programmable renderer. The blobs have no contour points and
+* are never holes, use ofxCvContourFinder on getMaskTexture() if the
+* contours are needed.
+*
+*/
+
+#pragma once
+
+#include "ofxCvConstants.h"
+#include "ofxCvBlob.h"
+
+class ofxCvGpuBlobFinder : public ofBaseDraws {
+
+  public:
+
+    vector<ofxCvBlob>  blobs;
+
+
+    ofxCvGpuBlobFinder();
+
+    // frames of any size are scaled to w x h, maxBlobs is the most blobs
+    // read back each frame before sorting by area
+    bool  setup( int w, int h, int maxBlobs = 256 );
+    bool  isSetup() const;
+
+    // the next frame becomes the background, the first frame is used if
+    // this is never called
+    void  learnBackground();
+    // how fast the background adapts to the frames, 0 keeps it static
+    void  setBackgroundLearningRate( float rate );
+    // difference in luminance, from 0 to 1, that counts as foreground
+    void  setThreshold( float threshold );
+    // iterations of a 3x3 box blur of the difference before thresholding
+    void  setBlur( int iterations );
+    // iterations of 3x3 erode and then dilate of the thresholded mask
+    void  setErode( int iterations );
+    void  setDilate( int iterations );
+    // passes of the labeling, each one spreads the labels by at least a
+    // pixel and jumps along the labels already found so most blobs are
+    // complete after a few, long thin shapes might need more
+    void  setLabelIterations( int iterations );
+    // reads the blobs back without stalling, blobs are then updated some
+    // frames late and only when a new result is ready
+    void  setUseAsyncReadback( bool bAsync );
+
+    // process a frame, returns the number of blobs
+    int  findBlobs( const ofTexture& frame,
+                    int minArea, int maxArea,
+                    int nConsidered );
+
+    const ofTexture&  getBackgroundTexture() const;
+    const ofTexture&  getDifferenceTexture() const;
+    const ofTexture&  getMaskTexture() const;
+
+    virtual float getWidth() const { return _width; };
+    virtual float getHeight() const { return _height; };
+
+    using ofBaseDraws::draw;
+    virtual void  draw( float x, float y, float w, float h ) const;
+
+
+  protected:
+
+    void  beginPass( ofFbo& dst, ofShader& shader );
+    void  endPass( ofFbo& dst, ofShader& shader );
+    void  readBlobs();
+
+    int  _width;
+    int  _height;
+    int  maxBlobs;
+
+    float  learningRate;
+    float  threshold;
+    int    blurIterations;
+    int    erodeIterations;
+    int    dilateIterations;
+    int    labelIterations;
+    bool   bAsyncReadback;
+    bool   bLearnBackground;
+    int    nConsidered;
+
+    // ping pong pairs, current is the last one written
+    ofFbo  background[2];
+    ofFbo  difference[2];
+    ofFbo  mask[2];
+    ofFbo  labels[2];
+    ofFbo  search[2];
+    int    currentBackground;
+    int    currentDifference;
+    int    currentMask;
+
+    ofFbo  frameCopy;
+    ofFbo  sums;        // count and offsets to the root of each label
+    ofFbo  extents;     // bounding box of each label
+    vector<ofFbo>  pyramid;  // number of blobs in each 2^n x 2^n area
+    ofFbo  result;      // the statistics of up to maxBlobs blobs
+    ofFloatPixels  resultPixels;
+    ofVboMesh  pixelPoints;
+
+    ofShader  backgroundShader;
+    ofShader  differenceShader;
+    ofShader  blurShader;
+    ofShader  thresholdShader;
+    ofShader  morphologyShader;
+    ofShader  labelInitShader;
+    ofShader  labelShader;
+    ofShader  statsShader;
+    ofShader  countShader;
+    ofShader  reduceShader;
+    ofShader  searchShader;
+    ofShader  gatherShader;
+
+};
@@ -0,0 +1,485 @@
+#include "ofxCvGpuOpticalFlow.h"
+
+namespace{
+#ifdef TARGET_OPENGLES
+    const string header = "#version 300 es\nprecision highp float;\nprecision highp int;\nprecision highp sampler2D;\n";
+    // 32 bit float textures can't be filtered in OpenGL ES 3
+    const GLint lumaFormat = GL_R16F;
+    const GLint vectorFormat = GL_RG16F;
+#else
+    const string header = "#version 150\n";
+    const GLint lumaFormat = GL_R32F;
+    const GLint vectorFormat = GL_RG32F;
+#endif
+
+    const string passVertex = R"(
+uniform mat4 modelViewProjectionMatrix;
+in vec4 position;
+void main(){
+    gl_Position = modelViewProjectionMatrix * position;
+}
+)";
+
+    const string lumaFragment = R"(
+uniform sampler2D frame;
+out vec4 fragColor;
+void main(){
+    fragColor = vec4(dot(texelFetch(frame, ivec2(gl_FragCoord.xy), 0).rgb, vec3(0.299, 0.587, 0.114)));
+}
+)";
+
+    // each level is the average of 2x2 pixels of the one below
+    const string downsampleFragment = R"(
+uniform sampler2D src;
+uniform ivec2 size;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy) * 2;
+    ivec2 last = size - 1;
+    fragColor = vec4((texelFetch(src, p, 0).r + texelFetch(src, min(p + ivec2(1, 0), last), 0).r
+                    + texelFetch(src, min(p + ivec2(0, 1), last), 0).r + texelFetch(src, min(p + ivec2(1, 1), last), 0).r) * 0.25);
+}
+)";
+
+    const string gradientFragment = R"(
+uniform sampler2D src;
+uniform ivec2 size;
+out vec4 fragColor;
+float luma(ivec2 p){
+    return texelFetch(src, clamp(p, ivec2(0), size - 1), 0).r;
+}
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    fragColor = vec4((luma(p + ivec2(1, 0)) - luma(p - ivec2(1, 0))) * 0.5,
+                     (luma(p + ivec2(0, 1)) - luma(p - ivec2(0, 1))) * 0.5, 0.0, 1.0);
+}
+)";
+
+    // one Lucas-Kanade step: the flow v moves the window of the previous
+    // frame to the next one, the mismatch along the gradient over the
+    // window gives the correction. The first step of a level starts from
+    // the coarser level's flow, scaled to this one
+    const string lucasKanadeFragment = R"(
+uniform sampler2D prev;
+uniform sampler2D gradient;
+uniform sampler2D next;
+uniform sampler2D flow;
+uniform sampler2D coarse;
+uniform int init;
+uniform int hasCoarse;
+uniform vec2 coarseScale;
+uniform ivec2 size;
+uniform int radius;
+uniform float minEigen;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    vec2 v = vec2(0.0);
+    if(init == 0){
+        v = texelFetch(flow, p, 0).xy;
+    }else if(hasCoarse == 1){
+        v = texture(coarse, gl_FragCoord.xy / vec2(size)).xy * coarseScale;
+    }
+
+    vec2 invSize = 1.0 / vec2(size);
+    float gxx = 0.0;
+    float gxy = 0.0;
+    float gyy = 0.0;
+    vec2 b = vec2(0.0);
+    for(int y = -radius; y <= radius; y++){
+        for(int x = -radius; x <= radius; x++){
+            ivec2 q = clamp(p + ivec2(x, y), ivec2(0), size - 1);
+            vec2 g = texelFetch(gradient, q, 0).xy;
+            float diff = texelFetch(prev, q, 0).r - texture(next, (vec2(q) + 0.5 + v) * invSize).r;
+            gxx += g.x * g.x;
+            gxy += g.x * g.y;
+            gyy += g.y * g.y;
+            b += diff * g;
+        }
+    }
+
+    // windows without texture in both directions keep the estimate
+    float halfTrace = (gxx + gyy) * 0.5;
+    float eigen = halfTrace - sqrt(max(halfTrace * halfTrace - (gxx * gyy - gxy * gxy), 0.0));
+    if(eigen > minEigen){
+        vec2 dv = vec2(gyy * b.x - gxy * b.y, gxx * b.y - gxy * b.x) / (gxx * gyy - gxy * gxy);
+        float len = length(dv);
+        v += len > 2.0 ? dv * (2.0 / len) : dv;
+    }
+    fragColor = vec4(v, 0.0, 1.0);
+}
+)";
+
+    const string smoothFragment = R"(
+uniform sampler2D src;
+uniform ivec2 size;
+out vec4 fragColor;
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    vec2 sum = vec2(0.0);
+    for(int y = -1; y <= 1; y++){
+        for(int x = -1; x <= 1; x++){
+            sum += texelFetch(src, clamp(p + ivec2(x, y), ivec2(0), size - 1), 0).xy;
+        }
+    }
+    fragColor = vec4(sum / 9.0, 0.0, 1.0);
+}
+)";
+
+    // the flow filtered to the readback size, in pixels of that size
+    const string readbackFragment = R"(
+uniform sampler2D src;
+uniform ivec2 size;
+uniform vec2 scale;
+out vec4 fragColor;
+void main(){
+    fragColor = vec4(texture(src, gl_FragCoord.xy / vec2(size)).xy * scale, 0.0, 1.0);
+}
+)";
+
+    const string drawVertex = R"(
+uniform mat4 modelViewProjectionMatrix;
+in vec4 position;
+in vec2 texcoord;
+out vec2 uv;
+void main(){
+    uv = texcoord;
+    gl_Position = modelViewProjectionMatrix * position;
+}
+)";
+
+    const string drawFragment = R"(
+uniform sampler2D src;
+uniform float scale;
+in vec2 uv;
+out vec4 fragColor;
+vec3 hsv2rgb(vec3 c){
+    vec3 p = abs(fract(c.xxx + vec3(1.0, 2.0 / 3.0, 1.0 / 3.0)) * 6.0 - 3.0);
+    return c.z * mix(vec3(1.0), clamp(p - 1.0, 0.0, 1.0), c.y);
+}
+void main(){
+    vec2 v = texture(src, uv).xy;
+    float hue = atan(v.y, v.x) / 6.2831853 + 0.5;
+    fragColor = vec4(hsv2rgb(vec3(hue, clamp(length(v) / scale, 0.0, 1.0), 1.0)), 1.0);
+}
+)";
+
+    bool setupShader(ofShader & shader, const string & vertex, const string & fragment){
+        // position has to be at the location the renderer uses
+        return shader.setupShaderFromSource(GL_VERTEX_SHADER, header + vertex)
+            && shader.setupShaderFromSource(GL_FRAGMENT_SHADER, header + fragment)
+            && shader.bindDefaults()
+            && shader.linkProgram();
+    }
+
+    ofFbo::Settings fboSettings(int w, int h, GLint internalFormat, GLint filter = GL_NEAREST){
+        ofFbo::Settings settings;
+        settings.width = w;
+        settings.height = h;
+        settings.internalformat = internalFormat;
+        settings.textureTarget = GL_TEXTURE_2D;
+        settings.minFilter = filter;
+        settings.maxFilter = filter;
+        settings.wrapModeHorizontal = GL_CLAMP_TO_EDGE;
+        settings.wrapModeVertical = GL_CLAMP_TO_EDGE;
+        return settings;
+    }
+}
+
+//--------------------------------------------------------------------------------
+ofxCvGpuOpticalFlow::ofxCvGpuOpticalFlow() {
+    _width = 0;
+    _height = 0;
+    numLevels = 4;
+    windowRadius = 2;
+    iterations = 3;
+    smoothing = 1;
+    drawScale = 8;
+    bAsyncReadback = false;
+    bHasPrevious = false;
+    currentFrame = 0;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvGpuOpticalFlow::setup( int w, int h ) {
+    if( !ofIsGLProgrammableRenderer() ) {
+        ofLogError("ofxCvGpuOpticalFlow") << "setup(): needs the programmable renderer, set the GL version to 3.2 or newer";
+        return false;
+    }
+    if( w < 2 || h < 2 ) {
+        ofLogError("ofxCvGpuOpticalFlow") << "setup(): invalid size " << w << "x" << h;
+        return false;
+    }
+
+    bool ok = setupShader( lumaShader, passVertex, lumaFragment )
+        && setupShader( downsampleShader, passVertex, downsampleFragment )
+        && setupShader( gradientShader, passVertex, gradientFragment )
+        && setupShader( lucasKanadeShader, passVertex, lucasKanadeFragment )
+        && setupShader( smoothShader, passVertex, smoothFragment )
+        && setupShader( readbackShader, passVertex, readbackFragment )
+        && setupShader( drawShader, drawVertex, drawFragment );
+    if( !ok ) {
+        ofLogError("ofxCvGpuOpticalFlow") << "setup(): couldn't compile the shaders";
+        return false;
+    }
+
+    _width = w;
+    _height = h;
+    frameCopy.allocate( fboSettings(w, h, GL_RGBA) );
+    allocateLevels();
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::allocateLevels() {
+    // no level smaller than the window
+    int levels = 1;
+    while( levels < numLevels && (_width >> levels) > windowRadius * 2 && (_height >> levels) > windowRadius * 2 ) {
+        levels++;
+    }
+
+    for( int i = 0; i < 2; i++ ) {
+        pyramid[i].assign( levels, ofFbo() );
+        gradient[i].assign( levels, ofFbo() );
+        flow[i].assign( levels, ofFbo() );
+        for( int l = 0; l < levels; l++ ) {
+            int w = _width >> l;
+            int h = _height >> l;
+            // the next frame is sampled between pixels and the coarser
+            // flow is upsampled, both filtered
+            pyramid[i][l].allocate( fboSettings(w, h, lumaFormat, GL_LINEAR) );
+            gradient[i][l].allocate( fboSettings(w, h, vectorFormat) );
+            flow[i][l].allocate( fboSettings(w, h, vectorFormat, GL_LINEAR) );
+        }
+    }
+    currentFlow.assign( levels, 0 );
+    currentFrame = 0;
+    bHasPrevious = false;
+
+    flow[0][0].begin();
+    ofClear( 0, 0, 0, 0 );
+    flow[0][0].end();
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvGpuOpticalFlow::isSetup() const {
+    return _width > 0;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::setPyramidLevels( int levels ) {
+    numLevels = MAX(levels, 1);
+    if( isSetup() ) {
+        allocateLevels();
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::setWindowRadius( int radius ) {
+    windowRadius = MAX(radius, 1);
+    if( isSetup() ) {
+        allocateLevels();
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::setIterations( int _iterations ) {
+    iterations = MAX(_iterations, 1);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::setSmoothing( int _iterations ) {
+    smoothing = MAX(_iterations, 0);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::setUseAsyncReadback( bool bAsync ) {
+    bAsyncReadback = bAsync;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::setDrawScale( float pixels ) {
+    drawScale = MAX(pixels, 0.001f);
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::reset() {
+    bHasPrevious = false;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::beginPass( ofFbo& dst, ofShader& shader ) {
+    dst.begin();
+    shader.begin();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::endPass( ofFbo& dst, ofShader& shader ) {
+    ofDrawRectangle( 0, 0, dst.getWidth(), dst.getHeight() );
+    shader.end();
+    dst.end();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::update( const ofTexture& frame ) {
+    if( !isSetup() ) {
+        ofLogError("ofxCvGpuOpticalFlow") << "update(): call setup() first";
+        return;
+    }
+    if( !frame.isAllocated() ) {
+        ofLogError("ofxCvGpuOpticalFlow") << "update(): frame not allocated";
+        return;
+    }
+
+    ofPushStyle();
+    ofDisableBlendMode();
+    ofFill();
+    ofSetColor(255);
+
+    // copy the frame into a texture of the right size and type
+    frameCopy.begin();
+    frame.draw( 0, 0, _width, _height );
+    frameCopy.end();
+
+    // ---------------------------- pyramid and gradients of the new frame
+    int next = 1 - currentFrame;
+    int levels = pyramid[next].size();
+    beginPass( pyramid[next][0], lumaShader );
+    lumaShader.setUniformTexture( "frame", frameCopy.getTexture(), 0 );
+    endPass( pyramid[next][0], lumaShader );
+
+    for( int l = 1; l < levels; l++ ) {
+        beginPass( pyramid[next][l], downsampleShader );
+        downsampleShader.setUniformTexture( "src", pyramid[next][l - 1].getTexture(), 0 );
+        downsampleShader.setUniform2i( "size", pyramid[next][l - 1].getWidth(), pyramid[next][l - 1].getHeight() );
+        endPass( pyramid[next][l], downsampleShader );
+    }
+
+    for( int l = 0; l < levels; l++ ) {
+        beginPass( gradient[next][l], gradientShader );
+        gradientShader.setUniformTexture( "src", pyramid[next][l].getTexture(), 0 );
+        gradientShader.setUniform2i( "size", pyramid[next][l].getWidth(), pyramid[next][l].getHeight() );
+        endPass( gradient[next][l], gradientShader );
+    }
+
+    // ---------------------------- flow from the coarsest level to the finest
+    if( bHasPrevious ) {
+        float minEigen = 1e-4f * (windowRadius * 2 + 1) * (windowRadius * 2 + 1);
+        for( int l = levels - 1; l >= 0; l-- ) {
+            int w = pyramid[next][l].getWidth();
+            int h = pyramid[next][l].getHeight();
+            bool bCoarse = l + 1 < levels;
+            const ofFbo& coarse = flow[currentFlow[bCoarse ? l + 1 : l]][bCoarse ? l + 1 : l];
+            for( int i = 0; i < iterations; i++ ) {
+                int dst = 1 - currentFlow[l];
+                beginPass( flow[dst][l], lucasKanadeShader );
+                lucasKanadeShader.setUniformTexture( "prev", pyramid[currentFrame][l].getTexture(), 0 );
+                lucasKanadeShader.setUniformTexture( "gradient", gradient[currentFrame][l].getTexture(), 1 );
+                lucasKanadeShader.setUniformTexture( "next", pyramid[next][l].getTexture(), 2 );
+                lucasKanadeShader.setUniformTexture( "flow", flow[currentFlow[l]][l].getTexture(), 3 );
+                lucasKanadeShader.setUniformTexture( "coarse", coarse.getTexture(), 4 );
+                lucasKanadeShader.setUniform1i( "init", i == 0 ? 1 : 0 );
+                lucasKanadeShader.setUniform1i( "hasCoarse", bCoarse ? 1 : 0 );
+                lucasKanadeShader.setUniform2f( "coarseScale", float(w) / coarse.getWidth(), float(h) / coarse.getHeight() );
+                lucasKanadeShader.setUniform2i( "size", w, h );
+                lucasKanadeShader.setUniform1i( "radius", windowRadius );
+                lucasKanadeShader.setUniform1f( "minEigen", minEigen );
+                endPass( flow[dst][l], lucasKanadeShader );
+                currentFlow[l] = dst;
+            }
+        }
+
+        for( int i = 0; i < smoothing; i++ ) {
+            int dst = 1 - currentFlow[0];
+            beginPass( flow[dst][0], smoothShader );
+            smoothShader.setUniformTexture( "src", flow[currentFlow[0]][0].getTexture(), 0 );
+            smoothShader.setUniform2i( "size", _width, _height );
+            endPass( flow[dst][0], smoothShader );
+            currentFlow[0] = dst;
+        }
+    } else {
+        ofFbo& dst = flow[currentFlow[0]][0];
+        dst.begin();
+        ofClear( 0, 0, 0, 0 );
+        dst.end();
+    }
+
+    ofPopStyle();
+
+    currentFrame = next;
+    bHasPrevious = true;
+}
+
+//--------------------------------------------------------------------------------
+const ofTexture& ofxCvGpuOpticalFlow::getFlowTexture() const {
+    return flow[currentFlow.empty() ? 0 : currentFlow[0]][0].getTexture();
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvGpuOpticalFlow::getFlow( ofxCvFloatImage& flowX, ofxCvFloatImage& flowY ) {
+    if( !isSetup() ) {
+        ofLogError("ofxCvGpuOpticalFlow") << "getFlow(): call setup() first";
+        return false;
+    }
+
+    int w = flowX.bAllocated ? flowX.width : _width;
+    int h = flowX.bAllocated ? flowX.height : _height;
+    if( readback.getWidth() != w || readback.getHeight() != h ) {
+        readback.allocate( fboSettings(w, h, GL_RGBA32F) );
+    }
+
+    ofPushStyle();
+    ofDisableBlendMode();
+    ofFill();
+    ofSetColor(255);
+    beginPass( readback, readbackShader );
+    readbackShader.setUniformTexture( "src", getFlowTexture(), 0 );
+    readbackShader.setUniform2i( "size", w, h );
+    readbackShader.setUniform2f( "scale", float(w) / _width, float(h) / _height );
+    endPass( readback, readbackShader );
+    ofPopStyle();
+
+    if( bAsyncReadback ) {
+        readback.readToPixelsAsync();
+        if( !readback.getAsyncPixels(readbackPixels) ) {
+            return false;
+        }
+    } else {
+        readback.readToPixels( readbackPixels );
+    }
+
+    // an async result can be from before the size changed
+    int rw = readbackPixels.getWidth();
+    int rh = readbackPixels.getHeight();
+    if( rw == 0 || rh == 0 || readbackPixels.getNumChannels() != 4 ) {
+        return false;
+    }
+    readbackX.resize( rw * rh );
+    readbackY.resize( rw * rh );
+    const float* src = readbackPixels.getData();
+    for( int i = 0; i < rw * rh; i++ ) {
+        readbackX[i] = src[i * 4];
+        readbackY[i] = src[i * 4 + 1];
+    }
+    if( !flowX.bAllocated || flowX.width != rw || flowX.height != rh ) {
+        flowX.allocate( rw, rh );
+    }
+    if( !flowY.bAllocated || flowY.width != rw || flowY.height != rh ) {
+        flowY.allocate( rw, rh );
+    }
+    flowX.setFromPixels( readbackX.data(), rw, rh );
+    flowY.setFromPixels( readbackY.data(), rw, rh );
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvGpuOpticalFlow::draw( float x, float y, float w, float h ) const {
+    if( !isSetup() ) {
+        return;
+    }
+    drawShader.begin();
+    drawShader.setUniformTexture( "src", getFlowTexture(), 0 );
+    drawShader.setUniform1f( "scale", drawScale );
+    getFlowTexture().draw( x, y, w, h );
+    drawShader.end();
+}
@@ -0,0 +1,107 @@
+/*
+* ofxCvGpuOpticalFlow.h
+*
+* Dense optical flow that runs fully on the gpu, pyramidal Lucas-Kanade
+* solved for every pixel in shaders. The result stays in a texture, in
+* pixels per frame, so it can drive particles or other shaders without a
+* readback. getFlow() reads it back downsampled into ofxCvFloatImages
+* when the cpu needs it.
+*
+* Needs the programmable renderer.
+*
+*/
+
+#pragma once
+
+#include "ofxCvConstants.h"
+#include "ofxCvFloatImage.h"
+
+class ofxCvGpuOpticalFlow : public ofBaseDraws {
+
+  public:
+
+    ofxCvGpuOpticalFlow();
+
+    // frames of any size are scaled to w x h, the flow has the same size
+    bool  setup( int w, int h );
+    bool  isSetup() const;
+
+    // levels of the pyramid, each one half the size of the previous one,
+    // every level doubles the motion that can be followed, 4 by default
+    void  setPyramidLevels( int levels );
+    // radius of the window the flow of each pixel is solved over, bigger
+    // is smoother and slower, 2 (5x5) by default
+    void  setWindowRadius( int radius );
+    // refinements of the flow at each level, 3 by default
+    void  setIterations( int iterations );
+    // iterations of a 3x3 blur of the final flow, 1 by default
+    void  setSmoothing( int iterations );
+    // reads the flow back without stalling, getFlow() then returns the
+    // flow of some frames before and false until one is ready
+    void  setUseAsyncReadback( bool bAsync );
+    // flow, in pixels per frame, drawn with full saturation by draw()
+    void  setDrawScale( float pixels );
+
+    // the next frame has no flow, the one after is compared to it
+    void  reset();
+
+    // the flow from the previous frame to this one
+    void  update( const ofTexture& frame );
+
+    // x in red and y in green, in pixels per frame at the flow size
+    const ofTexture&  getFlowTexture() const;
+
+    // reads the flow back at the size the images are allocated with, or
+    // the flow size if they aren't, in pixels of that size
+    bool  getFlow( ofxCvFloatImage& flowX, ofxCvFloatImage& flowY );
+
+    virtual float getWidth() const { return _width; };
+    virtual float getHeight() const { return _height; };
+
+    // the direction as hue and the speed as saturation
+    using ofBaseDraws::draw;
+    virtual void  draw( float x, float y, float w, float h ) const;
+
+
+  protected:
+
+    void  beginPass( ofFbo& dst, ofShader& shader );
+    void  endPass( ofFbo& dst, ofShader& shader );
+    void  allocateLevels();
+
+    int  _width;
+    int  _height;
+
+    int    numLevels;
+    int    windowRadius;
+    int    iterations;
+    int    smoothing;
+    float  drawScale;
+    bool   bAsyncReadback;
+    bool   bHasPrevious;
+
+    // luminance and its gradient of the current and the previous frame,
+    // current is the last one written
+    vector<ofFbo>  pyramid[2];
+    vector<ofFbo>  gradient[2];
+    int    currentFrame;
+
+    // ping pong pairs for every level
+    vector<ofFbo>  flow[2];
+    vector<int>    currentFlow;
+
+    ofFbo  frameCopy;
+    ofFbo  readback;
+    ofFloatPixels  readbackPixels;
+    vector<float>  readbackX;
+    vector<float>  readbackY;
+
+    ofShader  lumaShader;
+    ofShader  downsampleShader;
+    ofShader  gradientShader;
+    ofShader  lucasKanadeShader;
+    ofShader  smoothShader;
+    ofShader  readbackShader;
+    ofShader  drawShader;
+
+};
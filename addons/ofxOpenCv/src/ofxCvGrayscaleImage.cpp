@@ -243,8 +243,7 @@ void ofxCvGrayscaleImage::absDiff( ofxCvGrayscaleImage& mom ){
 	}	
 
     if( matchingROI(getROI(), mom.getROI()) ) {
-        cvAbsDiff( cvImage, mom.getCvImage(), cvImageTemp );
-        swapTemp();
+        cvAbsDiff( cvImage, mom.getCvImage(), cvImage );
         flagImageChanged();
     } else {
         ofLogError("ofxCvGrayscaleImage") << "absDiff(): region of interest mismatch";
@@ -395,8 +394,7 @@ void ofxCvGrayscaleImage::brightnessContrast(float brightness, float contrast){
 
 	//cvSetData( briConLutMatrix, briConLut, 0 );
 
-	cvLUT( cvImage, cvImageTemp, briConLutMatrix); 
-	swapTemp();
+	cvLUT( cvImage, cvImage, briConLutMatrix);
 	flagImageChanged();
 }
 
@@ -11,10 +11,42 @@ static bool sort_carea_compare( const ofxCvBlob & a, const ofxCvBlob & b) {
 	return (areaa > areab);
 }
 
+//--------------------------------------------------------------------------------
+static ofxCvBlob toBlob(const cv::Rect& r, int x, int y) {
+	ofxCvBlob blob;
+
+	float area = r.width * r.height;
+	float length = (r.width * 2) + (r.height * 2);
+	float centerx	= (r.x) + (r.width / 2.0);
+	float centery	= (r.y) + (r.height / 2.0);
+
+	blob.area = fabs(area);
+	blob.hole = area < 0 ? true : false;
+	blob.length	= length;
+	blob.boundingRect.x = r.x + x;
+	blob.boundingRect.y = r.y + y;
+	blob.boundingRect.width = r.width;
+	blob.boundingRect.height = r.height;
+	blob.centroid.x = centerx;
+	blob.centroid.y = centery;
+	blob.pts.push_back(ofPoint(r.x, r.y));
+	blob.pts.push_back(ofPoint(r.x + r.width, r.y));
+	blob.pts.push_back(ofPoint(r.x + r.width, r.y + r.height));
+	blob.pts.push_back(ofPoint(r.x, r.y + r.height));
+	return blob;
+}
+
 ofxCvHaarFinder::ofxCvHaarFinder() {
 	cascade = NULL;
 	scaleHaar = 1.08;
 	neighbors = 2;
+	bParallel = true;
+	rescanInterval = 0;
+	framesSinceScan = 0;
+	bAsync = false;
+	bNewBlobs = false;
+	pendingFullScan = false;
+	pendingPrevious = 0;
 	img.setUseTexture(false);
 }
 
@@ -22,15 +54,71 @@ ofxCvHaarFinder::ofxCvHaarFinder(const ofxCvHaarFinder& finder) {
 	cascade = NULL;
 	scaleHaar = finder.scaleHaar;
 	neighbors = finder.neighbors;
+	bParallel = finder.bParallel;
+	rescanInterval = finder.rescanInterval;
+	framesSinceScan = 0;
+	bAsync = finder.bAsync;
+	bNewBlobs = false;
+	pendingFullScan = false;
+	pendingPrevious = 0;
 	img.setUseTexture(false);
 	setup(finder.haarFile);
 }
 
+ofxCvHaarFinder& ofxCvHaarFinder::operator=(const ofxCvHaarFinder& finder) {
+	if(&finder == this) return *this;
+	if(pending.valid())
+		pending.wait();
+	pending = std::future<vector<ofxCvBlob>>();
+	blobs.clear();
+	scaleHaar = finder.scaleHaar;
+	neighbors = finder.neighbors;
+	bParallel = finder.bParallel;
+	rescanInterval = finder.rescanInterval;
+	framesSinceScan = 0;
+	bAsync = finder.bAsync;
+	bNewBlobs = false;
+	setup(finder.haarFile);
+	return *this;
+}
+
 ofxCvHaarFinder::~ofxCvHaarFinder() {
+	// the async detection uses the cascades and img
+	if(pending.valid())
+		pending.wait();
+	releaseCascades();
+}
+
+void ofxCvHaarFinder::releaseCascades() {
+	for(auto & copy: cascades)
+		cvReleaseHaarClassifierCascade(&copy);
+	cascades.clear();
+	freeCascades.clear();
 	if(cascade != NULL)
 		cvReleaseHaarClassifierCascade(&cascade);
 }
 
+// every parallel search takes a copy that isn't in use, loading a new one
+// the first time there are more searches at once than copies
+CvHaarClassifierCascade* ofxCvHaarFinder::acquireCascade() {
+	std::unique_lock<std::mutex> lock(cascadesMutex);
+	if(!freeCascades.empty()) {
+		CvHaarClassifierCascade* copy = freeCascades.back();
+		freeCascades.pop_back();
+		return copy;
+	}
+	CvHaarClassifierCascade* copy = (CvHaarClassifierCascade*) cvLoad(ofToDataPath(haarFile).c_str(), 0, 0, 0);
+	if(copy != NULL)
+		cascades.push_back(copy);
+	return copy;
+}
+
+void ofxCvHaarFinder::returnCascade(CvHaarClassifierCascade* copy) {
+	if(copy == NULL) return;
+	std::unique_lock<std::mutex> lock(cascadesMutex);
+	freeCascades.push_back(copy);
+}
+
 // low values	- more accurate - eg: 1.01
 // high values	- faster - eg: 1.06 or 1.09
 void ofxCvHaarFinder::setScaleHaar(float scaleHaar) {
@@ -43,9 +131,32 @@ void ofxCvHaarFinder::setNeighbors(unsigned neighbors) {
 	this->neighbors = neighbors;
 }
 
+void ofxCvHaarFinder::setParallel(bool parallel) {
+	bParallel = parallel;
+}
+
+void ofxCvHaarFinder::setTracking(int rescanInterval) {
+	this->rescanInterval = rescanInterval;
+	framesSinceScan = 0;
+}
+
+void ofxCvHaarFinder::setAsync(bool async) {
+	bAsync = async;
+}
+
+bool ofxCvHaarFinder::isDetecting() {
+	return pending.valid();
+}
+
+bool ofxCvHaarFinder::isFrameNew() {
+	return bNewBlobs;
+}
+
 void ofxCvHaarFinder::setup(string haarFile) {
-	if(cascade != NULL)
-		cvReleaseHaarClassifierCascade(&cascade);
+	if(pending.valid())
+		pending.wait();
+	pending = std::future<vector<ofxCvBlob>>();
+	releaseCascades();
 
 	this->haarFile = haarFile;
 
@@ -65,6 +176,8 @@ void ofxCvHaarFinder::setup(string haarFile) {
 
 	if (!cascade)
         ofLogError("ofxCvHaarFinder") << "setup(): couldn't load Haar cascade file: \"" << haarFile << "\"";
+	else
+		freeCascades.push_back(cascade);
 }
 
 
@@ -159,26 +272,154 @@ int ofxCvHaarFinder::findHaarObjects(const ofxCvGrayscaleImage& input,
 	int x, int y, int w, int h,
 	int minWidth, int minHeight) {
 
-	int nHaarResults = 0;
+	if (!cascade) {
+		bNewBlobs = false;
+		return 0;
+	}
+
+	if (!bAsync && !pending.valid()) {
+		prepare(input, x, y, w, h);
+		bool fullScan = isFullScan();
+		size_t previous = blobs.size();
+		blobs = detect(x, y, w, h, minWidth, minHeight, scaleHaar, neighbors, bParallel, blobs, fullScan);
+		scanned(fullScan, previous, blobs.size());
+		bNewBlobs = true;
+		return blobs.size();
+	}
+
+	// async, or the last async detection after switching to sync
+	bNewBlobs = false;
+	if (pending.valid()) {
+		if (bAsync && pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			return blobs.size();
+		}
+		blobs = pending.get();
+		scanned(pendingFullScan, pendingPrevious, blobs.size());
+		bNewBlobs = true;
+		if (!bAsync) {
+			return findHaarObjects(input, x, y, w, h, minWidth, minHeight);
+		}
+	}
+
+	// img isn't touched again until the detection finishes, the settings
+	// are copied so changing them doesn't affect it
+	prepare(input, x, y, w, h);
+	pendingFullScan = isFullScan();
+	pendingPrevious = blobs.size();
+	vector<ofxCvBlob> previous = blobs;
+	float scale = scaleHaar;
+	unsigned minNeighbors = neighbors;
+	bool parallel = bParallel;
+	bool fullScan = pendingFullScan;
+	pending = ofGetTaskPool().submit([=]{
+		return detect(x, y, w, h, minWidth, minHeight, scale, minNeighbors, parallel, previous, fullScan);
+	});
+	return blobs.size();
+}
 
-	if (cascade) {
-		if (!blobs.empty())
-			blobs.clear();
+void ofxCvHaarFinder::prepare(const ofxCvGrayscaleImage& input, int x, int y, int w, int h) {
+	// we make a copy of the input image here
+	// because we need to equalize it.
+
+	if (img.width == input.width && img.height == input.height) {
+			img.resetROI();
+			img = input;
+	} else {
+			img.clear();
+			img.allocate(input.width, input.height);
+			img = input;
+	}
+
+	img.setROI(x, y, w, h);
+	cvEqualizeHist(img.getCvImage(), img.getCvImage());
+}
+
+bool ofxCvHaarFinder::isFullScan() {
+	return rescanInterval <= 0 || blobs.empty() || framesSinceScan + 1 >= rescanInterval;
+}
+
+void ofxCvHaarFinder::scanned(bool fullScan, size_t previous, size_t found) {
+	if (fullScan) {
+		framesSinceScan = 0;
+	} else if (found < previous) {
+		// lost something, scan everything in the next frame
+		framesSinceScan = rescanInterval;
+	} else {
+		framesSinceScan++;
+	}
+}
 
-		// we make a copy of the input image here
-		// because we need to equalize it.
+vector<ofxCvBlob> ofxCvHaarFinder::detect(int x, int y, int w, int h,
+	int minWidth, int minHeight, float scale, unsigned minNeighbors,
+	bool parallel, const vector<ofxCvBlob>& previous, bool fullScan) {
+
+	// each search is a rectangle of the roi and a range of sizes
+	struct Search {
+		CvRect rect;
+		CvSize minSize;
+		CvSize maxSize;
+	};
+	vector<Search> searches;
+
+	if (fullScan) {
+		// the window sizes cvHaarDetectObjects goes through, with the cost
+		// of each one, to split them in ranges that take about the same
+		CvSize window = cascade->orig_window_size;
+		vector<CvSize> sizes;
+		vector<double> costs;
+		double total = 0;
+		for (double factor = 1; window.width * factor < w - 10 && window.height * factor < h - 10; factor *= scale) {
+			CvSize size = cvSize(cvRound(window.width * factor), cvRound(window.height * factor));
+			if (size.width < minWidth || size.height < minHeight) continue;
+			double step = std::max(2., factor);
+			sizes.push_back(size);
+			costs.push_back((w - size.width) / step * (h - size.height) / step);
+			total += costs.back();
+		}
 
-		if (img.width == input.width && img.height == input.height) {
-                img.resetROI();
-				img = input;
-		} else {
-				img.clear();
-				img.allocate(input.width, input.height);
-				img = input;
+		size_t numRanges = parallel ? ofGetTaskPool().getNumThreads() + 1 : 1;
+		double done = 0;
+		size_t first = 0;
+		for (size_t i = 0; i < sizes.size(); i++) {
+			done += costs[i];
+			bool last = i + 1 == sizes.size();
+			// the limits are inclusive so a range can't end between two equal sizes
+			bool distinct = last || sizes[i + 1].width != sizes[i].width || sizes[i + 1].height != sizes[i].height;
+			if (last || (distinct && done >= total * (searches.size() + 1) / numRanges)) {
+				searches.push_back({cvRect(0, 0, w, h), sizes[first], sizes[i]});
+				first = i + 1;
+			}
+		}
+	} else {
+		// around each object, from 2/3 to 3/2 of its size
+		for (auto & blob: previous) {
+			ofRectangle r = blob.boundingRect;
+			r.x -= x;
+			r.y -= y;
+			float margin = std::max(r.width, r.height) * 0.5;
+			int left = std::max(0, int(r.x - margin));
+			int top = std::max(0, int(r.y - margin));
+			int right = std::min(w, int(r.x + r.width + margin));
+			int bottom = std::min(h, int(r.y + r.height + margin));
+			CvSize minSize = cvSize(std::max(minWidth, int(r.width / 1.5)), std::max(minHeight, int(r.height / 1.5)));
+			CvSize maxSize = cvSize(std::max(minSize.width, int(r.width * 1.5)), std::max(minSize.height, int(r.height * 1.5)));
+			if (right - left > minSize.width && bottom - top > minSize.height) {
+				searches.push_back({cvRect(left, top, right - left, bottom - top), minSize, maxSize});
+			}
 		}
+	}
 
-		img.setROI(x, y, w, h);
-		cvEqualizeHist(img.getCvImage(), img.getCvImage());
+	// the candidates of all the searches are grouped together, like
+	// cvHaarDetectObjects does with the ones of a single search
+	vector<cv::Rect> found;
+	std::mutex foundMutex;
+	IplImage* image = img.getCvImage();
+	auto run = [&](const Search& search) {
+		CvHaarClassifierCascade* copy = acquireCascade();
+		if (copy == NULL) return;
+
+		CvMat region;
+		cvGetSubRect(image, &region, search.rect);
 		CvMemStorage* storage = cvCreateMemStorage();
 
 		/*
@@ -201,47 +442,43 @@ int ofxCvHaarFinder::findHaarObjects(const ofxCvGrayscaleImage& input,
 		*/
 
 		CvSeq* haarResults = cvHaarDetectObjects(
-				img.getCvImage(), cascade, storage, scaleHaar, neighbors, CV_HAAR_DO_CANNY_PRUNING,
-				cvSize(minWidth, minHeight));
-
-		nHaarResults = haarResults->total;
-
-		for (int i = 0; i < nHaarResults; i++ ) {
-			//ofLogNotice("ofxCvHaarFinder") << "findHaarObjects(): " << i << " objects";
-
-			ofxCvBlob blob;
+				&region, copy, storage, scale, 0, CV_HAAR_DO_CANNY_PRUNING,
+				search.minSize, search.maxSize);
+		returnCascade(copy);
 
+		std::unique_lock<std::mutex> lock(foundMutex);
+		for (int i = 0; i < haarResults->total; i++ ) {
 			CvRect* r = (CvRect*) cvGetSeqElem(haarResults, i);
-
-			float area = r->width * r->height;
-			float length = (r->width * 2) + (r->height * 2);
-			float centerx	= (r->x) + (r->width / 2.0);
-			float centery	= (r->y) + (r->height / 2.0);
-
-			blob.area = fabs(area);
-			blob.hole = area < 0 ? true : false;
-			blob.length	= length;
-			blob.boundingRect.x = r->x + x;
-			blob.boundingRect.y = r->y + y;
-			blob.boundingRect.width = r->width;
-			blob.boundingRect.height = r->height;
-			blob.centroid.x = centerx;
-			blob.centroid.y = centery;
-			blob.pts.push_back(ofPoint(r->x, r->y));
-			blob.pts.push_back(ofPoint(r->x + r->width, r->y));
-			blob.pts.push_back(ofPoint(r->x + r->width, r->y + r->height));
-			blob.pts.push_back(ofPoint(r->x, r->y + r->height));
-
-			blobs.push_back(blob);
+			found.push_back(cv::Rect(r->x + search.rect.x, r->y + search.rect.y, r->width, r->height));
 		}
-
-		// sort the pointers based on size
-		if( blobs.size() > 1 ) {
-			sort( blobs.begin(), blobs.end(), sort_carea_compare );
+		cvReleaseMemStorage(&storage);
+	};
+
+	if (parallel && searches.size() > 1) {
+		ofGetTaskPool().parallelFor(0, searches.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				run(searches[i]);
+			}
+		}, 1);
+	} else {
+		for (auto & search: searches) {
+			run(search);
 		}
+	}
 
-		cvReleaseMemStorage(&storage);
+	if (minNeighbors > 0) {
+		cv::groupRectangles(found, minNeighbors, 0.2);
+	}
+
+	vector<ofxCvBlob> results;
+	for (auto & r: found) {
+		results.push_back(toBlob(r, x, y));
+	}
+
+	// sort the pointers based on size
+	if( results.size() > 1 ) {
+		sort( results.begin(), results.end(), sort_carea_compare );
 	}
 
-	return nHaarResults;
+	return results;
 }
@@ -23,6 +23,7 @@ public:
 
 	ofxCvHaarFinder();
 	ofxCvHaarFinder(const ofxCvHaarFinder& finder);
+	ofxCvHaarFinder& operator=(const ofxCvHaarFinder& finder);
 	~ofxCvHaarFinder();
 	
 	void setup(string haarFile);
@@ -32,6 +33,22 @@ public:
 	// How many neighbors can be grouped into a face? Default value is 2. If set to 0, no grouping will be done.
 	void setNeighbors(unsigned neighbors);
 
+	// Splits the scales of the search in ranges that run in parallel in the
+	// ofTaskPool, each one with its own copy of the cascade. Same results, enabled by default.
+	void setParallel(bool parallel);
+	// Searches only around the objects found in the previous frame, at similar sizes,
+	// and scans the whole image again every rescanInterval frames or as soon as an
+	// object is lost. 0, the default, scans the whole image every frame.
+	void setTracking(int rescanInterval);
+	// findHaarObjects() returns right away with the objects of the last detection that
+	// finished and starts detecting on the new image if the worker is idle, frames that
+	// arrive while it's busy are skipped.
+	void setAsync(bool async);
+	// true while an async detection is running
+	bool isDetecting();
+	// true if the last call to findHaarObjects() updated the blobs, always in sync mode
+	bool isFrameNew();
+
 	int findHaarObjects(ofImage& input, int minWidth = 0, int minHeight = 0);
 	int findHaarObjects(const ofxCvGrayscaleImage& input, int minWidth = 0, int minHeight = 0);
 		
@@ -46,9 +63,34 @@ public:
 	void draw(float x, float y);
 
 protected:
+	void releaseCascades();
+	CvHaarClassifierCascade* acquireCascade();
+	void returnCascade(CvHaarClassifierCascade* cascade);
+	void prepare(const ofxCvGrayscaleImage& input, int x, int y, int w, int h);
+	bool isFullScan();
+	void scanned(bool fullScan, size_t previous, size_t found);
+	// searches the roi of img, the blobs' bounding rects are in image coordinates
+	// and their centroids and points relative to the roi, like they always were
+	vector<ofxCvBlob> detect(int x, int y, int w, int h, int minWidth, int minHeight,
+		float scaleHaar, unsigned neighbors, bool parallel, const vector<ofxCvBlob>& previous, bool fullScan);
+
 	CvHaarClassifierCascade* cascade;
 	string haarFile;
 	ofxCvGrayscaleImage img;
 	float scaleHaar;
 	unsigned neighbors;
+
+	// copies of the cascade for the parallel searches, cvHaarDetectObjects writes to it
+	vector<CvHaarClassifierCascade*> cascades;
+	vector<CvHaarClassifierCascade*> freeCascades;
+	std::mutex cascadesMutex;
+
+	bool bParallel;
+	int rescanInterval;
+	int framesSinceScan;
+	bool bAsync;
+	bool bNewBlobs;
+	std::future<vector<ofxCvBlob>> pending;
+	bool pendingFullScan;
+	size_t pendingPrevious;
 };
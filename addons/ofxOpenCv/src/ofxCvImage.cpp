@@ -15,6 +15,7 @@ ofxCvImage::ofxCvImage() {
     height			= 0;
     bUseTexture		= true;
     bTextureDirty   = true;
+    bTextureHasRoi  = false;
 	bAllocated		= false;
     bPixelsDirty    = true;
     bRoiPixelsDirty = true;
@@ -49,11 +50,8 @@ void ofxCvImage::allocate( int w, int h ) {
 	height = h;
 	bAllocated = true;
 
-    if( bUseTexture ) {
-    	allocatePixels(w,h);
-        allocateTexture();
-        bTextureDirty = true;
-    }
+    // the texture is allocated the first time it's needed, see updateTexture
+    flagImageChanged();
 }
 
 //--------------------------------------------------------------------------------
@@ -71,10 +69,9 @@ void ofxCvImage::clear() {
 		width = 0;
 		height = 0;
 
-		if( bUseTexture ) {
-			tex.clear();
-            bTextureDirty = true;
-		}
+		tex.clear();
+		bTextureDirty = true;
+		bTextureHasRoi = false;
 
 		bAllocated = false;
 	}
@@ -101,12 +98,15 @@ bool ofxCvImage::isUsingTexture() const{
 
 //--------------------------------------------------------------------------------
 ofTexture& ofxCvImage::getTexture() {
+	if( bAllocated && bUseTexture ) {
+		updateTexture();
+	}
 	return tex;
 }
 
 //--------------------------------------------------------------------------------
 const ofTexture & ofxCvImage::getTexture() const{
-	return tex;
+	return const_cast<ofxCvImage*>(this)->getTexture();
 }
 
 //--------------------------------------------------------------------------------
@@ -250,8 +250,7 @@ void ofxCvImage::operator -= ( float value ) {
 		ofLogError("ofxCvImage") << "operator-=: image not allocated";
 		return;		
 	}
-	cvSubS( cvImage, cvScalar(value), cvImageTemp );
-	swapTemp();
+	cvSubS( cvImage, cvScalar(value), cvImage );
     flagImageChanged();
 }
 
@@ -261,8 +260,7 @@ void ofxCvImage::operator += ( float value ) {
 		ofLogError("ofxCvImage") << "operator-=: image not allocated";
 		return;		
 	}
-	cvAddS( cvImage, cvScalar(value), cvImageTemp );
-	swapTemp();
+	cvAddS( cvImage, cvScalar(value), cvImage );
     flagImageChanged();
 }
 
@@ -283,8 +281,7 @@ void ofxCvImage::operator -= ( ofxCvImage& mom ) {
         mom.getCvImage()->depth == cvImage->depth )
     {
         if( matchingROI(getROI(), mom.getROI()) ) {
-            cvSub( cvImage, mom.getCvImage(), cvImageTemp );
-            swapTemp();
+            cvSub( cvImage, mom.getCvImage(), cvImage );
             flagImageChanged();
         } else {
             ofLogError("ofxCvImage") << "operator-=: region of interest mismatch";
@@ -310,8 +307,7 @@ void ofxCvImage::operator += ( ofxCvImage& mom ) {
         mom.getCvImage()->depth == cvImage->depth )
     {
         if( matchingROI(getROI(), mom.getROI()) ) {
-            cvAdd( cvImage, mom.getCvImage(), cvImageTemp );
-            swapTemp();
+            cvAdd( cvImage, mom.getCvImage(), cvImage );
             flagImageChanged();
         } else {
             ofLogError("ofxCvImage") << "operator+=: region of interest mismatch";
@@ -338,8 +334,7 @@ void ofxCvImage::operator *= ( ofxCvImage& mom ) {
     {
         if( matchingROI(getROI(), mom.getROI()) ) {
             float scalef = 1.0f / 255.0f;
-            cvMul( cvImage, mom.getCvImage(), cvImageTemp, scalef );
-            swapTemp();
+            cvMul( cvImage, mom.getCvImage(), cvImage, scalef );
             flagImageChanged();
         } else {
             ofLogError("ofxCvImage") << "operator*=: region of interest mismatch";
@@ -365,8 +360,7 @@ void ofxCvImage::operator &= ( ofxCvImage& mom ) {
         mom.getCvImage()->depth == cvImage->depth )
     {
         if( matchingROI(getROI(), mom.getROI()) ) {
-            cvAnd( cvImage, mom.getCvImage(), cvImageTemp );
-            swapTemp();
+            cvAnd( cvImage, mom.getCvImage(), cvImage );
             flagImageChanged();
         } else {
             ofLogError("ofxCvImage") << "operator&=: region of interest mismatch";
@@ -415,14 +409,27 @@ void ofxCvImage::draw(const ofRectangle & rect) const{
 }
 
 
+//--------------------------------------------------------------------------------
+void ofxCvImage::allocateTextureIfNeeded(){
+	if( !tex.isAllocated() || tex.getWidth() != width || tex.getHeight() != height ) {
+		allocatePixels(width,height);
+		allocateTexture();
+		// the pixels were reallocated to get the texture format from them
+		// so they don't point to the image anymore
+		flagImageChanged();
+	}
+}
+
 //--------------------------------------------------------------------------------
 void ofxCvImage::updateTexture(){
 	if(!bAllocated) {
 		ofLogWarning("ofxCvImage") << "updateTexture(): image not allocated";	
 	} else if(bUseTexture ) {
-		if( bTextureDirty ) {
+		allocateTextureIfNeeded();
+		if( bTextureDirty || bTextureHasRoi ) {
 			tex.loadData( getPixels() );
 			bTextureDirty = false;
+			bTextureHasRoi = false;
 		}
 	}
 }
@@ -444,11 +451,14 @@ void ofxCvImage::drawROI( float x, float y ) const {
 
 //--------------------------------------------------------------------------------
 void ofxCvImage::drawROI( float x, float y, float w, float h ) const {
-    if( bUseTexture ) {
+    if( bUseTexture && bAllocated ) {
         ofRectangle roi = getROI();
-        if( bTextureDirty ) {
-            tex.loadData( getRoiPixels() );
+        ofxCvImage* mutImage = const_cast<ofxCvImage*>(this);
+        mutImage->allocateTextureIfNeeded();
+        if( bTextureDirty || !bTextureHasRoi ) {
+            tex.loadData( mutImage->getRoiPixels() );
             bTextureDirty = false;
+            bTextureHasRoi = true;
         }
 
         tex.drawSubsection(x,y, w,h,0,0,roi.width,roi.height);
@@ -501,8 +511,7 @@ void ofxCvImage::dilate() {
 		ofLogError("ofxCvImage") << "dilate(): image not allocated";
 		return;		
 	}
-	cvDilate( cvImage, cvImageTemp, 0, 1 );
-	swapTemp();
+	cvDilate( cvImage, cvImage, 0, 1 );
     flagImageChanged();
 }
 
@@ -512,8 +521,7 @@ void ofxCvImage::erode() {
 		ofLogError("ofxCvImage") << "erode(): image not allocated";
 		return;		
 	}
-	cvErode( cvImage, cvImageTemp, 0, 1 );
-	swapTemp();
+	cvErode( cvImage, cvImage, 0, 1 );
     flagImageChanged();
 }
 
@@ -527,8 +535,7 @@ void ofxCvImage::blur( int value ) {
         ofLogNotice("ofxCvImage") << "blur(): value " << value << " not odd, adding 1";
         value++;
     }
-	cvSmooth( cvImage, cvImageTemp, CV_BLUR , value);
-	swapTemp();
+	cvSmooth( cvImage, cvImage, CV_BLUR , value);
     flagImageChanged();
 }
 
@@ -542,8 +549,7 @@ void ofxCvImage::blurGaussian( int value ) {
         ofLogNotice("ofxCvImage") << "blurGaussian(): value " << value << " not odd, adding 1";
         value++;
     }
-	cvSmooth( cvImage, cvImageTemp, CV_GAUSSIAN ,value );
-	swapTemp();
+	cvSmooth( cvImage, cvImage, CV_GAUSSIAN ,value );
     flagImageChanged();
 }
 
@@ -575,8 +581,7 @@ void ofxCvImage::mirror( bool bFlipVertically, bool bFlipHorizontally ) {
 	else if( bFlipVertically && bFlipHorizontally ) flipMode = -1;
 	else return;
 
-	cvFlip( cvImage, cvImageTemp, flipMode );
-	swapTemp();
+	cvFlip( cvImage, nullptr, flipMode );
     flagImageChanged();
 }
 
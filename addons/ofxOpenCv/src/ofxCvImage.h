@@ -156,6 +156,7 @@ class ofxCvImage : public ofBaseImage {
 
     virtual void allocateTexture() = 0;
     virtual void allocatePixels(int w, int h) = 0;
+    void allocateTextureIfNeeded();
     bool matchingROI( const ofRectangle& rec1, const ofRectangle& rec2 );
     virtual void  setImageROI( IplImage* img, const ofRectangle& rect );
     virtual void  resetImageROI( IplImage* img );
@@ -164,7 +165,9 @@ class ofxCvImage : public ofBaseImage {
     virtual void  rangeMap( IplImage* mom, IplImage* kid, float min1, float max1, float min2, float max2 );
                                      
     virtual void swapTemp();  // swap cvImageTemp back
-                              // to cvImage after an image operation
+                              // to cvImage after an image operation,
+                              // operations that opencv can do in place
+                              // write directly to cvImage instead
     virtual IplImage*  getCv8BitsImage() { return cvImage; }
     virtual IplImage*  getCv8BitsRoiImage() { return cvImage; }
                           
@@ -184,6 +187,7 @@ class ofxCvImage : public ofBaseImage {
     // to allow draw to be const we mark the texture as mutable
     mutable ofTexture  tex;		      // internal tex
     mutable bool bTextureDirty;       // texture needs to be reloaded before drawing
+    mutable bool bTextureHasRoi;      // texture only has the roi, loaded by drawROI
     bool bUseTexture;
     
     ofPoint  anchor;
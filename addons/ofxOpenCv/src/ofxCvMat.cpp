@@ -0,0 +1,397 @@
+#include "ofxCvMat.h"
+
+namespace{
+	template<typename PixelType>
+	int cvDepth();
+
+	template<>
+	int cvDepth<unsigned char>(){
+		return CV_8U;
+	}
+
+	template<>
+	int cvDepth<unsigned short>(){
+		return CV_16U;
+	}
+
+	template<>
+	int cvDepth<float>(){
+		return CV_32F;
+	}
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+cv::Mat ofxCvToMat(ofPixels_<PixelType> & pixels){
+	if(!pixels.isAllocated()){
+		return cv::Mat();
+	}
+	return cv::Mat(int(pixels.getHeight()), int(pixels.getWidth()),
+		CV_MAKETYPE(cvDepth<PixelType>(), int(pixels.getNumChannels())),
+		pixels.getData(), pixels.getBytesStride());
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+ofxCvMat_<PixelType>::ofxCvMat_(){
+	residency = Synced;
+	bUseOpenCL = false;
+	bUseTexture = true;
+	bTextureDirty = true;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::allocate(size_t w, size_t h, size_t channels){
+	if(pixels.isAllocated() && pixels.getWidth() == w && pixels.getHeight() == h && pixels.getNumChannels() == channels){
+		return;
+	}
+	pixels.allocate(w, h, channels);
+	wrapPixels();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::clear(){
+	pixels.clear();
+	mat.release();
+#ifdef OFX_CV_HAS_UMAT
+	umat.release();
+#endif
+	tex.clear();
+	residency = Synced;
+	bTextureDirty = true;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+bool ofxCvMat_<PixelType>::isAllocated() const{
+	return pixels.isAllocated();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::setFromPixels(const ofPixels_<PixelType> & src){
+	if(!src.isAllocated()){
+		ofLogError("ofxCvMat") << "setFromPixels(): source pixels not allocated";
+		return;
+	}
+	allocate(src.getWidth(), src.getHeight(), src.getNumChannels());
+	// copies into the wrapped memory, pixels = src would reallocate it
+	ofxCvToMat(const_cast<ofPixels_<PixelType>&>(src)).copyTo(getMat());
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::wrap(ofPixels_<PixelType> & src){
+	if(!src.isAllocated()){
+		ofLogError("ofxCvMat") << "wrap(): source pixels not allocated";
+		return;
+	}
+	pixels.setFromExternalPixels(src.getData(), src.getWidth(), src.getHeight(), src.getNumChannels());
+	wrapPixels();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::wrapPixels(){
+	mat = ofxCvToMat(pixels);
+#ifdef OFX_CV_HAS_UMAT
+	umat.release();
+#endif
+	residency = HostNewer;
+	bTextureDirty = true;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::setUseOpenCL(bool bUse){
+#ifdef OFX_CV_HAS_UMAT
+	if(bUse && !cv::ocl::haveOpenCL()){
+		ofLogWarning("ofxCvMat") << "setUseOpenCL(): OpenCL is not available, using the cpu";
+		bUse = false;
+	}
+	if(!bUse){
+		syncToHost();
+		umat.release();
+		residency = HostNewer;
+	}
+	bUseOpenCL = bUse;
+#else
+	if(bUse){
+		ofLogWarning("ofxCvMat") << "setUseOpenCL(): OpenCL needs OpenCV 3 or newer, using the cpu";
+	}
+#endif
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+bool ofxCvMat_<PixelType>::isUsingOpenCL() const{
+	return bUseOpenCL;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::syncToHost() const{
+#ifdef OFX_CV_HAS_UMAT
+	if(residency == DeviceNewer){
+		// mat has the same size and type so this downloads straight into
+		// the memory of the pixels
+		umat.copyTo(mat);
+		residency = Synced;
+	}
+#endif
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+cv::Mat & ofxCvMat_<PixelType>::getMat(){
+	syncToHost();
+	residency = HostNewer;
+	flagImageChanged();
+	return mat;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+const cv::Mat & ofxCvMat_<PixelType>::getMat() const{
+	syncToHost();
+	return mat;
+}
+
+#ifdef OFX_CV_HAS_UMAT
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+cv::UMat & ofxCvMat_<PixelType>::getUMat(){
+	if(residency == HostNewer){
+		mat.copyTo(umat);
+	}
+	residency = DeviceNewer;
+	flagImageChanged();
+	return umat;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+const cv::UMat & ofxCvMat_<PixelType>::getUMat() const{
+	if(residency == HostNewer){
+		mat.copyTo(umat);
+		residency = Synced;
+	}
+	return umat;
+}
+#endif
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+typename ofxCvMat_<PixelType>::Array ofxCvMat_<PixelType>::getArray(){
+#ifdef OFX_CV_HAS_UMAT
+	if(bUseOpenCL){
+		return getUMat();
+	}
+#endif
+	return getMat();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+cv::_InputArray ofxCvMat_<PixelType>::getArray() const{
+#ifdef OFX_CV_HAS_UMAT
+	if(bUseOpenCL){
+		return getUMat();
+	}
+#endif
+	return getMat();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+ofPixels_<PixelType> & ofxCvMat_<PixelType>::getPixels(){
+	getMat();
+	return pixels;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+const ofPixels_<PixelType> & ofxCvMat_<PixelType>::getPixels() const{
+	syncToHost();
+	return pixels;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::setUseTexture(bool bUse){
+	bUseTexture = bUse;
+	if(!bUse){
+		tex.clear();
+	}
+	bTextureDirty = true;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+bool ofxCvMat_<PixelType>::isUsingTexture() const{
+	return bUseTexture;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::uploadTexture() const{
+	if(!bUseTexture || !bTextureDirty || !pixels.isAllocated()){
+		return;
+	}
+	syncToHost();
+	if(!tex.isAllocated() || tex.getWidth() != pixels.getWidth() || tex.getHeight() != pixels.getHeight()){
+		tex.allocate(pixels);
+	}
+	tex.loadData(pixels);
+	bTextureDirty = false;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+ofTexture & ofxCvMat_<PixelType>::getTexture(){
+	uploadTexture();
+	return tex;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+const ofTexture & ofxCvMat_<PixelType>::getTexture() const{
+	uploadTexture();
+	return tex;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::flagImageChanged(){
+	bTextureDirty = true;
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+float ofxCvMat_<PixelType>::getWidth() const{
+	return pixels.getWidth();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+float ofxCvMat_<PixelType>::getHeight() const{
+	return pixels.getHeight();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+size_t ofxCvMat_<PixelType>::getNumChannels() const{
+	return pixels.getNumChannels();
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::draw(float x, float y, float w, float h) const{
+	if(!bUseTexture){
+		return;
+	}
+	uploadTexture();
+	if(tex.isAllocated()){
+		tex.draw(x, y, w, h);
+	}
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::set(float value){
+	if(!isAllocated()){
+		ofLogError("ofxCvMat") << "set(): image not allocated";
+		return;
+	}
+#ifdef OFX_CV_HAS_UMAT
+	if(bUseOpenCL){
+		getUMat().setTo(cv::Scalar::all(value));
+		return;
+	}
+#endif
+	getMat().setTo(cv::Scalar::all(value));
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::threshold(float value, bool bInvert){
+	if(!isAllocated()){
+		ofLogError("ofxCvMat") << "threshold(): image not allocated";
+		return;
+	}
+	Array array = getArray();
+	cv::threshold(array, array, value, ofColor_<PixelType>::limit(), bInvert ? cv::THRESH_BINARY_INV : cv::THRESH_BINARY);
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::absDiff(const ofxCvMat_<PixelType> & other){
+	if(!isAllocated()){
+		ofLogError("ofxCvMat") << "absDiff(): image not allocated";
+		return;
+	}
+	if(other.getWidth() != getWidth() || other.getHeight() != getHeight() || other.getNumChannels() != getNumChannels()){
+		ofLogError("ofxCvMat") << "absDiff(): images need to be the same size and number of channels";
+		return;
+	}
+	Array array = getArray();
+	cv::absdiff(array, other.getArray(), array);
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::blur(int size){
+	if(!isAllocated()){
+		ofLogError("ofxCvMat") << "blur(): image not allocated";
+		return;
+	}
+	Array array = getArray();
+	cv::blur(array, array, cv::Size(size, size));
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::blurGaussian(int size){
+	if(!isAllocated()){
+		ofLogError("ofxCvMat") << "blurGaussian(): image not allocated";
+		return;
+	}
+	if(size % 2 == 0){
+		ofLogNotice("ofxCvMat") << "blurGaussian(): value " << size << " not odd, adding 1";
+		size++;
+	}
+	Array array = getArray();
+	cv::GaussianBlur(array, array, cv::Size(size, size), 0);
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::dilate(int iterations){
+	if(!isAllocated()){
+		ofLogError("ofxCvMat") << "dilate(): image not allocated";
+		return;
+	}
+	Array array = getArray();
+	cv::dilate(array, array, cv::Mat(), cv::Point(-1, -1), iterations);
+}
+
+//--------------------------------------------------------------------------------
+template<typename PixelType>
+void ofxCvMat_<PixelType>::erode(int iterations){
+	if(!isAllocated()){
+		ofLogError("ofxCvMat") << "erode(): image not allocated";
+		return;
+	}
+	Array array = getArray();
+	cv::erode(array, array, cv::Mat(), cv::Point(-1, -1), iterations);
+}
+
+template class ofxCvMat_<unsigned char>;
+template class ofxCvMat_<unsigned short>;
+template class ofxCvMat_<float>;
+
+template cv::Mat ofxCvToMat(ofPixels_<unsigned char> & pixels);
+template cv::Mat ofxCvToMat(ofPixels_<unsigned short> & pixels);
+template cv::Mat ofxCvToMat(ofPixels_<float> & pixels);
@@ -0,0 +1,138 @@
+/*
+* ofxCvMat.h
+*
+* Image backed by a cv::Mat instead of an IplImage so it can use the
+* OpenCV C++ api, which is multithreaded and can run on the gpu through
+* OpenCL. The cv::Mat always points to the memory of the ofPixels so
+* there are no copies between the two, with wrap() it can even point to
+* the memory of someone else's ofPixels.
+*
+* With setUseOpenCL(true) the data lives in a cv::UMat and stays on the
+* gpu between operations, it's only downloaded when the pixels, the
+* cv::Mat or the texture are needed.
+*
+*/
+
+#pragma once
+
+#include "ofxCvConstants.h"
+#include "opencv2/core/core.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+// cv::UMat and the transparent OpenCL api are only in OpenCV 3 and newer,
+// 2.4 defines CV_VERSION_EPOCH as 2 and CV_VERSION_MAJOR as 4
+#if !defined(CV_VERSION_EPOCH) && CV_VERSION_MAJOR >= 3
+	#define OFX_CV_HAS_UMAT
+	#include "opencv2/core/ocl.hpp"
+#endif
+
+template<typename PixelType>
+class ofxCvMat_ : public ofBaseDraws {
+  public:
+#ifdef OFX_CV_HAS_UMAT
+	typedef cv::_InputOutputArray Array;
+#else
+	typedef cv::_OutputArray Array;
+#endif
+
+	ofxCvMat_();
+
+	void allocate(size_t w, size_t h, size_t channels);
+	void clear();
+	bool isAllocated() const;
+
+	/// \brief Copies pixels into this image, allocating it if the size
+	/// or the number of channels are different
+	void setFromPixels(const ofPixels_<PixelType> & pixels);
+
+	/// \brief Uses the memory of pixels without copying it, pixels have
+	/// to be kept allocated while this image uses them
+	void wrap(ofPixels_<PixelType> & pixels);
+
+	/// \brief Keeps the data in a cv::UMat so operations run through
+	/// OpenCL, does nothing if OpenCL is not available
+	void setUseOpenCL(bool bUse);
+	bool isUsingOpenCL() const;
+
+	/// \brief The cv::Mat of the pixels, downloads them first if the gpu
+	/// has a newer version. The non const version flags the image as
+	/// changed since it's usually called to modify it
+	cv::Mat & getMat();
+	const cv::Mat & getMat() const;
+#ifdef OFX_CV_HAS_UMAT
+	/// \brief The cv::UMat of the image, uploads the pixels first if
+	/// they were modified since the last upload
+	cv::UMat & getUMat();
+	const cv::UMat & getUMat() const;
+#endif
+
+	/// \brief The cv::UMat when using OpenCL or the cv::Mat otherwise,
+	/// to pass to any cv:: function without caring where the data is:
+	///
+	/// ~~~~{.cpp}
+	/// cv::Canny(gray.getArray(), edges.getArray(), 50, 150);
+	/// ~~~~
+	Array getArray();
+	cv::_InputArray getArray() const;
+
+	ofPixels_<PixelType> & getPixels();
+	const ofPixels_<PixelType> & getPixels() const;
+
+	void setUseTexture(bool bUse);
+	bool isUsingTexture() const;
+	/// \brief The texture is allocated and uploaded the first time it's
+	/// needed after the image changes
+	ofTexture & getTexture();
+	const ofTexture & getTexture() const;
+
+	/// \brief Call after modifying the data through a cv::Mat or
+	/// cv::UMat obtained before, so the texture is uploaded again
+	void flagImageChanged();
+
+	float getWidth() const;
+	float getHeight() const;
+	size_t getNumChannels() const;
+
+	using ofBaseDraws::draw;
+	void draw(float x, float y, float w, float h) const;
+
+	// image processing, runs on the gpu when using OpenCL
+	void set(float value);
+	void threshold(float value, bool bInvert = false);
+	void absDiff(const ofxCvMat_<PixelType> & other);
+	void blur(int size = 3);
+	void blurGaussian(int size = 3);
+	void dilate(int iterations = 1);
+	void erode(int iterations = 1);
+
+  private:
+	void wrapPixels();
+	void syncToHost() const;
+	void uploadTexture() const;
+
+	enum Residency{
+		Synced,
+		HostNewer,
+		DeviceNewer,
+	};
+
+	ofPixels_<PixelType> pixels;
+	mutable cv::Mat mat;
+#ifdef OFX_CV_HAS_UMAT
+	mutable cv::UMat umat;
+#endif
+	mutable Residency residency;
+	bool bUseOpenCL;
+
+	mutable ofTexture tex;
+	bool bUseTexture;
+	mutable bool bTextureDirty;
+};
+
+typedef ofxCvMat_<unsigned char> ofxCvMat;
+typedef ofxCvMat_<unsigned short> ofxCvShortMat;
+typedef ofxCvMat_<float> ofxCvFloatMat;
+
+/// \brief A cv::Mat that uses the memory of pixels without copying it
+template<typename PixelType>
+cv::Mat ofxCvToMat(ofPixels_<PixelType> & pixels);
@@ -11,9 +11,16 @@
 #include "ofxCvColorImage.h"
 #include "ofxCvFloatImage.h"
 #include "ofxCvShortImage.h"
+#include "ofxCvMat.h"
 
 //--------------------------
 // contours and blobs
 #include "ofxCvContourFinder.h"
+#include "ofxCvGpuBlobFinder.h"
+#include "ofxCvBlobTracker.h"
+
+//--------------------------
+// motion
+#include "ofxCvGpuOpticalFlow.h"
 
 #include "ofxCvHaarFinder.h"
@@ -104,6 +104,12 @@ public:
 	// operating systems.
 	void SetAllowReuse( bool allowReuse );
 
+	// Sets SO_RCVBUF, the datagrams the system keeps while they aren't
+	// read. The system might cap it, the size it's really using is returned
+	// by GetReceiveBufferSize().
+	void SetReceiveBufferSize( int bufferSize );
+	int GetReceiveBufferSize() const;
+
 
 	// The socket is created in an unbound, unconnected state
 	// such a socket can only be used to send to an arbitrary
@@ -150,6 +150,19 @@ public:
 #endif
 	}
 
+	void SetReceiveBufferSize( int bufferSize )
+	{
+		setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+	}
+
+	int GetReceiveBufferSize() const
+	{
+		int bufferSize = 0;
+		socklen_t length = sizeof(bufferSize);
+		getsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &bufferSize, &length);
+		return bufferSize;
+	}
+
 	IpEndpointName LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
 	{
 		assert( isBound_ );
@@ -288,6 +301,16 @@ void UdpSocket::SetAllowReuse( bool allowReuse )
     impl_->SetAllowReuse( allowReuse );
 }
 
+void UdpSocket::SetReceiveBufferSize( int bufferSize )
+{
+    impl_->SetReceiveBufferSize( bufferSize );
+}
+
+int UdpSocket::GetReceiveBufferSize() const
+{
+    return impl_->GetReceiveBufferSize();
+}
+
 IpEndpointName UdpSocket::LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
 {
 	return impl_->LocalEndpointFor( remoteEndpoint );
@@ -144,6 +144,19 @@ public:
 		setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof(reuseAddr));
 	}
 
+	void SetReceiveBufferSize( int bufferSize )
+	{
+		setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, (const char*)&bufferSize, sizeof(bufferSize));
+	}
+
+	int GetReceiveBufferSize() const
+	{
+		int bufferSize = 0;
+		int length = sizeof(bufferSize);
+		getsockopt(socket_, SOL_SOCKET, SO_RCVBUF, (char*)&bufferSize, &length);
+		return bufferSize;
+	}
+
 	IpEndpointName LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
 	{
 		assert( isBound_ );
@@ -281,6 +294,16 @@ void UdpSocket::SetAllowReuse( bool allowReuse )
     impl_->SetAllowReuse( allowReuse );
 }
 
+void UdpSocket::SetReceiveBufferSize( int bufferSize )
+{
+    impl_->SetReceiveBufferSize( bufferSize );
+}
+
+int UdpSocket::GetReceiveBufferSize() const
+{
+    return impl_->GetReceiveBufferSize();
+}
+
 IpEndpointName UdpSocket::LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
 {
 	return impl_->LocalEndpointFor( remoteEndpoint );
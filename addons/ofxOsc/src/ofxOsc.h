@@ -4,5 +4,6 @@
 
 #include "ofxOscArg.h"
 #include "ofxOscMessage.h"
+#include "ofxOscPackedMessage.h"
 #include "ofxOscSender.h"
 #include "ofxOscReceiver.h"
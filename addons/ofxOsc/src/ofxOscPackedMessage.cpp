@@ -0,0 +1,323 @@
+// copyright (c) openFrameworks team 2010-2017
+#include "ofxOscPackedMessage.h"
+#include "ofLog.h"
+
+using namespace std;
+
+//--------------------------------------------------------------
+bool ofxOscPackedMessage::set(const osc::ReceivedMessage &m, const osc::IpEndpointName &remoteEndpoint){
+	clear();
+
+	remoteEndpoint.AddressAsString(remoteHost);
+	remotePort = remoteEndpoint.port;
+
+	const char * address = m.AddressPattern();
+	data.insert(data.end(), address, address + strlen(address) + 1);
+	typeTagsOffset = data.size();
+	data.insert(data.end(), m.TypeTags(), m.TypeTags() + m.ArgumentCount());
+	data.push_back(0);
+
+	for(osc::ReceivedMessage::const_iterator arg = m.ArgumentsBegin(); arg != m.ArgumentsEnd(); ++arg){
+		offsets.push_back(uint32_t(data.size()));
+		switch(arg->TypeTag()){
+			case OFXOSC_TYPE_INT32:
+				write(arg->AsInt32Unchecked());
+				break;
+			case OFXOSC_TYPE_INT64:
+				write(arg->AsInt64Unchecked());
+				break;
+			case OFXOSC_TYPE_FLOAT:
+				write(arg->AsFloatUnchecked());
+				break;
+			case OFXOSC_TYPE_DOUBLE:
+				write(arg->AsDoubleUnchecked());
+				break;
+			case OFXOSC_TYPE_STRING:
+			case OFXOSC_TYPE_SYMBOL:{
+				const char * str = arg->AsStringUnchecked();
+				data.insert(data.end(), str, str + strlen(str) + 1);
+				break;
+			}
+			case OFXOSC_TYPE_CHAR:
+				data.push_back(arg->AsCharUnchecked());
+				break;
+			case OFXOSC_TYPE_MIDI_MESSAGE:
+				write(arg->AsMidiMessageUnchecked());
+				break;
+			case OFXOSC_TYPE_RGBA_COLOR:
+				write(arg->AsRgbaColorUnchecked());
+				break;
+			case OFXOSC_TYPE_TIMETAG:
+				write(arg->AsTimeTagUnchecked());
+				break;
+			case OFXOSC_TYPE_BLOB:{
+				const char * dataPtr;
+				osc::osc_bundle_element_size_t len = 0;
+				arg->AsBlobUnchecked((const void*&)dataPtr, len);
+				write(uint32_t(len));
+				data.insert(data.end(), dataPtr, dataPtr + len);
+				break;
+			}
+			case OFXOSC_TYPE_TRUE:
+			case OFXOSC_TYPE_FALSE:
+			case OFXOSC_TYPE_NONE:
+			case OFXOSC_TYPE_TRIGGER:
+				// no value
+				break;
+			default:
+				ofLogError("ofxOscPackedMessage") << "set(): argument in message "
+					<< address << " is an unknown type "
+					<< (int) arg->TypeTag() << " '" << (char) arg->TypeTag() << "'";
+				// keep the arguments before it
+				offsets.pop_back();
+				data[typeTagsOffset + offsets.size()] = 0;
+				return false;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxOscPackedMessage::clear(){
+	data.clear();
+	offsets.clear();
+	typeTagsOffset = 0;
+	remoteHost[0] = 0;
+	remotePort = 0;
+}
+
+//--------------------------------------------------------------
+const char * ofxOscPackedMessage::getAddress() const{
+	return data.empty() ? "" : data.data();
+}
+
+//--------------------------------------------------------------
+const char * ofxOscPackedMessage::getRemoteHost() const{
+	return remoteHost;
+}
+
+//--------------------------------------------------------------
+int ofxOscPackedMessage::getRemotePort() const{
+	return remotePort;
+}
+
+//--------------------------------------------------------------
+size_t ofxOscPackedMessage::getNumArgs() const{
+	return offsets.size();
+}
+
+//--------------------------------------------------------------
+const char * ofxOscPackedMessage::getTypeString() const{
+	return data.empty() ? "" : data.data() + typeTagsOffset;
+}
+
+//--------------------------------------------------------------
+ofxOscArgType ofxOscPackedMessage::getArgType(size_t index) const{
+	if(index >= offsets.size()){
+		return OFXOSC_TYPE_INDEXOUTOFBOUNDS;
+	}
+	return ofxOscArgType(data[typeTagsOffset + index]);
+}
+
+//--------------------------------------------------------------
+template<typename T>
+T ofxOscPackedMessage::read(size_t index) const{
+	// memcpy, arguments aren't aligned
+	T value;
+	memcpy(&value, data.data() + offsets[index], sizeof(T));
+	return value;
+}
+
+//--------------------------------------------------------------
+template<typename T>
+void ofxOscPackedMessage::write(const T &value){
+	const char * bytes = (const char*)&value;
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+//--------------------------------------------------------------
+bool ofxOscPackedMessage::checkIndex(size_t index, const char * method) const{
+	if(index >= offsets.size()){
+		ofLogError("ofxOscPackedMessage") << method << "(): index "
+			<< index << " out of bounds";
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------
+double ofxOscPackedMessage::getArgAsNumber(size_t index, const char * method) const{
+	if(!checkIndex(index, method)){
+		return 0;
+	}
+	switch(getArgType(index)){
+		case OFXOSC_TYPE_INT32: return read<int32_t>(index);
+		case OFXOSC_TYPE_INT64: return double(read<int64_t>(index));
+		case OFXOSC_TYPE_FLOAT: return read<float>(index);
+		case OFXOSC_TYPE_DOUBLE: return read<double>(index);
+		case OFXOSC_TYPE_TRUE: return 1;
+		case OFXOSC_TYPE_FALSE: return 0;
+		default:
+			ofLogError("ofxOscPackedMessage") << method << "(): argument "
+				<< index << " is not a number";
+			return 0;
+	}
+}
+
+//--------------------------------------------------------------
+int32_t ofxOscPackedMessage::getArgAsInt32(size_t index) const{
+	if(getArgType(index) == OFXOSC_TYPE_INT32){
+		return read<int32_t>(index);
+	}
+	return int32_t(getArgAsNumber(index, "getArgAsInt32"));
+}
+
+//--------------------------------------------------------------
+int64_t ofxOscPackedMessage::getArgAsInt64(size_t index) const{
+	if(getArgType(index) == OFXOSC_TYPE_INT64){
+		return read<int64_t>(index);
+	}
+	return int64_t(getArgAsNumber(index, "getArgAsInt64"));
+}
+
+//--------------------------------------------------------------
+float ofxOscPackedMessage::getArgAsFloat(size_t index) const{
+	if(getArgType(index) == OFXOSC_TYPE_FLOAT){
+		return read<float>(index);
+	}
+	return float(getArgAsNumber(index, "getArgAsFloat"));
+}
+
+//--------------------------------------------------------------
+double ofxOscPackedMessage::getArgAsDouble(size_t index) const{
+	return getArgAsNumber(index, "getArgAsDouble");
+}
+
+//--------------------------------------------------------------
+bool ofxOscPackedMessage::getArgAsBool(size_t index) const{
+	return getArgAsNumber(index, "getArgAsBool") != 0;
+}
+
+//--------------------------------------------------------------
+const char * ofxOscPackedMessage::getArgAsString(size_t index) const{
+	auto type = getArgType(index);
+	if(type != OFXOSC_TYPE_STRING && type != OFXOSC_TYPE_SYMBOL){
+		ofLogError("ofxOscPackedMessage") << "getArgAsString(): argument "
+			<< index << " is not a string";
+		return "";
+	}
+	return data.data() + offsets[index];
+}
+
+//--------------------------------------------------------------
+char ofxOscPackedMessage::getArgAsChar(size_t index) const{
+	if(getArgType(index) != OFXOSC_TYPE_CHAR){
+		ofLogError("ofxOscPackedMessage") << "getArgAsChar(): argument "
+			<< index << " is not a char";
+		return 0;
+	}
+	return data[offsets[index]];
+}
+
+//--------------------------------------------------------------
+uint32_t ofxOscPackedMessage::getArgAsMidiMessage(size_t index) const{
+	if(getArgType(index) != OFXOSC_TYPE_MIDI_MESSAGE){
+		ofLogError("ofxOscPackedMessage") << "getArgAsMidiMessage(): argument "
+			<< index << " is not a midi message";
+		return 0;
+	}
+	return read<uint32_t>(index);
+}
+
+//--------------------------------------------------------------
+uint64_t ofxOscPackedMessage::getArgAsTimetag(size_t index) const{
+	if(getArgType(index) != OFXOSC_TYPE_TIMETAG){
+		ofLogError("ofxOscPackedMessage") << "getArgAsTimetag(): argument "
+			<< index << " is not a timetag";
+		return 0;
+	}
+	return read<uint64_t>(index);
+}
+
+//--------------------------------------------------------------
+uint32_t ofxOscPackedMessage::getArgAsRgbaColor(size_t index) const{
+	if(getArgType(index) != OFXOSC_TYPE_RGBA_COLOR){
+		ofLogError("ofxOscPackedMessage") << "getArgAsRgbaColor(): argument "
+			<< index << " is not a color";
+		return 0;
+	}
+	return read<uint32_t>(index);
+}
+
+//--------------------------------------------------------------
+const char * ofxOscPackedMessage::getArgAsBlob(size_t index, size_t &size) const{
+	if(getArgType(index) != OFXOSC_TYPE_BLOB){
+		ofLogError("ofxOscPackedMessage") << "getArgAsBlob(): argument "
+			<< index << " is not a blob";
+		size = 0;
+		return nullptr;
+	}
+	size = read<uint32_t>(index);
+	return data.data() + offsets[index] + sizeof(uint32_t);
+}
+
+//--------------------------------------------------------------
+void ofxOscPackedMessage::toMessage(ofxOscMessage &message) const{
+	message.clear();
+	message.setAddress(getAddress());
+	message.setRemoteEndpoint(remoteHost, remotePort);
+	for(size_t i = 0; i < getNumArgs(); i++){
+		switch(getArgType(i)){
+			case OFXOSC_TYPE_INT32:
+				message.addIntArg(read<int32_t>(i));
+				break;
+			case OFXOSC_TYPE_INT64:
+				message.addInt64Arg(read<int64_t>(i));
+				break;
+			case OFXOSC_TYPE_FLOAT:
+				message.addFloatArg(read<float>(i));
+				break;
+			case OFXOSC_TYPE_DOUBLE:
+				message.addDoubleArg(read<double>(i));
+				break;
+			case OFXOSC_TYPE_STRING:
+				message.addStringArg(getArgAsString(i));
+				break;
+			case OFXOSC_TYPE_SYMBOL:
+				message.addSymbolArg(getArgAsString(i));
+				break;
+			case OFXOSC_TYPE_CHAR:
+				message.addCharArg(getArgAsChar(i));
+				break;
+			case OFXOSC_TYPE_MIDI_MESSAGE:
+				message.addMidiMessageArg(getArgAsMidiMessage(i));
+				break;
+			case OFXOSC_TYPE_TRUE:
+				message.addBoolArg(true);
+				break;
+			case OFXOSC_TYPE_FALSE:
+				message.addBoolArg(false);
+				break;
+			case OFXOSC_TYPE_NONE:
+				message.addNoneArg();
+				break;
+			case OFXOSC_TYPE_TRIGGER:
+				message.addTriggerArg();
+				break;
+			case OFXOSC_TYPE_TIMETAG:
+				message.addTimetagArg(getArgAsTimetag(i));
+				break;
+			case OFXOSC_TYPE_RGBA_COLOR:
+				message.addRgbaColorArg(getArgAsRgbaColor(i));
+				break;
+			case OFXOSC_TYPE_BLOB:{
+				size_t size;
+				const char * blob = getArgAsBlob(i, size);
+				message.addBlobArg(ofBuffer(blob, size));
+				break;
+			}
+			default:
+				break;
+		}
+	}
+}
@@ -0,0 +1,95 @@
+// copyright (c) openFrameworks team 2010-2017
+#pragma once
+
+#include "ofxOscMessage.h"
+
+#include "OscReceivedElements.h"
+#include "IpEndpointName.h"
+
+/// \class ofxOscPackedMessage
+/// \brief a received OSC message stored in a single buffer
+///
+/// the address, type tags and arguments are kept one after the other in
+/// one block of memory with the arguments already converted from network
+/// byte order, instead of allocating an ofxOscArg for each of them. the
+/// buffer is reused when the message is, so receiving into the same
+/// packed message over and over doesn't allocate
+///
+/// strings, symbols and blobs point into the message and are only valid
+/// while it isn't changed
+///
+///     ofxOscPackedMessage message;
+///     while(receiver.getNextMessage(message)){
+///         if(strcmp(message.getAddress(), "/mocap/joint") == 0 &&
+///            strcmp(message.getTypeString(), "ifff") == 0){
+///             joints[message.getArgAsInt32(0)] = {
+///                 message.getArgAsFloat(1),
+///                 message.getArgAsFloat(2),
+///                 message.getArgAsFloat(3)};
+///         }
+///     }
+class ofxOscPackedMessage{
+public:
+
+	/// replace the contents with a message received by oscpack
+	/// \return false if the message has an argument of an unknown type
+	bool set(const osc::ReceivedMessage &message, const osc::IpEndpointName &remoteEndpoint);
+
+	/// clear this message, keeps the memory allocated
+	void clear();
+
+	/// \return the OSC address
+	const char * getAddress() const;
+
+	/// \return the remote host ip
+	const char * getRemoteHost() const;
+
+	/// \return the remote port or 0 if not set
+	int getRemotePort() const;
+
+	/// \return number of arguments
+	std::size_t getNumArgs() const;
+
+	/// \return type tags for all arguments, 1 char for each argument
+	const char * getTypeString() const;
+
+	/// \param index The index of the queried item.
+	/// \return argument type code for a given index
+	ofxOscArgType getArgType(std::size_t index) const;
+
+	/// numeric getters convert between numeric types and bools
+	/// automatically, other types log an error and return 0
+	std::int32_t getArgAsInt32(std::size_t index) const;
+	std::int64_t getArgAsInt64(std::size_t index) const;
+	float getArgAsFloat(std::size_t index) const;
+	double getArgAsDouble(std::size_t index) const;
+	bool getArgAsBool(std::size_t index) const;
+
+	/// \return the string or symbol, "" for other types
+	const char * getArgAsString(std::size_t index) const;
+	char getArgAsChar(std::size_t index) const;
+	std::uint32_t getArgAsMidiMessage(std::size_t index) const;
+	std::uint64_t getArgAsTimetag(std::size_t index) const;
+	std::uint32_t getArgAsRgbaColor(std::size_t index) const;
+
+	/// \param size set to the size of the blob in bytes
+	/// \return the blob data, nullptr for other types
+	const char * getArgAsBlob(std::size_t index, std::size_t &size) const;
+
+	/// copy the message into a regular ofxOscMessage
+	void toMessage(ofxOscMessage &message) const;
+
+private:
+	template<typename T>
+	T read(std::size_t index) const;
+	template<typename T>
+	void write(const T &value);
+	bool checkIndex(std::size_t index, const char * method) const;
+	double getArgAsNumber(std::size_t index, const char * method) const;
+
+	std::vector<char> data; //< address, type tags and then the arguments
+	std::vector<std::uint32_t> offsets; //< where each argument starts in data
+	std::size_t typeTagsOffset = 0;
+	char remoteHost[osc::IpEndpointName::ADDRESS_STRING_LENGTH] = {0};
+	int remotePort = 0;
+};
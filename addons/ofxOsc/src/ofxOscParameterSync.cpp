@@ -15,7 +15,13 @@ ofxOscParameterSync::~ofxOscParameterSync(){
 void ofxOscParameterSync::setup(ofParameterGroup &group, int localPort, const std::string &host, int remotePort){
 	syncGroup = group;
 	ofAddListener(syncGroup.parameterChangedE(), this, &ofxOscParameterSync::parameterChanged);
-	sender.setup(host, remotePort);
+	// a preset or a dragged slider changes many parameters in a frame,
+	// send only their last values packed in bundles at the end of it
+	ofxOscSenderSettings settings;
+	settings.host = host;
+	settings.port = remotePort;
+	settings.batch = true;
+	sender.setup(settings);
 	receiver.setup(localPort);
 }
 
@@ -16,6 +16,9 @@ public:
 
 	/// set the parameter group & connection info
 	/// the remote and local ports must be different to avoid collisions
+	///
+	/// changes are batched, see ofxOscSenderSettings::batch, and sent
+	/// once per frame after update
 	void setup(ofParameterGroup &group, int localPort, const std::string &remoteHost, int remotePort);
 	
 	/// process any incoming messages
@@ -4,6 +4,8 @@
 
 using namespace std;
 
+thread_local ofxOscReceiver::Worker * ofxOscReceiver::currentWorker = nullptr;
+
 //--------------------------------------------------------------
 ofxOscReceiver::~ofxOscReceiver(){
 	stop();
@@ -23,6 +25,7 @@ ofxOscReceiver& ofxOscReceiver::operator=(const ofxOscReceiver &mom){
 ofxOscReceiver& ofxOscReceiver::copy(const ofxOscReceiver &other){
 	if(this == &other) return *this;
 	settings = other.settings;
+	packedCallback = other.packedCallback;
 	if(other.listenSocket){
 		setup(settings);
 	}
@@ -89,6 +92,39 @@ bool ofxOscReceiver::start() {
 		return false;
 	}
 
+	if(settings.receiveBufferSize > 0){
+		listenSocket->SetReceiveBufferSize(settings.receiveBufferSize);
+		// linux reports twice the size it was asked for, to fit its bookkeeping
+		if(listenSocket->GetReceiveBufferSize() < settings.receiveBufferSize){
+			ofLogWarning("ofxOscReceiver") << "start(): receive buffer limited to "
+				<< listenSocket->GetReceiveBufferSize() << " bytes by the system";
+		}
+	}
+
+	// each worker parses the packets it's handed and queues the messages
+	// for the main thread, the listening thread only copies the packets
+	if(settings.numThreads > 1){
+		auto newWorkers = std::make_shared<Workers>();
+		for(int i = 0; i < settings.numThreads; i++){
+			newWorkers->emplace_back(new Worker);
+			Worker * worker = newWorkers->back().get();
+			worker->thread = std::thread([this, worker]{
+				currentWorker = worker;
+				Packet packet;
+				while(worker->packets.receive(packet)){
+					try{
+						osc::OscPacketListener::ProcessPacket(packet.data.data(), packet.data.size(), packet.endpoint);
+					}
+					catch(std::exception &e){
+						ofLogWarning("ofxOscReceiver") << e.what();
+					}
+					worker->freePackets.send(std::move(packet));
+				}
+			});
+		}
+		std::atomic_store(&workers, newWorkers);
+	}
+
 	listenThread = std::thread([this]{
 		while(listenSocket){
 			try{
@@ -111,6 +147,14 @@ bool ofxOscReceiver::start() {
 //--------------------------------------------------------------
 void ofxOscReceiver::stop() {
 	listenSocket.reset();
+	if(workers){
+		auto stopped = workers;
+		std::atomic_store(&workers, std::shared_ptr<Workers>());
+		for(auto & worker : *stopped){
+			worker->packets.close();
+			worker->thread.join();
+		}
+	}
 }
 
 //--------------------------------------------------------------
@@ -120,7 +164,17 @@ bool ofxOscReceiver::isListening() const{
 
 //--------------------------------------------------------------
 bool ofxOscReceiver::hasWaitingMessages() const{
-	return !messagesChannel.empty();
+	if(!messagesChannel.empty() || !packedChannel.empty()){
+		return true;
+	}
+	if(workers){
+		for(auto & worker : *workers){
+			if(!worker->messages.empty() || !worker->packed.empty()){
+				return true;
+			}
+		}
+	}
+	return false;
 }
 
 //--------------------------------------------------------------
@@ -130,13 +184,56 @@ bool ofxOscReceiver::getNextMessage(ofxOscMessage *message){
 
 //--------------------------------------------------------------
 bool ofxOscReceiver::getNextMessage(ofxOscMessage &message){
-	return messagesChannel.tryReceive(message);
+	if(messagesChannel.tryReceive(message)){
+		return true;
+	}
+	if(workers){
+		// take turns so a busy worker doesn't delay the others
+		for(size_t i = 0; i < workers->size(); i++){
+			Worker & worker = *(*workers)[nextWorker++ % workers->size()];
+			if(worker.messages.tryReceive(message)){
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------
+bool ofxOscReceiver::getNextMessage(ofxOscPackedMessage &message){
+	ofxOscPackedMessage next;
+	if(packedChannel.tryReceive(next)){
+		std::swap(message, next);
+		freePackedChannel.send(std::move(next));
+		return true;
+	}
+	if(workers){
+		for(size_t i = 0; i < workers->size(); i++){
+			Worker & worker = *(*workers)[nextWorker++ % workers->size()];
+			if(worker.packed.tryReceive(next)){
+				std::swap(message, next);
+				worker.freePacked.send(std::move(next));
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------
+void ofxOscReceiver::setPackedMessageCallback(std::function<void(const ofxOscPackedMessage &)> callback){
+	if(listenSocket){
+		ofLogWarning("ofxOscReceiver") << "setPackedMessageCallback(): "
+			<< "set it before starting to listen";
+		return;
+	}
+	packedCallback = callback;
 }
 
 //--------------------------------------------------------------
 bool ofxOscReceiver::getParameter(ofAbstractParameter &parameter){
 	ofxOscMessage msg;
-	while(messagesChannel.tryReceive(msg)){
+	while(getNextMessage(msg)){
 		ofAbstractParameter * p = &parameter;
 		std::vector<std::string> address = ofSplitString(msg.getAddress(),"/", true);
 		for(unsigned int i = 0; i < address.size(); i++){
@@ -186,6 +283,16 @@ bool ofxOscReceiver::getParameter(ofAbstractParameter &parameter){
 	return true;
 }
 
+//--------------------------------------------------------------
+uint64_t ofxOscReceiver::getNumDroppedPackets() const{
+	return numDroppedPackets;
+}
+
+//--------------------------------------------------------------
+uint64_t ofxOscReceiver::getNumDroppedMessages() const{
+	return numDroppedMessages;
+}
+
 //--------------------------------------------------------------
 int ofxOscReceiver::getPort() const{
 	return settings.port;
@@ -197,8 +304,57 @@ const ofxOscReceiverSettings &ofxOscReceiver::getSettings() const {
 }
 
 // PROTECTED
+//--------------------------------------------------------------
+void ofxOscReceiver::ProcessPacket(const char *data, int size, const osc::IpEndpointName &remoteEndpoint){
+	auto workers = std::atomic_load(&this->workers);
+	if(!workers || currentWorker){
+		osc::OscPacketListener::ProcessPacket(data, size, remoteEndpoint);
+		return;
+	}
+
+	// the packets of a sender always go to the same worker when ordered,
+	// so its messages can't overtake each other
+	size_t index;
+	if(settings.ordered){
+		uint64_t key = (uint64_t(remoteEndpoint.address) << 16) ^ uint64_t(remoteEndpoint.port);
+		index = ((key * 0x9E3779B97F4A7C15ull) >> 32) % workers->size();
+	}else{
+		index = nextPacketWorker++ % workers->size();
+	}
+	Worker & worker = *(*workers)[index];
+
+	// reuse the memory of a packet the worker is done with, if any
+	Packet packet;
+	worker.freePackets.tryReceive(packet);
+	packet.data.assign(data, data + size);
+	packet.endpoint = remoteEndpoint;
+	if(!worker.packets.send(std::move(packet))){
+		numDroppedPackets++;
+	}
+}
+
 //--------------------------------------------------------------
 void ofxOscReceiver::ProcessMessage(const osc::ReceivedMessage &m, const osc::IpEndpointName &remoteEndpoint){
+	Worker * worker = currentWorker;
+	if(packedCallback){
+		ofxOscPackedMessage & msg = worker ? worker->callbackMessage : callbackMessage;
+		msg.set(m, remoteEndpoint);
+		packedCallback(msg);
+		return;
+	}
+	if(settings.packed){
+		auto & freeChannel = worker ? worker->freePacked : freePackedChannel;
+		auto & channel = worker ? worker->packed : packedChannel;
+		// reuse the memory of a message the main thread is done with, if any
+		ofxOscPackedMessage msg;
+		freeChannel.tryReceive(msg);
+		msg.set(m, remoteEndpoint);
+		if(!channel.send(std::move(msg))){
+			numDroppedMessages++;
+		}
+		return;
+	}
+
 	// convert the message to an ofxOscMessage
 	ofxOscMessage msg;
 
@@ -267,7 +423,13 @@ void ofxOscReceiver::ProcessMessage(const osc::ReceivedMessage &m, const osc::Ip
 	}
 
 	// send msg to main thread
-	messagesChannel.send(std::move(msg));
+	if(worker){
+		if(!worker->messages.send(std::move(msg))){
+			numDroppedMessages++;
+		}
+	}else{
+		messagesChannel.send(std::move(msg));
+	}
 }
 
 // friend functions
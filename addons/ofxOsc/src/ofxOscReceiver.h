@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ofxOscMessage.h"
+#include "ofxOscPackedMessage.h"
 #include "ofParameter.h"
 #include "ofThreadChannel.h"
 
@@ -16,6 +17,10 @@ struct ofxOscReceiverSettings {
 	int port = 0;        //< port to listen on
 	bool reuse = true;   //< should the port be reused by other receivers?
 	bool start = true;   //< start listening after setup?
+	bool packed = false; //< queue ofxOscPackedMessages instead of ofxOscMessages?
+	int numThreads = 1;  //< threads parsing the packets, 1 parses them on the listening thread
+	bool ordered = true; //< keep the order of the messages of each sender when numThreads > 1?
+	int receiveBufferSize = 0; //< bytes the system buffers while they aren't read, 0 keeps its default
 };
 
 /// \class ofxOscReceiver
@@ -71,11 +76,41 @@ public:
 	/// \return false if there are no more messages to be got, otherwise return true
 	bool getNextMessage(ofxOscMessage& msg);
 	OF_DEPRECATED_MSG("Pass a reference instead of a pointer", bool getNextMessage(ofxOscMessage *msg));
+
+	/// take the next message on the queue of packed messages, needs
+	/// settings.packed to be true
+	///
+	/// the memory message had is handed back to the listening thread and
+	/// reused, so getting every message into the same packed message doesn't
+	/// allocate. messages are dropped if the queue of 4096 gets full
+	/// eturn false if there are no more messages to be got, otherwise return true
+	bool getNextMessage(ofxOscPackedMessage &msg);
+
+	/// call a function from the listening thread with every message received
+	/// instead of queueing them, set it before starting to listen
+	///
+	/// the message is reused for every call so the function should copy
+	/// whatever it needs to keep
+	///
+	/// with settings.numThreads > 1 it's called from every parsing thread
+	/// at the same time
+	void setPackedMessageCallback(std::function<void(const ofxOscPackedMessage &msg)> callback);
 	
 	/// try to get waiting message an ofParameter
 	/// \return true if message was handled by the given parameter
 	bool getParameter(ofAbstractParameter &parameter);
 
+	/// packets that couldn't be handed to a parsing thread since its queue
+	/// was full, only when settings.numThreads > 1
+	///
+	/// packets dropped by the system because its receive buffer was full
+	/// are not counted, raise settings.receiveBufferSize to avoid them
+	uint64_t getNumDroppedPackets() const;
+
+	/// messages dropped because the queue to the main thread was full, the
+	/// main thread isn't getting them fast enough
+	uint64_t getNumDroppedMessages() const;
+
 	/// \return listening port
 	int getPort() const;
 	
@@ -91,14 +126,52 @@ protected:
 	/// process an incoming osc message and add it to the queue
 	virtual void ProcessMessage(const osc::ReceivedMessage &m, const osc::IpEndpointName &remoteEndpoint);
 
+	/// hand an incoming packet to a parsing thread, or parse it right away
+	/// if there's none
+	virtual void ProcessPacket(const char *data, int size, const osc::IpEndpointName &remoteEndpoint);
+
 private:
 
+	/// copy of a packet waiting to be parsed
+	struct Packet {
+		std::vector<char> data;
+		osc::IpEndpointName endpoint;
+	};
+
+	/// parsing thread with its own queues, so every queue has only one
+	/// thread on each side
+	struct Worker {
+		ofThreadChannel<Packet, ofThreadChannelSPSC> packets{1024}; //< from the listening thread
+		ofThreadChannel<Packet, ofThreadChannelSPSC> freePackets{1024}; //< back to be reused
+		ofThreadChannel<ofxOscMessage, ofThreadChannelSPSC> messages{4096}; //< to the main thread
+		ofThreadChannel<ofxOscPackedMessage, ofThreadChannelSPSC> packed{4096}; //< to the main thread
+		ofThreadChannel<ofxOscPackedMessage, ofThreadChannelSPSC> freePacked{4096}; //< back to be reused
+		ofxOscPackedMessage callbackMessage; //< reused for every call to packedCallback
+		std::thread thread;
+	};
+	typedef std::vector<std::unique_ptr<Worker>> Workers;
+
+	/// the worker whose thread is running, null on any other thread
+	static thread_local Worker * currentWorker;
+
 	/// socket to listen on, unique for each port
 	/// shared between objects if allowReuse is true
 	std::unique_ptr<osc::UdpListeningReceiveSocket, std::function<void(osc::UdpListeningReceiveSocket*)>> listenSocket;
 
 	std::thread listenThread; //< listener thread
 	ofThreadChannel<ofxOscMessage> messagesChannel; //< message passing thread channel
+	ofThreadChannel<ofxOscPackedMessage, ofThreadChannelSPSC> packedChannel{4096}; //< packed messages to the main thread
+	ofThreadChannel<ofxOscPackedMessage, ofThreadChannelSPSC> freePackedChannel{4096}; //< packed messages back to be reused
+	ofxOscPackedMessage callbackMessage; //< reused for every call to packedCallback
+	std::function<void(const ofxOscPackedMessage &)> packedCallback;
+
+	/// only replaced with atomic_store, the listening thread keeps its own
+	/// reference so they outlive stop() while it's handing them a packet
+	std::shared_ptr<Workers> workers;
+	size_t nextPacketWorker = 0; //< next worker for unordered packets, only used by the listening thread
+	size_t nextWorker = 0; //< next worker to poll for messages on the main thread
+	std::atomic<uint64_t> numDroppedPackets{0};
+	std::atomic<uint64_t> numDroppedMessages{0};
 
 	ofxOscReceiverSettings settings; //< current settings
 };
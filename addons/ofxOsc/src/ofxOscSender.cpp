@@ -78,12 +78,21 @@ bool ofxOscSender::setup(const ofxOscSenderSettings &settings){
 		sendSocket.reset();
 		return false;
 	}
+	if(settings.batch){
+		updateListener = ofEvents().update.newListener(this, &ofxOscSender::onUpdate, OF_EVENT_ORDER_AFTER_APP);
+	}
+	else{
+		updateListener.unsubscribe();
+	}
 	return true;
 }
 
 //--------------------------------------------------------------
 void ofxOscSender::clear(){
 	sendSocket.reset();
+	updateListener.unsubscribe();
+	pendingMessages.clear();
+	pendingAddresses.clear();
 }
 
 //--------------------------------------------------------------
@@ -92,6 +101,10 @@ void ofxOscSender::sendBundle(const ofxOscBundle &bundle){
 		ofLogError("ofxOscSender") << "trying to send with empty socket";
 		return;
 	}
+	if(settings.batch){
+		queueBundle(bundle);
+		return;
+	}
 	
 	// setting this much larger as it gets trimmed down to the size its using before being sent.
 	// TODO: much better if we could make this dynamic? Maybe have ofxOscBundle return its size?
@@ -110,6 +123,10 @@ void ofxOscSender::sendMessage(const ofxOscMessage &message, bool wrapInBundle){
 		ofLogError("ofxOscSender") << "trying to send with empty socket";
 		return;
 	}
+	if(settings.batch){
+		queueMessage(message);
+		return;
+	}
 	
 	// setting this much larger as it gets trimmed down to the size its using before being sent.
 	// TODO: much better if we could make this dynamic? Maybe have ofxOscMessage return its size?
@@ -156,6 +173,54 @@ void ofxOscSender::sendParameter(const ofAbstractParameter &parameter){
 	}
 }
 
+//--------------------------------------------------------------
+void ofxOscSender::flush(){
+	if(pendingMessages.empty() || !sendSocket){
+		return;
+	}
+	if(settings.maxSendRate > 0){
+		auto now = ofGetElapsedTimeMicros();
+		if(lastFlush != 0 && now - lastFlush < std::uint64_t(1000000 / settings.maxSendRate)){
+			return;
+		}
+		lastFlush = now;
+	}
+
+	static const int OUTPUT_BUFFER_SIZE = 327680;
+	char buffer[OUTPUT_BUFFER_SIZE];
+
+	// "#bundle" and an immediate time tag, followed by the size and
+	// contents of each message
+	static const char bundleHeader[16] = {'#','b','u','n','d','l','e',0, 0,0,0,0,0,0,0,1};
+	const std::size_t headerSize = sizeof(bundleHeader);
+	bundleBuffer.assign(bundleHeader, bundleHeader + headerSize);
+	for(auto &message : pendingMessages){
+		osc::OutboundPacketStream p(buffer, OUTPUT_BUFFER_SIZE);
+		appendMessage(message, p);
+		std::size_t size = p.Size();
+
+		// messages bigger than maxBundleSize go in a bundle on their own
+		if(bundleBuffer.size() > headerSize && bundleBuffer.size() + 4 + size > settings.maxBundleSize){
+			sendSocket->Send(bundleBuffer.data(), bundleBuffer.size());
+			bundleBuffer.resize(headerSize);
+		}
+		char sizeBytes[4] = {char(size >> 24), char(size >> 16), char(size >> 8), char(size)};
+		bundleBuffer.insert(bundleBuffer.end(), sizeBytes, sizeBytes + 4);
+		bundleBuffer.insert(bundleBuffer.end(), p.Data(), p.Data() + size);
+	}
+	if(bundleBuffer.size() > headerSize){
+		sendSocket->Send(bundleBuffer.data(), bundleBuffer.size());
+	}
+
+	pendingMessages.clear();
+	pendingAddresses.clear();
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscSender::getNumPendingMessages() const{
+	return pendingMessages.size();
+}
+
 //--------------------------------------------------------------
 std::string ofxOscSender::getHost() const{
 	return settings.host;
@@ -285,6 +350,36 @@ void ofxOscSender::appendParameter(ofxOscMessage &msg, const ofAbstractParameter
 	}
 }
 
+//--------------------------------------------------------------
+void ofxOscSender::queueMessage(const ofxOscMessage &message){
+	if(settings.coalesce){
+		// replace the previous value, keeping its place in the queue
+		auto it = pendingAddresses.find(message.getAddress());
+		if(it != pendingAddresses.end()){
+			pendingMessages[it->second] = message;
+			return;
+		}
+		pendingAddresses[message.getAddress()] = pendingMessages.size();
+	}
+	pendingMessages.push_back(message);
+}
+
+//--------------------------------------------------------------
+void ofxOscSender::queueBundle(const ofxOscBundle &bundle){
+	// nested bundles are flattened, they are all immediate anyway
+	for(int i = 0; i < bundle.getBundleCount(); i++){
+		queueBundle(bundle.getBundleAt(i));
+	}
+	for(int i = 0; i < bundle.getMessageCount(); i++){
+		queueMessage(bundle.getMessageAt(i));
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscSender::onUpdate(ofEventArgs &){
+	flush();
+}
+
 // friend functions
 //--------------------------------------------------------------
 std::ostream& operator<<(std::ostream &os, const ofxOscSender &sender) {
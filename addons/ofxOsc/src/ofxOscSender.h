@@ -9,6 +9,8 @@
 #include "ofxOscBundle.h"
 #include "ofParameter.h"
 #include "ofParameterGroup.h"
+#include "ofEvents.h"
+#include <unordered_map>
 
 /// \struct ofxOscSenderSettings
 /// \brief OSC message sender settings
@@ -16,6 +18,10 @@ struct ofxOscSenderSettings {
 	std::string host = "localhost"; //< destination host name/ip
 	int port = 0;                   //< destination port
 	bool broadcast = true;          //< allow multicast (broadcasting) ip range?
+	bool batch = false;             //< queue messages and send them packed in bundles on flush()?
+	std::size_t maxBundleSize = 1400; //< when batching, biggest bundle in bytes, keep it under the network MTU
+	bool coalesce = true;           //< when batching, only send the latest message queued for each address?
+	float maxSendRate = 0;          //< when batching, most flushes per second, 0 to send on every flush
 };
 
 /// \class ofxOscSender
@@ -52,6 +58,17 @@ public:
 	/// create & send a message with data from an ofParameter
 	void sendParameter(const ofAbstractParameter &parameter);
 
+	/// send the messages queued when batching, packed in as few bundles
+	/// of up to maxBundleSize as possible
+	///
+	/// called automatically after every update, so messages sent during
+	/// a frame go out together at the end of it. with a maxSendRate the
+	/// messages stay queued until enough time has passed since the last flush
+	void flush();
+
+	/// \return number of messages queued for the next flush
+	std::size_t getNumPendingMessages() const;
+
 	/// \return current host name/ip
 	std::string getHost() const;
 
@@ -73,6 +90,17 @@ private:
 	void appendParameter(ofxOscBundle &bundle, const ofAbstractParameter &parameter, const std::string &address);
 	void appendParameter(ofxOscMessage &msg, const ofAbstractParameter &parameter, const std::string &address);
 
+	// batching
+	void queueMessage(const ofxOscMessage &message);
+	void queueBundle(const ofxOscBundle &bundle);
+	void onUpdate(ofEventArgs &args);
+
 	ofxOscSenderSettings settings; //< current settings
 	std::unique_ptr<osc::UdpTransmitSocket> sendSocket; //< sender socket
+
+	std::vector<ofxOscMessage> pendingMessages; //< queued when batching
+	std::unordered_map<std::string, std::size_t> pendingAddresses; //< index of each address in pendingMessages when coalescing
+	std::vector<char> bundleBuffer; //< bundle being filled by flush()
+	std::uint64_t lastFlush = 0; //< time of the last flush that sent, for maxSendRate
+	ofEventListener updateListener; //< flushes after every update when batching
 };
@@ -1,5 +1,6 @@
 #include "ofxSvg.h"
 #include "ofConstants.h"
+#include "ofTaskPool.h"
 
 using namespace std;
 
@@ -51,16 +52,219 @@ void ofxSVG::load(string path){
 	}
 
 	setupDiagram(diagram);
+	geometry.clear();
+	batches.clear();
 
 	svgtiny_free(diagram);
 }
 
 void ofxSVG::draw(){
+	if(retained){
+		updateRetained();
+		for(auto & batch: batches){
+			batch.mesh.draw();
+		}
+		return;
+	}
 	for(int i = 0; i < (int)paths.size(); i++){
 		paths[i].draw();
 	}
 }
 
+void ofxSVG::setRetained(bool retained){
+	this->retained = retained;
+	if(!retained){
+		geometry.clear();
+		batches.clear();
+	}
+}
+
+bool ofxSVG::isRetained() const{
+	return retained;
+}
+
+void ofxSVG::setPathsPerBatch(size_t numPaths){
+	numPaths = std::max<size_t>(numPaths, 1);
+	if(numPaths != pathsPerBatch){
+		pathsPerBatch = numPaths;
+		batches.clear();
+	}
+}
+
+size_t ofxSVG::getPathsPerBatch() const{
+	return pathsPerBatch;
+}
+
+size_t ofxSVG::getNumBatches() const{
+	return batches.size();
+}
+
+void ofxSVG::flagPathChanged(int n){
+	if(n >= 0 && n < (int)geometry.size()){
+		geometry[n].dirty = true;
+		if(n / pathsPerBatch < batches.size()){
+			batches[n / pathsPerBatch].dirty = true;
+		}
+	}
+}
+
+namespace{
+	// triangulates an outline as a band of width around it with mitered
+	// joins, so it can go in the same mesh as the fills
+	void appendStroke(const ofPolyline & polyline, float width, const ofDefaultColorType & color,
+					  vector<ofDefaultVertexType> & vertices, vector<ofDefaultColorType> & colors){
+		auto & points = polyline.getVertices();
+		size_t n = points.size();
+		bool closed = polyline.isClosed();
+		if(closed && n > 1 && points.front() == points.back()){
+			n--;
+		}
+		if(n < 2){
+			return;
+		}
+
+		float halfWidth = width * 0.5f;
+		auto direction = [&](size_t from, size_t to){
+			glm::vec2 d = glm::vec2(points[to]) - glm::vec2(points[from]);
+			float length = glm::length(d);
+			return length > 0 ? d / length : glm::vec2(0);
+		};
+		auto perpendicular = [](const glm::vec2 & d){
+			return glm::vec2(-d.y, d.x);
+		};
+
+		size_t firstOffset = vertices.size();
+		vector<glm::vec2> offsets(n);
+		for(size_t i = 0; i < n; i++){
+			bool hasPrev = i > 0 || closed;
+			bool hasNext = i < n - 1 || closed;
+			glm::vec2 normalPrev = hasPrev ? perpendicular(direction(i > 0 ? i - 1 : n - 1, i)) : glm::vec2(0);
+			glm::vec2 normalNext = hasNext ? perpendicular(direction(i, i < n - 1 ? i + 1 : 0)) : glm::vec2(0);
+			if(!hasPrev){
+				offsets[i] = normalNext * halfWidth;
+			}else if(!hasNext){
+				offsets[i] = normalPrev * halfWidth;
+			}else{
+				glm::vec2 miter = normalPrev + normalNext;
+				float length = glm::length(miter);
+				if(length < 1e-4f){
+					offsets[i] = normalPrev * halfWidth;
+				}else{
+					miter /= length;
+					// limit the miter to 4 times the width on sharp corners
+					float cos = std::max(glm::dot(miter, normalPrev), 0.25f);
+					offsets[i] = miter * (halfWidth / cos);
+				}
+			}
+		}
+
+		size_t numSegments = closed ? n : n - 1;
+		vertices.reserve(firstOffset + numSegments * 6);
+		for(size_t i = 0; i < numSegments; i++){
+			size_t j = (i + 1) % n;
+			ofDefaultVertexType leftI = points[i] + ofDefaultVertexType(offsets[i], 0);
+			ofDefaultVertexType rightI = points[i] - ofDefaultVertexType(offsets[i], 0);
+			ofDefaultVertexType leftJ = points[j] + ofDefaultVertexType(offsets[j], 0);
+			ofDefaultVertexType rightJ = points[j] - ofDefaultVertexType(offsets[j], 0);
+			vertices.push_back(leftI);
+			vertices.push_back(rightI);
+			vertices.push_back(leftJ);
+			vertices.push_back(rightI);
+			vertices.push_back(rightJ);
+			vertices.push_back(leftJ);
+		}
+		colors.resize(vertices.size(), color);
+	}
+}
+
+void ofxSVG::buildPathGeometry(size_t n){
+	auto & path = paths[n];
+	auto & dst = geometry[n];
+	dst.vertices.clear();
+	dst.colors.clear();
+
+	if(path.isFilled()){
+		const ofMesh & fill = path.getTessellation();
+		ofDefaultColorType color = path.getFillColor();
+		auto & vertices = fill.getVertices();
+		auto & indices = fill.getIndices();
+		if(fill.hasIndices()){
+			dst.vertices.reserve(indices.size());
+			for(auto index: indices){
+				dst.vertices.push_back(vertices[index]);
+			}
+		}else{
+			dst.vertices.assign(vertices.begin(), vertices.end());
+		}
+		dst.colors.resize(dst.vertices.size(), color);
+	}
+
+	if(path.hasOutline()){
+		// svg strokes thinner than a unit are usually hairlines, as
+		// lines they would be drawn 1 pixel wide
+		float strokeWidth = std::max(path.getStrokeWidth(), 1.f);
+		ofDefaultColorType color = path.getStrokeColor();
+		for(auto & outline: path.getOutline()){
+			appendStroke(outline, strokeWidth, color, dst.vertices, dst.colors);
+		}
+	}
+	dst.dirty = false;
+}
+
+void ofxSVG::updateRetained(){
+	size_t numBatches = (paths.size() + pathsPerBatch - 1) / pathsPerBatch;
+	if(geometry.size() != paths.size()){
+		geometry.clear();
+		geometry.resize(paths.size());
+	}
+	if(batches.size() != numBatches){
+		batches.clear();
+		batches.resize(numBatches);
+	}
+
+	dirtyPaths.clear();
+	for(size_t i = 0; i < geometry.size(); i++){
+		if(geometry[i].dirty){
+			dirtyPaths.push_back(i);
+			batches[i / pathsPerBatch].dirty = true;
+		}
+	}
+	if(!dirtyPaths.empty()){
+		ofGetTaskPool().parallelFor(0, dirtyPaths.size(), [this](size_t begin, size_t end){
+			for(size_t i = begin; i < end; i++){
+				buildPathGeometry(dirtyPaths[i]);
+			}
+		});
+	}
+
+	for(size_t b = 0; b < batches.size(); b++){
+		auto & batch = batches[b];
+		if(!batch.dirty){
+			continue;
+		}
+		size_t begin = b * pathsPerBatch;
+		size_t end = std::min(begin + pathsPerBatch, paths.size());
+		size_t numVertices = 0;
+		for(size_t i = begin; i < end; i++){
+			numVertices += geometry[i].vertices.size();
+		}
+
+		auto & vertices = batch.mesh.getVertices();
+		auto & colors = batch.mesh.getColors();
+		vertices.clear();
+		colors.clear();
+		vertices.reserve(numVertices);
+		colors.reserve(numVertices);
+		for(size_t i = begin; i < end; i++){
+			vertices.insert(vertices.end(), geometry[i].vertices.begin(), geometry[i].vertices.end());
+			colors.insert(colors.end(), geometry[i].colors.begin(), geometry[i].colors.end());
+		}
+		batch.mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+		batch.mesh.setUsage(GL_STATIC_DRAW);
+		batch.dirty = false;
+	}
+}
+
 
 void ofxSVG::setupDiagram(struct svgtiny_diagram * diagram){
 
@@ -77,6 +281,14 @@ void ofxSVG::setupDiagram(struct svgtiny_diagram * diagram){
 			ofLogWarning("ofxSVG") << "setupDiagram(): text: not implemented yet";
 		}
 	}
+
+	// tessellate all the paths now, in parallel, instead of one by one
+	// the first time they are drawn
+	ofGetTaskPool().parallelFor(0, paths.size(), [this](size_t begin, size_t end){
+		for(size_t i = begin; i < end; i++){
+			paths[i].tessellate();
+		}
+	});
 }
 
 void ofxSVG::setupShape(struct svgtiny_shape * shape, ofPath & path){
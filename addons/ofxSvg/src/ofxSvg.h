@@ -3,6 +3,7 @@
 //#include "ofMain.h"
 #include "ofPath.h"
 #include "ofTypes.h"
+#include "ofVboMesh.h"
 
 class ofxSVG {
 	public: ~ofxSVG();
@@ -17,13 +18,50 @@ class ofxSVG {
 		void load(std::string path);
 		void draw();
 
+		/// \brief Draws the whole document from a few cached meshes
+		///
+		/// By default every path is drawn on its own, with a draw call for the
+		/// fill and another for each outline. In retained mode the fills and
+		/// the outlines of up to getPathsPerBatch() consecutive paths are
+		/// merged, in document order, into one ofVboMesh with a color per
+		/// vertex, so the document is drawn in a handful of calls. Outlines
+		/// are triangulated with their stroke width in document units
+		/// instead of drawn as lines, so they scale with the drawing.
+		///
+		/// Paths modified through getPathAt() or flagged with
+		/// flagPathChanged() are tessellated again on the next draw and only
+		/// the batches that contain them are uploaded again.
+		void setRetained(bool retained);
+		bool isRetained() const;
+
+		/// \brief Number of paths merged in each mesh in retained mode,
+		/// smaller batches are faster to update when paths change, bigger
+		/// ones need fewer draw calls
+		void setPathsPerBatch(std::size_t numPaths);
+		std::size_t getPathsPerBatch() const;
+
+		/// \brief Number of meshes the document is drawn with in retained
+		/// mode, updated on draw
+		std::size_t getNumBatches() const;
+
 		int getNumPath(){
 			return paths.size();
 		}
+
+		/// \brief Path n, flagged as changed in retained mode since it can
+		/// be modified through the reference
 		ofPath & getPathAt(int n){
+			flagPathChanged(n);
+			return paths[n];
+		}
+		const ofPath & getPathAt(int n) const{
 			return paths[n];
 		}
 
+		/// \brief Rebuilds path n in the retained meshes on the next draw,
+		/// for changes made through a reference kept from getPathAt()
+		void flagPathChanged(int n);
+
 		const std::vector <ofPath> & getPaths() const;
 
 	private:
@@ -35,4 +73,25 @@ class ofxSVG {
 		void setupDiagram(struct svgtiny_diagram * diagram);
 		void setupShape(struct svgtiny_shape * shape, ofPath & path);
 
+		// triangles of a path's fill and outlines for the retained meshes
+		struct PathGeometry{
+			std::vector<ofDefaultVertexType> vertices;
+			std::vector<ofDefaultColorType> colors;
+			bool dirty = true;
+		};
+
+		struct Batch{
+			ofVboMesh mesh;
+			bool dirty = true;
+		};
+
+		void updateRetained();
+		void buildPathGeometry(std::size_t n);
+
+		bool retained = false;
+		std::size_t pathsPerBatch = 512;
+		std::vector<PathGeometry> geometry;
+		std::vector<Batch> batches;
+		std::vector<std::size_t> dirtyPaths;
+
 };
@@ -1,77 +1,332 @@
 #include "ofxThreadedImageLoader.h"
 #include <sstream>
-ofxThreadedImageLoader::ofxThreadedImageLoader(){
+
+class ofxThreadedImageLoader::Worker: public ofThread{
+public:
+	Worker(ofxThreadedImageLoader & loader)
+	:loader(loader){}
+
+	void threadedFunction(){
+		setThreadName("ofxThreadedImageLoader " + ofToString(thread.get_id()));
+		loader.decodeLoop();
+	}
+
+	ofxThreadedImageLoader & loader;
+};
+
+ofxThreadedImageLoader::ofxThreadedImageLoader(size_t numThreads){
 	nextID = 0;
+	maxUploadBytes = 0;
+	maxUploadTime = 2;
+	streamMipmaps = false;
+	closing = false;
     ofAddListener(ofEvents().update, this, &ofxThreadedImageLoader::update);
 	ofAddListener(ofURLResponseEvent(),this,&ofxThreadedImageLoader::urlResponse);
-    
-    startThread();
-    lastUpdate = 0;
+
+    startThreads(numThreads);
 }
 
 ofxThreadedImageLoader::~ofxThreadedImageLoader(){
-	images_to_load_from_disk.close();
-	images_to_update.close();
-	waitForThread(true);
+	stopThreads();
     ofRemoveListener(ofEvents().update, this, &ofxThreadedImageLoader::update);
 	ofRemoveListener(ofURLResponseEvent(),this,&ofxThreadedImageLoader::urlResponse);
 }
 
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::startThreads(size_t numThreads){
+	numThreads = std::max<size_t>(numThreads, 1);
+	for(size_t i = 0; i < numThreads; i++){
+		workers.emplace_back(new Worker(*this));
+		workers.back()->startThread();
+	}
+}
+
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::stopThreads(){
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		closing = true;
+	}
+	condition.notify_all();
+	for(auto & worker: workers){
+		worker->waitForThread(false);
+	}
+	workers.clear();
+	std::unique_lock<std::mutex> lock(mutex);
+	closing = false;
+}
+
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::setNumThreads(size_t numThreads){
+	stopThreads();
+	startThreads(numThreads);
+}
+
+//--------------------------------------------------------------
+size_t ofxThreadedImageLoader::getNumThreads() const{
+	return workers.size();
+}
+
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::stopThread(){
+	cancelAll();
+	stopThreads();
+}
+
 // Load an image from disk.
 //--------------------------------------------------------------
-void ofxThreadedImageLoader::loadFromDisk(ofImage& image, string filename) {
+uint64_t ofxThreadedImageLoader::loadFromDisk(ofImage& image, string filename, int priority) {
 	nextID++;
 	ofImageLoaderEntry entry(image);
 	entry.filename = filename;
-	entry.image->setUseTexture(false);
 	entry.name = filename;
-    
-	images_to_load_from_disk.send(entry);
+	entry.id = nextID;
+	entry.priority = priority;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		images_to_decode[entry_key(-priority, entry.id)] = std::move(entry);
+	}
+	condition.notify_one();
+	return nextID;
 }
 
 
 // Load an url asynchronously from an url.
 //--------------------------------------------------------------
-void ofxThreadedImageLoader::loadFromURL(ofImage& image, string url) {
+uint64_t ofxThreadedImageLoader::loadFromURL(ofImage& image, string url, int priority) {
 	nextID++;
 	ofImageLoaderEntry entry(image);
 	entry.url = url;
-	entry.image->setUseTexture(false);	
 	entry.name = "image" + ofToString(nextID);
+	entry.id = nextID;
+	entry.priority = priority;
+	entry.urlRequestId = ofLoadURLAsync(entry.url, entry.name);
 	images_async_loading[entry.name] = entry;
-	ofLoadURLAsync(entry.url, entry.name);
+	return nextID;
+}
+
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::setPriority(uint64_t id, int priority){
+	for(auto & it: images_async_loading){
+		if(it.second.id == id){
+			it.second.priority = priority;
+			return;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto it = images_to_decode.begin(); it != images_to_decode.end(); ++it){
+		if(it->second.id == id){
+			ofImageLoaderEntry entry = std::move(it->second);
+			images_to_decode.erase(it);
+			entry.priority = priority;
+			images_to_decode[entry_key(-priority, id)] = std::move(entry);
+			return;
+		}
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxThreadedImageLoader::cancel(uint64_t id){
+	for(auto it = images_async_loading.begin(); it != images_async_loading.end(); ++it){
+		if(it->second.id == id){
+			ofRemoveURLRequest(it->second.urlRequestId);
+			images_async_loading.erase(it);
+			return true;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto it = images_to_decode.begin(); it != images_to_decode.end(); ++it){
+		if(it->second.id == id){
+			images_to_decode.erase(it);
+			return true;
+		}
+	}
+	if(images_decoding.find(id) != images_decoding.end()){
+		// the worker drops it once decoded
+		images_cancelled.insert(id);
+		return true;
+	}
+	for(auto it = images_to_update.begin(); it != images_to_update.end(); ++it){
+		if(it->id == id){
+			images_to_update.erase(it);
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::cancel(const ofImage & image){
+	for(auto it = images_async_loading.begin(); it != images_async_loading.end();){
+		if(it->second.image == &image){
+			ofRemoveURLRequest(it->second.urlRequestId);
+			it = images_async_loading.erase(it);
+		}else{
+			++it;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto it = images_to_decode.begin(); it != images_to_decode.end();){
+		if(it->second.image == &image){
+			it = images_to_decode.erase(it);
+		}else{
+			++it;
+		}
+	}
+	for(auto & decoding: images_decoding){
+		if(decoding.second == &image){
+			images_cancelled.insert(decoding.first);
+		}
+	}
+	for(auto it = images_to_update.begin(); it != images_to_update.end();){
+		if(it->image == &image){
+			it = images_to_update.erase(it);
+		}else{
+			++it;
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::cancelAll(){
+	for(auto & it: images_async_loading){
+		ofRemoveURLRequest(it.second.urlRequestId);
+	}
+	images_async_loading.clear();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	images_to_decode.clear();
+	for(auto & decoding: images_decoding){
+		images_cancelled.insert(decoding.first);
+	}
+	images_to_update.clear();
 }
 
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::setMaxUploadBytesPerFrame(size_t bytes){
+	maxUploadBytes = bytes;
+}
+
+//--------------------------------------------------------------
+size_t ofxThreadedImageLoader::getMaxUploadBytesPerFrame() const{
+	return maxUploadBytes;
+}
+
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::setMaxUploadTimePerFrame(float ms){
+	maxUploadTime = ms;
+}
+
+//--------------------------------------------------------------
+float ofxThreadedImageLoader::getMaxUploadTimePerFrame() const{
+	return maxUploadTime;
+}
 
-// Reads from the queue and loads new images.
 //--------------------------------------------------------------
-void ofxThreadedImageLoader::threadedFunction() {
-	setThreadName("ofxThreadedImageLoader " + ofToString(thread.get_id()));
-	ofImageLoaderEntry entry;
-	while( images_to_load_from_disk.receive(entry) ) {
-		if(entry.image->load(entry.filename) )  {
-			images_to_update.send(entry);
+void ofxThreadedImageLoader::setStreamMipmaps(bool stream){
+#ifndef TARGET_OPENGLES
+	std::unique_lock<std::mutex> lock(mutex);
+	streamMipmaps = stream;
+#else
+	if(stream){
+		ofLogWarning("ofxThreadedImageLoader") << "setStreamMipmaps(): streaming mipmaps is not supported on OpenGL ES";
+	}
+#endif
+}
+
+//--------------------------------------------------------------
+bool ofxThreadedImageLoader::isStreamingMipmaps() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return streamMipmaps;
+}
+
+//--------------------------------------------------------------
+size_t ofxThreadedImageLoader::getNumPending() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return images_async_loading.size() + images_to_decode.size() + images_decoding.size() + images_to_update.size();
+}
+
+
+// Takes the entries with the highest priority from the queue and
+// decodes them, runs in every worker thread.
+//--------------------------------------------------------------
+void ofxThreadedImageLoader::decodeLoop() {
+	while(true){
+		ofImageLoaderEntry entry;
+		bool mipmaps;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]{ return closing || !images_to_decode.empty(); });
+			if(closing) break;
+			entry = std::move(images_to_decode.begin()->second);
+			images_to_decode.erase(images_to_decode.begin());
+			images_decoding[entry.id] = entry.image;
+			mipmaps = streamMipmaps;
+		}
+
+		// decode into the entry and not the image, the image is only
+		// touched from the main thread once it's uploaded
+		bool loaded;
+		if(entry.data.size()){
+			loaded = ofLoadImage(entry.pixels, entry.data);
+			entry.data.clear();
 		}else{
+			loaded = ofLoadImage(entry.pixels, entry.filename);
+		}
+		if(loaded && mipmaps){
+			while(true){
+				auto & last = entry.mipmaps.empty() ? entry.pixels : entry.mipmaps.back();
+				if(last.getWidth() <= 1 && last.getHeight() <= 1) break;
+				ofPixels next;
+				if(!last.halveTo(next)){
+					entry.mipmaps.clear();
+					break;
+				}
+				entry.mipmaps.push_back(std::move(next));
+			}
+			entry.nextLevel = entry.mipmaps.size();
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		images_decoding.erase(entry.id);
+		if(images_cancelled.erase(entry.id)){
+			continue;
+		}
+		if(loaded){
+			images_to_update.push_back(std::move(entry));
+		}else if(entry.url.empty()){
 			ofLogError("ofxThreadedImageLoader") << "couldn't load file: \"" << entry.filename << "\"";
+		}else{
+			ofLogError("ofxThreadedImageLoader") << "couldn't decode image from url: \"" << entry.url << "\"";
 		}
 	}
 	ofLogVerbose("ofxThreadedImageLoader") << "finishing thread on closed queue";
 }
 
 
-// When we receive an url response this method is called; 
+// When we receive an url response this method is called;
 // The loaded image is removed from the async_queue and added to the
-// update queue. The update queue is used to update the texture.
+// decode queue.
 //--------------------------------------------------------------
 void ofxThreadedImageLoader::urlResponse(ofHttpResponse & response) {
 	// this happens in the update thread so no need to lock to access
 	// images_async_loading
 	entry_iterator it = images_async_loading.find(response.request.name);
+	if(it == images_async_loading.end()) {
+		return;
+	}
 	if(response.status == 200) {
-		if(it != images_async_loading.end()) {
-			it->second.image->load(response.data);
-			images_to_update.send(it->second);
+		ofImageLoaderEntry entry = std::move(it->second);
+		entry.data = response.data;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			images_to_decode[entry_key(-entry.priority, entry.id)] = std::move(entry);
 		}
+		condition.notify_one();
 	}else{
 		// log error.
 		ofLogError("ofxThreadedImageLoader") << "couldn't load url, response status: " << response.status;
@@ -79,20 +334,54 @@ void ofxThreadedImageLoader::urlResponse(ofHttpResponse & response) {
 	}
 
 	// remove the entry from the queue
-	if(it != images_async_loading.end()) {
-		images_async_loading.erase(it);
-	}
+	images_async_loading.erase(it);
 }
 
 
-// Check the update queue and update the texture
+// Check the update queue and upload the textures, within the
+// per frame budget so we don't block the gl thread for too long
 //--------------------------------------------------------------
 void ofxThreadedImageLoader::update(ofEventArgs & a){
-    // Load 1 image per update so we don't block the gl thread for too long
-	ofImageLoaderEntry entry;
-	if (images_to_update.tryReceive(entry)) {
+	uint64_t start = ofGetElapsedTimeMicros();
+	size_t uploadedBytes = 0;
+	size_t numUploaded = 0;
+	while(true){
+		ofImageLoaderEntry entry;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if(images_to_update.empty()) break;
+			auto & front = images_to_update.front();
+			size_t bytes = front.nextLevel > 0 ? front.mipmaps[front.nextLevel - 1].getTotalBytes() : front.pixels.getTotalBytes();
+			if(numUploaded > 0 && maxUploadBytes > 0 && uploadedBytes + bytes > maxUploadBytes) break;
+			entry = std::move(images_to_update.front());
+			images_to_update.pop_front();
+		}
+
+		numUploaded++;
 		entry.image->setUseTexture(true);
-		entry.image->update();
+#ifndef TARGET_OPENGLES
+		if(entry.nextLevel > 0){
+			auto & texture = entry.image->getTexture();
+			auto & level = entry.mipmaps[entry.nextLevel - 1];
+			uploadedBytes += level.getTotalBytes();
+			if(entry.nextLevel == entry.mipmaps.size()){
+				// mipmaps need GL_TEXTURE_2D, ofImage::update() keeps the
+				// texture as long as the size and format don't change
+				texture.allocate(entry.pixels.getWidth(), entry.pixels.getHeight(), ofGetGlInternalFormat(entry.pixels), false);
+			}
+			texture.loadMipmapData(level, entry.nextLevel);
+			entry.nextLevel--;
+			// back of the queue so every image gets its small levels first
+			std::unique_lock<std::mutex> lock(mutex);
+			images_to_update.push_back(std::move(entry));
+		}else
+#endif
+		{
+			uploadedBytes += entry.pixels.getTotalBytes();
+			entry.image->getPixels() = std::move(entry.pixels);
+			entry.image->update();
+		}
+
+		if(maxUploadTime > 0 && (ofGetElapsedTimeMicros() - start) >= uint64_t(maxUploadTime * 1000)) break;
 	}
 }
-
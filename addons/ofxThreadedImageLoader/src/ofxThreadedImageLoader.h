@@ -3,33 +3,107 @@
 #include "ofThread.h"
 #include "ofImage.h"
 #include "ofURLFileLoader.h"
-#include "ofTypes.h" 
-#include "ofThreadChannel.h"
+#include "ofTypes.h"
+#include <condition_variable>
+#include <deque>
+#include <set>
 
 
 using namespace std;
 
-class ofxThreadedImageLoader : public ofThread {
+/// \brief Loads images in a pool of threads and uploads them to their
+/// textures from update(), a few per frame
+///
+/// Requests with a higher priority are decoded first, requests with the
+/// same priority in the order they were made. Every load returns an id
+/// that can be used to change its priority or cancel it while it's still
+/// pending. Decoded images are uploaded to the GPU within a per frame
+/// budget so a burst of loads doesn't stall the app.
+///
+/// The images passed are only touched from the main thread, once they
+/// are uploaded, so they can be drawn while loading, but have to be kept
+/// alive until the load finishes or is cancelled. All the methods have to
+/// be called from the main thread.
+class ofxThreadedImageLoader {
 public:
-    ofxThreadedImageLoader();
+    ofxThreadedImageLoader(size_t numThreads = 1);
     ~ofxThreadedImageLoader();
 
-	void loadFromDisk(ofImage& image, string file);
-	void loadFromURL(ofImage& image, string url);
+	/// \brief Loads an image from disk in one of the decoding threads
+	/// \returns an id for the request, to cancel it or change its priority
+	uint64_t loadFromDisk(ofImage& image, string file, int priority = 0);
 
+	/// \brief Downloads an image and decodes it in one of the decoding threads
+	/// \returns an id for the request, to cancel it or change its priority
+	uint64_t loadFromURL(ofImage& image, string url, int priority = 0);
 
+	/// \brief Changes the priority of a request that hasn't started decoding
+	void setPriority(uint64_t id, int priority);
+
+	/// \brief Cancels a request, the image won't be modified
+	///
+	/// \returns false if the request was already uploaded or doesn't exist
+	bool cancel(uint64_t id);
+
+	/// \brief Cancels every request for image
+	void cancel(const ofImage & image);
+
+	/// \brief Cancels every request
+	void cancelAll();
+
+	/// \brief Sets the number of decoding threads, restarting them
+	///
+	/// images being decoded are finished first, pending ones are kept
+	void setNumThreads(size_t numThreads);
+	size_t getNumThreads() const;
+
+	/// \brief Maximum bytes of pixels uploaded per frame, 0 for no limit
+	///
+	/// At least one image is uploaded every frame, even if it's bigger
+	void setMaxUploadBytesPerFrame(size_t bytes);
+	size_t getMaxUploadBytesPerFrame() const;
+
+	/// \brief Maximum milliseconds spent uploading per frame, 0 for no limit
+	///
+	/// 2ms by default. At least one image is uploaded every frame, even if
+	/// it takes longer.
+	void setMaxUploadTimePerFrame(float ms);
+	float getMaxUploadTimePerFrame() const;
+
+	/// \brief Uploads the mipmaps of each image from the smallest level up
+	///
+	/// The mipmap levels are computed in the decoding threads and uploaded
+	/// one per update, smallest first, with ofTexture::loadMipmapData(), so
+	/// images show blurry right after decoding and sharpen as the bigger
+	/// levels are uploaded. The levels of every pending image are uploaded
+	/// in turns so all the images show before any of them is complete.
+	///
+	/// The textures are allocated as GL_TEXTURE_2D, even with ARB textures
+	/// enabled. Disabled by default, not available on OpenGL ES.
+	void setStreamMipmaps(bool stream);
+	bool isStreamingMipmaps() const;
+
+	/// \brief Number of requests not uploaded yet
+	size_t getNumPending() const;
+
+	/// \brief Stops the decoding threads, dropping every request
+	void stopThread();
 
 private:
+	class Worker;
+
 	void update(ofEventArgs & a);
-    virtual void threadedFunction();
+	void decodeLoop();
+	void startThreads(size_t numThreads);
+	void stopThreads();
 	void urlResponse(ofHttpResponse & response);
-    
+
     // Entry to load.
     struct ofImageLoaderEntry {
         ofImageLoaderEntry() {
             image = NULL;
         }
-        
+
         ofImageLoaderEntry(ofImage & pImage) {
             image = &pImage;
         }
@@ -37,17 +111,33 @@ private:
         string filename;
         string url;
         string name;
+        ofBuffer data;
+        ofPixels pixels;
+        vector<ofPixels> mipmaps; // levels 1 to n when streaming mipmaps
+        size_t nextLevel = 0; // next mipmap level to upload, 0 for the pixels
+        uint64_t id = 0;
+        int priority = 0;
+        int urlRequestId = -1;
     };
 
-
+	// pending entries sorted by -priority so the highest comes first, then by id
+	typedef pair<int,uint64_t> entry_key;
     typedef map<string, ofImageLoaderEntry>::iterator entry_iterator;
 
-	int                 nextID;
-    int                 lastUpdate;
+	uint64_t            nextID;
+	size_t              maxUploadBytes;
+	float               maxUploadTime;
+	bool                streamMipmaps;
 
 	map<string,ofImageLoaderEntry> images_async_loading; // keeps track of images which are loading async
-	ofThreadChannel<ofImageLoaderEntry> images_to_load_from_disk;
-	ofThreadChannel<ofImageLoaderEntry> images_to_update;
-};
-
+	vector<unique_ptr<Worker>> workers;
 
+	// guarded by mutex
+	mutable std::mutex mutex;
+	std::condition_variable condition;
+	map<entry_key,ofImageLoaderEntry> images_to_decode;
+	map<uint64_t,const ofImage*> images_decoding;
+	set<uint64_t> images_cancelled;
+	deque<ofImageLoaderEntry> images_to_update;
+	bool closing;
+};
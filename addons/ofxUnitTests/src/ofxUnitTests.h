@@ -10,7 +10,75 @@
 #include "ofLog.h"
 #include "ofBaseApp.h"
 #include "ofAppRunner.h"
+#include "ofJson.h"
 #include <string>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <map>
+
+namespace ofxUnitTests{
+	/// \brief Number of allocations done with operator new since the start
+	/// of the program, only counted if OFX_UNIT_TESTS_COUNT_ALLOCATIONS is
+	/// defined.
+	inline std::atomic<uint64_t> & numAllocations(){
+		static std::atomic<uint64_t> allocations{0};
+		return allocations;
+	}
+}
+
+// To count allocations in benchmarks define OFX_UNIT_TESTS_COUNT_ALLOCATIONS
+// before including this file, in only one file of the app since it replaces
+// the global operator new and delete. Allocations are counted for every thread.
+// openFrameworks built with OF_ALLOCATION_TRACKING already replaces them, use
+// ofAllocationTracker instead in that case.
+#ifdef OFX_UNIT_TESTS_COUNT_ALLOCATIONS
+void * operator new(std::size_t size){
+	ofxUnitTests::numAllocations().fetch_add(1, std::memory_order_relaxed);
+	if(void * ptr = std::malloc(size ? size : 1)){
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void * operator new[](std::size_t size){
+	return ::operator new(size);
+}
+
+void operator delete(void * ptr) noexcept{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept{
+	std::free(ptr);
+}
+#endif
+
+/// \brief Result of ofxUnitTestsApp::benchmark(), times are in nanoseconds
+/// per iteration.
+struct ofxBenchmarkResult{
+	std::string name;
+	double median = 0;
+	double p95 = 0;
+	double p99 = 0;
+	double min = 0;
+	double max = 0;
+	uint64_t iterations = 0; ///< iterations per sample
+	size_t samples = 0;
+	/// allocations per iteration or -1 if OFX_UNIT_TESTS_COUNT_ALLOCATIONS
+	/// isn't defined
+	double allocations = -1;
+};
 
 class ofColorsLoggerChannel: public ofBaseLoggerChannel{
 	std::string CON_DEFAULT="\033[0m";
@@ -154,6 +222,144 @@ protected:
 
     virtual void run() = 0;
 
+	/// \brief Time a function and record it as a test
+	///
+	/// function is run for the warmup time and then numSamples times with
+	/// the number of iterations per sample scaled so the whole benchmark
+	/// takes about the time budget. If a baseline was loaded with
+	/// loadBenchmarkBaseline() the test fails when the median is slower than
+	/// the one in the baseline by more than the regression threshold.
+	///
+	/// ~~~~{.cpp}
+	/// benchmark("ofPixels::mirror 1080p", [&]{
+	///     pixels.mirror(true, false);
+	/// });
+	/// ~~~~
+	template<typename Function>
+	ofxBenchmarkResult benchmark(const std::string & name, Function && function){
+		using clock = std::chrono::steady_clock;
+		using nanos = std::chrono::duration<double, std::nano>;
+
+		// warm up caches and lazy initializations and measure how long an
+		// iteration takes to scale the number of iterations per sample
+		uint64_t warmupIterations = 0;
+		auto warmupStart = clock::now();
+		do{
+			function();
+			warmupIterations++;
+		}while(clock::now() - warmupStart < benchmarkWarmup);
+		nanos iterationTime = (clock::now() - warmupStart) / double(warmupIterations);
+
+		ofxBenchmarkResult result;
+		result.name = name;
+		result.samples = benchmarkSamples;
+		result.iterations = std::max<uint64_t>(1, uint64_t(nanos(benchmarkTimeBudget).count() / benchmarkSamples / std::max(iterationTime.count(), 1.)));
+
+		std::vector<double> samples;
+		samples.reserve(benchmarkSamples);
+		auto allocationsBefore = ofxUnitTests::numAllocations().load();
+		for(size_t s = 0; s < benchmarkSamples; s++){
+			auto start = clock::now();
+			for(uint64_t i = 0; i < result.iterations; i++){
+				function();
+			}
+			samples.push_back(nanos(clock::now() - start).count() / result.iterations);
+		}
+#ifdef OFX_UNIT_TESTS_COUNT_ALLOCATIONS
+		auto allocations = ofxUnitTests::numAllocations().load() - allocationsBefore;
+		result.allocations = double(allocations) / (result.iterations * benchmarkSamples);
+#else
+		(void)allocationsBefore;
+#endif
+
+		std::sort(samples.begin(), samples.end());
+		auto percentile = [&](double p){
+			return samples[std::min(samples.size() - 1, size_t(p * samples.size()))];
+		};
+		result.median = percentile(0.5);
+		result.p95 = percentile(0.95);
+		result.p99 = percentile(0.99);
+		result.min = samples.front();
+		result.max = samples.back();
+		benchmarkResults.push_back(result);
+
+		std::stringstream msg;
+		msg << name << ": median " << result.median << "ns, p95 " << result.p95 << "ns, p99 " << result.p99 << "ns";
+		if(result.allocations >= 0){
+			msg << ", " << result.allocations << " allocations";
+		}
+
+		auto baseline = benchmarkBaseline.find(name);
+		if(baseline != benchmarkBaseline.end()){
+			auto change = result.median / baseline->second - 1;
+			msg << " (" << (change >= 0 ? "+" : "") << change * 100 << "% from baseline)";
+			do_test(change <= benchmarkRegressionThreshold, msg.str(),
+				"slower than baseline " + ofToString(baseline->second) + "ns by more than " + ofToString(benchmarkRegressionThreshold * 100) + "%",
+				__FILE__, __LINE__);
+		}else{
+			do_test(true, msg.str(), __FILE__, __LINE__);
+		}
+		return result;
+	}
+
+	/// \brief Total time each benchmark() runs for, excluding the warmup
+	void setBenchmarkTimeBudget(std::chrono::nanoseconds timeBudget){
+		benchmarkTimeBudget = timeBudget;
+	}
+
+	void setBenchmarkWarmup(std::chrono::nanoseconds warmup){
+		benchmarkWarmup = warmup;
+	}
+
+	/// \brief Number of samples the median and percentiles are taken from
+	void setBenchmarkSamples(size_t samples){
+		benchmarkSamples = std::max<size_t>(samples, 1);
+	}
+
+	/// \brief Fraction by which a median can be slower than the baseline
+	/// before the benchmark fails, 0.1 by default
+	void setBenchmarkRegressionThreshold(double threshold){
+		benchmarkRegressionThreshold = threshold;
+	}
+
+	/// \brief Load the medians to compare against from a file written by
+	/// saveBenchmarkResults()
+	bool loadBenchmarkBaseline(const std::filesystem::path & path){
+		auto json = ofLoadJson(path);
+		if(!json.is_object() || !json["benchmarks"].is_array()){
+			ofLogWarning() << "couldn't load benchmark baseline from " << path;
+			return false;
+		}
+		benchmarkBaseline.clear();
+		for(auto & entry: json["benchmarks"]){
+			benchmarkBaseline[entry["name"].get<std::string>()] = entry["median_ns"].get<double>();
+		}
+		return true;
+	}
+
+	/// \brief Save the results of every benchmark() run so far as json
+	bool saveBenchmarkResults(const std::filesystem::path & path, const ofJson & extraInfo = ofJson::object()){
+		ofJson json = extraInfo;
+		json["benchmarks"] = ofJson::array();
+		for(auto & result: benchmarkResults){
+			ofJson entry = {
+				{"name", result.name},
+				{"median_ns", result.median},
+				{"p95_ns", result.p95},
+				{"p99_ns", result.p99},
+				{"min_ns", result.min},
+				{"max_ns", result.max},
+				{"iterations", result.iterations},
+				{"samples", result.samples},
+			};
+			if(result.allocations >= 0){
+				entry["allocations"] = result.allocations;
+			}
+			json["benchmarks"].push_back(entry);
+		}
+		return ofSaveJson(path, json);
+	}
+
 	bool do_test(bool test, const std::string & testName, const std::string & msg, const std::string & file, int line){
 		numTestsTotal++;
 		if(test){
@@ -299,6 +505,12 @@ private:
 	int numTestsTotal = 0;
 	int numTestsPassed = 0;
 	int numTestsFailed = 0;
+	std::chrono::nanoseconds benchmarkTimeBudget = std::chrono::milliseconds(500);
+	std::chrono::nanoseconds benchmarkWarmup = std::chrono::milliseconds(50);
+	size_t benchmarkSamples = 100;
+	double benchmarkRegressionThreshold = 0.1;
+	std::map<std::string, double> benchmarkBaseline;
+	std::vector<ofxBenchmarkResult> benchmarkResults;
     std::shared_ptr<ofColorsLoggerChannel> logger{new ofColorsLoggerChannel};
 };
 
@@ -56,6 +56,58 @@ ofxXmlSettings::~ofxXmlSettings()
 {
 }
 
+//---------------------------------------------------------
+const vector<TiXmlElement*> & ofxXmlSettings::getChildren(TiXmlNode * parent, const string & tag) const{
+	auto & children = index.children[parent];
+	auto found = children.find(tag);
+	if(found == children.end()){
+		// one walk over the siblings per parent and tag instead of one per
+		// lookup, so reading the nth tag doesn't walk the n before it
+		auto & elements = children[tag];
+		for(TiXmlElement * child = parent->FirstChildElement(tag); child; child = child->NextSiblingElement(tag)){
+			elements.push_back(child);
+		}
+		return elements;
+	}
+	return found->second;
+}
+
+//---------------------------------------------------------
+TiXmlElement * ofxXmlSettings::findChild(TiXmlNode * parent, const string & tag, int which) const{
+	if(!parent) return nullptr;
+	if(which < 0) which = 0;
+	auto & elements = getChildren(parent, tag);
+	return which < (int)elements.size() ? elements[which] : nullptr;
+}
+
+//---------------------------------------------------------
+TiXmlNode * ofxXmlSettings::findTag(const vector<string> & tokens, int which) const{
+	TiXmlNode * node = storedHandle.ToNode();
+	for(int x=0;x<(int)tokens.size() && node;x++){
+		//we only support multi tags
+		//with same name at root level
+		node = findChild(node, tokens.at(x), x == 0 ? which : 0);
+	}
+	return node;
+}
+
+//---------------------------------------------------------
+void ofxXmlSettings::addToIndex(TiXmlNode * parent, const string & tag, TiXmlNode * child){
+	if(!child || !child->ToElement()) return;
+	auto children = index.children.find(parent);
+	if(children != index.children.end()){
+		auto elements = children->second.find(tag);
+		if(elements != children->second.end()){
+			elements->second.push_back(child->ToElement());
+		}
+	}
+}
+
+//---------------------------------------------------------
+void ofxXmlSettings::clearIndex(){
+	index.children.clear();
+}
+
 //---------------------------------------------------------
 void ofxXmlSettings::setVerbose(bool _verbose){
 }
@@ -69,6 +121,7 @@ void ofxXmlSettings::clear(){
 	//node - including the node itself!
 
 	storedHandle.ToNode()->Clear();
+	clearIndex();
 }
 
 //---------------------------------------------------------
@@ -86,6 +139,7 @@ bool ofxXmlSettings::loadFile(const string& xmlFile){
 	level = 0;
 
 	storedHandle = TiXmlHandle(&doc);
+	clearIndex();
 	return loadOkay;
 }
 
@@ -138,7 +192,7 @@ void ofxXmlSettings::removeTag(const string& tag, int which){
 		//with same name at root level
 		if(x > 0) which = 0;
 
-		TiXmlHandle isRealHandle = tagHandle.ChildElement( tokens.at(x), which);
+		TiXmlHandle isRealHandle(findChild(tagHandle.ToNode(), tokens.at(x), which));
 
 		if ( !isRealHandle.ToNode() ) break;
 		else{
@@ -146,6 +200,9 @@ void ofxXmlSettings::removeTag(const string& tag, int which){
 				//if we are at the last tag and it exists
 				//we use its parent to remove it - haha
 				tagHandle.ToNode()->RemoveChild( isRealHandle.ToNode() );
+				//the removed tag and everything inside it are deleted
+				clearIndex();
+				break;
 			}
 			tagHandle = isRealHandle;
 		}
@@ -179,16 +236,48 @@ string ofxXmlSettings::getValue(const string& tag, const string& defaultValue, i
 	return defaultValue;
 }
 
+//---------------------------------------------------------
+vector<int> ofxXmlSettings::getValues(const string& tag, int defaultValue) const{
+	vector<int> values(getNumTags(tag), defaultValue);
+	TiXmlHandle valHandle(NULL);
+	for(int i=0;i<(int)values.size();i++){
+		if (readTag(tag, valHandle, i)){
+			values[i] = ofToInt(valHandle.ToText()->Value());
+		}
+	}
+	return values;
+}
+
+//---------------------------------------------------------
+vector<double> ofxXmlSettings::getValues(const string& tag, double defaultValue) const{
+	vector<double> values(getNumTags(tag), defaultValue);
+	TiXmlHandle valHandle(NULL);
+	for(int i=0;i<(int)values.size();i++){
+		if (readTag(tag, valHandle, i)){
+			values[i] = ofToDouble(valHandle.ToText()->Value());
+		}
+	}
+	return values;
+}
+
+//---------------------------------------------------------
+vector<string> ofxXmlSettings::getValues(const string& tag, const string& defaultValue) const{
+	vector<string> values(getNumTags(tag), defaultValue);
+	TiXmlHandle valHandle(NULL);
+	for(int i=0;i<(int)values.size();i++){
+		if (readTag(tag, valHandle, i)){
+			values[i] = valHandle.ToText()->ValueStr();
+		}
+	}
+	return values;
+}
+
 //---------------------------------------------------------
 bool ofxXmlSettings::readTag(const string&  tag, TiXmlHandle& valHandle, int which) const{
 
 	vector<string> tokens = tokenize(tag,":");
 
-	TiXmlHandle tagHandle = storedHandle;
-	for(int x=0;x<(int)tokens.size();x++){
-		if(x == 0)tagHandle = tagHandle.ChildElement(tokens.at(x), which);
-		else tagHandle = tagHandle.FirstChildElement( tokens.at(x) );
-	}
+	TiXmlHandle tagHandle(findTag(tokens, which));
 
 	// once we've walked, let's get that value...
 	valHandle = tagHandle.Child( 0 );
@@ -205,7 +294,7 @@ bool ofxXmlSettings::pushTag(const string&  tag, int which){
     string tagToFind((pos > 0) ? tag.substr(0,pos) :tag);
 
 	//we only allow to push one tag at a time.
-	TiXmlHandle isRealHandle = storedHandle.ChildElement(tagToFind, which);
+	TiXmlHandle isRealHandle(findChild(storedHandle.ToNode(), tagToFind, which));
 
 	if( isRealHandle.ToNode() ){
 		storedHandle = isRealHandle;
@@ -257,7 +346,7 @@ bool ofxXmlSettings::tagExists(const string& tag, int which) const{
 		//with same name at root level
 		if(x > 0) which = 0;
 
-		TiXmlHandle isRealHandle = tagHandle.ChildElement( tokens.at(x), which);
+		TiXmlHandle isRealHandle(findChild(tagHandle.ToNode(), tokens.at(x), which));
 
 		//as soon as we find a tag that doesn't exist
 		//we return false;
@@ -288,17 +377,7 @@ int ofxXmlSettings::getNumTags(const string&  tag) const{
 	//normally this is the doc but could be a pushed node
 	//TiXmlHandle tagHandle = storedHandle;
 
-	int count = 0;
-
-	//ripped from tinyXML as doing this ourselves once is a LOT! faster
-	//than having this called n number of times in a while loop - we go from n*n iterations to n iterations
-
-	TiXmlElement* child = ( storedHandle.FirstChildElement( tagToFind ) ).ToElement();
-	for (count = 0; child; child = child->NextSiblingElement( tagToFind ), ++count){
-		//nothing
-	}
-
-	return count;
+	return getChildren(storedHandle.ToNode(), tagToFind).size();
 }
 
 
@@ -333,7 +412,7 @@ int ofxXmlSettings::writeTag(const string&  tag, const string& valueStr, int whi
 			addNewTag = false;
 		}
 
-		TiXmlHandle isRealHandle = tagHandle.ChildElement( tokens.at(x), which);
+		TiXmlHandle isRealHandle(findChild(tagHandle.ToNode(), tokens.at(x), which));
 
 		if ( !isRealHandle.ToNode() ||  addNewTag){
 
@@ -345,7 +424,7 @@ int ofxXmlSettings::writeTag(const string&  tag, const string& valueStr, int whi
 				}
 			}
 
-			tagHandle.ToNode()->InsertEndChild(elements[x]);
+			addToIndex(tagHandle.ToNode(), tokens.at(x), tagHandle.ToNode()->InsertEndChild(elements[x]));
 
 			break;
 
@@ -353,24 +432,18 @@ int ofxXmlSettings::writeTag(const string&  tag, const string& valueStr, int whi
 			 tagHandle = isRealHandle;
 			 if (x == (int)tokens.size()-1){
 				// what we want to change : TiXmlHandle valHandle = tagHandle.Child( 0 );
+				bool hadChildTags = tagHandle.ToNode()->FirstChildElement() != nullptr;
 				tagHandle.ToNode()->Clear();
 				tagHandle.ToNode()->InsertEndChild(Value);
+				if(hadChildTags) clearIndex();
 			}
 		}
 	}
 
 
 	//lets count how many tags with our name exist so we can return an index
-
-	//ripped from tinyXML as doing this ourselves once is a LOT! faster
-	//than having this called n number of times in a while loop - we go from n*n iterations to n iterations
-	int numSameTags;
-	TiXmlElement* child = ( storedHandle.FirstChildElement( tokens.at(0) ) ).ToElement();
-	for (numSameTags = 0; child; child = child->NextSiblingElement( tokens.at(0) ), ++numSameTags){
-		//nothing
-	}
-
-	return numSameTags;
+	if(tokens.empty()) return 0;
+	return getChildren(storedHandle.ToNode(), tokens.at(0)).size();
 }
 
 //---------------------------------------------------------
@@ -456,13 +529,7 @@ int ofxXmlSettings::addAttribute(const string& tag, const string& attribute, con
 //---------------------------------------------------------
 void ofxXmlSettings::removeAttribute(const string& tag, const string& attribute, int which){
 	vector<string> tokens = tokenize(tag,":");
-	TiXmlHandle tagHandle = storedHandle;
-	for (int x = 0; x < (int)tokens.size(); x++) {
-		if (x == 0)
-			tagHandle = tagHandle.ChildElement(tokens.at(x), which);
-		else
-			tagHandle = tagHandle.FirstChildElement(tokens.at(x));
-	}
+	TiXmlHandle tagHandle(findTag(tokens, which));
 
 	if (tagHandle.ToElement()) {
 		TiXmlElement* elem = tagHandle.ToElement();
@@ -481,13 +548,7 @@ void ofxXmlSettings::clearTagAttributes(const string& tag, int which){
 //---------------------------------------------------------
 int ofxXmlSettings::getNumAttributes(const string& tag, int which) const{
 	vector<string> tokens = tokenize(tag,":");
-	TiXmlHandle tagHandle = storedHandle;
-	for (int x = 0; x < (int)tokens.size(); x++) {
-		if (x == 0)
-			tagHandle = tagHandle.ChildElement(tokens.at(x), which);
-		else
-			tagHandle = tagHandle.FirstChildElement(tokens.at(x));
-	}
+	TiXmlHandle tagHandle(findTag(tokens, which));
 
 	if (tagHandle.ToElement()) {
 		TiXmlElement* elem = tagHandle.ToElement();
@@ -507,13 +568,7 @@ int ofxXmlSettings::getNumAttributes(const string& tag, int which) const{
 //---------------------------------------------------------
 bool ofxXmlSettings::attributeExists(const string& tag, const string& attribute, int which) const{
 	vector<string> tokens = tokenize(tag,":");
-	TiXmlHandle tagHandle = storedHandle;
-	for (int x = 0; x < (int)tokens.size(); x++) {
-		if (x == 0)
-			tagHandle = tagHandle.ChildElement(tokens.at(x), which);
-		else
-			tagHandle = tagHandle.FirstChildElement(tokens.at(x));
-	}
+	TiXmlHandle tagHandle(findTag(tokens, which));
 
 	if (tagHandle.ToElement()) {
 		TiXmlElement* elem = tagHandle.ToElement();
@@ -530,13 +585,7 @@ bool ofxXmlSettings::attributeExists(const string& tag, const string& attribute,
 //---------------------------------------------------------
 bool ofxXmlSettings::getAttributeNames(const string& tag, vector<string>& outNames, int which) const{
 	vector<string> tokens = tokenize(tag,":");
-	TiXmlHandle tagHandle = storedHandle;
-	for (int x = 0; x < (int)tokens.size(); x++) {
-		if (x == 0)
-			tagHandle = tagHandle.ChildElement(tokens.at(x), which);
-		else
-			tagHandle = tagHandle.FirstChildElement(tokens.at(x));
-	}
+	TiXmlHandle tagHandle(findTag(tokens, which));
 
 	if (tagHandle.ToElement()) {
 		TiXmlElement* elem = tagHandle.ToElement();
@@ -594,13 +643,7 @@ int ofxXmlSettings::setAttribute(const string& tag, const string& attribute, con
 //---------------------------------------------------------
 TiXmlElement* ofxXmlSettings::getElementForAttribute(const string& tag, int which) const{
 	vector<string> tokens = tokenize(tag,":");
-	TiXmlHandle tagHandle = storedHandle;
-	for (int x = 0; x < (int)tokens.size(); x++) {
-		if (x == 0)
-			tagHandle = tagHandle.ChildElement(tokens.at(x), which);
-		else
-			tagHandle = tagHandle.FirstChildElement(tokens.at(x));
-	}
+	TiXmlHandle tagHandle(findTag(tokens, which));
     return tagHandle.ToElement();
 }
 
@@ -641,13 +684,7 @@ bool ofxXmlSettings::readStringAttribute(const string& tag, const string& attrib
 //---------------------------------------------------------
 int ofxXmlSettings::writeAttribute(const string& tag, const string& attribute, const string& valueString, int which){
 	vector<string> tokens = tokenize(tag,":");
-	TiXmlHandle tagHandle = storedHandle;
-	for (int x = 0; x < (int)tokens.size(); x++) {
-		if (x == 0)
-			tagHandle = tagHandle.ChildElement(tokens.at(x), which);
-		else
-			tagHandle = tagHandle.FirstChildElement(tokens.at(x));
-	}
+	TiXmlHandle tagHandle(findTag(tokens, which));
 
 	int ret = 0;
 	if (tagHandle.ToElement()) {
@@ -656,12 +693,7 @@ int ofxXmlSettings::writeAttribute(const string& tag, const string& attribute, c
 
         // Do we really need this?  We could just ignore this and remove the 'addAttribute' functions...
 		// Now, just get the ID.
-		int numSameTags;
-		TiXmlElement* child = ( storedHandle.FirstChildElement( tokens.at(0) ) ).ToElement();
-		for (numSameTags = 0; child; child = child->NextSiblingElement( tokens.at(0) ), ++numSameTags) {
-			// nothing
-		}
-		ret = numSameTags;
+		ret = tokens.empty() ? 0 : getChildren(storedHandle.ToNode(), tokens.at(0)).size();
 	}
 	return ret;
 }
@@ -673,6 +705,7 @@ bool ofxXmlSettings::loadFromBuffer( string buffer )
     bool loadOkay = doc.ReadFromMemory( buffer.c_str(), size);//, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING);
     storedHandle = TiXmlHandle(&doc);
     level = 0;
+    clearIndex();
     return loadOkay;
 }
 
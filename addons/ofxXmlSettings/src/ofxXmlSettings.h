@@ -2,6 +2,7 @@
 
 #include "ofMain.h"
 #include <string.h>
+#include <unordered_map>
 #if (_MSC_VER)
 #include "../libs/tinyxml.h"
 #else
@@ -78,6 +79,14 @@ class ofxXmlSettings{
 		int 	setValue(const string&  tag, double         value, int which = 0);
 		int 	setValue(const string&  tag, const string& 	value, int which = 0);
 
+		//-- getValues
+		//reads the values of all the tags with this name at the current
+		//root level at once, the value at position n is the same as
+		//getValue(tag, defaultValue, n)
+		vector<int> 	getValues(const string&  tag, int            defaultValue) const;
+		vector<double> 	getValues(const string&  tag, double         defaultValue) const;
+		vector<string> 	getValues(const string&  tag, const string& 	defaultValue) const;
+
 		//advanced
 
 		//-- pushTag/popTag
@@ -146,6 +155,9 @@ class ofxXmlSettings{
 		bool	loadFromBuffer( string buffer );
 		void	copyXmlToString(string & str) const;
 
+		//lookups keep an index of the tags in doc so they don't walk it
+		//from the root every time, removing tags from doc directly instead
+		//of with removeTag or clear leaves the index pointing to them
 		TiXmlDocument 	doc;
 		bool 			bDocLoaded;
 
@@ -154,6 +166,23 @@ class ofxXmlSettings{
 		TiXmlHandle     storedHandle;
 		int             level;
 
+		//the tags with each name inside each node, built the first time
+		//they are looked up and discarded when tags are removed. copies
+		//start with an empty index since it points into the original doc
+		struct TagIndex{
+			TagIndex(){}
+			TagIndex(const TagIndex &){}
+			TagIndex & operator=(const TagIndex &){ children.clear(); return *this; }
+			std::unordered_map<const TiXmlNode*, std::unordered_map<string, vector<TiXmlElement*>>> children;
+		};
+		mutable TagIndex index;
+
+		const vector<TiXmlElement*> & getChildren(TiXmlNode * parent, const string & tag) const;
+		TiXmlElement * findChild(TiXmlNode * parent, const string & tag, int which) const;
+		TiXmlNode * findTag(const vector<string> & tokens, int which) const;
+		void addToIndex(TiXmlNode * parent, const string & tag, TiXmlNode * child);
+		void clearIndex();
+
 
 		int 	writeTag(const string&  tag, const string& valueString, int which = 0);
 		bool 	readTag(const string&  tag, TiXmlHandle& valHandle, int which = 0) const;	// max 1024 chars...
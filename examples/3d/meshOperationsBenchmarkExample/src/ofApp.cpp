@@ -0,0 +1,84 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	ofSetVerticalSync(true);
+	ofBackground(30);
+	resolution = 500;
+	runBenchmark();
+}
+
+//--------------------------------------------------------------
+void ofApp::runBenchmark(){
+	timings.clear();
+
+	// a wavy plane so welding finds shared vertices and smoothing has
+	// faces at different angles
+	ofMesh plane = ofMesh::plane(1000, 1000, resolution, resolution, OF_PRIMITIVE_TRIANGLES);
+	for(auto & v: plane.getVertices()){
+		v.z = sin(v.x * 0.02f) * cos(v.y * 0.02f) * 50;
+	}
+
+	auto time = [this](const std::string & name, std::function<void()> f){
+		uint64_t start = ofGetElapsedTimeMicros();
+		f();
+		timings.emplace_back(name, (ofGetElapsedTimeMicros() - start) / 1000.f);
+	};
+
+	std::vector<ofDefaultNormalType> faceNormals;
+	time("getFaceNormals()", [&]{
+		faceNormals = plane.getFaceNormals();
+	});
+
+	std::vector<ofMeshFace> faces;
+	time("getUniqueFaces()", [&]{
+		faces = plane.getUniqueFaces();
+	});
+
+	ofMesh fromTriangles;
+	time("setFromTriangles()", [&]{
+		fromTriangles.setFromTriangles(faces);
+	});
+
+	time("smoothNormals()", [&]{
+		plane.smoothNormals(60);
+	});
+
+	mesh = plane;
+	for(auto & timing: timings){
+		ofLogNotice("meshOperationsBenchmark") << plane.getNumIndices() / 3 << " triangles, " << timing.first << ": " << timing.second << "ms";
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+	ofEnableDepthTest();
+	light.enable();
+	cam.begin();
+	ofSetColor(200);
+	mesh.draw();
+	cam.end();
+	light.disable();
+	ofDisableLighting();
+	ofDisableDepthTest();
+
+	ofSetColor(255);
+	std::stringstream info;
+	info << mesh.getNumIndices() / 3 << " triangles, " << ofGetTaskPool().getNumThreads() + 1 << " threads" << endl << endl;
+	for(auto & timing: timings){
+		info << timing.first << ": " << timing.second << "ms" << endl;
+	}
+	info << endl << "+/- to change the resolution";
+	ofDrawBitmapString(info.str(), 20, 20);
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+	if(key == '+' || key == '='){
+		resolution *= 2;
+		runBenchmark();
+	}else if(key == '-' && resolution > 10){
+		resolution /= 2;
+		runBenchmark();
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ofMain.h"
+
+class ofApp : public ofBaseApp{
+
+	public:
+		void setup();
+		void draw();
+		void keyPressed(int key);
+
+		// builds a plane with the current resolution and times the
+		// mesh operations on it
+		void runBenchmark();
+
+		ofEasyCam cam;
+		ofVboMesh mesh;
+		ofLight light;
+		int resolution;
+		std::vector<std::pair<std::string, float>> timings;
+};
@@ -68,15 +68,16 @@ void ofApp::update(){
 	compute.setUniform3f("attractor2",atractor2.x,atractor2.y,atractor2.z);
 	compute.setUniform3f("attractor3",atractor3.x,atractor3.y,atractor3.z);
 	
-	// since each work group has a local_size of 1024 (this is defined in the shader)
-	// we only have to issue 1 / 1024 workgroups to cover the full workload.
-	// note how we add 1024 and subtract one, this is a fast way to do the equivalent
-	// of std::ceil() in the float domain, i.e. to round up, so that we're also issueing
-	// a work group should the total size of particles be < 1024
-	compute.dispatchCompute((particles.size() + 1024 -1 )/1024, 1, 1);
+	// each work group has a local_size of 1024 (this is defined in the shader),
+	// dispatchComputeForSize issues enough work groups to have one invocation
+	// per particle, rounding up so there's at least one work group
+	compute.dispatchComputeForSize(particles.size());
 	
 	compute.end();
 
+	// wait for the shader to write the buffer before copying and drawing it
+	ofShader::memoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
 	particlesBuffer.copyTo(particlesBuffer2);
 }
 
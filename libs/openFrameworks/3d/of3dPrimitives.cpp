@@ -8,12 +8,30 @@
 
 #include "of3dPrimitives.h"
 #include "ofGraphics.h"
+#include <mutex>
 
 using namespace std;
 
+namespace{
+	// meshes shared between primitives by type and parameters, only kept
+	// while some primitive uses them
+	struct SharedMeshes{
+		std::mutex mutex;
+		std::map<std::pair<std::string, std::vector<float>>, std::weak_ptr<ofMesh>> meshes;
+		size_t sizeAtLastPrune = 0;
+	};
+
+	SharedMeshes & sharedMeshes(){
+		static SharedMeshes * meshes = new SharedMeshes;
+		return *meshes;
+	}
+}
+
 of3dPrimitive::of3dPrimitive()
 :usingVbo(true)
 ,mesh(new ofVboMesh)
+,sharedMesh(false)
+,boundsDirty(true)
 {
     setScale(1.0, 1.0, 1.0);
 }
@@ -27,18 +45,26 @@ of3dPrimitive::~of3dPrimitive() {
 of3dPrimitive::of3dPrimitive(const of3dPrimitive & mom):ofNode(mom){
     texCoords = mom.texCoords;
     usingVbo = mom.usingVbo;
-	if(usingVbo){
-		mesh = std::make_shared<ofVboMesh>();
+	sharedMesh = mom.sharedMesh;
+	if(sharedMesh){
+		mesh = mom.mesh;
 	}else{
-		mesh = std::make_shared<ofMesh>();
+		if(usingVbo){
+			mesh = std::make_shared<ofVboMesh>();
+		}else{
+			mesh = std::make_shared<ofMesh>();
+		}
+		*mesh = *mom.mesh;
 	}
-	*mesh = *mom.mesh;
+	boundsDirty = true;
 }
 
 //----------------------------------------------------------
 of3dPrimitive::of3dPrimitive(const ofMesh & mesh)
 :usingVbo(true)
-,mesh(new ofVboMesh(mesh)){
+,mesh(new ofVboMesh(mesh))
+,sharedMesh(false)
+,boundsDirty(true){
 
 }
 
@@ -47,8 +73,16 @@ of3dPrimitive & of3dPrimitive::operator=(const of3dPrimitive & mom){
 	if(&mom!=this){
 		(*(ofNode*)this)=mom;
 		texCoords = mom.texCoords;
-		setUseVbo(mom.usingVbo);
-		*mesh = *mom.mesh;
+		if(mom.sharedMesh){
+			usingVbo = mom.usingVbo;
+			mesh = mom.mesh;
+			sharedMesh = true;
+		}else{
+			setUseVbo(mom.usingVbo);
+			unshareMesh();
+			*mesh = *mom.mesh;
+		}
+		boundsDirty = true;
 	}
     return *this;
 }
@@ -56,14 +90,81 @@ of3dPrimitive & of3dPrimitive::operator=(const of3dPrimitive & mom){
 // GETTERS //
 //----------------------------------------------------------
 ofMesh* of3dPrimitive::getMeshPtr() {
+    // the mesh can be modified through it
+    unshareMesh();
+    boundsDirty = true;
     return mesh.get();
 }
 
 //----------------------------------------------------------
 ofMesh& of3dPrimitive::getMesh() {
+    unshareMesh();
+    boundsDirty = true;
     return *mesh;
 }
 
+//----------------------------------------------------------
+void of3dPrimitive::unshareMesh(){
+	if(sharedMesh){
+		const ofMesh & shared = *mesh;
+		if(usingVbo){
+			mesh = std::make_shared<ofVboMesh>(shared);
+		}else{
+			mesh = std::make_shared<ofMesh>(shared);
+		}
+		sharedMesh = false;
+	}
+}
+
+//----------------------------------------------------------
+void of3dPrimitive::setSharedMesh(const std::string & type, std::initializer_list<float> parameters, const std::function<ofMesh()> & generate){
+	boundsDirty = true;
+	if(!usingVbo){
+		unshareMesh();
+		*mesh = generate();
+		return;
+	}
+
+	auto & cache = sharedMeshes();
+	auto key = std::make_pair(type, std::vector<float>(parameters));
+	{
+		std::unique_lock<std::mutex> lock(cache.mutex);
+		auto cached = cache.meshes[key].lock();
+		if(cached){
+			mesh = cached;
+			sharedMesh = true;
+			return;
+		}
+	}
+
+	// generated outside of the lock, if another thread generates the
+	// same mesh meanwhile the first one stays in the cache
+	std::shared_ptr<ofMesh> generated = std::make_shared<ofVboMesh>(generate());
+	std::unique_lock<std::mutex> lock(cache.mutex);
+	auto & cached = cache.meshes[key];
+	auto existing = cached.lock();
+	if(existing){
+		mesh = existing;
+	}else{
+		cached = generated;
+		mesh = generated;
+	}
+	sharedMesh = true;
+
+	// forget the meshes no primitive uses anymore every time the cache
+	// doubles its size
+	if(cache.meshes.size() > std::max<size_t>(cache.sizeAtLastPrune * 2, 64)){
+		for(auto it = cache.meshes.begin(); it != cache.meshes.end();){
+			if(it->second.expired()){
+				it = cache.meshes.erase(it);
+			}else{
+				++it;
+			}
+		}
+		cache.sizeAtLastPrune = cache.meshes.size();
+	}
+}
+
 //----------------------------------------------------------
 const ofMesh* of3dPrimitive::getMeshPtr() const{
     return mesh.get();
@@ -182,7 +283,10 @@ void of3dPrimitive::normalizeAndApplySavedTexCoords() {
     // when a new mesh is created, it uses normalized tex coords, we need to reset them
     // but save the ones used previously //
 	texCoords = {0.f, 0.f, 1.f, 1.f};
-    mapTexCoords(tcoords.x, tcoords.y, tcoords.z, tcoords.w);
+    // mapping to the normalized ones does nothing and would unshare the mesh
+    if(tcoords != texCoords){
+        mapTexCoords(tcoords.x, tcoords.y, tcoords.z, tcoords.w);
+    }
 }
 
 
@@ -276,6 +380,7 @@ void of3dPrimitive::setUseVbo(bool useVbo){
 		}
 		*newMesh = *mesh;
 		mesh = newMesh;
+		sharedMesh = false;
 	}
 	usingVbo = useVbo;
 }
@@ -285,6 +390,25 @@ bool of3dPrimitive::isUsingVbo() const{
 	return usingVbo;
 }
 
+//--------------------------------------------------------------
+const ofBoundingBox & of3dPrimitive::getBoundingBox() const{
+	if(boundsDirty){
+		bounds = ofBoundingBox(mesh->getVertices());
+		boundsDirty = false;
+	}
+	return bounds;
+}
+
+//--------------------------------------------------------------
+ofBoundingBox of3dPrimitive::getGlobalBoundingBox() const{
+	return getBoundingBox().getTransformed(getGlobalTransformMatrix());
+}
+
+//--------------------------------------------------------------
+ofBoundingSphere of3dPrimitive::getGlobalBoundingSphere() const{
+	return ofBoundingSphere(getGlobalBoundingBox());
+}
+
 // PLANE PRIMITIVE //
 //--------------------------------------------------------------
 ofPlanePrimitive::ofPlanePrimitive() {
@@ -308,7 +432,9 @@ void ofPlanePrimitive::set(float _width, float _height, int columns, int rows, o
     height = _height;
 	resolution = { columns, rows };
     
-    getMesh() = ofMesh::plane( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
+    setSharedMesh("plane", {getWidth(), getHeight(), getResolution().x, getResolution().y, float(mode)}, [&]{
+        return ofMesh::plane( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
+    });
     
     normalizeAndApplySavedTexCoords();
     
@@ -351,14 +477,14 @@ void ofPlanePrimitive::setRows( int rows ) {
 //--------------------------------------------------------------
 void ofPlanePrimitive::setResolution( int columns, int rows ) {
 	resolution = { columns, rows };
-    ofPrimitiveMode mode = getMesh().getMode();
+    ofPrimitiveMode mode = mesh->getMode();
     
     set( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
 }
 
 //--------------------------------------------------------------
 void ofPlanePrimitive::setMode(ofPrimitiveMode mode) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     
     if( mode != currMode )
         set( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
@@ -418,7 +544,9 @@ void ofSpherePrimitive::set( float _radius, int res, ofPrimitiveMode mode ) {
     radius     = _radius;
     resolution = res;
 
-    getMesh() = ofMesh::sphere( getRadius(), getResolution(), mode );
+    setSharedMesh("sphere", {getRadius(), float(getResolution()), float(mode)}, [&]{
+        return ofMesh::sphere( getRadius(), getResolution(), mode );
+    });
     
     normalizeAndApplySavedTexCoords();
 }
@@ -426,14 +554,14 @@ void ofSpherePrimitive::set( float _radius, int res, ofPrimitiveMode mode ) {
 //----------------------------------------------------------
 void ofSpherePrimitive::setResolution( int res ) {
     resolution             = res;
-    ofPrimitiveMode mode   = getMesh().getMode();
+    ofPrimitiveMode mode   = mesh->getMode();
     
     set(getRadius(), getResolution(), mode );
 }
 
 //----------------------------------------------------------
 void ofSpherePrimitive::setMode( ofPrimitiveMode mode ) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     if(currMode != mode)
         set(getRadius(), getResolution(), mode );
 }
@@ -486,7 +614,9 @@ void ofIcoSpherePrimitive::setResolution( int iterations ) {
     // store the number of iterations in the resolution //
     resolution = iterations;
     
-    getMesh() = ofMesh::icosphere( getRadius(), getResolution() );
+    setSharedMesh("icosphere", {getRadius(), float(getResolution())}, [&]{
+        return ofMesh::icosphere( getRadius(), getResolution() );
+    });
     normalizeAndApplySavedTexCoords();
 }
 
@@ -570,7 +700,9 @@ void ofCylinderPrimitive::set(float _radius, float _height, int radiusSegments,
     vertices[2][1] = (getResolution().x+1) * (getResolution().z+1);
     
     
-    getMesh() = ofMesh::cylinder( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, getCapped(), mode );
+    setSharedMesh("cylinder", {getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, float(getCapped()), float(mode)}, [&]{
+        return ofMesh::cylinder( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, getCapped(), mode );
+    });
     
     normalizeAndApplySavedTexCoords();
     
@@ -618,13 +750,13 @@ void ofCylinderPrimitive::setResolutionCap( int capRes ) {
 
 //--------------------------------------------------------------
 void ofCylinderPrimitive::setResolution( int radiusSegments, int heightSegments, int capSegments ) {
-    ofPrimitiveMode mode = getMesh().getMode();
+    ofPrimitiveMode mode = mesh->getMode();
     set( getRadius(), getHeight(), radiusSegments, heightSegments, capSegments, getCapped(), mode );
 }
 
 //----------------------------------------------------------
 void ofCylinderPrimitive::setMode( ofPrimitiveMode mode ) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     if(currMode != mode)
         set( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, getCapped(), mode );
 }
@@ -785,7 +917,9 @@ void ofConePrimitive::set( float _radius, float _height, int radiusSegments, int
     vertices[1][0] = vertices[0][0] + vertices[0][1];
     vertices[1][1] = (getResolution().x+1) * (getResolution().z+1);
     
-    getMesh() = ofMesh::cone( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mode );
+    setSharedMesh("cone", {getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, float(mode)}, [&]{
+        return ofMesh::cone( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mode );
+    });
     
     normalizeAndApplySavedTexCoords();
     
@@ -815,13 +949,13 @@ void ofConePrimitive::setResolutionCap( int capRes ) {
 
 //--------------------------------------------------------------
 void ofConePrimitive::setResolution( int radiusRes, int heightRes, int capRes ) {
-    ofPrimitiveMode mode = getMesh().getMode();
+    ofPrimitiveMode mode = mesh->getMode();
     set( getRadius(), getHeight(), radiusRes, heightRes, capRes, mode );
 }
 
 //----------------------------------------------------------
 void ofConePrimitive::setMode( ofPrimitiveMode mode ) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     if(currMode != mode)
         set( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mode );
 }
@@ -997,7 +1131,9 @@ void ofBoxPrimitive::set( float width, float height, float depth, int resWidth,
     vertices[SIDE_BOTTOM][0] = vertices[SIDE_TOP][0] + vertices[SIDE_TOP][1];
     vertices[SIDE_BOTTOM][1] = (resY+1) * (resZ+1);
     
-    getMesh() = ofMesh::box( getWidth(), getHeight(), getDepth(), getResolution().x, getResolution().y, getResolution().z );
+    setSharedMesh("box", {getWidth(), getHeight(), getDepth(), getResolution().x, getResolution().y, getResolution().z}, [&]{
+        return ofMesh::box( getWidth(), getHeight(), getDepth(), getResolution().x, getResolution().y, getResolution().z );
+    });
     
     normalizeAndApplySavedTexCoords();
 }
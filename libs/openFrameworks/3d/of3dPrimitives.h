@@ -3,10 +3,19 @@
 #include "ofVboMesh.h"
 #include "ofRectangle.h"
 #include "ofNode.h"
+#include "ofBounds.h"
 #include "ofTexture.h"
 #include <map>
+#include <functional>
 
 /// \brief A class representing a 3d primitive.
+///
+/// Primitives using a vbo share their geometry with every other primitive
+/// of the same type created with the same parameters, so creating many
+/// spheres or boxes of the same size only generates and uploads one mesh.
+/// Each instance only carries its own transform. Calling the non const
+/// versions of getMesh() or getMeshPtr(), or any method that modifies the
+/// mesh, gives the instance its own copy of the geometry first.
 class of3dPrimitive : public ofNode {
 public:
     of3dPrimitive();
@@ -58,18 +67,44 @@ public:
 
     void setUseVbo(bool useVbo);
     bool isUsingVbo() const;
+
+    /// \brief The box containing the mesh vertices, in local coordinates
+    ///
+    /// It's cached and calculated again after the mesh is accessed through
+    /// getMesh() or getMeshPtr() without const. Call it again after
+    /// modifying the mesh through a reference kept from before.
+    const ofBoundingBox & getBoundingBox() const;
+
+    /// \brief The bounding box transformed by the node's global transform
+    ofBoundingBox getGlobalBoundingBox() const;
+
+    /// \brief The sphere containing the global bounding box
+    ofBoundingSphere getGlobalBoundingSphere() const;
 protected:
 
     // useful when creating a new model, since it uses normalized tex coords //
     void normalizeAndApplySavedTexCoords();
 
+    /// \brief Use the mesh shared by the primitives of this type with the
+    /// same parameters, calling generate to create it if there's none
+    ///
+    /// Without vbo the primitive doesn't share its mesh and it's always
+    /// generated.
+    void setSharedMesh(const std::string & type, std::initializer_list<float> parameters, const std::function<ofMesh()> & generate);
+
 	glm::vec4 texCoords;
     bool usingVbo;
     std::shared_ptr<ofMesh>  mesh;
+    bool sharedMesh;
     mutable ofMesh normalsMesh;
+    mutable ofBoundingBox bounds;
+    mutable bool boundsDirty;
 
     std::vector<ofIndexType> getIndices( int startIndex, int endIndex ) const;
 
+private:
+    // copies the mesh if others are using it, before modifying it
+    void unshareMesh();
 };
 
 
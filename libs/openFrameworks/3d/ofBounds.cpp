@@ -0,0 +1,223 @@
+#include "ofBounds.h"
+#include <limits>
+
+using namespace std;
+
+//----------------------------------------------------------
+ofBoundingBox::ofBoundingBox(){
+	clear();
+}
+
+//----------------------------------------------------------
+ofBoundingBox::ofBoundingBox(const glm::vec3 & min, const glm::vec3 & max)
+:min(min)
+,max(max){
+}
+
+//----------------------------------------------------------
+ofBoundingBox::ofBoundingBox(const vector<glm::vec3> & points){
+	clear();
+	add(points);
+}
+
+//----------------------------------------------------------
+ofBoundingBox::ofBoundingBox(const glm::vec3 * points, size_t count){
+	clear();
+	add(points, count);
+}
+
+//----------------------------------------------------------
+void ofBoundingBox::add(const glm::vec3 & point){
+	min = glm::min(min, point);
+	max = glm::max(max, point);
+}
+
+//----------------------------------------------------------
+void ofBoundingBox::add(const glm::vec3 * points, size_t count){
+	for(size_t i = 0; i < count; i++){
+		add(points[i]);
+	}
+}
+
+//----------------------------------------------------------
+void ofBoundingBox::add(const vector<glm::vec3> & points){
+	add(points.data(), points.size());
+}
+
+//----------------------------------------------------------
+void ofBoundingBox::add(const ofBoundingBox & box){
+	if(!box.isEmpty()){
+		add(box.min);
+		add(box.max);
+	}
+}
+
+//----------------------------------------------------------
+void ofBoundingBox::clear(){
+	min = glm::vec3(numeric_limits<float>::max());
+	max = glm::vec3(-numeric_limits<float>::max());
+}
+
+//----------------------------------------------------------
+bool ofBoundingBox::isEmpty() const{
+	return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+//----------------------------------------------------------
+bool ofBoundingBox::inside(const glm::vec3 & point) const{
+	return point.x >= min.x && point.y >= min.y && point.z >= min.z
+		&& point.x <= max.x && point.y <= max.y && point.z <= max.z;
+}
+
+//----------------------------------------------------------
+bool ofBoundingBox::intersects(const ofBoundingBox & box) const{
+	return !isEmpty() && !box.isEmpty()
+		&& min.x <= box.max.x && min.y <= box.max.y && min.z <= box.max.z
+		&& max.x >= box.min.x && max.y >= box.min.y && max.z >= box.min.z;
+}
+
+//----------------------------------------------------------
+glm::vec3 ofBoundingBox::getCenter() const{
+	return (min + max) * 0.5f;
+}
+
+//----------------------------------------------------------
+glm::vec3 ofBoundingBox::getSize() const{
+	if(isEmpty()){
+		return glm::vec3(0);
+	}
+	return max - min;
+}
+
+//----------------------------------------------------------
+ofBoundingBox ofBoundingBox::getTransformed(const glm::mat4 & matrix) const{
+	if(isEmpty()){
+		return ofBoundingBox();
+	}
+	// transforms the center and projects the half size on each axis of the
+	// matrix instead of transforming the 8 corners
+	glm::vec3 center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+	glm::vec3 extents = (max - min) * 0.5f;
+	glm::vec3 transformedExtents;
+	for(int i = 0; i < 3; i++){
+		transformedExtents[i] = fabs(matrix[0][i]) * extents.x
+			+ fabs(matrix[1][i]) * extents.y
+			+ fabs(matrix[2][i]) * extents.z;
+	}
+	return ofBoundingBox(center - transformedExtents, center + transformedExtents);
+}
+
+//----------------------------------------------------------
+ofBoundingSphere::ofBoundingSphere()
+:radius(-1){
+}
+
+//----------------------------------------------------------
+ofBoundingSphere::ofBoundingSphere(const glm::vec3 & center, float radius)
+:center(center)
+,radius(radius){
+}
+
+//----------------------------------------------------------
+ofBoundingSphere::ofBoundingSphere(const ofBoundingBox & box)
+:radius(-1){
+	if(!box.isEmpty()){
+		center = box.getCenter();
+		radius = glm::length(box.max - center);
+	}
+}
+
+//----------------------------------------------------------
+bool ofBoundingSphere::isEmpty() const{
+	return radius < 0;
+}
+
+//----------------------------------------------------------
+bool ofBoundingSphere::inside(const glm::vec3 & point) const{
+	glm::vec3 d = point - center;
+	return !isEmpty() && glm::dot(d, d) <= radius * radius;
+}
+
+//----------------------------------------------------------
+ofBoundingSphere ofBoundingSphere::getTransformed(const glm::mat4 & matrix) const{
+	if(isEmpty()){
+		return ofBoundingSphere();
+	}
+	float scale = std::max(std::max(glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1]))), glm::length(glm::vec3(matrix[2])));
+	return ofBoundingSphere(glm::vec3(matrix * glm::vec4(center, 1.0f)), radius * scale);
+}
+
+//----------------------------------------------------------
+ofFrustum::ofFrustum(){
+	for(auto & plane: planes){
+		plane = glm::vec4(0, 0, 0, 1);
+	}
+}
+
+//----------------------------------------------------------
+ofFrustum::ofFrustum(const glm::mat4 & m){
+	// Gribb & Hartmann, the planes are combinations of the rows of the
+	// matrix, glm matrices are indexed by column
+	auto row = [&m](int i){
+		return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+	};
+	planes[PLANE_LEFT] = row(3) + row(0);
+	planes[PLANE_RIGHT] = row(3) - row(0);
+	planes[PLANE_BOTTOM] = row(3) + row(1);
+	planes[PLANE_TOP] = row(3) - row(1);
+	planes[PLANE_NEAR] = row(3) + row(2);
+	planes[PLANE_FAR] = row(3) - row(2);
+	for(auto & plane: planes){
+		float length = glm::length(glm::vec3(plane));
+		if(length > 0){
+			plane /= length;
+		}
+	}
+}
+
+//----------------------------------------------------------
+bool ofFrustum::inside(const glm::vec3 & point) const{
+	for(auto & plane: planes){
+		if(glm::dot(glm::vec3(plane), point) + plane.w < 0){
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofFrustum::intersects(const ofBoundingSphere & sphere) const{
+	if(sphere.isEmpty()){
+		return false;
+	}
+	for(auto & plane: planes){
+		if(glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius){
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofFrustum::intersects(const ofBoundingBox & box) const{
+	if(box.isEmpty()){
+		return false;
+	}
+	for(auto & plane: planes){
+		// the corner furthest along the plane's normal, if it's outside
+		// the whole box is
+		glm::vec3 corner(
+			plane.x >= 0 ? box.max.x : box.min.x,
+			plane.y >= 0 ? box.max.y : box.min.y,
+			plane.z >= 0 ? box.max.z : box.min.z);
+		if(glm::dot(glm::vec3(plane), corner) + plane.w < 0){
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+const glm::vec4 & ofFrustum::getPlane(Plane plane) const{
+	return planes[plane];
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ofConstants.h"
+
+/// \brief An axis aligned box that contains a set of points
+///
+/// A default constructed box is empty, adding points or boxes to it grows
+/// it to contain them:
+///
+/// ~~~~{.cpp}
+/// ofBoundingBox bounds(mesh.getVertices());
+/// bounds.add(otherMesh.getVertices());
+/// ofDrawBox(bounds.getCenter(), bounds.getSize().x, bounds.getSize().y, bounds.getSize().z);
+/// ~~~~
+class ofBoundingBox{
+public:
+	/// \brief Creates an empty box
+	ofBoundingBox();
+	ofBoundingBox(const glm::vec3 & min, const glm::vec3 & max);
+
+	/// \brief Creates the smallest box containing all the points
+	ofBoundingBox(const std::vector<glm::vec3> & points);
+	ofBoundingBox(const glm::vec3 * points, std::size_t count);
+
+	/// \brief Grows the box to contain point
+	void add(const glm::vec3 & point);
+	void add(const glm::vec3 * points, std::size_t count);
+	void add(const std::vector<glm::vec3> & points);
+	void add(const ofBoundingBox & box);
+
+	/// \brief Makes the box empty
+	void clear();
+
+	/// \brief True until a point is added
+	bool isEmpty() const;
+
+	bool inside(const glm::vec3 & point) const;
+	bool intersects(const ofBoundingBox & box) const;
+
+	glm::vec3 getCenter() const;
+	glm::vec3 getSize() const;
+
+	/// \brief The box containing this one after transforming it by matrix,
+	/// usually a node's global transform
+	ofBoundingBox getTransformed(const glm::mat4 & matrix) const;
+
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+/// \brief A sphere that contains a set of points
+///
+/// Cheaper to transform and to test against a frustum than a box but
+/// usually bigger than the object it contains.
+class ofBoundingSphere{
+public:
+	/// \brief Creates an empty sphere, with a negative radius
+	ofBoundingSphere();
+	ofBoundingSphere(const glm::vec3 & center, float radius);
+
+	/// \brief The sphere around box, centered at its center
+	ofBoundingSphere(const ofBoundingBox & box);
+
+	bool isEmpty() const;
+	bool inside(const glm::vec3 & point) const;
+
+	/// \brief The sphere containing this one after transforming it by
+	/// matrix, non uniform scales make it grow by the biggest one
+	ofBoundingSphere getTransformed(const glm::mat4 & matrix) const;
+
+	glm::vec3 center;
+	float radius;
+};
+
+/// \brief The 6 planes of a camera's view volume, to test if something
+/// can be seen before drawing it
+///
+/// ~~~~{.cpp}
+/// auto frustum = cam.getFrustum();
+/// for(auto & box: boxes){
+///     if(frustum.intersects(box.getGlobalBoundingBox())){
+///         box.draw();
+///     }
+/// }
+/// ~~~~
+///
+/// The tests are conservative: a box near a corner of the frustum can be
+/// reported as intersecting while it's outside, never the other way around.
+class ofFrustum{
+public:
+	enum Plane{
+		PLANE_LEFT,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+	};
+
+	/// \brief A frustum that contains everything
+	ofFrustum();
+
+	/// \brief Extracts the planes of a model view projection matrix, like
+	/// the one returned by ofCamera::getModelViewProjectionMatrix()
+	///
+	/// The planes are in the space the matrix transforms from, world space
+	/// for a camera's matrix.
+	ofFrustum(const glm::mat4 & modelViewProjection);
+
+	bool inside(const glm::vec3 & point) const;
+	bool intersects(const ofBoundingSphere & sphere) const;
+	bool intersects(const ofBoundingBox & box) const;
+
+	/// \brief The plane as (normal, distance), with the normal pointing
+	/// inside, so points inside have dot(normal, p) + distance >= 0
+	const glm::vec4 & getPlane(Plane plane) const;
+
+private:
+	glm::vec4 planes[6];
+};
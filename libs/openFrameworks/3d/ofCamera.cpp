@@ -172,6 +172,11 @@ glm::mat4 ofCamera::getModelViewProjectionMatrix(ofRectangle viewport) const {
 	return getProjectionMatrix(viewport) * getModelViewMatrix();
 }
 
+//----------------------------------------
+ofFrustum ofCamera::getFrustum(ofRectangle viewport) const {
+	return ofFrustum(getModelViewProjectionMatrix(viewport));
+}
+
 //----------------------------------------
 glm::vec3 ofCamera::worldToScreen(glm::vec3 WorldXYZ, ofRectangle viewport) const {
 	viewport = getViewport(viewport);
@@ -4,6 +4,7 @@
 #include "ofRectangle.h"
 #include "ofGraphics.h"
 #include "ofNode.h"
+#include "ofBounds.h"
 
 // \todo Use the public API of ofNode for all transformations
 // \todo add set projection matrix
@@ -171,6 +172,10 @@ public:
     /// \todo getModelViewProjectionMatrix()
 	glm::mat4 getModelViewProjectionMatrix(ofRectangle viewport = ofRectangle()) const;
 
+	/// \brief The planes of what the camera sees in world space, to skip
+	/// drawing what's outside
+	ofFrustum getFrustum(ofRectangle viewport = ofRectangle()) const;
+
     /// \}
     /// \name Coordinate Conversion
     /// \{
@@ -0,0 +1,216 @@
+#include "ofLodMesh.h"
+#include "ofCamera.h"
+#include "ofGraphics.h"
+#include "ofTaskPool.h"
+#include <numeric>
+
+using namespace std;
+
+namespace{
+	// simplifies mesh level after level, each from the previous one, and
+	// calls add with the indices and the accumulated error of each
+	void generateLevels(ofMesh & mesh, size_t numLevels, float ratio, float extent, const function<void(vector<ofIndexType> &&, float)> & add){
+		float error = 0;
+		for(size_t i = 1; i < numLevels; i++){
+			size_t numTriangles = mesh.getNumIndices() / 3;
+			float levelError;
+			auto levelIndices = mesh.getSimplifiedIndices(size_t(numTriangles * ratio), 1.f, &levelError);
+			if(levelIndices.empty() || levelIndices.size() / 3 >= numTriangles){
+				break;
+			}
+			error += levelError * extent;
+			mesh.getIndices() = levelIndices;
+			add(std::move(levelIndices), error);
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofLodMesh::ofLodMesh()
+:level(0)
+,maxScreenError(1)
+,ready(false){
+}
+
+//----------------------------------------------------------
+void ofLodMesh::setup(const ofMesh & _mesh, size_t numLevels, float ratio, bool threaded){
+	mesh = _mesh;
+	levels.clear();
+	indices.clear();
+	level = 0;
+	ready = false;
+	generation = make_shared<bool>(true);
+
+	if(mesh.getMode() != OF_PRIMITIVE_TRIANGLES){
+		ofLogError("ofLodMesh") << "setup(): only OF_PRIMITIVE_TRIANGLES meshes can be simplified";
+		numLevels = 1;
+	}
+
+	bounds = ofBoundingBox(mesh.getVertices());
+	auto size = bounds.getSize();
+	float extent = std::max(size.x, std::max(size.y, size.z));
+
+	// every level draws from the same vertices, level 0 being the full mesh
+	vector<ofIndexType> fullIndices;
+	if(mesh.hasIndices()){
+		fullIndices = mesh.getIndices();
+	}else{
+		fullIndices.resize(mesh.getNumVertices());
+		std::iota(fullIndices.begin(), fullIndices.end(), 0);
+	}
+	vbo.setMesh(mesh, GL_STATIC_DRAW);
+	addLevel(fullIndices, 0);
+
+	if(numLevels < 2 || fullIndices.size() < 3){
+		ready = true;
+		return;
+	}
+
+	if(!threaded){
+		ofMesh source = mesh;
+		source.getIndices() = fullIndices;
+		generateLevels(source, numLevels, ratio, extent, [this](vector<ofIndexType> && levelIndices, float error){
+			addLevel(levelIndices, error);
+		});
+		ready = true;
+		return;
+	}
+
+	auto source = make_shared<ofMesh>(mesh);
+	source->getIndices() = fullIndices;
+	weak_ptr<bool> current = generation;
+	ofGetTaskPool().submit([this, source, current, numLevels, ratio, extent]{
+		generateLevels(*source, numLevels, ratio, extent, [this, current](vector<ofIndexType> && levelIndices, float error){
+			auto result = make_shared<vector<ofIndexType>>(std::move(levelIndices));
+			ofTaskPool::runOnMainThread([this, current, result, error]{
+				if(!current.expired()){
+					addLevel(*result, error);
+				}
+			});
+		});
+	}, [this, current]{
+		if(!current.expired()){
+			ready = true;
+		}
+	});
+}
+
+//----------------------------------------------------------
+void ofLodMesh::addLevel(const vector<ofIndexType> & levelIndices, float error){
+	levels.push_back({indices.size(), levelIndices.size(), error});
+	indices.insert(indices.end(), levelIndices.begin(), levelIndices.end());
+	vbo.setIndexData(indices.data(), int(indices.size()), GL_STATIC_DRAW);
+}
+
+//----------------------------------------------------------
+bool ofLodMesh::isReady() const{
+	return ready;
+}
+
+//----------------------------------------------------------
+size_t ofLodMesh::getNumLevels() const{
+	return levels.size();
+}
+
+//----------------------------------------------------------
+size_t ofLodMesh::getNumTriangles(size_t level) const{
+	return level < levels.size() ? levels[level].count / 3 : 0;
+}
+
+//----------------------------------------------------------
+float ofLodMesh::getError(size_t level) const{
+	return level < levels.size() ? levels[level].error : 0;
+}
+
+//----------------------------------------------------------
+const ofMesh & ofLodMesh::getMesh() const{
+	return mesh;
+}
+
+//----------------------------------------------------------
+ofMesh ofLodMesh::getLevelMesh(size_t level) const{
+	ofMesh levelMesh = mesh;
+	if(level < levels.size()){
+		auto begin = indices.begin() + levels[level].offset;
+		levelMesh.getIndices().assign(begin, begin + levels[level].count);
+	}
+	return levelMesh;
+}
+
+//----------------------------------------------------------
+void ofLodMesh::setMaxScreenError(float pixels){
+	maxScreenError = pixels;
+}
+
+//----------------------------------------------------------
+float ofLodMesh::getMaxScreenError() const{
+	return maxScreenError;
+}
+
+//----------------------------------------------------------
+float ofLodMesh::getPixelsPerUnit(const ofCamera & camera, const ofBoundingBox & globalBounds, ofRectangle viewport){
+	if(viewport.isZero()){
+		viewport = ofGetCurrentViewport();
+	}
+	// the projection scales y by [1][1] at a distance of 1, or at any
+	// distance for orthographic cameras
+	float pixelsPerUnit = camera.getProjectionMatrix(viewport)[1][1] * viewport.height * 0.5f;
+	if(camera.getOrtho() || globalBounds.isEmpty()){
+		return pixelsPerUnit;
+	}
+	glm::vec3 eye = camera.getGlobalPosition();
+	glm::vec3 nearest = glm::clamp(eye, globalBounds.min, globalBounds.max);
+	float distance = std::max(glm::distance(eye, nearest), camera.getNearClip());
+	return pixelsPerUnit / distance;
+}
+
+//----------------------------------------------------------
+size_t ofLodMesh::selectLevel(const ofCamera & camera, ofRectangle viewport){
+	level = 0;
+	if(levels.size() < 2){
+		return level;
+	}
+	glm::vec3 scale = getGlobalScale();
+	float maxScale = std::max(std::abs(scale.x), std::max(std::abs(scale.y), std::abs(scale.z)));
+	float pixels = getPixelsPerUnit(camera, getGlobalBoundingBox(), viewport) * maxScale;
+	for(size_t i = levels.size() - 1; i > 0; i--){
+		if(levels[i].error * pixels <= maxScreenError){
+			level = i;
+			break;
+		}
+	}
+	return level;
+}
+
+//----------------------------------------------------------
+void ofLodMesh::setLevel(size_t _level){
+	level = std::min(_level, levels.empty() ? 0 : levels.size() - 1);
+}
+
+//----------------------------------------------------------
+size_t ofLodMesh::getLevel() const{
+	return level;
+}
+
+//----------------------------------------------------------
+void ofLodMesh::draw(const ofCamera & camera){
+	selectLevel(camera);
+	draw();
+}
+
+//----------------------------------------------------------
+const ofBoundingBox & ofLodMesh::getBoundingBox() const{
+	return bounds;
+}
+
+//----------------------------------------------------------
+ofBoundingBox ofLodMesh::getGlobalBoundingBox() const{
+	return bounds.getTransformed(getGlobalTransformMatrix());
+}
+
+//----------------------------------------------------------
+void ofLodMesh::customDraw(const ofBaseRenderer * renderer) const{
+	if(level < levels.size()){
+		vbo.drawElements(GL_TRIANGLES, int(levels[level].count), int(levels[level].offset));
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "ofNode.h"
+#include "ofMesh.h"
+#include "ofVbo.h"
+#include "ofBounds.h"
+#include "ofRectangle.h"
+
+class ofCamera;
+
+/// \brief A mesh with simplified versions, levels of detail, drawn instead
+/// of it when they look the same from the camera
+///
+/// The levels are generated with ofMesh::getSimplifiedIndices() on the task
+/// pool, each one with a fraction of the triangles of the previous one. The
+/// full mesh is drawn until they arrive:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofMesh scan;
+///     scan.load("statue.ply");
+///     statue.setup(scan, 5);
+/// }
+///
+/// void ofApp::draw(){
+///     cam.begin();
+///     statue.draw(cam);
+///     cam.end();
+/// }
+/// ~~~~
+///
+/// draw(camera) picks the coarsest level whose error is smaller than
+/// getMaxScreenError() pixels when projected on the screen from the part of
+/// the mesh nearest to the camera. All the levels share the vertices of the
+/// full mesh, only their indices are added to the vbo.
+class ofLodMesh: public ofNode{
+public:
+	ofLodMesh();
+
+	ofLodMesh(const ofLodMesh &) = delete;
+	ofLodMesh & operator=(const ofLodMesh &) = delete;
+
+	/// \brief Uploads mesh as level 0 and starts generating the rest
+	///
+	/// \param numLevels levels including the full mesh, less are kept if
+	/// the mesh can't be simplified any further
+	/// \param ratio triangles of each level relative to the previous one
+	/// \param threaded generates the levels on ofGetTaskPool(), they are
+	/// added from the main loop as they finish, or before returning if false
+	void setup(const ofMesh & mesh, std::size_t numLevels = 4, float ratio = 0.5f, bool threaded = true);
+
+	/// \brief If all the levels have been generated
+	bool isReady() const;
+
+	/// \brief Levels ready to draw, including the full mesh
+	std::size_t getNumLevels() const;
+	std::size_t getNumTriangles(std::size_t level) const;
+
+	/// \brief Distance the surface of level can be from the full mesh, in
+	/// the coordinates of the mesh
+	float getError(std::size_t level) const;
+
+	/// \brief The full mesh
+	const ofMesh & getMesh() const;
+
+	/// \brief A copy of the mesh with the triangles of level
+	ofMesh getLevelMesh(std::size_t level) const;
+
+	/// \brief Error in pixels allowed on screen, 1 by default
+	void setMaxScreenError(float pixels);
+	float getMaxScreenError() const;
+
+	/// \brief Selects the level for camera and the viewport, the current
+	/// one by default
+	std::size_t selectLevel(const ofCamera & camera, ofRectangle viewport = ofRectangle());
+
+	/// \brief Selects the level drawn by draw()
+	void setLevel(std::size_t level);
+	std::size_t getLevel() const;
+
+	/// \brief Selects the level for camera and draws it
+	void draw(const ofCamera & camera);
+	using ofNode::draw;
+
+	/// \brief Bounds of the mesh in its own coordinates
+	const ofBoundingBox & getBoundingBox() const;
+
+	/// \brief Bounds of the mesh transformed by the node
+	ofBoundingBox getGlobalBoundingBox() const;
+
+	/// \brief Pixels covered on screen by a unit at the point of
+	/// globalBounds nearest to camera, to project errors
+	static float getPixelsPerUnit(const ofCamera & camera, const ofBoundingBox & globalBounds, ofRectangle viewport = ofRectangle());
+
+protected:
+	void customDraw(const ofBaseRenderer * renderer) const override;
+
+private:
+	struct Level{
+		std::size_t offset;
+		std::size_t count;
+		float error;
+	};
+
+	void addLevel(const std::vector<ofIndexType> & levelIndices, float error);
+
+	ofMesh mesh;
+	ofVbo vbo;
+	std::vector<ofIndexType> indices;
+	std::vector<Level> levels;
+	std::size_t level;
+	float maxScreenError;
+	ofBoundingBox bounds;
+	bool ready;
+	// results of a previous setup() still being generated are dropped
+	std::shared_ptr<bool> generation;
+};
@@ -10,12 +10,94 @@
 template<class V, class N, class C, class T>
 class ofMeshFace_;
 
+class ofBuffer;
+
 template<typename T>
 struct ofArrayView{
 		const T * data;
 		std::size_t size;
 };
 
+/// \brief Sorted list of the [begin, end) ranges of elements modified in one
+/// of the arrays of a mesh
+///
+/// Overlapping and adjacent ranges are merged as they are added. Once there
+/// are more than getMaxRanges() the two closest are merged too, so the list
+/// stays short even if many scattered elements change, at the cost of
+/// including a few unmodified ones.
+class ofMeshDirtyRanges{
+public:
+	typedef std::pair<std::size_t, std::size_t> Range;
+
+	/// \brief Adds the range [begin, end)
+	void add(std::size_t begin, std::size_t end){
+		if(begin >= end) return;
+
+		// most changes are appends or sequential sets, check the last first
+		if(ranges.empty() || begin > ranges.back().second){
+			ranges.emplace_back(begin, end);
+		}else if(begin >= ranges.back().first){
+			ranges.back().second = std::max(ranges.back().second, end);
+			return;
+		}else{
+			auto it = std::lower_bound(ranges.begin(), ranges.end(), Range(begin, end));
+			if(it != ranges.begin() && std::prev(it)->second >= begin){
+				--it;
+			}else{
+				it = ranges.insert(it, Range(begin, end));
+			}
+			it->first = std::min(it->first, begin);
+			it->second = std::max(it->second, end);
+			auto last = std::next(it);
+			while(last != ranges.end() && last->first <= it->second){
+				it->second = std::max(it->second, last->second);
+				++last;
+			}
+			ranges.erase(std::next(it), last);
+		}
+
+		if(ranges.size() > getMaxRanges()){
+			std::size_t closest = 0;
+			for(std::size_t i = 1; i < ranges.size() - 1; i++){
+				if(ranges[i + 1].first - ranges[i].second < ranges[closest + 1].first - ranges[closest].second){
+					closest = i;
+				}
+			}
+			ranges[closest].second = ranges[closest + 1].second;
+			ranges.erase(ranges.begin() + closest + 1);
+		}
+	}
+
+	void clear(){
+		ranges.clear();
+	}
+
+	bool empty() const{
+		return ranges.empty();
+	}
+
+	const std::vector<Range> & get() const{
+		return ranges;
+	}
+
+	std::vector<Range>::const_iterator begin() const{
+		return ranges.begin();
+	}
+
+	std::vector<Range>::const_iterator end() const{
+		return ranges.end();
+	}
+
+	/// \brief Maximum number of ranges kept, every range is a separate
+	/// upload so there's no point in keeping many small ones
+	static std::size_t getMaxRanges(){
+		return 16;
+	}
+
+private:
+	std::vector<Range> ranges;
+};
+
 class ofMeshData{
 	public:
 		virtual ~ofMeshData();
@@ -263,6 +345,13 @@ public:
 	/// \returns If the vertices of the mesh have changed, been added or removed.
 	bool haveVertsChanged();
 
+	/// \brief Same as haveVertsChanged() but also returns which vertices
+	/// changed, through setters or by adding new ones, since the last call
+	///
+	/// \param changed is cleared if they all might have changed, like
+	/// after a call to the non const getVertices()
+	bool haveVertsChanged(ofMeshDirtyRanges & changed);
+
 	/// \returns Whether the mesh has any vertices.
 	bool hasVertices() const;
 
@@ -340,6 +429,13 @@ public:
 	/// \returns If the normals of the mesh have changed, been added or removed.
 	bool haveNormalsChanged();
 
+	/// \brief Same as haveNormalsChanged() but also returns which normals
+	/// changed, through setters or by adding new ones, since the last call
+	///
+	/// \param changed is cleared if they all might have changed, like
+	/// after a call to the non const getNormals()
+	bool haveNormalsChanged(ofMeshDirtyRanges & changed);
+
 	/// /returnsWhether the mesh has any normals.
 	bool hasNormals() const;
 
@@ -357,6 +453,73 @@ public:
         /// \brief Duplicates vertices and updates normals to get a low-poly look.
         void flatNormals();
 
+	/// \brief Indices of a version of the mesh with fewer triangles,
+	/// using the same vertices
+	///
+	/// Collapses the edges that change the surface the least, by the
+	/// quadric error metric, moving one of their vertices onto the other,
+	/// until numTriangles are left or the next collapse would move the
+	/// surface more than maxError. Open borders are kept in place and the
+	/// vertices on the seams between different normals, colors or texture
+	/// coordinates don't move so the surface doesn't crack. Only works with
+	/// OF_PRIMITIVE_TRIANGLES.
+	///
+	/// \param maxError error allowed relative to the largest side of the
+	/// bounds of the mesh, 1 to only stop at numTriangles
+	/// \param error if not null, set to the error of the result with the
+	/// same scale as maxError
+	std::vector<ofIndexType> getSimplifiedIndices(std::size_t numTriangles, float maxError = 1.f, float * error = nullptr) const;
+
+	/// \brief A version of the mesh with numTriangles, see
+	/// getSimplifiedIndices(), with only the vertices still used
+	///
+	/// ~~~~{.cpp}
+	/// ofMesh lowPoly = scan.getSimplified(scan.getNumIndices() / 3 / 10);
+	/// ~~~~
+	ofMesh_<V,N,C,T> getSimplified(std::size_t numTriangles, float maxError = 1.f, float * error = nullptr) const;
+
+	/// \}
+	/// \name Optimization
+	/// \{
+
+	/// \brief Merges the vertices that are the same in all their attributes
+	///
+	/// Unlike mergeDuplicateVertices(), which only compares the positions,
+	/// the seams between different normals, colors or texture coordinates
+	/// are kept. Adds indices to meshes without them.
+	void removeDuplicateVertices();
+
+	/// \brief Reorders the triangles so the vertices they share are still
+	/// in the GPU's post transform cache when they are drawn
+	///
+	/// Only works with OF_PRIMITIVE_TRIANGLES.
+	void optimizeVertexCache();
+
+	/// \brief Reorders clusters of triangles so the ones that face out of
+	/// the mesh are drawn first and hide the rest, less pixels are shaded
+	/// more than once
+	///
+	/// Works on a triangle order already optimized with
+	/// optimizeVertexCache().
+	/// \param threshold how much worse than the current order the vertex
+	/// cache can get, a bigger one allows smaller clusters
+	void optimizeOverdraw(float threshold = 1.05f);
+
+	/// \brief Reorders the vertices in the order the indices use them so
+	/// they are read sequentially from memory, and removes the unused ones
+	void optimizeVertexFetch();
+
+	/// \brief Runs all the optimizations in order for meshes that are
+	/// drawn many times, like the ones loaded from files
+	///
+	/// ~~~~{.cpp}
+	/// ofMesh scan;
+	/// scan.load("statue.ply", true);
+	/// // or after generating it
+	/// terrain.optimize();
+	/// ~~~~
+	void optimize();
+
 	/// \}
 	/// \name Faces
 	/// \{
@@ -424,6 +587,13 @@ public:
 	/// \returns If the colors of the mesh have changed, been added or removed.
 	bool haveColorsChanged();
 
+	/// \brief Same as haveColorsChanged() but also returns which colors
+	/// changed, through setters or by adding new ones, since the last call
+	///
+	/// \param changed is cleared if they all might have changed, like
+	/// after a call to the non const getColors()
+	bool haveColorsChanged(ofMeshDirtyRanges & changed);
+
 	/// /returns Whether the mesh has any colors.
 	bool hasColors() const;
 
@@ -497,6 +667,13 @@ public:
 	/// \returns If the texture coords of the mesh have changed, been added or removed.
 	bool haveTexCoordsChanged();
 
+	/// \brief Same as haveTexCoordsChanged() but also returns which texture coords
+	/// changed, through setters or by adding new ones, since the last call
+	///
+	/// \param changed is cleared if they all might have changed, like
+	/// after a call to the non const getTexCoords()
+	bool haveTexCoordsChanged(ofMeshDirtyRanges & changed);
+
 	/// /returns Whether the mesh has any textures assigned to it.
 	bool hasTexCoords() const;
 
@@ -587,6 +764,13 @@ public:
 	/// \returns If the indices of the mesh have changed, been added or removed.
 	bool haveIndicesChanged();
 
+	/// \brief Same as haveIndicesChanged() but also returns which indices
+	/// changed, through setters or by adding new ones, since the last call
+	///
+	/// \param changed is cleared if they all might have changed, like
+	/// after a call to the non const getIndices()
+	bool haveIndicesChanged(ofMeshDirtyRanges & changed);
+
 	/// /returns Whether the mesh has any indices assigned to it.
 	bool hasIndices() const;
 
@@ -642,7 +826,10 @@ public:
 	///
 	/// It expects that the file will be in the [PLY Format](http://en.wikipedia.org/wiki/PLY_(file_format)).
 	/// It will only load meshes saved in the PLY ASCII format; the binary format is not supported.
-    void load(const std::filesystem::path& path);
+	///
+	/// \param optimize calls optimize() once it's loaded, see
+	/// removeDuplicateVertices() and optimizeVertexCache()
+    void load(const std::filesystem::path& path, bool optimize = false);
 
 	///  \brief Saves the mesh at the passed path in the [PLY Format](http://en.wikipedia.org/wiki/PLY_(file_format)).
 	///
@@ -655,6 +842,29 @@ public:
 	///  For more information, see the [PLY format specification](http://paulbourke.net/dataformats/ply/).
     void save(const std::filesystem::path& path, bool useBinary = false) const;
 
+	/// \brief Saves the mesh in openFrameworks' own binary format
+	///
+	/// Much faster to save and load than PLY and there's no precision lost.
+	/// Each array is stored as is, in the byte order of the machine saving
+	/// it, at an offset aligned to 16 bytes so a memory mapped file can be
+	/// used directly. The file can only be loaded into a mesh with the same
+	/// vertex, normal, color and texture coordinate types.
+	/// \returns false if the file couldn't be written
+	bool saveBinary(const std::filesystem::path& path) const;
+
+	/// \brief Saves the mesh in the format of saveBinary(path) into buffer
+	void saveBinary(ofBuffer & buffer) const;
+
+	/// \brief Loads a mesh saved with saveBinary()
+	///
+	/// The file is memory mapped and each array copied in one go, nothing
+	/// is parsed. The mesh is left untouched if the file is not valid.
+	bool loadBinary(const std::filesystem::path& path);
+
+	/// \brief Loads a mesh saved with saveBinary() from memory, like an
+	/// ofBuffer, an ofMappedBuffer or a network packet
+	bool loadBinary(const char * data, std::size_t size);
+
 	/// \}
 
 private:
@@ -672,6 +882,10 @@ private:
 
 	bool bVertsChanged, bColorsChanged, bNormalsChanged, bTexCoordsChanged,
 		bIndicesChanged;
+	// elements changed individually, the b*Changed flags are only set when
+	// the whole array might have changed
+	ofMeshDirtyRanges vertsDirty, colorsDirty, normalsDirty, texCoordsDirty,
+		indicesDirty;
 	ofPrimitiveMode mode;
 
 	bool useColors;
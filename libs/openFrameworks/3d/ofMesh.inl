@@ -2,7 +2,629 @@
 #include "ofBaseTypes.h"
 #include "ofMesh.h"
 #include "ofVectorMath.h"
+#include "ofTaskPool.h"
 #include <map>
+#include <cstring>
+#include <queue>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
+
+namespace of{
+namespace priv{
+	// faces per chunk when a mesh operation is split across the task pool
+	static const std::size_t meshFacesPerTask = 4096;
+
+	template<class V>
+	inline glm::vec3 faceNormal(const V & v0, const V & v1, const V & v2){
+		return glm::normalize(glm::cross(toGlm(v1 - v0), toGlm(v2 - v0)));
+	}
+
+	// header of the files written by ofMesh::saveBinary, followed by each
+	// array at its offset. Never change the existing fields, increase the
+	// version and use the reserved ones
+	struct MeshBinaryHeader{
+		char magic[4];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint32_t mode;
+		uint32_t flags;
+		uint32_t elementSize[5];
+		uint64_t count[5];
+		uint64_t offset[5];
+		uint32_t reserved[4];
+	};
+	static_assert(sizeof(MeshBinaryHeader) == 128, "the binary mesh header can't change size");
+
+	static const char meshBinaryMagic[4] = {'o','f','M','B'};
+	static const uint32_t meshBinaryVersion = 1;
+	static const uint32_t meshBinaryByteOrder = 0x01020304;
+	static const std::size_t meshBinaryAlignment = 16;
+	enum MeshBinaryArray{ MeshVertices, MeshNormals, MeshColors, MeshTexCoords, MeshIndices };
+	enum MeshBinaryFlags{ MeshUseColors = 1, MeshUseTextures = 2, MeshUseNormals = 4, MeshUseIndices = 8 };
+
+	template<class E>
+	inline bool loadMeshArray(const MeshBinaryHeader & header, MeshBinaryArray array, const char * data, std::size_t size, std::vector<E> & dst){
+		static_assert(std::is_trivially_copyable<E>::value, "binary meshes need trivially copyable types");
+		uint64_t count = header.count[array];
+		uint64_t offset = header.offset[array];
+		if(header.elementSize[array] != sizeof(E) || offset > size || count > (size - offset) / sizeof(E)){
+			return false;
+		}
+		dst.resize(count);
+		if(count){
+			memcpy(dst.data(), data + offset, count * sizeof(E));
+		}
+		return true;
+	}
+
+	// quadric error of a set of planes, the symmetric 4x4 matrix of
+	// their equations summed and weighted by the area of their faces
+	struct MeshQuadric{
+		double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+		double weight;
+	};
+
+	inline MeshQuadric meshPlaneQuadric(const glm::vec3 & n, float d, double weight){
+		double a = n.x, b = n.y, c = n.z, dd = d;
+		return {a*a*weight, a*b*weight, a*c*weight, a*dd*weight, b*b*weight, b*c*weight, b*dd*weight, c*c*weight, c*dd*weight, dd*dd*weight, weight};
+	}
+
+	inline void meshAddQuadric(MeshQuadric & q, const MeshQuadric & o){
+		q.a2 += o.a2; q.ab += o.ab; q.ac += o.ac; q.ad += o.ad;
+		q.b2 += o.b2; q.bc += o.bc; q.bd += o.bd;
+		q.c2 += o.c2; q.cd += o.cd; q.d2 += o.d2;
+		q.weight += o.weight;
+	}
+
+	// mean squared distance from p to the planes of the quadric
+	inline double meshQuadricError(const MeshQuadric & q, const glm::vec3 & p){
+		double x = p.x, y = p.y, z = p.z;
+		double e = q.a2*x*x + 2*q.ab*x*y + 2*q.ac*x*z + 2*q.ad*x
+			+ q.b2*y*y + 2*q.bc*y*z + 2*q.bd*y
+			+ q.c2*z*z + 2*q.cd*z + q.d2;
+		return q.weight > 0 ? std::abs(e) / q.weight : 0;
+	}
+
+	// Collapses the edges of the triangles, moving one of their vertices
+	// onto the other, cheapest first by the quadric error metric, until
+	// targetTriangles are left or the next collapse would move the surface
+	// further than maxError, relative to the largest side of the bounds of
+	// the positions. Only moves vertices within the ones already used so
+	// the remaining triangles index the same positions. Vertices on open
+	// borders only move along them and vertices that share their position
+	// with another one, the seams between different normals or texture
+	// coordinates, and non manifold vertices don't move so no cracks open.
+	inline std::vector<uint32_t> simplifyMeshTriangles(const std::vector<glm::vec3> & positions, std::vector<uint32_t> triangles, std::size_t targetTriangles, float maxError, float & resultError){
+		const uint32_t none = std::numeric_limits<uint32_t>::max();
+		std::size_t numVertices = positions.size();
+		std::size_t numTriangles = triangles.size() / 3;
+		triangles.resize(numTriangles * 3);
+		resultError = 0;
+
+		std::vector<uint8_t> removed(numTriangles, 0);
+		std::size_t alive = numTriangles;
+		for(std::size_t t = 0; t < numTriangles; t++){
+			uint32_t a = triangles[t*3], b = triangles[t*3+1], c = triangles[t*3+2];
+			if(a == b || b == c || a == c || a >= numVertices || b >= numVertices || c >= numVertices){
+				removed[t] = 1;
+				alive--;
+			}
+		}
+
+		auto compact = [&]{
+			std::vector<uint32_t> result;
+			result.reserve(alive * 3);
+			for(std::size_t t = 0; t < numTriangles; t++){
+				if(!removed[t]){
+					result.insert(result.end(), triangles.begin() + t*3, triangles.begin() + t*3 + 3);
+				}
+			}
+			return result;
+		};
+		if(alive <= targetTriangles){
+			return compact();
+		}
+
+		std::vector<std::vector<uint32_t>> vertexTriangles(numVertices);
+		glm::vec3 minPos(std::numeric_limits<float>::max());
+		glm::vec3 maxPos(-std::numeric_limits<float>::max());
+		for(std::size_t t = 0; t < numTriangles; t++){
+			if(removed[t]) continue;
+			for(std::size_t k = 0; k < 3; k++){
+				uint32_t v = triangles[t*3+k];
+				vertexTriangles[v].push_back(uint32_t(t));
+				minPos = glm::min(minPos, positions[v]);
+				maxPos = glm::max(maxPos, positions[v]);
+			}
+		}
+		glm::vec3 size = maxPos - minPos;
+		double extent = std::max(size.x, std::max(size.y, size.z));
+		if(extent <= 0){
+			return compact();
+		}
+		double maxCost = double(maxError) * extent;
+		maxCost *= maxCost;
+
+		auto hasVertex = [&](uint32_t t, uint32_t v){
+			return triangles[t*3] == v || triangles[t*3+1] == v || triangles[t*3+2] == v;
+		};
+
+		// seams, sorting the used vertices by position
+		std::vector<uint8_t> locked(numVertices, 0);
+		std::vector<uint8_t> border(numVertices, 0);
+		{
+			std::vector<uint32_t> sorted;
+			for(uint32_t v = 0; v < numVertices; v++){
+				if(!vertexTriangles[v].empty()) sorted.push_back(v);
+			}
+			auto less = [&](uint32_t a, uint32_t b){
+				const glm::vec3 & pa = positions[a];
+				const glm::vec3 & pb = positions[b];
+				if(pa.x != pb.x) return pa.x < pb.x;
+				if(pa.y != pb.y) return pa.y < pb.y;
+				return pa.z < pb.z;
+			};
+			std::sort(sorted.begin(), sorted.end(), less);
+			for(std::size_t i = 1; i < sorted.size(); i++){
+				if(!less(sorted[i-1], sorted[i])){
+					locked[sorted[i-1]] = 1;
+					locked[sorted[i]] = 1;
+				}
+			}
+		}
+
+		// planes of the faces, plus planes perpendicular to the faces
+		// through the border edges to keep the borders in place
+		const double borderWeight = 10;
+		std::vector<MeshQuadric> quadrics(numVertices, MeshQuadric{0,0,0,0,0,0,0,0,0,0,0});
+		for(std::size_t t = 0; t < numTriangles; t++){
+			if(removed[t]) continue;
+			const glm::vec3 & p0 = positions[triangles[t*3]];
+			const glm::vec3 & p1 = positions[triangles[t*3+1]];
+			const glm::vec3 & p2 = positions[triangles[t*3+2]];
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area2 = glm::length(normal);
+			if(area2 <= 0) continue;
+			normal /= area2;
+			auto quadric = meshPlaneQuadric(normal, -glm::dot(normal, p0), area2 * 0.5);
+			for(std::size_t k = 0; k < 3; k++){
+				meshAddQuadric(quadrics[triangles[t*3+k]], quadric);
+			}
+			for(std::size_t k = 0; k < 3; k++){
+				uint32_t a = triangles[t*3+k];
+				uint32_t b = triangles[t*3+(k+1)%3];
+				std::size_t shared = 0;
+				for(auto other: vertexTriangles[a]){
+					if(hasVertex(other, b)) shared++;
+				}
+				if(shared > 2){
+					locked[a] = 1;
+					locked[b] = 1;
+				}else if(shared == 1){
+					border[a] = 1;
+					border[b] = 1;
+					glm::vec3 edge = positions[b] - positions[a];
+					glm::vec3 edgeNormal = glm::cross(edge, normal);
+					float length = glm::length(edgeNormal);
+					if(length > 0){
+						edgeNormal /= length;
+						auto borderQuadric = meshPlaneQuadric(edgeNormal, -glm::dot(edgeNormal, positions[a]), glm::dot(edge, edge) * borderWeight);
+						meshAddQuadric(quadrics[a], borderQuadric);
+						meshAddQuadric(quadrics[b], borderQuadric);
+					}
+				}
+			}
+		}
+
+		// candidates are invalidated lazily, when any of their vertices
+		// changed since they were pushed
+		struct Collapse{
+			double cost;
+			uint32_t from, to;
+			uint32_t fromVersion, toVersion;
+			bool operator>(const Collapse & other) const{
+				return cost > other.cost;
+			}
+		};
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> candidates;
+		std::vector<uint32_t> version(numVertices, 0);
+		auto push = [&](uint32_t from, uint32_t to){
+			if(locked[from] || (border[from] && !border[to])) return;
+			MeshQuadric q = quadrics[from];
+			meshAddQuadric(q, quadrics[to]);
+			candidates.push({meshQuadricError(q, positions[to]), from, to, version[from], version[to]});
+		};
+		for(std::size_t t = 0; t < numTriangles; t++){
+			if(removed[t]) continue;
+			for(std::size_t k = 0; k < 3; k++){
+				uint32_t a = triangles[t*3+k];
+				uint32_t b = triangles[t*3+(k+1)%3];
+				push(a, b);
+				push(b, a);
+			}
+		}
+
+		std::vector<uint32_t> marks(numVertices, 0);
+		uint32_t mark = 0;
+		auto canCollapse = [&](uint32_t from, uint32_t to){
+			std::size_t shared = 0;
+			for(auto t: vertexTriangles[from]){
+				if(!removed[t] && hasVertex(t, to)) shared++;
+			}
+			if(shared == 0 || shared > 2 || (border[from] && shared != 1) || (!border[from] && shared != 2)){
+				return false;
+			}
+			// link condition, the only vertices connected to both are the
+			// ones of the triangles that disappear
+			mark++;
+			for(auto t: vertexTriangles[from]){
+				if(removed[t]) continue;
+				for(std::size_t k = 0; k < 3; k++){
+					marks[triangles[t*3+k]] = mark;
+				}
+			}
+			std::size_t common = 0;
+			mark++;
+			for(auto t: vertexTriangles[to]){
+				if(removed[t]) continue;
+				for(std::size_t k = 0; k < 3; k++){
+					uint32_t v = triangles[t*3+k];
+					if(v != from && v != to && marks[v] == mark - 1){
+						marks[v] = mark;
+						common++;
+					}
+				}
+			}
+			if(common != shared){
+				return false;
+			}
+			// no triangle can flip or become degenerate
+			for(auto t: vertexTriangles[from]){
+				if(removed[t] || hasVertex(t, to)) continue;
+				glm::vec3 p[3], q[3];
+				for(std::size_t k = 0; k < 3; k++){
+					uint32_t v = triangles[t*3+k];
+					p[k] = positions[v];
+					q[k] = v == from ? positions[to] : p[k];
+				}
+				glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+				glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+				float lengthBefore = glm::length(before);
+				float lengthAfter = glm::length(after);
+				if(lengthAfter <= 0 || glm::dot(before, after) < 0.2f * lengthBefore * lengthAfter){
+					return false;
+				}
+			}
+			return true;
+		};
+
+		double maxCostUsed = 0;
+		std::vector<uint32_t> neighbors;
+		while(alive > targetTriangles && !candidates.empty()){
+			Collapse collapse = candidates.top();
+			candidates.pop();
+			uint32_t from = collapse.from;
+			uint32_t to = collapse.to;
+			if(version[from] != collapse.fromVersion || version[to] != collapse.toVersion){
+				continue;
+			}
+			if(collapse.cost > maxCost){
+				break;
+			}
+			if(!canCollapse(from, to)){
+				continue;
+			}
+
+			auto & toTriangles = vertexTriangles[to];
+			for(auto t: vertexTriangles[from]){
+				if(removed[t]) continue;
+				if(hasVertex(t, to)){
+					removed[t] = 1;
+					alive--;
+				}else{
+					for(std::size_t k = 0; k < 3; k++){
+						if(triangles[t*3+k] == from) triangles[t*3+k] = to;
+					}
+					toTriangles.push_back(t);
+				}
+			}
+			vertexTriangles[from].clear();
+			vertexTriangles[from].shrink_to_fit();
+			toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&](uint32_t t){
+				return removed[t] != 0;
+			}), toTriangles.end());
+			meshAddQuadric(quadrics[to], quadrics[from]);
+			version[from]++;
+			version[to]++;
+			maxCostUsed = std::max(maxCostUsed, collapse.cost);
+
+			mark++;
+			neighbors.clear();
+			for(auto t: toTriangles){
+				for(std::size_t k = 0; k < 3; k++){
+					uint32_t v = triangles[t*3+k];
+					if(v != to && marks[v] != mark){
+						marks[v] = mark;
+						neighbors.push_back(v);
+					}
+				}
+			}
+			for(auto v: neighbors){
+				push(to, v);
+				push(v, to);
+			}
+		}
+
+		resultError = float(std::sqrt(maxCostUsed) / extent);
+		return compact();
+	}
+
+	// simulates a fifo post transform cache of cacheSize vertices
+	// \returns the misses of each triangle
+	inline std::vector<uint8_t> simulateMeshVertexCache(const uint32_t * triangles, std::size_t numTriangles, std::size_t cacheSize){
+		std::vector<uint8_t> misses(numTriangles);
+		std::unordered_map<uint32_t, std::size_t> insertedAt;
+		std::size_t numInserted = 0;
+		for(std::size_t t = 0; t < numTriangles; t++){
+			for(int k = 0; k < 3; k++){
+				uint32_t v = triangles[t * 3 + k];
+				auto it = insertedAt.find(v);
+				if(it == insertedAt.end() || numInserted - it->second > cacheSize){
+					insertedAt[v] = numInserted++;
+					misses[t]++;
+				}
+			}
+		}
+		return misses;
+	}
+
+	// Reorders the triangles so the vertices they share are still in the
+	// post transform cache, with the algorithm in Tom Forsyth's "Linear-Speed
+	// Vertex Cache Optimisation": each step adds the triangle with the best
+	// score among the ones using the vertices in a simulated lru cache, the
+	// score favouring recently used vertices and vertices with few
+	// triangles left so no isolated triangles are left behind.
+	inline void optimizeMeshVertexCache(uint32_t * triangles, std::size_t numTriangles){
+		const int cacheSize = 32;
+		if(numTriangles < 2){
+			return;
+		}
+
+		// compact ids for the vertices used
+		std::vector<uint32_t> vertices(triangles, triangles + numTriangles * 3);
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+		std::size_t numVertices = vertices.size();
+		std::vector<uint32_t> local(numTriangles * 3);
+		for(std::size_t i = 0; i < local.size(); i++){
+			local[i] = uint32_t(std::lower_bound(vertices.begin(), vertices.end(), triangles[i]) - vertices.begin());
+		}
+
+		// triangles of each vertex, the ones still to add first
+		std::vector<uint32_t> offsets(numVertices + 1, 0);
+		for(auto v: local){
+			offsets[v + 1]++;
+		}
+		for(std::size_t v = 0; v < numVertices; v++){
+			offsets[v + 1] += offsets[v];
+		}
+		std::vector<uint32_t> adjacency(local.size());
+		std::vector<uint32_t> remaining(numVertices);
+		for(std::size_t t = 0; t < numTriangles; t++){
+			for(int k = 0; k < 3; k++){
+				uint32_t v = local[t * 3 + k];
+				adjacency[offsets[v] + remaining[v]++] = uint32_t(t);
+			}
+		}
+
+		float cacheScores[cacheSize];
+		for(int i = 0; i < cacheSize; i++){
+			cacheScores[i] = i < 3 ? 0.75f : std::pow(1.f - float(i - 3) / float(cacheSize - 3), 1.5f);
+		}
+		auto score = [&](int cachePosition, uint32_t numRemaining){
+			if(numRemaining == 0){
+				return -1.f;
+			}
+			float s = cachePosition < 0 ? 0.f : cacheScores[cachePosition];
+			return s + 2.f / std::sqrt(float(numRemaining));
+		};
+
+		std::vector<int> cachePosition(numVertices, -1);
+		std::vector<float> vertexScore(numVertices);
+		for(std::size_t v = 0; v < numVertices; v++){
+			vertexScore[v] = score(-1, remaining[v]);
+		}
+		std::vector<float> triangleScore(numTriangles);
+		for(std::size_t t = 0; t < numTriangles; t++){
+			triangleScore[t] = vertexScore[local[t*3]] + vertexScore[local[t*3+1]] + vertexScore[local[t*3+2]];
+		}
+		std::vector<bool> added(numTriangles, false);
+
+		std::vector<uint32_t> order;
+		order.reserve(numTriangles);
+		uint32_t cache[cacheSize + 3];
+		int cacheCount = 0;
+		std::size_t nextUnadded = 0;
+		int64_t best = std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin();
+
+		while(order.size() < numTriangles){
+			if(best < 0){
+				// dead end, no triangle uses the cached vertices
+				while(added[nextUnadded]){
+					nextUnadded++;
+				}
+				best = int64_t(nextUnadded);
+			}
+			order.push_back(uint32_t(best));
+			added[best] = true;
+			const uint32_t * tri = &local[best * 3];
+
+			uint32_t newCache[cacheSize + 3];
+			int newCount = 0;
+			for(int k = 0; k < 3; k++){
+				uint32_t v = tri[k];
+				newCache[newCount++] = v;
+				// move the triangle out of the ones still to add
+				uint32_t * first = &adjacency[offsets[v]];
+				uint32_t * last = first + remaining[v] - 1;
+				*std::find(first, last + 1, uint32_t(best)) = *last;
+				remaining[v]--;
+			}
+			for(int i = 0; i < cacheCount; i++){
+				uint32_t v = cache[i];
+				if(v != tri[0] && v != tri[1] && v != tri[2]){
+					newCache[newCount++] = v;
+				}
+			}
+
+			auto updateVertex = [&](uint32_t v, int position){
+				cachePosition[v] = position;
+				float s = score(position, remaining[v]);
+				float diff = s - vertexScore[v];
+				vertexScore[v] = s;
+				for(uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; i++){
+					triangleScore[adjacency[i]] += diff;
+				}
+			};
+			for(int i = cacheSize; i < newCount; i++){
+				updateVertex(newCache[i], -1);
+			}
+			cacheCount = std::min(newCount, cacheSize);
+			for(int i = 0; i < cacheCount; i++){
+				cache[i] = newCache[i];
+				updateVertex(cache[i], i);
+			}
+
+			best = -1;
+			float bestScore = -1;
+			for(int i = 0; i < cacheCount; i++){
+				uint32_t v = cache[i];
+				for(uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; j++){
+					uint32_t t = adjacency[j];
+					if(triangleScore[t] > bestScore){
+						bestScore = triangleScore[t];
+						best = t;
+					}
+				}
+			}
+		}
+
+		for(std::size_t i = 0; i < numTriangles; i++){
+			for(int k = 0; k < 3; k++){
+				triangles[i * 3 + k] = vertices[local[order[i] * 3 + k]];
+			}
+		}
+	}
+
+	// Sorts clusters of triangles so the ones facing out of the mesh are
+	// drawn first and hide the ones behind them, as in Sander et al. "Fast
+	// Triangle Reordering for Vertex Locality and Reduced Overdraw". The
+	// clusters are split wherever the order given, already optimized for
+	// the vertex cache, restarts the cache, and further as long as the
+	// misses in them stay under threshold times the ones of the whole order
+	// so sorting them keeps most of the cache hits.
+	inline void optimizeMeshOverdraw(const std::vector<glm::vec3> & positions, uint32_t * triangles, std::size_t numTriangles, float threshold){
+		const std::size_t cacheSize = 16;
+		if(numTriangles < 2){
+			return;
+		}
+		auto misses = simulateMeshVertexCache(triangles, numTriangles, cacheSize);
+
+		std::vector<std::size_t> hardBoundaries;
+		for(std::size_t t = 0; t < numTriangles; t++){
+			if(t == 0 || misses[t] == 3){
+				hardBoundaries.push_back(t);
+			}
+		}
+		hardBoundaries.push_back(numTriangles);
+
+		std::vector<std::size_t> clusters;
+		for(std::size_t c = 0; c + 1 < hardBoundaries.size(); c++){
+			std::size_t start = hardBoundaries[c];
+			std::size_t end = hardBoundaries[c + 1];
+			auto clusterMisses = simulateMeshVertexCache(triangles + start * 3, end - start, cacheSize);
+			float clusterThreshold = threshold * float(std::accumulate(clusterMisses.begin(), clusterMisses.end(), 0u)) / float(end - start);
+			clusters.push_back(start);
+			// a new cluster starts when the running misses get under the
+			// threshold, after a flush of the cache
+			std::unordered_map<uint32_t, std::size_t> insertedAt;
+			std::size_t numInserted = 0;
+			std::size_t runningMisses = 0;
+			std::size_t runningTriangles = 0;
+			for(std::size_t t = start; t < end; t++){
+				for(int k = 0; k < 3; k++){
+					uint32_t v = triangles[t * 3 + k];
+					auto it = insertedAt.find(v);
+					if(it == insertedAt.end() || numInserted - it->second > cacheSize){
+						insertedAt[v] = numInserted++;
+						runningMisses++;
+					}
+				}
+				runningTriangles++;
+				if(t + 1 < end && float(runningMisses) / float(runningTriangles) <= clusterThreshold){
+					clusters.push_back(t + 1);
+					insertedAt.clear();
+					numInserted = 0;
+					runningMisses = 0;
+					runningTriangles = 0;
+				}
+			}
+		}
+		clusters.push_back(numTriangles);
+		std::size_t numClusters = clusters.size() - 1;
+		if(numClusters < 2){
+			return;
+		}
+
+		// area weighted centroid and normal of each cluster and of the mesh
+		std::vector<glm::vec3> centroids(numClusters);
+		std::vector<glm::vec3> normals(numClusters);
+		glm::vec3 meshCentroid(0);
+		float meshArea = 0;
+		for(std::size_t c = 0; c < numClusters; c++){
+			glm::vec3 centroid(0), normal(0);
+			float area = 0;
+			for(std::size_t t = clusters[c]; t < clusters[c + 1]; t++){
+				const glm::vec3 & p0 = positions[triangles[t*3]];
+				const glm::vec3 & p1 = positions[triangles[t*3+1]];
+				const glm::vec3 & p2 = positions[triangles[t*3+2]];
+				glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+				float a = glm::length(n);
+				centroid += (p0 + p1 + p2) * (a / 3.f);
+				normal += n;
+				area += a;
+			}
+			meshCentroid += centroid;
+			meshArea += area;
+			centroids[c] = area > 0 ? centroid / area : positions[triangles[clusters[c] * 3]];
+			float length = glm::length(normal);
+			normals[c] = length > 0 ? normal / length : normal;
+		}
+		if(meshArea > 0){
+			meshCentroid /= meshArea;
+		}
+
+		std::vector<float> outwards(numClusters);
+		for(std::size_t c = 0; c < numClusters; c++){
+			outwards[c] = glm::dot(centroids[c] - meshCentroid, normals[c]);
+		}
+		std::vector<std::size_t> order(numClusters);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){
+			return outwards[a] > outwards[b];
+		});
+
+		std::vector<uint32_t> sorted;
+		sorted.reserve(numTriangles * 3);
+		for(auto c: order){
+			sorted.insert(sorted.end(), triangles + clusters[c] * 3, triangles + clusters[c + 1] * 3);
+		}
+		std::copy(sorted.begin(), sorted.end(), triangles);
+	}
+}
+}
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
@@ -66,8 +688,27 @@ void ofMesh_<V,N,C,T>::clear(){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 bool ofMesh_<V,N,C,T>::haveVertsChanged(){
+	if(bVertsChanged || !vertsDirty.empty()){
+		bVertsChanged = false;
+		vertsDirty.clear();
+		return true;
+	}else{
+		return false;
+	}
+}
+
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::haveVertsChanged(ofMeshDirtyRanges & changed){
+	changed.clear();
 	if(bVertsChanged){
 		bVertsChanged = false;
+		vertsDirty.clear();
+		return true;
+	}else if(!vertsDirty.empty()){
+		std::swap(changed, vertsDirty);
 		return true;
 	}else{
 		return false;
@@ -79,8 +720,27 @@ bool ofMesh_<V,N,C,T>::haveVertsChanged(){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 bool ofMesh_<V,N,C,T>::haveColorsChanged(){
+	if(bColorsChanged || !colorsDirty.empty()){
+		bColorsChanged = false;
+		colorsDirty.clear();
+		return true;
+	}else{
+		return false;
+	}
+}
+
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::haveColorsChanged(ofMeshDirtyRanges & changed){
+	changed.clear();
 	if(bColorsChanged){
 		bColorsChanged = false;
+		colorsDirty.clear();
+		return true;
+	}else if(!colorsDirty.empty()){
+		std::swap(changed, colorsDirty);
 		return true;
 	}else{
 		return false;
@@ -92,8 +752,27 @@ bool ofMesh_<V,N,C,T>::haveColorsChanged(){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 bool ofMesh_<V,N,C,T>::haveNormalsChanged(){
+	if(bNormalsChanged || !normalsDirty.empty()){
+		bNormalsChanged = false;
+		normalsDirty.clear();
+		return true;
+	}else{
+		return false;
+	}
+}
+
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::haveNormalsChanged(ofMeshDirtyRanges & changed){
+	changed.clear();
 	if(bNormalsChanged){
 		bNormalsChanged = false;
+		normalsDirty.clear();
+		return true;
+	}else if(!normalsDirty.empty()){
+		std::swap(changed, normalsDirty);
 		return true;
 	}else{
 		return false;
@@ -105,8 +784,27 @@ bool ofMesh_<V,N,C,T>::haveNormalsChanged(){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 bool ofMesh_<V,N,C,T>::haveTexCoordsChanged(){
+	if(bTexCoordsChanged || !texCoordsDirty.empty()){
+		bTexCoordsChanged = false;
+		texCoordsDirty.clear();
+		return true;
+	}else{
+		return false;
+	}
+}
+
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::haveTexCoordsChanged(ofMeshDirtyRanges & changed){
+	changed.clear();
 	if(bTexCoordsChanged){
 		bTexCoordsChanged = false;
+		texCoordsDirty.clear();
+		return true;
+	}else if(!texCoordsDirty.empty()){
+		std::swap(changed, texCoordsDirty);
 		return true;
 	}else{
 		return false;
@@ -118,8 +816,27 @@ bool ofMesh_<V,N,C,T>::haveTexCoordsChanged(){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 bool ofMesh_<V,N,C,T>::haveIndicesChanged(){
+	if(bIndicesChanged || !indicesDirty.empty()){
+		bIndicesChanged = false;
+		indicesDirty.clear();
+		return true;
+	}else{
+		return false;
+	}
+}
+
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::haveIndicesChanged(ofMeshDirtyRanges & changed){
+	changed.clear();
 	if(bIndicesChanged){
 		bIndicesChanged = false;
+		indicesDirty.clear();
+		return true;
+	}else if(!indicesDirty.empty()){
+		std::swap(changed, indicesDirty);
 		return true;
 	}else{
 		return false;
@@ -175,7 +892,7 @@ bool ofMesh_<V,N,C,T>::hasIndices() const{
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addVertex(const V& v){
 	vertices.push_back(v);
-	bVertsChanged = true;
+	vertsDirty.add(vertices.size() - 1, vertices.size());
 	bFacesDirty = true;
 }
 
@@ -184,8 +901,9 @@ void ofMesh_<V,N,C,T>::addVertex(const V& v){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addVertices(const std::vector<V>& verts){
+	std::size_t first = vertices.size();
 	vertices.insert(vertices.end(),verts.begin(),verts.end());
-	bVertsChanged = true;
+	vertsDirty.add(first, vertices.size());
 	bFacesDirty = true;
 }
 
@@ -194,8 +912,9 @@ void ofMesh_<V,N,C,T>::addVertices(const std::vector<V>& verts){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addVertices(const V* verts, std::size_t amt){
+	std::size_t first = vertices.size();
 	vertices.insert(vertices.end(),verts,verts+amt);
-	bVertsChanged = true;
+	vertsDirty.add(first, vertices.size());
 	bFacesDirty = true;
 }
 
@@ -205,7 +924,7 @@ void ofMesh_<V,N,C,T>::addVertices(const V* verts, std::size_t amt){
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addColor(const C& c){
 	colors.push_back(c);
-	bColorsChanged = true;
+	colorsDirty.add(colors.size() - 1, colors.size());
 	bFacesDirty = true;
 }
 
@@ -214,8 +933,9 @@ void ofMesh_<V,N,C,T>::addColor(const C& c){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addColors(const std::vector<C>& cols){
+	std::size_t first = colors.size();
 	colors.insert(colors.end(),cols.begin(),cols.end());
-	bColorsChanged = true;
+	colorsDirty.add(first, colors.size());
 	bFacesDirty = true;
 }
 
@@ -224,8 +944,9 @@ void ofMesh_<V,N,C,T>::addColors(const std::vector<C>& cols){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addColors(const C* cols, std::size_t amt){
+	std::size_t first = colors.size();
 	colors.insert(colors.end(),cols,cols+amt);
-	bColorsChanged = true;
+	colorsDirty.add(first, colors.size());
 	bFacesDirty = true;
 }
 
@@ -235,7 +956,7 @@ void ofMesh_<V,N,C,T>::addColors(const C* cols, std::size_t amt){
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addNormal(const N& n){
 	normals.push_back(n);
-	bNormalsChanged = true;
+	normalsDirty.add(normals.size() - 1, normals.size());
 	bFacesDirty = true;
 }
 
@@ -244,8 +965,9 @@ void ofMesh_<V,N,C,T>::addNormal(const N& n){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addNormals(const std::vector<N>& norms){
+	std::size_t first = normals.size();
 	normals.insert(normals.end(),norms.begin(),norms.end());
-	bNormalsChanged = true;
+	normalsDirty.add(first, normals.size());
 	bFacesDirty = true;
 }
 
@@ -254,8 +976,9 @@ void ofMesh_<V,N,C,T>::addNormals(const std::vector<N>& norms){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addNormals(const N* norms, std::size_t amt){
+	std::size_t first = normals.size();
 	normals.insert(normals.end(),norms,norms+amt);
-	bNormalsChanged = true;
+	normalsDirty.add(first, normals.size());
 	bFacesDirty = true;
 }
 
@@ -266,7 +989,7 @@ template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addTexCoord(const T& t){
 	//TODO: figure out if we add to all other arrays to match
 	texCoords.push_back(t);
-	bTexCoordsChanged = true;
+	texCoordsDirty.add(texCoords.size() - 1, texCoords.size());
 	bFacesDirty = true;
 }
 
@@ -275,8 +998,9 @@ void ofMesh_<V,N,C,T>::addTexCoord(const T& t){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addTexCoords(const std::vector<T>& tCoords){
+	std::size_t first = texCoords.size();
 	texCoords.insert(texCoords.end(),tCoords.begin(),tCoords.end());
-	bTexCoordsChanged = true;
+	texCoordsDirty.add(first, texCoords.size());
 	bFacesDirty = true;
 }
 
@@ -285,8 +1009,9 @@ void ofMesh_<V,N,C,T>::addTexCoords(const std::vector<T>& tCoords){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addTexCoords(const T* tCoords, std::size_t amt){
+	std::size_t first = texCoords.size();
 	texCoords.insert(texCoords.end(),tCoords,tCoords+amt);
-	bTexCoordsChanged = true;
+	texCoordsDirty.add(first, texCoords.size());
 	bFacesDirty = true;
 }
 
@@ -304,7 +1029,7 @@ ofIndexType ofMesh_<V,N,C,T>::getIndex(ofIndexType i) const{
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addIndex(ofIndexType i){
 	indices.push_back(i);
-	bIndicesChanged = true;
+	indicesDirty.add(indices.size() - 1, indices.size());
 	bFacesDirty = true;
 }
 
@@ -313,8 +1038,9 @@ void ofMesh_<V,N,C,T>::addIndex(ofIndexType i){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addIndices(const std::vector<ofIndexType>& inds){
+	std::size_t first = indices.size();
 	indices.insert(indices.end(),inds.begin(),inds.end());
-	bIndicesChanged = true;
+	indicesDirty.add(first, indices.size());
 	bFacesDirty = true;
 }
 
@@ -323,8 +1049,9 @@ void ofMesh_<V,N,C,T>::addIndices(const std::vector<ofIndexType>& inds){
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::addIndices(const ofIndexType* inds, std::size_t amt){
+	std::size_t first = indices.size();
 	indices.insert(indices.end(),inds,inds+amt);
-	bIndicesChanged = true;
+	indicesDirty.add(first, indices.size());
 	bFacesDirty = true;
 }
 
@@ -747,8 +1474,7 @@ void ofMesh_<V,N,C,T>::setMode(ofPrimitiveMode m){
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::setVertex(ofIndexType index, const V& v){
 	vertices[index] = v;
-	bVertsChanged = true;
-	bIndicesChanged = true;
+	vertsDirty.add(index, index + 1);
 	bFacesDirty = true;
 }
 
@@ -758,7 +1484,7 @@ void ofMesh_<V,N,C,T>::setVertex(ofIndexType index, const V& v){
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::setNormal(ofIndexType index, const N& n){
 	normals[index] = n;
-	bNormalsChanged = true;
+	normalsDirty.add(index, index + 1);
 	bFacesDirty = true;
 }
 
@@ -768,7 +1494,7 @@ void ofMesh_<V,N,C,T>::setNormal(ofIndexType index, const N& n){
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::setColor(ofIndexType index, const C& c){
 	colors[index] = c;
-	bColorsChanged = true;
+	colorsDirty.add(index, index + 1);
 	bFacesDirty = true;
 }
 
@@ -778,7 +1504,7 @@ void ofMesh_<V,N,C,T>::setColor(ofIndexType index, const C& c){
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::setTexCoord(ofIndexType index, const T& t){
 	texCoords[index] = t;
-	bTexCoordsChanged = true;
+	texCoordsDirty.add(index, index + 1);
 	bFacesDirty = true;
 }
 
@@ -788,7 +1514,7 @@ void ofMesh_<V,N,C,T>::setTexCoord(ofIndexType index, const T& t){
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::setIndex(ofIndexType index, ofIndexType  val){
 	indices[index] = val;
-	bIndicesChanged = true;
+	indicesDirty.add(index, index + 1);
 	bFacesDirty = true;
 }
 
@@ -1024,7 +1750,7 @@ void ofMesh_<V,N,C,T>::append(const ofMesh_<V,N,C,T> & mesh){
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
-void ofMesh_<V,N,C,T>::load(const std::filesystem::path& path){
+void ofMesh_<V,N,C,T>::load(const std::filesystem::path& path, bool optimize){
 	ofFile is(path, ofFile::ReadOnly);
 	auto & data = *this;
 
@@ -1254,7 +1980,9 @@ void ofMesh_<V,N,C,T>::load(const std::filesystem::path& path){
 		}
 	}
 
-
+	if(optimize){
+		data.optimize();
+	}
 	return;
 	clean:
 	ofLogError("ofMesh") << "load(): " << lineNum << ":" << error;
@@ -1366,6 +2094,136 @@ void ofMesh_<V,N,C,T>::save(const std::filesystem::path& path, bool useBinary) c
 	//TODO: add index generation for other OF_PRIMITIVE cases
 }
 
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::saveBinary(ofBuffer & buffer) const{
+	static_assert(std::is_trivially_copyable<V>::value && std::is_trivially_copyable<N>::value &&
+		std::is_trivially_copyable<C>::value && std::is_trivially_copyable<T>::value,
+		"binary meshes need trivially copyable types");
+
+	of::priv::MeshBinaryHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, of::priv::meshBinaryMagic, sizeof(header.magic));
+	header.version = of::priv::meshBinaryVersion;
+	header.byteOrder = of::priv::meshBinaryByteOrder;
+	header.mode = mode;
+	header.flags = (useColors ? of::priv::MeshUseColors : 0) |
+		(useTextures ? of::priv::MeshUseTextures : 0) |
+		(useNormals ? of::priv::MeshUseNormals : 0) |
+		(useIndices ? of::priv::MeshUseIndices : 0);
+
+	const char * arrays[5] = {
+		reinterpret_cast<const char*>(vertices.data()),
+		reinterpret_cast<const char*>(normals.data()),
+		reinterpret_cast<const char*>(colors.data()),
+		reinterpret_cast<const char*>(texCoords.data()),
+		reinterpret_cast<const char*>(indices.data()),
+	};
+	header.elementSize[of::priv::MeshVertices] = sizeof(V);
+	header.elementSize[of::priv::MeshNormals] = sizeof(N);
+	header.elementSize[of::priv::MeshColors] = sizeof(C);
+	header.elementSize[of::priv::MeshTexCoords] = sizeof(T);
+	header.elementSize[of::priv::MeshIndices] = sizeof(ofIndexType);
+	header.count[of::priv::MeshVertices] = vertices.size();
+	header.count[of::priv::MeshNormals] = normals.size();
+	header.count[of::priv::MeshColors] = colors.size();
+	header.count[of::priv::MeshTexCoords] = texCoords.size();
+	header.count[of::priv::MeshIndices] = indices.size();
+
+	uint64_t offset = sizeof(header);
+	for(std::size_t i = 0; i < 5; i++){
+		header.offset[i] = offset;
+		offset += header.count[i] * header.elementSize[i];
+		offset = (offset + of::priv::meshBinaryAlignment - 1) / of::priv::meshBinaryAlignment * of::priv::meshBinaryAlignment;
+	}
+
+	buffer.clear();
+	buffer.allocate(offset);
+	char * dst = buffer.getData();
+	memset(dst, 0, offset);
+	memcpy(dst, &header, sizeof(header));
+	for(std::size_t i = 0; i < 5; i++){
+		if(header.count[i]){
+			memcpy(dst + header.offset[i], arrays[i], header.count[i] * header.elementSize[i]);
+		}
+	}
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::saveBinary(const std::filesystem::path& path) const{
+	ofBuffer buffer;
+	saveBinary(buffer);
+	if(!ofBufferToFile(path, buffer, true)){
+		ofLogError("ofMesh") << "saveBinary(): couldn't save " << path;
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::loadBinary(const std::filesystem::path& path){
+	ofMappedBuffer file;
+	if(!file.open(path)){
+		ofLogError("ofMesh") << "loadBinary(): couldn't open " << path;
+		return false;
+	}
+	return loadBinary(file.getData(), file.size());
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+bool ofMesh_<V,N,C,T>::loadBinary(const char * data, std::size_t size){
+	of::priv::MeshBinaryHeader header;
+	if(!data || size < sizeof(header)){
+		ofLogError("ofMesh") << "loadBinary(): not a binary mesh";
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+	if(memcmp(header.magic, of::priv::meshBinaryMagic, sizeof(header.magic)) != 0){
+		ofLogError("ofMesh") << "loadBinary(): not a binary mesh";
+		return false;
+	}
+	if(header.version > of::priv::meshBinaryVersion){
+		ofLogError("ofMesh") << "loadBinary(): unsupported binary mesh version " << header.version;
+		return false;
+	}
+	if(header.byteOrder != of::priv::meshBinaryByteOrder){
+		ofLogError("ofMesh") << "loadBinary(): the mesh was saved on a machine with a different byte order";
+		return false;
+	}
+
+	// load into a copy so the mesh isn't left half loaded on errors
+	std::vector<V> newVertices;
+	std::vector<N> newNormals;
+	std::vector<C> newColors;
+	std::vector<T> newTexCoords;
+	std::vector<ofIndexType> newIndices;
+	if(!of::priv::loadMeshArray(header, of::priv::MeshVertices, data, size, newVertices) ||
+	   !of::priv::loadMeshArray(header, of::priv::MeshNormals, data, size, newNormals) ||
+	   !of::priv::loadMeshArray(header, of::priv::MeshColors, data, size, newColors) ||
+	   !of::priv::loadMeshArray(header, of::priv::MeshTexCoords, data, size, newTexCoords) ||
+	   !of::priv::loadMeshArray(header, of::priv::MeshIndices, data, size, newIndices)){
+		ofLogError("ofMesh") << "loadBinary(): the mesh is truncated or was saved with different vertex types";
+		return false;
+	}
+
+	vertices = std::move(newVertices);
+	normals = std::move(newNormals);
+	colors = std::move(newColors);
+	texCoords = std::move(newTexCoords);
+	indices = std::move(newIndices);
+	bVertsChanged = bNormalsChanged = bColorsChanged = bTexCoordsChanged = bIndicesChanged = true;
+	bFacesDirty = true;
+	mode = ofPrimitiveMode(header.mode);
+	useColors = (header.flags & of::priv::MeshUseColors) != 0;
+	useTextures = (header.flags & of::priv::MeshUseTextures) != 0;
+	useNormals = (header.flags & of::priv::MeshUseNormals) != 0;
+	useIndices = (header.flags & of::priv::MeshUseIndices) != 0;
+	return true;
+}
+
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
@@ -1569,28 +2427,26 @@ const std::vector<ofMeshFace_<V,N,C,T>> & ofMesh_<V,N,C,T>::getUniqueFaces() con
 		// that way we can calculate face normals and use getFaceNormal();
 		faces.resize( indices.size()/3 );
 
-		int index	   = 0;
-		int triindex	= 0;
-
 		bool bHasColors	 = hasColors();
 		bool bHasNormals	= hasNormals();
 		bool bHasTexcoords  = hasTexCoords();
 
 		if( getMode() == OF_PRIMITIVE_TRIANGLES) {
-			for(std::size_t j = 0; j < indices.size(); j += 3) {
-				ofMeshFace_<V,N,C,T> & tri = faces[triindex];
-				for(std::size_t k = 0; k < 3; k++) {
-					index = indices[j+k];
-					tri.setVertex( k, vertices[index] );
-					if(bHasNormals)
-						tri.setNormal(k, normals[index] );
-					if(bHasTexcoords)
-						tri.setTexCoord(k, texCoords[index] );
-					if(bHasColors)
-						tri.setColor(k, colors[index] );
+			ofGetTaskPool().parallelFor(0, faces.size(), [&](std::size_t begin, std::size_t end){
+				for(std::size_t j = begin; j < end; j++) {
+					ofMeshFace_<V,N,C,T> & tri = faces[j];
+					for(std::size_t k = 0; k < 3; k++) {
+						ofIndexType index = indices[j*3+k];
+						tri.setVertex( k, vertices[index] );
+						if(bHasNormals)
+							tri.setNormal(k, normals[index] );
+						if(bHasTexcoords)
+							tri.setTexCoord(k, texCoords[index] );
+						if(bHasColors)
+							tri.setColor(k, colors[index] );
+					}
 				}
-				triindex++;
-			}
+			}, of::priv::meshFacesPerTask);
 
 		} else {
 			ofLogWarning("ofMesh") << "getUniqueFaces(): only works with primitive mode OF_PRIMITIVE_TRIANGLES";
@@ -1617,21 +2473,17 @@ std::vector<N> ofMesh_<V,N,C,T>::getFaceNormals( bool perVertex ) const{
 			}else{
 				faceNormals.resize(indices.size());
 			}
-			ofMeshFace_<V,N,C,T> face;
-			N n;
-			for(ofIndexType i = 0; i < indices.size(); i+=3) {
-				face.setVertex( 0, vertices[indices[i+0]] );
-				face.setVertex( 1, vertices[indices[i+1]] );
-				face.setVertex( 2, vertices[indices[i+2]] );
-
-				n = face.getFaceNormal();
-
-				faceNormals[i]=n;
-				if(perVertex) {
-					faceNormals[i+1]=n;
-					faceNormals[i+2]=n;
+			ofGetTaskPool().parallelFor(0, indices.size()/3, [&](std::size_t begin, std::size_t end){
+				for(std::size_t face = begin; face < end; face++) {
+					std::size_t i = face * 3;
+					N n = of::priv::faceNormal(vertices[indices[i+0]], vertices[indices[i+1]], vertices[indices[i+2]]);
+					faceNormals[i]=n;
+					if(perVertex) {
+						faceNormals[i+1]=n;
+						faceNormals[i+2]=n;
+					}
 				}
-			}
+			}, of::priv::meshFacesPerTask);
 		}
 	}
 
@@ -1647,42 +2499,44 @@ void ofMesh_<V,N,C,T>::setFromTriangles( const std::vector<ofMeshFace_<V,N,C,T>>
 		return;
 	}
 
-	typename std::vector<ofMeshFace_<V,N,C,T>>::const_iterator it;
-
 	vertices.resize(tris.size()*3 );
-	it = tris.begin();
 	// if the first tri has data, assume the rest do as well //
-	if(it->hasNormals()){
+	if(tris.front().hasNormals() || bUseFaceNormal){
 		normals.resize(tris.size()*3);
 	}else{
 		normals.clear();
 	}
-	if(it->hasColors()){
+	if(tris.front().hasColors()){
 		colors.resize(tris.size()*3);
 	}else{
 		colors.clear();
 	}
-	if(it->hasTexcoords()){
+	if(tris.front().hasTexcoords()){
 		texCoords.resize(tris.size()*3);
 	}else{
 		texCoords.clear();
 	}
 
-	int i = 0;
-	for(it = tris.begin(); it != tris.end(); it++) {
-		for(std::size_t k = 0; k < 3; k++) {
-			vertices[i] = it->getVertex(k);
-			if(it->hasTexcoords())
-				texCoords[i] = it->getTexCoord(k);
-			if(it->hasColors())
-				colors[i] = it->getColor(k);
-			if(bUseFaceNormal)
-				normals[i] = it->getFaceNormal();
-			else if(it->hasNormals())
-				normals[i] = it->getNormal(k);
-			i++;
+	bool bHasNormals = !normals.empty();
+	bool bHasColors = !colors.empty();
+	bool bHasTexcoords = !texCoords.empty();
+	ofGetTaskPool().parallelFor(0, tris.size(), [&](std::size_t begin, std::size_t end){
+		for(std::size_t t = begin; t < end; t++) {
+			const ofMeshFace_<V,N,C,T> & tri = tris[t];
+			for(std::size_t k = 0; k < 3; k++) {
+				std::size_t i = t * 3 + k;
+				vertices[i] = tri.getVertex(k);
+				if(bHasTexcoords && tri.hasTexcoords())
+					texCoords[i] = tri.getTexCoord(k);
+				if(bHasColors && tri.hasColors())
+					colors[i] = tri.getColor(k);
+				if(bUseFaceNormal)
+					normals[i] = tri.getFaceNormal();
+				else if(bHasNormals && tri.hasNormals())
+					normals[i] = tri.getNormal(k);
+			}
 		}
-	}
+	}, of::priv::meshFacesPerTask);
 
 	setupIndicesAuto();
 	bVertsChanged = true;
@@ -1701,99 +2555,143 @@ template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::smoothNormals( float angle ) {
 
 	if( getMode() == OF_PRIMITIVE_TRIANGLES) {
-		std::vector<ofMeshFace_<V,N,C,T>> triangles = getUniqueFaces();
-		std::vector<V> verts;
-		for(ofIndexType i = 0; i < triangles.size(); i++) {
-			for(ofIndexType j = 0; j < 3; j++) {
-				verts.push_back( triangles[i].getVertex(j) );
-			}
-		}
-
-		std::map<int, int> removeIds;
-
-		float epsilon = .01f;
-		for(ofIndexType i = 0; i < verts.size()-1; i++) {
-			for(ofIndexType j = i+1; j < verts.size(); j++) {
-				if(i != j) {
-					const auto& v1 = toGlm(verts[i]);
-					const auto& v2 = toGlm(verts[j]);
-					if( glm::distance(v1, v2) <= epsilon ) {
-						// average the location //
-						verts[i] = (v1+v2)/2.f;
-						verts[j] = verts[i];
-						removeIds[j] = 1;
-					}
-				}
+		// every corner of every face, indexed or not
+		bool bIndexed = hasIndices();
+		std::size_t numCorners = (bIndexed ? indices.size() : vertices.size()) / 3 * 3;
+		std::size_t numFaces = numCorners / 3;
+		if(numFaces == 0) return;
+		auto vertexIndex = [&](std::size_t corner) -> std::size_t{
+			return bIndexed ? indices[corner] : corner;
+		};
+
+		std::vector<glm::vec3> faceNormals(numFaces);
+		ofGetTaskPool().parallelFor(0, numFaces, [&](std::size_t begin, std::size_t end){
+			for(std::size_t f = begin; f < end; f++){
+				faceNormals[f] = of::priv::faceNormal(vertices[vertexIndex(f*3)], vertices[vertexIndex(f*3+1)], vertices[vertexIndex(f*3+2)]);
 			}
-		}
-
-		// string of vertex in 3d space to triangle index //
-		std::map<std::string, std::vector<int> > vertHash;
-
-		//ofLogNotice("ofMesh") << "smoothNormals(): num verts = " << verts.size() << " tris size = " << triangles.size();
-
-		std::string xStr, yStr, zStr;
-
-		for(ofIndexType i = 0; i < verts.size(); i++ ) {
-			xStr = "x"+ofToString(verts[i].x==-0?0:verts[i].x);
-			yStr = "y"+ofToString(verts[i].y==-0?0:verts[i].y);
-			zStr = "z"+ofToString(verts[i].z==-0?0:verts[i].z);
-			std::string vstring = xStr+yStr+zStr;
-			if(vertHash.find(vstring) == vertHash.end()) {
-				for(ofIndexType j = 0; j < triangles.size(); j++) {
-					for(ofIndexType k = 0; k < 3; k++) {
-						if(verts[i].x == triangles[j].getVertex(k).x) {
-							if(verts[i].y == triangles[j].getVertex(k).y) {
-								if(verts[i].z == triangles[j].getVertex(k).z) {
-									vertHash[vstring].push_back( j );
-								}
-							}
-						}
+		}, of::priv::meshFacesPerTask);
+
+		// weld the vertices closer than epsilon using a hash grid with cells
+		// of 2 * epsilon, any point closer than epsilon is then in one of
+		// the 8 cells on the side of the nearest borders
+		const float epsilon = .01f;
+		const float cellSize = epsilon * 2.f;
+		const uint32_t none = std::numeric_limits<uint32_t>::max();
+		std::vector<uint32_t> vertexWeld(vertices.size(), none);
+		std::vector<glm::vec3> weldPositions;
+		std::vector<uint32_t> weldNext;
+		// open addressing table from cell to the first welded vertex in it,
+		// with at least twice as many slots as vertices
+		std::size_t gridBits = 1;
+		while((std::size_t(1) << gridBits) < vertices.size() * 2) gridBits++;
+		const uint64_t gridMask = (uint64_t(1) << gridBits) - 1;
+		const uint64_t emptyCell = std::numeric_limits<uint64_t>::max();
+		std::vector<uint64_t> gridKeys(gridMask + 1, emptyCell);
+		std::vector<uint32_t> gridHeads(gridMask + 1, none);
+		auto cellKey = [](int64_t x, int64_t y, int64_t z) -> uint64_t{
+			const uint64_t mask = (1 << 21) - 1;
+			return (uint64_t(x) & mask) | ((uint64_t(y) & mask) << 21) | ((uint64_t(z) & mask) << 42);
+		};
+		auto findCell = [&](uint64_t key) -> std::size_t{
+			std::size_t slot = (key * 0x9E3779B97F4A7C15ull) >> (64 - gridBits);
+			while(gridKeys[slot] != key && gridKeys[slot] != emptyCell){
+				slot = (slot + 1) & gridMask;
+			}
+			return slot;
+		};
+		for(std::size_t corner = 0; corner < numCorners; corner++){
+			std::size_t index = vertexIndex(corner);
+			if(vertexWeld[index] != none) continue;
+			glm::vec3 p = toGlm(vertices[index]);
+			glm::vec3 cellPos = p / cellSize;
+			glm::vec3 cell = glm::floor(cellPos);
+			glm::vec3 fraction = cellPos - cell;
+			int64_t cx = int64_t(cell.x), cy = int64_t(cell.y), cz = int64_t(cell.z);
+			int64_t nx = fraction.x < .5f ? -1 : 1;
+			int64_t ny = fraction.y < .5f ? -1 : 1;
+			int64_t nz = fraction.z < .5f ? -1 : 1;
+			uint32_t weld = none;
+			for(int n = 0; n < 8 && weld == none; n++){
+				std::size_t slot = findCell(cellKey(cx + (n & 1 ? nx : 0), cy + (n & 2 ? ny : 0), cz + (n & 4 ? nz : 0)));
+				for(uint32_t w = gridHeads[slot]; w != none; w = weldNext[w]){
+					if(glm::distance(weldPositions[w], p) <= epsilon){
+						weld = w;
+						break;
 					}
 				}
 			}
+			if(weld == none){
+				weld = uint32_t(weldPositions.size());
+				weldPositions.push_back(p);
+				uint64_t key = cellKey(cx, cy, cz);
+				std::size_t slot = findCell(key);
+				gridKeys[slot] = key;
+				weldNext.push_back(gridHeads[slot]);
+				gridHeads[slot] = weld;
+			}
+			vertexWeld[index] = weld;
 		}
 
-//		for( std::map<std::string, std::vector<int> >::iterator it = vertHash.begin(); it != vertHash.end(); ++it) {
-//			//for( std::map<std::string, int >::iterator it = vertHash.begin(); it != vertHash.end(); ++it) {
-//			ofLogNotice("ofMesh") << "smoothNormals(): " << it->first << "  num = " << it->second.size();
-//		}
+		// faces touching each welded vertex, packed in one array
+		std::vector<uint32_t> weldFacesStart(weldPositions.size() + 1, 0);
+		for(std::size_t corner = 0; corner < numCorners; corner++){
+			weldFacesStart[vertexWeld[vertexIndex(corner)] + 1]++;
+		}
+		for(std::size_t w = 1; w < weldFacesStart.size(); w++){
+			weldFacesStart[w] += weldFacesStart[w - 1];
+		}
+		std::vector<uint32_t> weldFaces(numCorners);
+		std::vector<uint32_t> weldFacesCount(weldPositions.size(), 0);
+		for(std::size_t corner = 0; corner < numCorners; corner++){
+			uint32_t w = vertexWeld[vertexIndex(corner)];
+			weldFaces[weldFacesStart[w] + weldFacesCount[w]++] = uint32_t(corner / 3);
+		}
 
-		V vert;
-		N normal;
+		// every corner gets the average of the normals of the faces around
+		// it that are within angle of its own face, the result has a
+		// vertex per corner like setFromTriangles()
 		float angleCos = cos(angle * DEG_TO_RAD );
-		float numNormals=0;
-
-		for(ofIndexType j = 0; j < triangles.size(); j++) {
-			for(ofIndexType k = 0; k < 3; k++) {
-				vert = triangles[j].getVertex(k);
-				xStr = "x"+ofToString(vert.x==-0?0:vert.x);
-				yStr = "y"+ofToString(vert.y==-0?0:vert.y);
-				zStr = "z"+ofToString(vert.z==-0?0:vert.z);
-
-				std::string vstring = xStr+yStr+zStr;
-				numNormals=0;
-				normal = {0.f,0.f,0.f};
-				if(vertHash.find(vstring) != vertHash.end()) {
-					for(ofIndexType i = 0; i < vertHash[vstring].size(); i++) {
-						auto f1 = triangles[j].getFaceNormal();
-						auto f2 = triangles[vertHash[vstring][i]].getFaceNormal();
-						if(glm::dot(toGlm(f1), toGlm(f2)) >= angleCos ) {
-							normal += f2;
-							numNormals+=1.f;
+		bool bHasColors = hasColors();
+		bool bHasTexcoords = hasTexCoords();
+		std::vector<V> newVertices(numCorners);
+		std::vector<N> newNormals(numCorners);
+		std::vector<C> newColors(bHasColors ? numCorners : 0);
+		std::vector<T> newTexCoords(bHasTexcoords ? numCorners : 0);
+		ofGetTaskPool().parallelFor(0, numFaces, [&](std::size_t begin, std::size_t end){
+			for(std::size_t f = begin; f < end; f++){
+				const glm::vec3 & faceNormal = faceNormals[f];
+				for(std::size_t k = 0; k < 3; k++){
+					std::size_t corner = f * 3 + k;
+					std::size_t index = vertexIndex(corner);
+					uint32_t w = vertexWeld[index];
+					glm::vec3 normal(0.f);
+					float numNormals = 0;
+					for(uint32_t i = weldFacesStart[w]; i < weldFacesStart[w + 1]; i++){
+						const glm::vec3 & other = faceNormals[weldFaces[i]];
+						if(glm::dot(faceNormal, other) >= angleCos){
+							normal += other;
+							numNormals += 1.f;
 						}
 					}
-					//normal /= (float)vertHash[vstring].size();
-					normal /= numNormals;
-
-					triangles[j].setNormal(k, normal);
+					newNormals[corner] = numNormals > 0 ? normal / numNormals : faceNormal;
+					newVertices[corner] = vertices[index];
+					if(bHasColors) newColors[corner] = colors[index];
+					if(bHasTexcoords) newTexCoords[corner] = texCoords[index];
 				}
 			}
-		}
-
-		//ofLogNotice("ofMesh") << "smoothNormals(): setting from triangles ";
-		setFromTriangles( triangles );
+		}, of::priv::meshFacesPerTask);
 
+		vertices = std::move(newVertices);
+		normals = std::move(newNormals);
+		colors = std::move(newColors);
+		texCoords = std::move(newTexCoords);
+		setupIndicesAuto();
+		bVertsChanged = true;
+		bIndicesChanged = true;
+		bNormalsChanged = true;
+		bColorsChanged = true;
+		bTexCoordsChanged = true;
+		bFacesDirty = true;
 	}
 }
 
@@ -1842,6 +2740,234 @@ void ofMesh_<V,N,C,T>::flatNormals() {
     }
 }
 
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+std::vector<ofIndexType> ofMesh_<V,N,C,T>::getSimplifiedIndices(std::size_t numTriangles, float maxError, float * error) const{
+	if(error) *error = 0;
+	if(getMode() != OF_PRIMITIVE_TRIANGLES){
+		ofLogError("ofMesh") << "getSimplifiedIndices(): only OF_PRIMITIVE_TRIANGLES meshes can be simplified";
+		return indices;
+	}
+	std::vector<glm::vec3> positions(vertices.size());
+	for(std::size_t i = 0; i < vertices.size(); i++){
+		positions[i] = toGlm(vertices[i]);
+	}
+	std::vector<uint32_t> triangles;
+	if(hasIndices()){
+		triangles.assign(indices.begin(), indices.end());
+	}else{
+		triangles.resize(vertices.size() / 3 * 3);
+		std::iota(triangles.begin(), triangles.end(), 0);
+	}
+	float resultError;
+	triangles = of::priv::simplifyMeshTriangles(positions, std::move(triangles), numTriangles, maxError, resultError);
+	if(error) *error = resultError;
+	return std::vector<ofIndexType>(triangles.begin(), triangles.end());
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+ofMesh_<V,N,C,T> ofMesh_<V,N,C,T>::getSimplified(std::size_t numTriangles, float maxError, float * error) const{
+	auto simplified = getSimplifiedIndices(numTriangles, maxError, error);
+	if(getMode() != OF_PRIMITIVE_TRIANGLES){
+		return *this;
+	}
+
+	ofMesh_<V,N,C,T> mesh;
+	mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+	bool bHasNormals = normals.size() == vertices.size();
+	bool bHasColors = colors.size() == vertices.size();
+	bool bHasTexCoords = texCoords.size() == vertices.size();
+	const ofIndexType none = std::numeric_limits<ofIndexType>::max();
+	std::vector<ofIndexType> remap(vertices.size(), none);
+	mesh.getIndices().reserve(simplified.size());
+	for(auto index: simplified){
+		if(remap[index] == none){
+			remap[index] = ofIndexType(mesh.getNumVertices());
+			mesh.addVertex(vertices[index]);
+			if(bHasNormals) mesh.addNormal(normals[index]);
+			if(bHasColors) mesh.addColor(colors[index]);
+			if(bHasTexCoords) mesh.addTexCoord(texCoords[index]);
+		}
+		mesh.addIndex(remap[index]);
+	}
+	if(!usingNormals()) mesh.disableNormals();
+	if(!usingColors()) mesh.disableColors();
+	if(!usingTextures()) mesh.disableTextures();
+	return mesh;
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::removeDuplicateVertices(){
+	std::size_t numVertices = vertices.size();
+	if(numVertices == 0){
+		return;
+	}
+	bool bHasNormals = normals.size() == numVertices;
+	bool bHasColors = colors.size() == numVertices;
+	bool bHasTexCoords = texCoords.size() == numVertices;
+
+	// fnv-1a of the bytes of every attribute
+	auto hashBytes = [](uint64_t hash, const void * data, std::size_t size){
+		auto bytes = static_cast<const unsigned char*>(data);
+		for(std::size_t i = 0; i < size; i++){
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		return hash;
+	};
+	auto hashVertex = [&](std::size_t i){
+		uint64_t hash = hashBytes(14695981039346656037ull, &vertices[i], sizeof(V));
+		if(bHasNormals) hash = hashBytes(hash, &normals[i], sizeof(N));
+		if(bHasColors) hash = hashBytes(hash, &colors[i], sizeof(C));
+		if(bHasTexCoords) hash = hashBytes(hash, &texCoords[i], sizeof(T));
+		return hash;
+	};
+	auto equal = [&](std::size_t a, std::size_t b){
+		return memcmp(&vertices[a], &vertices[b], sizeof(V)) == 0 &&
+			(!bHasNormals || memcmp(&normals[a], &normals[b], sizeof(N)) == 0) &&
+			(!bHasColors || memcmp(&colors[a], &colors[b], sizeof(C)) == 0) &&
+			(!bHasTexCoords || memcmp(&texCoords[a], &texCoords[b], sizeof(T)) == 0);
+	};
+
+	std::vector<uint64_t> hashes(numVertices);
+	ofGetTaskPool().parallelFor(0, numVertices, [&](std::size_t begin, std::size_t end){
+		for(std::size_t i = begin; i < end; i++){
+			hashes[i] = hashVertex(i);
+		}
+	});
+
+	// open addressing table of the first vertex with each value
+	const ofIndexType none = std::numeric_limits<ofIndexType>::max();
+	std::size_t tableSize = 1;
+	while(tableSize < numVertices * 2){
+		tableSize *= 2;
+	}
+	std::vector<ofIndexType> table(tableSize, none);
+	std::vector<ofIndexType> remap(numVertices);
+	std::size_t numUnique = 0;
+	for(std::size_t i = 0; i < numVertices; i++){
+		std::size_t slot = hashes[i] & (tableSize - 1);
+		while(table[slot] != none && !equal(table[slot], i)){
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		if(table[slot] == none){
+			remap[i] = ofIndexType(numUnique);
+			// unique vertices are moved down, the ones before i are final
+			vertices[numUnique] = vertices[i];
+			if(bHasNormals) normals[numUnique] = normals[i];
+			if(bHasColors) colors[numUnique] = colors[i];
+			if(bHasTexCoords) texCoords[numUnique] = texCoords[i];
+			table[slot] = ofIndexType(numUnique);
+			numUnique++;
+		}else{
+			remap[i] = table[slot];
+		}
+	}
+	if(numUnique == numVertices){
+		return;
+	}
+
+	if(hasIndices()){
+		for(auto & index: indices){
+			index = remap[index];
+		}
+	}else{
+		indices = remap;
+	}
+	vertices.resize(numUnique);
+	if(bHasNormals) normals.resize(numUnique);
+	if(bHasColors) colors.resize(numUnique);
+	if(bHasTexCoords) texCoords.resize(numUnique);
+	bVertsChanged = bNormalsChanged = bColorsChanged = bTexCoordsChanged = bIndicesChanged = true;
+	bFacesDirty = true;
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimizeVertexCache(){
+	if(getMode() != OF_PRIMITIVE_TRIANGLES){
+		ofLogError("ofMesh") << "optimizeVertexCache(): only OF_PRIMITIVE_TRIANGLES meshes can be optimized";
+		return;
+	}
+	if(!hasIndices()){
+		indices.resize(vertices.size() / 3 * 3);
+		std::iota(indices.begin(), indices.end(), 0);
+	}
+	std::vector<uint32_t> triangles(indices.begin(), indices.end());
+	of::priv::optimizeMeshVertexCache(triangles.data(), triangles.size() / 3);
+	indices.assign(triangles.begin(), triangles.end());
+	bIndicesChanged = true;
+	bFacesDirty = true;
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimizeOverdraw(float threshold){
+	if(getMode() != OF_PRIMITIVE_TRIANGLES){
+		ofLogError("ofMesh") << "optimizeOverdraw(): only OF_PRIMITIVE_TRIANGLES meshes can be optimized";
+		return;
+	}
+	if(!hasIndices()){
+		indices.resize(vertices.size() / 3 * 3);
+		std::iota(indices.begin(), indices.end(), 0);
+	}
+	std::vector<glm::vec3> positions(vertices.size());
+	for(std::size_t i = 0; i < vertices.size(); i++){
+		positions[i] = toGlm(vertices[i]);
+	}
+	std::vector<uint32_t> triangles(indices.begin(), indices.end());
+	of::priv::optimizeMeshOverdraw(positions, triangles.data(), triangles.size() / 3, threshold);
+	indices.assign(triangles.begin(), triangles.end());
+	bIndicesChanged = true;
+	bFacesDirty = true;
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimizeVertexFetch(){
+	if(!hasIndices()){
+		return;
+	}
+	std::size_t numVertices = vertices.size();
+	const ofIndexType none = std::numeric_limits<ofIndexType>::max();
+	std::vector<ofIndexType> remap(numVertices, none);
+	std::vector<ofIndexType> order;
+	order.reserve(numVertices);
+	for(auto & index: indices){
+		if(remap[index] == none){
+			remap[index] = ofIndexType(order.size());
+			order.push_back(index);
+		}
+		index = remap[index];
+	}
+	auto reorder = [&](auto & attribute){
+		if(attribute.size() != numVertices) return;
+		typename std::remove_reference<decltype(attribute)>::type reordered(order.size());
+		for(std::size_t i = 0; i < order.size(); i++){
+			reordered[i] = attribute[order[i]];
+		}
+		attribute.swap(reordered);
+	};
+	reorder(vertices);
+	reorder(normals);
+	reorder(colors);
+	reorder(texCoords);
+	bVertsChanged = bNormalsChanged = bColorsChanged = bTexCoordsChanged = bIndicesChanged = true;
+	bFacesDirty = true;
+}
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimize(){
+	removeDuplicateVertices();
+	if(getMode() == OF_PRIMITIVE_TRIANGLES){
+		optimizeVertexCache();
+		optimizeOverdraw();
+	}
+	optimizeVertexFetch();
+}
+
 // PLANE MESH //
 
 
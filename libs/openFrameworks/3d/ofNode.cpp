@@ -79,6 +79,7 @@ ofNode & ofNode::operator=(const ofNode & node){
 	if(parent){
 		parent->addListener(*this);
 	}
+	invalidateGlobalTransform();
 	return *this;
 }
 
@@ -96,6 +97,8 @@ ofNode & ofNode::operator=(ofNode && node){
 	if(parent){
 		parent->addListener(*this);
 	}
+	globalTransformDirty = false;
+	invalidateGlobalTransform();
 	return *this;
 }
 
@@ -143,6 +146,7 @@ void ofNode::setParent(ofNode& parent, bool bMaintainGlobalTransform) {
 		parent.addListener(*this);
 	}
 	this->parent = &parent;
+	invalidateGlobalTransform();
 }
 
 //----------------------------------------
@@ -161,7 +165,7 @@ void ofNode::clearParent(bool bMaintainGlobalTransform) {
 	}else{
 		this->parent = nullptr;
 	}
-
+	invalidateGlobalTransform();
 }
 
 //----------------------------------------
@@ -549,9 +553,40 @@ const glm::mat4& ofNode::getLocalTransformMatrix() const {
 }
 
 //----------------------------------------
-glm::mat4 ofNode::getGlobalTransformMatrix() const {
-	if(parent) return parent->getGlobalTransformMatrix() * getLocalTransformMatrix();
-	else return getLocalTransformMatrix();
+const glm::mat4& ofNode::getGlobalTransformMatrix() const {
+	if(globalTransformDirty){
+		if(parent) globalTransformMatrix = parent->getGlobalTransformMatrix() * getLocalTransformMatrix();
+		else globalTransformMatrix = getLocalTransformMatrix();
+		globalTransformDirty = false;
+	}
+	return globalTransformMatrix;
+}
+
+//----------------------------------------
+void ofNode::updateGlobalTransforms() const {
+	// iterative so deep hierarchies don't overflow the stack, a node is
+	// always visited after its parent
+	std::vector<const ofNode*> pending{this};
+	while(!pending.empty()){
+		auto node = pending.back();
+		pending.pop_back();
+		node->getGlobalTransformMatrix();
+		pending.insert(pending.end(), node->children.begin(), node->children.end());
+	}
+}
+
+//----------------------------------------
+void ofNode::invalidateGlobalTransform() {
+	if(globalTransformDirty) return;
+	std::vector<ofNode*> pending{this};
+	while(!pending.empty()){
+		auto node = pending.back();
+		pending.pop_back();
+		if(!node->globalTransformDirty){
+			node->globalTransformDirty = true;
+			pending.insert(pending.end(), node->children.begin(), node->children.end());
+		}
+	}
 }
 
 //----------------------------------------
@@ -675,6 +710,7 @@ void ofNode::createMatrix() {
 	localTransformMatrix = glm::translate(glm::mat4(1.0), toGlm(position));
 	localTransformMatrix = localTransformMatrix * glm::toMat4((const glm::quat&)orientation);
 	localTransformMatrix = glm::scale(localTransformMatrix, toGlm(scale));
+	invalidateGlobalTransform();
 	
 	updateAxis();
 }
@@ -144,14 +144,23 @@ public:
 	/// \sa https://open.gl/transformations
 	const glm::mat4& getLocalTransformMatrix() const;
 	
-	// TODO: optimize and cache these
-	// (parent would need to know about its children so it can inform them 
-	// to update their global matrices if it itself transforms)
-	
 	/// \brief Get node's global transformations (position, orientation, scale).
+	///
+	/// It's cached and only calculated again after this node or one of its
+	/// parents is transformed or changes parent.
+	///
 	/// \returns A refrence to mat4 containing node's global transformations.
 	/// \sa https://open.gl/transformations
-	glm::mat4 getGlobalTransformMatrix() const;
+	const glm::mat4& getGlobalTransformMatrix() const;
+
+	/// \brief Calculates the global transformations of this node and all
+	/// its descendants that changed, parents before children
+	///
+	/// Calling it on the root of a hierarchy once its nodes are updated
+	/// makes the getGlobal... functions of all of them only read the
+	/// cached matrices, so they can be called from other threads until
+	/// a node is transformed again.
+	void updateGlobalTransforms() const;
 	
 	/// \brief Get node's global position as a 3D vector.
 	/// \returns A 3D vector with the global coordinates.
@@ -451,6 +460,9 @@ public:
 	
 protected:
 	void createMatrix();
+	/// \brief Marks the global transform of this node and its descendants
+	/// to be calculated again
+	void invalidateGlobalTransform();
 	void updateAxis();
 	
 	/// \brief classes extending ofNode can override this method to get
@@ -482,5 +494,9 @@ private:
 
 	void addListener(ofNode & node);
 	void removeListener(ofNode & node);
-//	glm::mat4 globalTransformMatrix;
+
+	// when a node is dirty all its descendants are too, so invalidating
+	// can stop at the first dirty node
+	mutable glm::mat4 globalTransformMatrix;
+	mutable bool globalTransformDirty = true;
 };
@@ -0,0 +1,168 @@
+#include "ofRenderList.h"
+#include "of3dPrimitives.h"
+#include "ofCamera.h"
+#include "ofOcclusionQuery.h"
+#include "of3dGraphics.h"
+#include "ofGraphics.h"
+#include <algorithm>
+
+using namespace std;
+
+//----------------------------------------------------------
+ofRenderList::ofRenderList(){}
+
+//----------------------------------------------------------
+// defined here so the header doesn't need ofOcclusionQuery to be complete
+ofRenderList::~ofRenderList(){}
+
+//----------------------------------------------------------
+void ofRenderList::add(const of3dPrimitive & primitive, bool transparent){
+	add(primitive, primitive.getGlobalBoundingBox(), transparent);
+}
+
+//----------------------------------------------------------
+void ofRenderList::add(const ofNode & node, const ofBoundingBox & globalBounds, bool transparent){
+	items.push_back({&node, globalBounds, transparent, 0.f});
+}
+
+//----------------------------------------------------------
+void ofRenderList::clear(){
+	items.clear();
+	visible.clear();
+}
+
+//----------------------------------------------------------
+void ofRenderList::draw(const ofCamera & camera){
+	draw(camera.getFrustum(), camera.getModelViewMatrix());
+}
+
+//----------------------------------------------------------
+void ofRenderList::draw(const ofFrustum & frustum, const glm::mat4 & viewMatrix){
+	visible.clear();
+	for(auto & item: items){
+		if(frustum.intersects(item.bounds)){
+			// the camera looks down -z, bigger depths are further away
+			item.depth = -(viewMatrix * glm::vec4(item.bounds.getCenter(), 1.0f)).z;
+			visible.push_back(&item);
+		}
+	}
+	numDrawn = visible.size();
+	numCulled = items.size() - visible.size();
+
+	std::stable_sort(visible.begin(), visible.end(), [](const Item * a, const Item * b){
+		if(a->transparent != b->transparent){
+			return b->transparent;
+		}
+		if(a->transparent){
+			return a->depth > b->depth;
+		}else{
+			return a->depth < b->depth;
+		}
+	});
+
+	numOccluded = 0;
+	bool occlusion = occlusionMode != OCCLUSION_OFF && ofOcclusionQuery::isSupported();
+	if(!occlusion){
+		occlusions.clear();
+		for(auto item: visible){
+			item->node->draw();
+		}
+		return;
+	}
+
+	drawCount++;
+	glm::vec3 eye = glm::inverse(viewMatrix)[3];
+	for(auto item: visible){
+		if(item->transparent){
+			item->node->draw();
+		}else{
+			drawOccluded(*item, eye);
+		}
+	}
+
+	// forget the nodes that weren't drawn this time
+	for(auto it = occlusions.begin(); it != occlusions.end();){
+		if(it->second.lastDraw != drawCount){
+			it = occlusions.erase(it);
+		}else{
+			++it;
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofRenderList::drawOccluded(const Item & item, const glm::vec3 & eye){
+#ifndef TARGET_OPENGLES
+	auto & occlusion = occlusions[item.node];
+	if(!occlusion.query){
+		occlusion.query.reset(new ofOcclusionQuery);
+	}
+	occlusion.lastDraw = drawCount;
+	auto & query = *occlusion.query;
+
+	// the bounds of a node around the camera could be clipped by the near
+	// plane, those are always drawn
+	glm::vec3 margin = item.bounds.getSize() * 0.05f;
+	bool eyeInside = ofBoundingBox(item.bounds.min - margin, item.bounds.max + margin).inside(eye);
+
+	if(eyeInside || query.isVisible()){
+		query.begin();
+		item.node->draw();
+		query.end();
+		return;
+	}
+
+	GLboolean depthMask;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+	ofPushStyle();
+	ofFill();
+	query.begin();
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthMask(GL_FALSE);
+	auto size = item.bounds.getSize();
+	ofDrawBox(item.bounds.getCenter(), size.x, size.y, size.z);
+	query.end();
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthMask(depthMask);
+	ofPopStyle();
+	numOccluded++;
+
+	if(occlusionMode == OCCLUSION_CONDITIONAL){
+		query.beginConditionalRender();
+		item.node->draw();
+		query.endConditionalRender();
+	}
+#else
+	item.node->draw();
+#endif
+}
+
+//----------------------------------------------------------
+size_t ofRenderList::size() const{
+	return items.size();
+}
+
+//----------------------------------------------------------
+size_t ofRenderList::getNumDrawn() const{
+	return numDrawn;
+}
+
+//----------------------------------------------------------
+size_t ofRenderList::getNumCulled() const{
+	return numCulled;
+}
+
+//----------------------------------------------------------
+void ofRenderList::setOcclusionMode(OcclusionMode mode){
+	occlusionMode = mode;
+}
+
+//----------------------------------------------------------
+ofRenderList::OcclusionMode ofRenderList::getOcclusionMode() const{
+	return occlusionMode;
+}
+
+//----------------------------------------------------------
+size_t ofRenderList::getNumOccluded() const{
+	return numOccluded;
+}
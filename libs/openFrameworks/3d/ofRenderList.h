@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ofBounds.h"
+#include <unordered_map>
+#include <memory>
+
+class ofNode;
+class of3dPrimitive;
+class ofCamera;
+class ofOcclusionQuery;
+
+/// \brief Draws a set of nodes skipping the ones outside of the camera's
+/// view and sorted by their distance to it
+///
+/// Opaque nodes are drawn first, from front to back so the depth test can
+/// discard what's behind them, and transparent ones afterwards, from back
+/// to front so they blend over what's behind:
+///
+/// ~~~~{.cpp}
+/// void ofApp::draw(){
+///     cam.begin();
+///     ofEnableDepthTest();
+///     renderList.clear();
+///     for(auto & box: boxes){
+///         renderList.add(box);
+///     }
+///     renderList.add(glass, true);
+///     renderList.draw(cam);
+///     cam.end();
+/// }
+/// ~~~~
+///
+/// The nodes are stored by reference, they have to be alive until draw().
+/// Setting the depth test and blending is left to the app.
+///
+/// setOcclusionMode() also skips the opaque nodes hidden behind the ones
+/// drawn before them. Every node is drawn inside an ofOcclusionQuery and,
+/// if last frame's query found it hidden, only its bounds are tested
+/// without writing color or depth, so it reappears a frame after it comes
+/// into view. The results are collected without waiting for the GPU.
+class ofRenderList{
+public:
+	enum OcclusionMode{
+		OCCLUSION_OFF,
+		/// hidden nodes are skipped until their bounds are visible again
+		OCCLUSION_SKIP,
+		/// hidden nodes are drawn with conditional rendering after testing
+		/// their bounds, so the GPU skips them if the bounds are still hidden
+		/// without popping when they come into view
+		OCCLUSION_CONDITIONAL,
+	};
+
+	ofRenderList();
+	~ofRenderList();
+
+	/// \brief Adds a primitive, using the bounds of its mesh
+	void add(const of3dPrimitive & primitive, bool transparent = false);
+
+	/// \brief Adds any other node with its bounds in world coordinates
+	void add(const ofNode & node, const ofBoundingBox & globalBounds, bool transparent = false);
+
+	/// \brief Removes all the nodes
+	void clear();
+
+	/// \brief Draws the nodes seen by camera, which has to be the current
+	/// one, with the current viewport
+	void draw(const ofCamera & camera);
+
+	/// \brief Draws the nodes that intersect frustum, sorted by their depth
+	/// in the coordinates of viewMatrix
+	void draw(const ofFrustum & frustum, const glm::mat4 & viewMatrix);
+
+	std::size_t size() const;
+
+	/// \brief Number of nodes drawn by the last draw()
+	std::size_t getNumDrawn() const;
+
+	/// \brief Number of nodes skipped by the last draw() because they were
+	/// out of the view
+	std::size_t getNumCulled() const;
+
+	/// \brief Enables occlusion culling of the opaque nodes, OCCLUSION_OFF by
+	/// default
+	///
+	/// Needs occlusion queries, see ofOcclusionQuery::isSupported(), it's
+	/// ignored otherwise. Nodes are tracked by address, so they should be
+	/// added every frame to keep their queries.
+	void setOcclusionMode(OcclusionMode mode);
+	OcclusionMode getOcclusionMode() const;
+
+	/// \brief Number of nodes only tested with their bounds in the last
+	/// draw() because they were hidden the frame before
+	std::size_t getNumOccluded() const;
+
+private:
+	struct Item{
+		const ofNode * node;
+		ofBoundingBox bounds;
+		bool transparent;
+		float depth;
+	};
+	struct Occlusion{
+		std::unique_ptr<ofOcclusionQuery> query;
+		uint64_t lastDraw = 0;
+	};
+
+	void drawOccluded(const Item & item, const glm::vec3 & eye);
+
+	std::vector<Item> items;
+	std::vector<Item*> visible;
+	std::size_t numDrawn = 0;
+	std::size_t numCulled = 0;
+
+	OcclusionMode occlusionMode = OCCLUSION_OFF;
+	std::unordered_map<const ofNode*, Occlusion> occlusions;
+	uint64_t drawCount = 0;
+	std::size_t numOccluded = 0;
+};
@@ -0,0 +1,331 @@
+#include "ofStaticBatch.h"
+#include "of3dPrimitives.h"
+#include "ofMaterial.h"
+#include "ofTaskPool.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace std;
+
+namespace{
+	// the indices of the triangles of mesh, strips and fans unrolled
+	bool getTriangles(const ofMesh & mesh, vector<ofIndexType> & triangles){
+		vector<ofIndexType> indices;
+		if(mesh.hasIndices()){
+			indices = mesh.getIndices();
+		}else{
+			indices.resize(mesh.getNumVertices());
+			std::iota(indices.begin(), indices.end(), 0);
+		}
+		switch(mesh.getMode()){
+		case OF_PRIMITIVE_TRIANGLES:
+			indices.resize(indices.size() / 3 * 3);
+			triangles = std::move(indices);
+			return true;
+		case OF_PRIMITIVE_TRIANGLE_STRIP:
+			triangles.clear();
+			for(size_t i = 2; i < indices.size(); i++){
+				ofIndexType a = indices[i - 2], b = indices[i - 1], c = indices[i];
+				if(a == b || b == c || a == c){
+					continue;
+				}
+				// every other triangle of a strip is wound the other way
+				if(i % 2){
+					std::swap(a, b);
+				}
+				triangles.insert(triangles.end(), {a, b, c});
+			}
+			return true;
+		case OF_PRIMITIVE_TRIANGLE_FAN:
+			triangles.clear();
+			for(size_t i = 2; i < indices.size(); i++){
+				triangles.insert(triangles.end(), {indices[0], indices[i - 1], indices[i]});
+			}
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
+//----------------------------------------------------------
+size_t ofStaticBatch::add(const ofMesh & mesh, const glm::mat4 & transform, const ofMaterial * material){
+	Object object;
+	if(!getTriangles(mesh, object.triangles)){
+		ofLogError("ofStaticBatch") << "add(): only triangles, triangle strips and triangle fans can be batched";
+	}
+	object.mesh = mesh;
+	object.mesh.clearIndices();
+	object.transform = transform;
+	object.material = material;
+	object.group = 0;
+	object.firstVertex = 0;
+	object.firstIndex = 0;
+	object.visible = true;
+	objects.push_back(std::move(object));
+	return objects.size() - 1;
+}
+
+//----------------------------------------------------------
+size_t ofStaticBatch::add(const of3dPrimitive & primitive, const ofMaterial * material){
+	return add(primitive.getMesh(), primitive.getGlobalTransformMatrix(), material);
+}
+
+//----------------------------------------------------------
+void ofStaticBatch::build(){
+	groups.clear();
+
+	// objects go to the last group of their material until its vertices
+	// can't be indexed anymore
+	const size_t maxVertices = size_t(std::numeric_limits<ofIndexType>::max()) + 1;
+	vector<size_t> numVertices, numIndices;
+	for(size_t i = 0; i < objects.size(); i++){
+		auto & object = objects[i];
+		size_t objectVertices = object.mesh.getNumVertices();
+		if(objectVertices > maxVertices){
+			ofLogError("ofStaticBatch") << "build(): object " << i << " has too many vertices for " << sizeof(ofIndexType) * 8 << " bit indices, skipping it";
+			object.triangles.clear();
+			objectVertices = 0;
+		}
+		size_t group = groups.size();
+		for(size_t g = groups.size(); g > 0; g--){
+			if(groups[g - 1].material == object.material){
+				if(numVertices[g - 1] + objectVertices <= maxVertices){
+					group = g - 1;
+				}
+				break;
+			}
+		}
+		if(group == groups.size()){
+			groups.emplace_back();
+			groups.back().material = object.material;
+			groups.back().hasNormals = false;
+			groups.back().hasColors = false;
+			groups.back().hasTexCoords = false;
+			numVertices.push_back(0);
+			numIndices.push_back(0);
+		}
+		auto & g = groups[group];
+		object.group = group;
+		object.firstVertex = numVertices[group];
+		object.firstIndex = numIndices[group];
+		numVertices[group] += objectVertices;
+		numIndices[group] += object.triangles.size();
+		g.objects.push_back(i);
+		g.hasNormals |= object.mesh.hasNormals();
+		g.hasColors |= object.mesh.hasColors();
+		g.hasTexCoords |= object.mesh.hasTexCoords();
+	}
+
+	for(size_t i = 0; i < groups.size(); i++){
+		auto & group = groups[i];
+		group.mesh.clear();
+		group.mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+		group.mesh.getVertices().resize(numVertices[i]);
+		if(group.hasNormals) group.mesh.getNormals().resize(numVertices[i]);
+		if(group.hasColors) group.mesh.getColors().resize(numVertices[i]);
+		if(group.hasTexCoords) group.mesh.getTexCoords().resize(numVertices[i]);
+		group.indices.resize(numIndices[i]);
+		group.objectIds.resize(numVertices[i]);
+	}
+
+	// every object writes its own ranges so they can be baked in parallel
+	ofGetTaskPool().parallelFor(0, objects.size(), [this](size_t begin, size_t end){
+		for(size_t i = begin; i < end; i++){
+			auto & object = objects[i];
+			auto & group = groups[object.group];
+			auto & mesh = object.mesh;
+			size_t count = mesh.getNumVertices();
+			if(object.triangles.empty()){
+				count = 0;
+			}
+			bake(object, group, group.mesh.getVerticesPointer() + object.firstVertex,
+				group.hasNormals ? group.mesh.getNormalsPointer() + object.firstVertex : nullptr);
+			for(size_t v = 0; v < count; v++){
+				size_t dst = object.firstVertex + v;
+				if(group.hasColors){
+					group.mesh.getColorsPointer()[dst] = mesh.hasColors() ? mesh.getColor(v) : ofFloatColor::white;
+				}
+				if(group.hasTexCoords){
+					group.mesh.getTexCoordsPointer()[dst] = mesh.hasTexCoords() ? mesh.getTexCoord(v) : ofDefaultTexCoordType();
+				}
+				group.objectIds[dst] = float(i);
+			}
+			for(size_t t = 0; t < object.triangles.size(); t++){
+				group.indices[object.firstIndex + t] = ofIndexType(object.firstVertex + object.triangles[t]);
+			}
+		}
+	}, 64);
+
+	for(auto & group: groups){
+		group.mesh.getIndices() = group.indices;
+		// hidden objects are collapsed in the mesh, the indices keep them
+		for(auto o: group.objects){
+			auto & object = objects[o];
+			if(!object.visible){
+				auto first = group.mesh.getIndices().begin() + object.firstIndex;
+				std::fill(first, first + object.triangles.size(), ofIndexType(object.firstVertex));
+			}
+		}
+		uploadObjectIds(group);
+	}
+}
+
+//----------------------------------------------------------
+void ofStaticBatch::bake(const Object & object, Group & group, ofDefaultVertexType * vertices, ofDefaultNormalType * normals) const{
+	auto & mesh = object.mesh;
+	size_t count = object.triangles.empty() ? 0 : mesh.getNumVertices();
+	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(object.transform)));
+	ofBoundingBox bounds;
+	for(size_t v = 0; v < count; v++){
+		glm::vec3 position(object.transform * glm::vec4(glm::vec3(mesh.getVertex(v)), 1.f));
+		vertices[v] = position;
+		bounds.add(position);
+		if(normals){
+			glm::vec3 normal = mesh.hasNormals() ? glm::vec3(mesh.getNormal(v)) : glm::vec3(0.f, 0.f, 1.f);
+			normal = normalMatrix * normal;
+			float length = glm::length(normal);
+			normals[v] = length > 0 ? normal / length : normal;
+		}
+	}
+	// only this object writes its bounds, even when baking in parallel
+	const_cast<Object&>(object).bounds = bounds;
+}
+
+//----------------------------------------------------------
+void ofStaticBatch::uploadObjectIds(Group & group){
+	if(group.objectIds.empty()){
+		return;
+	}
+	// getVbo() uploads the mesh first so the attribute has its vertices
+	auto & vbo = group.mesh.getVbo();
+	vbo.setAttributeData(OBJECT_ID_ATTRIBUTE, group.objectIds.data(), 1, int(group.objectIds.size()), GL_STATIC_DRAW);
+}
+
+//----------------------------------------------------------
+void ofStaticBatch::clear(){
+	objects.clear();
+	groups.clear();
+}
+
+//----------------------------------------------------------
+size_t ofStaticBatch::getNumObjects() const{
+	return objects.size();
+}
+
+//----------------------------------------------------------
+size_t ofStaticBatch::getNumGroups() const{
+	return groups.size();
+}
+
+//----------------------------------------------------------
+void ofStaticBatch::setVisible(size_t o, bool visible){
+	auto & object = objects.at(o);
+	if(object.visible == visible){
+		return;
+	}
+	object.visible = visible;
+	if(object.group >= groups.size()){
+		return;
+	}
+	auto & group = groups[object.group];
+	if(group.mesh.getNumIndices() < object.firstIndex + object.triangles.size()){
+		// added after the last build()
+		return;
+	}
+	// all the triangles of a hidden object collapse to its first vertex
+	for(size_t t = 0; t < object.triangles.size(); t++){
+		size_t index = object.firstIndex + t;
+		group.mesh.setIndex(ofIndexType(index), visible ? group.indices[index] : ofIndexType(object.firstVertex));
+	}
+}
+
+//----------------------------------------------------------
+bool ofStaticBatch::isVisible(size_t object) const{
+	return objects.at(object).visible;
+}
+
+//----------------------------------------------------------
+void ofStaticBatch::setTransform(size_t o, const glm::mat4 & transform){
+	auto & object = objects.at(o);
+	object.transform = transform;
+	if(object.group >= groups.size() || object.triangles.empty()){
+		return;
+	}
+	auto & group = groups[object.group];
+	size_t count = object.mesh.getNumVertices();
+	if(group.mesh.getNumVertices() < object.firstVertex + count){
+		return;
+	}
+	// set one by one so the mesh only uploads this object's range
+	vector<ofDefaultVertexType> vertices(count);
+	vector<ofDefaultNormalType> normals(group.hasNormals ? count : 0);
+	bake(object, group, vertices.data(), group.hasNormals ? normals.data() : nullptr);
+	for(size_t v = 0; v < count; v++){
+		group.mesh.setVertex(ofIndexType(object.firstVertex + v), vertices[v]);
+		if(group.hasNormals){
+			group.mesh.setNormal(ofIndexType(object.firstVertex + v), normals[v]);
+		}
+	}
+}
+
+//----------------------------------------------------------
+const glm::mat4 & ofStaticBatch::getTransform(size_t object) const{
+	return objects.at(object).transform;
+}
+
+//----------------------------------------------------------
+const ofBoundingBox & ofStaticBatch::getBoundingBox(size_t object) const{
+	return objects.at(object).bounds;
+}
+
+//----------------------------------------------------------
+size_t ofStaticBatch::getGroup(size_t object) const{
+	return objects.at(object).group;
+}
+
+//----------------------------------------------------------
+size_t ofStaticBatch::getObject(size_t g, size_t triangle) const{
+	auto & group = groups.at(g);
+	size_t index = triangle * 3;
+	// the last object whose range starts before index
+	auto it = std::upper_bound(group.objects.begin(), group.objects.end(), index, [this](size_t index, size_t object){
+		return index < objects[object].firstIndex;
+	});
+	if(it == group.objects.begin()){
+		return group.objects.empty() ? 0 : group.objects.front();
+	}
+	return *std::prev(it);
+}
+
+//----------------------------------------------------------
+ofVboMesh & ofStaticBatch::getMesh(size_t group){
+	return groups.at(group).mesh;
+}
+
+//----------------------------------------------------------
+const ofVboMesh & ofStaticBatch::getMesh(size_t group) const{
+	return groups.at(group).mesh;
+}
+
+//----------------------------------------------------------
+const ofMaterial * ofStaticBatch::getMaterial(size_t group) const{
+	return groups.at(group).material;
+}
+
+//----------------------------------------------------------
+void ofStaticBatch::draw() const{
+	for(auto & group: groups){
+		if(group.mesh.getNumIndices() == 0){
+			continue;
+		}
+		if(group.material){
+			group.material->begin();
+		}
+		group.mesh.draw();
+		if(group.material){
+			group.material->end();
+		}
+	}
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "ofVboMesh.h"
+#include "ofBounds.h"
+
+class of3dPrimitive;
+class ofMaterial;
+
+/// \brief Merges many static meshes into a few ofVboMesh, one per material,
+/// so all of them are drawn with a couple of draw calls
+///
+/// Each mesh is added with its transform, which is baked into its vertices
+/// and normals when the batch is built:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofBoxPrimitive box(10, 10, 10);
+///     for(int i = 0; i < 5000; i++){
+///         box.setPosition(ofRandom(-1000, 1000), 0, ofRandom(-1000, 1000));
+///         batch.add(box, i % 2 ? &stone : &wood);
+///     }
+///     batch.build();
+/// }
+///
+/// void ofApp::draw(){
+///     cam.begin();
+///     batch.draw();
+///     cam.end();
+/// }
+/// ~~~~
+///
+/// Every object keeps its range of vertices and indices in its group, so
+/// it can be hidden or moved later and only that range is uploaded again.
+/// The vertices also carry the id of their object, returned by add(), as a
+/// float attribute at OBJECT_ID_ATTRIBUTE for shaders that draw ids to pick
+/// objects, and getObject() finds the object a triangle belongs to.
+///
+/// The materials are stored by address and have to be alive until the
+/// batch is drawn.
+class ofStaticBatch{
+public:
+	/// location of the float attribute with the id of the object of each
+	/// vertex, after the ones used by ofInstancedMesh
+	static const int OBJECT_ID_ATTRIBUTE = 10;
+
+	/// \brief Adds a copy of mesh, transformed by transform, drawn with
+	/// material or the current style if it's null
+	///
+	/// Triangle strips and fans are converted to triangles, other modes
+	/// can't be batched. Objects added after build() appear once it's
+	/// called again.
+	/// \returns the id of the object, consecutive from 0
+	std::size_t add(const ofMesh & mesh, const glm::mat4 & transform = glm::mat4(1.f), const ofMaterial * material = nullptr);
+
+	/// \brief Adds the mesh of primitive with its global transform
+	std::size_t add(const of3dPrimitive & primitive, const ofMaterial * material = nullptr);
+
+	/// \brief Bakes all the objects into their groups, in parallel on the
+	/// task pool, and uploads them
+	void build();
+
+	/// \brief Removes all the objects and groups
+	void clear();
+
+	std::size_t getNumObjects() const;
+
+	/// \brief Number of meshes the objects were merged into, one per
+	/// material or more if their vertices don't fit in one mesh's indices
+	std::size_t getNumGroups() const;
+
+	/// \brief Hides or shows an object by collapsing its triangles, only
+	/// the indices of the object are uploaded again
+	void setVisible(std::size_t object, bool visible);
+	bool isVisible(std::size_t object) const;
+
+	/// \brief Moves an object baking its new transform, only the vertices
+	/// of the object are uploaded again
+	void setTransform(std::size_t object, const glm::mat4 & transform);
+	const glm::mat4 & getTransform(std::size_t object) const;
+
+	/// \brief Bounds of an object, with its transform, after build()
+	const ofBoundingBox & getBoundingBox(std::size_t object) const;
+
+	/// \brief Group the object was merged into
+	std::size_t getGroup(std::size_t object) const;
+
+	/// \brief The object of a triangle of a group's mesh, the triangle
+	/// being the position of its first index divided by 3
+	std::size_t getObject(std::size_t group, std::size_t triangle) const;
+
+	ofVboMesh & getMesh(std::size_t group);
+	const ofVboMesh & getMesh(std::size_t group) const;
+	const ofMaterial * getMaterial(std::size_t group) const;
+
+	/// \brief Draws every group with its material
+	void draw() const;
+
+private:
+	struct Object{
+		ofMesh mesh;
+		std::vector<ofIndexType> triangles;
+		glm::mat4 transform;
+		const ofMaterial * material;
+		std::size_t group;
+		std::size_t firstVertex;
+		std::size_t firstIndex;
+		ofBoundingBox bounds;
+		bool visible;
+	};
+
+	struct Group{
+		const ofMaterial * material;
+		ofVboMesh mesh;
+		// the indices of the objects, restored when they are shown again
+		std::vector<ofIndexType> indices;
+		std::vector<float> objectIds;
+		// objects in the order of their ranges
+		std::vector<std::size_t> objects;
+		bool hasNormals;
+		bool hasColors;
+		bool hasTexCoords;
+	};
+
+	void bake(const Object & object, Group & group, ofDefaultVertexType * vertices, ofDefaultNormalType * normals) const;
+	void uploadObjectIds(Group & group);
+
+	std::vector<Object> objects;
+	std::vector<Group> groups;
+};
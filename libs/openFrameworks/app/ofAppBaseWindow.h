@@ -16,6 +16,18 @@ struct _XDisplay;
 typedef struct _XDisplay Display;
 #endif
 
+/// \brief A GL context created by a window that shares its textures and
+/// buffers, to use them from another thread, see ofGLUploadWorker
+class ofBaseGLContext{
+public:
+	virtual ~ofBaseGLContext(){}
+
+	/// \brief Makes the context current in the calling thread, it can only
+	/// be current in one thread at a time
+	virtual void makeCurrent()=0;
+	virtual void releaseCurrent()=0;
+};
+
 class ofAppBaseWindow{
 
 public:
@@ -69,7 +81,18 @@ public:
     virtual std::string  getClipboardString() { return ""; }
 
     virtual void makeCurrent(){};
+	/// \brief Leaves no context current in the calling thread, so the
+	/// window's context can be made current in another one
+	virtual void releaseCurrent(){};
+	/// \brief Creates a hidden context that shares objects with the
+	/// window's one, from the main thread
+	///
+	/// \returns nullptr if the window doesn't support it
+	virtual std::shared_ptr<ofBaseGLContext> createSharedContext(){ return nullptr; }
 	virtual void swapBuffers() {}
+	/// \brief Don't swap at the end of draw(), ofMainLoop swaps once every
+	/// window is drawn, see ofMainLoop::setSwapMode()
+	virtual void setDeferSwap(bool defer){}
 	virtual void startRender() {}
 	virtual void finishRender() {}
 
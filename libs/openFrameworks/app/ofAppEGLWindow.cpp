@@ -7,9 +7,127 @@
 #include "ofGLProgrammableRenderer.h"
 #include "ofGLRenderer.h"
 #include <assert.h>
+#include <EGL/eglext.h>
+#include <poll.h>
+#include <time.h>
+
+#ifdef OF_USE_KMS
+#include <drm_fourcc.h>
+#include <errno.h>
+#endif
 
 using namespace std;
 
+#ifdef OF_USE_KMS
+namespace{
+	struct KmsFramebuffer{
+		int fd;
+		uint32_t id;
+	};
+
+	void destroyKmsFramebuffer(gbm_bo * bo, void * data){
+		KmsFramebuffer * framebuffer = static_cast<KmsFramebuffer*>(data);
+		drmModeRmFB(framebuffer->fd, framebuffer->id);
+		delete framebuffer;
+	}
+
+	// gbm surfaces cycle through the same few buffers, their framebuffer
+	// is created the first time they are presented and kept with them
+	uint32_t getKmsFramebuffer(int fd, gbm_bo * bo){
+		KmsFramebuffer * framebuffer = static_cast<KmsFramebuffer*>(gbm_bo_get_user_data(bo));
+		if(framebuffer){
+			return framebuffer->id;
+		}
+
+		uint32_t width = gbm_bo_get_width(bo);
+		uint32_t height = gbm_bo_get_height(bo);
+		uint32_t format = gbm_bo_get_format(bo);
+		uint32_t handles[4] = {0, 0, 0, 0};
+		uint32_t strides[4] = {0, 0, 0, 0};
+		uint32_t offsets[4] = {0, 0, 0, 0};
+		uint64_t modifiers[4] = {0, 0, 0, 0};
+		uint64_t modifier = gbm_bo_get_modifier(bo);
+		for(int i = 0; i < gbm_bo_get_plane_count(bo) && i < 4; i++){
+			handles[i] = gbm_bo_get_handle_for_plane(bo, i).u32;
+			strides[i] = gbm_bo_get_stride_for_plane(bo, i);
+			offsets[i] = gbm_bo_get_offset(bo, i);
+			modifiers[i] = modifier;
+		}
+
+		uint32_t id = 0;
+		int ret = -1;
+		if(modifier != DRM_FORMAT_MOD_INVALID){
+			ret = drmModeAddFB2WithModifiers(fd, width, height, format, handles, strides, offsets, modifiers, &id, DRM_MODE_FB_MODIFIERS);
+		}
+		if(ret != 0){
+			// drivers without modifiers support
+			handles[0] = gbm_bo_get_handle(bo).u32;
+			strides[0] = gbm_bo_get_stride(bo);
+			offsets[0] = 0;
+			ret = drmModeAddFB2(fd, width, height, format, handles, strides, offsets, &id, 0);
+		}
+		if(ret != 0){
+			ofLogError("ofAppEGLWindow") << "couldn't create framebuffer: " << strerror(errno);
+			return 0;
+		}
+
+		gbm_bo_set_user_data(bo, new KmsFramebuffer{fd, id}, destroyKmsFramebuffer);
+		return id;
+	}
+
+	// looking properties up is an ioctl per object, they are cached on
+	// setup so frames are committed without querying the driver
+	std::map<std::string, uint32_t> getKmsProperties(int fd, uint32_t object, uint32_t type){
+		std::map<std::string, uint32_t> ids;
+		drmModeObjectProperties * properties = drmModeObjectGetProperties(fd, object, type);
+		if(!properties){
+			return ids;
+		}
+		for(uint32_t i = 0; i < properties->count_props; i++){
+			drmModePropertyRes * property = drmModeGetProperty(fd, properties->props[i]);
+			if(property){
+				ids[property->name] = property->prop_id;
+				drmModeFreeProperty(property);
+			}
+		}
+		drmModeFreeObjectProperties(properties);
+		return ids;
+	}
+
+	uint64_t getKmsPropertyValue(int fd, uint32_t object, uint32_t type, const std::string & name){
+		uint64_t value = -1;
+		drmModeObjectProperties * properties = drmModeObjectGetProperties(fd, object, type);
+		if(!properties){
+			return value;
+		}
+		for(uint32_t i = 0; i < properties->count_props; i++){
+			drmModePropertyRes * property = drmModeGetProperty(fd, properties->props[i]);
+			if(property && name == property->name){
+				value = properties->prop_values[i];
+			}
+			drmModeFreeProperty(property);
+		}
+		drmModeFreeObjectProperties(properties);
+		return value;
+	}
+
+	void addKmsProperty(drmModeAtomicReq * request, uint32_t object, const std::map<std::string, uint32_t> & ids, const std::string & name, uint64_t value){
+		auto id = ids.find(name);
+		if(id == ids.end()){
+			ofLogWarning("ofAppEGLWindow") << "object " << object << " has no property " << name;
+			return;
+		}
+		drmModeAtomicAddProperty(request, object, id->second, value);
+	}
+
+	uint64_t getKmsMonotonicMicros(){
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+	}
+}
+#endif
+
 // native events
 struct udev* udev;
 struct udev_device* dev;
@@ -18,6 +136,7 @@ static int udev_fd = -1;
 
 static int keyboard_fd = -1; // defaults to 0 ie console
 static int mouse_fd	= -1; // defaults to 0
+static int touch_fd = -1;
 
 // minimal map
 const int lowercase_map[] = {
@@ -65,6 +184,47 @@ typedef struct {
 #define MOUSE_BUTTON_RIGHT_MASK  2 << 1
 
 static MouseState mb;
+
+// multitouch protocol B, the kernel tracks each contact in a slot and
+// only sends what changed in it
+typedef struct {
+	int trackingId;
+	float x, y;
+	float pressure;
+	float majoraxis, minoraxis;
+	bool began;
+	bool ended;
+	bool changed;
+} TouchSlot;
+
+typedef struct {
+	std::vector<TouchSlot> slots;
+	int currentSlot;
+	bool dropping;  // the kernel's buffer overflowed, skip until the next report
+	struct input_absinfo absX;
+	struct input_absinfo absY;
+	struct input_absinfo absPressure;
+} TouchState;
+
+static TouchState ts;
+
+// devices report CLOCK_MONOTONIC times once set, converted to the
+// app's elapsed time so they can be compared with the frame times
+static void setMonotonicInputClock(int fd) {
+	int clock = CLOCK_MONOTONIC;
+	ioctl(fd, EVIOCSCLOCKID, &clock);
+}
+
+static uint64_t inputEventElapsedMicros(const struct input_event & ev) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	int64_t age = (int64_t(now.tv_sec) - ev.time.tv_sec) * 1000000 + (now.tv_nsec / 1000 - ev.time.tv_usec);
+	uint64_t elapsed = ofGetElapsedTimeMicros();
+	if(age > 0 && uint64_t(age) < elapsed) {
+		return elapsed - age;
+	}
+	return elapsed;
+}
 ofAppEGLWindow* ofAppEGLWindow::instance = NULL;
 
 static int string_ends_with(const char *str, const char *suffix) {
@@ -227,6 +387,8 @@ ofAppEGLWindow::Settings::Settings()
 
 	screenNum = 0; /* 0 = LCD on the raspberry pi */
 	layer = 0;
+	eglDevice = -1;
+	kmsAtomic = true;
 }
 
 ofAppEGLWindow::Settings::Settings(const ofGLESWindowSettings & settings)
@@ -248,10 +410,13 @@ ofAppEGLWindow::Settings::Settings(const ofGLESWindowSettings & settings)
 
 	screenNum = 0; /* 0 = LCD on the raspberry pi */
 	layer = 0;
+	eglDevice = -1;
+	kmsAtomic = true;
 }
 
 //------------------------------------------------------------
-ofAppEGLWindow::ofAppEGLWindow() {
+ofAppEGLWindow::ofAppEGLWindow()
+:inputEvents(4096) {
 	keyboardDetected = false;
 	mouseDetected = false;
 	threadTimeout = ofThread::INFINITE_JOIN_TIMEOUT;
@@ -263,12 +428,23 @@ ofAppEGLWindow::ofAppEGLWindow() {
 	mouseScaleX = 2.0f;
 	mouseScaleY = 2.0f;
 	isUsingX11 = false;
+	isHeadless = false;
+	isUsingKms = false;
 	isWindowInited = false;
 	isSurfaceInited = false;
 	x11Display = NULL;
 	x11Screen = NULL;
 	x11ScreenNum = 0l;
 	glesVersion = 1;
+	bKeepInputHistory = false;
+	coreEvents.setCoalesceMotionEvents(true);
+#ifdef OF_USE_KMS
+	kmsFd = -1;
+	kmsSavedCrtc = NULL;
+	kmsGbmDevice = NULL;
+	kmsGbmSurface = NULL;
+	kmsFrontBo = NULL;
+#endif
 
 	if(instance!=NULL){
 		ofLogError("ofAppEGLWindow") << "trying to create more than one instance";
@@ -322,8 +498,26 @@ EGLint ofAppEGLWindow::getEglVersionMinor() const {
 	return eglVersionMinor;
 }
 
+//------------------------------------------------------------
+int ofAppEGLWindow::getNumEglDevices() {
+#ifdef EGL_EXT_device_enumeration
+	auto queryDevices = (PFNEGLQUERYDEVICESEXTPROC)eglGetProcAddress("eglQueryDevicesEXT");
+	EGLint numDevices = 0;
+	if(queryDevices && queryDevices(0, NULL, &numDevices)) {
+		return numDevices;
+	}
+#endif
+	return 0;
+}
+
 //------------------------------------------------------------
 void ofAppEGLWindow::initNative() {
+#ifdef OF_USE_KMS
+	if(isUsingKms) {
+		initKmsNative();
+		return;
+	}
+#endif
 #ifdef TARGET_RASPBERRY_PI
 	initRPiNative();
 #endif
@@ -331,6 +525,12 @@ void ofAppEGLWindow::initNative() {
 
 //------------------------------------------------------------
 void ofAppEGLWindow::exitNative() {
+#ifdef OF_USE_KMS
+	if(isUsingKms) {
+		exitKmsNative();
+		return;
+	}
+#endif
 #ifdef TARGET_RASPBERRY_PI
 	exitRPiNative();
 #endif
@@ -338,6 +538,10 @@ void ofAppEGLWindow::exitNative() {
 
 //------------------------------------------------------------
 EGLNativeWindowType ofAppEGLWindow::getNativeWindow()  {
+	if(isHeadless) {
+		return (EGLNativeWindowType)NULL;
+	}
+
 	if(!isWindowInited) {
 		ofLogWarning("ofAppEGLWindow") << "getNativeDisplay(): window not initialized, returning NULL";
 		return NULL;
@@ -345,6 +549,10 @@ EGLNativeWindowType ofAppEGLWindow::getNativeWindow()  {
 
 	if(isUsingX11) {
 		return (EGLNativeWindowType)x11Window;
+#ifdef OF_USE_KMS
+	} else if(isUsingKms) {
+		return (EGLNativeWindowType)kmsGbmSurface;
+#endif
 	} else {
 #ifdef TARGET_RASPBERRY_PI
 		return (EGLNativeWindowType)&dispman_native_window;
@@ -357,6 +565,10 @@ EGLNativeWindowType ofAppEGLWindow::getNativeWindow()  {
 
 //------------------------------------------------------------
 EGLNativeDisplayType ofAppEGLWindow::getNativeDisplay() {
+	if(isHeadless) {
+		return 0;
+	}
+
 	if(!isWindowInited) {
 		ofLogWarning("ofAppEGLWindow") << "getNativeDisplay(): window not initialized, returning NULL";
 		return 0;
@@ -364,6 +576,10 @@ EGLNativeDisplayType ofAppEGLWindow::getNativeDisplay() {
 
 	if(isUsingX11) {
 		return (EGLNativeDisplayType)x11Display;
+#ifdef OF_USE_KMS
+	} else if(isUsingKms) {
+		return (EGLNativeDisplayType)kmsGbmDevice;
+#endif
 	} else {
 #ifdef TARGET_RASPBERRY_PI
 		return (EGLNativeDisplayType)NULL;
@@ -402,6 +618,8 @@ void ofAppEGLWindow::setup(const Settings & _settings) {
 	mouseScaleY = 2.0f;
 
 	isUsingX11 = false;
+	isHeadless = false;
+	isUsingKms = false;
 	isWindowInited  = false;
 	isSurfaceInited = false;
 
@@ -425,6 +643,9 @@ void ofAppEGLWindow::setup(const Settings & _settings) {
 			isUsingX11 = true;
 		} else {
 			isUsingX11 = false;
+#ifdef OF_USE_KMS
+			isUsingKms = true;
+#endif
 		}
 	} else if(settings.eglWindowPreference == OF_APP_WINDOW_NATIVE) {
 		isUsingX11 = false;
@@ -434,6 +655,14 @@ void ofAppEGLWindow::setup(const Settings & _settings) {
 			isUsingX11 = false;
 			ofLogError("ofAppEGLWindow") << "init(): X11 window requested, but X11 is not available";
 		}
+	} else if(settings.eglWindowPreference == OF_APP_WINDOW_HEADLESS) {
+		isHeadless = true;
+	} else if(settings.eglWindowPreference == OF_APP_WINDOW_KMS) {
+#ifdef OF_USE_KMS
+		isUsingKms = true;
+#else
+		ofLogError("ofAppEGLWindow") << "init(): KMS window requested, but openFrameworks was compiled without OF_USE_KMS, using a native window instead";
+#endif
 	}
 
 	////////////////
@@ -490,11 +719,19 @@ void ofAppEGLWindow::setup(const Settings & _settings) {
 	}else{
 		static_cast<ofGLRenderer*>(currentRenderer.get())->setup();
 	}
+
+	if(isHeadless) {
+		// nothing is presented so there's no reason to wait for a vblank,
+		// frames run as fast as the gpu goes unless a frame rate is set
+		setVerticalSync(false);
+	}
 }
 
 //------------------------------------------------------------
 void ofAppEGLWindow::setupPeripherals() {
-	if(!isUsingX11) {
+	if(isHeadless) {
+		ofLogNotice("ofAppEGLWindow") << "setupPeripherals(): headless window, skipping peripherals";
+	} else if(!isUsingX11) {
 		// roll our own cursor!
 		mouseCursor.allocate(mouse_cursor_data.width,mouse_cursor_data.height,OF_IMAGE_COLOR_ALPHA);
 		MOUSE_CURSOR_RUN_LENGTH_DECODE(mouseCursor.getPixels().getData(),mouse_cursor_data.rle_pixel_data,mouse_cursor_data.width*mouse_cursor_data.height,mouse_cursor_data.bpp);
@@ -521,7 +758,13 @@ bool ofAppEGLWindow::createSurface() {
 
 	EGLint result;
 
-	if(display==0){
+	if(isHeadless){
+		eglDisplay = getHeadlessDisplay();
+#ifdef OF_USE_KMS
+	}else if(isUsingKms){
+		eglDisplay = getKmsDisplay();
+#endif
+	}else if(display==0){
 		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
 	}else{
 		eglDisplay = eglGetDisplay(display);
@@ -579,7 +822,7 @@ bool ofAppEGLWindow::createSurface() {
 	int i;
 
 	// each attribute has 2 values, and we need one extra for the EGL_NONE terminator
-	EGLint attribute_list_framebuffer_config[settings.frameBufferAttributes.size() * 2 + 3];
+	EGLint attribute_list_framebuffer_config[settings.frameBufferAttributes.size() * 2 + 5];
 
 	iter = settings.frameBufferAttributes.begin();
 	iterEnd = settings.frameBufferAttributes.end();
@@ -590,6 +833,10 @@ bool ofAppEGLWindow::createSurface() {
 	}
 	attribute_list_framebuffer_config[i++] = EGL_RENDERABLE_TYPE;
 	attribute_list_framebuffer_config[i++] = glesVersion; //openGL ES version
+	if(isHeadless) {
+		attribute_list_framebuffer_config[i++] = EGL_SURFACE_TYPE;
+		attribute_list_framebuffer_config[i++] = EGL_PBUFFER_BIT;
+	}
 	attribute_list_framebuffer_config[i] = EGL_NONE; // add the terminator
 
 	EGLint num_configs;
@@ -616,6 +863,29 @@ bool ofAppEGLWindow::createSurface() {
 		return false;
 	}
 
+#ifdef OF_USE_KMS
+	if(isUsingKms) {
+		// the first config doesn't need to match the format of the gbm
+		// surface the display scans out, look for one that does
+		EGLint numMatching = 0;
+		eglChooseConfig(eglDisplay, attribute_list_framebuffer_config, NULL, 0, &numMatching);
+		std::vector<EGLConfig> configs(numMatching);
+		eglChooseConfig(eglDisplay, attribute_list_framebuffer_config, configs.data(), numMatching, &numMatching);
+		bool found = false;
+		for(auto config: configs) {
+			EGLint visual = 0;
+			if(eglGetConfigAttrib(eglDisplay, config, EGL_NATIVE_VISUAL_ID, &visual) && (uint32_t)visual == kmsFormat) {
+				eglConfig = config;
+				found = true;
+				break;
+			}
+		}
+		if(!found) {
+			ofLogWarning("ofAppEGLWindow") << "createSurface(): no config matches the gbm surface format, using the first one";
+		}
+	}
+#endif
+
 
 	// each attribute has 2 values, and we need one extra for the EGL_NONE terminator
 	EGLint attribute_list_window_surface[settings.windowSurfaceAttributes.size() * 2 + 1];
@@ -631,10 +901,14 @@ bool ofAppEGLWindow::createSurface() {
 	attribute_list_window_surface[i] = EGL_NONE; // add the terminator
 
 	// create a surface
-	eglSurface = eglCreateWindowSurface( eglDisplay, // our display handle
-			eglConfig,	// our first config
-			nativeWindow, // our native window
-			attribute_list_window_surface); // surface attribute list
+	if(isHeadless) {
+		eglSurface = createPbufferSurface(currentWindowRect.width, currentWindowRect.height);
+	} else {
+		eglSurface = eglCreateWindowSurface( eglDisplay, // our display handle
+				eglConfig,	// our first config
+				nativeWindow, // our native window
+				attribute_list_window_surface); // surface attribute list
+	}
 
 	if(eglSurface == EGL_NO_SURFACE) {
 		EGLint error = eglGetError();
@@ -734,6 +1008,47 @@ bool ofAppEGLWindow::createSurface() {
 	return true;
 }
 
+//------------------------------------------------------------
+EGLDisplay ofAppEGLWindow::getHeadlessDisplay() {
+	if(settings.eglDevice >= 0) {
+#if defined(EGL_EXT_device_enumeration) && defined(EGL_EXT_platform_device)
+		auto queryDevices = (PFNEGLQUERYDEVICESEXTPROC)eglGetProcAddress("eglQueryDevicesEXT");
+		auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		EGLint numDevices = getNumEglDevices();
+		if(queryDevices && getPlatformDisplay && settings.eglDevice < numDevices) {
+			std::vector<EGLDeviceEXT> devices(numDevices);
+			queryDevices(numDevices, devices.data(), &numDevices);
+			ofLogNotice("ofAppEGLWindow") << "getHeadlessDisplay(): using EGL device " << settings.eglDevice << " of " << numDevices;
+			return getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[settings.eglDevice], NULL);
+		}
+		ofLogWarning("ofAppEGLWindow") << "getHeadlessDisplay(): EGL device " << settings.eglDevice
+			<< " not available, found " << numDevices << ", using the default display";
+#else
+		ofLogWarning("ofAppEGLWindow") << "getHeadlessDisplay(): EGL device enumeration not supported, using the default display";
+#endif
+	}
+	return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+//------------------------------------------------------------
+EGLSurface ofAppEGLWindow::createPbufferSurface(int width, int height) {
+	// each attribute has 2 values, plus width, height and the EGL_NONE terminator
+	EGLint attribute_list_pbuffer_surface[settings.windowSurfaceAttributes.size() * 2 + 5];
+
+	int i = 0;
+	for(auto & attribute: settings.windowSurfaceAttributes) {
+		attribute_list_pbuffer_surface[i++] = attribute.first;
+		attribute_list_pbuffer_surface[i++] = attribute.second;
+	}
+	attribute_list_pbuffer_surface[i++] = EGL_WIDTH;
+	attribute_list_pbuffer_surface[i++] = std::max(width, 1);
+	attribute_list_pbuffer_surface[i++] = EGL_HEIGHT;
+	attribute_list_pbuffer_surface[i++] = std::max(height, 1);
+	attribute_list_pbuffer_surface[i] = EGL_NONE; // add the terminator
+
+	return eglCreatePbufferSurface(eglDisplay, eglConfig, attribute_list_pbuffer_surface);
+}
+
 //------------------------------------------------------------
 bool ofAppEGLWindow::destroySurface() {
 	if(isSurfaceInited) {
@@ -762,10 +1077,16 @@ bool ofAppEGLWindow::destroySurface() {
 //------------------------------------------------------------
 bool ofAppEGLWindow::destroyWindow() {
 	if(isWindowInited) {
-		if(isUsingX11) {
+		if(isHeadless) {
+			// the pbuffer goes away with the surface
+		} else if(isUsingX11) {
 			// TODO: double check
 			XDestroyWindow(x11Display,x11Window); // or XCloseWindow?
 			XFree(x11Screen);
+#ifdef OF_USE_KMS
+		} else if(isUsingKms) {
+			destroyKmsNativeWindow();
+#endif
 		} else {
 #ifdef TARGET_RASPBERRY_PI
 			dispman_update = vc_dispmanx_update_start(0);
@@ -794,7 +1115,7 @@ bool ofAppEGLWindow::destroyWindow() {
 
 
 void ofAppEGLWindow::close(){
-	if(!isUsingX11) {
+	if(!isUsingX11 && !isHeadless) {
 		destroyNativeEvents();
 	}
 
@@ -815,13 +1136,69 @@ void ofAppEGLWindow::makeCurrent(){
 			eglContext);
 }
 
+//------------------------------------------------------------
+namespace{
+	class EGLSharedContext: public ofBaseGLContext{
+	public:
+		EGLSharedContext(EGLDisplay display, EGLSurface surface, EGLContext context)
+		:display(display)
+		,surface(surface)
+		,context(context){}
+
+		~EGLSharedContext(){
+			if(surface != EGL_NO_SURFACE){
+				eglDestroySurface(display, surface);
+			}
+			eglDestroyContext(display, context);
+		}
+
+		void makeCurrent(){
+			eglMakeCurrent(display, surface, surface, context);
+		}
+
+		void releaseCurrent(){
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		}
+
+	private:
+		EGLDisplay display;
+		EGLSurface surface;
+		EGLContext context;
+	};
+}
+
+//------------------------------------------------------------
+shared_ptr<ofBaseGLContext> ofAppEGLWindow::createSharedContext(){
+	if(eglContext == EGL_NO_CONTEXT){
+		return nullptr;
+	}
+	EGLint attribute_list_shared_context[] = {
+			EGL_CONTEXT_CLIENT_VERSION, glesVersion == 2 ? 2 : 1,
+			EGL_NONE
+	};
+	EGLContext context = eglCreateContext(eglDisplay, eglConfig, eglContext, attribute_list_shared_context);
+	if(context == EGL_NO_CONTEXT){
+		ofLogError("ofAppEGLWindow") << "createSharedContext(): error creating context: " << eglErrorString(eglGetError());
+		return nullptr;
+	}
+	// drivers with EGL_KHR_surfaceless_context work without a surface
+	EGLSurface surface = createPbufferSurface(1, 1);
+	return make_shared<EGLSharedContext>(eglDisplay, surface, context);
+}
+
 //------------------------------------------------------------
 void ofAppEGLWindow::swapBuffers(){
+	if(isHeadless) return;
 	EGLBoolean success = eglSwapBuffers(eglDisplay, eglSurface);
 	if(!success) {
 		GLint error = eglGetError();
 		ofLogNotice("ofAppEGLWindow") << "display(): eglSwapBuffers failed: " << eglErrorString(error);
 	}
+#ifdef OF_USE_KMS
+	if(isUsingKms && success) {
+		presentKmsFrame();
+	}
+#endif
 }
 
 //--------------------------------------------
@@ -857,7 +1234,7 @@ void ofAppEGLWindow::draw() {
 
 	coreEvents.notifyDraw();
 
-	if(!isUsingX11) {
+	if(!isUsingX11 && !isHeadless) {
 		if(bShowCursor){
 			GLboolean bIsDepthTestEnabled = GL_FALSE;
 			glGetBooleanv(GL_DEPTH_TEST, &bIsDepthTestEnabled);
@@ -889,10 +1266,17 @@ void ofAppEGLWindow::draw() {
 	}
 	currentRenderer->finishRender();
 
-	EGLBoolean success = eglSwapBuffers(eglDisplay, eglSurface);
-	if(!success) {
-		GLint error = eglGetError();
-		ofLogNotice("ofAppEGLWindow") << "display(): eglSwapBuffers failed: " << eglErrorString(error);
+	if(!isHeadless) {
+		EGLBoolean success = eglSwapBuffers(eglDisplay, eglSurface);
+		if(!success) {
+			GLint error = eglGetError();
+			ofLogNotice("ofAppEGLWindow") << "display(): eglSwapBuffers failed: " << eglErrorString(error);
+		}
+#ifdef OF_USE_KMS
+		if(isUsingKms && success) {
+			presentKmsFrame();
+		}
+#endif
 	}
 
 	nFramesSinceWindowResized++;
@@ -914,15 +1298,17 @@ void ofAppEGLWindow::setupNativeEvents() {
 	setupNativeUDev();
 	setupNativeMouse();
 	setupNativeKeyboard();
+	setupNativeTouch();
 	startThread();
 }
 
 //------------------------------------------------------------
 void ofAppEGLWindow::destroyNativeEvents() {
+	waitForThread(true, threadTimeout);
 	destroyNativeUDev();
 	destroyNativeMouse();
 	destroyNativeKeyboard();
-	waitForThread(true, threadTimeout);
+	destroyNativeTouch();
 }
 
 //------------------------------------------------------------
@@ -937,7 +1323,18 @@ void ofAppEGLWindow::setWindowRect(const ofRectangle& requestedWindowRect) {
 	if(newRect != currentWindowRect) {
 		ofRectangle oldWindowRect = currentWindowRect;
 
-		if(isUsingX11) {
+		if(isHeadless) {
+			// pbuffers can't be resized, replace it with one of the new size
+			EGLSurface newSurface = createPbufferSurface(newRect.width, newRect.height);
+			if(newSurface == EGL_NO_SURFACE) {
+				ofLogError("ofAppEGLWindow") << "setWindowRect(): couldn't create pbuffer: " << eglErrorString(eglGetError());
+			} else {
+				eglMakeCurrent(eglDisplay, newSurface, newSurface, eglContext);
+				eglDestroySurface(eglDisplay, eglSurface);
+				eglSurface = newSurface;
+				currentWindowRect = newRect;
+			}
+		} else if(isUsingX11) {
 			int ret = XMoveResizeWindow(x11Display,
 					x11Window,
 					(int)newRect.x,
@@ -952,6 +1349,11 @@ void ofAppEGLWindow::setWindowRect(const ofRectangle& requestedWindowRect) {
 				// all is good
 				currentWindowRect = newRect;
 			}
+#ifdef OF_USE_KMS
+		} else if(isUsingKms) {
+			// the output always covers the whole display in the mode
+			// chosen on setup, fullscreen or not
+#endif
 		} else {
 #ifdef TARGET_RASPBERRY_PI
 
@@ -1004,8 +1406,16 @@ void ofAppEGLWindow::setWindowRect(const ofRectangle& requestedWindowRect) {
 
 //------------------------------------------------------------
 bool ofAppEGLWindow::createWindow(const ofRectangle& requestedWindowRect) {
-	if(isUsingX11) {
+	if(isHeadless) {
+		// there's no native window, the size is used for the pbuffer
+		currentWindowRect = requestedWindowRect.getStandardized();
+		return true;
+	} else if(isUsingX11) {
 		return createX11NativeWindow(requestedWindowRect);
+#ifdef OF_USE_KMS
+	} else if(isUsingKms) {
+		return createKmsNativeWindow(requestedWindowRect);
+#endif
 	} else {
 #ifdef TARGET_RASPBERRY_PI
 		return createRPiNativeWindow(requestedWindowRect);
@@ -1041,33 +1451,73 @@ void ofAppEGLWindow::pollEvents(){
 			}
 		}
 	} else {
-		queue<ofMouseEventArgs> mouseEventsCopy;
-		instance->lock();
-		mouseEventsCopy = instance->mouseEvents;
-		while(!instance->mouseEvents.empty()){
-			instance->mouseEvents.pop();
-		}
-		instance->unlock();
-		while(!mouseEventsCopy.empty()){
-			instance->coreEvents.notifyMouseEvent(mouseEventsCopy.front());
-			mouseEventsCopy.pop();
-		}
+		instance->notifyInputEvents();
+	}
+}
 
-		// KEYBOARD EVENTS
-		queue<ofKeyEventArgs> keyEventsCopy;
-		instance->lock();
-		keyEventsCopy = instance->keyEvents;
-		while(!instance->keyEvents.empty()){
-			instance->keyEvents.pop();
-		}
-		instance->unlock();
-		while(!keyEventsCopy.empty()){
-			instance->coreEvents.notifyKeyEvent(keyEventsCopy.front());
-			keyEventsCopy.pop();
+//------------------------------------------------------------
+void ofAppEGLWindow::notifyInputEvents(){
+	pendingInputEvents.clear();
+	InputEvent event;
+	while(inputEvents.tryReceive(event)){
+		pendingInputEvents.push_back(std::move(event));
+	}
+
+	if(bKeepInputHistory){
+		inputHistory = pendingInputEvents;
+	}else{
+		inputHistory.clear();
+	}
+
+	// the motion events are coalesced by coreEvents, which notifies them
+	// before update
+	for(auto & e: pendingInputEvents){
+		switch(e.type){
+		case InputEvent::Mouse:
+			coreEvents.notifyMouseEvent(e.mouse);
+			break;
+		case InputEvent::Key:
+			coreEvents.notifyKeyEvent(e.key);
+			break;
+		case InputEvent::Touch:
+			coreEvents.notifyTouchEvent(e.touch);
+			break;
 		}
 	}
 }
 
+//------------------------------------------------------------
+void ofAppEGLWindow::sendInputEvent(InputEvent && event){
+	if(!inputEvents.send(std::move(event))){
+		// the main thread is stalled, losing input is better than
+		// blocking the reader and the kernel's buffer filling up
+		ofLogVerbose("ofAppEGLWindow") << "sendInputEvent(): input queue full, event dropped";
+	}
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::setCoalesceMotionEvents(bool coalesce){
+	coreEvents.setCoalesceMotionEvents(coalesce);
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::isCoalescingMotionEvents() const{
+	return coreEvents.isCoalescingMotionEvents();
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::setKeepInputHistory(bool keep){
+	bKeepInputHistory = keep;
+	if(!keep){
+		inputHistory.clear();
+	}
+}
+
+//------------------------------------------------------------
+const std::vector<ofAppEGLWindow::InputEvent> & ofAppEGLWindow::getInputHistory() const{
+	return inputHistory;
+}
+
 //------------------------------------------------------------
 void ofAppEGLWindow::hideCursor(){
 	bShowCursor = false;
@@ -1098,7 +1548,11 @@ glm::vec2 ofAppEGLWindow::getScreenSize(){
 	unsigned int screenWidth = 0;
 	unsigned int screenHeight = 0;
 
-	if(isUsingX11) {
+	if(isHeadless) {
+		// there's no screen, report the pbuffer so fullscreen keeps its size
+		screenWidth  = currentWindowRect.width;
+		screenHeight = currentWindowRect.height;
+	} else if(isUsingX11) {
 		// TODO, there must be a way to get screensize if the window is not inited
 		if(isWindowInited && x11Screen) {
 			screenWidth  = XWidthOfScreen(x11Screen);
@@ -1107,6 +1561,15 @@ glm::vec2 ofAppEGLWindow::getScreenSize(){
 			ofLogError("ofAppEGLWindow") << "getScreenSize(): tried to get display size but failed, x11Screen is not inited";
 		}
 
+#ifdef OF_USE_KMS
+	} else if(isUsingKms) {
+		if(kmsFd >= 0) {
+			screenWidth  = kmsMode.hdisplay;
+			screenHeight = kmsMode.vdisplay;
+		} else {
+			ofLogError("ofAppEGLWindow") << "getScreenSize(): tried to get display size but failed, no DRM device open";
+		}
+#endif
 	} else {
 #ifdef TARGET_RASPBERRY_PI
 		int success = graphics_get_display_size(settings.screenNum, &screenWidth, &screenHeight);
@@ -1161,7 +1624,11 @@ void ofAppEGLWindow::setWindowPosition(int x, int y){
 		return;
 	}
 
-	if(isUsingX11) {
+	if(isHeadless) {
+		currentWindowRect.x = x;
+		currentWindowRect.y = y;
+		nonFullscreenWindowRect = currentWindowRect;
+	} else if(isUsingX11) {
 		int ret = XMoveWindow(x11Display,
 				x11Window,
 				x,
@@ -1175,6 +1642,10 @@ void ofAppEGLWindow::setWindowPosition(int x, int y){
 			currentWindowRect.y = y;
 			nonFullscreenWindowRect = currentWindowRect;
 		}
+#ifdef OF_USE_KMS
+	} else if(isUsingKms) {
+		ofLogNotice("ofAppEGLWindow") << "setWindowPosition(): a KMS window always covers the whole display";
+#endif
 	} else {
 #ifdef TARGET_RASPBERRY_PI
 
@@ -1222,7 +1693,10 @@ void ofAppEGLWindow::setWindowShape(int w, int h){
 		return;
 	}
 
-	if(isUsingX11) {
+	if(isHeadless) {
+		setWindowRect(ofRectangle(currentWindowRect.x,currentWindowRect.y,w,h));
+		nonFullscreenWindowRect = currentWindowRect;
+	} else if(isUsingX11) {
 		int ret = XResizeWindow(x11Display,
 				x11Window,
 				(unsigned int)w,
@@ -1236,6 +1710,10 @@ void ofAppEGLWindow::setWindowShape(int w, int h){
 			currentWindowRect.height = h;
 			nonFullscreenWindowRect = currentWindowRect;
 		}
+#ifdef OF_USE_KMS
+	} else if(isUsingKms) {
+		ofLogNotice("ofAppEGLWindow") << "setWindowShape(): a KMS window always covers the whole display, set the size on setup to choose the mode";
+#endif
 	} else {
 #ifdef TARGET_RASPBERRY_PI
 		setWindowRect(ofRectangle(currentWindowRect.x,currentWindowRect.y,w,h));
@@ -1294,6 +1772,16 @@ ofRectangle ofAppEGLWindow::getScreenRect(){
 
 //------------------------------------------------------------
 void ofAppEGLWindow::setVerticalSync(bool enabled){
+#ifdef OF_USE_KMS
+	if(isUsingKms) {
+		// gbm surfaces ignore the swap interval, the flips are done here
+		kmsVerticalSync = enabled;
+		if(!enabled && !kmsAsyncFlip) {
+			ofLogWarning("ofAppEGLWindow") << "setVerticalSync(): the driver can't flip without waiting for the vblank";
+		}
+		return;
+	}
+#endif
 	eglSwapInterval(eglDisplay, enabled ? 1 : 0);
 }
 
@@ -1303,13 +1791,30 @@ void ofAppEGLWindow::threadedFunction(){
 	// they are not plugged in upon start
 	// This can be done with our udev device callbacks
 
+	// sleeps until a device has something to read instead of polling
+	// them, events are timestamped and queued as soon as they arrive
 	while(isThreadRunning()) {
+		struct pollfd fds[4];
+		int numFds = 0;
+		for(int fd: {udev_fd, mouse_fd, keyboard_fd, touch_fd}) {
+			if(fd >= 0) {
+				fds[numFds].fd = fd;
+				fds[numFds].events = POLLIN;
+				fds[numFds].revents = 0;
+				numFds++;
+			}
+		}
+
+		// the timeout only bounds how long stopping the thread takes
+		int ret = poll(fds, numFds, 100);
+		if(ret <= 0) {
+			continue;
+		}
+
 		readNativeUDevEvents();
 		readNativeMouseEvents();
 		readNativeKeyboardEvents();
-
-		// sleep briefly
-		ofSleepMillis(20);
+		readNativeTouchEvents();
 	}
 }
 
@@ -1372,6 +1877,7 @@ void ofAppEGLWindow::setupNativeMouse() {
 		char deviceNameBuffer[256] = "Unknown Device";
 		ioctl(mouse_fd, EVIOCGNAME(sizeof(deviceNameBuffer)), deviceNameBuffer);
 		ofLogNotice("ofAppEGLWindow") << "setupMouse(): mouse device name = " << deviceNameBuffer;
+		setMonotonicInputClock(mouse_fd);
 	} else {
 		ofLogError("ofAppEGLWindow") << "setupMouse(): did not open mouse";
 	}
@@ -1412,6 +1918,7 @@ void ofAppEGLWindow::setupNativeKeyboard() {
 		char deviceNameBuffer[256] = "Unknown Device";
 		ioctl(keyboard_fd, EVIOCGNAME(sizeof(deviceNameBuffer)), deviceNameBuffer);
 		ofLogNotice("ofAppEGLWindow") << "setupKeyboard(): keyboard device name = " << deviceNameBuffer;
+		setMonotonicInputClock(keyboard_fd);
 
 
 		// save current terminal settings
@@ -1671,9 +2178,11 @@ void ofAppEGLWindow::readNativeKeyboardEvents() {
 
 		// do we have a mouse svent to push?
 		if(pushKeyEvent){
-			lock();
-			keyEvents.push(keyEvent);
-			unlock();
+			InputEvent event;
+			event.type = InputEvent::Key;
+			event.key = keyEvent;
+			event.timeMicros = inputEventElapsedMicros(ev);
+			sendInputEvent(std::move(event));
 			pushKeyEvent = false;
 		}
 
@@ -1806,10 +2315,11 @@ void ofAppEGLWindow::readNativeMouseEvents() {
 
 		// do we have a mouse event to push?
 		if(pushMouseEvent){
-			// lock the thread for a moment while we copy the data
-			lock();
-			mouseEvents.push(mouseEvent);
-			unlock();
+			InputEvent event;
+			event.type = InputEvent::Mouse;
+			event.mouse = mouseEvent;
+			event.timeMicros = inputEventElapsedMicros(ev);
+			sendInputEvent(std::move(event));
 			pushMouseEvent = false;
 		}
 
@@ -1818,6 +2328,228 @@ void ofAppEGLWindow::readNativeMouseEvents() {
 
 }
 
+//------------------------------------------------------------
+void ofAppEGLWindow::setupNativeTouch() {
+	struct dirent **eps;
+	string devicePath = "/dev/input/";
+	int n = scandir(devicePath.c_str(), &eps, filter_event, dummy_sort);
+
+	// the first device that reports multitouch slots, single touch
+	// screens keep working as a mouse
+	for(int i = 0; i < n && touch_fd < 0; i++) {
+		string devicePathBuffer = devicePath + eps[i]->d_name;
+		int fd = open(devicePathBuffer.c_str(), O_RDONLY | O_NONBLOCK);
+		if(fd < 0) {
+			continue;
+		}
+		const size_t bitsPerLong = sizeof(long) * 8;
+		unsigned long absBits[ABS_MAX / bitsPerLong + 1];
+		memset(absBits, 0, sizeof(absBits));
+		ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+		auto hasAbs = [&](int code) {
+			return (absBits[code / bitsPerLong] >> (code % bitsPerLong)) & 1;
+		};
+		if(hasAbs(ABS_MT_SLOT) && hasAbs(ABS_MT_POSITION_X) && hasAbs(ABS_MT_POSITION_Y)) {
+			touch_fd = fd;
+			ofLogNotice("ofAppEGLWindow") << "setupTouch(): touch_fd=" << touch_fd << " devicePath=" << devicePathBuffer;
+		} else {
+			close(fd);
+		}
+	}
+	for(int i = 0; i < n; i++) {
+		free(eps[i]);
+	}
+	if(n >= 0) {
+		free(eps);
+	}
+
+	if(touch_fd < 0) {
+		ofLogNotice("ofAppEGLWindow") << "setupTouch(): no multitouch device found";
+		return;
+	}
+
+	char deviceNameBuffer[256] = "Unknown Device";
+	ioctl(touch_fd, EVIOCGNAME(sizeof(deviceNameBuffer)), deviceNameBuffer);
+	ofLogNotice("ofAppEGLWindow") << "setupTouch(): touch device name = " << deviceNameBuffer;
+	setMonotonicInputClock(touch_fd);
+
+	struct input_absinfo absSlot;
+	memset(&absSlot, 0, sizeof(absSlot));
+	memset(&ts.absX, 0, sizeof(ts.absX));
+	memset(&ts.absY, 0, sizeof(ts.absY));
+	memset(&ts.absPressure, 0, sizeof(ts.absPressure));
+	ioctl(touch_fd, EVIOCGABS(ABS_MT_SLOT), &absSlot);
+	ioctl(touch_fd, EVIOCGABS(ABS_MT_POSITION_X), &ts.absX);
+	ioctl(touch_fd, EVIOCGABS(ABS_MT_POSITION_Y), &ts.absY);
+	ioctl(touch_fd, EVIOCGABS(ABS_MT_PRESSURE), &ts.absPressure);
+
+	TouchSlot emptySlot;
+	memset(&emptySlot, 0, sizeof(emptySlot));
+	emptySlot.trackingId = -1;
+	ts.slots.assign(std::max(absSlot.maximum + 1, 1), emptySlot);
+	ts.currentSlot = absSlot.value;
+	ts.dropping = false;
+	ofLogNotice("ofAppEGLWindow") << "setupTouch(): " << ts.slots.size() << " touch slots";
+
+	// contacts already down are notified with the first report
+	syncNativeTouchSlots();
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::destroyNativeTouch() {
+	if(touch_fd >= 0) {
+		close(touch_fd);
+		touch_fd = -1;
+	}
+	ts.slots.clear();
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::syncNativeTouchSlots() {
+	// reads the state of every slot back from the device, used when
+	// starting and when events were dropped
+	size_t numSlots = ts.slots.size();
+	std::vector<int32_t> ids(numSlots + 1), xs(numSlots + 1), ys(numSlots + 1);
+	ids[0] = ABS_MT_TRACKING_ID;
+	xs[0] = ABS_MT_POSITION_X;
+	ys[0] = ABS_MT_POSITION_Y;
+	if(ioctl(touch_fd, EVIOCGMTSLOTS(ids.size() * sizeof(int32_t)), ids.data()) < 0
+			|| ioctl(touch_fd, EVIOCGMTSLOTS(xs.size() * sizeof(int32_t)), xs.data()) < 0
+			|| ioctl(touch_fd, EVIOCGMTSLOTS(ys.size() * sizeof(int32_t)), ys.data()) < 0) {
+		ofLogError("ofAppEGLWindow") << "syncNativeTouchSlots(): couldn't read the touch slots";
+		return;
+	}
+
+	for(size_t i = 0; i < numSlots; i++) {
+		TouchSlot & slot = ts.slots[i];
+		int id = ids[i + 1];
+		if(id != slot.trackingId) {
+			slot.ended = slot.ended || slot.trackingId >= 0;
+			slot.began = id >= 0;
+			slot.trackingId = id;
+		}
+		if(id >= 0) {
+			float x = ofMap(xs[i + 1], ts.absX.minimum, ts.absX.maximum, 0, currentWindowRect.width, true);
+			float y = ofMap(ys[i + 1], ts.absY.minimum, ts.absY.maximum, 0, currentWindowRect.height, true);
+			slot.changed = slot.changed || x != slot.x || y != slot.y;
+			slot.x = x;
+			slot.y = y;
+		}
+	}
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::sendNativeTouches(uint64_t timeMicros) {
+	int numTouches = 0;
+	for(auto & slot: ts.slots) {
+		numTouches += slot.trackingId >= 0;
+	}
+
+	for(size_t i = 0; i < ts.slots.size(); i++) {
+		TouchSlot & slot = ts.slots[i];
+		if(!slot.began && !slot.ended && !slot.changed) {
+			continue;
+		}
+
+		InputEvent event;
+		event.type = InputEvent::Touch;
+		event.timeMicros = timeMicros;
+		ofTouchEventArgs & touch = event.touch;
+		touch.id = i;
+		touch.x = slot.x;
+		touch.y = slot.y;
+		touch.pressure = slot.pressure;
+		touch.majoraxis = slot.majoraxis;
+		touch.minoraxis = slot.minoraxis;
+		touch.numTouches = numTouches;
+		touch.time = timeMicros / 1000;
+
+		// a slot can be lifted and touched again in the same report
+		if(slot.ended) {
+			InputEvent up = event;
+			up.touch.type = ofTouchEventArgs::up;
+			sendInputEvent(std::move(up));
+		}
+		if(slot.trackingId >= 0) {
+			touch.type = slot.began ? ofTouchEventArgs::down : ofTouchEventArgs::move;
+			sendInputEvent(std::move(event));
+		}
+
+		slot.began = false;
+		slot.ended = false;
+		slot.changed = false;
+	}
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::readNativeTouchEvents() {
+	// https://www.kernel.org/doc/Documentation/input/multi-touch-protocol.txt
+	if(touch_fd < 0) {
+		return;
+	}
+
+	// read in bursts, a touch wall sends dozens of events per report
+	struct input_event evs[64];
+	int nBytesRead;
+	while((nBytesRead = read(touch_fd, evs, sizeof(evs))) > 0) {
+		int numEvents = nBytesRead / sizeof(struct input_event);
+		for(int i = 0; i < numEvents; i++) {
+			const struct input_event & ev = evs[i];
+
+			if(ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+				ts.dropping = true;
+			} else if(ev.type == EV_SYN && ev.code == SYN_REPORT) {
+				if(ts.dropping) {
+					ts.dropping = false;
+					syncNativeTouchSlots();
+				}
+				sendNativeTouches(inputEventElapsedMicros(ev));
+			} else if(ev.type == EV_ABS && !ts.dropping) {
+				if(ev.code == ABS_MT_SLOT) {
+					ts.currentSlot = ev.value;
+					continue;
+				}
+				if(ts.currentSlot < 0 || ts.currentSlot >= (int)ts.slots.size()) {
+					continue;
+				}
+
+				TouchSlot & slot = ts.slots[ts.currentSlot];
+				switch(ev.code) {
+				case ABS_MT_TRACKING_ID:
+					// a new id in a slot still in use replaces its contact
+					slot.ended = slot.ended || slot.trackingId >= 0;
+					slot.began = ev.value >= 0;
+					slot.trackingId = ev.value < 0 ? -1 : ev.value;
+					break;
+				case ABS_MT_POSITION_X:
+					slot.x = ofMap(ev.value, ts.absX.minimum, ts.absX.maximum, 0, currentWindowRect.width, true);
+					slot.changed = true;
+					break;
+				case ABS_MT_POSITION_Y:
+					slot.y = ofMap(ev.value, ts.absY.minimum, ts.absY.maximum, 0, currentWindowRect.height, true);
+					slot.changed = true;
+					break;
+				case ABS_MT_PRESSURE:
+					slot.pressure = ts.absPressure.maximum > ts.absPressure.minimum ?
+						ofMap(ev.value, ts.absPressure.minimum, ts.absPressure.maximum, 0, 1, true) : ev.value;
+					slot.changed = true;
+					break;
+				case ABS_MT_TOUCH_MAJOR:
+					slot.majoraxis = ev.value;
+					slot.changed = true;
+					break;
+				case ABS_MT_TOUCH_MINOR:
+					slot.minoraxis = ev.value;
+					slot.changed = true;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	}
+}
+
 #ifdef TARGET_RASPBERRY_PI
 //------------------------------------------------------------
 void ofAppEGLWindow::initRPiNative() {
@@ -1923,6 +2655,618 @@ bool ofAppEGLWindow::createRPiNativeWindow(const ofRectangle& requestedWindowRec
 }
 #endif
 
+//------------------------------------------------------------
+ofAppEGLWindow::FrameTiming ofAppEGLWindow::getFrameTiming() const {
+#ifdef OF_USE_KMS
+	if(isUsingKms) {
+		return kmsFrameTiming;
+	}
+#endif
+	return FrameTiming();
+}
+
+//------------------------------------------------------------
+float ofAppEGLWindow::getRefreshRate() const {
+#ifdef OF_USE_KMS
+	if(isUsingKms && kmsFd >= 0 && kmsMode.htotal && kmsMode.vtotal) {
+		// the clock is in kHz, vrefresh is rounded to an integer
+		return kmsMode.clock * 1000.f / (kmsMode.htotal * kmsMode.vtotal);
+	}
+#endif
+	return 0;
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::setVideoLayer(const VideoLayerFrame & frame, const ofRectangle & rect) {
+#ifdef OF_USE_KMS
+	if(!isUsingKms || kmsFd < 0 || kmsCrtcIndex < 0) {
+		ofLogError("ofAppEGLWindow") << "setVideoLayer(): video layers are only supported by OF_APP_WINDOW_KMS windows";
+		return false;
+	}
+
+	if(kmsVideoPlaneId && !kmsPlaneSupports(kmsVideoPlaneId, frame.format)) {
+		if(kmsVideoFb || kmsVideoPendingFb || kmsVideoNextFb) {
+			ofLogError("ofAppEGLWindow") << "setVideoLayer(): the video plane doesn't support the format of the frame, clear the layer before changing it";
+			return false;
+		}
+		kmsVideoPlaneId = 0;
+	}
+	if(!kmsVideoPlaneId) {
+		kmsVideoPlaneId = findKmsPlane(DRM_PLANE_TYPE_OVERLAY, frame.format);
+		if(!kmsVideoPlaneId) {
+			ofLogError("ofAppEGLWindow") << "setVideoLayer(): no overlay plane supports the format of the frame";
+			return false;
+		}
+		kmsVideoProps = getKmsProperties(kmsFd, kmsVideoPlaneId, DRM_MODE_OBJECT_PLANE);
+	}
+
+	// the framebuffer keeps its own reference to the buffers, the
+	// handles are only needed to create it
+	uint32_t handles[4] = {0, 0, 0, 0};
+	uint64_t modifiers[4] = {0, 0, 0, 0};
+	bool imported = true;
+	for(int i = 0; i < 4 && frame.fds[i] >= 0; i++) {
+		if(drmPrimeFDToHandle(kmsFd, frame.fds[i], &handles[i]) != 0) {
+			imported = false;
+			break;
+		}
+		modifiers[i] = frame.modifier;
+	}
+
+	uint32_t fb = 0;
+	if(imported) {
+		int ret;
+		if(frame.modifier != DRM_FORMAT_MOD_LINEAR) {
+			ret = drmModeAddFB2WithModifiers(kmsFd, frame.width, frame.height, frame.format,
+				handles, frame.pitches, frame.offsets, modifiers, &fb, DRM_MODE_FB_MODIFIERS);
+		} else {
+			ret = drmModeAddFB2(kmsFd, frame.width, frame.height, frame.format,
+				handles, frame.pitches, frame.offsets, &fb, 0);
+		}
+		if(ret != 0) {
+			fb = 0;
+		}
+	}
+
+	for(int i = 0; i < 4; i++) {
+		bool closed = false;
+		for(int j = 0; j < i; j++) {
+			closed |= handles[j] == handles[i];
+		}
+		if(handles[i] && !closed) {
+			struct drm_gem_close gemClose;
+			memset(&gemClose, 0, sizeof(gemClose));
+			gemClose.handle = handles[i];
+			drmIoctl(kmsFd, DRM_IOCTL_GEM_CLOSE, &gemClose);
+		}
+	}
+
+	if(!fb) {
+		ofLogError("ofAppEGLWindow") << "setVideoLayer(): couldn't import the frame: " << strerror(errno);
+		return false;
+	}
+
+	// a frame set twice before drawing is replaced without being shown
+	if(kmsVideoNextFb && kmsVideoNextFb != kmsVideoPendingFb && kmsVideoNextFb != kmsVideoFb) {
+		drmModeRmFB(kmsFd, kmsVideoNextFb);
+	}
+	kmsVideoNextFb = fb;
+	kmsVideoWidth = frame.width;
+	kmsVideoHeight = frame.height;
+	kmsVideoRect = rect.getStandardized();
+	kmsVideoDirty = true;
+	return true;
+#else
+	ofLogError("ofAppEGLWindow") << "setVideoLayer(): video layers need openFrameworks compiled with OF_USE_KMS";
+	return false;
+#endif
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::clearVideoLayer() {
+#ifdef OF_USE_KMS
+	if(!isUsingKms || kmsFd < 0) {
+		return;
+	}
+	if(kmsVideoNextFb && kmsVideoNextFb != kmsVideoPendingFb && kmsVideoNextFb != kmsVideoFb) {
+		drmModeRmFB(kmsFd, kmsVideoNextFb);
+	}
+	kmsVideoNextFb = 0;
+	kmsVideoDirty = true;
+#endif
+}
+
+#ifdef OF_USE_KMS
+//------------------------------------------------------------
+// KMS BELOW
+//------------------------------------------------------------
+void ofAppEGLWindow::initKmsNative() {
+	kmsFd = -1;
+	kmsAtomic = false;
+	kmsAsyncFlip = false;
+	kmsVerticalSync = true;
+	kmsModeSet = false;
+	kmsFlipPending = false;
+	memset(&kmsMode, 0, sizeof(kmsMode));
+	kmsSavedCrtc = NULL;
+	kmsConnectorId = 0;
+	kmsCrtcId = 0;
+	kmsCrtcIndex = -1;
+	kmsPrimaryPlaneId = 0;
+	kmsModeBlob = 0;
+	kmsGbmDevice = NULL;
+	kmsGbmSurface = NULL;
+	kmsFormat = 0;
+	kmsFrontBo = NULL;
+	kmsVideoPlaneId = 0;
+	kmsVideoFb = 0;
+	kmsVideoPendingFb = 0;
+	kmsVideoNextFb = 0;
+	kmsVideoDirty = false;
+	kmsVideoWidth = 0;
+	kmsVideoHeight = 0;
+	kmsFrameTiming = FrameTiming();
+	kmsSubmitMicros = 0;
+
+	vector<string> devices;
+	if(!settings.kmsDevice.empty()) {
+		devices.push_back(settings.kmsDevice);
+	} else {
+		// render only devices, like the v3d of the raspberry pi 4, have
+		// no connectors and are skipped
+		for(int i = 0; i < 8; i++) {
+			devices.push_back("/dev/dri/card" + ofToString(i));
+		}
+	}
+
+	for(auto & device: devices) {
+		int fd = open(device.c_str(), O_RDWR | O_CLOEXEC);
+		if(fd < 0) {
+			continue;
+		}
+		drmSetClientCap(fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1);
+		if(findKmsOutput(fd)) {
+			kmsFd = fd;
+			ofLogNotice("ofAppEGLWindow") << "initKmsNative(): using " << device << ", mode " << kmsMode.name << " " << kmsMode.vrefresh << "Hz";
+			break;
+		}
+		close(fd);
+	}
+
+	if(kmsFd < 0) {
+		ofLogError("ofAppEGLWindow") << "initKmsNative(): no DRM device with a connected display found";
+		return;
+	}
+
+	kmsAtomic = settings.kmsAtomic && drmSetClientCap(kmsFd, DRM_CLIENT_CAP_ATOMIC, 1) == 0;
+	if(settings.kmsAtomic && !kmsAtomic) {
+		ofLogWarning("ofAppEGLWindow") << "initKmsNative(): the driver doesn't support atomic mode setting, using legacy page flips";
+	}
+
+	uint64_t cap = 0;
+	kmsAsyncFlip = drmGetCap(kmsFd, DRM_CAP_ASYNC_PAGE_FLIP, &cap) == 0 && cap;
+
+	kmsPrimaryPlaneId = findKmsPlane(DRM_PLANE_TYPE_PRIMARY, 0);
+	kmsConnectorProps = getKmsProperties(kmsFd, kmsConnectorId, DRM_MODE_OBJECT_CONNECTOR);
+	kmsCrtcProps = getKmsProperties(kmsFd, kmsCrtcId, DRM_MODE_OBJECT_CRTC);
+	kmsPrimaryProps = getKmsProperties(kmsFd, kmsPrimaryPlaneId, DRM_MODE_OBJECT_PLANE);
+	if(kmsAtomic && !kmsPrimaryPlaneId) {
+		ofLogWarning("ofAppEGLWindow") << "initKmsNative(): no primary plane found, using legacy page flips";
+		kmsAtomic = false;
+	}
+
+	kmsSavedCrtc = drmModeGetCrtc(kmsFd, kmsCrtcId);
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::exitKmsNative() {
+	if(kmsFd >= 0) {
+		close(kmsFd);
+		kmsFd = -1;
+	}
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::findKmsOutput(int fd) {
+	drmModeRes * resources = drmModeGetResources(fd);
+	if(!resources) {
+		return false;
+	}
+
+	// screenNum counts only the connected displays
+	drmModeConnector * connector = NULL;
+	int numConnected = 0;
+	for(int i = 0; i < resources->count_connectors && !connector; i++) {
+		drmModeConnector * candidate = drmModeGetConnector(fd, resources->connectors[i]);
+		if(candidate && candidate->connection == DRM_MODE_CONNECTED && candidate->count_modes > 0) {
+			if(numConnected++ == settings.screenNum) {
+				connector = candidate;
+				break;
+			}
+		}
+		drmModeFreeConnector(candidate);
+	}
+
+	if(!connector) {
+		drmModeFreeResources(resources);
+		return false;
+	}
+
+	// a window that matches one of the modes switches the display to it,
+	// otherwise the display keeps its preferred one
+	int modeIndex = -1;
+	if(settings.windowMode == OF_WINDOW) {
+		for(int i = 0; i < connector->count_modes && modeIndex < 0; i++) {
+			if(connector->modes[i].hdisplay == settings.width && connector->modes[i].vdisplay == settings.height) {
+				modeIndex = i;
+			}
+		}
+	}
+	for(int i = 0; i < connector->count_modes && modeIndex < 0; i++) {
+		if(connector->modes[i].type & DRM_MODE_TYPE_PREFERRED) {
+			modeIndex = i;
+		}
+	}
+	kmsMode = connector->modes[modeIndex < 0 ? 0 : modeIndex];
+
+	// keep the crtc already driving the connector, or the first one
+	// any of its encoders can use
+	uint32_t crtcId = 0;
+	drmModeEncoder * encoder = connector->encoder_id ? drmModeGetEncoder(fd, connector->encoder_id) : NULL;
+	if(encoder) {
+		crtcId = encoder->crtc_id;
+		drmModeFreeEncoder(encoder);
+	}
+	for(int i = 0; i < connector->count_encoders && !crtcId; i++) {
+		encoder = drmModeGetEncoder(fd, connector->encoders[i]);
+		if(!encoder) {
+			continue;
+		}
+		for(int j = 0; j < resources->count_crtcs; j++) {
+			if(encoder->possible_crtcs & (1 << j)) {
+				crtcId = resources->crtcs[j];
+				break;
+			}
+		}
+		drmModeFreeEncoder(encoder);
+	}
+
+	kmsCrtcIndex = -1;
+	for(int j = 0; j < resources->count_crtcs; j++) {
+		if(resources->crtcs[j] == crtcId) {
+			kmsCrtcIndex = j;
+		}
+	}
+
+	kmsConnectorId = connector->connector_id;
+	kmsCrtcId = crtcId;
+
+	drmModeFreeConnector(connector);
+	drmModeFreeResources(resources);
+
+	return kmsCrtcId != 0 && kmsCrtcIndex >= 0;
+}
+
+//------------------------------------------------------------
+uint32_t ofAppEGLWindow::findKmsPlane(uint64_t type, uint32_t format) {
+	drmModePlaneRes * planes = drmModeGetPlaneResources(kmsFd);
+	if(!planes) {
+		return 0;
+	}
+	uint32_t found = 0;
+	for(uint32_t i = 0; i < planes->count_planes && !found; i++) {
+		drmModePlane * plane = drmModeGetPlane(kmsFd, planes->planes[i]);
+		if(!plane) {
+			continue;
+		}
+		if((plane->possible_crtcs & (1 << kmsCrtcIndex))
+				&& plane->plane_id != kmsPrimaryPlaneId
+				&& getKmsPropertyValue(kmsFd, plane->plane_id, DRM_MODE_OBJECT_PLANE, "type") == type
+				&& (format == 0 || kmsPlaneSupports(plane->plane_id, format))) {
+			found = plane->plane_id;
+		}
+		drmModeFreePlane(plane);
+	}
+	drmModeFreePlaneResources(planes);
+	return found;
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::kmsPlaneSupports(uint32_t planeId, uint32_t format) {
+	drmModePlane * plane = drmModeGetPlane(kmsFd, planeId);
+	if(!plane) {
+		return false;
+	}
+	bool supported = false;
+	for(uint32_t i = 0; i < plane->count_formats; i++) {
+		supported |= plane->formats[i] == format;
+	}
+	drmModeFreePlane(plane);
+	return supported;
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::createKmsNativeWindow(const ofRectangle& requestedWindowRect) {
+	if(kmsFd < 0) {
+		ofLogError("ofAppEGLWindow") << "createKmsNativeWindow(): no DRM device open";
+		return false;
+	}
+
+	kmsGbmDevice = gbm_create_device(kmsFd);
+	if(!kmsGbmDevice) {
+		ofLogError("ofAppEGLWindow") << "createKmsNativeWindow(): couldn't create gbm device";
+		return false;
+	}
+
+	auto alpha = settings.frameBufferAttributes.find(EGL_ALPHA_SIZE);
+	bool hasAlpha = alpha != settings.frameBufferAttributes.end() && alpha->second > 0;
+	kmsFormat = hasAlpha ? GBM_FORMAT_ARGB8888 : GBM_FORMAT_XRGB8888;
+
+	kmsGbmSurface = gbm_surface_create(kmsGbmDevice, kmsMode.hdisplay, kmsMode.vdisplay,
+		kmsFormat, GBM_BO_USE_SCANOUT | GBM_BO_USE_RENDERING);
+	if(!kmsGbmSurface) {
+		ofLogError("ofAppEGLWindow") << "createKmsNativeWindow(): couldn't create gbm surface";
+		gbm_device_destroy(kmsGbmDevice);
+		kmsGbmDevice = NULL;
+		return false;
+	}
+
+	currentWindowRect.set(0, 0, kmsMode.hdisplay, kmsMode.vdisplay);
+	if(requestedWindowRect.width != currentWindowRect.width || requestedWindowRect.height != currentWindowRect.height) {
+		ofLogNotice("ofAppEGLWindow") << "createKmsNativeWindow(): no mode matches " << requestedWindowRect.width << "x" << requestedWindowRect.height
+			<< ", using the whole display at " << currentWindowRect.width << "x" << currentWindowRect.height;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::destroyKmsNativeWindow() {
+	if(kmsFlipPending) {
+		waitForKmsFlip();
+	}
+
+	// give the display back to the console before removing the
+	// framebuffers, removing one on screen turns the display off
+	if(kmsSavedCrtc) {
+		drmModeSetCrtc(kmsFd, kmsSavedCrtc->crtc_id, kmsSavedCrtc->buffer_id,
+			kmsSavedCrtc->x, kmsSavedCrtc->y, &kmsConnectorId, 1, &kmsSavedCrtc->mode);
+		drmModeFreeCrtc(kmsSavedCrtc);
+		kmsSavedCrtc = NULL;
+	}
+
+	clearVideoLayer();
+	if(kmsVideoPendingFb && kmsVideoPendingFb != kmsVideoFb) {
+		drmModeRmFB(kmsFd, kmsVideoPendingFb);
+	}
+	if(kmsVideoFb) {
+		drmModeRmFB(kmsFd, kmsVideoFb);
+	}
+	kmsVideoFb = kmsVideoPendingFb = 0;
+
+	if(kmsModeBlob) {
+		drmModeDestroyPropertyBlob(kmsFd, kmsModeBlob);
+		kmsModeBlob = 0;
+	}
+
+	// the framebuffers go away with their buffers
+	if(kmsFrontBo) {
+		gbm_surface_release_buffer(kmsGbmSurface, kmsFrontBo);
+		kmsFrontBo = NULL;
+	}
+	if(kmsGbmSurface) {
+		gbm_surface_destroy(kmsGbmSurface);
+		kmsGbmSurface = NULL;
+	}
+	if(kmsGbmDevice) {
+		gbm_device_destroy(kmsGbmDevice);
+		kmsGbmDevice = NULL;
+	}
+	kmsModeSet = false;
+}
+
+//------------------------------------------------------------
+EGLDisplay ofAppEGLWindow::getKmsDisplay() {
+#ifdef EGL_PLATFORM_GBM_KHR
+	auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if(getPlatformDisplay) {
+		return getPlatformDisplay(EGL_PLATFORM_GBM_KHR, kmsGbmDevice, NULL);
+	}
+#endif
+	return eglGetDisplay((EGLNativeDisplayType)kmsGbmDevice);
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::presentKmsFrame() {
+	gbm_bo * bo = gbm_surface_lock_front_buffer(kmsGbmSurface);
+	if(!bo) {
+		ofLogError("ofAppEGLWindow") << "presentKmsFrame(): couldn't lock the front buffer";
+		return false;
+	}
+
+	uint32_t fb = getKmsFramebuffer(kmsFd, bo);
+	kmsSubmitMicros = getKmsMonotonicMicros();
+	if(!fb || !commitKmsFrame(fb)) {
+		gbm_surface_release_buffer(kmsGbmSurface, bo);
+		return false;
+	}
+
+	// waiting here instead of before the next commit starts the next
+	// frame right after the vblank, so input read in update() is as
+	// recent as possible when its frame is shown
+	waitForKmsFlip();
+
+	// the buffer that was on screen can be rendered to again
+	if(kmsFrontBo) {
+		gbm_surface_release_buffer(kmsGbmSurface, kmsFrontBo);
+	}
+	kmsFrontBo = bo;
+
+	if(kmsVideoPendingFb != kmsVideoFb) {
+		if(kmsVideoFb) {
+			drmModeRmFB(kmsFd, kmsVideoFb);
+		}
+		kmsVideoFb = kmsVideoPendingFb;
+	}
+	return true;
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::commitKmsFrame(uint32_t fb) {
+	uint32_t width = kmsMode.hdisplay;
+	uint32_t height = kmsMode.vdisplay;
+
+	if(!kmsAtomic || (kmsModeSet && !kmsVerticalSync && kmsAsyncFlip && !kmsVideoDirty)) {
+		if(!kmsModeSet) {
+			// setting the mode shows the buffer without a flip event
+			if(drmModeSetCrtc(kmsFd, kmsCrtcId, fb, 0, 0, &kmsConnectorId, 1, &kmsMode) != 0) {
+				ofLogError("ofAppEGLWindow") << "commitKmsFrame(): couldn't set the mode: " << strerror(errno);
+				return false;
+			}
+			kmsModeSet = true;
+		} else {
+			uint32_t flags = DRM_MODE_PAGE_FLIP_EVENT;
+			if(!kmsVerticalSync && kmsAsyncFlip) {
+				flags |= DRM_MODE_PAGE_FLIP_ASYNC;
+			}
+			if(drmModePageFlip(kmsFd, kmsCrtcId, fb, flags, this) != 0) {
+				ofLogError("ofAppEGLWindow") << "commitKmsFrame(): page flip failed: " << strerror(errno);
+				return false;
+			}
+			kmsFlipPending = true;
+		}
+
+		if(kmsVideoDirty && kmsVideoPlaneId) {
+			// legacy planes change on their own, not with the flip
+			int ret;
+			if(kmsVideoNextFb) {
+				ret = drmModeSetPlane(kmsFd, kmsVideoPlaneId, kmsCrtcId, kmsVideoNextFb, 0,
+					kmsVideoRect.x, kmsVideoRect.y, kmsVideoRect.width, kmsVideoRect.height,
+					0, 0, kmsVideoWidth << 16, kmsVideoHeight << 16);
+			} else {
+				ret = drmModeSetPlane(kmsFd, kmsVideoPlaneId, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+			}
+			if(ret != 0) {
+				ofLogError("ofAppEGLWindow") << "commitKmsFrame(): couldn't set the video plane: " << strerror(errno);
+			}
+			kmsVideoPendingFb = kmsVideoNextFb;
+			kmsVideoDirty = false;
+		}
+		return true;
+	}
+
+	drmModeAtomicReq * request = drmModeAtomicAlloc();
+	uint32_t flags = DRM_MODE_PAGE_FLIP_EVENT | DRM_MODE_ATOMIC_NONBLOCK;
+
+	if(!kmsModeSet) {
+		if(drmModeCreatePropertyBlob(kmsFd, &kmsMode, sizeof(kmsMode), &kmsModeBlob) != 0) {
+			ofLogError("ofAppEGLWindow") << "commitKmsFrame(): couldn't create the mode blob: " << strerror(errno);
+			drmModeAtomicFree(request);
+			return false;
+		}
+		addKmsProperty(request, kmsConnectorId, kmsConnectorProps, "CRTC_ID", kmsCrtcId);
+		addKmsProperty(request, kmsCrtcId, kmsCrtcProps, "MODE_ID", kmsModeBlob);
+		addKmsProperty(request, kmsCrtcId, kmsCrtcProps, "ACTIVE", 1);
+		flags |= DRM_MODE_ATOMIC_ALLOW_MODESET;
+	}
+
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "FB_ID", fb);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "CRTC_ID", kmsCrtcId);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "SRC_X", 0);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "SRC_Y", 0);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "SRC_W", (uint64_t)width << 16);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "SRC_H", (uint64_t)height << 16);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "CRTC_X", 0);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "CRTC_Y", 0);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "CRTC_W", width);
+	addKmsProperty(request, kmsPrimaryPlaneId, kmsPrimaryProps, "CRTC_H", height);
+
+	// the video frame flips in the same commit as the frame drawn over it
+	if(kmsVideoDirty && kmsVideoPlaneId) {
+		if(kmsVideoNextFb) {
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "FB_ID", kmsVideoNextFb);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "CRTC_ID", kmsCrtcId);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "SRC_X", 0);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "SRC_Y", 0);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "SRC_W", (uint64_t)kmsVideoWidth << 16);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "SRC_H", (uint64_t)kmsVideoHeight << 16);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "CRTC_X", (int64_t)kmsVideoRect.x);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "CRTC_Y", (int64_t)kmsVideoRect.y);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "CRTC_W", (uint64_t)kmsVideoRect.width);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "CRTC_H", (uint64_t)kmsVideoRect.height);
+		} else {
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "FB_ID", 0);
+			addKmsProperty(request, kmsVideoPlaneId, kmsVideoProps, "CRTC_ID", 0);
+		}
+	}
+
+	int ret = drmModeAtomicCommit(kmsFd, request, flags, this);
+	drmModeAtomicFree(request);
+
+	if(ret != 0) {
+		ofLogError("ofAppEGLWindow") << "commitKmsFrame(): atomic commit failed: " << strerror(errno);
+		if(kmsVideoDirty) {
+			// most likely the plane can't scale or place the video like that,
+			// drop it so the ui keeps updating
+			ofLogError("ofAppEGLWindow") << "commitKmsFrame(): hiding the video layer";
+			clearVideoLayer();
+			kmsVideoPlaneId = 0;
+		}
+		return false;
+	}
+
+	if(kmsVideoDirty) {
+		kmsVideoPendingFb = kmsVideoNextFb;
+		kmsVideoDirty = false;
+	}
+	kmsModeSet = true;
+	kmsFlipPending = true;
+	return true;
+}
+
+//------------------------------------------------------------
+bool ofAppEGLWindow::waitForKmsFlip() {
+	drmEventContext eventContext;
+	memset(&eventContext, 0, sizeof(eventContext));
+	eventContext.version = 2;
+	eventContext.page_flip_handler = &ofAppEGLWindow::onKmsPageFlip;
+
+	while(kmsFlipPending) {
+		struct pollfd pfd;
+		pfd.fd = kmsFd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		int ret = poll(&pfd, 1, 1000);
+		if(ret < 0 && errno == EINTR) {
+			continue;
+		} else if(ret <= 0) {
+			ofLogError("ofAppEGLWindow") << "waitForKmsFlip(): " << (ret == 0 ? "timed out waiting for the page flip" : strerror(errno));
+			kmsFlipPending = false;
+			return false;
+		}
+		drmHandleEvent(kmsFd, &eventContext);
+	}
+	return true;
+}
+
+//------------------------------------------------------------
+void ofAppEGLWindow::onKmsPageFlip(int fd, unsigned int sequence, unsigned int sec, unsigned int usec, void * data) {
+	ofAppEGLWindow * window = static_cast<ofAppEGLWindow*>(data);
+	FrameTiming & timing = window->kmsFrameTiming;
+	if(timing.vblankSequence && sequence > timing.vblankSequence + 1) {
+		timing.missedVblanks = sequence - timing.vblankSequence - 1;
+	} else {
+		timing.missedVblanks = 0;
+	}
+	timing.frameNum = ofGetFrameNum();
+	timing.vblankSequence = sequence;
+	timing.submittedMicros = window->kmsSubmitMicros;
+	// drm timestamps are CLOCK_MONOTONIC unless the driver lacks DRM_CAP_TIMESTAMP_MONOTONIC
+	timing.presentedMicros = (uint64_t)sec * 1000000 + usec;
+	window->kmsFlipPending = false;
+}
+#endif
+
 //------------------------------------------------------------
 // X11 BELOW
 //------------------------------------------------------------
@@ -4,6 +4,7 @@
 
 #include "ofAppBaseWindow.h"
 #include "ofThread.h"
+#include "ofThreadChannel.h"
 #include "ofImage.h"
 #include "ofBaseTypes.h"
 #include "ofEvents.h"
@@ -36,11 +37,19 @@
 
 #include <EGL/egl.h>
 
+#ifdef OF_USE_KMS
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#include <gbm.h>
+#endif
+
 // TODO: this shold be passed in with the other window settings, like window alpha, etc.
 enum ofAppEGLWindowType {
 	OF_APP_WINDOW_AUTO,
 	OF_APP_WINDOW_NATIVE,
-	OF_APP_WINDOW_X11
+	OF_APP_WINDOW_X11,
+	OF_APP_WINDOW_HEADLESS, ///< no display or window, renders into an offscreen pbuffer
+	OF_APP_WINDOW_KMS ///< renders straight to a display through DRM/KMS, without X11 or a compositor, needs OF_USE_KMS
 };
 
 typedef std::map<EGLint,EGLint> ofEGLAttributeList;
@@ -68,6 +77,9 @@ public:
 	void draw();
 	void close();
 	void makeCurrent();
+	/// \brief A context sharing this window's one with a 1x1 pbuffer, or
+	/// no surface if the config doesn't support pbuffers
+	std::shared_ptr<ofBaseGLContext> createSharedContext();
 	void swapBuffers();
 	void startRender();
 	void finishRender();
@@ -121,6 +133,25 @@ public:
 		int screenNum;
 		int layer;
 
+		/// \brief With OF_APP_WINDOW_HEADLESS, the index of the EGL device (GPU)
+		/// to render on, or -1 to use the default display.
+		///
+		/// Running one process per device and rendering into ofFbos
+		/// scales offline rendering across every GPU in the machine.
+		int eglDevice;
+
+		/// \brief With OF_APP_WINDOW_KMS, the DRM device to output to, like
+		/// "/dev/dri/card1", or empty to use the first one with a display
+		/// connected. screenNum selects between its connected displays.
+		std::string kmsDevice;
+
+		/// \brief With OF_APP_WINDOW_KMS, commit the mode, the frames and the
+		/// video layer with atomic mode setting, true by default.
+		///
+		/// Drivers without atomic support fall back to legacy page flips,
+		/// where the video layer isn't synchronized with the frames.
+		bool kmsAtomic;
+
 		Settings();
 		Settings(const ofGLESWindowSettings & settings);
 	};
@@ -139,6 +170,113 @@ public:
 	EGLint getEglVersionMajor () const;
 	EGLint getEglVersionMinor() const;
 
+	/// \returns the number of EGL devices that a headless window can
+	/// render on, 0 if the driver can't enumerate them.
+	static int getNumEglDevices();
+
+	/// \brief When and how the last frame reached the display
+	struct FrameTiming{
+		uint64_t frameNum = 0; ///< ofGetFrameNum() when the frame was presented
+		uint32_t vblankSequence = 0; ///< the display's vblank counter at the flip
+		uint64_t submittedMicros = 0; ///< CLOCK_MONOTONIC time the frame was committed to the display
+		uint64_t presentedMicros = 0; ///< CLOCK_MONOTONIC time the display started scanning it out
+		uint32_t missedVblanks = 0; ///< vblanks the previous frame was repeated for, 0 if the app keeps up with the display
+	};
+
+	/// \brief Timing reported by the display for the last presented frame,
+	/// only available with OF_APP_WINDOW_KMS, all zeros otherwise
+	///
+	/// presentedMicros - submittedMicros is the time the frame waited for
+	/// the vblank, the difference between consecutive presentedMicros the
+	/// real frame period:
+	///
+	/// ~~~~{.cpp}
+	/// auto window = dynamic_cast<ofAppEGLWindow*>(ofGetWindowPtr());
+	/// auto timing = window->getFrameTiming();
+	/// if(timing.missedVblanks > 0){
+	///     ofLogWarning() << "frame " << timing.frameNum << " was late";
+	/// }
+	/// ~~~~
+	FrameTiming getFrameTiming() const;
+
+	/// \returns the refresh rate of the display in Hz with
+	/// OF_APP_WINDOW_KMS, 0 otherwise
+	float getRefreshRate() const;
+
+	/// \brief A frame in a dmabuf, usually from a hardware video decoder
+	/// or a camera, to show on a display plane
+	struct VideoLayerFrame{
+		uint32_t format = 0; ///< DRM fourcc, like DRM_FORMAT_NV12
+		int width = 0;
+		int height = 0;
+		int fds[4] = {-1, -1, -1, -1}; ///< dmabuf of each plane, can be the same one
+		uint32_t pitches[4] = {0, 0, 0, 0};
+		uint32_t offsets[4] = {0, 0, 0, 0};
+		uint64_t modifier = 0; ///< DRM_FORMAT_MOD_LINEAR by default
+	};
+
+	/// \brief Shows frame on a hardware overlay plane over rect of the
+	/// display, only with OF_APP_WINDOW_KMS
+	///
+	/// The display scans the frame out and scales it itself, it's never
+	/// copied or drawn by the GPU. It appears with the next frame drawn
+	/// by the app and the buffers must be left untouched until the frame
+	/// set after it has been presented, so decoders need at least 2. The
+	/// fds are only used during the call and can be closed afterwards.
+	///
+	/// \returns false if there's no plane for the format or the buffer
+	/// can't be imported
+	bool setVideoLayer(const VideoLayerFrame & frame, const ofRectangle & rect);
+
+	/// \brief Hides the video layer with the next frame
+	void clearVideoLayer();
+
+	/// \brief A mouse, key or touch event read from /dev/input
+	struct InputEvent{
+		enum Type{
+			Mouse,
+			Key,
+			Touch
+		};
+		Type type = Mouse;
+		ofMouseEventArgs mouse;
+		ofKeyEventArgs key;
+		ofTouchEventArgs touch;
+		uint64_t timeMicros = 0; ///< ofGetElapsedTimeMicros() when the kernel received it
+	};
+
+	/// \brief Merge the mouse and touch motion events that arrive between
+	/// two frames into the last one, true by default
+	///
+	/// Native input is read by a thread as soon as it arrives and notified
+	/// by the main thread before each frame. A touch wall sends a move per
+	/// finger several times per frame, with this only the newest position
+	/// of each touch is notified, with the others in its history, while
+	/// presses, releases and keys are all notified in order. Same as
+	/// events().setCoalesceMotionEvents(), see ofCoreEvents.
+	void setCoalesceMotionEvents(bool coalesce);
+	bool isCoalescingMotionEvents() const;
+
+	/// \brief Keep every event notified before the current frame,
+	/// including the motion events that were coalesced, off by default
+	///
+	/// Unlike the history of the coalesced events, these have the time the
+	/// kernel received them.
+	///
+	/// ~~~~{.cpp}
+	/// // draw the whole stroke, not only the point of each frame
+	/// for(auto & event: window->getInputHistory()){
+	///     if(event.type == ofAppEGLWindow::InputEvent::Touch){
+	///         stroke.addVertex(event.touch.x, event.touch.y);
+	///     }
+	/// }
+	/// ~~~~
+	void setKeepInputHistory(bool keep);
+
+	/// \returns the events read for the current frame, oldest first, empty
+	/// unless setKeepInputHistory(true) was called
+	const std::vector<InputEvent> & getInputHistory() const;
+
 
 protected:
 	void setWindowRect(const ofRectangle& requestedWindowRect);
@@ -165,8 +303,12 @@ protected:
 
 
 	void threadedFunction();
-	std::queue<ofMouseEventArgs> mouseEvents;
-	std::queue<ofKeyEventArgs>   keyEvents;
+	ofThreadChannel<InputEvent, ofThreadChannelSPSC> inputEvents;  ///< \brief Sent by the input thread, received before each frame.
+	std::vector<InputEvent> pendingInputEvents;
+	std::vector<InputEvent> inputHistory;
+	bool bKeepInputHistory;
+	void sendInputEvent(InputEvent && event);
+	void notifyInputEvents();
 	void checkEvents();
 	ofImage mouseCursor;
 
@@ -192,6 +334,9 @@ protected:
 	bool createSurface();
 	bool destroySurface();
 
+	EGLDisplay getHeadlessDisplay();
+	EGLSurface createPbufferSurface(int width, int height);
+
 	// bool resizeSurface();
 
 	EGLDisplay eglDisplay;  // EGL display connection
@@ -218,6 +363,8 @@ protected:
 	bool destroyWindow();
 
 	bool isUsingX11;  ///< \brief Indicate the use of the X Window System.
+	bool isHeadless;  ///< \brief Indicate rendering into a pbuffer without a display.
+	bool isUsingKms;  ///< \brief Indicate rendering straight to a display through DRM/KMS.
 
 	bool isWindowInited;  ///< \brief Indicate that the window is (properly) initialized.
 	bool isSurfaceInited;  ///< \brief Indicate that the surface is (properly) initialized.
@@ -249,6 +396,59 @@ protected:
 	// create a window without using x11.
 #endif
 
+#ifdef OF_USE_KMS
+	void initKmsNative();
+	void exitKmsNative();
+	bool findKmsOutput(int fd);
+	uint32_t findKmsPlane(uint64_t type, uint32_t format);
+	bool kmsPlaneSupports(uint32_t plane, uint32_t format);
+
+	bool createKmsNativeWindow(const ofRectangle& requestedWindowRect);
+	void destroyKmsNativeWindow();
+	EGLDisplay getKmsDisplay();
+
+	bool presentKmsFrame();
+	bool commitKmsFrame(uint32_t fb);
+	bool waitForKmsFlip();
+	static void onKmsPageFlip(int fd, unsigned int sequence, unsigned int sec, unsigned int usec, void * data);
+
+	int kmsFd;
+	bool kmsAtomic;  ///< \brief The driver accepted atomic commits.
+	bool kmsAsyncFlip;  ///< \brief The driver can flip without waiting for the vblank.
+	bool kmsVerticalSync;
+	bool kmsModeSet;  ///< \brief The mode was set by the first frame.
+	bool kmsFlipPending;
+
+	drmModeModeInfo kmsMode;
+	drmModeCrtc * kmsSavedCrtc;  ///< \brief The console's crtc, restored on exit.
+	uint32_t kmsConnectorId;
+	uint32_t kmsCrtcId;
+	int kmsCrtcIndex;
+	uint32_t kmsPrimaryPlaneId;
+	uint32_t kmsModeBlob;
+	std::map<std::string, uint32_t> kmsConnectorProps;
+	std::map<std::string, uint32_t> kmsCrtcProps;
+	std::map<std::string, uint32_t> kmsPrimaryProps;
+
+	gbm_device * kmsGbmDevice;
+	gbm_surface * kmsGbmSurface;
+	uint32_t kmsFormat;
+	gbm_bo * kmsFrontBo;  ///< \brief The buffer on screen.
+
+	uint32_t kmsVideoPlaneId;
+	std::map<std::string, uint32_t> kmsVideoProps;
+	uint32_t kmsVideoFb;  ///< \brief The video frame on screen.
+	uint32_t kmsVideoPendingFb;  ///< \brief The video frame committed, waiting for the flip.
+	uint32_t kmsVideoNextFb;  ///< \brief The video frame to commit with the next frame.
+	bool kmsVideoDirty;
+	ofRectangle kmsVideoRect;
+	int kmsVideoWidth;
+	int kmsVideoHeight;
+
+	FrameTiming kmsFrameTiming;
+	uint64_t kmsSubmitMicros;
+#endif
+
 	Display* x11Display;  ///< \brief Indicate which X11 display is in use (currently).
 	Screen* x11Screen;  ///< \brief Indicate which X11 screen is in use (currently).
 	Window x11Window;
@@ -266,12 +466,17 @@ protected:
 	
 	void setupNativeMouse();
 	void setupNativeKeyboard();
+	void setupNativeTouch();
 
 	void destroyNativeMouse();
 	void destroyNativeKeyboard();
+	void destroyNativeTouch();
 
 	void readNativeMouseEvents();
 	void readNativeKeyboardEvents();
+	void readNativeTouchEvents();
+	void syncNativeTouchSlots();
+	void sendNativeTouches(uint64_t timeMicros);
 	void readNativeUDevEvents();
 
 	static void handleX11Event(const XEvent& event);
@@ -6,6 +6,7 @@
 #include "ofGLProgrammableRenderer.h"
 #include "ofAppRunner.h"
 #include "ofFileUtils.h"
+#include "ofProfiler.h"
 
 #ifdef TARGET_LINUX
 	#include "ofIcon.h"
@@ -35,6 +36,29 @@
 
 using namespace std;
 
+namespace{
+	class GLFWSharedContext: public ofBaseGLContext{
+	public:
+		GLFWSharedContext(GLFWwindow * window)
+		:window(window){}
+
+		~GLFWSharedContext(){
+			glfwDestroyWindow(window);
+		}
+
+		void makeCurrent(){
+			glfwMakeContextCurrent(window);
+		}
+
+		void releaseCurrent(){
+			glfwMakeContextCurrent(nullptr);
+		}
+
+	private:
+		GLFWwindow * window;
+	};
+}
+
 //-------------------------------------------------------
 ofAppGLFWWindow::ofAppGLFWWindow(){
 	bEnableSetupScreen	= true;
@@ -50,6 +74,8 @@ ofAppGLFWWindow::ofAppGLFWWindow(){
     pixelScreenCoordScale = 1;
 	nFramesSinceWindowResized = 0;
 	iconSet = false;
+	bVerticalSync = false;
+	bDeferSwap = false;
 	windowP = nullptr;
 	windowW = 0;
 	windowH = 0;
@@ -402,41 +428,54 @@ void ofAppGLFWWindow::draw(){
 	currentRenderer->startRender();
 	if( bEnableSetupScreen ) currentRenderer->setupScreen();
 
-	events().notifyDraw();
+	{
+		OF_PROFILE_GPU_SCOPE("draw");
+		events().notifyDraw();
+	}
 
-	#ifdef TARGET_WIN32
-	if (currentRenderer->getBackgroundAuto() == false){
-		// on a PC resizing a window with this method of accumulation (essentially single buffering)
-		// is BAD, so we clear on resize events.
-		if (nFramesSinceWindowResized < 3){
+	if(bDeferSwap){
+		// ofMainLoop swaps once every window is drawn, maybe from another
+		// thread, which only sees the commands already flushed
+		if (currentRenderer->getBackgroundAuto() == false && nFramesSinceWindowResized < 3){
 			currentRenderer->clear();
-		} else {
-			if ( (events().getFrameNum() < 3 || nFramesSinceWindowResized < 3) && settings.doubleBuffering){
-				glfwSwapBuffers(windowP);
-			}else{
-				glFlush();
-			}
-		}
-	} else {
-		if(settings.doubleBuffering){
-		    glfwSwapBuffers(windowP);
-		} else {
-			glFlush();
 		}
-	}
-	#else
+		glFlush();
+	}else{
+		ofProfilerScope swapScope("swap");
+	#ifdef TARGET_WIN32
 		if (currentRenderer->getBackgroundAuto() == false){
-			// in accum mode resizing a window is BAD, so we clear on resize events.
+			// on a PC resizing a window with this method of accumulation (essentially single buffering)
+			// is BAD, so we clear on resize events.
 			if (nFramesSinceWindowResized < 3){
 				currentRenderer->clear();
+			} else {
+				if ( (events().getFrameNum() < 3 || nFramesSinceWindowResized < 3) && settings.doubleBuffering){
+					glfwSwapBuffers(windowP);
+				}else{
+					glFlush();
+				}
+			}
+		} else {
+			if(settings.doubleBuffering){
+			    glfwSwapBuffers(windowP);
+			} else {
+				glFlush();
 			}
 		}
-		if(settings.doubleBuffering){
-		    glfwSwapBuffers(windowP);
-		} else{
-			glFlush();
-		}
+	#else
+			if (currentRenderer->getBackgroundAuto() == false){
+				// in accum mode resizing a window is BAD, so we clear on resize events.
+				if (nFramesSinceWindowResized < 3){
+					currentRenderer->clear();
+				}
+			}
+			if(settings.doubleBuffering){
+			    glfwSwapBuffers(windowP);
+			} else{
+				glFlush();
+			}
 	#endif
+	}
 
 	currentRenderer->finishRender();
 
@@ -1516,13 +1555,33 @@ void ofAppGLFWWindow::exit_cb(GLFWwindow* windowP_){
 
 //------------------------------------------------------------
 void ofAppGLFWWindow::setVerticalSync(bool bVerticalSync){
+	this->bVerticalSync = bVerticalSync;
 	if(bVerticalSync){
-		glfwSwapInterval( 1);
+		// a negative interval swaps late frames without waiting
+		if(settings.adaptiveVerticalSync && isAdaptiveVerticalSyncSupported()){
+			glfwSwapInterval(-1);
+		}else{
+			glfwSwapInterval( 1);
+		}
 	}else{
 		glfwSwapInterval(0);
 	}
 }
 
+//------------------------------------------------------------
+void ofAppGLFWWindow::setAdaptiveVerticalSync(bool adaptive){
+	settings.adaptiveVerticalSync = adaptive;
+	if(adaptive && !isAdaptiveVerticalSyncSupported()){
+		ofLogWarning("ofAppGLFWWindow") << "setAdaptiveVerticalSync(): swap_control_tear not supported, using normal vertical sync";
+	}
+	setVerticalSync(bVerticalSync);
+}
+
+//------------------------------------------------------------
+bool ofAppGLFWWindow::isAdaptiveVerticalSyncSupported(){
+	return glfwExtensionSupported("GLX_EXT_swap_control_tear") || glfwExtensionSupported("WGL_EXT_swap_control_tear");
+}
+
 //------------------------------------------------------------
 void ofAppGLFWWindow::setClipboardString(const string& text) {
     glfwSetClipboardString(ofAppGLFWWindow::windowP, text.c_str());
@@ -1594,6 +1653,48 @@ void ofAppGLFWWindow::makeCurrent(){
 	glfwMakeContextCurrent(windowP);
 }
 
+//------------------------------------------------------------
+void ofAppGLFWWindow::releaseCurrent(){
+	glfwMakeContextCurrent(nullptr);
+}
+
+//------------------------------------------------------------
+shared_ptr<ofBaseGLContext> ofAppGLFWWindow::createSharedContext(){
+	if(!windowP){
+		return nullptr;
+	}
+	// the hints are global, other windows could have changed them since
+	// this one was created
+	glfwDefaultWindowHints();
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	#ifdef TARGET_OPENGLES
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, settings.glesVersion);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
+	#else
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, settings.glVersionMajor);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, settings.glVersionMinor);
+		if((settings.glVersionMajor==3 && settings.glVersionMinor>=2) || settings.glVersionMajor>=4){
+			glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		}
+		if(settings.glVersionMajor>=3){
+			glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+		}
+	#endif
+	GLFWwindow * context = glfwCreateWindow(1, 1, "", nullptr, windowP);
+	if(!context){
+		ofLogError("ofAppGLFWWindow") << "createSharedContext(): couldn't create shared context";
+		return nullptr;
+	}
+	return make_shared<GLFWSharedContext>(context);
+}
+
+//------------------------------------------------------------
+void ofAppGLFWWindow::setDeferSwap(bool defer){
+	bDeferSwap = defer;
+}
+
 #if defined(TARGET_LINUX) && !defined(TARGET_RASPBERRY_PI)
 Display* ofAppGLFWWindow::getX11Display(){
 	return glfwGetX11Display();
@@ -48,6 +48,10 @@ public:
 	bool resizable = true;
 	int monitor = 0;
 	bool multiMonitorFullScreen = false;
+	/// with vertical sync, frames that miss the vertical blank are shown
+	/// right away, tearing, instead of waiting for the next one. Only where
+	/// GLX_EXT_swap_control_tear or WGL_EXT_swap_control_tear are supported
+	bool adaptiveVerticalSync = false;
 	std::shared_ptr<ofAppBaseWindow> shareContextWith;
 };
 
@@ -121,6 +125,9 @@ public:
 	void		disableSetupScreen();
 
 	void		setVerticalSync(bool bSync);
+	/// \brief See ofGLFWWindowSettings::adaptiveVerticalSync
+	void		setAdaptiveVerticalSync(bool adaptive);
+	bool		isAdaptiveVerticalSyncSupported();
 
     void        setClipboardString(const std::string& text);
     std::string      getClipboardString();
@@ -128,6 +135,11 @@ public:
     int         getPixelScreenCoordScale();
 
     void 		makeCurrent();
+	void		releaseCurrent();
+	/// \brief A hidden window sharing this window's context, it has to be
+	/// destroyed from the main thread like any GLFW window
+	std::shared_ptr<ofBaseGLContext> createSharedContext();
+	void		setDeferSwap(bool defer);
 	void swapBuffers();
 	void startRender();
 	void finishRender();
@@ -225,6 +237,8 @@ private:
 	ofOrientation orientation;
 
 	bool iconSet;
+	bool bVerticalSync;
+	bool bDeferSwap;
 
     #ifdef TARGET_WIN32
     LONG lExStyle, lStyle;
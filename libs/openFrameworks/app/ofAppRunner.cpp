@@ -16,6 +16,7 @@
 #include "ofGLRenderer.h"
 #include "ofGLProgrammableRenderer.h"
 #include "ofTrueTypeFont.h"
+#include "ofCommandBuffer.h"
 
 #include "ofURLFileLoader.h"
 
@@ -301,6 +302,10 @@ void ofSetEscapeQuitsApp(bool bQuitOnEsc){
 
 //--------------------------------------
 shared_ptr<ofBaseRenderer> & ofGetCurrentRenderer(){
+	auto recording = of::priv::getRecordingRenderer();
+	if(recording){
+		return *recording;
+	}
 	return mainLoop()->getCurrentWindow()->renderer();
 }
 
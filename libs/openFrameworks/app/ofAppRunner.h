@@ -61,6 +61,15 @@ float 		ofGetFrameRate();
 float 		ofGetTargetFrameRate();
 uint64_t	ofGetFrameNum();
 void 		ofSetFrameRate(int targetRate);
+/// \brief Spin the last spinThresholdNanos of each frame wait for precise
+/// frame times, and skip or catch up frames that started late, see
+/// ofCoreEvents::setFramePacing()
+void		ofSetFramePacing(uint64_t spinThresholdNanos, bool skipLateFrames = true);
+/// \brief Notify update every stepNanos instead of once per frame, see
+/// ofCoreEvents::setFixedTimestep()
+void		ofSetFixedTimestep(uint64_t stepNanos, int maxStepsPerFrame = 8);
+/// \brief Fraction of a fixed step elapsed since the last update
+float		ofGetFixedTimestepAlpha();
 double		ofGetLastFrameTime();
 void		ofSetTimeModeSystem();
 uint64_t	ofGetFixedStepForFps(double fps);
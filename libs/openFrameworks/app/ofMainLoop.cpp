@@ -8,6 +8,12 @@
 #include <ofMainLoop.h>
 #include "ofWindowSettings.h"
 #include "ofConstants.h"
+#include "ofTaskPool.h"
+#include "ofCommandBuffer.h"
+#include "ofProfiler.h"
+#include "ofAllocationTracker.h"
+#include "ofRenderStats.h"
+#include "ofMetrics.h"
 
 //========================================================================
 // default windowing
@@ -27,10 +33,75 @@
 	#include "ofAppGLFWWindow.h"
 #endif
 
+#include <thread>
+#include <condition_variable>
+
 using namespace std;
 
+// swaps a window whenever the main loop asks, so the waits for the vertical
+// sync of every window overlap
+class ofMainLoop::SwapThread{
+public:
+	SwapThread(ofAppBaseWindow * window)
+	:window(window)
+	,bPending(false)
+	,bQuit(false){
+		thread = std::thread([this]{
+			run();
+		});
+	}
+
+	~SwapThread(){
+		{
+			lock_guard<mutex> lock(threadMutex);
+			bQuit = true;
+		}
+		condition.notify_all();
+		thread.join();
+	}
+
+	void swap(){
+		{
+			lock_guard<mutex> lock(threadMutex);
+			bPending = true;
+		}
+		condition.notify_all();
+	}
+
+	void waitSwapped(){
+		unique_lock<mutex> lock(threadMutex);
+		condition.wait(lock, [this]{ return !bPending; });
+	}
+
+private:
+	void run(){
+		unique_lock<mutex> lock(threadMutex);
+		while(true){
+			condition.wait(lock, [this]{ return bPending || bQuit; });
+			if(bQuit){
+				return;
+			}
+			lock.unlock();
+			window->makeCurrent();
+			window->swapBuffers();
+			window->releaseCurrent();
+			lock.lock();
+			bPending = false;
+			condition.notify_all();
+		}
+	}
+
+	ofAppBaseWindow * window;
+	std::thread thread;
+	mutex threadMutex;
+	condition_variable condition;
+	bool bPending;
+	bool bQuit;
+};
+
 ofMainLoop::ofMainLoop()
-:bShouldClose(false)
+:swapMode(OF_SWAP_EACH_WINDOW)
+,bShouldClose(false)
 ,status(0)
 ,allowMultiWindow(true)
 ,escapeQuits(true){
@@ -131,22 +202,96 @@ int ofMainLoop::loop(){
 
 void ofMainLoop::loopOnce(){
 	if(bShouldClose) return;
+	ofGetProfiler().newFrame();
+	ofGetAllocationTracker().newFrame();
+	ofResetRenderStats();
+	ofGetMetrics().update();
+	{
+		OF_PROFILE_SCOPE("tasks");
+		// continuations of ofTaskPool tasks run before update() so
+		// their results are visible for the whole frame
+		ofTaskPool::processMainThreadTasks();
+		// and so do events notified from other threads and queued for the
+		// main thread
+		of::priv::deliverDeferredNotifications();
+		// the scene parts recorded by other threads are swapped in once per
+		// frame so all windows draw the same ones
+		ofCommandBuffer::processSubmitted();
+	}
+	vector<shared_ptr<ofAppBaseWindow>> drawnWindows;
 	for(auto i = windowsApps.begin(); !windowsApps.empty() && i != windowsApps.end();){
 		if(i->first->getWindowShouldClose()){
 			i->first->close();
+			swapThreads.erase(i->first.get());
 			windowsApps.erase(i++); ///< i now points at the window after the one which was just erased
 		}else{
 			currentWindow = i->first;
 			i->first->makeCurrent();
-			i->first->update();
-			i->first->draw();
+			{
+				OF_PROFILE_SCOPE("update");
+				i->first->update();
+			}
+			{
+				OF_PROFILE_SCOPE("draw");
+				i->first->draw();
+			}
+			if(swapMode != OF_SWAP_EACH_WINDOW){
+				drawnWindows.push_back(i->first);
+			}
 			i++; ///< continue to next window
 		}
 	}
+	if(!drawnWindows.empty()){
+		swapWindows(drawnWindows);
+	}
 	loopEvent.notify(this);
 }
 
+void ofMainLoop::swapWindows(const vector<shared_ptr<ofAppBaseWindow>> & windows){
+	OF_PROFILE_SCOPE("swap");
+	if(swapMode == OF_SWAP_BATCHED){
+		for(auto & window: windows){
+			window->makeCurrent();
+			window->swapBuffers();
+		}
+		return;
+	}
+
+	// a context can only be current in one thread, the swap threads take
+	// them and give them back once swapped
+	windows.back()->releaseCurrent();
+	for(auto & window: windows){
+		auto & swapThread = swapThreads[window.get()];
+		if(!swapThread){
+			swapThread.reset(new SwapThread(window.get()));
+		}
+		swapThread->swap();
+	}
+	for(auto & window: windows){
+		swapThreads[window.get()]->waitSwapped();
+	}
+	auto current = getCurrentWindow();
+	if(current){
+		current->makeCurrent();
+	}
+}
+
+void ofMainLoop::setSwapMode(ofWindowSwapMode mode){
+	swapMode = mode;
+	for(auto & windowApp: windowsApps){
+		windowApp.first->setDeferSwap(swapMode != OF_SWAP_EACH_WINDOW);
+	}
+	if(swapMode != OF_SWAP_PARALLEL){
+		swapThreads.clear();
+	}
+}
+
+ofWindowSwapMode ofMainLoop::getSwapMode() const{
+	return swapMode;
+}
+
 void ofMainLoop::pollEvents(){
+	OF_PROFILE_SCOPE("events");
 	if(windowPollEvents){
 		windowPollEvents();
 	}
@@ -5,6 +5,20 @@
 #include "ofBaseApp.h"
 #include "ofEvents.h"
 
+/// \brief When ofMainLoop presents the frames of its windows
+enum ofWindowSwapMode{
+	/// every window swaps right after it's drawn, with vertical sync the
+	/// frame time is the sum of the wait of every window
+	OF_SWAP_EACH_WINDOW,
+	/// every window is drawn and then they are swapped one after another,
+	/// usually with vertical sync enabled in only one of them
+	OF_SWAP_BATCHED,
+	/// every window is drawn and then they are swapped at the same time,
+	/// each from its own thread, so the vertical sync of every window is
+	/// waited for in parallel
+	OF_SWAP_PARALLEL,
+};
+
 class ofMainLoop {
 public:
 	ofMainLoop();
@@ -24,6 +38,7 @@ public:
 		    windowsApps.clear();
 		}
 		windowsApps[window] = std::shared_ptr<ofBaseApp>();
+		window->setDeferSwap(swapMode != OF_SWAP_EACH_WINDOW);
 		currentWindow = window;
 		ofAddListener(window->events().keyPressed,this,&ofMainLoop::keyPressed);
 	}
@@ -41,10 +56,27 @@ public:
 	std::shared_ptr<ofBaseApp> getCurrentApp();
 	void setEscapeQuitsLoop(bool quits);
 
+	/// \brief How the windows present their frames, OF_SWAP_EACH_WINDOW
+	/// by default.
+	///
+	/// With several windows, like one per projector, swapping each window
+	/// right after drawing it waits for the vertical sync of every window
+	/// in turn, with 6 outputs at 60Hz the app runs at 10fps. Deferring the
+	/// swaps until all the windows are drawn and doing them in parallel
+	/// keeps every output at the refresh rate. Create the windows sharing
+	/// the context of the first one (ofGLFWWindowSettings::shareContextWith)
+	/// to load textures, shaders and fbos once for all of them.
+	void setSwapMode(ofWindowSwapMode mode);
+	ofWindowSwapMode getSwapMode() const;
+
 	ofEvent<void> exitEvent;
 	ofEvent<void> loopEvent;
 private:
 	void keyPressed(ofKeyEventArgs & key);
+	void swapWindows(const std::vector<std::shared_ptr<ofAppBaseWindow>> & windows);
+	class SwapThread;
+	std::map<ofAppBaseWindow*,std::unique_ptr<SwapThread>> swapThreads;
+	ofWindowSwapMode swapMode;
 	std::map<std::shared_ptr<ofAppBaseWindow>,std::shared_ptr<ofBaseApp> > windowsApps;
 	bool bShouldClose;
 	std::weak_ptr<ofAppBaseWindow> currentWindow;
@@ -46,10 +46,25 @@
 
 #include "ofArduino.h"
 #include "ofUtils.h"
+#include <iterator>
 
 using namespace std;
 
- // TODO thread it?
+// adds a value to the front of a history, reusing the oldest node once the
+// history is full instead of allocating a new one for every sample
+static void pushHistory(list<int> & history, int value, int length) {
+	if (!history.empty() && (int)history.size() >= length) {
+		history.splice(history.begin(), history, std::prev(history.end()));
+		history.front() = value;
+	}
+	else {
+		history.push_front(value);
+	}
+	while ((int)history.size() > length) {
+		history.pop_back();
+	}
+}
+
  // TODO throw event or exception if the serial port goes down...
  //---------------------------------------------------------------------------
 ofArduino::ofArduino() {
@@ -97,6 +112,8 @@ ofArduino::ofArduino() {
 	_firmwareName = "Unknown";
 
 	bUseDelay = true;
+	bUseReadThread = false;
+	_receiveTime = 0;
 }
 
 ofArduino::~ofArduino() {
@@ -153,6 +170,9 @@ bool ofArduino::connect(const std::string & device, int baud) {
 	connectTime = ofGetElapsedTimef();
 	_initialized = false;
 	connected = _port.setup(device.c_str(), baud);
+	if (connected && bUseReadThread) {
+		_port.startReadThread();
+	}
 	sendFirmwareVersionRequest();
 	return connected;
 }
@@ -173,6 +193,22 @@ void ofArduino::setUseDelay(bool bDelay) {
 	bUseDelay = bDelay;
 }
 
+void ofArduino::setUseReadThread(bool useThread) {
+	bUseReadThread = useThread;
+	if (_port.isInitialized()) {
+		if (useThread) {
+			_port.startReadThread();
+		}
+		else {
+			_port.stopReadThread();
+		}
+	}
+}
+
+uint64_t ofArduino::getReceiveTime() const {
+	return _receiveTime;
+}
+
 void ofArduino::setDigitalHistoryLength(int length) {
 	if (length >= 2) {
 		_digitalHistoryLength = length;
@@ -202,14 +238,16 @@ void ofArduino::disconnect() {
 }
 
 void ofArduino::update() {
-	vector <unsigned char> bytesToProcess;
 	int bytesToRead = _port.available();
 	if (bytesToRead > 0) {
-		bytesToProcess.resize(bytesToRead);
+		if ((int)_bytesToProcess.size() < bytesToRead) {
+			_bytesToProcess.resize(bytesToRead);
+		}
+		_receiveTime = _port.getReceiveTime();
 		//its possible we dont get all the bytes
-		int bytesRead = _port.readBytes(&bytesToProcess[0], bytesToRead);
+		int bytesRead = _port.readBytes(&_bytesToProcess[0], bytesToRead);
 		for (int i = 0; i < bytesRead; i++) {
-			processData((char)(bytesToProcess[i]));
+			processData((char)(_bytesToProcess[i]));
 		}
 	}
 }
@@ -583,10 +621,7 @@ void ofArduino::processData(unsigned char inputData) {
 					if (_analogHistory[_multiByteChannel].size() > 0) {
 						int previous = _analogHistory[_multiByteChannel].front();
 
-						_analogHistory[_multiByteChannel].push_front((_storedInputData[0] << 7) | _storedInputData[1]);
-						if ((int)_analogHistory[_multiByteChannel].size() > _analogHistoryLength) {
-							_analogHistory[_multiByteChannel].pop_back();
-						}
+						pushHistory(_analogHistory[_multiByteChannel], (_storedInputData[0] << 7) | _storedInputData[1], _analogHistoryLength);
 
 						// trigger an event if the pin has changed value
 						if (_analogHistory[_multiByteChannel].front() != previous) {
@@ -594,10 +629,7 @@ void ofArduino::processData(unsigned char inputData) {
 						}
 					}
 					else {
-						_analogHistory[_multiByteChannel].push_front((_storedInputData[0] << 7) | _storedInputData[1]);
-						if ((int)_analogHistory[_multiByteChannel].size() > _analogHistoryLength) {
-							_analogHistory[_multiByteChannel].pop_back();
-						}
+						pushHistory(_analogHistory[_multiByteChannel], (_storedInputData[0] << 7) | _storedInputData[1], _analogHistoryLength);
 					}
 				}
 				break;
@@ -1024,10 +1056,7 @@ void ofArduino::processDigitalPort(int port, unsigned char value) {
 			else previous = 0;
 
 			mask = 1 << i;
-			_digitalHistory[pin].push_front((value & mask) >> i);
-
-			if ((int)_digitalHistory[pin].size() > _digitalHistoryLength)
-				_digitalHistory[pin].pop_back();
+			pushHistory(_digitalHistory[pin], (value & mask) >> i, _digitalHistoryLength);
 
 			// trigger an event if the pin has changed value
 			if (_digitalHistory[pin].front() != previous) {
@@ -306,6 +306,21 @@ public:
 	/// \brief Polls data from the serial port, this has to be called periodically
 	void update();
 
+	/// \brief Reads the serial port from a background thread, see
+	/// ofSerial::startReadThread()
+	///
+	/// The Firmata messages are still parsed and their events notified
+	/// in update(), but the data is taken from the port and timestamped as
+	/// soon as it arrives, so getReceiveTime() tells how long ago the data
+	/// processed by update() was sent, independently of the frame rate.
+	/// Can be called before or after connect().
+	void setUseReadThread(bool useThread);
+
+	/// \brief Time at which the data processed in the last update() started
+	/// arriving, in microseconds as ofGetElapsedTimeMicros(). Only
+	/// available with setUseReadThread(true), 0 otherwise.
+	uint64_t getReceiveTime() const;
+
 	/// \}
 	/// \name Setup
 	/// \{
@@ -776,6 +791,9 @@ private:
 	// whether pin reporting is enabled / disabled
 
 	bool bUseDelay;
+	bool bUseReadThread; ///< \brief Read the serial port from a thread, see setUseReadThread().
+	uint64_t _receiveTime; ///< \brief Time the data of the last update() was received.
+	std::vector <unsigned char> _bytesToProcess; ///< \brief Read buffer reused by update().
 
 	mutable bool connected; ///< \brief This yields true if a serial connection to Arduino exists.
 
@@ -4,6 +4,7 @@
 
 #if defined( TARGET_OSX ) || defined( TARGET_LINUX )
 	#include <sys/ioctl.h>
+	#include <poll.h>
 	#include <getopt.h>
 	#include <dirent.h>
 #endif
@@ -13,9 +14,98 @@
 #include <errno.h>
 #include <ctype.h>
 #include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
+//----------------------------------------------------------------
+// received bytes waiting to be read, in a ring so the read thread never
+// allocates, with the time of arrival of each chunk
+struct ofSerial::ReadThread{
+	static const size_t maxChunks = 256;
+
+	struct Chunk{
+		size_t size;
+		uint64_t time;
+	};
+
+	ReadThread(size_t bufferSize)
+	:buffer(std::max<size_t>(bufferSize, 1))
+	,chunks(maxChunks){}
+
+	void push(const char * data, size_t length, uint64_t time){
+		std::unique_lock<std::mutex> lock(mutex);
+		if(length > buffer.size()){
+			data += length - buffer.size();
+			length = buffer.size();
+		}
+		size_t overflow = count + length > buffer.size() ? count + length - buffer.size() : 0;
+		if(overflow > 0){
+			if(!overflowed){
+				ofLogWarning("ofSerial") << "read thread buffer full, dropping the oldest bytes";
+				overflowed = true;
+			}
+			pop(nullptr, overflow);
+		}
+		size_t end = (start + count) % buffer.size();
+		size_t first = std::min(length, buffer.size() - end);
+		memcpy(buffer.data() + end, data, first);
+		memcpy(buffer.data(), data + first, length - first);
+		count += length;
+
+		if(numChunks == maxChunks){
+			chunks[(chunkStart + numChunks - 1) % maxChunks].size += length;
+		}else{
+			chunks[(chunkStart + numChunks) % maxChunks] = {length, time};
+			numChunks++;
+		}
+		lastTime = time;
+	}
+
+	// doesn't lock, data can be null to drop the bytes
+	size_t pop(char * data, size_t length){
+		length = std::min(length, count);
+		if(data){
+			size_t first = std::min(length, buffer.size() - start);
+			memcpy(data, buffer.data() + start, first);
+			memcpy(data + first, buffer.data(), length - first);
+		}
+		start = (start + length) % buffer.size();
+		count -= length;
+
+		size_t remaining = length;
+		while(remaining > 0 && numChunks > 0){
+			auto & chunk = chunks[chunkStart];
+			size_t consumed = std::min(remaining, chunk.size);
+			chunk.size -= consumed;
+			remaining -= consumed;
+			if(chunk.size == 0){
+				chunkStart = (chunkStart + 1) % maxChunks;
+				numChunks--;
+			}
+		}
+		if(count * 2 < buffer.size()){
+			overflowed = false;
+		}
+		return length;
+	}
+
+	std::thread thread;
+	std::atomic<bool> running{true};
+	mutable std::mutex mutex;
+	std::vector<char> buffer;
+	size_t start = 0;
+	size_t count = 0;
+	std::vector<Chunk> chunks;
+	size_t chunkStart = 0;
+	size_t numChunks = 0;
+	uint64_t lastTime = 0;
+	bool overflowed = false;
+};
+
 #ifdef TARGET_LINUX
 	#include <linux/serial.h>
 #endif
@@ -239,6 +329,7 @@ void ofSerial::enumerateDevices(){
 
 //----------------------------------------------------------------
 void ofSerial::close(){
+	stopReadThread();
 
 	#ifdef TARGET_WIN32
 
@@ -520,6 +611,17 @@ long ofSerial::readBytes(char * buffer, size_t length){
 		return OF_SERIAL_ERROR;
 	}
 
+	if(readThread){
+		std::unique_lock<std::mutex> lock(readThread->mutex);
+		auto nRead = readThread->pop(buffer, length);
+		return nRead > 0 ? long(nRead) : OF_SERIAL_NO_DATA;
+	}
+
+	return readPort(buffer, length);
+}
+
+//----------------------------------------------------------------
+long ofSerial::readPort(char * buffer, size_t length){
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
 
 		auto nRead = read(fd, buffer, length);
@@ -577,6 +679,14 @@ int ofSerial::readByte(){
 
 	unsigned char tmpByte = 0;
 
+	if(readThread){
+		std::unique_lock<std::mutex> lock(readThread->mutex);
+		if(readThread->pop(reinterpret_cast<char*>(&tmpByte), 1) == 0){
+			return OF_SERIAL_NO_DATA;
+		}
+		return tmpByte;
+	}
+
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
 
 		int nRead = read(fd, &tmpByte, 1);
@@ -622,6 +732,11 @@ void ofSerial::flush(bool flushIn, bool flushOut){
 		return;
 	}
 
+	if(readThread && flushIn){
+		std::unique_lock<std::mutex> lock(readThread->mutex);
+		readThread->pop(nullptr, readThread->count);
+	}
+
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
 		int flushType = 0;
 		if(flushIn && flushOut) flushType = TCIOFLUSH;
@@ -663,6 +778,11 @@ int ofSerial::available(){
 		return OF_SERIAL_ERROR;
 	}
 
+	if(readThread){
+		std::unique_lock<std::mutex> lock(readThread->mutex);
+		return int(readThread->count);
+	}
+
 	int numBytes = 0;
 
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
@@ -693,3 +813,129 @@ int ofSerial::available(){
 bool ofSerial::isInitialized() const{
 	return bInited;
 }
+
+//----------------------------------------------------------------
+bool ofSerial::startReadThread(size_t bufferSize){
+	if(!bInited){
+		ofLogError("ofSerial") << "startReadThread(): serial not inited";
+		return false;
+	}
+	if(readThread){
+		return true;
+	}
+
+	readThread.reset(new ReadThread(bufferSize));
+	auto state = readThread.get();
+
+	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
+
+		int port = fd;
+		state->thread = std::thread([state, port]{
+			char data[1024];
+			while(state->running){
+				pollfd pfd;
+				pfd.fd = port;
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+				int ready = poll(&pfd, 1, 100);
+				if(ready < 0 && errno != EINTR){
+					ofLogError("ofSerial") << "read thread: couldn't wait for data: " << errno << " " << strerror(errno);
+					break;
+				}
+				if(ready <= 0){
+					continue;
+				}
+				if(pfd.revents & (POLLERR | POLLHUP | POLLNVAL)){
+					ofLogError("ofSerial") << "read thread: port closed or disconnected";
+					break;
+				}
+				auto nRead = read(port, data, sizeof(data));
+				auto time = ofGetElapsedTimeMicros();
+				if(nRead < 0){
+					if(errno == EAGAIN || errno == EINTR){
+						continue;
+					}
+					ofLogError("ofSerial") << "read thread: couldn't read from port: " << errno << " " << strerror(errno);
+					break;
+				}
+				if(nRead > 0){
+					state->push(data, nRead, time);
+				}
+			}
+			state->running = false;
+		});
+
+	#elif defined( TARGET_WIN32 )
+
+		// return as soon as something arrives or after 1ms, the handle isn't
+		// overlapped so a longer wait would block writes for as long
+		COMMTIMEOUTS tOut;
+		GetCommTimeouts(hComm, &tOut);
+		tOut.ReadIntervalTimeout = MAXDWORD;
+		tOut.ReadTotalTimeoutMultiplier = MAXDWORD;
+		tOut.ReadTotalTimeoutConstant = 1;
+		SetCommTimeouts(hComm, &tOut);
+
+		HANDLE port = hComm;
+		state->thread = std::thread([state, port]{
+			char data[1024];
+			while(state->running){
+				DWORD nRead = 0;
+				if(!ReadFile(port, data, sizeof(data), &nRead, 0)){
+					ofLogError("ofSerial") << "read thread: couldn't read from port";
+					break;
+				}
+				if(nRead > 0){
+					state->push(data, nRead, ofGetElapsedTimeMicros());
+				}
+			}
+			state->running = false;
+		});
+
+	#else
+
+		ofLogError("ofSerial") << "startReadThread(): not implemented in this platform";
+		readThread.reset();
+		return false;
+
+	#endif
+
+	return true;
+}
+
+//----------------------------------------------------------------
+void ofSerial::stopReadThread(){
+	if(!readThread){
+		return;
+	}
+	readThread->running = false;
+	if(readThread->thread.joinable()){
+		readThread->thread.join();
+	}
+
+	#ifdef TARGET_WIN32
+		// back to returning immediately, as set in setup
+		COMMTIMEOUTS tOut;
+		GetCommTimeouts(hComm, &tOut);
+		tOut.ReadIntervalTimeout = MAXDWORD;
+		tOut.ReadTotalTimeoutMultiplier = 0;
+		tOut.ReadTotalTimeoutConstant = 0;
+		SetCommTimeouts(hComm, &tOut);
+	#endif
+
+	readThread.reset();
+}
+
+//----------------------------------------------------------------
+bool ofSerial::isReadThreadRunning() const{
+	return readThread && readThread->running;
+}
+
+//----------------------------------------------------------------
+uint64_t ofSerial::getReceiveTime() const{
+	if(!readThread){
+		return 0;
+	}
+	std::unique_lock<std::mutex> lock(readThread->mutex);
+	return readThread->numChunks > 0 ? readThread->chunks[readThread->chunkStart].time : readThread->lastTime;
+}
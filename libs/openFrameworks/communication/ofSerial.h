@@ -1,6 +1,7 @@
 #pragma once
 
 #include <climits>
+#include <memory>
 #include "ofConstants.h"
 #include "ofTypes.h"
 #include "ofFileUtils.h"
@@ -262,6 +263,50 @@ public:
 	void drain();
 
 	/// \}
+	/// \name Background Reading
+	/// \{
+
+	/// \brief Starts a thread that reads from the port as soon as data
+	/// arrives, instead of when available() or readBytes() are called.
+	///
+	/// The thread blocks on the port and moves everything received to a
+	/// buffer of bufferSize bytes, that available(), readBytes() and
+	/// readByte() then read from. Data isn't lost when the app is slow to
+	/// read it, and every chunk is timestamped on arrival, see
+	/// getReceiveTime(). If the buffer fills up the oldest bytes are
+	/// dropped.
+	///
+	/// ~~~~{.cpp}
+	/// serial.setup(0, 115200);
+	/// serial.startReadThread();
+	///
+	/// // in update
+	/// while(serial.available() > 0){
+	///     uint64_t time = serial.getReceiveTime();
+	///     int byte = serial.readByte();
+	///     ...
+	/// }
+	/// ~~~~
+	///
+	/// On Windows the port isn't opened for overlapped IO, so the thread
+	/// waits for at most 1ms at a time and writes can be delayed by as much.
+	/// close() stops the thread.
+	/// \returns false if the port isn't open
+	bool startReadThread(size_t bufferSize = 65536);
+
+	/// \brief Stops the read thread, bytes received and not read yet are
+	/// dropped
+	void stopReadThread();
+
+	/// \brief false once stopped or if the thread stopped on a read error
+	bool isReadThreadRunning() const;
+
+	/// \brief Time at which the next byte to read was received, in
+	/// microseconds as ofGetElapsedTimeMicros(), or of the last byte
+	/// received if there's nothing left to read. 0 without a read thread.
+	uint64_t getReceiveTime() const;
+
+	/// \}
 
 protected:
 	/// \brief Enumerate all devices attached to a serial port.
@@ -277,6 +322,12 @@ protected:
 	bool bHaveEnumeratedDevices;  ///\< \brief Indicate having enumerated devices (serial ports) available.
 	bool bInited;  ///\< \brief Indicate the successful initialization of the serial connection.
 
+	struct ReadThread;
+	std::unique_ptr<ReadThread> readThread;  ///< \brief State of the background read thread, see startReadThread().
+
+	/// \brief Reads directly from the port, bypassing the read thread
+	long readPort(char * buffer, size_t length);
+
 #ifdef TARGET_WIN32
 
 	/// \brief Enumerate all serial ports on Microsoft Windows.
@@ -0,0 +1,747 @@
+#include "ofSharedFrames.h"
+#include "ofSharedTexture.h"
+#include "ofTexture.h"
+#include "ofGLUtils.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include <cstring>
+#include <cerrno>
+#include <random>
+
+#ifndef TARGET_OPENGLES
+#include "ofPixelReadback.h"
+#endif
+
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstddef>
+#endif
+
+using namespace std;
+
+namespace{
+	const uint32_t sharedFramesMagic = 0x6f665346; // ofSF
+	const uint32_t sharedFramesVersion = 1;
+	const std::size_t maxSlots = 8;
+	const std::size_t slotAlignment = 64;
+
+	enum FrameType: uint32_t{
+		FramePixels = 1,
+		FrameBuffer,
+		FrameTexture,
+	};
+
+	// the atomics are shared by different processes, that only works if
+	// they are lock free which they are on every platform OF supports
+	struct Slot{
+		std::atomic<uint32_t> readers;
+		// 0 while the sender is writing the slot
+		std::atomic<uint64_t> frameNum;
+		uint32_t type;
+		uint32_t width;
+		uint32_t height;
+		int32_t pixelFormat;
+		uint64_t size;
+		ofSharedTextureHandle texture;
+	};
+
+	struct Header{
+		uint32_t magic;
+		uint32_t version;
+		// changes every time a sender creates the memory
+		uint64_t instance;
+		uint32_t numSlots;
+		uint64_t slotBytes;
+		// frame number << 8 | slot of the last frame sent, 0 before the first
+		std::atomic<uint64_t> latest;
+		// changes every time the sender reallocates its textures
+		std::atomic<uint32_t> textureGeneration;
+		Slot slots[maxSlots];
+	};
+
+	std::size_t alignSlot(std::size_t size){
+		return (size + slotAlignment - 1) / slotAlignment * slotAlignment;
+	}
+
+	Header * getHeader(ofSharedMemory & memory){
+		return static_cast<Header*>(memory.getData());
+	}
+
+	unsigned char * getSlotData(ofSharedMemory & memory, std::size_t slot){
+		return static_cast<unsigned char*>(memory.getData()) + alignSlot(sizeof(Header)) + slot * getHeader(memory)->slotBytes;
+	}
+
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	// abstract unix sockets don't leave files behind
+	socklen_t getSocketAddress(const string & name, sockaddr_un & address){
+		string path = "of_shared_frames_" + name;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		path = path.substr(0, sizeof(address.sun_path) - 1);
+		memcpy(address.sun_path + 1, path.data(), path.size());
+		return socklen_t(offsetof(sockaddr_un, sun_path) + 1 + path.size());
+	}
+#endif
+}
+
+//--------------------------------------------------
+ofSharedFrameSender::ofSharedFrameSender()
+:numSlots(0)
+,slotBytes(0)
+,frameNum(0)
+,numDropped(0)
+,frameSlot(-1)
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+,listenSocket(-1)
+,serving(false)
+,textureGeneration(0)
+#endif
+{
+}
+
+//--------------------------------------------------
+ofSharedFrameSender::~ofSharedFrameSender(){
+	close();
+}
+
+//--------------------------------------------------
+bool ofSharedFrameSender::setup(const string & name, std::size_t maxFrameBytes, std::size_t numSlots){
+	close();
+	this->numSlots = std::max<std::size_t>(2, std::min(numSlots, maxSlots));
+	slotBytes = alignSlot(maxFrameBytes);
+	if(!memory.create(name, alignSlot(sizeof(Header)) + this->numSlots * slotBytes)){
+		return false;
+	}
+	auto header = getHeader(memory);
+	header->version = sharedFramesVersion;
+	header->instance = (uint64_t(std::random_device()()) << 32) ^ ofGetSystemTimeMicros();
+	header->numSlots = this->numSlots;
+	header->slotBytes = slotBytes;
+	// the magic goes last so receivers never see a half written header
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = sharedFramesMagic;
+	frameNum = 0;
+	numDropped = 0;
+	return true;
+}
+
+//--------------------------------------------------
+int ofSharedFrameSender::claimSlot(){
+	auto header = getHeader(memory);
+	auto latest = header->latest.load();
+	int latestSlot = latest ? int(latest & 0xFF) : -1;
+	int slots = int(numSlots);
+	for(int i = 1; i <= slots; i++){
+		int slot = (latestSlot + i + slots) % slots;
+		if(slot == latestSlot){
+			continue;
+		}
+		auto & s = header->slots[slot];
+		if(s.readers.load() != 0){
+			continue;
+		}
+		auto previous = s.frameNum.exchange(0);
+		// a receiver could have started reading it between both checks
+		if(s.readers.load() == 0){
+			return slot;
+		}
+		s.frameNum.store(previous);
+	}
+	numDropped++;
+	return -1;
+}
+
+//--------------------------------------------------
+void ofSharedFrameSender::publish(int slot){
+	auto header = getHeader(memory);
+	frameNum++;
+	header->slots[slot].frameNum.store(frameNum);
+	header->latest.store(frameNum << 8 | uint64_t(slot));
+}
+
+//--------------------------------------------------
+bool ofSharedFrameSender::send(const ofPixels & pixels){
+	auto & frame = beginFrame(pixels.getWidth(), pixels.getHeight(), pixels.getPixelFormat());
+	if(!frame.isAllocated()){
+		return false;
+	}
+	memcpy(frame.getData(), pixels.getData(), frame.getTotalBytes());
+	endFrame();
+	return true;
+}
+
+//--------------------------------------------------
+bool ofSharedFrameSender::send(const ofBuffer & buffer){
+	if(!memory.isOpen()){
+		return false;
+	}
+	if(buffer.size() > slotBytes){
+		ofLogWarning("ofSharedFrameSender") << "send(): buffer of " << buffer.size() << " bytes doesn't fit in slots of " << slotBytes;
+		numDropped++;
+		return false;
+	}
+	int slot = claimSlot();
+	if(slot < 0){
+		return false;
+	}
+	memcpy(getSlotData(memory, slot), buffer.getData(), buffer.size());
+	auto & s = getHeader(memory)->slots[slot];
+	s.type = FrameBuffer;
+	s.width = 0;
+	s.height = 0;
+	s.pixelFormat = OF_PIXELS_UNKNOWN;
+	s.size = buffer.size();
+	publish(slot);
+	return true;
+}
+
+//--------------------------------------------------
+bool ofSharedFrameSender::send(const ofTexture & texture){
+	if(!memory.isOpen() || !texture.isAllocated()){
+		return false;
+	}
+	if(ofSharedTexture::isSupported()){
+		return sendTexture(texture);
+	}
+#ifndef TARGET_OPENGLES
+	// the frame read now is sent on a later call, once the GPU is done
+	if(!readback){
+		readback.reset(new ofPixelReadback);
+	}
+	readback->read(texture);
+	if(!readback->isFrameReady()){
+		return false;
+	}
+	ofPixelFormat format = OF_PIXELS_UNKNOWN;
+	if(readback->getFrameBytesPerChannel() == 1){
+		switch(readback->getFrameNumChannels()){
+		case 1: format = OF_PIXELS_GRAY; break;
+		case 3: format = OF_PIXELS_RGB; break;
+		case 4: format = OF_PIXELS_RGBA; break;
+		}
+	}
+	if(format == OF_PIXELS_UNKNOWN){
+		ofLogError("ofSharedFrameSender") << "send(): only textures with 8 bits per channel can be sent as pixels";
+		readback->clear();
+		return false;
+	}
+	bool sent = false;
+	auto data = readback->mapFrame();
+	if(data){
+		auto & frame = beginFrame(readback->getFrameWidth(), readback->getFrameHeight(), format);
+		if(frame.isAllocated()){
+			memcpy(frame.getData(), data, frame.getTotalBytes());
+			endFrame();
+			sent = true;
+		}
+		readback->unmapFrame();
+	}
+	return sent;
+#else
+	texture.readToPixels(readbackPixels);
+	return send(readbackPixels);
+#endif
+}
+
+//--------------------------------------------------
+bool ofSharedFrameSender::sendTexture(const ofTexture & texture){
+	int width = texture.getWidth();
+	int height = texture.getHeight();
+	if(textures.empty() || int(textures[0]->getHandle().width) != width || int(textures[0]->getHandle().height) != height){
+		if(!allocateTextures(width, height)){
+			numDropped++;
+			return false;
+		}
+	}
+	int slot = claimSlot();
+	if(slot < 0){
+		return false;
+	}
+	auto & shared = *textures[slot];
+	shared.lock();
+	bool copied = texture.copyTo(shared.getTexture());
+	shared.unlock();
+	// the receivers read it from other contexts, the copy has to be
+	// submitted before they see the frame
+	glFlush();
+	if(!copied){
+		// the slot stays unpublished and is claimed again by the next frame
+		numDropped++;
+		return false;
+	}
+	auto & s = getHeader(memory)->slots[slot];
+	s.type = FrameTexture;
+	s.width = width;
+	s.height = height;
+	s.pixelFormat = OF_PIXELS_RGBA;
+	s.size = 0;
+	s.texture = shared.getHandle();
+	publish(slot);
+	return true;
+}
+
+//--------------------------------------------------
+bool ofSharedFrameSender::allocateTextures(int width, int height){
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	// the server thread might be sending the old fds
+	std::unique_lock<std::mutex> lock(texturesMutex);
+	textureFds.clear();
+#endif
+	// receivers that imported the old textures keep them alive until they
+	// import the new ones
+	textures.clear();
+	for(std::size_t i = 0; i < numSlots; i++){
+		std::unique_ptr<ofSharedTexture> texture(new ofSharedTexture);
+		if(!texture->allocate(width, height)){
+			textures.clear();
+			return false;
+		}
+		textures.push_back(std::move(texture));
+	}
+	auto header = getHeader(memory);
+	auto generation = header->textureGeneration.load() + 1;
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	for(auto & texture: textures){
+		textureFds.push_back(texture->getFd());
+	}
+	textureGeneration = generation;
+	lock.unlock();
+
+	if(!serving){
+		listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		sockaddr_un address;
+		auto length = getSocketAddress(memory.getName(), address);
+		if(listenSocket == -1 || bind(listenSocket, (sockaddr*)&address, length) == -1 || listen(listenSocket, 4) == -1){
+			ofLogError("ofSharedFrameSender") << "couldn't open the socket to share the textures: " << strerror(errno);
+			if(listenSocket != -1){
+				::close(listenSocket);
+				listenSocket = -1;
+			}
+			lock.lock();
+			textureFds.clear();
+			textures.clear();
+			return false;
+		}
+		serving = true;
+		server = std::thread(&ofSharedFrameSender::serveTextures, this);
+	}
+#endif
+	header->textureGeneration.store(generation);
+	return true;
+}
+
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+//--------------------------------------------------
+void ofSharedFrameSender::serveTextures(){
+	while(serving){
+		pollfd request = {listenSocket, POLLIN, 0};
+		if(poll(&request, 1, 100) <= 0){
+			continue;
+		}
+		int client = accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+		if(client == -1){
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(texturesMutex);
+		uint32_t message[2] = {textureGeneration, uint32_t(textureFds.size())};
+		iovec iov = {message, sizeof(message)};
+		char control[CMSG_SPACE(sizeof(int) * maxSlots)];
+		memset(control, 0, sizeof(control));
+		msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		if(!textureFds.empty()){
+			msg.msg_control = control;
+			msg.msg_controllen = CMSG_SPACE(sizeof(int) * textureFds.size());
+			auto cmsg = CMSG_FIRSTHDR(&msg);
+			cmsg->cmsg_level = SOL_SOCKET;
+			cmsg->cmsg_type = SCM_RIGHTS;
+			cmsg->cmsg_len = CMSG_LEN(sizeof(int) * textureFds.size());
+			memcpy(CMSG_DATA(cmsg), textureFds.data(), sizeof(int) * textureFds.size());
+		}
+		sendmsg(client, &msg, MSG_NOSIGNAL);
+		lock.unlock();
+		::close(client);
+	}
+}
+#endif
+
+//--------------------------------------------------
+ofPixels & ofSharedFrameSender::beginFrame(int width, int height, ofPixelFormat format){
+	framePixels.clear();
+	if(!memory.isOpen()){
+		return framePixels;
+	}
+	if(frameSlot != -1){
+		ofLogWarning("ofSharedFrameSender") << "beginFrame(): called again before endFrame(), the previous frame is lost";
+	}else{
+		auto size = ofPixels::bytesFromPixelFormat(width, height, format);
+		if(size > slotBytes){
+			ofLogWarning("ofSharedFrameSender") << "beginFrame(): frame of " << size << " bytes doesn't fit in slots of " << slotBytes;
+			numDropped++;
+			return framePixels;
+		}
+		frameSlot = claimSlot();
+		if(frameSlot < 0){
+			return framePixels;
+		}
+	}
+	framePixels.setFromExternalPixels(getSlotData(memory, frameSlot), width, height, format);
+	return framePixels;
+}
+
+//--------------------------------------------------
+void ofSharedFrameSender::endFrame(){
+	if(frameSlot < 0 || !framePixels.isAllocated()){
+		ofLogError("ofSharedFrameSender") << "endFrame(): no frame started with beginFrame()";
+		return;
+	}
+	auto & s = getHeader(memory)->slots[frameSlot];
+	s.type = FramePixels;
+	s.width = framePixels.getWidth();
+	s.height = framePixels.getHeight();
+	s.pixelFormat = framePixels.getPixelFormat();
+	s.size = framePixels.getTotalBytes();
+	publish(frameSlot);
+	frameSlot = -1;
+	framePixels.clear();
+}
+
+//--------------------------------------------------
+void ofSharedFrameSender::close(){
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	if(serving){
+		serving = false;
+		server.join();
+		::close(listenSocket);
+		listenSocket = -1;
+	}
+	textureFds.clear();
+	textureGeneration = 0;
+#endif
+	textures.clear();
+	readback.reset();
+	framePixels.clear();
+	frameSlot = -1;
+	memory.close();
+}
+
+//--------------------------------------------------
+bool ofSharedFrameSender::isSetup() const{
+	return memory.isOpen();
+}
+
+//--------------------------------------------------
+uint64_t ofSharedFrameSender::getNumFramesSent() const{
+	return frameNum;
+}
+
+//--------------------------------------------------
+uint64_t ofSharedFrameSender::getNumFramesDropped() const{
+	return numDropped;
+}
+
+//--------------------------------------------------
+ofSharedFrameReceiver::ofSharedFrameReceiver()
+:instance(0)
+,lastLatest(0)
+,lastFrameTime(0)
+,lastConnectTime(0)
+,heldSlot(-1)
+,texturesGeneration(0)
+{
+}
+
+//--------------------------------------------------
+ofSharedFrameReceiver::~ofSharedFrameReceiver(){
+	close();
+}
+
+//--------------------------------------------------
+bool ofSharedFrameReceiver::setup(const string & name){
+	close();
+	this->name = name;
+	return connect();
+}
+
+//--------------------------------------------------
+bool ofSharedFrameReceiver::connect(){
+	lastConnectTime = ofGetElapsedTimeMillis();
+	ofSharedMemory newMemory;
+	if(!newMemory.open(name) || newMemory.size() < sizeof(Header)){
+		return false;
+	}
+	auto header = getHeader(newMemory);
+	if(header->magic != sharedFramesMagic || header->version != sharedFramesVersion){
+		return false;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if(memory.isOpen() && header->instance == instance){
+		return true;
+	}
+	if(header->numSlots > maxSlots || newMemory.size() < alignSlot(sizeof(Header)) + header->numSlots * header->slotBytes){
+		ofLogError("ofSharedFrameReceiver") << "connect(): the shared memory of " << name << " is corrupted";
+		return false;
+	}
+
+	release();
+	textures.clear();
+	texturesGeneration = 0;
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	for(auto fd: textureFds){
+		::close(fd);
+	}
+	textureFds.clear();
+#endif
+	previousMemory = std::move(memory);
+	memory = std::move(newMemory);
+	instance = header->instance;
+	lastLatest = 0;
+	lastFrameTime = lastConnectTime;
+	return true;
+}
+
+//--------------------------------------------------
+int ofSharedFrameReceiver::acquire(){
+	auto now = ofGetElapsedTimeMillis();
+	// no frames for a while, the sender might have been restarted
+	if(now - lastFrameTime > 1000 && now - lastConnectTime > 1000){
+		connect();
+	}
+	if(!memory.isOpen()){
+		return -1;
+	}
+	auto header = getHeader(memory);
+	for(int attempt = 0; attempt < 4; attempt++){
+		auto latest = header->latest.load();
+		if(latest == 0 || latest == lastLatest){
+			return -1;
+		}
+		auto slot = latest & 0xFF;
+		auto frame = latest >> 8;
+		if(slot >= header->numSlots){
+			return -1;
+		}
+		auto & s = header->slots[slot];
+		s.readers++;
+		if(s.frameNum.load() == frame){
+			lastLatest = latest;
+			lastFrameTime = now;
+			previousMemory.close();
+			return int(slot);
+		}
+		// overwritten since it was published, there's a newer one
+		s.readers--;
+	}
+	return -1;
+}
+
+//--------------------------------------------------
+void ofSharedFrameReceiver::release(){
+	if(heldSlot < 0){
+		return;
+	}
+	if(std::size_t(heldSlot) < textures.size() && textures[heldSlot]){
+		textures[heldSlot]->unlock();
+	}
+	if(memory.isOpen()){
+		getHeader(memory)->slots[heldSlot].readers--;
+	}
+	heldSlot = -1;
+}
+
+//--------------------------------------------------
+ofSharedTexture * ofSharedFrameReceiver::getTexture(int slot){
+	auto header = getHeader(memory);
+	auto generation = header->textureGeneration.load();
+	if(generation != texturesGeneration){
+		if(std::size_t(heldSlot) < textures.size() && textures[heldSlot]){
+			textures[heldSlot]->unlock();
+		}
+		textures.clear();
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+		if(!receiveTextureFds(generation)){
+			return nullptr;
+		}
+#endif
+		textures.resize(header->numSlots);
+		texturesGeneration = generation;
+	}
+	auto & texture = textures[slot];
+	if(!texture){
+		int fd = -1;
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+		if(std::size_t(slot) >= textureFds.size()){
+			return nullptr;
+		}
+		fd = textureFds[slot];
+#endif
+		texture.reset(new ofSharedTexture);
+		if(!texture->import(header->slots[slot].texture, fd)){
+			texture.reset();
+			return nullptr;
+		}
+	}
+	return texture.get();
+}
+
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+//--------------------------------------------------
+bool ofSharedFrameReceiver::receiveTextureFds(uint32_t & generation){
+	for(auto fd: textureFds){
+		::close(fd);
+	}
+	textureFds.clear();
+
+	int client = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	sockaddr_un address;
+	auto length = getSocketAddress(name, address);
+	if(client == -1 || ::connect(client, (sockaddr*)&address, length) == -1){
+		ofLogError("ofSharedFrameReceiver") << "couldn't connect to the sender to get its textures: " << strerror(errno);
+		if(client != -1){
+			::close(client);
+		}
+		return false;
+	}
+	uint32_t message[2] = {0, 0};
+	iovec iov = {message, sizeof(message)};
+	char control[CMSG_SPACE(sizeof(int) * maxSlots)];
+	msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	auto received = recvmsg(client, &msg, MSG_CMSG_CLOEXEC);
+	::close(client);
+	for(auto cmsg = CMSG_FIRSTHDR(&msg); received > 0 && cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+		if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS){
+			auto numFds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+			textureFds.resize(numFds);
+			memcpy(textureFds.data(), CMSG_DATA(cmsg), numFds * sizeof(int));
+		}
+	}
+	if(received != sizeof(message) || textureFds.size() != message[1]){
+		ofLogError("ofSharedFrameReceiver") << "couldn't get the textures from the sender";
+		return false;
+	}
+	// the sender might have reallocated them since the generation was read
+	generation = message[0];
+	return true;
+}
+#endif
+
+//--------------------------------------------------
+bool ofSharedFrameReceiver::receive(ofPixels & pixels){
+	int slot = acquire();
+	if(slot < 0){
+		return false;
+	}
+	auto & s = getHeader(memory)->slots[slot];
+	if(s.type == FramePixels){
+		pixels.setFromExternalPixels(getSlotData(memory, slot), s.width, s.height, ofPixelFormat(s.pixelFormat));
+		release();
+		heldSlot = slot;
+		return true;
+	}
+
+	bool received = false;
+	if(s.type == FrameTexture){
+		if(auto texture = getTexture(slot)){
+			texture->lock();
+			texture->getTexture().readToPixels(pixels);
+			texture->unlock();
+			received = true;
+		}
+	}else{
+		ofLogError("ofSharedFrameReceiver") << "receive(): the sender sent a buffer, it can't be received as pixels";
+	}
+	s.readers--;
+	return received;
+}
+
+//--------------------------------------------------
+bool ofSharedFrameReceiver::receive(ofBuffer & buffer){
+	int slot = acquire();
+	if(slot < 0){
+		return false;
+	}
+	auto & s = getHeader(memory)->slots[slot];
+	bool received = false;
+	if(s.type == FrameBuffer || s.type == FramePixels){
+		buffer.set(reinterpret_cast<const char*>(getSlotData(memory, slot)), s.size);
+		received = true;
+	}else{
+		ofLogError("ofSharedFrameReceiver") << "receive(): the sender sent a texture, it can't be received as a buffer";
+	}
+	s.readers--;
+	return received;
+}
+
+//--------------------------------------------------
+bool ofSharedFrameReceiver::receive(ofTexture & texture){
+	int slot = acquire();
+	if(slot < 0){
+		return false;
+	}
+	auto & s = getHeader(memory)->slots[slot];
+	if(s.type == FrameTexture){
+		auto shared = getTexture(slot);
+		if(!shared){
+			s.readers--;
+			return false;
+		}
+		release();
+		shared->lock();
+		// shares the GL texture, no copy
+		texture = shared->getTexture();
+		heldSlot = slot;
+		return true;
+	}
+
+	bool received = false;
+	if(s.type == FramePixels){
+		ofPixels pixels;
+		pixels.setFromExternalPixels(getSlotData(memory, slot), s.width, s.height, ofPixelFormat(s.pixelFormat));
+		if(!texture.isAllocated() || texture.getWidth() != pixels.getWidth() || texture.getHeight() != pixels.getHeight()){
+			texture.allocate(pixels);
+		}
+		texture.loadData(pixels);
+		received = true;
+	}else{
+		ofLogError("ofSharedFrameReceiver") << "receive(): the sender sent a buffer, it can't be received as a texture";
+	}
+	s.readers--;
+	return received;
+}
+
+//--------------------------------------------------
+void ofSharedFrameReceiver::close(){
+	release();
+	textures.clear();
+	texturesGeneration = 0;
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	for(auto fd: textureFds){
+		::close(fd);
+	}
+	textureFds.clear();
+#endif
+	memory.close();
+	previousMemory.close();
+	instance = 0;
+	lastLatest = 0;
+}
+
+//--------------------------------------------------
+bool ofSharedFrameReceiver::isConnected() const{
+	return memory.isOpen();
+}
+
+//--------------------------------------------------
+uint64_t ofSharedFrameReceiver::getFrameNum() const{
+	return lastLatest >> 8;
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofSharedMemory.h"
+#include "ofPixels.h"
+#include "ofFileUtils.h"
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+class ofTexture;
+class ofSharedTexture;
+class ofPixelReadback;
+
+/// \class ofSharedFrameSender
+/// \brief Sends pixels, buffers or textures to other processes without
+/// copying them through sockets or pipes
+///
+/// Frames are written into a ring of slots in an ofSharedMemory and the
+/// receivers read them in place: a receiver always gets the latest frame
+/// and the sender never waits for the receivers, if they are slower they
+/// skip frames.
+///
+/// Textures are sent through a ring of ofSharedTexture when the GL context
+/// can share them, so the frame never leaves the GPU. Otherwise they are
+/// read back asynchronously and sent as pixels.
+///
+/// ~~~~{.cpp}
+/// // ofApp.h
+/// ofSharedFrameSender sender;
+///
+/// // setup
+/// sender.setup("camera", 1920 * 1080 * 4);
+///
+/// // update
+/// sender.send(grabber.getPixels());
+///
+/// // or, rendered frames
+/// sender.send(fbo.getTexture());
+/// ~~~~
+///
+/// Writing straight into the shared memory avoids the last copy:
+///
+/// ~~~~{.cpp}
+/// ofPixels & pixels = sender.beginFrame(640, 480, OF_PIXELS_RGB);
+/// if(pixels.isAllocated()){
+///     decodeInto(pixels);
+///     sender.endFrame();
+/// }
+/// ~~~~
+class ofSharedFrameSender{
+public:
+	ofSharedFrameSender();
+	~ofSharedFrameSender();
+
+	ofSharedFrameSender(const ofSharedFrameSender &) = delete;
+	ofSharedFrameSender & operator=(const ofSharedFrameSender &) = delete;
+
+	/// \brief Creates the shared memory receivers open by name
+	/// \param maxFrameBytes size of the biggest pixels or buffer that
+	/// will be sent, textures sent on the GPU don't need any
+	/// \param numSlots frames in the ring, with 3 the sender always finds
+	/// a free one while a receiver holds another
+	bool setup(const std::string & name, std::size_t maxFrameBytes, std::size_t numSlots = 3);
+
+	bool send(const ofPixels & pixels);
+	bool send(const ofBuffer & buffer);
+	bool send(const ofTexture & texture);
+
+	/// \brief Claims a slot and returns pixels that point to it
+	///
+	/// The returned pixels are unallocated if the frame doesn't fit or all
+	/// the slots are in use by receivers. Call endFrame() to send it.
+	ofPixels & beginFrame(int width, int height, ofPixelFormat format);
+	void endFrame();
+
+	void close();
+	bool isSetup() const;
+
+	uint64_t getNumFramesSent() const;
+
+	/// \brief Frames that couldn't be sent because they didn't fit or
+	/// every slot was being read
+	uint64_t getNumFramesDropped() const;
+
+private:
+	int claimSlot();
+	void publish(int slot);
+	bool sendTexture(const ofTexture & texture);
+	bool allocateTextures(int width, int height);
+
+	ofSharedMemory memory;
+	std::size_t numSlots;
+	std::size_t slotBytes;
+	uint64_t frameNum;
+	uint64_t numDropped;
+	int frameSlot;
+	ofPixels framePixels;
+	std::vector<std::unique_ptr<ofSharedTexture>> textures;
+	std::unique_ptr<ofPixelReadback> readback;
+	ofPixels readbackPixels;
+
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	// dma-bufs are file descriptors, receivers get them from this thread
+	void serveTextures();
+	int listenSocket;
+	std::atomic<bool> serving;
+	std::thread server;
+	std::mutex texturesMutex;
+	std::vector<int> textureFds;
+	uint32_t textureGeneration;
+#endif
+};
+
+/// \class ofSharedFrameReceiver
+/// \brief Receives the frames sent by an ofSharedFrameSender in another
+/// process
+///
+/// receive() returns true when there's a frame newer than the last one.
+/// The pixels received point into the shared memory and textures shared on
+/// the GPU are the sender's own memory, in both cases the frame stays
+/// valid until receive() returns another one or close() is called.
+///
+/// The sender can start before or after the receiver and can be restarted,
+/// the receiver reconnects by itself.
+///
+/// A receiver that crashes while holding a frame keeps that slot busy, the
+/// sender goes on with the rest of the ring.
+///
+/// ~~~~{.cpp}
+/// // setup
+/// receiver.setup("camera");
+///
+/// // update
+/// if(receiver.receive(texture)){
+///     // new frame
+/// }
+///
+/// // draw
+/// if(texture.isAllocated()) texture.draw(0, 0);
+/// ~~~~
+class ofSharedFrameReceiver{
+public:
+	ofSharedFrameReceiver();
+	~ofSharedFrameReceiver();
+
+	ofSharedFrameReceiver(const ofSharedFrameReceiver &) = delete;
+	ofSharedFrameReceiver & operator=(const ofSharedFrameReceiver &) = delete;
+
+	/// \returns whether the sender is already running
+	bool setup(const std::string & name);
+
+	bool receive(ofPixels & pixels);
+	bool receive(ofBuffer & buffer);
+	bool receive(ofTexture & texture);
+
+	void close();
+
+	/// \brief Whether the shared memory of a sender is open
+	bool isConnected() const;
+
+	/// \brief Number of the last frame received, frames skipped because
+	/// the receiver was slower than the sender show as gaps
+	uint64_t getFrameNum() const;
+
+private:
+	bool connect();
+	int acquire();
+	void release();
+	ofSharedTexture * getTexture(int slot);
+
+	std::string name;
+	ofSharedMemory memory;
+	// the memory of a sender that was restarted stays mapped until the
+	// first new frame so the frame held so far stays valid
+	ofSharedMemory previousMemory;
+	uint64_t instance;
+	uint64_t lastLatest;
+	uint64_t lastFrameTime;
+	uint64_t lastConnectTime;
+	int heldSlot;
+	std::vector<std::unique_ptr<ofSharedTexture>> textures;
+	uint32_t texturesGeneration;
+#if defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	bool receiveTextureFds(uint32_t & generation);
+	std::vector<int> textureFds;
+#endif
+};
@@ -0,0 +1,211 @@
+#include "ofSharedMemory.h"
+#include "ofLog.h"
+#include <cstring>
+
+#ifndef TARGET_WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+using namespace std;
+
+namespace{
+#ifdef TARGET_WIN32
+	string getSystemName(const string & name){
+		return "Local\\of_" + name;
+	}
+#else
+	string getSystemName(const string & name){
+		return "/of_" + name;
+	}
+#endif
+}
+
+//--------------------------------------------------
+ofSharedMemory::ofSharedMemory()
+:data(nullptr)
+,length(0)
+,owner(false)
+#ifdef TARGET_WIN32
+,mapping(nullptr)
+#endif
+{
+}
+
+//--------------------------------------------------
+ofSharedMemory::~ofSharedMemory(){
+	close();
+}
+
+//--------------------------------------------------
+ofSharedMemory::ofSharedMemory(ofSharedMemory && other)
+:ofSharedMemory(){
+	*this = std::move(other);
+}
+
+//--------------------------------------------------
+ofSharedMemory & ofSharedMemory::operator=(ofSharedMemory && other){
+	if(&other == this){
+		return *this;
+	}
+	close();
+	std::swap(name, other.name);
+	std::swap(data, other.data);
+	std::swap(length, other.length);
+	std::swap(owner, other.owner);
+#ifdef TARGET_WIN32
+	std::swap(mapping, other.mapping);
+#endif
+	return *this;
+}
+
+//--------------------------------------------------
+bool ofSharedMemory::create(const string & name, std::size_t size){
+	close();
+	if(size == 0){
+		ofLogError("ofSharedMemory") << "create(): can't create empty memory";
+		return false;
+	}
+	auto systemName = getSystemName(name);
+#ifdef TARGET_WIN32
+	mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		DWORD(uint64_t(size) >> 32), DWORD(size & 0xFFFFFFFF), systemName.c_str());
+	if(!mapping){
+		ofLogError("ofSharedMemory") << "create(): couldn't create " << name << ", error " << GetLastError();
+		return false;
+	}
+	data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if(!data){
+		ofLogError("ofSharedMemory") << "create(): couldn't map " << name << ", error " << GetLastError();
+		CloseHandle(mapping);
+		mapping = nullptr;
+		return false;
+	}
+#else
+	// a leftover from a process that crashed would have the wrong size
+	shm_unlink(systemName.c_str());
+	int fd = shm_open(systemName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if(fd == -1){
+		ofLogError("ofSharedMemory") << "create(): couldn't create " << name << ": " << strerror(errno);
+		return false;
+	}
+	if(ftruncate(fd, size) == -1){
+		ofLogError("ofSharedMemory") << "create(): couldn't resize " << name << ": " << strerror(errno);
+		::close(fd);
+		shm_unlink(systemName.c_str());
+		return false;
+	}
+	void * mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(mapped == MAP_FAILED){
+		ofLogError("ofSharedMemory") << "create(): couldn't map " << name << ": " << strerror(errno);
+		shm_unlink(systemName.c_str());
+		return false;
+	}
+	data = mapped;
+#endif
+	memset(data, 0, size);
+	this->name = name;
+	length = size;
+	owner = true;
+	return true;
+}
+
+//--------------------------------------------------
+bool ofSharedMemory::open(const string & name){
+	close();
+	auto systemName = getSystemName(name);
+#ifdef TARGET_WIN32
+	mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName.c_str());
+	if(!mapping){
+		return false;
+	}
+	data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	MEMORY_BASIC_INFORMATION info;
+	if(!data || !VirtualQuery(data, &info, sizeof(info))){
+		ofLogError("ofSharedMemory") << "open(): couldn't map " << name << ", error " << GetLastError();
+		close();
+		return false;
+	}
+	// rounded up to whole pages
+	length = info.RegionSize;
+#else
+	int fd = shm_open(systemName.c_str(), O_RDWR, 0600);
+	if(fd == -1){
+		return false;
+	}
+	struct stat info;
+	if(fstat(fd, &info) == -1 || info.st_size == 0){
+		::close(fd);
+		return false;
+	}
+	void * mapped = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(mapped == MAP_FAILED){
+		ofLogError("ofSharedMemory") << "open(): couldn't map " << name << ": " << strerror(errno);
+		return false;
+	}
+	data = mapped;
+	length = info.st_size;
+#endif
+	this->name = name;
+	owner = false;
+	return true;
+}
+
+//--------------------------------------------------
+void ofSharedMemory::close(){
+#ifdef TARGET_WIN32
+	if(data){
+		UnmapViewOfFile(data);
+	}
+	if(mapping){
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+#else
+	if(data){
+		munmap(data, length);
+	}
+	if(owner){
+		shm_unlink(getSystemName(name).c_str());
+	}
+#endif
+	data = nullptr;
+	length = 0;
+	owner = false;
+	name.clear();
+}
+
+//--------------------------------------------------
+bool ofSharedMemory::isOpen() const{
+	return data != nullptr;
+}
+
+//--------------------------------------------------
+bool ofSharedMemory::isOwner() const{
+	return owner;
+}
+
+//--------------------------------------------------
+void * ofSharedMemory::getData(){
+	return data;
+}
+
+//--------------------------------------------------
+const void * ofSharedMemory::getData() const{
+	return data;
+}
+
+//--------------------------------------------------
+std::size_t ofSharedMemory::size() const{
+	return length;
+}
+
+//--------------------------------------------------
+const string & ofSharedMemory::getName() const{
+	return name;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ofConstants.h"
+
+/// \class ofSharedMemory
+/// \brief A named block of memory that several processes can map at once
+///
+/// One process creates it with a name and a size, others open it with the
+/// same name and see the same bytes, without copies or system calls once
+/// it's mapped. The memory contains whatever the processes agree on, for
+/// frames see ofSharedFrameSender and ofSharedFrameReceiver which are built
+/// on it.
+///
+/// ~~~~{.cpp}
+/// // process A
+/// ofSharedMemory memory;
+/// memory.create("positions", 1024 * sizeof(glm::vec3));
+///
+/// // process B
+/// ofSharedMemory memory;
+/// if(memory.open("positions")){
+///     auto positions = (glm::vec3*)memory.getData();
+/// }
+/// ~~~~
+///
+/// The memory is removed once it's closed by the process that created it,
+/// processes that still have it open keep their mapping until they close it.
+class ofSharedMemory{
+public:
+	ofSharedMemory();
+	~ofSharedMemory();
+
+	ofSharedMemory(const ofSharedMemory &) = delete;
+	ofSharedMemory & operator=(const ofSharedMemory &) = delete;
+	ofSharedMemory(ofSharedMemory && other);
+	ofSharedMemory & operator=(ofSharedMemory && other);
+
+	/// \brief Creates the memory, replacing any other with the same name,
+	/// and fills it with zeros
+	bool create(const std::string & name, std::size_t size);
+
+	/// \brief Opens memory created by another process
+	/// \returns false if there's none with that name
+	bool open(const std::string & name);
+
+	void close();
+
+	bool isOpen() const;
+
+	/// \brief Whether this object created the memory
+	bool isOwner() const;
+
+	void * getData();
+	const void * getData() const;
+	std::size_t size() const;
+
+	const std::string & getName() const;
+
+private:
+	std::string name;
+	void * data;
+	std::size_t length;
+	bool owner;
+#ifdef TARGET_WIN32
+	void * mapping;
+#endif
+};
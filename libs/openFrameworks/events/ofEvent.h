@@ -12,6 +12,21 @@
 #include "ofTypes.h"
 
 
+// -------------------------------------
+/// \brief How an event delivers the notifications made from threads other
+/// than the main one, see ofEvent::setThreadDelivery()
+enum ofEventThreadDelivery{
+	/// \brief Listeners are called right away from the thread that notifies
+	OF_EVENT_DELIVER_IMMEDIATELY,
+	/// \brief Notifications are queued and delivered in the main thread, in
+	/// the order they were made, once per frame before update
+	OF_EVENT_DELIVER_IN_MAIN_THREAD,
+	/// \brief Like OF_EVENT_DELIVER_IN_MAIN_THREAD but only the latest
+	/// notification since the last frame is delivered
+	OF_EVENT_DELIVER_LATEST_IN_MAIN_THREAD
+};
+
+
 /*! \cond PRIVATE */
 namespace of{
 namespace priv{
@@ -142,6 +157,104 @@ namespace priv{
 	};
 
 
+	// -------------------------------------
+	// A notification made from another thread waiting to be delivered in
+	// the main thread
+	class DeferredNotification{
+	public:
+		virtual ~DeferredNotification();
+		virtual void deliver() = 0;
+		DeferredNotification * next = nullptr;
+	};
+
+	// queues a notification to be delivered in the main thread, takes
+	// ownership of it. Lock-free, can be called from any thread
+	void queueDeferredNotification(DeferredNotification * notification);
+
+	// delivers every queued notification in the order they were queued,
+	// called by ofMainLoop once per frame
+	void deliverDeferredNotifications();
+
+	bool isMainThread();
+
+	// -------------------------------------
+	// List that can be iterated from any thread without locking while it's
+	// being modified. Every modification publishes a new immutable copy so
+	// readers only pay for an atomic increment and decrement. The copies
+	// replaced while someone might still be reading them are freed by the
+	// next modification that finds no readers, or on destruction.
+	template<typename T>
+	class CopyOnWriteList{
+	public:
+		typedef std::vector<T> List;
+
+		CopyOnWriteList()
+		:current(new List)
+		,readers(0){}
+
+		CopyOnWriteList(const CopyOnWriteList &) = delete;
+		CopyOnWriteList & operator=(const CopyOnWriteList &) = delete;
+
+		~CopyOnWriteList(){
+			delete current.load();
+			for(auto list: retired){
+				delete list;
+			}
+		}
+
+		// keeps the current list alive while iterating it, even if it's
+		// replaced from a listener or another thread
+		class Reader{
+		public:
+			Reader(const CopyOnWriteList & list)
+			:owner(list){
+				owner.readers++;
+				snapshot = owner.current.load();
+			}
+
+			~Reader(){
+				owner.readers--;
+			}
+
+			Reader(const Reader &) = delete;
+			Reader & operator=(const Reader &) = delete;
+
+			const List & operator*() const{
+				return *snapshot;
+			}
+
+			const List * operator->() const{
+				return snapshot;
+			}
+
+		private:
+			const CopyOnWriteList & owner;
+			const List * snapshot;
+		};
+
+		// the current list, only valid while holding the writers mutex
+		const List & get() const{
+			return *current.load();
+		}
+
+		// replaces the list, calls have to be serialized by the caller
+		void set(List && list){
+			const List * prev = current.exchange(new List(std::move(list)));
+			retired.push_back(prev);
+			if(readers == 0){
+				for(auto list: retired){
+					delete list;
+				}
+				retired.clear();
+			}
+		}
+
+	private:
+		std::atomic<const List*> current;
+		mutable std::atomic<std::size_t> readers;
+		std::vector<const List*> retired;
+	};
+
 	// -------------------------------------
 	template<typename Function, typename Mutex=std::recursive_mutex>
 	class BaseEvent{
@@ -150,7 +263,7 @@ namespace priv{
 
 		BaseEvent(const BaseEvent & mom){
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
-			self->functions = mom.self->functions;
+			self->functions.set(Functions(mom.self->functions.get()));
 		}
 
 		BaseEvent & operator=(const BaseEvent & mom){
@@ -159,15 +272,18 @@ namespace priv{
 			}
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
 			std::unique_lock<Mutex> lck2(self->mtx);
-			self->functions = mom.self->functions;
+			self->functions.set(Functions(mom.self->functions.get()));
 			self->enabled = mom.self->enabled;
+			self->delivery = mom.self->delivery;
 			return *this;
 		}
 
 		BaseEvent(BaseEvent && mom){
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
-			self->functions = std::move(mom.self->functions);
+			self->functions.set(Functions(mom.self->functions.get()));
+			mom.self->functions.set(Functions());
 			self->enabled = std::move(mom.self->enabled);
+			self->delivery = mom.self->delivery;
 		}
 
 		BaseEvent & operator=(BaseEvent && mom){
@@ -176,8 +292,9 @@ namespace priv{
 			}
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
 			std::unique_lock<Mutex> lck2(self->mtx);
-			self->functions = mom.self->functions;
+			self->functions.set(Functions(mom.self->functions.get()));
 			self->enabled = mom.self->enabled;
+			self->delivery = mom.self->delivery;
 			return *this;
 		}
 
@@ -194,27 +311,58 @@ namespace priv{
 		}
 
 		std::size_t size() const {
-			return self->functions.size();
+			typename Listeners::Reader functions(self->functions);
+			return functions->size();
+		}
+
+		/// \brief Sets how notifications made from threads other than the
+		/// main one are delivered, right away by default
+		///
+		/// Queued notifications keep a copy of the argument, notify returns
+		/// false for them since the listeners haven't been called yet.
+		/// Events with arguments that can't be copied are always delivered
+		/// right away.
+		void setThreadDelivery(ofEventThreadDelivery delivery){
+			self->delivery = delivery;
+		}
+
+		ofEventThreadDelivery getThreadDelivery() const{
+			return self->delivery;
 		}
 
 	protected:
+		typedef CopyOnWriteList<std::shared_ptr<Function>> Listeners;
+		typedef typename Listeners::List Functions;
 
+		// notify iterates the listeners without taking mtx, it's only
+		// locked to add or remove them
 		struct Data{
 			Mutex mtx;
-			std::vector<std::shared_ptr<Function>> functions;
+			Listeners functions;
 			bool enabled = true;
+			ofEventThreadDelivery delivery = OF_EVENT_DELIVER_IMMEDIATELY;
+			// the notification waiting to be delivered when coalescing
+			std::atomic<DeferredNotification*> latest{nullptr};
+
+			~Data(){
+				delete latest.load();
+			}
 
 			void remove(const BaseFunctionId & id){
 				std::unique_lock<Mutex> lck(mtx);
-				auto it = functions.begin();
-				for(; it!=functions.end(); ++it){
-					auto f = *it;
-					if(*f->id == id){
-						f->disable();
-						functions.erase(it);
+				const Functions & current = functions.get();
+				auto it = current.begin();
+				for(; it!=current.end(); ++it){
+					if(*(*it)->id == id){
 						break;
 					}
 				}
+				if(it!=current.end()){
+					(*it)->disable();
+					Functions next(current.begin(), it);
+					next.insert(next.end(), it + 1, current.end());
+					functions.set(std::move(next));
+				}
 			}
 		};
 		std::shared_ptr<Data> self{new Data};
@@ -248,23 +396,80 @@ namespace priv{
 		template<typename TFunction>
 		void addNoToken(TFunction && f){
 			std::unique_lock<Mutex> lck(self->mtx);
-			auto it = self->functions.begin();
-			for(; it!=self->functions.end(); ++it){
+			Functions functions(self->functions.get());
+			auto it = functions.begin();
+			for(; it!=functions.end(); ++it){
 				if((*it)->priority>f->priority) break;
 			}
-			self->functions.emplace(it, f);
+			functions.emplace(it, f);
+			self->functions.set(std::move(functions));
 		}
 
 		template<typename TFunction>
 		std::unique_ptr<EventToken> addFunction(TFunction && f){
-			std::unique_lock<Mutex> lck(self->mtx);
-			auto it = self->functions.begin();
-			for(; it!=self->functions.end(); ++it){
-				if((*it)->priority>f->priority) break;
-			}
-			self->functions.emplace(it, f);
+			addNoToken(f);
 			return make_token(*f);
 		}
+
+		// calls notify on every listener in priority order until one of
+		// them returns true, the event data is kept alive in case a
+		// listener destroys the event
+		template<typename Notify>
+		bool notifyListeners(Notify && notify){
+			return notifyListeners(self, std::forward<Notify>(notify));
+		}
+
+		template<typename Notify>
+		static bool notifyListeners(std::shared_ptr<Data> data, Notify && notify){
+			if(!data->enabled) return false;
+			typename Listeners::Reader functions(data->functions);
+			for(auto & f: *functions){
+				if(notify(*f)){
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool shouldDefer() const{
+			return self->delivery != OF_EVENT_DELIVER_IMMEDIATELY && self->enabled && !isMainThread();
+		}
+
+		// delivers the latest notification of an event that coalesces them
+		class LatestNotification: public DeferredNotification{
+		public:
+			LatestNotification(const std::shared_ptr<Data> & data)
+			:data(data){}
+
+			void deliver(){
+				auto data = this->data.lock();
+				if(data){
+					std::unique_ptr<DeferredNotification> notification(data->latest.exchange(nullptr));
+					if(notification){
+						notification->deliver();
+					}
+				}
+			}
+
+		private:
+			std::weak_ptr<Data> data;
+		};
+
+		// queues notification for the main thread, when coalescing it
+		// replaces the one still pending, if any, which already has a
+		// LatestNotification queued to deliver it
+		void defer(DeferredNotification * notification){
+			if(self->delivery == OF_EVENT_DELIVER_LATEST_IN_MAIN_THREAD){
+				DeferredNotification * prev = self->latest.exchange(notification);
+				if(prev){
+					delete prev;
+				}else{
+					queueDeferredNotification(new LatestNotification(self));
+				}
+			}else{
+				queueDeferredNotification(notification);
+			}
+		}
 	};
 
 
@@ -484,6 +689,43 @@ protected:
 
 	using of::priv::BaseEvent<of::priv::Function<T,Mutex>,Mutex>::addFunction;
 	using of::priv::BaseEvent<of::priv::Function<T,Mutex>,Mutex>::addNoToken;
+	typedef typename of::priv::BaseEvent<of::priv::Function<T,Mutex>,Mutex>::Data Data;
+
+	// a copy of a notification made from another thread
+	class DeferredValue: public of::priv::DeferredNotification{
+	public:
+		DeferredValue(const std::shared_ptr<Data> & data, const void * sender, const T & value)
+		:data(data)
+		,sender(sender)
+		,value(value){}
+
+		void deliver(){
+			auto data = this->data.lock();
+			if(data){
+				ofEvent<T,Mutex>::notifyListeners(data, [this](Function & f){
+					return f.notify(sender,value);
+				});
+			}
+		}
+
+	private:
+		std::weak_ptr<Data> data;
+		const void * sender;
+		T value;
+	};
+
+	bool defer(const void * sender, T & param, std::true_type){
+		of::priv::BaseEvent<Function,Mutex>::defer(new DeferredValue(this->self, sender, param));
+		return true;
+	}
+
+	bool defer(const void *, T &, std::false_type){
+		return false;
+	}
+
+	bool deferIfNeeded(const void * sender, T & param){
+		return this->shouldDefer() && defer(sender, param, std::is_copy_constructible<T>());
+	}
 
 public:
 	template<class TObj, typename TMethod>
@@ -517,31 +759,16 @@ public:
 	}
 
 	inline bool notify(const void* sender, T & param){
-		if(ofEvent<T,Mutex>::self->enabled && !ofEvent<T,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<T,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<T,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-                if(f->notify(sender,param)){
-					return true;
-                }
-			}
+		if(deferIfNeeded(sender,param)){
+			return false;
 		}
-		return false;
+		return this->notifyListeners([&](Function & f){
+			return f.notify(sender,param);
+		});
 	}
 
 	inline bool notify(T & param){
-		if(ofEvent<T,Mutex>::self->enabled && !ofEvent<T,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<T,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<T,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-				if(f->notify(nullptr,param)){
-					return true;
-				}
-			}
-		}
-		return false;
+		return notify(nullptr,param);
 	}
 };
 
@@ -642,6 +869,28 @@ protected:
 
 	using of::priv::BaseEvent<of::priv::Function<void,Mutex>,Mutex>::addFunction;
 	using of::priv::BaseEvent<of::priv::Function<void,Mutex>,Mutex>::addNoToken;
+	typedef typename of::priv::BaseEvent<of::priv::Function<void,Mutex>,Mutex>::Data Data;
+
+	// a notification made from another thread
+	class DeferredValue: public of::priv::DeferredNotification{
+	public:
+		DeferredValue(const std::shared_ptr<Data> & data, const void * sender)
+		:data(data)
+		,sender(sender){}
+
+		void deliver(){
+			auto data = this->data.lock();
+			if(data){
+				ofEvent<void,Mutex>::notifyListeners(data, [this](Function & f){
+					return f.notify(sender);
+				});
+			}
+		}
+
+	private:
+		std::weak_ptr<Data> data;
+		const void * sender;
+	};
 
 public:
 	template<class TObj, typename TMethod>
@@ -675,49 +924,23 @@ public:
 	}
 
 	bool notify(const void* sender){
-		if(ofEvent<void,Mutex>::self->enabled && !ofEvent<void,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<void,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<void,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-				if(f->notify(sender)){
-					return true;
-				}
-			}
+		if(this->shouldDefer()){
+			this->defer(new DeferredValue(this->self, sender));
+			return false;
 		}
-		return false;
+		return this->notifyListeners([&](Function & f){
+			return f.notify(sender);
+		});
 	}
 
 	bool notify(){
-		if(ofEvent<void,Mutex>::self->enabled && !ofEvent<void,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<void,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<void,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-				if(f->notify(nullptr)){
-					return true;
-				}
-			}
-		}
-		return false;
+		return notify(nullptr);
 	}
 };
 
 // -------------------------------------
-/// Non thread safe event that avoids locks and copies of the listeners
-/// making it faster than a plain ofEvent
+/// Non thread safe event that avoids locking each listener while it's
+/// called, making it faster than a plain ofEvent
 template<typename T>
 class ofFastEvent: public ofEvent<T,of::priv::NoopMutex>{
-public:
-	inline bool notify(const void* sender, T & param){
-		if(this->isEnabled()){
-			for(auto & f: ofFastEvent<T>::self->functions){
-				if(f->notify(sender, param)){
-					return true;
-				}
-			}
-		}
-		return false;
-	}
 };
-
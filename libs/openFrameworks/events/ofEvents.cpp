@@ -1,5 +1,8 @@
 #include "ofEvents.h"
 #include "ofAppRunner.h"
+#include "ofProfiler.h"
+#include "ofUtils.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -16,6 +19,36 @@ void ofSetFrameRate(int targetRate){
 	}
 }
 
+//--------------------------------------
+void ofSetFramePacing(uint64_t spinThresholdNanos, bool skipLateFrames){
+	auto window = ofGetMainLoop()->getCurrentWindow();
+	if(window){
+		window->events().setFramePacing(spinThresholdNanos, skipLateFrames);
+	}else{
+		ofLogWarning("ofEvents") << "Trying to set frame pacing before mainloop is ready";
+	}
+}
+
+//--------------------------------------
+void ofSetFixedTimestep(uint64_t stepNanos, int maxStepsPerFrame){
+	auto window = ofGetMainLoop()->getCurrentWindow();
+	if(window){
+		window->events().setFixedTimestep(stepNanos, maxStepsPerFrame);
+	}else{
+		ofLogWarning("ofEvents") << "Trying to set fixed timestep before mainloop is ready";
+	}
+}
+
+//--------------------------------------
+float ofGetFixedTimestepAlpha(){
+	auto window = ofGetMainLoop()->getCurrentWindow();
+	if(window){
+		return window->events().getFixedTimestepAlpha();
+	}else{
+		return 0.f;
+	}
+}
+
 //--------------------------------------
 float ofGetFrameRate(){
 	auto window = ofGetMainLoop()->getCurrentWindow();
@@ -119,6 +152,10 @@ int ofGetPreviousMouseY(){
 ofCoreEvents::ofCoreEvents()
 :targetRate(0)
 ,bFrameRateSet(false)
+,fixedTimestep(0)
+,maxStepsPerFrame(8)
+,numLastUpdateSteps(0)
+,bInFixedUpdate(false)
 ,fps(60)
 ,currentMouseX(0)
 ,currentMouseY(0)
@@ -207,6 +244,48 @@ void ofCoreEvents::setFrameRate(int _targetRate){
 	}
 }
 
+//--------------------------------------
+void ofCoreEvents::setFramePacing(uint64_t spinThresholdNanos, bool skipLateFrames){
+	timer.setSpinThreshold(spinThresholdNanos);
+	timer.setSkipLateEvents(skipLateFrames);
+}
+
+//--------------------------------------
+std::chrono::nanoseconds ofCoreEvents::getLastFrameLateness() const{
+	return bFrameRateSet ? timer.getLastLateness() : std::chrono::nanoseconds(0);
+}
+
+//--------------------------------------
+uint64_t ofCoreEvents::getNumLateFrames() const{
+	return bFrameRateSet ? timer.getNumLateEvents() : 0;
+}
+
+//--------------------------------------
+void ofCoreEvents::setFixedTimestep(uint64_t stepNanos, int maxSteps){
+	fixedTimestep = std::chrono::nanoseconds(stepNanos);
+	maxStepsPerFrame = std::max(maxSteps, 1);
+	accumulatedTime = std::chrono::nanoseconds(0);
+	lastUpdateTime = std::chrono::steady_clock::time_point();
+}
+
+//--------------------------------------
+uint64_t ofCoreEvents::getFixedTimestep() const{
+	return fixedTimestep.count();
+}
+
+//--------------------------------------
+float ofCoreEvents::getFixedTimestepAlpha() const{
+	if(fixedTimestep.count() == 0){
+		return 0.f;
+	}
+	return std::chrono::duration<double>(accumulatedTime).count() / std::chrono::duration<double>(fixedTimestep).count();
+}
+
+//--------------------------------------
+int ofCoreEvents::getNumLastUpdateSteps() const{
+	return numLastUpdateSteps;
+}
+
 //--------------------------------------
 float ofCoreEvents::getFrameRate() const{
 	return fps.getFps();
@@ -219,6 +298,9 @@ float ofCoreEvents::getTargetFrameRate() const{
 
 //--------------------------------------
 double ofCoreEvents::getLastFrameTime() const{
+	if(bInFixedUpdate){
+		return std::chrono::duration<double>(fixedTimestep).count();
+	}
 	switch(timeMode){
 		case Filtered:
 			return fps.getLastFrameFilteredSecs();
@@ -236,6 +318,16 @@ uint64_t ofCoreEvents::getFrameNum() const{
 	return fps.getNumFrames();
 }
 
+//--------------------------------------
+ofFpsCounter & ofCoreEvents::getFpsCounter(){
+	return fps;
+}
+
+//--------------------------------------
+const ofFpsCounter & ofCoreEvents::getFpsCounter() const{
+	return fps;
+}
+
 //--------------------------------------
 bool ofCoreEvents::getMousePressed(int button) const{ //by default any button
 	if(button==-1) return pressedMouseButtons.size();
@@ -273,6 +365,92 @@ int ofCoreEvents::getModifiers() const{
 	return modifiers;
 }
 
+//--------------------------------------
+void ofCoreEvents::setCoalesceMotionEvents(bool coalesce){
+	if(!coalesce){
+		flushMotionEvents();
+	}
+	bCoalesceMotionEvents = coalesce;
+}
+
+//--------------------------------------
+bool ofCoreEvents::isCoalescingMotionEvents() const{
+	return bCoalesceMotionEvents;
+}
+
+//--------------------------------------
+void ofCoreEvents::flushMotionEvents(){
+	flushMouseMotion();
+	flushTouchMotion(-1);
+}
+
+//--------------------------------------
+bool ofCoreEvents::coalesceMouseMotion(ofMouseEventArgs & e){
+	if(bHasPendingMouseMotion && (pendingMouseMotion.type != e.type || pendingMouseMotion.button != e.button)){
+		flushMouseMotion();
+	}
+	std::vector<ofMouseEventArgs::Sample> history;
+	if(bHasPendingMouseMotion){
+		history = std::move(pendingMouseMotion.history);
+	}
+	history.push_back({e, ofGetElapsedTimeMicros()});
+	pendingMouseMotion = e;
+	pendingMouseMotion.history = std::move(history);
+	bHasPendingMouseMotion = true;
+	return false;
+}
+
+//--------------------------------------
+void ofCoreEvents::flushMouseMotion(){
+	if(!bHasPendingMouseMotion){
+		return;
+	}
+	// moved out first, a listener could notify new events
+	auto e = std::move(pendingMouseMotion);
+	bHasPendingMouseMotion = false;
+	if(e.type == ofMouseEventArgs::Dragged){
+		ofNotifyEvent( mouseDragged, e );
+	}else{
+		ofNotifyEvent( mouseMoved, e );
+	}
+}
+
+//--------------------------------------
+void ofCoreEvents::coalesceTouchMotion(ofTouchEventArgs & e){
+	auto pending = std::find_if(pendingTouchMotions.begin(), pendingTouchMotions.end(), [&](const ofTouchEventArgs & touch){
+		return touch.id == e.id;
+	});
+	std::vector<ofTouchEventArgs::Sample> history;
+	if(pending != pendingTouchMotions.end()){
+		history = std::move(pending->history);
+	}else{
+		pending = pendingTouchMotions.insert(pendingTouchMotions.end(), e);
+	}
+	history.push_back({e, e.pressure, ofGetElapsedTimeMicros()});
+	*pending = e;
+	pending->history = std::move(history);
+}
+
+//--------------------------------------
+void ofCoreEvents::flushTouchMotion(int id){
+	std::vector<ofTouchEventArgs> touches;
+	if(id < 0){
+		std::swap(touches, pendingTouchMotions);
+	}else{
+		auto pending = std::find_if(pendingTouchMotions.begin(), pendingTouchMotions.end(), [&](const ofTouchEventArgs & touch){
+			return touch.id == id;
+		});
+		if(pending == pendingTouchMotions.end()){
+			return;
+		}
+		touches.push_back(std::move(*pending));
+		pendingTouchMotions.erase(pending);
+	}
+	for(auto & touch: touches){
+		ofNotifyEvent( touchMoved, touch );
+	}
+}
+
 //------------------------------------------
 bool ofCoreEvents::notifySetup(){
 	return ofNotifyEvent( setup, voidEventArgs );
@@ -281,7 +459,37 @@ bool ofCoreEvents::notifySetup(){
 #include "ofGraphics.h"
 //------------------------------------------
 bool ofCoreEvents::notifyUpdate(){
-	return ofNotifyEvent( update, voidEventArgs );
+	flushMotionEvents();
+
+	if(fixedTimestep.count() == 0){
+		numLastUpdateSteps = 1;
+		return ofNotifyEvent( update, voidEventArgs );
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	if(lastUpdateTime == std::chrono::steady_clock::time_point()){
+		// the first frame simulates one step
+		accumulatedTime = fixedTimestep;
+	}else{
+		accumulatedTime += std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastUpdateTime);
+	}
+	lastUpdateTime = now;
+
+	bool attended = false;
+	numLastUpdateSteps = 0;
+	bInFixedUpdate = true;
+	while(accumulatedTime >= fixedTimestep && numLastUpdateSteps < maxStepsPerFrame){
+		attended |= ofNotifyEvent( update, voidEventArgs );
+		accumulatedTime -= fixedTimestep;
+		numLastUpdateSteps++;
+	}
+	bInFixedUpdate = false;
+	// a simulation slower than real time would otherwise fall further
+	// behind every frame, the time that didn't fit is dropped
+	if(accumulatedTime >= fixedTimestep){
+		accumulatedTime = std::chrono::nanoseconds(accumulatedTime.count() % fixedTimestep.count());
+	}
+	return attended;
 }
 
 //------------------------------------------
@@ -289,11 +497,12 @@ bool ofCoreEvents::notifyDraw(){
 	auto attended = ofNotifyEvent( draw, voidEventArgs );
 
 	if (bFrameRateSet){
+		OF_PROFILE_SCOPE("wait");
 		timer.waitNext();
 	}
 	
 	if(fps.getNumFrames()==0){
-		if(bFrameRateSet) fps = ofFpsCounter(targetRate);
+		if(bFrameRateSet) fps.reset(targetRate);
 	}else{
 		/*if(ofIsVerticalSyncEnabled()){
 			float rate = ofGetRefreshRate();
@@ -450,6 +659,14 @@ void ofCoreEvents::notifyTouchDoubleTap(int x, int y, int touchID){
 
 //------------------------------------------
 void ofCoreEvents::notifyTouchEvent(ofTouchEventArgs & touchArgs){
+	if(touchArgs.type == ofTouchEventArgs::move && bCoalesceMotionEvents){
+		coalesceTouchMotion(touchArgs);
+		return;
+	}
+	if(!pendingTouchMotions.empty()){
+		flushTouchMotion(touchArgs.id);
+	}
+
 	switch(touchArgs.type){
 		case ofTouchEventArgs::move:
 			ofNotifyEvent( touchMoved, touchArgs );
@@ -473,6 +690,10 @@ void ofCoreEvents::notifyTouchEvent(ofTouchEventArgs & touchArgs){
 //------------------------------------------
 bool  ofCoreEvents::notifyMouseEvent(ofMouseEventArgs & e){
 	modifiers = e.modifiers;
+	// presses, releases... have to arrive after the moves that preceded them
+	if(bHasPendingMouseMotion && e.type != ofMouseEventArgs::Moved && e.type != ofMouseEventArgs::Dragged){
+		flushMouseMotion();
+	}
 	switch(e.type){
 		case ofMouseEventArgs::Moved:
 			if( bPreMouseNotSet ){
@@ -487,6 +708,9 @@ bool  ofCoreEvents::notifyMouseEvent(ofMouseEventArgs & e){
 			currentMouseX = e.x;
 			currentMouseY = e.y;
 
+			if(bCoalesceMotionEvents){
+				return coalesceMouseMotion(e);
+			}
 			return ofNotifyEvent( mouseMoved, e );
 		case ofMouseEventArgs::Dragged:
 			if( bPreMouseNotSet ){
@@ -501,6 +725,9 @@ bool  ofCoreEvents::notifyMouseEvent(ofMouseEventArgs & e){
 			currentMouseX = e.x;
 			currentMouseY = e.y;
 
+			if(bCoalesceMotionEvents){
+				return coalesceMouseMotion(e);
+			}
 			return ofNotifyEvent( mouseDragged, e );
 		case ofMouseEventArgs::Pressed:{
 			if( bPreMouseNotSet ){
@@ -631,5 +858,39 @@ namespace of{
 		BaseFunctionId::~BaseFunctionId(){}
 
 		StdFunctionId::~StdFunctionId(){}
+
+		DeferredNotification::~DeferredNotification(){}
+
+		// notifications are pushed on a lock-free stack, the main thread
+		// takes all of them at once and reverses them to keep their order
+		static std::atomic<DeferredNotification*> deferredNotifications{nullptr};
+
+		// statics are initialized from the main thread, before main()
+		static const std::thread::id mainThreadId = std::this_thread::get_id();
+
+		void queueDeferredNotification(DeferredNotification * notification){
+			notification->next = deferredNotifications.load(std::memory_order_relaxed);
+			while(!deferredNotifications.compare_exchange_weak(notification->next, notification, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		void deliverDeferredNotifications(){
+			DeferredNotification * notification = deferredNotifications.exchange(nullptr, std::memory_order_acquire);
+			DeferredNotification * ordered = nullptr;
+			while(notification){
+				DeferredNotification * next = notification->next;
+				notification->next = ordered;
+				ordered = notification;
+				notification = next;
+			}
+			while(ordered){
+				std::unique_ptr<DeferredNotification> current(ordered);
+				ordered = ordered->next;
+				current->deliver();
+			}
+		}
+
+		bool isMainThread(){
+			return std::this_thread::get_id() == mainThreadId;
+		}
 	}
 }
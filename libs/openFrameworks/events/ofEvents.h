@@ -136,6 +136,19 @@ class ofMouseEventArgs : public ofEventArgs, public glm::vec2 {
 	/// Key modifiers
 	int modifiers = 0;
 
+	/// \brief A position the pointer went through
+	struct Sample{
+		glm::vec2 position;
+		uint64_t timeMicros; ///< ofGetElapsedTimeMicros() when the window notified it
+	};
+
+	/// \brief Every position of a move or drag coalesced into this event,
+	/// oldest first, the last one is this event's own
+	///
+	/// Only filled when ofCoreEvents::setCoalesceMotionEvents() is on,
+	/// empty otherwise.
+	std::vector<Sample> history;
+
 	bool hasModifier(int modifier){
 		return modifiers & modifier;
 	}
@@ -197,6 +210,20 @@ class ofTouchEventArgs : public ofEventArgs, public glm::vec2 {
 	float pressure;
 	float xspeed, yspeed;
 	float xaccel, yaccel;
+
+	/// \brief A position the touch went through
+	struct Sample{
+		glm::vec2 position;
+		float pressure;
+		uint64_t timeMicros; ///< ofGetElapsedTimeMicros() when the window notified it
+	};
+
+	/// \brief Every position of a move coalesced into this event, oldest
+	/// first, the last one is this event's own
+	///
+	/// Only filled when ofCoreEvents::setCoalesceMotionEvents() is on,
+	/// empty otherwise.
+	std::vector<Sample> history;
 };
 
 class ofResizeEventArgs : public ofEventArgs {
@@ -275,10 +302,55 @@ class ofCoreEvents {
 	void setTimeModeFiltered(float alpha);
 
 	void setFrameRate(int _targetRate);
+	/// \brief How the frame rate set with setFrameRate() is kept.
+	///
+	/// By default each frame sleeps until its deadline, which can wake up
+	/// late with the granularity of the OS scheduler. With a spin threshold
+	/// the last part of the wait spins instead, 1 to 2ms gives steady frame
+	/// times at 120 or 144Hz. A frame that starts after its deadline makes
+	/// the next ones a period from then if skipLateFrames, otherwise the
+	/// following frames don't wait until the missed ones are caught up.
+	void setFramePacing(uint64_t spinThresholdNanos, bool skipLateFrames = true);
+	/// \brief How late the last frame finished waiting, after its deadline
+	std::chrono::nanoseconds getLastFrameLateness() const;
+	/// \brief Frames that were done after their deadline since the frame
+	/// rate was set
+	uint64_t getNumLateFrames() const;
+
+	/// \brief Run update at a fixed rate, independent of the frame rate.
+	///
+	/// Each frame update is notified as many times as steps of stepNanos
+	/// fit in the time since the last frame, up to maxStepsPerFrame, and
+	/// ofGetLastFrameTime() returns the step while they run. The time left
+	/// is returned as a fraction of a step by getFixedTimestepAlpha(), for
+	/// draw to interpolate between the last two simulated states:
+	///
+	/// ~~~~{.cpp}
+	/// void ofApp::update(){
+	///     previous = current;
+	///     current = simulate(previous, ofGetLastFrameTime());
+	/// }
+	///
+	/// void ofApp::draw(){
+	///     drawState(mix(previous, current, ofGetFixedTimestepAlpha()));
+	/// }
+	/// ~~~~
+	///
+	/// \param stepNanos Duration of a simulation step, 0 to notify update
+	/// once per frame as usual.
+	void setFixedTimestep(uint64_t stepNanos, int maxStepsPerFrame = 8);
+	uint64_t getFixedTimestep() const;
+	float getFixedTimestepAlpha() const;
+	/// \brief Times update was notified in the last frame
+	int getNumLastUpdateSteps() const;
 	float getFrameRate() const;
 	float getTargetFrameRate() const;
 	double getLastFrameTime() const;
 	uint64_t getFrameNum() const;
+	/// \brief The counter that measures the frames, for their percentiles
+	/// and to be notified of spikes
+	ofFpsCounter & getFpsCounter();
+	const ofFpsCounter & getFpsCounter() const;
 
 	bool getMousePressed(int button=-1) const;
 	bool getKeyPressed(int key=-1) const;
@@ -288,6 +360,35 @@ class ofCoreEvents {
 	int getPreviousMouseY() const;
 	int getModifiers() const;
 
+	/// \brief Deliver a single mouse move or drag, and a single move per
+	/// touch, each frame, off by default
+	///
+	/// 1000Hz mice and pen tablets send many motion events per frame. With
+	/// this on they are held until the next update, or until a press,
+	/// release or scroll of the same mouse or touch that has to be notified
+	/// after them, and only the last one is notified with the positions
+	/// of all the others in its history:
+	///
+	/// ~~~~{.cpp}
+	/// ofGetMainLoop()->getCurrentWindow()->events().setCoalesceMotionEvents(true);
+	///
+	/// void ofApp::mouseDragged(ofMouseEventArgs & mouse){
+	///     for(auto & sample: mouse.history){
+	///         stroke.addVertex(sample.position.x, sample.position.y);
+	///     }
+	/// }
+	/// ~~~~
+	///
+	/// ofGetMouseX() and ofGetMouseY() are updated as soon as the events
+	/// arrive. Each window has its own ofCoreEvents so it can be set for
+	/// each of them.
+	void setCoalesceMotionEvents(bool coalesce);
+	bool isCoalescingMotionEvents() const;
+
+	/// \brief Notifies the motion events held by setCoalesceMotionEvents(),
+	/// done automatically before update
+	void flushMotionEvents();
+
 	//  event notification only for internal OF use
 	bool notifySetup();
 	bool notifyUpdate();
@@ -323,6 +424,12 @@ private:
 	float targetRate;
 	bool bFrameRateSet;
 	ofTimer timer;
+	std::chrono::nanoseconds fixedTimestep;
+	std::chrono::nanoseconds accumulatedTime{0};
+	std::chrono::steady_clock::time_point lastUpdateTime;
+	int maxStepsPerFrame;
+	int numLastUpdateSteps;
+	bool bInFixedUpdate;
 	ofFpsCounter fps;
 
 	int	currentMouseX, currentMouseY;
@@ -332,6 +439,15 @@ private:
 	std::set<int> pressedKeys;
 	int modifiers = 0;
 
+	bool coalesceMouseMotion(ofMouseEventArgs & e);
+	void coalesceTouchMotion(ofTouchEventArgs & e);
+	void flushMouseMotion();
+	void flushTouchMotion(int id);
+	bool bCoalesceMotionEvents = false;
+	bool bHasPendingMouseMotion = false;
+	ofMouseEventArgs pendingMouseMotion;
+	std::vector<ofTouchEventArgs> pendingTouchMotions;
+
 	enum TimeMode{
 		System,
 		FixedRate,
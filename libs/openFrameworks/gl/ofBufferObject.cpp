@@ -1,13 +1,23 @@
 #include "ofBufferObject.h"
 #include "ofConstants.h"
 #include "ofAppRunner.h"
+#include "ofLog.h"
+#include "ofRenderStats.h"
+#include "ofGpuMemory.h"
 
 using namespace std;
 
 ofBufferObject::Data::Data()
 :id(0)
 ,size(0)
-,lastTarget(GL_ARRAY_BUFFER){
+,lastTarget(GL_ARRAY_BUFFER)
+,isBound(false)
+#ifndef TARGET_OPENGLES
+,persistentPtr(nullptr)
+,regionSize(0)
+,currentRegion(-1)
+#endif
+{
 	
 	// tig: glGenBuffers does not actually create a buffer, it just 
 	//      returns the next available name, and only a subsequent 
@@ -34,7 +44,14 @@ ofBufferObject::Data::Data()
 }
 
 ofBufferObject::Data::~Data(){
+#ifndef TARGET_OPENGLES
+	// deleting the buffer also releases the persistent mapping
+	for(auto & fence: fences){
+		if(fence) glDeleteSync(fence);
+	}
+#endif
 	glDeleteBuffers(1,&id);
+	of::priv::gpuMemoryReleased(OF_GPU_MEMORY_BUFFER, id);
 }
 
 ofBufferObject::ofBufferObject()
@@ -111,7 +128,21 @@ GLuint ofBufferObject::getId() const{
 
 void ofBufferObject::setData(GLsizeiptr bytes, const void * data, GLenum usage){
 	if(!this->data) return;
+
+#ifndef TARGET_OPENGLES
+	// immutable storage can't be respecified, create a new buffer instead
+	if(this->data->persistentPtr){
+		GLenum lastTarget = this->data->lastTarget;
+		allocate();
+		this->data->lastTarget = lastTarget;
+	}
+#endif
+
 	this->data->size = bytes;
+	of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_BUFFER, this->data->id, bytes);
+	if(data){
+		of::priv::currentRenderStats().bufferUploadBytes += bytes;
+	}
 
 #ifdef GLEW_VERSION_4_5
 	if (GLEW_ARB_direct_state_access) {
@@ -128,6 +159,7 @@ void ofBufferObject::setData(GLsizeiptr bytes, const void * data, GLenum usage){
 
 void ofBufferObject::updateData(GLintptr offset, GLsizeiptr bytes, const void * data){
 	if(!this->data) return;
+	of::priv::currentRenderStats().bufferUploadBytes += bytes;
 
 #ifdef GLEW_VERSION_4_5
 	if(GLEW_ARB_direct_state_access){
@@ -257,6 +289,115 @@ void ofBufferObject::invalidate(){
     glInvalidateBufferData(data->id);
 }
 
+bool ofBufferObject::isPersistentMappingSupported(){
+#ifdef GLEW_VERSION_4_4
+	return GLEW_ARB_buffer_storage;
+#else
+	return false;
+#endif
+}
+
+void ofBufferObject::allocatePersistentRing(GLsizeiptr regionBytes, int numRegions){
+	if(!isPersistentMappingSupported()){
+		ofLogError("ofBufferObject") << "allocatePersistentRing(): persistent mapped buffers need GL 4.4 or ARB_buffer_storage";
+		return;
+	}
+	if(numRegions<1){
+		ofLogError("ofBufferObject") << "allocatePersistentRing(): need at least one region";
+		return;
+	}
+
+#ifdef GLEW_VERSION_4_4
+	GLenum lastTarget = data ? data->lastTarget : GL_ARRAY_BUFFER;
+	allocate();
+	data->lastTarget = lastTarget;
+
+	// keep every region aligned so it can be bound at any offset
+	// with bindRange, 256 is the largest alignment required in practice
+	const GLsizeiptr alignment = 256;
+	GLsizeiptr regionSize = ((regionBytes + alignment - 1) / alignment) * alignment;
+	GLsizeiptr bytes = regionSize * numRegions;
+	GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLbitfield storageFlags = mapFlags | GL_DYNAMIC_STORAGE_BIT;
+
+#ifdef GLEW_VERSION_4_5
+	if (GLEW_ARB_direct_state_access) {
+		glNamedBufferStorage(data->id, bytes, nullptr, storageFlags);
+		data->persistentPtr = glMapNamedBufferRange(data->id, 0, bytes, mapFlags);
+	}else
+#endif
+	{
+		/// --------| invariant: direct state access is not available
+		bind(data->lastTarget);
+		glBufferStorage(data->lastTarget, bytes, nullptr, storageFlags);
+		data->persistentPtr = glMapBufferRange(data->lastTarget, 0, bytes, mapFlags);
+		unbind(data->lastTarget);
+	}
+
+	if(!data->persistentPtr){
+		ofLogError("ofBufferObject") << "allocatePersistentRing(): couldn't map buffer storage";
+		return;
+	}
+
+	data->size = bytes;
+	of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_BUFFER, data->id, bytes);
+	data->regionSize = regionSize;
+	data->currentRegion = -1;
+	data->fences.assign(numRegions, nullptr);
+#endif
+}
+
+bool ofBufferObject::isPersistentlyMapped() const{
+	return data && data->persistentPtr;
+}
+
+void * ofBufferObject::mapNextRegion(){
+	if(!isPersistentlyMapped()) return nullptr;
+
+	data->currentRegion = (data->currentRegion + 1) % data->fences.size();
+	GLsync & fence = data->fences[data->currentRegion];
+	if(fence){
+		// the region is usually free by the time we get back to it so
+		// this only blocks if the GPU is more than numRegions frames behind
+		GLenum waitReturn = glClientWaitSync(fence, 0, 0);
+		while(waitReturn!=GL_ALREADY_SIGNALED && waitReturn!=GL_CONDITION_SATISFIED){
+			if(waitReturn==GL_WAIT_FAILED){
+				ofLogError("ofBufferObject") << "mapNextRegion(): failed waiting for region " << data->currentRegion;
+				break;
+			}
+			waitReturn = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	return static_cast<char*>(data->persistentPtr) + getCurrentRegionOffset();
+}
+
+void ofBufferObject::lockCurrentRegion() const{
+	if(!isPersistentlyMapped() || data->currentRegion<0) return;
+	GLsync & fence = data->fences[data->currentRegion];
+	if(fence){
+		glDeleteSync(fence);
+	}
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLintptr ofBufferObject::getCurrentRegionOffset() const{
+	if(!isPersistentlyMapped() || data->currentRegion<0) return 0;
+	return data->currentRegion * data->regionSize;
+}
+
+GLsizeiptr ofBufferObject::getRegionSize() const{
+	if(!isPersistentlyMapped()) return 0;
+	return data->regionSize;
+}
+
+int ofBufferObject::getNumRegions() const{
+	if(!isPersistentlyMapped()) return 0;
+	return data->fences.size();
+}
+
 #endif
 
 GLsizeiptr ofBufferObject::size() const{
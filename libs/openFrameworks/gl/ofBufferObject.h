@@ -130,6 +130,53 @@ public:
 	void copyTo(ofBufferObject & dstBuffer, int readOffset, int writeOffset, size_t size) const;
 
     void invalidate();
+
+	/// true if the driver supports immutable storage that can stay
+	/// mapped while the GPU reads from it: GL 4.4 or ARB_buffer_storage
+	static bool isPersistentMappingSupported();
+
+	/// creates a buffer with immutable storage for numRegions regions of
+	/// regionBytes each and keeps it mapped for the lifetime of the buffer
+	/// glBufferStorage + glMapBufferRange with GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT:
+	/// https://www.opengl.org/sdk/docs/man4/html/glBufferStorage.xhtml
+	///
+	/// the regions work as a ring: every frame mapNextRegion() returns
+	/// the region after the last one which can be written directly while
+	/// the GPU still reads from the previous ones. Once the commands that
+	/// read a region have been issued call lockCurrentRegion() so the next
+	/// time that region is returned mapNextRegion() waits for the GPU to
+	/// be done with it
+	void allocatePersistentRing(GLsizeiptr regionBytes, int numRegions = 3);
+
+	/// true if the buffer was allocated with allocatePersistentRing
+	bool isPersistentlyMapped() const;
+
+	/// waits for the fence of the next region in the ring, if any, and
+	/// returns a pointer to its mapped memory
+	void * mapNextRegion();
+
+	/// typed version of mapNextRegion, returns an array of T when used like:
+	/// buffer.mapNextRegion<Type>()
+	template<typename T>
+	T * mapNextRegion(){
+		return static_cast<T*>(mapNextRegion());
+	}
+
+	/// inserts a fence after the commands issued so far that guards the
+	/// region returned by the last call to mapNextRegion
+	/// glFenceSync: https://www.opengl.org/sdk/docs/man4/html/glFenceSync.xhtml
+	void lockCurrentRegion() const;
+
+	/// offset in bytes from the start of the buffer of the region returned
+	/// by the last call to mapNextRegion, to be used when binding the
+	/// buffer or setting it as an attribute
+	GLintptr getCurrentRegionOffset() const;
+
+	/// size in bytes of each region in the ring
+	GLsizeiptr getRegionSize() const;
+
+	/// number of regions in the ring or 0 if the buffer is not persistently mapped
+	int getNumRegions() const;
 #endif
 
 	GLsizeiptr size() const;
@@ -142,6 +189,12 @@ private:
 		GLsizeiptr size;
 		GLenum lastTarget;
 		bool isBound;
+#ifndef TARGET_OPENGLES
+		void * persistentPtr;
+		GLsizeiptr regionSize;
+		int currentRegion;
+		std::vector<GLsync> fences;
+#endif
 	};
 	std::shared_ptr<Data> data;
 };
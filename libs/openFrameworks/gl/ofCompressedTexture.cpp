@@ -0,0 +1,371 @@
+#include "ofCompressedTexture.h"
+#include "ofTexture.h"
+#include "ofPixels.h"
+#include "ofGLStateCache.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include <cstring>
+
+using namespace std;
+
+namespace{
+	const unsigned char ktxIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+	const size_t ktxHeaderSize = 64;
+	const size_t ddsHeaderSize = 128;
+	const size_t ddsDX10HeaderSize = 20;
+
+	uint32_t readUInt32(const char * data){
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	uint32_t swapUInt32(uint32_t value){
+		return ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) | ((value >> 8) & 0xFF00) | (value >> 24);
+	}
+
+	uint32_t fourCC(const char * code){
+		return uint32_t(code[0]) | (uint32_t(code[1]) << 8) | (uint32_t(code[2]) << 16) | (uint32_t(code[3]) << 24);
+	}
+
+	GLint getDXGIInternalFormat(uint32_t dxgiFormat){
+		switch(dxgiFormat){
+		case 71: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case 72: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+		case 74: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+		case 75: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+		case 77: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case 78: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+		case 80: return GL_COMPRESSED_RED_RGTC1;
+		case 81: return GL_COMPRESSED_SIGNED_RED_RGTC1;
+		case 83: return GL_COMPRESSED_RG_RGTC2;
+		case 84: return GL_COMPRESSED_SIGNED_RG_RGTC2;
+		case 95: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+		case 96: return GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+		case 98: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		case 99: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+		default: return 0;
+		}
+	}
+
+	GLint getBaseInternalFormat(GLint internalFormat){
+		switch(internalFormat){
+		case GL_COMPRESSED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+		case GL_COMPRESSED_R11_EAC:
+		case GL_COMPRESSED_SIGNED_R11_EAC:
+			return GL_RED;
+		case GL_COMPRESSED_RG_RGTC2:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+		case GL_COMPRESSED_RG11_EAC:
+		case GL_COMPRESSED_SIGNED_RG11_EAC:
+			return GL_RG;
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+		case GL_COMPRESSED_RGB8_ETC2:
+		case GL_COMPRESSED_SRGB8_ETC2:
+			return GL_RGB;
+		default:
+			return GL_RGBA;
+		}
+	}
+}
+
+//----------------------------------------------------------
+bool ofCompressedTextureData::load(const std::filesystem::path & path){
+	auto buffer = ofBufferFromFile(path, true);
+	if(buffer.size() == 0){
+		ofLogError("ofCompressedTextureData") << "load(): couldn't read " << path;
+		return false;
+	}
+	if(buffer.size() >= sizeof(ktxIdentifier) && memcmp(buffer.getData(), ktxIdentifier, sizeof(ktxIdentifier)) == 0){
+		return loadKTX(buffer);
+	}
+	if(buffer.size() >= 4 && memcmp(buffer.getData(), "DDS ", 4) == 0){
+		return loadDDS(buffer);
+	}
+	ofLogError("ofCompressedTextureData") << "load(): " << path << " is not a DDS or KTX file";
+	return false;
+}
+
+//----------------------------------------------------------
+bool ofCompressedTextureData::loadDDS(const ofBuffer & buffer){
+	clear();
+	auto data = buffer.getData();
+	if(buffer.size() < ddsHeaderSize || memcmp(data, "DDS ", 4) != 0){
+		ofLogError("ofCompressedTextureData") << "loadDDS(): not a DDS file";
+		return false;
+	}
+
+	int height = readUInt32(data + 12);
+	int width = readUInt32(data + 16);
+	uint32_t flags = readUInt32(data + 8);
+	// DDSD_MIPMAPCOUNT
+	size_t numLevels = (flags & 0x20000) ? std::max<uint32_t>(readUInt32(data + 28), 1) : 1;
+	uint32_t pixelFormatFlags = readUInt32(data + 80);
+	uint32_t code = readUInt32(data + 84);
+	uint32_t caps2 = readUInt32(data + 112);
+	size_t offset = ddsHeaderSize;
+
+	if(caps2 & 0x200){
+		ofLogError("ofCompressedTextureData") << "loadDDS(): cubemaps are not supported";
+		return false;
+	}
+
+	GLint format = 0;
+	if(code == fourCC("DXT1")){
+		// DDPF_ALPHAPIXELS
+		format = (pixelFormatFlags & 0x1) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	}else if(code == fourCC("DXT3")){
+		format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+	}else if(code == fourCC("DXT5")){
+		format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	}else if(code == fourCC("ATI1") || code == fourCC("BC4U")){
+		format = GL_COMPRESSED_RED_RGTC1;
+	}else if(code == fourCC("ATI2") || code == fourCC("BC5U")){
+		format = GL_COMPRESSED_RG_RGTC2;
+	}else if(code == fourCC("DX10")){
+		if(buffer.size() < ddsHeaderSize + ddsDX10HeaderSize){
+			ofLogError("ofCompressedTextureData") << "loadDDS(): truncated DX10 header";
+			return false;
+		}
+		uint32_t dxgiFormat = readUInt32(data + 128);
+		uint32_t miscFlag = readUInt32(data + 136);
+		uint32_t arraySize = readUInt32(data + 140);
+		if((miscFlag & 0x4) || arraySize > 1){
+			ofLogError("ofCompressedTextureData") << "loadDDS(): cubemaps and texture arrays are not supported";
+			return false;
+		}
+		format = getDXGIInternalFormat(dxgiFormat);
+		if(format == 0){
+			ofLogError("ofCompressedTextureData") << "loadDDS(): unsupported DXGI format " << dxgiFormat;
+			return false;
+		}
+		offset += ddsDX10HeaderSize;
+	}else{
+		ofLogError("ofCompressedTextureData") << "loadDDS(): only block compressed formats are supported";
+		return false;
+	}
+
+	auto blockSize = ofGLGetCompressedBlockSize(format);
+	for(size_t i = 0; i < numLevels && (width > 0 || height > 0); i++){
+		Level level;
+		level.width = std::max(width >> i, 1);
+		level.height = std::max(height >> i, 1);
+		size_t levelSize = ((level.width + 3) / 4) * ((level.height + 3) / 4) * blockSize;
+		if(offset + levelSize > buffer.size()){
+			ofLogError("ofCompressedTextureData") << "loadDDS(): truncated file, level " << i << " is missing";
+			clear();
+			return false;
+		}
+		level.data.set(data + offset, levelSize);
+		offset += levelSize;
+		levels.push_back(std::move(level));
+	}
+	if(levels.empty()){
+		ofLogError("ofCompressedTextureData") << "loadDDS(): texture has 0 width and height";
+		return false;
+	}
+	internalFormat = format;
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofCompressedTextureData::loadKTX(const ofBuffer & buffer){
+	clear();
+	auto data = buffer.getData();
+	if(buffer.size() < ktxHeaderSize || memcmp(data, ktxIdentifier, sizeof(ktxIdentifier)) != 0){
+		ofLogError("ofCompressedTextureData") << "loadKTX(): not a KTX file";
+		return false;
+	}
+
+	bool swap = readUInt32(data + 12) == 0x01020304;
+	auto field = [&](size_t offset){
+		auto value = readUInt32(data + offset);
+		return swap ? swapUInt32(value) : value;
+	};
+	uint32_t glType = field(16);
+	uint32_t glInternalFormat = field(28);
+	uint32_t width = field(36);
+	uint32_t height = field(40);
+	uint32_t depth = field(44);
+	uint32_t arrayElements = field(48);
+	uint32_t faces = field(52);
+	// 0 means the mipmaps should be generated when loading
+	size_t numLevels = std::max<uint32_t>(field(56), 1);
+	size_t offset = ktxHeaderSize + field(60);
+
+	if(glType != 0){
+		ofLogError("ofCompressedTextureData") << "loadKTX(): only compressed textures are supported";
+		return false;
+	}
+	if(faces != 1 || arrayElements > 0 || depth > 1 || height == 0){
+		ofLogError("ofCompressedTextureData") << "loadKTX(): only 2D textures are supported";
+		return false;
+	}
+
+	for(size_t i = 0; i < numLevels; i++){
+		if(offset + 4 > buffer.size()){
+			break;
+		}
+		size_t levelSize = field(offset);
+		offset += 4;
+		if(offset + levelSize > buffer.size()){
+			break;
+		}
+		Level level;
+		level.width = std::max<int>(width >> i, 1);
+		level.height = std::max<int>(height >> i, 1);
+		level.data.set(data + offset, levelSize);
+		levels.push_back(std::move(level));
+		// mipPadding
+		offset += (levelSize + 3) & ~size_t(3);
+	}
+	if(levels.size() != numLevels){
+		ofLogError("ofCompressedTextureData") << "loadKTX(): truncated file, found " << levels.size() << " of " << numLevels << " levels";
+		clear();
+		return false;
+	}
+	internalFormat = glInternalFormat;
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofCompressedTextureData::saveKTX(const std::filesystem::path & path) const{
+	if(!isAllocated()){
+		ofLogError("ofCompressedTextureData") << "saveKTX(): no data to save";
+		return false;
+	}
+
+	ofBuffer buffer;
+	buffer.append((const char*)ktxIdentifier, sizeof(ktxIdentifier));
+	auto append = [&](uint32_t value){
+		buffer.append((const char*)&value, sizeof(value));
+	};
+	append(0x04030201);
+	append(0); // glType
+	append(1); // glTypeSize
+	append(0); // glFormat
+	append(internalFormat);
+	append(getBaseInternalFormat(internalFormat));
+	append(getWidth());
+	append(getHeight());
+	append(0); // pixelDepth
+	append(0); // numberOfArrayElements
+	append(1); // numberOfFaces
+	append(levels.size());
+	append(0); // bytesOfKeyValueData
+	const char padding[3] = {0, 0, 0};
+	for(auto & level: levels){
+		append(level.data.size());
+		buffer.append(level.data.getData(), level.data.size());
+		buffer.append(padding, (4 - level.data.size() % 4) % 4);
+	}
+	return ofBufferToFile(path, buffer, true);
+}
+
+#ifndef TARGET_OPENGLES
+//----------------------------------------------------------
+bool ofCompressedTextureData::compress(const ofPixels & pixels, GLint format, bool mipmaps){
+	clear();
+	if(!pixels.isAllocated()){
+		ofLogError("ofCompressedTextureData") << "compress(): pixels not allocated";
+		return false;
+	}
+	if(!ofGLSupportsCompressedTextureFormat(format)){
+		ofLogError("ofCompressedTextureData") << "compress(): format 0x" << ofToHex(format) << " not supported by this graphics card";
+		return false;
+	}
+
+	GLuint id;
+	glGenTextures(1, &id);
+	ofGetGLStateCache().bindTexture(GL_TEXTURE_2D, id);
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT, pixels.getBytesStride());
+	glTexImage2D(GL_TEXTURE_2D, 0, format, pixels.getWidth(), pixels.getHeight(), 0, ofGetGlFormat(pixels), ofGetGlType(pixels), pixels.getData());
+	if(mipmaps){
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	GLint compressed = GL_FALSE;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+	if(compressed == GL_TRUE){
+		size_t numLevels = 1;
+		if(mipmaps){
+			numLevels += floor(log2(std::max(pixels.getWidth(), pixels.getHeight())));
+		}
+		for(size_t i = 0; i < numLevels; i++){
+			GLint width, height, size;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_WIDTH, &width);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_HEIGHT, &height);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+			Level level;
+			level.width = width;
+			level.height = height;
+			level.data.allocate(size);
+			glPixelStorei(GL_PACK_ALIGNMENT, 1);
+			glGetCompressedTexImage(GL_TEXTURE_2D, i, level.data.getData());
+			levels.push_back(std::move(level));
+		}
+		internalFormat = format;
+	}else{
+		ofLogError("ofCompressedTextureData") << "compress(): the driver couldn't compress to format 0x" << ofToHex(format);
+	}
+
+	ofGetGLStateCache().bindTexture(GL_TEXTURE_2D, 0);
+	glDeleteTextures(1, &id);
+	return isAllocated();
+}
+#endif
+
+//----------------------------------------------------------
+void ofCompressedTextureData::clear(){
+	internalFormat = 0;
+	levels.clear();
+}
+
+//----------------------------------------------------------
+bool ofCompressedTextureData::isAllocated() const{
+	return !levels.empty();
+}
+
+//----------------------------------------------------------
+GLint ofCompressedTextureData::getGLInternalFormat() const{
+	return internalFormat;
+}
+
+//----------------------------------------------------------
+int ofCompressedTextureData::getWidth() const{
+	return levels.empty() ? 0 : levels[0].width;
+}
+
+//----------------------------------------------------------
+int ofCompressedTextureData::getHeight() const{
+	return levels.empty() ? 0 : levels[0].height;
+}
+
+//----------------------------------------------------------
+size_t ofCompressedTextureData::size() const{
+	size_t total = 0;
+	for(auto & level: levels){
+		total += level.data.size();
+	}
+	return total;
+}
+
+//----------------------------------------------------------
+size_t ofCompressedTextureData::getNumLevels() const{
+	return levels.size();
+}
+
+//----------------------------------------------------------
+const ofCompressedTextureData::Level & ofCompressedTextureData::getLevel(size_t level) const{
+	return levels[level];
+}
+
+//----------------------------------------------------------
+bool ofLoadCompressedTexture(ofTexture & tex, const std::filesystem::path & path){
+	ofCompressedTextureData data;
+	return data.load(path) && tex.loadData(data);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ofGLUtils.h"
+#include "ofFileUtils.h"
+
+class ofTexture;
+
+/// \brief GPU compressed image data with its mipmap chain, as stored in DDS
+/// and KTX files
+///
+/// Block compressed formats (BC1-7, ETC2/EAC, ASTC) are sampled directly by
+/// the GPU, so textures loaded from them use 4 to 8 times less memory and
+/// bandwidth than RGBA8 and don't need to be decoded or have their mipmaps
+/// generated when loading:
+///
+/// ~~~~{.cpp}
+/// ofTexture tex;
+/// ofLoadCompressedTexture(tex, "terrain.ktx");
+/// ~~~~
+///
+/// The data is kept as the blocks in the file, check that the graphics card
+/// supports the format with ofGLSupportsCompressedTextureFormat(): BCn is
+/// usually available on desktop, ETC2 and ASTC on mobile.
+class ofCompressedTextureData{
+public:
+	struct Level{
+		int width = 0;
+		int height = 0;
+		ofBuffer data;
+	};
+
+	/// \brief Loads a DDS or KTX file, detecting the container from its
+	/// contents
+	bool load(const std::filesystem::path & path);
+
+	/// \brief Loads a DDS file with a 2D texture in a DXT1/3/5, BC4/5 or,
+	/// with the DX10 header, BC6H/7 format
+	bool loadDDS(const ofBuffer & buffer);
+
+	/// \brief Loads a KTX 1 file with a 2D compressed texture
+	bool loadKTX(const ofBuffer & buffer);
+
+	/// \brief Saves the levels as a KTX 1 file
+	bool saveKTX(const std::filesystem::path & path) const;
+
+#ifndef TARGET_OPENGLES
+	/// \brief Compresses pixels to internalFormat with the graphics driver
+	///
+	/// Meant for converting assets offline, the driver's encoders are fast
+	/// but of lower quality than dedicated tools. Needs a GL context.
+	///
+	/// \param internalFormat a compressed format like GL_COMPRESSED_RGBA_BPTC_UNORM
+	/// \param mipmaps whether to generate and store the whole mipmap chain
+	bool compress(const ofPixels & pixels, GLint internalFormat, bool mipmaps = true);
+#endif
+
+	void clear();
+	bool isAllocated() const;
+
+	GLint getGLInternalFormat() const;
+	int getWidth() const;
+	int getHeight() const;
+
+	/// \brief Total size in bytes of all the levels
+	std::size_t size() const;
+
+	std::size_t getNumLevels() const;
+	const Level & getLevel(std::size_t level) const;
+
+private:
+	GLint internalFormat = 0;
+	std::vector<Level> levels;
+};
+
+/// \brief Loads a DDS or KTX file into tex with its mipmaps
+/// \returns false if the file can't be read or the graphics card
+/// doesn't support its format
+bool ofLoadCompressedTexture(ofTexture & tex, const std::filesystem::path & path);
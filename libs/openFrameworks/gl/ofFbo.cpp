@@ -4,6 +4,9 @@
 #include "ofUtils.h"
 #include "ofGraphics.h"
 #include "ofGLRenderer.h"
+#include "ofPixelReadback.h"
+#include "ofRenderStats.h"
+#include "ofGpuMemory.h"
 #include <map>
 
 #ifdef TARGET_OPENGLES
@@ -214,10 +217,12 @@ static void releaseRB(GLuint id){
 		getIdsRB()[id]--;
 		if(getIdsRB()[id]==0){
 			glDeleteRenderbuffers(1, &id);
+			of::priv::gpuMemoryReleased(OF_GPU_MEMORY_RENDERBUFFER, id);
 		}
 	}else{
 		ofLogWarning("ofFbo") << "releaseRB(): something's wrong here, releasing unknown render buffer id " << id;
 		glDeleteRenderbuffers(1, &id);
+		of::priv::gpuMemoryReleased(OF_GPU_MEMORY_RENDERBUFFER, id);
 	}
 }
 
@@ -478,7 +483,56 @@ void ofFbo::clearStencilBuffer(int value){
 void ofFbo::clearDepthStencilBuffer(float depth, int stencil){
 	glClearBufferfi(GL_DEPTH_STENCIL, 0, depth, stencil);
 }
+
+//--------------------------------------------------------------
+void ofFbo::clearColorBuffers(const vector<int> & attachments, const ofFloatColor & color){
+	for(auto attachment: attachments){
+		glClearBufferfv(GL_COLOR, attachment, &color.r);
+	}
+}
+#endif
+
+//--------------------------------------------------------------
+bool ofFbo::isInvalidateSupported(){
+#if defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_0)
+	return ofGetGLRenderer() && ofGetGLRenderer()->getGLVersionMajor() >= 3;
+#elif !defined(TARGET_OPENGLES) && defined(GLEW_ARB_invalidate_subdata)
+	return GLEW_VERSION_4_3 || GLEW_ARB_invalidate_subdata;
+#else
+	return false;
 #endif
+}
+
+//--------------------------------------------------------------
+void ofFbo::invalidate(const vector<int> & colorAttachments, bool depth, bool stencil){
+	if(!bIsAllocated) return;
+	vector<GLenum> attachments;
+	attachments.reserve(colorAttachments.size() + 2);
+	for(auto attachment: colorAttachments){
+		if(attachment < 0 || attachment >= getNumTextures()){
+			ofLogWarning("ofFbo") << "invalidate(): fbo " << fbo << " has no color attachment " << attachment;
+			continue;
+		}
+		attachments.push_back(GL_COLOR_ATTACHMENT0 + attachment);
+		if(fbo != fboTextures){
+			// the multisampled contents are undefined from now on, there's
+			// nothing worth resolving into the texture
+			invalidated.resize(dirty.size(), false);
+			invalidated[attachment] = true;
+			dirty[attachment] = false;
+		}
+	}
+	if(depth){
+		attachments.push_back(GL_DEPTH_ATTACHMENT);
+	}
+	if(stencil){
+		attachments.push_back(GL_STENCIL_ATTACHMENT);
+	}
+	if(attachments.empty() || !isInvalidateSupported()) return;
+#if (defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_0)) || (!defined(TARGET_OPENGLES) && defined(GLEW_ARB_invalidate_subdata))
+	glInvalidateFramebuffer(GL_FRAMEBUFFER, attachments.size(), attachments.data());
+#endif
+}
 
 //--------------------------------------------------------------
 void ofFbo::destroy() {
@@ -617,6 +671,7 @@ void ofFbo::allocate(Settings _settings) {
 	// simplicity and readability .
 
 	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFboId);
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	//- USE REGULAR RENDER BUFFER
@@ -693,6 +748,7 @@ void ofFbo::allocate(Settings _settings) {
 
 	// if textures are attached to a different fbo (e.g. if using MSAA) check it's status
 	if(fbo != fboTextures) {
+		of::priv::currentRenderStats().fboBinds++;
 		glBindFramebuffer(GL_FRAMEBUFFER, fboTextures);
 	}
 
@@ -700,6 +756,7 @@ void ofFbo::allocate(Settings _settings) {
 	bIsAllocated = checkStatus();
 
 	// restore previous framebuffer id
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, previousFboId);
 
     /* UNCOMMENT OUTSIDE OF DOING RELEASES
@@ -736,13 +793,18 @@ GLuint ofFbo::createAndAttachRenderbuffer(GLenum internalFormat, GLenum attachme
 	} else {
 		glRenderbufferStorageMultisample(GL_RENDERBUFFER, settings.numSamples, internalFormat, settings.width, settings.height);
 	}
+	uint64_t bytes = of::priv::gpuMemoryBytes(internalFormat, settings.width, settings.height) * std::max(settings.numSamples, 1);
 #else
 	if(ofGLSupportsNPOTTextures()){
 		glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, settings.width, settings.height);
 	}else{
 		glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, ofNextPow2(settings.width), ofNextPow2(settings.height));
 	}
+	uint64_t bytes = ofGLSupportsNPOTTextures() ?
+		of::priv::gpuMemoryBytes(internalFormat, settings.width, settings.height) :
+		of::priv::gpuMemoryBytes(internalFormat, ofNextPow2(settings.width), ofNextPow2(settings.height));
 #endif
+	of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_RENDERBUFFER, buffer, bytes);
 	glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachmentPoint, GL_RENDERBUFFER, buffer);
 	return buffer;
 }
@@ -775,6 +837,7 @@ void ofFbo::attachTexture(ofTexture & tex, GLenum internalFormat, GLenum attachm
     // bind fbo for textures (if using MSAA this is the newly created fbo, otherwise its the same fbo as before)
 	GLint temp;
 	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &temp);
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, fboTextures);
     
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachmentPoint, tex.texData.textureTarget, tex.texData.textureID, 0);
@@ -789,12 +852,14 @@ void ofFbo::attachTexture(ofTexture & tex, GLenum internalFormat, GLenum attachm
     
 	// if MSAA, bind main fbo and attach renderbuffer
 	if(settings.numSamples) {
+		of::priv::currentRenderStats().fboBinds++;
 		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
         
 		GLuint colorBuffer = createAndAttachRenderbuffer(internalFormat, GL_COLOR_ATTACHMENT0 + attachmentPoint);
 		colorBuffers.push_back(colorBuffer);
 		retainRB(colorBuffer);
 	}
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, temp);
 
 }
@@ -918,11 +983,15 @@ void ofFbo::flagDirty() const{
 		// flagged dirty at activation, so we can be sure all buffers which have 
 		// been rendered to are flagged dirty.
 		// 
+		// Buffers invalidated while bound have undefined contents, so they
+		// stay clean instead.
+		//
 		int numBuffersToFlag = min(dirty.size(), activeDrawBuffers.size());
 		for(int i=0; i < numBuffersToFlag; i++){
-			dirty[i] = true;
+			dirty[i] = i >= (int)invalidated.size() || !invalidated[i];
 		}
 	}
+	invalidated.clear();
 }
 
 //----------------------------------------------------------
@@ -1053,6 +1122,7 @@ void ofFbo::readToPixels(ofPixels & pixels, int attachmentPoint) const{
 	pixels.allocate(settings.width,settings.height,ofGetImageTypeFromGLType(settings.internalformat));
 	bind();
 	int format = ofGetGLFormatFromInternal(settings.internalformat);
+	of::priv::currentRenderStats().readbacks++;
 	glReadPixels(0,0,settings.width, settings.height, format, GL_UNSIGNED_BYTE, pixels.getData());
 	unbind();
 #endif
@@ -1067,6 +1137,7 @@ void ofFbo::readToPixels(ofShortPixels & pixels, int attachmentPoint) const{
 	pixels.allocate(settings.width,settings.height,ofGetImageTypeFromGLType(settings.internalformat));
 	bind();
 	int format = ofGetGLFormatFromInternal(settings.internalformat);
+	of::priv::currentRenderStats().readbacks++;
 	glReadPixels(0,0,settings.width, settings.height, format, GL_UNSIGNED_SHORT, pixels.getData());
 	unbind();
 #endif
@@ -1081,21 +1152,76 @@ void ofFbo::readToPixels(ofFloatPixels & pixels, int attachmentPoint) const{
 	pixels.allocate(settings.width,settings.height,ofGetImageTypeFromGLType(settings.internalformat));
 	bind();
 	int format = ofGetGLFormatFromInternal(settings.internalformat);
+	of::priv::currentRenderStats().readbacks++;
 	glReadPixels(0,0,settings.width, settings.height, format, GL_FLOAT, pixels.getData());
 	unbind();
 #endif
 }
 
+//----------------------------------------------------------
+void ofFbo::readToPixels(ofPixels & pixels, const ofRectangle & region, int attachmentPoint) const{
+	if(!bIsAllocated) return;
+	getTexture(attachmentPoint).readToPixels(pixels, region);
+}
+
+//----------------------------------------------------------
+void ofFbo::readToPixels(ofShortPixels & pixels, const ofRectangle & region, int attachmentPoint) const{
+	if(!bIsAllocated) return;
+	getTexture(attachmentPoint).readToPixels(pixels, region);
+}
+
+//----------------------------------------------------------
+void ofFbo::readToPixels(ofFloatPixels & pixels, const ofRectangle & region, int attachmentPoint) const{
+	if(!bIsAllocated) return;
+	getTexture(attachmentPoint).readToPixels(pixels, region);
+}
+
 #ifndef TARGET_OPENGLES
+//----------------------------------------------------------
+void ofFbo::copyTo(ofBufferObject & buffer, const ofRectangle & region, int attachmentPoint) const{
+	if(!bIsAllocated) return;
+	getTexture(attachmentPoint).copyTo(buffer, region);
+}
+
 //----------------------------------------------------------
 void ofFbo::copyTo(ofBufferObject & buffer) const{
 	if(!bIsAllocated) return;
 	bind();
 	buffer.bind(GL_PIXEL_PACK_BUFFER);
+	of::priv::currentRenderStats().readbacks++;
 	glReadPixels(0, 0, settings.width, settings.height, ofGetGLFormatFromInternal(settings.internalformat), ofGetGlTypeFromInternal(settings.internalformat), NULL);
 	buffer.unbind(GL_PIXEL_PACK_BUFFER);
 	unbind();
 }
+
+//----------------------------------------------------------
+ofPixelReadback & ofFbo::getAsyncReadback() const{
+	if(!asyncReadback){
+		asyncReadback = std::make_shared<ofPixelReadback>();
+	}
+	return *asyncReadback;
+}
+
+//----------------------------------------------------------
+bool ofFbo::readToPixelsAsync(int attachmentPoint) const{
+	if(!bIsAllocated) return false;
+	return getAsyncReadback().read(*this, attachmentPoint);
+}
+
+//----------------------------------------------------------
+bool ofFbo::getAsyncPixels(ofPixels & pixels) const{
+	return asyncReadback && asyncReadback->getPixels(pixels);
+}
+
+//----------------------------------------------------------
+bool ofFbo::getAsyncPixels(ofShortPixels & pixels) const{
+	return asyncReadback && asyncReadback->getPixels(pixels);
+}
+
+//----------------------------------------------------------
+bool ofFbo::getAsyncPixels(ofFloatPixels & pixels) const{
+	return asyncReadback && asyncReadback->getPixels(pixels);
+}
 #endif
 
 //----------------------------------------------------------
@@ -1115,9 +1241,14 @@ void ofFbo::updateTexture(int attachmentPoint) {
 
 		auto renderer = settings.renderer.lock();
 		if(renderer){
+			// unbinding flags every active buffer dirty again, keep the
+			// attachments that were already resolved clean so each one is
+			// only blitted once per render
+			auto wasDirty = dirty;
 			renderer->bindForBlitting(*this,*this,attachmentPoint);
 			glBlitFramebuffer(0, 0, settings.width, settings.height, 0, 0, settings.width, settings.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 			renderer->unbind(*this);
+			dirty = wasDirty;
 		
 			glReadBuffer(GL_BACK);
 		}
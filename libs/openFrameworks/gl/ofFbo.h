@@ -62,8 +62,37 @@ public:
 	///
 	/// @see: https://www.opengl.org/wiki/GLAPI/glClearBuffer
 	void clearDepthStencilBuffer(float depth, int stencil);
+
+	/// glClearBufferfv(GL_COLOR, buffer_idx...) for each of the attachments,
+	/// clears only some targets of a multiple render target fbo, like the
+	/// G-buffer of a deferred renderer, and leaves the rest untouched.
+	///
+	/// The attachments have to be active draw buffers, see setActiveDrawBuffers()
+	void clearColorBuffers(const std::vector<int> & attachments, const ofFloatColor & color);
 #endif
 
+	/// \brief   Tells the driver the contents of some attachments won't be
+	///          read anymore, so it doesn't need to store or resolve them.
+	///
+	/// Call it while the fbo is bound, after the last draw that reads them
+	/// and before end(), for transient attachments like the depth buffer or
+	/// the G-buffer targets of a deferred renderer once the lighting pass
+	/// consumed them. On tiled GPUs this saves writing them back to memory.
+	///
+	/// If the fbo uses MSAA the invalidated attachments aren't resolved
+	/// into their textures on getTexture() until they are drawn to again.
+	///
+	/// Uses glInvalidateFramebuffer so it needs OpenGL 4.3,
+	/// ARB_invalidate_subdata or OpenGL ES 3, does nothing otherwise.
+	///
+	/// \param colorAttachments indices of the color attachments to invalidate
+	/// \param depth invalidate the depth attachment
+	/// \param stencil invalidate the stencil attachment
+	void invalidate(const std::vector<int> & colorAttachments, bool depth = false, bool stencil = false);
+
+	/// \brief   If invalidate() is supported by the current context
+	static bool isInvalidateSupported();
+
 	using ofBaseDraws::draw;
 	void draw(float x, float y) const;
 	void draw(float x, float y, float width, float height) const;
@@ -136,10 +165,41 @@ public:
 	void readToPixels(ofShortPixels & pixels, int attachmentPoint = 0) const;
 	void readToPixels(ofFloatPixels & pixels, int attachmentPoint = 0) const;
 
+	/// \brief Reads only a region of an attachment into pixels.
+	///
+	/// The region is in pixels from the first row of the attachment, see
+	/// ofTexture::readToPixels(ofPixels &, const ofRectangle &). Multisampled
+	/// fbos are resolved first.
+	void readToPixels(ofPixels & pixels, const ofRectangle & region, int attachmentPoint = 0) const;
+	void readToPixels(ofShortPixels & pixels, const ofRectangle & region, int attachmentPoint = 0) const;
+	void readToPixels(ofFloatPixels & pixels, const ofRectangle & region, int attachmentPoint = 0) const;
+
 #ifndef TARGET_OPENGLES
 	/// \brief Copy the fbo to an ofBufferObject.
 	/// \param buffer the target buffer to copy to.
 	void copyTo(ofBufferObject & buffer) const;
+
+	/// \brief Copy only a region of an attachment to an ofBufferObject,
+	/// tightly packed.
+	void copyTo(ofBufferObject & buffer, const ofRectangle & region, int attachmentPoint = 0) const;
+
+	/// \brief Start reading an attachment back to the CPU without blocking.
+	///
+	/// Like readToPixels() but the copy goes to a pool of pixel buffers
+	/// owned by the fbo and the result is collected some frames later with
+	/// getAsyncPixels(), so the GPU pipeline doesn't stall.
+	///
+	/// \returns false if all the buffers in the pool are still in use.
+	bool readToPixelsAsync(int attachmentPoint = 0) const;
+
+	/// \brief Collect the oldest completed readToPixelsAsync().
+	/// \returns false if no read has been completed yet.
+	bool getAsyncPixels(ofPixels & pixels) const;
+	bool getAsyncPixels(ofShortPixels & pixels) const;
+	bool getAsyncPixels(ofFloatPixels & pixels) const;
+
+	/// \brief The pool of buffers used by readToPixelsAsync()
+	ofPixelReadback & getAsyncReadback() const;
 #endif
 	
 	float getWidth() const;
@@ -172,6 +232,9 @@ public:
 	///           into the texture call this to blit from the colorbuffer into the texture 
 	///           so we can use the results for rendering, or input to a shader etc.
 	/// \note     This will get called implicitly upon getTexture();
+	/// \note     Only attachments that were drawn to since their last
+	///           resolve are blitted, each one on demand, so attachments
+	///           that are never read don't cost a resolve.
 	void updateTexture(int attachmentPoint);
 
 
@@ -256,8 +319,15 @@ private:
 	///         the texture will be resolved through blitting the renderbuffer into it.
 	mutable std::vector<bool> dirty;
 
+	/// \brief  Attachments invalidated while bound, flagDirty() leaves them
+	///         clean on unbind and resets this, sized on demand by invalidate()
+	mutable std::vector<bool> invalidated;
+
 	int 				defaultTextureIndex; //used for getTextureReference
 	bool				bIsAllocated;
+#ifndef TARGET_OPENGLES
+	mutable std::shared_ptr<ofPixelReadback> asyncReadback;
+#endif
 	void reloadFbo();
 #ifdef TARGET_OPENGLES
 	static bool bglFunctionsInitialized;
@@ -0,0 +1,127 @@
+#include "ofFboPool.h"
+#include "ofAppRunner.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace{
+	// ofFbo::Settings::operator!= logs every difference, this is used to
+	// search for a match and has to stay quiet
+	bool sameSettings(const ofFbo::Settings & a, const ofFbo::Settings & b){
+		return a.width == b.width &&
+			a.height == b.height &&
+			a.numColorbuffers == b.numColorbuffers &&
+			a.colorFormats == b.colorFormats &&
+			a.useDepth == b.useDepth &&
+			a.useStencil == b.useStencil &&
+			a.depthStencilAsTexture == b.depthStencilAsTexture &&
+			a.textureTarget == b.textureTarget &&
+			a.internalformat == b.internalformat &&
+			a.depthStencilInternalFormat == b.depthStencilInternalFormat &&
+			a.wrapModeHorizontal == b.wrapModeHorizontal &&
+			a.wrapModeVertical == b.wrapModeVertical &&
+			a.minFilter == b.minFilter &&
+			a.maxFilter == b.maxFilter &&
+			a.numSamples == b.numSamples;
+	}
+}
+
+struct ofFboPool::Data{
+	struct Entry{
+		ofFbo::Settings settings;
+		unique_ptr<ofFbo> fbo;
+		uint64_t lastUsed;
+	};
+	vector<Entry> free;
+	size_t numAllocated = 0;
+	uint64_t maxUnusedFrames = 2;
+};
+
+//----------------------------------------------------------
+ofFboPool::ofFboPool()
+:data(make_shared<Data>()){}
+
+//----------------------------------------------------------
+ofFboPool::~ofFboPool(){}
+
+//----------------------------------------------------------
+shared_ptr<ofFbo> ofFboPool::acquire(const ofFbo::Settings & settings){
+	purge();
+
+	unique_ptr<ofFbo> fbo;
+	auto found = find_if(data->free.begin(), data->free.end(), [&](const Data::Entry & entry){
+		return sameSettings(entry.settings, settings);
+	});
+	if(found != data->free.end()){
+		fbo = std::move(found->fbo);
+		data->free.erase(found);
+	}else{
+		fbo.reset(new ofFbo);
+		fbo->allocate(settings);
+		data->numAllocated++;
+	}
+
+	weak_ptr<Data> weakData = data;
+	return shared_ptr<ofFbo>(fbo.release(), [weakData, settings](ofFbo * fbo){
+		auto data = weakData.lock();
+		if(data){
+			data->free.push_back({settings, unique_ptr<ofFbo>(fbo), ofGetFrameNum()});
+		}else{
+			delete fbo;
+		}
+	});
+}
+
+//----------------------------------------------------------
+shared_ptr<ofFbo> ofFboPool::acquire(int width, int height, int internalformat, int numSamples){
+	ofFbo::Settings settings;
+	settings.width = width;
+	settings.height = height;
+	settings.internalformat = internalformat;
+	settings.numSamples = numSamples;
+	return acquire(settings);
+}
+
+//----------------------------------------------------------
+void ofFboPool::setMaxUnusedFrames(uint64_t frames){
+	data->maxUnusedFrames = frames;
+}
+
+//----------------------------------------------------------
+uint64_t ofFboPool::getMaxUnusedFrames() const{
+	return data->maxUnusedFrames;
+}
+
+//----------------------------------------------------------
+void ofFboPool::purge(){
+	auto frame = ofGetFrameNum();
+	auto maxUnusedFrames = data->maxUnusedFrames;
+	auto unused = remove_if(data->free.begin(), data->free.end(), [&](const Data::Entry & entry){
+		return frame > entry.lastUsed + maxUnusedFrames;
+	});
+	data->numAllocated -= std::distance(unused, data->free.end());
+	data->free.erase(unused, data->free.end());
+}
+
+//----------------------------------------------------------
+void ofFboPool::clear(){
+	data->numAllocated -= data->free.size();
+	data->free.clear();
+}
+
+//----------------------------------------------------------
+size_t ofFboPool::getNumAllocated() const{
+	return data->numAllocated;
+}
+
+//----------------------------------------------------------
+size_t ofFboPool::getNumFree() const{
+	return data->free.size();
+}
+
+//----------------------------------------------------------
+ofFboPool & ofGetFboPool(){
+	// never destroyed, the fbos can't be deleted after the GL context
+	static ofFboPool * pool = new ofFboPool;
+	return *pool;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofFbo.h"
+#include <memory>
+#include <vector>
+
+/// \brief Hands out transient fbos for post processing chains and render
+/// passes, reusing them once they are released
+///
+/// Instead of every effect keeping its own full resolution ofFbo, each
+/// pass acquires a target with the size and format it needs and drops it
+/// as soon as its output has been consumed by the next pass. The fbo then
+/// goes back to the pool and the next pass asking for the same settings
+/// gets it, so passes that don't overlap in time share the same memory:
+///
+/// ~~~~{.cpp}
+/// auto scene = pool.acquire(ofGetWidth(), ofGetHeight(), GL_RGBA16F);
+/// scene->begin();
+/// drawScene();
+/// scene->end();
+///
+/// for(auto & effect: effects){
+///     auto output = pool.acquire(ofGetWidth(), ofGetHeight(), GL_RGBA16F);
+///     output->begin();
+///     effect.draw(scene->getTexture());
+///     output->end();
+///     scene = output; // the previous target goes back to the pool
+/// }
+/// scene->draw(0, 0);
+/// ~~~~
+///
+/// A chain of any length only keeps two targets alive. Fbos that stay
+/// unused in the pool for more than getMaxUnusedFrames() frames are freed.
+///
+/// The contents of an acquired fbo are undefined, clear it or draw the
+/// whole of it. Acquired fbos can outlive the pool, they are deleted
+/// instead of returned if it's gone. Has to be used from the GL thread.
+class ofFboPool{
+public:
+	ofFboPool();
+	~ofFboPool();
+
+	ofFboPool(const ofFboPool &) = delete;
+	ofFboPool & operator=(const ofFboPool &) = delete;
+
+	/// \brief Returns a free fbo allocated with settings, allocating a
+	/// new one if there's none
+	///
+	/// The fbo goes back to the pool when the last copy of the returned
+	/// pointer is destroyed.
+	std::shared_ptr<ofFbo> acquire(const ofFbo::Settings & settings);
+
+	/// \brief Returns a free fbo with one color buffer of the passed size
+	/// and format
+	std::shared_ptr<ofFbo> acquire(int width, int height, int internalformat = GL_RGBA, int numSamples = 0);
+
+	/// \brief Number of frames a released fbo stays in the pool before it's
+	/// freed, 2 by default so targets used every frame are never freed
+	void setMaxUnusedFrames(uint64_t frames);
+	uint64_t getMaxUnusedFrames() const;
+
+	/// \brief Frees the fbos that have been unused for longer than
+	/// getMaxUnusedFrames(), called from acquire()
+	void purge();
+
+	/// \brief Frees all the fbos currently in the pool
+	void clear();
+
+	/// \brief Number of fbos allocated by the pool, acquired or free
+	std::size_t getNumAllocated() const;
+
+	/// \brief Number of fbos waiting in the pool to be acquired
+	std::size_t getNumFree() const;
+
+private:
+	struct Data;
+	std::shared_ptr<Data> data;
+};
+
+/// \brief A pool shared by the whole application
+ofFboPool & ofGetFboPool();
@@ -4,15 +4,21 @@
 #include "ofMesh.h"
 #include "ofBitmapFont.h"
 #include "ofGLUtils.h"
+#include "ofGLStateCache.h"
+#include "ofRenderStats.h"
 #include "ofImage.h"
 #include "ofFbo.h"
 #include "ofVbo.h"
+#include "ofInstancedMesh.h"
 #include "of3dPrimitives.h"
 #include "ofLight.h"
 #include "ofMaterial.h"
 #include "ofCamera.h"
 #include "ofTrueTypeFont.h"
 #include "ofNode.h"
+#include "ofGpuStrokes.h"
+#include <limits>
+#include <cstring>
 
 using namespace std;
 
@@ -22,10 +28,13 @@ static const string MODELVIEW_MATRIX_UNIFORM="modelViewMatrix";
 static const string PROJECTION_MATRIX_UNIFORM="projectionMatrix";
 static const string MODELVIEW_PROJECTION_MATRIX_UNIFORM="modelViewProjectionMatrix";
 static const string TEXTURE_MATRIX_UNIFORM="textureMatrix";
+static const string MATRICES_BLOCK="ofMatrices";
 static const string COLOR_UNIFORM="globalColor";
 
 static const string USE_TEXTURE_UNIFORM="usingTexture";
 static const string USE_COLORS_UNIFORM="usingColors";
+static const string USE_INSTANCE_COLORS_UNIFORM="usingInstanceColors";
+static const string TEXTURE_LAYER_UNIFORM="textureLayer";
 static const string BITMAP_STRING_UNIFORM="bitmapText";
 
 
@@ -49,8 +58,17 @@ ofGLProgrammableRenderer::ofGLProgrammableRenderer(const ofAppBaseWindow * _wind
 	lineMesh.setMode(OF_PRIMITIVE_LINES);
 	triangleMesh.getVertices().resize(3);
 	rectMesh.getVertices().resize(4);
+	batchMesh.setMode(OF_PRIMITIVE_TRIANGLES);
+	flushingBatch = false;
+	primitiveBatching = false;
+#ifndef TARGET_OPENGLES
+	streamVao = 0;
+	streamRegion = nullptr;
+	streamOffset = 0;
+#endif
 
 	bitmapStringEnabled = false;
+	distanceFieldEnabled = false;
     verticesEnabled = true;
     colorsEnabled = false;
     texCoordsEnabled = false;
@@ -58,6 +76,8 @@ ofGLProgrammableRenderer::ofGLProgrammableRenderer(const ofAppBaseWindow * _wind
 	settingDefaultShader = false;
 	usingVideoShader = false;
 	usingCustomShader = false;
+	instancingEnabled = false;
+	instanceColorsEnabled = false;
 
 	wrongUseLoggedOnce = false;
 
@@ -66,6 +86,7 @@ ofGLProgrammableRenderer::ofGLProgrammableRenderer(const ofAppBaseWindow * _wind
 	currentShader = nullptr;
 
 	currentTextureTarget = OF_NO_TEXTURE;
+	currentTextureLayer = 0;
 	currentMaterial = nullptr;
 	alphaMaskTextureTarget = OF_NO_TEXTURE;
 
@@ -81,6 +102,8 @@ ofGLProgrammableRenderer::ofGLProgrammableRenderer(const ofAppBaseWindow * _wind
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::startRender() {
+	// every window can have its own context with its own state
+	ofGetGLStateCache().invalidate();
 	currentFramebufferId = defaultFramebufferId;
 	framebufferIdStack.push_back(defaultFramebufferId);
 	matrixStack.setRenderSurface(*window);
@@ -102,8 +125,17 @@ void ofGLProgrammableRenderer::startRender() {
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::finishRender() {
+	flushPrimitiveBatch();
+#ifndef TARGET_OPENGLES
+	if(streamRegion){
+		// the next frame streams to the next region, this one is reused
+		// once the GPU is done with the draws issued from it
+		streamBuffer.lockCurrentRegion();
+		streamRegion = nullptr;
+	}
+#endif
 	if (!uniqueShader) {
-		glUseProgram(0);
+		ofGetGLStateCache().useProgram(0);
 		if(!usingCustomShader) currentShader = nullptr;
 	}
 	matrixStack.clearStacks();
@@ -112,6 +144,7 @@ void ofGLProgrammableRenderer::finishRender() {
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode renderType, bool useColors, bool useTextures, bool useNormals) const{
+	flushPrimitiveBatch();
 	if (vertexData.getVertices().empty()) return;
 	
 	
@@ -171,17 +204,23 @@ void ofGLProgrammableRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode
 	}
 
 	if(vertexData.getNumIndices()){
+		of::priv::countDraw(drawMode, vertexData.getNumIndices());
 		glDrawElements(drawMode, vertexData.getNumIndices(),GL_UNSIGNED_SHORT,vertexData.getIndexPointer());
 	}else{
+		of::priv::countDraw(drawMode, vertexData.getNumVertices());
 		glDrawArrays(drawMode, 0, vertexData.getNumVertices());
 	}
 #else
 	
 
 #ifndef TARGET_OPENGLES
-	meshVbo.setMesh(vertexData, GL_STREAM_DRAW, useColors, useTextures, useNormals);
 	glPolygonMode(GL_FRONT_AND_BACK, ofGetGLPolyMode(renderType));
 	GLenum drawMode = ofGetGLPrimitiveMode(vertexData.getMode());
+	if(drawStreamed(vertexData, drawMode, useColors, useTextures, useNormals)){
+		glPolygonMode(GL_FRONT_AND_BACK, currentStyle.bFill ?  GL_FILL : GL_LINE);
+		return;
+	}
+	meshVbo.setMesh(vertexData, GL_STREAM_DRAW, useColors, useTextures, useNormals);
 #else
 	meshVbo.setMesh(vertexData, GL_STATIC_DRAW, useColors, useTextures, useNormals);
 	GLenum drawMode;
@@ -221,6 +260,96 @@ void ofGLProgrammableRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode
 	//if (bSmoothHinted) endSmoothing();
 }
 
+#ifndef TARGET_OPENGLES
+//----------------------------------------------------------
+bool ofGLProgrammableRenderer::drawStreamed(const ofMesh & vertexData, GLenum drawMode, bool useColors, bool useTextures, bool useNormals) const{
+	if(!ofBufferObject::isPersistentMappingSupported()){
+		return false;
+	}
+
+	// attributes with less elements than vertices would be read past
+	// their end, meshVbo handles those
+	std::size_t numVertices = vertexData.getNumVertices();
+	useColors &= vertexData.getNumColors()>0;
+	useTextures &= vertexData.getNumTexCoords()>0;
+	useNormals &= vertexData.getNumNormals()>0;
+	if((useColors && vertexData.getNumColors()<numVertices) ||
+	   (useTextures && vertexData.getNumTexCoords()<numVertices) ||
+	   (useNormals && vertexData.getNumNormals()<numVertices)){
+		return false;
+	}
+
+	auto aligned = [](GLsizeiptr bytes){
+		return (bytes + 15) & ~GLsizeiptr(15);
+	};
+	GLsizeiptr positionBytes = aligned(numVertices * sizeof(glm::vec3));
+	GLsizeiptr colorBytes = useColors ? aligned(numVertices * sizeof(ofFloatColor)) : 0;
+	GLsizeiptr texCoordBytes = useTextures ? aligned(numVertices * sizeof(glm::vec2)) : 0;
+	GLsizeiptr normalBytes = useNormals ? aligned(numVertices * sizeof(glm::vec3)) : 0;
+	GLsizeiptr indexBytes = aligned(vertexData.getNumIndices() * sizeof(ofIndexType));
+	GLsizeiptr bytes = positionBytes + colorBytes + texCoordBytes + normalBytes + indexBytes;
+
+	if(!streamBuffer.isPersistentlyMapped()){
+		streamBuffer.allocatePersistentRing(4 * 1024 * 1024);
+		if(!streamBuffer.isPersistentlyMapped()){
+			return false;
+		}
+		glGenVertexArrays(1, &streamVao);
+	}
+	if(bytes > streamBuffer.getRegionSize()){
+		return false;
+	}
+	if(!streamRegion){
+		streamRegion = static_cast<char*>(streamBuffer.mapNextRegion());
+		streamOffset = 0;
+	}
+	if(streamOffset + bytes > streamBuffer.getRegionSize()){
+		// the region of this frame is full, the rest of the frame goes
+		// through meshVbo
+		return false;
+	}
+
+	GLintptr base = streamBuffer.getCurrentRegionOffset() + streamOffset;
+	char * dst = streamRegion + streamOffset;
+	streamOffset += bytes;
+	of::priv::currentRenderStats().bufferUploadBytes += bytes;
+
+	ofGetGLStateCache().bindVertexArray(streamVao);
+	glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.getId());
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, streamBuffer.getId());
+
+	auto setAttribute = [&](GLuint location, bool enabled, const void * data, GLsizeiptr size, GLint numCoords, GLboolean normalize){
+		if(!enabled){
+			glDisableVertexAttribArray(location);
+			return;
+		}
+		memcpy(dst, data, size);
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, numCoords, GL_FLOAT, normalize, 0, (void*)base);
+		dst += aligned(size);
+		base += aligned(size);
+	};
+	setAttribute(ofShader::POSITION_ATTRIBUTE, true, vertexData.getVerticesPointer(), numVertices * sizeof(glm::vec3), 3, GL_FALSE);
+	setAttribute(ofShader::COLOR_ATTRIBUTE, useColors, vertexData.getColorsPointer(), numVertices * sizeof(ofFloatColor), 4, GL_FALSE);
+	setAttribute(ofShader::TEXCOORD_ATTRIBUTE, useTextures, vertexData.getTexCoordsPointer(), numVertices * sizeof(glm::vec2), 2, GL_FALSE);
+	setAttribute(ofShader::NORMAL_ATTRIBUTE, useNormals, vertexData.getNormalsPointer(), numVertices * sizeof(glm::vec3), 3, GL_TRUE);
+
+	const_cast<ofGLProgrammableRenderer*>(this)->setAttributes(true,useColors,useTextures,useNormals);
+	if(vertexData.getNumIndices()){
+		memcpy(dst, vertexData.getIndexPointer(), vertexData.getNumIndices() * sizeof(ofIndexType));
+		of::priv::countDraw(drawMode, vertexData.getNumIndices());
+		glDrawElements(drawMode, vertexData.getNumIndices(), GL_UNSIGNED_INT, (void*)base);
+	}else{
+		of::priv::countDraw(drawMode, numVertices);
+		glDrawArrays(drawMode, 0, numVertices);
+	}
+
+	ofGetGLStateCache().bindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	return true;
+}
+#endif
+
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::draw(const ofVboMesh & mesh, ofPolyRenderMode renderType) const{
 	drawInstanced(mesh,renderType,1);
@@ -228,6 +357,7 @@ void ofGLProgrammableRenderer::draw(const ofVboMesh & mesh, ofPolyRenderMode ren
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawInstanced(const ofVboMesh & mesh, ofPolyRenderMode renderType, int primCount) const{
+	flushPrimitiveBatch();
 	if(mesh.getNumVertices()==0) return;
 	GLuint mode = ofGetGLPrimitiveMode(mesh.getMode());
 #ifndef TARGET_OPENGLES
@@ -262,6 +392,12 @@ void ofGLProgrammableRenderer::drawInstanced(const ofVboMesh & mesh, ofPolyRende
 		}else{
 			draw(mesh.getVbo(),GL_LINES,0,mesh.getNumVertices());
 		}
+	}else if(primCount > 1){
+		if(mesh.getNumIndices()){
+			drawElementsInstanced(mesh.getVbo(),mode,mesh.getNumIndices(),primCount);
+		}else{
+			drawInstanced(mesh.getVbo(),mode,0,mesh.getNumVertices(),primCount);
+		}
 	}else{
 		if(mesh.getNumIndices()){
 			drawElements(mesh.getVbo(),mode,mesh.getNumIndices());
@@ -294,8 +430,20 @@ void ofGLProgrammableRenderer::draw(const ofNode& node) const{
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::draw(const ofPolyline & poly) const{
+	flushPrimitiveBatch();
 	if(poly.getVertices().empty()) return;
 
+	// custom shaders and materials expect the polyline's vertices
+	if(currentStyle.lineWidth > 1 && !usingCustomShader && !currentMaterial && ofGpuStrokes::isSupported()){
+		if(!strokes){
+			strokes = std::make_shared<ofGpuStrokes>();
+		}
+		strokes->clear();
+		strokes->add(poly, currentStyle.lineWidth);
+		strokes->draw();
+		return;
+	}
+
 	// use smoothness, if requested:
 	//if (bSmoothHinted) startSmoothing();
 
@@ -308,6 +456,7 @@ void ofGLProgrammableRenderer::draw(const ofPolyline & poly) const{
 
 	GLenum drawMode = poly.isClosed()?GL_LINE_LOOP:GL_LINE_STRIP;
 
+	of::priv::countDraw(drawMode, poly.size());
 	glDrawArrays(drawMode, 0, poly.size());
 
 #else
@@ -327,7 +476,12 @@ void ofGLProgrammableRenderer::draw(const ofPath & shape) const{
 		prevColor = currentStyle.color;
 	}
 	ofGLProgrammableRenderer * mut_this = const_cast<ofGLProgrammableRenderer*>(this);
-	if(shape.isFilled()){
+	if(shape.isFilled() && shape.isStencilFill()){
+		if(shape.getUseShapeColor()){
+			mut_this->setColor( shape.getFillColor(),shape.getFillColor().a);
+		}
+		drawStencilFill(shape);
+	}else if(shape.isFilled()){
 		const ofMesh & mesh = shape.getTessellation();
 		if(shape.getUseShapeColor()){
 			mut_this->setColor( shape.getFillColor(),shape.getFillColor().a);
@@ -350,6 +504,47 @@ void ofGLProgrammableRenderer::draw(const ofPath & shape) const{
 	}
 }
 
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::drawStencilFill(const ofPath & shape) const{
+	const ofMesh & fans = shape.getStencilFillMesh();
+	const ofMesh & cover = shape.getStencilCoverMesh();
+	if(fans.getNumVertices() == 0) return;
+	flushPrimitiveBatch();
+
+	GLboolean depthMask;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+	GLboolean cullFace = glIsEnabled(GL_CULL_FACE);
+	ofGetGLStateCache().setCapability(GL_CULL_FACE, false);
+	glEnable(GL_STENCIL_TEST);
+	glStencilMask(0xFF);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthMask(GL_FALSE);
+
+	// clear the stencil under the path, draw the fans counting the winding
+	// of every pixel and then cover the pixels inside, resetting the
+	// stencil to 0 again
+	glStencilFunc(GL_ALWAYS, 0, 0xFF);
+	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+	draw(cover, OF_MESH_FILL, false, false, false);
+
+	if(shape.getWindingMode() == OF_POLY_WINDING_ODD){
+		glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+	}else{
+		glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+		glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+	}
+	draw(fans, OF_MESH_FILL, false, false, false);
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthMask(depthMask);
+	glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+	draw(cover, OF_MESH_FILL, false, false, false);
+
+	glDisable(GL_STENCIL_TEST);
+	if(cullFace) ofGetGLStateCache().setCapability(GL_CULL_FACE, true);
+}
+
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::draw(const ofImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
 	if(image.isUsingTexture()){
@@ -419,9 +614,11 @@ void ofGLProgrammableRenderer::draw(const ofBaseVideoDraws & video, float x, flo
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::draw(const ofVbo & vbo, GLuint drawMode, int first, int total) const{
+	flushPrimitiveBatch();
 	if(vbo.getUsingVerts()) {
 		vbo.bind();
 		const_cast<ofGLProgrammableRenderer*>(this)->setAttributes(vbo.getUsingVerts(),vbo.getUsingColors(),vbo.getUsingTexCoords(),vbo.getUsingNormals());
+		of::priv::countDraw(drawMode, total);
 		glDrawArrays(drawMode, first, total);
 		vbo.unbind();
 	}
@@ -429,30 +626,48 @@ void ofGLProgrammableRenderer::draw(const ofVbo & vbo, GLuint drawMode, int firs
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawElements(const ofVbo & vbo, GLuint drawMode, int amt, int offsetelements) const{
+	flushPrimitiveBatch();
 	if(vbo.getUsingVerts()) {
 		vbo.bind();
 		const_cast<ofGLProgrammableRenderer*>(this)->setAttributes(vbo.getUsingVerts(),vbo.getUsingColors(),vbo.getUsingTexCoords(),vbo.getUsingNormals());
-#ifdef TARGET_OPENGLES
-        glDrawElements(drawMode, amt, GL_UNSIGNED_SHORT, (void*)(sizeof(ofIndexType) * offsetelements));
-#else
-        glDrawElements(drawMode, amt, GL_UNSIGNED_INT, (void*)(sizeof(ofIndexType) * offsetelements));
-#endif
+		of::priv::countDraw(drawMode, amt);
+		GLenum indexType = vbo.getIndexType();
+		glDrawElements(drawMode, amt, indexType, (void*)(size_t(ofGetBytesPerChannelFromGLType(indexType)) * offsetelements));
 		vbo.unbind();
 	}
 }
 
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::setInstancing(bool instancing, bool instanceColors){
+	flushPrimitiveBatch();
+	bool colorsChanged = instanceColors != instanceColorsEnabled;
+	instancingEnabled = instancing;
+	instanceColorsEnabled = instanceColors;
+	// the shader is selected once the mesh attributes are set, but the
+	// current one might be reused and needs the right uniform already
+	if(instancing && colorsChanged && currentShader){
+		currentShader->setUniform1f(USE_INSTANCE_COLORS_UNIFORM,instanceColors);
+	}
+}
+
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawInstanced(const ofVbo & vbo, GLuint drawMode, int first, int total, int primCount) const{
+	flushPrimitiveBatch();
 	if(vbo.getUsingVerts()) {
 		vbo.bind();
 		const_cast<ofGLProgrammableRenderer*>(this)->setAttributes(vbo.getUsingVerts(),vbo.getUsingColors(),vbo.getUsingTexCoords(),vbo.getUsingNormals());
-#ifdef TARGET_OPENGLES
-		// todo: activate instancing once OPENGL ES supports instancing, starting with version 3.0
-		// unfortunately there is currently no easy way within oF to query the current OpenGL version.
-		// https://www.khronos.org/opengles/sdk/docs/man3/xhtml/glDrawElementsInstanced.xml
+#if defined(TARGET_OPENGLES) && !defined(GL_ES_VERSION_3_0)
+		// the ES 2 headers don't have the instanced draws
 		ofLogWarning("ofVbo") << "drawInstanced(): hardware instancing is not supported on OpenGL ES < 3.0";
-		// glDrawArraysInstanced(drawMode, first, total, primCount);
 #else
+	#ifdef TARGET_OPENGLES
+		if(major < 3){
+			ofLogWarning("ofVbo") << "drawInstanced(): hardware instancing is not supported on OpenGL ES < 3.0";
+			vbo.unbind();
+			return;
+		}
+	#endif
+		of::priv::countDraw(drawMode, total, primCount);
 		glDrawArraysInstanced(drawMode, first, total, primCount);
 #endif
 		vbo.unbind();
@@ -460,18 +675,25 @@ void ofGLProgrammableRenderer::drawInstanced(const ofVbo & vbo, GLuint drawMode,
 }
 
 //----------------------------------------------------------
-void ofGLProgrammableRenderer::drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount) const{
+void ofGLProgrammableRenderer::drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount, int offsetelements) const{
+	flushPrimitiveBatch();
 	if(vbo.getUsingVerts()) {
 		vbo.bind();
 		const_cast<ofGLProgrammableRenderer*>(this)->setAttributes(vbo.getUsingVerts(),vbo.getUsingColors(),vbo.getUsingTexCoords(),vbo.getUsingNormals());
-#ifdef TARGET_OPENGLES
-        // todo: activate instancing once OPENGL ES supports instancing, starting with version 3.0
-        // unfortunately there is currently no easy way within oF to query the current OpenGL version.
-        // https://www.khronos.org/opengles/sdk/docs/man3/xhtml/glDrawElementsInstanced.xml
+#if defined(TARGET_OPENGLES) && !defined(GL_ES_VERSION_3_0)
+        // the ES 2 headers don't have the instanced draws
         ofLogWarning("ofVbo") << "drawElementsInstanced(): hardware instancing is not supported on OpenGL ES < 3.0";
-        // glDrawElementsInstanced(drawMode, amt, GL_UNSIGNED_SHORT, nullptr, primCount);
 #else
-        glDrawElementsInstanced(drawMode, amt, GL_UNSIGNED_INT, nullptr, primCount);
+	#ifdef TARGET_OPENGLES
+        if(major < 3){
+            ofLogWarning("ofVbo") << "drawElementsInstanced(): hardware instancing is not supported on OpenGL ES < 3.0";
+            vbo.unbind();
+            return;
+        }
+	#endif
+        of::priv::countDraw(drawMode, amt, primCount);
+        GLenum indexType = vbo.getIndexType();
+        glDrawElementsInstanced(drawMode, amt, indexType, (void*)(size_t(ofGetBytesPerChannelFromGLType(indexType)) * offsetelements), primCount);
 #endif
 		vbo.unbind();
 	}
@@ -517,11 +739,13 @@ void ofGLProgrammableRenderer::unbind(const ofBaseVideoDraws & video){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::pushView() {
+	flushPrimitiveBatch();
 	matrixStack.pushView();
 }
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::popView() {
+	flushPrimitiveBatch();
 	matrixStack.popView();
 	uploadMatrices();
 	viewport(matrixStack.getCurrentViewport());
@@ -534,9 +758,10 @@ void ofGLProgrammableRenderer::viewport(ofRectangle viewport_){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::viewport(float x, float y, float width, float height, bool vflip) {
+	flushPrimitiveBatch();
 	matrixStack.viewport(x,y,width,height,vflip);
 	ofRectangle nativeViewport = matrixStack.getNativeViewport();
-	glViewport(nativeViewport.x,nativeViewport.y,nativeViewport.width,nativeViewport.height);
+	ofGetGLStateCache().viewport(nativeViewport.x,nativeViewport.y,nativeViewport.width,nativeViewport.height);
 }
 
 //----------------------------------------------------------
@@ -576,6 +801,7 @@ ofHandednessType ofGLProgrammableRenderer::getCoordHandedness() const{
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::setOrientation(ofOrientation orientation, bool vFlip){
+	flushPrimitiveBatch();
 	matrixStack.setOrientation(orientation,vFlip);
 	uploadMatrices();
 
@@ -583,6 +809,7 @@ void ofGLProgrammableRenderer::setOrientation(ofOrientation orientation, bool vF
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::setupScreenPerspective(float width, float height, float fov, float nearDist, float farDist) {
+	flushPrimitiveBatch();
 	float viewW, viewH;
 	if(width<0 || height<0){
 		ofRectangle currentViewport = getCurrentViewport();
@@ -617,6 +844,7 @@ void ofGLProgrammableRenderer::setupScreenPerspective(float width, float height,
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::setupScreenOrtho(float width, float height, float nearDist, float farDist) {
+	flushPrimitiveBatch();
 	float viewW, viewH;
 	if(width<0 || height<0){
 		ofRectangle currentViewport = getCurrentViewport();
@@ -676,6 +904,7 @@ void ofGLProgrammableRenderer::pushMatrix(){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::popMatrix(){
+	flushPrimitiveBatchIfNotModelView();
 	matrixStack.popMatrix();
 	uploadCurrentMatrix();
 }
@@ -687,18 +916,21 @@ void ofGLProgrammableRenderer::translate(const glm::vec3& p){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::translate(float x, float y, float z){
+	flushPrimitiveBatchIfNotModelView();
 	matrixStack.translate(x,y,z);
 	uploadCurrentMatrix();
 }
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::scale(float xAmnt, float yAmnt, float zAmnt){
+	flushPrimitiveBatchIfNotModelView();
 	matrixStack.scale(xAmnt, yAmnt, zAmnt);
 	uploadCurrentMatrix();
 }
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::rotateRad(float radians, float vecX, float vecY, float vecZ){
+	flushPrimitiveBatchIfNotModelView();
 	matrixStack.rotateRad(radians, vecX, vecY, vecZ);
 	uploadCurrentMatrix();
 }
@@ -731,12 +963,14 @@ void ofGLProgrammableRenderer::matrixMode(ofMatrixMode mode){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::loadIdentityMatrix (void){
+	flushPrimitiveBatchIfNotModelView();
 	matrixStack.loadIdentityMatrix();
 	uploadCurrentMatrix();
 }
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::loadMatrix (const glm::mat4 & m){
+	flushPrimitiveBatchIfNotModelView();
 	matrixStack.loadMatrix(m);
 	uploadCurrentMatrix();
 }
@@ -748,6 +982,7 @@ void ofGLProgrammableRenderer::loadMatrix (const float *m){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::multMatrix (const glm::mat4 & m){
+	flushPrimitiveBatchIfNotModelView();
 	matrixStack.multMatrix(m);
 	uploadCurrentMatrix();
 }
@@ -776,12 +1011,20 @@ glm::mat4 ofGLProgrammableRenderer::getCurrentViewMatrix() const{
 
 //----------------------------------------------------------
 glm::mat4 ofGLProgrammableRenderer::getCurrentNormalMatrix() const{
-	return glm::transpose(glm::inverse(getCurrentMatrix(OF_MATRIX_MODELVIEW)));
+	return matrixStack.getNormalMatrix();
 }
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::uploadCurrentMatrix(){
 	if(!currentShader) return;
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_uniform_buffer_object)
+	if(uploadMatricesBlock()){
+		if(currentMaterial && matrixStack.getCurrentMatrixMode() == OF_MATRIX_MODELVIEW){
+			currentMaterial->uploadMatrices(*currentShader,*this);
+		}
+		return;
+	}
+#endif
 	// uploads the current matrix to the current shader.
 	switch(matrixStack.getCurrentMatrixMode()){
 	case OF_MATRIX_MODELVIEW:
@@ -872,11 +1115,13 @@ void ofGLProgrammableRenderer::setBitmapTextMode(ofDrawBitmapMode mode){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::clear(){
+	flushPrimitiveBatch();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::clear(float r, float g, float b, float a) {
+	flushPrimitiveBatch();
 	glClearColor(r / 255., g / 255., b / 255., a / 255.);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -888,6 +1133,7 @@ void ofGLProgrammableRenderer::clear(float brightness, float a) {
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::clearAlpha() {
+	flushPrimitiveBatch();
 	glColorMask(0, 0, 0, 1);
 	glClearColor(0, 0, 0, 1);
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -917,6 +1163,7 @@ void ofGLProgrammableRenderer::setBackgroundColor(const ofColor & c){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::background(const ofColor & c){
+	flushPrimitiveBatch();
 	setBackgroundColor(c);
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 }
@@ -938,6 +1185,7 @@ void ofGLProgrammableRenderer::background(int r, int g, int b, int a){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::setFillMode(ofFillFlag fill){
+	flushPrimitiveBatch();
 	currentStyle.bFill = (fill==OF_FILLED);
 	if(currentStyle.bFill){
 		path.setFilled(true);
@@ -992,10 +1240,11 @@ void ofGLProgrammableRenderer::setLineWidth(float lineWidth){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::setDepthTest(bool depthTest) {
+	flushPrimitiveBatch();
 	if(depthTest) {
-		glEnable(GL_DEPTH_TEST);
+		ofGetGLStateCache().setCapability(GL_DEPTH_TEST, true);
 	} else {
-		glDisable(GL_DEPTH_TEST);
+		ofGetGLStateCache().setCapability(GL_DEPTH_TEST, false);
 	}
 }
 
@@ -1016,39 +1265,40 @@ void ofGLProgrammableRenderer::endSmoothing(){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::setBlendMode(ofBlendMode blendMode){
+	flushPrimitiveBatch();
 	switch (blendMode){
 		case OF_BLENDMODE_DISABLED:
-			glDisable(GL_BLEND);
+			ofGetGLStateCache().setCapability(GL_BLEND, false);
 			break;
 
 		case OF_BLENDMODE_ALPHA:
-			glEnable(GL_BLEND);
-			glBlendEquation(GL_FUNC_ADD);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			ofGetGLStateCache().setCapability(GL_BLEND, true);
+			ofGetGLStateCache().blendEquation(GL_FUNC_ADD);
+			ofGetGLStateCache().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			break;
 
 		case OF_BLENDMODE_ADD:
-			glEnable(GL_BLEND);
-			glBlendEquation(GL_FUNC_ADD);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+			ofGetGLStateCache().setCapability(GL_BLEND, true);
+			ofGetGLStateCache().blendEquation(GL_FUNC_ADD);
+			ofGetGLStateCache().blendFunc(GL_SRC_ALPHA, GL_ONE);
 			break;
 
 		case OF_BLENDMODE_MULTIPLY:
-			glEnable(GL_BLEND);
-			glBlendEquation(GL_FUNC_ADD);
-			glBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA /* GL_ZERO or GL_ONE_MINUS_SRC_ALPHA */);
+			ofGetGLStateCache().setCapability(GL_BLEND, true);
+			ofGetGLStateCache().blendEquation(GL_FUNC_ADD);
+			ofGetGLStateCache().blendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA /* GL_ZERO or GL_ONE_MINUS_SRC_ALPHA */);
 			break;
 
 		case OF_BLENDMODE_SCREEN:
-			glEnable(GL_BLEND);
-			glBlendEquation(GL_FUNC_ADD);
-			glBlendFunc(GL_ONE_MINUS_DST_COLOR, GL_ONE);
+			ofGetGLStateCache().setCapability(GL_BLEND, true);
+			ofGetGLStateCache().blendEquation(GL_FUNC_ADD);
+			ofGetGLStateCache().blendFunc(GL_ONE_MINUS_DST_COLOR, GL_ONE);
 			break;
 
 		case OF_BLENDMODE_SUBTRACT:
-			glEnable(GL_BLEND);
-			glBlendEquation(GL_FUNC_REVERSE_SUBTRACT);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+			ofGetGLStateCache().setCapability(GL_BLEND, true);
+			ofGetGLStateCache().blendEquation(GL_FUNC_REVERSE_SUBTRACT);
+			ofGetGLStateCache().blendFunc(GL_SRC_ALPHA, GL_ONE);
 			break;
 
 		default:
@@ -1082,6 +1332,7 @@ void ofGLProgrammableRenderer::disablePointSprites(){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::enableAntiAliasing(){
+	flushPrimitiveBatch();
 #if !defined(TARGET_PROGRAMMABLE_GL) || !defined(TARGET_OPENGLES)
 	glEnable(GL_MULTISAMPLE);
 #endif
@@ -1089,6 +1340,7 @@ void ofGLProgrammableRenderer::enableAntiAliasing(){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::disableAntiAliasing(){
+	flushPrimitiveBatch();
 #if !defined(TARGET_PROGRAMMABLE_GL) || !defined(TARGET_OPENGLES)
 	glDisable(GL_MULTISAMPLE);
 #endif
@@ -1226,6 +1478,7 @@ void ofGLProgrammableRenderer::setAttributes(bool vertices, bool color, bool tex
 void ofGLProgrammableRenderer::enableTextureTarget(const ofTexture & tex, int textureLocation){
 	bool wasUsingTexture = texCoordsEnabled & (currentTextureTarget!=OF_NO_TEXTURE);
 	currentTextureTarget = tex.texData.textureTarget;
+	currentTextureLayer = tex.texData.layer;
 
 	if(!uniqueShader || currentMaterial){
 		beginDefaultShader();
@@ -1238,6 +1491,11 @@ void ofGLProgrammableRenderer::enableTextureTarget(const ofTexture & tex, int te
 
 	if((currentTextureTarget!=OF_NO_TEXTURE) && currentShader){
 		currentShader->setUniformTexture("src_tex_unit"+ofToString(textureLocation),tex,textureLocation);
+#ifndef TARGET_OPENGLES
+		if(currentTextureTarget==GL_TEXTURE_2D_ARRAY){
+			currentShader->setUniform1f(TEXTURE_LAYER_UNIFORM,currentTextureLayer);
+		}
+#endif
 	}
 }
 
@@ -1254,9 +1512,8 @@ void ofGLProgrammableRenderer::disableTextureTarget(int textureTarget, int textu
 	if(wasUsingTexture!=usingTexture){
 		if(currentShader) currentShader->setUniform1f(USE_TEXTURE_UNIFORM,usingTexture);
 	}
-	glActiveTexture(GL_TEXTURE0+textureLocation);
-	glBindTexture(textureTarget, 0);
-	glActiveTexture(GL_TEXTURE0);
+	ofGetGLStateCache().bindTexture(GL_TEXTURE0+textureLocation, textureTarget, 0);
+	ofGetGLStateCache().activeTexture(GL_TEXTURE0);
 }
 
 //----------------------------------------------------------
@@ -1287,10 +1544,11 @@ void ofGLProgrammableRenderer::disableAlphaMask(){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::bind(const ofShader & shader){
+	flushPrimitiveBatch();
     if(currentShader && *currentShader==shader){
 		return;
     }
-	glUseProgram(shader.getProgram());
+	ofGetGLStateCache().useProgram(shader.getProgram());
 
 	currentShader = &shader;
 	uploadMatrices();
@@ -1302,7 +1560,8 @@ void ofGLProgrammableRenderer::bind(const ofShader & shader){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::unbind(const ofShader & shader){
-	glUseProgram(0);
+	flushPrimitiveBatch();
+	ofGetGLStateCache().useProgram(0);
 	usingCustomShader = false;
 	beginDefaultShader();
 }
@@ -1337,6 +1596,7 @@ void ofGLProgrammableRenderer::end(const ofFbo & fbo){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::bind(const ofFbo & fbo){
+	flushPrimitiveBatch();
 	if (currentFramebufferId == fbo.getId()){
 		ofLogWarning() << "Framebuffer with id: " << fbo.getId() << " cannot be bound onto itself. \n" <<
 			"Most probably you forgot to end() the current framebuffer before calling begin() again or you forgot to allocate() before calling begin().";
@@ -1349,12 +1609,14 @@ void ofGLProgrammableRenderer::bind(const ofFbo & fbo){
 	// different implementations.
 	framebufferIdStack.push_back(currentFramebufferId);
 	currentFramebufferId = fbo.getId();
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, currentFramebufferId);
 }
 
 #ifndef TARGET_OPENGLES
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::bindForBlitting(const ofFbo & fboSrc, ofFbo & fboDst, int attachmentPoint){
+	flushPrimitiveBatch();
 	if (currentFramebufferId == fboSrc.getId()){
 		ofLogWarning() << "Framebuffer with id: " << fboSrc.getId() << " cannot be bound onto itself. \n" <<
 			"Most probably you forgot to end() the current framebuffer before calling getTexture().";
@@ -1367,8 +1629,10 @@ void ofGLProgrammableRenderer::bindForBlitting(const ofFbo & fboSrc, ofFbo & fbo
 	// different implementations.
 	framebufferIdStack.push_back(currentFramebufferId);
 	currentFramebufferId = fboSrc.getId();
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_READ_FRAMEBUFFER, currentFramebufferId);
 	glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentPoint);
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboDst.getIdDrawBuffer());
 	glDrawBuffer(GL_COLOR_ATTACHMENT0 + attachmentPoint);
 }
@@ -1376,6 +1640,7 @@ void ofGLProgrammableRenderer::bindForBlitting(const ofFbo & fboSrc, ofFbo & fbo
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::unbind(const ofFbo & fbo){
+	flushPrimitiveBatch();
 	if(framebufferIdStack.empty()){
 		ofLogError() << "unbalanced fbo bind/unbind binding default framebuffer";
 		currentFramebufferId = defaultFramebufferId;
@@ -1383,12 +1648,14 @@ void ofGLProgrammableRenderer::unbind(const ofFbo & fbo){
 		currentFramebufferId = framebufferIdStack.back();
 		framebufferIdStack.pop_back();
 	}
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, currentFramebufferId);
 	fbo.flagDirty();
 }
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::bind(const ofBaseMaterial & material){
+	flushPrimitiveBatch();
     currentMaterial = &material;
     // FIXME: this invalidates the previous shader to avoid that
     // when binding 2 materials one after another, the second won't
@@ -1399,6 +1666,7 @@ void ofGLProgrammableRenderer::bind(const ofBaseMaterial & material){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::unbind(const ofBaseMaterial &){
+	flushPrimitiveBatch();
     currentMaterial = nullptr;
 	beginDefaultShader();
 }
@@ -1429,6 +1697,7 @@ bool ofGLProgrammableRenderer::getLightingEnabled(){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::bind(const ofTexture & texture, int location){
+	flushPrimitiveBatch();
 	//we could check if it has been allocated - but we don't do that in draw()
 	if(texture.getAlphaMask()){
 		setAlphaMaskTex(*texture.getAlphaMask());
@@ -1461,6 +1730,7 @@ void ofGLProgrammableRenderer::bind(const ofTexture & texture, int location){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::unbind(const ofTexture & texture, int location){
+	flushPrimitiveBatch();
 	disableTextureTarget(texture.texData.textureTarget,location);
 	if(texture.getAlphaMask()){
 		disableAlphaMask();
@@ -1475,6 +1745,7 @@ void ofGLProgrammableRenderer::unbind(const ofTexture & texture, int location){
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::bind(const ofCamera & camera, const ofRectangle & _viewport){
+	flushPrimitiveBatch();
 	pushView();
 	viewport(_viewport);
 	setOrientation(matrixStack.getOrientation(),camera.isVFlipped());
@@ -1486,6 +1757,7 @@ void ofGLProgrammableRenderer::bind(const ofCamera & camera, const ofRectangle &
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::unbind(const ofCamera & camera){
+	flushPrimitiveBatch();
 	popView();
 }
 
@@ -1493,6 +1765,14 @@ void ofGLProgrammableRenderer::unbind(const ofCamera & camera){
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::uploadMatrices(){
 	if(!currentShader) return;
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_uniform_buffer_object)
+	if(uploadMatricesBlock()){
+		if(currentMaterial){
+			currentMaterial->uploadMatrices(*currentShader,*this);
+		}
+		return;
+	}
+#endif
 	currentShader->setUniformMatrix4f(MODELVIEW_MATRIX_UNIFORM, matrixStack.getModelViewMatrix());
 	currentShader->setUniformMatrix4f(PROJECTION_MATRIX_UNIFORM, matrixStack.getProjectionMatrix());
 	currentShader->setUniformMatrix4f(TEXTURE_MATRIX_UNIFORM, matrixStack.getTextureMatrix());
@@ -1502,6 +1782,31 @@ void ofGLProgrammableRenderer::uploadMatrices(){
 	}
 }
 
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_uniform_buffer_object)
+//----------------------------------------------------------
+bool ofGLProgrammableRenderer::uploadMatricesBlock(){
+	if(!GLEW_ARB_uniform_buffer_object || currentShader->getUniformBlockIndex(MATRICES_BLOCK) == -1){
+		return false;
+	}
+	MatricesBlock matrices;
+	matrices.modelViewMatrix = matrixStack.getModelViewMatrix();
+	matrices.projectionMatrix = matrixStack.getProjectionMatrix();
+	matrices.textureMatrix = matrixStack.getTextureMatrix();
+	matrices.modelViewProjectionMatrix = matrixStack.getModelViewProjectionMatrix();
+	matrices.viewMatrix = matrixStack.getViewMatrix();
+	// the block is shared by all the shaders, it only needs updating
+	// when the matrices change, not every time a shader is bound
+	if(!matricesBuffer.isAllocated()){
+		matricesBuffer.allocate(sizeof(matrices), &matrices, GL_DYNAMIC_DRAW);
+	}else if(memcmp(&matrices, &matricesBlock, sizeof(matrices)) != 0){
+		matricesBuffer.updateData(0, sizeof(matrices), &matrices);
+	}
+	matricesBlock = matrices;
+	matricesBuffer.bindBase(GL_UNIFORM_BUFFER, ofShader::MATRICES_BLOCK_BINDING);
+	return true;
+}
+#endif
+
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::setDefaultUniforms(){
 	if(!currentShader) return;
@@ -1509,6 +1814,14 @@ void ofGLProgrammableRenderer::setDefaultUniforms(){
 	bool usingTexture = texCoordsEnabled & (currentTextureTarget!=OF_NO_TEXTURE);
 	currentShader->setUniform1f(USE_TEXTURE_UNIFORM,usingTexture);
 	currentShader->setUniform1f(USE_COLORS_UNIFORM,colorsEnabled);
+	if(instancingEnabled){
+		currentShader->setUniform1f(USE_INSTANCE_COLORS_UNIFORM,instanceColorsEnabled);
+	}
+#ifndef TARGET_OPENGLES
+	if(usingTexture && currentTextureTarget==GL_TEXTURE_2D_ARRAY){
+		currentShader->setUniform1f(TEXTURE_LAYER_UNIFORM,currentTextureLayer);
+	}
+#endif
 	if(currentMaterial){
 		currentMaterial->updateMaterial(*currentShader,*this);
 		currentMaterial->updateLights(*currentShader,*this);
@@ -1528,51 +1841,41 @@ void ofGLProgrammableRenderer::beginDefaultShader(){
 		}else if(bitmapStringEnabled){
 			nextShader = &bitmapStringShader;
 
-		}else if(colorsEnabled && texCoordsEnabled){
-			switch(currentTextureTarget){
-	#ifndef TARGET_OPENGLES
-			case GL_TEXTURE_RECTANGLE_ARB:
-				nextShader = &defaultTexRectColor;
-				break;
-	#endif
-			case GL_TEXTURE_2D:
-				nextShader = &defaultTex2DColor;
-				break;
-			case OF_NO_TEXTURE:
-				nextShader = &defaultNoTexColor;
-				break;
-	#ifdef TARGET_ANDROID
-			case GL_TEXTURE_EXTERNAL_OES:
-				nextShader = &defaultOESTexColor;
-				break;
+		}else if(distanceFieldEnabled){
+			nextShader = &getDistanceFieldShader();
+
+		}else{
+			// one lookup for the variant with the features in use
+			unsigned int features = 0;
+	#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
+			if(instancingEnabled){
+				features |= SHADER_INSTANCING;
+			}else
 	#endif
+			if(colorsEnabled){
+				features |= SHADER_COLORS;
 			}
-
-		}else if(colorsEnabled){
-			nextShader = &defaultNoTexColor;
-
-		}else if(texCoordsEnabled){
-			switch(currentTextureTarget){
+			if(texCoordsEnabled){
+				switch(currentTextureTarget){
+				case GL_TEXTURE_2D:
+					features |= SHADER_TEXTURE_2D;
+					break;
 	#ifndef TARGET_OPENGLES
-			case GL_TEXTURE_RECTANGLE_ARB:
-				nextShader = &defaultTexRectNoColor;
-				break;
+				case GL_TEXTURE_RECTANGLE_ARB:
+					features |= SHADER_TEXTURE_RECT;
+					break;
+				case GL_TEXTURE_2D_ARRAY:
+					features |= SHADER_TEXTURE_2D_ARRAY;
+					break;
 	#endif
-			case GL_TEXTURE_2D:
-				nextShader = &defaultTex2DNoColor;
-				break;
-			case OF_NO_TEXTURE:
-				nextShader = &defaultNoTexNoColor;
-				break;
 	#ifdef TARGET_ANDROID
-			case GL_TEXTURE_EXTERNAL_OES:
-				nextShader = &defaultOESTexNoColor;
-				break;
+				case GL_TEXTURE_EXTERNAL_OES:
+					features |= SHADER_TEXTURE_OES;
+					break;
 	#endif
+				}
 			}
-
-		}else{
-			nextShader = &defaultNoTexNoColor;
+			nextShader = &getDefaultShader(features);
 		}
 
 	}else{
@@ -1588,8 +1891,202 @@ void ofGLProgrammableRenderer::beginDefaultShader(){
 	}
 }
 
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::setPrimitiveBatching(bool batching){
+	if(!batching){
+		flushPrimitiveBatch();
+	}
+	primitiveBatching = batching;
+}
+
+//----------------------------------------------------------
+bool ofGLProgrammableRenderer::getPrimitiveBatching() const{
+	return primitiveBatching;
+}
+
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::flushPrimitiveBatch() const{
+	// only one of the batches has vertices at a time, adding to one
+	// flushes the other to keep the drawing order
+	flushBitmapStringBatch();
+	flushShapeBatch();
+}
+
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::flushShapeBatch() const{
+	if(flushingBatch || batchMesh.getVertices().empty()) return;
+	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
+	flushingBatch = true;
+
+	// batched vertices are already in eye space so they are drawn
+	// with an identity model view matrix
+	ofMatrixMode prevMatrixMode = matrixStack.getCurrentMatrixMode();
+	mutThis->matrixMode(OF_MATRIX_MODELVIEW);
+	mutThis->pushMatrix();
+	mutThis->loadIdentityMatrix();
+	draw(batchMesh,OF_MESH_FILL,true,false,false);
+	mutThis->popMatrix();
+	mutThis->matrixMode(prevMatrixMode);
+
+	batchMesh.clear();
+	flushingBatch = false;
+}
+
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::flushBitmapStringBatch() const{
+	if(flushingBatch || bitmapStringBatch.getVertices().empty()) return;
+	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
+	flushingBatch = true;
+
+	// batched strings are already in normalized viewport coordinates
+	ofMatrixMode prevMatrixMode = matrixStack.getCurrentMatrixMode();
+	mutThis->matrixMode(OF_MATRIX_PROJECTION);
+	mutThis->pushMatrix();
+	mutThis->loadIdentityMatrix();
+	mutThis->matrixMode(OF_MATRIX_MODELVIEW);
+	mutThis->pushMatrix();
+	mutThis->loadIdentityMatrix();
+
+	mutThis->setAlphaBitmapText(true);
+	mutThis->bind(bitmapFont.getTexture(),0);
+	draw(bitmapStringBatch,OF_MESH_FILL,true,true,false);
+	mutThis->unbind(bitmapFont.getTexture(),0);
+	mutThis->setAlphaBitmapText(false);
+
+	mutThis->popMatrix();
+	mutThis->matrixMode(OF_MATRIX_PROJECTION);
+	mutThis->popMatrix();
+	mutThis->matrixMode(prevMatrixMode);
+
+	bitmapStringBatch.clear();
+	flushingBatch = false;
+}
+
+//----------------------------------------------------------
+bool ofGLProgrammableRenderer::addBatchedBitmapString(const string & text, float x, float y, float z) const{
+	if(!primitiveBatching || flushingBatch || usingCustomShader || currentMaterial || uniqueShader){
+		return false;
+	}
+
+	// same transformations as drawString for the modes that end up in
+	// viewport coordinates, the other ones depend on the projection
+	ofRectangle rViewport = getCurrentViewport();
+	glm::vec2 position;
+	switch (currentStyle.drawBitmapMode) {
+		case OF_BITMAPMODE_SCREEN:
+			if(rViewport != matrixStack.getFullSurfaceViewport()){
+				return false;
+			}
+			position = {x, y};
+			break;
+		case OF_BITMAPMODE_VIEWPORT:
+			position = {x, y};
+			break;
+		case OF_BITMAPMODE_MODEL_BILLBOARD:{
+			auto mat = matrixStack.getProjectionMatrixNoOrientation()  * matrixStack.getModelViewMatrix();
+			auto dScreen4 = mat * glm::vec4(x,y,z,1.0);
+			auto dScreen = dScreen4.xyz() / dScreen4.w;
+			if (dScreen.z >= 1) return true;
+			dScreen += glm::vec3(1.0) ;
+			dScreen *= 0.5;
+			dScreen.x += rViewport.x;
+			dScreen.x *= rViewport.width;
+			dScreen.y += rViewport.y;
+			dScreen.y *= rViewport.height;
+			position = {dScreen.x, dScreen.y};
+		}
+			break;
+		default:
+			return false;
+	}
+
+	flushShapeBatch();
+	glm::mat4 modelView;
+	modelView = glm::translate(modelView, glm::vec3(-1,-1,0));
+	modelView = glm::scale(modelView, glm::vec3(2/rViewport.width, 2/rViewport.height, 1));
+	modelView = glm::translate(modelView, glm::vec3(position, 0));
+	const ofMesh & charMesh = bitmapFont.getCachedMesh(text, 0, 0, currentStyle.drawBitmapMode, isVFlipped());
+	const auto & vertices = charMesh.getVertices();
+	const auto & texCoords = charMesh.getTexCoords();
+	for(std::size_t i = 0; i < vertices.size(); i++){
+		bitmapStringBatch.addVertex(glm::vec3(modelView * glm::vec4(vertices[i], 1.f)));
+		bitmapStringBatch.addTexCoord(texCoords[i]);
+		bitmapStringBatch.addColor(currentStyle.color);
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::flushPrimitiveBatchIfNotModelView() const{
+	// changes to the model view matrix are already baked into the
+	// batched vertices, any other matrix affects the whole batch
+	if(matrixStack.getCurrentMatrixMode()!=OF_MATRIX_MODELVIEW){
+		flushPrimitiveBatch();
+	}
+}
+
+//----------------------------------------------------------
+bool ofGLProgrammableRenderer::beginBatchedPrimitive(ofPrimitiveMode mode, std::size_t numVertices) const{
+	if(!primitiveBatching || flushingBatch){
+		return false;
+	}
+	// custom shaders and materials might depend on globalColor or on
+	// the model view matrix so those are always drawn immediately
+	if(usingCustomShader || currentMaterial || uniqueShader || bitmapStringEnabled || currentTextureTarget!=OF_NO_TEXTURE){
+		flushPrimitiveBatch();
+		return false;
+	}
+	flushBitmapStringBatch();
+	if(batchMesh.getMode()!=mode || batchMesh.getNumVertices()+numVertices > std::numeric_limits<ofIndexType>::max()){
+		flushPrimitiveBatch();
+		batchMesh.setMode(mode);
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::addBatchedVertex(float x, float y, float z) const{
+	batchMesh.addVertex(glm::vec3(matrixStack.getModelViewMatrix() * glm::vec4(x,y,z,1.f)));
+	batchMesh.addColor(currentStyle.color);
+}
+
+//----------------------------------------------------------
+bool ofGLProgrammableRenderer::addBatchedEllipse(float x, float y, float z, float radiusX, float radiusY) const{
+	const auto & circleCache = circlePolyline.getVertices();
+	if(!beginBatchedPrimitive(currentStyle.bFill ? OF_PRIMITIVE_TRIANGLES : OF_PRIMITIVE_LINES, circleCache.size())){
+		return false;
+	}
+	ofIndexType first = batchMesh.getNumVertices();
+	for(auto & v: circleCache){
+		addBatchedVertex(radiusX*v.x+x,radiusY*v.y+y,z);
+	}
+	// same topology as the immediate path, a fan around the first
+	// vertex when filled or an open strip for the outline
+	ofIndexType numVertices = circleCache.size();
+	if(currentStyle.bFill){
+		for(ofIndexType i=1;i+1<numVertices;i++){
+			batchMesh.addTriangle(first, first+i, first+i+1);
+		}
+	}else{
+		for(ofIndexType i=0;i+1<numVertices;i++){
+			batchMesh.addIndex(first+i);
+			batchMesh.addIndex(first+i+1);
+		}
+	}
+	return true;
+}
+
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const{
+	if(beginBatchedPrimitive(OF_PRIMITIVE_LINES, 2)){
+		ofIndexType first = batchMesh.getNumVertices();
+		addBatchedVertex(x1,y1,z1);
+		addBatchedVertex(x2,y2,z2);
+		batchMesh.addIndex(first);
+		batchMesh.addIndex(first+1);
+		return;
+	}
+
 	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	lineMesh.getVertices()[0] = {x1,y1,z1};
 	lineMesh.getVertices()[1] = {x2,y2,z2};
@@ -1605,6 +2102,28 @@ void ofGLProgrammableRenderer::drawLine(float x1, float y1, float z1, float x2,
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawRectangle(float x, float y, float z, float w, float h) const{
+	if(beginBatchedPrimitive(currentStyle.bFill ? OF_PRIMITIVE_TRIANGLES : OF_PRIMITIVE_LINES, 4)){
+		if(currentStyle.rectMode != OF_RECTMODE_CORNER){
+			x -= w/2.0f;
+			y -= h/2.0f;
+		}
+		ofIndexType first = batchMesh.getNumVertices();
+		addBatchedVertex(x,y,z);
+		addBatchedVertex(x+w,y,z);
+		addBatchedVertex(x+w,y+h,z);
+		addBatchedVertex(x,y+h,z);
+		if(currentStyle.bFill){
+			batchMesh.addTriangle(first, first+1, first+2);
+			batchMesh.addTriangle(first, first+2, first+3);
+		}else{
+			for(ofIndexType i=0;i<4;i++){
+				batchMesh.addIndex(first+i);
+				batchMesh.addIndex(first+(i+1)%4);
+			}
+		}
+		return;
+	}
+
 	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	if (currentStyle.rectMode == OF_RECTMODE_CORNER){
 		rectMesh.getVertices()[0] = {x,y,z};
@@ -1630,6 +2149,22 @@ void ofGLProgrammableRenderer::drawRectangle(float x, float y, float z, float w,
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const{
+	if(beginBatchedPrimitive(currentStyle.bFill ? OF_PRIMITIVE_TRIANGLES : OF_PRIMITIVE_LINES, 3)){
+		ofIndexType first = batchMesh.getNumVertices();
+		addBatchedVertex(x1,y1,z1);
+		addBatchedVertex(x2,y2,z2);
+		addBatchedVertex(x3,y3,z3);
+		if(currentStyle.bFill){
+			batchMesh.addTriangle(first, first+1, first+2);
+		}else{
+			for(ofIndexType i=0;i<3;i++){
+				batchMesh.addIndex(first+i);
+				batchMesh.addIndex(first+(i+1)%3);
+			}
+		}
+		return;
+	}
+
 	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	triangleMesh.getVertices()[0] = {x1,y1,z1};
 	triangleMesh.getVertices()[1] = {x2,y2,z2};
@@ -1647,6 +2182,8 @@ void ofGLProgrammableRenderer::drawTriangle(float x1, float y1, float z1, float
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawCircle(float x, float y, float z,  float radius) const{
+	if(addBatchedEllipse(x, y, z, radius, radius)) return;
+
 	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	const auto & circleCache = circlePolyline.getVertices();
 	for(int i=0;i<(int)circleCache.size();i++){
@@ -1665,9 +2202,11 @@ void ofGLProgrammableRenderer::drawCircle(float x, float y, float z,  float radi
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawEllipse(float x, float y, float z, float width, float height) const{
-	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	float radiusX = width*0.5;
 	float radiusY = height*0.5;
+	if(addBatchedEllipse(x, y, z, radiusX, radiusY)) return;
+
+	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	const auto & circleCache = circlePolyline.getVertices();
 	for(int i=0;i<(int)circleCache.size();i++){
 		circleMesh.getVertices()[i] = {radiusX*circlePolyline[i].x+x,radiusY*circlePolyline[i].y+y,z};
@@ -1685,6 +2224,10 @@ void ofGLProgrammableRenderer::drawEllipse(float x, float y, float z, float widt
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawString(string textString, float x, float y, float z) const{
+	if(addBatchedBitmapString(textString, x, y, z)){
+		return;
+	}
+	flushPrimitiveBatch();
 	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	float sx = 0;
 	float sy = 0;
@@ -1812,7 +2355,7 @@ void ofGLProgrammableRenderer::drawString(string textString, float x, float y, f
 	// (c) enable texture once before we start drawing each char (no point turning it on and off constantly)
 	//We do this because its way faster
 	mutThis->setAlphaBitmapText(true);
-	ofMesh charMesh = bitmapFont.getMesh(textString, sx, sy, currentStyle.drawBitmapMode, isVFlipped());
+	const ofMesh & charMesh = bitmapFont.getCachedMesh(textString, sx, sy, currentStyle.drawBitmapMode, isVFlipped());
 	mutThis->bind(bitmapFont.getTexture(),0);
 	draw(charMesh,OF_MESH_FILL,false,true,false);
 	mutThis->unbind(bitmapFont.getTexture(),0);
@@ -1838,15 +2381,41 @@ void ofGLProgrammableRenderer::drawString(string textString, float x, float y, f
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawString(const ofTrueTypeFont & font, string text, float x, float y) const{
+	flushPrimitiveBatch();
 	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	ofBlendMode blendMode = currentStyle.blendingMode;
 
 	mutThis->setBlendMode(OF_BLENDMODE_ALPHA);
 
-	mutThis->bind(font.getFontTexture(),0);
-	draw(font.getStringMesh(text,x,y,isVFlipped()),OF_MESH_FILL);
-	mutThis->unbind(font.getFontTexture(),0);
+	// distance fields need their own shader, a custom shader or material
+	// draws them as plain alpha
+	bool distanceField = font.isDistanceField() && !usingCustomShader && !currentMaterial && !uniqueShader;
+	mutThis->distanceFieldEnabled = distanceField;
+
+	// with a dynamic atlas the glyphs can be spread over several pages
+	font.getStringMesh(text,x,y,isVFlipped());
+	for(std::size_t page = 0; page < font.getNumAtlasPages(); page++){
+		const ofMesh & mesh = font.getStringMeshForPage(page);
+		if(mesh.getNumVertices() == 0) continue;
+		mutThis->bind(font.getFontTexture(page),0);
+		if(distanceField){
+			// widths in pixels to distances in the field
+			float scale = 0.5f / font.getDistanceFieldSpread();
+			const ofFloatColor & outline = font.getOutlineColor();
+			const ofFloatColor & glow = font.getGlowColor();
+			currentShader->setUniform1f("outlineWidth", font.getOutlineWidth() * scale);
+			currentShader->setUniform4f("outlineColor", outline.r, outline.g, outline.b, outline.a);
+			currentShader->setUniform1f("glowWidth", font.getGlowWidth() * scale);
+			currentShader->setUniform4f("glowColor", glow.r, glow.g, glow.b, glow.a);
+		}
+		draw(mesh,OF_MESH_FILL);
+		mutThis->unbind(font.getFontTexture(page),0);
+	}
 
+	if(distanceField){
+		mutThis->distanceFieldEnabled = false;
+		mutThis->beginDefaultShader();
+	}
 	mutThis->setBlendMode(blendMode);
 }
 
@@ -1914,41 +2483,94 @@ static const string defaultVertexShader = vertex_shader_header + STRINGIFY(
 );
 
 // ----------------------------------------------------------------------
+// the default shaders are variants of these two, compiled with HAS_COLOR,
+// INSTANCING and one of the TEXTURE_ defines set to 1 for the features of
+// the variant, see defaultShaderDefines()
+
+static const string defaultVariantVertexShader = R"(
+uniform mat4 projectionMatrix;
+uniform mat4 modelViewMatrix;
+uniform mat4 textureMatrix;
+uniform mat4 modelViewProjectionMatrix;
+#if INSTANCING
+uniform vec4 globalColor;
+uniform float usingColors;
+uniform float usingInstanceColors;
+#endif
 
-static const string defaultFragmentShaderTexRectColor = fragment_shader_header + STRINGIFY(
-
-	uniform sampler2DRect src_tex_unit0;
-	uniform float usingTexture;
-	uniform float usingColors;
-	uniform vec4 globalColor;
+IN vec4  position;
+IN vec2  texcoord;
+IN vec4  color;
+IN vec3  normal;
+#if INSTANCING
+IN mat4  instanceTransform;
+IN vec4  instanceColor;
+IN float instanceLayer;
 
-	IN float depth;
-	IN vec4 colorVarying;
-	IN vec2 texCoordVarying;
+OUT float layerVarying;
+#endif
 
+OUT vec4 colorVarying;
+OUT vec2 texCoordVarying;
+OUT vec4 normalVarying;
 
-	void main(){
-		FRAG_COLOR = TEXTURE(src_tex_unit0, texCoordVarying) * colorVarying;
-	}
-);
+void main()
+{
+#if INSTANCING
+	colorVarying = mix(globalColor, color, usingColors) * mix(vec4(1.0), instanceColor, usingInstanceColors);
+	layerVarying = instanceLayer;
+	gl_Position = modelViewProjectionMatrix * instanceTransform * position;
+#else
+	colorVarying = color;
+	gl_Position = modelViewProjectionMatrix * position;
+#endif
+	texCoordVarying = (textureMatrix*vec4(texcoord.x,texcoord.y,0,1)).xy;
+}
+)";
 
 // ----------------------------------------------------------------------
 
-static const string defaultFragmentShaderTexRectNoColor = fragment_shader_header + STRINGIFY(
-
-	uniform sampler2DRect src_tex_unit0;
-	uniform float usingTexture;
-	uniform float usingColors;
-	uniform vec4 globalColor;
-
-	IN float depth;
-	IN vec4 colorVarying;
-	IN vec2 texCoordVarying;
+static const string defaultVariantFragmentShader = R"(
+#if TEXTURE_2D
+uniform sampler2D src_tex_unit0;
+#elif TEXTURE_RECT
+uniform sampler2DRect src_tex_unit0;
+#elif TEXTURE_2D_ARRAY
+// the layer set with ofTexture::setDrawLayer, plus the one of each
+// instance when drawing an ofInstancedMesh
+uniform sampler2DArray src_tex_unit0;
+uniform float textureLayer;
+#elif TEXTURE_OES
+uniform samplerExternalOES src_tex_unit0;
+#endif
+uniform float usingTexture;
+uniform float usingColors;
+uniform vec4 globalColor;
+
+IN vec4 colorVarying;
+IN vec2 texCoordVarying;
+#if INSTANCING && TEXTURE_2D_ARRAY
+IN float layerVarying;
+#endif
 
-	void main(){
-		FRAG_COLOR = TEXTURE(src_tex_unit0, texCoordVarying)* globalColor;
-	}
-);
+void main(){
+	// instances always get their color from the vertex shader
+#if HAS_COLOR || INSTANCING
+	vec4 color = colorVarying;
+#else
+	vec4 color = globalColor;
+#endif
+#if TEXTURE_2D_ARRAY && INSTANCING
+	FRAG_COLOR = TEXTURE(src_tex_unit0, vec3(texCoordVarying, textureLayer + layerVarying)) * color;
+#elif TEXTURE_2D_ARRAY
+	FRAG_COLOR = TEXTURE(src_tex_unit0, vec3(texCoordVarying, textureLayer)) * color;
+#elif TEXTURE_2D || TEXTURE_RECT || TEXTURE_OES
+	FRAG_COLOR = TEXTURE(src_tex_unit0, texCoordVarying) * color;
+#else
+	FRAG_COLOR = color;
+#endif
+}
+)";
 
 // ----------------------------------------------------------------------
 
@@ -1990,111 +2612,6 @@ static const string alphaMaskFragmentShaderTex2DNoColor = fragment_shader_header
 
 // ----------------------------------------------------------------------
 
-static const string defaultFragmentShaderTex2DColor = fragment_shader_header + STRINGIFY(
-
-	uniform sampler2D src_tex_unit0;
-	uniform float usingTexture;
-	uniform float usingColors;
-	uniform vec4 globalColor;
-
-	IN float depth;
-	IN vec4 colorVarying;
-	IN vec2 texCoordVarying;
-
-	void main(){
-		FRAG_COLOR = TEXTURE(src_tex_unit0, texCoordVarying) * colorVarying;
-	}
-);
-
-// ----------------------------------------------------------------------
-
-static const string defaultFragmentShaderTex2DNoColor = fragment_shader_header + STRINGIFY(
-
-	uniform sampler2D src_tex_unit0;
-	uniform float usingTexture;
-	uniform float usingColors;
-	uniform vec4 globalColor;
-
-	IN float depth;
-	IN vec4 colorVarying;
-	IN vec2 texCoordVarying;
-	void main(){
-		FRAG_COLOR = TEXTURE(src_tex_unit0, texCoordVarying) * globalColor;
-	}
-);
-
-// ----------------------------------------------------------------------
-
-static const string defaultFragmentShaderOESTexNoColor = fragment_shader_header + STRINGIFY(
-    
-    uniform samplerExternalOES src_tex_unit0;
-    uniform float usingTexture;
-    uniform float usingColors;
-    uniform vec4 globalColor;
-    
-    IN float depth;
-    IN vec4 colorVarying;
-    IN vec2 texCoordVarying;
-    
-    void main(){
-        FRAG_COLOR = TEXTURE(src_tex_unit0, texCoordVarying) * globalColor;
-    }
-);
-
-// ----------------------------------------------------------------------
-
-static const string defaultFragmentShaderOESTexColor = fragment_shader_header + STRINGIFY(
-																							
-	uniform samplerExternalOES src_tex_unit0;
-	uniform float usingTexture;
-	uniform float usingColors;
-	uniform vec4 globalColor;
-	
-	IN float depth;
-	IN vec4 colorVarying;
-	IN vec2 texCoordVarying;
-	
-	void main(){
-		FRAG_COLOR = TEXTURE(src_tex_unit0, texCoordVarying) * colorVarying;
-	}
-);
-
-// ----------------------------------------------------------------------
-
-static const string defaultFragmentShaderNoTexColor = fragment_shader_header + STRINGIFY (
-
-	uniform float usingTexture;
-	uniform float usingColors;
-	uniform vec4 globalColor;
-
-	IN float depth;
-	IN vec4 colorVarying;
-	IN vec2 texCoordVarying;
-
-	void main(){
-		FRAG_COLOR = colorVarying;
-	}
-);
-
-// ----------------------------------------------------------------------
-
-static const string defaultFragmentShaderNoTexNoColor = fragment_shader_header + STRINGIFY(
-
-	uniform float usingTexture;
-	uniform float usingColors;
-	uniform vec4 globalColor;
-
-	IN float depth;
-	IN vec4 colorVarying;
-	IN vec2 texCoordVarying;
-
-	void main(){
-		FRAG_COLOR = globalColor;
-	}
-);
-
-// ----------------------------------------------------------------------
-
 static const string bitmapStringVertexShader = vertex_shader_header + STRINGIFY(
 
 	uniform mat4 projectionMatrix;
@@ -2107,10 +2624,12 @@ static const string bitmapStringVertexShader = vertex_shader_header + STRINGIFY(
 	IN vec2  texcoord;
 
 	OUT vec2 texCoordVarying;
+	OUT vec4 colorVarying;
 
 	void main()
 	{
 		texCoordVarying = texcoord;
+		colorVarying = color;
 		gl_Position = modelViewProjectionMatrix * position;
 	}
 );
@@ -2121,8 +2640,10 @@ static const string bitmapStringFragmentShader = fragment_shader_header + STRING
 
 	uniform sampler2D src_tex_unit0;
 	uniform vec4 globalColor;
+	uniform float usingColors;
 
 	IN vec2 texCoordVarying;
+	IN vec4 colorVarying;
 
 	void main()
 	{
@@ -2131,7 +2652,54 @@ static const string bitmapStringFragmentShader = fragment_shader_header + STRING
 		// We will not write anything to the framebuffer if we have a transparent pixel
 		// This makes sure we don't mess up our depth buffer.
 		if (tex.a < 0.5) discard;
-		FRAG_COLOR = globalColor * tex;
+		// batched strings have the color of each string in the vertices
+		FRAG_COLOR = mix(globalColor, colorVarying, usingColors) * tex;
+	}
+);
+
+// ----------------------------------------------------------------------
+
+static const string distanceFieldFragmentShader = fragment_shader_header + STRINGIFY(
+
+	uniform sampler2D src_tex_unit0;
+	uniform vec4 globalColor;
+	uniform float usingColors;
+	uniform vec4 outlineColor;
+	uniform float outlineWidth;
+	uniform vec4 glowColor;
+	uniform float glowWidth;
+
+	IN vec2 texCoordVarying;
+	IN vec4 colorVarying;
+
+	vec4 over(vec4 top, vec4 bottom){
+		float a = top.a + bottom.a * (1.0 - top.a);
+		vec3 rgb = (top.rgb * top.a + bottom.rgb * bottom.a * (1.0 - top.a)) / max(a, 0.0001);
+		return vec4(rgb, a);
+	}
+
+	void main()
+	{
+		// 0.5 on the outline of the glyph, 1 inside, 0 outside
+		float dist = TEXTURE(src_tex_unit0, texCoordVarying).a;
+		// antialias over one pixel on screen whatever the scale
+		float aa = max(fwidth(dist) * 0.5, 0.0001);
+
+		// batched strings have the color of each string in the vertices
+		vec4 color = mix(globalColor, colorVarying, usingColors);
+		color.a *= smoothstep(0.5 - aa, 0.5 + aa, dist);
+
+		float outlineEdge = 0.5 - outlineWidth;
+		float outline = smoothstep(outlineEdge - aa, outlineEdge + aa, dist) * step(0.0001, outlineWidth);
+		vec4 result = over(color, vec4(outlineColor.rgb, outlineColor.a * outline));
+
+		float glowEdge = outlineEdge - glowWidth;
+		float glow = smoothstep(glowEdge, outlineEdge, dist) * step(0.0001, glowWidth);
+		result = over(result, vec4(glowColor.rgb, glowColor.a * glow));
+
+		// keeps the transparent part of the quads out of the depth buffer
+		if (result.a < 0.004) discard;
+		FRAG_COLOR = result;
 	}
 );
 
@@ -2202,9 +2770,9 @@ static const string FRAGMENT_SHADER_YUY2 = STRINGIFY(
 	uniform float textureWidth;\n
 
     const vec3 offset = vec3(-0.0625, -0.5, -0.5);\n
-    const vec3 rcoeff = vec3(1.164, 0.000, 1.596);\n
-    const vec3 gcoeff = vec3(1.164,-0.391,-0.813);\n
-    const vec3 bcoeff = vec3(1.164, 2.018, 0.000);\n
+    uniform vec3 rcoeff;\n
+    uniform vec3 gcoeff;\n
+    uniform vec3 bcoeff;\n
 
 
 	void main(){\n
@@ -2237,9 +2805,9 @@ static const string FRAGMENT_SHADER_NV12_NV21 = STRINGIFY(
 	IN vec2 texCoordVarying;\n
 
     const vec3 offset = vec3(-0.0625, -0.5, -0.5);\n
-    const vec3 rcoeff = vec3(1.164, 0.000, 1.596);\n
-    const vec3 gcoeff = vec3(1.164,-0.391,-0.813);\n
-    const vec3 bcoeff = vec3(1.164, 2.018, 0.000);\n
+    uniform vec3 rcoeff;\n
+    uniform vec3 gcoeff;\n
+    uniform vec3 bcoeff;\n
 
 
 	void main(){\n
@@ -2268,9 +2836,9 @@ static const string FRAGMENT_SHADER_PLANAR_YUV = STRINGIFY(
 	IN vec2 texCoordVarying;\n
 
     const vec3 offset = vec3(-0.0625, -0.5, -0.5);\n
-    const vec3 rcoeff = vec3(1.164, 0.000, 1.596);\n
-    const vec3 gcoeff = vec3(1.164,-0.391,-0.813);\n
-    const vec3 bcoeff = vec3(1.164, 2.018, 0.000);\n
+    uniform vec3 rcoeff;\n
+    uniform vec3 gcoeff;\n
+    uniform vec3 bcoeff;\n
 
 
 	void main(){\n
@@ -2321,6 +2889,18 @@ static string shaderSource(const string & src, int major, int minor){
 	return shaderSrc;
 }
 
+static string defaultShaderDefines(unsigned int features){
+	auto define = [features](const string & name, unsigned int feature){
+		return "#define " + name + ((features & feature) ? " 1\n" : " 0\n");
+	};
+	return define("HAS_COLOR", ofGLProgrammableRenderer::SHADER_COLORS) +
+		define("INSTANCING", ofGLProgrammableRenderer::SHADER_INSTANCING) +
+		define("TEXTURE_2D", ofGLProgrammableRenderer::SHADER_TEXTURE_2D) +
+		define("TEXTURE_RECT", ofGLProgrammableRenderer::SHADER_TEXTURE_RECT) +
+		define("TEXTURE_2D_ARRAY", ofGLProgrammableRenderer::SHADER_TEXTURE_2D_ARRAY) +
+		define("TEXTURE_OES", ofGLProgrammableRenderer::SHADER_TEXTURE_OES);
+}
+
 #ifdef TARGET_ANDROID
 static string shaderOESSource(const string & src, int major, int minor){
 	string shaderSrc = src;
@@ -2421,69 +3001,37 @@ void ofGLProgrammableRenderer::setup(int _major, int _minor){
 		beginDefaultShader();
 	}else{
 	#ifndef TARGET_OPENGLES
-		defaultTexRectColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
-		defaultTexRectNoColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
 		alphaMaskRectShader.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
-	#endif
-		defaultTex2DColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
-		defaultNoTexColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
-		defaultTex2DNoColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
-		defaultNoTexNoColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
-		alphaMask2DShader.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
-
-	#ifndef TARGET_OPENGLES
-		defaultTexRectColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(defaultFragmentShaderTexRectColor,major, minor));
-		defaultTexRectNoColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(defaultFragmentShaderTexRectNoColor,major, minor));
 		alphaMaskRectShader.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(alphaMaskFragmentShaderTexRectNoColor,major, minor));
+		alphaMaskRectShader.bindDefaults();
+		alphaMaskRectShader.linkProgram();
 	#endif
-		defaultTex2DColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(defaultFragmentShaderTex2DColor,major, minor));
-		defaultNoTexColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(defaultFragmentShaderNoTexColor,major, minor));
-		defaultTex2DNoColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(defaultFragmentShaderTex2DNoColor,major, minor));
-		defaultNoTexNoColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(defaultFragmentShaderNoTexNoColor,major, minor));
+		alphaMask2DShader.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(defaultVertexShader,major, minor));
 		alphaMask2DShader.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(alphaMaskFragmentShaderTex2DNoColor,major, minor));
-
-
-		bitmapStringShader.setupShaderFromSource(GL_VERTEX_SHADER, shaderSource(bitmapStringVertexShader,major, minor));
-		bitmapStringShader.setupShaderFromSource(GL_FRAGMENT_SHADER, shaderSource(bitmapStringFragmentShader,major, minor));
-
-#ifndef TARGET_OPENGLES
-		defaultTexRectColor.bindDefaults();
-		defaultTexRectNoColor.bindDefaults();
-		alphaMaskRectShader.bindDefaults();
-#endif
-		defaultTex2DColor.bindDefaults();
-		defaultNoTexColor.bindDefaults();
-		defaultTex2DNoColor.bindDefaults();
-		defaultNoTexNoColor.bindDefaults();
 		alphaMask2DShader.bindDefaults();
-
-#ifndef TARGET_OPENGLES
-		defaultTexRectColor.linkProgram();
-		defaultTexRectNoColor.linkProgram();
-		alphaMaskRectShader.linkProgram();
-#endif
-		defaultTex2DColor.linkProgram();
-		defaultNoTexColor.linkProgram();
-		defaultTex2DNoColor.linkProgram();
-		defaultNoTexNoColor.linkProgram();
 		alphaMask2DShader.linkProgram();
 
+		bitmapStringShader.setupShaderFromSource(GL_VERTEX_SHADER, shaderSource(bitmapStringVertexShader,major, minor));
+		bitmapStringShader.setupShaderFromSource(GL_FRAGMENT_SHADER, shaderSource(bitmapStringFragmentShader,major, minor));
 		bitmapStringShader.bindDefaults();
 		bitmapStringShader.linkProgram();
-		
-		
-#ifdef TARGET_ANDROID
-		defaultOESTexNoColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderOESSource(defaultVertexShader,major, minor));
-		defaultOESTexColor.setupShaderFromSource(GL_VERTEX_SHADER,shaderOESSource(defaultVertexShader,major, minor));
-		defaultOESTexColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderOESSource(defaultFragmentShaderOESTexColor,major, minor));
-		defaultOESTexNoColor.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderOESSource(defaultFragmentShaderOESTexNoColor,major, minor));
-		
-		defaultOESTexColor.bindDefaults();
-		defaultOESTexNoColor.bindDefaults();
-		
-		defaultOESTexColor.linkProgram();
-		defaultOESTexNoColor.linkProgram();
-#endif
+
+		// the variants almost every app uses, the rest are compiled when
+		// first drawn
+		prewarmDefaultShaders({
+			0,
+			SHADER_COLORS,
+			SHADER_TEXTURE_2D,
+			SHADER_COLORS | SHADER_TEXTURE_2D,
+	#ifndef TARGET_OPENGLES
+			SHADER_TEXTURE_RECT,
+			SHADER_COLORS | SHADER_TEXTURE_RECT,
+	#endif
+	#ifdef TARGET_ANDROID
+			SHADER_TEXTURE_OES,
+			SHADER_COLORS | SHADER_TEXTURE_OES,
+	#endif
+		});
 	}
 
 	setupGraphicDefaults();
@@ -2491,6 +3039,60 @@ void ofGLProgrammableRenderer::setup(int _major, int _minor){
 	setupScreenPerspective();
 }
 
+const ofShader & ofGLProgrammableRenderer::getDefaultShader(unsigned int features){
+	auto it = defaultShaders.find(features);
+	if(it != defaultShaders.end()){
+		return it->second;
+	}
+
+	ofShader & shader = defaultShaders[features];
+	string defines = defaultShaderDefines(features);
+	string vertexSrc = vertex_shader_header + defines + defaultVariantVertexShader;
+	string fragmentSrc = fragment_shader_header + defines + defaultVariantFragmentShader;
+#ifdef TARGET_ANDROID
+	if(features & SHADER_TEXTURE_OES){
+		shader.setupShaderFromSource(GL_VERTEX_SHADER,shaderOESSource(vertexSrc,major,minor));
+		shader.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderOESSource(fragmentSrc,major,minor));
+	}else
+#endif
+	{
+		shader.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(vertexSrc,major,minor));
+		shader.setupShaderFromSource(GL_FRAGMENT_SHADER,shaderSource(fragmentSrc,major,minor));
+	}
+	shader.bindDefaults();
+	if(features & SHADER_INSTANCING){
+		shader.bindAttribute(ofInstancedMesh::TRANSFORM_ATTRIBUTE,"instanceTransform");
+		shader.bindAttribute(ofInstancedMesh::COLOR_INSTANCE_ATTRIBUTE,"instanceColor");
+		shader.bindAttribute(ofInstancedMesh::LAYER_INSTANCE_ATTRIBUTE,"instanceLayer");
+	}
+	shader.linkProgram();
+	return shader;
+}
+
+void ofGLProgrammableRenderer::prewarmDefaultShaders(const vector<unsigned int> & variants){
+	for(auto features: variants){
+		getDefaultShader(features);
+	}
+}
+
+const ofShader & ofGLProgrammableRenderer::getDistanceFieldShader(){
+	// only compiled once a distance field font is drawn
+	if(!distanceFieldShader.isLoaded()){
+		string fragmentSrc = shaderSource(distanceFieldFragmentShader,major,minor);
+#ifdef TARGET_OPENGLES
+		// fwidth is an extension in GLSL ES 1.0
+		if(major < 3){
+			ofStringReplace(fragmentSrc,"precision mediump float;","#extension GL_OES_standard_derivatives : enable\nprecision mediump float;");
+		}
+#endif
+		distanceFieldShader.setupShaderFromSource(GL_VERTEX_SHADER,shaderSource(bitmapStringVertexShader,major,minor));
+		distanceFieldShader.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSrc);
+		distanceFieldShader.bindDefaults();
+		distanceFieldShader.linkProgram();
+	}
+	return distanceFieldShader;
+}
+
 const ofShader * ofGLProgrammableRenderer::getVideoShader(const ofBaseVideoDraws & video) const{
 	const ofShader * shader = nullptr;
 	GLenum target = video.getTexture().getTextureData().textureTarget;
@@ -2562,6 +3164,16 @@ static float getTextureScaleY(const ofBaseVideoDraws & video, int plane){
 #endif
 
 void ofGLProgrammableRenderer::setVideoShaderUniforms(const ofBaseVideoDraws & video, const ofShader & shader) const{
+	// video doesn't say its color space, HD and bigger is BT.709 and SD BT.601
+	if(video.getHeight() > 576){
+		shader.setUniform3f("rcoeff",1.164, 0.000, 1.793);
+		shader.setUniform3f("gcoeff",1.164,-0.213,-0.533);
+		shader.setUniform3f("bcoeff",1.164, 2.112, 0.000);
+	}else{
+		shader.setUniform3f("rcoeff",1.164, 0.000, 1.596);
+		shader.setUniform3f("gcoeff",1.164,-0.391,-0.813);
+		shader.setUniform3f("bcoeff",1.164, 2.018, 0.000);
+	}
 	switch(video.getPixelFormat()){
 		case OF_PIXELS_YUY2:
 #ifndef TARGET_OPENGLES
@@ -2647,6 +3259,7 @@ void ofGLProgrammableRenderer::saveFullViewport(ofPixels & pixels){
 }
 
 void ofGLProgrammableRenderer::saveScreen(int x, int y, int w, int h, ofPixels & pixels){
+	flushPrimitiveBatch();
 
     int sh = getViewportHeight();
 
@@ -2661,6 +3274,7 @@ void ofGLProgrammableRenderer::saveScreen(int x, int y, int w, int h, ofPixels &
 	}
 
 	buffer.bind(GL_PIXEL_PACK_BUFFER);
+	of::priv::currentRenderStats().readbacks++;
 	glReadPixels(x, y, w, h, ofGetGlFormat(pixels), GL_UNSIGNED_BYTE, 0); // read the memory....
 	buffer.unbind(GL_PIXEL_PACK_BUFFER);
 	unsigned char * p = buffer.map<unsigned char>(GL_READ_ONLY);
@@ -2690,6 +3304,7 @@ void ofGLProgrammableRenderer::saveScreen(int x, int y, int w, int h, ofPixels &
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(true,false);
 		break;
@@ -2701,6 +3316,7 @@ void ofGLProgrammableRenderer::saveScreen(int x, int y, int w, int h, ofPixels &
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(false,true);
 		break;
@@ -2716,6 +3332,7 @@ void ofGLProgrammableRenderer::saveScreen(int x, int y, int w, int h, ofPixels &
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(true,true);
 		break;
@@ -2731,6 +3348,7 @@ void ofGLProgrammableRenderer::saveScreen(int x, int y, int w, int h, ofPixels &
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(true,true);
 		break;
@@ -13,6 +13,7 @@
 class ofShapeTessellation;
 class ofFbo;
 class ofVbo;
+class ofGpuStrokes;
 static const int OF_NO_TEXTURE=-1;
 
 class ofGLProgrammableRenderer: public ofBaseGLRenderer{
@@ -42,9 +43,13 @@ public:
 	void draw(const ofVbo & vbo, GLuint drawMode, int first, int total) const;
 	void drawElements(const ofVbo & vbo, GLuint drawMode, int amt, int offsetelements = 0) const;
 	void drawInstanced(const ofVbo & vbo, GLuint drawMode, int first, int total, int primCount) const;
-	void drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount) const;
+	void drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount, int offsetelements = 0) const;
 	void draw(const ofVboMesh & mesh, ofPolyRenderMode renderType) const;
 	void drawInstanced(const ofVboMesh & mesh, ofPolyRenderMode renderType, int primCount) const;
+
+	/// \brief Makes the default shaders apply the per instance transform,
+	/// and color if instanceColors, set by ofInstancedMesh
+	void setInstancing(bool instancing, bool instanceColors);
     ofPath & getPath();
     
     
@@ -175,6 +180,40 @@ public:
 
 	const ofShader & getCurrentShader() const;
 
+	/// \brief Features of the default shaders
+	///
+	/// The default shaders are variants of a single source, each one
+	/// compiled with a #define per feature. A variant is identified by its
+	/// features or'ed together, with at most one texture target.
+	enum DefaultShaderFeature{
+		SHADER_COLORS = 1 << 0,
+		SHADER_INSTANCING = 1 << 1,
+		SHADER_TEXTURE_2D = 1 << 2,
+		SHADER_TEXTURE_RECT = 1 << 3,
+		SHADER_TEXTURE_2D_ARRAY = 1 << 4,
+		SHADER_TEXTURE_OES = 1 << 5,
+	};
+
+	/// \brief The default shader variant for features, compiled the first
+	/// time it's used
+	const ofShader & getDefaultShader(unsigned int features);
+
+	/// \brief Compiles the variants now instead of on the first draw that
+	/// needs them
+	///
+	/// setup() compiles the variants for colors and 2D and rectangle
+	/// textures, the instanced, array texture and OES ones are compiled
+	/// on demand unless they are prewarmed:
+	///
+	/// ~~~~{.cpp}
+	/// auto renderer = std::dynamic_pointer_cast<ofGLProgrammableRenderer>(ofGetCurrentRenderer());
+	/// renderer->prewarmDefaultShaders({
+	///     ofGLProgrammableRenderer::SHADER_INSTANCING,
+	///     ofGLProgrammableRenderer::SHADER_INSTANCING | ofGLProgrammableRenderer::SHADER_TEXTURE_2D,
+	/// });
+	/// ~~~~
+	void prewarmDefaultShaders(const std::vector<unsigned int> & variants);
+
 	void bind(const ofBaseMaterial & material);
 	void bind(const ofShader & shader);
 	void bind(const ofTexture & texture, int location);
@@ -235,6 +274,32 @@ public:
 	const of3dGraphics & get3dGraphics() const;
 	of3dGraphics & get3dGraphics();
 
+	/// \brief Enables or disables batching of immediate mode primitives
+	///
+	/// When enabled, consecutive calls to drawLine, drawRectangle,
+	/// drawTriangle, drawCircle and drawEllipse that share the same
+	/// style, shader and texture state are accumulated into a single
+	/// vertex stream instead of issuing one draw call each. The batch
+	/// is flushed whenever the renderer state changes and at
+	/// finishRender().
+	///
+	/// Primitives are only batched while one of the default shaders is
+	/// in use and no texture or material is bound; in any other case
+	/// they are drawn immediately as usual.
+	///
+	/// Bitmap strings drawn in the OF_BITMAPMODE_MODEL_BILLBOARD,
+	/// OF_BITMAPMODE_VIEWPORT or OF_BITMAPMODE_SCREEN modes are batched
+	/// in their own vertex stream, so a debug overlay with many lines of
+	/// text is a single draw call.
+	///
+	/// \note Raw GL calls are not seen by the renderer, call
+	/// flushPrimitiveBatch() before changing GL state directly.
+	void setPrimitiveBatching(bool batching);
+	bool getPrimitiveBatching() const;
+
+	/// \brief Draws any primitives accumulated while batching is enabled
+	void flushPrimitiveBatch() const;
+
 private:
 
 
@@ -244,6 +309,31 @@ private:
 	mutable ofMesh rectMesh;
 	mutable ofMesh lineMesh;
 	mutable ofVbo meshVbo;
+#ifndef TARGET_OPENGLES
+	// immediate meshes are copied one after another into a persistently
+	// mapped ring, one region per frame, and drawn with a single vao
+	// instead of respecifying the buffers of meshVbo on every draw
+	mutable ofBufferObject streamBuffer;
+	mutable GLuint streamVao;
+	mutable char * streamRegion;
+	mutable GLsizeiptr streamOffset;
+	bool drawStreamed(const ofMesh & vertexData, GLenum drawMode, bool useColors, bool useTextures, bool useNormals) const;
+#endif
+	// lines wider than 1 pixel, core profiles only draw 1 pixel wide GL_LINES
+	mutable std::shared_ptr<ofGpuStrokes> strokes;
+	mutable ofMesh batchMesh;
+	mutable ofMesh bitmapStringBatch;
+	mutable bool flushingBatch;
+	bool primitiveBatching;
+
+	bool beginBatchedPrimitive(ofPrimitiveMode mode, std::size_t numVertices) const;
+	void addBatchedVertex(float x, float y, float z) const;
+	bool addBatchedEllipse(float x, float y, float z, float radiusX, float radiusY) const;
+	void flushPrimitiveBatchIfNotModelView() const;
+	void flushShapeBatch() const;
+	void flushBitmapStringBatch() const;
+	bool addBatchedBitmapString(const std::string & text, float x, float y, float z) const;
+	void drawStencilFill(const ofPath & path) const;
 
 	void uploadCurrentMatrix();
 
@@ -253,10 +343,14 @@ private:
 
 	void beginDefaultShader();
 	void uploadMatrices();
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_uniform_buffer_object)
+	bool uploadMatricesBlock();
+#endif
 	void setDefaultUniforms();
 
 	void setAttributes(bool vertices, bool color, bool tex, bool normals);
 	void setAlphaBitmapText(bool bitmapText);
+	const ofShader & getDistanceFieldShader();
 
     
 	ofMatrixStack matrixStack;
@@ -267,13 +361,30 @@ private:
 	const ofShader * currentShader;
 
 	bool verticesEnabled, colorsEnabled, texCoordsEnabled, normalsEnabled, bitmapStringEnabled;
+	bool distanceFieldEnabled;
 	bool usingCustomShader, settingDefaultShader, usingVideoShader;
+	bool instancingEnabled, instanceColorsEnabled;
 	int currentTextureTarget;
+	int currentTextureLayer;
 
 	bool wrongUseLoggedOnce;
 	bool uniqueShader;
 
 	const ofBaseMaterial * currentMaterial;
+
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_uniform_buffer_object)
+	// contents of the ofMatrices uniform block, std140 lays the matrices
+	// out one after another
+	struct MatricesBlock{
+		glm::mat4 modelViewMatrix;
+		glm::mat4 projectionMatrix;
+		glm::mat4 textureMatrix;
+		glm::mat4 modelViewProjectionMatrix;
+		glm::mat4 viewMatrix;
+	};
+	MatricesBlock matricesBlock;
+	ofBufferObject matricesBuffer;
+#endif
 	int alphaMaskTextureTarget;
 
 	ofStyle currentStyle;
@@ -283,22 +394,16 @@ private:
 	ofPath path;
 	const ofAppBaseWindow * window;
 
-	ofShader defaultTexRectColor;
-	ofShader defaultTexRectNoColor;
-	ofShader defaultTex2DColor;
-	ofShader defaultTex2DNoColor;
-	ofShader defaultNoTexColor;
-	ofShader defaultNoTexNoColor;
+	// variants of the default shader by their features, the nodes of the
+	// map don't move so currentShader can point to them
+	std::unordered_map<unsigned int, ofShader> defaultShaders;
 	ofShader defaultUniqueShader;
-#ifdef TARGET_ANDROID
-	ofShader defaultOESTexColor;
-	ofShader defaultOESTexNoColor;
-#endif
 	
 	ofShader alphaMaskRectShader;
 	ofShader alphaMask2DShader;
 	
 	ofShader bitmapStringShader;
+	ofShader distanceFieldShader;
 	
 	ofShader shaderPlanarYUY2;
 	ofShader shaderNV12;
@@ -5,6 +5,8 @@
 #include "of3dPrimitives.h"
 #include "ofBitmapFont.h"
 #include "ofGLUtils.h"
+#include "ofGLStateCache.h"
+#include "ofRenderStats.h"
 #include "ofImage.h"
 #include "ofFbo.h"
 #include "ofLight.h"
@@ -12,6 +14,7 @@
 #include "ofCamera.h"
 #include "ofTrueTypeFont.h"
 #include "ofNode.h"
+#include "ofMathBatch.h"
 
 using namespace std;
 
@@ -54,6 +57,8 @@ void ofGLRenderer::setup(){
 }
 
 void ofGLRenderer::startRender(){
+	// every window can have its own context with its own state
+	ofGetGLStateCache().invalidate();
 	currentFramebufferId = defaultFramebufferId;
 	framebufferIdStack.push_back(defaultFramebufferId);
 	matrixStack.setRenderSurface(*window);
@@ -102,12 +107,12 @@ void ofGLRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode renderType,
 			}else{
 				set<int>::iterator textureLocation = textureLocationsEnabled.begin();
 				for(;textureLocation!=textureLocationsEnabled.end();textureLocation++){
-					glActiveTexture(GL_TEXTURE0+*textureLocation);
+					ofGetGLStateCache().activeTexture(GL_TEXTURE0+*textureLocation);
 					glClientActiveTexture(GL_TEXTURE0+*textureLocation);
 					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 					glTexCoordPointer(2, GL_FLOAT, sizeof(glm::vec2), &vertexData.getTexCoordsPointer()->x);
 				}
-				glActiveTexture(GL_TEXTURE0);
+				ofGetGLStateCache().activeTexture(GL_TEXTURE0);
 				glClientActiveTexture(GL_TEXTURE0);
 			}
 		}
@@ -115,11 +120,14 @@ void ofGLRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode renderType,
 		if(vertexData.getNumIndices()){
 	// This is never executed right now but this branch of the ifdef should be used for GLES 3 so let's keep it for future uses
 	#ifdef TARGET_OPENGLES
+			of::priv::countDraw(ofGetGLPrimitiveMode(vertexData.getMode()), vertexData.getNumIndices());
 			glDrawElements(ofGetGLPrimitiveMode(vertexData.getMode()), vertexData.getNumIndices(),GL_UNSIGNED_SHORT,vertexData.getIndexPointer());
 	#else
+			of::priv::countDraw(ofGetGLPrimitiveMode(vertexData.getMode()), vertexData.getNumIndices());
 			glDrawElements(ofGetGLPrimitiveMode(vertexData.getMode()), vertexData.getNumIndices(),GL_UNSIGNED_INT,vertexData.getIndexPointer());
 	#endif
 		}else{
+			of::priv::countDraw(ofGetGLPrimitiveMode(vertexData.getMode()), vertexData.getNumVertices());
 			glDrawArrays(ofGetGLPrimitiveMode(vertexData.getMode()), 0, vertexData.getNumVertices());
 		}
 
@@ -154,12 +162,12 @@ void ofGLRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode renderType,
 			}else{
 				set<int>::iterator textureLocation = textureLocationsEnabled.begin();
 				for(;textureLocation!=textureLocationsEnabled.end();textureLocation++){
-					glActiveTexture(GL_TEXTURE0+*textureLocation);
+					ofGetGLStateCache().activeTexture(GL_TEXTURE0+*textureLocation);
 					glClientActiveTexture(GL_TEXTURE0+*textureLocation);
 					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 					glTexCoordPointer(2, GL_FLOAT, sizeof(ofVec2f), &vertexData.getTexCoordsPointer()->x);
 				}
-				glActiveTexture(GL_TEXTURE0);
+				ofGetGLStateCache().activeTexture(GL_TEXTURE0);
 				glClientActiveTexture(GL_TEXTURE0);
 			}
 		}
@@ -181,8 +189,10 @@ void ofGLRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode renderType,
 		}
 
 		if(vertexData.getNumIndices()){
+			of::priv::countDraw(drawMode, vertexData.getNumIndices());
 			glDrawElements(drawMode, vertexData.getNumIndices(),GL_UNSIGNED_SHORT,vertexData.getIndexPointer());
 		}else{
+			of::priv::countDraw(drawMode, vertexData.getNumVertices());
 			glDrawArrays(drawMode, 0, vertexData.getNumVertices());
 		}
 		if(vertexData.getNumColors() && useColors){
@@ -270,6 +280,7 @@ void ofGLRenderer::draw(const ofPolyline & poly) const{
 
 		glEnableClientState(GL_VERTEX_ARRAY);
 		glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), &poly.getVertices()[0].x);
+		of::priv::countDraw(poly.isClosed()?GL_LINE_LOOP:GL_LINE_STRIP, poly.size());
 		glDrawArrays(poly.isClosed()?GL_LINE_LOOP:GL_LINE_STRIP, 0, poly.size());
 
 		// use smoothness, if requested:
@@ -373,6 +384,7 @@ void ofGLRenderer::draw(const ofBaseVideoDraws & video, float x, float y, float
 void ofGLRenderer::draw(const ofVbo & vbo, GLuint drawMode, int first, int total) const{
 	if(vbo.getUsingVerts()) {
 		vbo.bind();
+		of::priv::countDraw(drawMode, total);
 		glDrawArrays(drawMode, first, total);
 		vbo.unbind();
 	}
@@ -382,11 +394,9 @@ void ofGLRenderer::draw(const ofVbo & vbo, GLuint drawMode, int first, int total
 void ofGLRenderer::drawElements(const ofVbo & vbo, GLuint drawMode, int amt, int offsetelements) const{
 	if(vbo.getUsingVerts()) {
 		vbo.bind();
-#ifdef TARGET_OPENGLES
-		glDrawElements(drawMode, amt, GL_UNSIGNED_SHORT, (void*)(sizeof(ofIndexType) * offsetelements));
-#else
-		glDrawElements(drawMode, amt, GL_UNSIGNED_INT, (void*)(sizeof(ofIndexType) * offsetelements));
-#endif
+		of::priv::countDraw(drawMode, amt);
+		GLenum indexType = vbo.getIndexType();
+		glDrawElements(drawMode, amt, indexType, (void*)(size_t(ofGetBytesPerChannelFromGLType(indexType)) * offsetelements));
 		vbo.unbind();
 	}
 }
@@ -402,6 +412,7 @@ void ofGLRenderer::drawInstanced(const ofVbo & vbo, GLuint drawMode, int first,
 		ofLogWarning("ofVbo") << "drawInstanced(): hardware instancing is not supported on OpenGL ES < 3.0";
 		// glDrawArraysInstanced(drawMode, first, total, primCount);
 #else
+		of::priv::countDraw(drawMode, total, primCount);
 		glDrawArraysInstanced(drawMode, first, total, primCount);
 #endif
 		vbo.unbind();
@@ -409,7 +420,7 @@ void ofGLRenderer::drawInstanced(const ofVbo & vbo, GLuint drawMode, int first,
 }
 
 //----------------------------------------------------------
-void ofGLRenderer::drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount) const{
+void ofGLRenderer::drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount, int offsetelements) const{
 	if(vbo.getUsingVerts()) {
 		vbo.bind();
 #ifdef TARGET_OPENGLES
@@ -419,7 +430,9 @@ void ofGLRenderer::drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int
 		ofLogWarning("ofVbo") << "drawElementsInstanced(): hardware instancing is not supported on OpenGL ES < 3.0";
 		// glDrawElementsInstanced(drawMode, amt, GL_UNSIGNED_SHORT, nullptr, primCount);
 #else
-		glDrawElementsInstanced(drawMode, amt, GL_UNSIGNED_INT, nullptr, primCount);
+		of::priv::countDraw(drawMode, amt, primCount);
+		GLenum indexType = vbo.getIndexType();
+		glDrawElementsInstanced(drawMode, amt, indexType, (void*)(size_t(ofGetBytesPerChannelFromGLType(indexType)) * offsetelements), primCount);
 #endif
 		vbo.unbind();
 	}
@@ -446,12 +459,12 @@ void ofGLRenderer::unbind(const ofBaseVideoDraws & video){
 
 //----------------------------------------------------------
 void ofGLRenderer::bind(const ofShader & shader){
-	glUseProgram(shader.getProgram());
+	ofGetGLStateCache().useProgram(shader.getProgram());
 }
 
 //----------------------------------------------------------
 void ofGLRenderer::unbind(const ofShader & shader){
-	glUseProgram(0);
+	ofGetGLStateCache().useProgram(0);
 }
 
 
@@ -503,6 +516,7 @@ void ofGLRenderer::bind(const ofFbo & fbo){
 	// different implementations.
 	framebufferIdStack.push_back(currentFramebufferId);
 	currentFramebufferId = fbo.getId();
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, currentFramebufferId);
 }
 
@@ -521,8 +535,10 @@ void ofGLRenderer::bindForBlitting(const ofFbo & fboSrc, ofFbo & fboDst, int att
 	// different implementations.
 	framebufferIdStack.push_back(currentFramebufferId);
 	currentFramebufferId = fboSrc.getId();
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_READ_FRAMEBUFFER, currentFramebufferId);
 	glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentPoint);
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboDst.getIdDrawBuffer());
 	glDrawBuffer(GL_COLOR_ATTACHMENT0 + attachmentPoint);
 }
@@ -537,6 +553,7 @@ void ofGLRenderer::unbind(const ofFbo & fbo){
 		currentFramebufferId = framebufferIdStack.back();
 		framebufferIdStack.pop_back();
 	}
+	of::priv::currentRenderStats().fboBinds++;
 	glBindFramebuffer(GL_FRAMEBUFFER, currentFramebufferId);
 	fbo.flagDirty();
 }
@@ -1022,7 +1039,7 @@ glm::mat4 ofGLRenderer::getCurrentViewMatrix() const{
 
 //----------------------------------------------------------
 glm::mat4 ofGLRenderer::getCurrentNormalMatrix() const{
-	return glm::transpose(glm::inverse(getCurrentMatrix(OF_MATRIX_MODELVIEW)));
+	return glm::transpose(ofInvertMatrix(getCurrentMatrix(OF_MATRIX_MODELVIEW)));
 }
 
 //----------------------------------------------------------
@@ -1411,6 +1428,7 @@ void ofGLRenderer::drawLine(float x1, float y1, float z1, float x2, float y2, fl
 
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), linePoints.data());
+	of::priv::countDraw(GL_LINES, 2);
 	glDrawArrays(GL_LINES, 0, 2);
 
 	// use smoothness, if requested:
@@ -1438,6 +1456,7 @@ void ofGLRenderer::drawRectangle(float x, float y, float z,float w, float h) con
 
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), &rectPoints[0].x);
+	of::priv::countDraw(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_LOOP, 4);
 	glDrawArrays(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_LOOP, 0, 4);
 
 	// use smoothness, if requested:
@@ -1456,6 +1475,7 @@ void ofGLRenderer::drawTriangle(float x1, float y1, float z1, float x2, float y2
 
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), &triPoints[0].x);
+	of::priv::countDraw(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_LOOP, 3);
 	glDrawArrays(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_LOOP, 0, 3);
 
 	// use smoothness, if requested:
@@ -1475,6 +1495,7 @@ void ofGLRenderer::drawCircle(float x, float y, float z,  float radius) const{
 
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), &circlePoints[0].x);
+	of::priv::countDraw(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_STRIP, circlePoints.size());
 	glDrawArrays(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_STRIP, 0, circlePoints.size());
 
 	// use smoothness, if requested:
@@ -1496,6 +1517,7 @@ void ofGLRenderer::drawEllipse(float x, float y, float z, float width, float hei
 
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), &circlePoints[0].x);
+	of::priv::countDraw(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_STRIP, circlePoints.size());
 	glDrawArrays(currentStyle.bFill ? GL_TRIANGLE_FAN : GL_LINE_STRIP, 0, circlePoints.size());
 
 	// use smoothness, if requested:
@@ -1653,7 +1675,7 @@ void ofGLRenderer::drawString(string textString, float x, float y, float z) cons
 	glAlphaFunc(GL_GREATER, 0);
 #endif
 
-	ofMesh charMesh = bitmapFont.getMesh(textString,sx,sy,currentStyle.drawBitmapMode,vflipped);
+	const ofMesh & charMesh = bitmapFont.getCachedMesh(textString,sx,sy,currentStyle.drawBitmapMode,vflipped);
 	mutThis->bind(bitmapFont.getTexture(),0);
 	draw(charMesh,OF_MESH_FILL,false,true,false);
 	mutThis->unbind(bitmapFont.getTexture(),0);
@@ -1690,10 +1712,27 @@ void ofGLRenderer::drawString(const ofTrueTypeFont & font, string text, float x,
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	mutThis->bind(font.getFontTexture(),0);
-	draw(font.getStringMesh(text,x,y,isVFlipped()),OF_MESH_FILL);
-	mutThis->unbind(font.getFontTexture(),0);
+	// without shaders distance fields are cut at the outline of the
+	// glyphs, outlines and glows need the programmable renderer
+	bool alphaTestEnabled = glIsEnabled(GL_ALPHA_TEST);
+	if(font.isDistanceField()){
+		glEnable(GL_ALPHA_TEST);
+		glAlphaFunc(GL_GEQUAL, 0.5f);
+	}
+
+	// with a dynamic atlas the glyphs can be spread over several pages
+	font.getStringMesh(text,x,y,isVFlipped());
+	for(std::size_t page = 0; page < font.getNumAtlasPages(); page++){
+		const ofMesh & mesh = font.getStringMeshForPage(page);
+		if(mesh.getNumVertices() == 0) continue;
+		mutThis->bind(font.getFontTexture(page),0);
+		draw(mesh,OF_MESH_FILL);
+		mutThis->unbind(font.getFontTexture(page),0);
+	}
 
+	if(font.isDistanceField() && !alphaTestEnabled){
+		glDisable(GL_ALPHA_TEST);
+	}
 	if(!blendEnabled){
 		glDisable(GL_BLEND);
 	}
@@ -1702,10 +1741,10 @@ void ofGLRenderer::drawString(const ofTrueTypeFont & font, string text, float x,
 
 //----------------------------------------------------------
 void ofGLRenderer::enableTextureTarget(const ofTexture & tex, int textureLocation){
-	glActiveTexture(GL_TEXTURE0+textureLocation);
+	ofGetGLStateCache().activeTexture(GL_TEXTURE0+textureLocation);
 	glClientActiveTexture(GL_TEXTURE0+textureLocation);
 	glEnable( tex.getTextureData().textureTarget);
-	glBindTexture( tex.getTextureData().textureTarget, (GLuint)tex.getTextureData().textureID);
+	ofGetGLStateCache().bindTexture( tex.getTextureData().textureTarget, (GLuint)tex.getTextureData().textureID);
 #ifndef TARGET_OPENGLES
 	if(tex.getTextureData().bufferId!=0){
 		glTexBuffer(GL_TEXTURE_BUFFER, tex.getTextureData().glInternalFormat, tex.getTextureData().bufferId);
@@ -1716,10 +1755,9 @@ void ofGLRenderer::enableTextureTarget(const ofTexture & tex, int textureLocatio
 
 //----------------------------------------------------------
 void ofGLRenderer::disableTextureTarget(int textureTarget, int textureLocation){
-	glActiveTexture(GL_TEXTURE0+textureLocation);
-	glBindTexture( textureTarget, 0);
+	ofGetGLStateCache().bindTexture(GL_TEXTURE0+textureLocation, textureTarget, 0);
 	glDisable(textureTarget);
-	glActiveTexture(GL_TEXTURE0);
+	ofGetGLStateCache().activeTexture(GL_TEXTURE0);
 	textureLocationsEnabled.erase(textureLocation);
 }
 
@@ -1919,6 +1957,7 @@ void ofGLRenderer::saveScreen(int x, int y, int w, int h, ofPixels & pixels){
 	}
 
 	buffer.bind(GL_PIXEL_PACK_BUFFER);
+	of::priv::currentRenderStats().readbacks++;
 	glReadPixels(x, y, w, h, ofGetGlFormat(pixels), GL_UNSIGNED_BYTE, 0); // read the memory....
 	buffer.unbind(GL_PIXEL_PACK_BUFFER);
 	unsigned char * p = buffer.map<unsigned char>(GL_READ_ONLY);
@@ -1947,6 +1986,7 @@ void ofGLRenderer::saveScreen(int x, int y, int w, int h, ofPixels & pixels){
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(true,false);
 		break;
@@ -1958,6 +1998,7 @@ void ofGLRenderer::saveScreen(int x, int y, int w, int h, ofPixels & pixels){
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(false,true);
 		break;
@@ -1973,6 +2014,7 @@ void ofGLRenderer::saveScreen(int x, int y, int w, int h, ofPixels & pixels){
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(true,true);
 		break;
@@ -1988,6 +2030,7 @@ void ofGLRenderer::saveScreen(int x, int y, int w, int h, ofPixels & pixels){
 		}
 
 		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		of::priv::currentRenderStats().readbacks++;
 		glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
 		pixels.mirror(true,true);
 		break;
@@ -0,0 +1,205 @@
+#include "ofGLStateCache.h"
+#include "ofRenderStats.h"
+#include <algorithm>
+
+using namespace std;
+
+//----------------------------------------------------------
+ofGLStateCache::ofGLStateCache()
+:enabled(false)
+,viewportKnown(false)
+,numCalls(0)
+,numSkipped(0){
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::setEnabled(bool enabled){
+	this->enabled = enabled;
+	invalidate();
+}
+
+//----------------------------------------------------------
+bool ofGLStateCache::isEnabled() const{
+	return enabled;
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::invalidate(){
+	program = Value();
+	vertexArray = Value();
+	activeUnit = Value();
+	blendEquationMode = Value();
+	blendSrc = Value();
+	blendDst = Value();
+	viewportKnown = false;
+	textures.clear();
+	capabilities.clear();
+}
+
+//----------------------------------------------------------
+bool ofGLStateCache::skip(bool unchanged){
+	if(enabled && unchanged){
+		numSkipped++;
+		return true;
+	}else{
+		numCalls++;
+		of::priv::currentRenderStats().stateChanges++;
+		return false;
+	}
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::useProgram(GLuint id){
+	if(skip(program.known && program.value == id)) return;
+	glUseProgram(id);
+	of::priv::currentRenderStats().shaderBinds++;
+	program.known = true;
+	program.value = id;
+}
+
+#ifndef TARGET_OPENGLES
+//----------------------------------------------------------
+void ofGLStateCache::bindVertexArray(GLuint id){
+	if(skip(vertexArray.known && vertexArray.value == id)) return;
+	glBindVertexArray(id);
+	vertexArray.known = true;
+	vertexArray.value = id;
+}
+#endif
+
+//----------------------------------------------------------
+void ofGLStateCache::activeTexture(GLenum unit){
+	if(skip(activeUnit.known && activeUnit.value == unit)) return;
+	glActiveTexture(unit);
+	activeUnit.known = true;
+	activeUnit.value = unit;
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::bindTexture(GLenum target, GLuint texture){
+	if(!enabled || !activeUnit.known){
+		// without knowing the unit the binding can't be remembered
+		skip(false);
+		glBindTexture(target, texture);
+		return;
+	}
+	size_t unit = activeUnit.value - GL_TEXTURE0;
+	if(unit >= textures.size()){
+		textures.resize(unit + 1);
+	}
+	for(auto & binding: textures[unit]){
+		if(binding.target == target){
+			if(skip(binding.texture == texture)) return;
+			glBindTexture(target, texture);
+			binding.texture = texture;
+			return;
+		}
+	}
+	skip(false);
+	glBindTexture(target, texture);
+	textures[unit].push_back({target, texture});
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::bindTexture(GLenum unit, GLenum target, GLuint texture){
+	activeTexture(unit);
+	bindTexture(target, texture);
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::setCapability(GLenum cap, bool capEnabled){
+	auto it = std::find_if(capabilities.begin(), capabilities.end(), [cap](const Capability & c){
+		return c.cap == cap;
+	});
+	if(skip(it != capabilities.end() && it->enabled == capEnabled)) return;
+	if(capEnabled){
+		glEnable(cap);
+	}else{
+		glDisable(cap);
+	}
+	if(it == capabilities.end()){
+		capabilities.push_back({cap, capEnabled});
+	}else{
+		it->enabled = capEnabled;
+	}
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::blendEquation(GLenum mode){
+	if(skip(blendEquationMode.known && blendEquationMode.value == mode)) return;
+	glBlendEquation(mode);
+	blendEquationMode.known = true;
+	blendEquationMode.value = mode;
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::blendFunc(GLenum src, GLenum dst){
+	if(skip(blendSrc.known && blendSrc.value == src && blendDst.value == dst)) return;
+	glBlendFunc(src, dst);
+	blendSrc.known = true;
+	blendSrc.value = src;
+	blendDst.value = dst;
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height){
+	if(skip(viewportKnown && viewportValues[0] == x && viewportValues[1] == y && viewportValues[2] == width && viewportValues[3] == height)) return;
+	glViewport(x, y, width, height);
+	viewportKnown = true;
+	viewportValues[0] = x;
+	viewportValues[1] = y;
+	viewportValues[2] = width;
+	viewportValues[3] = height;
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::deletedProgram(GLuint id){
+	// a program in use is only deleted once it stops being used, the
+	// next glUseProgram has to go through
+	if(program.value == id){
+		program = Value();
+	}
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::deletedTexture(GLuint texture){
+	for(auto & unit: textures){
+		for(auto & binding: unit){
+			if(binding.texture == texture){
+				binding.texture = 0;
+			}
+		}
+	}
+}
+
+#ifndef TARGET_OPENGLES
+//----------------------------------------------------------
+void ofGLStateCache::deletedVertexArray(GLuint id){
+	if(vertexArray.value == id){
+		vertexArray.value = 0;
+	}
+}
+#endif
+
+//----------------------------------------------------------
+size_t ofGLStateCache::getNumCalls() const{
+	return numCalls;
+}
+
+//----------------------------------------------------------
+size_t ofGLStateCache::getNumSkippedCalls() const{
+	return numSkipped;
+}
+
+//----------------------------------------------------------
+void ofGLStateCache::resetCounters(){
+	numCalls = 0;
+	numSkipped = 0;
+}
+
+//----------------------------------------------------------
+ofGLStateCache & ofGetGLStateCache(){
+	// each thread has its own, only the render thread's is usually enabled
+	static thread_local ofGLStateCache cache;
+	return cache;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <vector>
+
+/// \brief Remembers the GL state set through it and skips the calls that
+/// wouldn't change anything
+///
+/// The renderers, ofShader, ofTexture and ofVbo set the current program,
+/// vertex array, texture bindings, blending, depth test, face culling and
+/// viewport through the cache returned by ofGetGLStateCache().
+///
+/// It's disabled by default because the GL calls an app or addon makes
+/// directly aren't seen by it. Enable it when all that state is changed
+/// through openFrameworks, or call invalidate() after changing it directly
+/// so the next calls go through:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofGetGLStateCache().setEnabled(true);
+/// }
+///
+/// void ofApp::draw(){
+///     glEnable(GL_CULL_FACE);
+///     ofGetGLStateCache().invalidate();
+///     ...
+///     ofDrawBitmapString(ofToString(ofGetGLStateCache().getNumSkippedCalls()), 20, 20);
+///     ofGetGLStateCache().resetCounters();
+/// }
+/// ~~~~
+///
+/// The state is only valid for one GL context, the renderers invalidate
+/// it at the beginning of every frame since each window can have its own.
+/// Every thread has its own cache, so the one of an ofGLUploadWorker stays
+/// disabled unless it's enabled from that thread.
+class ofGLStateCache{
+public:
+	ofGLStateCache();
+
+	/// \brief Enables or disables skipping redundant calls, when disabled
+	/// every call goes straight to GL
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	/// \brief Forgets all the state, the next call to each function always
+	/// reaches GL
+	void invalidate();
+
+	void useProgram(GLuint program);
+#ifndef TARGET_OPENGLES
+	void bindVertexArray(GLuint vertexArray);
+#endif
+	void activeTexture(GLenum unit);
+
+	/// \brief Binds texture to target in the active texture unit
+	void bindTexture(GLenum target, GLuint texture);
+
+	/// \brief Binds texture to target in unit, leaving unit active
+	void bindTexture(GLenum unit, GLenum target, GLuint texture);
+
+	/// \brief glEnable() or glDisable() cap, for any cap but meant for
+	/// GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE...
+	void setCapability(GLenum cap, bool enabled);
+	void blendEquation(GLenum mode);
+	void blendFunc(GLenum src, GLenum dst);
+	void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	/// \brief Has to be called when these objects are deleted. GL resets
+	/// the bindings of deleted objects to 0 and their names can be reused
+	void deletedProgram(GLuint program);
+	void deletedTexture(GLuint texture);
+#ifndef TARGET_OPENGLES
+	void deletedVertexArray(GLuint vertexArray);
+#endif
+
+	/// \brief Number of calls that reached GL since the last resetCounters()
+	std::size_t getNumCalls() const;
+
+	/// \brief Number of calls skipped since the last resetCounters()
+	/// because they wouldn't have changed anything
+	std::size_t getNumSkippedCalls() const;
+
+	void resetCounters();
+
+private:
+	bool skip(bool unchanged);
+
+	struct Value{
+		bool known = false;
+		GLuint value = 0;
+	};
+
+	struct TextureBinding{
+		GLenum target;
+		GLuint texture;
+	};
+
+	struct Capability{
+		GLenum cap;
+		bool enabled;
+	};
+
+	bool enabled;
+	Value program;
+	Value vertexArray;
+	Value activeUnit;
+	Value blendEquationMode;
+	Value blendSrc, blendDst;
+	bool viewportKnown;
+	GLint viewportValues[4];
+	std::vector<std::vector<TextureBinding>> textures;
+	std::vector<Capability> capabilities;
+	std::size_t numCalls;
+	std::size_t numSkipped;
+};
+
+/// \brief The state cache used by openFrameworks for the current GL context
+ofGLStateCache & ofGetGLStateCache();
@@ -0,0 +1,162 @@
+#include "ofGLUploadWorker.h"
+#include "ofAppBaseWindow.h"
+#include "ofAppRunner.h"
+#include "ofLog.h"
+
+using namespace std;
+
+//----------------------------------------------------------
+ofGLUpload::ofGLUpload()
+:finished(false)
+#ifndef TARGET_OPENGLES
+,fence(nullptr)
+#endif
+{}
+
+//----------------------------------------------------------
+ofGLUpload::~ofGLUpload(){
+#ifndef TARGET_OPENGLES
+	// sync objects are shared, any of the contexts can delete it
+	if(fence){
+		glDeleteSync(fence);
+	}
+#endif
+}
+
+//----------------------------------------------------------
+void ofGLUpload::finish(){
+#ifndef TARGET_OPENGLES
+	GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	// without a flush a context waiting for the fence could wait forever
+	glFlush();
+#else
+	// there's no fences in OpenGL ES 2, the upload is complete once
+	// glFinish() returns
+	glFinish();
+#endif
+	std::lock_guard<std::mutex> lock(mutex);
+#ifndef TARGET_OPENGLES
+	fence = sync;
+#endif
+	finished = true;
+	condition.notify_all();
+}
+
+//----------------------------------------------------------
+bool ofGLUpload::isReady() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	if(!finished){
+		return false;
+	}
+#ifndef TARGET_OPENGLES
+	GLenum ret = glClientWaitSync(fence, 0, 0);
+	return ret == GL_ALREADY_SIGNALED || ret == GL_CONDITION_SATISFIED;
+#else
+	return true;
+#endif
+}
+
+//----------------------------------------------------------
+void ofGLUpload::wait(){
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this]{ return finished; });
+#ifndef TARGET_OPENGLES
+	glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+#endif
+}
+
+//----------------------------------------------------------
+ofGLUploadWorker::ofGLUploadWorker()
+:closing(false){}
+
+//----------------------------------------------------------
+ofGLUploadWorker::~ofGLUploadWorker(){
+	close();
+}
+
+//----------------------------------------------------------
+bool ofGLUploadWorker::setup(ofAppBaseWindow & window){
+	close();
+	context = window.createSharedContext();
+	if(!context){
+		ofLogError("ofGLUploadWorker") << "setup(): the window can't create a shared context, uploads will run in the calling thread";
+		return false;
+	}
+	closing = false;
+	thread = std::thread(&ofGLUploadWorker::threadedFunction, this);
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofGLUploadWorker::setup(){
+	auto window = ofGetCurrentWindow();
+	if(!window){
+		ofLogError("ofGLUploadWorker") << "setup(): there's no current window";
+		return false;
+	}
+	return setup(*window);
+}
+
+//----------------------------------------------------------
+bool ofGLUploadWorker::isSetup() const{
+	return context != nullptr;
+}
+
+//----------------------------------------------------------
+void ofGLUploadWorker::close(){
+	if(thread.joinable()){
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			closing = true;
+		}
+		condition.notify_all();
+		thread.join();
+	}
+	// the context is destroyed in the main thread, glfw needs it
+	context.reset();
+}
+
+//----------------------------------------------------------
+shared_ptr<ofGLUpload> ofGLUploadWorker::upload(function<void()> upload){
+	auto handle = make_shared<ofGLUpload>();
+	if(!isSetup()){
+		upload();
+		handle->finish();
+		return handle;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.emplace_back(std::move(upload), handle);
+	}
+	condition.notify_one();
+	return handle;
+}
+
+//----------------------------------------------------------
+size_t ofGLUploadWorker::getNumPending() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending.size();
+}
+
+//----------------------------------------------------------
+void ofGLUploadWorker::threadedFunction(){
+	context->makeCurrent();
+	while(true){
+		function<void()> upload;
+		shared_ptr<ofGLUpload> handle;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]{ return closing || !pending.empty(); });
+			// the pending uploads are run before closing
+			if(pending.empty()){
+				break;
+			}
+			upload = std::move(pending.front().first);
+			handle = std::move(pending.front().second);
+			pending.pop_front();
+		}
+		upload();
+		handle->finish();
+	}
+	context->releaseCurrent();
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class ofAppBaseWindow;
+class ofBaseGLContext;
+
+/// \brief An upload queued in an ofGLUploadWorker, tells the render thread
+/// when the objects it created can be used
+class ofGLUpload{
+public:
+	ofGLUpload();
+	~ofGLUpload();
+
+	ofGLUpload(const ofGLUpload &) = delete;
+	ofGLUpload & operator=(const ofGLUpload &) = delete;
+
+	/// \brief Whether the worker has run the upload and the GPU has
+	/// finished it, never blocks
+	bool isReady() const;
+
+	/// \brief Makes the GL commands issued after it from the calling
+	/// thread wait for the upload on the GPU
+	///
+	/// Only blocks until the worker has run the upload, the render thread
+	/// waits on the fence without stalling.
+	void wait();
+
+private:
+	friend class ofGLUploadWorker;
+	void finish();
+
+	mutable std::mutex mutex;
+	std::condition_variable condition;
+	bool finished;
+#ifndef TARGET_OPENGLES
+	GLsync fence;
+#endif
+};
+
+/// \brief Runs GL uploads in a thread with its own context, shared with
+/// the window's one, so they don't take time from the render thread
+///
+/// Each upload is a function that can make any GL call, creating and
+/// filling textures or buffers, like ofTexture::loadData() or
+/// ofVbo::setMesh(). Once it's run the worker places a fence, and the
+/// handle returned by upload() tells when the objects are ready:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     worker.setup();
+/// }
+///
+/// // once the pixels are decoded, from the main thread
+/// upload = worker.upload([this, pixels]{
+///     texture.loadData(pixels);
+/// });
+///
+/// void ofApp::draw(){
+///     if(upload && upload->isReady()){
+///         texture.draw(0, 0);
+///     }
+/// }
+/// ~~~~
+///
+/// The objects uploaded can't be touched from the render thread until
+/// their upload is ready or wait() has been called. Vertex array objects
+/// aren't shared between contexts but ofVbo creates them when it's first
+/// drawn, so vbos can be uploaded too. ofFbo and ofVbo::bind() can't be
+/// used from the worker.
+///
+/// If the window can't create a shared context, or setup() wasn't called,
+/// upload() runs the function right away in the calling thread, so the
+/// same code works with or without a worker.
+class ofGLUploadWorker{
+public:
+	ofGLUploadWorker();
+	~ofGLUploadWorker();
+
+	ofGLUploadWorker(const ofGLUploadWorker &) = delete;
+	ofGLUploadWorker & operator=(const ofGLUploadWorker &) = delete;
+
+	/// \brief Creates a context shared with the window's one and starts
+	/// the worker thread, has to be called from the main thread
+	///
+	/// \returns false if the window can't create shared contexts
+	bool setup(ofAppBaseWindow & window);
+
+	/// \brief Sets up the worker with the current window
+	bool setup();
+
+	bool isSetup() const;
+
+	/// \brief Runs the pending uploads, stops the thread and destroys its
+	/// context, has to be called from the main thread
+	void close();
+
+	/// \brief Queues upload to run in the worker thread with its context
+	/// current, it can be called from any thread once setup
+	std::shared_ptr<ofGLUpload> upload(std::function<void()> upload);
+
+	/// \brief Number of uploads queued that haven't run yet
+	std::size_t getNumPending() const;
+
+private:
+	void threadedFunction();
+
+	std::shared_ptr<ofBaseGLContext> context;
+	std::thread thread;
+	mutable std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::pair<std::function<void()>, std::shared_ptr<ofGLUpload>>> pending;
+	bool closing;
+};
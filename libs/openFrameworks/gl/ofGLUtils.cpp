@@ -116,11 +116,7 @@ int ofGetGLFormatFromInternal(int glInternalFormat){
 			case GL_RGBA8:
 			case GL_RGBA16:
 			case GL_RGBA16F:
-		    case GL_RGBA16I:
-		    case GL_RGBA16UI:
 		    case GL_RGBA32F:
-		    case GL_RGBA32I:
-		    case GL_RGBA32UI:
 	#endif
 				 return GL_RGBA;
 
@@ -130,11 +126,7 @@ int ofGetGLFormatFromInternal(int glInternalFormat){
 			case GL_RGB8:
 			case GL_RGB16:
 		    case GL_RGB16F:
-		    case GL_RGB16I:
-		    case GL_RGB16UI:
 		    case GL_RGB32F:
-		    case GL_RGB32I:
-		    case GL_RGB32UI:
 	#endif
 				return GL_RGB;
 
@@ -173,23 +165,79 @@ int ofGetGLFormatFromInternal(int glInternalFormat){
 #ifndef TARGET_OPENGLES
 			case GL_R8:
 			case GL_R16:
-		    case GL_R16I:
-		    case GL_R16UI:
 			case GL_R16F:
 			case GL_R32F:
-		    case GL_R32I:
-		    case GL_R32UI:
 				return GL_RED;
 
 			case GL_RG8:
 			case GL_RG16:
-		    case GL_RG16I:
-		    case GL_RG16UI:
 			case GL_RG16F:
 			case GL_RG32F:
+				return GL_RG;
+
+			// integer textures can only be allocated, uploaded and read
+			// with the integer formats
+		    case GL_RGBA16I:
+		    case GL_RGBA16UI:
+		    case GL_RGBA32I:
+		    case GL_RGBA32UI:
+				return GL_RGBA_INTEGER;
+		    case GL_RGB16I:
+		    case GL_RGB16UI:
+		    case GL_RGB32I:
+		    case GL_RGB32UI:
+				return GL_RGB_INTEGER;
+		    case GL_R16I:
+		    case GL_R16UI:
+		    case GL_R32I:
+		    case GL_R32UI:
+				return GL_RED_INTEGER;
+		    case GL_RG16I:
+		    case GL_RG16UI:
 		    case GL_RG32I:
 		    case GL_RG32UI:
+				return GL_RG_INTEGER;
+#endif
+
+#if defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_0)
+			// ES 3 sized formats, integer ones can only be uploaded
+			// with the matching integer format
+			case GL_RGBA8:
+			case GL_RGBA16F:
+			case GL_RGBA32F:
+				return GL_RGBA;
+			case GL_RGBA16I:
+			case GL_RGBA16UI:
+			case GL_RGBA32I:
+			case GL_RGBA32UI:
+				return GL_RGBA_INTEGER;
+			case GL_RGB8:
+			case GL_RGB16F:
+			case GL_RGB32F:
+				return GL_RGB;
+			case GL_RGB16I:
+			case GL_RGB16UI:
+			case GL_RGB32I:
+			case GL_RGB32UI:
+				return GL_RGB_INTEGER;
+			case GL_R8:
+			case GL_R16F:
+			case GL_R32F:
+				return GL_RED;
+			case GL_R16I:
+			case GL_R16UI:
+			case GL_R32I:
+			case GL_R32UI:
+				return GL_RED_INTEGER;
+			case GL_RG8:
+			case GL_RG16F:
+			case GL_RG32F:
 				return GL_RG;
+			case GL_RG16I:
+			case GL_RG16UI:
+			case GL_RG32I:
+			case GL_RG32UI:
+				return GL_RG_INTEGER;
 #endif
 
 #ifndef TARGET_OPENGLES
@@ -292,6 +340,44 @@ int ofGetGlTypeFromInternal(int glInternalFormat){
 		    return GL_INT;
 #endif
 
+#if defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_0)
+		case GL_R8:
+		case GL_RG8:
+		case GL_RGB8:
+		case GL_RGBA8:
+			return GL_UNSIGNED_BYTE;
+		case GL_R32F:
+		case GL_RG32F:
+		case GL_RGB32F:
+		case GL_RGBA32F:
+			return GL_FLOAT;
+		case GL_R16F:
+		case GL_RG16F:
+		case GL_RGB16F:
+		case GL_RGBA16F:
+			return GL_HALF_FLOAT;
+		case GL_R16UI:
+		case GL_RG16UI:
+		case GL_RGB16UI:
+		case GL_RGBA16UI:
+			return GL_UNSIGNED_SHORT;
+		case GL_R16I:
+		case GL_RG16I:
+		case GL_RGB16I:
+		case GL_RGBA16I:
+			return GL_SHORT;
+		case GL_R32UI:
+		case GL_RG32UI:
+		case GL_RGB32UI:
+		case GL_RGBA32UI:
+			return GL_UNSIGNED_INT;
+		case GL_R32I:
+		case GL_RG32I:
+		case GL_RGB32I:
+		case GL_RGBA32I:
+			return GL_INT;
+#endif
+
 		case GL_STENCIL_INDEX:
 			return GL_UNSIGNED_BYTE;
 
@@ -660,6 +746,16 @@ int ofGetNumChannelsFromGLFormat(int glFormat){
 		return 1;
 	case GL_RG:
 		return 2;
+#endif
+#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
+	case GL_RED_INTEGER:
+		return 1;
+	case GL_RG_INTEGER:
+		return 2;
+	case GL_RGB_INTEGER:
+		return 3;
+	case GL_RGBA_INTEGER:
+		return 4;
 #endif
 	default:
 		return 1;
@@ -781,6 +877,106 @@ bool ofGLSupportsNPOTTextures(){
 #endif
 }
 
+vector<GLint> ofGLSupportedCompressedTextureFormats(){
+	GLint numFormats = 0;
+	glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &numFormats);
+	vector<GLint> formats(numFormats);
+	if(numFormats > 0){
+		glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+	}
+	return formats;
+}
+
+std::size_t ofGLGetCompressedBlockSize(GLint internalFormat){
+	switch(internalFormat){
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RED_RGTC1:
+	case GL_COMPRESSED_SIGNED_RED_RGTC1:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+bool ofGLSupportsCompressedTextureFormat(GLint internalFormat){
+	static set<GLint> formats;
+	static bool formatsChecked = false;
+	if(!formatsChecked){
+		auto supported = ofGLSupportedCompressedTextureFormats();
+		formats.insert(supported.begin(), supported.end());
+		formatsChecked = true;
+	}
+	if(formats.find(internalFormat) != formats.end()){
+		return true;
+	}
+
+	switch(internalFormat){
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		return ofGLCheckExtension("GL_EXT_texture_compression_s3tc");
+	case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		return ofGLCheckExtension("GL_EXT_texture_compression_s3tc")
+			&& (ofGLCheckExtension("GL_EXT_texture_sRGB") || ofGLCheckExtension("GL_EXT_texture_compression_s3tc_srgb"));
+	case GL_COMPRESSED_RED_RGTC1:
+	case GL_COMPRESSED_SIGNED_RED_RGTC1:
+	case GL_COMPRESSED_RG_RGTC2:
+	case GL_COMPRESSED_SIGNED_RG_RGTC2:
+		return ofGLCheckExtension("GL_ARB_texture_compression_rgtc") || ofGLCheckExtension("GL_EXT_texture_compression_rgtc");
+	case GL_COMPRESSED_RGBA_BPTC_UNORM:
+	case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+	case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+	case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+		return ofGLCheckExtension("GL_ARB_texture_compression_bptc") || ofGLCheckExtension("GL_EXT_texture_compression_bptc");
+	case GL_COMPRESSED_R11_EAC:
+	case GL_COMPRESSED_SIGNED_R11_EAC:
+	case GL_COMPRESSED_RG11_EAC:
+	case GL_COMPRESSED_SIGNED_RG11_EAC:
+	case GL_COMPRESSED_RGB8_ETC2:
+	case GL_COMPRESSED_SRGB8_ETC2:
+	case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+	case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+	case GL_COMPRESSED_RGBA8_ETC2_EAC:
+	case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+#ifdef TARGET_OPENGLES
+		// core in ES 3
+		return ofGetGLRenderer() && ofGetGLRenderer()->getGLVersionMajor() >= 3;
+#else
+		return ofGLCheckExtension("GL_ARB_ES3_compatibility");
+#endif
+	default:
+		if((internalFormat >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR && internalFormat <= GL_COMPRESSED_RGBA_ASTC_12x12_KHR)
+			|| (internalFormat >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR && internalFormat <= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR)){
+			return ofGLCheckExtension("GL_KHR_texture_compression_astc_ldr");
+		}
+		return false;
+	}
+}
+
+bool ofGLSupportsInstancing(){
+#ifndef TARGET_OPENGLES
+	return GLEW_VERSION_3_3 || (GLEW_ARB_draw_instanced && GLEW_ARB_instanced_arrays);
+#elif defined(GL_ES_VERSION_3_0)
+	return ofGetGLRenderer() && ofGetGLRenderer()->getGLVersionMajor() >= 3;
+#else
+	return false;
+#endif
+}
+
+bool ofGLSupportsTextureArrays(){
+#ifdef TARGET_OPENGLES
+	return false;
+#else
+	return (ofGetGLRenderer() && ofGetGLRenderer()->getGLVersionMajor() >= 3) || ofGLCheckExtension("GL_EXT_texture_array");
+#endif
+}
+
 string ofGLSLVersionFromGL(int major, int minor){
 #ifdef TARGET_OPENGLES
 	return "ES1";
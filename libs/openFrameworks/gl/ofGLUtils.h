@@ -79,6 +79,29 @@ std::vector<std::string> ofGLSupportedExtensions();
 bool ofGLCheckExtension(std::string searchName);
 bool ofGLSupportsNPOTTextures();
 
+/// \brief The compressed internal formats reported by the driver in
+/// GL_COMPRESSED_TEXTURE_FORMATS
+std::vector<GLint> ofGLSupportedCompressedTextureFormats();
+
+/// \brief Whether textures with a compressed internal format, like
+/// GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, can be uploaded with
+/// glCompressedTexImage2D, checking the extensions of each family for
+/// drivers that don't list all of them
+bool ofGLSupportsCompressedTextureFormat(GLint internalFormat);
+
+/// \brief Bytes of each 4x4 block of a BCn (DXT, RGTC, BPTC) compressed
+/// internal format
+std::size_t ofGLGetCompressedBlockSize(GLint internalFormat);
+
+/// \brief Whether GL_TEXTURE_2D_ARRAY textures are available, OpenGL 3.0
+/// or EXT_texture_array
+bool ofGLSupportsTextureArrays();
+
+/// \brief Whether instanced draws and attribute divisors are available,
+/// OpenGL 3.3 or an OpenGL ES 3 context in platforms built with the ES 3
+/// headers, like a WebGL 2 context in emscripten
+bool ofGLSupportsInstancing();
+
 bool ofIsGLProgrammableRenderer();
 
 template<class T>
@@ -136,11 +159,16 @@ void ofDisableGLDebugLog();
     #endif
 
 	#define GL_FRAMEBUFFER_INCOMPLETE_FORMATS				GL_FRAMEBUFFER_INCOMPLETE_FORMATS_OES
-	#define GL_UNSIGNED_INT_24_8							GL_UNSIGNED_INT_24_8_OES
-
-	#define GL_DEPTH24_STENCIL8								GL_DEPTH24_STENCIL8_OES
+	#ifndef GL_ES_VERSION_3_0
+		#define GL_UNSIGNED_INT_24_8						GL_UNSIGNED_INT_24_8_OES
+		#define GL_DEPTH24_STENCIL8							GL_DEPTH24_STENCIL8_OES
+		#define GL_DEPTH_COMPONENT24						GL_DEPTH_COMPONENT24_OES
+	#else
+		// the ES 3 format has a different value, ofFbo and ofTexture
+		// use it as the packed renderbuffer format in ES 2 and 3
+		#undef GL_DEPTH_STENCIL
+	#endif
 	#define GL_DEPTH_STENCIL								GL_DEPTH24_STENCIL8_OES
-	#define GL_DEPTH_COMPONENT24							GL_DEPTH_COMPONENT24_OES
 	#ifdef GL_DEPTH_COMPONENT32_OES
         #define GL_DEPTH_COMPONENT32						GL_DEPTH_COMPONENT32_OES
     #endif
@@ -154,4 +182,96 @@ void ofDisableGLDebugLog();
     #endif
 #endif
 
+// compressed texture formats, not in every platform's headers
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT					0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT					0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT					0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT					0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT					0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT			0x8C4D
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT
+	#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT			0x8C4E
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+	#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT			0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+	#define GL_COMPRESSED_RED_RGTC1							0x8DBB
+#endif
+#ifndef GL_COMPRESSED_SIGNED_RED_RGTC1
+	#define GL_COMPRESSED_SIGNED_RED_RGTC1					0x8DBC
+#endif
+#ifndef GL_COMPRESSED_RG_RGTC2
+	#define GL_COMPRESSED_RG_RGTC2							0x8DBD
+#endif
+#ifndef GL_COMPRESSED_SIGNED_RG_RGTC2
+	#define GL_COMPRESSED_SIGNED_RG_RGTC2					0x8DBE
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+	#define GL_COMPRESSED_RGBA_BPTC_UNORM					0x8E8C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+	#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM				0x8E8D
+#endif
+#ifndef GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT
+	#define GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT				0x8E8E
+#endif
+#ifndef GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT
+	#define GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT			0x8E8F
+#endif
+#ifndef GL_COMPRESSED_R11_EAC
+	#define GL_COMPRESSED_R11_EAC							0x9270
+#endif
+#ifndef GL_COMPRESSED_SIGNED_R11_EAC
+	#define GL_COMPRESSED_SIGNED_R11_EAC						0x9271
+#endif
+#ifndef GL_COMPRESSED_RG11_EAC
+	#define GL_COMPRESSED_RG11_EAC							0x9272
+#endif
+#ifndef GL_COMPRESSED_SIGNED_RG11_EAC
+	#define GL_COMPRESSED_SIGNED_RG11_EAC					0x9273
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+	#define GL_COMPRESSED_RGB8_ETC2							0x9274
+#endif
+#ifndef GL_COMPRESSED_SRGB8_ETC2
+	#define GL_COMPRESSED_SRGB8_ETC2							0x9275
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+	#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2		0x9276
+#endif
+#ifndef GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2
+	#define GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2		0x9277
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+	#define GL_COMPRESSED_RGBA8_ETC2_EAC						0x9278
+#endif
+#ifndef GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+	#define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC				0x9279
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+	#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR					0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_12x12_KHR
+	#define GL_COMPRESSED_RGBA_ASTC_12x12_KHR				0x93BD
+#endif
+#ifndef GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR
+	#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR			0x93D0
+#endif
+#ifndef GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR
+	#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR		0x93DD
+#endif
+
 #endif /* OFGLUTILS_H_ */
@@ -0,0 +1,174 @@
+#include "ofGpuMemory.h"
+#include "ofGLUtils.h"
+#include <map>
+#include <algorithm>
+#include <mutex>
+
+using namespace std;
+
+namespace{
+	struct Allocation{
+		uint64_t bytes;
+		string tag;
+	};
+
+	struct GpuMemory{
+		map<pair<ofGpuMemoryType,GLuint>,Allocation> allocations;
+		ofGpuMemoryUsage total;
+		ofGpuMemoryUsage types[OF_GPU_MEMORY_NUM_TYPES];
+		map<string,ofGpuMemoryUsage> tags;
+		vector<string> tagStack;
+		// objects can be created from an ofGLUploadWorker thread too
+		recursive_mutex mutex;
+	};
+
+	// allocated on first use and never deleted, textures in static objects
+	// are released after any static here would be destroyed
+	GpuMemory & gpuMemory(){
+		static GpuMemory * memory = new GpuMemory;
+		return *memory;
+	}
+
+	void add(ofGpuMemoryUsage & usage, uint64_t bytes){
+		usage.bytes += bytes;
+		usage.numAllocations++;
+		usage.peakBytes = max(usage.peakBytes, usage.bytes);
+	}
+
+	void remove(ofGpuMemoryUsage & usage, uint64_t bytes){
+		usage.bytes -= bytes;
+		usage.numAllocations--;
+	}
+
+	const char * typeName(ofGpuMemoryType type){
+		switch(type){
+		case OF_GPU_MEMORY_TEXTURE: return "texture";
+		case OF_GPU_MEMORY_RENDERBUFFER: return "renderbuffer";
+		case OF_GPU_MEMORY_BUFFER: return "buffer";
+		default: return "unknown";
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofGpuMemoryUsage ofGetGpuMemoryUsage(){
+	std::lock_guard<std::recursive_mutex> lock(gpuMemory().mutex);
+	return gpuMemory().total;
+}
+
+//----------------------------------------------------------
+ofGpuMemoryUsage ofGetGpuMemoryUsage(ofGpuMemoryType type){
+	if(type < 0 || type >= OF_GPU_MEMORY_NUM_TYPES){
+		return ofGpuMemoryUsage();
+	}
+	std::lock_guard<std::recursive_mutex> lock(gpuMemory().mutex);
+	return gpuMemory().types[type];
+}
+
+//----------------------------------------------------------
+ofGpuMemoryUsage ofGetGpuMemoryUsage(const string & tag){
+	std::lock_guard<std::recursive_mutex> lock(gpuMemory().mutex);
+	auto it = gpuMemory().tags.find(tag);
+	if(it == gpuMemory().tags.end()){
+		return ofGpuMemoryUsage();
+	}
+	return it->second;
+}
+
+//----------------------------------------------------------
+void ofPushGpuMemoryTag(const string & tag){
+	std::lock_guard<std::recursive_mutex> lock(gpuMemory().mutex);
+	gpuMemory().tagStack.push_back(tag);
+}
+
+//----------------------------------------------------------
+void ofPopGpuMemoryTag(){
+	std::lock_guard<std::recursive_mutex> lock(gpuMemory().mutex);
+	if(gpuMemory().tagStack.empty()){
+		ofLogWarning("ofGpuMemory") << "ofPopGpuMemoryTag(): tag stack is empty, more pops than pushes";
+		return;
+	}
+	gpuMemory().tagStack.pop_back();
+}
+
+//----------------------------------------------------------
+vector<ofGpuAllocation> ofGetGpuAllocations(){
+	vector<ofGpuAllocation> allocations;
+	std::lock_guard<std::recursive_mutex> lock(gpuMemory().mutex);
+	allocations.reserve(gpuMemory().allocations.size());
+	for(auto & allocation: gpuMemory().allocations){
+		allocations.push_back({allocation.first.first, allocation.first.second, allocation.second.bytes, allocation.second.tag});
+	}
+	stable_sort(allocations.begin(), allocations.end(), [](const ofGpuAllocation & a, const ofGpuAllocation & b){
+		return a.bytes > b.bytes;
+	});
+	return allocations;
+}
+
+//----------------------------------------------------------
+void ofLogGpuAllocations(ofLogLevel level){
+	if(!ofLogEnabled(level, "ofGpuMemory")){
+		return;
+	}
+	auto & memory = gpuMemory();
+	std::lock_guard<std::recursive_mutex> lock(memory.mutex);
+	ofLog(level, "ofGpuMemory") << "total: " << memory.total.bytes / 1024 << "KB in " << memory.total.numAllocations
+		<< " allocations, peak " << memory.total.peakBytes / 1024 << "KB";
+	for(int i = 0; i < OF_GPU_MEMORY_NUM_TYPES; i++){
+		auto & usage = memory.types[i];
+		ofLog(level, "ofGpuMemory") << typeName(ofGpuMemoryType(i)) << ": " << usage.bytes / 1024 << "KB in " << usage.numAllocations
+			<< ", peak " << usage.peakBytes / 1024 << "KB";
+	}
+	for(auto & tag: memory.tags){
+		ofLog(level, "ofGpuMemory") << "\"" << tag.first << "\": " << tag.second.bytes / 1024 << "KB in " << tag.second.numAllocations
+			<< ", peak " << tag.second.peakBytes / 1024 << "KB";
+	}
+	for(auto & allocation: ofGetGpuAllocations()){
+		ofLog(level, "ofGpuMemory") << typeName(allocation.type) << " " << allocation.id << ": "
+			<< allocation.bytes / 1024 << "KB \"" << allocation.tag << "\"";
+	}
+}
+
+//----------------------------------------------------------
+void of::priv::gpuMemoryAllocated(ofGpuMemoryType type, GLuint id, uint64_t bytes){
+	if(id == 0){
+		return;
+	}
+	auto & memory = gpuMemory();
+	std::lock_guard<std::recursive_mutex> lock(memory.mutex);
+	Allocation allocation;
+	allocation.bytes = bytes;
+	// resizing an object, like generating mipmaps, keeps the tag it had
+	auto it = memory.allocations.find(make_pair(type, id));
+	if(it != memory.allocations.end()){
+		allocation.tag = it->second.tag;
+		gpuMemoryReleased(type, id);
+	}else{
+		allocation.tag = memory.tagStack.empty() ? "untagged" : memory.tagStack.back();
+	}
+	add(memory.total, bytes);
+	add(memory.types[type], bytes);
+	add(memory.tags[allocation.tag], bytes);
+	memory.allocations[make_pair(type, id)] = allocation;
+}
+
+//----------------------------------------------------------
+void of::priv::gpuMemoryReleased(ofGpuMemoryType type, GLuint id){
+	auto & memory = gpuMemory();
+	std::lock_guard<std::recursive_mutex> lock(memory.mutex);
+	auto it = memory.allocations.find(make_pair(type, id));
+	if(it == memory.allocations.end()){
+		return;
+	}
+	remove(memory.total, it->second.bytes);
+	remove(memory.types[type], it->second.bytes);
+	remove(memory.tags[it->second.tag], it->second.bytes);
+	memory.allocations.erase(it);
+}
+
+//----------------------------------------------------------
+uint64_t of::priv::gpuMemoryBytes(int glInternalFormat, int w, int h){
+	int glFormat = ofGetGLFormatFromInternal(glInternalFormat);
+	int bytesPerPixel = ofGetNumChannelsFromGLFormat(glFormat) * ofGetBytesPerChannelFromGLType(ofGetGlTypeFromInternal(glInternalFormat));
+	return uint64_t(max(w, 0)) * max(h, 0) * bytesPerPixel;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofLog.h"
+
+/// \brief Kinds of GPU allocations tracked by ofGetGpuMemoryUsage()
+enum ofGpuMemoryType{
+	OF_GPU_MEMORY_TEXTURE,		///< ofTexture, including the textures of ofFbo
+	OF_GPU_MEMORY_RENDERBUFFER,	///< ofFbo multisampled and depth/stencil renderbuffers
+	OF_GPU_MEMORY_BUFFER,		///< ofBufferObject, including ofVbo
+	OF_GPU_MEMORY_NUM_TYPES
+};
+
+/// \brief Bytes allocated on the GPU and the most there ever was
+struct ofGpuMemoryUsage{
+	uint64_t bytes = 0;
+	uint64_t peakBytes = 0;
+	std::size_t numAllocations = 0;
+};
+
+/// \brief A live allocation, as listed by ofGetGpuAllocations()
+struct ofGpuAllocation{
+	ofGpuMemoryType type;
+	GLuint id;
+	uint64_t bytes;
+	std::string tag;
+};
+
+/// \brief Memory allocated by ofTexture, ofFbo and ofBufferObject
+///
+/// The sizes are computed from the dimensions and formats requested, the
+/// driver may use more for padding or alignment. Memory allocated with
+/// direct GL calls isn't included.
+ofGpuMemoryUsage ofGetGpuMemoryUsage();
+ofGpuMemoryUsage ofGetGpuMemoryUsage(ofGpuMemoryType type);
+/// \brief Memory allocated while tag was on top of the tag stack
+ofGpuMemoryUsage ofGetGpuMemoryUsage(const std::string & tag);
+
+/// \brief Tags every allocation made from now on until the tag is popped,
+/// to find out who owns what:
+///
+/// ~~~~{.cpp}
+/// ofPushGpuMemoryTag("particles");
+/// fbo.allocate(1920, 1080, GL_RGBA32F);
+/// ofPopGpuMemoryTag();
+/// ...
+/// ofLogNotice() << ofGetGpuMemoryUsage("particles").bytes;
+/// ~~~~
+///
+/// Allocations made without any tag are tagged "untagged".
+void ofPushGpuMemoryTag(const std::string & tag);
+void ofPopGpuMemoryTag();
+
+/// \brief Every allocation still alive, largest first
+std::vector<ofGpuAllocation> ofGetGpuAllocations();
+
+/// \brief Logs the totals per type and tag and every live allocation,
+/// useful to find leaks in applications that run for a long time
+void ofLogGpuAllocations(ofLogLevel level = OF_LOG_NOTICE);
+
+namespace of{
+namespace priv{
+	/// \brief Records the storage of a GL object, replacing any size
+	/// recorded before for the same object but keeping its tag
+	void gpuMemoryAllocated(ofGpuMemoryType type, GLuint id, uint64_t bytes);
+	void gpuMemoryReleased(ofGpuMemoryType type, GLuint id);
+	/// \brief Size of w x h pixels of a GL internal format
+	uint64_t gpuMemoryBytes(int glInternalFormat, int w, int h);
+}
+}
@@ -0,0 +1,497 @@
+#include "ofGpuParticles.h"
+#include "ofGLUtils.h"
+#include "ofAppRunner.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include <algorithm>
+
+using namespace std;
+
+const int ofGpuParticles::VELOCITY_ATTRIBUTE;
+const int ofGpuParticles::MAX_ATTRACTORS;
+
+namespace{
+	const string updateHeader = R"(#version 150
+uniform float dt;
+uniform float time;
+uniform int frameSeed;
+uniform int numParticles;
+uniform int emitStart;
+uniform int emitCount;
+
+in vec4 position;
+in vec4 velocity;
+out vec4 outPosition;
+out vec4 outVelocity;
+
+uint hash(uint x){
+	x ^= x >> 16u;
+	x *= 0x7feb352du;
+	x ^= x >> 15u;
+	x *= 0x846ca68bu;
+	x ^= x >> 16u;
+	return x;
+}
+
+float random(inout uint seed){
+	seed = hash(seed);
+	return float(seed) * (1.0 / 4294967295.0);
+}
+
+// uniformly distributed inside the unit sphere
+vec3 randomInSphere(inout uint seed){
+	float z = random(seed) * 2.0 - 1.0;
+	float a = random(seed) * 6.28318530718;
+	float r = sqrt(1.0 - z * z);
+	return vec3(r * cos(a), r * sin(a), z) * pow(random(seed), 1.0 / 3.0);
+}
+)";
+
+	const string defaultEmitter = R"(
+uniform int emitterShape;
+uniform vec3 emitterPosition;
+uniform vec3 emitterSize;
+uniform vec3 emitterVelocity;
+uniform float emitterSpread;
+uniform vec2 emitterLife;
+
+void emitParticle(inout uint seed, out vec3 position, out vec3 velocity, out float life){
+	position = emitterPosition;
+	if(emitterShape == 1){
+		position += randomInSphere(seed) * emitterSize;
+	}else if(emitterShape == 2){
+		position += (vec3(random(seed), random(seed), random(seed)) - 0.5) * emitterSize;
+	}
+	velocity = emitterVelocity + randomInSphere(seed) * emitterSpread;
+	life = mix(emitterLife.x, emitterLife.y, random(seed));
+}
+)";
+
+	const string forces = R"(
+uniform vec3 gravity;
+uniform float drag;
+uniform int numAttractors;
+uniform vec4 attractors[MAX_ATTRACTORS];
+uniform float attractorRadius[MAX_ATTRACTORS];
+uniform vec3 noiseField;
+
+void gravityAndDrag(inout vec3 position, inout vec3 velocity, float age, float life){
+	velocity += gravity * dt;
+	velocity *= max(1.0 - drag * dt, 0.0);
+}
+
+void attract(inout vec3 position, inout vec3 velocity, float age, float life){
+	for(int i = 0; i < numAttractors; i++){
+		vec3 d = attractors[i].xyz - position;
+		float dist = length(d);
+		if(dist < 0.0001){
+			continue;
+		}
+		float falloff = attractorRadius[i] > 0.0 ? max(1.0 - dist / attractorRadius[i], 0.0) : 1.0;
+		velocity += d / dist * attractors[i].w * falloff * dt;
+	}
+}
+
+// value noise in -1..1 on an integer lattice
+float lattice(vec3 c){
+	uvec3 u = uvec3(ivec3(c));
+	return float(hash(u.x * 73856093u ^ hash(u.y * 19349663u ^ hash(u.z * 83492791u)))) * (2.0 / 4294967295.0) - 1.0;
+}
+
+float valueNoise(vec3 p){
+	vec3 i = floor(p);
+	vec3 f = fract(p);
+	f = f * f * (3.0 - 2.0 * f);
+	return mix(mix(mix(lattice(i), lattice(i + vec3(1.0, 0.0, 0.0)), f.x),
+	               mix(lattice(i + vec3(0.0, 1.0, 0.0)), lattice(i + vec3(1.0, 1.0, 0.0)), f.x), f.y),
+	           mix(mix(lattice(i + vec3(0.0, 0.0, 1.0)), lattice(i + vec3(1.0, 0.0, 1.0)), f.x),
+	               mix(lattice(i + vec3(0.0, 1.0, 1.0)), lattice(i + vec3(1.0, 1.0, 1.0)), f.x), f.y), f.z);
+}
+
+void noiseForce(inout vec3 position, inout vec3 velocity, float age, float life){
+	if(noiseField.x == 0.0){
+		return;
+	}
+	vec3 p = position * noiseField.y + vec3(time * noiseField.z);
+	vec3 force = vec3(valueNoise(p), valueNoise(p + vec3(31.41, 17.33, 53.97)), valueNoise(p + vec3(-13.71, 71.29, 7.93)));
+	velocity += force * noiseField.x * dt;
+}
+)";
+
+	const string drawVertex = R"(#version 150
+uniform mat4 modelViewProjectionMatrix;
+uniform vec4 globalColor;
+uniform vec4 startColor;
+uniform vec4 endColor;
+uniform float pointSize;
+in vec4 position;
+in vec4 velocity;
+out vec4 particleColor;
+
+void main(){
+	bool alive = position.w < velocity.w;
+	particleColor = globalColor * mix(startColor, endColor, alive ? position.w / velocity.w : 1.0);
+	gl_PointSize = pointSize;
+	// dead particles end up outside of the clip space
+	gl_Position = alive ? modelViewProjectionMatrix * vec4(position.xyz, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);
+}
+)";
+
+	const string drawFragment = R"(#version 150
+in vec4 particleColor;
+out vec4 fragColor;
+
+void main(){
+	fragColor = particleColor;
+}
+)";
+
+	// position with the age in w, velocity with the lifetime in w
+	const size_t particleStride = sizeof(glm::vec4) * 2;
+}
+
+//----------------------------------------------------------
+ofGpuParticles::ofGpuParticles()
+:numParticles(0)
+,current(0)
+,shaderDirty(true)
+,emitAccumulator(0)
+,emitStart(0)
+,burst(0)
+,seed(0)
+,time(0)
+,gravity(0, 0, 0)
+,drag(0)
+,noise(0, 0.01, 0.1)
+,pointSize(1)
+,startColor(ofFloatColor::white)
+,endColor(1, 1, 1, 0){
+}
+
+//----------------------------------------------------------
+bool ofGpuParticles::isSupported(){
+#ifdef TARGET_OPENGLES
+	return false;
+#else
+	return ofIsGLProgrammableRenderer();
+#endif
+}
+
+//----------------------------------------------------------
+bool ofGpuParticles::setup(size_t numParticles){
+	if(!isSupported()){
+		ofLogError("ofGpuParticles") << "setup(): needs transform feedback, set the GL version to 3.2 or newer";
+		return false;
+	}
+	if(numParticles == 0){
+		ofLogError("ofGpuParticles") << "setup(): can't setup 0 particles";
+		return false;
+	}
+#ifndef TARGET_OPENGLES
+	if(!drawShader.isLoaded()){
+		if(!drawShader.setupShaderFromSource(GL_VERTEX_SHADER, drawVertex)
+			|| !drawShader.setupShaderFromSource(GL_FRAGMENT_SHADER, drawFragment)
+			|| !drawShader.bindDefaults()){
+			ofLogError("ofGpuParticles") << "setup(): couldn't compile the draw shader";
+			return false;
+		}
+		drawShader.bindAttribute(VELOCITY_ATTRIBUTE, "velocity");
+		if(!drawShader.linkProgram()){
+			ofLogError("ofGpuParticles") << "setup(): couldn't link the draw shader";
+			return false;
+		}
+	}
+
+	// every particle starts dead, age 0 and lifetime 0
+	vector<glm::vec4> dead(numParticles * 2, glm::vec4(0));
+	for(int i = 0; i < 2; i++){
+		buffers[i].allocate();
+		buffers[i].setData(dead, GL_DYNAMIC_COPY);
+		vbos[i].clear();
+		vbos[i].setVertexBuffer(buffers[i], 4, particleStride, 0);
+		vbos[i].setAttributeBuffer(VELOCITY_ATTRIBUTE, buffers[i], 4, particleStride, sizeof(glm::vec4));
+	}
+	this->numParticles = numParticles;
+	current = 0;
+	emitAccumulator = 0;
+	emitStart = 0;
+	burst = 0;
+	time = 0;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//----------------------------------------------------------
+bool ofGpuParticles::isSetup() const{
+	return numParticles > 0;
+}
+
+//----------------------------------------------------------
+bool ofGpuParticles::buildUpdateShader(){
+#ifndef TARGET_OPENGLES
+	string source = updateHeader;
+	source += "#define MAX_ATTRACTORS " + ofToString(MAX_ATTRACTORS) + "\n";
+	source += emitterModule.empty() ? defaultEmitter : emitterModule;
+	source += forces;
+	for(auto & module: modules){
+		source += module.source + "\n";
+	}
+	source += R"(
+void main(){
+	vec3 p = position.xyz;
+	float age = position.w;
+	vec3 v = velocity.xyz;
+	float life = velocity.w;
+	if(age >= life){
+		// only the dead particles in the emission window respawn
+		int offset = gl_VertexID - emitStart;
+		if(offset < 0){
+			offset += numParticles;
+		}
+		if(offset < emitCount){
+			uint seed = hash(uint(gl_VertexID) ^ hash(uint(frameSeed)));
+			emitParticle(seed, p, v, life);
+			age = 0.0;
+		}
+	}else{
+		gravityAndDrag(p, v, age, life);
+		attract(p, v, age, life);
+		noiseForce(p, v, age, life);
+)";
+	for(auto & module: modules){
+		source += "\t\t" + module.name + "(p, v, age, life);\n";
+	}
+	source += R"(		p += v * dt;
+		age += dt;
+	}
+	outPosition = vec4(p, age);
+	outVelocity = vec4(v, life);
+	gl_Position = vec4(0.0);
+}
+)";
+
+	updateShader.unload();
+	if(!updateShader.setupShaderFromSource(GL_VERTEX_SHADER, source) || !updateShader.bindDefaults()){
+		ofLogError("ofGpuParticles") << "buildUpdateShader(): couldn't compile the update shader";
+		return false;
+	}
+	updateShader.bindAttribute(VELOCITY_ATTRIBUTE, "velocity");
+	const char * varyings[] = {"outPosition", "outVelocity"};
+	glTransformFeedbackVaryings(updateShader.getProgram(), 2, varyings, GL_INTERLEAVED_ATTRIBS);
+	if(!updateShader.linkProgram()){
+		ofLogError("ofGpuParticles") << "buildUpdateShader(): couldn't link the update shader";
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setEmitter(const Emitter & emitter){
+	this->emitter = emitter;
+}
+
+//----------------------------------------------------------
+const ofGpuParticles::Emitter & ofGpuParticles::getEmitter() const{
+	return emitter;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::emit(size_t count){
+	burst += count;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setGravity(const glm::vec3 & gravity){
+	this->gravity = gravity;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setDrag(float drag){
+	this->drag = drag;
+}
+
+//----------------------------------------------------------
+int ofGpuParticles::addAttractor(const glm::vec3 & position, float strength, float radius){
+	if(attractors.size() >= size_t(MAX_ATTRACTORS)){
+		ofLogError("ofGpuParticles") << "addAttractor(): already " << MAX_ATTRACTORS << " attractors";
+		return -1;
+	}
+	attractors.push_back(glm::vec4(position, strength));
+	attractorRadius.push_back(radius);
+	return attractors.size() - 1;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setAttractor(size_t index, const glm::vec3 & position, float strength, float radius){
+	if(index >= attractors.size()){
+		ofLogError("ofGpuParticles") << "setAttractor(): attractor " << index << " doesn't exist";
+		return;
+	}
+	attractors[index] = glm::vec4(position, strength);
+	attractorRadius[index] = radius;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::clearAttractors(){
+	attractors.clear();
+	attractorRadius.clear();
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setNoise(float strength, float scale, float speed){
+	noise = glm::vec3(strength, scale, speed);
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::addModule(const string & name, const string & source){
+	removeModule(name);
+	modules.push_back({name, source});
+	shaderDirty = true;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::removeModule(const string & name){
+	auto it = std::find_if(modules.begin(), modules.end(), [&](const Module & module){
+		return module.name == name;
+	});
+	if(it != modules.end()){
+		modules.erase(it);
+		shaderDirty = true;
+	}
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setEmitterModule(const string & source){
+	emitterModule = source;
+	shaderDirty = true;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::update(){
+	update(ofGetLastFrameTime());
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::update(float dt){
+#ifndef TARGET_OPENGLES
+	if(!isSetup()){
+		return;
+	}
+	if(shaderDirty){
+		// a broken module keeps the particles still until it's fixed
+		shaderDirty = false;
+		if(!buildUpdateShader()){
+			return;
+		}
+	}
+	if(!updateShader.isLoaded()){
+		return;
+	}
+
+	// the emission window moves along the particles so each frame respawns
+	// the dead particles emitted longest ago
+	size_t count;
+	if(emitter.rate > 0){
+		emitAccumulator += emitter.rate * dt;
+		count = size_t(emitAccumulator);
+		emitAccumulator -= count;
+	}else{
+		count = numParticles;
+	}
+	count = std::min(count + burst, numParticles);
+	burst = 0;
+
+	updateShader.begin();
+	updateShader.setUniform1f("dt", dt);
+	updateShader.setUniform1f("time", time);
+	updateShader.setUniform1i("frameSeed", int(seed));
+	updateShader.setUniform1i("numParticles", int(numParticles));
+	updateShader.setUniform1i("emitStart", int(emitStart));
+	updateShader.setUniform1i("emitCount", int(count));
+	updateShader.setUniform1i("emitterShape", emitter.shape);
+	updateShader.setUniform3f("emitterPosition", emitter.position);
+	updateShader.setUniform3f("emitterSize", emitter.size);
+	updateShader.setUniform3f("emitterVelocity", emitter.velocity);
+	updateShader.setUniform1f("emitterSpread", emitter.velocitySpread);
+	updateShader.setUniform2f("emitterLife", emitter.minLife, emitter.maxLife);
+	updateShader.setUniform3f("gravity", gravity);
+	updateShader.setUniform1f("drag", drag);
+	updateShader.setUniform1i("numAttractors", attractors.size());
+	if(!attractors.empty()){
+		updateShader.setUniform4fv("attractors", &attractors[0].x, attractors.size());
+		updateShader.setUniform1fv("attractorRadius", attractorRadius.data(), attractorRadius.size());
+	}
+	updateShader.setUniform3f("noiseField", noise);
+	updateShader.end();
+
+	ofShader::TransformFeedbackBaseBinding binding(buffers[1 - current]);
+	glEnable(GL_RASTERIZER_DISCARD);
+	updateShader.beginTransformFeedback(GL_POINTS, binding);
+	vbos[current].draw(GL_POINTS, 0, numParticles);
+	updateShader.endTransformFeedback(binding);
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	current = 1 - current;
+	emitStart = (emitStart + count) % numParticles;
+	seed++;
+	time += dt;
+#endif
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setPointSize(float size){
+	pointSize = size;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::setColors(const ofFloatColor & start, const ofFloatColor & end){
+	startColor = start;
+	endColor = end;
+}
+
+//----------------------------------------------------------
+void ofGpuParticles::draw() const{
+#ifndef TARGET_OPENGLES
+	if(!isSetup()){
+		return;
+	}
+	glEnable(GL_PROGRAM_POINT_SIZE);
+	drawShader.begin();
+	drawShader.setUniform1f("pointSize", pointSize);
+	drawShader.setUniform4f("startColor", startColor);
+	drawShader.setUniform4f("endColor", endColor);
+	vbos[current].draw(GL_POINTS, 0, numParticles);
+	drawShader.end();
+	glDisable(GL_PROGRAM_POINT_SIZE);
+#endif
+}
+
+//----------------------------------------------------------
+ofVbo & ofGpuParticles::getVbo(){
+	return vbos[current];
+}
+
+//----------------------------------------------------------
+const ofVbo & ofGpuParticles::getVbo() const{
+	return vbos[current];
+}
+
+//----------------------------------------------------------
+const ofBufferObject & ofGpuParticles::getBuffer() const{
+	return buffers[current];
+}
+
+//----------------------------------------------------------
+const ofShader & ofGpuParticles::getUpdateShader() const{
+	return updateShader;
+}
+
+//----------------------------------------------------------
+size_t ofGpuParticles::getNumParticles() const{
+	return numParticles;
+}
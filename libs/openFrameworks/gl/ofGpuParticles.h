@@ -0,0 +1,199 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofBufferObject.h"
+#include "ofVbo.h"
+#include "ofShader.h"
+#include "ofColor.h"
+#include <vector>
+
+/// \brief A particle system simulated and drawn entirely on the GPU
+///
+/// The state of every particle lives in two ofBufferObjects, one is read
+/// while the other is written by a transform feedback pass and they swap
+/// every update(), so no particle data goes through the CPU after setup:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     particles.setup(1000000);
+///     ofGpuParticles::Emitter emitter;
+///     emitter.shape = ofGpuParticles::EMITTER_SPHERE;
+///     emitter.size = {50, 50, 50};
+///     emitter.velocity = {0, 100, 0};
+///     emitter.velocitySpread = 40;
+///     particles.setEmitter(emitter);
+///     particles.setGravity({0, -98, 0});
+///     particles.setNoise(200, 0.01, 0.2);
+/// }
+///
+/// void ofApp::update(){
+///     particles.update();
+/// }
+///
+/// void ofApp::draw(){
+///     cam.begin();
+///     particles.draw();
+///     cam.end();
+/// }
+/// ~~~~
+///
+/// Dead particles are respawned by the emitter, as soon as they die or at
+/// Emitter::rate particles per second, plus any emit() bursts. The
+/// emitter, the gravity and drag, the attractors and the noise field are
+/// GLSL modules of the update shader. Custom behaviours are added with
+/// addModule(), a function that modifies each living particle every
+/// update:
+///
+/// ~~~~{.cpp}
+/// particles.addModule("bounce", R"(
+///     void bounce(inout vec3 position, inout vec3 velocity, float age, float life){
+///         if(position.y < 0.0){
+///             position.y = 0.0;
+///             velocity.y = abs(velocity.y) * 0.5;
+///         }
+///     }
+/// )");
+/// ~~~~
+///
+/// Modules have access to the `dt` and `time` uniforms and the
+/// `random(inout uint seed)` and `randomInSphere(inout uint seed)`
+/// helpers, and can declare their own uniforms, set with
+/// getUpdateShader() between update() calls.
+///
+/// The particles are stored as a vec4 position, with the age in w, and a
+/// vec4 velocity, with the lifetime in w. getVbo() draws them with any
+/// shader, the velocity is at the VELOCITY_ATTRIBUTE location.
+///
+/// Needs the programmable renderer with OpenGL 3.2 or later, not
+/// available on OpenGL ES.
+class ofGpuParticles{
+public:
+	/// \brief Attribute location of the velocity in getVbo()
+	static const int VELOCITY_ATTRIBUTE = 4;
+	static const int MAX_ATTRACTORS = 8;
+
+	enum EmitterShape{
+		EMITTER_POINT,
+		EMITTER_SPHERE, ///< inside an ellipsoid of radius size
+		EMITTER_BOX,    ///< inside a box of size centered at position
+	};
+
+	struct Emitter{
+		EmitterShape shape = EMITTER_POINT;
+		glm::vec3 position{0, 0, 0};
+		glm::vec3 size{0, 0, 0};
+		glm::vec3 velocity{0, 0, 0};
+		/// radius of a random velocity added to velocity
+		float velocitySpread = 10;
+		float minLife = 1;
+		float maxLife = 3;
+		/// particles emitted per second, 0 respawns particles as soon as
+		/// they die
+		float rate = 0;
+	};
+
+	ofGpuParticles();
+
+	static bool isSupported();
+
+	/// \brief Allocates the buffers for numParticles, all dead
+	bool setup(std::size_t numParticles);
+	bool isSetup() const;
+
+	void setEmitter(const Emitter & emitter);
+	const Emitter & getEmitter() const;
+
+	/// \brief Emits count particles in the next update, on top of the rate
+	void emit(std::size_t count);
+
+	void setGravity(const glm::vec3 & gravity);
+	/// \brief Fraction of the velocity lost per second
+	void setDrag(float drag);
+
+	/// \brief Pulls the particles towards position, or pushes them with a
+	/// negative strength, only within radius if it's bigger than 0
+	///
+	/// \returns the index of the attractor or -1 if there's already
+	/// MAX_ATTRACTORS
+	int addAttractor(const glm::vec3 & position, float strength, float radius = 0);
+	void setAttractor(std::size_t index, const glm::vec3 & position, float strength, float radius = 0);
+	void clearAttractors();
+
+	/// \brief Random force field, 0 strength disables it
+	///
+	/// \param scale spatial frequency of the field
+	/// \param speed how fast the field changes over time
+	void setNoise(float strength, float scale, float speed);
+
+	/// \brief Adds a GLSL function called for every living particle
+	///
+	/// The source has to declare `void name(inout vec3 position, inout vec3
+	/// velocity, float age, float life)`. Modules run in the order they
+	/// were added, after the built in forces. The shader is rebuilt on the
+	/// next update().
+	void addModule(const std::string & name, const std::string & source);
+	void removeModule(const std::string & name);
+
+	/// \brief Replaces the emitter with a GLSL function
+	///
+	/// The source has to declare `void emitParticle(inout uint seed, out
+	/// vec3 position, out vec3 velocity, out float life)`, an empty source
+	/// restores the default emitter.
+	void setEmitterModule(const std::string & source);
+
+	/// \brief Advances the simulation by dt seconds
+	void update(float dt);
+	void update();
+
+	/// \brief Point size in pixels of draw()
+	void setPointSize(float size);
+
+	/// \brief Colors of the particles at birth and death, multiplied by the
+	/// current color
+	void setColors(const ofFloatColor & start, const ofFloatColor & end);
+
+	/// \brief Draws the living particles as points
+	void draw() const;
+
+	ofVbo & getVbo();
+	const ofVbo & getVbo() const;
+	/// \brief Buffer with the current state, interleaved position and
+	/// velocity
+	const ofBufferObject & getBuffer() const;
+	const ofShader & getUpdateShader() const;
+	std::size_t getNumParticles() const;
+
+private:
+	struct Module{
+		std::string name;
+		std::string source;
+	};
+
+	bool buildUpdateShader();
+
+	std::size_t numParticles;
+	std::size_t current;
+	ofBufferObject buffers[2];
+	ofVbo vbos[2];
+	ofShader updateShader;
+	ofShader drawShader;
+	bool shaderDirty;
+
+	Emitter emitter;
+	std::string emitterModule;
+	std::vector<Module> modules;
+	double emitAccumulator;
+	std::size_t emitStart;
+	std::size_t burst;
+	uint32_t seed;
+	float time;
+
+	glm::vec3 gravity;
+	float drag;
+	std::vector<glm::vec4> attractors;
+	std::vector<float> attractorRadius;
+	glm::vec3 noise;
+
+	float pointSize;
+	ofFloatColor startColor, endColor;
+};
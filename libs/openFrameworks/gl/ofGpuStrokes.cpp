@@ -0,0 +1,447 @@
+#include "ofGpuStrokes.h"
+#include "ofGLUtils.h"
+#include "ofPolyline.h"
+#include "ofRenderStats.h"
+#include "ofLog.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace{
+	// every segment of every line is an instance reading 4 consecutive
+	// points: the one before, its 2 ends and the one after
+	const int PREV_ATTRIBUTE = 4;
+	const int POINT_A_ATTRIBUTE = 5;
+	const int POINT_B_ATTRIBUTE = 6;
+	const int NEXT_ATTRIBUTE = 7;
+	const int COLOR_A_ATTRIBUTE = 8;
+	const int COLOR_B_ATTRIBUTE = 9;
+
+	// the width is stored in w, 0 separates the lines and a negative
+	// width marks a point that's only there to join the ends of a closed
+	// line
+	const glm::vec4 separator(0, 0, 0, 0);
+
+#ifdef TARGET_OPENGLES
+	const string shaderHeader = "#version 300 es\nprecision highp float;\nprecision highp int;\n";
+#else
+	const string shaderHeader = "#version 150\n";
+#endif
+
+	const string strokeVertex = R"(
+uniform mat4 modelViewProjectionMatrix;
+uniform vec4 globalColor;
+uniform vec4 viewport;
+uniform int join;
+uniform float miterLimit;
+
+in vec4 prevPoint;
+in vec4 pointA;
+in vec4 pointB;
+in vec4 nextPoint;
+in vec4 colorA;
+in vec4 colorB;
+
+flat out vec4 segment;
+flat out vec4 neighbors;
+flat out vec3 info;
+out vec4 strokeColor;
+
+vec2 toWindow(vec4 clip){
+	return (clip.xy / clip.w * 0.5 + 0.5) * viewport.zw + viewport.xy;
+}
+
+void main(){
+	segment = vec4(0.0);
+	neighbors = vec4(0.0);
+	info = vec3(0.0);
+	strokeColor = vec4(0.0);
+
+	vec4 clipA = modelViewProjectionMatrix * vec4(pointA.xyz, 1.0);
+	vec4 clipB = modelViewProjectionMatrix * vec4(pointB.xyz, 1.0);
+	vec2 a = toWindow(clipA);
+	vec2 b = toWindow(clipB);
+	float len = length(b - a);
+
+	// separators, joining points and segments behind the camera or too
+	// short to be seen end up outside of the clip space
+	if(pointA.w <= 0.0 || pointB.w <= 0.0 || clipA.w <= 0.0 || clipB.w <= 0.0 || len < 0.0001){
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+
+	vec2 d = (b - a) / len;
+	vec2 n = vec2(-d.y, d.x);
+	float halfWidth = pointA.w * 0.5;
+
+	float hasPrev = 0.0;
+	vec2 prev = a;
+	vec4 clipPrev = modelViewProjectionMatrix * vec4(prevPoint.xyz, 1.0);
+	if(prevPoint.w != 0.0 && clipPrev.w > 0.0){
+		prev = toWindow(clipPrev);
+		hasPrev = length(a - prev) < 0.0001 ? 0.0 : 1.0;
+	}
+	float hasNext = 0.0;
+	vec2 next = b;
+	vec4 clipNext = modelViewProjectionMatrix * vec4(nextPoint.xyz, 1.0);
+	if(nextPoint.w != 0.0 && clipNext.w > 0.0){
+		next = toWindow(clipNext);
+		hasNext = length(next - b) < 0.0001 ? 0.0 : 1.0;
+	}
+
+	// the quad covers the segment, the joins or caps at both ends and a
+	// pixel around for the antialiasing
+	int corner = gl_VertexID & 3;
+	float atB = float(corner & 1);
+	float side = corner < 2 ? -1.0 : 1.0;
+	float extension = join == 0 ? max(miterLimit, 1.0) : 1.0;
+	float along = halfWidth * extension + 1.0;
+	vec2 p = mix(a - d * along, b + d * along, atB) + n * side * (halfWidth + 1.0);
+
+	vec4 clip = mix(clipA, clipB, atB);
+	gl_Position = vec4(((p - viewport.xy) / viewport.zw * 2.0 - 1.0) * clip.w, clip.z, clip.w);
+
+	segment = vec4(a, b);
+	neighbors = vec4(prev, next);
+	info = vec3(hasPrev, hasNext, halfWidth);
+	strokeColor = globalColor * mix(colorA, colorB, atB);
+}
+)";
+
+	const string strokeFragment = R"(
+uniform int join;
+uniform int cap;
+uniform float miterLimit;
+
+flat in vec4 segment;
+flat in vec4 neighbors;
+flat in vec3 info;
+in vec4 strokeColor;
+out vec4 fragColor;
+
+// normal of the line that splits a join between its 2 segments
+vec2 joinTangent(vec2 d0, vec2 d1){
+	vec2 t = d0 + d1;
+	float len = length(t);
+	return len < 0.0001 ? d1 : t / len;
+}
+
+// signed distance to the stroke beyond one of the ends of the segment,
+// d points away from the segment
+float endDistance(vec2 p, vec2 end, vec2 d, float strip, float halfWidth, bool joined, vec2 t){
+	float beyond = dot(p - end, d);
+	if(beyond <= 0.0){
+		return strip;
+	}
+	if(!joined){
+		if(cap == 1){
+			return length(p - end) - halfWidth;
+		}else if(cap == 2){
+			return max(strip, beyond - halfWidth);
+		}
+		return max(strip, beyond);
+	}
+	if(join == 1){
+		return length(p - end) - halfWidth;
+	}
+	float cosHalf = abs(dot(d, t));
+	if(join == 0 && cosHalf * miterLimit >= 1.0){
+		return strip;
+	}
+	return max(strip, abs(dot(p - end, vec2(-t.y, t.x))) - halfWidth * cosHalf);
+}
+
+void main(){
+	vec2 p = gl_FragCoord.xy;
+	vec2 a = segment.xy;
+	vec2 b = segment.zw;
+	vec2 d = normalize(b - a);
+	vec2 n = vec2(-d.y, d.x);
+	bool hasPrev = info.x > 0.5;
+	bool hasNext = info.y > 0.5;
+	float halfWidth = info.z;
+
+	// each segment only draws its own half of the joins so the
+	// overlapping quads don't blend twice
+	vec2 tStart = hasPrev ? joinTangent(normalize(a - neighbors.xy), d) : d;
+	vec2 tEnd = hasNext ? joinTangent(d, normalize(neighbors.zw - b)) : d;
+	if(hasPrev && dot(p - a, tStart) < 0.0){
+		discard;
+	}
+	if(hasNext && dot(p - b, tEnd) >= 0.0){
+		discard;
+	}
+
+	float strip = abs(dot(p - a, n)) - halfWidth;
+	float dist = max(endDistance(p, a, -d, strip, halfWidth, hasPrev, tStart),
+	                 endDistance(p, b, d, strip, halfWidth, hasNext, tEnd));
+	float coverage = clamp(0.5 - dist, 0.0, 1.0);
+	if(coverage <= 0.0){
+		discard;
+	}
+	fragColor = vec4(strokeColor.rgb, strokeColor.a * coverage);
+}
+)";
+}
+
+//----------------------------------------------------------
+ofGpuStrokes::ofGpuStrokes()
+:points(1, separator)
+,colors(1, ofFloatColor(0, 0))
+,capacity(0)
+,dirtyStart(0)
+,dirtyEnd(0)
+,shaderChecked(false)
+,join(OF_LINE_JOIN_MITER)
+,cap(OF_LINE_CAP_BUTT)
+,miterLimit(4){
+}
+
+//----------------------------------------------------------
+bool ofGpuStrokes::isSupported(){
+	return ofIsGLProgrammableRenderer() && ofGLSupportsInstancing();
+}
+
+//----------------------------------------------------------
+bool ofGpuStrokes::setupShader() const{
+	if(shaderChecked){
+		return shader.isLoaded();
+	}
+	shaderChecked = true;
+	if(!isSupported()){
+		ofLogError("ofGpuStrokes") << "draw(): needs the programmable renderer with OpenGL 3.3 or OpenGL ES 3";
+		return false;
+	}
+	if(!shader.setupShaderFromSource(GL_VERTEX_SHADER, shaderHeader + strokeVertex)
+		|| !shader.setupShaderFromSource(GL_FRAGMENT_SHADER, shaderHeader + strokeFragment)){
+		ofLogError("ofGpuStrokes") << "draw(): couldn't compile the stroke shader";
+		shader.unload();
+		return false;
+	}
+	shader.bindAttribute(PREV_ATTRIBUTE, "prevPoint");
+	shader.bindAttribute(POINT_A_ATTRIBUTE, "pointA");
+	shader.bindAttribute(POINT_B_ATTRIBUTE, "pointB");
+	shader.bindAttribute(NEXT_ATTRIBUTE, "nextPoint");
+	shader.bindAttribute(COLOR_A_ATTRIBUTE, "colorA");
+	shader.bindAttribute(COLOR_B_ATTRIBUTE, "colorB");
+	if(!shader.linkProgram()){
+		ofLogError("ofGpuStrokes") << "draw(): couldn't link the stroke shader";
+		shader.unload();
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::layout(const ofPolyline & polyline, float width, const ofFloatColor & color, vector<glm::vec4> & points, vector<ofFloatColor> & colors) const{
+	// repeated points would leave segments without a direction
+	vector<glm::vec3> unique;
+	unique.reserve(polyline.size());
+	for(auto & v: polyline.getVertices()){
+		if(unique.empty() || unique.back() != glm::vec3(v)){
+			unique.push_back(v);
+		}
+	}
+	bool closed = polyline.isClosed();
+	if(closed && unique.size() > 1 && unique.back() == unique.front()){
+		unique.pop_back();
+	}
+	closed &= unique.size() > 2;
+
+	if(unique.size() > 1){
+		if(closed){
+			points.emplace_back(unique.back(), -width);
+		}
+		for(auto & v: unique){
+			points.emplace_back(v, width);
+		}
+		if(closed){
+			points.emplace_back(unique[0], width);
+			points.emplace_back(unique[1], -width);
+		}
+	}
+	points.push_back(separator);
+	colors.resize(points.size(), color);
+	colors.back() = ofFloatColor(0, 0);
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::invalidate(size_t offset, size_t count){
+	if(dirtyStart >= dirtyEnd){
+		dirtyStart = offset;
+		dirtyEnd = offset + count;
+	}else{
+		dirtyStart = std::min(dirtyStart, offset);
+		dirtyEnd = std::max(dirtyEnd, offset + count);
+	}
+}
+
+//----------------------------------------------------------
+size_t ofGpuStrokes::add(const ofPolyline & polyline, float width, const ofFloatColor & color){
+	Line line;
+	line.offset = points.size();
+	line.width = width;
+	line.color = color;
+	layout(polyline, width, color, points, colors);
+	line.count = points.size() - line.offset;
+	lines.push_back(line);
+	invalidate(line.offset, line.count);
+	return lines.size() - 1;
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::set(size_t index, const ofPolyline & polyline){
+	if(index >= lines.size()){
+		ofLogError("ofGpuStrokes") << "set(): line " << index << " doesn't exist";
+		return;
+	}
+	Line & line = lines[index];
+	vector<glm::vec4> linePoints;
+	vector<ofFloatColor> lineColors;
+	layout(polyline, line.width, line.color, linePoints, lineColors);
+	if(linePoints.size() == line.count){
+		std::copy(linePoints.begin(), linePoints.end(), points.begin() + line.offset);
+		std::copy(lineColors.begin(), lineColors.end(), colors.begin() + line.offset);
+		invalidate(line.offset, line.count);
+		return;
+	}
+
+	// the lines after this one move
+	points.erase(points.begin() + line.offset, points.begin() + line.offset + line.count);
+	points.insert(points.begin() + line.offset, linePoints.begin(), linePoints.end());
+	colors.erase(colors.begin() + line.offset, colors.begin() + line.offset + line.count);
+	colors.insert(colors.begin() + line.offset, lineColors.begin(), lineColors.end());
+	ptrdiff_t shift = ptrdiff_t(linePoints.size()) - ptrdiff_t(line.count);
+	line.count = linePoints.size();
+	for(size_t i = index + 1; i < lines.size(); i++){
+		lines[i].offset += shift;
+	}
+	invalidate(line.offset, points.size() - line.offset);
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::setWidth(size_t index, float width){
+	if(index >= lines.size()){
+		ofLogError("ofGpuStrokes") << "setWidth(): line " << index << " doesn't exist";
+		return;
+	}
+	Line & line = lines[index];
+	line.width = width;
+	for(size_t i = line.offset; i < line.offset + line.count; i++){
+		if(points[i].w > 0){
+			points[i].w = width;
+		}else if(points[i].w < 0){
+			points[i].w = -width;
+		}
+	}
+	invalidate(line.offset, line.count);
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::setColor(size_t index, const ofFloatColor & color){
+	if(index >= lines.size()){
+		ofLogError("ofGpuStrokes") << "setColor(): line " << index << " doesn't exist";
+		return;
+	}
+	Line & line = lines[index];
+	line.color = color;
+	std::fill(colors.begin() + line.offset, colors.begin() + line.offset + line.count - 1, color);
+	invalidate(line.offset, line.count);
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::clear(){
+	lines.clear();
+	points.assign(1, separator);
+	colors.assign(1, ofFloatColor(0, 0));
+	dirtyStart = dirtyEnd = 0;
+	invalidate(0, 1);
+}
+
+//----------------------------------------------------------
+size_t ofGpuStrokes::size() const{
+	return lines.size();
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::setJoin(ofLineJoin join){
+	this->join = join;
+}
+
+//----------------------------------------------------------
+ofLineJoin ofGpuStrokes::getJoin() const{
+	return join;
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::setCap(ofLineCap cap){
+	this->cap = cap;
+}
+
+//----------------------------------------------------------
+ofLineCap ofGpuStrokes::getCap() const{
+	return cap;
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::setMiterLimit(float limit){
+	miterLimit = limit;
+}
+
+//----------------------------------------------------------
+float ofGpuStrokes::getMiterLimit() const{
+	return miterLimit;
+}
+
+//----------------------------------------------------------
+void ofGpuStrokes::draw() const{
+#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
+	if(points.size() < 4 || !setupShader()){
+		return;
+	}
+
+	if(points.size() > capacity){
+		// grows to the whole buffer, smaller updates reuse it
+		if(!pointsBuffer.isAllocated()){
+			pointsBuffer.allocate();
+			colorsBuffer.allocate();
+		}
+		pointsBuffer.setData(points, GL_DYNAMIC_DRAW);
+		colorsBuffer.setData(colors, GL_DYNAMIC_DRAW);
+		capacity = points.size();
+		if(!vbo.hasAttribute(PREV_ATTRIBUTE)){
+			int pointAttributes[] = {PREV_ATTRIBUTE, POINT_A_ATTRIBUTE, POINT_B_ATTRIBUTE, NEXT_ATTRIBUTE};
+			for(int i = 0; i < 4; i++){
+				vbo.setAttributeBuffer(pointAttributes[i], pointsBuffer, 4, sizeof(glm::vec4), sizeof(glm::vec4) * i);
+				vbo.setAttributeDivisor(pointAttributes[i], 1);
+			}
+			int colorAttributes[] = {COLOR_A_ATTRIBUTE, COLOR_B_ATTRIBUTE};
+			for(int i = 0; i < 2; i++){
+				vbo.setAttributeBuffer(colorAttributes[i], colorsBuffer, 4, sizeof(ofFloatColor), sizeof(ofFloatColor) * (i + 1));
+				vbo.setAttributeDivisor(colorAttributes[i], 1);
+			}
+		}
+	}else if(dirtyStart < dirtyEnd){
+		size_t end = std::min(dirtyEnd, points.size());
+		pointsBuffer.updateData(dirtyStart * sizeof(glm::vec4), (end - dirtyStart) * sizeof(glm::vec4), &points[dirtyStart]);
+		colorsBuffer.updateData(dirtyStart * sizeof(ofFloatColor), (end - dirtyStart) * sizeof(ofFloatColor), &colors[dirtyStart]);
+	}
+	dirtyStart = dirtyEnd = 0;
+
+	// the quads are computed in window coordinates
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	size_t instances = points.size() - 3;
+	shader.begin();
+	shader.setUniform4f("viewport", viewport[0], viewport[1], viewport[2], viewport[3]);
+	shader.setUniform1i("join", join);
+	shader.setUniform1i("cap", cap);
+	shader.setUniform1f("miterLimit", miterLimit);
+	vbo.bind();
+	of::priv::countDraw(GL_TRIANGLE_STRIP, 4, instances);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances);
+	vbo.unbind();
+	shader.end();
+#endif
+}
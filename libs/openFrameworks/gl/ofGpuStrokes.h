@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofBufferObject.h"
+#include "ofVbo.h"
+#include "ofShader.h"
+#include "ofColor.h"
+#include <vector>
+
+class ofPolyline;
+
+enum ofLineJoin{
+	OF_LINE_JOIN_MITER,
+	OF_LINE_JOIN_ROUND,
+	OF_LINE_JOIN_BEVEL,
+};
+
+enum ofLineCap{
+	OF_LINE_CAP_BUTT,
+	OF_LINE_CAP_ROUND,
+	OF_LINE_CAP_SQUARE,
+};
+
+/// \brief Draws thick polylines with joins, caps and antialiasing on the GPU
+///
+/// The points of every line are uploaded once to a single buffer and each
+/// segment is expanded to a quad in the vertex shader, the fragment shader
+/// computes the distance to the stroke so the joins, the caps and the
+/// antialiased edges don't need any extra geometry. Thousands of lines
+/// are drawn with one draw call and animating them only uploads the
+/// points that changed:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     strokes.setJoin(OF_LINE_JOIN_ROUND);
+///     strokes.setCap(OF_LINE_CAP_ROUND);
+///     for(auto & line: lines){
+///         strokes.add(line, 8, ofColor::orange);
+///     }
+/// }
+///
+/// void ofApp::update(){
+///     for(size_t i = 0; i < lines.size(); i++){
+///         animate(lines[i]);
+///         strokes.set(i, lines[i]);
+///     }
+/// }
+///
+/// void ofApp::draw(){
+///     strokes.draw();
+/// }
+/// ~~~~
+///
+/// Widths are in pixels, like ofSetLineWidth(), and the colors are
+/// multiplied by the current color. The edges are blended so alpha
+/// blending has to be enabled, as it is by default.
+///
+/// The programmable renderer draws ofPolyline and ofPath outlines wider
+/// than 1 pixel with it, using miter joins and butt caps.
+///
+/// Needs the programmable renderer and instanced arrays, OpenGL 3.3 or
+/// OpenGL ES 3.
+class ofGpuStrokes{
+public:
+	ofGpuStrokes();
+
+	static bool isSupported();
+
+	/// \brief Adds a line with the width in pixels
+	///
+	/// \returns the index of the line, to change it later
+	std::size_t add(const ofPolyline & polyline, float width, const ofFloatColor & color = ofFloatColor::white);
+
+	/// \brief Replaces the points of a line
+	///
+	/// When the number of points doesn't change only this line is uploaded
+	/// again, otherwise the whole buffer is.
+	void set(std::size_t index, const ofPolyline & polyline);
+	void setWidth(std::size_t index, float width);
+	void setColor(std::size_t index, const ofFloatColor & color);
+
+	void clear();
+	std::size_t size() const;
+
+	void setJoin(ofLineJoin join);
+	ofLineJoin getJoin() const;
+
+	void setCap(ofLineCap cap);
+	ofLineCap getCap() const;
+
+	/// \brief Miter joins longer than limit times the width are beveled
+	void setMiterLimit(float limit);
+	float getMiterLimit() const;
+
+	void draw() const;
+
+private:
+	struct Line{
+		std::size_t offset;
+		std::size_t count;
+		float width;
+		ofFloatColor color;
+	};
+
+	bool setupShader() const;
+	void layout(const ofPolyline & polyline, float width, const ofFloatColor & color, std::vector<glm::vec4> & points, std::vector<ofFloatColor> & colors) const;
+	void invalidate(std::size_t offset, std::size_t count);
+
+	std::vector<Line> lines;
+	std::vector<glm::vec4> points;
+	std::vector<ofFloatColor> colors;
+
+	// uploaded on the next draw
+	mutable ofBufferObject pointsBuffer;
+	mutable ofBufferObject colorsBuffer;
+	mutable ofVbo vbo;
+	mutable ofShader shader;
+	mutable std::size_t capacity;
+	mutable std::size_t dirtyStart;
+	mutable std::size_t dirtyEnd;
+	mutable bool shaderChecked;
+
+	ofLineJoin join;
+	ofLineCap cap;
+	float miterLimit;
+};
@@ -0,0 +1,327 @@
+#include "ofInstancedMesh.h"
+#include "ofGLProgrammableRenderer.h"
+#include "ofGraphics.h"
+#include "ofLog.h"
+
+static const glm::mat4 identityTransform(1.f);
+static const ofFloatColor whiteColor(1.f,1.f,1.f,1.f);
+
+//----------------------------------------------------------
+ofInstancedMesh::ofInstancedMesh()
+:numInstances(0)
+,bUsingInstanceColors(false)
+,bUsingInstanceLayers(false){
+	instanceArrays[TRANSFORM_ATTRIBUTE].numCoords = 16;
+	instanceArrays[COLOR_INSTANCE_ATTRIBUTE].numCoords = 4;
+	instanceArrays[LAYER_INSTANCE_ATTRIBUTE].numCoords = 1;
+}
+
+//----------------------------------------------------------
+ofInstancedMesh::ofInstancedMesh(const ofMesh & mom)
+:ofVboMesh(mom)
+,numInstances(0)
+,bUsingInstanceColors(false)
+,bUsingInstanceLayers(false){
+	instanceArrays[TRANSFORM_ATTRIBUTE].numCoords = 16;
+	instanceArrays[COLOR_INSTANCE_ATTRIBUTE].numCoords = 4;
+	instanceArrays[LAYER_INSTANCE_ATTRIBUTE].numCoords = 1;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::operator=(const ofMesh & mom){
+	ofVboMesh::operator=(mom);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setNumInstances(std::size_t numInstances){
+	this->numInstances = numInstances;
+	for(auto & array: instanceArrays){
+		const float * defaultValue = nullptr;
+		if(array.first == TRANSFORM_ATTRIBUTE){
+			defaultValue = &identityTransform[0][0];
+		}else if(array.first == COLOR_INSTANCE_ATTRIBUTE){
+			defaultValue = &whiteColor.r;
+		}
+		resizeArray(array.second, defaultValue);
+	}
+}
+
+//----------------------------------------------------------
+std::size_t ofInstancedMesh::getNumInstances() const{
+	return numInstances;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::resizeArray(InstanceArray & array, const float * defaultValue){
+	std::size_t prevInstances = array.data.size() / array.numCoords;
+	array.data.resize(numInstances * array.numCoords, 0.f);
+	if(defaultValue){
+		for(std::size_t i = prevInstances; i < numInstances; i++){
+			std::copy(defaultValue, defaultValue + array.numCoords, array.data.begin() + i * array.numCoords);
+		}
+	}
+	// the buffer is reallocated on the next draw if the size changed
+	array.dirtyBegin = 0;
+	array.dirtyEnd = numInstances;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::markDirty(InstanceArray & array, std::size_t instance){
+	if(array.dirtyBegin == array.dirtyEnd){
+		array.dirtyBegin = instance;
+		array.dirtyEnd = instance + 1;
+	}else{
+		array.dirtyBegin = std::min(array.dirtyBegin, instance);
+		array.dirtyEnd = std::max(array.dirtyEnd, instance + 1);
+	}
+}
+
+//----------------------------------------------------------
+ofInstancedMesh::InstanceArray * ofInstancedMesh::getArray(int location, const char * method){
+	auto it = instanceArrays.find(location);
+	if(it == instanceArrays.end()){
+		ofLogError("ofInstancedMesh") << method << "(): no instance attribute at location " << location;
+		return nullptr;
+	}
+	return &it->second;
+}
+
+//----------------------------------------------------------
+const ofInstancedMesh::InstanceArray * ofInstancedMesh::getArray(int location, const char * method) const{
+	return const_cast<ofInstancedMesh*>(this)->getArray(location, method);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setTransform(std::size_t instance, const glm::mat4 & transform){
+	setInstanceAttribute(TRANSFORM_ATTRIBUTE, instance, &transform[0][0], 16);
+}
+
+//----------------------------------------------------------
+const glm::mat4 & ofInstancedMesh::getTransform(std::size_t instance) const{
+	if(instance >= numInstances){
+		ofLogError("ofInstancedMesh") << "getTransform(): instance " << instance << " out of range";
+		return identityTransform;
+	}
+	return *reinterpret_cast<const glm::mat4*>(getInstanceAttribute(TRANSFORM_ATTRIBUTE, instance));
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setColor(std::size_t instance, const ofFloatColor & color){
+	enableInstanceColors();
+	setInstanceAttribute(COLOR_INSTANCE_ATTRIBUTE, instance, &color.r, 4);
+}
+
+//----------------------------------------------------------
+const ofFloatColor & ofInstancedMesh::getColor(std::size_t instance) const{
+	if(instance >= numInstances){
+		ofLogError("ofInstancedMesh") << "getColor(): instance " << instance << " out of range";
+		return whiteColor;
+	}
+	return *reinterpret_cast<const ofFloatColor*>(getInstanceAttribute(COLOR_INSTANCE_ATTRIBUTE, instance));
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::enableInstanceColors(){
+	bUsingInstanceColors = true;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::disableInstanceColors(){
+	bUsingInstanceColors = false;
+}
+
+//----------------------------------------------------------
+bool ofInstancedMesh::usingInstanceColors() const{
+	return bUsingInstanceColors;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setLayer(std::size_t instance, float layer){
+	enableInstanceLayers();
+	setInstanceAttribute(LAYER_INSTANCE_ATTRIBUTE, instance, &layer, 1);
+}
+
+//----------------------------------------------------------
+float ofInstancedMesh::getLayer(std::size_t instance) const{
+	if(instance >= numInstances){
+		ofLogError("ofInstancedMesh") << "getLayer(): instance " << instance << " out of range";
+		return 0;
+	}
+	return *getInstanceAttribute(LAYER_INSTANCE_ATTRIBUTE, instance);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::enableInstanceLayers(){
+	bUsingInstanceLayers = true;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::disableInstanceLayers(){
+	bUsingInstanceLayers = false;
+}
+
+//----------------------------------------------------------
+bool ofInstancedMesh::usingInstanceLayers() const{
+	return bUsingInstanceLayers;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::addInstanceAttribute(int location, int numCoords){
+	if(location <= LAYER_INSTANCE_ATTRIBUTE){
+		ofLogError("ofInstancedMesh") << "addInstanceAttribute(): locations up to " << LAYER_INSTANCE_ATTRIBUTE << " are reserved";
+		return;
+	}
+	if(numCoords < 1 || numCoords > 4){
+		ofLogError("ofInstancedMesh") << "addInstanceAttribute(): attributes can have 1 to 4 floats, got " << numCoords;
+		return;
+	}
+	removeInstanceAttribute(location);
+	auto & array = instanceArrays[location];
+	array.numCoords = numCoords;
+	resizeArray(array, nullptr);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::removeInstanceAttribute(int location){
+	if(location <= LAYER_INSTANCE_ATTRIBUTE) return;
+	auto it = instanceArrays.find(location);
+	if(it != instanceArrays.end()){
+		if(it->second.bound){
+			getVbo().clearAttribute(location);
+		}
+		instanceArrays.erase(it);
+	}
+}
+
+//----------------------------------------------------------
+bool ofInstancedMesh::hasInstanceAttribute(int location) const{
+	return location > LAYER_INSTANCE_ATTRIBUTE && instanceArrays.find(location) != instanceArrays.end();
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setInstanceAttribute(int location, std::size_t instance, const float * values, int numCoords){
+	auto array = getArray(location, "setInstanceAttribute");
+	if(!array) return;
+	if(instance >= numInstances){
+		ofLogError("ofInstancedMesh") << "setInstanceAttribute(): instance " << instance << " out of range, call setNumInstances() first";
+		return;
+	}
+	if(numCoords != array->numCoords){
+		ofLogError("ofInstancedMesh") << "setInstanceAttribute(): attribute at location " << location << " has " << array->numCoords << " coordinates, got " << numCoords;
+		return;
+	}
+	std::copy(values, values + numCoords, array->data.begin() + instance * numCoords);
+	markDirty(*array, instance);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setInstanceAttribute(int location, std::size_t instance, float value){
+	setInstanceAttribute(location, instance, &value, 1);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setInstanceAttribute(int location, std::size_t instance, const glm::vec2 & value){
+	setInstanceAttribute(location, instance, &value.x, 2);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setInstanceAttribute(int location, std::size_t instance, const glm::vec3 & value){
+	setInstanceAttribute(location, instance, &value.x, 3);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::setInstanceAttribute(int location, std::size_t instance, const glm::vec4 & value){
+	setInstanceAttribute(location, instance, &value.x, 4);
+}
+
+//----------------------------------------------------------
+const float * ofInstancedMesh::getInstanceAttribute(int location, std::size_t instance) const{
+	auto array = getArray(location, "getInstanceAttribute");
+	if(!array || instance >= numInstances) return nullptr;
+	return array->data.data() + instance * array->numCoords;
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::updateInstanceBuffers(){
+#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
+	ofVbo & vbo = getVbo();
+	for(auto & it: instanceArrays){
+		int location = it.first;
+		auto & array = it.second;
+		bool enabled = (location != COLOR_INSTANCE_ATTRIBUTE || bUsingInstanceColors) && (location != LAYER_INSTANCE_ATTRIBUTE || bUsingInstanceLayers);
+		if(!enabled){
+			if(array.bound){
+				vbo.clearAttribute(location);
+				array.bound = false;
+			}
+			continue;
+		}
+
+		std::size_t stride = array.numCoords * sizeof(float);
+		if(array.data.size() != array.bufferSize){
+			// the buffer keeps its id when respecified, so the vbo
+			// attributes pointing to it stay valid
+			if(!array.buffer.isAllocated()){
+				array.buffer.allocate();
+			}
+			array.buffer.setData(array.data.size() * sizeof(float), array.data.data(), GL_DYNAMIC_DRAW);
+			array.bufferSize = array.data.size();
+		}else if(array.dirtyBegin < array.dirtyEnd){
+			array.buffer.updateData(array.dirtyBegin * stride, (array.dirtyEnd - array.dirtyBegin) * stride, array.data.data() + array.dirtyBegin * array.numCoords);
+		}
+		array.dirtyBegin = array.dirtyEnd = 0;
+
+		if(!array.bound && array.buffer.isAllocated()){
+			// a mat4 takes 4 consecutive locations, one per column
+			int numLocations = (array.numCoords + 3) / 4;
+			for(int i = 0; i < numLocations; i++){
+				int numCoords = std::min(array.numCoords - i * 4, 4);
+				vbo.setAttributeBuffer(location + i, array.buffer, numCoords, stride, i * 4 * sizeof(float));
+				vbo.setAttributeDivisor(location + i, 1);
+			}
+			array.bound = true;
+		}
+	}
+#endif
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::draw(ofPolyRenderMode drawMode) const{
+	if(getNumVertices() == 0 || numInstances == 0) return;
+
+	auto renderer = ofGetGLRenderer();
+	if(!renderer) return;
+#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
+	#ifdef TARGET_OPENGLES
+	// ES 2 contexts, like WebGL 1, draw the instances one by one
+	if(renderer->getType() == ofGLProgrammableRenderer::TYPE && ofGLSupportsInstancing()){
+	#else
+	if(renderer->getType() == ofGLProgrammableRenderer::TYPE){
+	#endif
+		const_cast<ofInstancedMesh*>(this)->updateInstanceBuffers();
+		auto programmable = static_cast<ofGLProgrammableRenderer*>(renderer.get());
+		programmable->setInstancing(true, bUsingInstanceColors);
+		programmable->drawInstanced(*this, drawMode, numInstances);
+		programmable->setInstancing(false, false);
+		return;
+	}
+#endif
+	drawInstancesFixedPipeline(drawMode);
+}
+
+//----------------------------------------------------------
+void ofInstancedMesh::drawInstancesFixedPipeline(ofPolyRenderMode drawMode) const{
+	ofFloatColor styleColor = ofGetStyle().color;
+	for(std::size_t i = 0; i < numInstances; i++){
+		ofPushMatrix();
+		ofMultMatrix(getTransform(i));
+		if(bUsingInstanceColors){
+			ofSetColor(styleColor * getColor(i));
+		}
+		ofVboMesh::drawInstanced(drawMode, 1);
+		ofPopMatrix();
+	}
+	if(bUsingInstanceColors){
+		ofSetColor(styleColor);
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "ofVboMesh.h"
+#include "ofColor.h"
+#include <map>
+
+/// \brief A vbo mesh drawn many times in one call, with per instance
+/// transforms, colors and custom attributes
+///
+/// Every instance has a transform, applied before the model view matrix,
+/// and optionally a color that multiplies the color of the mesh. With the
+/// programmable renderer the default shaders apply both, so no GLSL is
+/// needed to draw lots of copies of a mesh:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// boxes = ofMesh::box(10,10,10);
+/// boxes.setNumInstances(1000);
+/// for(size_t i=0;i<boxes.getNumInstances();i++){
+///     boxes.setTransform(i, glm::translate(glm::vec3(ofRandom(-500,500), ofRandom(-500,500), 0)));
+///     boxes.setColor(i, ofFloatColor(ofRandom(1), ofRandom(1), ofRandom(1)));
+/// }
+///
+/// // draw
+/// boxes.draw();
+/// ~~~~
+///
+/// Only the instances modified since the last draw are uploaded.
+///
+/// Bound to an array texture, see ofTexture::allocateAsArray(), each
+/// instance can draw a different layer set with setLayer(), so sprites
+/// with different images are drawn in one call.
+///
+/// Custom shaders can read the transform from a mat4 attribute at
+/// TRANSFORM_ATTRIBUTE, the color from a vec4 at COLOR_INSTANCE_ATTRIBUTE,
+/// the layer from a float at LAYER_INSTANCE_ATTRIBUTE and any custom
+/// attribute from the location it was added at, which should be bigger
+/// than LAYER_INSTANCE_ATTRIBUTE.
+///
+/// The fixed pipeline renderer can't read per instance attributes, there
+/// every instance is drawn with a separate call applying its transform
+/// and color, custom attributes are ignored.
+class ofInstancedMesh: public ofVboMesh{
+public:
+	using ofVboMesh::draw;
+
+	ofInstancedMesh();
+	ofInstancedMesh(const ofMesh & mom);
+	void operator=(const ofMesh & mom);
+
+	/// first of the 4 consecutive locations used by the transform matrix
+	static const int TRANSFORM_ATTRIBUTE = 4;
+	static const int COLOR_INSTANCE_ATTRIBUTE = 8;
+	static const int LAYER_INSTANCE_ATTRIBUTE = 9;
+
+	/// \brief Resizes the per instance arrays, new instances get an
+	/// identity transform, white color, layer 0 and 0 for custom attributes
+	void setNumInstances(std::size_t numInstances);
+	std::size_t getNumInstances() const;
+
+	void setTransform(std::size_t instance, const glm::mat4 & transform);
+	const glm::mat4 & getTransform(std::size_t instance) const;
+
+	/// \brief Sets the color of an instance, enables instance colors
+	void setColor(std::size_t instance, const ofFloatColor & color);
+	const ofFloatColor & getColor(std::size_t instance) const;
+	void enableInstanceColors();
+	void disableInstanceColors();
+	bool usingInstanceColors() const;
+
+	/// \brief Sets the layer of the array texture an instance samples,
+	/// enables instance layers
+	void setLayer(std::size_t instance, float layer);
+	float getLayer(std::size_t instance) const;
+	void enableInstanceLayers();
+	void disableInstanceLayers();
+	bool usingInstanceLayers() const;
+
+	/// \brief Adds a custom per instance attribute of 1 to 4 floats
+	void addInstanceAttribute(int location, int numCoords);
+	void removeInstanceAttribute(int location);
+	bool hasInstanceAttribute(int location) const;
+	void setInstanceAttribute(int location, std::size_t instance, float value);
+	void setInstanceAttribute(int location, std::size_t instance, const glm::vec2 & value);
+	void setInstanceAttribute(int location, std::size_t instance, const glm::vec3 & value);
+	void setInstanceAttribute(int location, std::size_t instance, const glm::vec4 & value);
+	/// \brief Points to the attribute values of an instance, as many
+	/// floats as numCoords passed to addInstanceAttribute()
+	const float * getInstanceAttribute(int location, std::size_t instance) const;
+
+	/// \brief Draws all the instances
+	void draw(ofPolyRenderMode drawMode) const;
+
+private:
+	struct InstanceArray{
+		std::vector<float> data;
+		int numCoords = 0;
+		ofBufferObject buffer;
+		std::size_t bufferSize = 0;
+		std::size_t dirtyBegin = 0;
+		std::size_t dirtyEnd = 0;
+		bool bound = false;
+	};
+
+	InstanceArray * getArray(int location, const char * method);
+	const InstanceArray * getArray(int location, const char * method) const;
+	void setInstanceAttribute(int location, std::size_t instance, const float * values, int numCoords);
+	void resizeArray(InstanceArray & array, const float * defaultValue);
+	void markDirty(InstanceArray & array, std::size_t instance);
+	void updateInstanceBuffers();
+	void drawInstancesFixedPipeline(ofPolyRenderMode drawMode) const;
+
+	std::map<int,InstanceArray> instanceArrays;
+	std::size_t numInstances;
+	bool bUsingInstanceColors;
+	bool bUsingInstanceLayers;
+};
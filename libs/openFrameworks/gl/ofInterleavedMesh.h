@@ -0,0 +1,325 @@
+#pragma once
+
+#include "ofVbo.h"
+#include <cstddef>
+#include <type_traits>
+
+/// \file
+/// Vertex types for ofInterleavedMesh_. Any standard layout struct with a
+/// glm::vec3 or glm::vec2 position can be used as a vertex, the optional
+/// members color (ofFloatColor), normal (glm::vec3) and texCoord
+/// (glm::vec2) are found at compile time by their names.
+
+struct ofVertexP{
+	glm::vec3 position;
+};
+
+struct ofVertexPC{
+	glm::vec3 position;
+	ofFloatColor color;
+};
+
+struct ofVertexPN{
+	glm::vec3 position;
+	glm::vec3 normal;
+};
+
+struct ofVertexPT{
+	glm::vec3 position;
+	glm::vec2 texCoord;
+};
+
+struct ofVertexPNT{
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec2 texCoord;
+};
+
+struct ofVertexPNC{
+	glm::vec3 position;
+	glm::vec3 normal;
+	ofFloatColor color;
+};
+
+struct ofVertexPNCT{
+	glm::vec3 position;
+	glm::vec3 normal;
+	ofFloatColor color;
+	glm::vec2 texCoord;
+};
+
+/*! \cond PRIVATE */
+namespace of{
+namespace priv{
+	template<class Vertex, class = void>
+	struct VertexColor{
+		static int offset(){ return -1; }
+	};
+
+	template<class Vertex>
+	struct VertexColor<Vertex, decltype(void(&Vertex::color))>{
+		static_assert(sizeof(Vertex::color) == 4 * sizeof(float), "vertex color has to be 4 floats");
+		static int offset(){ return offsetof(Vertex, color); }
+	};
+
+	template<class Vertex, class = void>
+	struct VertexNormal{
+		static int offset(){ return -1; }
+	};
+
+	template<class Vertex>
+	struct VertexNormal<Vertex, decltype(void(&Vertex::normal))>{
+		static_assert(sizeof(Vertex::normal) == 3 * sizeof(float), "vertex normal has to be 3 floats");
+		static int offset(){ return offsetof(Vertex, normal); }
+	};
+
+	template<class Vertex, class = void>
+	struct VertexTexCoord{
+		static int offset(){ return -1; }
+	};
+
+	template<class Vertex>
+	struct VertexTexCoord<Vertex, decltype(void(&Vertex::texCoord))>{
+		static_assert(sizeof(Vertex::texCoord) == 2 * sizeof(float), "vertex texCoord has to be 2 floats");
+		static int offset(){ return offsetof(Vertex, texCoord); }
+	};
+}
+}
+/*! \endcond */
+
+/// \brief A mesh that stores every vertex with all its attributes next to
+/// each other, in a single array
+///
+/// The vertex layout is a struct chosen at compile time, like ofVertexPNT,
+/// so the whole mesh is uploaded to one buffer in a single call and the GPU
+/// reads every vertex from one place. Changes through setVertex() only
+/// upload the modified range on the next draw.
+///
+/// ~~~~{.cpp}
+/// ofInterleavedMesh_<ofVertexPN> mesh;
+/// mesh.reserve(numVertices);
+/// for(auto & p: points){
+///     mesh.addVertex({p, glm::vec3(0,0,1)});
+/// }
+/// mesh.draw();
+/// ~~~~
+template<class Vertex>
+class ofInterleavedMesh_{
+	static_assert(std::is_standard_layout<Vertex>::value, "the vertex type has to be a standard layout struct");
+	static_assert(sizeof(Vertex::position) == 3 * sizeof(float) || sizeof(Vertex::position) == 2 * sizeof(float), "vertex position has to be 2 or 3 floats");
+public:
+	ofInterleavedMesh_(ofPrimitiveMode mode = OF_PRIMITIVE_TRIANGLES, int usage = GL_STATIC_DRAW)
+	:mode(mode)
+	,usage(usage){}
+
+	/// \brief The layout of Vertex as ofVbo needs it
+	static ofVboInterleavedLayout getLayout(){
+		ofVboInterleavedLayout layout;
+		layout.stride = sizeof(Vertex);
+		layout.positionCoords = sizeof(Vertex::position) / sizeof(float);
+		layout.positionOffset = offsetof(Vertex, position);
+		layout.colorOffset = of::priv::VertexColor<Vertex>::offset();
+		layout.normalOffset = of::priv::VertexNormal<Vertex>::offset();
+		layout.texCoordOffset = of::priv::VertexTexCoord<Vertex>::offset();
+		return layout;
+	}
+
+	void setMode(ofPrimitiveMode mode){
+		this->mode = mode;
+	}
+
+	ofPrimitiveMode getMode() const{
+		return mode;
+	}
+
+	/// \brief GL usage hint for the buffers, GL_STATIC_DRAW by default
+	void setUsage(int usage){
+		this->usage = usage;
+		bVerticesAllocated = false;
+		bIndicesAllocated = false;
+	}
+
+	/// \brief Reserves memory for numVertices and numIndices, both in the
+	/// mesh and in the GPU buffers, so adding up to that many doesn't
+	/// reallocate them
+	void reserve(std::size_t numVertices, std::size_t numIndices = 0){
+		vertices.reserve(numVertices);
+		indices.reserve(numIndices);
+		if(vertices.capacity() > vboVertexCapacity){
+			bVerticesAllocated = false;
+		}
+		if(indices.capacity() > vboIndexCapacity){
+			bIndicesAllocated = false;
+		}
+	}
+
+	void addVertex(const Vertex & vertex){
+		vertices.push_back(vertex);
+		markVerticesChanged(vertices.size() - 1, vertices.size());
+	}
+
+	void addVertices(const Vertex * newVertices, std::size_t numVertices){
+		std::size_t first = vertices.size();
+		vertices.insert(vertices.end(), newVertices, newVertices + numVertices);
+		markVerticesChanged(first, vertices.size());
+	}
+
+	void addVertices(const std::vector<Vertex> & newVertices){
+		addVertices(newVertices.data(), newVertices.size());
+	}
+
+	void setVertex(std::size_t index, const Vertex & vertex){
+		vertices[index] = vertex;
+		markVerticesChanged(index, index + 1);
+	}
+
+	const Vertex & getVertex(std::size_t index) const{
+		return vertices[index];
+	}
+
+	/// \brief Gives access to all the vertices, they are all uploaded
+	/// again on the next draw
+	std::vector<Vertex> & getVertices(){
+		markVerticesChanged(0, vertices.size());
+		bVerticesAllocated = false;
+		return vertices;
+	}
+
+	const std::vector<Vertex> & getVertices() const{
+		return vertices;
+	}
+
+	std::size_t getNumVertices() const{
+		return vertices.size();
+	}
+
+	void addIndex(ofIndexType index){
+		indices.push_back(index);
+		bIndicesChanged = true;
+	}
+
+	void addIndices(const std::vector<ofIndexType> & newIndices){
+		indices.insert(indices.end(), newIndices.begin(), newIndices.end());
+		bIndicesChanged = true;
+	}
+
+	void addTriangle(ofIndexType index1, ofIndexType index2, ofIndexType index3){
+		indices.push_back(index1);
+		indices.push_back(index2);
+		indices.push_back(index3);
+		bIndicesChanged = true;
+	}
+
+	/// \brief Gives access to all the indices, they are all uploaded again
+	/// on the next draw
+	std::vector<ofIndexType> & getIndices(){
+		bIndicesChanged = true;
+		bIndicesAllocated = false;
+		return indices;
+	}
+
+	const std::vector<ofIndexType> & getIndices() const{
+		return indices;
+	}
+
+	std::size_t getNumIndices() const{
+		return indices.size();
+	}
+
+	void clearIndices(){
+		indices.clear();
+		bIndicesChanged = true;
+	}
+
+	void clear(){
+		vertices.clear();
+		indices.clear();
+		dirtyBegin = dirtyEnd = 0;
+		bIndicesChanged = true;
+	}
+
+	/// \brief The vbo the mesh is drawn with, updated on every draw
+	const ofVbo & getVbo() const{
+		updateVbo();
+		return vbo;
+	}
+
+	/// \brief Uploads any changes and draws the mesh with its mode
+	void draw() const{
+		if(vertices.empty()) return;
+		updateVbo();
+		GLuint glMode = ofGetGLPrimitiveMode(mode);
+		if(indices.empty()){
+			vbo.draw(glMode, 0, vertices.size());
+		}else{
+			vbo.drawElements(glMode, indices.size());
+		}
+	}
+
+	void drawInstanced(int primCount) const{
+		if(vertices.empty()) return;
+		updateVbo();
+		GLuint glMode = ofGetGLPrimitiveMode(mode);
+		if(indices.empty()){
+			vbo.drawInstanced(glMode, 0, vertices.size(), primCount);
+		}else{
+			vbo.drawElementsInstanced(glMode, indices.size(), primCount);
+		}
+	}
+
+private:
+	void markVerticesChanged(std::size_t begin, std::size_t end){
+		if(dirtyBegin == dirtyEnd){
+			dirtyBegin = begin;
+			dirtyEnd = end;
+		}else{
+			dirtyBegin = std::min(dirtyBegin, begin);
+			dirtyEnd = std::max(dirtyEnd, end);
+		}
+	}
+
+	void updateVbo() const{
+		if(!bVerticesAllocated || vertices.size() > vboVertexCapacity){
+			// a single glBufferData for all the attributes, with room for
+			// everything reserved
+			vbo.setInterleavedData(vertices.data(), vertices.size(), getLayout(), usage, vertices.capacity());
+			vboVertexCapacity = vbo.getInterleavedCapacity();
+			bVerticesAllocated = true;
+		}else if(dirtyBegin < dirtyEnd){
+			vbo.updateInterleavedData(vertices.data() + dirtyBegin, dirtyBegin, dirtyEnd - dirtyBegin);
+		}
+		dirtyBegin = dirtyEnd = 0;
+
+		if(bIndicesChanged){
+			if(indices.empty()){
+				vbo.disableIndices();
+			}else if(!bIndicesAllocated || indices.size() > vboIndexCapacity){
+				// allocate the reserved capacity and then fill it
+				std::size_t capacity = std::max(indices.size(), indices.capacity());
+				std::vector<ofIndexType> reserved(indices);
+				reserved.resize(capacity, 0);
+				vbo.setIndexData(reserved.data(), reserved.size(), usage);
+				vboIndexCapacity = capacity;
+				bIndicesAllocated = true;
+			}else{
+				vbo.enableIndices();
+				vbo.updateIndexData(indices.data(), indices.size());
+			}
+			bIndicesChanged = false;
+		}
+	}
+
+	std::vector<Vertex> vertices;
+	std::vector<ofIndexType> indices;
+	ofPrimitiveMode mode;
+	int usage;
+
+	mutable ofVbo vbo;
+	mutable std::size_t vboVertexCapacity = 0;
+	mutable std::size_t vboIndexCapacity = 0;
+	mutable std::size_t dirtyBegin = 0;
+	mutable std::size_t dirtyEnd = 0;
+	mutable bool bVerticesAllocated = false;
+	mutable bool bIndicesAllocated = false;
+	mutable bool bIndicesChanged = false;
+};
@@ -12,11 +12,14 @@
 #include "ofConstants.h"
 #include "ofLog.h"
 #include "ofUtils.h"
+#include "ofGLProgrammableRenderer.h"
+#include "ofLightClusters.h"
 #include <map>
 
 using namespace std;
 
 static ofFloatColor globalAmbient(0.2, 0.2, 0.2, 1.0);
+static bool clusteredLighting = false;
 
 //----------------------------------------
 void ofEnableLighting() {
@@ -58,6 +61,26 @@ const ofFloatColor & ofGetGlobalAmbientColor(){
 	return globalAmbient;
 }
 
+//----------------------------------------
+void ofEnableClusteredLighting(){
+	auto renderer = dynamic_pointer_cast<ofGLProgrammableRenderer>(ofGetGLRenderer());
+	if(!renderer || !ofLightClusters::isSupported(*renderer)){
+		ofLogWarning("ofLight") << "ofEnableClusteredLighting(): clustered lighting needs the programmable renderer"
+			<< " and OpenGL 3.1 or later, materials will keep using the lights uniforms";
+	}
+	clusteredLighting = true;
+}
+
+//----------------------------------------
+void ofDisableClusteredLighting(){
+	clusteredLighting = false;
+}
+
+//----------------------------------------
+bool ofGetClusteredLightingEnabled(){
+	return clusteredLighting;
+}
+
 //----------------------------------------
 vector<weak_ptr<ofLight::Data> > & ofLightsData(){
 	static vector<weak_ptr<ofLight::Data> > * lightsActive = ofIsGLProgrammableRenderer()?new vector<weak_ptr<ofLight::Data> >:new vector<weak_ptr<ofLight::Data> >(8);
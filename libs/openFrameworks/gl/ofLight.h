@@ -33,6 +33,18 @@ void ofSetSmoothLighting(bool b);
 void ofSetGlobalAmbientColor(const ofFloatColor& c);
 const ofFloatColor & ofGetGlobalAmbientColor();
 
+/// \brief Makes ofMaterial assign the lights to clusters of the view
+/// frustum so each fragment only evaluates the lights that reach it
+///
+/// Useful with many point or spot lights with linear or quadratic
+/// attenuation, every fragment still evaluates the directional and
+/// area lights and the lights without attenuation. Only with the
+/// programmable renderer and OpenGL 3.1 or later on desktop, the
+/// materials keep using the array of lights uniforms otherwise.
+void ofEnableClusteredLighting();
+void ofDisableClusteredLighting();
+bool ofGetClusteredLightingEnabled();
+
 //----------------------------------------
 // Use the public API of ofNode for all transformations
 class ofLight : public ofNode {
@@ -0,0 +1,229 @@
+#include "ofLightClusters.h"
+#include "ofLight.h"
+#include "ofShader.h"
+#include "ofGLProgrammableRenderer.h"
+#include "ofAppRunner.h"
+#include "ofMath.h"
+
+using namespace std;
+
+const int ofLightClusters::tilesX;
+const int ofLightClusters::tilesY;
+const int ofLightClusters::slices;
+const int ofLightClusters::texelsPerLight;
+const int ofLightClusters::lightsTextureLocation;
+const int ofLightClusters::clustersTextureLocation;
+const int ofLightClusters::indicesTextureLocation;
+
+namespace{
+	// distance at which the light's attenuation makes its brightest color
+	// channel drop below 1/256, or infinity if it never does
+	float lightRange(const ofLight::Data & light){
+		float intensity = 0;
+		for(auto & color: {light.ambientColor, light.diffuseColor, light.specularColor}){
+			intensity = max(intensity, max(color.r, max(color.g, color.b)));
+		}
+		float c = light.attenuation_constant - intensity * 256.f;
+		float l = light.attenuation_linear;
+		float q = light.attenuation_quadratic;
+		if(c >= 0){
+			return 0;
+		}
+		if(q > 0){
+			return (-l + sqrt(l * l - 4 * q * c)) / (2 * q);
+		}else if(l > 0){
+			return -c / l;
+		}else{
+			return numeric_limits<float>::infinity();
+		}
+	}
+
+	glm::vec3 eyeDirection(const glm::mat4 & view, const glm::vec3 & from, const glm::vec3 & direction, const glm::vec3 & eyeFrom){
+		auto to = view * glm::vec4(from + direction, 1.0);
+		return glm::normalize(to.xyz() / to.w - eyeFrom);
+	}
+}
+
+//----------------------------------------------------------
+bool ofLightClusters::isSupported(ofGLProgrammableRenderer & renderer){
+#ifdef TARGET_OPENGLES
+	return false;
+#else
+	return renderer.getGLVersionMajor() > 3 || (renderer.getGLVersionMajor() == 3 && renderer.getGLVersionMinor() >= 1);
+#endif
+}
+
+//----------------------------------------------------------
+void ofLightClusters::allocate(){
+#ifndef TARGET_OPENGLES
+	lightsBuffer.allocate();
+	lightsBuffer.setData(sizeof(glm::vec4) * texelsPerLight, nullptr, GL_STREAM_DRAW);
+	lightsTexture.allocateAsBufferTexture(lightsBuffer, GL_RGBA32F);
+	clustersBuffer.allocate();
+	clustersBuffer.setData(sizeof(glm::uvec2) * tilesX * tilesY * slices, nullptr, GL_STREAM_DRAW);
+	clustersTexture.allocateAsBufferTexture(clustersBuffer, GL_RG32UI);
+	indicesBuffer.allocate();
+	indicesBuffer.setData(sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+	indicesTexture.allocateAsBufferTexture(indicesBuffer, GL_R32UI);
+	clusterLights.resize(tilesX * tilesY * slices);
+	clusters.resize(tilesX * tilesY * slices);
+#endif
+}
+
+//----------------------------------------------------------
+void ofLightClusters::update(ofGLProgrammableRenderer & renderer){
+	auto view = renderer.getCurrentViewMatrix();
+	auto projection = renderer.getCurrentMatrix(OF_MATRIX_PROJECTION);
+	auto currentViewport = renderer.getNativeViewport();
+	auto frame = ofGetFrameNum();
+	if(frame == lastFrame && view == lastView && projection == lastProjection && currentViewport == viewport){
+		return;
+	}
+	lastFrame = frame;
+	lastView = view;
+	lastProjection = projection;
+	viewport = currentViewport;
+
+	if(!lightsBuffer.isAllocated()){
+		allocate();
+	}
+
+	// near and far from the projection, slices are exponential in depth
+	// for perspectives and linear for orthographic projections
+	linearDepth = projection[2][3] == 0;
+	if(linearDepth){
+		zNear = (projection[3][2] + 1) / projection[2][2];
+		zFar = (projection[3][2] - 1) / projection[2][2];
+	}else{
+		zNear = projection[3][2] / (projection[2][2] - 1);
+		zFar = projection[3][2] / (projection[2][2] + 1);
+	}
+	zNear = max(zNear, 0.0001f);
+	zFar = max(zFar, zNear * 1.001f);
+	auto slice = [&](float depth){
+		float s = linearDepth ?
+			(depth - zNear) / (zFar - zNear) :
+			log(depth / zNear) / log(zFar / zNear);
+		return ofClamp(int(floor(s * slices)), 0, slices - 1);
+	};
+
+	lights.clear();
+	indices.clear();
+	for(auto & cluster: clusterLights){
+		cluster.clear();
+	}
+
+	for(auto & weakLight: ofLightsData()){
+		auto light = weakLight.lock();
+		if(!light || !light->isEnabled){
+			continue;
+		}
+		auto index = uint32_t(lights.size() / texelsPerLight);
+		auto position = view * light->position;
+		glm::vec3 spotDirection, halfVector, right, up;
+		if(light->lightType == OF_LIGHT_SPOT || light->lightType == OF_LIGHT_AREA){
+			spotDirection = eyeDirection(view, light->position.xyz(), light->direction, position.xyz());
+		}
+		if(light->lightType == OF_LIGHT_DIRECTIONAL){
+			halfVector = glm::normalize(glm::vec4(0.f, 0.f, 1.f, 0.f) + position).xyz();
+		}
+		if(light->lightType == OF_LIGHT_AREA){
+			right = eyeDirection(view, light->position.xyz(), light->right, position.xyz());
+			up = glm::normalize(glm::cross(right, spotDirection));
+		}
+		lights.push_back(position);
+		lights.push_back(glm::vec4(light->ambientColor.r, light->ambientColor.g, light->ambientColor.b, light->ambientColor.a));
+		lights.push_back(glm::vec4(light->diffuseColor.r, light->diffuseColor.g, light->diffuseColor.b, light->diffuseColor.a));
+		lights.push_back(glm::vec4(light->specularColor.r, light->specularColor.g, light->specularColor.b, light->specularColor.a));
+		lights.push_back(glm::vec4(light->attenuation_constant, light->attenuation_linear, light->attenuation_quadratic, float(light->lightType)));
+		lights.push_back(glm::vec4(spotDirection, light->exponent));
+		lights.push_back(glm::vec4(halfVector, cos(ofDegToRad(light->spotCutOff))));
+		lights.push_back(glm::vec4(right, light->width));
+		lights.push_back(glm::vec4(up, light->height));
+
+		float range = lightRange(*light);
+		if(light->lightType == OF_LIGHT_DIRECTIONAL || light->lightType == OF_LIGHT_AREA || std::isinf(range)){
+			// global lights go first in the indices, every fragment loops
+			// over them
+			indices.push_back(index);
+			continue;
+		}
+		if(range <= 0){
+			continue;
+		}
+
+		// depth range of the light's sphere, in front of the camera
+		auto center = position.xyz() / position.w;
+		float minDepth = -center.z - range;
+		float maxDepth = -center.z + range;
+		if(maxDepth < zNear || minDepth > zFar){
+			continue;
+		}
+		int minSlice = slice(max(minDepth, zNear));
+		int maxSlice = slice(min(maxDepth, zFar));
+
+		// screen bounds of the sphere's bounding box, the whole screen if
+		// it crosses the near plane
+		glm::vec2 minNdc(-1), maxNdc(1);
+		if(minDepth > zNear){
+			minNdc = glm::vec2(1);
+			maxNdc = glm::vec2(-1);
+			for(int corner = 0; corner < 8; corner++){
+				glm::vec3 offset(corner & 1 ? range : -range, corner & 2 ? range : -range, corner & 4 ? range : -range);
+				auto clip = projection * glm::vec4(center + offset, 1.0);
+				auto ndc = glm::vec2(clip.x, clip.y) / clip.w;
+				minNdc = glm::min(minNdc, ndc);
+				maxNdc = glm::max(maxNdc, ndc);
+			}
+			if(maxNdc.x < -1 || maxNdc.y < -1 || minNdc.x > 1 || minNdc.y > 1){
+				continue;
+			}
+		}
+		int minX = ofClamp(int(floor((minNdc.x * 0.5f + 0.5f) * tilesX)), 0, tilesX - 1);
+		int maxX = ofClamp(int(floor((maxNdc.x * 0.5f + 0.5f) * tilesX)), 0, tilesX - 1);
+		int minY = ofClamp(int(floor((minNdc.y * 0.5f + 0.5f) * tilesY)), 0, tilesY - 1);
+		int maxY = ofClamp(int(floor((maxNdc.y * 0.5f + 0.5f) * tilesY)), 0, tilesY - 1);
+		for(int z = minSlice; z <= maxSlice; z++){
+			for(int y = minY; y <= maxY; y++){
+				for(int x = minX; x <= maxX; x++){
+					clusterLights[(z * tilesY + y) * tilesX + x].push_back(index);
+				}
+			}
+		}
+	}
+	numLights = lights.size() / texelsPerLight;
+	numGlobalLights = indices.size();
+
+	for(size_t i = 0; i < clusterLights.size(); i++){
+		clusters[i] = glm::uvec2(indices.size(), clusterLights[i].size());
+		indices.insert(indices.end(), clusterLights[i].begin(), clusterLights[i].end());
+	}
+
+	// the buffer textures keep pointing to the buffers when they are
+	// reallocated with a different size
+	if(!lights.empty()){
+		lightsBuffer.setData(lights, GL_STREAM_DRAW);
+	}
+	clustersBuffer.updateData(0, sizeof(glm::uvec2) * clusters.size(), clusters.data());
+	if(!indices.empty()){
+		indicesBuffer.setData(indices, GL_STREAM_DRAW);
+	}
+}
+
+//----------------------------------------------------------
+void ofLightClusters::bind(const ofShader & shader) const{
+#ifndef TARGET_OPENGLES
+	shader.setUniformTexture("lightsBuffer", lightsTexture, lightsTextureLocation);
+	shader.setUniformTexture("lightClusters", clustersTexture, clustersTextureLocation);
+	shader.setUniformTexture("lightIndices", indicesTexture, indicesTextureLocation);
+	shader.setUniform4f("clusterViewport", viewport.x, viewport.y, viewport.width, viewport.height);
+	shader.setUniform3f("clusterGrid", tilesX, tilesY, slices);
+	shader.setUniform3f("clusterDepth", zNear, zFar, linearDepth ? 1 : 0);
+	shader.setUniform1i("numGlobalLights", numGlobalLights);
+#endif
+}
+
+//----------------------------------------------------------
+size_t ofLightClusters::getNumLights() const{
+	return numLights;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofBufferObject.h"
+#include "ofTexture.h"
+#include "ofRectangle.h"
+#include <limits>
+#include <vector>
+
+class ofShader;
+class ofGLProgrammableRenderer;
+
+/// \brief Light data and light to cluster assignment for the clustered
+/// forward lighting mode of ofMaterial.
+///
+/// The view frustum is divided in a grid of tiles on screen and
+/// exponential slices in depth. Once per frame and camera the active
+/// ofLights are packed into a buffer texture and each point and spot light
+/// is assigned to the clusters its range touches, so every fragment only
+/// evaluates the lights of its cluster. Directional and area lights, and
+/// lights with no attenuation, affect every fragment.
+///
+/// The range of a light is the distance at which its attenuation drops
+/// its color below 1/256, lights only stay local with linear or
+/// quadratic attenuation.
+///
+/// Used internally by ofMaterial, enable it with
+/// ofEnableClusteredLighting(). Needs buffer textures, so it's only
+/// available with OpenGL 3.1 or later on desktop.
+class ofLightClusters{
+public:
+	static const int tilesX = 16;
+	static const int tilesY = 9;
+	static const int slices = 24;
+	/// texels of the lights buffer used by each light
+	static const int texelsPerLight = 9;
+	/// texture units the buffers are bound to
+	static const int lightsTextureLocation = 13;
+	static const int clustersTextureLocation = 14;
+	static const int indicesTextureLocation = 15;
+
+	static bool isSupported(ofGLProgrammableRenderer & renderer);
+
+	/// \brief Rebuild the clusters if the frame, the camera or the
+	/// viewport changed since the last update
+	void update(ofGLProgrammableRenderer & renderer);
+
+	/// \brief Bind the buffers and set the uniforms of a clustered shader
+	void bind(const ofShader & shader) const;
+
+	/// \brief Number of lights packed in the last update
+	std::size_t getNumLights() const;
+
+private:
+	void allocate();
+
+	ofBufferObject lightsBuffer;
+	ofBufferObject clustersBuffer;
+	ofBufferObject indicesBuffer;
+	ofTexture lightsTexture;
+	ofTexture clustersTexture;
+	ofTexture indicesTexture;
+
+	std::vector<glm::vec4> lights;
+	std::vector<glm::uvec2> clusters;
+	std::vector<uint32_t> indices;
+	std::vector<std::vector<uint32_t>> clusterLights;
+	std::size_t numLights = 0;
+	std::size_t numGlobalLights = 0;
+
+	uint64_t lastFrame = std::numeric_limits<uint64_t>::max();
+	glm::mat4 lastView;
+	glm::mat4 lastProjection;
+	ofRectangle viewport;
+	float zNear = 1;
+	float zFar = 1000;
+	bool linearDepth = false;
+};
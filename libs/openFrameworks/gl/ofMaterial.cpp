@@ -4,14 +4,65 @@
 #include "ofLight.h"
 #include "ofGLProgrammableRenderer.h"
 #include "ofAppRunner.h"
+#include "ofLightClusters.h"
 
 using namespace std;
 
 std::map<ofGLProgrammableRenderer*, std::map<std::string, std::weak_ptr<ofMaterial::Shaders>>> ofMaterial::shadersMap;
+std::map<ofGLProgrammableRenderer*, std::weak_ptr<ofLightClusters>> ofMaterial::lightClustersMap;
 
 namespace{
-string vertexSource(string defaultHeader, int maxLights, bool hasTexture, bool hasColor);
-string fragmentSource(string defaultHeader, string customUniforms, string postFragment, int maxLights, bool hasTexture, bool hasColor);
+string vertexSource(string defaultHeader, string preVertex, int maxLights, bool hasTexture, bool hasColor, bool clustered);
+string fragmentSource(string defaultHeader, string customUniforms, string postFragment, int maxLights, bool hasTexture, bool hasColor, bool clustered, bool materialBlock);
+const string MATERIAL_BLOCK="ofMaterialBlock";
+uint64_t nextCustomUniformsVersion = 0;
+
+bool materialBlockSupported(ofGLProgrammableRenderer & renderer){
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_uniform_buffer_object)
+	return GLEW_ARB_uniform_buffer_object &&
+		(renderer.getGLVersionMajor() > 3 || (renderer.getGLVersionMajor() == 3 && renderer.getGLVersionMinor() >= 1));
+#else
+	return false;
+#endif
+}
+
+// names of the uniforms of each light in the lights array, built once so
+// setting the lights doesn't create strings every time a material is used
+struct LightUniforms{
+	LightUniforms(size_t i){
+		auto light = "lights[" + ofToString(i) + "].";
+		enabled = light + "enabled";
+		type = light + "type";
+		position = light + "position";
+		ambient = light + "ambient";
+		specular = light + "specular";
+		diffuse = light + "diffuse";
+		constantAttenuation = light + "constantAttenuation";
+		linearAttenuation = light + "linearAttenuation";
+		quadraticAttenuation = light + "quadraticAttenuation";
+		spotDirection = light + "spotDirection";
+		spotExponent = light + "spotExponent";
+		spotCutoff = light + "spotCutoff";
+		spotCosCutoff = light + "spotCosCutoff";
+		halfVector = light + "halfVector";
+		width = light + "width";
+		height = light + "height";
+		right = light + "right";
+		up = light + "up";
+	}
+	string enabled, type, position, ambient, specular, diffuse;
+	string constantAttenuation, linearAttenuation, quadraticAttenuation;
+	string spotDirection, spotExponent, spotCutoff, spotCosCutoff;
+	string halfVector, width, height, right, up;
+};
+
+const LightUniforms & lightUniforms(size_t i){
+	static vector<LightUniforms> uniforms;
+	while(uniforms.size() <= i){
+		uniforms.emplace_back(uniforms.size());
+	}
+	return uniforms[i];
+}
 }
 
 
@@ -27,7 +78,8 @@ void ofMaterial::setColors(ofFloatColor oDiffuse, ofFloatColor oAmbient, ofFloat
 
 
 void ofMaterial::setup(const ofMaterial::Settings & settings){
-	if(settings.customUniforms != data.customUniforms || settings.postFragment != data.postFragment){
+	if(settings.customUniforms != data.customUniforms || settings.postFragment != data.postFragment
+		|| settings.preVertex != data.preVertex || settings.customAttributes != data.customAttributes){
 		shaders.clear();
 		uniforms1f.clear();
 		uniforms2f.clear();
@@ -37,6 +89,7 @@ void ofMaterial::setup(const ofMaterial::Settings & settings){
 		uniforms2i.clear();
 		uniforms3i.clear();
 		uniforms4i.clear();
+		customUniformsVersion = ++nextCustomUniformsVersion;
 	}
 	data = settings;
 }
@@ -101,13 +154,27 @@ void ofMaterial::end() const{
 	}
 }
 
+string ofMaterial::getShadersKey() const{
+    // materials with the same shader sources can share the shaders
+    string key = data.postFragment + '\0' + data.preVertex;
+    for(auto & attribute: data.customAttributes){
+        key += '\0' + attribute.first + ofToString(attribute.second);
+    }
+    return key;
+}
+
 void ofMaterial::initShaders(ofGLProgrammableRenderer & renderer) const{
+    auto key = getShadersKey();
+    // clustered shaders read the lights from buffers so they don't depend
+    // on the number of lights
+    auto clustered = ofGetClusteredLightingEnabled() && ofLightClusters::isSupported(renderer);
+    auto numLights = clustered ? 0 : ofLightsData().size();
     auto rendererShaders = shaders.find(&renderer);
-    if(rendererShaders == shaders.end() || rendererShaders->second->numLights != ofLightsData().size()){
-        if(shadersMap[&renderer].find(data.postFragment)!=shadersMap[&renderer].end()){
-            auto newShaders = shadersMap[&renderer][data.postFragment].lock();
-            if(newShaders == nullptr || newShaders->numLights != ofLightsData().size()){
-                shadersMap[&renderer].erase(data.postFragment);
+    if(rendererShaders == shaders.end() || rendererShaders->second->numLights != numLights || rendererShaders->second->clustered != clustered){
+        if(shadersMap[&renderer].find(key)!=shadersMap[&renderer].end()){
+            auto newShaders = shadersMap[&renderer][key].lock();
+            if(newShaders == nullptr || newShaders->numLights != numLights || newShaders->clustered != clustered){
+                shadersMap[&renderer].erase(key);
                 shaders[&renderer] = nullptr;
             }else{
                 shaders[&renderer] = newShaders;
@@ -122,45 +189,65 @@ void ofMaterial::initShaders(ofGLProgrammableRenderer & renderer) const{
         #endif
         string vertex2DHeader = renderer.defaultVertexShaderHeader(GL_TEXTURE_2D);
         string fragment2DHeader = renderer.defaultFragmentShaderHeader(GL_TEXTURE_2D);
-        auto numLights = ofLightsData().size();
+        auto bindAttributes = [this](ofShader & shader){
+            for(auto & attribute: data.customAttributes){
+                shader.bindAttribute(attribute.second, attribute.first);
+            }
+        };
         shaders[&renderer].reset(new Shaders);
         shaders[&renderer]->numLights = numLights;
-        shaders[&renderer]->noTexture.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,numLights,false,false));
-        shaders[&renderer]->noTexture.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,false,false));
+        shaders[&renderer]->clustered = clustered;
+        auto materialBlock = materialBlockSupported(renderer);
+        if(clustered){
+            // all the materials of a renderer share the light clusters
+            shaders[&renderer]->lightClusters = lightClustersMap[&renderer].lock();
+            if(!shaders[&renderer]->lightClusters){
+                shaders[&renderer]->lightClusters = std::make_shared<ofLightClusters>();
+                lightClustersMap[&renderer] = shaders[&renderer]->lightClusters;
+            }
+        }
+        shaders[&renderer]->noTexture.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,data.preVertex,numLights,false,false,clustered));
+        shaders[&renderer]->noTexture.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,false,false,clustered,materialBlock));
         shaders[&renderer]->noTexture.bindDefaults();
+        bindAttributes(shaders[&renderer]->noTexture);
         shaders[&renderer]->noTexture.linkProgram();
 
-        shaders[&renderer]->texture2D.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,numLights,true,false));
-        shaders[&renderer]->texture2D.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,true,false));
+        shaders[&renderer]->texture2D.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,data.preVertex,numLights,true,false,clustered));
+        shaders[&renderer]->texture2D.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,true,false,clustered,materialBlock));
         shaders[&renderer]->texture2D.bindDefaults();
+        bindAttributes(shaders[&renderer]->texture2D);
         shaders[&renderer]->texture2D.linkProgram();
 
         #ifndef TARGET_OPENGLES
-            shaders[&renderer]->textureRect.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertexRectHeader,numLights,true,false));
-            shaders[&renderer]->textureRect.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragmentRectHeader, data.customUniforms, data.postFragment,numLights,true,false));
+            shaders[&renderer]->textureRect.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertexRectHeader,data.preVertex,numLights,true,false,clustered));
+            shaders[&renderer]->textureRect.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragmentRectHeader, data.customUniforms, data.postFragment,numLights,true,false,clustered,materialBlock));
             shaders[&renderer]->textureRect.bindDefaults();
+            bindAttributes(shaders[&renderer]->textureRect);
             shaders[&renderer]->textureRect.linkProgram();
         #endif
 
-        shaders[&renderer]->color.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,numLights,false,true));
-        shaders[&renderer]->color.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,false,true));
+        shaders[&renderer]->color.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,data.preVertex,numLights,false,true,clustered));
+        shaders[&renderer]->color.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,false,true,clustered,materialBlock));
         shaders[&renderer]->color.bindDefaults();
+        bindAttributes(shaders[&renderer]->color);
         shaders[&renderer]->color.linkProgram();
 
 
-        shaders[&renderer]->texture2DColor.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,numLights,true,true));
-        shaders[&renderer]->texture2DColor.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,true,true));
+        shaders[&renderer]->texture2DColor.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertex2DHeader,data.preVertex,numLights,true,true,clustered));
+        shaders[&renderer]->texture2DColor.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragment2DHeader, data.customUniforms, data.postFragment,numLights,true,true,clustered,materialBlock));
         shaders[&renderer]->texture2DColor.bindDefaults();
+        bindAttributes(shaders[&renderer]->texture2DColor);
         shaders[&renderer]->texture2DColor.linkProgram();
 
         #ifndef TARGET_OPENGLES
-            shaders[&renderer]->textureRectColor.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertexRectHeader,numLights,true,true));
-            shaders[&renderer]->textureRectColor.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragmentRectHeader, data.customUniforms, data.postFragment,numLights,true,true));
+            shaders[&renderer]->textureRectColor.setupShaderFromSource(GL_VERTEX_SHADER,vertexSource(vertexRectHeader,data.preVertex,numLights,true,true,clustered));
+            shaders[&renderer]->textureRectColor.setupShaderFromSource(GL_FRAGMENT_SHADER,fragmentSource(fragmentRectHeader, data.customUniforms, data.postFragment,numLights,true,true,clustered,materialBlock));
             shaders[&renderer]->textureRectColor.bindDefaults();
+            bindAttributes(shaders[&renderer]->textureRectColor);
             shaders[&renderer]->textureRectColor.linkProgram();
         #endif
 
-        shadersMap[&renderer][data.postFragment] = shaders[&renderer];
+        shadersMap[&renderer][key] = shaders[&renderer];
     }
 
 }
@@ -193,12 +280,64 @@ const ofShader & ofMaterial::getShader(int textureTarget, bool geometryHasColor,
 }
 
 void ofMaterial::updateMaterial(const ofShader & shader,ofGLProgrammableRenderer & renderer) const{
-	shader.setUniform4fv("mat_ambient", &data.ambient.r);
-	shader.setUniform4fv("mat_diffuse", &data.diffuse.r);
-	shader.setUniform4fv("mat_specular", &data.specular.r);
-	shader.setUniform4fv("mat_emissive", &data.emissive.r);
-	shader.setUniform4fv("global_ambient", &ofGetGlobalAmbientColor().r);
-	shader.setUniform1f("mat_shininess",data.shininess);
+	if(!uploadMaterialBlock(shader)){
+		shader.setUniform4fv("mat_ambient", &data.ambient.r);
+		shader.setUniform4fv("mat_diffuse", &data.diffuse.r);
+		shader.setUniform4fv("mat_specular", &data.specular.r);
+		shader.setUniform4fv("mat_emissive", &data.emissive.r);
+		shader.setUniform4fv("global_ambient", &ofGetGlobalAmbientColor().r);
+		shader.setUniform1f("mat_shininess",data.shininess);
+	}
+
+	// uniforms keep their values in each shader, so the custom ones only
+	// need setting if they changed or another material used the shader
+	// since this one set them
+	auto rendererShaders = shaders.find(&renderer);
+	if(rendererShaders != shaders.end() && rendererShaders->second){
+		auto & version = rendererShaders->second->customUniformsVersions[&shader];
+		if(version != customUniformsVersion){
+			setCustomUniforms(shader);
+			version = customUniformsVersion;
+		}
+	}else{
+		setCustomUniforms(shader);
+	}
+	for (auto & uniform : uniformstex) {
+		shader.setUniformTexture(uniform.first,
+								 uniform.second.textureTarget,
+								 uniform.second.textureID,
+								 uniform.second.textureLocation);
+	}
+}
+
+bool ofMaterial::uploadMaterialBlock(const ofShader & shader) const{
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_uniform_buffer_object)
+	if(!GLEW_ARB_uniform_buffer_object || shader.getUniformBlockIndex(MATERIAL_BLOCK) == -1){
+		return false;
+	}
+	MaterialBlock block;
+	block.ambient = glm::vec4(data.ambient.r, data.ambient.g, data.ambient.b, data.ambient.a);
+	block.diffuse = glm::vec4(data.diffuse.r, data.diffuse.g, data.diffuse.b, data.diffuse.a);
+	block.specular = glm::vec4(data.specular.r, data.specular.g, data.specular.b, data.specular.a);
+	block.emissive = glm::vec4(data.emissive.r, data.emissive.g, data.emissive.b, data.emissive.a);
+	auto & globalAmbient = ofGetGlobalAmbientColor();
+	block.globalAmbient = glm::vec4(globalAmbient.r, globalAmbient.g, globalAmbient.b, globalAmbient.a);
+	block.shininess = data.shininess;
+	block.padding[0] = block.padding[1] = block.padding[2] = 0;
+	if(!materialBuffer.buffer.isAllocated()){
+		materialBuffer.buffer.allocate(sizeof(block), &block, GL_DYNAMIC_DRAW);
+	}else if(memcmp(&block, &materialBuffer.block, sizeof(block)) != 0){
+		materialBuffer.buffer.updateData(0, sizeof(block), &block);
+	}
+	materialBuffer.block = block;
+	materialBuffer.buffer.bindBase(GL_UNIFORM_BUFFER, ofShader::MATERIAL_BLOCK_BINDING);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void ofMaterial::setCustomUniforms(const ofShader & shader) const{
 	for(auto & uniform: uniforms1f){
 		shader.setUniform1f(uniform.first, uniform.second);
 	}
@@ -229,34 +368,34 @@ void ofMaterial::updateMaterial(const ofShader & shader,ofGLProgrammableRenderer
 	for (auto & uniform : uniforms3m) {
 		shader.setUniformMatrix3f(uniform.first, uniform.second);
 	}
-	for (auto & uniform : uniformstex) {
-		shader.setUniformTexture(uniform.first,
-								 uniform.second.textureTarget,
-								 uniform.second.textureID,
-								 uniform.second.textureLocation);
-	}
 }
 
 void ofMaterial::updateLights(const ofShader & shader,ofGLProgrammableRenderer & renderer) const{
+	auto rendererShaders = shaders.find(&renderer);
+	if(rendererShaders != shaders.end() && rendererShaders->second && rendererShaders->second->clustered){
+		rendererShaders->second->lightClusters->update(renderer);
+		rendererShaders->second->lightClusters->bind(shader);
+		return;
+	}
 	for(size_t i=0;i<ofLightsData().size();i++){
-		string idx = ofToString(i);
+		auto & uniforms = lightUniforms(i);
 		shared_ptr<ofLight::Data> light = ofLightsData()[i].lock();
 		if(!light || !light->isEnabled){
-			shader.setUniform1f("lights["+idx+"].enabled",0);
+			shader.setUniform1f(uniforms.enabled,0);
 			continue;
 		}
 		auto lightEyePosition = renderer.getCurrentViewMatrix() * light->position;
-		shader.setUniform1f("lights["+idx+"].enabled",1);
-		shader.setUniform1f("lights["+idx+"].type", light->lightType);
-		shader.setUniform4f("lights["+idx+"].position", lightEyePosition);
-		shader.setUniform4f("lights["+idx+"].ambient", light->ambientColor);
-		shader.setUniform4f("lights["+idx+"].specular", light->specularColor);
-		shader.setUniform4f("lights["+idx+"].diffuse", light->diffuseColor);
+		shader.setUniform1f(uniforms.enabled,1);
+		shader.setUniform1f(uniforms.type, light->lightType);
+		shader.setUniform4f(uniforms.position, lightEyePosition);
+		shader.setUniform4f(uniforms.ambient, light->ambientColor);
+		shader.setUniform4f(uniforms.specular, light->specularColor);
+		shader.setUniform4f(uniforms.diffuse, light->diffuseColor);
 
 		if(light->lightType!=OF_LIGHT_DIRECTIONAL){
-			shader.setUniform1f("lights["+idx+"].constantAttenuation", light->attenuation_constant);
-			shader.setUniform1f("lights["+idx+"].linearAttenuation", light->attenuation_linear);
-			shader.setUniform1f("lights["+idx+"].quadraticAttenuation", light->attenuation_quadratic);
+			shader.setUniform1f(uniforms.constantAttenuation, light->attenuation_constant);
+			shader.setUniform1f(uniforms.linearAttenuation, light->attenuation_linear);
+			shader.setUniform1f(uniforms.quadraticAttenuation, light->attenuation_quadratic);
 		}
 
 		if(light->lightType==OF_LIGHT_SPOT){
@@ -264,70 +403,80 @@ void ofMaterial::updateLights(const ofShader & shader,ofGLProgrammableRenderer &
 			auto direction4 = renderer.getCurrentViewMatrix() * glm::vec4(direction,1.0);
 			direction = direction4.xyz() / direction4.w;
 			direction = direction - lightEyePosition.xyz();
-			shader.setUniform3f("lights["+idx+"].spotDirection", glm::normalize(direction));
-			shader.setUniform1f("lights["+idx+"].spotExponent", light->exponent);
-			shader.setUniform1f("lights["+idx+"].spotCutoff", light->spotCutOff);
-			shader.setUniform1f("lights["+idx+"].spotCosCutoff", cos(ofDegToRad(light->spotCutOff)));
+			shader.setUniform3f(uniforms.spotDirection, glm::normalize(direction));
+			shader.setUniform1f(uniforms.spotExponent, light->exponent);
+			shader.setUniform1f(uniforms.spotCutoff, light->spotCutOff);
+			shader.setUniform1f(uniforms.spotCosCutoff, cos(ofDegToRad(light->spotCutOff)));
 		}else if(light->lightType==OF_LIGHT_DIRECTIONAL){
 			auto halfVector = glm::normalize(glm::vec4(0.f, 0.f, 1.f, 0.f) + lightEyePosition);
-			shader.setUniform3f("lights["+idx+"].halfVector", halfVector.xyz());
+			shader.setUniform3f(uniforms.halfVector, halfVector.xyz());
 		}else if(light->lightType==OF_LIGHT_AREA){
-			shader.setUniform1f("lights["+idx+"].width", light->width);
-			shader.setUniform1f("lights["+idx+"].height", light->height);
+			shader.setUniform1f(uniforms.width, light->width);
+			shader.setUniform1f(uniforms.height, light->height);
 			auto direction = light->position.xyz() + light->direction;
 			auto direction4 = renderer.getCurrentViewMatrix() * glm::vec4(direction, 1.0);
 			direction = direction4.xyz() / direction4.w;
 			direction = direction - lightEyePosition.xyz();
-			shader.setUniform3f("lights["+idx+"].spotDirection", glm::normalize(direction));
+			shader.setUniform3f(uniforms.spotDirection, glm::normalize(direction));
 			auto right = toGlm(light->position).xyz() + light->right;
 			auto right4 = renderer.getCurrentViewMatrix() * glm::vec4(right, 1.0);
 			right = right4.xyz() / right4.w;
 			right = right - lightEyePosition.xyz();
 			auto up = glm::cross(toGlm(right), direction);
-			shader.setUniform3f("lights["+idx+"].right", glm::normalize(toGlm(right)));
-			shader.setUniform3f("lights["+idx+"].up", glm::normalize(up));
+			shader.setUniform3f(uniforms.right, glm::normalize(toGlm(right)));
+			shader.setUniform3f(uniforms.up, glm::normalize(up));
 		}
 	}
 }
 
 void ofMaterial::setCustomUniform1f(const std::string & name, float value){
 	uniforms1f[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniform2f(const std::string & name, glm::vec2 value){
 	uniforms2f[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniform3f(const std::string & name, glm::vec3 value) {
 	uniforms3f[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniform4f(const std::string & name, glm::vec4 value) {
 	uniforms4f[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniform1i(const std::string & name, int value) {
 	uniforms1i[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniform2i(const std::string & name, glm::tvec2<int> value) {
 	uniforms2i[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniform3i(const std::string & name, glm::tvec3<int> value) {
 	uniforms3i[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniform4i(const std::string & name, glm::tvec4<int> value) {
 	uniforms4i[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniformMatrix4f(const std::string & name, glm::mat4 value){
 	uniforms4m[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniformMatrix3f(const std::string & name, glm::mat3 value){
 	uniforms3m[name] = value;
+	customUniformsVersion = ++nextCustomUniformsVersion;
 }
 
 void ofMaterial::setCustomUniformTexture(const std::string & name, const ofTexture & value, int textureLocation){
@@ -342,8 +491,13 @@ void ofMaterial::setCustomUniformTexture(const string & name, int textureTarget,
 #include "shaders/phong.frag"
 
 namespace{
-    string shaderHeader(string header, int maxLights, bool hasTexture, bool hasColor){
+    string shaderHeader(string header, int maxLights, bool hasTexture, bool hasColor, bool clustered){
         header += "#define MAX_LIGHTS " + ofToString(max(1,maxLights)) + "\n";
+        if(clustered){
+            header += "#define CLUSTERED_LIGHTING 1\n";
+        } else {
+            header += "#define CLUSTERED_LIGHTING 0\n";
+        }
         if(hasTexture){
             header += "#define HAS_TEXTURE 1\n";
 		} else {
@@ -357,11 +511,16 @@ namespace{
         return header;
     }
 
-    string vertexSource(string defaultHeader, int maxLights, bool hasTexture, bool hasColor){
-        return shaderHeader(defaultHeader, maxLights, hasTexture, hasColor) + vertexShader;
+    string vertexSource(string defaultHeader, string preVertex, int maxLights, bool hasTexture, bool hasColor, bool clustered){
+        auto source = vertexShader;
+        if(preVertex.empty()){
+            preVertex = "void preVertex(inout vec4 position, inout vec4 normal){}";
+        }
+        ofStringReplace(source, "%preVertex%", preVertex);
+        return shaderHeader(defaultHeader, maxLights, hasTexture, hasColor, clustered) + source;
     }
 
-    string fragmentSource(string defaultHeader, string customUniforms,  string postFragment, int maxLights, bool hasTexture, bool hasColor){
+    string fragmentSource(string defaultHeader, string customUniforms,  string postFragment, int maxLights, bool hasTexture, bool hasColor, bool clustered, bool materialBlock){
         auto source = fragmentShader;
         if(postFragment.empty()){
             postFragment = "vec4 postFragment(vec4 localColor){ return localColor; }";
@@ -369,7 +528,12 @@ namespace{
 		ofStringReplace(source, "%postFragment%", postFragment);
 		ofStringReplace(source, "%custom_uniforms%", customUniforms);
 
-        source = shaderHeader(defaultHeader, maxLights, hasTexture, hasColor) + source;
+        if(materialBlock){
+            source = "#define MATERIAL_BLOCK 1\n" + source;
+        } else {
+            source = "#define MATERIAL_BLOCK 0\n" + source;
+        }
+        source = shaderHeader(defaultHeader, maxLights, hasTexture, hasColor, clustered) + source;
         return source;
     }
 }
@@ -2,6 +2,9 @@
 #include "ofColor.h"
 #include "ofShader.h"
 #include "ofBaseTypes.h"
+#include "ofBufferObject.h"
+
+class ofLightClusters;
 
 // Material concept: "Anything graphical applied to the polygons"
 //
@@ -100,6 +103,19 @@ public:
 	///     vec3 lights[i].right;
 	///     vec3 lights[i].up;
 	///
+	/// preVertex: Adds a function to the material vertex shader that can
+	/// modify the position and normal of each vertex before they are
+	/// transformed, like skinning or displacement. It has to have the
+	/// signature:
+	///
+	/// void preVertex(inout vec4 position, inout vec4 normal){
+	/// }
+	///
+	/// and can declare the uniforms and inputs it needs before it. The
+	/// inputs that aren't one of the default attributes have to be listed
+	/// in customAttributes with the location their data is set to in the
+	/// vbo, like vbo.setAttributeData(location, ...).
+	///
 	struct Settings {
 		ofFloatColor diffuse{ 0.8f, 0.8f, 0.8f, 1.0f }; ///< diffuse reflectance
 		ofFloatColor ambient{ 0.2f, 0.2f, 0.2f, 1.0f }; //< ambient reflectance
@@ -108,6 +124,8 @@ public:
 		float shininess{ 0.2f }; //< specular exponent
 		std::string postFragment;
 		std::string customUniforms;
+		std::string preVertex;
+		std::map<std::string, GLuint> customAttributes;
 	};
 
 	void setup(const ofMaterial::Settings & settings);
@@ -179,6 +197,9 @@ private:
 	const ofShader & getShader(int textureTarget, bool geometryHasColor, ofGLProgrammableRenderer & renderer) const;
 	void updateMaterial(const ofShader & shader,ofGLProgrammableRenderer & renderer) const;
 	void updateLights(const ofShader & shader,ofGLProgrammableRenderer & renderer) const;
+	bool uploadMaterialBlock(const ofShader & shader) const;
+	void setCustomUniforms(const ofShader & shader) const;
+	std::string getShadersKey() const;
 
 	Settings data;
 
@@ -190,6 +211,28 @@ private:
 		ofShader texture2D;
 		ofShader textureRect;
 		size_t numLights;
+		bool clustered = false;
+		std::shared_ptr<ofLightClusters> lightClusters;
+		/// version of the custom uniforms last set in each shader
+		std::map<const ofShader*, uint64_t> customUniformsVersions;
+	};
+	// contents of the ofMaterialBlock uniform block in std140 layout
+	struct MaterialBlock{
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+		glm::vec4 specular;
+		glm::vec4 emissive;
+		glm::vec4 globalAmbient;
+		float shininess;
+		float padding[3];
+	};
+	// copies of a material get their own buffer instead of sharing it
+	struct MaterialBuffer{
+		MaterialBuffer(){}
+		MaterialBuffer(const MaterialBuffer &){}
+		MaterialBuffer & operator=(const MaterialBuffer &){ return *this; }
+		ofBufferObject buffer;
+		MaterialBlock block;
 	};
 	struct TextureUnifom{
 		int textureTarget;
@@ -198,7 +241,12 @@ private:
 	};
 
 	mutable std::map<ofGLProgrammableRenderer*,std::shared_ptr<Shaders>> shaders;
+	mutable MaterialBuffer materialBuffer;
+	/// changes every time a custom uniform is set, so they are only set
+	/// again in the shaders that have older values
+	uint64_t customUniformsVersion = 0;
 	static std::map<ofGLProgrammableRenderer*, std::map<std::string,std::weak_ptr<Shaders>>> shadersMap;
+	static std::map<ofGLProgrammableRenderer*, std::weak_ptr<ofLightClusters>> lightClustersMap;
 	static std::string vertexShader;
 	static std::string fragmentShader;
 	std::map<std::string, float> uniforms1f;
@@ -0,0 +1,226 @@
+#include "ofObjectPicker.h"
+#include "ofGLProgrammableRenderer.h"
+#include "ofGLUtils.h"
+#include "ofCamera.h"
+#include "ofGraphics.h"
+#include "ofAppRunner.h"
+#include "ofLog.h"
+#include <algorithm>
+
+using namespace std;
+
+#ifndef TARGET_OPENGLES
+namespace{
+	const string pickVertex = R"(#version 150
+uniform mat4 modelViewProjectionMatrix;
+in vec4 position;
+
+void main(){
+	gl_Position = modelViewProjectionMatrix * position;
+}
+)";
+
+	const string pickFragment = R"(#version 150
+uniform int objectId;
+out uvec2 fragId;
+
+void main(){
+	// 0 is the background, the primitives start at 1 too
+	fragId = uvec2(uint(objectId), uint(gl_PrimitiveID) + 1u);
+}
+)";
+
+	// the primitives batched by the renderer have to be drawn with the id
+	// they were drawn with
+	void flushPrimitiveBatch(){
+		auto renderer = ofGetCurrentRenderer();
+		if(renderer && renderer->getType() == ofGLProgrammableRenderer::TYPE){
+			static_cast<ofGLProgrammableRenderer*>(renderer.get())->flushPrimitiveBatch();
+		}
+	}
+
+	struct Sample{
+		int distance;
+		GLuint id;
+		GLuint primitive;
+		glm::vec2 position;
+	};
+}
+
+//----------------------------------------------------------
+ofObjectPicker::ofObjectPicker()
+:radius(-1)
+,active(false)
+,depthTest(false){
+}
+
+//----------------------------------------------------------
+bool ofObjectPicker::isSupported(){
+	return ofIsGLProgrammableRenderer();
+}
+
+//----------------------------------------------------------
+void ofObjectPicker::begin(const ofCamera & camera, const glm::vec2 & position, int radius, ofRectangle viewport){
+	if(active){
+		ofLogError("ofObjectPicker") << "begin(): already picking, call end() first";
+		return;
+	}
+	if(!isSupported()){
+		ofLogError("ofObjectPicker") << "begin(): needs the programmable renderer, set the GL version to 3.2 or newer";
+		return;
+	}
+	if(!shader.isLoaded()){
+		if(!shader.setupShaderFromSource(GL_VERTEX_SHADER, pickVertex)
+			|| !shader.setupShaderFromSource(GL_FRAGMENT_SHADER, pickFragment)
+			|| !shader.bindDefaults()
+			|| !shader.linkProgram()){
+			ofLogError("ofObjectPicker") << "begin(): couldn't compile the picking shader";
+			return;
+		}
+	}
+	radius = std::max(radius, 0);
+	int size = radius * 2 + 1;
+	if(radius != this->radius){
+		ofFbo::Settings settings;
+		settings.width = size;
+		settings.height = size;
+		settings.internalformat = GL_RG32UI;
+		settings.textureTarget = GL_TEXTURE_2D;
+		settings.useDepth = true;
+		settings.minFilter = GL_NEAREST;
+		settings.maxFilter = GL_NEAREST;
+		fbo.allocate(settings);
+		this->radius = radius;
+	}
+	if(viewport.isZero()){
+		viewport = ofGetCurrentViewport();
+	}
+
+	// narrows the projection to the pixels around the position, like
+	// gluPickMatrix, so nothing else is rasterized
+	glm::vec2 center(2 * (position.x - viewport.x) / viewport.width - 1, 1 - 2 * (position.y - viewport.y) / viewport.height);
+	glm::vec2 scale(viewport.width / size, viewport.height / size);
+	glm::mat4 pick = glm::scale(glm::mat4(1), glm::vec3(scale, 1)) * glm::translate(glm::mat4(1), glm::vec3(-center, 0));
+
+	depthTest = glIsEnabled(GL_DEPTH_TEST);
+	fbo.begin(ofFboBeginMode::NoDefaults);
+	ofSetMatrixMode(OF_MATRIX_PROJECTION);
+	ofLoadMatrix(pick * camera.getProjectionMatrix(viewport));
+	ofSetMatrixMode(OF_MATRIX_MODELVIEW);
+	ofLoadViewMatrix(camera.getModelViewMatrix());
+	ofSetDepthTest(true);
+	const GLuint background[4] = {0, 0, 0, 0};
+	const GLfloat farDepth = 1;
+	glClearBufferuiv(GL_COLOR, 0, background);
+	glClearBufferfv(GL_DEPTH, 0, &farDepth);
+	shader.begin();
+	shader.setUniform1i("objectId", 0);
+
+	current.objects.clear();
+	// the first row read back is the bottom one
+	current.origin = glm::vec2(position.x - radius, position.y + radius);
+	active = true;
+}
+
+//----------------------------------------------------------
+void ofObjectPicker::nextObject(const ofNode * node, int tag){
+	if(!active){
+		ofLogError("ofObjectPicker") << "setObject(): call begin() first";
+		return;
+	}
+	flushPrimitiveBatch();
+	current.objects.push_back({node, tag});
+	shader.setUniform1i("objectId", int(current.objects.size()));
+}
+
+//----------------------------------------------------------
+void ofObjectPicker::setObject(const ofNode & node, int tag){
+	nextObject(&node, tag);
+}
+
+//----------------------------------------------------------
+void ofObjectPicker::setObject(int tag){
+	nextObject(nullptr, tag);
+}
+
+//----------------------------------------------------------
+void ofObjectPicker::end(){
+	if(!active){
+		return;
+	}
+	flushPrimitiveBatch();
+	shader.end();
+	ofSetDepthTest(depthTest);
+	fbo.end();
+	active = false;
+	// skipped if the GPU is more than getNumBuffers() picks behind
+	if(readback.read(fbo.getTexture())){
+		pending.push_back(std::move(current));
+	}
+	current = Pick();
+}
+
+//----------------------------------------------------------
+bool ofObjectPicker::update(){
+	if(pending.empty() || !readback.isFrameReady()){
+		return false;
+	}
+	auto data = static_cast<const GLuint*>(readback.mapFrame());
+	if(!data){
+		return false;
+	}
+	Pick pick = std::move(pending.front());
+	pending.pop_front();
+
+	int w = readback.getFrameWidth();
+	int h = readback.getFrameHeight();
+	vector<Sample> samples;
+	for(int y = 0; y < h; y++){
+		for(int x = 0; x < w; x++){
+			const GLuint * texel = data + (y * w + x) * 2;
+			if(texel[0] == 0 || texel[0] > pick.objects.size()){
+				continue;
+			}
+			int dx = x - w / 2;
+			int dy = y - h / 2;
+			samples.push_back({dx * dx + dy * dy, texel[0], texel[1], pick.origin + glm::vec2(x, -y)});
+		}
+	}
+	readback.unmapFrame();
+
+	stable_sort(samples.begin(), samples.end(), [](const Sample & a, const Sample & b){
+		return a.distance < b.distance;
+	});
+	hits.clear();
+	vector<bool> found(pick.objects.size(), false);
+	for(auto & sample: samples){
+		if(found[sample.id - 1]){
+			continue;
+		}
+		found[sample.id - 1] = true;
+		Hit hit;
+		hit.found = true;
+		hit.node = pick.objects[sample.id - 1].node;
+		hit.tag = pick.objects[sample.id - 1].tag;
+		hit.primitive = int(sample.primitive) - 1;
+		hit.position = sample.position;
+		hits.push_back(hit);
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+const ofObjectPicker::Hit & ofObjectPicker::getHit() const{
+	return hits.empty() ? noHit : hits.front();
+}
+
+//----------------------------------------------------------
+const vector<ofObjectPicker::Hit> & ofObjectPicker::getHits() const{
+	return hits;
+}
+
+//----------------------------------------------------------
+size_t ofObjectPicker::getNumPending() const{
+	return pending.size();
+}
+#endif
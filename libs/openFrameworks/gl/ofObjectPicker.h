@@ -0,0 +1,135 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofFbo.h"
+#include "ofShader.h"
+#include "ofPixelReadback.h"
+#include "ofRectangle.h"
+#include <deque>
+
+class ofNode;
+class ofCamera;
+
+#ifndef TARGET_OPENGLES
+/// \brief Finds the objects under the mouse by drawing their ids instead of
+/// testing every one of them on the CPU
+///
+/// Between begin() and end() the scene is drawn again with a shader that
+/// writes the id of the current object and the index of each primitive to
+/// an integer fbo. Only the few pixels around the position picked are
+/// rasterized, the projection is narrowed to them, so the cost barely
+/// depends on the size of the scene. The pixels are read back without
+/// stalling and the result arrives a frame or two later:
+///
+/// ~~~~{.cpp}
+/// void ofApp::draw(){
+///     cam.begin();
+///     ofEnableDepthTest();
+///     for(auto & box: boxes){
+///         box.draw();
+///     }
+///     cam.end();
+///
+///     picker.begin(cam, glm::vec2(ofGetMouseX(), ofGetMouseY()));
+///     for(size_t i = 0; i < boxes.size(); i++){
+///         picker.setObject(boxes[i], i);
+///         boxes[i].draw();
+///     }
+///     picker.end();
+///
+///     if(picker.update() && picker.getHit().found){
+///         selected = picker.getHit().tag;
+///     }
+/// }
+/// ~~~~
+///
+/// Draws before the first setObject() hide what's behind them but aren't
+/// picked. Anything drawn with the current shader is picked, of3dPrimitive,
+/// ofMesh, ofVbo and the ofDraw functions. Draws that bind their own
+/// shader, like ofInstancedMesh or materials, aren't. The primitive index
+/// of a hit tells which triangle, line or point of the draw was under the
+/// position, to map it back to a range of a mesh drawn at once.
+///
+/// Needs the programmable renderer, OpenGL 3.2 or newer, not available on
+/// OpenGL ES.
+class ofObjectPicker{
+public:
+	struct Hit{
+		/// \brief false if nothing was drawn under the position
+		bool found = false;
+		/// \brief The node passed to setObject(), nullptr if none was
+		const ofNode * node = nullptr;
+		/// \brief The tag passed to setObject()
+		int tag = 0;
+		/// \brief Index of the primitive in the draw, counted from the
+		/// first triangle, line or point of each draw call
+		int primitive = -1;
+		/// \brief Where the object was seen, in window coordinates
+		glm::vec2 position;
+	};
+
+	ofObjectPicker();
+
+	ofObjectPicker(const ofObjectPicker &) = delete;
+	ofObjectPicker & operator=(const ofObjectPicker &) = delete;
+
+	static bool isSupported();
+
+	/// \brief Starts drawing the ids of the objects seen by camera around
+	/// position
+	///
+	/// \param position in window coordinates, usually the mouse
+	/// \param radius pixels around position that are drawn too, so small or
+	/// thin objects can be picked without hitting them exactly
+	/// \param viewport the one the scene is drawn with, the current one by
+	/// default
+	void begin(const ofCamera & camera, const glm::vec2 & position, int radius = 0, ofRectangle viewport = ofRectangle());
+
+	/// \brief The following draws belong to a new object
+	///
+	/// The node is only stored to be returned with the hit, it has to be
+	/// alive once the result arrives to be used.
+	void setObject(const ofNode & node, int tag = 0);
+	void setObject(int tag);
+
+	/// \brief Ends drawing and starts reading the ids back
+	void end();
+
+	/// \brief Collects the oldest pick that the GPU finished, never blocks
+	/// \returns true if a new result arrived
+	bool update();
+
+	/// \brief The object closest to the position picked in the newest result
+	const Hit & getHit() const;
+
+	/// \brief Every object drawn around the position in the newest result,
+	/// closest to it first
+	const std::vector<Hit> & getHits() const;
+
+	/// \brief Number of picks that haven't got a result yet
+	std::size_t getNumPending() const;
+
+private:
+	struct Object{
+		const ofNode * node;
+		int tag;
+	};
+	struct Pick{
+		std::vector<Object> objects;
+		glm::vec2 origin; // viewport position of the first pixel
+	};
+
+	void nextObject(const ofNode * node, int tag);
+
+	ofFbo fbo;
+	ofShader shader;
+	ofPixelReadback readback;
+	int radius;
+	bool active;
+	bool depthTest;
+	Pick current;
+	std::deque<Pick> pending;
+	std::vector<Hit> hits;
+	Hit noHit;
+};
+#endif
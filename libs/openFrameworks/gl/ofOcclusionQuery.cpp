@@ -0,0 +1,209 @@
+#include "ofOcclusionQuery.h"
+#include "ofGLProgrammableRenderer.h"
+#include "ofAppRunner.h"
+#include "ofLog.h"
+
+using namespace std;
+
+const size_t ofOcclusionQuery::numQueries;
+
+namespace{
+	// primitives batched by the renderer have to be drawn inside the query
+	void flushPrimitiveBatch(){
+		auto renderer = ofGetCurrentRenderer();
+		if(renderer && renderer->getType() == ofGLProgrammableRenderer::TYPE){
+			static_cast<ofGLProgrammableRenderer*>(renderer.get())->flushPrimitiveBatch();
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofOcclusionQuery::ofOcclusionQuery()
+:next(0)
+,lastEnded(-1)
+,active(-1)
+,target(0)
+,result(0)
+,bHasResult(false){
+	for(size_t i = 0; i < numQueries; i++){
+		ids[i] = 0;
+		pending[i] = false;
+	}
+}
+
+//----------------------------------------------------------
+ofOcclusionQuery::~ofOcclusionQuery(){
+#ifndef TARGET_OPENGLES
+	if(ids[0] != 0){
+		glDeleteQueries(numQueries, ids);
+	}
+#endif
+}
+
+//----------------------------------------------------------
+bool ofOcclusionQuery::isSupported(){
+#ifndef TARGET_OPENGLES
+	return GLEW_VERSION_3_3 || GLEW_ARB_occlusion_query2;
+#else
+	return false;
+#endif
+}
+
+//----------------------------------------------------------
+bool ofOcclusionQuery::isConditionalRenderSupported(){
+#ifndef TARGET_OPENGLES
+	return GLEW_VERSION_3_0 != 0;
+#else
+	return false;
+#endif
+}
+
+//----------------------------------------------------------
+void ofOcclusionQuery::allocate(){
+#ifndef TARGET_OPENGLES
+	glGenQueries(numQueries, ids);
+#endif
+}
+
+//----------------------------------------------------------
+void ofOcclusionQuery::begin(){
+#ifndef TARGET_OPENGLES
+	begin(GL_ANY_SAMPLES_PASSED);
+#endif
+}
+
+//----------------------------------------------------------
+void ofOcclusionQuery::begin(GLenum target){
+#ifndef TARGET_OPENGLES
+	if(!isSupported()){
+		ofLogError("ofOcclusionQuery") << "begin(): occlusion queries need OpenGL 3.3 or GL_ARB_occlusion_query2";
+		return;
+	}
+	if(active >= 0){
+		ofLogError("ofOcclusionQuery") << "begin(): query already started, call end() first";
+		return;
+	}
+	if(ids[0] == 0){
+		allocate();
+	}
+	update();
+	flushPrimitiveBatch();
+	this->target = target;
+	active = next;
+	// a query that still has no result after cycling through all of them
+	// is dropped
+	pending[active] = false;
+	glBeginQuery(target, ids[active]);
+#endif
+}
+
+//----------------------------------------------------------
+void ofOcclusionQuery::end(){
+#ifndef TARGET_OPENGLES
+	if(active < 0){
+		return;
+	}
+	flushPrimitiveBatch();
+	glEndQuery(target);
+	pending[active] = true;
+	lastEnded = active;
+	next = (active + 1) % numQueries;
+	active = -1;
+#endif
+}
+
+//----------------------------------------------------------
+bool ofOcclusionQuery::update(){
+	bool updated = false;
+#ifndef TARGET_OPENGLES
+	// the results arrive in order, from the oldest query, stop at the
+	// first one that isn't ready
+	for(size_t i = 0; i < numQueries; i++){
+		size_t query = (next + i) % numQueries;
+		if(!pending[query] || int(query) == active){
+			continue;
+		}
+		GLint available = 0;
+		glGetQueryObjectiv(ids[query], GL_QUERY_RESULT_AVAILABLE, &available);
+		if(!available){
+			break;
+		}
+		GLuint64 samples = 0;
+		glGetQueryObjectui64v(ids[query], GL_QUERY_RESULT, &samples);
+		result = samples;
+		bHasResult = true;
+		pending[query] = false;
+		updated = true;
+	}
+#endif
+	return updated;
+}
+
+//----------------------------------------------------------
+bool ofOcclusionQuery::hasResult(){
+	update();
+	return bHasResult;
+}
+
+//----------------------------------------------------------
+bool ofOcclusionQuery::isVisible(){
+	update();
+	return !bHasResult || result > 0;
+}
+
+//----------------------------------------------------------
+uint64_t ofOcclusionQuery::getResult(){
+	update();
+	return result;
+}
+
+//----------------------------------------------------------
+uint64_t ofOcclusionQuery::waitForResult(){
+#ifndef TARGET_OPENGLES
+	if(lastEnded >= 0 && pending[lastEnded]){
+		GLuint64 samples = 0;
+		glGetQueryObjectui64v(ids[lastEnded], GL_QUERY_RESULT, &samples);
+		result = samples;
+		bHasResult = true;
+		// older results are superseded
+		for(auto & p: pending){
+			p = false;
+		}
+	}
+#endif
+	return result;
+}
+
+//----------------------------------------------------------
+void ofOcclusionQuery::beginConditionalRender() const{
+#ifndef TARGET_OPENGLES
+	beginConditionalRender(GL_QUERY_NO_WAIT);
+#endif
+}
+
+//----------------------------------------------------------
+void ofOcclusionQuery::beginConditionalRender(GLenum mode) const{
+#ifndef TARGET_OPENGLES
+	if(lastEnded < 0 || !isConditionalRenderSupported()){
+		return;
+	}
+	flushPrimitiveBatch();
+	glBeginConditionalRender(ids[lastEnded], mode);
+#endif
+}
+
+//----------------------------------------------------------
+void ofOcclusionQuery::endConditionalRender() const{
+#ifndef TARGET_OPENGLES
+	if(lastEnded < 0 || !isConditionalRenderSupported()){
+		return;
+	}
+	flushPrimitiveBatch();
+	glEndConditionalRender();
+#endif
+}
+
+//----------------------------------------------------------
+GLuint ofOcclusionQuery::getId() const{
+	return lastEnded < 0 ? 0 : ids[lastEnded];
+}
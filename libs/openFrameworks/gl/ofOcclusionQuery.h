@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ofConstants.h"
+
+/// \brief Counts the samples of the draws between begin() and end() that
+/// pass the depth test, to know if an object is hidden
+///
+/// The results arrive a frame or two after the draws and are collected
+/// without waiting for the GPU, so a query can be issued every frame and
+/// its last result used to decide what to draw in the next one:
+///
+/// ~~~~{.cpp}
+/// void ofApp::draw(){
+///     cam.begin();
+///     ofEnableDepthTest();
+///     walls.draw();
+///     query.begin();
+///     if(query.isVisible()){
+///         statue.draw();
+///     }else{
+///         // hidden last frame, test only its bounds this frame
+///         glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+///         glDepthMask(GL_FALSE);
+///         ofDrawBox(bounds.getCenter(), bounds.getSize().x, bounds.getSize().y, bounds.getSize().z);
+///         glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+///         glDepthMask(GL_TRUE);
+///     }
+///     query.end();
+///     cam.end();
+/// }
+/// ~~~~
+///
+/// beginConditionalRender() lets the GPU skip the draws itself if the last
+/// query found no samples, without waiting for the result on the CPU.
+/// ofRenderList::setOcclusionMode() does all this for a list of nodes.
+///
+/// Each query cycles through a few GL queries so issuing a new one never
+/// waits for the previous results. Needs OpenGL 3.3 or
+/// GL_ARB_occlusion_query2 on desktop, not available on OpenGL ES.
+class ofOcclusionQuery{
+public:
+	/// \brief GL queries in flight per ofOcclusionQuery
+	static const std::size_t numQueries = 3;
+
+	ofOcclusionQuery();
+	~ofOcclusionQuery();
+
+	ofOcclusionQuery(const ofOcclusionQuery &) = delete;
+	ofOcclusionQuery & operator=(const ofOcclusionQuery &) = delete;
+
+	static bool isSupported();
+
+	/// \brief If beginConditionalRender() can be used, OpenGL 3.0 or later
+	static bool isConditionalRenderSupported();
+
+	/// \brief Starts counting the samples of the following draws, with
+	/// GL_ANY_SAMPLES_PASSED
+	void begin();
+
+	/// \param target GL_ANY_SAMPLES_PASSED, the fastest, only tells if any
+	/// sample passed, GL_ANY_SAMPLES_PASSED_CONSERVATIVE can be even faster
+	/// and report false positives, GL_SAMPLES_PASSED counts all of them.
+	void begin(GLenum target);
+	void end();
+
+	/// \brief Collects the results that are ready without waiting
+	///
+	/// Called by begin() and the result getters.
+	/// \returns true if a newer result arrived
+	bool update();
+
+	/// \brief If any query issued has a result already
+	bool hasResult();
+
+	/// \brief If the newest result found samples, true until there's a
+	/// result so new objects are always drawn
+	bool isVisible();
+
+	/// \brief The newest result, the number of samples or 0 or 1 for the
+	/// GL_ANY_SAMPLES_PASSED targets
+	uint64_t getResult();
+
+	/// \brief Waits for the GPU to finish the last query and returns its
+	/// result, stalls the pipeline
+	uint64_t waitForResult();
+
+	/// \brief The following draws are skipped by the GPU if the last query
+	/// ended didn't find any samples, they are drawn if the result isn't
+	/// ready yet (GL_QUERY_NO_WAIT)
+	void beginConditionalRender() const;
+
+	/// \param mode GL_QUERY_NO_WAIT draws if the result isn't ready yet,
+	/// GL_QUERY_WAIT makes the GPU wait for it.
+	void beginConditionalRender(GLenum mode) const;
+	void endConditionalRender() const;
+
+	/// \brief GL id of the last query ended, 0 if none was
+	GLuint getId() const;
+
+private:
+	void allocate();
+
+	GLuint ids[numQueries];
+	bool pending[numQueries];
+	std::size_t next;
+	int lastEnded;
+	int active;
+	GLenum target;
+	uint64_t result;
+	bool bHasResult;
+};
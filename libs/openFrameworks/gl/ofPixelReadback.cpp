@@ -0,0 +1,223 @@
+#include "ofPixelReadback.h"
+#include "ofTexture.h"
+#include "ofFbo.h"
+#include "ofGLUtils.h"
+#include "ofLog.h"
+
+#ifndef TARGET_OPENGLES
+
+//----------------------------------------------------------
+ofPixelReadback::ofPixelReadback()
+:frames(3)
+,oldest(0)
+,numPending(0)
+,mappedFrame(nullptr){
+
+}
+
+//----------------------------------------------------------
+ofPixelReadback::~ofPixelReadback(){
+	clear();
+}
+
+//----------------------------------------------------------
+void ofPixelReadback::setNumBuffers(std::size_t numBuffers){
+	clear();
+	frames.clear();
+	frames.resize(std::max<std::size_t>(numBuffers,1));
+}
+
+//----------------------------------------------------------
+std::size_t ofPixelReadback::getNumBuffers() const{
+	return frames.size();
+}
+
+//----------------------------------------------------------
+ofPixelReadback::Frame * ofPixelReadback::beginRead(int width, int height, int glInternalFormat){
+	if(numPending == frames.size()){
+		ofLogVerbose("ofPixelReadback") << "read(): all buffers in use, skipping frame";
+		return nullptr;
+	}
+
+	Frame & frame = frames[(oldest + numPending) % frames.size()];
+	frame.width = width;
+	frame.height = height;
+	frame.glFormat = ofGetGLFormatFromInternal(glInternalFormat);
+	frame.glType = ofGetGlTypeFromInternal(glInternalFormat);
+
+	int numChannels = ofGetNumChannelsFromGLFormat(frame.glFormat);
+	int bytesPerChannel = ofGetBytesPerChannelFromGLType(frame.glType);
+	GLsizeiptr bytes = GLsizeiptr(width) * height * numChannels * bytesPerChannel;
+	if(!frame.buffer.isAllocated() || frame.buffer.size() != bytes){
+		frame.buffer.allocate(bytes, GL_STREAM_READ);
+	}
+	ofSetPixelStoreiAlignment(GL_PACK_ALIGNMENT, width, bytesPerChannel, numChannels);
+	return &frame;
+}
+
+//----------------------------------------------------------
+void ofPixelReadback::endRead(Frame & frame){
+	frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	numPending++;
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::read(const ofTexture & texture){
+	if(!texture.isAllocated()) return false;
+	const ofTextureData & texData = texture.getTextureData();
+	Frame * frame = beginRead(texData.width, texData.height, texData.glInternalFormat);
+	if(!frame) return false;
+	texture.copyTo(frame->buffer);
+	endRead(*frame);
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::read(const ofFbo & fbo, int attachmentPoint){
+	if(!fbo.isAllocated()) return false;
+	const ofTexture & texture = fbo.getTexture(attachmentPoint);
+	// glReadPixels can't read from a multisampled fbo and only reads
+	// the first attachment, in any other case read the resolved texture
+	if(attachmentPoint != 0 || fbo.getId() != fbo.getIdDrawBuffer()){
+		return read(texture);
+	}
+	Frame * frame = beginRead(fbo.getWidth(), fbo.getHeight(), texture.getTextureData().glInternalFormat);
+	if(!frame) return false;
+	fbo.copyTo(frame->buffer);
+	endRead(*frame);
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::read(const ofTexture & texture, const ofRectangle & region){
+	if(!texture.isAllocated()) return false;
+	const ofTextureData & texData = texture.getTextureData();
+	// clipped to whole texels here so the buffer has the size of the copy
+	ofRectangle r = region.getStandardized();
+	int x = std::max(int(r.getMinX()), 0);
+	int y = std::max(int(r.getMinY()), 0);
+	int w = std::min(int(r.getMaxX()), int(texData.tex_w)) - x;
+	int h = std::min(int(r.getMaxY()), int(texData.tex_h)) - y;
+	if(w <= 0 || h <= 0) return false;
+	Frame * frame = beginRead(w, h, texData.glInternalFormat);
+	if(!frame) return false;
+	texture.copyTo(frame->buffer, ofRectangle(x, y, w, h));
+	endRead(*frame);
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::read(const ofFbo & fbo, const ofRectangle & region, int attachmentPoint){
+	if(!fbo.isAllocated()) return false;
+	return read(fbo.getTexture(attachmentPoint), region);
+}
+
+//----------------------------------------------------------
+std::size_t ofPixelReadback::getNumPending() const{
+	return numPending;
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::isFrameReady() const{
+	if(numPending == 0) return false;
+	const Frame & frame = frames[oldest];
+	if(!frame.fence) return true;
+	GLenum ret = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	return ret == GL_ALREADY_SIGNALED || ret == GL_CONDITION_SATISFIED;
+}
+
+//----------------------------------------------------------
+template<typename PixelType>
+bool ofPixelReadback::getPixels(ofPixels_<PixelType> & pixels, int glType){
+	if(mappedFrame){
+		ofLogError("ofPixelReadback") << "getPixels(): the oldest frame is mapped, call unmapFrame() first";
+		return false;
+	}
+	if(!isFrameReady()) return false;
+	Frame & frame = frames[oldest];
+	if(frame.glType != glType){
+		ofLogError("ofPixelReadback") << "getPixels(): pixels type doesn't match the type of the texture read, dropping frame";
+		releaseFrame();
+		return false;
+	}
+	auto data = frame.buffer.map<PixelType>(GL_READ_ONLY);
+	if(data){
+		pixels.setFromPixels(data, frame.width, frame.height, ofGetNumChannelsFromGLFormat(frame.glFormat));
+		frame.buffer.unmap();
+	}
+	releaseFrame();
+	return data != nullptr;
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::getPixels(ofPixels & pixels){
+	return getPixels(pixels, GL_UNSIGNED_BYTE);
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::getPixels(ofShortPixels & pixels){
+	return getPixels(pixels, GL_UNSIGNED_SHORT);
+}
+
+//----------------------------------------------------------
+bool ofPixelReadback::getPixels(ofFloatPixels & pixels){
+	return getPixels(pixels, GL_FLOAT);
+}
+
+//----------------------------------------------------------
+const void * ofPixelReadback::mapFrame(){
+	if(!mappedFrame && isFrameReady()){
+		mappedFrame = frames[oldest].buffer.map(GL_READ_ONLY);
+	}
+	return mappedFrame;
+}
+
+//----------------------------------------------------------
+void ofPixelReadback::unmapFrame(){
+	if(!mappedFrame) return;
+	frames[oldest].buffer.unmap();
+	mappedFrame = nullptr;
+	releaseFrame();
+}
+
+//----------------------------------------------------------
+int ofPixelReadback::getFrameWidth() const{
+	return numPending ? frames[oldest].width : 0;
+}
+
+//----------------------------------------------------------
+int ofPixelReadback::getFrameHeight() const{
+	return numPending ? frames[oldest].height : 0;
+}
+
+//----------------------------------------------------------
+int ofPixelReadback::getFrameNumChannels() const{
+	return numPending ? ofGetNumChannelsFromGLFormat(frames[oldest].glFormat) : 0;
+}
+
+//----------------------------------------------------------
+int ofPixelReadback::getFrameBytesPerChannel() const{
+	return numPending ? ofGetBytesPerChannelFromGLType(frames[oldest].glType) : 0;
+}
+
+//----------------------------------------------------------
+void ofPixelReadback::releaseFrame(){
+	Frame & frame = frames[oldest];
+	if(frame.fence){
+		glDeleteSync(frame.fence);
+		frame.fence = nullptr;
+	}
+	oldest = (oldest + 1) % frames.size();
+	numPending--;
+}
+
+//----------------------------------------------------------
+void ofPixelReadback::clear(){
+	unmapFrame();
+	while(numPending){
+		releaseFrame();
+	}
+	oldest = 0;
+}
+
+#endif
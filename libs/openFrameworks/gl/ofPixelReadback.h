@@ -0,0 +1,121 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofBufferObject.h"
+#include "ofPixels.h"
+
+class ofTexture;
+class ofFbo;
+
+#ifndef TARGET_OPENGLES
+/// \brief Reads textures and fbos back to the CPU without stalling
+///
+/// ofPixelReadback keeps a pool of pixel pack buffers. Every call to
+/// read() starts a copy from the GPU into the next free buffer and
+/// places a fence after it, the results can be collected some frames
+/// later, once the GPU is done with the copy, oldest first:
+///
+/// ~~~~{.cpp}
+/// void ofApp::draw(){
+///     fbo.draw(0,0);
+///     readback.read(fbo);
+///     if(readback.getPixels(pixels)){
+///         // pixels contains the fbo as it was some frames ago
+///     }
+/// }
+/// ~~~~
+///
+/// The number of buffers is the maximum number of reads in flight,
+/// if all of them are still in use read() returns false and the frame
+/// is skipped instead of blocking.
+class ofPixelReadback{
+public:
+	ofPixelReadback();
+	~ofPixelReadback();
+
+	ofPixelReadback(const ofPixelReadback &) = delete;
+	ofPixelReadback & operator=(const ofPixelReadback &) = delete;
+
+	/// \brief Sets the number of buffers in the pool, 3 by default
+	///
+	/// Drops any read that is still in flight
+	void setNumBuffers(std::size_t numBuffers);
+	std::size_t getNumBuffers() const;
+
+	/// \brief Starts reading the texture into the next free buffer
+	/// \returns false if all the buffers are still in use
+	bool read(const ofTexture & texture);
+
+	/// \brief Starts reading the fbo into the next free buffer
+	/// \returns false if all the buffers are still in use
+	bool read(const ofFbo & fbo, int attachmentPoint = 0);
+
+	/// \brief Starts reading only a region of the texture, in texels from
+	/// its first row, so the buffer and the transfer are just that size
+	/// \returns false if all the buffers are still in use or the region
+	/// is outside of the texture
+	bool read(const ofTexture & texture, const ofRectangle & region);
+
+	/// \brief Starts reading only a region of an attachment of the fbo
+	bool read(const ofFbo & fbo, const ofRectangle & region, int attachmentPoint = 0);
+
+	/// \brief Number of reads started that haven't been collected yet
+	std::size_t getNumPending() const;
+
+	/// \brief true if the oldest pending read has been completed by the GPU
+	///
+	/// never blocks
+	bool isFrameReady() const;
+
+	/// \brief Copies the oldest completed read into pixels and releases its buffer
+	///
+	/// the type of the pixels has to match the type of the texture that
+	/// was read
+	///
+	/// \returns false if no read has been completed yet
+	bool getPixels(ofPixels & pixels);
+	bool getPixels(ofShortPixels & pixels);
+	bool getPixels(ofFloatPixels & pixels);
+
+	/// \brief Maps the oldest completed read and returns a pointer to it
+	///
+	/// The data is tightly packed, getFrameWidth(), getFrameHeight(),
+	/// getFrameNumChannels() and getFrameBytesPerChannel() describe its
+	/// layout. Call unmapFrame() once done with it to release the buffer.
+	///
+	/// \returns nullptr if no read has been completed yet
+	const void * mapFrame();
+
+	/// \brief Unmaps and releases the frame returned by mapFrame()
+	void unmapFrame();
+
+	int getFrameWidth() const;
+	int getFrameHeight() const;
+	int getFrameNumChannels() const;
+	int getFrameBytesPerChannel() const;
+
+	/// \brief Drops all the pending reads
+	void clear();
+
+private:
+	struct Frame{
+		ofBufferObject buffer;
+		GLsync fence = nullptr;
+		int width = 0;
+		int height = 0;
+		int glFormat = 0;
+		int glType = 0;
+	};
+
+	Frame * beginRead(int width, int height, int glInternalFormat);
+	void endRead(Frame & frame);
+	void releaseFrame();
+	template<typename PixelType>
+	bool getPixels(ofPixels_<PixelType> & pixels, int glType);
+
+	std::vector<Frame> frames;
+	std::size_t oldest;
+	std::size_t numPending;
+	const void * mappedFrame;
+};
+#endif
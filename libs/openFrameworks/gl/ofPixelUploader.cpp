@@ -0,0 +1,213 @@
+#include "ofPixelUploader.h"
+#include "ofTexture.h"
+#include "ofGLUtils.h"
+#include "ofLog.h"
+
+#ifndef TARGET_OPENGLES
+
+//----------------------------------------------------------
+ofPixelUploader::ofPixelUploader()
+:writing(nullptr)
+,lastFrameNum(0)
+,width(0)
+,height(0)
+,glInternalFormat(0)
+,glFormat(0)
+,glType(0)
+,frameSize(0){
+
+}
+
+//----------------------------------------------------------
+ofPixelUploader::~ofPixelUploader(){
+	clear();
+}
+
+//----------------------------------------------------------
+void ofPixelUploader::allocate(int width, int height, int glInternalFormat, std::size_t numBuffers){
+	clear();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	this->width = width;
+	this->height = height;
+	this->glInternalFormat = glInternalFormat;
+	glFormat = ofGetGLFormatFromInternal(glInternalFormat);
+	glType = ofGetGlTypeFromInternal(glInternalFormat);
+	frameSize = std::size_t(width) * height * ofGetNumChannelsFromGLFormat(glFormat) * ofGetBytesPerChannelFromGLType(glType);
+
+	frames.resize(std::max<std::size_t>(numBuffers,1));
+	for(auto & frame: frames){
+		frame.buffer.allocate(frameSize, GL_STREAM_DRAW);
+		frame.data = frame.buffer.mapRange(0, frameSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		frame.state = frame.data ? Free : InFlight;
+	}
+}
+
+//----------------------------------------------------------
+void ofPixelUploader::allocate(const ofTexture & texture, std::size_t numBuffers){
+	const ofTextureData & texData = texture.getTextureData();
+	allocate(texData.width, texData.height, texData.glInternalFormat, numBuffers);
+}
+
+//----------------------------------------------------------
+bool ofPixelUploader::isAllocated() const{
+	return !frames.empty();
+}
+
+//----------------------------------------------------------
+void * ofPixelUploader::beginWrite(){
+	std::unique_lock<std::mutex> lock(mutex);
+	if(writing){
+		ofLogError("ofPixelUploader") << "beginWrite(): called twice without calling endWrite()";
+		return nullptr;
+	}
+	for(auto & frame: frames){
+		if(frame.state == Free){
+			frame.state = Writing;
+			writing = &frame;
+			return frame.data;
+		}
+	}
+	return nullptr;
+}
+
+//----------------------------------------------------------
+void ofPixelUploader::endWrite(){
+	std::unique_lock<std::mutex> lock(mutex);
+	if(!writing) return;
+	writing->state = Ready;
+	writing->frameNum = ++lastFrameNum;
+	writing = nullptr;
+}
+
+//----------------------------------------------------------
+template<typename PixelType>
+bool ofPixelUploader::write(const ofPixels_<PixelType> & pixels, int glType){
+	if(glType != this->glType || pixels.getTotalBytes() != frameSize){
+		ofLogError("ofPixelUploader") << "write(): pixels size or format don't match the allocated buffers";
+		return false;
+	}
+	void * data = beginWrite();
+	if(!data) return false;
+	memcpy(data, pixels.getData(), frameSize);
+	endWrite();
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofPixelUploader::write(const ofPixels & pixels){
+	return write(pixels, GL_UNSIGNED_BYTE);
+}
+
+//----------------------------------------------------------
+bool ofPixelUploader::write(const ofShortPixels & pixels){
+	return write(pixels, GL_UNSIGNED_SHORT);
+}
+
+//----------------------------------------------------------
+bool ofPixelUploader::write(const ofFloatPixels & pixels){
+	return write(pixels, GL_FLOAT);
+}
+
+//----------------------------------------------------------
+bool ofPixelUploader::isFrameNew() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto & frame: frames){
+		if(frame.state == Ready) return true;
+	}
+	return false;
+}
+
+//----------------------------------------------------------
+void ofPixelUploader::recycleFrames(){
+	for(auto & frame: frames){
+		if(frame.state != InFlight) continue;
+		if(frame.fence){
+			GLenum ret = glClientWaitSync(frame.fence, 0, 0);
+			if(ret != GL_ALREADY_SIGNALED && ret != GL_CONDITION_SATISFIED) continue;
+			glDeleteSync(frame.fence);
+			frame.fence = nullptr;
+		}
+		frame.data = frame.buffer.mapRange(0, frameSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if(frame.data){
+			frame.state = Free;
+		}
+	}
+}
+
+//----------------------------------------------------------
+bool ofPixelUploader::upload(ofTexture & texture){
+	if(!texture.isAllocated()){
+		texture.allocate(width, height, glInternalFormat);
+	}else if(texture.getTextureData().width != width || texture.getTextureData().height != height){
+		ofLogError("ofPixelUploader") << "upload(): texture size doesn't match the allocated buffers";
+		return false;
+	}
+
+	Frame * newest = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		recycleFrames();
+		for(auto & frame: frames){
+			if(frame.state != Ready) continue;
+			if(!newest || frame.frameNum > newest->frameNum){
+				newest = &frame;
+			}
+		}
+		if(!newest) return false;
+		// frames older than the newest one are skipped, they are still
+		// mapped so they can be written to again straight away
+		for(auto & frame: frames){
+			if(frame.state == Ready && &frame != newest){
+				frame.state = Free;
+			}
+		}
+		newest->state = InFlight;
+	}
+
+	// the writer never touches frames in flight so the rest doesn't
+	// need to hold the lock
+	newest->buffer.unmap();
+	newest->data = nullptr;
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT, width, ofGetBytesPerChannelFromGLType(glType), ofGetNumChannelsFromGLFormat(glFormat));
+	texture.loadData(newest->buffer, glFormat, glType);
+	newest->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	return true;
+}
+
+//----------------------------------------------------------
+int ofPixelUploader::getWidth() const{
+	return width;
+}
+
+//----------------------------------------------------------
+int ofPixelUploader::getHeight() const{
+	return height;
+}
+
+//----------------------------------------------------------
+std::size_t ofPixelUploader::getFrameSize() const{
+	return frameSize;
+}
+
+//----------------------------------------------------------
+std::size_t ofPixelUploader::getNumBuffers() const{
+	return frames.size();
+}
+
+//----------------------------------------------------------
+void ofPixelUploader::clear(){
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto & frame: frames){
+		if(frame.data){
+			frame.buffer.unmap();
+		}
+		if(frame.fence){
+			glDeleteSync(frame.fence);
+		}
+	}
+	frames.clear();
+	writing = nullptr;
+}
+
+#endif
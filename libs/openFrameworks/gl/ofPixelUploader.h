@@ -0,0 +1,122 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofBufferObject.h"
+#include "ofPixels.h"
+#include <mutex>
+
+class ofTexture;
+
+#ifndef TARGET_OPENGLES
+/// \brief Streams pixels to a texture through a pool of mapped pixel buffers
+///
+/// ofPixelUploader keeps a few pixel unpack buffers mapped so another
+/// thread can write frames straight into GPU visible memory, the GL thread
+/// then only has to start the transfer from the buffer to the texture:
+///
+/// ~~~~{.cpp}
+/// // setup, on the GL thread
+/// texture.allocate(1920, 1080, GL_RGB);
+/// uploader.allocate(texture);
+///
+/// // on a worker thread, for every new frame
+/// uploader.write(pixels); // or beginWrite() / endWrite() to decode in place
+///
+/// // on the GL thread, every frame
+/// uploader.upload(texture);
+/// ~~~~
+///
+/// Only the newest written frame is uploaded, older ones are skipped.
+/// If all the buffers are waiting to be uploaded or still in use by the GPU
+/// beginWrite() returns nullptr and the writer should drop the frame
+/// instead of waiting. Only one thread should write at a time.
+class ofPixelUploader{
+public:
+	ofPixelUploader();
+	~ofPixelUploader();
+
+	ofPixelUploader(const ofPixelUploader &) = delete;
+	ofPixelUploader & operator=(const ofPixelUploader &) = delete;
+
+	/// \brief Allocates numBuffers buffers big enough for a frame with
+	/// the passed size and format, has to be called from the GL thread
+	void allocate(int width, int height, int glInternalFormat, std::size_t numBuffers = 3);
+
+	/// \brief Allocates buffers that match the size and format of texture
+	void allocate(const ofTexture & texture, std::size_t numBuffers = 3);
+
+	bool isAllocated() const;
+
+	/// \brief Returns a pointer to a free buffer to write a frame to
+	///
+	/// The frame has to be tightly packed, with the size and format passed
+	/// to allocate(). Can be called from any thread.
+	///
+	/// \returns nullptr if there's no free buffer
+	void * beginWrite();
+
+	/// \brief Marks the buffer returned by beginWrite() as ready to upload
+	void endWrite();
+
+	/// \brief Copies pixels into a free buffer and marks it ready to upload
+	///
+	/// Can be called from any thread, the pixels have to match the size
+	/// and format passed to allocate()
+	///
+	/// \returns false if there's no free buffer or the pixels don't match
+	bool write(const ofPixels & pixels);
+	bool write(const ofShortPixels & pixels);
+	bool write(const ofFloatPixels & pixels);
+
+	/// \brief true if a frame has been written since the last upload()
+	bool isFrameNew() const;
+
+	/// \brief Uploads the newest written frame to texture, has to be
+	/// called from the GL thread
+	///
+	/// Also maps again the buffers the GPU is done with so they can be
+	/// written to. Never blocks.
+	///
+	/// \returns true if a new frame was uploaded
+	bool upload(ofTexture & texture);
+
+	int getWidth() const;
+	int getHeight() const;
+	std::size_t getFrameSize() const;
+	std::size_t getNumBuffers() const;
+
+	/// \brief Releases all the buffers, has to be called from the GL thread
+	void clear();
+
+private:
+	enum State{
+		InFlight,
+		Free,
+		Writing,
+		Ready,
+	};
+
+	struct Frame{
+		ofBufferObject buffer;
+		void * data = nullptr;
+		GLsync fence = nullptr;
+		State state = InFlight;
+		uint64_t frameNum = 0;
+	};
+
+	void recycleFrames();
+	template<typename PixelType>
+	bool write(const ofPixels_<PixelType> & pixels, int glType);
+
+	std::vector<Frame> frames;
+	mutable std::mutex mutex;
+	Frame * writing;
+	uint64_t lastFrameNum;
+	int width;
+	int height;
+	int glInternalFormat;
+	int glFormat;
+	int glType;
+	std::size_t frameSize;
+};
+#endif
@@ -0,0 +1,53 @@
+#include "ofRenderStats.h"
+
+namespace{
+	ofRenderStats lastStats;
+}
+
+//----------------------------------------------------------
+void ofRenderStats::reset(){
+	*this = ofRenderStats();
+}
+
+//----------------------------------------------------------
+const ofRenderStats & ofGetRenderStats(){
+	return lastStats;
+}
+
+//----------------------------------------------------------
+const ofRenderStats & ofGetCurrentRenderStats(){
+	return of::priv::currentRenderStats();
+}
+
+//----------------------------------------------------------
+void ofResetRenderStats(){
+	lastStats = of::priv::currentRenderStats();
+	of::priv::currentRenderStats().reset();
+}
+
+//----------------------------------------------------------
+ofRenderStats & of::priv::currentRenderStats(){
+	// only the render thread's are reported, other threads with a GL
+	// context count their own
+	static thread_local ofRenderStats stats;
+	return stats;
+}
+
+//----------------------------------------------------------
+void of::priv::countDraw(GLenum mode, std::size_t count, std::size_t instances){
+	auto & stats = currentRenderStats();
+	stats.drawCalls++;
+	switch(mode){
+	case GL_TRIANGLES:
+		stats.triangles += uint64_t(count / 3) * instances;
+		break;
+	case GL_TRIANGLE_STRIP:
+	case GL_TRIANGLE_FAN:
+		if(count > 2){
+			stats.triangles += uint64_t(count - 2) * instances;
+		}
+		break;
+	default:
+		break;
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ofConstants.h"
+
+/// \brief What was sent to GL during a frame
+///
+/// Counted by the renderers, ofGLStateCache, ofTexture, ofBufferObject and
+/// ofFbo, so GL calls an app or addon makes directly aren't included, nor
+/// the uploads made by an ofGLUploadWorker in its own thread:
+///
+/// ~~~~{.cpp}
+/// void ofApp::draw(){
+///     ...
+///     auto & stats = ofGetRenderStats();
+///     ofDrawBitmapString(ofToString(stats.drawCalls) + " draw calls, " +
+///         ofToString(stats.textureUploadBytes / 1024) + "KB uploaded", 20, 20);
+/// }
+/// ~~~~
+struct ofRenderStats{
+	std::size_t drawCalls = 0;
+	/// triangles in triangle, strip and fan draws, times the instances
+	uint64_t triangles = 0;
+	/// shader, vertex array, texture, blending, capability and viewport
+	/// changes that reached GL through ofGLStateCache
+	std::size_t stateChanges = 0;
+	std::size_t shaderBinds = 0;
+	uint64_t textureUploadBytes = 0;
+	uint64_t bufferUploadBytes = 0;
+	std::size_t fboBinds = 0;
+	/// pixels read back from the screen, fbos or textures
+	std::size_t readbacks = 0;
+
+	void reset();
+};
+
+/// \brief The counters of the last complete frame
+const ofRenderStats & ofGetRenderStats();
+
+/// \brief The counters of the current frame so far
+const ofRenderStats & ofGetCurrentRenderStats();
+
+/// \brief Ends the current frame, its counters become the ones returned
+/// by ofGetRenderStats() and counting starts again from 0
+///
+/// Called by ofMainLoop before updating the windows, the counters of a
+/// frame include every window.
+void ofResetRenderStats();
+
+namespace of{
+namespace priv{
+	ofRenderStats & currentRenderStats();
+
+	/// \brief Counts a draw of count vertices with the GL primitive mode
+	void countDraw(GLenum mode, std::size_t count, std::size_t instances = 1);
+}
+}
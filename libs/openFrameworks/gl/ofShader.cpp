@@ -12,7 +12,10 @@
 #include "ofParameterGroup.h"
 #include "ofParameter.h"
 #include "ofBufferObject.h"
+#include "ofGLStateCache.h"
+#include "ofTaskPool.h"
 #include <regex>
+#include <cstring>
 #ifdef TARGET_ANDROID
 #include "ofxAndroidUtils.h"
 #endif
@@ -24,6 +27,8 @@ static const string COLOR_ATTRIBUTE="color";
 static const string POSITION_ATTRIBUTE="position";
 static const string NORMAL_ATTRIBUTE="normal";
 static const string TEXCOORD_ATTRIBUTE="texcoord";
+static const string MATRICES_BLOCK="ofMatrices";
+static const string MATERIAL_BLOCK="ofMaterialBlock";
 
 static map<GLuint,int> & getShaderIds(){
 	static map<GLuint,int> * ids = new map<GLuint,int>;
@@ -77,14 +82,112 @@ static void releaseProgram(GLuint id){
 		getProgramIds()[id]--;
 		if(getProgramIds()[id]==0){
 			glDeleteProgram(id);
+			ofGetGLStateCache().deletedProgram(id);
 			getProgramIds().erase(id);
 		}
 	}else{
 		ofLogWarning("ofShader") << "releaseProgram(): something's wrong here, releasing unknown program id " << id;
 		glDeleteProgram(id);
+		ofGetGLStateCache().deletedProgram(id);
 	}
 }
 
+#if (!defined(TARGET_OPENGLES) && defined(glProgramBinary)) || (defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_0))
+	#define OF_SHADER_PROGRAM_BINARY
+#endif
+
+static bool programBinaryCacheEnabled = false;
+static std::filesystem::path programBinaryCacheDirectory;
+
+// header of the files in the binary cache, followed by the binary itself
+struct ProgramBinaryHeader{
+	char magic[4];
+	uint32_t version;
+	uint32_t format;
+	uint64_t hash;
+};
+
+static const char programBinaryMagic[4] = {'O','F','P','B'};
+static const uint32_t programBinaryVersion = 1;
+
+//--------------------------------------------------------------
+static uint64_t programBinaryHash(const string & key){
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for(auto c: key){
+		hash ^= uint8_t(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+//--------------------------------------------------------------
+static bool useProgramBinaryCache(){
+#ifdef OF_SHADER_PROGRAM_BINARY
+	if(!programBinaryCacheEnabled) return false;
+	// needs a gl context, checked the first time a shader is set up
+	static bool supported = []{
+#ifndef TARGET_OPENGLES
+		if(!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)) return false;
+#endif
+		GLint numFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+		if(numFormats == 0){
+			ofLogWarning("ofShader") << "the driver doesn't support any program binary format, the binary cache is disabled";
+		}
+		return numFormats > 0;
+	}();
+	return supported;
+#else
+	return false;
+#endif
+}
+
+//--------------------------------------------------------------
+static string programBinaryPath(const string & key){
+	return (programBinaryCacheDirectory / (key + ".bin")).string();
+}
+
+//--------------------------------------------------------------
+static bool parallelShaderCompileSupported(){
+	// needs a gl context, checked the first time a shader is loaded async
+	static bool supported = []{
+#if defined(GLEW_KHR_parallel_shader_compile)
+		if(GLEW_KHR_parallel_shader_compile){
+			// as many threads as the driver wants to use
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+			return true;
+		}
+#endif
+#if defined(GLEW_ARB_parallel_shader_compile)
+		if(GLEW_ARB_parallel_shader_compile){
+			glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+			return true;
+		}
+#endif
+#if defined(TARGET_OPENGLES) && defined(GL_COMPLETION_STATUS_KHR)
+		return ofGLCheckExtension("GL_KHR_parallel_shader_compile");
+#else
+		return false;
+#endif
+	}();
+	return supported;
+}
+
+struct ofShader::AsyncLoad{
+	~AsyncLoad(){
+		// discarded before finishing, unload() only releases the program
+		// and shaders of a loaded shader
+		if(!finished){
+			shader.bLoaded = true;
+		}
+	}
+
+	ofShader shader;
+	ofShader * owner = nullptr;
+	bool finished = false;
+};
+
 #ifndef TARGET_OPENGLES
 //--------------------------------------------------------------
 ofShader::TransformFeedbackRangeBinding::TransformFeedbackRangeBinding(const ofBufferObject & buffer, GLuint offset, GLuint size)
@@ -116,9 +219,14 @@ ofShader::ofShader(const ofShader & mom)
 	,shaders(mom.shaders)
 	,uniformsCache(mom.uniformsCache)
 	,attributesBindingsCache(mom.attributesBindingsCache)
+	,linkParameters(mom.linkParameters)
+	,uniformValues(mom.uniformValues)
   #ifndef TARGET_OPENGLES
 	,uniformBlocksCache(mom.uniformBlocksCache)
   #endif
+  #if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	,shaderStorageBlocksCache(mom.shaderStorageBlocksCache)
+  #endif
 {
 	if(mom.bLoaded){
 		retainProgram(program);
@@ -145,6 +253,11 @@ ofShader & ofShader::operator=(const ofShader & mom){
 	shaders = mom.shaders;
 	attributesBindingsCache = mom.attributesBindingsCache;
 	uniformsCache = mom.uniformsCache;
+	linkParameters = mom.linkParameters;
+	uniformValues = mom.uniformValues;
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	shaderStorageBlocksCache = mom.shaderStorageBlocksCache;
+#endif
 	if(mom.bLoaded){
 		retainProgram(program);
 		for(auto it: shaders){
@@ -163,7 +276,17 @@ ofShader::ofShader(ofShader && mom)
 	,bLoaded(std::move(mom.bLoaded))
 	,shaders(std::move(mom.shaders))
 	,uniformsCache(std::move(mom.uniformsCache))
-	,attributesBindingsCache(std::move(mom.attributesBindingsCache)){
+	,attributesBindingsCache(std::move(mom.attributesBindingsCache))
+	,linkParameters(std::move(mom.linkParameters))
+	,uniformValues(std::move(mom.uniformValues))
+  #if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	,shaderStorageBlocksCache(std::move(mom.shaderStorageBlocksCache))
+  #endif
+	,asyncLoad(std::move(mom.asyncLoad))
+{
+	if(asyncLoad){
+		asyncLoad->owner = this;
+	}
 	if(mom.bLoaded){
 #ifdef TARGET_ANDROID
 		ofAddListener(ofxAndroidEvents().unloadGL,this,&ofShader::unloadGL);
@@ -184,6 +307,15 @@ ofShader & ofShader::operator=(ofShader && mom){
 	shaders = std::move(mom.shaders);
 	attributesBindingsCache = std::move(mom.attributesBindingsCache);
 	uniformsCache = std::move(mom.uniformsCache);
+	linkParameters = std::move(mom.linkParameters);
+	uniformValues = std::move(mom.uniformValues);
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	shaderStorageBlocksCache = std::move(mom.shaderStorageBlocksCache);
+#endif
+	asyncLoad = std::move(mom.asyncLoad);
+	if(asyncLoad){
+		asyncLoad->owner = this;
+	}
 	if(mom.bLoaded){
 #ifdef TARGET_ANDROID
 		ofAddListener(ofxAndroidEvents().unloadGL,this,&ofShader::unloadGL);
@@ -249,6 +381,134 @@ bool ofShader::setup(const Settings & settings) {
 	return linkProgram();
 }
 
+//--------------------------------------------------------------
+bool ofShader::setupAsync(const Settings & settings) {
+	auto load = std::make_shared<AsyncLoad>();
+	load->shader.asyncLink = true;
+	return load->shader.setup(settings) && startAsyncLoad(load);
+}
+
+//--------------------------------------------------------------
+bool ofShader::loadAsync(const std::filesystem::path& shaderName) {
+	return loadAsync(shaderName.string() + ".vert", shaderName.string() + ".frag");
+}
+
+//--------------------------------------------------------------
+bool ofShader::loadAsync(const std::filesystem::path& vertName, const std::filesystem::path& fragName, const std::filesystem::path& geomName) {
+	auto load = std::make_shared<AsyncLoad>();
+	load->shader.asyncLink = true;
+	return load->shader.load(vertName, fragName, geomName) && startAsyncLoad(load);
+}
+
+//--------------------------------------------------------------
+bool ofShader::isLoading() const{
+	return asyncLoad != nullptr;
+}
+
+//--------------------------------------------------------------
+bool ofShader::startAsyncLoad(const std::shared_ptr<AsyncLoad> & load){
+	// replaces any load still pending, its poll finds it expired
+	load->owner = this;
+	asyncLoad = load;
+	pollAsyncLoad(load);
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofShader::pollAsyncLoad(std::weak_ptr<AsyncLoad> weakLoad){
+	ofTaskPool::runOnMainThread([weakLoad]{
+		auto load = weakLoad.lock();
+		if(!load) return;
+		if(!load->shader.isAsyncLinkFinished()){
+			pollAsyncLoad(weakLoad);
+			return;
+		}
+		ofShader * owner = load->owner;
+		bool linked = load->shader.finishAsyncLink();
+		load->finished = true;
+		if(linked){
+			// releases the old program, uniforms have to be set again
+			*owner = std::move(load->shader);
+		}
+		owner->asyncLoad.reset();
+		ofNotifyEvent(owner->loadedEvent, linked, owner);
+	});
+}
+
+//--------------------------------------------------------------
+bool ofShader::startAsyncLink(){
+	checkAndCreateProgram();
+
+	if(useProgramBinaryCache()){
+		asyncBinaryKey = getProgramBinaryKey();
+		asyncFromBinary = loadProgramBinary(asyncBinaryKey);
+		if(asyncFromBinary){
+			return true;
+		}
+	}
+
+	// nothing is queried until the driver is done, querying the status
+	// now would wait for the compiler
+	parallelShaderCompileSupported();
+	for(auto & it: shaders){
+		if(it.second.id == 0 && !startCompileShader(it.first)) {
+			return false;
+		}
+	}
+	for(auto & it: shaders){
+		glAttachShader(program, it.second.id);
+	}
+#ifdef OF_SHADER_PROGRAM_BINARY
+	if(!asyncBinaryKey.empty()){
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+#endif
+	glLinkProgram(program);
+	return true;
+}
+
+//--------------------------------------------------------------
+bool ofShader::isAsyncLinkFinished() const{
+	if(asyncFromBinary || !parallelShaderCompileSupported()){
+		return true;
+	}
+#if defined(GL_COMPLETION_STATUS_KHR)
+	GLint completed = GL_FALSE;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+	return completed == GL_TRUE;
+#elif defined(GL_COMPLETION_STATUS_ARB)
+	GLint completed = GL_FALSE;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_ARB, &completed);
+	return completed == GL_TRUE;
+#else
+	return true;
+#endif
+}
+
+//--------------------------------------------------------------
+bool ofShader::finishAsyncLink(){
+	bool linked = asyncFromBinary;
+	if(!linked){
+		linked = true;
+		for(auto & it: shaders){
+			linked &= checkShaderCompileStatus(it.first);
+		}
+		linked = linked && checkProgramLinkStatus();
+		if(linked && !asyncBinaryKey.empty()){
+			saveProgramBinary(asyncBinaryKey);
+		}
+	}
+	// unload() only releases the program and shaders of a loaded shader
+	bLoaded = true;
+	if(!linked){
+		unload();
+		return false;
+	}
+	cacheActiveResources();
+	asyncLink = false;
+	return true;
+}
+
 #if !defined(TARGET_OPENGLES)
 //--------------------------------------------------------------
 bool ofShader::setup(const TransformFeedbackSettings & settings) {
@@ -284,6 +544,7 @@ bool ofShader::setup(const TransformFeedbackSettings & settings) {
 			return str.c_str();
 		});
 		glTransformFeedbackVaryings(getProgram(), varyings.size(), varyings.data(), settings.bufferMode);
+		linkParameters += "varyings " + ofToString(settings.bufferMode) + " " + ofJoinString(settings.varyingsToCapture, " ") + "\n";
 	}
 	return linkProgram();
 }
@@ -336,20 +597,6 @@ bool ofShader::setupShaderFromSource(ofShader::Source && source){
 		ofLogVerbose("ofShader") << "setupShaderFromSource(): OpenGL error after checkAndCreateProgram() (probably harmless): error " << clearErrors;
 	}
 
-	// create shader
-	GLuint shaderId = glCreateShader(source.type);
-	if(shaderId == 0) {
-		ofLogError("ofShader") << "setupShaderFromSource(): failed creating " << nameForType(source.type) << " shader";
-		return false;
-	} else {
-		// if the shader object has been allocated successfully on the GPU
-		// we must retain it so that it can be de-allocated again, once
-		// this ofShader object has been discarded, or re-allocated.
-		// we need to do this at this point in the code path, since early
-		// return statements might prevent us from retaining later.
-		retainShader(shaderId);
-	}
-
 	// parse for includes
 	source.expandedSource = parseForIncludes( source.source, source.directoryPath );
 
@@ -372,37 +619,182 @@ bool ofShader::setupShaderFromSource(ofShader::Source && source){
 	// we need to store this here, and before shader compilation,
 	// so that any shader compilation errors can be
 	// traced down to the correct shader source code line.
-	shaders[source.type] = { shaderId, std::move(source) };
-	auto & shader = shaders[source.type];
+	GLenum type = source.type;
+	shaders[type] = { 0, std::move(source) };
+
+	// with the binary cache the shaders are only compiled when linking
+	// and only if the program isn't in the cache, async links compile
+	// them all at once without waiting for each one
+	if(useProgramBinaryCache() || asyncLink){
+		return true;
+	}
+	return compileShader(type);
+}
+
+//--------------------------------------------------------------
+bool ofShader::compileShader(GLenum type){
+	return startCompileShader(type) && checkShaderCompileStatus(type);
+}
+
+//--------------------------------------------------------------
+bool ofShader::startCompileShader(GLenum type){
+	auto & shader = shaders[type];
+
+	// create shader
+	GLuint shaderId = glCreateShader(type);
+	if(shaderId == 0) {
+		ofLogError("ofShader") << "setupShaderFromSource(): failed creating " << nameForType(type) << " shader";
+		shaders.erase(type);
+		return false;
+	} else {
+		// if the shader object has been allocated successfully on the GPU
+		// we must retain it so that it can be de-allocated again, once
+		// this ofShader object has been discarded, or re-allocated.
+		// we need to do this at this point in the code path, since early
+		// return statements might prevent us from retaining later.
+		retainShader(shaderId);
+		shader.id = shaderId;
+	}
 
 	// compile shader
 	const char* sptr = shader.source.expandedSource.c_str();
 	int ssize = shader.source.expandedSource.size();
 	glShaderSource(shaderId, 1, &sptr, &ssize);
 	glCompileShader(shaderId);
+	return true;
+}
 
-	// check compile status
+//--------------------------------------------------------------
+bool ofShader::checkShaderCompileStatus(GLenum type){
+	GLuint shaderId = shaders[type].id;
 	GLint status = GL_FALSE;
 	glGetShaderiv(shaderId, GL_COMPILE_STATUS, &status);
 	GLuint err = glGetError();
 	if (err != GL_NO_ERROR){
-		ofLogError("ofShader") << "setupShaderFromSource(): OpenGL generated error " << err << " trying to get the compile status for a " << nameForType(shader.source.type) << " shader, does your video card support this?";
+		ofLogError("ofShader") << "setupShaderFromSource(): OpenGL generated error " << err << " trying to get the compile status for a " << nameForType(type) << " shader, does your video card support this?";
 		return false;
 	}
 
 	if(status == GL_TRUE){
-		ofLogVerbose("ofShader") << "setupShaderFromSource(): " << nameForType(shader.source.type) + " shader compiled";
+		ofLogVerbose("ofShader") << "setupShaderFromSource(): " << nameForType(type) + " shader compiled";
 #ifdef TARGET_EMSCRIPTEN
-		checkShaderInfoLog(shaderId, source.type, OF_LOG_VERBOSE);
+		checkShaderInfoLog(shaderId, type, OF_LOG_VERBOSE);
 #else
-		checkShaderInfoLog(shaderId, source.type, OF_LOG_WARNING);
+		checkShaderInfoLog(shaderId, type, OF_LOG_WARNING);
 #endif
 	}else if (status == GL_FALSE) {
-		ofLogError("ofShader") << "setupShaderFromSource(): " << nameForType(shader.source.type) + " shader failed to compile";
-		checkShaderInfoLog(shaderId, source.type, OF_LOG_ERROR);
+		ofLogError("ofShader") << "setupShaderFromSource(): " << nameForType(type) + " shader failed to compile";
+		checkShaderInfoLog(shaderId, type, OF_LOG_ERROR);
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofShader::enableProgramBinaryCache(const std::filesystem::path & directory){
+	programBinaryCacheDirectory = ofToDataPath(directory, true);
+	programBinaryCacheEnabled = true;
+}
+
+//--------------------------------------------------------------
+void ofShader::disableProgramBinaryCache(){
+	programBinaryCacheEnabled = false;
+}
+
+//--------------------------------------------------------------
+bool ofShader::isProgramBinaryCacheEnabled(){
+	return programBinaryCacheEnabled;
+}
+
+//--------------------------------------------------------------
+string ofShader::getProgramBinaryKey() const{
+	auto glString = [](GLenum name){
+		auto str = reinterpret_cast<const char*>(glGetString(name));
+		return string(str ? str : "");
+	};
+	// everything that changes the linked program, in a stable order
+	string key = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION) + "\n" + glString(GL_SHADING_LANGUAGE_VERSION) + "\n";
+	map<GLenum, const Shader*> sortedShaders;
+	for(auto & shader: shaders){
+		sortedShaders[shader.first] = &shader.second;
+	}
+	for(auto & shader: sortedShaders){
+		key += nameForType(shader.first) + "\n" + shader.second->source.expandedSource + "\n";
+	}
+	map<string, GLint> sortedBindings(attributesBindingsCache.begin(), attributesBindingsCache.end());
+	for(auto & binding: sortedBindings){
+		key += "attribute " + binding.first + " " + ofToString(binding.second) + "\n";
+	}
+	key += linkParameters;
+
+	std::stringstream hex;
+	hex << std::hex << std::setw(16) << std::setfill('0') << programBinaryHash(key);
+	return hex.str();
+}
+
+//--------------------------------------------------------------
+bool ofShader::loadProgramBinary(const string & key){
+#ifdef OF_SHADER_PROGRAM_BINARY
+	auto path = programBinaryPath(key);
+	if(!ofFile::doesFileExist(path, false)) return false;
+
+	ofBuffer buffer = ofBufferFromFile(path, true);
+	ProgramBinaryHeader header;
+	if(buffer.size() <= sizeof(header)) return false;
+	memcpy(&header, buffer.getData(), sizeof(header));
+	if(memcmp(header.magic, programBinaryMagic, 4) != 0 || header.version != programBinaryVersion || header.hash != programBinaryHash(key)){
 		return false;
 	}
+
+	while(glGetError() != GL_NO_ERROR);
+	glProgramBinary(program, header.format, buffer.getData() + sizeof(header), buffer.size() - sizeof(header));
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if(glGetError() != GL_NO_ERROR || status != GL_TRUE){
+		// usually a driver update, the program is compiled again
+		ofLogVerbose("ofShader") << "loadProgramBinary(): the driver rejected the cached binary " << path << ", compiling from source";
+		return false;
+	}
+	ofLogVerbose("ofShader") << "loadProgramBinary(): program " << program << " loaded from " << path;
 	return true;
+#else
+	return false;
+#endif
+}
+
+//--------------------------------------------------------------
+void ofShader::saveProgramBinary(const string & key){
+#ifdef OF_SHADER_PROGRAM_BINARY
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if(length <= 0) return;
+
+	ProgramBinaryHeader header;
+	memcpy(header.magic, programBinaryMagic, 4);
+	header.version = programBinaryVersion;
+	header.hash = programBinaryHash(key);
+
+	vector<char> data(sizeof(header) + length);
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &written, &format, data.data() + sizeof(header));
+	if(written <= 0) return;
+	header.format = format;
+	memcpy(data.data(), &header, sizeof(header));
+
+	if(!ofDirectory::doesDirectoryExist(programBinaryCacheDirectory, false)){
+		ofDirectory::createDirectory(programBinaryCacheDirectory, false, true);
+	}
+	// write to a temporary file first so a crash can't leave a half written binary
+	auto path = programBinaryPath(key);
+	auto tmpPath = path + ".tmp";
+	ofBuffer buffer(data.data(), sizeof(header) + written);
+	if(!ofBufferToFile(tmpPath, buffer, true)){
+		ofLogWarning("ofShader") << "saveProgramBinary(): couldn't write " << tmpPath;
+		return;
+	}
+	ofFile::moveFromTo(tmpPath, path, false, true);
+#endif
 }
 
 /*
@@ -516,6 +908,7 @@ void ofShader::setGeometryInputType(GLenum type) {
 #ifndef TARGET_OPENGLES
 	checkAndCreateProgram();
 	glProgramParameteri(program, GL_GEOMETRY_INPUT_TYPE_EXT, type);
+	linkParameters += "geometryInputType " + ofToString(type) + "\n";
 #endif
 }
 
@@ -524,6 +917,7 @@ void ofShader::setGeometryOutputType(GLenum type) {
 #ifndef TARGET_OPENGLES
 	checkAndCreateProgram();
 	glProgramParameteri(program, GL_GEOMETRY_OUTPUT_TYPE_EXT, type);
+	linkParameters += "geometryOutputType " + ofToString(type) + "\n";
 #endif
 }
 
@@ -532,6 +926,7 @@ void ofShader::setGeometryOutputCount(int count) {
 #ifndef TARGET_OPENGLES
 	checkAndCreateProgram();
 	glProgramParameteri(program, GL_GEOMETRY_VERTICES_OUT_EXT, count);
+	linkParameters += "geometryOutputCount " + ofToString(count) + "\n";
 #endif
 }
 
@@ -652,78 +1047,139 @@ void ofShader::checkAndCreateProgram() {
 bool ofShader::linkProgram() {
 	if(shaders.empty()) {
 		ofLogError("ofShader") << "linkProgram(): trying to link GLSL program, but no shaders created yet";
+	} else if(asyncLink) {
+		return startAsyncLink();
 	} else {
 		checkAndCreateProgram();
 
-		for(auto it: shaders){
-			auto shader = it.second;
-			if(shader.id>0) {
-				ofLogVerbose("ofShader") << "linkProgram(): attaching " << nameForType(it.first) << " shader to program " << program;
-				glAttachShader(program, shader.id);
-			}
+		string binaryKey;
+		bool fromBinary = false;
+		if(useProgramBinaryCache()){
+			binaryKey = getProgramBinaryKey();
+			fromBinary = loadProgramBinary(binaryKey);
 		}
 
-		glLinkProgram(program);
+		if(!fromBinary){
+			// compile the shaders that were waiting for the binary cache
+			for(auto & it: shaders){
+				if(it.second.id == 0 && !compileShader(it.first)) {
+					return false;
+				}
+			}
+
+			for(auto it: shaders){
+				auto shader = it.second;
+				if(shader.id>0) {
+					ofLogVerbose("ofShader") << "linkProgram(): attaching " << nameForType(it.first) << " shader to program " << program;
+					glAttachShader(program, shader.id);
+				}
+			}
+
+#ifdef OF_SHADER_PROGRAM_BINARY
+			if(!binaryKey.empty()){
+				glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
+#endif
+			glLinkProgram(program);
 
-		checkProgramLinkStatus();
+			if(checkProgramLinkStatus() && !binaryKey.empty()){
+				saveProgramBinary(binaryKey);
+			}
+		}
 
+		cacheActiveResources();
+	}
+	return bLoaded;
+}
 
-		// Pre-cache all active uniforms
-		GLint numUniforms = 0;
-		glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
+//--------------------------------------------------------------
+void ofShader::cacheActiveResources(){
+	// Pre-cache all active uniforms
+	GLint numUniforms = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
 
-		GLint uniformMaxLength = 0;
-		glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &uniformMaxLength);
+	GLint uniformMaxLength = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &uniformMaxLength);
 
-		GLint count = -1;
-		GLenum type = 0;
-		GLsizei length;
-		GLint location;
-		vector<GLchar> uniformName(uniformMaxLength);
-		for(GLint i = 0; i < numUniforms; i++) {
-			glGetActiveUniform(program, i, uniformMaxLength, &length, &count, &type, uniformName.data());
-			string name(uniformName.begin(), uniformName.begin()+length);
-			// some drivers return uniform_name[0] for array uniforms
-			// instead of the real uniform name
-			location = glGetUniformLocation(program, name.c_str());
-			if (location == -1) continue; // ignore uniform blocks
+	GLint count = -1;
+	GLenum type = 0;
+	GLsizei length;
+	GLint location;
+	GLint numLocations = 0;
+	vector<GLchar> uniformName(uniformMaxLength);
+	for(GLint i = 0; i < numUniforms; i++) {
+		glGetActiveUniform(program, i, uniformMaxLength, &length, &count, &type, uniformName.data());
+		string name(uniformName.begin(), uniformName.begin()+length);
+		// some drivers return uniform_name[0] for array uniforms
+		// instead of the real uniform name
+		location = glGetUniformLocation(program, name.c_str());
+		if (location == -1) continue; // ignore uniform blocks
+		numLocations = std::max(numLocations, location + count);
 
+		uniformsCache[name] = location;
+		auto arrayPos = name.find('[');
+		if(arrayPos!=std::string::npos){
+			name = name.substr(0, arrayPos);
 			uniformsCache[name] = location;
-			auto arrayPos = name.find('[');
-			if(arrayPos!=std::string::npos){
-				name = name.substr(0, arrayPos);
-				uniformsCache[name] = location;
-			}
 		}
+	}
+
+	// linking resets all the uniforms. locations are usually
+	// consecutive, the ones past a sane maximum just aren't remembered
+	if(!uniformValues){
+		uniformValues = std::make_shared<vector<UniformValue>>();
+	}
+	uniformValues->assign(std::min(numLocations, 4096), UniformValue());
 
 #ifndef TARGET_OPENGLES
 #ifdef GLEW_ARB_uniform_buffer_object
-		if(GLEW_ARB_uniform_buffer_object) {
-			// Pre-cache all active uniforms blocks
-			GLint numUniformBlocks = 0;
-			glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &numUniformBlocks);
-
-			count = -1;
-			type = 0;
-			vector<GLchar> uniformBlockName(uniformMaxLength);
-			for(GLint i = 0; i < numUniformBlocks; i++) {
-				glGetActiveUniformBlockName(program, i, uniformMaxLength, &length, uniformBlockName.data() );
-				string name(uniformBlockName.begin(), uniformBlockName.begin()+length);
-				uniformBlocksCache[name] = glGetUniformBlockIndex(program, name.c_str());
+	if(GLEW_ARB_uniform_buffer_object) {
+		// Pre-cache all active uniforms blocks
+		GLint numUniformBlocks = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &numUniformBlocks);
+
+		count = -1;
+		type = 0;
+		vector<GLchar> uniformBlockName(uniformMaxLength);
+		for(GLint i = 0; i < numUniformBlocks; i++) {
+			glGetActiveUniformBlockName(program, i, uniformMaxLength, &length, uniformBlockName.data() );
+			string name(uniformBlockName.begin(), uniformBlockName.begin()+length);
+			uniformBlocksCache[name] = glGetUniformBlockIndex(program, name.c_str());
+			if(name == MATRICES_BLOCK){
+				glUniformBlockBinding(program, uniformBlocksCache[name], MATRICES_BLOCK_BINDING);
+			}else if(name == MATERIAL_BLOCK){
+				glUniformBlockBinding(program, uniformBlocksCache[name], MATERIAL_BLOCK_BINDING);
 			}
 		}
+	}
 #endif
 #endif
 
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	if(glShaderStorageBlockBinding) {
+		// Pre-cache all active shader storage blocks
+		GLint numStorageBlocks = 0;
+		glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &numStorageBlocks);
+
+		GLint storageBlockMaxLength = 0;
+		glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK, GL_MAX_NAME_LENGTH, &storageBlockMaxLength);
+
+		vector<GLchar> storageBlockName(storageBlockMaxLength);
+		for(GLint i = 0; i < numStorageBlocks; i++) {
+			glGetProgramResourceName(program, GL_SHADER_STORAGE_BLOCK, i, storageBlockMaxLength, &length, storageBlockName.data());
+			string name(storageBlockName.begin(), storageBlockName.begin()+length);
+			shaderStorageBlocksCache[name] = i;
+		}
+	}
+#endif
+
 #ifdef TARGET_ANDROID
-		ofAddListener(ofxAndroidEvents().unloadGL,this,&ofShader::unloadGL);
+	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofShader::unloadGL);
 #endif
 
-		// bLoaded means we have loaded shaders onto the graphics card;
-		// it doesn't necessarily mean that these shaders have compiled and linked successfully.
-		bLoaded = true;
-	}
-	return bLoaded;
+	// bLoaded means we have loaded shaders onto the graphics card;
+	// it doesn't necessarily mean that these shaders have compiled and linked successfully.
+	bLoaded = true;
 }
 
 
@@ -754,6 +1210,9 @@ void ofShader::reloadGL(){
 #ifdef GLEW_ARB_uniform_buffer_object // Core in OpenGL 3.1
 	uniformBlocksCache.clear();
 #endif
+#endif
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	shaderStorageBlocksCache.clear();
 #endif
 	attributesBindingsCache.clear();
 	for(auto & shader: source){
@@ -810,14 +1269,22 @@ void ofShader::unload() {
 #ifdef GLEW_ARB_uniform_buffer_object // Core in OpenGL 3.1
 		uniformBlocksCache.clear();
 #endif
+#endif
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+		shaderStorageBlocksCache.clear();
 #endif
 		attributesBindingsCache.clear();
+		linkParameters.clear();
+		uniformValues.reset();
+		asyncFromBinary = false;
+		asyncBinaryKey.clear();
 #ifdef TARGET_ANDROID
 		ofRemoveListener(ofxAndroidEvents().reloadGL,this,&ofShader::reloadGL);
 		ofRemoveListener(ofxAndroidEvents().unloadGL,this,&ofShader::unloadGL);
 #endif
 	}
 	bLoaded = false;
+	asyncLoad.reset();
 }
 
 //--------------------------------------------------------------
@@ -910,6 +1377,80 @@ void ofShader::endTransformFeedback(const std::vector<TransformFeedbackBaseBindi
 void ofShader::dispatchCompute(GLuint x, GLuint y, GLuint z) const{
 	glDispatchCompute(x,y,z);
 }
+
+//--------------------------------------------------------------
+void ofShader::dispatchComputeIndirect(const ofBufferObject & buffer, GLintptr offset) const{
+	buffer.bind(GL_DISPATCH_INDIRECT_BUFFER);
+	glDispatchComputeIndirect(offset);
+	buffer.unbind(GL_DISPATCH_INDIRECT_BUFFER);
+}
+
+//--------------------------------------------------------------
+void ofShader::dispatchComputeForSize(GLuint width, GLuint height, GLuint depth) const{
+	glm::ivec3 groupSize = getComputeWorkGroupSize();
+	if(groupSize.x == 0 || groupSize.y == 0 || groupSize.z == 0){
+		ofLogError("ofShader") << "dispatchComputeForSize(): the program doesn't have a compute shader";
+		return;
+	}
+	glDispatchCompute((width + groupSize.x - 1) / groupSize.x,
+	                  (height + groupSize.y - 1) / groupSize.y,
+	                  (depth + groupSize.z - 1) / groupSize.z);
+}
+
+//--------------------------------------------------------------
+glm::ivec3 ofShader::getComputeWorkGroupSize() const{
+	glm::ivec3 size(0);
+	if(bLoaded && shaders.find(GL_COMPUTE_SHADER) != shaders.end()){
+		glGetProgramiv(program, GL_COMPUTE_WORK_GROUP_SIZE, &size.x);
+	}
+	return size;
+}
+#endif
+
+#if !defined(TARGET_OPENGLES) && defined(glMemoryBarrier)
+//--------------------------------------------------------------
+void ofShader::memoryBarrier(GLbitfield barriers){
+	glMemoryBarrier(barriers);
+}
+#endif
+
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+//--------------------------------------------------------------
+GLint ofShader::getShaderStorageBlockIndex(const string & name) const{
+	if(!bLoaded) return -1;
+	auto it = shaderStorageBlocksCache.find(name);
+	if (it == shaderStorageBlocksCache.end()){
+		return -1;
+	} else {
+		return it->second;
+	}
+}
+
+//--------------------------------------------------------------
+void ofShader::setShaderStorageBuffer(const string & name, const ofBufferObject & buffer, GLuint binding) const{
+	GLint index = getShaderStorageBlockIndex(name);
+	if(index == -1) return;
+	glShaderStorageBlockBinding(program, index, binding);
+	buffer.bindBase(GL_SHADER_STORAGE_BUFFER, binding);
+}
+
+//--------------------------------------------------------------
+void ofShader::setShaderStorageBuffer(const string & name, const ofBufferObject & buffer, GLuint binding, GLintptr offset, GLsizeiptr size) const{
+	GLint index = getShaderStorageBlockIndex(name);
+	if(index == -1) return;
+	glShaderStorageBlockBinding(program, index, binding);
+	buffer.bindRange(GL_SHADER_STORAGE_BUFFER, binding, offset, size);
+}
+#endif
+
+#if !defined(TARGET_OPENGLES) && defined(glBindImageTexture)
+//--------------------------------------------------------------
+void ofShader::setUniformImage(const string & name, ofTexture & texture, int unit, GLenum access, GLint level) const{
+	if(bLoaded) {
+		texture.bindAsImage(unit, access, level);
+		setUniform1i(name, unit);
+	}
+}
 #endif
 
 //--------------------------------------------------------------
@@ -920,16 +1461,16 @@ void ofShader::setUniformTexture(const string & name, const ofBaseHasTexture& im
 //--------------------------------------------------------------
 void ofShader::setUniformTexture(const string & name, int textureTarget, GLint textureID, int textureLocation) const{
 	if(bLoaded) {
-		glActiveTexture(GL_TEXTURE0 + textureLocation);
+		ofGetGLStateCache().activeTexture(GL_TEXTURE0 + textureLocation);
 		if (!ofIsGLProgrammableRenderer()){
 			glEnable(textureTarget);
-			glBindTexture(textureTarget, textureID);
+			ofGetGLStateCache().bindTexture(textureTarget, textureID);
 			glDisable(textureTarget);
 		} else {
-			glBindTexture(textureTarget, textureID);
+			ofGetGLStateCache().bindTexture(textureTarget, textureID);
 		}
 		setUniform1i(name, textureLocation);
-		glActiveTexture(GL_TEXTURE0);
+		ofGetGLStateCache().activeTexture(GL_TEXTURE0);
 	}
 }
 
@@ -937,10 +1478,10 @@ void ofShader::setUniformTexture(const string & name, int textureTarget, GLint t
 void ofShader::setUniformTexture(const string & name, const ofTexture& tex, int textureLocation)  const{
 	if(bLoaded) {
 		ofTextureData texData = tex.getTextureData();
-		glActiveTexture(GL_TEXTURE0 + textureLocation);
+		ofGetGLStateCache().activeTexture(GL_TEXTURE0 + textureLocation);
 		if (!ofIsGLProgrammableRenderer()){
 			glEnable(texData.textureTarget);
-			glBindTexture(texData.textureTarget, texData.textureID);
+			ofGetGLStateCache().bindTexture(texData.textureTarget, texData.textureID);
 #ifndef TARGET_OPENGLES
 			if (texData.bufferId != 0) {
 				glTexBuffer(GL_TEXTURE_BUFFER, texData.glInternalFormat, texData.bufferId);
@@ -948,7 +1489,7 @@ void ofShader::setUniformTexture(const string & name, const ofTexture& tex, int
 #endif
 			glDisable(texData.textureTarget);
 		} else {
-			glBindTexture(texData.textureTarget, texData.textureID);
+			ofGetGLStateCache().bindTexture(texData.textureTarget, texData.textureID);
 #ifndef TARGET_OPENGLES
 			if (texData.bufferId != 0) {
 				glTexBuffer(GL_TEXTURE_BUFFER, texData.glInternalFormat, texData.bufferId);
@@ -956,156 +1497,245 @@ void ofShader::setUniformTexture(const string & name, const ofTexture& tex, int
 #endif
 		}
 		setUniform1i(name, textureLocation);
-		glActiveTexture(GL_TEXTURE0);
+		ofGetGLStateCache().activeTexture(GL_TEXTURE0);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform1i(const string & name, int v1)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform1i(loc, v1);
-	}
+void ofShader::setUniform1i(const string & name, int v1) const{
+	setUniform1i(getUniformLocation(name), v1);
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform2i(const string & name, int v1, int v2)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform2i(loc, v1, v2);
+void ofShader::setUniform2i(const string & name, int v1, int v2) const{
+	setUniform2i(getUniformLocation(name), v1, v2);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform3i(const string & name, int v1, int v2, int v3) const{
+	setUniform3i(getUniformLocation(name), v1, v2, v3);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform4i(const string & name, int v1, int v2, int v3, int v4) const{
+	setUniform4i(getUniformLocation(name), v1, v2, v3, v4);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform1f(const string & name, float v1) const{
+	setUniform1f(getUniformLocation(name), v1);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform2f(const string & name, float v1, float v2) const{
+	setUniform2f(getUniformLocation(name), v1, v2);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform3f(const string & name, float v1, float v2, float v3) const{
+	setUniform3f(getUniformLocation(name), v1, v2, v3);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform4f(const string & name, float v1, float v2, float v3, float v4) const{
+	setUniform4f(getUniformLocation(name), v1, v2, v3, v4);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform2f(const string & name, const glm::vec2 & v) const{
+	setUniform2f(getUniformLocation(name),v.x,v.y);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform3f(const string & name, const glm::vec3 & v) const{
+	setUniform3f(getUniformLocation(name),v.x,v.y,v.z);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform4f(const string & name, const glm::vec4 & v) const{
+	setUniform4f(getUniformLocation(name),v.x,v.y,v.z,v.w);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform4f(const string & name, const ofFloatColor & v) const{
+	setUniform4f(getUniformLocation(name),v.r,v.g,v.b,v.a);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform1iv(const string & name, const int* v, int count) const{
+	setUniform1iv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform2iv(const string & name, const int* v, int count) const{
+	setUniform2iv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform3iv(const string & name, const int* v, int count) const{
+	setUniform3iv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform4iv(const string & name, const int* v, int count) const{
+	setUniform4iv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform1fv(const string & name, const float* v, int count) const{
+	setUniform1fv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform2fv(const string & name, const float* v, int count) const{
+	setUniform2fv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform3fv(const string & name, const float* v, int count) const{
+	setUniform3fv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform4fv(const string & name, const float* v, int count) const{
+	setUniform4fv(getUniformLocation(name), v, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniform1i(GLint location, int v1) const{
+	if(updateUniformValue(location, 1, GL_INT, &v1, sizeof(v1))){
+		glUniform1i(location, v1);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform3i(const string & name, int v1, int v2, int v3)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform3i(loc, v1, v2, v3);
+void ofShader::setUniform2i(GLint location, int v1, int v2) const{
+	int v[] = {v1, v2};
+	if(updateUniformValue(location, 1, GL_INT_VEC2, v, sizeof(v))){
+		glUniform2i(location, v1, v2);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform4i(const string & name, int v1, int v2, int v3, int v4)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) 	glUniform4i(loc, v1, v2, v3, v4);
+void ofShader::setUniform3i(GLint location, int v1, int v2, int v3) const{
+	int v[] = {v1, v2, v3};
+	if(updateUniformValue(location, 1, GL_INT_VEC3, v, sizeof(v))){
+		glUniform3i(location, v1, v2, v3);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform1f(const string & name, float v1)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform1f(loc, v1);
+void ofShader::setUniform4i(GLint location, int v1, int v2, int v3, int v4) const{
+	int v[] = {v1, v2, v3, v4};
+	if(updateUniformValue(location, 1, GL_INT_VEC4, v, sizeof(v))){
+		glUniform4i(location, v1, v2, v3, v4);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform2f(const string & name, float v1, float v2)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform2f(loc, v1, v2);
+void ofShader::setUniform1f(GLint location, float v1) const{
+	if(updateUniformValue(location, 1, GL_FLOAT, &v1, sizeof(v1))){
+		glUniform1f(location, v1);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform3f(const string & name, float v1, float v2, float v3)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform3f(loc, v1, v2, v3);
+void ofShader::setUniform2f(GLint location, float v1, float v2) const{
+	float v[] = {v1, v2};
+	if(updateUniformValue(location, 1, GL_FLOAT_VEC2, v, sizeof(v))){
+		glUniform2f(location, v1, v2);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform4f(const string & name, float v1, float v2, float v3, float v4)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform4f(loc, v1, v2, v3, v4);
+void ofShader::setUniform3f(GLint location, float v1, float v2, float v3) const{
+	float v[] = {v1, v2, v3};
+	if(updateUniformValue(location, 1, GL_FLOAT_VEC3, v, sizeof(v))){
+		glUniform3f(location, v1, v2, v3);
 	}
 }
 
+//--------------------------------------------------------------
+void ofShader::setUniform4f(GLint location, float v1, float v2, float v3, float v4) const{
+	float v[] = {v1, v2, v3, v4};
+	if(updateUniformValue(location, 1, GL_FLOAT_VEC4, v, sizeof(v))){
+		glUniform4f(location, v1, v2, v3, v4);
+	}
+}
 
 //--------------------------------------------------------------
-void ofShader::setUniform2f(const string & name, const glm::vec2 & v) const{
-	setUniform2f(name,v.x,v.y);
+void ofShader::setUniform2f(GLint location, const glm::vec2 & v) const{
+	setUniform2f(location,v.x,v.y);
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform3f(const string & name, const glm::vec3 & v) const{
-	setUniform3f(name,v.x,v.y,v.z);
+void ofShader::setUniform3f(GLint location, const glm::vec3 & v) const{
+	setUniform3f(location,v.x,v.y,v.z);
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform4f(const string & name, const glm::vec4 & v) const{
-	setUniform4f(name,v.x,v.y,v.z,v.w);
+void ofShader::setUniform4f(GLint location, const glm::vec4 & v) const{
+	setUniform4f(location,v.x,v.y,v.z,v.w);
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform4f(const string & name, const ofFloatColor & v) const{
-	setUniform4f(name,v.r,v.g,v.b,v.a);
+void ofShader::setUniform4f(GLint location, const ofFloatColor & v) const{
+	setUniform4f(location,v.r,v.g,v.b,v.a);
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform1iv(const string & name, const int* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform1iv(loc, count, v);
+void ofShader::setUniform1iv(GLint location, const int* v, int count) const{
+	if(updateUniformValue(location, count, GL_INT, v, sizeof(int))){
+		glUniform1iv(location, count, v);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform2iv(const string & name, const int* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform2iv(loc, count, v);
+void ofShader::setUniform2iv(GLint location, const int* v, int count) const{
+	if(updateUniformValue(location, count, GL_INT_VEC2, v, 2 * sizeof(int))){
+		glUniform2iv(location, count, v);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform3iv(const string & name, const int* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform3iv(loc, count, v);
+void ofShader::setUniform3iv(GLint location, const int* v, int count) const{
+	if(updateUniformValue(location, count, GL_INT_VEC3, v, 3 * sizeof(int))){
+		glUniform3iv(location, count, v);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform4iv(const string & name, const int* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform4iv(loc, count, v);
+void ofShader::setUniform4iv(GLint location, const int* v, int count) const{
+	if(updateUniformValue(location, count, GL_INT_VEC4, v, 4 * sizeof(int))){
+		glUniform4iv(location, count, v);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform1fv(const string & name, const float* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform1fv(loc, count, v);
+void ofShader::setUniform1fv(GLint location, const float* v, int count) const{
+	if(updateUniformValue(location, count, GL_FLOAT, v, sizeof(float))){
+		glUniform1fv(location, count, v);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform2fv(const string & name, const float* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform2fv(loc, count, v);
+void ofShader::setUniform2fv(GLint location, const float* v, int count) const{
+	if(updateUniformValue(location, count, GL_FLOAT_VEC2, v, 2 * sizeof(float))){
+		glUniform2fv(location, count, v);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform3fv(const string & name, const float* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform3fv(loc, count, v);
+void ofShader::setUniform3fv(GLint location, const float* v, int count) const{
+	if(updateUniformValue(location, count, GL_FLOAT_VEC3, v, 3 * sizeof(float))){
+		glUniform3fv(location, count, v);
 	}
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniform4fv(const string & name, const float* v, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniform4fv(loc, count, v);
+void ofShader::setUniform4fv(GLint location, const float* v, int count) const{
+	if(updateUniformValue(location, count, GL_FLOAT_VEC4, v, 4 * sizeof(float))){
+		glUniform4fv(location, count, v);
 	}
 }
 
@@ -1135,21 +1765,53 @@ void ofShader::setUniforms(const ofParameterGroup & parameters) const{
 }
 
 //--------------------------------------------------------------
-void ofShader::setUniformMatrix3f(const string & name, const glm::mat3 & m, int count)  const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniformMatrix3fv(loc, count, GL_FALSE, glm::value_ptr(m));
-	}
+void ofShader::setUniformMatrix3f(const string & name, const glm::mat3 & m, int count) const{
+	setUniformMatrix3f(getUniformLocation(name), m, count);
 }
 
 //--------------------------------------------------------------
 void ofShader::setUniformMatrix4f(const string & name, const glm::mat4 & m, int count) const{
-	if(bLoaded) {
-		int loc = getUniformLocation(name);
-		if (loc != -1) glUniformMatrix4fv(loc, count, GL_FALSE, glm::value_ptr(m));
+	setUniformMatrix4f(getUniformLocation(name), m, count);
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniformMatrix3f(GLint location, const glm::mat3 & m, int count) const{
+	if(updateUniformValue(location, count, GL_FLOAT_MAT3, glm::value_ptr(m), sizeof(m))){
+		glUniformMatrix3fv(location, count, GL_FALSE, glm::value_ptr(m));
+	}
+}
+
+//--------------------------------------------------------------
+void ofShader::setUniformMatrix4f(GLint location, const glm::mat4 & m, int count) const{
+	if(updateUniformValue(location, count, GL_FLOAT_MAT4, glm::value_ptr(m), sizeof(m))){
+		glUniformMatrix4fv(location, count, GL_FALSE, glm::value_ptr(m));
 	}
 }
 
+//--------------------------------------------------------------
+bool ofShader::updateUniformValue(GLint location, int count, GLenum type, const void * value, size_t size) const{
+	if(!bLoaded || location == -1) return false;
+	if(!uniformValues || location < 0) return true;
+	auto & values = *uniformValues;
+	if(count != 1){
+		// arrays aren't remembered, forget the values of the locations
+		// they overwrite
+		size_t end = std::min(size_t(location) + size_t(std::max(count, 0)), values.size());
+		for(size_t i = location; i < end; i++){
+			values[i].type = 0;
+		}
+		return true;
+	}
+	if(size_t(location) >= values.size()) return true;
+	auto & current = values[location];
+	if(current.type == type && memcmp(current.value, value, size) == 0){
+		return false;
+	}
+	current.type = type;
+	memcpy(current.value, value, size);
+	return true;
+}
+
 #ifndef TARGET_OPENGLES
 //--------------------------------------------------------------
 void ofShader::setAttribute1s(GLint location, short v1)  const{
@@ -10,6 +10,7 @@
 #include "ofConstants.h"
 #include "ofBaseTypes.h"
 #include "ofLog.h"
+#include "ofEvent.h"
 class ofTexture;
 class ofMatrix3x3;
 class ofParameterGroup;
@@ -101,6 +102,46 @@ public:
 	bool setup(const TransformFeedbackSettings & settings);
 #endif
 
+	/// \brief Compiles and links the shaders without waiting for the driver,
+	/// the current program stays in use until the new one has linked
+	///
+	/// The shaders are sent to the driver right away and checked in the
+	/// following frames from the main thread. When they are ready the new
+	/// program replaces the current one and loadedEvent is notified with
+	/// true, if they fail to compile or link the errors are logged, the
+	/// current program is kept and loadedEvent is notified with false:
+	///
+	/// ~~~~{.cpp}
+	/// void ofApp::setup(){
+	///     shader.load("shader");
+	///     ofAddListener(shader.loadedEvent, this, &ofApp::shaderLoaded);
+	/// }
+	///
+	/// void ofApp::keyPressed(int key){
+	///     // keeps drawing with the old version while the new one compiles
+	///     shader.loadAsync("shader");
+	/// }
+	/// ~~~~
+	///
+	/// With GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile
+	/// the driver compiles on its own threads and the program is swapped
+	/// once it reports completion. Without them the status is queried the
+	/// next frame, which only blocks if the driver hasn't finished by then.
+	///
+	/// Loading again before it finishes replaces the pending load, loading
+	/// synchronously or unloading discards it. Copies of the shader don't
+	/// copy a pending load.
+	bool setupAsync(const Settings & settings);
+	bool loadAsync(const std::filesystem::path& shaderName);
+	bool loadAsync(const std::filesystem::path& vertName, const std::filesystem::path& fragName, const std::filesystem::path& geomName="");
+
+	/// \brief true between setupAsync() or loadAsync() and loadedEvent
+	bool isLoading() const;
+
+	/// \brief Notified in the main thread when an asynchronous load
+	/// finishes, with true if the new program replaced the old one
+	ofEvent<bool> loadedEvent;
+
 	// these are essential to call before linking the program with geometry shaders
 	void setGeometryInputType(GLenum type); // type: GL_POINTS, GL_LINES, GL_LINES_ADJACENCY_EXT, GL_TRIANGLES, GL_TRIANGLES_ADJACENCY_EXT
 	void setGeometryOutputType(GLenum type); // type: GL_POINTS, GL_LINE_STRIP or GL_TRIANGLE_STRIP
@@ -130,7 +171,62 @@ public:
 #endif
 
 #if !defined(TARGET_OPENGLES) && defined(glDispatchCompute)
-	void dispatchCompute(GLuint x, GLuint y, GLuint z) const;
+	/// \brief Runs the compute shader in x * y * z work groups, the shader
+	/// has to be bound with begin()
+	void dispatchCompute(GLuint x, GLuint y = 1, GLuint z = 1) const;
+
+	/// \brief Runs the compute shader with the number of work groups read
+	/// from buffer, 3 GLuint starting at offset
+	void dispatchComputeIndirect(const ofBufferObject & buffer, GLintptr offset = 0) const;
+
+	/// \brief Runs as many work groups as needed so there's one invocation
+	/// for every element in a width * height * depth grid
+	///
+	/// The last work groups can run past the size of the grid when it's not
+	/// a multiple of the work group size, the shader has to skip those.
+	void dispatchComputeForSize(GLuint width, GLuint height = 1, GLuint depth = 1) const;
+
+	/// \brief The work group size declared in the compute shader with
+	/// layout(local_size_x = ..., local_size_y = ..., local_size_z = ...)
+	glm::ivec3 getComputeWorkGroupSize() const;
+#endif
+
+#if !defined(TARGET_OPENGLES) && defined(glMemoryBarrier)
+	/// \brief Makes the writes done by previous shaders to buffers and
+	/// images visible to the commands that read them afterwards
+	///
+	/// barriers is a combination of GL_*_BARRIER_BIT flags for the ways the
+	/// data is read next, eg. GL_SHADER_STORAGE_BARRIER_BIT before another
+	/// compute shader reads the same buffer or GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+	/// before drawing it as a vbo.
+	///
+	/// \sa https://www.opengl.org/sdk/docs/man4/html/glMemoryBarrier.xhtml
+	static void memoryBarrier(GLbitfield barriers = GL_ALL_BARRIER_BITS);
+#endif
+
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	/// \brief Index of the buffer block called name, -1 if the shader
+	/// doesn't have it
+	GLint getShaderStorageBlockIndex(const std::string & name) const;
+
+	/// \brief Binds buffer to binding point and the buffer block called
+	/// name to the same binding point
+	void setShaderStorageBuffer(const std::string & name, const ofBufferObject & buffer, GLuint binding) const;
+
+	/// \brief Binds size bytes of buffer, starting at offset, to binding
+	/// point and the buffer block called name to the same binding point
+	///
+	/// offset has to be a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+	void setShaderStorageBuffer(const std::string & name, const ofBufferObject & buffer, GLuint binding, GLintptr offset, GLsizeiptr size) const;
+#endif
+
+#if !defined(TARGET_OPENGLES) && defined(glBindImageTexture)
+	/// \brief Binds level of texture as an image to unit and sets the image
+	/// uniform called name to that unit
+	///
+	/// access is GL_READ_ONLY, GL_WRITE_ONLY or GL_READ_WRITE, the image is
+	/// accessed with the internal format of the texture.
+	void setUniformImage(const std::string & name, ofTexture & texture, int unit, GLenum access, GLint level = 0) const;
 #endif
 
 	// set a texture reference
@@ -139,6 +235,11 @@ public:
 	void setUniformTexture(const std::string & name, int textureTarget, GLint textureID, int textureLocation) const;
 
 	// set a single uniform value
+	//
+	// values set through these are remembered per location, setting a
+	// uniform to the value it already has doesn't call glUniform. values
+	// set with glUniform directly aren't seen, don't mix both for the
+	// same uniform
 	void setUniform1i(const std::string & name, int v1) const;
 	void setUniform2i(const std::string & name, int v1, int v2) const;
 	void setUniform3i(const std::string & name, int v1, int v2, int v3) const;
@@ -173,6 +274,50 @@ public:
 
 	GLint getUniformLocation(const std::string & name) const;
 
+	/// \name Uniforms by Location
+	/// The same setters taking a location from getUniformLocation(). Look
+	/// the location up once after loading the shader and keep it, so
+	/// there's no search by name on every call. Locations are only valid
+	/// until the shader is linked again.
+	///
+	/// ~~~~{.cpp}
+	/// // setup
+	/// timeLocation = shader.getUniformLocation("time");
+	/// // draw
+	/// shader.setUniform1f(timeLocation, ofGetElapsedTimef());
+	/// ~~~~
+	/// \{
+
+	void setUniform1i(GLint location, int v1) const;
+	void setUniform2i(GLint location, int v1, int v2) const;
+	void setUniform3i(GLint location, int v1, int v2, int v3) const;
+	void setUniform4i(GLint location, int v1, int v2, int v3, int v4) const;
+
+	void setUniform1f(GLint location, float v1) const;
+	void setUniform2f(GLint location, float v1, float v2) const;
+	void setUniform3f(GLint location, float v1, float v2, float v3) const;
+	void setUniform4f(GLint location, float v1, float v2, float v3, float v4) const;
+
+	void setUniform2f(GLint location, const glm::vec2 & v) const;
+	void setUniform3f(GLint location, const glm::vec3 & v) const;
+	void setUniform4f(GLint location, const glm::vec4 & v) const;
+	void setUniform4f(GLint location, const ofFloatColor & v) const;
+
+	void setUniform1iv(GLint location, const int* v, int count = 1) const;
+	void setUniform2iv(GLint location, const int* v, int count = 1) const;
+	void setUniform3iv(GLint location, const int* v, int count = 1) const;
+	void setUniform4iv(GLint location, const int* v, int count = 1) const;
+
+	void setUniform1fv(GLint location, const float* v, int count = 1) const;
+	void setUniform2fv(GLint location, const float* v, int count = 1) const;
+	void setUniform3fv(GLint location, const float* v, int count = 1) const;
+	void setUniform4fv(GLint location, const float* v, int count = 1) const;
+
+	void setUniformMatrix3f(GLint location, const glm::mat3 & m, int count = 1) const;
+	void setUniformMatrix4f(GLint location, const glm::mat4 & m, int count = 1) const;
+
+	/// \}
+
 	// set attributes that vary per vertex (look up the location before glBegin)
 	GLint getAttributeLocation(const std::string & name) const;
 
@@ -225,6 +370,28 @@ public:
 	// links program with all compiled shaders
 	bool linkProgram();
 
+	/// \brief Saves the linked programs to directory and loads them from
+	/// there the next time the same shaders are set up, instead of
+	/// compiling them again
+	///
+	/// Programs are found by a hash of their sources, after includes and
+	/// defines, their attribute bindings and the GL vendor, renderer and
+	/// version, so updating the driver invalidates the cache. If there's no
+	/// binary for a program or the driver rejects it, the program is compiled
+	/// from source and its binary saved again.
+	///
+	/// With the cache enabled shaders are compiled in linkProgram() instead
+	/// of setupShaderFromSource(), so compile errors are reported there, and
+	/// getShader() returns 0 for programs that were loaded from the cache.
+	///
+	/// Needs OpenGL 4.1 or ARB_get_program_binary, or OpenGL ES 3, it's
+	/// ignored otherwise.
+	///
+	/// \param directory folder for the binaries, relative to the data folder
+	static void enableProgramBinaryCache(const std::filesystem::path & directory = "shadercache");
+	static void disableProgramBinaryCache();
+	static bool isProgramBinaryCacheEnabled();
+
 	// binds default uniforms and attributes, only useful for
 	// fixed pipeline simulation under programmable renderer
 	// has to be called before linking
@@ -246,6 +413,32 @@ public:
 		INDEX_ATTRIBUTE  // usually not used except for compute shades
 	};
 
+	/// \brief Binding point of the ofMatrices uniform block
+	///
+	/// Shaders that declare this block instead of the separate matrix
+	/// uniforms are bound to it when linked. The programmable renderer
+	/// updates the block once when the matrices change instead of setting
+	/// 4 uniforms in every shader it binds:
+	///
+	/// ~~~~{.glsl}
+	/// layout(std140) uniform ofMatrices{
+	///     mat4 modelViewMatrix;
+	///     mat4 projectionMatrix;
+	///     mat4 textureMatrix;
+	///     mat4 modelViewProjectionMatrix;
+	///     mat4 viewMatrix;
+	/// };
+	/// ~~~~
+	static const GLuint MATRICES_BLOCK_BINDING = 15;
+
+	/// \brief Binding point of the ofMaterialBlock uniform block
+	///
+	/// ofMaterial shaders declare the material colors in this block when
+	/// uniform buffers are available, each material keeps its values in
+	/// its own buffer and binds it instead of setting the uniforms every
+	/// time it's used.
+	static const GLuint MATERIAL_BLOCK_BINDING = 14;
+
 	/// @brief returns the shader source as it was passed to the GLSL compiler
 	/// @param type (GL_VERTEX_SHADER | GL_FRAGMENT_SHADER | GL_GEOMETRY_SHADER_EXT) the shader source you'd like to inspect.
 	std::string getShaderSource(GLenum type) const;
@@ -264,11 +457,33 @@ private:
 	std::unordered_map<std::string, GLint> uniformsCache;
 	mutable std::unordered_map<std::string, GLint> attributesBindingsCache;
 
+	// program parameters set before linking, part of the binary cache key
+	std::string linkParameters;
+
+	// last value set to every location of the program, shared with the
+	// copies of this shader since they use the same program
+	struct UniformValue{
+		GLenum type = 0;
+		float value[16];
+	};
+	std::shared_ptr<std::vector<UniformValue>> uniformValues;
+	bool updateUniformValue(GLint location, int count, GLenum type, const void * value, std::size_t size) const;
+
 #ifndef TARGET_OPENGLES
 	std::unordered_map<std::string, GLint> uniformBlocksCache;
 #endif
+#if !defined(TARGET_OPENGLES) && defined(glShaderStorageBlockBinding)
+	std::unordered_map<std::string, GLint> shaderStorageBlocksCache;
+#endif
 
 	bool setupShaderFromSource(Source && source);
+	bool compileShader(GLenum type);
+	bool startCompileShader(GLenum type);
+	bool checkShaderCompileStatus(GLenum type);
+	void cacheActiveResources();
+	std::string getProgramBinaryKey() const;
+	bool loadProgramBinary(const std::string & key);
+	void saveProgramBinary(const std::string & key);
 	ofShader::Source sourceFromFile(GLenum type, const std::filesystem::path& filename);
 	void checkProgramInfoLog();
 	bool checkProgramLinkStatus();
@@ -290,6 +505,20 @@ private:
 	static std::string parseForIncludes( const std::string& source, std::vector<std::string>& included, int level = 0, const std::filesystem::path& sourceDirectoryPath = "");
 
 	void checkAndCreateProgram();
+
+	// a shader linked in the background, swapped into owner when done
+	struct AsyncLoad;
+	std::shared_ptr<AsyncLoad> asyncLoad;
+	// set in the pending shader of an AsyncLoad, linkProgram() only
+	// starts the link
+	bool asyncLink = false;
+	bool asyncFromBinary = false;
+	std::string asyncBinaryKey;
+	bool startAsyncLink();
+	bool isAsyncLinkFinished() const;
+	bool finishAsyncLink();
+	bool startAsyncLoad(const std::shared_ptr<AsyncLoad> & load);
+	static void pollAsyncLoad(std::weak_ptr<AsyncLoad> load);
 #ifdef TARGET_ANDROID
 	void unloadGL();
 	void reloadGL();
@@ -0,0 +1,385 @@
+#include "ofSharedTexture.h"
+#include "ofGLUtils.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <cstring>
+#include <vector>
+
+#ifdef TARGET_WIN32
+#include <d3d11.h>
+#include <wrl/client.h>
+#elif defined(TARGET_OSX)
+#include <IOSurface/IOSurface.h>
+#include <OpenGL/CGLIOSurface.h>
+#include <OpenGL/OpenGL.h>
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2ext.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace{
+#ifdef TARGET_WIN32
+	using Microsoft::WRL::ComPtr;
+
+	// one device for all the shared textures, the textures only live in
+	// D3D, all the drawing happens in GL
+	struct InteropDevice{
+		ComPtr<ID3D11Device> device;
+		HANDLE interop = nullptr;
+	};
+
+	InteropDevice & getInteropDevice(){
+		static InteropDevice device;
+		if(!device.device && WGLEW_NV_DX_interop2){
+			if(SUCCEEDED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0, nullptr, 0, D3D11_SDK_VERSION, &device.device, nullptr, nullptr))){
+				device.interop = wglDXOpenDeviceNV(device.device.Get());
+			}
+			if(!device.interop){
+				ofLogError("ofSharedTexture") << "couldn't open a D3D11 device for WGL_NV_DX_interop2";
+			}
+		}
+		return device;
+	}
+#elif defined(TARGET_OSX)
+	void setNumber(CFMutableDictionaryRef dict, CFStringRef key, int32_t value){
+		CFNumberRef number = CFNumberCreate(nullptr, kCFNumberSInt32Type, &value);
+		CFDictionarySetValue(dict, key, number);
+		CFRelease(number);
+	}
+
+	bool bindSurface(ofTexture & texture, IOSurfaceRef surface, int width, int height){
+		texture.allocate(width, height, GL_RGBA, true);
+		auto & texData = texture.getTextureData();
+		glBindTexture(texData.textureTarget, texData.textureID);
+		CGLError error = CGLTexImageIOSurface2D(CGLGetCurrentContext(), texData.textureTarget, GL_RGBA,
+			width, height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, surface, 0);
+		glBindTexture(texData.textureTarget, 0);
+		if(error != kCGLNoError){
+			ofLogError("ofSharedTexture") << "couldn't bind the IOSurface to a texture: " << CGLErrorString(error);
+			texture.clear();
+			return false;
+		}
+		return true;
+	}
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	struct EGLFunctions{
+		PFNEGLCREATEIMAGEKHRPROC createImage = nullptr;
+		PFNEGLDESTROYIMAGEKHRPROC destroyImage = nullptr;
+		PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC exportQuery = nullptr;
+		PFNEGLEXPORTDMABUFIMAGEMESAPROC exportImage = nullptr;
+		PFNGLEGLIMAGETARGETTEXTURE2DOESPROC imageTargetTexture = nullptr;
+		bool bImport = false;
+		bool bModifiers = false;
+	};
+
+	bool hasExtension(const char * extensions, const char * name){
+		if(!extensions) return false;
+		auto len = strlen(name);
+		for(auto p = strstr(extensions, name); p; p = strstr(p + len, name)){
+			if((p == extensions || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0')){
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const EGLFunctions & getEGLFunctions(){
+		static EGLFunctions functions;
+		static bool loaded = false;
+		EGLDisplay display = eglGetCurrentDisplay();
+		if(!loaded && display != EGL_NO_DISPLAY){
+			loaded = true;
+			auto extensions = eglQueryString(display, EGL_EXTENSIONS);
+			if(hasExtension(extensions, "EGL_KHR_image_base")){
+				functions.createImage = (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
+				functions.destroyImage = (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress("eglDestroyImageKHR");
+			}
+			if(hasExtension(extensions, "EGL_MESA_image_dma_buf_export") && hasExtension(extensions, "EGL_KHR_gl_texture_2D_image")){
+				functions.exportQuery = (PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC)eglGetProcAddress("eglExportDMABUFImageQueryMESA");
+				functions.exportImage = (PFNEGLEXPORTDMABUFIMAGEMESAPROC)eglGetProcAddress("eglExportDMABUFImageMESA");
+			}
+			functions.bImport = hasExtension(extensions, "EGL_EXT_image_dma_buf_import");
+			functions.bModifiers = hasExtension(extensions, "EGL_EXT_image_dma_buf_import_modifiers");
+			functions.imageTargetTexture = (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)eglGetProcAddress("glEGLImageTargetTexture2DOES");
+		}
+		return functions;
+	}
+#endif
+}
+
+//----------------------------------------------------------
+ofSharedTexture::ofSharedTexture()
+:fd(-1)
+,bLocked(false)
+#ifdef TARGET_WIN32
+,d3dTexture(nullptr)
+,interopObject(nullptr)
+#elif defined(TARGET_OSX)
+,surface(nullptr)
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+,image(nullptr)
+#endif
+{
+}
+
+//----------------------------------------------------------
+ofSharedTexture::~ofSharedTexture(){
+	clear();
+}
+
+//----------------------------------------------------------
+bool ofSharedTexture::isSupported(){
+#ifdef TARGET_WIN32
+	return getInteropDevice().interop != nullptr;
+#elif defined(TARGET_OSX)
+	return true;
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	auto & egl = getEGLFunctions();
+	return egl.createImage && egl.exportImage && egl.bImport && egl.imageTargetTexture;
+#else
+	return false;
+#endif
+}
+
+//----------------------------------------------------------
+bool ofSharedTexture::allocate(int width, int height){
+	clear();
+	if(!isSupported()){
+		ofLogError("ofSharedTexture") << "allocate(): sharing textures isn't supported by this platform or GL context";
+		return false;
+	}
+	handle = ofSharedTextureHandle();
+	handle.width = width;
+	handle.height = height;
+
+#ifdef TARGET_WIN32
+	auto & device = getInteropDevice();
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = width;
+	desc.Height = height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED;
+	ComPtr<ID3D11Texture2D> tex;
+	ComPtr<IDXGIResource> resource;
+	HANDLE sharedHandle = nullptr;
+	if(FAILED(device.device->CreateTexture2D(&desc, nullptr, &tex)) ||
+	   FAILED(tex.As(&resource)) || FAILED(resource->GetSharedHandle(&sharedHandle))){
+		ofLogError("ofSharedTexture") << "allocate(): couldn't create a shared D3D11 texture";
+		return false;
+	}
+	texture.allocate(width, height, GL_RGBA, false);
+	interopObject = wglDXRegisterObjectNV(device.interop, tex.Get(), texture.getTextureData().textureID, GL_TEXTURE_2D, WGL_ACCESS_READ_WRITE_NV);
+	if(!interopObject){
+		ofLogError("ofSharedTexture") << "allocate(): couldn't register the D3D11 texture with GL";
+		texture.clear();
+		return false;
+	}
+	d3dTexture = tex.Detach();
+	handle.handle = uint64_t(uintptr_t(sharedHandle));
+#elif defined(TARGET_OSX)
+	CFMutableDictionaryRef properties = CFDictionaryCreateMutable(nullptr, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+	setNumber(properties, kIOSurfaceWidth, width);
+	setNumber(properties, kIOSurfaceHeight, height);
+	setNumber(properties, kIOSurfaceBytesPerElement, 4);
+	setNumber(properties, kIOSurfacePixelFormat, 'BGRA');
+	// lets other processes find it by id, the alternative, passing mach
+	// ports, needs a connection between the processes
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+	CFDictionarySetValue(properties, kIOSurfaceIsGlobal, kCFBooleanTrue);
+#pragma clang diagnostic pop
+	IOSurfaceRef ioSurface = IOSurfaceCreate(properties);
+	CFRelease(properties);
+	if(!ioSurface){
+		ofLogError("ofSharedTexture") << "allocate(): couldn't create an IOSurface";
+		return false;
+	}
+	if(!bindSurface(texture, ioSurface, width, height)){
+		CFRelease(ioSurface);
+		return false;
+	}
+	surface = ioSurface;
+	handle.handle = IOSurfaceGetID(ioSurface);
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	auto & egl = getEGLFunctions();
+	EGLDisplay display = eglGetCurrentDisplay();
+	texture.allocate(width, height, GL_RGBA);
+	EGLImageKHR eglImage = egl.createImage(display, eglGetCurrentContext(), EGL_GL_TEXTURE_2D_KHR,
+		(EGLClientBuffer)(uintptr_t)texture.getTextureData().textureID, nullptr);
+	int fourcc = 0, numPlanes = 0;
+	EGLuint64KHR modifier = 0;
+	EGLint stride = 0, offset = 0;
+	if(eglImage == EGL_NO_IMAGE_KHR ||
+	   !egl.exportQuery(display, eglImage, &fourcc, &numPlanes, &modifier) || numPlanes != 1 ||
+	   !egl.exportImage(display, eglImage, &fd, &stride, &offset)){
+		ofLogError("ofSharedTexture") << "allocate(): couldn't export the texture as a dma-buf";
+		if(eglImage != EGL_NO_IMAGE_KHR) egl.destroyImage(display, eglImage);
+		texture.clear();
+		fd = -1;
+		return false;
+	}
+	image = eglImage;
+	handle.fourcc = fourcc;
+	handle.stride = stride;
+	handle.offset = offset;
+	handle.modifier = modifier;
+#endif
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofSharedTexture::import(const ofSharedTextureHandle & handle, int fd){
+	clear();
+	if(!isSupported()){
+		ofLogError("ofSharedTexture") << "import(): sharing textures isn't supported by this platform or GL context";
+		return false;
+	}
+	int width = handle.width;
+	int height = handle.height;
+
+#ifdef TARGET_WIN32
+	auto & device = getInteropDevice();
+	ComPtr<ID3D11Texture2D> tex;
+	if(FAILED(device.device->OpenSharedResource(HANDLE(uintptr_t(handle.handle)), IID_PPV_ARGS(&tex)))){
+		ofLogError("ofSharedTexture") << "import(): couldn't open the shared D3D11 texture";
+		return false;
+	}
+	texture.allocate(width, height, GL_RGBA, false);
+	interopObject = wglDXRegisterObjectNV(device.interop, tex.Get(), texture.getTextureData().textureID, GL_TEXTURE_2D, WGL_ACCESS_READ_ONLY_NV);
+	if(!interopObject){
+		ofLogError("ofSharedTexture") << "import(): couldn't register the D3D11 texture with GL";
+		texture.clear();
+		return false;
+	}
+	d3dTexture = tex.Detach();
+#elif defined(TARGET_OSX)
+	IOSurfaceRef ioSurface = IOSurfaceLookup(IOSurfaceID(handle.handle));
+	if(!ioSurface){
+		ofLogError("ofSharedTexture") << "import(): couldn't find IOSurface " << handle.handle;
+		return false;
+	}
+	if(!bindSurface(texture, ioSurface, width, height)){
+		CFRelease(ioSurface);
+		return false;
+	}
+	surface = ioSurface;
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	auto & egl = getEGLFunctions();
+	EGLDisplay display = eglGetCurrentDisplay();
+	std::vector<EGLint> attributes = {
+		EGL_WIDTH, width,
+		EGL_HEIGHT, height,
+		EGL_LINUX_DRM_FOURCC_EXT, EGLint(handle.fourcc),
+		EGL_DMA_BUF_PLANE0_FD_EXT, fd,
+		EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGLint(handle.offset),
+		EGL_DMA_BUF_PLANE0_PITCH_EXT, EGLint(handle.stride),
+	};
+#ifdef EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT
+	// DRM_FORMAT_MOD_INVALID means the driver decides
+	if(egl.bModifiers && handle.modifier != 0x00ffffffffffffffULL){
+		attributes.insert(attributes.end(), {
+			EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, EGLint(handle.modifier & 0xFFFFFFFF),
+			EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT, EGLint(handle.modifier >> 32),
+		});
+	}
+#endif
+	attributes.push_back(EGL_NONE);
+	EGLImageKHR eglImage = egl.createImage(display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attributes.data());
+	if(eglImage == EGL_NO_IMAGE_KHR){
+		ofLogError("ofSharedTexture") << "import(): couldn't import the dma-buf, error " << ofToHex(eglGetError());
+		return false;
+	}
+	texture.allocate(width, height, GL_RGBA);
+	auto & texData = texture.getTextureData();
+	glBindTexture(texData.textureTarget, texData.textureID);
+	egl.imageTargetTexture(texData.textureTarget, eglImage);
+	glBindTexture(texData.textureTarget, 0);
+	image = eglImage;
+#endif
+	this->handle = handle;
+	return true;
+}
+
+//----------------------------------------------------------
+void ofSharedTexture::clear(){
+	unlock();
+#ifdef TARGET_WIN32
+	if(interopObject){
+		wglDXUnregisterObjectNV(getInteropDevice().interop, interopObject);
+		interopObject = nullptr;
+	}
+	if(d3dTexture){
+		static_cast<ID3D11Texture2D*>(d3dTexture)->Release();
+		d3dTexture = nullptr;
+	}
+#elif defined(TARGET_OSX)
+	if(surface){
+		CFRelease(IOSurfaceRef(surface));
+		surface = nullptr;
+	}
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	if(image){
+		getEGLFunctions().destroyImage(eglGetCurrentDisplay(), EGLImageKHR(image));
+		image = nullptr;
+	}
+	if(fd != -1){
+		::close(fd);
+		fd = -1;
+	}
+#endif
+	texture.clear();
+	handle = ofSharedTextureHandle();
+}
+
+//----------------------------------------------------------
+bool ofSharedTexture::isAllocated() const{
+	return texture.isAllocated();
+}
+
+//----------------------------------------------------------
+const ofSharedTextureHandle & ofSharedTexture::getHandle() const{
+	return handle;
+}
+
+//----------------------------------------------------------
+int ofSharedTexture::getFd() const{
+	return fd;
+}
+
+//----------------------------------------------------------
+ofTexture & ofSharedTexture::getTexture(){
+	return texture;
+}
+
+//----------------------------------------------------------
+const ofTexture & ofSharedTexture::getTexture() const{
+	return texture;
+}
+
+//----------------------------------------------------------
+void ofSharedTexture::lock(){
+#ifdef TARGET_WIN32
+	if(interopObject && !bLocked){
+		bLocked = wglDXLockObjectsNV(getInteropDevice().interop, 1, &interopObject);
+	}
+#endif
+}
+
+//----------------------------------------------------------
+void ofSharedTexture::unlock(){
+#ifdef TARGET_WIN32
+	if(interopObject && bLocked){
+		wglDXUnlockObjectsNV(getInteropDevice().interop, 1, &interopObject);
+		bLocked = false;
+	}
+#endif
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofTexture.h"
+
+/// \brief Describes a texture allocated by ofSharedTexture so another
+/// process can import it
+///
+/// It's plain data, meant to be stored in shared memory.
+struct ofSharedTextureHandle{
+	uint32_t width = 0;
+	uint32_t height = 0;
+
+	/// \brief A D3D11 shared handle on windows or an IOSurfaceID on macOS
+	uint64_t handle = 0;
+
+	/// \brief Layout of the dma-buf on linux, the file descriptor itself
+	/// can't be stored in memory and has to be passed through a unix socket
+	uint32_t fourcc = 0;
+	uint32_t stride = 0;
+	uint32_t offset = 0;
+	uint64_t modifier = 0;
+};
+
+/// \brief A texture whose memory can be used by other processes
+///
+/// The memory belongs to the platform's native API and is seen as an
+/// ofTexture by the process that allocates it and by every process that
+/// imports it: a D3D11 shared texture through WGL_NV_DX_interop2 on
+/// windows, an IOSurface on macOS and a dma-buf through EGL images on
+/// linux with EGL. Drawing or copying into it in one process changes it
+/// in all of them without any copy.
+///
+/// Most apps use it through ofSharedFrameSender and ofSharedFrameReceiver,
+/// which also pass the handles around.
+///
+/// On macOS the texture is a GL_TEXTURE_RECTANGLE_ARB, IOSurfaces can only
+/// be bound to those.
+class ofSharedTexture{
+public:
+	ofSharedTexture();
+	~ofSharedTexture();
+
+	ofSharedTexture(const ofSharedTexture &) = delete;
+	ofSharedTexture & operator=(const ofSharedTexture &) = delete;
+
+	/// \brief Whether the current GL context can share textures, on linux
+	/// it needs an EGL context with dma-buf export and import
+	static bool isSupported();
+
+	/// \brief Allocates an RGBA texture other processes can import
+	bool allocate(int width, int height);
+
+	/// \brief Imports a texture allocated in another process
+	///
+	/// fd is the dma-buf on linux, it's only used during the call, the
+	/// caller still owns it
+	bool import(const ofSharedTextureHandle & handle, int fd = -1);
+
+	void clear();
+	bool isAllocated() const;
+
+	const ofSharedTextureHandle & getHandle() const;
+
+	/// \brief The dma-buf of an allocated texture on linux, -1 elsewhere
+	int getFd() const;
+
+	ofTexture & getTexture();
+	const ofTexture & getTexture() const;
+
+	/// \brief Brackets GL access to the texture
+	///
+	/// On windows the memory belongs to D3D and GL can only use it while
+	/// it's locked, unlocking it makes the changes visible to the other
+	/// processes. Does nothing on other platforms.
+	void lock();
+	void unlock();
+
+private:
+	ofTexture texture;
+	ofSharedTextureHandle handle;
+	int fd;
+	bool bLocked;
+#ifdef TARGET_WIN32
+	void * d3dTexture;     // ID3D11Texture2D
+	void * interopObject;  // registered with wglDXRegisterObjectNV
+#elif defined(TARGET_OSX)
+	void * surface;        // IOSurfaceRef
+#elif defined(TARGET_LINUX) && defined(TARGET_OPENGLES)
+	void * image;          // EGLImageKHR
+#endif
+};
@@ -4,6 +4,13 @@
 #include "ofGraphics.h"
 #include "ofPixels.h"
 #include "ofGLUtils.h"
+#include "ofPixelReadback.h"
+#include "ofPixelUploader.h"
+#include "ofCompressedTexture.h"
+#include "ofGLStateCache.h"
+#include "ofRenderStats.h"
+#include "ofGpuMemory.h"
+#include <mutex>
 #include <map>
 
 #ifdef TARGET_ANDROID
@@ -126,8 +133,33 @@ static map<GLuint,int> & getTexturesIndex(){
 	return *textureReferences;
 }
 
+// textures can be created and deleted from an ofGLUploadWorker thread too
+static std::mutex & getTexturesMutex(){
+	static std::mutex * mutex = new std::mutex;
+	return *mutex;
+}
+
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_bindless_texture)
+static map<GLuint,GLuint64> & getBindlessHandles(){
+	static map<GLuint,GLuint64> * bindlessHandles = new map<GLuint,GLuint64>;
+	return *bindlessHandles;
+}
+#endif
+
+// resident handles have to be released before deleting their texture
+static void releaseBindlessHandle(GLuint id){
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_bindless_texture)
+	auto it = getBindlessHandles().find(id);
+	if(it != getBindlessHandles().end()){
+		glMakeTextureHandleNonResidentARB(it->second);
+		getBindlessHandles().erase(it);
+	}
+#endif
+}
+
 static void retain(GLuint id){
 	if(id!=0){
+		std::lock_guard<std::mutex> lock(getTexturesMutex());
 		if(getTexturesIndex().find(id)!=getTexturesIndex().end()){
 			getTexturesIndex()[id]++;
 		}else{
@@ -140,24 +172,31 @@ static void release(GLuint id){
 	// try to free up the texture memory so we don't reallocate
 	// http://www.opengl.org/documentation/specs/man_pages/hardcopy/GL/html/gl/deletetextures.html
 	if (id != 0){
+		std::lock_guard<std::mutex> lock(getTexturesMutex());
 		if(getTexturesIndex().find(id)!=getTexturesIndex().end()){
 			getTexturesIndex()[id]--;
 			if(getTexturesIndex()[id]==0){
+				releaseBindlessHandle(id);
 
 #ifdef TARGET_ANDROID
 				if (!ofAppAndroidWindow::isSurfaceDestroyed())
 #endif
 					glDeleteTextures(1, (GLuint *)&id);
+				ofGetGLStateCache().deletedTexture(id);
+				of::priv::gpuMemoryReleased(OF_GPU_MEMORY_TEXTURE, id);
 
 				getTexturesIndex().erase(id);
 			}
 		}else{
 			ofLogError("ofTexture") << "release(): something's wrong here, releasing unknown texture id " << id;
+			releaseBindlessHandle(id);
 
 #ifdef TARGET_ANDROID
 			if (!ofAppAndroidWindow::isSurfaceDestroyed())
 #endif
 				glDeleteTextures(1, (GLuint *)&id);
+			ofGetGLStateCache().deletedTexture(id);
+			of::priv::gpuMemoryReleased(OF_GPU_MEMORY_TEXTURE, id);
 		}
 	}
 }
@@ -381,12 +420,34 @@ void ofTexture::allocateAsBufferTexture(const ofBufferObject & buffer, int glInt
 	allocate(texData,0,0);
 	buffer.bind(GL_TEXTURE_BUFFER);
 }
+
+//----------------------------------------------------------
+void ofTexture::allocateAsArray(int w, int h, int numLayers, int glInternalFormat){
+	if(!ofGLSupportsTextureArrays()){
+		ofLogError("ofTexture") << "allocateAsArray(): texture arrays need OpenGL 3.0 or GL_EXT_texture_array";
+		return;
+	}
+	if(numLayers <= 0){
+		ofLogError("ofTexture") << "allocateAsArray(): number of layers has to be bigger than 0, got " << numLayers;
+		return;
+	}
+	texData.width = w;
+	texData.height = h;
+	texData.depth = numLayers;
+	texData.layer = 0;
+	texData.bFlipTexture = false;
+	texData.glInternalFormat = glInternalFormat;
+	texData.textureTarget = GL_TEXTURE_2D_ARRAY;
+	allocate(texData,ofGetGLFormatFromInternal(glInternalFormat),ofGetGlTypeFromInternal(glInternalFormat));
+}
 #endif
 
 //----------------------------------------------------------
 void ofTexture::allocate(int w, int h, int glInternalFormat, bool bUseARBExtension, int glFormat, int pixelType){
 	texData.width = w;
 	texData.height = h;
+	texData.depth = 1;
+	texData.layer = 0;
 	texData.bFlipTexture = false;
 	texData.glInternalFormat = glInternalFormat;
 	//our graphics card might not support arb so we have to see if it is supported.
@@ -412,7 +473,7 @@ void ofTexture::allocate(const ofTextureData & textureData){
 
 void ofTexture::allocate(const ofTextureData & textureData, int glFormat, int pixelType){
 #ifndef TARGET_OPENGLES
-	if(texData.textureTarget == GL_TEXTURE_2D || texData.textureTarget == GL_TEXTURE_RECTANGLE_ARB){
+	if(texData.textureTarget == GL_TEXTURE_2D || texData.textureTarget == GL_TEXTURE_RECTANGLE_ARB || texData.textureTarget == GL_TEXTURE_2D_ARRAY){
 #else
 	if(texData.textureTarget == GL_TEXTURE_2D){
 #endif
@@ -423,6 +484,15 @@ void ofTexture::allocate(const ofTextureData & textureData, int glFormat, int pi
 	}
 
 	texData = textureData;
+	texData.baseLevel = 0;
+#if defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_0)
+	// integer textures can't be filtered, they are incomplete with the
+	// default linear filters
+	if(glFormat == GL_RED_INTEGER || glFormat == GL_RG_INTEGER || glFormat == GL_RGB_INTEGER || glFormat == GL_RGBA_INTEGER){
+		texData.minFilter = GL_NEAREST;
+		texData.magFilter = GL_NEAREST;
+	}
+#endif
 	//our graphics card might not support arb so we have to see if it is supported.
 #ifndef TARGET_OPENGLES
 	if( texData.textureTarget==GL_TEXTURE_RECTANGLE_ARB && ofGLSupportsNPOTTextures() ){
@@ -430,6 +500,12 @@ void ofTexture::allocate(const ofTextureData & textureData, int glFormat, int pi
 		texData.tex_h = texData.height;
 		texData.tex_t = texData.width;
 		texData.tex_u = texData.height;
+	}else if(texData.textureTarget == GL_TEXTURE_2D_ARRAY){
+		// array textures need GL 3 so they are never padded to a power of 2
+		texData.tex_w = texData.width;
+		texData.tex_h = texData.height;
+		texData.tex_t = 1;
+		texData.tex_u = 1;
 	}else if(texData.textureTarget == GL_TEXTURE_2D)
 #endif
 	{
@@ -458,8 +534,9 @@ void ofTexture::allocate(const ofTextureData & textureData, int glFormat, int pi
 #else
 	if(texData.textureTarget == GL_TEXTURE_2D){
 #endif
-		glBindTexture(texData.textureTarget,texData.textureID);
+		ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
 		glTexImage2D(texData.textureTarget, 0, texData.glInternalFormat, (GLint)texData.tex_w, (GLint)texData.tex_h, 0, glFormat, pixelType, 0);  // init to black...
+		of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_TEXTURE, texData.textureID, of::priv::gpuMemoryBytes(texData.glInternalFormat, texData.tex_w, texData.tex_h));
 
 		glTexParameterf(texData.textureTarget, GL_TEXTURE_MAG_FILTER, texData.magFilter);
 		glTexParameterf(texData.textureTarget, GL_TEXTURE_MIN_FILTER, texData.minFilter);
@@ -471,8 +548,21 @@ void ofTexture::allocate(const ofTextureData & textureData, int glFormat, int pi
 				glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 			}
 		#endif
-		glBindTexture(texData.textureTarget,0);
+		ofGetGLStateCache().bindTexture(texData.textureTarget,0);
+	}
+#ifndef TARGET_OPENGLES
+	else if(texData.textureTarget == GL_TEXTURE_2D_ARRAY){
+		ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+		glTexImage3D(texData.textureTarget, 0, texData.glInternalFormat, (GLint)texData.tex_w, (GLint)texData.tex_h, texData.depth, 0, glFormat, pixelType, 0);
+		of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_TEXTURE, texData.textureID, of::priv::gpuMemoryBytes(texData.glInternalFormat, texData.tex_w, texData.tex_h) * texData.depth);
+
+		glTexParameterf(texData.textureTarget, GL_TEXTURE_MAG_FILTER, texData.magFilter);
+		glTexParameterf(texData.textureTarget, GL_TEXTURE_MIN_FILTER, texData.minFilter);
+		glTexParameterf(texData.textureTarget, GL_TEXTURE_WRAP_S, texData.wrapModeHorizontal);
+		glTexParameterf(texData.textureTarget, GL_TEXTURE_WRAP_T, texData.wrapModeVertical);
+		ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 	}
+#endif
 
 	texData.bAllocated = true;
 
@@ -484,7 +574,7 @@ void ofTexture::allocate(const ofTextureData & textureData, int glFormat, int pi
 
 void ofTexture::setRGToRGBASwizzles(bool rToRGBSwizzles){
 #ifndef TARGET_OPENGLES
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
 	if(rToRGBSwizzles){
 		if(texData.glInternalFormat==GL_R8 ||
 			texData.glInternalFormat==GL_R16 ||
@@ -528,15 +618,15 @@ void ofTexture::setRGToRGBASwizzles(bool rToRGBSwizzles){
 			 glTexParameteri(texData.textureTarget, GL_TEXTURE_SWIZZLE_A, GL_ALPHA);
 		}
 	}
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 #endif
 }
 
 void ofTexture::setSwizzle(GLenum srcSwizzle, GLenum dstChannel){
 #ifndef TARGET_OPENGLES
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
 	glTexParameteri(texData.textureTarget, srcSwizzle, dstChannel);
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 #endif
 }
 
@@ -646,10 +736,297 @@ void ofTexture::loadData(const ofBufferObject & buffer, int glFormat, int glType
 	loadData(0,texData.width,texData.height,glFormat,glType);
 	buffer.unbind(GL_PIXEL_UNPACK_BUFFER);
 }
+
+//----------------------------------------------------------
+bool ofTexture::loadData(ofPixelUploader & uploader){
+	return uploader.upload(*this);
+}
+
+//----------------------------------------------------------
+void ofTexture::loadLayerData(const ofPixels & pix, int layer){
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT,pix.getBytesStride());
+	loadLayerData(pix.getData(), pix.getWidth(), pix.getHeight(), layer, ofGetGlFormat(pix), ofGetGlType(pix));
+}
+
+//----------------------------------------------------------
+void ofTexture::loadLayerData(const ofShortPixels & pix, int layer){
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT,pix.getBytesStride());
+	loadLayerData(pix.getData(), pix.getWidth(), pix.getHeight(), layer, ofGetGlFormat(pix), ofGetGlType(pix));
+}
+
+//----------------------------------------------------------
+void ofTexture::loadLayerData(const ofFloatPixels & pix, int layer){
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT,pix.getBytesStride());
+	loadLayerData(pix.getData(), pix.getWidth(), pix.getHeight(), layer, ofGetGlFormat(pix), ofGetGlType(pix));
+}
+
+//----------------------------------------------------------
+void ofTexture::loadLayerData(const void * data, int w, int h, int layer, int glFormat, int glType){
+	if(!isAllocated() || texData.textureTarget != GL_TEXTURE_2D_ARRAY){
+		ofLogError("ofTexture") << "loadLayerData(): texture is not an array texture, allocate it with allocateAsArray()";
+		return;
+	}
+	if(layer < 0 || layer >= texData.depth){
+		ofLogError("ofTexture") << "loadLayerData(): layer " << layer << " out of range, texture has " << texData.depth << " layers";
+		return;
+	}
+	if(w > texData.tex_w || h > texData.tex_h){
+		ofLogError("ofTexture") << "loadLayerData(): data is " << w << "x" << h << " but the layers are " << texData.tex_w << "x" << texData.tex_h;
+		return;
+	}
+	ofGetGLStateCache().bindTexture(texData.textureTarget, (GLuint) texData.textureID);
+	glTexSubImage3D(texData.textureTarget, 0, 0, 0, layer, w, h, 1, glFormat, glType, data);
+	of::priv::currentRenderStats().textureUploadBytes += uint64_t(w) * h * ofGetNumChannelsFromGLFormat(glFormat) * ofGetBytesPerChannelFromGLType(glType);
+	ofGetGLStateCache().bindTexture(texData.textureTarget, 0);
+
+	if (bWantsMipmap) {
+		generateMipmap();
+	}
+}
+
+//----------------------------------------------------------
+void ofTexture::loadMipmapData(const ofPixels & pix, int level){
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT,pix.getBytesStride());
+	loadMipmapData(pix.getData(), pix.getWidth(), pix.getHeight(), level, ofGetGlFormat(pix), ofGetGlType(pix));
+}
+
+//----------------------------------------------------------
+void ofTexture::loadMipmapData(const ofShortPixels & pix, int level){
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT,pix.getBytesStride());
+	loadMipmapData(pix.getData(), pix.getWidth(), pix.getHeight(), level, ofGetGlFormat(pix), ofGetGlType(pix));
+}
+
+//----------------------------------------------------------
+void ofTexture::loadMipmapData(const ofFloatPixels & pix, int level){
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT,pix.getBytesStride());
+	loadMipmapData(pix.getData(), pix.getWidth(), pix.getHeight(), level, ofGetGlFormat(pix), ofGetGlType(pix));
+}
+
+//----------------------------------------------------------
+void ofTexture::loadMipmapData(const void * data, int w, int h, int level, int glFormat, int glType){
+	if(!isAllocated() || texData.textureTarget != GL_TEXTURE_2D){
+		ofLogError("ofTexture") << "loadMipmapData(): only allocated GL_TEXTURE_2D textures can have mipmaps, call ofDisableArbTex() or allocate with bUseARBExtension false";
+		return;
+	}
+	int numLevels = getNumMipmapLevels();
+	if(level < 0 || level >= numLevels){
+		ofLogError("ofTexture") << "loadMipmapData(): level " << level << " out of range, texture has " << numLevels << " levels";
+		return;
+	}
+	int levelWidth = std::max(1, int(texData.tex_w) >> level);
+	int levelHeight = std::max(1, int(texData.tex_h) >> level);
+	if(w != levelWidth || h != levelHeight){
+		ofLogError("ofTexture") << "loadMipmapData(): level " << level << " has to be " << levelWidth << "x" << levelHeight << " but data is " << w << "x" << h;
+		return;
+	}
+	if(level == 0){
+		loadData(data, w, h, glFormat, glType);
+		return;
+	}
+
+	ofGetGLStateCache().bindTexture(texData.textureTarget, (GLuint) texData.textureID);
+	glTexImage2D(texData.textureTarget, level, texData.glInternalFormat, w, h, 0, glFormat, glType, data);
+	of::priv::currentRenderStats().textureUploadBytes += uint64_t(w) * h * ofGetNumChannelsFromGLFormat(glFormat) * ofGetBytesPerChannelFromGLType(glType);
+	if(!texData.hasMipmap){
+		// the whole chain is a third of the first level
+		of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_TEXTURE, texData.textureID, of::priv::gpuMemoryBytes(texData.glInternalFormat, texData.tex_w, texData.tex_h) * 4 / 3);
+		texData.hasMipmap = true;
+		texData.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+		glTexParameterf(texData.textureTarget, GL_TEXTURE_MIN_FILTER, texData.minFilter);
+		glTexParameteri(texData.textureTarget, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+	}
+	// sample only from the levels uploaded so far, an incomplete chain
+	// would make the texture sample black
+	if(texData.baseLevel == 0 || level < texData.baseLevel){
+		texData.baseLevel = level;
+		glTexParameteri(texData.textureTarget, GL_TEXTURE_BASE_LEVEL, level);
+	}
+	ofGetGLStateCache().bindTexture(texData.textureTarget, 0);
+}
+
+//----------------------------------------------------------
+int ofTexture::getMipmapBaseLevel() const{
+	return texData.baseLevel;
+}
+
+//----------------------------------------------------------
+bool ofTexture::isBindlessSupported(){
+#ifdef GLEW_ARB_bindless_texture
+	return GLEW_ARB_bindless_texture;
+#else
+	return false;
+#endif
+}
+
+//----------------------------------------------------------
+GLuint64 ofTexture::getBindlessHandle() const{
+	if(!isAllocated()){
+		ofLogError("ofTexture") << "getBindlessHandle(): texture not allocated";
+		return 0;
+	}
+	if(!isBindlessSupported()){
+		ofLogError("ofTexture") << "getBindlessHandle(): bindless textures need GL_ARB_bindless_texture";
+		return 0;
+	}
+#ifdef GLEW_ARB_bindless_texture
+	auto & handles = getBindlessHandles();
+	auto it = handles.find(texData.textureID);
+	if(it != handles.end()){
+		return it->second;
+	}
+	GLuint64 handle = glGetTextureHandleARB(texData.textureID);
+	glMakeTextureHandleResidentARB(handle);
+	handles[texData.textureID] = handle;
+	return handle;
+#else
+	return 0;
+#endif
+}
+
+//----------------------------------------------------------
+void ofTexture::releaseBindlessHandle() const{
+	::releaseBindlessHandle(texData.textureID);
+}
+#endif
+
+//----------------------------------------------------------
+int ofTexture::getNumLayers() const{
+	return texData.depth;
+}
+
+//----------------------------------------------------------
+void ofTexture::setDrawLayer(int layer){
+	texData.layer = layer;
+}
+
+//----------------------------------------------------------
+int ofTexture::getDrawLayer() const{
+	return texData.layer;
+}
+
+//----------------------------------------------------------
+bool ofTexture::loadData(const ofCompressedTextureData & data){
+	if(!data.isAllocated()){
+		ofLogError("ofTexture") << "loadData(): compressed data is empty";
+		return false;
+	}
+	if(!ofGLSupportsCompressedTextureFormat(data.getGLInternalFormat())){
+		ofLogError("ofTexture") << "loadData(): compressed format 0x" << ofToHex(data.getGLInternalFormat()) << " not supported by this graphics card";
+		return false;
+	}
+
+	clear();
+
+	texData.textureTarget = GL_TEXTURE_2D;
+	texData.depth = 1;
+	texData.layer = 0;
+	texData.glInternalFormat = data.getGLInternalFormat();
+	texData.width = data.getWidth();
+	texData.height = data.getHeight();
+	texData.tex_w = texData.width;
+	texData.tex_h = texData.height;
+	texData.tex_t = 1;
+	texData.tex_u = 1;
+	texData.hasMipmap = data.getNumLevels() > 1;
+	if(texData.hasMipmap){
+		texData.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+	}
+
+	glGenTextures(1, (GLuint *)&texData.textureID);
+	retain(texData.textureID);
+
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+	// compressed blocks are tightly packed
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	uint64_t bytes = 0;
+	for(size_t i = 0; i < data.getNumLevels(); i++){
+		auto & level = data.getLevel(i);
+		glCompressedTexImage2D(texData.textureTarget, i, texData.glInternalFormat, level.width, level.height, 0, level.data.size(), level.data.getData());
+		bytes += level.data.size();
+	}
+	of::priv::currentRenderStats().textureUploadBytes += bytes;
+	of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_TEXTURE, texData.textureID, bytes);
+#ifndef TARGET_OPENGLES
+	// an incomplete chain would make the texture sample black
+	glTexParameteri(texData.textureTarget, GL_TEXTURE_MAX_LEVEL, data.getNumLevels() - 1);
+#endif
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_MAG_FILTER, texData.magFilter);
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_MIN_FILTER, texData.minFilter);
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_WRAP_S, texData.wrapModeHorizontal);
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_WRAP_T, texData.wrapModeVertical);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
+
+	texData.bAllocated = true;
+
+#ifdef TARGET_ANDROID
+	registerTexture(this);
+#endif
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofTexture::allocateCompressed(int w, int h, GLint glInternalFormat){
+	if(!ofGLSupportsCompressedTextureFormat(glInternalFormat)){
+		ofLogError("ofTexture") << "allocateCompressed(): compressed format 0x" << ofToHex(glInternalFormat) << " not supported by this graphics card";
+		return false;
+	}
+
+	clear();
+
+	texData.textureTarget = GL_TEXTURE_2D;
+	texData.depth = 1;
+	texData.layer = 0;
+	texData.glInternalFormat = glInternalFormat;
+	texData.width = w;
+	texData.height = h;
+	texData.tex_w = w;
+	texData.tex_h = h;
+	texData.tex_t = 1;
+	texData.tex_u = 1;
+	texData.hasMipmap = false;
+
+	glGenTextures(1, (GLuint *)&texData.textureID);
+	retain(texData.textureID);
+
+	auto bytes = ofGLGetCompressedBlockSize(glInternalFormat) * ((w + 3) / 4) * ((h + 3) / 4);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+	glCompressedTexImage2D(texData.textureTarget, 0, glInternalFormat, w, h, 0, bytes, nullptr);
+	of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_TEXTURE, texData.textureID, bytes);
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_MAG_FILTER, texData.magFilter);
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_MIN_FILTER, texData.minFilter);
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_WRAP_S, texData.wrapModeHorizontal);
+	glTexParameterf(texData.textureTarget, GL_TEXTURE_WRAP_T, texData.wrapModeVertical);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
+
+	texData.bAllocated = true;
+
+#ifdef TARGET_ANDROID
+	registerTexture(this);
 #endif
+	return true;
+}
+
+//----------------------------------------------------------
+void ofTexture::loadCompressedData(const void * data, std::size_t bytes){
+	if(!isAllocated()){
+		ofLogError("ofTexture") << "loadCompressedData(): texture not allocated, call allocateCompressed() first";
+		return;
+	}
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glCompressedTexSubImage2D(texData.textureTarget, 0, 0, 0, texData.tex_w, texData.tex_h, texData.glInternalFormat, bytes, data);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
+	of::priv::currentRenderStats().textureUploadBytes += bytes;
+}
 
 //----------------------------------------------------------
 void ofTexture::loadData(const void * data, int w, int h, int glFormat, int glType){
+#ifndef TARGET_OPENGLES
+	if(texData.textureTarget == GL_TEXTURE_2D_ARRAY && isAllocated()){
+		loadLayerData(data, w, h, 0, glFormat, glType);
+		return;
+	}
+#endif
 
 	if(w > texData.tex_w || h > texData.tex_h) {
 		if(isAllocated()){
@@ -673,11 +1050,19 @@ void ofTexture::loadData(const void * data, int w, int h, int glFormat, int glTy
 	}
 	
 	// bind texture
-	glBindTexture(texData.textureTarget, (GLuint) texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget, (GLuint) texData.textureID);
 	//update the texture image:
 	glTexSubImage2D(texData.textureTarget, 0, 0, 0, w, h, glFormat, glType, data);
+	of::priv::currentRenderStats().textureUploadBytes += uint64_t(w) * h * ofGetNumChannelsFromGLFormat(glFormat) * ofGetBytesPerChannelFromGLType(glType);
+#ifndef TARGET_OPENGLES
+	if(texData.baseLevel > 0){
+		// level 0 completes a chain streamed with loadMipmapData
+		texData.baseLevel = 0;
+		glTexParameteri(texData.textureTarget, GL_TEXTURE_BASE_LEVEL, 0);
+	}
+#endif
 	// unbind texture target by binding 0
-	glBindTexture(texData.textureTarget, 0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget, 0);
 	
 	if (bWantsMipmap) {
 		// auto-generate mipmap, since this ofTexture wants us to.
@@ -729,9 +1114,13 @@ void ofTexture::generateMipmap(){
 			// glEnable(texData.textureTarget);	/// < uncomment this hack if you are unlucky enough to run an older ATI card.
 			// See also: https://www.opengl.org/wiki/Common_Mistakes#Automatic_mipmap_generation
 
-			glBindTexture(texData.textureTarget, (GLuint) texData.textureID);
+			ofGetGLStateCache().bindTexture(texData.textureTarget, (GLuint) texData.textureID);
 			glGenerateMipmap(texData.textureTarget);
-			glBindTexture(texData.textureTarget, 0);
+			ofGetGLStateCache().bindTexture(texData.textureTarget, 0);
+			if(!texData.hasMipmap){
+				// the whole chain is a third of the first level
+				of::priv::gpuMemoryAllocated(OF_GPU_MEMORY_TEXTURE, texData.textureID, of::priv::gpuMemoryBytes(texData.glInternalFormat, texData.tex_w, texData.tex_h) * 4 / 3);
+			}
 			texData.hasMipmap = true;
 			break;
 		}
@@ -785,11 +1174,11 @@ void ofTexture::loadScreenData(int x, int y, int w, int h){
 	}
 	
 	
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
 
 	glCopyTexSubImage2D(texData.textureTarget, 0,0,0,x,y,w,h);
 
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 	
 	if (bWantsMipmap) {
 		generateMipmap();
@@ -949,12 +1338,12 @@ glm::vec2 ofTexture::getCoordFromPercent(float xPct, float yPct) const{
 
 //----------------------------------------------------------
 void ofTexture::setTextureWrap(GLint wrapModeHorizontal, GLint wrapModeVertical) {
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
 	glTexParameteri(texData.textureTarget, GL_TEXTURE_WRAP_S, wrapModeHorizontal);
 	glTexParameteri(texData.textureTarget, GL_TEXTURE_WRAP_T, wrapModeVertical);
 	texData.wrapModeVertical = wrapModeVertical;
 	texData.wrapModeHorizontal = wrapModeHorizontal;
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 }
 
 //----------------------------------------------------------
@@ -983,12 +1372,12 @@ void ofTexture::setTextureMinMagFilter(GLint minFilter, GLint magFilter){
 		return;
 	}
 
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
 	glTexParameteri(texData.textureTarget, GL_TEXTURE_MAG_FILTER, magFilter);
 	glTexParameteri(texData.textureTarget, GL_TEXTURE_MIN_FILTER, minFilter);
 	texData.magFilter = magFilter;
 	texData.minFilter = minFilter;
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 }
 
 //----------------------------------------------------------
@@ -1008,6 +1397,17 @@ void ofTexture::disableMipmap(){
 	texData.minFilter = GL_LINEAR;
 }
 
+//------------------------------------
+int ofTexture::getNumMipmapLevels() const{
+	int size = std::max(int(texData.tex_w), int(texData.tex_h));
+	int levels = 1;
+	while(size > 1){
+		size >>= 1;
+		levels++;
+	}
+	return levels;
+}
+
 //------------------------------------
 bool ofTexture::hasMipmap() const{
 	return texData.hasMipmap;
@@ -1216,9 +1616,10 @@ void ofTexture::readToPixels(ofPixels & pixels) const {
 #ifndef TARGET_OPENGLES
 	pixels.allocate(texData.width,texData.height,ofGetImageTypeFromGLType(texData.glInternalFormat));
 	ofSetPixelStoreiAlignment(GL_PACK_ALIGNMENT,pixels.getWidth(),pixels.getBytesPerChannel(),pixels.getNumChannels());
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+	of::priv::currentRenderStats().readbacks++;
 	glGetTexImage(texData.textureTarget,0,ofGetGlFormat(pixels),GL_UNSIGNED_BYTE, pixels.getData());
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 #endif
 }
 
@@ -1227,9 +1628,10 @@ void ofTexture::readToPixels(ofShortPixels & pixels) const {
 #ifndef TARGET_OPENGLES
 	pixels.allocate(texData.width,texData.height,ofGetImageTypeFromGLType(texData.glInternalFormat));
 	ofSetPixelStoreiAlignment(GL_PACK_ALIGNMENT,pixels.getWidth(),pixels.getBytesPerChannel(),pixels.getNumChannels());
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+	of::priv::currentRenderStats().readbacks++;
 	glGetTexImage(texData.textureTarget,0,ofGetGlFormat(pixels),GL_UNSIGNED_SHORT,pixels.getData());
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 #endif
 }
 
@@ -1237,22 +1639,200 @@ void ofTexture::readToPixels(ofFloatPixels & pixels) const {
 #ifndef TARGET_OPENGLES
 	pixels.allocate(texData.width,texData.height,ofGetImageTypeFromGLType(texData.glInternalFormat));
 	ofSetPixelStoreiAlignment(GL_PACK_ALIGNMENT,pixels.getWidth(),pixels.getBytesPerChannel(),pixels.getNumChannels());
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+	of::priv::currentRenderStats().readbacks++;
 	glGetTexImage(texData.textureTarget,0,ofGetGlFormat(pixels),GL_FLOAT,pixels.getData());
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
 #endif
 }
 
+namespace{
+	// a framebuffer with the texture as its only attachment, to read or
+	// copy from, the previous framebuffer is bound back when it's destroyed
+	struct TextureFramebuffer{
+		GLint previous = 0;
+		GLuint id = 0;
+		bool complete = false;
+
+		TextureFramebuffer(const ofTextureData & texData){
+			glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+			glGenFramebuffers(1, &id);
+			of::priv::currentRenderStats().fboBinds++;
+			glBindFramebuffer(GL_FRAMEBUFFER, id);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texData.textureTarget, texData.textureID, 0);
+			complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		}
+
+		~TextureFramebuffer(){
+			of::priv::currentRenderStats().fboBinds++;
+			glBindFramebuffer(GL_FRAMEBUFFER, previous);
+			glDeleteFramebuffers(1, &id);
+		}
+	};
+
+	// region clipped to the texels of the texture
+	bool clipRegion(const ofTextureData & texData, const ofRectangle & region, int & x, int & y, int & w, int & h){
+		ofRectangle r = region.getStandardized();
+		x = std::max(int(r.getMinX()), 0);
+		y = std::max(int(r.getMinY()), 0);
+		w = std::min(int(r.getMaxX()), int(texData.tex_w)) - x;
+		h = std::min(int(r.getMaxY()), int(texData.tex_h)) - y;
+		return w > 0 && h > 0;
+	}
+
+	template<typename PixelType>
+	void readRegion(const ofTextureData & texData, const ofRectangle & region, ofPixels_<PixelType> & pixels, GLenum glType){
+		int x, y, w, h;
+		if(!clipRegion(texData, region, x, y, w, h)){
+			pixels.clear();
+			return;
+		}
+		TextureFramebuffer framebuffer(texData);
+		if(!framebuffer.complete){
+			ofLogError("ofTexture") << "readToPixels(): couldn't attach texture " << texData.textureID << " to a framebuffer";
+			pixels.clear();
+			return;
+		}
+		pixels.allocate(w,h,ofGetImageTypeFromGLType(texData.glInternalFormat));
+		ofSetPixelStoreiAlignment(GL_PACK_ALIGNMENT,pixels.getWidth(),pixels.getBytesPerChannel(),pixels.getNumChannels());
+		of::priv::currentRenderStats().readbacks++;
+		glReadPixels(x,y,w,h,ofGetGlFormat(pixels),glType,pixels.getData());
+	}
+}
+
+//----------------------------------------------------------
+void ofTexture::readToPixels(ofPixels & pixels, const ofRectangle & region) const{
+	if(!isAllocated()) return;
+	readRegion(texData, region, pixels, GL_UNSIGNED_BYTE);
+}
+
+//----------------------------------------------------------
+void ofTexture::readToPixels(ofShortPixels & pixels, const ofRectangle & region) const{
+	if(!isAllocated()) return;
+	readRegion(texData, region, pixels, GL_UNSIGNED_SHORT);
+}
+
+//----------------------------------------------------------
+void ofTexture::readToPixels(ofFloatPixels & pixels, const ofRectangle & region) const{
+	if(!isAllocated()) return;
+	readRegion(texData, region, pixels, GL_FLOAT);
+}
+
+//----------------------------------------------------------
+bool ofTexture::copyTo(ofTexture & dst, const ofRectangle & srcRegion, const glm::vec2 & dstPosition) const{
+	if(!isAllocated() || !dst.isAllocated()){
+		ofLogError("ofTexture") << "copyTo(): both textures have to be allocated";
+		return false;
+	}
+	// clipped to the source and then to the destination, moving the
+	// other side by the same amount
+	ofRectangle region = srcRegion.getStandardized();
+	int sx = int(region.getMinX()), sy = int(region.getMinY());
+	int dx = int(dstPosition.x), dy = int(dstPosition.y);
+	int w = int(region.getWidth()), h = int(region.getHeight());
+	if(sx < 0){ dx -= sx; w += sx; sx = 0; }
+	if(sy < 0){ dy -= sy; h += sy; sy = 0; }
+	if(dx < 0){ sx -= dx; w += dx; dx = 0; }
+	if(dy < 0){ sy -= dy; h += dy; dy = 0; }
+	w = std::min({w, int(texData.tex_w) - sx, int(dst.texData.tex_w) - dx});
+	h = std::min({h, int(texData.tex_h) - sy, int(dst.texData.tex_h) - dy});
+	if(w <= 0 || h <= 0){
+		return false;
+	}
+
+	bool sameFormat = texData.glInternalFormat == dst.texData.glInternalFormat;
+	bool copyImage = false;
+#if !defined(TARGET_OPENGLES) && defined(GLEW_ARB_copy_image)
+	copyImage = GLEW_VERSION_4_3 || GLEW_ARB_copy_image;
+#elif defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_2)
+	copyImage = ofGetGLRenderer() && (ofGetGLRenderer()->getGLVersionMajor() > 3 ||
+		(ofGetGLRenderer()->getGLVersionMajor() == 3 && ofGetGLRenderer()->getGLVersionMinor() >= 2));
+#endif
+	if(copyImage && sameFormat){
+#if (!defined(TARGET_OPENGLES) && defined(GLEW_ARB_copy_image)) || (defined(TARGET_OPENGLES) && defined(GL_ES_VERSION_3_2))
+		glCopyImageSubData(texData.textureID, texData.textureTarget, 0, sx, sy, 0,
+			dst.texData.textureID, dst.texData.textureTarget, 0, dx, dy, 0, w, h, 1);
+		return true;
+#endif
+	}
+
+	if(texData.textureID == dst.texData.textureID){
+		ofLogError("ofTexture") << "copyTo(): copying within the same texture needs glCopyImageSubData";
+		return false;
+	}
+	TextureFramebuffer framebuffer(texData);
+	if(!framebuffer.complete){
+		ofLogError("ofTexture") << "copyTo(): couldn't attach texture " << texData.textureID << " to a framebuffer";
+		return false;
+	}
+	ofGetGLStateCache().bindTexture(dst.texData.textureTarget,dst.texData.textureID);
+	glCopyTexSubImage2D(dst.texData.textureTarget, 0, dx, dy, sx, sy, w, h);
+	ofGetGLStateCache().bindTexture(dst.texData.textureTarget,0);
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofTexture::copyTo(ofTexture & dst) const{
+	return copyTo(dst, ofRectangle(0, 0, texData.tex_w, texData.tex_h), glm::vec2(0, 0));
+}
+
 #ifndef TARGET_OPENGLES
 //----------------------------------------------------------
 void ofTexture::copyTo(ofBufferObject & buffer) const{
 	ofSetPixelStoreiAlignment(GL_PACK_ALIGNMENT,getWidth(),ofGetBytesPerChannelFromGLType(ofGetGlTypeFromInternal(texData.glInternalFormat)),ofGetNumChannelsFromGLFormat(ofGetGLFormatFromInternal(texData.glInternalFormat)));
 	buffer.bind(GL_PIXEL_PACK_BUFFER);
-	glBindTexture(texData.textureTarget,texData.textureID);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,texData.textureID);
+	of::priv::currentRenderStats().readbacks++;
 	glGetTexImage(texData.textureTarget,0,ofGetGLFormatFromInternal(texData.glInternalFormat),ofGetGlTypeFromInternal(texData.glInternalFormat),0);
-	glBindTexture(texData.textureTarget,0);
+	ofGetGLStateCache().bindTexture(texData.textureTarget,0);
+	buffer.unbind(GL_PIXEL_PACK_BUFFER);
+
+}
+
+//----------------------------------------------------------
+void ofTexture::copyTo(ofBufferObject & buffer, const ofRectangle & region) const{
+	int x, y, w, h;
+	if(!isAllocated() || !clipRegion(texData, region, x, y, w, h)) return;
+	TextureFramebuffer framebuffer(texData);
+	if(!framebuffer.complete){
+		ofLogError("ofTexture") << "copyTo(): couldn't attach texture " << texData.textureID << " to a framebuffer";
+		return;
+	}
+	GLenum glFormat = ofGetGLFormatFromInternal(texData.glInternalFormat);
+	GLenum glType = ofGetGlTypeFromInternal(texData.glInternalFormat);
+	ofSetPixelStoreiAlignment(GL_PACK_ALIGNMENT,w,ofGetBytesPerChannelFromGLType(glType),ofGetNumChannelsFromGLFormat(glFormat));
+	buffer.bind(GL_PIXEL_PACK_BUFFER);
+	of::priv::currentRenderStats().readbacks++;
+	glReadPixels(x,y,w,h,glFormat,glType,0);
 	buffer.unbind(GL_PIXEL_PACK_BUFFER);
+}
 
+//----------------------------------------------------------
+ofPixelReadback & ofTexture::getAsyncReadback() const{
+	if(!asyncReadback){
+		asyncReadback = std::make_shared<ofPixelReadback>();
+	}
+	return *asyncReadback;
+}
+
+//----------------------------------------------------------
+bool ofTexture::readToPixelsAsync() const{
+	return getAsyncReadback().read(*this);
+}
+
+//----------------------------------------------------------
+bool ofTexture::getAsyncPixels(ofPixels & pixels) const{
+	return asyncReadback && asyncReadback->getPixels(pixels);
+}
+
+//----------------------------------------------------------
+bool ofTexture::getAsyncPixels(ofShortPixels & pixels) const{
+	return asyncReadback && asyncReadback->getPixels(pixels);
+}
+
+//----------------------------------------------------------
+bool ofTexture::getAsyncPixels(ofFloatPixels & pixels) const{
+	return asyncReadback && asyncReadback->getPixels(pixels);
 }
 #endif
 
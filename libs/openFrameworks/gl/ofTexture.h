@@ -5,6 +5,10 @@
 #include "ofConstants.h"
 #include "ofVboMesh.h"
 
+class ofPixelReadback;
+class ofPixelUploader;
+class ofCompressedTextureData;
+
 /// \file
 /// ofTexture is used to create OpenGL textures that live on your graphics card
 /// (GPU). While you can certainly use ofTexture directly to manipulate and
@@ -166,6 +170,8 @@ public:
 		tex_h = 0;
 		width = 0;
 		height = 0;
+		depth = 1;
+		layer = 0;
 		
 		bFlipTexture = false;
 		compressionType = OF_COMPRESS_NONE;
@@ -179,6 +185,7 @@ public:
 		wrapModeHorizontal = GL_CLAMP_TO_EDGE;
 		wrapModeVertical = GL_CLAMP_TO_EDGE;
 		hasMipmap = false;
+		baseLevel = 0;
 		bufferId = 0;
 
 	}
@@ -194,6 +201,8 @@ public:
 	float tex_w; ///< Texture width (in pixels).
 	float tex_h; ///< Texture height (in pixels).
 	float width, height; ///< Texture display size.
+	int depth; ///< Number of layers of GL_TEXTURE_2D_ARRAY textures, 1 otherwise.
+	int layer; ///< Layer of a GL_TEXTURE_2D_ARRAY texture sampled by the default shaders.
 	
 	bool bFlipTexture; ///< Should the texture be flipped vertically?
 	ofTexCompression compressionType; ///< Texture compression type.
@@ -212,6 +221,7 @@ private:
 	glm::mat4 textureMatrix; ///< For required transformations.
 	bool useTextureMatrix; ///< Apply the transformation matrix?
 	bool hasMipmap; ///< True if mipmap has been generated for this texture, false by default.
+	int baseLevel; ///< Finest mipmap level with data while streaming levels with loadMipmapData().
 
 	friend class ofTexture;
 
@@ -395,6 +405,31 @@ class ofTexture : public ofBaseDraws {
 	/// \param buffer Reference to ofBufferObject instance.
 	/// \param glInternalFormat Internal pixel format of the data.
 	void allocateAsBufferTexture(const ofBufferObject & buffer, int glInternalFormat);
+
+	/// \brief Allocate the texture as a GL_TEXTURE_2D_ARRAY.
+	///
+	/// All the layers have the same size and format, and are loaded one at
+	/// a time with loadLayerData(). Binding an array texture binds all of
+	/// its layers, so sprites with different images can be drawn without
+	/// rebinding, picking the layer per instance with
+	/// ofInstancedMesh::setLayer():
+	///
+	/// ~~~~{.cpp}
+	/// sprites.allocateAsArray(64, 64, images.size(), GL_RGBA8);
+	/// for(size_t i = 0; i < images.size(); i++){
+	///     sprites.loadLayerData(images[i].getPixels(), i);
+	/// }
+	/// ~~~~
+	///
+	/// The default shaders sample the layer set with setDrawLayer() plus
+	/// the instance layer, with normalized texture coordinates. Needs
+	/// OpenGL 3.0.
+	///
+	/// \param w Width of each layer.
+	/// \param h Height of each layer.
+	/// \param numLayers Number of layers.
+	/// \param glInternalFormat Internal pixel format of the data.
+	void allocateAsArray(int w, int h, int numLayers, int glInternalFormat);
 #endif
 
 
@@ -552,8 +587,111 @@ class ofTexture : public ofBaseDraws {
 	/// \param glFormat GL pixel type: GL_RGBA, GL_LUMINANCE, etc.
 	/// \param glType the GL type to load.
 	void loadData(const ofBufferObject & buffer, int glFormat, int glType);
+
+	/// \brief Load the newest frame written to an ofPixelUploader
+	///
+	/// The uploader keeps a pool of mapped PBOs that other threads can
+	/// write frames to, this only starts the transfer from the newest one
+	/// to the texture so it barely costs anything on the GL thread.
+	///
+	/// \param uploader The uploader to load the frame from.
+	/// \returns true if there was a new frame to load.
+	bool loadData(ofPixelUploader & uploader);
 #endif
 
+#ifndef TARGET_OPENGLES
+	/// \brief Load pixels into one layer of an array texture
+	///
+	/// \sa allocateAsArray()
+	/// \param pix Pixels to load, the same size as the layers or smaller.
+	/// \param layer Layer to load them to.
+	void loadLayerData(const ofPixels & pix, int layer);
+	void loadLayerData(const ofShortPixels & pix, int layer);
+	void loadLayerData(const ofFloatPixels & pix, int layer);
+
+	/// \brief Load raw data into one layer of an array texture
+	///
+	/// \param data Pointer to the pixel data.
+	/// \param w Pixel data width.
+	/// \param h Pixel data height.
+	/// \param layer Layer to load the data to.
+	/// \param glFormat GL pixel type: GL_RGBA, GL_LUMINANCE, etc.
+	/// \param glType the OpenGL type of the data.
+	void loadLayerData(const void * data, int w, int h, int layer, int glFormat, int glType);
+#endif
+
+	/// \brief Number of layers of an array texture, 1 for other textures
+	int getNumLayers() const;
+
+	/// \brief Layer of an array texture drawn by the default shaders, 0
+	/// by default
+	///
+	/// With ofInstancedMesh it's added to the layer of each instance.
+	void setDrawLayer(int layer);
+	int getDrawLayer() const;
+
+#ifndef TARGET_OPENGLES
+	/// \brief Whether textures can be accessed from shaders through
+	/// 64 bit handles, needs ARB_bindless_texture
+	static bool isBindlessSupported();
+
+	/// \brief Handle to sample this texture from any shader without
+	/// binding it, made resident the first time it's requested
+	///
+	/// Handles can be stored in uniforms, or in buffers to access a
+	/// different texture per instance or per draw of a multi draw call:
+	///
+	/// ~~~~{.cpp}
+	/// std::vector<GLuint64> handles;
+	/// for(auto & texture: textures){
+	///     handles.push_back(texture.getBindlessHandle());
+	/// }
+	/// handlesBuffer.allocate(handles, GL_STATIC_DRAW);
+	/// handlesBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+	/// ~~~~
+	///
+	/// and read in GLSL with `#extension GL_ARB_bindless_texture : require`
+	/// as `layout(std430, binding=0) buffer Handles{ sampler2D textures[]; };`.
+	///
+	/// Once a handle is created the texture's parameters, like filters and
+	/// wrap modes, can't change, and it can't be reallocated. The handle
+	/// is released with the GL texture.
+	///
+	/// \returns the handle or 0 if bindless textures aren't supported.
+	GLuint64 getBindlessHandle() const;
+
+	/// \brief Makes the handle non resident, it can't be used by shaders
+	/// until getBindlessHandle() is called again
+	void releaseBindlessHandle() const;
+#endif
+
+	/// \brief Allocate the texture with compressed data and its mipmaps
+	///
+	/// The data is uploaded as is with glCompressedTexImage2D, the texture
+	/// is always GL_TEXTURE_2D and keeps the GPU format, it uses a fraction
+	/// of the memory and bandwidth of the uncompressed pixels.
+	///
+	/// \param data Levels loaded from a DDS or KTX file, see ofCompressedTextureData.
+	/// \returns false if the format isn't supported by the graphics card.
+	bool loadData(const ofCompressedTextureData & data);
+
+	/// \brief Allocate an empty GL_TEXTURE_2D in a block compressed format
+	/// to be filled with loadCompressedData()
+	///
+	/// \param glInternalFormat A BCn format like GL_COMPRESSED_RGBA_S3TC_DXT5_EXT.
+	/// \returns false if the format isn't supported by the graphics card.
+	bool allocateCompressed(int w, int h, GLint glInternalFormat);
+
+	/// \brief Replace the whole image of a texture from allocateCompressed()
+	/// with blocks in its format, using glCompressedTexSubImage2D
+	///
+	/// Video players use it to upload frames that are already compressed,
+	/// like HAP, without decoding them on the CPU.
+	///
+	/// \param data The 4x4 blocks, row by row.
+	/// \param bytes Size of data, has to match the texture's size and format.
+	void loadCompressedData(const void * data, std::size_t bytes);
+
 	/// \brief Copy an area of the screen into this texture.
 	///
 	/// Specifiy the position (x,y) you wish to grab from, with the width (w)
@@ -858,10 +996,74 @@ class ofTexture : public ofBaseDraws {
 	/// \param pixels Target pixels reference.
 	void readToPixels(ofFloatPixels & pixels) const;
 
+	/// \brief Read only a region of the texture from the GPU into pixels.
+	///
+	/// The region is in texels from the first row of the texture and is
+	/// clipped to it, only those texels are transferred. Unlike the full
+	/// readToPixels() this works in OpenGL ES too.
+	///
+	/// \param pixels Target pixels reference, allocated to the region size.
+	/// \param region The texels to read.
+	void readToPixels(ofPixels & pixels, const ofRectangle & region) const;
+	void readToPixels(ofShortPixels & pixels, const ofRectangle & region) const;
+	void readToPixels(ofFloatPixels & pixels, const ofRectangle & region) const;
+
+	/// \brief Copies a region of this texture into another texture without
+	/// drawing it or reading it back to the CPU.
+	///
+	/// Uses glCopyImageSubData where it's supported and both textures have
+	/// the same internal format, otherwise the texels are copied through a
+	/// framebuffer with glCopyTexSubImage2D, which can also convert to a
+	/// format with the same or fewer channels:
+	///
+	/// ~~~~{.cpp}
+	/// // composites a 256x256 tile of the atlas into the canvas
+	/// atlas.copyTo(canvas, ofRectangle(512, 0, 256, 256), glm::vec2(100, 100));
+	/// ~~~~
+	///
+	/// Regions are in texels from the first row of each texture, the copy
+	/// is clipped to both textures and only writes the first mipmap level
+	/// of dst. dst can only be this same texture with glCopyImageSubData.
+	///
+	/// \param dst The texture to copy to.
+	/// \param srcRegion The texels of this texture to copy.
+	/// \param dstPosition Where the region goes in dst.
+	/// \returns false if nothing was copied.
+	bool copyTo(ofTexture & dst, const ofRectangle & srcRegion, const glm::vec2 & dstPosition) const;
+
+	/// \brief Copies the whole texture into the same texels of dst.
+	bool copyTo(ofTexture & dst) const;
+
 #ifndef TARGET_OPENGLES
 	/// \brief Copy the texture to an ofBufferObject.
 	/// \param buffer the target buffer to copy to.
 	void copyTo(ofBufferObject & buffer) const;
+
+	/// \brief Copy only a region of the texture to an ofBufferObject,
+	/// tightly packed.
+	/// \param buffer the target buffer to copy to.
+	/// \param region The texels to copy, clipped to the texture.
+	void copyTo(ofBufferObject & buffer, const ofRectangle & region) const;
+
+	/// \brief Start reading the texture back to the CPU without blocking.
+	///
+	/// The copy is done into a pool of pixel buffers owned by the texture,
+	/// the result can be collected some frames later with
+	/// getAsyncPixels(). See ofPixelReadback for more control over the
+	/// pool or to access the mapped data directly.
+	///
+	/// \returns false if all the buffers in the pool are still in use.
+	bool readToPixelsAsync() const;
+
+	/// \brief Collect the oldest completed readToPixelsAsync().
+	/// \param pixels Target pixels reference.
+	/// \returns false if no read has been completed yet.
+	bool getAsyncPixels(ofPixels & pixels) const;
+	bool getAsyncPixels(ofShortPixels & pixels) const;
+	bool getAsyncPixels(ofFloatPixels & pixels) const;
+
+	/// \brief The pool of buffers used by readToPixelsAsync()
+	ofPixelReadback & getAsyncReadback() const;
 #endif
 
 	/// \section Texture Data
@@ -922,6 +1124,48 @@ class ofTexture : public ofBaseDraws {
 	/// \sa generateMipmap()
 	/// \sa enableMipmap()
 	bool hasMipmap() const;
+
+	/// \brief Number of levels of a full mipmap chain for the size of the
+	/// texture, down to 1x1
+	int getNumMipmapLevels() const;
+
+#ifndef TARGET_OPENGLES
+	/// \brief Upload one level of the mipmap chain
+	///
+	/// Lets a big texture show as soon as its smallest levels are
+	/// uploaded, instead of waiting for the full resolution upload and
+	/// generateMipmap(). Levels have to be uploaded from the smallest,
+	/// getNumMipmapLevels() - 1, to the biggest, 0: until level 0 is
+	/// loaded the texture samples from the finest level uploaded so far,
+	/// so it sharpens as levels arrive.
+	///
+	/// ~~~~{.cpp}
+	/// // in a thread
+	/// std::vector<ofPixels> levels(1, pixels);
+	/// while(levels.back().getWidth() > 1 || levels.back().getHeight() > 1){
+	///     levels.emplace_back();
+	///     levels[levels.size() - 2].halveTo(levels.back());
+	/// }
+	///
+	/// // in the main thread, one level per frame
+	/// texture.allocate(pixels.getWidth(), pixels.getHeight(), GL_RGBA8, false);
+	/// texture.loadMipmapData(levels[nextLevel], nextLevel);
+	/// ~~~~
+	///
+	/// Loading level 0 with loadData() also completes the chain. Only
+	/// GL_TEXTURE_2D textures, allocated without ARB textures, can stream
+	/// their levels.
+	///
+	/// \param level The size of the pixels has to be the size of the
+	/// texture divided by 2^level, rounded down and at least 1.
+	void loadMipmapData(const ofPixels & pix, int level);
+	void loadMipmapData(const ofShortPixels & pix, int level);
+	void loadMipmapData(const ofFloatPixels & pix, int level);
+	void loadMipmapData(const void * data, int w, int h, int level, int glFormat, int glType);
+
+	/// \brief Finest mipmap level loaded, 0 once the chain is complete
+	int getMipmapBaseLevel() const;
+#endif
 	
 	/// \internal
 	ofTextureData texData; ///< Internal texture data access.
@@ -944,5 +1188,8 @@ protected:
 
 private:
 	bool bWantsMipmap; ///< Should mipmaps be created?
+#ifndef TARGET_OPENGLES
+	mutable std::shared_ptr<ofPixelReadback> asyncReadback; ///< Created on the first readToPixelsAsync()
+#endif
 	
 };
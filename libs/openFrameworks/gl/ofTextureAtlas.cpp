@@ -0,0 +1,393 @@
+#include "ofTextureAtlas.h"
+#include "ofImage.h"
+#include "ofGraphics.h"
+#include "ofFileUtils.h"
+#include "ofJson.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <limits>
+
+using namespace std;
+
+//----------------------------------------------------------
+ofTextureAtlas::ofTextureAtlas()
+:numRegions(0)
+,batching(false){
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::setup(const Settings & settings){
+	clear();
+	this->settings = settings;
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::clear(){
+	pages.clear();
+	names.clear();
+	batches.clear();
+	numRegions = 0;
+}
+
+//----------------------------------------------------------
+ofTextureAtlas::Page & ofTextureAtlas::addPage(){
+	pages.emplace_back();
+	Page & page = pages.back();
+	page.pixels.allocate(settings.pageWidth, settings.pageHeight, OF_PIXELS_RGBA);
+	page.pixels.set(0);
+	page.skyline.push_back({0, 0, settings.pageWidth});
+	return page;
+}
+
+//----------------------------------------------------------
+bool ofTextureAtlas::findPosition(const Page & page, int w, int h, int & x, int & y, size_t & segment) const{
+	// the lowest spot, and the leftmost of those, where the rectangle
+	// rests on the skyline
+	bool found = false;
+	int bestY = numeric_limits<int>::max();
+	for(size_t i = 0; i < page.skyline.size(); i++){
+		int left = page.skyline[i].x;
+		if(left + w > settings.pageWidth){
+			break;
+		}
+		int top = 0;
+		for(size_t j = i; j < page.skyline.size() && page.skyline[j].x < left + w; j++){
+			top = max(top, page.skyline[j].y);
+		}
+		if(top + h <= settings.pageHeight && top < bestY){
+			bestY = top;
+			x = left;
+			y = top;
+			segment = i;
+			found = true;
+		}
+	}
+	return found;
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::place(Page & page, size_t segment, int x, int y, int w, int h){
+	auto & skyline = page.skyline;
+	skyline.insert(skyline.begin() + segment, Segment{x, y + h, w});
+	// the new segment covers the start of the ones after it
+	for(size_t i = segment + 1; i < skyline.size();){
+		int covered = skyline[i - 1].x + skyline[i - 1].width - skyline[i].x;
+		if(covered <= 0){
+			break;
+		}
+		skyline[i].x += covered;
+		skyline[i].width -= covered;
+		if(skyline[i].width <= 0){
+			skyline.erase(skyline.begin() + i);
+		}else{
+			break;
+		}
+	}
+	for(size_t i = 0; i + 1 < skyline.size();){
+		if(skyline[i].y == skyline[i + 1].y){
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}else{
+			i++;
+		}
+	}
+	page.usedArea += uint64_t(w) * h;
+}
+
+//----------------------------------------------------------
+ofTextureAtlas::Region ofTextureAtlas::add(const ofPixels & pixels){
+	Region region;
+	if(!pixels.isAllocated()){
+		ofLogError("ofTextureAtlas") << "add(): pixels not allocated";
+		return region;
+	}
+	int w = pixels.getWidth() + settings.padding * 2;
+	int h = pixels.getHeight() + settings.padding * 2;
+	if(w > settings.pageWidth || h > settings.pageHeight){
+		ofLogError("ofTextureAtlas") << "add(): " << pixels.getWidth() << "x" << pixels.getHeight()
+			<< " image doesn't fit in a " << settings.pageWidth << "x" << settings.pageHeight << " page";
+		return region;
+	}
+
+	int x = 0, y = 0;
+	size_t segment = 0;
+	size_t pageIndex = 0;
+	for(; pageIndex < pages.size(); pageIndex++){
+		if(findPosition(pages[pageIndex], w, h, x, y, segment)){
+			break;
+		}
+	}
+	if(pageIndex == pages.size()){
+		findPosition(addPage(), w, h, x, y, segment);
+	}
+	Page & page = pages[pageIndex];
+	place(page, segment, x, y, w, h);
+
+	const ofPixels * rgba = &pixels;
+	ofPixels converted;
+	if(pixels.getPixelFormat() != OF_PIXELS_RGBA){
+		converted = pixels;
+		if(converted.getPixelFormat() == OF_PIXELS_BGR || converted.getPixelFormat() == OF_PIXELS_BGRA){
+			converted.swapRgb();
+		}
+		converted.setImageType(OF_IMAGE_COLOR_ALPHA);
+		rgba = &converted;
+	}
+	rgba->pasteInto(page.pixels, x + settings.padding, y + settings.padding);
+	page.dirty = true;
+	numRegions++;
+
+	region.page = pageIndex;
+	region.rect.set(x + settings.padding, y + settings.padding, pixels.getWidth(), pixels.getHeight());
+	return region;
+}
+
+//----------------------------------------------------------
+ofTextureAtlas::Region ofTextureAtlas::add(const string & name, const ofPixels & pixels){
+	// the space of a replaced image isn't reused until the atlas is cleared
+	auto region = add(pixels);
+	if(region.isValid()){
+		names[name] = region;
+	}
+	return region;
+}
+
+//----------------------------------------------------------
+bool ofTextureAtlas::has(const string & name) const{
+	return names.find(name) != names.end();
+}
+
+//----------------------------------------------------------
+ofTextureAtlas::Region ofTextureAtlas::get(const string & name) const{
+	auto it = names.find(name);
+	if(it == names.end()){
+		return Region();
+	}
+	return it->second;
+}
+
+//----------------------------------------------------------
+size_t ofTextureAtlas::getNumPages() const{
+	return pages.size();
+}
+
+//----------------------------------------------------------
+size_t ofTextureAtlas::getNumRegions() const{
+	return numRegions;
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::uploadPage(const Page & page) const{
+	if(!page.texture.isAllocated()){
+		// GL_TEXTURE_2D so the pages can have mipmaps
+		page.texture.allocate(page.pixels.getWidth(), page.pixels.getHeight(), GL_RGBA8, false);
+		if(settings.mipmaps){
+			page.texture.enableMipmap();
+		}
+	}
+	page.texture.loadData(page.pixels);
+	if(settings.mipmaps){
+		page.texture.setTextureMinMagFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+	}
+	page.dirty = false;
+}
+
+//----------------------------------------------------------
+const ofTexture & ofTextureAtlas::getTexture(size_t page) const{
+	if(page >= pages.size()){
+		ofLogError("ofTextureAtlas") << "getTexture(): page " << page << " out of range";
+		static ofTexture * empty = new ofTexture;
+		return *empty;
+	}
+	if(pages[page].dirty){
+		uploadPage(pages[page]);
+	}
+	return pages[page].texture;
+}
+
+//----------------------------------------------------------
+const ofPixels & ofTextureAtlas::getPixels(size_t page) const{
+	if(page >= pages.size()){
+		ofLogError("ofTextureAtlas") << "getPixels(): page " << page << " out of range";
+		static ofPixels * empty = new ofPixels;
+		return *empty;
+	}
+	return pages[page].pixels;
+}
+
+//----------------------------------------------------------
+float ofTextureAtlas::getOccupancy() const{
+	if(pages.empty()) return 0;
+	uint64_t used = 0;
+	for(auto & page: pages){
+		used += page.usedArea;
+	}
+	return double(used) / (double(settings.pageWidth) * settings.pageHeight * pages.size());
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::addQuad(ofMesh & mesh, const Region & region, float x, float y, float w, float h) const{
+	if(!region.isValid() || size_t(region.page) >= pages.size()) return;
+	auto & texture = getTexture(region.page);
+	if(ofGetRectMode() == OF_RECTMODE_CENTER){
+		x -= w / 2;
+		y -= h / 2;
+	}
+	float y0 = y;
+	float y1 = y + h;
+	// same orientation as ofTexture::draw
+	if(!ofIsVFlipped()){
+		swap(y0, y1);
+	}
+	auto t0 = texture.getCoordFromPoint(region.rect.x, region.rect.y);
+	auto t1 = texture.getCoordFromPoint(region.rect.x + region.rect.width, region.rect.y + region.rect.height);
+
+	mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+	auto first = ofIndexType(mesh.getNumVertices());
+	mesh.addVertex({x, y0, 0});
+	mesh.addVertex({x + w, y0, 0});
+	mesh.addVertex({x + w, y1, 0});
+	mesh.addVertex({x, y1, 0});
+	mesh.addTexCoord({t0.x, t0.y});
+	mesh.addTexCoord({t1.x, t0.y});
+	mesh.addTexCoord({t1.x, t1.y});
+	mesh.addTexCoord({t0.x, t1.y});
+	mesh.addTriangle(first, first + 1, first + 2);
+	mesh.addTriangle(first, first + 2, first + 3);
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::draw(const Region & region, float x, float y) const{
+	draw(region, x, y, region.rect.width, region.rect.height);
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::draw(const Region & region, float x, float y, float w, float h) const{
+	if(!region.isValid() || size_t(region.page) >= pages.size()) return;
+	if(batching){
+		if(batches.size() < pages.size()){
+			batches.resize(pages.size());
+		}
+		addQuad(batches[region.page], region, x, y, w, h);
+	}else{
+		auto & rect = region.rect;
+		getTexture(region.page).drawSubsection(x, y, w, h, rect.x, rect.y, rect.width, rect.height);
+	}
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::draw(const string & name, float x, float y) const{
+	draw(get(name), x, y);
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::draw(const string & name, float x, float y, float w, float h) const{
+	draw(get(name), x, y, w, h);
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::beginBatch(){
+	batching = true;
+}
+
+//----------------------------------------------------------
+void ofTextureAtlas::endBatch(){
+	batching = false;
+	for(size_t i = 0; i < batches.size(); i++){
+		auto & mesh = batches[i];
+		if(mesh.getNumVertices() == 0) continue;
+		auto & texture = getTexture(i);
+		texture.bind();
+		mesh.draw();
+		texture.unbind();
+		// keeps the memory for the next batch
+		mesh.clear();
+	}
+}
+
+//----------------------------------------------------------
+bool ofTextureAtlas::save(const std::filesystem::path & folder) const{
+	if(!ofDirectory::createDirectory(folder, true, true) && !ofDirectory::doesDirectoryExist(folder)){
+		ofLogError("ofTextureAtlas") << "save(): couldn't create folder " << folder;
+		return false;
+	}
+	ofJson json;
+	json["pageWidth"] = settings.pageWidth;
+	json["pageHeight"] = settings.pageHeight;
+	json["padding"] = settings.padding;
+	json["mipmaps"] = settings.mipmaps;
+	json["numRegions"] = numRegions;
+	json["pages"] = ofJson::array();
+	for(size_t i = 0; i < pages.size(); i++){
+		auto file = "page_" + ofToString(i) + ".png";
+		auto path = folder / file;
+		ofSaveImage(pages[i].pixels, path);
+		if(!ofFile::doesFileExist(path)){
+			ofLogError("ofTextureAtlas") << "save(): couldn't save page " << path;
+			return false;
+		}
+		ofJson page;
+		page["file"] = file;
+		page["usedArea"] = pages[i].usedArea;
+		page["skyline"] = ofJson::array();
+		for(auto & segment: pages[i].skyline){
+			page["skyline"].push_back({segment.x, segment.y, segment.width});
+		}
+		json["pages"].push_back(page);
+	}
+	json["regions"] = ofJson::object();
+	for(auto & named: names){
+		auto & r = named.second;
+		json["regions"][named.first] = {r.page, r.rect.x, r.rect.y, r.rect.width, r.rect.height};
+	}
+	return ofSavePrettyJson(folder / "atlas.json", json);
+}
+
+//----------------------------------------------------------
+bool ofTextureAtlas::load(const std::filesystem::path & folder){
+	auto json = ofLoadJson(folder / "atlas.json");
+	if(json.is_null()){
+		return false;
+	}
+	try{
+		Settings loaded;
+		loaded.pageWidth = json["pageWidth"].get<int>();
+		loaded.pageHeight = json["pageHeight"].get<int>();
+		loaded.padding = json["padding"].get<int>();
+		loaded.mipmaps = json["mipmaps"].get<bool>();
+		setup(loaded);
+		for(auto & pageJson: json["pages"]){
+			pages.emplace_back();
+			Page & page = pages.back();
+			auto file = pageJson["file"].get<string>();
+			if(!ofLoadImage(page.pixels, folder / file)){
+				ofLogError("ofTextureAtlas") << "load(): couldn't load page " << folder / file;
+				clear();
+				return false;
+			}
+			page.pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+			if(int(page.pixels.getWidth()) != settings.pageWidth || int(page.pixels.getHeight()) != settings.pageHeight){
+				ofLogError("ofTextureAtlas") << "load(): page " << file << " doesn't have the size of the atlas";
+				clear();
+				return false;
+			}
+			page.usedArea = pageJson["usedArea"].get<uint64_t>();
+			for(auto & segment: pageJson["skyline"]){
+				page.skyline.push_back({segment[0].get<int>(), segment[1].get<int>(), segment[2].get<int>()});
+			}
+		}
+		for(auto it = json["regions"].begin(); it != json["regions"].end(); ++it){
+			auto & r = it.value();
+			Region region;
+			region.page = r[0].get<int>();
+			region.rect.set(r[1].get<float>(), r[2].get<float>(), r[3].get<float>(), r[4].get<float>());
+			names[it.key()] = region;
+		}
+		numRegions = json["numRegions"].get<size_t>();
+	}catch(std::exception & e){
+		ofLogError("ofTextureAtlas") << "load(): wrong format in " << folder / "atlas.json" << ": " << e.what();
+		clear();
+		return false;
+	}
+	return true;
+}
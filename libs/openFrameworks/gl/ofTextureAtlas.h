@@ -0,0 +1,150 @@
+#pragma once
+
+#include "ofTexture.h"
+#include "ofPixels.h"
+#include "ofRectangle.h"
+#include "ofMesh.h"
+#include <unordered_map>
+
+/// \brief Packs many small images into a few big textures at runtime
+///
+/// Every image added is copied into a page, an RGBA texture of
+/// Settings::pageWidth x pageHeight, at a free spot found with a skyline
+/// bottom left packer. A new page is started when an image doesn't fit in
+/// any of the current ones. Images are referred to by the Region returned
+/// when adding them, or by their name:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofDirectory icons("icons");
+///     for(auto & file: icons.getFiles()){
+///         ofPixels pixels;
+///         ofLoadImage(pixels, file.path());
+///         atlas.add(file.getBaseName(), pixels);
+///     }
+/// }
+///
+/// void ofApp::draw(){
+///     // one draw call for all the icons in the same page
+///     atlas.beginBatch();
+///     for(int i = 0; i < 100; i++){
+///         atlas.draw("star", i * 20, 10);
+///     }
+///     atlas.endBatch();
+/// }
+/// ~~~~
+///
+/// Outside of beginBatch() / endBatch() every draw is a
+/// ofTexture::drawSubsection() of its page. Inside, the quads are
+/// accumulated in one mesh per page and drawn with a single bind and draw
+/// call per page at endBatch(), the same way the programmable renderer
+/// batches untextured primitives.
+///
+/// The pages are uploaded to the GPU the first time they are drawn after
+/// adding images, so adding many images at once only uploads each page
+/// once. save() writes the pages and the layout to a folder that load()
+/// reads back, much faster than decoding and packing hundreds of files.
+class ofTextureAtlas{
+public:
+	struct Settings{
+		int pageWidth = 2048;
+		int pageHeight = 2048;
+		/// transparent pixels around each image so filtering doesn't
+		/// bleed the neighbours
+		int padding = 1;
+		bool mipmaps = false;
+	};
+
+	/// \brief Location of an image in the atlas
+	struct Region{
+		int page = -1;
+		ofRectangle rect; ///< in pixels of the page
+
+		bool isValid() const{ return page >= 0; }
+	};
+
+	ofTextureAtlas();
+
+	/// \brief Clears the atlas and sets the size of the new pages
+	void setup(const Settings & settings);
+	void clear();
+
+	/// \brief Copies pixels into the atlas
+	///
+	/// Gray and RGB pixels are converted to RGBA.
+	///
+	/// \returns the region or an invalid one if the image is bigger than
+	/// a page
+	Region add(const ofPixels & pixels);
+
+	/// \brief Copies pixels into the atlas so they can be looked up by
+	/// name, replacing any image with the same name
+	Region add(const std::string & name, const ofPixels & pixels);
+
+	bool has(const std::string & name) const;
+
+	/// \returns the region of a named image or an invalid one
+	Region get(const std::string & name) const;
+
+	std::size_t getNumPages() const;
+	std::size_t getNumRegions() const;
+
+	/// \brief Texture of a page, uploaded with any pending images
+	const ofTexture & getTexture(std::size_t page) const;
+
+	/// \brief Pixels of a page in memory
+	const ofPixels & getPixels(std::size_t page) const;
+
+	/// \brief Fraction of the pages' area covered by images
+	float getOccupancy() const;
+
+	void draw(const Region & region, float x, float y) const;
+	void draw(const Region & region, float x, float y, float w, float h) const;
+	void draw(const std::string & name, float x, float y) const;
+	void draw(const std::string & name, float x, float y, float w, float h) const;
+
+	/// \brief Accumulate the following draws and draw them with one draw
+	/// call per page at endBatch()
+	void beginBatch();
+	void endBatch();
+
+	/// \brief Quad of a region with texture coordinates of its page, to
+	/// build custom meshes
+	void addQuad(ofMesh & mesh, const Region & region, float x, float y, float w, float h) const;
+
+	/// \brief Saves the pages as PNGs and the named regions as atlas.json
+	///
+	/// \param folder created if needed, relative to the data folder
+	bool save(const std::filesystem::path & folder) const;
+
+	/// \brief Loads an atlas saved with save(), new images can be added
+	/// after loading it
+	bool load(const std::filesystem::path & folder);
+
+private:
+	// bottom left skyline, each segment is the lowest free y of a span of
+	// columns
+	struct Segment{
+		int x, y, width;
+	};
+
+	struct Page{
+		ofPixels pixels;
+		mutable ofTexture texture;
+		mutable bool dirty = true;
+		std::vector<Segment> skyline;
+		uint64_t usedArea = 0;
+	};
+
+	bool findPosition(const Page & page, int w, int h, int & x, int & y, std::size_t & segment) const;
+	void place(Page & page, std::size_t segment, int x, int y, int w, int h);
+	Page & addPage();
+	void uploadPage(const Page & page) const;
+
+	Settings settings;
+	std::vector<Page> pages;
+	std::unordered_map<std::string, Region> names;
+	std::size_t numRegions;
+	bool batching;
+	mutable std::vector<ofMesh> batches;
+};
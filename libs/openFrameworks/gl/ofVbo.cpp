@@ -9,6 +9,7 @@
 #include "ofVbo.h"
 #include "ofShader.h"
 #include "ofGLProgrammableRenderer.h"
+#include "ofGLStateCache.h"
 
 #ifdef TARGET_ANDROID
 #include "ofAppAndroidWindow.h"
@@ -16,6 +17,8 @@
 
 #include <map>
 #include <set>
+#include <algorithm>
+#include <limits>
 
 bool ofVbo::vaoSupported=true;
 bool ofVbo::vaoChecked=false;
@@ -23,7 +26,7 @@ bool ofVbo::vaoChecked=false;
 using namespace std;
 
 
-#ifdef TARGET_OPENGLES
+#if defined(TARGET_OPENGLES) && !defined(GL_ES_VERSION_3_0)
 	#include <dlfcn.h>
 	typedef void (* glGenVertexArraysType) (GLsizei n,  GLuint *arrays);
 	glGenVertexArraysType glGenVertexArraysFunc = nullptr;
@@ -43,6 +46,112 @@ static map<GLuint,int> & getVAOIds(){
 	return *ids;
 }
 
+namespace{
+#ifdef TARGET_OPENGLES
+	const GLenum indexGLType = GL_UNSIGNED_SHORT;
+#else
+	const GLenum indexGLType = GL_UNSIGNED_INT;
+#endif
+
+	// rounds to the nearest half float, ties to even
+	uint16_t toHalfFloat(float value){
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		uint32_t sign = (bits >> 16) & 0x8000;
+		bits &= 0x7fffffff;
+		uint16_t half;
+		if(bits >= 0x47800000){
+			// too big for a half, inf or nan
+			half = bits > 0x7f800000 ? 0x7e00 : 0x7c00;
+		}else if(bits < 0x38800000){
+			// denormals, adding 0.5 aligns the 10 bits of the mantissa
+			// at the bottom and lets the fpu round them
+			uint32_t magicBits = 126u << 23;
+			float magic;
+			memcpy(&magic, &magicBits, sizeof(magic));
+			float denormal;
+			memcpy(&denormal, &bits, sizeof(denormal));
+			denormal += magic;
+			memcpy(&bits, &denormal, sizeof(bits));
+			half = bits - magicBits;
+		}else{
+			uint32_t odd = (bits >> 13) & 1;
+			// rebias the exponent from 127 to 15 and round
+			bits += 0xc8000fffu + odd;
+			half = bits >> 13;
+		}
+		return sign | half;
+	}
+
+	GLsizei getElementSize(GLenum type, int numCoords){
+		switch(type){
+		case GL_HALF_FLOAT:
+			return numCoords * sizeof(uint16_t);
+		case GL_UNSIGNED_BYTE:
+			return numCoords;
+#ifdef GL_INT_2_10_10_10_REV
+		case GL_INT_2_10_10_10_REV:
+			return sizeof(uint32_t);
+#endif
+		default:
+			return numCoords * sizeof(float);
+		}
+	}
+
+	// converts total elements of sourceCoords floats, sourceStride bytes
+	// apart, to numCoords components of type, the ones missing are 0 except
+	// w which is 1
+	void packElements(GLenum type, int numCoords, const float * source, int sourceCoords, GLsizei sourceStride, int total, vector<unsigned char> & packed){
+		GLsizei size = getElementSize(type, numCoords);
+		packed.resize(size_t(total) * size);
+		auto src = reinterpret_cast<const unsigned char*>(source);
+		auto dst = packed.data();
+		for(int i = 0; i < total; i++, src += sourceStride, dst += size){
+			float element[4] = {0, 0, 0, 1};
+			memcpy(element, src, sourceCoords * sizeof(float));
+			switch(type){
+			case GL_HALF_FLOAT:{
+				uint16_t halfs[4];
+				for(int c = 0; c < numCoords; c++){
+					halfs[c] = toHalfFloat(element[c]);
+				}
+				memcpy(dst, halfs, size);
+				break;
+			}
+			case GL_UNSIGNED_BYTE:
+				for(int c = 0; c < numCoords; c++){
+					dst[c] = (unsigned char)std::round(std::max(0.f, std::min(element[c], 1.f)) * 255.f);
+				}
+				break;
+#ifdef GL_INT_2_10_10_10_REV
+			case GL_INT_2_10_10_10_REV:{
+				auto snorm = [](float v){
+					return uint32_t(int32_t(std::round(std::max(-1.f, std::min(v, 1.f)) * 511.f))) & 0x3ff;
+				};
+				uint32_t normal = snorm(element[0]) | snorm(element[1]) << 10 | snorm(element[2]) << 20;
+				memcpy(dst, &normal, sizeof(normal));
+				break;
+			}
+#endif
+			default:
+				memcpy(dst, element, size);
+				break;
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------
+ofVboFormat ofVboFormat::compact(){
+	ofVboFormat format;
+	format.halfFloatPositions = true;
+	format.halfFloatTexCoords = true;
+	format.packedNormals = true;
+	format.byteColors = true;
+	format.shortIndices = true;
+	return format;
+}
+
 //--------------------------------------------------------------
 static void retainVAO(GLuint id){
 	if(id==0) return;
@@ -62,6 +171,9 @@ static void releaseVAO(GLuint id){
 			if (!ofAppAndroidWindow::isSurfaceDestroyed())
 #endif
 				glDeleteVertexArrays(1, &id);
+#ifndef TARGET_OPENGLES
+			ofGetGLStateCache().deletedVertexArray(id);
+#endif
 			getVAOIds().erase(id);
 		}
 	}else{
@@ -71,6 +183,9 @@ static void releaseVAO(GLuint id){
 		if (!ofAppAndroidWindow::isSurfaceDestroyed())
 #endif
 			glDeleteVertexArrays(1, &id);
+#ifndef TARGET_OPENGLES
+		ofGetGLStateCache().deletedVertexArray(id);
+#endif
 	}
 }
 
@@ -81,7 +196,10 @@ ofVbo::VertexAttribute::VertexAttribute()
 ,numCoords(0)
 ,location(0)
 ,normalize(false)
-,divisor(0){
+,divisor(0)
+,type(GL_FLOAT)
+,sourceCoords(0)
+,sourceStride(0){
 
 }
 
@@ -118,23 +236,69 @@ GLuint ofVbo::VertexAttribute::getId() const{
 
 //--------------------------------------------------------------
 void ofVbo::VertexAttribute::updateData(GLintptr offset, GLsizeiptr bytes, const void * data){
+#ifndef TARGET_OPENGLES
+	// full updates of a persistent buffer go to the next region in the
+	// ring, the attribute offset is updated when the vbo is bound again
+	if(buffer.isPersistentlyMapped() && offset==0 && bytes<=buffer.getRegionSize()){
+		memcpy(buffer.mapNextRegion(), data, bytes);
+		this->offset = buffer.getCurrentRegionOffset();
+		return;
+	}
+#endif
 	buffer.updateData(offset,bytes,data);
 }
 
 
 //--------------------------------------------------------------
-void ofVbo::VertexAttribute::setData(const float * attrib0x, int numCoords, int total, int usage, int stride, bool normalize){
+void ofVbo::VertexAttribute::setData(const float * attrib0x, int numCoords, int total, int usage, int stride, bool normalize, bool persistent, GLenum type){
 	if (!isAllocated()) {
 		allocate();
 	}
-	GLsizeiptr size = (stride == 0) ? numCoords * sizeof(float) : stride;
-	this->stride = size;
-	this->numCoords = numCoords;
+	this->type = type;
+	this->sourceCoords = numCoords;
+	this->sourceStride = (stride == 0) ? numCoords * sizeof(float) : stride;
 	this->offset = 0;
-	this->normalize = normalize;
-	setData(total * size, attrib0x, usage);
+	const void * data = attrib0x;
+	vector<unsigned char> packed;
+	if(type == GL_FLOAT){
+		this->numCoords = numCoords;
+		this->stride = sourceStride;
+		this->normalize = normalize;
+	}else{
+		// 3 components are padded to 4 to keep every element aligned
+		this->numCoords = numCoords == 3 ? 4 : numCoords;
+		this->stride = getElementSize(type, this->numCoords);
+		this->normalize = type != GL_HALF_FLOAT;
+		packElements(type, this->numCoords, attrib0x, sourceCoords, sourceStride, total, packed);
+		data = packed.data();
+	}
+	GLsizeiptr size = this->stride;
+#ifndef TARGET_OPENGLES
+	if(persistent && usage==GL_STREAM_DRAW && ofBufferObject::isPersistentMappingSupported()){
+		// reuse the ring as long as the data fits in one region
+		if(!buffer.isPersistentlyMapped() || buffer.getRegionSize() < total * size){
+			buffer.allocatePersistentRing(total * size);
+		}
+		if(buffer.isPersistentlyMapped()){
+			updateData(0, total * size, data);
+			return;
+		}
+	}
+#endif
+	setData(total * size, data, usage);
 };
 
+//--------------------------------------------------------------
+void ofVbo::VertexAttribute::updateElements(int first, int total, const float * attrib0x){
+	if(type == GL_FLOAT){
+		updateData(first * stride, total * stride, attrib0x);
+		return;
+	}
+	vector<unsigned char> packed;
+	packElements(type, numCoords, attrib0x, sourceCoords, sourceStride, total, packed);
+	updateData(first * stride, total * stride, packed.data());
+}
+
 //--------------------------------------------------------------
 void ofVbo::VertexAttribute::setBuffer(ofBufferObject & buffer, int numCoords, int stride, int offset){
 	this->buffer = buffer;
@@ -142,16 +306,22 @@ void ofVbo::VertexAttribute::setBuffer(ofBufferObject & buffer, int numCoords, i
 	this->numCoords = numCoords;
 	GLsizeiptr size = (stride == 0) ? numCoords * sizeof(float) : stride;
 	this->stride = size;
-
+	this->type = GL_FLOAT;
+	this->sourceCoords = numCoords;
+	this->sourceStride = size;
 };
 
 //--------------------------------------------------------------
 void ofVbo::VertexAttribute::enable() const{
 	bind();
 	glEnableVertexAttribArray(location);
-	glVertexAttribPointer(location, numCoords, GL_FLOAT, normalize?GL_TRUE:GL_FALSE, stride, (void*)offset);
+	glVertexAttribPointer(location, numCoords, type, normalize?GL_TRUE:GL_FALSE, stride, (void*)offset);
 #ifndef TARGET_OPENGLES
 	glVertexAttribDivisor(location, divisor);
+#elif defined(GL_ES_VERSION_3_0)
+	if(ofGLSupportsInstancing()){
+		glVertexAttribDivisor(location, divisor);
+	}
 #endif
 	unbind();
 }
@@ -163,7 +333,7 @@ void ofVbo::VertexAttribute::disable() const{
 
 //--------------------------------------------------------------
 ofVbo::IndexAttribute::IndexAttribute()
-{
+:type(indexGLType){
 
 }
 
@@ -212,9 +382,11 @@ ofVbo::ofVbo(){
 	bUsingColors = false;
 	bUsingNormals = false;
 	bUsingIndices = false;
+	bUsingPersistentMapping = false;
 
 	totalVerts = 0;
 	totalIndices = 0;
+	interleavedStride = 0;
 
 	vaoChanged 		= false;
 	vaoID			= 0;
@@ -231,6 +403,8 @@ ofVbo::ofVbo(const ofVbo & mom){
 	bUsingColors = mom.bUsingColors;
 	bUsingNormals = mom.bUsingNormals;
 	bUsingIndices = mom.bUsingIndices;
+	bUsingPersistentMapping = mom.bUsingPersistentMapping;
+	format = mom.format;
 
 	positionAttribute = mom.positionAttribute;
 	colorAttribute = mom.colorAttribute;
@@ -238,6 +412,8 @@ ofVbo::ofVbo(const ofVbo & mom){
 	normalAttribute = mom.normalAttribute;
 
 	customAttributes = mom.customAttributes;
+	interleavedBuffer = mom.interleavedBuffer;
+	interleavedStride = mom.interleavedStride;
 	
 	totalVerts = mom.totalVerts;
 	totalIndices = mom.totalIndices;
@@ -259,6 +435,8 @@ ofVbo & ofVbo::operator=(const ofVbo& mom){
 	bUsingColors = mom.bUsingColors;
 	bUsingNormals = mom.bUsingNormals;
 	bUsingIndices = mom.bUsingIndices;
+	bUsingPersistentMapping = mom.bUsingPersistentMapping;
+	format = mom.format;
 
 	positionAttribute = mom.positionAttribute;
 	colorAttribute = mom.colorAttribute;
@@ -266,6 +444,8 @@ ofVbo & ofVbo::operator=(const ofVbo& mom){
 	normalAttribute = mom.normalAttribute;
 
 	customAttributes = mom.customAttributes;
+	interleavedBuffer = mom.interleavedBuffer;
+	interleavedStride = mom.interleavedStride;
 
 	totalVerts = mom.totalVerts;
 	totalIndices = mom.totalIndices;
@@ -345,7 +525,8 @@ void ofVbo::setVertexData(const ofVec2f * verts, int total, int usage) {
 
 //--------------------------------------------------------------
 void ofVbo::setVertexData(const float * vert0x, int numCoords, int total, int usage, int stride) {
-	positionAttribute.setData(vert0x, numCoords, total, usage, stride);
+	GLenum type = format.halfFloatPositions ? GL_HALF_FLOAT : GL_FLOAT;
+	positionAttribute.setData(vert0x, numCoords, total, usage, stride, false, bUsingPersistentMapping, type);
 	bUsingVerts = true;
 	totalVerts = total;
 }
@@ -357,7 +538,8 @@ void ofVbo::setColorData(const ofFloatColor * colors, int total, int usage) {
 
 //--------------------------------------------------------------
 void ofVbo::setColorData(const float * color0r, int total, int usage, int stride) {
-	colorAttribute.setData(color0r, 4, total, usage, stride);
+	GLenum type = format.byteColors ? GL_UNSIGNED_BYTE : GL_FLOAT;
+	colorAttribute.setData(color0r, 4, total, usage, stride, false, bUsingPersistentMapping, type);
 	enableColors();
 }
 
@@ -373,7 +555,12 @@ void ofVbo::setNormalData(const ofVec3f * normals, int total, int usage) {
 
 //--------------------------------------------------------------
 void ofVbo::setNormalData(const float * normal0x, int total, int usage, int stride) {
-	normalAttribute.setData(normal0x, 3, total, usage, stride);
+#ifdef GL_INT_2_10_10_10_REV
+	GLenum type = format.packedNormals ? GL_INT_2_10_10_10_REV : GL_FLOAT;
+#else
+	GLenum type = GL_FLOAT;
+#endif
+	normalAttribute.setData(normal0x, 3, total, usage, stride, false, bUsingPersistentMapping, type);
 	enableNormals();
 }
 
@@ -389,7 +576,8 @@ void ofVbo::setTexCoordData(const ofVec2f * texCoords, int total, int usage) {
 
 //--------------------------------------------------------------
 void ofVbo::setTexCoordData(const float * texCoord0x, int total, int usage, int stride) {
-	texCoordAttribute.setData(texCoord0x, 2, total, usage, stride);
+	GLenum type = format.halfFloatTexCoords ? GL_HALF_FLOAT : GL_FLOAT;
+	texCoordAttribute.setData(texCoord0x, 2, total, usage, stride, false, bUsingPersistentMapping, type);
 	enableTexCoords();
 }
 
@@ -401,7 +589,25 @@ void ofVbo::setIndexData(const ofIndexType * indices, int total, int usage){
 		enableIndices();
 	}
 	totalIndices = total;
-	indexAttribute.setData(sizeof(ofIndexType) * total, &indices[0], usage);
+	if(format.shortIndices && sizeof(ofIndexType) > sizeof(GLushort) && total > 0 &&
+	   *std::max_element(indices, indices + total) <= std::numeric_limits<GLushort>::max()){
+		vector<GLushort> shortIndices(indices, indices + total);
+		indexAttribute.type = GL_UNSIGNED_SHORT;
+		indexAttribute.setData(sizeof(GLushort) * total, shortIndices.data(), usage);
+	}else{
+		indexAttribute.type = indexGLType;
+		indexAttribute.setData(sizeof(ofIndexType) * total, &indices[0], usage);
+	}
+}
+
+//--------------------------------------------------------------
+void ofVbo::setFormat(const ofVboFormat & format){
+	this->format = format;
+}
+
+//--------------------------------------------------------------
+const ofVboFormat & ofVbo::getFormat() const{
+	return format;
 }
 
 //--------------------------------------------------------------
@@ -450,10 +656,10 @@ void ofVbo::setAttributeData(int location, const float * attrib0x, int numCoords
 		bUsingTexCoords |= (location == ofShader::TEXCOORD_ATTRIBUTE);
 	}
 
-	getOrCreateAttr(location).setData(attrib0x,numCoords,total,usage,stride,normalize);
+	getOrCreateAttr(location).setData(attrib0x,numCoords,total,usage,stride,normalize,bUsingPersistentMapping);
 }
 
-#ifndef TARGET_OPENGLES
+#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
 //--------------------------------------------------------------
 void ofVbo::setAttributeDivisor(int location, int divisor){
 	getOrCreateAttr(location).divisor = divisor;
@@ -491,7 +697,7 @@ void ofVbo::updateVertexData(const ofVec2f * verts, int total) {
 
 //--------------------------------------------------------------
 void ofVbo::updateVertexData(const float * vert0x, int total) {
-	positionAttribute.updateData(0, total * positionAttribute.stride, vert0x);
+	positionAttribute.updateElements(0, total, vert0x);
 }
 
 //--------------------------------------------------------------
@@ -501,7 +707,7 @@ void ofVbo::updateColorData(const ofFloatColor * colors, int total) {
 
 //--------------------------------------------------------------
 void ofVbo::updateColorData(const float * color0r, int total) {
-	colorAttribute.updateData(0, total * colorAttribute.stride, color0r);
+	colorAttribute.updateElements(0, total, color0r);
 }
 
 //--------------------------------------------------------------
@@ -516,7 +722,7 @@ void ofVbo::updateNormalData(const ofVec3f * normals, int total) {
 
 //--------------------------------------------------------------
 void ofVbo::updateNormalData(const float * normal0x, int total) {
-	normalAttribute.updateData(0, total * normalAttribute.stride, normal0x);
+	normalAttribute.updateElements(0, total, normal0x);
 }
 
 //--------------------------------------------------------------
@@ -531,13 +737,48 @@ void ofVbo::updateTexCoordData(const ofVec2f * texCoords, int total) {
 
 //--------------------------------------------------------------
 void ofVbo::updateTexCoordData(const float * texCoord0x, int total) {
-	texCoordAttribute.updateData(0, total * texCoordAttribute.stride, texCoord0x);
+	texCoordAttribute.updateElements(0, total, texCoord0x);
 }
 
 //--------------------------------------------------------------
 void ofVbo::updateIndexData(const ofIndexType * indices, int total) {
-	if(indexAttribute.isAllocated()) {
-		indexAttribute.updateData(0, total*sizeof(ofIndexType), indices);
+	updateIndexData(indices, 0, total);
+}
+
+//--------------------------------------------------------------
+void ofVbo::updateVertexData(const glm::vec3 * verts, int offset, int total) {
+	positionAttribute.updateElements(offset, total, &verts[0].x);
+}
+
+//--------------------------------------------------------------
+void ofVbo::updateColorData(const ofFloatColor * colors, int offset, int total) {
+	colorAttribute.updateElements(offset, total, &colors[0].r);
+}
+
+//--------------------------------------------------------------
+void ofVbo::updateNormalData(const glm::vec3 * normals, int offset, int total) {
+	normalAttribute.updateElements(offset, total, &normals[0].x);
+}
+
+//--------------------------------------------------------------
+void ofVbo::updateTexCoordData(const glm::vec2 * texCoords, int offset, int total) {
+	texCoordAttribute.updateElements(offset, total, &texCoords[0].x);
+}
+
+//--------------------------------------------------------------
+void ofVbo::updateIndexData(const ofIndexType * indices, int offset, int total) {
+	if(!indexAttribute.isAllocated()) {
+		return;
+	}
+	if(indexAttribute.type == GL_UNSIGNED_SHORT && sizeof(ofIndexType) > sizeof(GLushort)){
+		if(total > 0 && *std::max_element(indices, indices + total) > std::numeric_limits<GLushort>::max()){
+			ofLogError("ofVbo") << "updateIndexData(): indices don't fit in the 16 bit index buffer anymore, call setIndexData() instead";
+			return;
+		}
+		vector<GLushort> shortIndices(indices, indices + total);
+		indexAttribute.updateData(offset*sizeof(GLushort), total*sizeof(GLushort), shortIndices.data());
+	}else{
+		indexAttribute.updateData(offset*sizeof(ofIndexType), total*sizeof(ofIndexType), indices);
 	}
 }
 
@@ -569,7 +810,7 @@ void ofVbo::updateAttributeData(int location, const float * attr0x, int total){
 		}
 	}
 	if (attr !=nullptr && attr->isAllocated()) {
-		attr->updateData(0, total*attr->stride, attr0x);
+		attr->updateElements(0, total, attr0x);
 	}
 }
 
@@ -594,6 +835,20 @@ void ofVbo::enableTexCoords(){
 	}
 }
 
+#ifndef TARGET_OPENGLES
+void ofVbo::enablePersistentMapping(){
+	bUsingPersistentMapping = true;
+}
+
+void ofVbo::disablePersistentMapping(){
+	bUsingPersistentMapping = false;
+}
+
+bool ofVbo::getUsingPersistentMapping() const{
+	return bUsingPersistentMapping;
+}
+#endif
+
 void ofVbo::enableIndices(){
 	if(indexAttribute.isAllocated() && !bUsingIndices){
 		bUsingIndices=true;
@@ -659,6 +914,11 @@ bool ofVbo::getUsingIndices() const {
 	return  bUsingIndices;
 }
 
+//--------------------------------------------------------------
+GLenum ofVbo::getIndexType() const {
+	return indexAttribute.type;
+}
+
 //--------------------------------------------------------------
 GLuint ofVbo::getVaoId() const{
 	return vaoID;
@@ -736,9 +996,69 @@ void ofVbo::setTexCoordBuffer(ofBufferObject & buffer, int stride, int offset){
 	enableTexCoords();
 }
 
+//--------------------------------------------------------------
+void ofVbo::setInterleavedData(const void * vertices, int numVertices, const ofVboInterleavedLayout & layout, int usage, int reserveVertices){
+	if(layout.stride <= 0){
+		ofLogError("ofVbo") << "setInterleavedData(): the layout needs a stride";
+		return;
+	}
+	if(!interleavedBuffer.isAllocated()){
+		interleavedBuffer.allocate();
+	}
+	GLsizeiptr bytes = GLsizeiptr(numVertices) * layout.stride;
+	if(reserveVertices > numVertices){
+		interleavedBuffer.setData(GLsizeiptr(reserveVertices) * layout.stride, nullptr, usage);
+		if(bytes > 0){
+			interleavedBuffer.updateData(0, bytes, vertices);
+		}
+	}else{
+		interleavedBuffer.setData(bytes, vertices, usage);
+	}
+	interleavedStride = layout.stride;
+
+	// every attribute reads from the same buffer at its own offset
+	setVertexBuffer(interleavedBuffer, layout.positionCoords, layout.stride, layout.positionOffset);
+	totalVerts = numVertices;
+	if(layout.colorOffset >= 0){
+		setColorBuffer(interleavedBuffer, layout.stride, layout.colorOffset);
+	}else{
+		disableColors();
+	}
+	if(layout.normalOffset >= 0){
+		setNormalBuffer(interleavedBuffer, layout.stride, layout.normalOffset);
+	}else{
+		disableNormals();
+	}
+	if(layout.texCoordOffset >= 0){
+		setTexCoordBuffer(interleavedBuffer, layout.stride, layout.texCoordOffset);
+	}else{
+		disableTexCoords();
+	}
+}
+
+//--------------------------------------------------------------
+void ofVbo::updateInterleavedData(const void * vertices, int firstVertex, int numVertices){
+	if(!interleavedBuffer.isAllocated() || interleavedStride == 0){
+		ofLogError("ofVbo") << "updateInterleavedData(): call setInterleavedData() first";
+		return;
+	}
+	if(firstVertex + numVertices > getInterleavedCapacity()){
+		ofLogError("ofVbo") << "updateInterleavedData(): " << firstVertex + numVertices << " vertices don't fit in a buffer of " << getInterleavedCapacity();
+		return;
+	}
+	interleavedBuffer.updateData(GLintptr(firstVertex) * interleavedStride, GLsizeiptr(numVertices) * interleavedStride, vertices);
+}
+
+//--------------------------------------------------------------
+int ofVbo::getInterleavedCapacity() const{
+	if(!interleavedBuffer.isAllocated() || interleavedStride == 0) return 0;
+	return interleavedBuffer.size() / interleavedStride;
+}
+
 //--------------------------------------------------------------
 void ofVbo::setIndexBuffer(ofBufferObject & buffer){
 	indexAttribute.buffer = buffer;
+	indexAttribute.type = indexGLType;
 	vaoChanged = true;
 	enableIndices();
 }
@@ -822,7 +1142,7 @@ void ofVbo::bind() const{
 	bool programmable = ofIsGLProgrammableRenderer();
 	if(programmable && (vaoSupported || !vaoChecked)){
 		if(vaoID==0){
-			#ifdef TARGET_OPENGLES
+			#if defined(TARGET_OPENGLES) && !defined(GL_ES_VERSION_3_0)
 			if(glGenVertexArrays==0 && !vaoChecked){
 				glGenVertexArrays = (glGenVertexArraysType)dlsym(RTLD_DEFAULT, "glGenVertexArrays");
 				glDeleteVertexArrays = (glDeleteVertexArraysType)dlsym(RTLD_DEFAULT, "glDeleteVertexArrays");
@@ -830,6 +1150,12 @@ void ofVbo::bind() const{
 				vaoChecked = true;
 				vaoSupported = glGenVertexArrays;
 			}
+			#elif defined(TARGET_OPENGLES)
+			// built with the ES 3 headers but the context can still be ES 2
+			if(!vaoChecked){
+				vaoChecked = true;
+				vaoSupported = ofGLSupportsInstancing() || ofGLCheckExtension("GL_OES_vertex_array_object");
+			}
 			#else
 			vaoChecked = true;
 			vaoSupported = true;
@@ -840,18 +1166,24 @@ void ofVbo::bind() const{
 				vaoChanged = true;
 			}
 		}
+		#ifdef TARGET_OPENGLES
 		if(vaoSupported) glBindVertexArray(vaoID);
+		#else
+		if(vaoSupported) ofGetGLStateCache().bindVertexArray(vaoID);
+		#endif
 	}else{
 		vaoSupported = false;
 	}
 
-	if(vaoChanged || !vaoSupported){
+	// persistent attributes move to a different region of their
+	// buffer on every update so their pointers need to be set again
+	if(vaoChanged || !vaoSupported || bUsingPersistentMapping){
 		if(bUsingVerts){
 			if(!programmable){
 				positionAttribute.bind();
 				#ifndef TARGET_PROGRAMMABLE_GL
 				glEnableClientState(GL_VERTEX_ARRAY);
-				glVertexPointer(positionAttribute.numCoords, GL_FLOAT,
+				glVertexPointer(positionAttribute.numCoords, positionAttribute.type,
 								positionAttribute.stride,
 								(void*)positionAttribute.offset);
 				#endif
@@ -867,7 +1199,7 @@ void ofVbo::bind() const{
 				colorAttribute.bind();
 				#ifndef TARGET_PROGRAMMABLE_GL
 				glEnableClientState(GL_COLOR_ARRAY);
-				glColorPointer(colorAttribute.numCoords, GL_FLOAT,
+				glColorPointer(colorAttribute.numCoords, colorAttribute.type,
 						colorAttribute.stride,
 							   (void*)colorAttribute.offset);
 				#endif
@@ -883,7 +1215,7 @@ void ofVbo::bind() const{
 				normalAttribute.bind();
 				#ifndef TARGET_PROGRAMMABLE_GL
 				glEnableClientState(GL_NORMAL_ARRAY);
-				glNormalPointer(GL_FLOAT, normalAttribute.stride,
+				glNormalPointer(normalAttribute.type, normalAttribute.stride,
 								(void*)normalAttribute.offset);
 				#endif
 			}else{
@@ -899,7 +1231,7 @@ void ofVbo::bind() const{
 				#ifndef TARGET_PROGRAMMABLE_GL
 				glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 				glTexCoordPointer(texCoordAttribute.numCoords,
-								  GL_FLOAT, texCoordAttribute.stride,
+								  texCoordAttribute.type, texCoordAttribute.stride,
 								  (void*)texCoordAttribute.offset);
 				#endif
 			}else{
@@ -924,8 +1256,24 @@ void ofVbo::bind() const{
 
 //--------------------------------------------------------------
 void ofVbo::unbind() const{
+#ifndef TARGET_OPENGLES
+	if(bUsingPersistentMapping){
+		// the draw that used the current regions has been issued by now
+		positionAttribute.buffer.lockCurrentRegion();
+		colorAttribute.buffer.lockCurrentRegion();
+		normalAttribute.buffer.lockCurrentRegion();
+		texCoordAttribute.buffer.lockCurrentRegion();
+		for(auto & attr: customAttributes){
+			attr.second.buffer.lockCurrentRegion();
+		}
+	}
+#endif
 	if(vaoSupported){
+		#ifdef TARGET_OPENGLES
 		glBindVertexArray(0);
+		#else
+		ofGetGLStateCache().bindVertexArray(0);
+		#endif
 	}
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -960,8 +1308,8 @@ void ofVbo::drawInstanced(int drawMode, int first, int total, int primCount) con
 }
 
 //--------------------------------------------------------------
-void ofVbo::drawElementsInstanced(int drawMode, int amt, int primCount) const{
-	ofGetGLRenderer()->drawElementsInstanced(*this,drawMode,amt,primCount);
+void ofVbo::drawElementsInstanced(int drawMode, int amt, int primCount, int offsetelements) const{
+	ofGetGLRenderer()->drawElementsInstanced(*this,drawMode,amt,primCount,offsetelements);
 }
 
 //--------------------------------------------------------------
@@ -982,6 +1330,8 @@ void ofVbo::clear(){
 
 	// clear all custom attributes.
 	customAttributes.clear();
+	interleavedBuffer = ofBufferObject();
+	interleavedStride = 0;
 	
 	clearIndices();
 	if(vaoID!=0){
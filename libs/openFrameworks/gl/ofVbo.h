@@ -10,6 +10,56 @@
 #include "ofBufferObject.h"
 #include <map>
 
+/// \brief Describes where each attribute is in a vertex of interleaved data,
+/// offsets in bytes from the start of the vertex, -1 for the attributes
+/// the vertex doesn't have. Colors are 4 floats, normals 3 and texture
+/// coordinates 2
+struct ofVboInterleavedLayout{
+	int stride = 0;
+	int positionCoords = 3;
+	int positionOffset = 0;
+	int colorOffset = -1;
+	int normalOffset = -1;
+	int texCoordOffset = -1;
+};
+
+/// \brief Compact formats the ofVbo converts the vertex data to when it's
+/// uploaded, so it takes less memory and bandwidth on the GPU
+///
+/// The shaders still receive floats, so the default shaders and any custom
+/// one work with them unchanged:
+///
+/// ~~~~{.cpp}
+/// ofVbo vbo;
+/// vbo.setFormat(ofVboFormat::compact());
+/// vbo.setMesh(scan, GL_STATIC_DRAW);
+/// ~~~~
+///
+/// Half floats keep about 3 significant digits, fine for texture
+/// coordinates and positions of meshes around the origin a few units big,
+/// but not for the positions of a big scene.
+struct ofVboFormat{
+	/// \brief Positions as half floats, 3d ones get w = 1 to keep them 4
+	/// byte aligned
+	bool halfFloatPositions = false;
+
+	/// \brief Texture coordinates as half floats
+	bool halfFloatTexCoords = false;
+
+	/// \brief Normals as normalized 10:10:10:2 integers, 4 bytes instead of
+	/// 12, not available on OpenGL ES 2
+	bool packedNormals = false;
+
+	/// \brief Colors as normalized bytes, clamped to [0, 1]
+	bool byteColors = false;
+
+	/// \brief 16 bit indices when all the indices fit in them
+	bool shortIndices = false;
+
+	/// \brief All the compact formats enabled
+	static ofVboFormat compact();
+};
+
 class ofVbo {
 public:
 	
@@ -20,6 +70,12 @@ public:
 
 	void setMesh(const ofMesh & mesh, int usage);
 	void setMesh(const ofMesh & mesh, int usage, bool useColors, bool useTextures, bool useNormals);
+
+	/// \brief Formats the following set*Data() and update*Data() calls
+	/// convert the positions, colors, normals, texture coordinates and
+	/// indices to, data already uploaded keeps its format
+	void setFormat(const ofVboFormat & format);
+	const ofVboFormat & getFormat() const;
 	
 	void setVertexData(const glm::vec3 * verts, int total, int usage);
 	void setVertexData(const glm::vec2 * verts, int total, int usage);
@@ -40,10 +96,13 @@ public:
 
 	void setAttributeData(int location, const float * vert0x, int numCoords, int total, int usage, int stride=0);
 
-#ifndef TARGET_OPENGLES
+#if !defined(TARGET_OPENGLES) || defined(GL_ES_VERSION_3_0)
 	/// used to send an attribute per instance(s) instead of per vertex.
 	/// will send per vertex if set to 0 or to the number of instances if >0
 	///
+	/// on OpenGL ES it's only applied with an ES 3 context, see
+	/// ofGLSupportsInstancing()
+	///
 	/// see textureBufferInstancedExample
 	/// and https://www.opengl.org/sdk/docs/man4/html/glVertexAttribDivisor.xhtml
 	void setAttributeDivisor(int location, int divisor);
@@ -57,6 +116,21 @@ public:
 	
 	void setAttributeBuffer(int location, ofBufferObject & buffer, int numCoords, int stride, int offset=0);
 
+	/// \brief Uploads vertices with all their attributes interleaved in one
+	/// buffer, with a single glBufferData call
+	///
+	/// The buffer is allocated for at least reserveVertices, so data that
+	/// grows up to that size can be updated with updateInterleavedData()
+	/// instead of reallocating it.
+	void setInterleavedData(const void * vertices, int numVertices, const ofVboInterleavedLayout & layout, int usage, int reserveVertices = 0);
+
+	/// \brief Updates numVertices of the interleaved data starting at
+	/// firstVertex, they have to fit in the allocated buffer
+	void updateInterleavedData(const void * vertices, int firstVertex, int numVertices);
+
+	/// \returns the number of vertices the interleaved buffer can hold
+	int getInterleavedCapacity() const;
+
 	ofBufferObject & getVertexBuffer();
 	ofBufferObject & getColorBuffer();
 	ofBufferObject & getNormalBuffer();
@@ -92,6 +166,18 @@ public:
 
 	void updateAttributeData(int location, const float * vert0x, int total);
 
+	/// \brief Updates only the elements [offset, offset + total) of an
+	/// already allocated buffer
+	///
+	/// The pointers point to the data for the first element to update, not
+	/// to the start of the whole array. Buffers using persistent mapping
+	/// can only be updated as a whole.
+	void updateVertexData(const glm::vec3 * verts, int offset, int total);
+	void updateColorData(const ofFloatColor * colors, int offset, int total);
+	void updateNormalData(const glm::vec3 * normals, int offset, int total);
+	void updateTexCoordData(const glm::vec2 * texCoords, int offset, int total);
+	void updateIndexData(const ofIndexType * indices, int offset, int total);
+
 	void enableColors();
 	void enableNormals();
 	void enableTexCoords();
@@ -102,6 +188,22 @@ public:
 	void disableTexCoords();
 	void disableIndices();
 
+#ifndef TARGET_OPENGLES
+	/// when enabled, attributes set with GL_STREAM_DRAW usage are stored
+	/// in a persistently mapped, triple buffered ring of ofBufferObject
+	/// regions (GL 4.4+) so updating them every frame writes directly
+	/// into GPU visible memory instead of going through glBufferSubData.
+	/// Has no effect if ofBufferObject::isPersistentMappingSupported()
+	/// is false.
+	///
+	/// meant for data that is updated once per frame, updating the same
+	/// vbo more times per frame than regions in the ring will block
+	/// until the GPU is done with the oldest one
+	void enablePersistentMapping();
+	void disablePersistentMapping();
+	bool getUsingPersistentMapping() const;
+#endif
+
 	GLuint getVaoId() const;
 	GLuint getVertId() const;
 	GLuint getColorId() const;
@@ -118,12 +220,15 @@ public:
 	bool getUsingNormals() const;
 	bool getUsingTexCoords() const;
 	bool getUsingIndices() const;
+
+	/// \returns the type of the indices, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	GLenum getIndexType() const;
 	
 	void draw(int drawMode, int first, int total) const;
 	void drawElements(int drawMode, int amt, int offsetelements = 0) const;
 	
 	void drawInstanced(int drawMode, int first, int total, int primCount) const;
-	void drawElementsInstanced(int drawMode, int amt, int primCount) const;
+	void drawElementsInstanced(int drawMode, int amt, int primCount, int offsetelements = 0) const;
 	
 	void bind() const;
 	void unbind() const;
@@ -153,7 +258,8 @@ private:
 		void unbind() const;
 		void setData(GLsizeiptr bytes, const void * data, GLenum usage);
 		void updateData(GLintptr offset, GLsizeiptr bytes, const void * data);
-		void setData(const float * attrib0x, int numCoords, int total, int usage, int stride, bool normalize=false);
+		void setData(const float * attrib0x, int numCoords, int total, int usage, int stride, bool normalize=false, bool persistent=false, GLenum type=GL_FLOAT);
+		void updateElements(int first, int total, const float * attrib0x);
 		void setBuffer(ofBufferObject & buffer, int numCoords, int stride, int offset);
 		void enable() const;
 		void disable() const;
@@ -165,6 +271,11 @@ private:
 		GLuint location;
 		bool normalize;
 		int divisor;
+		// floats set are converted to type, from elements of sourceCoords
+		// sourceStride bytes apart
+		GLenum type;
+		int sourceCoords;
+		GLsizei sourceStride;
 	};
 
 	struct IndexAttribute{
@@ -177,6 +288,7 @@ private:
 		void updateData(GLintptr offset, GLsizeiptr bytes, const void * data);
 		GLuint getId() const;
 		ofBufferObject buffer;
+		GLenum type;
 	};
 
 	GLuint vaoID;
@@ -189,6 +301,8 @@ private:
 	mutable bool bUsingColors;
 	mutable bool bUsingNormals;
 	mutable bool bUsingIndices;
+	bool bUsingPersistentMapping;
+	ofVboFormat format;
 
 	int	totalVerts;
 	int	totalIndices;
@@ -198,6 +312,8 @@ private:
 	VertexAttribute texCoordAttribute;
 	VertexAttribute normalAttribute;
 	std::map<int,VertexAttribute> customAttributes;
+	ofBufferObject interleavedBuffer;
+	int interleavedStride;
 	
 	static bool vaoChecked;
 	static bool vaoSupported;
@@ -1,5 +1,6 @@
 #include "ofVboMesh.h"
 #include "ofBaseTypes.h"
+#include <limits>
 
 #ifdef TARGET_ANDROID
 #include "ofxAndroidUtils.h"
@@ -43,6 +44,24 @@ ofVboMesh::~ofVboMesh(){
 
 void ofVboMesh::setUsage(int _usage){
 	usage = _usage;
+#ifndef TARGET_OPENGLES
+	// meshes updated every frame stream through a persistently
+	// mapped ring buffer where available
+	if(usage==GL_STREAM_DRAW){
+		vbo.enablePersistentMapping();
+	}else{
+		vbo.disablePersistentMapping();
+	}
+#endif
+}
+
+void ofVboMesh::setFormat(const ofVboFormat & format){
+	vbo.setFormat(format);
+	unloadVbo();
+}
+
+const ofVboFormat & ofVboMesh::getFormat() const{
+	return vbo.getFormat();
 }
 
 void ofVboMesh::enableColors(){
@@ -151,62 +170,101 @@ void ofVboMesh::updateVbo(){
 		haveTexCoordsChanged();
 		haveIndicesChanged();
 	}else{
+		// only the ranges that changed are uploaded if the buffers are big
+		// enough, streamed buffers using persistent mapping are always
+		// updated as a whole
+		ofMeshDirtyRanges changed;
+		bool partial = !vbo.getUsingPersistentMapping();
 
-		if(haveVertsChanged()){
+		if(haveVertsChanged(changed)){
 			if(getNumVertices()==0){
 				vbo.clearVertices();
 				vboNumVerts = getNumVertices();
 			}else if(vboNumVerts<getNumVertices()){
 				vbo.setVertexData(getVerticesPointer(),getNumVertices(),usage);
 				vboNumVerts = getNumVertices();
+			}else if(partial && !changed.empty()){
+				for(auto & range: changed){
+					if(range.first >= getNumVertices()) break;
+					std::size_t end = std::min(range.second, getNumVertices());
+					vbo.updateVertexData(getVerticesPointer() + range.first, range.first, end - range.first);
+				}
 			}else{
 				vbo.updateVertexData(getVerticesPointer(),getNumVertices());
 			}
 		}
 
-		if(haveColorsChanged()){
+		if(haveColorsChanged(changed)){
 			if(getNumColors()==0){
 				vbo.clearColors();
 				vboNumColors = getNumColors();
 			}else if(vboNumColors<getNumColors()){
 				vbo.setColorData(getColorsPointer(),getNumColors(),usage);
 				vboNumColors = getNumColors();
+			}else if(partial && !changed.empty()){
+				for(auto & range: changed){
+					if(range.first >= getNumColors()) break;
+					std::size_t end = std::min(range.second, getNumColors());
+					vbo.updateColorData(getColorsPointer() + range.first, range.first, end - range.first);
+				}
 			}else{
 				vbo.updateColorData(getColorsPointer(),getNumColors());
 			}
 		}
 
-		if(haveNormalsChanged()){
+		if(haveNormalsChanged(changed)){
 			if(getNumNormals()==0){
 				vbo.clearNormals();
 				vboNumNormals = getNumNormals();
 			}else if(vboNumNormals<getNumNormals()){
 				vbo.setNormalData(getNormalsPointer(),getNumNormals(),usage);
 				vboNumNormals = getNumNormals();
+			}else if(partial && !changed.empty()){
+				for(auto & range: changed){
+					if(range.first >= getNumNormals()) break;
+					std::size_t end = std::min(range.second, getNumNormals());
+					vbo.updateNormalData(getNormalsPointer() + range.first, range.first, end - range.first);
+				}
 			}else{
 				vbo.updateNormalData(getNormalsPointer(),getNumNormals());
 			}
 		}
 
-		if(haveTexCoordsChanged()){
+		if(haveTexCoordsChanged(changed)){
 			if(getNumTexCoords()==0){
 				vbo.clearTexCoords();
 				vboNumTexCoords = getNumTexCoords();
 			}else if(vboNumTexCoords<getNumTexCoords()){
 				vbo.setTexCoordData(getTexCoordsPointer(),getNumTexCoords(),usage);
 				vboNumTexCoords = getNumTexCoords();
+			}else if(partial && !changed.empty()){
+				for(auto & range: changed){
+					if(range.first >= getNumTexCoords()) break;
+					std::size_t end = std::min(range.second, getNumTexCoords());
+					vbo.updateTexCoordData(getTexCoordsPointer() + range.first, range.first, end - range.first);
+				}
 			}else{
 				vbo.updateTexCoordData(getTexCoordsPointer(),getNumTexCoords());
 			}
 		}
 
-		if(haveIndicesChanged()){
+		if(haveIndicesChanged(changed)){
+			// 16 bit indices are uploaded again as 32 bit ones once the mesh
+			// has more vertices than they can address
+			bool shortIndicesOverflow = vbo.getIndexType() == GL_UNSIGNED_SHORT &&
+				sizeof(ofIndexType) > sizeof(GLushort) && getNumVertices() > std::numeric_limits<GLushort>::max() + std::size_t(1);
 			if(getNumIndices()==0){
 				vbo.clearIndices();
 				vboNumIndices = getNumIndices();
-			}else if(vboNumIndices<getNumIndices()){
+			}else if(vboNumIndices<getNumIndices() || shortIndicesOverflow){
 				vbo.setIndexData(getIndexPointer(),getNumIndices(),usage);
 				vboNumIndices = getNumIndices();
+			}else if(!changed.empty()){
+				for(auto & range: changed){
+					if(range.first >= getNumIndices()) break;
+					std::size_t end = std::min(range.second, getNumIndices());
+					vbo.updateIndexData(getIndexPointer() + range.first, range.first, end - range.first);
+				}
 			}else{
 				vbo.updateIndexData(getIndexPointer(),getNumIndices());
 			}
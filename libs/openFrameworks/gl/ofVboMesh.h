@@ -12,6 +12,11 @@ public:
 	virtual ~ofVboMesh();
 	void setUsage(int usage);
 
+	/// \brief Compact formats the mesh is uploaded with, the whole mesh is
+	/// uploaded again the next time it's drawn
+	void setFormat(const ofVboFormat & format);
+	const ofVboFormat & getFormat() const;
+
     void enableColors();
     void enableTextures();
     void enableNormals();
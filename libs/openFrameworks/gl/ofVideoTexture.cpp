@@ -0,0 +1,181 @@
+#include "ofVideoTexture.h"
+#include "ofGraphics.h"
+#include "ofGLUtils.h"
+
+using namespace std;
+
+//----------------------------------------------------------
+ofVideoTexture::ofVideoTexture()
+:pixelFormat(OF_PIXELS_NATIVE)
+,width(0)
+,height(0)
+,bFrameNew(false)
+,bKeepPixels(false){
+}
+
+//----------------------------------------------------------
+bool ofVideoTexture::allocate(int w, int h, ofPixelFormat format){
+	if(w <= 0 || h <= 0 || format == OF_PIXELS_NATIVE || format == OF_PIXELS_UNKNOWN){
+		ofLogError("ofVideoTexture") << "allocate(): can't allocate " << w << "x" << h << " " << ofToString(format);
+		return false;
+	}
+	// a frame with no data, only to get the size and format of the planes
+	ofPixels frame;
+	frame.setFromExternalPixels(nullptr, w, h, format);
+	planes.resize(frame.getNumPlanes());
+	for(size_t i = 0; i < planes.size(); i++){
+		ofPixels plane = frame.getPlane(i);
+		planes[i].allocate(plane.getWidth(), plane.getHeight(), ofGetGlInternalFormat(plane), ofGetUsingArbTex(), ofGetGlFormat(plane), ofGetGlType(plane));
+		if(ofIsGLProgrammableRenderer() && (plane.getPixelFormat() == OF_PIXELS_GRAY || plane.getPixelFormat() == OF_PIXELS_GRAY_ALPHA)){
+			planes[i].setRGToRGBASwizzles(true);
+		}
+	}
+	width = w;
+	height = h;
+	pixelFormat = format;
+	return true;
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::loadData(const ofPixels & frame){
+	if(!frame.isAllocated()){
+		return;
+	}
+	if(frame.getWidth() != size_t(width) || frame.getHeight() != size_t(height) || frame.getPixelFormat() != pixelFormat || planes.empty()){
+		if(!allocate(frame.getWidth(), frame.getHeight(), frame.getPixelFormat())){
+			return;
+		}
+	}
+	// getPlane only points into the frame, nothing is copied before the upload
+	ofPixels & source = const_cast<ofPixels&>(frame);
+	for(size_t i = 0; i < planes.size(); i++){
+		planes[i].loadData(source.getPlane(i));
+	}
+	if(bKeepPixels){
+		pixels = frame;
+	}
+	bFrameNew = true;
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::setKeepPixels(bool keep){
+	bKeepPixels = keep;
+	if(!keep){
+		pixels.clear();
+	}
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::update(){
+	bFrameNew = false;
+}
+
+//----------------------------------------------------------
+bool ofVideoTexture::isFrameNew() const{
+	return bFrameNew;
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::close(){
+	planes.clear();
+	pixels.clear();
+	width = 0;
+	height = 0;
+	bFrameNew = false;
+}
+
+//----------------------------------------------------------
+bool ofVideoTexture::isInitialized() const{
+	return !planes.empty() && planes[0].isAllocated();
+}
+
+//----------------------------------------------------------
+bool ofVideoTexture::setPixelFormat(ofPixelFormat format){
+	if(isInitialized() && format != pixelFormat){
+		return allocate(width, height, format);
+	}
+	pixelFormat = format;
+	return true;
+}
+
+//----------------------------------------------------------
+ofPixelFormat ofVideoTexture::getPixelFormat() const{
+	return pixelFormat;
+}
+
+//----------------------------------------------------------
+ofPixels & ofVideoTexture::getPixels(){
+	return pixels;
+}
+
+//----------------------------------------------------------
+const ofPixels & ofVideoTexture::getPixels() const{
+	return pixels;
+}
+
+//----------------------------------------------------------
+ofTexture & ofVideoTexture::getTexture(){
+	if(planes.empty()){
+		planes.resize(1);
+	}
+	return planes[0];
+}
+
+//----------------------------------------------------------
+const ofTexture & ofVideoTexture::getTexture() const{
+	return const_cast<ofVideoTexture*>(this)->getTexture();
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::setUseTexture(bool){
+	// it's only textures
+}
+
+//----------------------------------------------------------
+bool ofVideoTexture::isUsingTexture() const{
+	return true;
+}
+
+//----------------------------------------------------------
+vector<ofTexture> & ofVideoTexture::getTexturePlanes(){
+	return planes;
+}
+
+//----------------------------------------------------------
+const vector<ofTexture> & ofVideoTexture::getTexturePlanes() const{
+	return planes;
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::draw(float x, float y) const{
+	draw(x, y, getWidth(), getHeight());
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::draw(float x, float y, float w, float h) const{
+	ofGetCurrentRenderer()->draw(*this, x, y, w, h);
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::bind() const{
+	if(auto renderer = ofGetGLRenderer()){
+		renderer->bind(*this);
+	}
+}
+
+//----------------------------------------------------------
+void ofVideoTexture::unbind() const{
+	if(auto renderer = ofGetGLRenderer()){
+		renderer->unbind(*this);
+	}
+}
+
+//----------------------------------------------------------
+float ofVideoTexture::getWidth() const{
+	return width;
+}
+
+//----------------------------------------------------------
+float ofVideoTexture::getHeight() const{
+	return height;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ofTexture.h"
+#include "ofPixels.h"
+#include "ofBaseTypes.h"
+
+/// \brief Draws ofPixels in any video format, uploading each of its planes
+/// to its own texture and converting YUV to RGB in the GPU
+///
+/// NV12, NV21, I420, YV12 and YUY2 frames are uploaded as they are, which
+/// for 4:2:0 formats is half the data of RGB, and the programmable renderer
+/// converts them with a built in shader when drawing, the same way it draws
+/// an ofVideoPlayer or ofVideoGrabber set to OF_PIXELS_NATIVE:
+///
+/// ~~~~{.cpp}
+/// void ofApp::update(){
+///     // frames decoded by a library as NV12
+///     if(decoder.hasNewFrame()){
+///         ofPixels frame;
+///         frame.setFromExternalPixels(decoder.getData(), 3840, 2160, OF_PIXELS_NV12);
+///         video.loadData(frame);
+///     }
+/// }
+///
+/// void ofApp::draw(){
+///     video.draw(0, 0, ofGetWidth(), ofGetHeight());
+/// }
+/// ~~~~
+///
+/// It doesn't keep a copy of the pixels, getPixels() is empty unless
+/// setKeepPixels(true) is called. The fixed pipeline renderer can only draw
+/// the first plane.
+class ofVideoTexture: public ofBaseVideoDraws{
+public:
+	ofVideoTexture();
+
+	/// \brief Allocates the textures for every plane of a frame of width x
+	/// height in format
+	bool allocate(int width, int height, ofPixelFormat format);
+
+	/// \brief Uploads a frame, reallocating if its size or format changed
+	void loadData(const ofPixels & pixels);
+
+	/// \brief Keeps a copy of the last frame for getPixels()
+	void setKeepPixels(bool keep);
+
+	void update();
+	bool isFrameNew() const;
+	void close();
+	bool isInitialized() const;
+	bool setPixelFormat(ofPixelFormat pixelFormat);
+	ofPixelFormat getPixelFormat() const;
+
+	ofPixels & getPixels();
+	const ofPixels & getPixels() const;
+
+	/// \brief The texture of the first plane, luma for YUV formats
+	ofTexture & getTexture();
+	const ofTexture & getTexture() const;
+	void setUseTexture(bool bUseTex);
+	bool isUsingTexture() const;
+
+	std::vector<ofTexture> & getTexturePlanes();
+	const std::vector<ofTexture> & getTexturePlanes() const;
+
+	using ofBaseDraws::draw;
+	void draw(float x, float y) const;
+	void draw(float x, float y, float w, float h) const;
+
+	/// \brief Binds the planes with the conversion shader, to draw a mesh
+	/// with the frame
+	void bind() const;
+	void unbind() const;
+
+	float getWidth() const;
+	float getHeight() const;
+
+private:
+	std::vector<ofTexture> planes;
+	ofPixels pixels;
+	ofPixelFormat pixelFormat;
+	int width, height;
+	bool bFrameNew;
+	bool bKeepPixels;
+};
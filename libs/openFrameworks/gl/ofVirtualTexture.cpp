@@ -0,0 +1,666 @@
+#include "ofVirtualTexture.h"
+#include "ofFileIOService.h"
+#include "ofTaskPool.h"
+#include "ofGLStateCache.h"
+#include "ofRenderStats.h"
+#include "ofGraphics.h"
+#include "ofAppRunner.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include <sstream>
+#include <cstring>
+
+using namespace std;
+
+#define STRINGIFY(x) #x
+
+namespace{
+	// only the feedback pass needs derivatives, but both share the header
+#ifdef TARGET_OPENGLES
+	const string vertexHeader =
+		"precision highp float;\n"
+		"#define IN attribute\n"
+		"#define OUT varying\n";
+	const string fragmentHeader =
+		"#extension GL_OES_standard_derivatives : enable\n"
+		"precision highp float;\n"
+		"#define IN varying\n"
+		"#define TEXTURE texture2D\n"
+		"#define FRAG_COLOR gl_FragColor\n";
+#else
+	const string vertexHeader =
+		"#version %glsl_version%\n"
+		"#define IN in\n"
+		"#define OUT out\n";
+	const string fragmentHeader =
+		"#version %glsl_version%\n"
+		"#define IN in\n"
+		"#define TEXTURE texture\n"
+		"#define FRAG_COLOR fragColor\n"
+		"out vec4 fragColor;\n";
+#endif
+
+	const string vertexShader = vertexHeader + STRINGIFY(
+		uniform mat4 modelViewProjectionMatrix;
+		IN vec4 position;
+		IN vec2 texcoord;
+		OUT vec2 texCoordVarying;
+
+		void main(){
+			texCoordVarying = texcoord;
+			gl_Position = modelViewProjectionMatrix * position;
+		}
+	);
+
+	// the page table has the atlas slot in rg and the level of the tile in
+	// b, the level is used to find where in the tile the pixel is
+	const string fragmentShader = fragmentHeader + STRINGIFY(
+		uniform sampler2D atlas;
+		uniform sampler2D pageTable;
+		uniform vec4 globalColor;
+		uniform vec2 imageSize;
+		uniform float tileSize;
+		uniform float slotSize;
+		uniform vec2 atlasSize;
+		uniform vec2 pageTableCoords;
+		IN vec2 texCoordVarying;
+
+		void main(){
+			vec2 uv = clamp(texCoordVarying, 0.0, 0.99999);
+			vec4 page = floor(TEXTURE(pageTable, uv * pageTableCoords) * 255.0 + 0.5);
+			vec2 local = fract(uv * imageSize / (tileSize * exp2(page.b)));
+			vec2 texel = page.rg * slotSize + 1.0 + local * tileSize;
+			FRAG_COLOR = TEXTURE(atlas, texel / atlasSize) * globalColor * (page.a / 255.0);
+		}
+	);
+
+	// writes the tile each pixel needs, x and y split in 8 bits and the 4
+	// high bits of each in b, the level + 1 in a so 0 means no tile
+	const string feedbackFragmentShader = fragmentHeader + STRINGIFY(
+		uniform vec2 imageSize;
+		uniform float tileSize;
+		uniform float maxLevel;
+		uniform float lodBias;
+		IN vec2 texCoordVarying;
+
+		void main(){
+			vec2 pixel = texCoordVarying * imageSize;
+			vec2 dx = dFdx(pixel);
+			vec2 dy = dFdy(pixel);
+			float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) + lodBias;
+			float level = clamp(floor(lod), 0.0, maxLevel);
+			vec2 tile = floor(clamp(texCoordVarying, 0.0, 0.99999) * imageSize / (tileSize * exp2(level)));
+			vec2 high = floor(tile / 256.0);
+			FRAG_COLOR = vec4(tile - high * 256.0, high.x + high.y * 16.0, level + 1.0) / 255.0;
+		}
+	);
+
+	const string pyramidFileName = "pyramid.txt";
+
+	// copies the tile at x, y with a border of 1 pixel, repeating the edge
+	// pixels of the image
+	void copyTile(const ofPixels & src, int x, int y, int tileSize, ofPixels & dst){
+		int size = tileSize + 2;
+		auto channels = src.getNumChannels();
+		dst.allocate(size, size, src.getPixelFormat());
+		auto srcData = src.getData();
+		auto dstData = dst.getData();
+		int srcWidth = src.getWidth();
+		int srcHeight = src.getHeight();
+		for(int row = 0; row < size; row++){
+			int srcY = ofClamp(y - 1 + row, 0, srcHeight - 1);
+			auto srcRow = srcData + size_t(srcY) * src.getBytesStride();
+			auto dstRow = dstData + size_t(row) * dst.getBytesStride();
+			for(int col = 0; col < size; col++){
+				int srcX = ofClamp(x - 1 + col, 0, srcWidth - 1);
+				memcpy(dstRow + col * channels, srcRow + srcX * channels, channels);
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------
+bool ofVirtualTexture::buildPyramid(const ofPixels & pixels, const std::filesystem::path & folder, int tileSize, ofImageFormat format, ofImageQualityType quality){
+	if(!pixels.isAllocated() || tileSize <= 0){
+		ofLogError("ofVirtualTexture") << "buildPyramid(): pixels not allocated or tile size <= 0";
+		return false;
+	}
+	auto channels = pixels.getNumChannels();
+	if(pixels.getBytesPerPixel() != channels || (channels != 1 && channels != 3 && channels != 4)){
+		ofLogError("ofVirtualTexture") << "buildPyramid(): only gray, RGB and RGBA pixels are supported";
+		return false;
+	}
+	auto fullFolder = ofToDataPath(folder, true);
+	if(!ofDirectory::doesDirectoryExist(fullFolder, false) && !ofDirectory::createDirectory(fullFolder, false, true)){
+		ofLogError("ofVirtualTexture") << "buildPyramid(): couldn't create folder " << fullFolder;
+		return false;
+	}
+
+	int width = pixels.getWidth();
+	int height = pixels.getHeight();
+	int numLevels = 1;
+	while((tileSize << (numLevels - 1)) < std::max(width, height)){
+		numLevels++;
+	}
+	auto extension = ofImageFormatExtension(format);
+
+	const ofPixels * level = &pixels;
+	ofPixels scaled;
+	atomic<bool> saved(true);
+	for(int l = 0; l < numLevels; l++){
+		if(l > 0){
+			ofPixels next;
+			next.allocate(std::max<size_t>((level->getWidth() + 1) / 2, 1), std::max<size_t>((level->getHeight() + 1) / 2, 1), level->getPixelFormat());
+			level->resizeTo(next, OF_INTERPOLATE_AREA, 0);
+			scaled = std::move(next);
+			level = &scaled;
+		}
+		auto levelFolder = ofFilePath::join(fullFolder, ofToString(l));
+		if(!ofDirectory::doesDirectoryExist(levelFolder, false)){
+			ofDirectory::createDirectory(levelFolder, false);
+		}
+		size_t tilesX = (level->getWidth() + tileSize - 1) / tileSize;
+		size_t tilesY = (level->getHeight() + tileSize - 1) / tileSize;
+		ofGetTaskPool().parallelFor(0, tilesX * tilesY, [&](size_t begin, size_t end){
+			ofPixels tile;
+			for(size_t i = begin; i < end; i++){
+				int x = i % tilesX;
+				int y = i / tilesX;
+				copyTile(*level, x * tileSize, y * tileSize, tileSize, tile);
+				auto path = ofFilePath::join(levelFolder, ofToString(x) + "_" + ofToString(y) + "." + extension);
+				ofBuffer encoded;
+				ofSaveImage(tile, encoded, format, quality);
+				if(encoded.size() == 0 || !ofBufferToFile(path, encoded, true)){
+					saved = false;
+				}
+			}
+		}, 1);
+		if(!saved){
+			ofLogError("ofVirtualTexture") << "buildPyramid(): couldn't save the tiles of level " << l;
+			return false;
+		}
+	}
+
+	ofBuffer info;
+	info.set(ofToString(width) + " " + ofToString(height) + " " + ofToString(tileSize) + " " + ofToString(numLevels) + " " + extension + "\n");
+	return ofBufferToFile(ofFilePath::join(fullFolder, pyramidFileName), info, false);
+}
+
+//----------------------------------------------------------
+ofVirtualTexture::ofVirtualTexture()
+:width(0)
+,height(0)
+,tileSize(0)
+,numLevels(0)
+,slotsPerSide(0)
+,frame(0)
+,pageTableDirty(false){
+}
+
+//----------------------------------------------------------
+ofVirtualTexture::~ofVirtualTexture(){
+	clear();
+}
+
+//----------------------------------------------------------
+bool ofVirtualTexture::setup(const Settings & s){
+	clear();
+	if(!ofIsGLProgrammableRenderer()){
+		ofLogError("ofVirtualTexture") << "setup(): needs the programmable renderer";
+		return false;
+	}
+
+	settings = s;
+	folder = ofToDataPath(settings.folder, true);
+	auto info = ofBufferFromFile(ofFilePath::join(folder, pyramidFileName), false);
+	istringstream stream(info.getText());
+	if(!(stream >> width >> height >> tileSize >> numLevels >> extension) || width <= 0 || height <= 0 || tileSize <= 0 || numLevels <= 0){
+		ofLogError("ofVirtualTexture") << "setup(): couldn't read the tile pyramid in " << folder << ", create it with buildPyramid()";
+		width = height = tileSize = numLevels = 0;
+		return false;
+	}
+
+	GLint maxTextureSize;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	int slotSize = tileSize + 2;
+	slotsPerSide = ceil(sqrt(double(std::max<size_t>(settings.cacheTiles, 4))));
+	slotsPerSide = std::min<size_t>(slotsPerSide, maxTextureSize / slotSize);
+	if(slotsPerSide < 2){
+		ofLogError("ofVirtualTexture") << "setup(): tile size " << tileSize << " too big for this graphics card";
+		clear();
+		return false;
+	}
+	for(size_t i = slotsPerSide * slotsPerSide; i > 0; i--){
+		freeSlots.push_back(i - 1);
+	}
+
+	atlas.allocate(slotsPerSide * slotSize, slotsPerSide * slotSize, GL_RGBA8, false);
+	atlas.setTextureWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+	atlas.setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+
+	pageTablePixels.allocate(getNumTilesX(0), getNumTilesY(0), OF_PIXELS_RGBA);
+	pageTablePixels.set(0);
+	pageTable.allocate(pageTablePixels.getWidth(), pageTablePixels.getHeight(), GL_RGBA8, false);
+	pageTable.setTextureWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+	pageTable.setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+	requestedLevels.assign(pageTablePixels.getWidth() * pageTablePixels.getHeight(), numLevels - 1);
+
+	auto renderer = ofGetGLRenderer();
+	auto version = ofGLSLVersionFromGL(renderer->getGLVersionMajor(), renderer->getGLVersionMinor());
+	auto vertexSource = vertexShader;
+	auto fragmentSource = fragmentShader;
+	auto feedbackSource = feedbackFragmentShader;
+	ofStringReplace(vertexSource, "%glsl_version%", version);
+	ofStringReplace(fragmentSource, "%glsl_version%", version);
+	ofStringReplace(feedbackSource, "%glsl_version%", version);
+	ofShader::Settings shaderSettings;
+	shaderSettings.shaderSources[GL_VERTEX_SHADER] = vertexSource;
+	shaderSettings.shaderSources[GL_FRAGMENT_SHADER] = fragmentSource;
+	bool compiled = shader.setup(shaderSettings);
+	shaderSettings.shaderSources[GL_FRAGMENT_SHADER] = feedbackSource;
+	compiled &= feedbackShader.setup(shaderSettings);
+	if(!compiled){
+		ofLogError("ofVirtualTexture") << "setup(): couldn't compile the shaders";
+		clear();
+		return false;
+	}
+
+	// the coarsest level is the fallback for everything else, it's loaded
+	// now and never evicted
+	ofPixels top;
+	auto topPath = getTilePath(numLevels - 1, 0, 0);
+	if(!ofLoadImage(top, topPath)){
+		ofLogError("ofVirtualTexture") << "setup(): couldn't load " << topPath;
+		clear();
+		return false;
+	}
+	top.setImageType(OF_IMAGE_COLOR_ALPHA);
+	upload(makeKey(numLevels - 1, 0, 0), top);
+	updatePageTable();
+
+	alive = make_shared<bool>(true);
+	return true;
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::clear(){
+	// the loads in flight see it and drop their tiles
+	alive.reset();
+	atlas.clear();
+	pageTable.clear();
+	pageTablePixels.clear();
+	requestedLevels.clear();
+	feedback.clear();
+	resident.clear();
+	loading.clear();
+	missing.clear();
+	loaded.clear();
+	freeSlots.clear();
+	width = height = tileSize = numLevels = 0;
+	slotsPerSide = 0;
+	pageTableDirty = false;
+}
+
+//----------------------------------------------------------
+bool ofVirtualTexture::isAllocated() const{
+	return alive != nullptr;
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::update(){
+	if(!isAllocated()){
+		return;
+	}
+	frame++;
+
+#ifndef TARGET_OPENGLES
+	// only the newest feedback is useful
+	bool newFeedback = false;
+	while(feedback.isAllocated() && feedback.getAsyncPixels(feedbackPixels)){
+		newFeedback = true;
+	}
+	if(newFeedback){
+		processFeedback(feedbackPixels);
+	}
+#endif
+
+	for(size_t i = 0; i < settings.maxUploadsPerFrame && !loaded.empty(); i++){
+		auto tile = std::move(loaded.front());
+		loaded.pop_front();
+		loading.erase(tile.key);
+		if(tile.pixels.isAllocated()){
+			upload(tile.key, tile.pixels);
+		}else{
+			ofLogError("ofVirtualTexture") << "update(): couldn't load " << getTilePath(getKeyLevel(tile.key), getKeyX(tile.key), getKeyY(tile.key));
+			missing.insert(tile.key);
+		}
+	}
+
+	if(pageTableDirty){
+		updatePageTable();
+	}
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::beginFeedback(){
+	if(!isAllocated()){
+		return;
+	}
+	auto viewport = ofGetCurrentViewport();
+	int feedbackWidth = std::max(int(viewport.width * settings.feedbackScale), 1);
+	int feedbackHeight = std::max(int(viewport.height * settings.feedbackScale), 1);
+	if(!feedback.isAllocated() || feedback.getWidth() != feedbackWidth || feedback.getHeight() != feedbackHeight){
+		ofFbo::Settings fboSettings;
+		fboSettings.width = feedbackWidth;
+		fboSettings.height = feedbackHeight;
+		fboSettings.internalformat = GL_RGBA;
+		fboSettings.useDepth = true;
+		fboSettings.minFilter = GL_NEAREST;
+		fboSettings.maxFilter = GL_NEAREST;
+		feedback.allocate(fboSettings);
+	}
+
+	// keeps the current matrices, the scene is rendered the same but smaller
+	feedback.begin(ofFboBeginMode::NoDefaults);
+	ofClear(0, 0, 0, 0);
+	feedbackShader.begin();
+	feedbackShader.setUniform2f("imageSize", width, height);
+	feedbackShader.setUniform1f("tileSize", tileSize);
+	feedbackShader.setUniform1f("maxLevel", numLevels - 1);
+	// the derivatives in the feedback fbo are 1 / feedbackScale bigger
+	feedbackShader.setUniform1f("lodBias", settings.lodBias + log2(settings.feedbackScale));
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::endFeedback(){
+	if(!isAllocated()){
+		return;
+	}
+	feedbackShader.end();
+	feedback.end();
+#ifndef TARGET_OPENGLES
+	// if all the readbacks are in flight this frame's feedback is skipped
+	feedback.readToPixelsAsync();
+#else
+	feedback.readToPixels(feedbackPixels);
+	processFeedback(feedbackPixels);
+#endif
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::begin(){
+	if(!isAllocated()){
+		return;
+	}
+	auto & atlasData = atlas.getTextureData();
+	auto & pageTableData = pageTable.getTextureData();
+	shader.begin();
+	shader.setUniformTexture("atlas", atlas, 0);
+	shader.setUniformTexture("pageTable", pageTable, 1);
+	shader.setUniform2f("imageSize", width, height);
+	shader.setUniform1f("tileSize", tileSize);
+	shader.setUniform1f("slotSize", tileSize + 2);
+	shader.setUniform2f("atlasSize", atlasData.tex_w, atlasData.tex_h);
+	// the page table covers whole tiles, a bit more than the image
+	shader.setUniform2f("pageTableCoords",
+		pageTableData.tex_t * width / float(pageTablePixels.getWidth() * tileSize),
+		pageTableData.tex_u * height / float(pageTablePixels.getHeight() * tileSize));
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::end(){
+	if(!isAllocated()){
+		return;
+	}
+	shader.end();
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getWidth() const{
+	return width;
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getHeight() const{
+	return height;
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getTileSize() const{
+	return tileSize;
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getNumLevels() const{
+	return numLevels;
+}
+
+//----------------------------------------------------------
+size_t ofVirtualTexture::getNumResidentTiles() const{
+	return resident.size();
+}
+
+//----------------------------------------------------------
+size_t ofVirtualTexture::getNumLoadingTiles() const{
+	return loading.size();
+}
+
+//----------------------------------------------------------
+size_t ofVirtualTexture::getCacheSize() const{
+	return slotsPerSide * slotsPerSide;
+}
+
+//----------------------------------------------------------
+const ofTexture & ofVirtualTexture::getAtlas() const{
+	return atlas;
+}
+
+//----------------------------------------------------------
+const ofTexture & ofVirtualTexture::getPageTable() const{
+	return pageTable;
+}
+
+//----------------------------------------------------------
+ofVirtualTexture::TileKey ofVirtualTexture::makeKey(int level, int x, int y){
+	return (TileKey(level) << 48) | (TileKey(y) << 24) | TileKey(x);
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getKeyLevel(TileKey key){
+	return key >> 48;
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getKeyX(TileKey key){
+	return key & 0xFFFFFF;
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getKeyY(TileKey key){
+	return (key >> 24) & 0xFFFFFF;
+}
+
+//----------------------------------------------------------
+string ofVirtualTexture::getTilePath(int level, int x, int y) const{
+	return ofFilePath::join(ofFilePath::join(folder, ofToString(level)), ofToString(x) + "_" + ofToString(y) + "." + extension);
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getNumTilesX(int level) const{
+	int levelTileSize = tileSize << level;
+	return (width + levelTileSize - 1) / levelTileSize;
+}
+
+//----------------------------------------------------------
+int ofVirtualTexture::getNumTilesY(int level) const{
+	int levelTileSize = tileSize << level;
+	return (height + levelTileSize - 1) / levelTileSize;
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::processFeedback(const ofPixels & pixels){
+	if(pixels.getNumChannels() != 4){
+		return;
+	}
+	unordered_set<TileKey> requested;
+	auto data = pixels.getData();
+	size_t numPixels = pixels.getWidth() * pixels.getHeight();
+	for(size_t i = 0; i < numPixels; i++){
+		auto p = data + i * 4;
+		if(p[3] == 0){
+			continue;
+		}
+		int level = std::min(p[3] - 1, numLevels - 1);
+		int x = p[0] + (p[2] & 0xF) * 256;
+		int y = p[1] + (p[2] >> 4) * 256;
+		if(x < getNumTilesX(level) && y < getNumTilesY(level)){
+			requested.insert(makeKey(level, x, y));
+		}
+	}
+
+	// each part of the image shows the finest level requested for it, the
+	// coarser tiles covering it are requested too as fallbacks
+	vector<uint8_t> levels(requestedLevels.size(), numLevels - 1);
+	int tilesX = pageTablePixels.getWidth();
+	int tilesY = pageTablePixels.getHeight();
+	vector<TileKey> tiles;
+	unordered_set<TileKey> parents;
+	for(auto key: requested){
+		int level = getKeyLevel(key);
+		int x = getKeyX(key);
+		int y = getKeyY(key);
+		for(int ty = y << level; ty < std::min((y + 1) << level, tilesY); ty++){
+			for(int tx = x << level; tx < std::min((x + 1) << level, tilesX); tx++){
+				auto & l = levels[ty * tilesX + tx];
+				l = std::min<uint8_t>(l, level);
+			}
+		}
+		tiles.push_back(key);
+		for(int parent = level + 1; parent < numLevels; parent++){
+			auto parentKey = makeKey(parent, x >> (parent - level), y >> (parent - level));
+			if(requested.find(parentKey) == requested.end() && parents.insert(parentKey).second){
+				tiles.push_back(parentKey);
+			}
+		}
+	}
+	if(levels != requestedLevels){
+		requestedLevels.swap(levels);
+		pageTableDirty = true;
+	}
+
+	// coarse tiles first, they cover more and show something sooner
+	sort(tiles.begin(), tiles.end(), [](TileKey a, TileKey b){
+		return getKeyLevel(a) > getKeyLevel(b);
+	});
+	for(auto key: tiles){
+		request(key);
+	}
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::request(TileKey key){
+	auto it = resident.find(key);
+	if(it != resident.end()){
+		it->second.lastUsed = frame;
+		return;
+	}
+	if(loading.size() >= settings.maxLoading || loading.count(key) || missing.count(key)){
+		return;
+	}
+	loading.insert(key);
+
+	// read in the file service, decode in the task pool and queue for
+	// upload in the main thread
+	weak_ptr<bool> weakAlive = alive;
+	auto path = getTilePath(getKeyLevel(key), getKeyX(key), getKeyY(key));
+	ofGetFileIOService().read(path, [this, weakAlive, key](ofBuffer & buffer){
+		if(weakAlive.expired()){
+			return;
+		}
+		auto data = make_shared<ofBuffer>(std::move(buffer));
+		ofGetTaskPool().submit([data]{
+			ofPixels pixels;
+			if(data->size() > 0 && ofLoadImage(pixels, *data)){
+				pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+			}
+			return pixels;
+		}, [this, weakAlive, key](ofPixels & pixels){
+			if(weakAlive.expired()){
+				return;
+			}
+			loaded.push_back({key, std::move(pixels)});
+		});
+	});
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::upload(TileKey key, const ofPixels & pixels){
+	if(resident.find(key) != resident.end()){
+		return;
+	}
+	size_t slot;
+	if(!acquireSlot(slot)){
+		// every tile is in use this frame, it'll be requested again
+		return;
+	}
+	int slotSize = tileSize + 2;
+	int x = (slot % slotsPerSide) * slotSize;
+	int y = (slot / slotsPerSide) * slotSize;
+	ofGetGLStateCache().bindTexture(GL_TEXTURE_2D, atlas.getTextureData().textureID);
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT, pixels.getBytesStride());
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, std::min<int>(pixels.getWidth(), slotSize), std::min<int>(pixels.getHeight(), slotSize), GL_RGBA, GL_UNSIGNED_BYTE, pixels.getData());
+	of::priv::currentRenderStats().textureUploadBytes += uint64_t(std::min<int>(pixels.getWidth(), slotSize)) * std::min<int>(pixels.getHeight(), slotSize) * 4;
+	ofGetGLStateCache().bindTexture(GL_TEXTURE_2D, 0);
+	resident[key] = {slot, frame};
+	pageTableDirty = true;
+}
+
+//----------------------------------------------------------
+bool ofVirtualTexture::acquireSlot(size_t & slot){
+	if(!freeSlots.empty()){
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+		return true;
+	}
+	auto victim = resident.end();
+	for(auto it = resident.begin(); it != resident.end(); ++it){
+		if(getKeyLevel(it->first) == numLevels - 1 || it->second.lastUsed == frame){
+			continue;
+		}
+		if(victim == resident.end() || it->second.lastUsed < victim->second.lastUsed){
+			victim = it;
+		}
+	}
+	if(victim == resident.end()){
+		return false;
+	}
+	slot = victim->second.slot;
+	resident.erase(victim);
+	pageTableDirty = true;
+	return true;
+}
+
+//----------------------------------------------------------
+void ofVirtualTexture::updatePageTable(){
+	int tilesX = pageTablePixels.getWidth();
+	int tilesY = pageTablePixels.getHeight();
+	auto data = pageTablePixels.getData();
+	for(int ty = 0; ty < tilesY; ty++){
+		for(int tx = 0; tx < tilesX; tx++){
+			auto p = data + (ty * tilesX + tx) * 4;
+			p[0] = p[1] = p[2] = p[3] = 0;
+			for(int level = requestedLevels[ty * tilesX + tx]; level < numLevels; level++){
+				auto it = resident.find(makeKey(level, tx >> level, ty >> level));
+				if(it != resident.end()){
+					p[0] = it->second.slot % slotsPerSide;
+					p[1] = it->second.slot / slotsPerSide;
+					p[2] = level;
+					p[3] = 255;
+					break;
+				}
+			}
+		}
+	}
+	pageTable.loadData(pageTablePixels);
+	pageTableDirty = false;
+}
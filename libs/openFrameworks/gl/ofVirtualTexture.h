@@ -0,0 +1,175 @@
+#pragma once
+
+#include "ofTexture.h"
+#include "ofFbo.h"
+#include "ofShader.h"
+#include "ofImage.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+
+/// \brief Draws images too big to fit in memory by streaming the tiles that
+/// are visible, at the resolution they are seen at
+///
+/// The image is stored on disk as a pyramid of tiles, built once with
+/// buildPyramid(). While drawing, a low resolution feedback pass records
+/// which tiles each pixel needs and at which level, those are read from
+/// disk and decoded in the background and uploaded to a fixed size atlas,
+/// replacing the least recently used. A page table maps every part of the
+/// image to the finest tile that is resident, so areas still loading show
+/// a coarser level instead of holes. GPU and CPU memory stay bounded by
+/// Settings::cacheTiles however big the image is.
+///
+/// Texture coordinates go from 0 to 1 over the whole image:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     // once, offline
+///     // ofVirtualTexture::buildPyramid(hugePixels, "panorama");
+///     ofVirtualTexture::Settings settings;
+///     settings.folder = "panorama";
+///     vt.setup(settings);
+///     sphere.set(1000, 64);
+///     sphere.mapTexCoords(0, 1, 1, 0);
+/// }
+///
+/// void ofApp::update(){
+///     vt.update();
+/// }
+///
+/// void ofApp::draw(){
+///     cam.begin();
+///     vt.beginFeedback();
+///     sphere.draw();
+///     vt.endFeedback();
+///
+///     vt.begin();
+///     sphere.draw();
+///     vt.end();
+///     cam.end();
+/// }
+/// ~~~~
+///
+/// Needs the programmable renderer.
+class ofVirtualTexture{
+public:
+	struct Settings{
+		std::filesystem::path folder; //< built with buildPyramid(), relative to the data folder
+		std::size_t cacheTiles = 1024; //< tiles resident in the atlas
+		std::size_t maxLoading = 32; //< tiles read and decoded at the same time
+		std::size_t maxUploadsPerFrame = 8; //< tiles uploaded to the atlas per update()
+		float feedbackScale = 0.125f; //< size of the feedback pass relative to the viewport
+		float lodBias = 0; //< positive values load coarser tiles
+	};
+
+	/// \brief Splits pixels into the tile pyramid read by setup(), the tiles
+	/// at each level covering twice the area of the previous one, until the
+	/// whole image fits in one
+	///
+	/// Tiles have a 1 pixel border copied from their neighbours so they can
+	/// be filtered without seams.
+	///
+	/// \param folder created if needed, relative to the data folder
+	static bool buildPyramid(const ofPixels & pixels, const std::filesystem::path & folder, int tileSize = 256, ofImageFormat format = OF_IMAGE_FORMAT_JPEG, ofImageQualityType quality = OF_IMAGE_QUALITY_HIGH);
+
+	ofVirtualTexture();
+	~ofVirtualTexture();
+
+	ofVirtualTexture(const ofVirtualTexture &) = delete;
+	ofVirtualTexture & operator=(const ofVirtualTexture &) = delete;
+
+	/// \brief Reads the pyramid description, allocates the atlas and loads
+	/// the coarsest tile, which stays always resident
+	bool setup(const Settings & settings);
+	void clear();
+	bool isAllocated() const;
+
+	/// \brief Requests the tiles seen in the last feedback pass, uploads
+	/// the ones that finished loading and updates the page table
+	void update();
+
+	/// \brief Draw the geometry that uses the texture between these to
+	/// find the tiles it needs
+	///
+	/// Renders with the current matrices to a small fbo, it has to be
+	/// called with the same camera as the actual draw.
+	void beginFeedback();
+	void endFeedback();
+
+	/// \brief Binds the shader that samples the texture, draw the geometry
+	/// between these
+	void begin();
+	void end();
+
+	int getWidth() const;
+	int getHeight() const;
+	int getTileSize() const;
+	int getNumLevels() const;
+
+	std::size_t getNumResidentTiles() const;
+	std::size_t getNumLoadingTiles() const;
+	std::size_t getCacheSize() const;
+
+	/// \brief The atlas with the resident tiles
+	const ofTexture & getAtlas() const;
+
+	/// \brief The tile each part of the image maps to, one texel per tile of
+	/// the finest level
+	const ofTexture & getPageTable() const;
+
+private:
+	typedef uint64_t TileKey;
+
+	struct Tile{
+		std::size_t slot;
+		uint64_t lastUsed;
+	};
+
+	struct LoadedTile{
+		TileKey key;
+		ofPixels pixels;
+	};
+
+	static TileKey makeKey(int level, int x, int y);
+	static int getKeyLevel(TileKey key);
+	static int getKeyX(TileKey key);
+	static int getKeyY(TileKey key);
+
+	std::string getTilePath(int level, int x, int y) const;
+	int getNumTilesX(int level) const;
+	int getNumTilesY(int level) const;
+	void processFeedback(const ofPixels & feedback);
+	void request(TileKey key);
+	void upload(TileKey key, const ofPixels & pixels);
+	bool acquireSlot(std::size_t & slot);
+	void updatePageTable();
+
+	Settings settings;
+	std::string folder;
+	std::string extension;
+	int width;
+	int height;
+	int tileSize;
+	int numLevels;
+	std::size_t slotsPerSide;
+
+	ofTexture atlas;
+	ofTexture pageTable;
+	ofPixels pageTablePixels;
+	std::vector<uint8_t> requestedLevels;
+	ofFbo feedback;
+	ofPixels feedbackPixels;
+	ofShader shader;
+	ofShader feedbackShader;
+
+	std::unordered_map<TileKey, Tile> resident;
+	std::unordered_set<TileKey> loading;
+	std::unordered_set<TileKey> missing;
+	std::deque<LoadedTile> loaded;
+	std::vector<std::size_t> freeSlots;
+	uint64_t frame;
+	bool pageTableDirty;
+
+	// tells the loading callbacks if this object still exists
+	std::shared_ptr<bool> alive;
+};
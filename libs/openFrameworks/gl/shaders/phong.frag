@@ -39,12 +39,23 @@ static const string fragmentShader = R"(
 
     uniform SAMPLER tex0;
 
+#if MATERIAL_BLOCK
+    layout(std140) uniform ofMaterialBlock{
+        vec4 mat_ambient;
+        vec4 mat_diffuse;
+        vec4 mat_specular;
+        vec4 mat_emissive;
+        vec4 global_ambient;
+        float mat_shininess;
+    };
+#else
     uniform vec4 mat_ambient;
     uniform vec4 mat_diffuse;
     uniform vec4 mat_specular;
     uniform vec4 mat_emissive;
     uniform float mat_shininess;
     uniform vec4 global_ambient;
+#endif
 
     // these are passed in from OF programmable renderer
     uniform mat4 modelViewMatrix;
@@ -52,7 +63,51 @@ static const string fragmentShader = R"(
     uniform mat4 textureMatrix;
     uniform mat4 modelViewProjectionMatrix;
 
+#if CLUSTERED_LIGHTING
+    // lights packed in texels by ofLightClusters: position, ambient,
+    // diffuse, specular, attenuation + type, spot direction + exponent,
+    // half vector + spot cos cutoff, right + width, up + height
+    uniform samplerBuffer lightsBuffer;
+    // offset and count in lightIndices of the lights of each cluster
+    uniform usamplerBuffer lightClusters;
+    // global lights first, then the lights of each cluster
+    uniform usamplerBuffer lightIndices;
+    uniform vec4 clusterViewport;
+    uniform vec3 clusterGrid;
+    uniform vec3 clusterDepth; // near, far, linear slices
+    uniform int numGlobalLights;
+
+    lightData getLight(int index){
+        int base = index * 9;
+        lightData light;
+        light.enabled = 1.0;
+        light.position = texelFetch(lightsBuffer, base);
+        light.ambient = texelFetch(lightsBuffer, base + 1);
+        light.diffuse = texelFetch(lightsBuffer, base + 2);
+        light.specular = texelFetch(lightsBuffer, base + 3);
+        vec4 attenuation = texelFetch(lightsBuffer, base + 4);
+        light.constantAttenuation = attenuation.x;
+        light.linearAttenuation = attenuation.y;
+        light.quadraticAttenuation = attenuation.z;
+        light.type = attenuation.w;
+        vec4 spot = texelFetch(lightsBuffer, base + 5);
+        light.spotDirection = spot.xyz;
+        light.spotExponent = spot.w;
+        vec4 halfVector = texelFetch(lightsBuffer, base + 6);
+        light.halfVector = halfVector.xyz;
+        light.spotCosCutoff = halfVector.w;
+        light.spotCutoff = 0.0;
+        vec4 right = texelFetch(lightsBuffer, base + 7);
+        light.right = right.xyz;
+        light.width = right.w;
+        vec4 up = texelFetch(lightsBuffer, base + 8);
+        light.up = up.xyz;
+        light.height = up.w;
+        return light;
+    }
+#else
     uniform lightData lights[MAX_LIGHTS];
+#endif
 
 	%custom_uniforms%
 
@@ -206,6 +261,19 @@ static const string fragmentShader = R"(
     }
 
 
+    void applyLight(in lightData light, inout vec3 ambient, inout vec3 diffuse, inout vec3 specular){
+        if(light.type<0.5){
+            pointLight(light, v_transformedNormal, v_eyePosition, ambient, diffuse, specular);
+        }else if(light.type<1.5){
+            directionalLight(light, v_transformedNormal, ambient, diffuse, specular);
+        }else if(light.type<2.5){
+            spotLight(light, v_transformedNormal, v_eyePosition, ambient, diffuse, specular);
+        }else{
+            areaLight(light, v_transformedNormal, v_eyePosition, ambient, diffuse, specular);
+        }
+    }
+
+
     %postFragment%
 
     //////////////////////////////////////////////////////
@@ -219,18 +287,31 @@ static const string fragmentShader = R"(
         vec3 diffuse = vec3(0.0,0.0,0.0);
         vec3 specular = vec3(0.0,0.0,0.0);
 
+#if CLUSTERED_LIGHTING
+        for( int i = 0; i < numGlobalLights; i++ ){
+            applyLight(getLight(int(texelFetch(lightIndices, i).r)), ambient, diffuse, specular);
+        }
+
+        vec2 tile = clamp(floor((gl_FragCoord.xy - clusterViewport.xy) / clusterViewport.zw * clusterGrid.xy), vec2(0.0), clusterGrid.xy - 1.0);
+        float depth = clamp(-v_eyePosition.z, clusterDepth.x, clusterDepth.y);
+        float slice;
+        if(clusterDepth.z > 0.5){
+            slice = (depth - clusterDepth.x) / (clusterDepth.y - clusterDepth.x);
+        }else{
+            slice = log(depth / clusterDepth.x) / log(clusterDepth.y / clusterDepth.x);
+        }
+        slice = clamp(floor(slice * clusterGrid.z), 0.0, clusterGrid.z - 1.0);
+        int cluster = int((slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x);
+        uvec2 clusterLightsRange = texelFetch(lightClusters, cluster).rg;
+        for( int i = 0; i < int(clusterLightsRange.y); i++ ){
+            applyLight(getLight(int(texelFetch(lightIndices, int(clusterLightsRange.x) + i).r)), ambient, diffuse, specular);
+        }
+#else
         for( int i = 0; i < MAX_LIGHTS; i++ ){
             if(lights[i].enabled<0.5) continue;
-            if(lights[i].type<0.5){
-                pointLight(lights[i], v_transformedNormal, v_eyePosition, ambient, diffuse, specular);
-            }else if(lights[i].type<1.5){
-                directionalLight(lights[i], v_transformedNormal, ambient, diffuse, specular);
-            }else if(lights[i].type<2.5){
-                spotLight(lights[i], v_transformedNormal, v_eyePosition, ambient, diffuse, specular);
-            }else{
-                areaLight(lights[i], v_transformedNormal, v_eyePosition, ambient, diffuse, specular);
-            }
+            applyLight(lights[i], ambient, diffuse, specular);
         }
+#endif
 
         ////////////////////////////////////////////////////////////
         // now add the material info
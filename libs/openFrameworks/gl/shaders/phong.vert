@@ -20,19 +20,23 @@ uniform mat4 textureMatrix;
 uniform mat4 modelViewProjectionMatrix;
 uniform mat4 normalMatrix;
 
+%preVertex%
 
 void main (void){
-    vec4 eyePosition = modelViewMatrix * position;
-    vec3 tempNormal = (normalMatrix * normal).xyz;
+    vec4 localPosition = position;
+    vec4 localNormal = normal;
+    preVertex(localPosition, localNormal);
+    vec4 eyePosition = modelViewMatrix * localPosition;
+    vec3 tempNormal = (normalMatrix * localNormal).xyz;
     v_transformedNormal = normalize(tempNormal);
-    v_normal = normal.xyz;
+    v_normal = localNormal.xyz;
     v_eyePosition = (eyePosition.xyz) / eyePosition.w;
-    v_worldPosition = position.xyz;
+    v_worldPosition = localPosition.xyz;
 
     v_texcoord = (textureMatrix*vec4(texcoord.x,texcoord.y,0,1)).xy;
     #if HAS_COLOR
         v_color = color;
     #endif
-    gl_Position = modelViewProjectionMatrix * position;
+    gl_Position = modelViewProjectionMatrix * localPosition;
 }
 )";
@@ -0,0 +1,323 @@
+#include "ofAssetCache.h"
+#include "ofGpuMemory.h"
+#include "ofTaskPool.h"
+#include "ofUtils.h"
+#include <algorithm>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace{
+	string settingsKey(const ofImageLoadSettings & settings){
+		return ofToString(settings.accurate) + ofToString(settings.exifRotate) +
+			ofToString(settings.grayscale) + ofToString(settings.separateCMYK) + ":" +
+			ofToString(settings.maxWidth) + "x" + ofToString(settings.maxHeight);
+	}
+
+	string pixelsKey(const std::filesystem::path & path, const ofImageLoadSettings & settings){
+		return "pixels:" + ofToDataPath(path, true) + ":" + settingsKey(settings);
+	}
+
+	string textureKey(const std::filesystem::path & path, const ofImageLoadSettings & settings){
+		return "texture:" + ofToDataPath(path, true) + ":" + settingsKey(settings);
+	}
+
+	string fontKey(const ofTrueTypeFont::Settings & settings){
+		string key = "font:" + settings.fontName.string() + ":" + ofToString(settings.fontSize) + ":" +
+			ofToString(settings.antialiased) + ofToString(settings.contours) + ofToString(settings.dynamicAtlas) + ":" +
+			ofToString(settings.simplifyAmt) + ":" + ofToString(settings.dpi) + ":" +
+			ofToString(int(settings.direction)) + ":" + ofToString(settings.atlasPageSize) + ":" +
+			ofToString(settings.maxAtlasPages);
+		for(auto & range: settings.ranges){
+			key += ":" + ofToString(range.begin) + "-" + ofToString(range.end);
+		}
+		return key;
+	}
+
+	uint64_t textureBytes(const ofTexture & texture){
+		auto & texData = texture.getTextureData();
+		return of::priv::gpuMemoryBytes(texData.glInternalFormat, int(texData.tex_w), int(texData.tex_h));
+	}
+}
+
+struct ofAssetCache::Data{
+	struct Entry{
+		// the cache's own reference, the asset is freed by purge() once
+		// it's the only one left
+		shared_ptr<void> asset;
+		uint64_t bytes = 0;
+		uint64_t lastUse = 0;
+		// set while the pixels are being decoded so concurrent requests
+		// wait for the same load
+		shared_future<shared_ptr<ofPixels>> loading;
+	};
+	mutable std::mutex mutex;
+	unordered_map<string, Entry> entries;
+	uint64_t budget = 256 * 1024 * 1024;
+	uint64_t usage = 0;
+	uint64_t uses = 0;
+
+	shared_ptr<ofPixels> loadPixels(const std::filesystem::path & path, const ofImageLoadSettings & settings);
+	shared_ptr<ofTexture> loadTexture(const std::filesystem::path & path, const ofImageLoadSettings & settings);
+	void insert(const string & key, shared_ptr<void> asset, uint64_t bytes);
+	void purge();
+};
+
+//----------------------------------------------------------
+shared_ptr<ofPixels> ofAssetCache::Data::loadPixels(const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	auto key = pixelsKey(path, settings);
+	std::unique_lock<std::mutex> lock(mutex);
+	auto it = entries.find(key);
+	if(it != entries.end()){
+		if(it->second.asset){
+			it->second.lastUse = ++uses;
+			return static_pointer_cast<ofPixels>(it->second.asset);
+		}
+		if(it->second.loading.valid()){
+			auto loading = it->second.loading;
+			lock.unlock();
+			return loading.get();
+		}
+	}
+	promise<shared_ptr<ofPixels>> loaded;
+	entries[key].loading = loaded.get_future().share();
+	lock.unlock();
+
+	auto pixels = make_shared<ofPixels>();
+	if(!ofLoadImage(*pixels, path, settings)){
+		pixels.reset();
+	}
+
+	lock.lock();
+	it = entries.find(key);
+	// clear() could have removed the entry while loading
+	if(it != entries.end() && !it->second.asset){
+		if(pixels){
+			it->second.asset = pixels;
+			it->second.bytes = pixels->getTotalBytes();
+			it->second.lastUse = ++uses;
+			it->second.loading = {};
+			usage += it->second.bytes;
+		}else{
+			entries.erase(it);
+		}
+	}
+	lock.unlock();
+	loaded.set_value(pixels);
+	return pixels;
+}
+
+//----------------------------------------------------------
+shared_ptr<ofTexture> ofAssetCache::Data::loadTexture(const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	auto key = textureKey(path, settings);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = entries.find(key);
+		if(it != entries.end() && it->second.asset){
+			it->second.lastUse = ++uses;
+			return static_pointer_cast<ofTexture>(it->second.asset);
+		}
+	}
+
+	// reuses the pixels if they were decoded already or are being
+	// decoded by an async load
+	auto pixels = loadPixels(path, settings);
+	if(!pixels){
+		return nullptr;
+	}
+	auto texture = make_shared<ofTexture>();
+	texture->loadData(*pixels);
+	pixels.reset();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = entries.find(pixelsKey(path, settings));
+		if(it != entries.end() && it->second.asset.use_count() == 1){
+			pixels = static_pointer_cast<ofPixels>(it->second.asset);
+			usage -= it->second.bytes;
+			entries.erase(it);
+		}
+	}
+	// freed out of the lock
+	pixels.reset();
+
+	insert(key, texture, textureBytes(*texture));
+	purge();
+	return texture;
+}
+
+//----------------------------------------------------------
+void ofAssetCache::Data::purge(){
+	vector<shared_ptr<void>> evicted;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(usage <= budget){
+			return;
+		}
+		vector<unordered_map<string, Entry>::iterator> unused;
+		for(auto it = entries.begin(); it != entries.end(); ++it){
+			if(it->second.asset && it->second.asset.use_count() == 1){
+				unused.push_back(it);
+			}
+		}
+		sort(unused.begin(), unused.end(), [](const auto & a, const auto & b){
+			return a->second.lastUse < b->second.lastUse;
+		});
+		for(auto & it: unused){
+			if(usage <= budget){
+				break;
+			}
+			usage -= it->second.bytes;
+			evicted.push_back(std::move(it->second.asset));
+			entries.erase(it);
+		}
+	}
+	// textures and fonts are deleted out of the lock
+	evicted.clear();
+}
+
+//----------------------------------------------------------
+void ofAssetCache::Data::insert(const string & key, shared_ptr<void> asset, uint64_t bytes){
+	std::lock_guard<std::mutex> lock(mutex);
+	auto & entry = entries[key];
+	usage -= entry.bytes;
+	entry.asset = std::move(asset);
+	entry.bytes = bytes;
+	entry.lastUse = ++uses;
+	usage += bytes;
+}
+
+//----------------------------------------------------------
+ofAssetCache::ofAssetCache()
+:data(make_shared<Data>()){}
+
+//----------------------------------------------------------
+ofAssetCache::~ofAssetCache(){}
+
+//----------------------------------------------------------
+shared_ptr<const ofPixels> ofAssetCache::getPixels(const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	return data->loadPixels(path, settings);
+}
+
+//----------------------------------------------------------
+shared_ptr<ofTexture> ofAssetCache::getTexture(const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	return data->loadTexture(path, settings);
+}
+
+//----------------------------------------------------------
+void ofAssetCache::getTextureAsync(const std::filesystem::path & path, function<void(shared_ptr<ofTexture>)> loaded, const ofImageLoadSettings & settings){
+	shared_ptr<ofTexture> texture;
+	{
+		std::lock_guard<std::mutex> lock(data->mutex);
+		auto it = data->entries.find(textureKey(path, settings));
+		if(it != data->entries.end() && it->second.asset){
+			it->second.lastUse = ++data->uses;
+			texture = static_pointer_cast<ofTexture>(it->second.asset);
+		}
+	}
+	if(texture){
+		loaded(texture);
+		return;
+	}
+
+	weak_ptr<Data> weakData = data;
+	ofGetTaskPool().submit([weakData, path, settings]{
+		auto data = weakData.lock();
+		return data ? data->loadPixels(path, settings) : shared_ptr<ofPixels>();
+	}, [weakData, path, settings, loaded](shared_ptr<ofPixels> & pixels){
+		auto data = weakData.lock();
+		shared_ptr<ofTexture> texture;
+		if(data && pixels){
+			// the pixels are cached, this only uploads them
+			pixels.reset();
+			texture = data->loadTexture(path, settings);
+		}
+		loaded(texture);
+	});
+}
+
+//----------------------------------------------------------
+shared_ptr<ofTrueTypeFont> ofAssetCache::getFont(const ofTrueTypeFont::Settings & settings){
+	auto key = fontKey(settings);
+	{
+		std::lock_guard<std::mutex> lock(data->mutex);
+		auto it = data->entries.find(key);
+		if(it != data->entries.end() && it->second.asset){
+			it->second.lastUse = ++data->uses;
+			return static_pointer_cast<ofTrueTypeFont>(it->second.asset);
+		}
+	}
+	auto font = make_shared<ofTrueTypeFont>();
+	if(!font->load(settings)){
+		return nullptr;
+	}
+	uint64_t bytes = 0;
+	for(size_t page = 0; page < font->getNumAtlasPages(); page++){
+		bytes += textureBytes(font->getFontTexture(page));
+	}
+	data->insert(key, font, bytes);
+	data->purge();
+	return font;
+}
+
+//----------------------------------------------------------
+shared_ptr<ofTrueTypeFont> ofAssetCache::getFont(const std::filesystem::path & path, int size){
+	return getFont(ofTrueTypeFont::Settings(path, size));
+}
+
+//----------------------------------------------------------
+void ofAssetCache::setMemoryBudget(uint64_t bytes){
+	{
+		std::lock_guard<std::mutex> lock(data->mutex);
+		data->budget = bytes;
+	}
+	data->purge();
+}
+
+//----------------------------------------------------------
+uint64_t ofAssetCache::getMemoryBudget() const{
+	std::lock_guard<std::mutex> lock(data->mutex);
+	return data->budget;
+}
+
+//----------------------------------------------------------
+uint64_t ofAssetCache::getMemoryUsage() const{
+	std::lock_guard<std::mutex> lock(data->mutex);
+	return data->usage;
+}
+
+//----------------------------------------------------------
+void ofAssetCache::purge(){
+	data->purge();
+}
+
+//----------------------------------------------------------
+void ofAssetCache::clear(){
+	unordered_map<string, Data::Entry> entries;
+	{
+		std::lock_guard<std::mutex> lock(data->mutex);
+		std::swap(entries, data->entries);
+		data->usage = 0;
+	}
+	// loads in flight still notify the threads waiting for them
+}
+
+//----------------------------------------------------------
+size_t ofAssetCache::getNumAssets() const{
+	std::lock_guard<std::mutex> lock(data->mutex);
+	size_t numAssets = 0;
+	for(auto & entry: data->entries){
+		if(entry.second.asset){
+			numAssets++;
+		}
+	}
+	return numAssets;
+}
+
+//----------------------------------------------------------
+ofAssetCache & ofGetAssetCache(){
+	static ofAssetCache cache;
+	return cache;
+}
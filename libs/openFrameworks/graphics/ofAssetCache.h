@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofImage.h"
+#include "ofTrueTypeFont.h"
+#include <functional>
+#include <memory>
+
+/// \brief Shares the images, textures and fonts loaded from the same file
+/// with the same settings, so every user of an asset gets the same copy in
+/// memory instead of loading its own one
+///
+/// Assets are returned as shared pointers, the different parts of an app
+/// asking for the same path get the same object:
+///
+/// ~~~~{.cpp}
+/// // both point to the same texture, loaded and uploaded once
+/// auto grass = ofGetAssetCache().getTexture("grass.png");
+/// auto sameGrass = ofGetAssetCache().getTexture("grass.png");
+///
+/// // decoded in the task pool, the callback runs in the main thread
+/// ofGetAssetCache().getTextureAsync("sky.jpg", [this](std::shared_ptr<ofTexture> texture){
+///     sky = texture;
+/// });
+///
+/// auto font = ofGetAssetCache().getFont(OF_TTF_SANS, 14);
+/// ~~~~
+///
+/// The cache keeps its own reference to every asset, so they stay loaded
+/// after the app drops them and can be reused later. Once the memory used
+/// by the cached assets goes over getMemoryBudget() the ones that have
+/// been unused for longer and aren't referenced from anywhere else are
+/// freed. Assets still in use are never freed, they are only counted.
+///
+/// getPixels() can be called from any thread, several threads asking for
+/// the same image wait for the same load. Textures and fonts have to be
+/// requested from the GL thread.
+class ofAssetCache{
+public:
+	ofAssetCache();
+	~ofAssetCache();
+
+	ofAssetCache(const ofAssetCache &) = delete;
+	ofAssetCache & operator=(const ofAssetCache &) = delete;
+
+	/// \brief The pixels of the image at path, decoded with settings,
+	/// thread safe
+	///
+	/// \returns nullptr if the image can't be loaded
+	std::shared_ptr<const ofPixels> getPixels(const std::filesystem::path & path, const ofImageLoadSettings & settings = ofImageLoadSettings());
+
+	/// \brief A texture with the image at path, reusing its pixels if
+	/// they were already decoded
+	///
+	/// The pixels are dropped from the cache once they are uploaded,
+	/// unless something else holds them.
+	/// \returns nullptr if the image can't be loaded
+	std::shared_ptr<ofTexture> getTexture(const std::filesystem::path & path, const ofImageLoadSettings & settings = ofImageLoadSettings());
+
+	/// \brief Decodes the image in the task pool and calls loaded with
+	/// the texture, from the main thread, once it's uploaded
+	///
+	/// If the texture is already cached loaded is called right away.
+	void getTextureAsync(const std::filesystem::path & path, std::function<void(std::shared_ptr<ofTexture>)> loaded, const ofImageLoadSettings & settings = ofImageLoadSettings());
+
+	/// \brief A font loaded with settings
+	///
+	/// \returns nullptr if the font can't be loaded
+	std::shared_ptr<ofTrueTypeFont> getFont(const ofTrueTypeFont::Settings & settings);
+
+	/// \brief A font loaded with the default settings at size
+	std::shared_ptr<ofTrueTypeFont> getFont(const std::filesystem::path & path, int size);
+
+	/// \brief Bytes the cached assets can use before the unused ones are
+	/// freed, 256MB by default
+	void setMemoryBudget(uint64_t bytes);
+	uint64_t getMemoryBudget() const;
+
+	/// \brief Bytes used by the cached assets, in CPU or GPU memory,
+	/// including the ones still in use
+	uint64_t getMemoryUsage() const;
+
+	/// \brief Frees the least recently used assets that aren't referenced
+	/// outside the cache until the usage is under budget, has to be
+	/// called from the GL thread
+	///
+	/// Called when textures or fonts are requested.
+	void purge();
+
+	/// \brief Drops the cache's references to all the assets
+	///
+	/// The ones still in use stay alive until they are released but
+	/// they'll be loaded again if requested.
+	void clear();
+
+	/// \brief Number of assets in the cache
+	std::size_t getNumAssets() const;
+
+private:
+	struct Data;
+	std::shared_ptr<Data> data;
+};
+
+/// \brief A cache shared by the whole application
+ofAssetCache & ofGetAssetCache();
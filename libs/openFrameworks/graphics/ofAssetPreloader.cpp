@@ -0,0 +1,265 @@
+#include "ofAssetPreloader.h"
+#include "ofTaskPool.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+
+using namespace std;
+
+namespace{
+	template<typename PixelType>
+	void addImage(ofAssetPreloader & preloader, ofImage_<PixelType> & image, const std::filesystem::path & path, const ofImageLoadSettings & settings){
+		auto pixels = make_shared<ofPixels_<PixelType>>();
+		preloader.add(path.string(), [pixels, path, settings]{
+			return ofLoadImage(*pixels, path, settings);
+		}, [&image, pixels]{
+			// the decoded pixels are moved in, update() uploads them
+			image.getPixels().swap(*pixels);
+			image.update();
+			pixels->clear();
+			return true;
+		});
+	}
+}
+
+//----------------------------------------------------------
+ofAssetPreloader::ofAssetPreloader()
+:numFinished(0)
+,maxUploadTime(4)
+,loading(false){}
+
+//----------------------------------------------------------
+ofAssetPreloader::~ofAssetPreloader(){
+	if(loading){
+		ofRemoveListener(ofEvents().update, this, &ofAssetPreloader::update);
+	}
+	// the tasks still running load into the app's objects
+	for(auto & asset: assets){
+		if(asset.prepared.valid()){
+			asset.prepared.wait();
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofImage & image, const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	addImage(*this, image, path, settings);
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofFloatImage & image, const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	addImage(*this, image, path, settings);
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofShortImage & image, const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	addImage(*this, image, path, settings);
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofTexture & texture, const std::filesystem::path & path, const ofImageLoadSettings & settings){
+	auto pixels = make_shared<ofPixels>();
+	add(path.string(), [pixels, path, settings]{
+		return ofLoadImage(*pixels, path, settings);
+	}, [&texture, pixels]{
+		// same as ofLoadImage(ofTexture &)
+		texture.allocate(pixels->getWidth(), pixels->getHeight(), ofGetGlInternalFormat(*pixels));
+		texture.loadData(*pixels);
+		pixels->clear();
+		return true;
+	});
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofTrueTypeFont & font, const ofTrueTypeFont::Settings & settings){
+	add(settings.fontName.string(), [&font, settings]{
+		return font.prepare(settings);
+	}, [&font]{
+		return font.uploadTextures();
+	});
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofShader & shader, const std::filesystem::path & shaderName){
+	addAsync(shaderName.string(), [&shader, shaderName]{
+		return shader.loadAsync(shaderName);
+	}, [&shader]{
+		return shader.isLoading();
+	}, [&shader]{
+		return shader.isLoaded();
+	});
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofShader & shader, const ofShader::Settings & settings){
+	string name = settings.shaderFiles.empty() ? "shader" : settings.shaderFiles.begin()->second.string();
+	addAsync(name, [&shader, settings]{
+		return shader.setupAsync(settings);
+	}, [&shader]{
+		return shader.isLoading();
+	}, [&shader]{
+		return shader.isLoaded();
+	});
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(ofSoundPlayer & sound, const std::filesystem::path & path, bool stream){
+#ifdef OF_SOUND_PLAYER_OPENAL
+	auto openAL = dynamic_pointer_cast<ofOpenALSoundPlayer>(sound.getPlayer());
+	if(openAL){
+		addAsync(path.string(), [openAL, path, stream]{
+			openAL->loadAsync(path, stream);
+			return true;
+		}, [openAL]{
+			return openAL->isLoading();
+		}, [openAL]{
+			return openAL->isLoaded();
+		});
+		return;
+	}
+#endif
+	// other players can't load from another thread
+	add(path.string(), nullptr, [&sound, path, stream]{
+		return sound.load(path, stream);
+	});
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(const std::string & name, std::function<bool()> prepare, std::function<bool()> finish){
+	Asset asset;
+	asset.name = name;
+	asset.prepare = prepare;
+	asset.finish = finish;
+	add(std::move(asset));
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::addAsync(const std::string & name, std::function<bool()> start, std::function<bool()> isLoading, std::function<bool()> isLoaded){
+	Asset asset;
+	asset.name = name;
+	asset.start = start;
+	asset.isLoading = isLoading;
+	asset.isLoaded = isLoaded;
+	add(std::move(asset));
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::add(Asset && asset){
+	assets.push_back(std::move(asset));
+	if(loading){
+		submit(assets.back());
+	}
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::submit(Asset & asset){
+	if(asset.state != Asset::Waiting){
+		return;
+	}
+	if(asset.prepare){
+		asset.prepared = ofGetTaskPool().submit(asset.prepare);
+		asset.state = Asset::Preparing;
+	}else if(!asset.start){
+		asset.state = Asset::Prepared;
+	}
+	// the ones that load on their own are started from update()
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::start(){
+	if(loading){
+		return;
+	}
+	loading = true;
+	for(auto & asset: assets){
+		submit(asset);
+	}
+	ofAddListener(ofEvents().update, this, &ofAssetPreloader::update);
+}
+
+//----------------------------------------------------------
+bool ofAssetPreloader::isLoading() const{
+	return loading;
+}
+
+//----------------------------------------------------------
+float ofAssetPreloader::getLoadingProgress() const{
+	return assets.empty() ? 1 : float(numFinished) / assets.size();
+}
+
+//----------------------------------------------------------
+std::size_t ofAssetPreloader::getNumAssets() const{
+	return assets.size();
+}
+
+//----------------------------------------------------------
+vector<string> ofAssetPreloader::getFailedAssets() const{
+	vector<string> failed;
+	for(auto & asset: assets){
+		if(asset.state == Asset::Failed){
+			failed.push_back(asset.name);
+		}
+	}
+	return failed;
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::setMaxUploadTimePerFrame(float ms){
+	maxUploadTime = ms;
+}
+
+//----------------------------------------------------------
+float ofAssetPreloader::getMaxUploadTimePerFrame() const{
+	return maxUploadTime;
+}
+
+//----------------------------------------------------------
+void ofAssetPreloader::update(ofEventArgs &){
+	auto begin = ofGetElapsedTimeMicros();
+	bool uploaded = false;
+	auto inBudget = [&]{
+		// at least one per frame so it always makes progress
+		return !uploaded || maxUploadTime <= 0 || ofGetElapsedTimeMicros() - begin < maxUploadTime * 1000;
+	};
+	auto finished = [&](Asset & asset, bool ok){
+		asset.state = ok ? Asset::Loaded : Asset::Failed;
+		if(!ok){
+			ofLogError("ofAssetPreloader") << "update(): couldn't load \"" << asset.name << "\"";
+		}
+		numFinished++;
+		float progress = getLoadingProgress();
+		ofNotifyEvent(loadProgressEvent, progress, this);
+	};
+
+	// loadProgressEvent listeners could add more assets
+	for(size_t i = 0; i < assets.size(); i++){
+		Asset & asset = assets[i];
+		if(asset.state == Asset::Preparing && asset.prepared.wait_for(std::chrono::seconds(0)) == std::future_status::ready){
+			if(asset.prepared.get()){
+				asset.state = Asset::Prepared;
+			}else{
+				finished(asset, false);
+				continue;
+			}
+		}
+		if(asset.state == Asset::Prepared && inBudget()){
+			uploaded = true;
+			finished(asset, asset.finish ? asset.finish() : true);
+		}else if(asset.state == Asset::Waiting && asset.start && inBudget()){
+			uploaded = true;
+			if(asset.start()){
+				asset.state = Asset::Loading;
+			}else{
+				finished(asset, false);
+			}
+		}else if(asset.state == Asset::Loading && !asset.isLoading()){
+			finished(asset, asset.isLoaded ? asset.isLoaded() : true);
+		}
+	}
+
+	if(numFinished == assets.size()){
+		loading = false;
+		ofRemoveListener(ofEvents().update, this, &ofAssetPreloader::update);
+		bool ok = getFailedAssets().empty();
+		ofNotifyEvent(loadedEvent, ok, this);
+	}
+}
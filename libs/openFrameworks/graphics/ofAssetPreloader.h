@@ -0,0 +1,149 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofEvents.h"
+#include "ofImage.h"
+#include "ofTrueTypeFont.h"
+#include "ofShader.h"
+#include "ofSoundPlayer.h"
+#include <functional>
+#include <future>
+
+/// \brief Loads the assets an app needs at startup in parallel while it
+/// keeps drawing, usually a loading screen
+///
+/// Assets are registered first and start() loads all of them: images are
+/// decoded and fonts rasterized in the task pool, shaders are compiled by
+/// the driver with ofShader::setupAsync() and sounds decoded in the
+/// background when the player supports it. What has to happen in the GL
+/// thread, uploading the textures or starting the asynchronous loads, is
+/// done from the update event, as much per frame as fits in
+/// setMaxUploadTimePerFrame(), so the app keeps drawing:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     preloader.add(background, "background.jpg");
+///     preloader.add(font, ofTrueTypeFont::Settings("Sans.ttf", 32));
+///     preloader.add(shader, "shaders/blur");
+///     preloader.add(music, "music.mp3", true);
+///     // anything else that loads asynchronously on its own
+///     preloader.addAsync("city.fbx", [this]{
+///         model.loadModelAsync("city.fbx");
+///         return true;
+///     }, [this]{
+///         return model.isLoading();
+///     });
+///     ofAddListener(preloader.loadedEvent, this, &ofApp::assetsLoaded);
+///     preloader.start();
+/// }
+///
+/// void ofApp::draw(){
+///     if(preloader.isLoading()){
+///         ofDrawBitmapString("loading " + ofToString(preloader.getLoadingProgress() * 100, 0) + "%", 20, 20);
+///         return;
+///     }
+///     background.draw(0, 0);
+/// }
+/// ~~~~
+///
+/// The assets are loaded in place and have to outlive the preloader or
+/// stay alive until loadedEvent, they can't be used while they load.
+/// Everything has to be called from the main thread.
+class ofAssetPreloader{
+public:
+	ofAssetPreloader();
+	/// \brief Waits for the assets still being prepared in the task pool
+	~ofAssetPreloader();
+
+	ofAssetPreloader(const ofAssetPreloader &) = delete;
+	ofAssetPreloader & operator=(const ofAssetPreloader &) = delete;
+
+	void add(ofImage & image, const std::filesystem::path & path, const ofImageLoadSettings & settings = ofImageLoadSettings());
+	void add(ofFloatImage & image, const std::filesystem::path & path, const ofImageLoadSettings & settings = ofImageLoadSettings());
+	void add(ofShortImage & image, const std::filesystem::path & path, const ofImageLoadSettings & settings = ofImageLoadSettings());
+	void add(ofTexture & texture, const std::filesystem::path & path, const ofImageLoadSettings & settings = ofImageLoadSettings());
+
+	/// \brief Rasterized in the task pool with ofTrueTypeFont::prepare(),
+	/// one font at a time
+	void add(ofTrueTypeFont & font, const ofTrueTypeFont::Settings & settings);
+
+	/// \brief Compiled with ofShader::loadAsync()
+	void add(ofShader & shader, const std::filesystem::path & shaderName);
+	void add(ofShader & shader, const ofShader::Settings & settings);
+
+	/// \brief Decoded in the background with the OpenAL player, loaded
+	/// from the main thread within the budget with the other players
+	void add(ofSoundPlayer & sound, const std::filesystem::path & path, bool stream = false);
+
+	/// \brief Any other kind of asset, prepare is called from the task pool
+	/// and, if it returns true, finish from the main thread within the
+	/// budget. Either can be nullptr.
+	void add(const std::string & name, std::function<bool()> prepare, std::function<bool()> finish);
+
+	/// \brief An asset that loads asynchronously on its own, like a model
+	/// with ofxAssimpModelLoader::loadModelAsync()
+	///
+	/// start is called from the main thread within the budget and returns
+	/// false if the load couldn't start, isLoading is then polled every
+	/// frame until it returns false. isLoaded tells if it succeeded, it's
+	/// assumed it did without it.
+	void addAsync(const std::string & name, std::function<bool()> start, std::function<bool()> isLoading, std::function<bool()> isLoaded = nullptr);
+
+	/// \brief Starts loading the assets added, the ones added while
+	/// loading start right away
+	void start();
+
+	/// \brief true from start() until loadedEvent
+	bool isLoading() const;
+
+	/// \brief Fraction of the assets that finished, from 0 to 1
+	float getLoadingProgress() const;
+
+	std::size_t getNumAssets() const;
+
+	/// \brief Names, usually the paths, of the assets that failed to load
+	std::vector<std::string> getFailedAssets() const;
+
+	/// \brief Maximum milliseconds spent in the main thread per frame, 4ms
+	/// by default, 0 for no limit. At least one asset is finished every
+	/// frame, even if it takes longer.
+	void setMaxUploadTimePerFrame(float ms);
+	float getMaxUploadTimePerFrame() const;
+
+	/// \brief Notified from the main thread with the progress every time
+	/// an asset finishes
+	ofEvent<float> loadProgressEvent;
+
+	/// \brief Notified once every asset finished, true if all of them
+	/// loaded
+	ofEvent<bool> loadedEvent;
+
+private:
+	struct Asset{
+		enum State{
+			Waiting,
+			Preparing,
+			Prepared,
+			Loading,
+			Loaded,
+			Failed,
+		};
+		std::string name;
+		std::function<bool()> prepare; ///< in the task pool
+		std::function<bool()> finish; ///< in the main thread, after prepare
+		std::function<bool()> start; ///< in the main thread, for the ones that load on their own
+		std::function<bool()> isLoading;
+		std::function<bool()> isLoaded;
+		std::future<bool> prepared;
+		State state = Waiting;
+	};
+
+	void add(Asset && asset);
+	void submit(Asset & asset);
+	void update(ofEventArgs & args);
+
+	std::vector<Asset> assets;
+	std::size_t numFinished;
+	float maxUploadTime;
+	bool loading;
+};
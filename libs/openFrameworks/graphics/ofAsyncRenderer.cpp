@@ -0,0 +1,563 @@
+#include "ofAsyncRenderer.h"
+#include "ofImage.h"
+#include "ofMesh.h"
+#include <future>
+
+using namespace std;
+
+const string ofAsyncRenderer::TYPE="async";
+
+//----------------------------------------------------------
+ofAsyncRenderer::ofAsyncRenderer(shared_ptr<ofBaseRenderer> target)
+:target(target)
+,graphics3d(this){
+	worker = std::thread([this]{
+		function<void()> call;
+		while(calls.receive(call)){
+			call();
+		}
+	});
+}
+
+//----------------------------------------------------------
+ofAsyncRenderer::~ofAsyncRenderer(){
+	waitIdle();
+	calls.close();
+	worker.join();
+}
+
+//----------------------------------------------------------
+shared_ptr<ofBaseRenderer> ofAsyncRenderer::getTarget() const{
+	return target;
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::push(function<void()> && call) const{
+	calls.send(std::move(call));
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::waitIdle() const{
+	auto done = make_shared<promise<void>>();
+	auto future = done->get_future();
+	push([done]{ done->set_value(); });
+	future.wait();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::startRender(){
+	push([=]{ target->startRender(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::finishRender(){
+	push([=]{ target->finishRender(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofPolyline & poly) const{
+	push([=]{ target->draw(poly); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofPath & shape) const{
+	push([=]{ target->draw(shape); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofMesh & vertexData, ofPolyRenderMode renderType, bool useColors, bool useTextures, bool useNormals) const{
+	push([=]{ target->draw(vertexData, renderType, useColors, useTextures, useNormals); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const of3dPrimitive & model, ofPolyRenderMode renderType) const{
+	waitIdle();
+	target->draw(model, renderType);
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofNode & model) const{
+	waitIdle();
+	target->draw(model);
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
+	// only the pixels, the texture can't be used or destroyed in the worker
+	auto copy = make_shared<ofImage>();
+	copy->setUseTexture(false);
+	copy->setFromPixels(image.getPixels());
+	push([=]{ target->draw(*copy, x, y, z, w, h, sx, sy, sw, sh); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofFloatImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
+	// only the pixels, the texture can't be used or destroyed in the worker
+	auto copy = make_shared<ofFloatImage>();
+	copy->setUseTexture(false);
+	copy->setFromPixels(image.getPixels());
+	push([=]{ target->draw(*copy, x, y, z, w, h, sx, sy, sw, sh); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofShortImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
+	// only the pixels, the texture can't be used or destroyed in the worker
+	auto copy = make_shared<ofShortImage>();
+	copy->setUseTexture(false);
+	copy->setFromPixels(image.getPixels());
+	push([=]{ target->draw(*copy, x, y, z, w, h, sx, sy, sw, sh); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::draw(const ofBaseVideoDraws & video, float x, float y, float w, float h) const{
+	waitIdle();
+	target->draw(video, x, y, w, h);
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::pushView(){
+	push([=]{ target->pushView(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::popView(){
+	push([=]{ target->popView(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::viewport(ofRectangle viewport){
+	push([=]{ target->viewport(viewport); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::viewport(float x, float y, float width, float height, bool vflip){
+	push([=]{ target->viewport(x, y, width, height, vflip); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setupScreenPerspective(float width, float height, float fov, float nearDist, float farDist){
+	push([=]{ target->setupScreenPerspective(width, height, fov, nearDist, farDist); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setupScreenOrtho(float width, float height, float nearDist, float farDist){
+	push([=]{ target->setupScreenOrtho(width, height, nearDist, farDist); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setOrientation(ofOrientation orientation, bool vFlip){
+	push([=]{ target->setOrientation(orientation, vFlip); });
+}
+
+//----------------------------------------------------------
+ofRectangle ofAsyncRenderer::getCurrentViewport() const{
+	waitIdle();
+	return target->getCurrentViewport();
+}
+
+//----------------------------------------------------------
+ofRectangle ofAsyncRenderer::getNativeViewport() const{
+	waitIdle();
+	return target->getNativeViewport();
+}
+
+//----------------------------------------------------------
+int ofAsyncRenderer::getViewportWidth() const{
+	waitIdle();
+	return target->getViewportWidth();
+}
+
+//----------------------------------------------------------
+int ofAsyncRenderer::getViewportHeight() const{
+	waitIdle();
+	return target->getViewportHeight();
+}
+
+//----------------------------------------------------------
+bool ofAsyncRenderer::isVFlipped() const{
+	waitIdle();
+	return target->isVFlipped();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setCoordHandedness(ofHandednessType handedness){
+	push([=]{ target->setCoordHandedness(handedness); });
+}
+
+//----------------------------------------------------------
+ofHandednessType ofAsyncRenderer::getCoordHandedness() const{
+	waitIdle();
+	return target->getCoordHandedness();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::pushMatrix(){
+	push([=]{ target->pushMatrix(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::popMatrix(){
+	push([=]{ target->popMatrix(); });
+}
+
+//----------------------------------------------------------
+glm::mat4 ofAsyncRenderer::getCurrentMatrix(ofMatrixMode matrixMode) const{
+	waitIdle();
+	return target->getCurrentMatrix(matrixMode);
+}
+
+//----------------------------------------------------------
+glm::mat4 ofAsyncRenderer::getCurrentOrientationMatrix() const{
+	waitIdle();
+	return target->getCurrentOrientationMatrix();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::translate(float x, float y, float z){
+	push([=]{ target->translate(x, y, z); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::translate(const glm::vec3 & p){
+	push([=]{ target->translate(p); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::scale(float xAmnt, float yAmnt, float zAmnt){
+	push([=]{ target->scale(xAmnt, yAmnt, zAmnt); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::rotateRad(float radians, float vecX, float vecY, float vecZ){
+	push([=]{ target->rotateRad(radians, vecX, vecY, vecZ); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::rotateXRad(float radians){
+	push([=]{ target->rotateXRad(radians); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::rotateYRad(float radians){
+	push([=]{ target->rotateYRad(radians); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::rotateZRad(float radians){
+	push([=]{ target->rotateZRad(radians); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::rotateRad(float radians){
+	push([=]{ target->rotateRad(radians); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::matrixMode(ofMatrixMode mode){
+	push([=]{ target->matrixMode(mode); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::loadIdentityMatrix(void){
+	push([=]{ target->loadIdentityMatrix(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::loadMatrix(const glm::mat4 & m){
+	push([=]{ target->loadMatrix(m); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::loadMatrix(const float * m){
+	loadMatrix(glm::make_mat4(m));
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::multMatrix(const glm::mat4 & m){
+	push([=]{ target->multMatrix(m); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::multMatrix(const float * m){
+	multMatrix(glm::make_mat4(m));
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::loadViewMatrix(const glm::mat4 & m){
+	push([=]{ target->loadViewMatrix(m); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::multViewMatrix(const glm::mat4 & m){
+	push([=]{ target->multViewMatrix(m); });
+}
+
+//----------------------------------------------------------
+glm::mat4 ofAsyncRenderer::getCurrentViewMatrix() const{
+	waitIdle();
+	return target->getCurrentViewMatrix();
+}
+
+//----------------------------------------------------------
+glm::mat4 ofAsyncRenderer::getCurrentNormalMatrix() const{
+	waitIdle();
+	return target->getCurrentNormalMatrix();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::bind(const ofCamera & camera, const ofRectangle & viewport){
+	waitIdle();
+	target->bind(camera, viewport);
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::unbind(const ofCamera & camera){
+	waitIdle();
+	target->unbind(camera);
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setupGraphicDefaults(){
+	push([=]{ target->setupGraphicDefaults(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setupScreen(){
+	push([=]{ target->setupScreen(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setRectMode(ofRectMode mode){
+	push([=]{ target->setRectMode(mode); });
+}
+
+//----------------------------------------------------------
+ofRectMode ofAsyncRenderer::getRectMode(){
+	waitIdle();
+	return target->getRectMode();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setFillMode(ofFillFlag fill){
+	push([=]{ target->setFillMode(fill); });
+}
+
+//----------------------------------------------------------
+ofFillFlag ofAsyncRenderer::getFillMode(){
+	waitIdle();
+	return target->getFillMode();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setLineWidth(float lineWidth){
+	push([=]{ target->setLineWidth(lineWidth); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setDepthTest(bool depthTest){
+	push([=]{ target->setDepthTest(depthTest); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setBlendMode(ofBlendMode blendMode){
+	push([=]{ target->setBlendMode(blendMode); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setLineSmoothing(bool smooth){
+	push([=]{ target->setLineSmoothing(smooth); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setCircleResolution(int res){
+	push([=]{ target->setCircleResolution(res); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::enableAntiAliasing(){
+	push([=]{ target->enableAntiAliasing(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::disableAntiAliasing(){
+	push([=]{ target->disableAntiAliasing(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setColor(int r, int g, int b){
+	push([=]{ target->setColor(r, g, b); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setColor(int r, int g, int b, int a){
+	push([=]{ target->setColor(r, g, b, a); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setColor(const ofColor & color){
+	push([=]{ target->setColor(color); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setColor(const ofColor & color, int _a){
+	push([=]{ target->setColor(color, _a); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setColor(int gray){
+	push([=]{ target->setColor(gray); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setHexColor(int hexColor){
+	push([=]{ target->setHexColor(hexColor); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setBitmapTextMode(ofDrawBitmapMode mode){
+	push([=]{ target->setBitmapTextMode(mode); });
+}
+
+//----------------------------------------------------------
+ofColor ofAsyncRenderer::getBackgroundColor(){
+	waitIdle();
+	return target->getBackgroundColor();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setBackgroundColor(const ofColor & c){
+	push([=]{ target->setBackgroundColor(c); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::background(const ofColor & c){
+	push([=]{ target->background(c); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::background(float brightness){
+	push([=]{ target->background(brightness); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::background(int hexColor, float _a){
+	push([=]{ target->background(hexColor, _a); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::background(int r, int g, int b, int a){
+	push([=]{ target->background(r, g, b, a); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setBackgroundAuto(bool bManual){
+	push([=]{ target->setBackgroundAuto(bManual); });
+}
+
+//----------------------------------------------------------
+bool ofAsyncRenderer::getBackgroundAuto(){
+	waitIdle();
+	return target->getBackgroundAuto();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::clear(){
+	push([=]{ target->clear(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::clear(float r, float g, float b, float a){
+	push([=]{ target->clear(r, g, b, a); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::clear(float brightness, float a){
+	push([=]{ target->clear(brightness, a); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::clearAlpha(){
+	push([=]{ target->clearAlpha(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const{
+	push([=]{ target->drawLine(x1, y1, z1, x2, y2, z2); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::drawRectangle(float x, float y, float z, float w, float h) const{
+	push([=]{ target->drawRectangle(x, y, z, w, h); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const{
+	push([=]{ target->drawTriangle(x1, y1, z1, x2, y2, z2, x3, y3, z3); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::drawCircle(float x, float y, float z, float radius) const{
+	push([=]{ target->drawCircle(x, y, z, radius); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::drawEllipse(float x, float y, float z, float width, float height) const{
+	push([=]{ target->drawEllipse(x, y, z, width, height); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::drawString(string text, float x, float y, float z) const{
+	push([=]{ target->drawString(text, x, y, z); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::drawString(const ofTrueTypeFont & font, string text, float x, float y) const{
+	waitIdle();
+	target->drawString(font, text, x, y);
+}
+
+//----------------------------------------------------------
+ofPath & ofAsyncRenderer::getPath(){
+	return path;
+}
+
+//----------------------------------------------------------
+ofStyle ofAsyncRenderer::getStyle() const{
+	waitIdle();
+	return target->getStyle();
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setStyle(const ofStyle & style){
+	push([=]{ target->setStyle(style); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::pushStyle(){
+	push([=]{ target->pushStyle(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::popStyle(){
+	push([=]{ target->popStyle(); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setCurveResolution(int resolution){
+	push([=]{ target->setCurveResolution(resolution); });
+}
+
+//----------------------------------------------------------
+void ofAsyncRenderer::setPolyMode(ofPolyWindingMode mode){
+	push([=]{ target->setPolyMode(mode); });
+}
+
+//----------------------------------------------------------
+const of3dGraphics & ofAsyncRenderer::get3dGraphics() const{
+	return graphics3d;
+}
+
+//----------------------------------------------------------
+of3dGraphics & ofAsyncRenderer::get3dGraphics(){
+	return graphics3d;
+}
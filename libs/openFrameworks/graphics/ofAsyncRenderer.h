@@ -0,0 +1,172 @@
+#pragma once
+
+#include "ofBaseTypes.h"
+#include "ofPath.h"
+#include "of3dGraphics.h"
+#include "ofThreadChannel.h"
+#include <functional>
+#include <thread>
+
+/// \brief Forwards the calls to another renderer from a worker thread
+///
+/// Meant for non interactive renderers, like an ofCairoRenderer recording
+/// to PDF or SVG, put in an ofRendererCollection next to the GL renderer
+/// so recording doesn't slow down drawing to the screen:
+///
+/// ~~~~{.cpp}
+/// auto cairo = std::make_shared<ofCairoRenderer>();
+/// cairo->setup("frame.pdf", ofCairoRenderer::PDF);
+/// auto async = std::make_shared<ofAsyncRenderer>(cairo);
+/// collection->renderers.push_back(async);
+/// ...
+/// async->waitIdle(); // before closing or reading the result
+/// cairo->close();
+/// ~~~~
+///
+/// Every call is queued with a copy of its arguments and executed in
+/// order by the worker, images are copied without their texture. Calls
+/// that need an object that can't be copied safely, drawing an
+/// ofTrueTypeFont, an ofNode, an of3dPrimitive or a video, and all the
+/// getters wait for the queue to be empty and run on the calling thread.
+/// The collection only reads state from its first renderer, so the
+/// asynchronous ones shouldn't go first.
+///
+/// The queue has no size limit, if the target renderer can't keep up it
+/// keeps growing until waitIdle() is called.
+class ofAsyncRenderer: public ofBaseRenderer{
+public:
+	ofAsyncRenderer(std::shared_ptr<ofBaseRenderer> target);
+	~ofAsyncRenderer();
+
+	ofAsyncRenderer(const ofAsyncRenderer &) = delete;
+	ofAsyncRenderer & operator=(const ofAsyncRenderer &) = delete;
+
+	static const std::string TYPE;
+	const std::string & getType(){ return TYPE; }
+
+	/// \brief The renderer the calls are forwarded to, only safe to use
+	/// directly after waitIdle()
+	std::shared_ptr<ofBaseRenderer> getTarget() const;
+
+	/// \brief Blocks until every queued call has been executed
+	void waitIdle() const;
+
+	void startRender();
+	void finishRender();
+
+	using ofBaseRenderer::draw;
+	void draw(const ofPolyline & poly) const;
+	void draw(const ofPath & shape) const;
+	void draw(const ofMesh & vertexData, ofPolyRenderMode renderType, bool useColors, bool useTextures, bool useNormals) const;
+	void draw(const of3dPrimitive & model, ofPolyRenderMode renderType) const;
+	void draw(const ofNode & model) const;
+	void draw(const ofImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void draw(const ofFloatImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void draw(const ofShortImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void draw(const ofBaseVideoDraws & video, float x, float y, float w, float h) const;
+
+	void pushView();
+	void popView();
+	void viewport(ofRectangle viewport);
+	void viewport(float x = 0, float y = 0, float width = -1, float height = -1, bool vflip=true);
+	void setupScreenPerspective(float width = -1, float height = -1, float fov = 60, float nearDist = 0, float farDist = 0);
+	void setupScreenOrtho(float width = -1, float height = -1, float nearDist = -1, float farDist = 1);
+	void setOrientation(ofOrientation orientation, bool vFlip);
+	ofRectangle getCurrentViewport() const;
+	ofRectangle getNativeViewport() const;
+	int getViewportWidth() const;
+	int getViewportHeight() const;
+	bool isVFlipped() const;
+	void setCoordHandedness(ofHandednessType handedness);
+	ofHandednessType getCoordHandedness() const;
+
+	void pushMatrix();
+	void popMatrix();
+	glm::mat4 getCurrentMatrix(ofMatrixMode matrixMode) const;
+	glm::mat4 getCurrentOrientationMatrix() const;
+	void translate(float x, float y, float z = 0);
+	void translate(const glm::vec3 & p);
+	void scale(float xAmnt, float yAmnt, float zAmnt = 1);
+	void rotateRad(float radians, float vecX, float vecY, float vecZ);
+	void rotateXRad(float radians);
+	void rotateYRad(float radians);
+	void rotateZRad(float radians);
+	void rotateRad(float radians);
+	void matrixMode(ofMatrixMode mode);
+	void loadIdentityMatrix(void);
+	void loadMatrix(const glm::mat4 & m);
+	void loadMatrix(const float * m);
+	void multMatrix(const glm::mat4 & m);
+	void multMatrix(const float * m);
+	void loadViewMatrix(const glm::mat4 & m);
+	void multViewMatrix(const glm::mat4 & m);
+	glm::mat4 getCurrentViewMatrix() const;
+	glm::mat4 getCurrentNormalMatrix() const;
+	void bind(const ofCamera & camera, const ofRectangle & viewport);
+	void unbind(const ofCamera & camera);
+
+	void setupGraphicDefaults();
+	void setupScreen();
+
+	void setRectMode(ofRectMode mode);
+	ofRectMode getRectMode();
+	void setFillMode(ofFillFlag fill);
+	ofFillFlag getFillMode();
+	void setLineWidth(float lineWidth);
+	void setDepthTest(bool depthTest);
+	void setBlendMode(ofBlendMode blendMode);
+	void setLineSmoothing(bool smooth);
+	void setCircleResolution(int res);
+	void enableAntiAliasing();
+	void disableAntiAliasing();
+
+	void setColor(int r, int g, int b);
+	void setColor(int r, int g, int b, int a);
+	void setColor(const ofColor & color);
+	void setColor(const ofColor & color, int _a);
+	void setColor(int gray);
+	void setHexColor(int hexColor);
+	void setBitmapTextMode(ofDrawBitmapMode mode);
+
+	ofColor getBackgroundColor();
+	void setBackgroundColor(const ofColor & c);
+	void background(const ofColor & c);
+	void background(float brightness);
+	void background(int hexColor, float _a=255.0f);
+	void background(int r, int g, int b, int a=255);
+	void setBackgroundAuto(bool bManual);
+	bool getBackgroundAuto();
+
+	void clear();
+	void clear(float r, float g, float b, float a=0);
+	void clear(float brightness, float a=0);
+	void clearAlpha();
+
+	void drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const;
+	void drawRectangle(float x, float y, float z, float w, float h) const;
+	void drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const;
+	void drawCircle(float x, float y, float z, float radius) const;
+	void drawEllipse(float x, float y, float z, float width, float height) const;
+	void drawString(std::string text, float x, float y, float z) const;
+	void drawString(const ofTrueTypeFont & font, std::string text, float x, float y) const;
+
+	ofPath & getPath();
+	ofStyle getStyle() const;
+	void setStyle(const ofStyle & style);
+	void pushStyle();
+	void popStyle();
+	void setCurveResolution(int resolution);
+	void setPolyMode(ofPolyWindingMode mode);
+
+	const of3dGraphics & get3dGraphics() const;
+	of3dGraphics & get3dGraphics();
+
+private:
+	void push(std::function<void()> && call) const;
+
+	std::shared_ptr<ofBaseRenderer> target;
+	mutable ofThreadChannel<std::function<void()>> calls;
+	std::thread worker;
+	of3dGraphics graphics3d;
+	ofPath path;
+};
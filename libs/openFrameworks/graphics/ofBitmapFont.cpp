@@ -450,6 +450,25 @@ ofMesh ofBitmapFont::getMesh(const string & text, int x, int y, ofDrawBitmapMode
 
 }
 
+const ofMesh & ofBitmapFont::getCachedMesh(const string & text, int x, int y, ofDrawBitmapMode mode, bool vFlipped) const{
+	MeshKey key(text, x, y, mode, vFlipped);
+	auto recent = recentMeshes.find(key);
+	if(recent != recentMeshes.end()){
+		return recent->second;
+	}
+	if(recentMeshes.size() >= maxCachedMeshes){
+		olderMeshes = std::move(recentMeshes);
+		recentMeshes.clear();
+	}
+	auto older = olderMeshes.find(key);
+	if(older != olderMeshes.end()){
+		auto & mesh = recentMeshes[key] = std::move(older->second);
+		olderMeshes.erase(older);
+		return mesh;
+	}
+	return recentMeshes[key] = getMesh(text, x, y, mode, vFlipped);
+}
+
 ofBitmapFont::ofBitmapFont(){
 #ifdef TARGET_ANDROID
 	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofBitmapFont::unloadTexture);
@@ -6,6 +6,8 @@
 #include "ofTexture.h"
 #include "ofMesh.h"
 #include "ofGraphics.h"
+#include <map>
+#include <tuple>
 class ofRectangle;
 
 /*
@@ -22,6 +24,12 @@ public:
 	ofBitmapFont();
 	~ofBitmapFont();
 	ofMesh getMesh(const std::string & text, int x, int y, ofDrawBitmapMode mode=OF_BITMAPMODE_MODEL_BILLBOARD, bool vFlipped=true) const;
+
+	/// \brief Same as getMesh but keeps the meshes of the last strings
+	/// requested, so static text isn't generated again every frame
+	///
+	/// The reference is only valid until the next call.
+	const ofMesh & getCachedMesh(const std::string & text, int x, int y, ofDrawBitmapMode mode, bool vFlipped) const;
 	const ofTexture & getTexture() const;
 	ofRectangle getBoundingBox(const std::string & text, int x, int y, ofDrawBitmapMode mode = ofGetStyle().drawBitmapMode, bool vFlipped = ofIsVFlipped()) const;
 private:
@@ -29,4 +37,12 @@ private:
 	static ofPixels pixels;
 	void unloadTexture();
 	mutable ofTexture texture;
+
+	// the cache keeps two generations of meshes, when the newest fills
+	// up the older one is dropped, strings used in between move back to
+	// the newest
+	typedef std::tuple<std::string, int, int, int, bool> MeshKey;
+	static const std::size_t maxCachedMeshes = 256;
+	mutable std::map<MeshKey, ofMesh> recentMeshes;
+	mutable std::map<MeshKey, ofMesh> olderMeshes;
 };
@@ -7,6 +7,7 @@
 #include "ofTrueTypeFont.h"
 #include "ofNode.h"
 #include "ofGraphics.h"
+#include "ofTaskPool.h"
 
 using namespace std;
 
@@ -25,6 +26,8 @@ ofCairoRenderer::ofCairoRenderer()
 	bBackgroundAuto = true;
 	page = 0;
 	multiPage = false;
+	tileSize = 0;
+	bTiled = false;
 	b3D = false;
 	currentMatrixMode=OF_MATRIX_MODELVIEW;
 }
@@ -40,6 +43,7 @@ void ofCairoRenderer::setup(string _filename, Type _type, bool multiPage_, bool
 
 	filename = _filename;
 	type = _type;
+	bTiled = false;
 	streamBuffer.clear();
 
 	if(type == FROM_FILE_EXTENSION){
@@ -82,7 +86,14 @@ void ofCairoRenderer::setup(string _filename, Type _type, bool multiPage_, bool
 	case IMAGE:
 		imageBuffer.allocate(outputsize.width, outputsize.height, OF_PIXELS_BGRA);
 		imageBuffer.set(0);
-		surface = cairo_image_surface_create_for_data(imageBuffer.getData(),CAIRO_FORMAT_ARGB32,outputsize.width, outputsize.height,outputsize.width*4);
+		if(tileSize > 0){
+			// rasterized later, in parallel, by renderTiles()
+			cairo_rectangle_t extents = {0, 0, outputsize.width, outputsize.height};
+			surface = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+			bTiled = true;
+		}else{
+			surface = cairo_image_surface_create_for_data(imageBuffer.getData(),CAIRO_FORMAT_ARGB32,outputsize.width, outputsize.height,outputsize.width*4);
+		}
 		break;
 	case FROM_FILE_EXTENSION:
 		ofLogFatalError("ofCairoRenderer") << "setup(): couldn't determine type from extension for filename: \"" << _filename << "\"!";
@@ -106,15 +117,90 @@ void ofCairoRenderer::setupMemoryOnly(Type _type, bool multiPage_, bool b3D_, of
 	setup("",_type,multiPage_,b3D_,outputsize);
 }
 
+void ofCairoRenderer::setTileSize(int _tileSize){
+	tileSize = max(_tileSize, 0);
+}
+
+int ofCairoRenderer::getTileSize() const{
+	return tileSize;
+}
+
+void ofCairoRenderer::renderTiles(){
+	if(!bTiled || !surface || !cr) return;
+	cairo_surface_flush(surface);
+
+	// every tile replays the whole recording clipped to its own region of
+	// imageBuffer, so no stitching is needed and the only memory per
+	// worker is its part of the recording's rasterization
+	int width = imageBuffer.getWidth();
+	int height = imageBuffer.getHeight();
+	int tilesX = (width + tileSize - 1) / tileSize;
+	int tilesY = (height + tileSize - 1) / tileSize;
+	auto recording = surface;
+	auto pixels = imageBuffer.getData();
+	ofGetTaskPool().parallelFor(0, tilesX * tilesY, [&](size_t begin, size_t end){
+		for(size_t i = begin; i < end; i++){
+			int x = (i % tilesX) * tileSize;
+			int y = (i / tilesX) * tileSize;
+			int w = min(tileSize, width - x);
+			int h = min(tileSize, height - y);
+			auto tile = cairo_image_surface_create_for_data(pixels + (size_t(y) * width + x) * 4, CAIRO_FORMAT_ARGB32, w, h, width * 4);
+			auto tileCr = cairo_create(tile);
+			cairo_set_source_surface(tileCr, recording, -x, -y);
+			cairo_paint(tileCr);
+			cairo_destroy(tileCr);
+			cairo_surface_flush(tile);
+			cairo_surface_destroy(tile);
+		}
+	}, 1);
+
+	// the tiles keep what has been drawn so far, start a new recording so
+	// the same commands aren't replayed twice and the recording doesn't
+	// grow with every frame, carrying over the state of the context
+	cairo_rectangle_t extents = {0, 0, double(width), double(height)};
+	auto nextSurface = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+	auto nextCr = cairo_create(nextSurface);
+
+	cairo_matrix_t matrix;
+	cairo_get_matrix(cr, &matrix);
+	cairo_save(cr);
+	cairo_identity_matrix(cr);
+	auto clip = cairo_copy_clip_rectangle_list(cr);
+	cairo_restore(cr);
+	if(clip->status == CAIRO_STATUS_SUCCESS){
+		for(int i = 0; i < clip->num_rectangles; i++){
+			auto & r = clip->rectangles[i];
+			cairo_rectangle(nextCr, r.x, r.y, r.width, r.height);
+		}
+		cairo_clip(nextCr);
+	}
+	cairo_rectangle_list_destroy(clip);
+	cairo_set_matrix(nextCr, &matrix);
+	cairo_set_source(nextCr, cairo_get_source(cr));
+	cairo_set_antialias(nextCr, cairo_get_antialias(cr));
+	cairo_set_line_width(nextCr, cairo_get_line_width(cr));
+	cairo_set_line_cap(nextCr, cairo_get_line_cap(cr));
+	cairo_set_line_join(nextCr, cairo_get_line_join(cr));
+	cairo_set_fill_rule(nextCr, cairo_get_fill_rule(cr));
+	cairo_set_operator(nextCr, cairo_get_operator(cr));
+
+	cairo_destroy(cr);
+	cairo_surface_destroy(surface);
+	cr = nextCr;
+	surface = nextSurface;
+}
+
 void ofCairoRenderer::flush(){
 	if(surface){
 		cairo_surface_flush(surface);
+		renderTiles();
 	}
 }
 
 void ofCairoRenderer::close(){
 	if(surface){
 		cairo_surface_flush(surface);
+		renderTiles();
 		if(type==IMAGE && filename!=""){
 			ofSaveImage(imageBuffer,filename);
 		}
@@ -146,6 +232,7 @@ void ofCairoRenderer::startRender(){
 
 void ofCairoRenderer::finishRender(){
 	cairo_surface_flush(surface);
+	renderTiles();
 }
 
 void ofCairoRenderer::setStyle(const ofStyle & style){
@@ -27,6 +27,17 @@ public:
 	};
 	void setup(std::string filename, Type type=ofCairoRenderer::FROM_FILE_EXTENSION, bool multiPage=true, bool b3D=false, ofRectangle outputsize = ofRectangle(0,0,0,0));
 	void setupMemoryOnly(Type _type, bool multiPage=true, bool b3D=false, ofRectangle viewport = ofRectangle(0,0,0,0));
+
+	/// \brief Renders IMAGE surfaces in tiles of tileSize x tileSize pixels
+	/// over the threads of ofGetTaskPool(), 0, the default, disables it
+	///
+	/// Has to be called before setup(). The drawing commands are recorded
+	/// instead of rasterized as they are issued, and replayed into every
+	/// tile in parallel by flush(), finishRender() and close(), which
+	/// write straight into getImageSurfacePixels(). Makes very big exports
+	/// scale with the number of cores. Ignored for PDF and SVG.
+	void setTileSize(int tileSize);
+	int getTileSize() const;
 	void close();
 	void flush();
 
@@ -171,6 +182,7 @@ private:
 	glm::vec3 transform(glm::vec3 vec) const;
 	static _cairo_status stream_function(void *closure,const unsigned char *data, unsigned int length);
 	void draw(const ofPixels & img, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void renderTiles();
 
 	mutable std::deque<glm::vec3> curvePoints;
 	cairo_t * cr;
@@ -182,6 +194,8 @@ private:
 	Type type;
 	int page;
 	bool multiPage;
+	int tileSize;
+	bool bTiled;
 
 	// 3d transformation
 	bool b3D;
@@ -0,0 +1,966 @@
+#include "ofCommandBuffer.h"
+#include "ofAppRunner.h"
+#include "ofImage.h"
+#include "ofNode.h"
+#include "of3dPrimitives.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#if !HAS_TLS
+#include <map>
+#include <thread>
+#endif
+
+using namespace std;
+
+namespace{
+	// the buffer recording in each thread, ofGetCurrentRenderer() returns
+	// it instead of the window's renderer
+#if HAS_TLS
+	thread_local shared_ptr<ofBaseRenderer> threadRenderer;
+
+	shared_ptr<ofBaseRenderer> & getThreadRenderer(){
+		return threadRenderer;
+	}
+
+	void releaseThreadRenderer(){
+	}
+#else
+	mutex threadRenderersMutex;
+	map<thread::id, shared_ptr<ofBaseRenderer>> threadRenderers;
+
+	shared_ptr<ofBaseRenderer> & getThreadRenderer(){
+		lock_guard<mutex> lock(threadRenderersMutex);
+		return threadRenderers[this_thread::get_id()];
+	}
+
+	void releaseThreadRenderer(){
+		lock_guard<mutex> lock(threadRenderersMutex);
+		auto it = threadRenderers.find(this_thread::get_id());
+		if(it != threadRenderers.end() && !it->second){
+			threadRenderers.erase(it);
+		}
+	}
+#endif
+
+	// avoids looking up the thread's renderer when nothing is recording
+	atomic<int> numRecording(0);
+
+	struct Submission{
+		const ofCommandBuffer * source;
+		int layer;
+		shared_ptr<const vector<function<void(ofBaseRenderer &)>>> commands;
+	};
+
+	mutex submissionsMutex;
+	// submitted since the last processSubmitted()
+	vector<Submission> pendingSubmissions;
+	// the last submission of every buffer, ordered by layer
+	vector<Submission> frameSubmissions;
+
+	void removeSubmissions(vector<Submission> & submissions, const ofCommandBuffer * source){
+		submissions.erase(std::remove_if(submissions.begin(), submissions.end(), [source](const Submission & submission){
+			return submission.source == source;
+		}), submissions.end());
+	}
+}
+
+const string ofCommandBuffer::TYPE="commandBuffer";
+
+//----------------------------------------------------------
+shared_ptr<ofBaseRenderer> * of::priv::getRecordingRenderer(){
+	if(numRecording == 0){
+		return nullptr;
+	}
+	auto & renderer = getThreadRenderer();
+	return renderer ? &renderer : nullptr;
+}
+
+//----------------------------------------------------------
+ofCommandBuffer::ofCommandBuffer()
+:recording(false)
+,graphics3d(this){
+	clearCommands();
+}
+
+//----------------------------------------------------------
+ofCommandBuffer::~ofCommandBuffer(){
+	if(recording){
+		end();
+	}
+	withdraw();
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::begin(){
+	if(recording){
+		ofLogError("ofCommandBuffer") << "begin(): already recording, call end() first";
+		return;
+	}
+	auto & renderer = getThreadRenderer();
+	previousRenderer = renderer;
+	// the buffer is owned by the app, the thread only borrows it until end()
+	renderer = shared_ptr<ofBaseRenderer>(this, [](ofBaseRenderer *){});
+	recording = true;
+	numRecording++;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::end(){
+	if(!recording){
+		ofLogError("ofCommandBuffer") << "end(): not recording, call begin() first";
+		return;
+	}
+	auto & renderer = getThreadRenderer();
+	if(renderer.get() != this){
+		ofLogError("ofCommandBuffer") << "end(): has to be called from the thread that called begin()";
+		return;
+	}
+	renderer = previousRenderer;
+	previousRenderer.reset();
+	releaseThreadRenderer();
+	recording = false;
+	numRecording--;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::play() const{
+	play(*ofGetCurrentRenderer());
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::play(ofBaseRenderer & renderer) const{
+	if(&renderer == this){
+		ofLogError("ofCommandBuffer") << "play(): can't play a buffer while recording into it";
+		return;
+	}
+	renderer.pushView();
+	renderer.pushStyle();
+	for(auto & command: commands){
+		command(renderer);
+	}
+	renderer.popStyle();
+	renderer.popView();
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::append(const ofCommandBuffer & other){
+	commands.insert(commands.end(), other.commands.begin(), other.commands.end());
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::clearCommands(){
+	commands.clear();
+	currentStyle = ofStyle();
+	styleHistory.clear();
+	currentMatrixMode = OF_MATRIX_MODELVIEW;
+	for(int i = 0; i < 3; i++){
+		matrices[i] = glm::mat4(1.0f);
+		matrixHistory[i].clear();
+	}
+	viewMatrix = glm::mat4(1.0f);
+	viewHistory.clear();
+	currentViewport = ofRectangle();
+	vFlipped = true;
+	handedness = OF_LEFT_HANDED;
+	backgroundAuto = true;
+	path.clear();
+	path.setMode(ofPath::POLYLINES);
+	path.setUseShapeColor(false);
+}
+
+//----------------------------------------------------------
+size_t ofCommandBuffer::getNumCommands() const{
+	return commands.size();
+}
+
+//----------------------------------------------------------
+bool ofCommandBuffer::isEmpty() const{
+	return commands.empty();
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::submit(int layer){
+	if(recording){
+		ofLogError("ofCommandBuffer") << "submit(): call end() before submitting";
+		return;
+	}
+	Submission submission;
+	submission.source = this;
+	submission.layer = layer;
+	submission.commands = make_shared<const vector<Command>>(std::move(commands));
+	clearCommands();
+
+	lock_guard<mutex> lock(submissionsMutex);
+	// only the last submission of each buffer is useful
+	removeSubmissions(pendingSubmissions, this);
+	pendingSubmissions.push_back(std::move(submission));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::withdraw(){
+	lock_guard<mutex> lock(submissionsMutex);
+	removeSubmissions(pendingSubmissions, this);
+	removeSubmissions(frameSubmissions, this);
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::processSubmitted(){
+	lock_guard<mutex> lock(submissionsMutex);
+	if(pendingSubmissions.empty()){
+		return;
+	}
+	for(auto & submission: pendingSubmissions){
+		auto it = std::find_if(frameSubmissions.begin(), frameSubmissions.end(), [&](const Submission & previous){
+			return previous.source == submission.source;
+		});
+		if(it != frameSubmissions.end()){
+			*it = std::move(submission);
+		}else{
+			frameSubmissions.push_back(std::move(submission));
+		}
+	}
+	pendingSubmissions.clear();
+	std::stable_sort(frameSubmissions.begin(), frameSubmissions.end(), [](const Submission & a, const Submission & b){
+		return a.layer < b.layer;
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawSubmitted(){
+	vector<shared_ptr<const vector<Command>>> frame;
+	{
+		// the commands are shared so workers can keep submitting while
+		// they are played
+		lock_guard<mutex> lock(submissionsMutex);
+		frame.reserve(frameSubmissions.size());
+		for(auto & submission: frameSubmissions){
+			frame.push_back(submission.commands);
+		}
+	}
+	if(frame.empty()){
+		return;
+	}
+	auto & renderer = *ofGetCurrentRenderer();
+	renderer.pushView();
+	renderer.pushStyle();
+	for(auto & commands: frame){
+		for(auto & command: *commands){
+			command(renderer);
+		}
+	}
+	renderer.popStyle();
+	renderer.popView();
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::record(Command && command) const{
+	commands.push_back(std::move(command));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofPolyline & poly) const{
+	record([poly](ofBaseRenderer & renderer){
+		renderer.draw(poly);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofPath & shape) const{
+	record([shape](ofBaseRenderer & renderer){
+		renderer.draw(shape);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofMesh & vertexData, ofPolyRenderMode renderType, bool useColors, bool useTextures, bool useNormals) const{
+	record([vertexData, renderType, useColors, useTextures, useNormals](ofBaseRenderer & renderer){
+		renderer.draw(vertexData, renderType, useColors, useTextures, useNormals);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const of3dPrimitive& model, ofPolyRenderMode renderType) const{
+	// the primitive's mesh and transform are copied now, of3dGraphics
+	// reuses the same primitive for every ofDrawBox, ofDrawSphere...
+	auto self = const_cast<ofCommandBuffer*>(this);
+	self->pushMatrix();
+	self->multMatrix(model.getGlobalTransformMatrix());
+	draw(model.getMesh(), renderType);
+	self->popMatrix();
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofNode& node) const{
+	auto self = const_cast<ofCommandBuffer*>(this);
+	self->pushMatrix();
+	self->multMatrix(node.getGlobalTransformMatrix());
+	node.customDraw(this);
+	self->popMatrix();
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
+	const ofImage * img = &image;
+	record([=](ofBaseRenderer & renderer){
+		renderer.draw(*img, x, y, z, w, h, sx, sy, sw, sh);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofFloatImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
+	const ofFloatImage * img = &image;
+	record([=](ofBaseRenderer & renderer){
+		renderer.draw(*img, x, y, z, w, h, sx, sy, sw, sh);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofShortImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
+	const ofShortImage * img = &image;
+	record([=](ofBaseRenderer & renderer){
+		renderer.draw(*img, x, y, z, w, h, sx, sy, sw, sh);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::draw(const ofBaseVideoDraws & video, float x, float y, float w, float h) const{
+	const ofBaseVideoDraws * v = &video;
+	record([=](ofBaseRenderer & renderer){
+		renderer.draw(*v, x, y, w, h);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::pushView(){
+	View view;
+	view.viewport = currentViewport;
+	for(int i = 0; i < 3; i++){
+		view.matrices[i] = matrices[i];
+	}
+	view.viewMatrix = viewMatrix;
+	viewHistory.push_back(view);
+	record([](ofBaseRenderer & renderer){
+		renderer.pushView();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::popView(){
+	if(!viewHistory.empty()){
+		auto & view = viewHistory.back();
+		currentViewport = view.viewport;
+		for(int i = 0; i < 3; i++){
+			matrices[i] = view.matrices[i];
+		}
+		viewMatrix = view.viewMatrix;
+		viewHistory.pop_back();
+	}
+	record([](ofBaseRenderer & renderer){
+		renderer.popView();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::viewport(ofRectangle rect){
+	viewport(rect.x, rect.y, rect.width, rect.height, isVFlipped());
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::viewport(float x, float y, float width, float height, bool vflip){
+	// a negative size means the size of the window, only known when played
+	if(width >= 0 && height >= 0){
+		currentViewport.set(x, y, width, height);
+	}
+	vFlipped = vflip;
+	record([=](ofBaseRenderer & renderer){
+		renderer.viewport(x, y, width, height, vflip);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setupScreenPerspective(float width, float height, float fov, float nearDist, float farDist){
+	record([=](ofBaseRenderer & renderer){
+		renderer.setupScreenPerspective(width, height, fov, nearDist, farDist);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setupScreenOrtho(float width, float height, float nearDist, float farDist){
+	record([=](ofBaseRenderer & renderer){
+		renderer.setupScreenOrtho(width, height, nearDist, farDist);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setOrientation(ofOrientation orientation, bool vFlip){
+	vFlipped = vFlip;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setOrientation(orientation, vFlip);
+	});
+}
+
+//----------------------------------------------------------
+ofRectangle ofCommandBuffer::getCurrentViewport() const{
+	return currentViewport;
+}
+
+//----------------------------------------------------------
+ofRectangle ofCommandBuffer::getNativeViewport() const{
+	return currentViewport;
+}
+
+//----------------------------------------------------------
+int ofCommandBuffer::getViewportWidth() const{
+	return currentViewport.width;
+}
+
+//----------------------------------------------------------
+int ofCommandBuffer::getViewportHeight() const{
+	return currentViewport.height;
+}
+
+//----------------------------------------------------------
+bool ofCommandBuffer::isVFlipped() const{
+	return vFlipped;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setCoordHandedness(ofHandednessType handedness){
+	this->handedness = handedness;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setCoordHandedness(handedness);
+	});
+}
+
+//----------------------------------------------------------
+ofHandednessType ofCommandBuffer::getCoordHandedness() const{
+	return handedness;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::pushMatrix(){
+	matrixHistory[currentMatrixMode].push_back(matrices[currentMatrixMode]);
+	record([](ofBaseRenderer & renderer){
+		renderer.pushMatrix();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::popMatrix(){
+	auto & history = matrixHistory[currentMatrixMode];
+	if(!history.empty()){
+		matrices[currentMatrixMode] = history.back();
+		history.pop_back();
+	}
+	record([](ofBaseRenderer & renderer){
+		renderer.popMatrix();
+	});
+}
+
+//----------------------------------------------------------
+glm::mat4 ofCommandBuffer::getCurrentMatrix(ofMatrixMode matrixMode_) const{
+	return matrices[matrixMode_];
+}
+
+//----------------------------------------------------------
+glm::mat4 ofCommandBuffer::getCurrentOrientationMatrix() const{
+	return glm::mat4(1.0f);
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::translate(float x, float y, float z){
+	matrices[currentMatrixMode] = glm::translate(matrices[currentMatrixMode], glm::vec3(x, y, z));
+	record([=](ofBaseRenderer & renderer){
+		renderer.translate(x, y, z);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::translate(const glm::vec3 & p){
+	translate(p.x, p.y, p.z);
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::scale(float xAmnt, float yAmnt, float zAmnt){
+	matrices[currentMatrixMode] = glm::scale(matrices[currentMatrixMode], glm::vec3(xAmnt, yAmnt, zAmnt));
+	record([=](ofBaseRenderer & renderer){
+		renderer.scale(xAmnt, yAmnt, zAmnt);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::rotateRad(float radians, float vecX, float vecY, float vecZ){
+	matrices[currentMatrixMode] = glm::rotate(matrices[currentMatrixMode], radians, glm::vec3(vecX, vecY, vecZ));
+	record([=](ofBaseRenderer & renderer){
+		renderer.rotateRad(radians, vecX, vecY, vecZ);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::rotateXRad(float radians){
+	rotateRad(radians, 1, 0, 0);
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::rotateYRad(float radians){
+	rotateRad(radians, 0, 1, 0);
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::rotateZRad(float radians){
+	rotateRad(radians, 0, 0, 1);
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::rotateRad(float radians){
+	rotateZRad(radians);
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::matrixMode(ofMatrixMode mode){
+	currentMatrixMode = mode;
+	record([=](ofBaseRenderer & renderer){
+		renderer.matrixMode(mode);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::loadIdentityMatrix(void){
+	matrices[currentMatrixMode] = glm::mat4(1.0f);
+	record([](ofBaseRenderer & renderer){
+		renderer.loadIdentityMatrix();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::loadMatrix(const glm::mat4 & m){
+	matrices[currentMatrixMode] = m;
+	record([=](ofBaseRenderer & renderer){
+		renderer.loadMatrix(m);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::loadMatrix(const float *m){
+	loadMatrix(glm::make_mat4(m));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::multMatrix(const glm::mat4 & m){
+	matrices[currentMatrixMode] = matrices[currentMatrixMode] * m;
+	record([=](ofBaseRenderer & renderer){
+		renderer.multMatrix(m);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::multMatrix(const float *m){
+	multMatrix(glm::make_mat4(m));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::loadViewMatrix(const glm::mat4 & m){
+	viewMatrix = m;
+	matrices[OF_MATRIX_MODELVIEW] = m;
+	record([=](ofBaseRenderer & renderer){
+		renderer.loadViewMatrix(m);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::multViewMatrix(const glm::mat4 & m){
+	viewMatrix = viewMatrix * m;
+	matrices[OF_MATRIX_MODELVIEW] = matrices[OF_MATRIX_MODELVIEW] * m;
+	record([=](ofBaseRenderer & renderer){
+		renderer.multViewMatrix(m);
+	});
+}
+
+//----------------------------------------------------------
+glm::mat4 ofCommandBuffer::getCurrentViewMatrix() const{
+	return viewMatrix;
+}
+
+//----------------------------------------------------------
+glm::mat4 ofCommandBuffer::getCurrentNormalMatrix() const{
+	return glm::transpose(glm::inverse(matrices[OF_MATRIX_MODELVIEW]));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::bind(const ofCamera & camera, const ofRectangle & viewport){
+	// the camera is used as it is when played, the matrices it sets are
+	// only known then
+	const ofCamera * cam = &camera;
+	View view;
+	view.viewport = currentViewport;
+	for(int i = 0; i < 3; i++){
+		view.matrices[i] = matrices[i];
+	}
+	view.viewMatrix = viewMatrix;
+	viewHistory.push_back(view);
+	currentViewport = viewport;
+	record([=](ofBaseRenderer & renderer){
+		renderer.bind(*cam, viewport);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::unbind(const ofCamera & camera){
+	const ofCamera * cam = &camera;
+	if(!viewHistory.empty()){
+		auto & view = viewHistory.back();
+		currentViewport = view.viewport;
+		for(int i = 0; i < 3; i++){
+			matrices[i] = view.matrices[i];
+		}
+		viewMatrix = view.viewMatrix;
+		viewHistory.pop_back();
+	}
+	record([=](ofBaseRenderer & renderer){
+		renderer.unbind(*cam);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setupGraphicDefaults(){
+	currentStyle = ofStyle();
+	record([](ofBaseRenderer & renderer){
+		renderer.setupGraphicDefaults();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setupScreen(){
+	record([](ofBaseRenderer & renderer){
+		renderer.setupScreen();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setRectMode(ofRectMode mode){
+	currentStyle.rectMode = mode;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setRectMode(mode);
+	});
+}
+
+//----------------------------------------------------------
+ofRectMode ofCommandBuffer::getRectMode(){
+	return currentStyle.rectMode;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setFillMode(ofFillFlag fill){
+	currentStyle.bFill = (fill == OF_FILLED);
+	path.setFilled(currentStyle.bFill);
+	path.setStrokeWidth(currentStyle.bFill ? 0 : currentStyle.lineWidth);
+	record([=](ofBaseRenderer & renderer){
+		renderer.setFillMode(fill);
+	});
+}
+
+//----------------------------------------------------------
+ofFillFlag ofCommandBuffer::getFillMode(){
+	return currentStyle.bFill ? OF_FILLED : OF_OUTLINE;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setLineWidth(float lineWidth){
+	currentStyle.lineWidth = lineWidth;
+	if(!currentStyle.bFill){
+		path.setStrokeWidth(lineWidth);
+	}
+	record([=](ofBaseRenderer & renderer){
+		renderer.setLineWidth(lineWidth);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setDepthTest(bool depthTest){
+	record([=](ofBaseRenderer & renderer){
+		renderer.setDepthTest(depthTest);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setBlendMode(ofBlendMode blendMode){
+	currentStyle.blendingMode = blendMode;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setBlendMode(blendMode);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setLineSmoothing(bool smooth){
+	currentStyle.smoothing = smooth;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setLineSmoothing(smooth);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setCircleResolution(int res){
+	currentStyle.circleResolution = res;
+	path.setCircleResolution(res);
+	record([=](ofBaseRenderer & renderer){
+		renderer.setCircleResolution(res);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::enableAntiAliasing(){
+	record([](ofBaseRenderer & renderer){
+		renderer.enableAntiAliasing();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::disableAntiAliasing(){
+	record([](ofBaseRenderer & renderer){
+		renderer.disableAntiAliasing();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setColor(int r, int g, int b){
+	setColor(ofColor(r, g, b));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setColor(int r, int g, int b, int a){
+	setColor(ofColor(r, g, b, a));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setColor(const ofColor & color){
+	currentStyle.color = color;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setColor(color);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setColor(const ofColor & color, int _a){
+	setColor(ofColor(color, _a));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setColor(int gray){
+	setColor(ofColor(gray));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setHexColor(int hexColor){
+	setColor(ofColor::fromHex(hexColor));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setBitmapTextMode(ofDrawBitmapMode mode){
+	currentStyle.drawBitmapMode = mode;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setBitmapTextMode(mode);
+	});
+}
+
+//----------------------------------------------------------
+ofColor ofCommandBuffer::getBackgroundColor(){
+	return currentStyle.bgColor;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setBackgroundColor(const ofColor & c){
+	currentStyle.bgColor = c;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setBackgroundColor(c);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::background(const ofColor & c){
+	currentStyle.bgColor = c;
+	record([=](ofBaseRenderer & renderer){
+		renderer.background(c);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::background(float brightness){
+	background(ofColor(brightness));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::background(int hexColor, float _a){
+	background(ofColor::fromHex(hexColor, _a));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::background(int r, int g, int b, int a){
+	background(ofColor(r, g, b, a));
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setBackgroundAuto(bool bAuto){
+	backgroundAuto = bAuto;
+	record([=](ofBaseRenderer & renderer){
+		renderer.setBackgroundAuto(bAuto);
+	});
+}
+
+//----------------------------------------------------------
+bool ofCommandBuffer::getBackgroundAuto(){
+	return backgroundAuto;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::clear(){
+	record([](ofBaseRenderer & renderer){
+		renderer.clear();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::clear(float r, float g, float b, float a){
+	record([=](ofBaseRenderer & renderer){
+		renderer.clear(r, g, b, a);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::clear(float brightness, float a){
+	record([=](ofBaseRenderer & renderer){
+		renderer.clear(brightness, a);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::clearAlpha(){
+	record([](ofBaseRenderer & renderer){
+		renderer.clearAlpha();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const{
+	record([=](ofBaseRenderer & renderer){
+		renderer.drawLine(x1, y1, z1, x2, y2, z2);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawRectangle(float x, float y, float z, float w, float h) const{
+	record([=](ofBaseRenderer & renderer){
+		renderer.drawRectangle(x, y, z, w, h);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const{
+	record([=](ofBaseRenderer & renderer){
+		renderer.drawTriangle(x1, y1, z1, x2, y2, z2, x3, y3, z3);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawCircle(float x, float y, float z, float radius) const{
+	record([=](ofBaseRenderer & renderer){
+		renderer.drawCircle(x, y, z, radius);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawEllipse(float x, float y, float z, float width, float height) const{
+	record([=](ofBaseRenderer & renderer){
+		renderer.drawEllipse(x, y, z, width, height);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawString(string text, float x, float y, float z) const{
+	record([=](ofBaseRenderer & renderer){
+		renderer.drawString(text, x, y, z);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::drawString(const ofTrueTypeFont & font, string text, float x, float y) const{
+	const ofTrueTypeFont * f = &font;
+	record([=](ofBaseRenderer & renderer){
+		renderer.drawString(*f, text, x, y);
+	});
+}
+
+//----------------------------------------------------------
+ofPath & ofCommandBuffer::getPath(){
+	return path;
+}
+
+//----------------------------------------------------------
+ofStyle ofCommandBuffer::getStyle() const{
+	return currentStyle;
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setStyle(const ofStyle & style){
+	currentStyle = style;
+	path.setFilled(style.bFill);
+	path.setStrokeWidth(style.bFill ? 0 : style.lineWidth);
+	path.setCircleResolution(style.circleResolution);
+	path.setCurveResolution(style.curveResolution);
+	path.setPolyWindingMode(style.polyMode);
+	record([=](ofBaseRenderer & renderer){
+		renderer.setStyle(style);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::pushStyle(){
+	styleHistory.push_back(currentStyle);
+	record([](ofBaseRenderer & renderer){
+		renderer.pushStyle();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::popStyle(){
+	if(!styleHistory.empty()){
+		currentStyle = styleHistory.back();
+		styleHistory.pop_back();
+		path.setFilled(currentStyle.bFill);
+		path.setStrokeWidth(currentStyle.bFill ? 0 : currentStyle.lineWidth);
+		path.setCircleResolution(currentStyle.circleResolution);
+		path.setCurveResolution(currentStyle.curveResolution);
+		path.setPolyWindingMode(currentStyle.polyMode);
+	}
+	record([](ofBaseRenderer & renderer){
+		renderer.popStyle();
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setCurveResolution(int resolution){
+	currentStyle.curveResolution = resolution;
+	path.setCurveResolution(resolution);
+	record([=](ofBaseRenderer & renderer){
+		renderer.setCurveResolution(resolution);
+	});
+}
+
+//----------------------------------------------------------
+void ofCommandBuffer::setPolyMode(ofPolyWindingMode mode){
+	currentStyle.polyMode = mode;
+	path.setPolyWindingMode(mode);
+	record([=](ofBaseRenderer & renderer){
+		renderer.setPolyMode(mode);
+	});
+}
+
+//----------------------------------------------------------
+const of3dGraphics & ofCommandBuffer::get3dGraphics() const{
+	return graphics3d;
+}
+
+//----------------------------------------------------------
+of3dGraphics & ofCommandBuffer::get3dGraphics(){
+	return graphics3d;
+}
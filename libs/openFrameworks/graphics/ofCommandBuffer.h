@@ -0,0 +1,260 @@
+#pragma once
+
+#include "ofBaseTypes.h"
+#include "of3dGraphics.h"
+#include "ofPath.h"
+#include <functional>
+
+/// \brief A renderer that records what's drawn with it to draw it again
+/// later, any number of times
+///
+/// Draw calls, matrix operations and style changes are stored in a list of
+/// commands instead of being executed. play() runs them on the current
+/// renderer, so a part of the scene that doesn't change can be generated
+/// once and played every frame:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     background.begin();
+///     for(auto & tree: trees){
+///         ofSetColor(tree.color);
+///         ofDrawCircle(tree.position, tree.radius);
+///     }
+///     background.end();
+/// }
+///
+/// void ofApp::draw(){
+///     background.play();
+/// }
+/// ~~~~
+///
+/// Recording doesn't make any GL call so it can be done from any thread.
+/// begin() only makes the buffer the current renderer of the thread that
+/// calls it, so worker threads can build parts of the scene with the usual
+/// ofDraw... functions while the main thread draws. Each worker submits
+/// what it recorded and the main thread draws the last submission of every
+/// buffer with drawSubmitted():
+///
+/// ~~~~{.cpp}
+/// void Layer::threadedFunction(){
+///     while(isThreadRunning()){
+///         buffer.begin();
+///         for(auto & p: generateGeometry()){
+///             ofDrawRectangle(p.x, p.y, 2, 2);
+///         }
+///         buffer.end();
+///         buffer.submit(layerIndex);
+///     }
+/// }
+///
+/// void ofApp::draw(){
+///     ofCommandBuffer::drawSubmitted();
+///     gui.draw();
+/// }
+/// ~~~~
+///
+/// Meshes, paths, polylines and strings are copied when recorded, nodes and
+/// 3d primitives are drawn into the buffer with their current transform.
+/// Images, videos, fonts and cameras are recorded by reference and have to
+/// be alive until the buffer is played. Drawing textures, vbos or fbos
+/// directly needs a GL renderer and isn't recorded.
+///
+/// The matrices, viewport and style returned while recording are the ones
+/// set since the recording started.
+class ofCommandBuffer: public ofBaseRenderer{
+public:
+	ofCommandBuffer();
+	~ofCommandBuffer();
+
+	static const std::string TYPE;
+	const std::string & getType(){ return TYPE; }
+
+	/// \brief Makes this the current renderer of the calling thread so all
+	/// the ofDraw... calls it makes are recorded until end()
+	void begin();
+
+	/// \brief Restores the renderer that was current in this thread before
+	/// begin()
+	void end();
+
+	/// \brief Runs all the commands on the current renderer
+	///
+	/// The style and matrices are restored afterwards so the commands don't
+	/// affect anything drawn after them.
+	void play() const;
+
+	/// \brief Runs all the commands on renderer
+	void play(ofBaseRenderer & renderer) const;
+
+	/// \brief Adds all the commands of other after the ones in this buffer
+	void append(const ofCommandBuffer & other);
+
+	/// \brief Removes all the commands and resets the recorded state
+	void clearCommands();
+
+	std::size_t getNumCommands() const;
+	bool isEmpty() const;
+
+	/// \brief Hands the recorded commands to the main thread and empties the
+	/// buffer so the next frame can be recorded
+	///
+	/// At the beginning of the next frame the main loop takes them,
+	/// replacing the ones this buffer submitted before, which keep being
+	/// drawn until then. Submissions are drawn ordered by layer, lower
+	/// first, and in the order they were first submitted within a layer.
+	void submit(int layer = 0);
+
+	/// \brief Forgets what this buffer submitted so it's not drawn anymore
+	void withdraw();
+
+	/// \brief Draws the last submission of every buffer on the current
+	/// renderer, has to be called from draw()
+	static void drawSubmitted();
+
+	/// \brief Takes the commands submitted since the last call, called by
+	/// ofMainLoop once per frame before update()
+	static void processSubmitted();
+
+	void startRender(){}
+	void finishRender(){}
+
+	using ofBaseRenderer::draw;
+	void draw(const ofPolyline & poly) const;
+	void draw(const ofPath & shape) const;
+	void draw(const ofMesh & vertexData, ofPolyRenderMode renderType, bool useColors, bool useTextures, bool useNormals) const;
+	void draw(const of3dPrimitive& model, ofPolyRenderMode renderType) const;
+	void draw(const ofNode& model) const;
+	void draw(const ofImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void draw(const ofFloatImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void draw(const ofShortImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void draw(const ofBaseVideoDraws & video, float x, float y, float w, float h) const;
+
+	void pushView();
+	void popView();
+	void viewport(ofRectangle viewport);
+	void viewport(float x = 0, float y = 0, float width = -1, float height = -1, bool vflip=true);
+	void setupScreenPerspective(float width = -1, float height = -1, float fov = 60, float nearDist = 0, float farDist = 0);
+	void setupScreenOrtho(float width = -1, float height = -1, float nearDist = -1, float farDist = 1);
+	void setOrientation(ofOrientation orientation, bool vFlip);
+	ofRectangle getCurrentViewport() const;
+	ofRectangle getNativeViewport() const;
+	int getViewportWidth() const;
+	int getViewportHeight() const;
+	bool isVFlipped() const;
+	void setCoordHandedness(ofHandednessType handedness);
+	ofHandednessType getCoordHandedness() const;
+
+	void pushMatrix();
+	void popMatrix();
+	glm::mat4 getCurrentMatrix(ofMatrixMode matrixMode_) const;
+	glm::mat4 getCurrentOrientationMatrix() const;
+	void translate(float x, float y, float z = 0);
+	void translate(const glm::vec3 & p);
+	void scale(float xAmnt, float yAmnt, float zAmnt = 1);
+	void rotateRad(float radians, float vecX, float vecY, float vecZ);
+	void rotateXRad(float radians);
+	void rotateYRad(float radians);
+	void rotateZRad(float radians);
+	void rotateRad(float radians);
+	void matrixMode(ofMatrixMode mode);
+	void loadIdentityMatrix (void);
+	void loadMatrix (const glm::mat4 & m);
+	void loadMatrix (const float *m);
+	void multMatrix (const glm::mat4 & m);
+	void multMatrix (const float *m);
+	void loadViewMatrix(const glm::mat4 & m);
+	void multViewMatrix(const glm::mat4 & m);
+	glm::mat4 getCurrentViewMatrix() const;
+	glm::mat4 getCurrentNormalMatrix() const;
+	void bind(const ofCamera & camera, const ofRectangle & viewport);
+	void unbind(const ofCamera & camera);
+	void setupGraphicDefaults();
+	void setupScreen();
+
+	void setRectMode(ofRectMode mode);
+	ofRectMode getRectMode();
+	void setFillMode(ofFillFlag fill);
+	ofFillFlag getFillMode();
+	void setLineWidth(float lineWidth);
+	void setDepthTest(bool depthTest);
+	void setBlendMode(ofBlendMode blendMode);
+	void setLineSmoothing(bool smooth);
+	void setCircleResolution(int res);
+	void enableAntiAliasing();
+	void disableAntiAliasing();
+	void setColor(int r, int g, int b);
+	void setColor(int r, int g, int b, int a);
+	void setColor(const ofColor & color);
+	void setColor(const ofColor & color, int _a);
+	void setColor(int gray);
+	void setHexColor( int hexColor );
+	void setBitmapTextMode(ofDrawBitmapMode mode);
+	ofColor getBackgroundColor();
+	void setBackgroundColor(const ofColor & c);
+	void background(const ofColor & c);
+	void background(float brightness);
+	void background(int hexColor, float _a=255.0f);
+	void background(int r, int g, int b, int a=255);
+	void setBackgroundAuto(bool bManual);
+	bool getBackgroundAuto();
+	void clear();
+	void clear(float r, float g, float b, float a=0);
+	void clear(float brightness, float a=0);
+	void clearAlpha();
+
+	void drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const;
+	void drawRectangle(float x, float y, float z, float w, float h) const;
+	void drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const;
+	void drawCircle(float x, float y, float z, float radius) const;
+	void drawEllipse(float x, float y, float z, float width, float height) const;
+	void drawString(std::string text, float x, float y, float z) const;
+	void drawString(const ofTrueTypeFont & font, std::string text, float x, float y) const;
+
+	ofPath & getPath();
+	ofStyle getStyle() const;
+	void setStyle(const ofStyle & style);
+	void pushStyle();
+	void popStyle();
+	void setCurveResolution(int resolution);
+	void setPolyMode(ofPolyWindingMode mode);
+
+	const of3dGraphics & get3dGraphics() const;
+	of3dGraphics & get3dGraphics();
+
+private:
+	typedef std::function<void(ofBaseRenderer &)> Command;
+	void record(Command && command) const;
+
+	mutable std::vector<Command> commands;
+	std::shared_ptr<ofBaseRenderer> previousRenderer;
+	bool recording;
+
+	// state set while recording, to answer the getters
+	ofStyle currentStyle;
+	std::vector<ofStyle> styleHistory;
+	ofMatrixMode currentMatrixMode;
+	glm::mat4 matrices[3];
+	glm::mat4 viewMatrix;
+	std::vector<glm::mat4> matrixHistory[3];
+	struct View{
+		ofRectangle viewport;
+		glm::mat4 matrices[3];
+		glm::mat4 viewMatrix;
+	};
+	std::vector<View> viewHistory;
+	ofRectangle currentViewport;
+	bool vFlipped;
+	ofHandednessType handedness;
+	bool backgroundAuto;
+
+	of3dGraphics graphics3d;
+	ofPath path;
+};
+
+namespace of{
+namespace priv{
+	/// the command buffer recording in the calling thread, used by
+	/// ofGetCurrentRenderer(), or nullptr if there's none
+	std::shared_ptr<ofBaseRenderer> * getRecordingRenderer();
+}
+}
@@ -175,9 +175,35 @@ static int getJpegOptionFromImageLoadSetting(const ofImageLoadSettings &settings
 	if(settings.exifRotate)   option |= JPEG_EXIFROTATE;
 	if(settings.grayscale)    option |= JPEG_GREYSCALE;
 	if(settings.separateCMYK) option |= JPEG_CMYK;
+	// the upper 16 bits ask libjpeg to decode at 1/2, 1/4 or 1/8 of the
+	// size as long as the longest side stays bigger than them
+	size_t requestedSize = std::max(settings.maxWidth, settings.maxHeight);
+	if(requestedSize > 0){
+		option |= int(std::min<size_t>(requestedSize, 0xFFFF)) << 16;
+	}
 	return option;
 }
 
+/// internal
+template<typename PixelType>
+static void fitToMaxSize(ofPixels_<PixelType> & pix, const ofImageLoadSettings &settings) {
+	if(settings.maxWidth == 0 && settings.maxHeight == 0){
+		return;
+	}
+	float scale = 1;
+	if(settings.maxWidth > 0){
+		scale = std::min(scale, settings.maxWidth / float(pix.getWidth()));
+	}
+	if(settings.maxHeight > 0){
+		scale = std::min(scale, settings.maxHeight / float(pix.getHeight()));
+	}
+	if(scale < 1){
+		size_t width = std::max<size_t>(1, std::round(pix.getWidth() * scale));
+		size_t height = std::max<size_t>(1, std::round(pix.getHeight() * scale));
+		pix.resize(width, height, OF_INTERPOLATE_AREA);
+	}
+}
+
 template<typename PixelType>
 static bool loadImage(ofPixels_<PixelType> & pix, const std::filesystem::path& _fileName, const ofImageLoadSettings& settings){
 	ofInitFreeImage();
@@ -204,7 +230,7 @@ static bool loadImage(ofPixels_<PixelType> & pix, const std::filesystem::path& _
 	uriFreeUriMembersA(&uri);
 
 	if(scheme == "http" || scheme == "https"){
-		return ofLoadImage(pix, ofLoadURL(_fileName.string()).data);
+		return ofLoadImage(pix, ofLoadURL(_fileName.string()).data, settings);
 	}
 	
 	std::string fileName = ofToDataPath(_fileName);
@@ -234,6 +260,7 @@ static bool loadImage(ofPixels_<PixelType> & pix, const std::filesystem::path& _
 
 	if ( bLoaded ){
 		putBmpIntoPixels(bmp,pix);
+		fitToMaxSize(pix, settings);
 	}
 
 	if (bmp != nullptr){
@@ -244,22 +271,23 @@ static bool loadImage(ofPixels_<PixelType> & pix, const std::filesystem::path& _
 }
 
 template<typename PixelType>
-static bool loadImage(ofPixels_<PixelType> & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings){
+static bool loadImage(ofPixels_<PixelType> & pix, const char * data, std::size_t size, const ofImageLoadSettings &settings){
 	ofInitFreeImage();
 	bool bLoaded = false;
 	FIBITMAP* bmp = nullptr;
 	FIMEMORY* hmem = nullptr;
 	
-	hmem = FreeImage_OpenMemory((unsigned char*) buffer.getData(), buffer.size());
+	// FreeImage only reads from the memory, it can point to a mapped file
+	hmem = FreeImage_OpenMemory((unsigned char*) data, size);
 	if (hmem == nullptr){
-		ofLogError("ofImage") << "loadImage(): couldn't load image from ofBuffer, opening FreeImage memory failed";
+		ofLogError("ofImage") << "loadImage(): couldn't load image from memory, opening FreeImage memory failed";
 		return false;
 	}
 
 	//get the file type!
 	FREE_IMAGE_FORMAT fif = FreeImage_GetFileTypeFromMemory(hmem);
 	if( fif == -1 ){
-		ofLogError("ofImage") << "loadImage(): couldn't load image from ofBuffer, unable to guess image format from memory";
+		ofLogError("ofImage") << "loadImage(): couldn't load image from memory, unable to guess image format from memory";
 		FreeImage_CloseMemory(hmem);
 		return false;
 	}
@@ -281,6 +309,7 @@ static bool loadImage(ofPixels_<PixelType> & pix, const ofBuffer & buffer, const
 	
 	if (bLoaded){
 		putBmpIntoPixels(bmp,pix);
+		fitToMaxSize(pix, settings);
 	}
 
 	if (bmp != nullptr){
@@ -301,7 +330,12 @@ bool ofLoadImage(ofPixels & pix, const std::filesystem::path& path, const ofImag
 
 //----------------------------------------------------------------
 bool ofLoadImage(ofPixels & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings) {
-	return loadImage(pix, buffer, settings);
+	return loadImage(pix, buffer.getData(), buffer.size(), settings);
+}
+
+//----------------------------------------------------------------
+bool ofLoadImage(ofPixels & pix, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings) {
+	return loadImage(pix, buffer.getData(), buffer.size(), settings);
 }
 
 //----------------------------------------------------------------
@@ -311,7 +345,12 @@ bool ofLoadImage(ofShortPixels & pix, const std::filesystem::path& path, const o
 
 //----------------------------------------------------------------
 bool ofLoadImage(ofShortPixels & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings) {
-	return loadImage(pix, buffer, settings);
+	return loadImage(pix, buffer.getData(), buffer.size(), settings);
+}
+
+//----------------------------------------------------------------
+bool ofLoadImage(ofShortPixels & pix, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings) {
+	return loadImage(pix, buffer.getData(), buffer.size(), settings);
 }
 
 //----------------------------------------------------------------
@@ -321,7 +360,12 @@ bool ofLoadImage(ofFloatPixels & pix, const std::filesystem::path& path, const o
 
 //----------------------------------------------------------------
 bool ofLoadImage(ofFloatPixels & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings) {
-	return loadImage(pix, buffer, settings);
+	return loadImage(pix, buffer.getData(), buffer.size(), settings);
+}
+
+//----------------------------------------------------------------
+bool ofLoadImage(ofFloatPixels & pix, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings) {
+	return loadImage(pix, buffer.getData(), buffer.size(), settings);
 }
 
 //----------------------------------------------------------------
@@ -346,6 +390,17 @@ bool ofLoadImage(ofTexture & tex, const ofBuffer & buffer, const ofImageLoadSett
 	return loaded;
 }
 
+//----------------------------------------------------------------
+bool ofLoadImage(ofTexture & tex, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings){
+	ofPixels pixels;
+	bool loaded = ofLoadImage(pixels, buffer, settings);
+	if(loaded){
+		tex.allocate(pixels.getWidth(), pixels.getHeight(), ofGetGlInternalFormat(pixels));
+		tex.loadData(pixels);
+	}
+	return loaded;
+}
+
 //----------------------------------------------------------------
 template<typename PixelType>
 static void saveImage(const ofPixels_<PixelType> & _pix, const std::filesystem::path& _fileName, ofImageQualityType qualityLevel) {
@@ -566,6 +621,8 @@ ofImage_<PixelType>::ofImage_(){
 	bpp							= 0;
 	type						= OF_IMAGE_UNDEFINED;
 	bUseTexture					= true;		// the default is, yes, use a texture
+	residency					= OF_IMAGE_RESIDENCY_CPU_AND_GPU;
+	bPixelsEvicted				= false;
 
 	//----------------------- init free image if necessary
 	ofInitFreeImage();
@@ -579,6 +636,8 @@ ofImage_<PixelType>::ofImage_(const ofPixels_<PixelType> & pix){
 	bpp							= 0;
 	type						= OF_IMAGE_UNDEFINED;
 	bUseTexture					= true;		// the default is, yes, use a texture
+	residency					= OF_IMAGE_RESIDENCY_CPU_AND_GPU;
+	bPixelsEvicted				= false;
 
 	//----------------------- init free image if necessary
 	ofInitFreeImage();
@@ -594,6 +653,8 @@ ofImage_<PixelType>::ofImage_(const std::filesystem::path & fileName, const ofIm
 	bpp							= 0;
 	type						= OF_IMAGE_UNDEFINED;
 	bUseTexture					= true;		// the default is, yes, use a texture
+	residency					= OF_IMAGE_RESIDENCY_CPU_AND_GPU;
+	bPixelsEvicted				= false;
 
 	//----------------------- init free image if necessary
 	ofInitFreeImage();
@@ -638,6 +699,10 @@ ofImage_<PixelType>::ofImage_(ofImage_<PixelType>&& mom){
     height      = mom.height;
     bpp         = mom.bpp;
     type        = mom.type;
+    residency   = mom.residency;
+    bPixelsEvicted = mom.bPixelsEvicted;
+    sourcePath  = std::move(mom.sourcePath);
+    sourceSettings = mom.sourceSettings;
 
     mom.clear(); //clear remaining flags and sizes from the mom
 
@@ -660,6 +725,10 @@ ofImage_<PixelType>& ofImage_<PixelType>::operator=(ofImage_<PixelType>&& mom){
     height      = mom.height;
     bpp         = mom.bpp;
     type        = mom.type;
+    residency   = mom.residency;
+    bPixelsEvicted = mom.bPixelsEvicted;
+    sourcePath  = std::move(mom.sourcePath);
+    sourceSettings = mom.sourceSettings;
 
     mom.clear(); //clear remaining flags and sizes from the mom
 
@@ -690,16 +759,27 @@ bool ofImage_<PixelType>::load(const std::filesystem::path& fileName, const ofIm
 	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofImage_<PixelType>::unloadTexture);
 	ofAddListener(ofxAndroidEvents().reloadGL,this,&ofImage_<PixelType>::update);
 	#endif
+	preparePixelsChange(false);
 	bool bLoadedOk = ofLoadImage(pixels, fileName, settings);
 	if (!bLoadedOk) {
 		ofLogError("ofImage") << "loadImage(): couldn't load image from \"" << fileName << "\"";
 		clear();
 		return false;
 	}
+	sourcePath = fileName;
+	sourceSettings = settings;
 	update();
 	return bLoadedOk;
 }
 
+//----------------------------------------------------------
+template<typename PixelType>
+bool ofImage_<PixelType>::loadScaled(const std::filesystem::path& fileName, size_t maxWidth, size_t maxHeight, ofImageLoadSettings settings){
+	settings.maxWidth = maxWidth;
+	settings.maxHeight = maxHeight;
+	return load(fileName, settings);
+}
+
 //----------------------------------------------------------
 template<typename PixelType>
 bool ofImage_<PixelType>::loadImage(const std::string& fileName){
@@ -713,6 +793,7 @@ bool ofImage_<PixelType>::load(const ofBuffer & buffer, const ofImageLoadSetting
 	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofImage_<PixelType>::unloadTexture);
 	ofAddListener(ofxAndroidEvents().reloadGL,this,&ofImage_<PixelType>::update);
 	#endif
+	preparePixelsChange(false);
 	bool bLoadedOk = ofLoadImage(pixels, buffer, settings);
 	if (!bLoadedOk) {
 		ofLogError("ofImage") << "loadImage(): couldn't load image from ofBuffer";
@@ -723,6 +804,24 @@ bool ofImage_<PixelType>::load(const ofBuffer & buffer, const ofImageLoadSetting
 	return bLoadedOk;
 }
 
+//----------------------------------------------------------
+template<typename PixelType>
+bool ofImage_<PixelType>::load(const ofMappedBuffer & buffer, const ofImageLoadSettings &settings){
+	#if defined(TARGET_ANDROID)
+	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofImage_<PixelType>::unloadTexture);
+	ofAddListener(ofxAndroidEvents().reloadGL,this,&ofImage_<PixelType>::update);
+	#endif
+	preparePixelsChange(false);
+	bool bLoadedOk = ofLoadImage(pixels, buffer, settings);
+	if (!bLoadedOk) {
+		ofLogError("ofImage") << "loadImage(): couldn't load image from ofMappedBuffer";
+		clear();
+		return false;
+	}
+	update();
+	return bLoadedOk;
+}
+
 //----------------------------------------------------------
 template<typename PixelType>
 bool ofImage_<PixelType>::loadImage(const ofBuffer & buffer){
@@ -732,12 +831,14 @@ bool ofImage_<PixelType>::loadImage(const ofBuffer & buffer){
 //----------------------------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::save(const std::filesystem::path& fileName, ofImageQualityType qualityLevel) const {
+	restorePixels();
 	ofSaveImage(pixels, fileName, qualityLevel);
 }
 
 //----------------------------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::save(ofBuffer & buffer, ofImageFormat imageFormat, ofImageQualityType qualityLevel) const {
+	restorePixels();
     ofSaveImage(pixels, buffer, imageFormat, qualityLevel);
 }
 
@@ -853,6 +954,7 @@ void ofImage_<PixelType>::allocate(int w, int h, ofImageType newType){
 	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofImage_<PixelType>::unloadTexture);
 	ofAddListener(ofxAndroidEvents().reloadGL,this,&ofImage_<PixelType>::update);
 #endif
+	preparePixelsChange(false);
 	pixels.allocate(w, h, newType);
 
 	// take care of texture allocation --
@@ -870,7 +972,7 @@ void ofImage_<PixelType>::allocate(int w, int h, ofImageType newType){
 //------------------------------------
 template<typename PixelType>
 bool ofImage_<PixelType>::bAllocated(){
-    return pixels.isAllocated();
+    return pixels.isAllocated() || bPixelsEvicted;
 }
 
 //------------------------------------
@@ -882,6 +984,8 @@ void ofImage_<PixelType>::clear(){
 #endif
 	pixels.clear();
 	if(bUseTexture)	tex.clear();
+	bPixelsEvicted			= false;
+	sourcePath.clear();
 
 	width					= 0;
 	height					= 0;
@@ -893,31 +997,34 @@ void ofImage_<PixelType>::clear(){
 //------------------------------------
 template<typename PixelType>
 ofPixels_<PixelType> &  ofImage_<PixelType>::getPixels(){
+	// they can be changed, the file doesn't have them anymore
+	preparePixelsChange(true);
 	return pixels;
 }
 
 //------------------------------------
 template<typename PixelType>
 const ofPixels_<PixelType> & ofImage_<PixelType>::getPixels() const{
+	restorePixels();
 	return pixels;
 }
 
 //----------------------------------------------------------
 template<typename PixelType>
 ofPixels_<PixelType> & ofImage_<PixelType>::getPixelsRef(){
-	return pixels;
+	return getPixels();
 }
 
 //----------------------------------------------------------
 template<typename PixelType>
 const ofPixels_<PixelType> & ofImage_<PixelType>::getPixelsRef() const {
-	return pixels;
+	return getPixels();
 }
 
 //----------------------------------------------------------
 template<typename PixelType>
 ofImage_<PixelType>::operator ofPixels_<PixelType>&(){
-	return pixels;
+	return getPixels();
 }
 
 //------------------------------------
@@ -962,30 +1069,35 @@ void ofImage_<PixelType>::unbind(int textureLocation) const{
 //------------------------------------
 template<typename PixelType>
 ofColor_<PixelType> ofImage_<PixelType>::getColor(int x, int y) const {
+	restorePixels();
 	return pixels.getColor(x, y);
 }
 
 //------------------------------------
 template<typename PixelType>
 ofColor_<PixelType> ofImage_<PixelType>::getColor(int index) const {
+	restorePixels();
 	return pixels.getColor(index);
 }
 
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::setColor(int x, int y, const ofColor_<PixelType>& color) {
+	preparePixelsChange(true);
 	pixels.setColor(x, y, color);
 }
 
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::setColor(int index, const ofColor_<PixelType>& color) {
+	preparePixelsChange(true);
 	pixels.setColor(index, color);
 }
 
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::setColor(const ofColor_<PixelType>& color) {
+	preparePixelsChange(true);
 	pixels.setColor(color);
 }
 
@@ -993,6 +1105,7 @@ void ofImage_<PixelType>::setColor(const ofColor_<PixelType>& color) {
 template<typename PixelType>
 void  ofImage_<PixelType>::setFromPixels(const PixelType * newPixels, int w, int h, ofImageType newType, bool bOrderIsRGB){
 
+	preparePixelsChange(false);
 	allocate(w, h, newType);
 	pixels.setFromPixels(newPixels,w,h,newType);
 
@@ -1019,6 +1132,8 @@ ofImage_<PixelType> & ofImage_<PixelType>::operator=(ofPixels_<PixelType> & pixe
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::update(){
+	// android calls it to upload the pixels again once the context is back
+	restorePixels();
 	width = pixels.getWidth();
 	height = pixels.getHeight();
 	bpp = pixels.getBitsPerPixel();
@@ -1031,6 +1146,7 @@ void ofImage_<PixelType>::update(){
 			tex.loadData(pixels);
 		}
 	}
+	evictPixels();
 }
 
 //------------------------------------
@@ -1045,11 +1161,90 @@ bool ofImage_<PixelType>::isUsingTexture() const{
 	return bUseTexture;
 }
 
+//------------------------------------
+template<typename PixelType>
+void ofImage_<PixelType>::setResidency(ofImageResidency newResidency){
+	residency = newResidency;
+	if(residency == OF_IMAGE_RESIDENCY_GPU_ONLY){
+		evictPixels();
+	}else{
+		restorePixels();
+	}
+}
+
+//------------------------------------
+template<typename PixelType>
+ofImageResidency ofImage_<PixelType>::getResidency() const{
+	return residency;
+}
+
+//------------------------------------
+template<typename PixelType>
+bool ofImage_<PixelType>::isPixelsResident() const{
+	return !bPixelsEvicted;
+}
+
+//------------------------------------
+template<typename PixelType>
+bool ofImage_<PixelType>::canRestorePixels() const{
+#ifndef TARGET_OPENGLES
+	// compressed textures would give back different pixels
+	if(tex.isAllocated() && tex.getTextureData().compressionType == OF_COMPRESS_NONE){
+		return true;
+	}
+#endif
+	return !sourcePath.empty();
+}
+
+//------------------------------------
+template<typename PixelType>
+void ofImage_<PixelType>::restorePixels() const{
+	if(!bPixelsEvicted){
+		return;
+	}
+	bPixelsEvicted = false;
+#ifndef TARGET_OPENGLES
+	if(tex.isAllocated() && tex.getTextureData().compressionType == OF_COMPRESS_NONE){
+		tex.readToPixels(pixels);
+		if(pixels.isAllocated()){
+			if(pixels.getImageType() != type){
+				pixels.setImageType(type);
+			}
+			return;
+		}
+	}
+#endif
+	if(sourcePath.empty() || !ofLoadImage(pixels, sourcePath, sourceSettings)){
+		ofLogError("ofImage") << "getPixels(): couldn't get back the pixels freed after uploading them";
+	}
+}
+
+//------------------------------------
+template<typename PixelType>
+void ofImage_<PixelType>::evictPixels(){
+	if(residency == OF_IMAGE_RESIDENCY_GPU_ONLY && bUseTexture && tex.isAllocated() &&
+	   pixels.isAllocated() && canRestorePixels()){
+		pixels.clear();
+		bPixelsEvicted = true;
+	}
+}
+
+//------------------------------------
+template<typename PixelType>
+void ofImage_<PixelType>::preparePixelsChange(bool keepContents){
+	if(keepContents){
+		restorePixels();
+	}
+	bPixelsEvicted = false;
+	sourcePath.clear();
+}
+
 //------------------------------------
 template<>
 void ofImage_<unsigned char>::grabScreen(int x, int y, int w, int h){
 	std::shared_ptr<ofBaseGLRenderer> renderer = ofGetGLRenderer();
 	if(renderer){
+		preparePixelsChange(false);
 		renderer->saveScreen(x,y,w,h,pixels);
 		update();
 	}
@@ -1078,6 +1273,7 @@ void ofGrabScreen(ofPixels & p, int x, int y, int w, int h){
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::grabScreen(int x, int y, int w, int h){
+	preparePixelsChange(false);
 	ofGrabScreen(pixels,x,y,w,h);
 	update();
 }
@@ -1085,6 +1281,7 @@ void ofImage_<PixelType>::grabScreen(int x, int y, int w, int h){
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::setImageType(ofImageType newType){
+	preparePixelsChange(true);
 	changeTypeOfPixels(pixels, newType);
 	update();
 }
@@ -1100,6 +1297,7 @@ template<typename PixelType>
 void ofImage_<PixelType>::resize(int newWidth, int newHeight){
 	if(newWidth == width && newHeight == height) return;
 
+	preparePixelsChange(true);
 	resizePixels(pixels, newWidth, newHeight);
 	update();
 }
@@ -1111,6 +1309,7 @@ void ofImage_<PixelType>::crop(int x, int y, int w, int h){
 	w = ofClamp(w,1,getWidth());
 	h = ofClamp(h,1,getHeight());
 
+	preparePixelsChange(true);
 	pixels.crop(x,y,w,h);
 	update();
 }
@@ -1121,6 +1320,8 @@ void ofImage_<PixelType>::cropFrom(const ofImage_<PixelType> & otherImage, int x
 	w = ofClamp(w,1,otherImage.getWidth());
 	h = ofClamp(h,1,otherImage.getHeight());
 
+	otherImage.restorePixels();
+	preparePixelsChange(false);
 	otherImage.pixels.cropTo(pixels, x, y, w, h);
 	update();
 }
@@ -1128,6 +1329,7 @@ void ofImage_<PixelType>::cropFrom(const ofImage_<PixelType> & otherImage, int x
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::rotate90(int nRotations){
+	preparePixelsChange(true);
 	pixels.rotate90(nRotations);
 	update();
 }
@@ -1135,6 +1337,7 @@ void ofImage_<PixelType>::rotate90(int nRotations){
 //------------------------------------
 template<typename PixelType>
 void ofImage_<PixelType>::mirror(bool vertical, bool horizontal){
+	preparePixelsChange(true);
 	pixels.mirror(vertical, horizontal);
 	update();
 }
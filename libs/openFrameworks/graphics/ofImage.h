@@ -120,6 +120,21 @@ struct ofImageLoadSettings {
 	bool exifRotate = false;
 	bool grayscale = false;
 	bool separateCMYK = false;
+	/// if not 0, images bigger than maxWidth x maxHeight are scaled down
+	/// to fit, keeping their aspect ratio. JPEGs are decoded directly at
+	/// a reduced size, which is much faster than decoding them whole
+	std::size_t maxWidth = 0;
+	std::size_t maxHeight = 0;
+};
+
+/// \brief Where an ofImage keeps its pixels once they are uploaded to its
+/// texture, see ofImage_::setResidency()
+enum ofImageResidency{
+	/// the pixels stay in memory next to the texture, the default
+	OF_IMAGE_RESIDENCY_CPU_AND_GPU,
+	/// the pixels are freed once uploaded and brought back when they are
+	/// needed
+	OF_IMAGE_RESIDENCY_GPU_ONLY,
 };
 
 //----------------------------------------------------
@@ -129,14 +144,18 @@ struct ofImageLoadSettings {
 /// \todo Needs documentation.
 bool ofLoadImage(ofPixels & pix, const std::filesystem::path& path, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofPixels & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
+bool ofLoadImage(ofPixels & pix, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofFloatPixels & pix, const std::filesystem::path& path, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofFloatPixels & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
+bool ofLoadImage(ofFloatPixels & pix, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofShortPixels & pix, const std::filesystem::path& path, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofShortPixels & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
+bool ofLoadImage(ofShortPixels & pix, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
 
 /// \todo Needs documentation.
 bool ofLoadImage(ofTexture & tex, const std::filesystem::path& path, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofTexture & tex, const ofBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
+bool ofLoadImage(ofTexture & tex, const ofMappedBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
 
 /// \todo Needs documentation.
 void ofSaveImage(const ofPixels & pix, const std::filesystem::path& path, ofImageQualityType qualityLevel = OF_IMAGE_QUALITY_BEST);
@@ -211,6 +230,15 @@ public:
     /// \param settings Load options
     /// \returns true if image loaded correctly.
 	bool load(const std::filesystem::path& fileName, const ofImageLoadSettings &settings = ofImageLoadSettings());
+
+    /// \brief Loads an image given by fileName scaled down to fit in
+    /// maxWidth x maxHeight, keeping its aspect ratio.
+    ///
+    /// JPEGs are decoded directly at a reduced size, using much less
+    /// memory and time than loading them whole and calling resize().
+    /// Smaller images are loaded at their size.
+    /// \returns true if image loaded correctly.
+	bool loadScaled(const std::filesystem::path& fileName, std::size_t maxWidth, std::size_t maxHeight, ofImageLoadSettings settings = ofImageLoadSettings());
     
     /// \brief Loads an image from an ofBuffer instance created by, for
     /// instance, ofFile::readToBuffer().
@@ -218,6 +246,10 @@ public:
     /// This actually loads the image data into an ofPixels object and then
     /// into the texture.
 	bool load(const ofBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
+
+    /// \brief Loads an image from a file mapped into memory, without
+    /// reading it into an ofBuffer first.
+	bool load(const ofMappedBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
     
     OF_DEPRECATED_MSG("Use load instead",bool loadImage(const std::string& fileName));
     OF_DEPRECATED_MSG("Use load instead",bool loadImage(const ofBuffer & buffer));
@@ -345,6 +377,32 @@ public:
     /// If the ofImage doesn't have a texture, nothing will be drawn to the screen.
     /// \returns true if the ofImage is using a texture.
     bool isUsingTexture() const;
+
+    /// \brief Sets whether the image keeps a copy of its pixels in memory
+    /// once they are uploaded to the texture
+    ///
+    /// With OF_IMAGE_RESIDENCY_GPU_ONLY the pixels are freed every time
+    /// update() uploads them, so images that are only drawn take memory
+    /// once, on the GPU:
+    ///
+    /// ~~~~{.cpp}
+    /// ofImage photo;
+    /// photo.setResidency(OF_IMAGE_RESIDENCY_GPU_ONLY);
+    /// photo.load("photo.jpg"); // decoded, uploaded and freed
+    /// photo.draw(0, 0);
+    /// ~~~~
+    ///
+    /// getPixels(), getColor(), save() and the methods that change the
+    /// image bring the pixels back, read from the texture or, where it
+    /// can't be read like on OpenGL ES, decoded again from the file the
+    /// image was loaded from. They stay in memory until the next update().
+    /// Images that can't get their pixels back that way keep them.
+    void setResidency(ofImageResidency residency);
+    ofImageResidency getResidency() const;
+
+    /// \brief Whether the pixels are in memory, false if they were freed
+    /// after uploading them
+    bool isPixelsResident() const;
     
     /// \brief Returns a reference to the texture that the ofImage contains.
     ///
@@ -628,11 +686,20 @@ protected:
     void changeTypeOfPixels(ofPixels_<PixelType> &pix, ofImageType type);
     void resizePixels(ofPixels_<PixelType> &pix, int newWidth, int newHeight);
     void unloadTexture();
+    bool canRestorePixels() const;
+    void restorePixels() const;
+    void evictPixels();
+    void preparePixelsChange(bool keepContents);
     
-    ofPixels_<PixelType> pixels;
+    mutable ofPixels_<PixelType> pixels;
     bool bUseTexture;
     ofTexture tex;
 
+    ofImageResidency residency;
+    mutable bool bPixelsEvicted; ///< \brief Pixels freed after uploading them.
+    std::filesystem::path sourcePath; ///< \brief File the pixels can be decoded again from.
+    ofImageLoadSettings sourceSettings;
+
     int width;  ///< \brief Image width in pixels.
     int height; ///< \brief Image Height in pixels.
     int bpp;    ///< \brief Bits per image pixel.
@@ -672,10 +739,12 @@ ofImage_<PixelType>::ofImage_(const ofImage_<SrcType>& mom) {
 template<typename PixelType>
 template<typename SrcType>
 void ofImage_<PixelType>::clone(const ofImage_<SrcType> &mom){
+    preparePixelsChange(false);
     pixels = mom.getPixels();
     
     tex.clear();
     bUseTexture = mom.isUsingTexture();
+    residency = mom.getResidency();
     if (bUseTexture == true && mom.getTexture().isAllocated()){
         tex.allocate(pixels.getWidth(), pixels.getHeight(), ofGetGlInternalFormat(pixels));
     }
@@ -0,0 +1,236 @@
+#include "ofImageSequenceRecorder.h"
+#include "ofFbo.h"
+#include "ofPixelReadback.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include <chrono>
+
+using namespace std;
+
+//----------------------------------------------------------
+ofImageSequenceRecorder::ofImageSequenceRecorder()
+:nextFrame(0)
+,numEncoding(0)
+,recording(false)
+,closing(false)
+,totalEncodeMs(0){
+}
+
+//----------------------------------------------------------
+ofImageSequenceRecorder::~ofImageSequenceRecorder(){
+	stop();
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::setup(const Settings & s){
+	stop();
+	settings = s;
+	folder = ofToDataPath(settings.folder, true);
+	if(!ofDirectory::doesDirectoryExist(folder, false) && !ofDirectory::createDirectory(folder, false, true)){
+		ofLogError("ofImageSequenceRecorder") << "setup(): couldn't create folder " << folder;
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	freeBuffers.clear();
+	freeBuffers.resize(std::max<size_t>(settings.numBuffers, 1));
+	frames.clear();
+	nextFrame = settings.firstFrame;
+	numEncoding = 0;
+	stats = Stats();
+	totalEncodeMs = 0;
+	closing = false;
+	recording = true;
+
+	size_t numThreads = settings.numThreads;
+	if(numThreads == 0){
+		numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+	for(size_t i = 0; i < numThreads; i++){
+		threads.emplace_back(&ofImageSequenceRecorder::workerLoop, this);
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::stop(){
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if(!recording){
+			return;
+		}
+		// the workers save what's queued before exiting
+		closing = true;
+		recording = false;
+	}
+	frameAvailable.notify_all();
+	bufferAvailable.notify_all();
+	for(auto & thread: threads){
+		thread.join();
+	}
+	threads.clear();
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::isRecording() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return recording;
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::add(const ofPixels & pixels){
+	ofPixels buffer;
+	if(!acquire(buffer)){
+		return false;
+	}
+	// the recycled buffer is reused if it has the same size
+	buffer = pixels;
+	queue(std::move(buffer));
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::add(ofPixels && pixels){
+	ofPixels buffer;
+	if(!acquire(buffer)){
+		return false;
+	}
+	buffer.swap(pixels);
+	queue(std::move(buffer));
+	return true;
+}
+
+#ifndef TARGET_OPENGLES
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::add(const ofFbo & fbo, int attachmentPoint){
+	bool added = true;
+	while(fbo.getAsyncPixels(readbackPixels)){
+		added &= add(std::move(readbackPixels));
+	}
+	if(!fbo.readToPixelsAsync(attachmentPoint)){
+		if(settings.policy == DROP_FRAMES){
+			std::unique_lock<std::mutex> lock(mutex);
+			stats.framesAdded++;
+			stats.framesDropped++;
+			return false;
+		}
+		flush(fbo);
+		fbo.readToPixelsAsync(attachmentPoint);
+	}
+	return added;
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::flush(const ofFbo & fbo){
+	auto & readback = fbo.getAsyncReadback();
+	while(readback.getNumPending() > 0){
+		if(!readback.isFrameReady()){
+			glFinish();
+		}
+		if(!fbo.getAsyncPixels(readbackPixels)){
+			break;
+		}
+		add(std::move(readbackPixels));
+	}
+}
+#endif
+
+//----------------------------------------------------------
+size_t ofImageSequenceRecorder::getNumPending() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return frames.size() + numEncoding;
+}
+
+//----------------------------------------------------------
+size_t ofImageSequenceRecorder::getFrameNumber() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return nextFrame;
+}
+
+//----------------------------------------------------------
+ofImageSequenceRecorder::Stats ofImageSequenceRecorder::getStats() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return stats;
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::acquire(ofPixels & pixels){
+	std::unique_lock<std::mutex> lock(mutex);
+	if(!recording){
+		ofLogError("ofImageSequenceRecorder") << "add(): not recording, call setup() first";
+		return false;
+	}
+	stats.framesAdded++;
+	if(freeBuffers.empty()){
+		if(settings.policy == DROP_FRAMES){
+			stats.framesDropped++;
+			return false;
+		}
+		auto start = chrono::steady_clock::now();
+		bufferAvailable.wait(lock, [this]{ return !freeBuffers.empty() || closing; });
+		stats.blockedMs += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		if(freeBuffers.empty()){
+			stats.framesDropped++;
+			return false;
+		}
+	}
+	pixels.swap(freeBuffers.back());
+	freeBuffers.pop_back();
+	return true;
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::queue(ofPixels && pixels){
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		frames.push_back({nextFrame++, std::move(pixels)});
+	}
+	frameAvailable.notify_one();
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::workerLoop(){
+	while(true){
+		Frame frame;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			frameAvailable.wait(lock, [this]{ return !frames.empty() || closing; });
+			if(frames.empty()){
+				return;
+			}
+			frame = std::move(frames.front());
+			frames.pop_front();
+			numEncoding++;
+		}
+
+		auto start = chrono::steady_clock::now();
+		ofBuffer encoded;
+		ofSaveImage(frame.pixels, encoded, settings.format, settings.quality);
+		auto fileName = getFileName(frame.number);
+		bool saved = encoded.size() > 0 && ofBufferToFile(fileName, encoded, true);
+		if(!saved){
+			ofLogError("ofImageSequenceRecorder") << "couldn't save frame " << fileName;
+		}
+		double encodeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if(saved){
+				stats.framesSaved++;
+			}else{
+				stats.framesFailed++;
+			}
+			totalEncodeMs += encodeMs;
+			stats.averageEncodeMs = totalEncodeMs / (stats.framesSaved + stats.framesFailed);
+			stats.maxEncodeMs = std::max(stats.maxEncodeMs, encodeMs);
+			freeBuffers.push_back(std::move(frame.pixels));
+			numEncoding--;
+		}
+		bufferAvailable.notify_one();
+	}
+}
+
+//----------------------------------------------------------
+string ofImageSequenceRecorder::getFileName(size_t frame) const{
+	return ofFilePath::join(folder, settings.prefix + ofToString(frame, settings.numDigits, '0') + "." + ofImageFormatExtension(settings.format));
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "ofImage.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+class ofFbo;
+
+/// \brief Saves frames as numbered image files, encoding them in
+/// background threads
+///
+/// Frames are copied into a fixed pool of recycled pixel buffers and
+/// encoded by the worker threads, so saving a sequence doesn't stall the
+/// draw thread while FreeImage compresses each frame:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofImageSequenceRecorder::Settings settings;
+///     settings.folder = "capture";
+///     settings.format = OF_IMAGE_FORMAT_JPEG;
+///     recorder.setup(settings);
+/// }
+///
+/// void ofApp::draw(){
+///     fbo.begin();
+///     // draw the scene
+///     fbo.end();
+///     fbo.draw(0, 0);
+///     // reads the fbo back without stalling, the frame is saved some
+///     // frames later
+///     recorder.add(fbo);
+/// }
+///
+/// void ofApp::exit(){
+///     recorder.flush(fbo);
+///     recorder.stop();
+/// }
+/// ~~~~
+///
+/// When all the buffers are waiting to be encoded, add() either waits for
+/// one or drops the frame, depending on Settings::policy.
+class ofImageSequenceRecorder{
+public:
+	/// \brief What add() does when no buffer is free
+	enum Policy{
+		BLOCK, //< wait for a worker to finish a frame
+		DROP_FRAMES, //< skip the frame and return false
+	};
+
+	struct Settings{
+		std::string folder = "frames"; //< relative to the data folder, created if needed
+		std::string prefix = "frame_";
+		std::size_t numDigits = 5; //< frame number padding
+		std::size_t firstFrame = 0;
+		ofImageFormat format = OF_IMAGE_FORMAT_PNG;
+		ofImageQualityType quality = OF_IMAGE_QUALITY_BEST;
+		std::size_t numThreads = 0; //< 0 for one less than the number of hardware threads
+		std::size_t numBuffers = 16; //< frames that can wait to be encoded
+		Policy policy = BLOCK;
+	};
+
+	struct Stats{
+		std::size_t framesAdded = 0;
+		std::size_t framesSaved = 0;
+		std::size_t framesDropped = 0;
+		std::size_t framesFailed = 0; //< couldn't be encoded or written
+		double averageEncodeMs = 0; //< encoding and writing one frame
+		double maxEncodeMs = 0;
+		double blockedMs = 0; //< total time add() waited for a free buffer
+	};
+
+	ofImageSequenceRecorder();
+	~ofImageSequenceRecorder();
+
+	ofImageSequenceRecorder(const ofImageSequenceRecorder &) = delete;
+	ofImageSequenceRecorder & operator=(const ofImageSequenceRecorder &) = delete;
+
+	/// \brief Starts the worker threads, stopping a previous recording
+	/// \returns false if the folder can't be created
+	bool setup(const Settings & settings);
+
+	/// \brief Waits for the queued frames to be saved and stops the threads
+	void stop();
+
+	bool isRecording() const;
+
+	/// \brief Queues a copy of pixels to be saved as the next frame
+	/// \returns false if the frame was dropped
+	bool add(const ofPixels & pixels);
+
+	/// \brief Queues pixels to be saved as the next frame, taking their
+	/// memory and leaving them with a recycled buffer
+	bool add(ofPixels && pixels);
+
+#ifndef TARGET_OPENGLES
+	/// \brief Starts an asynchronous readback of fbo and queues the frames
+	/// from previous calls that are already on the CPU
+	///
+	/// Uses ofFbo::readToPixelsAsync(), the fbo has to be RGB or RGBA 8 bit.
+	/// \returns false if a frame was dropped
+	bool add(const ofFbo & fbo, int attachmentPoint = 0);
+
+	/// \brief Waits for the GPU to finish the readbacks started by
+	/// add(fbo) and queues them
+	void flush(const ofFbo & fbo);
+#endif
+
+	/// \brief Number of frames waiting to be encoded or being encoded
+	std::size_t getNumPending() const;
+
+	/// \brief Number of the next frame added
+	std::size_t getFrameNumber() const;
+
+	Stats getStats() const;
+
+private:
+	struct Frame{
+		std::size_t number;
+		ofPixels pixels;
+	};
+
+	bool acquire(ofPixels & pixels);
+	void queue(ofPixels && pixels);
+	void workerLoop();
+	std::string getFileName(std::size_t frame) const;
+
+	Settings settings;
+	std::string folder;
+	std::vector<std::thread> threads;
+	std::deque<Frame> frames;
+	std::vector<ofPixels> freeBuffers;
+	std::size_t nextFrame;
+	std::size_t numEncoding;
+	bool recording;
+	bool closing;
+	Stats stats;
+	double totalEncodeMs;
+	ofPixels readbackPixels;
+	mutable std::mutex mutex;
+	std::condition_variable frameAvailable;
+	std::condition_variable bufferAvailable;
+};
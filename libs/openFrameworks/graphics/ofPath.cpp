@@ -2,14 +2,110 @@
 #include "ofAppRunner.h"
 #include "ofTessellator.h"
 #include "ofVectorMath.h"
+#include <list>
+#include <mutex>
 
 using namespace std;
 
-#if defined(TARGET_EMSCRIPTEN)
-	ofTessellator ofPath::tessellator;
-#elif HAS_TLS
-    thread_local ofTessellator ofPath::tessellator;
-#endif
+namespace{
+	struct CachedTessellation{
+		std::shared_ptr<const ofMesh> fill;
+		std::shared_ptr<const vector<ofPolyline>> contour;
+	};
+
+	// tessellations shared by all the paths, by the hash of their
+	// polylines, paths can be tessellated from any thread
+	class TessellationCache{
+	public:
+		template<typename T>
+		std::shared_ptr<const T> get(uint64_t hash, std::shared_ptr<const T> CachedTessellation::*part){
+			std::unique_lock<std::mutex> lock(mutex);
+			auto it = index.find(hash);
+			if(it == index.end()) return nullptr;
+			entries.splice(entries.begin(), entries, it->second);
+			return it->second->second.*part;
+		}
+
+		template<typename T>
+		void add(uint64_t hash, std::shared_ptr<const T> CachedTessellation::*part, std::shared_ptr<const T> value){
+			std::unique_lock<std::mutex> lock(mutex);
+			if(maxSize == 0) return;
+			auto it = index.find(hash);
+			if(it != index.end()){
+				entries.splice(entries.begin(), entries, it->second);
+			}else{
+				entries.emplace_front(hash, CachedTessellation());
+				index[hash] = entries.begin();
+				shrink();
+			}
+			entries.front().second.*part = std::move(value);
+		}
+
+		void setMaxSize(std::size_t size){
+			std::unique_lock<std::mutex> lock(mutex);
+			maxSize = size;
+			shrink();
+		}
+
+		std::size_t getMaxSize(){
+			std::unique_lock<std::mutex> lock(mutex);
+			return maxSize;
+		}
+
+		void clear(){
+			std::unique_lock<std::mutex> lock(mutex);
+			entries.clear();
+			index.clear();
+		}
+
+	private:
+		void shrink(){
+			while(entries.size() > maxSize){
+				index.erase(entries.back().first);
+				entries.pop_back();
+			}
+		}
+
+		typedef list<pair<uint64_t, CachedTessellation>> Entries;
+		Entries entries;
+		unordered_map<uint64_t, Entries::iterator> index;
+		std::size_t maxSize = 256;
+		std::mutex mutex;
+	};
+
+	TessellationCache & tessellationCache(){
+		static TessellationCache cache;
+		return cache;
+	}
+
+	// FNV-1a over the vertices, 4 bytes at a time
+	void hashBytes(uint64_t & hash, const void * data, std::size_t bytes){
+		const unsigned char * src = static_cast<const unsigned char*>(data);
+		for(std::size_t i = 0; i + 4 <= bytes; i += 4){
+			uint32_t word;
+			memcpy(&word, src + i, 4);
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+		for(std::size_t i = bytes & ~std::size_t(3); i < bytes; i++){
+			hash ^= src[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	uint64_t hashPolylines(const vector<ofPolyline> & polylines, ofPolyWindingMode windingMode){
+		uint64_t hash = 14695981039346656037ull;
+		int mode = windingMode;
+		hashBytes(hash, &mode, sizeof(mode));
+		for(auto & polyline: polylines){
+			auto & vertices = polyline.getVertices();
+			uint32_t header[2] = {uint32_t(vertices.size()), polyline.isClosed()};
+			hashBytes(hash, header, sizeof(header));
+			hashBytes(hash, vertices.data(), vertices.size() * sizeof(vertices[0]));
+		}
+		return hash;
+	}
+}
 
 ofPath::Command::Command(Type type)
 :type(type){
@@ -55,7 +151,11 @@ ofPath::ofPath(){
 	bHasChanged = false;
 	bUseShapeColor = true;
 	bNeedsPolylinesGeneration = false;
-	cachedTessellationValid = true;
+	cachedTessellationValid = false;
+	tessellatedContourValid = false;
+	tessellationHash = 0;
+	stencilFillValid = false;
+	fillMode = TESSELLATED_FILL;
 	clear();
 }
 
@@ -67,6 +167,7 @@ void ofPath::clear(){
 	polylines.resize(1);
 	polylines[0].clear();
 	cachedTessellation.clear();
+	cachedTessellationValid = false;
 	flagShapeChanged();
 }
 
@@ -611,20 +712,62 @@ void ofPath::generatePolylinesFromCommands(){
 
 		bNeedsPolylinesGeneration = false;
 		bNeedsTessellation = true;
-		cachedTessellationValid=false;
 	}
 }
 
+//----------------------------------------------------------
+void ofPath::updateTessellationHash(){
+	// a path that gets back to a previous shape doesn't need to tessellate
+	// again, any change is detected by the hash of the polylines
+	uint64_t hash = hashPolylines(polylines, windingMode);
+	if(hash != tessellationHash){
+		tessellationHash = hash;
+		cachedTessellationValid = false;
+		tessellatedContourValid = false;
+		stencilFillValid = false;
+	}
+}
+
+//----------------------------------------------------------
+void ofPath::tessellateFill(){
+	if(cachedTessellationValid) return;
+	auto cached = tessellationCache().get(tessellationHash, &CachedTessellation::fill);
+	if(cached){
+		cachedTessellation = *cached;
+	}else{
+		ofTessellator::getThreadTessellator().tessellateToMesh( polylines, windingMode, cachedTessellation);
+		if(getTessellationCacheSize() > 0){
+			tessellationCache().add(tessellationHash, &CachedTessellation::fill, std::make_shared<const ofMesh>(cachedTessellation));
+		}
+	}
+	cachedTessellationValid = true;
+}
+
+//----------------------------------------------------------
+void ofPath::tessellateContour(){
+	if(tessellatedContourValid) return;
+	auto cached = tessellationCache().get(tessellationHash, &CachedTessellation::contour);
+	if(cached){
+		tessellatedContour = *cached;
+	}else{
+		ofTessellator::getThreadTessellator().tessellateToPolylines( polylines, windingMode, tessellatedContour);
+		if(getTessellationCacheSize() > 0){
+			tessellationCache().add(tessellationHash, &CachedTessellation::contour, std::make_shared<const vector<ofPolyline>>(tessellatedContour));
+		}
+	}
+	tessellatedContourValid = true;
+}
+
 //----------------------------------------------------------
 void ofPath::tessellate(){
 	generatePolylinesFromCommands();
 	if(!bNeedsTessellation) return;
-	if(bFill){
-		tessellator.tessellateToMesh( polylines, windingMode, cachedTessellation);
-		cachedTessellationValid=true;
+	updateTessellationHash();
+	if(bFill && !isStencilFill()){
+		tessellateFill();
 	}
 	if(hasOutline() && windingMode!=OF_POLY_WINDING_ODD){
-		tessellator.tessellateToPolylines( polylines, windingMode, tessellatedContour);
+		tessellateContour();
 	}
 	bNeedsTessellation = false;
 }
@@ -632,7 +775,9 @@ void ofPath::tessellate(){
 //----------------------------------------------------------
 const vector<ofPolyline> & ofPath::getOutline() const{
 	if(windingMode!=OF_POLY_WINDING_ODD){
-		const_cast<ofPath*>(this)->tessellate();
+		ofPath * mutThis = const_cast<ofPath*>(this);
+		mutThis->tessellate();
+		mutThis->tessellateContour();
 		return tessellatedContour;
 	}else{
 		const_cast<ofPath*>(this)->generatePolylinesFromCommands();
@@ -642,10 +787,99 @@ const vector<ofPolyline> & ofPath::getOutline() const{
 
 //----------------------------------------------------------
 const ofMesh & ofPath::getTessellation() const{
-	const_cast<ofPath*>(this)->tessellate();
+	ofPath * mutThis = const_cast<ofPath*>(this);
+	mutThis->tessellate();
+	mutThis->tessellateFill();
 	return cachedTessellation;
 }
 
+//----------------------------------------------------------
+void ofPath::setTessellationCacheSize(std::size_t numTessellations){
+	tessellationCache().setMaxSize(numTessellations);
+}
+
+//----------------------------------------------------------
+std::size_t ofPath::getTessellationCacheSize(){
+	return tessellationCache().getMaxSize();
+}
+
+//----------------------------------------------------------
+void ofPath::clearTessellationCache(){
+	tessellationCache().clear();
+}
+
+//----------------------------------------------------------
+void ofPath::setFillMode(FillMode mode){
+	fillMode = mode;
+	bNeedsTessellation = true;
+}
+
+//----------------------------------------------------------
+ofPath::FillMode ofPath::getFillMode() const{
+	return fillMode;
+}
+
+//----------------------------------------------------------
+bool ofPath::isStencilFill() const{
+	return fillMode==STENCIL_FILL && (windingMode==OF_POLY_WINDING_ODD || windingMode==OF_POLY_WINDING_NONZERO);
+}
+
+//----------------------------------------------------------
+void ofPath::generateStencilFill(){
+	stencilFill.clear();
+	stencilFill.setMode(OF_PRIMITIVE_TRIANGLES);
+	stencilCover.clear();
+	stencilCover.setMode(OF_PRIMITIVE_TRIANGLES);
+
+	// a fan from the first vertex of every contour, every pixel inside the
+	// path is covered by a number of fans that follows its winding
+	glm::vec3 min, max;
+	float z = 0;
+	for(auto & polyline: polylines){
+		auto & vertices = polyline.getVertices();
+		if(vertices.size() < 3) continue;
+		if(stencilFill.getNumVertices() == 0){
+			min = max = toGlm(vertices[0]);
+			z = min.z;
+		}
+		ofIndexType first = stencilFill.getNumVertices();
+		stencilFill.addVertices(vertices);
+		for(ofIndexType i = 1; i + 1 < vertices.size(); i++){
+			stencilFill.addTriangle(first, first + i, first + i + 1);
+		}
+		for(auto & v: vertices){
+			min = glm::min(min, toGlm(v));
+			max = glm::max(max, toGlm(v));
+		}
+	}
+
+	if(stencilFill.getNumVertices() > 0){
+		stencilCover.addVertex(glm::vec3(min.x, min.y, z));
+		stencilCover.addVertex(glm::vec3(max.x, min.y, z));
+		stencilCover.addVertex(glm::vec3(max.x, max.y, z));
+		stencilCover.addVertex(glm::vec3(min.x, max.y, z));
+		stencilCover.addTriangle(0, 1, 2);
+		stencilCover.addTriangle(0, 2, 3);
+	}
+	stencilFillValid = true;
+}
+
+//----------------------------------------------------------
+const ofMesh & ofPath::getStencilFillMesh() const{
+	ofPath * mutThis = const_cast<ofPath*>(this);
+	mutThis->tessellate();
+	if(!stencilFillValid) mutThis->generateStencilFill();
+	return stencilFill;
+}
+
+//----------------------------------------------------------
+const ofMesh & ofPath::getStencilCoverMesh() const{
+	ofPath * mutThis = const_cast<ofPath*>(this);
+	mutThis->tessellate();
+	if(!stencilFillValid) mutThis->generateStencilFill();
+	return stencilCover;
+}
+
 //----------------------------------------------------------
 void ofPath::draw(float x, float y) const{
 	ofGetCurrentRenderer()->draw(*this,x,y);
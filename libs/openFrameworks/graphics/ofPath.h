@@ -305,6 +305,40 @@ public:
 	/// \name Drawing
 	/// \{
 
+	/// \brief How the fill of the path is drawn
+	enum FillMode{
+		/// triangulate the fill on the CPU with ofTessellator, the default
+		TESSELLATED_FILL,
+		/// draw every contour as a triangle fan to the stencil buffer and
+		/// then cover the bounding box where the stencil is set, see
+		/// setFillMode()
+		STENCIL_FILL
+	};
+
+	/// \brief Sets how the fill of the path is drawn
+	///
+	/// STENCIL_FILL avoids triangulating the path on the CPU, complex
+	/// paths that change every frame draw much faster, but it needs a
+	/// stencil buffer, like setting stencilBits in ofGLFWWindowSettings or
+	/// allocating an ofFbo with useStencil, and the programmable renderer.
+	/// It only works for flat paths and the OF_POLY_WINDING_ODD and
+	/// OF_POLY_WINDING_NONZERO winding modes, otherwise the path is
+	/// tessellated as usual.
+	void setFillMode(FillMode mode);
+	FillMode getFillMode() const;
+
+	/// \brief Whether the fill can be drawn through the stencil buffer,
+	/// the fill mode is STENCIL_FILL and the winding mode is supported
+	bool isStencilFill() const;
+
+	/// \brief Triangle fans of every contour of the path, drawn to the
+	/// stencil buffer by STENCIL_FILL
+	const ofMesh & getStencilFillMesh() const;
+
+	/// \brief Two triangles covering the bounding box of the path, drawn
+	/// where the stencil is set by STENCIL_FILL
+	const ofMesh & getStencilCoverMesh() const;
+
 	/// \brief Draws the path at 0,0. Calling draw() also calls tessellate()
 	void draw() const;
 
@@ -322,6 +356,18 @@ public:
 
 	const ofMesh & getTessellation() const;
 
+	/// \brief Sets the maximum number of tessellations kept in the cache
+	/// shared by all the paths, 256 by default, 0 to disable it
+	///
+	/// Tessellations are cached by a hash of the polylines of the path and
+	/// its winding mode, so a path that goes back to a previous shape, like
+	/// the frames of an animation, or many paths with the same shape, like
+	/// the letters of a text, are only tessellated once. The least recently
+	/// used are dropped first.
+	static void setTessellationCacheSize(std::size_t numTessellations);
+	static std::size_t getTessellationCacheSize();
+	static void clearTessellationCache();
+
 	void simplify(float tolerance=0.3f);
 
 	void translate(const glm::vec3 & p);
@@ -393,6 +439,10 @@ private:
 	ofPolyline & lastPolyline();
 	void addCommand(const Command & command);
 	void generatePolylinesFromCommands();
+	void updateTessellationHash();
+	void tessellateFill();
+	void tessellateContour();
+	void generateStencilFill();
 
 	// only needs to be called when path is modified externally
 	void flagShapeChanged();
@@ -418,13 +468,16 @@ private:
 	ofVboMesh			cachedTessellation;
 #endif
 	bool				cachedTessellationValid;
-#if defined(TARGET_EMSCRIPTEN)
-	static ofTessellator tessellator;
-#elif HAS_TLS
-	static thread_local ofTessellator tessellator;
+	bool				tessellatedContourValid;
+	uint64_t			tessellationHash;
+
+#ifdef TARGET_OPENGLES
+	ofMesh				stencilFill, stencilCover;
 #else
-	ofTessellator tessellator;
+	ofVboMesh			stencilFill, stencilCover;
 #endif
+	bool				stencilFillValid;
+	FillMode			fillMode;
 	bool				bHasChanged;
 	int					prevCurveRes;
 	int					curveResolution;
@@ -1,9 +1,311 @@
 #include "ofPixels.h"
 #include "ofMath.h"
+#include "ofTaskPool.h"
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define OF_PIXELS_RESIZE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define OF_PIXELS_RESIZE_NEON
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OF_PIXELS_SSE2
+#endif
 
 using namespace std;
 
+static size_t parallelThreshold = 1 << 20;
+
+//----------------------------------------------------------------------
+void ofSetPixelsParallelThreshold(size_t bytes){
+	parallelThreshold = bytes;
+}
+
+//----------------------------------------------------------------------
+size_t ofGetPixelsParallelThreshold(){
+	return parallelThreshold;
+}
+
+//----------------------------------------------------------------------
+void of::priv::parallelPixelsFor(size_t numItems, size_t bytesPerItem, const std::function<void(size_t,size_t)> & f){
+	if(numItems == 0) return;
+	size_t total = numItems * bytesPerItem;
+	ofTaskPool & pool = ofGetTaskPool();
+	if(parallelThreshold == 0 || total < parallelThreshold || pool.getNumThreads() == 0){
+		f(0, numItems);
+		return;
+	}
+	// a few chunks per thread to balance them, but not so small that
+	// scheduling them costs more than the work
+	const size_t minChunkBytes = 64 * 1024;
+	size_t grain = std::max(numItems / ((pool.getNumThreads() + 1) * 4), (minChunkBytes + bytesPerItem - 1) / bytesPerItem);
+	pool.parallelFor(0, numItems, f, std::max<size_t>(grain, 1));
+}
+
+//----------------------------------------------------------------------
+// conversions between 8 bit, 16 bit and float pixels, the same math as
+// the generic ofPixels_::copyFrom: a float scale and truncation, clamping
+// float sources to 0..1
+namespace{
+	template<typename SrcType, typename DstType>
+	inline void convertPixelTypeScalar(const SrcType * src, DstType * dst, size_t count, float factor, bool clampSource){
+		if(clampSource){
+			for(size_t i = 0; i < count; i++){
+				dst[i] = CLAMP(src[i], 0, 1) * factor;
+			}
+		}else{
+			for(size_t i = 0; i < count; i++){
+				dst[i] = src[i] * factor;
+			}
+		}
+	}
+
+#if defined(OF_PIXELS_SSE2)
+	inline __m128 clampUnit(__m128 v){
+		return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+	}
+
+	// 16 unsigned bytes to 4 vectors of 4 floats
+	inline void unpackBytes(__m128i v, __m128 out[4]){
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		out[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+		out[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+		out[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+		out[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+	}
+
+	// 8 unsigned shorts to 2 vectors of 4 floats
+	inline void unpackShorts(__m128i v, __m128 out[2]){
+		const __m128i zero = _mm_setzero_si128();
+		out[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+		out[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero));
+	}
+
+	// 2 vectors of 4 ints in 0..65535 to 8 unsigned shorts, SSE2 only has
+	// a signed saturating pack so the values are biased around it
+	inline __m128i packUnsignedShorts(__m128i a, __m128i b){
+		const __m128i bias32 = _mm_set1_epi32(32768);
+		const __m128i bias16 = _mm_set1_epi16(-32768);
+		return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32)), bias16);
+	}
+#endif
+}
+
+//----------------------------------------------------------------------
+bool of::priv::convertPixelType(const unsigned char * src, float * dst, size_t count){
+	const float factor = 1.f / 255.f;
+	size_t i = 0;
+#if defined(OF_PIXELS_SSE2)
+	const __m128 vfactor = _mm_set1_ps(factor);
+	for(; i + 16 <= count; i += 16){
+		__m128 v[4];
+		unpackBytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), v);
+		for(int k = 0; k < 4; k++){
+			_mm_storeu_ps(dst + i + k * 4, _mm_mul_ps(v[k], vfactor));
+		}
+	}
+#endif
+	convertPixelTypeScalar(src + i, dst + i, count - i, factor, false);
+	return true;
+}
+
+//----------------------------------------------------------------------
+bool of::priv::convertPixelType(const unsigned char * src, unsigned short * dst, size_t count){
+	size_t i = 0;
+#if defined(OF_PIXELS_SSE2)
+	// * 65535 / 255 is exactly * 257, the byte repeated in both halves
+	const __m128i zero = _mm_setzero_si128();
+	for(; i + 16 <= count; i += 16){
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(lo, _mm_slli_epi16(lo, 8)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_or_si128(hi, _mm_slli_epi16(hi, 8)));
+	}
+#endif
+	convertPixelTypeScalar(src + i, dst + i, count - i, 65535.f / 255.f, false);
+	return true;
+}
+
+//----------------------------------------------------------------------
+bool of::priv::convertPixelType(const unsigned short * src, unsigned char * dst, size_t count){
+	const float factor = 255.f / 65535.f;
+	size_t i = 0;
+#if defined(OF_PIXELS_SSE2)
+	const __m128 vfactor = _mm_set1_ps(factor);
+	for(; i + 16 <= count; i += 16){
+		__m128 a[2], b[2];
+		unpackShorts(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), a);
+		unpackShorts(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8)), b);
+		__m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(a[0], vfactor)), _mm_cvttps_epi32(_mm_mul_ps(a[1], vfactor)));
+		__m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(b[0], vfactor)), _mm_cvttps_epi32(_mm_mul_ps(b[1], vfactor)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	convertPixelTypeScalar(src + i, dst + i, count - i, factor, false);
+	return true;
+}
+
+//----------------------------------------------------------------------
+bool of::priv::convertPixelType(const unsigned short * src, float * dst, size_t count){
+	const float factor = 1.f / 65535.f;
+	size_t i = 0;
+#if defined(OF_PIXELS_SSE2)
+	const __m128 vfactor = _mm_set1_ps(factor);
+	for(; i + 8 <= count; i += 8){
+		__m128 v[2];
+		unpackShorts(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), v);
+		_mm_storeu_ps(dst + i, _mm_mul_ps(v[0], vfactor));
+		_mm_storeu_ps(dst + i + 4, _mm_mul_ps(v[1], vfactor));
+	}
+#endif
+	convertPixelTypeScalar(src + i, dst + i, count - i, factor, false);
+	return true;
+}
+
+//----------------------------------------------------------------------
+bool of::priv::convertPixelType(const float * src, unsigned char * dst, size_t count){
+	const float factor = 255.f;
+	size_t i = 0;
+#if defined(OF_PIXELS_SSE2)
+	const __m128 vfactor = _mm_set1_ps(factor);
+	for(; i + 16 <= count; i += 16){
+		__m128i v[4];
+		for(int k = 0; k < 4; k++){
+			v[k] = _mm_cvttps_epi32(_mm_mul_ps(clampUnit(_mm_loadu_ps(src + i + k * 4)), vfactor));
+		}
+		__m128i lo = _mm_packs_epi32(v[0], v[1]);
+		__m128i hi = _mm_packs_epi32(v[2], v[3]);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	convertPixelTypeScalar(src + i, dst + i, count - i, factor, true);
+	return true;
+}
+
+//----------------------------------------------------------------------
+bool of::priv::convertPixelType(const float * src, unsigned short * dst, size_t count){
+	const float factor = 65535.f;
+	size_t i = 0;
+#if defined(OF_PIXELS_SSE2)
+	const __m128 vfactor = _mm_set1_ps(factor);
+	for(; i + 8 <= count; i += 8){
+		__m128i a = _mm_cvttps_epi32(_mm_mul_ps(clampUnit(_mm_loadu_ps(src + i)), vfactor));
+		__m128i b = _mm_cvttps_epi32(_mm_mul_ps(clampUnit(_mm_loadu_ps(src + i + 4)), vfactor));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packUnsignedShorts(a, b));
+	}
+#endif
+	convertPixelTypeScalar(src + i, dst + i, count - i, factor, true);
+	return true;
+}
+
+namespace{
+	template<size_t Channels, typename PixelType>
+	inline void ofCopyPixel(const PixelType * src, PixelType * dst){
+		for(size_t k = 0; k < Channels; k++){
+			dst[k] = src[k];
+		}
+	}
+
+	// copies numPixels from src to dst, advancing by the strides in
+	// elements, the number of channels is resolved once outside the loop
+	// so the copy of each pixel is unrolled
+	template<size_t Channels, typename PixelType>
+	void ofCopyPixelsStrided(const PixelType * src, ptrdiff_t srcStride, PixelType * dst, ptrdiff_t dstStride, size_t numPixels){
+		for(size_t i = 0; i < numPixels; i++, src += srcStride, dst += dstStride){
+			ofCopyPixel<Channels>(src, dst);
+		}
+	}
+
+	template<typename PixelType>
+	void ofCopyPixelsStrided(const PixelType * src, ptrdiff_t srcStride, PixelType * dst, ptrdiff_t dstStride, size_t numPixels, size_t channels){
+		switch(channels){
+		case 1: ofCopyPixelsStrided<1>(src, srcStride, dst, dstStride, numPixels); break;
+		case 2: ofCopyPixelsStrided<2>(src, srcStride, dst, dstStride, numPixels); break;
+		case 3: ofCopyPixelsStrided<3>(src, srcStride, dst, dstStride, numPixels); break;
+		case 4: ofCopyPixelsStrided<4>(src, srcStride, dst, dstStride, numPixels); break;
+		default:
+			for(size_t i = 0; i < numPixels; i++, src += srcStride, dst += dstStride){
+				for(size_t k = 0; k < channels; k++){
+					dst[k] = src[k];
+				}
+			}
+			break;
+		}
+	}
+
+	// copies a row of pixels reversing their order
+	template<typename PixelType>
+	inline void ofMirrorRow(const PixelType * src, PixelType * dst, size_t width, size_t channels){
+		if(width == 0) return;
+		ofCopyPixelsStrided(src + (width - 1) * channels, -ptrdiff_t(channels), dst, channels, width, channels);
+	}
+
+	// reverses the order of the pixels in a row in place
+	template<typename PixelType>
+	inline void ofMirrorRowInPlace(PixelType * row, size_t width, size_t channels){
+		PixelType * a = row;
+		PixelType * b = row + width * channels;
+		for(size_t i = 0; i < width / 2; i++){
+			b -= channels;
+			std::swap_ranges(a, a + channels, b);
+			a += channels;
+		}
+	}
+
+	template<typename PixelType>
+	inline void ofSwapRgbRow(PixelType * p, size_t numPixels, size_t channels){
+		for(size_t i = 0; i < numPixels; i++, p += channels){
+			std::swap(p[0], p[2]);
+		}
+	}
+
+	inline void ofSwapRgbRow(unsigned char * p, size_t numPixels, size_t channels){
+		size_t i = 0;
+#if defined(OF_PIXELS_RESIZE_NEON)
+		if(channels == 4){
+			for(; i + 16 <= numPixels; i += 16, p += 64){
+				uint8x16x4_t v = vld4q_u8(p);
+				std::swap(v.val[0], v.val[2]);
+				vst4q_u8(p, v);
+			}
+		}else if(channels == 3){
+			for(; i + 16 <= numPixels; i += 16, p += 48){
+				uint8x16x3_t v = vld3q_u8(p);
+				std::swap(v.val[0], v.val[2]);
+				vst3q_u8(p, v);
+			}
+		}
+#elif defined(OF_PIXELS_SSE2)
+		if(channels == 4){
+			// every pixel is a 32 bit word, r and b are swapped by
+			// rotating the word by 16 bits, g and a stay in place
+			const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+			for(; i + 4 <= numPixels; i += 4, p += 16){
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				__m128i rb = _mm_and_si128(v, rbMask);
+				rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+				v = _mm_or_si128(_mm_andnot_si128(rbMask, v), rb);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+			}
+		}
+#endif
+		for(; i < numPixels; i++, p += channels){
+			std::swap(p[0], p[2]);
+		}
+	}
+}
+
 static ofImageType getImageTypeFromChannels(size_t channels){
 	switch(channels){
 	case 1:
@@ -205,7 +507,8 @@ ofPixels_<PixelType>::ofPixels_(ofPixels_<PixelType> && mom)
 ,pixelsSize(mom.pixelsSize)
 ,bAllocated(mom.bAllocated)
 ,pixelsOwner(mom.pixelsOwner)
-,pixelFormat(mom.pixelFormat){
+,pixelFormat(mom.pixelFormat)
+,pool(mom.pool){
 	mom.pixelsOwner = false;
 }
 
@@ -219,6 +522,7 @@ void ofPixels_<PixelType>::swap(ofPixels_<PixelType> & pix){
 	std::swap(bAllocated, pix.bAllocated);
 	std::swap(pixelsOwner, pix.pixelsOwner);
 	std::swap(pixelFormat,pix.pixelFormat);
+	std::swap(pool,pix.pool);
 }
 
 
@@ -244,6 +548,7 @@ ofPixels_<PixelType>& ofPixels_<PixelType>::operator=(ofPixels_<PixelType> && mo
 	bAllocated = mom.bAllocated;
 	pixelsOwner = mom.pixelsOwner;
 	pixelFormat = mom.pixelFormat;
+	pool = mom.pool;
 	mom.pixelsOwner = false;
 	return *this;
 }
@@ -464,16 +769,373 @@ void ofPixels_<PixelType>::allocate(size_t w, size_t h, ofPixelFormat format){
 
 	pixelsSize = newSize / sizeof(PixelType);
 
-	pixels = new PixelType[pixelsSize];
+	pixels = static_cast<PixelType*>(of::priv::acquirePixels(pool, newSize));
 	bAllocated = true;
 	pixelsOwner = true;
 }
 
+template<typename PixelType>
+void ofPixels_<PixelType>::allocate(size_t w, size_t h, ofPixelFormat format, ofPixelsPool & newPool){
+	if(pool.lock() != newPool.data){
+		// the current memory goes back where it came from
+		clear();
+		pool = newPool.data;
+	}
+	allocate(w, h, format);
+}
+
 template<typename PixelType>
 void ofPixels_<PixelType>::allocate(size_t w, size_t h, ofImageType type){
 	allocate(w,h,ofPixelFormatFromImageType(type));
 }
 
+// color conversion kernels, the generic versions work on any pixel type
+// and the 8 bit ones use SSE2 where available
+namespace{
+	// offsets of the red and blue channels, -1 for formats without color
+	void rgbOffsets(ofPixelFormat format, int & r, int & b){
+		switch(format){
+		case OF_PIXELS_RGB:
+		case OF_PIXELS_RGBA:
+			r = 0; b = 2;
+			break;
+		case OF_PIXELS_BGR:
+		case OF_PIXELS_BGRA:
+			r = 2; b = 0;
+			break;
+		default:
+			r = b = -1;
+			break;
+		}
+	}
+
+	// alpha channel offset, -1 for formats without alpha
+	int alphaOffset(ofPixelFormat format){
+		switch(format){
+		case OF_PIXELS_RGBA:
+		case OF_PIXELS_BGRA:
+			return 3;
+		case OF_PIXELS_GRAY_ALPHA:
+			return 1;
+		default:
+			return -1;
+		}
+	}
+
+	// same math as ofColor_::getHsb and setHsb
+	template<typename PixelType>
+	inline void rgbToHsb(PixelType & r, PixelType & g, PixelType & b, float limit){
+		float fr = r, fg = g, fb = b;
+		float max = std::max(fr, std::max(fg, fb));
+		float min = std::min(fr, std::min(fg, fb));
+		if(max == min){
+			r = 0;
+			g = 0;
+			b = max;
+			return;
+		}
+		float hueSixth;
+		if(fr == max){
+			hueSixth = (fg - fb) / (max - min);
+			if(hueSixth < 0.f) hueSixth += 6.f;
+		}else if(fg == max){
+			hueSixth = 2.f + (fb - fr) / (max - min);
+		}else{
+			hueSixth = 4.f + (fr - fg) / (max - min);
+		}
+		r = limit * hueSixth / 6.f;
+		g = limit * (max - min) / max;
+		b = max;
+	}
+
+	template<typename PixelType>
+	inline void hsbToRgb(PixelType & h, PixelType & s, PixelType & v, float limit){
+		float hue = h;
+		float saturation = ofClamp(s, 0, limit);
+		float brightness = ofClamp(v, 0, limit);
+		if(brightness == 0){
+			h = s = v = 0;
+			return;
+		}
+		if(saturation == 0){
+			h = s = v = brightness;
+			return;
+		}
+		float hueSix = hue * 6.f / limit;
+		float saturationNorm = saturation / limit;
+		int hueSixCategory = (int) floorf(hueSix);
+		float hueSixRemainder = hueSix - hueSixCategory;
+		PixelType value = brightness;
+		PixelType pv = (PixelType) ((1.f - saturationNorm) * brightness);
+		PixelType qv = (PixelType) ((1.f - saturationNorm * hueSixRemainder) * brightness);
+		PixelType tv = (PixelType) ((1.f - saturationNorm * (1.f - hueSixRemainder)) * brightness);
+		switch(hueSixCategory){
+			case 0: case 6: h = value; s = tv; v = pv; break;
+			case 1: h = qv; s = value; v = pv; break;
+			case 2: h = pv; s = value; v = tv; break;
+			case 3: h = pv; s = qv; v = value; break;
+			case 4: h = tv; s = pv; v = value; break;
+			case 5: h = value; s = pv; v = qv; break;
+		}
+	}
+
+	inline float srgbToLinear(float v){
+		return v <= 0.04045f ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+	}
+
+	inline float linearToSrgb(float v){
+		return v <= 0.0031308f ? v * 12.92f : 1.055f * powf(v, 1.f / 2.4f) - 0.055f;
+	}
+
+	// 8 and 16 bit transfers go through a table with every value, built the
+	// first time it's used
+	template<typename PixelType>
+	const std::vector<PixelType> & transferTable(bool toLinear){
+		static std::vector<PixelType> tables[2];
+		static std::once_flag once[2];
+		std::call_once(once[toLinear], [toLinear]{
+			auto & table = tables[toLinear];
+			const float limit = std::numeric_limits<PixelType>::max();
+			table.resize(size_t(limit) + 1);
+			for(size_t i = 0; i < table.size(); i++){
+				float v = i / limit;
+				table[i] = PixelType(ofClamp(toLinear ? srgbToLinear(v) : linearToSrgb(v), 0, 1) * limit + 0.5f);
+			}
+		});
+		return tables[toLinear];
+	}
+
+	template<typename PixelType>
+	void transferRow(PixelType * p, size_t numPixels, size_t channels, size_t numColors, bool toLinear){
+		const float limit = ofColor_<PixelType>::limit();
+		for(size_t i = 0; i < numPixels; i++, p += channels){
+			for(size_t c = 0; c < numColors; c++){
+				float v = ofClamp(p[c] / limit, 0, 1);
+				p[c] = PixelType((toLinear ? srgbToLinear(v) : linearToSrgb(v)) * limit);
+			}
+		}
+	}
+
+	template<typename PixelType>
+	void transferRowTable(PixelType * p, size_t numPixels, size_t channels, size_t numColors, bool toLinear){
+		auto & table = transferTable<PixelType>(toLinear);
+		for(size_t i = 0; i < numPixels; i++, p += channels){
+			for(size_t c = 0; c < numColors; c++){
+				p[c] = table[p[c]];
+			}
+		}
+	}
+
+	inline void transferRow(unsigned char * p, size_t numPixels, size_t channels, size_t numColors, bool toLinear){
+		transferRowTable(p, numPixels, channels, numColors, toLinear);
+	}
+
+	inline void transferRow(unsigned short * p, size_t numPixels, size_t channels, size_t numColors, bool toLinear){
+		transferRowTable(p, numPixels, channels, numColors, toLinear);
+	}
+
+	template<typename PixelType>
+	void transferPixels(PixelType * data, size_t numPixels, ofPixelFormat format, bool toLinear){
+		switch(format){
+		case OF_PIXELS_GRAY:
+		case OF_PIXELS_GRAY_ALPHA:
+		case OF_PIXELS_RGB:
+		case OF_PIXELS_BGR:
+		case OF_PIXELS_RGBA:
+		case OF_PIXELS_BGRA:{
+			size_t channels = channelsFromPixelFormat(format);
+			size_t numColors = alphaOffset(format) < 0 ? channels : channels - 1;
+			of::priv::parallelPixelsFor(numPixels, channels * sizeof(PixelType), [&](size_t begin, size_t end){
+				transferRow(data + begin * channels, end - begin, channels, numColors, toLinear);
+			});
+		}
+		break;
+		default:
+			ofLogWarning("ofPixels") << "sRGB conversion not supported for this pixel format";
+			break;
+		}
+	}
+
+	// converts between gray, rgb and rgba keeping the first channel as
+	// gray and filling new alpha channels with the maximum value
+	template<size_t SrcChannels, size_t DstChannels, typename PixelType>
+	void convertChannelsRow(const PixelType * src, PixelType * dst, size_t numPixels){
+		const PixelType limit = ofColor_<PixelType>::limit();
+		for(size_t i = 0; i < numPixels; i++, src += SrcChannels, dst += DstChannels){
+			for(size_t j = 0; j < DstChannels; j++){
+				dst[j] = j < SrcChannels ? src[j] : (j < 3 ? src[0] : limit);
+			}
+		}
+	}
+
+	template<typename PixelType>
+	void convertChannels(const PixelType * src, size_t srcChannels, PixelType * dst, size_t dstChannels, size_t numPixels){
+		switch(srcChannels * 10 + dstChannels){
+		case 13: convertChannelsRow<1,3>(src, dst, numPixels); return;
+		case 14: convertChannelsRow<1,4>(src, dst, numPixels); return;
+		case 31: convertChannelsRow<3,1>(src, dst, numPixels); return;
+		case 34: convertChannelsRow<3,4>(src, dst, numPixels); return;
+		case 41: convertChannelsRow<4,1>(src, dst, numPixels); return;
+		case 43: convertChannelsRow<4,3>(src, dst, numPixels); return;
+		}
+		const PixelType limit = ofColor_<PixelType>::limit();
+		for(size_t i = 0; i < numPixels; i++, src += srcChannels, dst += dstChannels){
+			for(size_t j = 0; j < dstChannels; j++){
+				dst[j] = j < srcChannels ? src[j] : (j < 3 ? src[0] : limit);
+			}
+		}
+	}
+
+	template<typename PixelType>
+	void premultiplyRow(PixelType * p, size_t numPixels, size_t channels, size_t alpha){
+		const float limit = ofColor_<PixelType>::limit();
+		for(size_t i = 0; i < numPixels; i++, p += channels){
+			float a = p[alpha] / limit;
+			for(size_t c = 0; c < channels; c++){
+				if(c != alpha) p[c] = PixelType(p[c] * a);
+			}
+		}
+	}
+
+	// c * a / 255 rounded, exact for every 8 bit c and a
+	inline unsigned char multiply255(unsigned int c, unsigned int a){
+		unsigned int v = c * a + 128;
+		return (v + (v >> 8)) >> 8;
+	}
+
+	inline void premultiplyRow(unsigned char * p, size_t numPixels, size_t channels, size_t alpha){
+		size_t i = 0;
+#if defined(OF_PIXELS_SSE2)
+		if(channels == 4 && alpha == 3){
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i half = _mm_set1_epi16(128);
+			const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+			for(; i + 4 <= numPixels; i += 4, p += 16){
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				__m128i lo = _mm_unpacklo_epi8(v, zero);
+				__m128i hi = _mm_unpackhi_epi8(v, zero);
+				// every 64 bits are a pixel, broadcast its alpha to the 4 lanes
+				__m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+				__m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+				lo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), half);
+				hi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), half);
+				lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+				hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+				__m128i result = _mm_packus_epi16(lo, hi);
+				result = _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, v));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(p), result);
+			}
+		}
+#endif
+		for(; i < numPixels; i++, p += channels){
+			unsigned int a = p[alpha];
+			for(size_t c = 0; c < channels; c++){
+				if(c != alpha) p[c] = multiply255(p[c], a);
+			}
+		}
+	}
+
+	template<typename PixelType>
+	void unpremultiplyRow(PixelType * p, size_t numPixels, size_t channels, size_t alpha){
+		const float limit = ofColor_<PixelType>::limit();
+		for(size_t i = 0; i < numPixels; i++, p += channels){
+			float a = p[alpha] / limit;
+			for(size_t c = 0; c < channels; c++){
+				if(c != alpha) p[c] = a > 0 ? PixelType(std::min(p[c] / a, limit)) : PixelType(0);
+			}
+		}
+	}
+
+	inline void unpremultiplyRow(unsigned char * p, size_t numPixels, size_t channels, size_t alpha){
+		// 255 / a in 16.16 fixed point instead of dividing for every channel
+		static const std::vector<unsigned int> reciprocals = []{
+			std::vector<unsigned int> table(256, 0);
+			for(unsigned int a = 1; a < 256; a++){
+				table[a] = (255u * 65536u + a / 2) / a;
+			}
+			return table;
+		}();
+		for(size_t i = 0; i < numPixels; i++, p += channels){
+			unsigned int reciprocal = reciprocals[p[alpha]];
+			for(size_t c = 0; c < channels; c++){
+				if(c != alpha) p[c] = std::min<unsigned int>((p[c] * reciprocal + 32768) >> 16, 255);
+			}
+		}
+	}
+
+	// BT.601 or BT.709, limited range, with 6 bits of fraction so the
+	// 16 bit SIMD products don't overflow. The luma factor is 1.164, 74.5,
+	// the half is added with a shift
+	struct YuvCoefficients{
+		int y, rv, gu, gv, bu;
+	};
+
+	YuvCoefficients yuvCoefficients(size_t height){
+		// video doesn't say its color space, HD and bigger is BT.709 and SD
+		// BT.601, same as the shaders in ofGLProgrammableRenderer
+		if(height > 576){
+			return {74, 115, -14, -34, 135};
+		}else{
+			return {74, 102, -25, -52, 129};
+		}
+	}
+
+	inline unsigned char clampByte(int v){
+		return v < 0 ? 0 : (v > 255 ? 255 : v);
+	}
+
+	// converts a row of y with u and v at half horizontal resolution to rgb
+	void yuvRowToRgb(const unsigned char * y, const unsigned char * u, const unsigned char * v, unsigned char * rgb, size_t width, const YuvCoefficients & k){
+		size_t x = 0;
+#if defined(OF_PIXELS_SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i y16 = _mm_set1_epi16(16);
+		const __m128i uv128 = _mm_set1_epi16(128);
+		const __m128i ky = _mm_set1_epi16(k.y);
+		const __m128i round = _mm_set1_epi16(32);
+		const __m128i krv = _mm_set1_epi16(k.rv);
+		const __m128i kgu = _mm_set1_epi16(k.gu);
+		const __m128i kgv = _mm_set1_epi16(k.gv);
+		const __m128i kbu = _mm_set1_epi16(k.bu);
+		alignas(16) unsigned char r8[16], g8[16], b8[16];
+		for(; x + 8 <= width; x += 8){
+			__m128i yv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero);
+			int u4, v4;
+			memcpy(&u4, u + x / 2, 4);
+			memcpy(&v4, v + x / 2, 4);
+			__m128i uv = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), zero);
+			__m128i vv = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), zero);
+			// every u and v is shared by 2 pixels
+			uv = _mm_sub_epi16(_mm_unpacklo_epi16(uv, uv), uv128);
+			vv = _mm_sub_epi16(_mm_unpacklo_epi16(vv, vv), uv128);
+			yv = _mm_sub_epi16(yv, y16);
+			yv = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(yv, ky), _mm_srai_epi16(yv, 1)), round);
+			// saturating adds clamp out of range results before the shift
+			__m128i r = _mm_srai_epi16(_mm_adds_epi16(yv, _mm_mullo_epi16(vv, krv)), 6);
+			__m128i g = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(yv, _mm_mullo_epi16(uv, kgu)), _mm_mullo_epi16(vv, kgv)), 6);
+			__m128i b = _mm_srai_epi16(_mm_adds_epi16(yv, _mm_mullo_epi16(uv, kbu)), 6);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(r8), _mm_packus_epi16(r, r));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(g8), _mm_packus_epi16(g, g));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(b8), _mm_packus_epi16(b, b));
+			for(size_t i = 0; i < 8; i++, rgb += 3){
+				rgb[0] = r8[i];
+				rgb[1] = g8[i];
+				rgb[2] = b8[i];
+			}
+		}
+#endif
+		auto saturate = [](int v){ return std::max(-32768, std::min(v, 32767)); };
+		for(; x < width; x++, rgb += 3){
+			int yv = (y[x] - 16) * k.y + ((y[x] - 16) >> 1) + 32;
+			int uv = u[x / 2] - 128;
+			int vv = v[x / 2] - 128;
+			rgb[0] = clampByte(saturate(yv + vv * k.rv) >> 6);
+			rgb[1] = clampByte(saturate(saturate(yv + uv * k.gu) + vv * k.gv) >> 6);
+			rgb[2] = clampByte(saturate(yv + uv * k.bu) >> 6);
+		}
+	}
+}
+
 template<typename PixelType>
 void ofPixels_<PixelType>::swapRgb(){
 	switch(pixelFormat){
@@ -481,9 +1143,14 @@ void ofPixels_<PixelType>::swapRgb(){
 	case OF_PIXELS_BGR:
 	case OF_PIXELS_RGBA:
 	case OF_PIXELS_BGRA:{
-		for(auto pixel: getPixelsIter()){
-			std::swap(pixel[0],pixel[2]);
-		}
+		size_t channels = getNumChannels();
+		size_t rowSize = width * channels;
+		PixelType * data = pixels;
+		of::priv::parallelPixelsFor(height, rowSize * sizeof(PixelType), [&](size_t begin, size_t end){
+			for(size_t y = begin; y < end; y++){
+				ofSwapRgbRow(data + y * rowSize, width, channels);
+			}
+		});
 	}
 	break;
 	default:
@@ -508,10 +1175,215 @@ void ofPixels_<PixelType>::swapRgb(){
 	}
 }
 
+template<typename PixelType>
+void ofPixels_<PixelType>::convertRgbToHsb(){
+	int r, b;
+	rgbOffsets(pixelFormat, r, b);
+	if(r < 0){
+		ofLogWarning("ofPixels") << "convertRgbToHsb(): only supported for RGB, BGR, RGBA and BGRA pixels";
+		return;
+	}
+	const float limit = ofColor_<PixelType>::limit();
+	size_t channels = getNumChannels();
+	PixelType * data = pixels;
+	of::priv::parallelPixelsFor(width * height, channels * sizeof(PixelType), [&](size_t begin, size_t end){
+		for(PixelType * p = data + begin * channels; p < data + end * channels; p += channels){
+			rgbToHsb(p[r], p[1], p[b], limit);
+		}
+	});
+}
+
+template<typename PixelType>
+void ofPixels_<PixelType>::convertHsbToRgb(){
+	int r, b;
+	rgbOffsets(pixelFormat, r, b);
+	if(r < 0){
+		ofLogWarning("ofPixels") << "convertHsbToRgb(): only supported for RGB, BGR, RGBA and BGRA pixels";
+		return;
+	}
+	const float limit = ofColor_<PixelType>::limit();
+	size_t channels = getNumChannels();
+	PixelType * data = pixels;
+	of::priv::parallelPixelsFor(width * height, channels * sizeof(PixelType), [&](size_t begin, size_t end){
+		for(PixelType * p = data + begin * channels; p < data + end * channels; p += channels){
+			hsbToRgb(p[r], p[1], p[b], limit);
+		}
+	});
+}
+
+template<typename PixelType>
+void ofPixels_<PixelType>::convertSrgbToLinear(){
+	transferPixels(pixels, width * height, pixelFormat, true);
+}
+
+template<typename PixelType>
+void ofPixels_<PixelType>::convertLinearToSrgb(){
+	transferPixels(pixels, width * height, pixelFormat, false);
+}
+
+template<typename PixelType>
+void ofPixels_<PixelType>::premultiplyAlpha(){
+	int alpha = alphaOffset(pixelFormat);
+	if(alpha < 0){
+		ofLogWarning("ofPixels") << "premultiplyAlpha(): pixels have no alpha channel";
+		return;
+	}
+	size_t channels = getNumChannels();
+	PixelType * data = pixels;
+	of::priv::parallelPixelsFor(width * height, channels * sizeof(PixelType), [&](size_t begin, size_t end){
+		premultiplyRow(data + begin * channels, end - begin, channels, alpha);
+	});
+}
+
+template<typename PixelType>
+void ofPixels_<PixelType>::unpremultiplyAlpha(){
+	int alpha = alphaOffset(pixelFormat);
+	if(alpha < 0){
+		ofLogWarning("ofPixels") << "unpremultiplyAlpha(): pixels have no alpha channel";
+		return;
+	}
+	size_t channels = getNumChannels();
+	PixelType * data = pixels;
+	of::priv::parallelPixelsFor(width * height, channels * sizeof(PixelType), [&](size_t begin, size_t end){
+		unpremultiplyRow(data + begin * channels, end - begin, channels, alpha);
+	});
+}
+
+template<typename PixelType>
+bool ofPixels_<PixelType>::convertYuvToRgb(ofPixels_<PixelType> & dst) const{
+	if(!std::is_same<PixelType, unsigned char>::value){
+		ofLogError("ofPixels") << "convertYuvToRgb(): only supported for 8 bit pixels";
+		return false;
+	}
+	if(width % 2 != 0 || (height % 2 != 0 && pixelFormat != OF_PIXELS_YUY2 && pixelFormat != OF_PIXELS_UYVY)){
+		ofLogError("ofPixels") << "convertYuvToRgb(): width and height have to be even";
+		return false;
+	}
+	const unsigned char * data = reinterpret_cast<const unsigned char*>(pixels);
+	size_t chromaWidth = width / 2;
+	const unsigned char * chroma = data + width * height;
+	// offsets of each plane and steps between samples in a chroma row
+	size_t uOffset, vOffset, chromaStep, chromaRow;
+	switch(pixelFormat){
+	case OF_PIXELS_NV12:
+		uOffset = 0; vOffset = 1; chromaStep = 2; chromaRow = width;
+		break;
+	case OF_PIXELS_NV21:
+		uOffset = 1; vOffset = 0; chromaStep = 2; chromaRow = width;
+		break;
+	case OF_PIXELS_I420:
+		uOffset = 0; vOffset = chromaWidth * (height / 2); chromaStep = 1; chromaRow = chromaWidth;
+		break;
+	case OF_PIXELS_YV12:
+		uOffset = chromaWidth * (height / 2); vOffset = 0; chromaStep = 1; chromaRow = chromaWidth;
+		break;
+	case OF_PIXELS_YUY2:
+	case OF_PIXELS_UYVY:
+		chroma = data;
+		uOffset = pixelFormat == OF_PIXELS_YUY2 ? 1 : 0;
+		vOffset = uOffset + 2;
+		chromaStep = 4; chromaRow = width * 2;
+		break;
+	default:
+		ofLogError("ofPixels") << "convertYuvToRgb(): pixels are not NV12, NV21, I420, YV12, YUY2 or UYVY";
+		return false;
+	}
+	bool packed = pixelFormat == OF_PIXELS_YUY2 || pixelFormat == OF_PIXELS_UYVY;
+	size_t yOffset = pixelFormat == OF_PIXELS_UYVY ? 1 : 0;
+
+	dst.allocate(width, height, OF_PIXELS_RGB);
+	unsigned char * rgb = reinterpret_cast<unsigned char*>(dst.getData());
+	auto coefficients = yuvCoefficients(height);
+	size_t w = width;
+	of::priv::parallelPixelsFor(height, w * 3, [&](size_t begin, size_t end){
+		// the interleaved samples are split in rows of each plane first
+		std::vector<unsigned char> rows(packed ? w * 2 : w);
+		unsigned char * u = rows.data();
+		unsigned char * v = u + chromaWidth;
+		unsigned char * y = v + chromaWidth;
+		for(size_t row = begin; row < end; row++){
+			const unsigned char * chromaSrc = chroma + (packed ? row : row / 2) * chromaRow;
+			for(size_t x = 0; x < chromaWidth; x++){
+				u[x] = chromaSrc[x * chromaStep + uOffset];
+				v[x] = chromaSrc[x * chromaStep + vOffset];
+			}
+			const unsigned char * luma = data + row * w;
+			if(packed){
+				for(size_t x = 0; x < w; x++){
+					y[x] = chromaSrc[x * 2 + yOffset];
+				}
+				luma = y;
+			}
+			yuvRowToRgb(luma, u, v, rgb + row * w * 3, w, coefficients);
+		}
+	});
+	return true;
+}
+
+template<typename PixelType>
+bool ofPixels_<PixelType>::convertRgbToNv12(ofPixels_<PixelType> & dst) const{
+	if(!std::is_same<PixelType, unsigned char>::value){
+		ofLogError("ofPixels") << "convertRgbToNv12(): only supported for 8 bit pixels";
+		return false;
+	}
+	int r, b;
+	rgbOffsets(pixelFormat, r, b);
+	if(r < 0){
+		ofLogError("ofPixels") << "convertRgbToNv12(): only supported for RGB, BGR, RGBA and BGRA pixels";
+		return false;
+	}
+	if(width % 2 != 0 || height % 2 != 0){
+		ofLogError("ofPixels") << "convertRgbToNv12(): width and height have to be even";
+		return false;
+	}
+	// integer BT.601 or BT.709 limited range, picked the same way as
+	// convertYuvToRgb
+	struct{ int yr, yg, yb, ur, ug, ub, vr, vg, vb; } k;
+	if(height > 576){
+		k = {47, 157, 16, -26, -87, 112, 112, -102, -10};
+	}else{
+		k = {66, 129, 25, -38, -74, 112, 112, -94, -18};
+	}
+	const unsigned char * data = reinterpret_cast<const unsigned char*>(pixels);
+	size_t channels = getNumChannels();
+	size_t w = width;
+	size_t h = height;
+	dst.allocate(width, height, OF_PIXELS_NV12);
+	unsigned char * yPlane = reinterpret_cast<unsigned char*>(dst.getData());
+	unsigned char * uvPlane = yPlane + w * h;
+	of::priv::parallelPixelsFor(h / 2, w * 3, [&](size_t begin, size_t end){
+		for(size_t row = begin; row < end; row++){
+			const unsigned char * src0 = data + row * 2 * w * channels;
+			const unsigned char * src1 = src0 + w * channels;
+			unsigned char * y0 = yPlane + row * 2 * w;
+			unsigned char * y1 = y0 + w;
+			unsigned char * uv = uvPlane + row * w;
+			for(size_t x = 0; x < w; x += 2){
+				int sumR = 0, sumG = 0, sumB = 0;
+				const unsigned char * quad[4] = {src0 + x * channels, src0 + (x + 1) * channels, src1 + x * channels, src1 + (x + 1) * channels};
+				unsigned char * luma[4] = {y0 + x, y0 + x + 1, y1 + x, y1 + x + 1};
+				for(int i = 0; i < 4; i++){
+					int pr = quad[i][r], pg = quad[i][1], pb = quad[i][b];
+					*luma[i] = ((k.yr * pr + k.yg * pg + k.yb * pb + 128) >> 8) + 16;
+					sumR += pr;
+					sumG += pg;
+					sumB += pb;
+				}
+				sumR = (sumR + 2) / 4;
+				sumG = (sumG + 2) / 4;
+				sumB = (sumB + 2) / 4;
+				uv[x] = ((k.ur * sumR + k.ug * sumG + k.ub * sumB + 128) >> 8) + 128;
+				uv[x + 1] = ((k.vr * sumR + k.vg * sumG + k.vb * sumB + 128) >> 8) + 128;
+			}
+		}
+	});
+	return true;
+}
+
 template<typename PixelType>
 void ofPixels_<PixelType>::clear(){
 	if(pixels){
-		if(pixelsOwner) delete[] pixels;
+		if(pixelsOwner) of::priv::releasePixels(pool, pixels, pixelsSize * sizeof(PixelType));
 		pixels = nullptr;
 	}
 
@@ -886,27 +1758,13 @@ void ofPixels_<PixelType>::setImageType(ofImageType imageType){
 	if(!isAllocated() || imageType==getImageType()) return;
 	ofPixels_<PixelType> dst;
 	dst.allocate(width,height,imageType);
-	PixelType * dstPtr = &dst[0];
-	PixelType * srcPtr = &pixels[0];
+	PixelType * dstPtr = dst.getData();
+	const PixelType * srcPtr = pixels;
 	size_t dstNumChannels = dst.getNumChannels();
 	size_t srcNumChannels = getNumChannels();
-	size_t diffNumChannels = 0;
-	if(dstNumChannels<srcNumChannels){
-		diffNumChannels = srcNumChannels-dstNumChannels;
-	}
-	for(size_t i=0;i<width*height;i++){
-		const PixelType & gray = *srcPtr;
-		for(size_t j=0;j<dstNumChannels;j++){
-			if(j<srcNumChannels){
-				*dstPtr++ =  *srcPtr++;
-			}else if(j<3){
-				*dstPtr++ = gray;
-			}else{
-				*dstPtr++ = ofColor_<PixelType>::limit();
-			}
-		}
-		srcPtr+=diffNumChannels;
-	}
+	of::priv::parallelPixelsFor(width * height, dstNumChannels * sizeof(PixelType), [&](size_t begin, size_t end){
+		convertChannels(srcPtr + begin * srcNumChannels, srcNumChannels, dstPtr + begin * dstNumChannels, dstNumChannels, end - begin);
+	});
 	swap(dst);
 }
 
@@ -947,10 +1805,12 @@ void ofPixels_<PixelType>::setChannel(size_t channel, const ofPixels_<PixelType>
 	if(channels==0) return;
 
 	channel = ofClamp(channel,0,channels-1);
-	const_iterator channelPixel = channelPixels.begin();
-	for(auto p: getPixelsIter()){
-		p[channel] = *channelPixel++;
-	}
+	const PixelType * src = channelPixels.getData();
+	PixelType * dst = pixels + channel;
+	size_t w = width;
+	of::priv::parallelPixelsFor(height, w * channels * sizeof(PixelType), [&](size_t begin, size_t end){
+		ofCopyPixelsStrided(src + begin * w, 1, dst + begin * w * channels, channels, (end - begin) * w, 1);
+	});
 
 }
 
@@ -1033,36 +1893,25 @@ void ofPixels_<PixelType>::rotate90To(ofPixels_<PixelType> & dst, int nClockwise
 
 	size_t strideSrc = width * channels;
 	size_t strideDst = dst.width * channels;
-
-	if(rotation == 1){
-		PixelType * srcPixels = pixels;
-		PixelType * startPixels = dst.getData() + strideDst;
-		for (size_t i = 0; i < height; ++i){
-			startPixels -= channels;
-			PixelType * dstPixels = startPixels;
-			for (size_t j = 0; j < width; ++j){
-				for (size_t k = 0; k < channels; ++k){
-					dstPixels[k] = srcPixels[k];
-				}
-				srcPixels += channels;
-				dstPixels += strideDst;
-			}
-		}
-	} else if(rotation == 3){
-		PixelType * dstPixels = dst.pixels;
-		PixelType * startPixels = pixels + strideSrc;
-		for (size_t i = 0; i < dst.height; ++i){
-			startPixels -= channels;
-			PixelType * srcPixels = startPixels;
-			for (size_t j = 0; j < dst.width; ++j){
-				for (size_t k = 0; k < channels; ++k){
-					dstPixels[k] = srcPixels[k];
-				}
-				srcPixels += strideSrc;
-				dstPixels += channels;
+	const PixelType * srcPixels = pixels;
+	PixelType * dstPixels = dst.pixels;
+	size_t srcHeight = height;
+
+	// every row of the destination is a column of the source, split by
+	// destination rows so each thread writes contiguous memory
+	of::priv::parallelPixelsFor(dst.height, strideDst * sizeof(PixelType), [&](size_t begin, size_t end){
+		for(size_t y = begin; y < end; y++){
+			if(rotation == 1){
+				// the column y read from the bottom
+				const PixelType * src = srcPixels + (srcHeight - 1) * strideSrc + y * channels;
+				ofCopyPixelsStrided(src, -ptrdiff_t(strideSrc), dstPixels + y * strideDst, channels, srcHeight, channels);
+			}else{
+				// the column width - 1 - y read from the top
+				const PixelType * src = srcPixels + strideSrc - (y + 1) * channels;
+				ofCopyPixelsStrided(src, strideSrc, dstPixels + y * strideDst, channels, srcHeight, channels);
 			}
 		}
-	}
+	});
 }
 
 //----------------------------------------------------------------------
@@ -1091,11 +1940,10 @@ void ofPixels_<PixelType>::rotate90(int nClockwiseRotations){
 	}
 
 	ofPixels_<PixelType> newPixels;
+	newPixels.pool = pool;
 	rotate90To(newPixels,nClockwiseRotations);
-	std::swap(newPixels.pixels,pixels);
-	width = newPixels.width;
-	height = newPixels.height;
-	pixelsSize = newPixels.size();
+	// the old memory is released by newPixels
+	swap(newPixels);
 
 }
 
@@ -1108,32 +1956,34 @@ void ofPixels_<PixelType>::mirror(bool vertically, bool horizontal){
 		return;
 	}
 
-	size_t bytesPerPixel = channels;
-	PixelType * oldPixels = pixels;
-	PixelType tempVal;
-
-	if (! (vertically && horizontal)){
-		size_t wToDo = horizontal ? width/2 : width;
-		size_t hToDo = vertically ? height/2 : height;
-
-		for (size_t i = 0; i < wToDo; i++){
-			for (size_t j = 0; j < hToDo; j++){
-
-				size_t  pixelb = (vertically ? (height - j - 1) : j) * width + (horizontal ? (width - i - 1) : i);
-				size_t  pixela = j*width + i;
-				for (size_t k = 0; k < bytesPerPixel; k++){
-
-					tempVal = oldPixels[pixela*bytesPerPixel + k];
-					oldPixels[pixela*bytesPerPixel + k] = oldPixels[pixelb*bytesPerPixel + k];
-					oldPixels[pixelb*bytesPerPixel + k] = tempVal;
-
+	size_t rowSize = width * channels;
+	PixelType * data = pixels;
+	size_t h = height;
+	size_t w = width;
+
+	if(vertically){
+		// swap the rows of the top half with the bottom half, mirroring
+		// both of them if needed, the middle row only needs mirroring
+		of::priv::parallelPixelsFor(h / 2, rowSize * 2 * sizeof(PixelType), [&](size_t begin, size_t end){
+			for(size_t y = begin; y < end; y++){
+				PixelType * a = data + y * rowSize;
+				PixelType * b = data + (h - 1 - y) * rowSize;
+				std::swap_ranges(a, a + rowSize, b);
+				if(horizontal){
+					ofMirrorRowInPlace(a, w, channels);
+					ofMirrorRowInPlace(b, w, channels);
 				}
 			}
+		});
+		if(horizontal && h % 2 == 1){
+			ofMirrorRowInPlace(data + (h / 2) * rowSize, w, channels);
 		}
-	} else {
-		// I couldn't think of a good way to do this in place.  I'm sure there is.
-		mirror(true, false);
-		mirror(false, true);
+	}else{
+		of::priv::parallelPixelsFor(h, rowSize * sizeof(PixelType), [&](size_t begin, size_t end){
+			for(size_t y = begin; y < end; y++){
+				ofMirrorRowInPlace(data + y * rowSize, w, channels);
+			}
+		});
 	}
 
 }
@@ -1151,116 +2001,221 @@ void ofPixels_<PixelType>::mirrorTo(ofPixels_<PixelType> & dst, bool vertically,
 		return;
 	}
 
-	size_t bytesPerPixel = getNumChannels();
+	size_t channels = getNumChannels();
 	dst.allocate(width, height, getPixelFormat());
 
-	if(vertically && !horizontal){
-		auto dstLines = dst.getLines();
-		auto lineSrc = getConstLines().begin();
-		auto line = --dstLines.end();
-		auto stride = line.getStride();
-
-		for(; line>=dstLines.begin(); --line, ++lineSrc){
-			memcpy(line.begin(), lineSrc.begin(), stride);
-		}
-	}else if (!vertically && horizontal){
-		size_t wToDo = width/2;
-		size_t hToDo = height;
-		for (size_t i = 0; i < wToDo; i++){
-			for (size_t j = 0; j < hToDo; j++){
-				size_t pixelb = j*width + (width - 1 - i);
-				size_t pixela = j*width + i;
-				for (size_t k = 0; k < bytesPerPixel; k++){
-					dst[pixela*bytesPerPixel + k] = pixels[pixelb*bytesPerPixel + k];
-					dst[pixelb*bytesPerPixel + k] = pixels[pixela*bytesPerPixel + k];
-
-				}
+	size_t rowSize = width * channels;
+	const PixelType * srcPixels = pixels;
+	PixelType * dstPixels = dst.pixels;
+	size_t h = height;
+	size_t w = width;
+	of::priv::parallelPixelsFor(h, rowSize * sizeof(PixelType), [&](size_t begin, size_t end){
+		for(size_t y = begin; y < end; y++){
+			const PixelType * src = srcPixels + (vertically ? h - 1 - y : y) * rowSize;
+			PixelType * dst = dstPixels + y * rowSize;
+			if(horizontal){
+				ofMirrorRow(src, dst, w, channels);
+			}else{
+				memcpy(dst, src, rowSize * sizeof(PixelType));
 			}
 		}
-	} else {
-		// I couldn't think of a good way to do this in place.  I'm sure there is.
-		mirrorTo(dst,true, false);
-		dst.mirror(false, true);
-	}
+	});
 
 }
 
 //----------------------------------------------------------------------
 template<typename PixelType>
-bool ofPixels_<PixelType>::resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod){
+bool ofPixels_<PixelType>::resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod, size_t numThreads){
 
 	if ((dstWidth == 0) || (dstHeight == 0) || !(isAllocated())) return false;
 
 	ofPixels_<PixelType> dstPixels;
+	dstPixels.pool = pool;
 	dstPixels.allocate(dstWidth, dstHeight, getPixelFormat());
 
-	if(!resizeTo(dstPixels,interpMethod)) return false;
+	if(!resizeTo(dstPixels,interpMethod,numThreads)) return false;
 
-	delete [] pixels;
-	pixels = dstPixels.getData();
-	width  = dstWidth;
-	height = dstHeight;
-	pixelsSize = dstPixels.size();
-	dstPixels.pixelsOwner = false;
+	// the old memory is released by dstPixels
+	swap(dstPixels);
 	return true;
 }
 
 //----------------------------------------------------------------------
-template<typename PixelType>
-float ofPixels_<PixelType>::bicubicInterpolate (const float *patch, float x,float y, float x2,float y2, float x3,float y3) {
-	// adapted from http://www.paulinternet.nl/?page=bicubic
-	// Note that this code can produce values outside of 0...255, due to cubic overshoot.
-	// The ofClamp() prevents this from happening.
-
-	float p00 = patch[ 0];
-	float p10 = patch[ 4];
-	float p20 = patch[ 8];
-	float p30 = patch[12];
-
-	float p01 = patch[ 1];
-	float p11 = patch[ 5];
-	float p21 = patch[ 9];
-	float p31 = patch[13];
-
-	float p02 = patch[ 2];
-	float p12 = patch[ 6];
-	float p22 = patch[10];
-	float p32 = patch[14];
-
-	float p03 = patch[ 3];
-	float p13 = patch[ 7];
-	float p23 = patch[11];
-	float p33 = patch[15];
-
-	float a00 =    p11;
-	float a01 =   -p10 +   p12;
-	float a02 =  2.0f*p10 - 2.0f*p11 +   p12 -   p13;
-	float a03 =   -p10 +   p11 -   p12 +   p13;
-	float a10 =   -p01 +   p21;
-	float a11 =    p00 -   p02 -   p20 +   p22;
-	float a12 = -2.0f*p00 + 2.0f*p01 -   p02 +   p03 + 2.0f*p20 - 2.0f*p21 +   p22 -   p23;
-	float a13 =    p00 -   p01 +   p02 -   p03 -   p20 +   p21 -   p22 +   p23;
-	float a20 =  2.0f*p01 - 2.0f*p11 +   p21 -   p31;
-	float a21 = -2.0f*p00 + 2.0f*p02 + 2.0f*p10 - 2.0f*p12 -   p20 +   p22 +   p30 -   p32;
-	float a22 =  4*p00 - 4*p01 + 2.0f*p02 - 2.0f*p03 - 4*p10 + 4*p11 - 2.0f*p12 + 2.0f*p13 + 2.0f*p20 - 2.0f*p21 + p22 - p23 - 2.0f*p30 + 2.0f*p31 - p32 + p33;
-	float a23 = -2.0f*p00 + 2.0f*p01 - 2.0f*p02 + 2.0f*p03 + 2.0f*p10 - 2.0f*p11 + 2.0f*p12 - 2.0f*p13 -   p20 +   p21 - p22 + p23 +   p30 -   p31 + p32 - p33;
-	float a30 =   -p01 +   p11 -   p21 +   p31;
-	float a31 =    p00 -   p02 -   p10 +   p12 +   p20 -   p22 -   p30 +   p32;
-	float a32 = -2.0f*p00 + 2.0f*p01 -   p02 +   p03 + 2.0f*p10 - 2.0f*p11 +   p12 -   p13 - 2.0f*p20 + 2.0f*p21 - p22 + p23 + 2.0f*p30 - 2.0f*p31 + p32 - p33;
-	float a33 =    p00 -   p01 +   p02 -   p03 -   p10 +   p11 -   p12 +   p13 +   p20 -   p21 + p22 - p23 -   p30 +   p31 - p32 + p33;
-
-	float out =
-	a00      + a01 * y      + a02 * y2      + a03 * y3 +
-	a10 * x  + a11 * x  * y + a12 * x  * y2 + a13 * x  * y3 +
-	a20 * x2 + a21 * x2 * y + a22 * x2 * y2 + a23 * x2 * y3 +
-	a30 * x3 + a31 * x3 * y + a32 * x3 * y2 + a33 * x3 * y3;
-
-	return std::min(static_cast<size_t>(255), std::max(static_cast<size_t>(out), static_cast<size_t>(0)));
+// separable resampling used by resizeTo() for every method except nearest
+// neighbor: the image is first filtered horizontally into a float buffer
+// and then vertically into the destination, each pass only needs the
+// weights for one axis, computed once per resize instead of per pixel.
+namespace{
+	// source samples and weights that contribute to every destination
+	// sample along one axis, taps entries per destination sample
+	struct ofResizeWeights{
+		size_t taps;
+		std::vector<size_t> indices;
+		std::vector<float> weights;
+	};
+
+	float ofResizeFilterSupport(ofInterpolationMethod method){
+		switch(method){
+		case OF_INTERPOLATE_BICUBIC: return 2;
+		case OF_INTERPOLATE_BILINEAR: return 1;
+		default: return 0.5;
+		}
+	}
+
+	float ofResizeFilter(ofInterpolationMethod method, float x){
+		x = std::abs(x);
+		switch(method){
+		case OF_INTERPOLATE_BICUBIC:
+			// Keys cubic convolution with a = -0.5 (Catmull-Rom)
+			if(x < 1) return (1.5f * x - 2.5f) * x * x + 1;
+			if(x < 2) return ((-0.5f * x + 2.5f) * x - 4) * x + 2;
+			return 0;
+		case OF_INTERPOLATE_BILINEAR:
+			return x < 1 ? 1 - x : 0;
+		default:
+			return x < 0.5f ? 1 : 0;
+		}
+	}
+
+	ofResizeWeights ofResizeComputeWeights(size_t srcSize, size_t dstSize, ofInterpolationMethod method){
+		ofResizeWeights ret;
+		float scale = float(srcSize) / float(dstSize);
+		// when downsampling the filter is stretched to cover all the
+		// source samples under each destination sample to avoid aliasing
+		float filterScale = std::max(scale, 1.f);
+		float support = ofResizeFilterSupport(method) * filterScale;
+		ret.taps = size_t(std::ceil(support * 2)) + 1;
+		ret.indices.resize(dstSize * ret.taps);
+		ret.weights.resize(dstSize * ret.taps);
+
+		for(size_t i = 0; i < dstSize; i++){
+			float center = (i + 0.5f) * scale;
+			int first = int(std::floor(center - support));
+			float total = 0;
+			for(size_t j = 0; j < ret.taps; j++){
+				int src = first + int(j);
+				float w;
+				if(method == OF_INTERPOLATE_AREA){
+					// exact coverage of the source sample by the destination one
+					float lo = std::max(float(src), center - scale * 0.5f);
+					float hi = std::min(float(src + 1), center + scale * 0.5f);
+					w = std::max(hi - lo, 0.f);
+				}else{
+					w = ofResizeFilter(method, (src + 0.5f - center) / filterScale);
+				}
+				ret.indices[i * ret.taps + j] = size_t(std::min(std::max(src, 0), int(srcSize) - 1));
+				ret.weights[i * ret.taps + j] = w;
+				total += w;
+			}
+			if(total != 0){
+				for(size_t j = 0; j < ret.taps; j++){
+					ret.weights[i * ret.taps + j] /= total;
+				}
+			}
+		}
+		return ret;
+	}
+
+	// dst[i] += src[i] * w
+	inline void ofResizeAccumulate(float * dst, const float * src, float w, size_t n){
+		size_t i = 0;
+#if defined(OF_PIXELS_RESIZE_SSE)
+		__m128 w4 = _mm_set1_ps(w);
+		for(; i + 4 <= n; i += 4){
+			_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), w4)));
+		}
+#elif defined(OF_PIXELS_RESIZE_NEON)
+		float32x4_t w4 = vdupq_n_f32(w);
+		for(; i + 4 <= n; i += 4){
+			vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), w4));
+		}
+#endif
+		for(; i < n; i++){
+			dst[i] += src[i] * w;
+		}
+	}
+
+	template<typename PixelType>
+	inline PixelType ofResizeToPixel(float v){
+		if(std::numeric_limits<PixelType>::is_integer){
+			v = std::floor(v + 0.5f);
+			if(v <= float(std::numeric_limits<PixelType>::lowest())) return std::numeric_limits<PixelType>::lowest();
+			if(v >= float(std::numeric_limits<PixelType>::max())) return std::numeric_limits<PixelType>::max();
+		}
+		return PixelType(v);
+	}
+
+	// runs f(begin,end) over numRows split in bands across numThreads threads
+	template<typename Function>
+	void ofResizeParallelRows(size_t numRows, size_t numThreads, Function f){
+		// not worth starting a thread for less than this many rows
+		const size_t minRowsPerThread = 32;
+		numThreads = std::min(numThreads, std::max<size_t>(numRows / minRowsPerThread, 1));
+		if(numThreads <= 1){
+			f(size_t(0), numRows);
+			return;
+		}
+		std::vector<std::thread> threads;
+		size_t band = (numRows + numThreads - 1) / numThreads;
+		for(size_t begin = band; begin < numRows; begin += band){
+			threads.emplace_back(f, begin, std::min(begin + band, numRows));
+		}
+		f(size_t(0), band);
+		for(auto & thread: threads){
+			thread.join();
+		}
+	}
+
+	template<typename PixelType>
+	void ofResizeSeparable(const PixelType * src, size_t srcWidth, size_t srcHeight,
+						   PixelType * dst, size_t dstWidth, size_t dstHeight,
+						   size_t channels, ofInterpolationMethod method, size_t numThreads){
+		ofResizeWeights horizontal = ofResizeComputeWeights(srcWidth, dstWidth, method);
+		ofResizeWeights vertical = ofResizeComputeWeights(srcHeight, dstHeight, method);
+		size_t dstRowSize = dstWidth * channels;
+		std::vector<float> tmp(srcHeight * dstRowSize);
+
+		ofResizeParallelRows(srcHeight, numThreads, [&](size_t begin, size_t end){
+			for(size_t y = begin; y < end; y++){
+				const PixelType * srcRow = src + y * srcWidth * channels;
+				float * tmpRow = &tmp[y * dstRowSize];
+				for(size_t x = 0; x < dstWidth; x++){
+					const size_t * indices = &horizontal.indices[x * horizontal.taps];
+					const float * weights = &horizontal.weights[x * horizontal.taps];
+					for(size_t c = 0; c < channels; c++){
+						float sum = 0;
+						for(size_t j = 0; j < horizontal.taps; j++){
+							sum += srcRow[indices[j] * channels + c] * weights[j];
+						}
+						tmpRow[x * channels + c] = sum;
+					}
+				}
+			}
+		});
+
+		ofResizeParallelRows(dstHeight, numThreads, [&](size_t begin, size_t end){
+			std::vector<float> accum(dstRowSize);
+			for(size_t y = begin; y < end; y++){
+				std::fill(accum.begin(), accum.end(), 0.f);
+				const size_t * indices = &vertical.indices[y * vertical.taps];
+				const float * weights = &vertical.weights[y * vertical.taps];
+				for(size_t j = 0; j < vertical.taps; j++){
+					if(weights[j] != 0){
+						ofResizeAccumulate(accum.data(), &tmp[indices[j] * dstRowSize], weights[j], dstRowSize);
+					}
+				}
+				PixelType * dstRow = dst + y * dstRowSize;
+				for(size_t i = 0; i < dstRowSize; i++){
+					dstRow[i] = ofResizeToPixel<PixelType>(accum[i]);
+				}
+			}
+		});
+	}
 }
 
 //----------------------------------------------------------------------
 template<typename PixelType>
-bool ofPixels_<PixelType>::resizeTo(ofPixels_<PixelType>& dst, ofInterpolationMethod interpMethod) const{
+bool ofPixels_<PixelType>::resizeTo(ofPixels_<PixelType>& dst, ofInterpolationMethod interpMethod, size_t numThreads) const{
 	if(&dst == this){
 		return true;
 	}
@@ -1302,65 +2257,26 @@ bool ofPixels_<PixelType>::resizeTo(ofPixels_<PixelType>& dst, ofInterpolationMe
 
 			//----------------------------------------
 		case OF_INTERPOLATE_BILINEAR:
-			// not implemented yet
-			ofLogError("ofPixels") << "resizeTo(): bilinear resize not implemented, not resizing";
-			break;
-
-			//----------------------------------------
 		case OF_INTERPOLATE_BICUBIC:
-			float px1, py1;
-			float px2, py2;
-			float px3, py3;
-
-			float srcColor = 0;
-			float interpCol;
-			size_t patchRow;
-			size_t patchIndex;
-			float patch[16];
-
-			size_t srcRowBytes = srcWidth*bytesPerPixel;
-			size_t loIndex = (srcRowBytes)+1;
-			size_t hiIndex = (srcWidth*srcHeight*bytesPerPixel)-(srcRowBytes)-1;
-
-			for (size_t dsty=0; dsty<dstHeight; dsty++){
-				for (size_t dstx=0; dstx<dstWidth; dstx++){
-
-					size_t   dstIndex0 = (dsty*dstWidth + dstx) * bytesPerPixel;
-					float srcxf = srcWidth  * (float)dstx/(float)dstWidth;
-					float srcyf = srcHeight * (float)dsty/(float)dstHeight;
-					size_t   srcx = static_cast<size_t>(std::min(srcWidth-1, static_cast<size_t>(srcxf)));
-					size_t   srcy = static_cast<size_t>(std::min(srcHeight-1, static_cast<size_t>(srcyf)));
-					size_t   srcIndex0 = (srcy*srcWidth + srcx) * bytesPerPixel;
-
-					px1 = srcxf - srcx;
-					py1 = srcyf - srcy;
-					px2 = px1 * px1;
-					px3 = px2 * px1;
-					py2 = py1 * py1;
-					py3 = py2 * py1;
-
-					for (size_t k=0; k<bytesPerPixel; k++){
-						size_t   dstIndex = dstIndex0+k;
-						size_t   srcIndex = srcIndex0+k;
-
-						for (size_t dy=0; dy<4; dy++) {
-							patchRow = srcIndex + ((dy-1)*srcRowBytes);
-							for (size_t dx=0; dx<4; dx++) {
-								patchIndex = patchRow + (dx-1)*bytesPerPixel;
-								if ((patchIndex >= loIndex) && (patchIndex < hiIndex)) {
-									srcColor = pixels[patchIndex];
-								}
-								patch[dx*4 + dy] = srcColor;
-							}
-						}
-
-						interpCol = (PixelType)bicubicInterpolate(patch, px1,py1, px2,py2, px3,py3);
-						dstPixels[dstIndex] = interpCol;
-					}
-
-				}
+		case OF_INTERPOLATE_AREA:{
+			switch(getPixelFormat()){
+			case OF_PIXELS_RGB565:
+			case OF_PIXELS_YUY2:
+			case OF_PIXELS_UYVY:
+				ofLogError("ofPixels") << "resizeTo(): filtered resize not supported for packed formats, not resizing";
+				return false;
+			default:
+				break;
 			}
-			break;
+			if(getNumPlanes() != 1 || getNumChannels() != dst.getNumChannels()){
+				ofLogError("ofPixels") << "resizeTo(): filtered resize not supported for planar formats, not resizing";
+				return false;
+			}
+			if(numThreads == 0){
+				numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+			}
+			ofResizeSeparable(pixels, srcWidth, srcHeight, dstPixels, dstWidth, dstHeight, getNumChannels(), interpMethod, numThreads);
+		}break;
 	}
 
 	return true;
@@ -1378,11 +2294,11 @@ bool ofPixels_<PixelType>::pasteInto(ofPixels_<PixelType> &dst, size_t xTo, size
 	size_t srcStride = getWidth()*getBytesPerPixel();
 	size_t dstStride = dst.getWidth()*dst.getBytesPerPixel();
 
-	for(size_t y=0;y<columnsToCopy; y++){
-		memcpy(dstPix,srcPix,bytesToCopyPerRow);
-		dstPix += dstStride;
-		srcPix += srcStride;
-	}
+	of::priv::parallelPixelsFor(columnsToCopy, bytesToCopyPerRow, [&](size_t begin, size_t end){
+		for(size_t y = begin; y < end; y++){
+			memcpy(dstPix + y * dstStride, srcPix + y * srcStride, bytesToCopyPerRow);
+		}
+	});
 
 	return true;
 }
@@ -1399,45 +2315,149 @@ template<typename PixelType>
 bool ofPixels_<PixelType>::blendInto(ofPixels_<PixelType> &dst, size_t xTo, size_t yTo) const{
 	if (!(isAllocated()) || !(dst.isAllocated()) || getBytesPerPixel() != dst.getBytesPerPixel() || xTo + getWidth()>dst.getWidth() || yTo + getHeight()>dst.getHeight() || getNumChannels()==0) return false;
 
-	std::function<void(const ConstPixel&,Pixel&)> blendFunc;
-	switch(getNumChannels()){
-	case 1:
-		blendFunc = [](const ConstPixel&src, Pixel&dst){
-			dst[0] = clampedAdd(src[0], dst[0]);
-		};
-		break;
-	case 2:
-		blendFunc = [](const ConstPixel&src, Pixel&dst){
-			dst[0] = clampedAdd(src[0], dst[0] / ofColor_<PixelType>::limit() * (ofColor_<PixelType>::limit() - src[1]));
-			dst[1] = clampedAdd(src[1], dst[1] / ofColor_<PixelType>::limit() * (ofColor_<PixelType>::limit() - src[1]));
-		};
-		break;
-	case 3:
-		blendFunc = [](const ConstPixel&src, Pixel&dst){
-			dst[0] = clampedAdd(src[0], dst[0]);
-			dst[1] = clampedAdd(src[1], dst[1]);
-			dst[2] = clampedAdd(src[2], dst[2]);
-		};
-		break;
-	case 4:
-		blendFunc = [](const ConstPixel&src, Pixel&dst){
-			dst[0] = clampedAdd(src[0], dst[0] / ofColor_<PixelType>::limit() * (ofColor_<PixelType>::limit() - src[3]));
-			dst[1] = clampedAdd(src[1], dst[1] / ofColor_<PixelType>::limit() * (ofColor_<PixelType>::limit() - src[3]));
-			dst[2] = clampedAdd(src[2], dst[2] / ofColor_<PixelType>::limit() * (ofColor_<PixelType>::limit() - src[3]));
-			dst[3] = clampedAdd(src[3], dst[3] / ofColor_<PixelType>::limit() * (ofColor_<PixelType>::limit() - src[3]));
-		};
-		break;
+	size_t channels = getNumChannels();
+	size_t srcStride = width * channels;
+	size_t dstStride = dst.width * channels;
+	const PixelType * srcPixels = pixels;
+	PixelType * dstPixels = dst.pixels + (yTo * dst.width + xTo) * channels;
+	size_t w = width;
+	const float limit = ofColor_<PixelType>::limit();
+	of::priv::parallelPixelsFor(height, srcStride * sizeof(PixelType), [&](size_t begin, size_t end){
+		for(size_t y = begin; y < end; y++){
+			const PixelType * src = srcPixels + y * srcStride;
+			PixelType * dst = dstPixels + y * dstStride;
+			switch(channels){
+			case 1:
+				for(size_t x = 0; x < w; x++, src += 1, dst += 1){
+					dst[0] = clampedAdd(src[0], dst[0]);
+				}
+				break;
+			case 2:
+				for(size_t x = 0; x < w; x++, src += 2, dst += 2){
+					dst[0] = clampedAdd(src[0], dst[0] / limit * (limit - src[1]));
+					dst[1] = clampedAdd(src[1], dst[1] / limit * (limit - src[1]));
+				}
+				break;
+			case 3:
+				for(size_t x = 0; x < w; x++, src += 3, dst += 3){
+					dst[0] = clampedAdd(src[0], dst[0]);
+					dst[1] = clampedAdd(src[1], dst[1]);
+					dst[2] = clampedAdd(src[2], dst[2]);
+				}
+				break;
+			case 4:
+				for(size_t x = 0; x < w; x++, src += 4, dst += 4){
+					dst[0] = clampedAdd(src[0], dst[0] / limit * (limit - src[3]));
+					dst[1] = clampedAdd(src[1], dst[1] / limit * (limit - src[3]));
+					dst[2] = clampedAdd(src[2], dst[2] / limit * (limit - src[3]));
+					dst[3] = clampedAdd(src[3], dst[3] / limit * (limit - src[3]));
+				}
+				break;
+			}
+		}
+	});
+
+	return true;
+}
+
+//----------------------------------------------------------------------
+template<typename PixelType>
+static inline PixelType ofAverage4(PixelType a, PixelType b, PixelType c, PixelType d){
+	return (int64_t(a) + b + c + d + 2) / 4;
+}
+
+static inline float ofAverage4(float a, float b, float c, float d){
+	return (a + b + c + d) * 0.25f;
+}
+
+static inline double ofAverage4(double a, double b, double c, double d){
+	return (a + b + c + d) * 0.25;
+}
+
+// one row of a 2x2 box filter from rows r0 and r1, the last column is
+// repeated for 1 pixel wide images
+template<typename PixelType>
+static void ofHalveRow(const PixelType * r0, const PixelType * r1, PixelType * dst, size_t x, size_t dstWidth, size_t srcWidth, size_t channels){
+	for(; x < dstWidth; x++){
+		size_t x0 = x * 2 * channels;
+		size_t x1 = std::min(x * 2 + 1, srcWidth - 1) * channels;
+		for(size_t c = 0; c < channels; c++){
+			dst[x * channels + c] = ofAverage4(r0[x0 + c], r0[x1 + c], r1[x0 + c], r1[x1 + c]);
+		}
 	}
-	auto dstLine = dst.getLine(yTo);
-	for(auto line: getConstLines()){
-		auto dstPixel = dstLine.getPixels().begin() + xTo;
-		for(auto p: line.getPixels()){
-			blendFunc(p,dstPixel);
-			dstPixel++;
+}
+
+static void ofHalveRow(const unsigned char * r0, const unsigned char * r1, unsigned char * dst, size_t x, size_t dstWidth, size_t srcWidth, size_t channels){
+#if defined(OF_PIXELS_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+	if(channels == 4){
+		// 4 source pixels of each row to 2 destination pixels
+		for(; x + 2 <= dstWidth && x * 2 + 4 <= srcWidth; x += 2){
+			__m128i a = _mm_loadu_si128((const __m128i*)(r0 + x * 8));
+			__m128i b = _mm_loadu_si128((const __m128i*)(r1 + x * 8));
+			__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+			__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+			lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+			hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+			__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+			_mm_storel_epi64((__m128i*)(dst + x * 4), _mm_packus_epi16(sum, sum));
+		}
+	}else if(channels == 1){
+		// 16 source pixels of each row to 8 destination pixels
+		const __m128i mask = _mm_set1_epi32(0xffff);
+		for(; x + 8 <= dstWidth && x * 2 + 16 <= srcWidth; x += 8){
+			__m128i a = _mm_loadu_si128((const __m128i*)(r0 + x * 2));
+			__m128i b = _mm_loadu_si128((const __m128i*)(r1 + x * 2));
+			__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+			__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+			lo = _mm_and_si128(_mm_add_epi16(lo, _mm_srli_epi32(lo, 16)), mask);
+			hi = _mm_and_si128(_mm_add_epi16(hi, _mm_srli_epi32(hi, 16)), mask);
+			__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_packs_epi32(lo, hi), two), 2);
+			_mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(sum, sum));
+		}
+	}
+#endif
+	for(; x < dstWidth; x++){
+		size_t x0 = x * 2 * channels;
+		size_t x1 = std::min(x * 2 + 1, srcWidth - 1) * channels;
+		for(size_t c = 0; c < channels; c++){
+			dst[x * channels + c] = (r0[x0 + c] + r0[x1 + c] + r1[x0 + c] + r1[x1 + c] + 2) >> 2;
 		}
-		dstLine++;
+	}
+}
+
+//----------------------------------------------------------------------
+template<typename PixelType>
+bool ofPixels_<PixelType>::halveTo(ofPixels_<PixelType> & dst) const{
+	if(!isAllocated()) return false;
+	if(&dst == this){
+		ofLogError("ofPixels") << "halveTo(): can't halve into the same pixels";
+		return false;
+	}
+	if(getNumPlanes() != 1 || pixelFormat == OF_PIXELS_YUY2 || pixelFormat == OF_PIXELS_UYVY){
+		ofLogError("ofPixels") << "halveTo(): not supported for planar or packed formats";
+		return false;
 	}
 
+	size_t srcWidth = width;
+	size_t srcHeight = height;
+	size_t dstWidth = std::max<size_t>(width / 2, 1);
+	size_t dstHeight = std::max<size_t>(height / 2, 1);
+	size_t channels = getNumChannels();
+	dst.allocate(dstWidth, dstHeight, getPixelFormat());
+
+	const PixelType * srcPixels = pixels;
+	PixelType * dstPixels = dst.pixels;
+	size_t srcRow = srcWidth * channels;
+	size_t dstRow = dstWidth * channels;
+	of::priv::parallelPixelsFor(dstHeight, srcRow * 2 * sizeof(PixelType), [&](size_t begin, size_t end){
+		for(size_t y = begin; y < end; y++){
+			const PixelType * r0 = srcPixels + y * 2 * srcRow;
+			const PixelType * r1 = srcPixels + std::min(y * 2 + 1, srcHeight - 1) * srcRow;
+			ofHalveRow(r0, r1, dstPixels + y * dstRow, 0, dstWidth, srcWidth, channels);
+		}
+	});
 	return true;
 }
 
@@ -5,7 +5,9 @@
 #include "ofColor.h"
 #include "ofMath.h"
 #include "ofLog.h"
+#include "ofPixelsPool.h"
 #include <limits>
+#include <functional>
 
 
 /// \file
@@ -52,9 +54,39 @@
 enum ofInterpolationMethod {
 	OF_INTERPOLATE_NEAREST_NEIGHBOR =1,
 	OF_INTERPOLATE_BILINEAR			=2,
-	OF_INTERPOLATE_BICUBIC			=3
+	OF_INTERPOLATE_BICUBIC			=3,
+	OF_INTERPOLATE_AREA				=4
 };
 
+/// \brief Minimum number of bytes an ofPixels operation has to write
+/// before it's split in bands of rows across ofGetTaskPool()
+///
+/// Applies to mirroring, rotating, swapping channels, pasting, blending
+/// and converting between pixel types. 1MB by default, 0 runs everything
+/// in the calling thread.
+void ofSetPixelsParallelThreshold(size_t bytes);
+size_t ofGetPixelsParallelThreshold();
+
+namespace of{
+namespace priv{
+	/// calls f(begin,end) with consecutive ranges of [0,numItems), in
+	/// parallel if numItems * bytesPerItem is over the parallel threshold
+	void parallelPixelsFor(size_t numItems, size_t bytesPerItem, const std::function<void(size_t,size_t)> & f);
+
+	/// vectorized conversions used by ofPixels_::copyFrom between 8 bit,
+	/// 16 bit and float pixels, with the same results as its scalar loop.
+	/// The generic version returns false so other types use that loop
+	template<typename SrcType, typename DstType>
+	inline bool convertPixelType(const SrcType *, DstType *, size_t){ return false; }
+	bool convertPixelType(const unsigned char * src, unsigned short * dst, size_t count);
+	bool convertPixelType(const unsigned char * src, float * dst, size_t count);
+	bool convertPixelType(const unsigned short * src, unsigned char * dst, size_t count);
+	bool convertPixelType(const unsigned short * src, float * dst, size_t count);
+	bool convertPixelType(const float * src, unsigned char * dst, size_t count);
+	bool convertPixelType(const float * src, unsigned short * dst, size_t count);
+}
+}
+
 
 /// \brief A class representing a collection of pixels.
 template <typename PixelType>
@@ -105,6 +137,13 @@ public:
 	/// \param imageType ofImageType defining number of channels per pixel
 	void allocate(size_t w, size_t h, ofImageType imageType);
 
+	/// \brief Allocates space for pixel data from pool
+	///
+	/// The memory goes back to the pool instead of the heap when the
+	/// pixels are cleared or destroyed, and the pixels keep using the pool
+	/// for any later allocation, see ofPixelsPool.
+	void allocate(size_t w, size_t h, ofPixelFormat pixelFormat, ofPixelsPool & pool);
+
 	/// \brief Get whether memory has been allocated for an ofPixels object or not
 	///
 	/// Many operations like copying pixels, etc, automatically allocate
@@ -174,7 +213,12 @@ public:
 	///     OF_INTERPOLATE_NEAREST_NEIGHBOR
 	///     OF_INTERPOLATE_BILINEAR		
 	///     OF_INTERPOLATE_BICUBIC		
-	bool resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR);	
+	///     OF_INTERPOLATE_AREA
+	///
+	/// \param numThreads Number of threads to split the filtered methods
+	/// in, by bands of rows. 0 uses all the hardware threads. Small images
+	/// always use less threads.
+	bool resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR, size_t numThreads=1);
 
 	/// \brief Resize the ofPixels instance to the size of the ofPixels object passed in dst. 
 	///
@@ -183,7 +227,17 @@ public:
 	///     OF_INTERPOLATE_NEAREST_NEIGHBOR
 	///     OF_INTERPOLATE_BILINEAR		
 	///     OF_INTERPOLATE_BICUBIC		
-	bool resizeTo(ofPixels_<PixelType> & dst, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR) const;
+	///     OF_INTERPOLATE_AREA
+	///
+	/// Bilinear, bicubic and area are computed as two separable passes,
+	/// when downsampling the filters are widened to cover all the source
+	/// pixels so they don't alias. Area averages the source pixels covered
+	/// by each destination pixel, the best choice for thumbnails. They only
+	/// work on interleaved formats, not on planar or packed YUV formats.
+	///
+	/// \param numThreads Number of threads to split the filtered methods
+	/// in, by bands of rows. 0 uses all the hardware threads.
+	bool resizeTo(ofPixels_<PixelType> & dst, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR, size_t numThreads=1) const;
 	
 	/// \brief Paste the ofPixels object into another ofPixels object at the
 	/// specified index, copying data from the ofPixels that the method is
@@ -193,10 +247,77 @@ public:
 
 	bool blendInto(ofPixels_<PixelType> &dst, size_t x, size_t y) const;
 
+	/// \brief Downsample to half the width and height with a 2x2 box filter
+	///
+	/// Computes the next level of a mipmap chain, the size is rounded down
+	/// and never less than 1, as in OpenGL, so halving repeatedly down to
+	/// 1x1 gives all the levels to stream with ofTexture::loadMipmapData().
+	/// 8 bit gray and RGBA pixels are averaged with SIMD where available.
+	/// Only works on interleaved formats.
+	///
+	/// \returns false if the pixels are empty or not interleaved
+	bool halveTo(ofPixels_<PixelType> & dst) const;
+
 	/// \brief Swaps the R and B channels of an
 	/// image, leaving the G and A channels as is.
 	void swapRgb();
 
+	/// \}
+	/// \name Color Conversions
+	/// \{
+
+	/// \brief Converts the color channels to hue, saturation and
+	/// brightness in place, in the same scale as ofColor_::getHsb
+	///
+	/// Hue is stored where red was, saturation in green and brightness
+	/// where blue was, alpha is left as is. Only for RGB, BGR, RGBA and
+	/// BGRA pixels.
+	void convertRgbToHsb();
+
+	/// \brief Converts pixels converted with convertRgbToHsb() back to
+	/// the same colors ofColor_::setHsb would give
+	void convertHsbToRgb();
+
+	/// \brief Applies the inverse sRGB transfer function to the color
+	/// channels, leaving alpha as is
+	///
+	/// 8 and 16 bit pixels use a lookup table.
+	void convertSrgbToLinear();
+
+	/// \brief Applies the sRGB transfer function to linear color channels
+	void convertLinearToSrgb();
+
+	/// \brief Multiplies the color channels by alpha, as expected when
+	/// blending with glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA):
+	///
+	/// ~~~~{.cpp}
+	/// ofPixels pixels;
+	/// ofLoadImage(pixels, "matte.png");
+	/// pixels.premultiplyAlpha();
+	/// ~~~~
+	void premultiplyAlpha();
+
+	/// \brief Divides the color channels by alpha, fully transparent
+	/// pixels become black
+	void unpremultiplyAlpha();
+
+	/// \brief Converts NV12, NV21, I420, YV12, YUY2 or UYVY pixels into
+	/// RGB pixels in dst
+	///
+	/// Uses limited range BT.709 for images taller than 576 lines and
+	/// BT.601 for the rest, like the YUV shaders of the programmable
+	/// renderer. Only for 8 bit pixels with even dimensions.
+	///
+	/// \returns false if the format or dimensions aren't supported
+	bool convertYuvToRgb(ofPixels_<PixelType> & dst) const;
+
+	/// \brief Converts RGB, BGR, RGBA or BGRA pixels into NV12 pixels in
+	/// dst, with the same color space rules as convertYuvToRgb()
+	///
+	/// Each chroma sample is the average of a 2x2 block of colors. Only
+	/// for 8 bit pixels with even dimensions.
+	bool convertRgbToNv12(ofPixels_<PixelType> & dst) const;
+
 	/// \}
 	/// \name Pixels Access
 	/// \{
@@ -535,7 +656,6 @@ public:
     /// \endcond
 
 private:
-	static float bicubicInterpolate(const float *patch, float x,float y, float x2,float y2, float x3,float y3);
 
 	void copyFrom( const ofPixels_<PixelType>& mom );
 
@@ -551,6 +671,7 @@ private:
 	bool	bAllocated = false;
 	bool	pixelsOwner = true;			// if set from external data don't delete it
 	ofPixelFormat pixelFormat = OF_PIXELS_UNKNOWN;
+	std::weak_ptr<of::priv::PixelsPoolData> pool; // where the memory goes back to, empty for the heap
 
 };
 
@@ -601,16 +722,24 @@ void ofPixels_<PixelType>::copyFrom(const ofPixels_<SrcType> & mom){
 		const float dstMax = ( (sizeof(PixelType) == sizeof(float) ) ? 1.f : std::numeric_limits<PixelType>::max() );
 		const float factor = dstMax / srcMax;
 
+		const SrcType * src = mom.getData();
+		PixelType * dst = pixels;
 		if(sizeof(SrcType) == sizeof(float)) {
 			// coming from float we need a special case to clamp the values
-			for(size_t i = 0; i < mom.size(); i++){
-				pixels[i] = CLAMP(mom[i], 0, 1) * factor;
-			}
+			of::priv::parallelPixelsFor(mom.size(), sizeof(PixelType), [&](size_t begin, size_t end){
+				if(of::priv::convertPixelType(src + begin, dst + begin, end - begin)) return;
+				for(size_t i = begin; i < end; i++){
+					dst[i] = CLAMP(src[i], 0, 1) * factor;
+				}
+			});
 		} else{
 			// everything else is a straight scaling
-			for(size_t i = 0; i < mom.size(); i++){
-				pixels[i] = mom[i] * factor;
-			}
+			of::priv::parallelPixelsFor(mom.size(), sizeof(PixelType), [&](size_t begin, size_t end){
+				if(of::priv::convertPixelType(src + begin, dst + begin, end - begin)) return;
+				for(size_t i = begin; i < end; i++){
+					dst[i] = src[i] * factor;
+				}
+			});
 		}
 	}
 }
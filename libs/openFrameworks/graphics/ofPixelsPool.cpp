@@ -0,0 +1,185 @@
+#include "ofPixelsPool.h"
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+#ifdef TARGET_LINUX
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+namespace{
+	const size_t pixelsAlignment = 64;
+	const size_t hugePageSize = 2 * 1024 * 1024;
+
+	void * alignedAlloc(size_t bytes, size_t alignment){
+		// rounded up so every path can free it without knowing its size
+		bytes = (bytes + alignment - 1) / alignment * alignment;
+#ifdef TARGET_WIN32
+		return _aligned_malloc(bytes, alignment);
+#else
+		void * data = nullptr;
+		if(posix_memalign(&data, alignment, bytes) != 0){
+			return nullptr;
+		}
+		return data;
+#endif
+	}
+
+	void alignedFree(void * data){
+#ifdef TARGET_WIN32
+		_aligned_free(data);
+#else
+		free(data);
+#endif
+	}
+
+	void * allocatePixels(size_t bytes, bool useHugePages){
+		if(useHugePages && bytes >= hugePageSize){
+			void * data = alignedAlloc(bytes, hugePageSize);
+#ifdef TARGET_LINUX
+			if(data){
+				size_t length = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+				madvise(data, length, MADV_HUGEPAGE);
+			}
+#endif
+			return data;
+		}
+		return alignedAlloc(bytes, pixelsAlignment);
+	}
+}
+
+struct of::priv::PixelsPoolData{
+	mutable std::mutex mutex;
+	unordered_map<size_t, vector<void*>> free;
+	uint64_t freeBytes = 0;
+	size_t numFree = 0;
+	uint64_t maxFreeBytes = 512 * 1024 * 1024;
+	bool useHugePages = false;
+
+	~PixelsPoolData(){
+		clear();
+	}
+
+	void clear(){
+		for(auto & buffers: free){
+			for(auto data: buffers.second){
+				alignedFree(data);
+			}
+		}
+		free.clear();
+		freeBytes = 0;
+		numFree = 0;
+	}
+};
+
+//----------------------------------------------------------
+void * of::priv::acquirePixels(const weak_ptr<PixelsPoolData> & weakPool, size_t bytes){
+	bool useHugePages = false;
+	auto pool = weakPool.lock();
+	if(pool){
+		std::lock_guard<std::mutex> lock(pool->mutex);
+		auto buffers = pool->free.find(bytes);
+		if(buffers != pool->free.end() && !buffers->second.empty()){
+			void * data = buffers->second.back();
+			buffers->second.pop_back();
+			pool->freeBytes -= bytes;
+			pool->numFree--;
+			return data;
+		}
+		useHugePages = pool->useHugePages;
+	}
+	void * data = allocatePixels(bytes, useHugePages);
+	if(!data){
+		throw std::bad_alloc();
+	}
+	return data;
+}
+
+//----------------------------------------------------------
+void of::priv::releasePixels(const weak_ptr<PixelsPoolData> & weakPool, void * data, size_t bytes){
+	if(!data){
+		return;
+	}
+	auto pool = weakPool.lock();
+	if(pool){
+		std::lock_guard<std::mutex> lock(pool->mutex);
+		if(pool->freeBytes + bytes <= pool->maxFreeBytes){
+			pool->free[bytes].push_back(data);
+			pool->freeBytes += bytes;
+			pool->numFree++;
+			return;
+		}
+	}
+	alignedFree(data);
+}
+
+//----------------------------------------------------------
+ofPixelsPool::ofPixelsPool()
+:data(make_shared<of::priv::PixelsPoolData>()){}
+
+//----------------------------------------------------------
+ofPixelsPool::~ofPixelsPool(){}
+
+//----------------------------------------------------------
+void ofPixelsPool::setMaxFreeBytes(uint64_t bytes){
+	std::lock_guard<std::mutex> lock(data->mutex);
+	data->maxFreeBytes = bytes;
+	// the buffers over the new limit are freed, the biggest first
+	while(data->freeBytes > data->maxFreeBytes){
+		auto biggest = data->free.end();
+		for(auto it = data->free.begin(); it != data->free.end(); ++it){
+			if(!it->second.empty() && (biggest == data->free.end() || it->first > biggest->first)){
+				biggest = it;
+			}
+		}
+		alignedFree(biggest->second.back());
+		biggest->second.pop_back();
+		data->freeBytes -= biggest->first;
+		data->numFree--;
+	}
+}
+
+//----------------------------------------------------------
+uint64_t ofPixelsPool::getMaxFreeBytes() const{
+	std::lock_guard<std::mutex> lock(data->mutex);
+	return data->maxFreeBytes;
+}
+
+//----------------------------------------------------------
+void ofPixelsPool::setUseHugePages(bool useHugePages){
+	std::lock_guard<std::mutex> lock(data->mutex);
+	data->useHugePages = useHugePages;
+}
+
+//----------------------------------------------------------
+bool ofPixelsPool::isUsingHugePages() const{
+	std::lock_guard<std::mutex> lock(data->mutex);
+	return data->useHugePages;
+}
+
+//----------------------------------------------------------
+uint64_t ofPixelsPool::getFreeBytes() const{
+	std::lock_guard<std::mutex> lock(data->mutex);
+	return data->freeBytes;
+}
+
+//----------------------------------------------------------
+size_t ofPixelsPool::getNumFree() const{
+	std::lock_guard<std::mutex> lock(data->mutex);
+	return data->numFree;
+}
+
+//----------------------------------------------------------
+void ofPixelsPool::clear(){
+	std::lock_guard<std::mutex> lock(data->mutex);
+	data->clear();
+}
+
+//----------------------------------------------------------
+ofPixelsPool & ofGetPixelsPool(){
+	static ofPixelsPool pool;
+	return pool;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <memory>
+
+template<typename PixelType>
+class ofPixels_;
+
+namespace of{
+namespace priv{
+	struct PixelsPoolData;
+
+	/// \brief Memory for bytes of pixels, 64 bytes aligned, recycled from
+	/// pool if it's alive and has a free buffer of that size
+	void * acquirePixels(const std::weak_ptr<PixelsPoolData> & pool, std::size_t bytes);
+
+	/// \brief Gives memory from acquirePixels() back to pool, or to the
+	/// heap if the pool is gone or full
+	void releasePixels(const std::weak_ptr<PixelsPoolData> & pool, void * data, std::size_t bytes);
+}
+}
+
+/// \brief Recycles the memory of ofPixels that are allocated and freed over
+/// and over with the same size, like video frames
+///
+/// Pixels allocated from a pool give their memory back to it, instead of
+/// the heap, when they are cleared, allocated with a different size or
+/// destroyed. The next pixels allocated with the same size get that buffer
+/// back without touching the heap or faulting in new pages:
+///
+/// ~~~~{.cpp}
+/// // in the thread that decodes the frames
+/// ofPixels frame;
+/// frame.allocate(3840, 2160, OF_PIXELS_RGBA, ofGetPixelsPool());
+/// decodeFrame(frame);
+/// channel.send(std::move(frame));
+///
+/// // in the main thread, the memory goes back to the pool once the frame
+/// // is uploaded and destroyed
+/// ofPixels frame;
+/// if(channel.tryReceive(frame)){
+///     texture.loadData(frame);
+/// }
+/// ~~~~
+///
+/// Once allocated from a pool, pixels keep using it for every allocation,
+/// also the ones done internally by resize() or rotate90(). Buffers are
+/// reused by their size in bytes so formats of the same size share them.
+///
+/// The pool is thread safe and pixels can outlive it, their memory is
+/// freed instead of returned if it's gone. All the memory owned by ofPixels
+/// is 64 bytes aligned, pooled or not.
+class ofPixelsPool{
+public:
+	ofPixelsPool();
+	~ofPixelsPool();
+
+	ofPixelsPool(const ofPixelsPool &) = delete;
+	ofPixelsPool & operator=(const ofPixelsPool &) = delete;
+
+	/// \brief Bytes of free buffers the pool keeps, 512MB by default,
+	/// buffers given back once it's full are freed
+	void setMaxFreeBytes(uint64_t bytes);
+	uint64_t getMaxFreeBytes() const;
+
+	/// \brief Allocates the buffers of 2MB or more aligned to huge pages,
+	/// off by default
+	///
+	/// On linux they are marked for transparent huge pages, which cuts
+	/// the page faults and TLB misses of 4K frames, elsewhere the buffers
+	/// are only aligned.
+	void setUseHugePages(bool useHugePages);
+	bool isUsingHugePages() const;
+
+	/// \brief Bytes of the buffers waiting in the pool to be reused
+	uint64_t getFreeBytes() const;
+
+	/// \brief Number of buffers waiting in the pool to be reused
+	std::size_t getNumFree() const;
+
+	/// \brief Frees all the buffers waiting in the pool
+	void clear();
+
+private:
+	template<typename PixelType>
+	friend class ofPixels_;
+
+	std::shared_ptr<of::priv::PixelsPoolData> data;
+};
+
+/// \brief A pool shared by the whole application
+ofPixelsPool & ofGetPixelsPool();
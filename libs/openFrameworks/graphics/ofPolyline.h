@@ -1,6 +1,8 @@
 #pragma once
 #include "ofConstants.h"
 #include <deque>
+#include <functional>
+#include <limits>
 
 /// \file 
 /// ofPolyLine allows you to combine multiple points into a single vector data
@@ -321,6 +323,20 @@ public:
 	/// box window (1) or something in between (for example, .5).
 	ofPolyline_ getSmoothed(int smoothingSize, float smoothingShape = 0) const;
 
+	/// \brief Smooths the ofPolyline into result, reusing its memory
+	///
+	/// Same as getSmoothed() but a result kept between frames doesn't
+	/// allocate once it's big enough:
+	///
+	/// ~~~~{.cpp}
+	/// // ofApp.h
+	/// ofPolyline smoothed;
+	///
+	/// // update
+	/// line.getSmoothed(5, 0, smoothed);
+	/// ~~~~
+	void getSmoothed(int smoothingSize, float smoothingShape, ofPolyline_ & result) const;
+
 	/// \brief Resamples the line based on the spacing passed in. The larger the
 	/// spacing, the more points will be eliminated.
 	/// 
@@ -330,14 +346,24 @@ public:
 	/// line.getResampledBySpacing(100).draw();
 	/// ~~~~
 	/// ![polyline resample](graphics/resample.jpg)
+	///
+	/// The lengths along the line are cached, vertices added at the end with
+	/// addVertex() or lineTo() only measure the new segments, so resampling
+	/// a line that's being drawn doesn't measure it all again every frame.
 	ofPolyline_ getResampledBySpacing(float spacing) const;
 
+	/// \brief Resamples the line into result, reusing its memory
+	void getResampledBySpacing(float spacing, ofPolyline_ & result) const;
+
 	/// \brief Resamples the line based on the count passed in. The lower the
 	/// count passed in, the more points will be eliminated. 
 	///
 	/// This doesn't add new points to the line.
 	ofPolyline_ getResampledByCount(int count) const;
 
+	/// \brief Resamples the line into result, reusing its memory
+	void getResampledByCount(int count, ofPolyline_ & result) const;
+
     /// \brief Simplifies the polyline, removing un-necessary vertices. 
     ///
     /// \param tolerance determines how dis-similar points need to be to stay in the line.
@@ -345,6 +371,12 @@ public:
     /// points removed.
 	void simplify(float tolerance=0.3f);
 
+	/// \brief Gets a simplified version of the ofPolyline, see simplify()
+	ofPolyline_ getSimplified(float tolerance=0.3f) const;
+
+	/// \brief Simplifies the ofPolyline into result, reusing its memory
+	void getSimplified(float tolerance, ofPolyline_ & result) const;
+
 	/// \}
 	/// \name Polyline State
 	/// \{
@@ -396,6 +428,16 @@ public:
 	/// optionally pass a pointer to/address of an unsigned int to get the
 	/// index of the closest vertex	
 	T getClosestPoint(const T& target, unsigned int* nearestIndex = nullptr) const;
+
+	/// \brief Keeps a grid of the segments of the polyline in the xy plane
+	/// to speed up getClosestPoint() and inside()
+	///
+	/// The grid is built the first time it's needed and kept until the
+	/// polyline changes, so it's worth it when the same polyline is tested
+	/// against many points, like hit testing contours every frame. Disabled
+	/// by default.
+	void setUseSpatialIndex(bool useIndex);
+	bool getUseSpatialIndex() const;
 	
 
 	/// \}
@@ -517,6 +559,30 @@ private:
     mutable bool bCacheIsDirty;   // used only internally, no public API to read
     
     void updateCache(bool bForceUpdate = false) const;
+
+	// lengths are kept for the first numLengthsValid points, appending
+	// vertices only measures the new ones
+	mutable std::size_t numLengthsValid;
+	void updateLengths() const;
+	void flagHasAppended();
+
+	// uniform grid with the segments overlapping every cell, columns x rows
+	// cells stored row by row, and the segments overlapping every row
+	struct SpatialIndex{
+		glm::vec2 origin;
+		float cellSize = 1;
+		int columns = 0;
+		int rows = 0;
+		std::vector<unsigned int> cellStart;
+		std::vector<unsigned int> cellSegments;
+		std::vector<unsigned int> rowStart;
+		std::vector<unsigned int> rowSegments;
+	};
+	mutable SpatialIndex spatialIndex;
+	mutable bool bSpatialIndexDirty;
+	bool bUseSpatialIndex;
+
+	void updateSpatialIndex() const;
     
     // given an interpolated index (e.g. 5.75) return neighboring indices and interolation factor (e.g. 5, 6, 0.75)
     void getInterpolationParams(float findex, int &i1, int &i2, float &t) const;
@@ -524,6 +590,42 @@ private:
 	void calcData(int index, T &tangent, float &angle, T &rotation, T &normal) const;
 };
 
+/// \name Batches of polylines
+/// \{
+
+/// \brief Smooths every polyline into results, in parallel on the task pool
+///
+/// results is resized to the number of polylines and the polylines in it
+/// are reused, keeping it between frames avoids allocating for every
+/// contour:
+///
+/// ~~~~{.cpp}
+/// // ofApp.h
+/// std::vector<ofPolyline> smoothed;
+///
+/// // update
+/// ofGetSmoothed(contourFinder.getPolylines(), 5, 0, smoothed);
+/// ~~~~
+template<class T>
+void ofGetSmoothed(const std::vector<ofPolyline_<T>> & polylines, int smoothingSize, float smoothingShape, std::vector<ofPolyline_<T>> & results);
+
+/// \brief Resamples every polyline into results, in parallel on the task
+/// pool, see ofGetSmoothed()
+template<class T>
+void ofGetResampledBySpacing(const std::vector<ofPolyline_<T>> & polylines, float spacing, std::vector<ofPolyline_<T>> & results);
+
+/// \brief Resamples every polyline into results, in parallel on the task
+/// pool, see ofGetSmoothed()
+template<class T>
+void ofGetResampledByCount(const std::vector<ofPolyline_<T>> & polylines, int count, std::vector<ofPolyline_<T>> & results);
+
+/// \brief Simplifies every polyline into results, in parallel on the task
+/// pool, see ofGetSmoothed()
+template<class T>
+void ofGetSimplified(const std::vector<ofPolyline_<T>> & polylines, float tolerance, std::vector<ofPolyline_<T>> & results);
+
+/// \}
+
 #include "ofPolyline.inl"
 
 using ofPolyline = ofPolyline_<ofDefaultVertexType>;
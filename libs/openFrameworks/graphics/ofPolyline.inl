@@ -2,11 +2,13 @@
 #include "ofAppRunner.h"
 #include "ofPolyline.h"
 #include "ofVectorMath.h"
+#include "ofTaskPool.h"
 
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T>::ofPolyline_(){
     setRightVector();
+	bUseSpatialIndex = false;
 	clear();
 }
 
@@ -14,6 +16,7 @@ ofPolyline_<T>::ofPolyline_(){
 template<class T>
 ofPolyline_<T>::ofPolyline_(const std::vector<T>& verts){
     setRightVector();
+	bUseSpatialIndex = false;
 	clear();
 	addVertices(verts);
 }
@@ -44,15 +47,13 @@ template<class T>
 void ofPolyline_<T>::addVertex(const T& p) {
 	curveVertices.clear();
 	points.push_back(p);
-    flagHasChanged();
+    flagHasAppended();
 }
 
 //----------------------------------------------------------
 template<class T>
 void ofPolyline_<T>::addVertex(float x, float y, float z) {
-	curveVertices.clear();
 	addVertex(T(x,y,z));
-    flagHasChanged();
 }
 
 //----------------------------------------------------------
@@ -60,7 +61,7 @@ template<class T>
 void ofPolyline_<T>::addVertices(const std::vector<T>& verts) {
 	curveVertices.clear();
 	points.insert( points.end(), verts.begin(), verts.end() );
-    flagHasChanged();
+    flagHasAppended();
 }
 
 //----------------------------------------------------------
@@ -68,7 +69,7 @@ template<class T>
 void ofPolyline_<T>::addVertices(const T* verts, int numverts) {
 	curveVertices.clear();
 	points.insert( points.end(), verts, verts + numverts );
-    flagHasChanged();
+    flagHasAppended();
 }
 
 //----------------------------------------------------------
@@ -145,8 +146,16 @@ bool ofPolyline_<T>::hasChanged(){
 //----------------------------------------------------------
 template<class T>
 void ofPolyline_<T>::flagHasChanged() {
+    flagHasAppended();
+    numLengthsValid = 0;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::flagHasAppended() {
     bHasChanged = true;
     bCacheIsDirty = true;
+    bSpatialIndexDirty = true;
 }
 
 //----------------------------------------------------------
@@ -411,7 +420,7 @@ float ofPolyline_<T>::getPerimeter() const {
     if(points.size() < 2) {
         return 0;
     } else {
-        updateCache();
+        updateLengths();
         return lengths.back();
     }
 }
@@ -448,25 +457,36 @@ ofRectangle ofPolyline_<T>::getBoundingBox() const {
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T> ofPolyline_<T>::getSmoothed(int smoothingSize, float smoothingShape) const {
+	ofPolyline_ result = *this;
+	getSmoothed(smoothingSize, smoothingShape, result);
+	return result;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getSmoothed(int smoothingSize, float smoothingShape, ofPolyline_ & result) const {
+	if(&result == this) {
+		// every point needs its neighbours before they were smoothed
+		ofPolyline_ source = *this;
+		source.getSmoothed(smoothingSize, smoothingShape, result);
+		return;
+	}
+
 	int n = size();
 	smoothingSize = ofClamp(smoothingSize, 0, n);
 	smoothingShape = ofClamp(smoothingShape, 0, 1);
-	
-	// precompute weights and normalization
-	std::vector<float> weights;
-	weights.resize(smoothingSize);
-	// side weights
-	for(int i = 1; i < smoothingSize; i++) {
-		float curWeight = ofMap(i, 0, smoothingSize, 1, smoothingShape);
-		weights[i] = curWeight;
-	}
-	
-	// make a copy of this polyline
-	ofPolyline_ result = *this;
-	
+
+	result.points.resize(n);
+	result.curveVertices.clear();
+	result.bClosed = bClosed;
+	result.rightVector = rightVector;
+
 	for(int i = 0; i < n; i++) {
+		T smoothed = points[i];
 		float sum = 1; // center weight
 		for(int j = 1; j < smoothingSize; j++) {
+			// side weights, the same as ofMap(j, 0, smoothingSize, 1, smoothingShape)
+			float weight = float(j) / smoothingSize * (smoothingShape - 1) + 1;
 			T cur;
 			int leftPosition = i - j;
 			int rightPosition = i + j;
@@ -475,52 +495,84 @@ ofPolyline_<T> ofPolyline_<T>::getSmoothed(int smoothingSize, float smoothingSha
 			}
 			if(leftPosition >= 0) {
 				cur += points[leftPosition];
-				sum += weights[j];
+				sum += weight;
 			}
 			if(rightPosition >= n && bClosed) {
 				rightPosition -= n;
 			}
 			if(rightPosition < n) {
 				cur += points[rightPosition];
-				sum += weights[j];
+				sum += weight;
 			}
-			result[i] += cur * weights[j];
+			smoothed += cur * weight;
 		}
-		result[i] /= sum;
+		result.points[i] = smoothed / sum;
 	}
-	
-	return result;
+	result.flagHasChanged();
 }
 
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T> ofPolyline_<T>::getResampledBySpacing(float spacing) const {
-    if(spacing==0 || size() == 0) return *this;
 	ofPolyline_ poly;
-    float totalLength = getPerimeter();
-    for(float f=0; f<totalLength; f += spacing) {
-        poly.lineTo(getPointAtLength(f));
-    }
-    
-    if(!isClosed()) {
-        if(poly.size() > 0) poly.points.back() = points.back();
-        poly.setClosed(false);
-    } else {
-        poly.setClosed(true);
-    }
-    
-    return poly;
+	getResampledBySpacing(spacing, poly);
+	return poly;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getResampledBySpacing(float spacing, ofPolyline_ & result) const {
+	if(&result == this) {
+		ofPolyline_ source = *this;
+		source.getResampledBySpacing(spacing, result);
+		return;
+	}
+	if(spacing==0 || size() == 0) {
+		result = *this;
+		return;
+	}
+
+	result.points.clear();
+	result.curveVertices.clear();
+	float totalLength = getPerimeter();
+
+	// the samples are in order so the segment they fall in only moves
+	// forward, no need to search the lengths for every one of them
+	size_t segment = 0;
+	for(float f=0; f<totalLength; f += spacing) {
+		while(segment + 2 < lengths.size() && lengths[segment + 1] <= f) {
+			segment++;
+		}
+		float distAt1 = lengths[segment];
+		float distAt2 = lengths[segment + 1];
+		float t = distAt2 <= distAt1 ? 0 : ofMap(f, distAt1, distAt2, 0, 1);
+		result.points.push_back(glm::lerp(toGlm(points[segment]), toGlm(points[getWrappedIndex(segment + 1)]), t));
+	}
+
+	if(!isClosed()) {
+		if(result.size() > 0) result.points.back() = points.back();
+	}
+	result.bClosed = isClosed();
+	result.flagHasChanged();
 }
 
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T> ofPolyline_<T>::getResampledByCount(int count) const {
+	ofPolyline_ poly;
+	getResampledByCount(count, poly);
+	return poly;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getResampledByCount(int count, ofPolyline_ & result) const {
 	float perimeter = getPerimeter();
 	if(count < 2) {
 		ofLogWarning("ofPolyline_") << "getResampledByCount(): requested " << count <<" points, using minimum count of 2 ";
 		count = 2;
     }
-	return ofPolyline_<T>::getResampledBySpacing(perimeter / (count-1));
+	getResampledBySpacing(perimeter / (count-1), result);
 }
 
 //----------------------------------------------------------
@@ -575,8 +627,8 @@ T ofPolyline_<T>::getClosestPoint(const T& target, unsigned int* nearestIndex) c
 	if(polyline.isClosed()) {
 		lastPosition++;
 	}
-	for(int i = 0; i < (int) lastPosition; i++) {
-		bool repeatNext = i == (int) (polyline.size() - 1);
+	auto testSegment = [&](unsigned int i, bool first){
+		bool repeatNext = i == polyline.size() - 1;
 		
 		const auto& cur = polyline[i];
 		const auto& next = repeatNext ? polyline[0] : polyline[i + 1];
@@ -584,12 +636,51 @@ T ofPolyline_<T>::getClosestPoint(const T& target, unsigned int* nearestIndex) c
 		float curNormalizedPosition = 0;
 		auto curNearestPoint = getClosestPointUtil(cur, next, target, &curNormalizedPosition);
 		float curDistance = glm::distance(toGlm(curNearestPoint), toGlm(target));
-		if(i == 0 || curDistance < distance) {
+		// on ties keep the first segment, the same as testing all of them in order
+		if(first || curDistance < distance || (curDistance == distance && i < nearest)) {
 			distance = curDistance;
 			nearest = i;
 			nearestPoint = curNearestPoint;
 			normalizedPosition = curNormalizedPosition;
 		}
+	};
+
+	if(bUseSpatialIndex){
+		updateSpatialIndex();
+		const auto & index = spatialIndex;
+		int cx = ofClamp(int(floor((target.x - index.origin.x) / index.cellSize)), 0, index.columns - 1);
+		int cy = ofClamp(int(floor((target.y - index.origin.y) / index.cellSize)), 0, index.rows - 1);
+		bool found = false;
+		int maxRing = std::max(index.columns, index.rows);
+		for(int ring = 0; ring <= maxRing; ring++){
+			for(int y = std::max(cy - ring, 0); y <= std::min(cy + ring, index.rows - 1); y++){
+				bool borderRow = y == cy - ring || y == cy + ring;
+				for(int x = std::max(cx - ring, 0); x <= std::min(cx + ring, index.columns - 1); x++){
+					if(!borderRow && x != cx - ring && x != cx + ring) continue;
+					int cell = y * index.columns + x;
+					for(unsigned int k = index.cellStart[cell]; k < index.cellStart[cell + 1]; k++){
+						unsigned int i = index.cellSegments[k];
+						if(i >= lastPosition) continue;
+						testSegment(i, !found);
+						found = true;
+					}
+				}
+			}
+			if(found){
+				// the segments not tested yet are all out of the cells
+				// around the target up to this ring
+				float bound = std::numeric_limits<float>::max();
+				if(cx - ring > 0) bound = std::min(bound, target.x - (index.origin.x + (cx - ring) * index.cellSize));
+				if(cx + ring < index.columns - 1) bound = std::min(bound, index.origin.x + (cx + ring + 1) * index.cellSize - target.x);
+				if(cy - ring > 0) bound = std::min(bound, target.y - (index.origin.y + (cy - ring) * index.cellSize));
+				if(cy + ring < index.rows - 1) bound = std::min(bound, index.origin.y + (cy + ring + 1) * index.cellSize - target.y);
+				if(bound >= distance) break;
+			}
+		}
+	}else{
+		for(unsigned int i = 0; i < lastPosition; i++) {
+			testSegment(i, i == 0);
+		}
 	}
 	
 	if(nearestIndex != nullptr) {
@@ -605,36 +696,168 @@ T ofPolyline_<T>::getClosestPoint(const T& target, unsigned int* nearestIndex) c
 	return nearestPoint;
 }
 
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::setUseSpatialIndex(bool useIndex){
+	bUseSpatialIndex = useIndex;
+	if(!useIndex){
+		spatialIndex = SpatialIndex();
+		bSpatialIndexDirty = true;
+	}
+}
+
+//----------------------------------------------------------
+template<class T>
+bool ofPolyline_<T>::getUseSpatialIndex() const{
+	return bUseSpatialIndex;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::updateSpatialIndex() const{
+	if(!bSpatialIndexDirty) return;
+	bSpatialIndexDirty = false;
+
+	auto & index = spatialIndex;
+	index = SpatialIndex();
+	// inside() always uses the closing segment, getClosestPoint() skips it
+	// if the polyline is open
+	std::size_t numSegments = points.size();
+	if(numSegments < 2) return;
+
+	glm::vec2 min(points[0].x, points[0].y);
+	glm::vec2 max = min;
+	for(auto & p: points){
+		min = glm::min(min, glm::vec2(p.x, p.y));
+		max = glm::max(max, glm::vec2(p.x, p.y));
+	}
+
+	// about 4 segments per cell, contours leave most cells empty and
+	// smaller cells make the search for the closest point visit too many
+	glm::vec2 size = max - min;
+	float area = size.x * size.y;
+	float cellSize = area > 0 ? sqrt(area * 4 / numSegments) : std::max(size.x, size.y) * 4 / numSegments;
+	cellSize = std::max(cellSize, std::max(size.x, size.y) / 1024.f);
+	if(cellSize <= 0) cellSize = 1;
+	index.origin = min;
+	index.cellSize = cellSize;
+	index.columns = ofClamp(int(size.x / cellSize) + 1, 1, 1025);
+	index.rows = ofClamp(int(size.y / cellSize) + 1, 1, 1025);
+
+	auto column = [&](float x){
+		return ofClamp(int(floor((x - index.origin.x) / cellSize)), 0, index.columns - 1);
+	};
+	auto row = [&](float y){
+		return ofClamp(int(floor((y - index.origin.y) / cellSize)), 0, index.rows - 1);
+	};
+
+	// calls f(row, firstColumn, lastColumn) for every row the segment
+	// crosses with the columns it covers in that row
+	auto rasterize = [&](std::size_t i, const std::function<void(int, int, int)> & f){
+		const auto & a = points[i];
+		const auto & b = points[(i + 1) % numSegments];
+		int r0 = row(std::min(a.y, b.y));
+		int r1 = row(std::max(a.y, b.y));
+		for(int r = r0; r <= r1; r++){
+			float x0, x1;
+			if(r0 == r1){
+				x0 = a.x;
+				x1 = b.x;
+			}else{
+				float bandBegin = index.origin.y + r * cellSize;
+				float bandEnd = bandBegin + cellSize;
+				float t0 = ofClamp((bandBegin - a.y) / (b.y - a.y), 0, 1);
+				float t1 = ofClamp((bandEnd - a.y) / (b.y - a.y), 0, 1);
+				x0 = ofLerp(a.x, b.x, t0);
+				x1 = ofLerp(a.x, b.x, t1);
+			}
+			f(r, column(std::min(x0, x1)), column(std::max(x0, x1)));
+		}
+	};
+
+	std::size_t numCells = index.columns * index.rows;
+	index.cellStart.assign(numCells + 1, 0);
+	index.rowStart.assign(index.rows + 1, 0);
+	for(std::size_t i = 0; i < numSegments; i++){
+		rasterize(i, [&](int r, int c0, int c1){
+			index.rowStart[r + 1]++;
+			for(int c = c0; c <= c1; c++){
+				index.cellStart[r * index.columns + c + 1]++;
+			}
+		});
+	}
+	for(std::size_t i = 0; i < numCells; i++){
+		index.cellStart[i + 1] += index.cellStart[i];
+	}
+	for(int r = 0; r < index.rows; r++){
+		index.rowStart[r + 1] += index.rowStart[r];
+	}
+
+	index.cellSegments.resize(index.cellStart.back());
+	index.rowSegments.resize(index.rowStart.back());
+	std::vector<unsigned int> cellNext(index.cellStart.begin(), index.cellStart.end() - 1);
+	std::vector<unsigned int> rowNext(index.rowStart.begin(), index.rowStart.end() - 1);
+	for(std::size_t i = 0; i < numSegments; i++){
+		rasterize(i, [&](int r, int c0, int c1){
+			index.rowSegments[rowNext[r]++] = i;
+			for(int c = c0; c <= c1; c++){
+				index.cellSegments[cellNext[r * index.columns + c]++] = i;
+			}
+		});
+	}
+}
+
 //--------------------------------------------------
 template<class T>
 bool ofPolyline_<T>::inside(const T & p, const ofPolyline_ & polyline){
 	return ofPolyline_<T>::inside(p.x,p.y,polyline);
 }
 
+//--------------------------------------------------
+// whether a ray from x,y to the right crosses the segment p1, p2
+template<class T>
+inline bool crossesRayUtil(float x, float y, const T& p1, const T& p2) {
+	if (y > MIN(p1.y,p2.y)) {
+		if (y <= MAX(p1.y,p2.y)) {
+			if (x <= MAX(p1.x,p2.x)) {
+				if (p1.y != p2.y) {
+					double xinters = (y-p1.y)*(p2.x-p1.x)/(p2.y-p1.y)+p1.x;
+					if (p1.x == p2.x || x <= xinters)
+						return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
 //--------------------------------------------------
 template<class T>
 bool ofPolyline_<T>::inside(float x, float y, const ofPolyline_ & polyline){
 	int counter = 0;
 	int i;
-	double xinters;
-	T p1,p2;
     
 	int N = polyline.size();
+
+	if(polyline.bUseSpatialIndex && N >= 2){
+		// only the segments in the row of y can cross the ray
+		polyline.updateSpatialIndex();
+		const auto & index = polyline.spatialIndex;
+		if(y < index.origin.y || y > index.origin.y + index.rows * index.cellSize) return false;
+		int row = ofClamp(int(floor((y - index.origin.y) / index.cellSize)), 0, index.rows - 1);
+		for(unsigned int k = index.rowStart[row]; k < index.rowStart[row + 1]; k++){
+			unsigned int s = index.rowSegments[k];
+			if(crossesRayUtil(x, y, polyline.points[s], polyline.points[(s + 1) % N]))
+				counter++;
+		}
+		return counter % 2 != 0;
+	}
     
-	p1 = polyline[0];
+	T p1 = polyline[0];
 	for (i=1;i<=N;i++) {
-		p2 = polyline[i % N];
-		if (y > MIN(p1.y,p2.y)) {
-            if (y <= MAX(p1.y,p2.y)) {
-                if (x <= MAX(p1.x,p2.x)) {
-                    if (p1.y != p2.y) {
-                        xinters = (y-p1.y)*(p2.x-p1.x)/(p2.y-p1.y)+p1.x;
-                        if (p1.x == p2.x || x <= xinters)
-                            counter++;
-                    }
-                }
-            }
-		}
+		T p2 = polyline[i % N];
+		if (crossesRayUtil(x, y, p1, p2))
+			counter++;
 		p1 = p2;
 	}
     
@@ -734,26 +957,18 @@ void ofPolyline_<T>::simplify(float tol){
     if(points.size() < 2) return;
     
 	int n = size();
-	
-	if(n == 0) {
-		return;
-	}
 
-	std::vector <T> sV;
-	sV.resize(n);
-    
     int    i, k, m, pv;            // misc counters
     float  tol2 = tol * tol;       // tolerance squared
-    std::vector<T> vt;
-    std::vector<int> mk;
-    vt.resize(n);
-	mk.resize(n,0);
-    
-    
+
+    // both stages only drop vertices so they run in place, the vertex
+    // written is never after the one being read
+    std::vector<T> & vt = points;
+    thread_local std::vector<int> mk;
+
     // STAGE 1.  Vertex Reduction within tolerance of prior vertex cluster
-    vt[0] = points[0];              // start at the beginning
     for (i=k=1, pv=0; i<n; i++) {
-		if (glm::length2((const glm::vec3&)points[i] - (const glm::vec3&)points[pv]) < tol2) continue;
+		if (glm::length2((const glm::vec3&)points[i] - (const glm::vec3&)vt[k-1]) < tol2) continue;
         
         vt[k++] = points[i];
         pv = i;
@@ -761,21 +976,36 @@ void ofPolyline_<T>::simplify(float tol){
     if (pv < n-1) vt[k++] = points[n-1];      // finish at the end
     
     // STAGE 2.  Douglas-Peucker polyline simplification
+    mk.assign(k, 0);
     mk[0] = mk[k-1] = 1;       // mark the first and last vertices
 	of::priv::simplifyDP( tol, &vt[0], 0, k-1, &mk[0] );
     
-    // copy marked vertices to the output simplified polyline
+    // keep the marked vertices
     for (i=m=0; i<k; i++) {
-        if (mk[i]) sV[m++] = vt[i];
+        if (mk[i]) points[m++] = vt[i];
     }
-    
-	//get rid of the unused points
-	if( m < (int)sV.size() ){
-		points.assign( sV.begin(),sV.begin()+m );
-	}else{
-		points = sV;
+	points.resize(m);
+	flagHasChanged();
+}
+
+//--------------------------------------------------
+template<class T>
+ofPolyline_<T> ofPolyline_<T>::getSimplified(float tolerance) const{
+	ofPolyline_ result = *this;
+	result.simplify(tolerance);
+	return result;
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getSimplified(float tolerance, ofPolyline_ & result) const{
+	if(&result != this){
+		result.points.assign(points.begin(), points.end());
+		result.curveVertices.clear();
+		result.bClosed = bClosed;
+		result.rightVector = rightVector;
 	}
-    
+	result.simplify(tolerance);
 }
 
 //--------------------------------------------------
@@ -802,35 +1032,19 @@ T ofPolyline_<T>::getRightVector() const {
 template<class T>
 float ofPolyline_<T>::getIndexAtLength(float length) const {
     if(points.size() < 2) return 0;
-    updateCache();
+    updateLengths();
     
     float totalLength = getPerimeter();
     length = ofClamp(length, 0, totalLength);
     
-    int lastPointIndex = isClosed() ? points.size() : points.size()-1;
-    
-    int i1 = ofClamp(floor(length / totalLength * lastPointIndex), 0, lengths.size()-2);   // start approximation here
-    int leftLimit = 0;
-    int rightLimit = lastPointIndex;
-    
-    float distAt1, distAt2;
-    for(int iterations = 0; iterations < 32; iterations ++) {	// limit iterations
-        i1 = ofClamp(i1, 0, lengths.size()-1);
-        distAt1 = lengths[i1];
-        if(distAt1 <= length) {         // if Length at i1 is less than desired Length (this is good)
-            distAt2 = lengths[i1+1];
-            if(distAt2 >= length) {
-                float t = ofMap(length, distAt1, distAt2, 0, 1);
-                return i1 + t;
-            } else {
-                leftLimit = i1;
-            }
-        } else {
-            rightLimit = i1;
-        }
-        i1 = (leftLimit + rightLimit)/2;
-    }
-    return 0;
+    // lengths is sorted, find the last point before length
+    auto it = std::upper_bound(lengths.begin(), lengths.end(), length);
+    int i1 = ofClamp(int(it - lengths.begin()) - 1, 0, lengths.size()-2);
+    float distAt1 = lengths[i1];
+    float distAt2 = lengths[i1+1];
+    if(distAt2 <= distAt1) return i1;
+    float t = ofMap(length, distAt1, distAt2, 0, 1);
+    return i1 + t;
 }
 
 
@@ -844,7 +1058,7 @@ float ofPolyline_<T>::getIndexAtPercent(float f) const {
 template<class T>
 float ofPolyline_<T>::getLengthAtIndex(int index) const {
     if(points.size() < 2) return 0;
-    updateCache();
+    updateLengths();
     return lengths[getWrappedIndex(index)];
 }
 
@@ -852,7 +1066,7 @@ float ofPolyline_<T>::getLengthAtIndex(int index) const {
 template<class T>
 float ofPolyline_<T>::getLengthAtIndexInterpolated(float findex) const {
     if(points.size() < 2) return 0;
-    updateCache();
+    updateLengths();
     int i1, i2;
     float t;
     getInterpolationParams(findex, i1, i2, t);
@@ -864,7 +1078,7 @@ float ofPolyline_<T>::getLengthAtIndexInterpolated(float findex) const {
 template<class T>
 T ofPolyline_<T>::getPointAtLength(float f) const {
 	if(points.size() < 2) return T();
-    updateCache();
+    updateLengths();
     return getPointAtIndexInterpolated(getIndexAtLength(f));
 }
 
@@ -1052,7 +1266,8 @@ void ofPolyline_<T>::getInterpolationParams(float findex, int &i1, int &i2, floa
 template<class T>
 void ofPolyline_<T>::updateCache(bool bForceUpdate) const {
     if(bCacheIsDirty || bForceUpdate) {
-        lengths.clear();
+        if(bForceUpdate) numLengthsValid = 0;
+        updateLengths();
         angles.clear();
         rotations.clear();
         normals.clear();
@@ -1088,7 +1303,6 @@ void ofPolyline_<T>::updateCache(bool bForceUpdate) const {
 
         
         // per vertex cache
-        lengths.resize(points.size());
         tangents.resize(points.size());
         angles.resize(points.size());
         normals.resize(points.size());
@@ -1099,23 +1313,42 @@ void ofPolyline_<T>::updateCache(bool bForceUpdate) const {
 		T normal;
 		T tangent;
 
-        float length = 0;
         for(int i=0; i<(int)points.size(); i++) {
-            lengths[i] = length;
-
             calcData(i, tangent, angle, rotation, normal);
             tangents[i] = tangent;
             angles[i] = angle;
             rotations[i] = rotation;
             normals[i] = normal;
-            
-			length += glm::distance(toGlm(points[i]), toGlm(points[getWrappedIndex(i + 1)]));
         }
-        
-        if(isClosed()) lengths.push_back(length);
     }
 }
 
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::updateLengths() const {
+    size_t n = points.size();
+    if(n < 2) {
+        lengths.clear();
+        numLengthsValid = 0;
+        return;
+    }
+    if(numLengthsValid == n) return;
+
+    // the length of a closed line is after the last point, its last
+    // segment changes when points are appended
+    size_t start = numLengthsValid;
+    lengths.resize(n);
+    if(start == 0 || start > n) {
+        lengths[0] = 0;
+        start = 1;
+    }
+    for(size_t i=start; i<n; i++) {
+        lengths[i] = lengths[i-1] + glm::distance(toGlm(points[i-1]), toGlm(points[i]));
+    }
+    if(isClosed()) lengths.push_back(lengths[n-1] + glm::distance(toGlm(points[n-1]), toGlm(points[0])));
+    numLengthsValid = n;
+}
+
 
 //--------------------------------------------------
 template<class T>
@@ -1165,3 +1398,50 @@ typename std::vector<T>::const_reverse_iterator ofPolyline_<T>::rend() const{
 	return points.rend();
 }
 
+
+namespace of{
+namespace priv{
+	template<class T, class F>
+	void forEachPolyline(const std::vector<ofPolyline_<T>> & polylines, std::vector<ofPolyline_<T>> & results, F && process){
+		results.resize(polylines.size());
+		// a single small contour isn't worth a task
+		ofGetTaskPool().parallelFor(0, polylines.size(), [&](std::size_t begin, std::size_t end){
+			for(std::size_t i = begin; i < end; i++){
+				process(polylines[i], results[i]);
+			}
+		}, 8);
+	}
+}
+}
+
+//--------------------------------------------------
+template<class T>
+void ofGetSmoothed(const std::vector<ofPolyline_<T>> & polylines, int smoothingSize, float smoothingShape, std::vector<ofPolyline_<T>> & results){
+	of::priv::forEachPolyline(polylines, results, [&](const ofPolyline_<T> & polyline, ofPolyline_<T> & result){
+		polyline.getSmoothed(smoothingSize, smoothingShape, result);
+	});
+}
+
+//--------------------------------------------------
+template<class T>
+void ofGetResampledBySpacing(const std::vector<ofPolyline_<T>> & polylines, float spacing, std::vector<ofPolyline_<T>> & results){
+	of::priv::forEachPolyline(polylines, results, [&](const ofPolyline_<T> & polyline, ofPolyline_<T> & result){
+		polyline.getResampledBySpacing(spacing, result);
+	});
+}
+
+//--------------------------------------------------
+template<class T>
+void ofGetResampledByCount(const std::vector<ofPolyline_<T>> & polylines, int count, std::vector<ofPolyline_<T>> & results){
+	of::priv::forEachPolyline(polylines, results, [&](const ofPolyline_<T> & polyline, ofPolyline_<T> & result){
+		polyline.getResampledByCount(count, result);
+	});
+}
+
+//--------------------------------------------------
+template<class T>
+void ofGetSimplified(const std::vector<ofPolyline_<T>> & polylines, float tolerance, std::vector<ofPolyline_<T>> & results){
+	of::priv::forEachPolyline(polylines, results, [&](const ofPolyline_<T> & polyline, ofPolyline_<T> & result){
+		polyline.getSimplified(tolerance, result);
+	});
+}
@@ -15,7 +15,7 @@ public:
 	 const std::string & getType(){ return TYPE; }
 
 	 std::shared_ptr<ofBaseGLRenderer> getGLRenderer(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			  if(renderer->getType()=="GL" || renderer->getType()=="ProgrammableGL"){
 				  return std::dynamic_pointer_cast<ofBaseGLRenderer>(renderer);
 			  }
@@ -30,13 +30,13 @@ public:
 	 bool rendersPathPrimitives(){return true;}
 
 	 void startRender(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->startRender();
 		 }
 	 }
 
 	 void finishRender(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->finishRender();
 		 }
 	 }
@@ -45,54 +45,54 @@ public:
 	 using ofBaseRenderer::draw;
 
 	 void draw(const ofPolyline & poly) const{
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->draw(poly);
 		 }
 	 }
 	 void draw(const ofPath & shape) const{
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->draw(shape);
 		 }
 	 }
 
 	 void draw(const ofMesh & vertexData, ofPolyRenderMode mode, bool useColors, bool useTextures, bool useNormals) const{
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->draw(vertexData,mode,useColors,useTextures,useNormals);
 		 }
 	 }
 
     void draw(const  of3dPrimitive& model, ofPolyRenderMode renderType ) const {
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->draw( model, renderType );
         }
     }
 
     void draw(const  ofNode& node) const {
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->draw( node );
         }
     }
 
 	void draw(const ofImage & img, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->draw(img,x,y,z,w,h,sx,sy,sw,sh);
 		 }
 	}
 
 	void draw(const ofFloatImage & img, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->draw(img,x,y,z,w,h,sx,sy,sw,sh);
 		}
 	}
 
 	void draw(const ofShortImage & img, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->draw(img,x,y,z,w,h,sx,sy,sw,sh);
 		}
 	}
 
 	void draw(const ofBaseVideoDraws & video, float x, float y, float w, float h) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->draw(video,x,y,w,h);
 		}
 	}
@@ -142,13 +142,13 @@ public:
 	//--------------------------------------------
 	// transformations
 	 void pushView(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->pushView();
 		 }
 	 }
 
 	 void popView(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->popView();
 		 }
 	 }
@@ -157,25 +157,25 @@ public:
 	// if width or height are 0, assume windows dimensions (ofGetWidth(), ofGetHeight())
 	// if nearDist or farDist are 0 assume defaults (calculated based on width / height)
 	void viewport(ofRectangle viewport){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->viewport(viewport);
 		 }
 	}
 
 	 void viewport(float x = 0, float y = 0, float width = -1, float height = -1, bool vflip=true){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->viewport(x,y,width,height,vflip);
 		 }
 	 }
 
 	 void setupScreenPerspective(float width = -1, float height = -1, float fov = 60, float nearDist = 0, float farDist = 0){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->setupScreenPerspective(width,height,fov,nearDist,farDist);
 		 }
 	 }
 
 	 void setupScreenOrtho(float width = -1, float height = -1, float nearDist = -1, float farDist = 1){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->setupScreenOrtho(width,height,nearDist,farDist);
 		 }
 	 }
@@ -212,7 +212,7 @@ public:
 	 }
 
 	 void setCoordHandedness(ofHandednessType handedness){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->setCoordHandedness(handedness);
 		 }
 	 }
@@ -226,115 +226,115 @@ public:
 
 	//our openGL wrappers
 	 void pushMatrix(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->pushMatrix();
 		 }
 	 }
 	 void popMatrix(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->popMatrix();
 		 }
 	 }
 	 void translate(float x, float y, float z = 0){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->translate(x,y,z);
 		 }
 	 }
 	 void translate(const glm::vec3 & p){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->translate(p);
 		 }
 	 }
 	 void scale(float xAmnt, float yAmnt, float zAmnt = 1){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->scale(xAmnt,yAmnt,zAmnt);
 		 }
 	 }
 
 	 void rotateDeg(float degrees, float vecX, float vecY, float vecZ){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateDeg(degrees,vecX,vecY,vecZ);
 		 }
 	 }
 	 void rotateXDeg(float degrees){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateXDeg(degrees);
 		 }
 	 }
 	 void rotateYDeg(float degrees){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateYDeg(degrees);
 		 }
 	 }
 	 void rotateZDeg(float degrees){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateZDeg(degrees);
 		 }
 	 }
 	 void rotateDeg(float degrees){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateDeg(degrees);
 		 }
 	 }
 
 	 void rotateRad(float radians, float vecX, float vecY, float vecZ){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateRad(radians,vecX,vecY,vecZ);
 		 }
 	 }
 	 void rotateXRad(float radians){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateXRad(radians);
 		 }
 	 }
 	 void rotateYRad(float radians){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateYRad(radians);
 		 }
 	 }
 	 void rotateZRad(float radians){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateZRad(radians);
 		 }
 	 }
 	 void rotateRad(float radians){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->rotateRad(radians);
 		 }
 	 }
 
 	void loadIdentityMatrix (void){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->loadIdentityMatrix();
 		}
 	}
 
 	void loadMatrix (const glm::mat4 & m){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->loadMatrix( m );
 		}
 	}
 
 	void loadMatrix (const float * m){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->loadMatrix( m );
 		}
 	}
 
 	void multMatrix (const glm::mat4 & m){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->multMatrix( m );
 		}
 	}
 
 	void multMatrix (const float * m){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->multMatrix( m );
 		}
 	}
 
 	void setOrientation(ofOrientation orientation, bool vflip){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setOrientation( orientation, vflip );
 		}
 	}
@@ -349,19 +349,19 @@ public:
 	}
 
 	void matrixMode(ofMatrixMode mode){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->matrixMode( mode );
 		}
 	}
 
 	void loadViewMatrix(const glm::mat4& m){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->loadViewMatrix( m );
 		}
 	}
 
 	void multViewMatrix(const glm::mat4& m){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->multViewMatrix( m );
 		}
 	}
@@ -378,7 +378,7 @@ public:
 
 	// screen coordinate things / default gl values
 	 void setupGraphicDefaults(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->setupGraphicDefaults();
 		}
 		path.setMode(ofPath::COMMANDS);
@@ -386,44 +386,44 @@ public:
 	 }
 
 	 void setupScreen(){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->setupScreen();
 		 }
 	 }
 
 	// color options
 	void setColor(int r, int g, int b){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setColor(r,g,b);
 		 }
 	}
 
 	void setColor(int r, int g, int b, int a){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setColor(r,g,b,a);
 		 }
 	}
 
 	void setColor(const ofColor & color){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setColor(color);
 		 }
 	}
 
 	void setColor(const ofColor & color, int _a){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setColor(color,_a);
 		 }
 	}
 
 	void setColor(int gray){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setColor(gray);
 		 }
 	}
 
 	void setHexColor( int hexColor ){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setHexColor(hexColor);
 		 }
 	 } // hex, like web 0xFF0033;
@@ -438,7 +438,7 @@ public:
 	}
 
 	void setBackgroundColor(const ofColor & color){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setBackgroundColor(color);
 		 }
 	}
@@ -452,62 +452,62 @@ public:
 	}
 
 	void background(const ofColor & c){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->background(c);
 		 }
 	}
 
 	void background(float brightness){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->background(brightness);
 		 }
 	}
 
 	void background(int hexColor, float _a=255.0f){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->background(hexColor,_a);
 		 }
 	}
 
 	void background(int r, int g, int b, int a=255){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->background(r,g,b,a);
 		 }
 	}
 
 	void setBackgroundAuto(bool bManual){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setBackgroundAuto(bManual);
 		 }
 	}
 
 	void clear(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->clear();
 		 }
 	}
 
 	void clear(float r, float g, float b, float a=0){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->clear(r,g,b,a);
 		 }
 	}
 
 	void clear(float brightness, float a=0){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->clear(brightness,a);
 		 }
 	}
 
 	void clearAlpha(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->clearAlpha();
 		 }
 	}
 
 	// drawing modes
 	void setRectMode(ofRectMode mode){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setRectMode(mode);
 		 }
 	}
@@ -521,7 +521,7 @@ public:
 	}
 
 	void setFillMode(ofFillFlag fill){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setFillMode(fill);
 		 }
 		if(fill==OF_FILLED){
@@ -542,7 +542,7 @@ public:
 	}
 
 	void setLineWidth(float lineWidth){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setLineWidth(lineWidth);
 		}
 		if(!getStyle().bFill){
@@ -551,35 +551,35 @@ public:
 	}
 
 	void setDepthTest(bool depthTest) {
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setDepthTest(depthTest);
 		}
 	}
 
 	void setBlendMode(ofBlendMode blendMode){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setBlendMode(blendMode);
 		 }
 	}
 	void setLineSmoothing(bool smooth){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setLineSmoothing(smooth);
 		 }
 	}
 	void setCircleResolution(int res){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setCircleResolution(res);
 		 }
 	}
 	void enablePointSprites(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			 if(renderer->getType()=="GL" || renderer->getType()=="ProgrammableGL"){
 				 std::dynamic_pointer_cast<ofBaseGLRenderer>(renderer)->enablePointSprites();
 			 }
 		 }
 	}
 	void disablePointSprites(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			 if(renderer->getType()=="GL" || renderer->getType()=="ProgrammableGL"){
 				 std::dynamic_pointer_cast<ofBaseGLRenderer>(renderer)->disablePointSprites();
 			 }
@@ -587,19 +587,19 @@ public:
 	}
 
 	void enableAntiAliasing(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->enableAntiAliasing();
 		 }
 	}
 
 	void disableAntiAliasing(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->disableAntiAliasing();
 		 }
 	}
 
 	void setBitmapTextMode(ofDrawBitmapMode mode){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setBitmapTextMode(mode);
 		 }
 	}
@@ -613,32 +613,32 @@ public:
 	}
 
 	void pushStyle(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->pushStyle();
 		 }
 	}
 
 	void popStyle(){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->popStyle();
 		 }
 	}
 
 	void setStyle(const ofStyle & style){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setStyle(style);
 		 }
 	}
 
 	void setCurveResolution(int res){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setCurveResolution(res);
 		 }
 		 path.setCurveResolution(res);
 	}
 
 	void setPolyMode(ofPolyWindingMode mode){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->setPolyMode(mode);
 		 }
 		 path.setPolyWindingMode(mode);
@@ -646,54 +646,54 @@ public:
 
 	// drawing
 	void drawLine(float x1, float y1, float z1, float x2, float y2, float z2) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->drawLine(x1,y1,z1,x2,y2,z2);
 		 }
 	}
 
 	void drawRectangle(float x, float y, float z, float w, float h) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->drawRectangle(x,y,z,w,h);
 		 }
 	}
 
 	void drawTriangle(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->drawTriangle(x1,y1,z1,x2,y2,z2,x3,y3,z3);
 		 }
 	}
 
 	void drawCircle(float x, float y, float z, float radius) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->drawCircle(x,y,z,radius);
 		 }
 	}
 
 	void drawEllipse(float x, float y, float z, float width, float height) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->drawEllipse(x,y,z,width,height);
 		 }
 	}
 
 	void drawString(std::string text, float x, float y, float z) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->drawString(text, x,y,z);
 		 }
 	}
 
 	void drawString(const ofTrueTypeFont & font, std::string text, float x, float y) const{
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->drawString(font, text, x,y);
 		 }
 	}
 
 	virtual void bind(const ofCamera & camera, const ofRectangle & viewport){
-		for(auto renderer: renderers){
+		for(auto & renderer: renderers){
 			renderer->bind(camera, viewport);
 		 }
 	}
 	virtual void unbind(const ofCamera & camera){
-		 for(auto renderer: renderers){
+		 for(auto & renderer: renderers){
 			 renderer->unbind(camera);
 		 }
 	}
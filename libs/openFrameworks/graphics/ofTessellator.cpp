@@ -1,4 +1,5 @@
 #include "ofTessellator.h"
+#include "ofTaskPool.h"
 
 using namespace std;
 
@@ -25,15 +26,10 @@ using namespace std;
 // a) collecting vertices
 // b) new vertices on combine callback
 //
-// important note!
-//
-// this assumes single threaded polygon creation
-// you can have big problems if creating polygons in
-// multiple threads... please be careful
-//
-// (but also be aware that alot of opengl code
-// is single threaded anyway, so you will have problems
-// with many things opengl related across threads)
+// every ofTessellator has its own tesselator context and
+// calls to it are serialized by its mutex, use one per
+// thread, like getThreadTessellator(), to tessellate in
+// parallel
 //
 // ------------------------------------
 // (note: this implementation is based on code from ftgl)
@@ -99,6 +95,7 @@ void ofTessellator::init(){
 
 //----------------------------------------------------------
 void ofTessellator::tessellateToMesh( const ofPolyline& src,  ofPolyWindingMode polyWindingMode, ofMesh& dstmesh, bool bIs2D){
+	std::unique_lock<std::mutex> lock(mutex);
 
 	ofPolyline& polyline = const_cast<ofPolyline&>(src);
 	tessAddContour( cacheTess, bIs2D?2:3, &polyline.getVertices()[0], sizeof(glm::vec3), polyline.size());
@@ -109,6 +106,7 @@ void ofTessellator::tessellateToMesh( const ofPolyline& src,  ofPolyWindingMode
 	
 //----------------------------------------------------------
 void ofTessellator::tessellateToMesh( const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, ofMesh & dstmesh, bool bIs2D ) {
+	std::unique_lock<std::mutex> lock(mutex);
 
 
 	// pass vertex pointers to GLU tessellator
@@ -125,6 +123,7 @@ void ofTessellator::tessellateToMesh( const vector<ofPolyline>& src, ofPolyWindi
 
 //----------------------------------------------------------
 void ofTessellator::tessellateToPolylines( const ofPolyline& src,  ofPolyWindingMode polyWindingMode, vector<ofPolyline>& dstpoly, bool bIs2D){
+	std::unique_lock<std::mutex> lock(mutex);
 
 	if (src.size() > 0) {
 		ofPolyline& polyline = const_cast<ofPolyline&>(src);
@@ -136,6 +135,7 @@ void ofTessellator::tessellateToPolylines( const ofPolyline& src,  ofPolyWinding
 
 //----------------------------------------------------------
 void ofTessellator::tessellateToPolylines( const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, vector<ofPolyline>& dstpoly, bool bIs2D ) {
+	std::unique_lock<std::mutex> lock(mutex);
 
 	// pass vertex pointers to GLU tessellator
 	for ( int i=0; i<(int)src.size(); ++i ) {
@@ -150,6 +150,38 @@ void ofTessellator::tessellateToPolylines( const vector<ofPolyline>& src, ofPoly
 }
 
 	
+//----------------------------------------------------------
+void ofTessellator::tessellateToMesh( const vector<vector<ofPolyline>> & src, ofPolyWindingMode polyWindingMode, vector<ofMesh> & dstmeshes, bool bIs2D ) {
+	dstmeshes.resize(src.size());
+	ofGetTaskPool().parallelFor(0, src.size(), [&](size_t begin, size_t end){
+		ofTessellator & tessellator = getThreadTessellator();
+		for(size_t i = begin; i < end; i++){
+			tessellator.tessellateToMesh(src[i], polyWindingMode, dstmeshes[i], bIs2D);
+		}
+	});
+}
+
+//----------------------------------------------------------
+void ofTessellator::tessellateToPolylines( const vector<vector<ofPolyline>> & src, ofPolyWindingMode polyWindingMode, vector<vector<ofPolyline>> & dstpolys, bool bIs2D ) {
+	dstpolys.resize(src.size());
+	ofGetTaskPool().parallelFor(0, src.size(), [&](size_t begin, size_t end){
+		ofTessellator & tessellator = getThreadTessellator();
+		for(size_t i = begin; i < end; i++){
+			tessellator.tessellateToPolylines(src[i], polyWindingMode, dstpolys[i], bIs2D);
+		}
+	});
+}
+
+//----------------------------------------------------------
+ofTessellator & ofTessellator::getThreadTessellator(){
+#if HAS_TLS && !defined(TARGET_NO_THREADS)
+	thread_local ofTessellator tessellator;
+#else
+	static ofTessellator tessellator;
+#endif
+	return tessellator;
+}
+
 //----------------------------------------------------------
 void ofTessellator::performTessellation(ofPolyWindingMode polyWindingMode, ofMesh& dstmesh, bool bIs2D ) {
 
@@ -5,6 +5,7 @@
 #include "ofTypes.h"
 #include "ofPolyline.h"
 #include "tesselator.h"
+#include <mutex>
 
 /// \brief
 /// ofTessellator exists for one purpose: to turn ofPolylines into ofMeshes so
@@ -21,6 +22,12 @@
 /// shown on the right.
 /// 
 /// ![tessellation](graphics/tessellation.jpg)
+///
+/// Every tessellator has its own libtess2 context so different instances
+/// can be used from different threads at the same time, calls to the same
+/// instance from several threads are serialized. getThreadTessellator()
+/// returns one owned by the calling thread, and the versions that take a
+/// vector of shapes tessellate them in parallel in ofGetTaskPool().
 class ofTessellator
 {
 public:	
@@ -48,6 +55,23 @@ public:
 	/// \brief Tessellate multiple polylines into a single polyline.
 	void tessellateToPolylines( const ofPolyline & src, ofPolyWindingMode polyWindingMode, std::vector<ofPolyline>& dstpoly, bool bIs2D=false );
 
+	/// \brief Tessellates every shape in src, a vector of ofPolyline
+	/// instances each, into its own ofMesh in dstmeshes
+	///
+	/// The shapes are split across the threads of ofGetTaskPool(), the call
+	/// returns once all of them are done.
+	static void tessellateToMesh( const std::vector<std::vector<ofPolyline>> & src, ofPolyWindingMode polyWindingMode, std::vector<ofMesh> & dstmeshes, bool bIs2D=false );
+
+	/// \brief Tessellates every shape in src into its own vector of
+	/// ofPolyline instances in dstpolys, in parallel
+	static void tessellateToPolylines( const std::vector<std::vector<ofPolyline>> & src, ofPolyWindingMode polyWindingMode, std::vector<std::vector<ofPolyline>> & dstpolys, bool bIs2D=false );
+
+	/// \brief A tessellator for the calling thread, created the first time
+	/// it's used from it
+	///
+	/// On platforms without thread local storage all the threads share one.
+	static ofTessellator & getThreadTessellator();
+
 private:
 	
 	void performTessellation( ofPolyWindingMode polyWindingMode, ofMesh& dstmesh, bool bIs2D );
@@ -56,6 +80,7 @@ private:
 
 	TESStesselator * cacheTess;
 	TESSalloc tessAllocator;
+	std::mutex mutex;
 };
 
 
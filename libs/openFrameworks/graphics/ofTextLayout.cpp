@@ -0,0 +1,184 @@
+#include "ofTextLayout.h"
+#include "ofTrueTypeFont.h"
+#include "ofGraphics.h"
+#include "ofLog.h"
+
+//----------------------------------------------------------
+ofTextLayout::ofTextLayout()
+:font(nullptr)
+,horzAlign(OF_ALIGN_HORZ_IGNORE)
+,vertAlign(OF_ALIGN_VERT_IGNORE)
+,fontVersion(0)
+,vFlipped(true)
+,dirty(true){
+
+}
+
+//----------------------------------------------------------
+ofTextLayout::ofTextLayout(const ofTrueTypeFont & font, const std::string & text)
+:ofTextLayout(){
+	setFont(font);
+	setText(text);
+}
+
+//----------------------------------------------------------
+void ofTextLayout::setFont(const ofTrueTypeFont & font){
+	if(this->font != &font){
+		this->font = &font;
+		dirty = true;
+	}
+}
+
+//----------------------------------------------------------
+const ofTrueTypeFont * ofTextLayout::getFont() const{
+	return font;
+}
+
+//----------------------------------------------------------
+void ofTextLayout::setText(const std::string & text){
+	if(this->text != text){
+		this->text = text;
+		dirty = true;
+	}
+}
+
+//----------------------------------------------------------
+const std::string & ofTextLayout::getText() const{
+	return text;
+}
+
+//----------------------------------------------------------
+void ofTextLayout::setAlignment(ofAlignHorz horzAlign, ofAlignVert vertAlign){
+	if(this->horzAlign != horzAlign || this->vertAlign != vertAlign){
+		this->horzAlign = horzAlign;
+		this->vertAlign = vertAlign;
+		dirty = true;
+	}
+}
+
+//----------------------------------------------------------
+ofAlignHorz ofTextLayout::getHorizontalAlignment() const{
+	return horzAlign;
+}
+
+//----------------------------------------------------------
+ofAlignVert ofTextLayout::getVerticalAlignment() const{
+	return vertAlign;
+}
+
+//----------------------------------------------------------
+ofRectangle ofTextLayout::getBoundingBox() const{
+	update();
+	return boundingBox;
+}
+
+//----------------------------------------------------------
+float ofTextLayout::getWidth() const{
+	return getBoundingBox().width;
+}
+
+//----------------------------------------------------------
+float ofTextLayout::getHeight() const{
+	return getBoundingBox().height;
+}
+
+//----------------------------------------------------------
+bool ofTextLayout::update() const{
+	if(!font || !font->isLoaded()){
+		return false;
+	}
+	if(!dirty && fontVersion == font->getLayoutVersion() && vFlipped == ofIsVFlipped()){
+		return false;
+	}
+
+	vFlipped = ofIsVFlipped();
+	ofRectangle bb = font->getStringBoundingBox(text, 0, 0, vFlipped);
+
+	// with the y axis pointing up the top of the text is its max y
+	float top = vFlipped ? bb.getMinY() : bb.getMaxY();
+	float bottom = vFlipped ? bb.getMaxY() : bb.getMinY();
+	glm::vec3 offset(0.f);
+	switch(horzAlign){
+		case OF_ALIGN_HORZ_LEFT: offset.x = -bb.getMinX(); break;
+		case OF_ALIGN_HORZ_CENTER: offset.x = -bb.getCenter().x; break;
+		case OF_ALIGN_HORZ_RIGHT: offset.x = -bb.getMaxX(); break;
+		default: break;
+	}
+	switch(vertAlign){
+		case OF_ALIGN_VERT_TOP: offset.y = -top; break;
+		case OF_ALIGN_VERT_CENTER: offset.y = -bb.getCenter().y; break;
+		case OF_ALIGN_VERT_BOTTOM: offset.y = -bottom; break;
+		default: break;
+	}
+
+	// the font reuses its meshes, copy them before anything else
+	// calls getStringMesh()
+	font->getStringMesh(text, 0, 0, vFlipped);
+	meshes.resize(std::max<std::size_t>(font->getNumAtlasPages(), 1));
+	for(std::size_t page = 0; page < meshes.size(); page++){
+		meshes[page] = font->getStringMeshForPage(page);
+		if(offset.x != 0 || offset.y != 0){
+			for(auto & v: meshes[page].getVertices()){
+				v += offset;
+			}
+		}
+	}
+
+	bb.translate(offset);
+	boundingBox = bb;
+	fontVersion = font->getLayoutVersion();
+	dirty = false;
+	return true;
+}
+
+//----------------------------------------------------------
+std::size_t ofTextLayout::getNumMeshes() const{
+	update();
+	return meshes.size();
+}
+
+//----------------------------------------------------------
+const ofVboMesh & ofTextLayout::getMesh(std::size_t page) const{
+	update();
+	if(page >= meshes.size()){
+		static const ofVboMesh emptyMesh;
+		return emptyMesh;
+	}
+	return meshes[page];
+}
+
+//----------------------------------------------------------
+void ofTextLayout::draw(float x, float y) const{
+	if(!font || !font->isLoaded()){
+		ofLogError("ofTextLayout") << "draw(): font not set or not loaded";
+		return;
+	}
+	update();
+
+	ofBlendMode blendMode = ofGetStyle().blendingMode;
+	ofEnableBlendMode(OF_BLENDMODE_ALPHA);
+	ofPushMatrix();
+	ofTranslate(x, y);
+	for(std::size_t page = 0; page < meshes.size(); page++){
+		if(meshes[page].getNumVertices() == 0) continue;
+		const ofTexture & texture = font->getFontTexture(page);
+		texture.bind();
+		meshes[page].draw();
+		texture.unbind();
+	}
+	ofPopMatrix();
+	ofEnableBlendMode(blendMode);
+}
+
+//----------------------------------------------------------
+void ofTextLayout::draw(const glm::vec2 & pos) const{
+	draw(pos.x, pos.y);
+}
+
+//----------------------------------------------------------
+void ofTextLayout::clear(){
+	font = nullptr;
+	meshes.clear();
+	boundingBox = ofRectangle();
+	dirty = true;
+}
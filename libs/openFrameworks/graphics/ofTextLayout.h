@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofRectangle.h"
+#include "ofVboMesh.h"
+
+class ofTrueTypeFont;
+
+/// \brief A string laid out with an ofTrueTypeFont, cached in vbos
+///
+/// ofTrueTypeFont::drawString() generates the quads for every glyph each
+/// time it's called. ofTextLayout keeps them, together with the bounding
+/// box of the text, and only generates them again when the text, the
+/// alignment or the font change, which makes drawing static labels
+/// mostly free for the CPU:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// label.setFont(font);
+/// label.setText("fps");
+/// label.setAlignment(OF_ALIGN_HORZ_CENTER, OF_ALIGN_VERT_CENTER);
+///
+/// // draw
+/// label.draw(x, y);
+/// ~~~~
+///
+/// The layout keeps a pointer to the font, which has to outlive it.
+/// Fonts loaded with a dynamic atlas invalidate their layouts every time
+/// they evict a glyph, so the atlas should be big enough for all the
+/// labels drawn each frame.
+class ofTextLayout{
+public:
+	ofTextLayout();
+	ofTextLayout(const ofTrueTypeFont & font, const std::string & text = "");
+
+	void setFont(const ofTrueTypeFont & font);
+	const ofTrueTypeFont * getFont() const;
+
+	void setText(const std::string & text);
+	const std::string & getText() const;
+
+	/// \brief Sets how the text is placed relative to the position it's drawn at
+	///
+	/// OF_ALIGN_HORZ_IGNORE and OF_ALIGN_VERT_IGNORE, the defaults, draw
+	/// the text like ofTrueTypeFont::drawString(), starting at the position
+	/// and with the baseline of the first line on it. Any other alignment
+	/// places the bounding box of the text.
+	void setAlignment(ofAlignHorz horzAlign, ofAlignVert vertAlign = OF_ALIGN_VERT_IGNORE);
+	ofAlignHorz getHorizontalAlignment() const;
+	ofAlignVert getVerticalAlignment() const;
+
+	/// \brief Bounding box of the text relative to the position it's drawn at
+	ofRectangle getBoundingBox() const;
+	float getWidth() const;
+	float getHeight() const;
+
+	/// \brief Generates the meshes again if anything changed since the
+	/// last time they were generated
+	///
+	/// draw() and the getters call it, there's usually no need to call it
+	/// directly.
+	///
+	/// \returns true if the meshes were generated again
+	bool update() const;
+
+	/// \brief Number of meshes, one per atlas page of the font used
+	std::size_t getNumMeshes() const;
+
+	/// \brief The glyph quads that have to be drawn with the atlas page
+	/// of the same index, relative to the position the text is drawn at
+	const ofVboMesh & getMesh(std::size_t page = 0) const;
+
+	void draw(float x, float y) const;
+	void draw(const glm::vec2 & pos) const;
+
+	/// \brief Drops the meshes and the reference to the font
+	void clear();
+
+private:
+	const ofTrueTypeFont * font;
+	std::string text;
+	ofAlignHorz horzAlign;
+	ofAlignVert vertAlign;
+
+	mutable std::vector<ofVboMesh> meshes;
+	mutable ofRectangle boundingBox;
+	mutable uint64_t fontVersion;
+	mutable bool vFlipped;
+	mutable bool dirty;
+};
@@ -14,12 +14,16 @@
 
 #include <algorithm>
 #include <numeric>
+#include <atomic>
+#include <mutex>
 
 #include "ofUtils.h"
 #include "ofGraphics.h"
 #include "ofAppRunner.h"
 #include "utf8.h"
 #include "ofVectorMath.h"
+#include "ofGLUtils.h"
+#include "ofGLStateCache.h"
 
 using namespace std;
 
@@ -143,7 +147,8 @@ const ofTrueTypeFont::glyphProps ofTrueTypeFont::invalidProps{
 	0,0,0,0,
 	0,
 	0.0f,0.0f,
-	0.0f,0.0f,0.0f,0.0f
+	0.0f,0.0f,0.0f,0.0f,
+	-1
 };
 
 const size_t TAB_WIDTH = 4; /// Number of spaces per tab
@@ -153,6 +158,13 @@ static int ttfGlobalDpi = 96;
 static bool librariesInitialized = false;
 static FT_Library library;
 
+// FreeType faces can be used from different threads, but creating and
+// destroying them, and the library, can't happen at the same time
+static std::recursive_mutex & libraryMutex(){
+	static std::recursive_mutex mutex;
+	return mutex;
+}
+
 //--------------------------------------------------------
 void ofTrueTypeShutdown(){
 #ifdef TARGET_LINUX
@@ -531,6 +543,7 @@ bool ofTrueTypeFont::initLibraries(){
 ofTrueTypeFont::ofTrueTypeFont()
 :settings("",0){
 	bLoadedOk		= false;
+	bPrepared		= false;
 	letterSpacing = 1;
 	spaceSize = 1;
 	fontUnitScale = 1;
@@ -538,6 +551,16 @@ ofTrueTypeFont::ofTrueTypeFont()
 	ascenderHeight = 0;
 	descenderHeight = 0;
 	lineHeight = 0;
+	atlasUseCount = 0;
+	atlasCellWidth = 0;
+	atlasCellHeight = 0;
+	atlasCellsPerRow = 0;
+	atlasCellsPerPage = 0;
+	outlineWidth = 0;
+	outlineColor = ofFloatColor::black;
+	glowWidth = 0;
+	glowColor = ofFloatColor::white;
+	invalidateLayouts();
 }
 
 //------------------------------------------------------------------
@@ -558,6 +581,7 @@ ofTrueTypeFont::ofTrueTypeFont(const ofTrueTypeFont& mom)
 	}
 #endif
 	bLoadedOk = mom.bLoadedOk;
+	bPrepared = false;
 
 	charOutlines = mom.charOutlines;
 	charOutlinesNonVFlipped = mom.charOutlinesNonVFlipped;
@@ -571,12 +595,24 @@ ofTrueTypeFont::ofTrueTypeFont(const ofTrueTypeFont& mom)
 	letterSpacing = mom.letterSpacing;
 	spaceSize = mom.spaceSize;
 	fontUnitScale = mom.fontUnitScale;
+	outlineWidth = mom.outlineWidth;
+	outlineColor = mom.outlineColor;
+	glowWidth = mom.glowWidth;
+	glowColor = mom.glowColor;
 
 	cps = mom.cps; // properties for each character
 	settings = mom.settings;
 	glyphIndexMap = mom.glyphIndexMap;
 	texAtlas = mom.texAtlas;
 	face = mom.face;
+
+	// the cells in a dynamic atlas are reused, sharing its textures
+	// would let one copy overwrite glyphs the other is using
+	atlasCellWidth = mom.atlasCellWidth;
+	atlasCellHeight = mom.atlasCellHeight;
+	atlasCellsPerRow = mom.atlasCellsPerRow;
+	atlasCellsPerPage = mom.atlasCellsPerPage;
+	resetAtlas();
 }
 
 //------------------------------------------------------------------
@@ -590,6 +626,7 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(const ofTrueTypeFont& mom){
 #endif
 	settings = mom.settings;
 	bLoadedOk = mom.bLoadedOk;
+	bPrepared = false;
 
 	charOutlines = mom.charOutlines;
 	charOutlinesNonVFlipped = mom.charOutlinesNonVFlipped;
@@ -603,6 +640,10 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(const ofTrueTypeFont& mom){
 	letterSpacing = mom.letterSpacing;
 	spaceSize = mom.spaceSize;
 	fontUnitScale = mom.fontUnitScale;
+	outlineWidth = mom.outlineWidth;
+	outlineColor = mom.outlineColor;
+	glowWidth = mom.glowWidth;
+	glowColor = mom.glowColor;
 
 	cps = mom.cps; // properties for each character
 	settings = mom.settings;
@@ -610,6 +651,14 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(const ofTrueTypeFont& mom){
 	texAtlas = mom.texAtlas;
 	face = mom.face;
 
+	// the cells in a dynamic atlas are reused, sharing its textures
+	// would let one copy overwrite glyphs the other is using
+	atlasCellWidth = mom.atlasCellWidth;
+	atlasCellHeight = mom.atlasCellHeight;
+	atlasCellsPerRow = mom.atlasCellsPerRow;
+	atlasCellsPerPage = mom.atlasCellsPerPage;
+	resetAtlas();
+
 	return *this;
 }
 
@@ -623,6 +672,7 @@ ofTrueTypeFont::ofTrueTypeFont(ofTrueTypeFont&& mom)
 	}
 #endif
 	bLoadedOk = mom.bLoadedOk;
+	bPrepared = false;
 
 	charOutlines = std::move(mom.charOutlines);
 	charOutlinesNonVFlipped = std::move(mom.charOutlinesNonVFlipped);
@@ -636,12 +686,27 @@ ofTrueTypeFont::ofTrueTypeFont(ofTrueTypeFont&& mom)
 	letterSpacing = mom.letterSpacing;
 	spaceSize = mom.spaceSize;
 	fontUnitScale = mom.fontUnitScale;
+	outlineWidth = mom.outlineWidth;
+	outlineColor = mom.outlineColor;
+	glowWidth = mom.glowWidth;
+	glowColor = mom.glowColor;
 
 	cps = mom.cps; // properties for each character
 	settings = mom.settings;
 	glyphIndexMap = std::move(mom.glyphIndexMap);
 	texAtlas = mom.texAtlas;
 	face = mom.face;
+
+	atlasPages = std::move(mom.atlasPages);
+	atlasPagesQuads = std::move(mom.atlasPagesQuads);
+	atlasSlots = std::move(mom.atlasSlots);
+	freeAtlasSlots = std::move(mom.freeAtlasSlots);
+	atlasUseCount = mom.atlasUseCount;
+	atlasCellWidth = mom.atlasCellWidth;
+	atlasCellHeight = mom.atlasCellHeight;
+	atlasCellsPerRow = mom.atlasCellsPerRow;
+	atlasCellsPerPage = mom.atlasCellsPerPage;
+	invalidateLayouts();
 }
 
 //------------------------------------------------------------------
@@ -654,6 +719,7 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(ofTrueTypeFont&& mom){
 	}
 #endif
 	bLoadedOk = mom.bLoadedOk;
+	bPrepared = false;
 
 	charOutlines = std::move(mom.charOutlines);
 	charOutlinesNonVFlipped = std::move(mom.charOutlinesNonVFlipped);
@@ -667,12 +733,27 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(ofTrueTypeFont&& mom){
 	letterSpacing = mom.letterSpacing;
 	spaceSize = mom.spaceSize;
 	fontUnitScale = mom.fontUnitScale;
+	outlineWidth = mom.outlineWidth;
+	outlineColor = mom.outlineColor;
+	glowWidth = mom.glowWidth;
+	glowColor = mom.glowColor;
 
 	cps = mom.cps; // properties for each character
 	settings = mom.settings;
 	glyphIndexMap = std::move(mom.glyphIndexMap);
 	texAtlas = mom.texAtlas;
 	face = mom.face;
+
+	atlasPages = std::move(mom.atlasPages);
+	atlasPagesQuads = std::move(mom.atlasPagesQuads);
+	atlasSlots = std::move(mom.atlasSlots);
+	freeAtlasSlots = std::move(mom.freeAtlasSlots);
+	atlasUseCount = mom.atlasUseCount;
+	atlasCellWidth = mom.atlasCellWidth;
+	atlasCellHeight = mom.atlasCellHeight;
+	atlasCellsPerRow = mom.atlasCellsPerRow;
+	atlasCellsPerPage = mom.atlasCellsPerPage;
+	invalidateLayouts();
 	return *this;
 }
 
@@ -680,6 +761,7 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(ofTrueTypeFont&& mom){
 void ofTrueTypeFont::unloadTextures(){
 	if(!bLoadedOk) return;
 	texAtlas.clear();
+	resetAtlas();
 }
 
 //-----------------------------------------------------------
@@ -692,16 +774,102 @@ bool ofTrueTypeFont::loadFont(string filename, int fontSize, bool bAntiAliased,
 	return load(filename, fontSize, bAntiAliased, bFullCharacterSet, makeContours, simplifyAmt, dpi);
 }
 
+//-----------------------------------------------------------
+// squared distance transform of one row or column of a grid,
+// Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions"
+static const float distanceInf = 1e20f;
+static void distanceTransform1D(vector<float> & grid, size_t offset, size_t stride, size_t length, vector<float> & f, vector<float> & z, vector<size_t> & v){
+	v[0] = 0;
+	z[0] = -distanceInf;
+	z[1] = distanceInf;
+	f[0] = grid[offset];
+	for(size_t q = 1, k = 0; q < length; q++){
+		f[q] = grid[offset + q * stride];
+		float s;
+		while(true){
+			float r = v[k];
+			s = (f[q] - f[v[k]] + float(q) * q - r * r) / (float(q) - r) / 2.f;
+			if(s > z[k] || k == 0) break;
+			k--;
+		}
+		if(s <= z[k]){
+			// only possible for k == 0, the new parabola hides the first
+			v[k] = q;
+			z[k] = -distanceInf;
+		}else{
+			k++;
+			v[k] = q;
+			z[k] = s;
+		}
+		z[k + 1] = distanceInf;
+	}
+	for(size_t q = 0, k = 0; q < length; q++){
+		while(z[k + 1] < q) k++;
+		float qr = float(q) - float(v[k]);
+		grid[offset + q * stride] = f[v[k]] + qr * qr;
+	}
+}
+
+//-----------------------------------------------------------
+static void distanceTransform(vector<float> & grid, size_t width, size_t height){
+	auto length = std::max(width, height);
+	vector<float> f(length), z(length + 1);
+	vector<size_t> v(length);
+	for(size_t x = 0; x < width; x++){
+		distanceTransform1D(grid, x, width, height, f, z, v);
+	}
+	for(size_t y = 0; y < height; y++){
+		distanceTransform1D(grid, y * width, 1, width, f, z, v);
+	}
+}
+
+//-----------------------------------------------------------
+// signed distance field from an antialiased glyph, partially covered
+// pixels place the edge with subpixel precision (same as mapbox tiny-sdf)
+static void distanceFieldFromCoverage(const unsigned char * coverage, int pitch, int width, int height, int spread, ofPixels & pixels){
+	size_t w = width + spread * 2;
+	size_t h = height + spread * 2;
+	vector<float> outside(w * h, distanceInf);
+	vector<float> inside(w * h, 0.f);
+	for(int y = 0; y < height; y++){
+		for(int x = 0; x < width; x++){
+			float a = coverage[y * pitch + x] / 255.f;
+			size_t i = (y + spread) * w + x + spread;
+			if(a >= 1.f){
+				outside[i] = 0.f;
+				inside[i] = distanceInf;
+			}else if(a > 0.f){
+				float d = 0.5f - a;
+				outside[i] = d > 0.f ? d * d : 0.f;
+				inside[i] = d < 0.f ? d * d : 0.f;
+			}
+		}
+	}
+	distanceTransform(outside, w, h);
+	distanceTransform(inside, w, h);
+
+	pixels.allocate(w, h, OF_PIXELS_GRAY_ALPHA);
+	pixels.set(0,255);
+	for(size_t i = 0; i < w * h; i++){
+		float d = sqrt(outside[i]) - sqrt(inside[i]);
+		pixels[i * 2 + 1] = ofClamp(0.5f - d / (spread * 2.f), 0.f, 1.f) * 255.f + 0.5f;
+	}
+}
+
 //-----------------------------------------------------------
 ofTrueTypeFont::glyph ofTrueTypeFont::loadGlyph(uint32_t utf8) const{
 	glyph aGlyph;
-	auto err = FT_Load_Glyph( face.get(), FT_Get_Char_Index( face.get(), utf8 ), settings.antialiased ?  FT_LOAD_FORCE_AUTOHINT : FT_LOAD_DEFAULT );
+	aGlyph.props = invalidProps;
+	// distance fields are drawn scaled, hinting for the loaded size
+	// would only distort them
+	auto loadFlags = settings.distanceField ? FT_LOAD_NO_HINTING : settings.antialiased ?  FT_LOAD_FORCE_AUTOHINT : FT_LOAD_DEFAULT;
+	auto err = FT_Load_Glyph( face.get(), FT_Get_Char_Index( face.get(), utf8 ), loadFlags );
 	if(err){
 		ofLogError("ofTrueTypeFont") << "loadFont(): FT_Load_Glyph failed for utf8 code " << utf8 << ": FT_Error " << err;
 		return aGlyph;
 	}
 
-	if (settings.antialiased) FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
+	if (settings.antialiased || settings.distanceField) FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
 	else FT_Render_Glyph(face->glyph, FT_RENDER_MODE_MONO);
 
 
@@ -719,12 +887,20 @@ ofTrueTypeFont::glyph ofTrueTypeFont::loadGlyph(uint32_t utf8) const{
 	aGlyph.props.advance	= face->glyph->metrics.horiAdvance>>6;
 	aGlyph.props.tW			= aGlyph.props.width;
 	aGlyph.props.tH			= aGlyph.props.height;
+	aGlyph.props.atlasSlot	= -1;
 
 	FT_Bitmap& bitmap= face->glyph->bitmap;
 	int width  = bitmap.width;
 	int height = bitmap.rows;
 	if(width==0 || height==0) return aGlyph;
 
+	if(settings.distanceField){
+		distanceFieldFromCoverage(bitmap.buffer, bitmap.pitch, width, height, settings.distanceFieldSpread, aGlyph.pixels);
+		aGlyph.props.tW += settings.distanceFieldSpread * 2;
+		aGlyph.props.tH += settings.distanceFieldSpread * 2;
+		return aGlyph;
+	}
+
 	// Allocate Memory For The Texture Data.
 	aGlyph.pixels.allocate(width, height, OF_PIXELS_GRAY_ALPHA);
 	//-------------------------------- clear data:
@@ -779,29 +955,37 @@ bool ofTrueTypeFont::load(const std::filesystem::path& filename, int fontSize, b
 }
 
 bool ofTrueTypeFont::load(const ofTrueTypeFont::Settings & _settings){
-	#if defined(TARGET_ANDROID)
-	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofTrueTypeFont::unloadTextures);
-	ofAddListener(ofxAndroidEvents().reloadGL,this,&ofTrueTypeFont::reloadTextures);
-	#endif
+	return prepare(_settings) && uploadTextures();
+}
 
+//-----------------------------------------------------------
+bool ofTrueTypeFont::prepare(const ofTrueTypeFont::Settings & _settings){
+	std::unique_lock<std::recursive_mutex> lock(libraryMutex());
 	initLibraries();
 	settings = _settings;
+	invalidateLayouts();
 	if( settings.dpi == 0 ){
 		settings.dpi = ttfGlobalDpi;
 	}
 
 	bLoadedOk = false;
+	bPrepared = false;
+	atlasPixels.clear();
 
 	//--------------- load the library and typeface
 	FT_Face loadFace;
     if(!loadFontFace(settings.fontName, loadFace, settings.fontName)){
 		return false;
 	}
-	face = std::shared_ptr<struct FT_FaceRec_>(loadFace,FT_Done_Face);
+	face = std::shared_ptr<struct FT_FaceRec_>(loadFace,[](FT_Face face){
+		std::unique_lock<std::recursive_mutex> lock(libraryMutex());
+		FT_Done_Face(face);
+	});
 
-	if(settings.ranges.empty()){
+	if(settings.ranges.empty() && !settings.dynamicAtlas){
 		settings.ranges.push_back(ofUnicode::Latin1Supplement);
 	}
+	settings.distanceFieldSpread = std::max(settings.distanceFieldSpread, 1);
 	int border = 1;
 
 
@@ -815,6 +999,26 @@ bool ofTrueTypeFont::load(const ofTrueTypeFont::Settings & _settings){
 				  (face->bbox.xMax - face->bbox.xMin) * fontUnitScale,
 				  (face->bbox.yMax - face->bbox.yMin) * fontUnitScale);
 
+	if(settings.dynamicAtlas){
+		// glyphs are rasterized on demand into cells big enough for any
+		// glyph in the font, so they can be evicted and reused one by one
+		cps.clear();
+		glyphIndexMap.clear();
+		charOutlines.clear();
+		charOutlinesNonVFlipped.clear();
+		charOutlinesContour.clear();
+		charOutlinesNonVFlippedContour.clear();
+		settings.maxAtlasPages = std::max<std::size_t>(settings.maxAtlasPages, 1);
+		int padding = border + (settings.distanceField ? settings.distanceFieldSpread : 0);
+		atlasCellWidth = ofClamp(std::ceil(glyphBBox.width) + padding*2, border*2 + 1, settings.atlasPageSize);
+		atlasCellHeight = ofClamp(std::ceil(glyphBBox.height) + padding*2, border*2 + 1, settings.atlasPageSize);
+		atlasCellsPerRow = settings.atlasPageSize / atlasCellWidth;
+		atlasCellsPerPage = atlasCellsPerRow * (settings.atlasPageSize / atlasCellHeight);
+		// the pages are textures, they are cleared by uploadTextures()
+		bPrepared = true;
+		return true;
+	}
+
 	//--------------- initialize character info and textures
 	auto nGlyphs = std::accumulate(settings.ranges.begin(), settings.ranges.end(), 0u,
 			[](uint32_t acc, ofUnicode::range range){
@@ -915,7 +1119,7 @@ bool ofTrueTypeFont::load(const ofTrueTypeFont::Settings & _settings){
 
 
 
-	ofPixels atlasPixelsLuminanceAlpha;
+	ofPixels & atlasPixelsLuminanceAlpha = atlasPixels;
 	atlasPixelsLuminanceAlpha.allocate(w,h,OF_PIXELS_GRAY_ALPHA);
 	atlasPixelsLuminanceAlpha.set(0,255);
 	atlasPixelsLuminanceAlpha.set(1,0);
@@ -940,15 +1144,40 @@ bool ofTrueTypeFont::load(const ofTrueTypeFont::Settings & _settings){
 		charPixels.pasteInto(atlasPixelsLuminanceAlpha,x+border,y+border);
 		x+= glyph.tW + border*2;
 	}
+	bPrepared = true;
+	return true;
+}
+
+//-----------------------------------------------------------
+bool ofTrueTypeFont::uploadTextures(){
+	if(!bPrepared){
+		return bLoadedOk;
+	}
+	bPrepared = false;
+
+	#if defined(TARGET_ANDROID)
+	ofAddListener(ofxAndroidEvents().unloadGL,this,&ofTrueTypeFont::unloadTextures);
+	ofAddListener(ofxAndroidEvents().reloadGL,this,&ofTrueTypeFont::reloadTextures);
+	#endif
+
+	if(settings.dynamicAtlas){
+		resetAtlas();
+		bLoadedOk = true;
+		return true;
+	}
+
+	ofPixels & atlasPixelsLuminanceAlpha = atlasPixels;
 	texAtlas.allocate(atlasPixelsLuminanceAlpha,false);
 	texAtlas.setRGToRGBASwizzles(true);
 
-	if(settings.antialiased && settings.fontSize>20){
+	// distance fields only work interpolated
+	if(settings.distanceField || (settings.antialiased && settings.fontSize>20)){
 		texAtlas.setTextureMinMagFilter(GL_LINEAR,GL_LINEAR);
 	}else{
 		texAtlas.setTextureMinMagFilter(GL_NEAREST,GL_NEAREST);
 	}
 	texAtlas.loadData(atlasPixelsLuminanceAlpha);
+	atlasPixels.clear();
 	bLoadedOk = true;
 	return true;
 }
@@ -976,6 +1205,7 @@ int ofTrueTypeFont::getSize() const{
 //-----------------------------------------------------------
 void ofTrueTypeFont::setLineHeight(float _newLineHeight) {
 	lineHeight = _newLineHeight;
+	invalidateLayouts();
 }
 
 //-----------------------------------------------------------
@@ -1001,6 +1231,7 @@ const ofRectangle & ofTrueTypeFont::getGlyphBBox() const {
 //-----------------------------------------------------------
 void ofTrueTypeFont::setLetterSpacing(float _newletterSpacing) {
 	letterSpacing = _newletterSpacing;
+	invalidateLayouts();
 }
 
 //-----------------------------------------------------------
@@ -1011,6 +1242,7 @@ float ofTrueTypeFont::getLetterSpacing() const{
 //-----------------------------------------------------------
 void ofTrueTypeFont::setSpaceSize(float _newspaceSize) {
 	spaceSize = _newspaceSize;
+	invalidateLayouts();
 }
 
 //-----------------------------------------------------------
@@ -1028,6 +1260,24 @@ ofTTFCharacter ofTrueTypeFont::getCharacterAsPoints(uint32_t character, bool vfl
 		return ofTTFCharacter();
 	}
 
+	if(settings.dynamicAtlas){
+		// outlines aren't cached with a dynamic atlas, load them every time
+		auto props = loadGlyph(character).props;
+		auto shape = makeContoursForCharacter( face.get() );
+		if(!vflip){
+			shape.translate({0,props.height,0.f});
+			shape.scale(1,-1);
+		}
+		if(!filled){
+			shape.setFilled(false);
+			shape.setStrokeWidth(1);
+		}
+		if(settings.simplifyAmt>0){
+			shape.simplify(settings.simplifyAmt);
+		}
+		return shape;
+	}
+
 	if(vflip){
 		if(filled){
 			return charOutlines[indexForGlyph(character)];
@@ -1054,7 +1304,13 @@ void ofTrueTypeFont::drawChar(uint32_t c, float x, float y, bool vFlipped) const
 
 	long xmin, ymin, xmax, ymax;
 	float t1, v1, t2, v2;
-	auto props = getGlyphProperties(c);
+	auto props = getAtlasGlyph(c);
+	if(settings.dynamicAtlas && props.atlasSlot < 0){
+		// nothing to draw or no space left in the atlas
+		return;
+	}
+	std::size_t page = settings.dynamicAtlas ? props.atlasSlot / atlasCellsPerPage : 0;
+	ofMesh & quads = page == 0 ? stringQuads : atlasPagesQuads[page - 1];
 	t1		= props.t1;
 	t2		= props.t2;
 	v2		= props.v2;
@@ -1065,6 +1321,14 @@ void ofTrueTypeFont::drawChar(uint32_t c, float x, float y, bool vFlipped) const
 	xmax		= long(props.xmax+x);
 	ymax		= props.ymax;
 
+	if(settings.distanceField){
+		// the field extends past the glyph on every side
+		xmin -= settings.distanceFieldSpread;
+		xmax += settings.distanceFieldSpread;
+		ymin -= settings.distanceFieldSpread;
+		ymax += settings.distanceFieldSpread;
+	}
+
 	if(!vFlipped){
 	   ymin *= -1;
 	   ymax *= -1;
@@ -1073,24 +1337,24 @@ void ofTrueTypeFont::drawChar(uint32_t c, float x, float y, bool vFlipped) const
 	ymin += y;
 	ymax += y;
 
-	ofIndexType firstIndex = stringQuads.getVertices().size();
+	ofIndexType firstIndex = quads.getVertices().size();
 
-	stringQuads.addVertex(glm::vec3(xmin,ymin,0.f));
-	stringQuads.addVertex(glm::vec3(xmax,ymin,0.f));
-	stringQuads.addVertex(glm::vec3(xmax,ymax,0.f));
-	stringQuads.addVertex(glm::vec3(xmin,ymax,0.f));
+	quads.addVertex(glm::vec3(xmin,ymin,0.f));
+	quads.addVertex(glm::vec3(xmax,ymin,0.f));
+	quads.addVertex(glm::vec3(xmax,ymax,0.f));
+	quads.addVertex(glm::vec3(xmin,ymax,0.f));
 
-	stringQuads.addTexCoord(glm::vec2(t1,v1));
-	stringQuads.addTexCoord(glm::vec2(t2,v1));
-	stringQuads.addTexCoord(glm::vec2(t2,v2));
-	stringQuads.addTexCoord(glm::vec2(t1,v2));
+	quads.addTexCoord(glm::vec2(t1,v1));
+	quads.addTexCoord(glm::vec2(t2,v1));
+	quads.addTexCoord(glm::vec2(t2,v2));
+	quads.addTexCoord(glm::vec2(t1,v2));
 
-	stringQuads.addIndex(firstIndex);
-	stringQuads.addIndex(firstIndex+1);
-	stringQuads.addIndex(firstIndex+2);
-	stringQuads.addIndex(firstIndex+2);
-	stringQuads.addIndex(firstIndex+3);
-	stringQuads.addIndex(firstIndex);
+	quads.addIndex(firstIndex);
+	quads.addIndex(firstIndex+1);
+	quads.addIndex(firstIndex+2);
+	quads.addIndex(firstIndex+2);
+	quads.addIndex(firstIndex+3);
+	quads.addIndex(firstIndex);
 }
 
 //-----------------------------------------------------------
@@ -1134,7 +1398,8 @@ void ofTrueTypeFont::iterateString(const string & str, float x, float y, bool vF
 				}
 				prevC = c;
 			} else if(isValidGlyph(c)) {
-				const auto & props = getGlyphProperties(c);
+				// copy, with a dynamic atlas f can grow cps
+				const auto props = getGlyphProperties(c);
 				if(prevC>0){
 					pos.x += getKerning(c,prevC);// * directionX;
 				}
@@ -1156,6 +1421,7 @@ void ofTrueTypeFont::iterateString(const string & str, float x, float y, bool vF
 //-----------------------------------------------------------
 void ofTrueTypeFont::setDirection(ofTrueTypeFont::Settings::Direction direction){
 	settings.direction = direction;
+	invalidateLayouts();
 }
 
 //-----------------------------------------------------------
@@ -1175,6 +1441,9 @@ vector<ofTTFCharacter> ofTrueTypeFont::getStringAsPoints(const string &  str, bo
 }
 
 bool ofTrueTypeFont::isValidGlyph(uint32_t glyph) const{
+	if(settings.dynamicAtlas && settings.ranges.empty()){
+		return face && FT_Get_Char_Index(face.get(), glyph) != 0;
+	}
 	//return glyphIndexMap.find(glyph) != glyphIndexMap.end();
 	return std::any_of(settings.ranges.begin(), settings.ranges.end(),
 		[&](ofUnicode::range range){
@@ -1183,7 +1452,154 @@ bool ofTrueTypeFont::isValidGlyph(uint32_t glyph) const{
 }
 
 size_t ofTrueTypeFont::indexForGlyph(uint32_t glyph) const{
-	return glyphIndexMap.find(glyph)->second;
+	auto it = glyphIndexMap.find(glyph);
+	if(it != glyphIndexMap.end() || !settings.dynamicAtlas){
+		return it->second;
+	}
+
+	// with a dynamic atlas the metrics are loaded the first time a
+	// glyph is used, its pixels only once it's drawn
+	auto index = cps.size();
+	cps.push_back(loadGlyph(glyph).props);
+	cps.back().characterIndex = index;
+	glyphIndexMap[glyph] = index;
+	return index;
+}
+
+//-----------------------------------------------------------
+static void loadAtlasSubData(ofTexture & texture, const ofPixels & pixels, int x, int y){
+	const ofTextureData & texData = texture.getTextureData();
+	ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT, pixels.getWidth(), pixels.getBytesPerChannel(), pixels.getNumChannels());
+	ofGetGLStateCache().bindTexture(texData.textureTarget, texData.textureID);
+	glTexSubImage2D(texData.textureTarget, 0, x, y, pixels.getWidth(), pixels.getHeight(), ofGetGlFormat(pixels), ofGetGlType(pixels), pixels.getData());
+	ofGetGLStateCache().bindTexture(texData.textureTarget, 0);
+}
+
+//-----------------------------------------------------------
+int ofTrueTypeFont::allocateAtlasSlot() const{
+	if(freeAtlasSlots.empty() && atlasPages.size() < settings.maxAtlasPages){
+		ofPixels blank;
+		blank.allocate(settings.atlasPageSize, settings.atlasPageSize, OF_PIXELS_GRAY_ALPHA);
+		blank.set(0,255);
+		blank.set(1,0);
+		atlasPages.emplace_back();
+		ofTexture & page = atlasPages.back();
+		page.allocate(blank,false);
+		page.setRGToRGBASwizzles(true);
+		if(settings.distanceField || (settings.antialiased && settings.fontSize>20)){
+			page.setTextureMinMagFilter(GL_LINEAR,GL_LINEAR);
+		}else{
+			page.setTextureMinMagFilter(GL_NEAREST,GL_NEAREST);
+		}
+		if(atlasPages.size() > 1){
+			atlasPagesQuads.emplace_back();
+			atlasPagesQuads.back().setMode(OF_PRIMITIVE_TRIANGLES);
+		}
+
+		int first = atlasSlots.size();
+		atlasSlots.resize(first + atlasCellsPerPage, {0, 0, false});
+		for(int i = int(atlasSlots.size()) - 1; i >= first; i--){
+			freeAtlasSlots.push_back(i);
+		}
+	}
+
+	if(!freeAtlasSlots.empty()){
+		int slot = freeAtlasSlots.back();
+		freeAtlasSlots.pop_back();
+		return slot;
+	}
+
+	// evict the least recently used glyph, glyphs used by the string
+	// that is being laid out can't be evicted
+	int lru = -1;
+	for(int i = 0; i < int(atlasSlots.size()); i++){
+		const auto & slot = atlasSlots[i];
+		if(slot.used && slot.lastUse < atlasUseCount && (lru < 0 || slot.lastUse < atlasSlots[lru].lastUse)){
+			lru = i;
+		}
+	}
+	if(lru >= 0){
+		cps[glyphIndexMap[atlasSlots[lru].glyph]].atlasSlot = -1;
+		atlasSlots[lru].used = false;
+		// the cell will get a different glyph, cached layouts that
+		// point to it are wrong now
+		invalidateLayouts();
+	}
+	return lru;
+}
+
+//-----------------------------------------------------------
+const ofTrueTypeFont::glyphProps & ofTrueTypeFont::getAtlasGlyph(uint32_t c) const{
+	glyphProps & props = cps[indexForGlyph(c)];
+	if(!settings.dynamicAtlas || props.tW <= 0 || props.tH <= 0){
+		return props;
+	}
+	if(props.atlasSlot >= 0){
+		atlasSlots[props.atlasSlot].lastUse = atlasUseCount;
+		return props;
+	}
+
+	int slot = allocateAtlasSlot();
+	if(slot < 0){
+		ofLogWarning("ofTrueTypeFont") << "drawString(): glyph atlas full, increase Settings::maxAtlasPages or Settings::atlasPageSize";
+		return props;
+	}
+
+	int border = 1;
+	auto g = loadGlyph(c);
+	int w = std::min<int>(props.tW, atlasCellWidth - border*2);
+	int h = std::min<int>(props.tH, atlasCellHeight - border*2);
+	if(g.pixels.getWidth() > size_t(atlasCellWidth - border*2) || g.pixels.getHeight() > size_t(atlasCellHeight - border*2)){
+		g.pixels.crop(0, 0, std::min<size_t>(g.pixels.getWidth(), atlasCellWidth - border*2), std::min<size_t>(g.pixels.getHeight(), atlasCellHeight - border*2));
+	}
+
+	// upload the whole cell to clear what the previous glyph left
+	ofPixels cell;
+	cell.allocate(atlasCellWidth, atlasCellHeight, OF_PIXELS_GRAY_ALPHA);
+	cell.set(0,255);
+	cell.set(1,0);
+	if(g.pixels.isAllocated()){
+		g.pixels.pasteInto(cell, border, border);
+	}
+	int cellIndex = slot % atlasCellsPerPage;
+	int x = (cellIndex % atlasCellsPerRow) * atlasCellWidth;
+	int y = (cellIndex / atlasCellsPerRow) * atlasCellHeight;
+	loadAtlasSubData(atlasPages[slot / atlasCellsPerPage], cell, x, y);
+
+	float pageSize = settings.atlasPageSize;
+	props.t1 = float(x + border) / pageSize;
+	props.v1 = float(y + border) / pageSize;
+	props.t2 = float(x + border + w) / pageSize;
+	props.v2 = float(y + border + h) / pageSize;
+	props.atlasSlot = slot;
+	atlasSlots[slot] = {c, atlasUseCount, true};
+	return props;
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::resetAtlas(){
+	atlasPages.clear();
+	atlasPagesQuads.clear();
+	atlasSlots.clear();
+	freeAtlasSlots.clear();
+	atlasUseCount = 0;
+	for(auto & props: cps){
+		props.atlasSlot = -1;
+	}
+	invalidateLayouts();
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::invalidateLayouts() const{
+	// versions are unique across fonts so a layout can't mistake
+	// a different font loaded at the same address for its own
+	static std::atomic<uint64_t> nextVersion(0);
+	layoutVersion = ++nextVersion;
+}
+
+//-----------------------------------------------------------
+uint64_t ofTrueTypeFont::getLayoutVersion() const{
+	return layoutVersion;
 }
 
 const ofTrueTypeFont::glyphProps & ofTrueTypeFont::getGlyphProperties(uint32_t glyph) const{
@@ -1196,6 +1612,10 @@ const ofTrueTypeFont::glyphProps & ofTrueTypeFont::getGlyphProperties(uint32_t g
 
 //-----------------------------------------------------------
 void ofTrueTypeFont::drawCharAsShape(uint32_t c, float x, float y, bool vFlipped, bool filled) const{
+	if(settings.dynamicAtlas){
+		getCharacterAsPoints(c, vFlipped, filled).draw(x,y);
+		return;
+	}
 	if(vFlipped){
 		if(filled){
 			charOutlines[indexForGlyph(c)].draw(x,y);
@@ -1275,15 +1695,40 @@ void ofTrueTypeFont::createStringMesh(const std::string& str, float x, float y,
 //-----------------------------------------------------------
 const ofMesh & ofTrueTypeFont::getStringMesh(const std::string& c, float x, float y, bool vFlipped) const{
 	stringQuads.clear();
+	for(auto & quads: atlasPagesQuads){
+		quads.clear();
+	}
+	atlasUseCount++;
 	createStringMesh(c,x,y,vFlipped);
 	return stringQuads;
 }
 
+//-----------------------------------------------------------
+const ofMesh & ofTrueTypeFont::getStringMeshForPage(std::size_t page) const{
+	if(page == 0 || page > atlasPagesQuads.size()){
+		return stringQuads;
+	}
+	return atlasPagesQuads[page - 1];
+}
+
 //-----------------------------------------------------------
 const ofTexture & ofTrueTypeFont::getFontTexture() const{
+	return getFontTexture(0);
+}
+
+//-----------------------------------------------------------
+const ofTexture & ofTrueTypeFont::getFontTexture(std::size_t page) const{
+	if(settings.dynamicAtlas && page < atlasPages.size()){
+		return atlasPages[page];
+	}
 	return texAtlas;
 }
 
+//-----------------------------------------------------------
+std::size_t ofTrueTypeFont::getNumAtlasPages() const{
+	return settings.dynamicAtlas ? atlasPages.size() : 1;
+}
+
 //-----------------------------------------------------------
 glm::vec2 ofTrueTypeFont::getFirstGlyphPosForTexture(const std::string & str, bool vflip) const{
 	if(!str.empty()){
@@ -1398,6 +1843,54 @@ void ofTrueTypeFont::drawStringAsShapes(const std::string& str, float x, float y
 	});
 }
 
+//-----------------------------------------------------------
+bool ofTrueTypeFont::isDistanceField() const{
+	return settings.distanceField;
+}
+
+//-----------------------------------------------------------
+int ofTrueTypeFont::getDistanceFieldSpread() const{
+	return settings.distanceFieldSpread;
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::setOutline(float width, const ofFloatColor & color){
+	outlineWidth = ofClamp(width, 0, settings.distanceFieldSpread);
+	outlineColor = color;
+	if(width > 0 && !settings.distanceField){
+		ofLogWarning("ofTrueTypeFont") << "setOutline(): outlines are only drawn for fonts loaded with Settings::distanceField";
+	}
+}
+
+//-----------------------------------------------------------
+float ofTrueTypeFont::getOutlineWidth() const{
+	return outlineWidth;
+}
+
+//-----------------------------------------------------------
+const ofFloatColor & ofTrueTypeFont::getOutlineColor() const{
+	return outlineColor;
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::setGlow(float width, const ofFloatColor & color){
+	glowWidth = std::max(width, 0.f);
+	glowColor = color;
+	if(width > 0 && !settings.distanceField){
+		ofLogWarning("ofTrueTypeFont") << "setGlow(): glows are only drawn for fonts loaded with Settings::distanceField";
+	}
+}
+
+//-----------------------------------------------------------
+float ofTrueTypeFont::getGlowWidth() const{
+	return std::min(glowWidth, settings.distanceFieldSpread - outlineWidth);
+}
+
+//-----------------------------------------------------------
+const ofFloatColor & ofTrueTypeFont::getGlowColor() const{
+	return glowColor;
+}
+
 //-----------------------------------------------------------
 std::size_t ofTrueTypeFont::getNumCharacters() const{
 	return cps.size();
@@ -6,6 +6,7 @@
 #include "ofPath.h"
 #include "ofTexture.h"
 #include "ofMesh.h"
+#include "ofColor.h"
 
 /// \file
 /// The ofTrueTypeFont class provides an interface to load fonts into
@@ -132,6 +133,27 @@ public:
 		Direction                direction = Direction::LeftToRight;
 		std::vector<ofUnicode::range> ranges;
 
+		/// When true glyphs are not rasterized on load but the first time
+		/// they are drawn, into atlas pages of atlasPageSize x atlasPageSize
+		/// pixels. Once maxAtlasPages are full the least recently used
+		/// glyphs are evicted. With no ranges every glyph in the font can
+		/// be drawn, which makes loading big alphabets like CJK instant.
+		bool                     dynamicAtlas = false;
+		int                      atlasPageSize = 1024;
+		std::size_t              maxAtlasPages = 4;
+
+		/// When true glyphs are stored as signed distance fields instead
+		/// of coverage: the alpha of the atlas is 0.5 on the outline of the
+		/// glyph and goes to 1 inside and 0 outside over
+		/// distanceFieldSpread pixels. Loaded once at a moderate size
+		/// (32 to 64 px) the font stays sharp when drawn scaled to any
+		/// size, and outlines and glows can be drawn from the same atlas,
+		/// see setOutline() and setGlow(). Edges are smooth with the
+		/// programmable renderer, the fixed pipeline renders them with an
+		/// alpha test.
+		bool                     distanceField = false;
+		int                      distanceFieldSpread = 6;
+
 		Settings(const std::filesystem::path & name, int size)
 		:fontName(name)
 		,fontSize(size){}
@@ -194,6 +216,29 @@ public:
 	
 	bool load(const Settings & settings);
 
+	/// \brief Does everything load() does except uploading the atlas, so it
+	/// can be called from any thread
+	///
+	/// uploadTextures() has to be called from the GL thread afterwards,
+	/// the font can't be used in between. Fonts share the FreeType
+	/// library so only one is prepared at a time, while others are drawn.
+	///
+	/// ~~~~{.cpp}
+	/// auto prepared = ofGetTaskPool().submit([this]{
+	///     return font.prepare(ofTrueTypeFont::Settings("Sans.ttf", 48));
+	/// });
+	/// // ... later in the GL thread
+	/// if(prepared.get()){
+	///     font.uploadTextures();
+	/// }
+	/// ~~~~
+	/// \returns true if the font face was loaded and rasterized
+	bool prepare(const Settings & settings);
+
+	/// \brief Finishes loading a font after prepare(), from the GL thread
+	/// \returns true if the font is loaded
+	bool uploadTextures();
+
 	/// \brief Has the font been loaded successfully?
 	/// \returns true if the font was loaded.
 	bool isLoaded() const;
@@ -343,16 +388,80 @@ public:
 	std::vector<ofTTFCharacter> getStringAsPoints(const std::string &  str, bool vflip=true, bool filled=true) const;
 	const ofMesh & getStringMesh(const std::string &  s, float x, float y, bool vflip=true) const;
 	const ofTexture & getFontTexture() const;
+
+	/// \brief Number of textures the glyphs are stored in
+	///
+	/// Always 1 unless the font was loaded with Settings::dynamicAtlas,
+	/// in which case getStringMesh() can produce quads for every page.
+	std::size_t getNumAtlasPages() const;
+
+	/// \brief The texture for an atlas page
+	const ofTexture & getFontTexture(std::size_t page) const;
+
+	/// \brief The quads that use the atlas page, from the last call to
+	/// getStringMesh(), getStringMesh() itself returns the ones for page 0
+	const ofMesh & getStringMeshForPage(std::size_t page) const;
+
+	/// \brief Changes every time the metrics, spacing or atlas texture
+	/// coordinates of the font change
+	///
+	/// Meshes generated with getStringMesh(), like the ones cached by
+	/// ofTextLayout, have to be generated again when it does.
+	uint64_t getLayoutVersion() const;
 	ofTexture getStringTexture(const std::string &  s, bool vflip=true) const;
 	glm::vec2 getFirstGlyphPosForTexture(const std::string & str, bool vflip) const;
 	bool isValidGlyph(uint32_t) const;
 	/// \}
 
+	/// \name Distance Field
+	/// \{
+
+	/// \brief Whether the font was loaded with Settings::distanceField
+	bool isDistanceField() const;
+
+	/// \brief Distance in pixels, at the loaded size, covered by the
+	/// distance field on each side of the outline of the glyphs
+	int getDistanceFieldSpread() const;
+
+	/// \brief Draws an outline around the glyphs of a distance field font
+	///
+	/// ~~~~{.cpp}
+	/// ofTrueTypeFont::Settings settings("verdana.ttf", 48);
+	/// settings.distanceField = true;
+	/// font.load(settings);
+	/// font.setOutline(2, ofFloatColor::black);
+	///
+	/// // draw
+	/// ofPushMatrix();
+	/// ofTranslate(x, y);
+	/// ofScale(size / font.getSize());
+	/// font.drawString("hello", 0, 0);
+	/// ofPopMatrix();
+	/// ~~~~
+	///
+	/// \param width in pixels at the loaded size, clamped to
+	/// getDistanceFieldSpread(). 0 disables it.
+	void setOutline(float width, const ofFloatColor & color);
+	float getOutlineWidth() const;
+	const ofFloatColor & getOutlineColor() const;
+
+	/// \brief Draws a glow that fades out around the glyphs, and their
+	/// outline if any, of a distance field font
+	///
+	/// \param width in pixels at the loaded size, the outline and the glow
+	/// together are clamped to getDistanceFieldSpread(). 0 disables it.
+	void setGlow(float width, const ofFloatColor & color);
+	float getGlowWidth() const;
+	const ofFloatColor & getGlowColor() const;
+	/// \}
+
 	void setDirection(Settings::Direction direction);
 protected:
 	/// \cond INTERNAL
 	
 	bool bLoadedOk;
+	bool bPrepared; ///< prepare() succeeded and uploadTextures() wasn't called yet
+	ofPixels atlasPixels; ///< rasterized by prepare(), until uploadTextures()
 	
 	std::vector <ofTTFCharacter> charOutlines;
 	std::vector <ofTTFCharacter> charOutlinesNonVFlipped;
@@ -378,6 +487,7 @@ protected:
 		long advance;
 		float tW,tH;
 		float t1,t2,v1,v2;
+		int atlasSlot; ///< cell in the dynamic atlas, -1 if not rasterized
 	};
 
 	struct glyph{
@@ -385,10 +495,10 @@ protected:
 		ofPixels pixels;
 	};
 
-	std::vector<glyphProps> cps; // properties for each character
+	mutable std::vector<glyphProps> cps; // properties for each character, grows on use with a dynamic atlas
 
   Settings settings;
-	std::unordered_map<uint32_t,size_t> glyphIndexMap;
+	mutable std::unordered_map<uint32_t,size_t> glyphIndexMap;
 
 
     int getKerning(uint32_t c, uint32_t prevC) const;
@@ -399,10 +509,37 @@ protected:
 	const glyphProps & getGlyphProperties(uint32_t glyph) const;
 	void iterateString(const std::string & str, float x, float y, bool vFlipped, std::function<void(uint32_t, glm::vec2)> f) const;
 	size_t indexForGlyph(uint32_t glyph) const;
+	const glyphProps & getAtlasGlyph(uint32_t glyph) const;
+	int allocateAtlasSlot() const;
+	void resetAtlas();
+	void invalidateLayouts() const;
 
 	ofTexture texAtlas;
 	mutable ofMesh stringQuads;
 
+	// dynamic atlas, glyph metrics are loaded into cps on first use
+	// and their pixels into fixed size cells in the atlas pages
+	struct atlasSlot{
+		uint32_t glyph;
+		uint64_t lastUse;
+		bool used;
+	};
+	mutable std::vector<ofTexture> atlasPages;
+	mutable std::vector<ofMesh> atlasPagesQuads; ///< quads for pages > 0
+	mutable std::vector<atlasSlot> atlasSlots;
+	mutable std::vector<int> freeAtlasSlots;
+	mutable uint64_t atlasUseCount;
+	int atlasCellWidth;
+	int atlasCellHeight;
+	int atlasCellsPerRow;
+	int atlasCellsPerPage;
+	mutable uint64_t layoutVersion;
+
+	float outlineWidth;
+	ofFloatColor outlineColor;
+	float glowWidth;
+	ofFloatColor glowColor;
+
 	/// \endcond
 
 private:
@@ -8,6 +8,7 @@
 
 #include "ofNoise.h"
 #include "ofPolyline.h"
+#include <atomic>
 
 using namespace std;
 
@@ -19,6 +20,107 @@ int ofNextPow2(int a){
 	return rval;
 }
 
+namespace{
+	// seed and generation of ofSeedRandom(), the threads seed their
+	// generators again when the generation changes
+	std::atomic<uint64_t> randomSeed(0);
+	std::atomic<uint32_t> randomGeneration(0);
+	std::atomic<uint32_t> nextRandomStream(0);
+
+	inline uint64_t splitMix64(uint64_t & x){
+		uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	struct ThreadRandomEngine{
+		ThreadRandomEngine()
+		:stream(nextRandomStream++)
+		,generation(randomGeneration.load() - 1){}
+		ofRandomEngine engine;
+		uint32_t stream;
+		uint32_t generation;
+	};
+
+	void setRandomSeed(uint64_t seed){
+		randomSeed = seed;
+		randomGeneration++;
+		srand((unsigned int)seed);
+	}
+}
+
+//--------------------------------------------------
+ofRandomEngine::ofRandomEngine(){
+	seed(0);
+}
+
+//--------------------------------------------------
+ofRandomEngine::ofRandomEngine(uint64_t seed, uint64_t stream){
+	this->seed(seed, stream);
+}
+
+//--------------------------------------------------
+void ofRandomEngine::seed(uint64_t seed, uint64_t stream){
+	uint64_t streamSeed = stream;
+	uint64_t x = seed ^ splitMix64(streamSeed);
+	uint64_t a = splitMix64(x);
+	uint64_t b = splitMix64(x);
+	state[0] = uint32_t(a);
+	state[1] = uint32_t(a >> 32);
+	state[2] = uint32_t(b);
+	state[3] = uint32_t(b >> 32);
+	if((state[0] | state[1] | state[2] | state[3]) == 0){
+		state[0] = 1;
+	}
+	hasNextGaussian = false;
+	nextGaussian = 0;
+}
+
+//--------------------------------------------------
+float ofRandomEngine::uniform(float x, float y){
+	float high = MAX(x, y);
+	float low = MIN(x, y);
+	if(high <= low){
+		return low;
+	}
+	float r = low + (high - low) * uniform();
+	// rounding can reach high with big ranges
+	return r < high ? r : std::nextafter(high, low);
+}
+
+//--------------------------------------------------
+float ofRandomEngine::gaussian(){
+	if(hasNextGaussian){
+		hasNextGaussian = false;
+		return nextGaussian;
+	}
+	// box muller, u1 in (0, 1] for the log
+	float u1 = 1.f - uniform();
+	float u2 = uniform();
+	float radius = std::sqrt(-2.f * std::log(u1));
+	float angle = float(TWO_PI) * u2;
+	nextGaussian = radius * std::sin(angle);
+	hasNextGaussian = true;
+	return radius * std::cos(angle);
+}
+
+//--------------------------------------------------
+ofRandomEngine & ofGetRandomEngine(){
+#ifdef HAS_TLS
+	thread_local ThreadRandomEngine random;
+#else
+	// shared by all the threads, like rand()
+	static ThreadRandomEngine random;
+#endif
+	uint32_t generation = randomGeneration.load(std::memory_order_relaxed);
+	if(random.generation != generation){
+		random.engine.seed(randomSeed.load(), random.stream);
+		random.generation = generation;
+	}
+	return random.engine;
+}
+
 //--------------------------------------------------
 void ofSeedRandom() {
 
@@ -26,46 +128,44 @@ void ofSeedRandom() {
 	// http://stackoverflow.com/questions/322938/recommended-way-to-initialize-srand
 
 	#ifdef TARGET_WIN32
-		srand(GetTickCount());
+		setRandomSeed(GetTickCount());
 	#elif !defined(TARGET_EMSCRIPTEN)
 		// use XOR'd second, microsecond precision AND pid as seed
 		struct timeval tv;
 		gettimeofday(&tv, 0);
 		long int n = (tv.tv_sec ^ tv.tv_usec) ^ getpid();
-		srand(n);
+		setRandomSeed(n);
 	#else
 		struct timeval tv;
 		gettimeofday(&tv, 0);
 		long int n = (tv.tv_sec ^ tv.tv_usec);
-		srand(n);
+		setRandomSeed(n);
 	#endif
 }
 
 //--------------------------------------------------
 void ofSeedRandom(int val) {
-	srand((long) val);
+	setRandomSeed((long) val);
 }
 
 //--------------------------------------------------
 float ofRandom(float max) {
-	return (max * rand() / float(RAND_MAX)) * (1.0f - std::numeric_limits<float>::epsilon());
+	return ofGetRandomEngine().uniform(0, max);
 }
 
 //--------------------------------------------------
 float ofRandom(float x, float y) {
-	float high = MAX(x, y);
-	float low = MIN(x, y);
-	return max(low, (low + ((high - low) * rand() / float(RAND_MAX))) * (1.0f - std::numeric_limits<float>::epsilon()));
+	return ofGetRandomEngine().uniform(x, y);
 }
 
 //--------------------------------------------------
 float ofRandomf() {
-	return -1.0f + (2.0f * rand() / float(RAND_MAX)) * (1.0f - std::numeric_limits<float>::epsilon());
+	return ofGetRandomEngine().uniform() * 2.f - 1.f;
 }
 
 //--------------------------------------------------
 float ofRandomuf() {
-	return (rand() / float(RAND_MAX)) * (1.0f - std::numeric_limits<float>::epsilon());
+	return ofGetRandomEngine().uniform();
 }
 
 //---- new to 006
@@ -5,15 +5,87 @@
 /// \file
 /// ofMath provides a collection of mathematical utilities and functions.
 ///
-/// \warning Many ofRandom-style functions wrap `rand()` which is not reentrant
-/// or thread safe.  To generate random numbers simultaneously in multiple
-/// threads, consider using c++11 uniform_real_distribution.
-///
-/// \sa http://en.cppreference.com/w/cpp/numeric/random/uniform_real_distribution
+/// The ofRandom-style functions use a fast generator per thread, see
+/// ofRandomEngine, so they can be called from several threads at the same
+/// time without locking. ofMathBatch.h has functions to fill whole arrays
+/// with random values.
 
 /// \name Random Numbers
 /// \{
 
+/// \brief A small and fast random number generator, xoshiro128+
+///
+/// Every thread has one, returned by ofGetRandomEngine(), that the
+/// ofRandom functions use. Objects that need a sequence that doesn't
+/// depend on other code calling ofRandom, like a particle system that
+/// has to look the same on every run, can have their own:
+///
+/// ~~~~{.cpp}
+/// ofRandomEngine random(1234);
+/// for(auto & p: particles){
+///     p.position = {random.uniform(-100, 100), random.uniform(-100, 100), 0};
+///     p.life = 2 + random.gaussian() * 0.5;
+/// }
+/// ~~~~
+///
+/// It also works with the distributions in <random>, as a
+/// UniformRandomBitGenerator.
+class ofRandomEngine{
+public:
+	typedef uint32_t result_type;
+
+	/// \brief Seeded with 0
+	ofRandomEngine();
+
+	/// \brief Seeded with seed, different streams give independent
+	/// sequences for the same seed
+	ofRandomEngine(uint64_t seed, uint64_t stream = 0);
+
+	void seed(uint64_t seed, uint64_t stream = 0);
+
+	/// \brief The next 32 random bits
+	result_type operator()(){
+		const uint32_t result = state[0] + state[3];
+		const uint32_t t = state[1] << 9;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = (state[3] << 11) | (state[3] >> 21);
+		return result;
+	}
+
+	static constexpr result_type min(){ return 0; }
+	static constexpr result_type max(){ return 0xFFFFFFFF; }
+
+	/// \brief A random number in [0, 1)
+	float uniform(){
+		// the upper bits are the best ones in xoshiro128+
+		return ((*this)() >> 8) * (1.f / 16777216.f);
+	}
+
+	/// \brief A random number in [min, max)
+	float uniform(float min, float max);
+
+	/// \brief A random number with a normal distribution of mean 0 and
+	/// standard deviation 1
+	float gaussian();
+
+private:
+	uint32_t state[4];
+	float nextGaussian;
+	bool hasNextGaussian;
+};
+
+/// \brief The generator of the calling thread, used by ofRandom
+///
+/// Each thread's generator is seeded from the last ofSeedRandom() seed and
+/// the order in which the threads first used it, the main thread being
+/// usually the first, so the results in a thread are reproducible as long
+/// as the threads start generating numbers in the same order.
+ofRandomEngine & ofGetRandomEngine();
+
 /// \brief Get a random floating point number between 0 and max.
 ///
 /// A random number in the range [0, max) will be returned.
@@ -24,8 +96,6 @@
 /// float randomNumber = ofRandom(20);
 /// ~~~~~
 ///
-/// \warning ofRandom wraps C++'s `rand()` which is not reentrant or thread safe.
-///
 /// \param max The maximum value of the random number.
 float ofRandom(float max); 
 
@@ -39,8 +109,6 @@ float ofRandom(float max);
 /// float randomNumber = ofRandom(-30, 20);
 /// ~~~~~
 ///
-/// \warning ofRandom wraps `rand()` which is not reentrant or thread safe.
-///
 /// \param val0 the minimum value of the random number.
 /// \param val1 The maximum value of the random number.
 /// \returns A random floating point number between val0 and val1.
@@ -48,15 +116,11 @@ float ofRandom(float val0, float val1);
 
 /// \brief Get a random floating point number.
 ///
-/// \warning ofRandom wraps `rand()` which is not reentrant or thread safe.
-///
 /// \returns A random floating point number between -1 and 1.
 float ofRandomf();
 
 /// \brief Get a random unsigned floating point number.
 ///
-/// \warning ofRandom wraps `rand()` which is not reentrant or thread safe.
-///
 /// \returns A random floating point number between 0 and 1.
 float ofRandomuf();
 
@@ -65,8 +129,6 @@ float ofRandomuf();
 ///
 /// A random number in the range [0, ofGetWidth()) will be returned.
 ///
-/// \warning ofRandom wraps `rand()` which is not reentrant or thread safe.
-///
 /// \returns a random number between 0 and ofGetWidth().
 float ofRandomWidth();
 
@@ -74,8 +136,6 @@ float ofRandomWidth();
 ///
 /// A random number in the range [0, ofGetHeight()) will be returned.
 ///
-/// \warning ofRandom wraps `rand()` which is not reentrant or thread safe.
-///
 /// \returns a random number between 0 and ofGetHeight().
 float ofRandomHeight();
 
@@ -83,6 +143,9 @@ float ofRandomHeight();
 ///
 /// This seeds the random number generator with an acceptably random value, 
 /// generated from clock time and the PID.
+///
+/// Every thread's generator is seeded again the next time it's used,
+/// `rand()` is seeded too.
 void ofSeedRandom();
 
 /// \brief Seed the random number generator.
@@ -0,0 +1,1041 @@
+#include "ofMathBatch.h"
+#include "ofVectorMath.h"
+#include "ofNoise.h"
+#include "ofTaskPool.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define OF_MATH_BATCH_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define OF_MATH_BATCH_NEON
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OF_MATH_BATCH_SSE2
+#endif
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "the batch functions need tightly packed vectors");
+static_assert(sizeof(ofVec3f) == sizeof(glm::vec3), "the batch functions need tightly packed vectors");
+
+namespace{
+	// the vectors are processed 4 at a time, 12 floats loaded into 3
+	// registers and split in x, y and z so every operation works on 4 values.
+	// everything is loaded before storing so dst can be the same as src
+#if defined(OF_MATH_BATCH_SSE)
+	struct Vec3x4{
+		__m128 x, y, z;
+	};
+
+	inline Vec3x4 load(const glm::vec3 * v){
+		const float * p = reinterpret_cast<const float*>(v);
+		__m128 a = _mm_loadu_ps(p);     // x0 y0 z0 x1
+		__m128 b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+		__m128 c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+		Vec3x4 r;
+		r.x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3,3,0,0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,2,0));
+		r.y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+		r.z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,3,0,0)), _MM_SHUFFLE(2,0,2,0));
+		return r;
+	}
+
+	inline void store(glm::vec3 * v, const Vec3x4 & r){
+		float * p = reinterpret_cast<float*>(v);
+		__m128 a = _mm_shuffle_ps(_mm_shuffle_ps(r.x, r.y, _MM_SHUFFLE(0,0,0,0)), _mm_shuffle_ps(r.z, r.x, _MM_SHUFFLE(1,1,0,0)), _MM_SHUFFLE(2,0,2,0));
+		__m128 b = _mm_shuffle_ps(_mm_shuffle_ps(r.y, r.z, _MM_SHUFFLE(1,1,1,1)), _mm_shuffle_ps(r.x, r.y, _MM_SHUFFLE(2,2,2,2)), _MM_SHUFFLE(2,0,2,0));
+		__m128 c = _mm_shuffle_ps(_mm_shuffle_ps(r.z, r.x, _MM_SHUFFLE(3,3,2,2)), _mm_shuffle_ps(r.y, r.z, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(2,0,2,0));
+		_mm_storeu_ps(p, a);
+		_mm_storeu_ps(p + 4, b);
+		_mm_storeu_ps(p + 8, c);
+	}
+
+	inline __m128 splat(float v){
+		return _mm_set1_ps(v);
+	}
+
+	inline __m128 madd(__m128 a, __m128 b, __m128 c){
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+	}
+
+	inline __m128 mul(__m128 a, __m128 b){
+		return _mm_mul_ps(a, b);
+	}
+
+	inline __m128 div(__m128 a, __m128 b){
+		return _mm_div_ps(a, b);
+	}
+
+	inline __m128 invLengthOrZero(__m128 length2){
+		__m128 inv = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(length2));
+		return _mm_and_ps(_mm_cmpgt_ps(length2, _mm_setzero_ps()), inv);
+	}
+
+	inline void lerp(const float * from, const float * to, __m128 amount, float * dst){
+		__m128 a = _mm_loadu_ps(from);
+		__m128 b = _mm_loadu_ps(to);
+		_mm_storeu_ps(dst, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), amount)));
+	}
+
+	inline void addScaled(float * dst, const float * src, __m128 scale){
+		_mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_loadu_ps(src), scale)));
+	}
+	#define OF_MATH_BATCH_SIMD
+#elif defined(OF_MATH_BATCH_NEON)
+	struct Vec3x4{
+		float32x4_t x, y, z;
+	};
+
+	inline Vec3x4 load(const glm::vec3 * v){
+		float32x4x3_t l = vld3q_f32(reinterpret_cast<const float*>(v));
+		Vec3x4 r;
+		r.x = l.val[0];
+		r.y = l.val[1];
+		r.z = l.val[2];
+		return r;
+	}
+
+	inline void store(glm::vec3 * v, const Vec3x4 & r){
+		float32x4x3_t s;
+		s.val[0] = r.x;
+		s.val[1] = r.y;
+		s.val[2] = r.z;
+		vst3q_f32(reinterpret_cast<float*>(v), s);
+	}
+
+	inline float32x4_t splat(float v){
+		return vdupq_n_f32(v);
+	}
+
+	inline float32x4_t madd(float32x4_t a, float32x4_t b, float32x4_t c){
+		return vmlaq_f32(c, a, b);
+	}
+
+	inline float32x4_t mul(float32x4_t a, float32x4_t b){
+		return vmulq_f32(a, b);
+	}
+
+	inline float32x4_t div(float32x4_t a, float32x4_t b){
+		// reciprocal estimate refined twice, close to a real division
+		float32x4_t inv = vrecpeq_f32(b);
+		inv = vmulq_f32(vrecpsq_f32(b, inv), inv);
+		inv = vmulq_f32(vrecpsq_f32(b, inv), inv);
+		return vmulq_f32(a, inv);
+	}
+
+	inline float32x4_t invLengthOrZero(float32x4_t length2){
+		float32x4_t inv = vrsqrteq_f32(length2);
+		inv = vmulq_f32(vrsqrtsq_f32(vmulq_f32(length2, inv), inv), inv);
+		inv = vmulq_f32(vrsqrtsq_f32(vmulq_f32(length2, inv), inv), inv);
+		uint32x4_t nonZero = vcgtq_f32(length2, vdupq_n_f32(0));
+		return vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(inv)));
+	}
+
+	inline void lerp(const float * from, const float * to, float32x4_t amount, float * dst){
+		float32x4_t a = vld1q_f32(from);
+		float32x4_t b = vld1q_f32(to);
+		vst1q_f32(dst, vmlaq_f32(a, vsubq_f32(b, a), amount));
+	}
+
+	inline void addScaled(float * dst, const float * src, float32x4_t scale){
+		vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), vld1q_f32(src), scale));
+	}
+	#define OF_MATH_BATCH_SIMD
+#endif
+
+	bool isAffine(const glm::mat4 & m){
+		return m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1;
+	}
+
+	inline glm::vec3 transformPoint(const glm::mat4 & m, const glm::vec3 & v, bool affine){
+		glm::vec3 r(m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0],
+		            m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1],
+		            m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z + m[3][2]);
+		if(!affine){
+			r /= m[0][3] * v.x + m[1][3] * v.y + m[2][3] * v.z + m[3][3];
+		}
+		return r;
+	}
+
+	inline glm::vec3 normalizeOrZero(const glm::vec3 & v){
+		float length2 = v.x * v.x + v.y * v.y + v.z * v.z;
+		return length2 > 0 ? v / std::sqrt(length2) : glm::vec3(0);
+	}
+}
+
+//--------------------------------------------------
+void ofTransformPoints(const glm::mat4 & m, const glm::vec3 * src, glm::vec3 * dst, std::size_t count){
+	bool affine = isAffine(m);
+	std::size_t i = 0;
+#ifdef OF_MATH_BATCH_SIMD
+	auto m00 = splat(m[0][0]), m10 = splat(m[1][0]), m20 = splat(m[2][0]), m30 = splat(m[3][0]);
+	auto m01 = splat(m[0][1]), m11 = splat(m[1][1]), m21 = splat(m[2][1]), m31 = splat(m[3][1]);
+	auto m02 = splat(m[0][2]), m12 = splat(m[1][2]), m22 = splat(m[2][2]), m32 = splat(m[3][2]);
+	auto m03 = splat(m[0][3]), m13 = splat(m[1][3]), m23 = splat(m[2][3]), m33 = splat(m[3][3]);
+	for(; i + 4 <= count; i += 4){
+		Vec3x4 v = load(src + i);
+		Vec3x4 r;
+		r.x = madd(m00, v.x, madd(m10, v.y, madd(m20, v.z, m30)));
+		r.y = madd(m01, v.x, madd(m11, v.y, madd(m21, v.z, m31)));
+		r.z = madd(m02, v.x, madd(m12, v.y, madd(m22, v.z, m32)));
+		if(!affine){
+			auto w = madd(m03, v.x, madd(m13, v.y, madd(m23, v.z, m33)));
+			r.x = div(r.x, w);
+			r.y = div(r.y, w);
+			r.z = div(r.z, w);
+		}
+		store(dst + i, r);
+	}
+#endif
+	for(; i < count; i++){
+		dst[i] = transformPoint(m, src[i], affine);
+	}
+}
+
+//--------------------------------------------------
+void ofTransformPoints(const glm::mat4 & matrix, std::vector<glm::vec3> & points){
+	ofTransformPoints(matrix, points.data(), points.data(), points.size());
+}
+
+//--------------------------------------------------
+void ofTransformPoints(const ofMatrix4x4 & matrix, const ofVec3f * src, ofVec3f * dst, std::size_t count){
+	// ofMatrix4x4 has the same layout as glm::mat4 and preMult is the same
+	// as multiplying the glm matrix by the vector
+	ofTransformPoints(toGlm(matrix), reinterpret_cast<const glm::vec3*>(src), reinterpret_cast<glm::vec3*>(dst), count);
+}
+
+//--------------------------------------------------
+void ofTransformDirections(const glm::mat4 & m, const glm::vec3 * src, glm::vec3 * dst, std::size_t count){
+	std::size_t i = 0;
+#ifdef OF_MATH_BATCH_SIMD
+	auto m00 = splat(m[0][0]), m10 = splat(m[1][0]), m20 = splat(m[2][0]);
+	auto m01 = splat(m[0][1]), m11 = splat(m[1][1]), m21 = splat(m[2][1]);
+	auto m02 = splat(m[0][2]), m12 = splat(m[1][2]), m22 = splat(m[2][2]);
+	for(; i + 4 <= count; i += 4){
+		Vec3x4 v = load(src + i);
+		Vec3x4 r;
+		r.x = madd(m00, v.x, madd(m10, v.y, mul(m20, v.z)));
+		r.y = madd(m01, v.x, madd(m11, v.y, mul(m21, v.z)));
+		r.z = madd(m02, v.x, madd(m12, v.y, mul(m22, v.z)));
+		store(dst + i, r);
+	}
+#endif
+	for(; i < count; i++){
+		const glm::vec3 & v = src[i];
+		dst[i] = glm::vec3(m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z,
+		                   m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z,
+		                   m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z);
+	}
+}
+
+//--------------------------------------------------
+void ofNormalizeArray(const glm::vec3 * src, glm::vec3 * dst, std::size_t count){
+	std::size_t i = 0;
+#ifdef OF_MATH_BATCH_SIMD
+	for(; i + 4 <= count; i += 4){
+		Vec3x4 v = load(src + i);
+		auto inv = invLengthOrZero(madd(v.x, v.x, madd(v.y, v.y, mul(v.z, v.z))));
+		v.x = mul(v.x, inv);
+		v.y = mul(v.y, inv);
+		v.z = mul(v.z, inv);
+		store(dst + i, v);
+	}
+#endif
+	for(; i < count; i++){
+		dst[i] = normalizeOrZero(src[i]);
+	}
+}
+
+//--------------------------------------------------
+void ofNormalizeArray(std::vector<glm::vec3> & vectors){
+	ofNormalizeArray(vectors.data(), vectors.data(), vectors.size());
+}
+
+//--------------------------------------------------
+void ofNormalizeArray(const ofVec3f * src, ofVec3f * dst, std::size_t count){
+	ofNormalizeArray(reinterpret_cast<const glm::vec3*>(src), reinterpret_cast<glm::vec3*>(dst), count);
+}
+
+//--------------------------------------------------
+void ofLerpArray(const glm::vec3 * from, const glm::vec3 * to, float amount, glm::vec3 * dst, std::size_t count){
+	// the same operation on every float, no need to split the components
+	const float * a = reinterpret_cast<const float*>(from);
+	const float * b = reinterpret_cast<const float*>(to);
+	float * d = reinterpret_cast<float*>(dst);
+	std::size_t total = count * 3;
+	std::size_t i = 0;
+#ifdef OF_MATH_BATCH_SIMD
+	auto amount4 = splat(amount);
+	for(; i + 4 <= total; i += 4){
+		lerp(a + i, b + i, amount4, d + i);
+	}
+#endif
+	for(; i < total; i++){
+		d[i] = a[i] + (b[i] - a[i]) * amount;
+	}
+}
+
+//--------------------------------------------------
+void ofLerpArray(const ofVec3f * from, const ofVec3f * to, float amount, ofVec3f * dst, std::size_t count){
+	ofLerpArray(reinterpret_cast<const glm::vec3*>(from), reinterpret_cast<const glm::vec3*>(to), amount, reinterpret_cast<glm::vec3*>(dst), count);
+}
+
+//--------------------------------------------------
+void ofAddScaledArray(glm::vec3 * dst, const glm::vec3 * src, float scale, std::size_t count){
+	const float * s = reinterpret_cast<const float*>(src);
+	float * d = reinterpret_cast<float*>(dst);
+	std::size_t total = count * 3;
+	std::size_t i = 0;
+#ifdef OF_MATH_BATCH_SIMD
+	auto scale4 = splat(scale);
+	for(; i + 4 <= total; i += 4){
+		addScaled(d + i, s + i, scale4);
+	}
+#endif
+	for(; i < total; i++){
+		d[i] += s[i] * scale;
+	}
+}
+
+//--------------------------------------------------
+void ofAddScaledArray(ofVec3f * dst, const ofVec3f * src, float scale, std::size_t count){
+	ofAddScaledArray(reinterpret_cast<glm::vec3*>(dst), reinterpret_cast<const glm::vec3*>(src), scale, count);
+}
+
+namespace{
+	// batch noise, the same simplex noise as ofNoise.h evaluated for 4
+	// points at a time, step by step in the same order so the results are
+	// the same as calling ofNoise for each of them. only the permutation
+	// table lookups are done one lane at a time
+#if defined(OF_MATH_BATCH_SSE2)
+	typedef __m128 Float4;
+	typedef __m128 Mask4;
+	typedef __m128i Int4;
+
+	inline Float4 add(Float4 a, Float4 b){ return _mm_add_ps(a, b); }
+	inline Float4 sub(Float4 a, Float4 b){ return _mm_sub_ps(a, b); }
+	inline Float4 maxZero(Float4 a){ return _mm_max_ps(a, _mm_setzero_ps()); }
+	inline Float4 toFloat(Int4 a){ return _mm_cvtepi32_ps(a); }
+	inline Float4 loadFloat(const float * p){ return _mm_loadu_ps(p); }
+	inline void storeFloat(float * p, Float4 a){ _mm_storeu_ps(p, a); }
+
+	inline Int4 addInt(Int4 a, Int4 b){ return _mm_add_epi32(a, b); }
+	inline Int4 andInt(Int4 a, int b){ return _mm_and_si128(a, _mm_set1_epi32(b)); }
+	inline Int4 splatInt(int a){ return _mm_set1_epi32(a); }
+	inline Int4 loadInt(const int32_t * p){ return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+	inline void storeInt(int32_t * p, Int4 a){ _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+
+	// FASTFLOOR: truncate and subtract 1 for anything <= 0
+	inline Int4 fastFloor(Float4 a){
+		return _mm_add_epi32(_mm_cvttps_epi32(a), _mm_castps_si128(_mm_cmple_ps(a, _mm_setzero_ps())));
+	}
+
+	inline Mask4 greater(Float4 a, Float4 b){ return _mm_cmpgt_ps(a, b); }
+	inline Mask4 greaterEqual(Float4 a, Float4 b){ return _mm_cmpge_ps(a, b); }
+	inline Mask4 equalInt(Int4 a, int b){ return _mm_castsi128_ps(_mm_cmpeq_epi32(a, _mm_set1_epi32(b))); }
+	inline Mask4 maskAnd(Mask4 a, Mask4 b){ return _mm_and_ps(a, b); }
+	inline Mask4 maskOr(Mask4 a, Mask4 b){ return _mm_or_ps(a, b); }
+	inline Mask4 maskNot(Mask4 a){ return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+	inline Float4 select(Mask4 m, Float4 a, Float4 b){ return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+	inline Float4 maskToFloat(Mask4 m){ return _mm_and_ps(m, _mm_set1_ps(1.f)); }
+	inline Int4 maskToInt(Mask4 m){ return _mm_and_si128(_mm_castps_si128(m), _mm_set1_epi32(1)); }
+
+	// -a where h & bit is set
+	inline Float4 negateIf(Int4 h, int bit, Float4 a){
+		__m128i clear = _mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(bit)), _mm_setzero_si128());
+		__m128i sign = _mm_andnot_si128(clear, _mm_set1_epi32(int(0x80000000)));
+		return _mm_xor_ps(a, _mm_castsi128_ps(sign));
+	}
+
+	struct Vec2x4{
+		Float4 x, y;
+	};
+
+	inline Vec2x4 load(const glm::vec2 * v){
+		const float * p = reinterpret_cast<const float*>(v);
+		__m128 a = _mm_loadu_ps(p);     // x0 y0 x1 y1
+		__m128 b = _mm_loadu_ps(p + 4); // x2 y2 x3 y3
+		Vec2x4 r;
+		r.x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+		r.y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+		return r;
+	}
+	#define OF_MATH_BATCH_NOISE_SIMD
+#elif defined(OF_MATH_BATCH_NEON)
+	typedef float32x4_t Float4;
+	typedef uint32x4_t Mask4;
+	typedef int32x4_t Int4;
+
+	inline Float4 add(Float4 a, Float4 b){ return vaddq_f32(a, b); }
+	inline Float4 sub(Float4 a, Float4 b){ return vsubq_f32(a, b); }
+	inline Float4 maxZero(Float4 a){ return vmaxq_f32(a, vdupq_n_f32(0)); }
+	inline Float4 toFloat(Int4 a){ return vcvtq_f32_s32(a); }
+	inline Float4 loadFloat(const float * p){ return vld1q_f32(p); }
+	inline void storeFloat(float * p, Float4 a){ vst1q_f32(p, a); }
+
+	inline Int4 addInt(Int4 a, Int4 b){ return vaddq_s32(a, b); }
+	inline Int4 andInt(Int4 a, int b){ return vandq_s32(a, vdupq_n_s32(b)); }
+	inline Int4 splatInt(int a){ return vdupq_n_s32(a); }
+	inline Int4 loadInt(const int32_t * p){ return vld1q_s32(p); }
+	inline void storeInt(int32_t * p, Int4 a){ vst1q_s32(p, a); }
+
+	// FASTFLOOR: truncate and subtract 1 for anything <= 0
+	inline Int4 fastFloor(Float4 a){
+		return vaddq_s32(vcvtq_s32_f32(a), vreinterpretq_s32_u32(vcleq_f32(a, vdupq_n_f32(0))));
+	}
+
+	inline Mask4 greater(Float4 a, Float4 b){ return vcgtq_f32(a, b); }
+	inline Mask4 greaterEqual(Float4 a, Float4 b){ return vcgeq_f32(a, b); }
+	inline Mask4 equalInt(Int4 a, int b){ return vceqq_s32(a, vdupq_n_s32(b)); }
+	inline Mask4 maskAnd(Mask4 a, Mask4 b){ return vandq_u32(a, b); }
+	inline Mask4 maskOr(Mask4 a, Mask4 b){ return vorrq_u32(a, b); }
+	inline Mask4 maskNot(Mask4 a){ return vmvnq_u32(a); }
+	inline Float4 select(Mask4 m, Float4 a, Float4 b){ return vbslq_f32(m, a, b); }
+	inline Float4 maskToFloat(Mask4 m){ return vbslq_f32(m, vdupq_n_f32(1), vdupq_n_f32(0)); }
+	inline Int4 maskToInt(Mask4 m){ return vreinterpretq_s32_u32(vandq_u32(m, vdupq_n_u32(1))); }
+
+	// -a where h & bit is set
+	inline Float4 negateIf(Int4 h, int bit, Float4 a){
+		uint32x4_t sign = vandq_u32(vtstq_s32(h, vdupq_n_s32(bit)), vdupq_n_u32(0x80000000));
+		return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), sign));
+	}
+
+	struct Vec2x4{
+		Float4 x, y;
+	};
+
+	inline Vec2x4 load(const glm::vec2 * v){
+		float32x4x2_t l = vld2q_f32(reinterpret_cast<const float*>(v));
+		Vec2x4 r;
+		r.x = l.val[0];
+		r.y = l.val[1];
+		return r;
+	}
+	#define OF_MATH_BATCH_NOISE_SIMD
+#endif
+
+	// the constants in ofNoise.h
+	const float skew2 = 0.366025403f;
+	const float unskew2 = 0.211324865f;
+	const float skew3 = 0.333333333f;
+	const float unskew3 = 0.166666667f;
+
+	// samples per task when filling big buffers in parallel
+	const std::size_t noiseGrainSize = 4096;
+
+#ifdef OF_MATH_BATCH_NOISE_SIMD
+	// splat and mul come from the vector functions above
+	inline Float4 grad1(Int4 h, Float4 x){
+		Float4 grad = add(splat(1.f), toFloat(andInt(h, 7)));
+		return mul(negateIf(h, 8, grad), x);
+	}
+
+	inline Float4 grad2(Int4 h, Float4 x, Float4 y){
+		Mask4 lt4 = equalInt(andInt(h, 4), 0);
+		Float4 u = select(lt4, x, y);
+		Float4 v = select(lt4, y, x);
+		return add(negateIf(h, 1, u), negateIf(h, 2, mul(splat(2.f), v)));
+	}
+
+	inline Float4 grad3(Int4 h, Float4 x, Float4 y, Float4 z){
+		Float4 u = select(equalInt(andInt(h, 8), 0), x, y);
+		Float4 v = select(equalInt(andInt(h, 12), 0), y, select(equalInt(andInt(h, 13), 12), x, z));
+		return add(negateIf(h, 1, u), negateIf(h, 2, v));
+	}
+
+	// contribution of a corner, 0 if it's too far
+	inline Float4 corner2(float radius, Float4 x, Float4 y, const int32_t * hash){
+		Float4 t = maxZero(sub(sub(splat(radius), mul(x, x)), mul(y, y)));
+		t = mul(t, t);
+		return mul(mul(t, t), grad2(loadInt(hash), x, y));
+	}
+
+	inline Float4 corner3(float radius, Float4 x, Float4 y, Float4 z, const int32_t * hash){
+		Float4 t = maxZero(sub(sub(sub(splat(radius), mul(x, x)), mul(y, y)), mul(z, z)));
+		t = mul(t, t);
+		return mul(mul(t, t), grad3(loadInt(hash), x, y, z));
+	}
+
+	inline Float4 simplex1(Float4 x){
+		Int4 i0 = fastFloor(x);
+		Float4 x0 = sub(x, toFloat(i0));
+		Float4 x1 = sub(x0, splat(1.f));
+
+		int32_t i[4], h0[4], h1[4];
+		storeInt(i, i0);
+		for(int l = 0; l < 4; l++){
+			h0[l] = perm[i[l] & 0xff];
+			h1[l] = perm[(i[l] + 1) & 0xff];
+		}
+
+		Float4 t0 = sub(splat(1.f), mul(x0, x0));
+		t0 = mul(t0, t0);
+		Float4 n0 = mul(mul(t0, t0), grad1(loadInt(h0), x0));
+		Float4 t1 = sub(splat(1.f), mul(x1, x1));
+		t1 = mul(t1, t1);
+		Float4 n1 = mul(mul(t1, t1), grad1(loadInt(h1), x1));
+		return mul(splat(0.25f), add(n0, n1));
+	}
+
+	inline Float4 simplex2(Float4 x, Float4 y){
+		Float4 s = mul(add(x, y), splat(skew2));
+		Int4 i = fastFloor(add(x, s));
+		Int4 j = fastFloor(add(y, s));
+		Float4 t = mul(toFloat(addInt(i, j)), splat(unskew2));
+		Float4 x0 = sub(x, sub(toFloat(i), t));
+		Float4 y0 = sub(y, sub(toFloat(j), t));
+
+		Mask4 lower = greater(x0, y0);
+		Float4 x1 = add(sub(x0, maskToFloat(lower)), splat(unskew2));
+		Float4 y1 = add(sub(y0, maskToFloat(maskNot(lower))), splat(unskew2));
+		Float4 x2 = add(sub(x0, splat(1.f)), splat(2.f * unskew2));
+		Float4 y2 = add(sub(y0, splat(1.f)), splat(2.f * unskew2));
+
+		int32_t ii[4], jj[4], i1[4], h0[4], h1[4], h2[4];
+		storeInt(ii, andInt(i, 0xff));
+		storeInt(jj, andInt(j, 0xff));
+		storeInt(i1, maskToInt(lower));
+		for(int l = 0; l < 4; l++){
+			int j1 = 1 - i1[l];
+			h0[l] = perm[ii[l] + perm[jj[l]]];
+			h1[l] = perm[ii[l] + i1[l] + perm[jj[l] + j1]];
+			h2[l] = perm[ii[l] + 1 + perm[jj[l] + 1]];
+		}
+
+		Float4 n0 = corner2(0.5f, x0, y0, h0);
+		Float4 n1 = corner2(0.5f, x1, y1, h1);
+		Float4 n2 = corner2(0.5f, x2, y2, h2);
+		return mul(splat(40.f), add(add(n0, n1), n2));
+	}
+
+	inline Float4 simplex3(Float4 x, Float4 y, Float4 z){
+		Float4 s = mul(add(add(x, y), z), splat(skew3));
+		Int4 i = fastFloor(add(x, s));
+		Int4 j = fastFloor(add(y, s));
+		Int4 k = fastFloor(add(z, s));
+		Float4 t = mul(toFloat(addInt(addInt(i, j), k)), splat(unskew3));
+		Float4 x0 = sub(x, sub(toFloat(i), t));
+		Float4 y0 = sub(y, sub(toFloat(j), t));
+		Float4 z0 = sub(z, sub(toFloat(k), t));
+
+		// the branches in ofNoise.h that choose the simplex, as masks
+		Mask4 xy = greaterEqual(x0, y0);
+		Mask4 yz = greaterEqual(y0, z0);
+		Mask4 xz = greaterEqual(x0, z0);
+		Mask4 i1 = maskAnd(xy, xz);
+		Mask4 j1 = maskAnd(maskNot(xy), yz);
+		Mask4 k1 = maskNot(maskOr(xz, yz));
+		Mask4 i2 = maskOr(xy, xz);
+		Mask4 j2 = maskOr(maskNot(xy), yz);
+		Mask4 k2 = maskNot(maskAnd(xz, yz));
+
+		Float4 x1 = add(sub(x0, maskToFloat(i1)), splat(unskew3));
+		Float4 y1 = add(sub(y0, maskToFloat(j1)), splat(unskew3));
+		Float4 z1 = add(sub(z0, maskToFloat(k1)), splat(unskew3));
+		Float4 x2 = add(sub(x0, maskToFloat(i2)), splat(2.f * unskew3));
+		Float4 y2 = add(sub(y0, maskToFloat(j2)), splat(2.f * unskew3));
+		Float4 z2 = add(sub(z0, maskToFloat(k2)), splat(2.f * unskew3));
+		Float4 x3 = add(sub(x0, splat(1.f)), splat(3.f * unskew3));
+		Float4 y3 = add(sub(y0, splat(1.f)), splat(3.f * unskew3));
+		Float4 z3 = add(sub(z0, splat(1.f)), splat(3.f * unskew3));
+
+		int32_t ii[4], jj[4], kk[4], o1[3][4], o2[3][4], h0[4], h1[4], h2[4], h3[4];
+		storeInt(ii, andInt(i, 0xff));
+		storeInt(jj, andInt(j, 0xff));
+		storeInt(kk, andInt(k, 0xff));
+		storeInt(o1[0], maskToInt(i1));
+		storeInt(o1[1], maskToInt(j1));
+		storeInt(o1[2], maskToInt(k1));
+		storeInt(o2[0], maskToInt(i2));
+		storeInt(o2[1], maskToInt(j2));
+		storeInt(o2[2], maskToInt(k2));
+		for(int l = 0; l < 4; l++){
+			h0[l] = perm[ii[l] + perm[jj[l] + perm[kk[l]]]];
+			h1[l] = perm[ii[l] + o1[0][l] + perm[jj[l] + o1[1][l] + perm[kk[l] + o1[2][l]]]];
+			h2[l] = perm[ii[l] + o2[0][l] + perm[jj[l] + o2[1][l] + perm[kk[l] + o2[2][l]]]];
+			h3[l] = perm[ii[l] + 1 + perm[jj[l] + 1 + perm[kk[l] + 1]]];
+		}
+
+		Float4 n0 = corner3(0.6f, x0, y0, z0, h0);
+		Float4 n1 = corner3(0.6f, x1, y1, z1, h1);
+		Float4 n2 = corner3(0.6f, x2, y2, z2, h2);
+		Float4 n3 = corner3(0.6f, x3, y3, z3, h3);
+		return mul(splat(32.f), add(add(add(n0, n1), n2), n3));
+	}
+
+	inline Float4 scaled(Float4 noise, float scale, float offset){
+		return add(mul(noise, splat(scale)), splat(offset));
+	}
+
+	// 0, 1, 2, 3 to get the coordinates of 4 consecutive samples in a grid
+	inline Float4 lanes(){
+		static const float l[4] = {0, 1, 2, 3};
+		return loadFloat(l);
+	}
+#endif
+
+	// ofNoise is the signed noise * 0.5 + 0.5, ofSignedNoise * 1 + 0
+	void fillNoise(const float * x, float * dst, std::size_t begin, std::size_t end, float scale, float offset){
+		std::size_t i = begin;
+#ifdef OF_MATH_BATCH_NOISE_SIMD
+		for(; i + 4 <= end; i += 4){
+			storeFloat(dst + i, scaled(simplex1(loadFloat(x + i)), scale, offset));
+		}
+#endif
+		for(; i < end; i++){
+			dst[i] = _slang_library_noise1(x[i]) * scale + offset;
+		}
+	}
+
+	void fillNoise(const glm::vec2 * p, float * dst, std::size_t begin, std::size_t end, float scale, float offset){
+		std::size_t i = begin;
+#ifdef OF_MATH_BATCH_NOISE_SIMD
+		for(; i + 4 <= end; i += 4){
+			Vec2x4 v = load(p + i);
+			storeFloat(dst + i, scaled(simplex2(v.x, v.y), scale, offset));
+		}
+#endif
+		for(; i < end; i++){
+			dst[i] = _slang_library_noise2(p[i].x, p[i].y) * scale + offset;
+		}
+	}
+
+	void fillNoise(const glm::vec3 * p, float * dst, std::size_t begin, std::size_t end, float scale, float offset){
+		std::size_t i = begin;
+#ifdef OF_MATH_BATCH_NOISE_SIMD
+		for(; i + 4 <= end; i += 4){
+			Vec3x4 v = load(p + i);
+			storeFloat(dst + i, scaled(simplex3(v.x, v.y, v.z), scale, offset));
+		}
+#endif
+		for(; i < end; i++){
+			dst[i] = _slang_library_noise3(p[i].x, p[i].y, p[i].z) * scale + offset;
+		}
+	}
+
+	// 4D noise walks a lookup table per sample, it's only split in threads
+	void fillNoise(const glm::vec4 * p, float * dst, std::size_t begin, std::size_t end, float scale, float offset){
+		for(std::size_t i = begin; i < end; i++){
+			dst[i] = _slang_library_noise4(p[i].x, p[i].y, p[i].z, p[i].w) * scale + offset;
+		}
+	}
+
+	void fillNoiseRow(float x0, float stepX, float y, float * row, std::size_t width, float scale, float offset){
+		std::size_t x = 0;
+#ifdef OF_MATH_BATCH_NOISE_SIMD
+		Float4 y4 = splat(y);
+		for(; x + 4 <= width; x += 4){
+			Float4 x4 = add(splat(x0), mul(add(splat(float(x)), lanes()), splat(stepX)));
+			storeFloat(row + x, scaled(simplex2(x4, y4), scale, offset));
+		}
+#endif
+		for(; x < width; x++){
+			row[x] = _slang_library_noise2(x0 + float(x) * stepX, y) * scale + offset;
+		}
+	}
+
+	void fillNoiseRow(float x0, float stepX, float y, float z, float * row, std::size_t width, float scale, float offset){
+		std::size_t x = 0;
+#ifdef OF_MATH_BATCH_NOISE_SIMD
+		Float4 y4 = splat(y);
+		Float4 z4 = splat(z);
+		for(; x + 4 <= width; x += 4){
+			Float4 x4 = add(splat(x0), mul(add(splat(float(x)), lanes()), splat(stepX)));
+			storeFloat(row + x, scaled(simplex3(x4, y4, z4), scale, offset));
+		}
+#endif
+		for(; x < width; x++){
+			row[x] = _slang_library_noise3(x0 + float(x) * stepX, y, z) * scale + offset;
+		}
+	}
+
+	template<typename Point>
+	void fillNoise(const Point * points, float * dst, std::size_t count, float scale, float offset){
+		ofGetTaskPool().parallelFor(0, count, [&](std::size_t begin, std::size_t end){
+			fillNoise(points, dst, begin, end, scale, offset);
+		}, noiseGrainSize);
+	}
+
+	void fillNoiseGrid(const glm::vec2 & origin, const glm::vec2 & step, std::size_t width, std::size_t height, float * dst, float scale, float offset){
+		if(width == 0) return;
+		std::size_t rowsPerTask = std::max<std::size_t>(noiseGrainSize / width, 1);
+		ofGetTaskPool().parallelFor(0, height, [&](std::size_t begin, std::size_t end){
+			for(std::size_t y = begin; y < end; y++){
+				fillNoiseRow(origin.x, step.x, origin.y + float(y) * step.y, dst + y * width, width, scale, offset);
+			}
+		}, rowsPerTask);
+	}
+
+	void fillNoiseGrid(const glm::vec3 & origin, const glm::vec3 & step, std::size_t width, std::size_t height, std::size_t depth, float * dst, float scale, float offset){
+		if(width == 0) return;
+		std::size_t rowsPerTask = std::max<std::size_t>(noiseGrainSize / width, 1);
+		ofGetTaskPool().parallelFor(0, height * depth, [&](std::size_t begin, std::size_t end){
+			for(std::size_t row = begin; row < end; row++){
+				std::size_t y = row % height;
+				std::size_t z = row / height;
+				fillNoiseRow(origin.x, step.x, origin.y + float(y) * step.y, origin.z + float(z) * step.z, dst + row * width, width, scale, offset);
+			}
+		}, rowsPerTask);
+	}
+}
+
+//--------------------------------------------------
+void ofNoise(const float * x, float * dst, std::size_t count){
+	fillNoise(x, dst, count, 0.5f, 0.5f);
+}
+
+//--------------------------------------------------
+void ofNoise(const glm::vec2 * points, float * dst, std::size_t count){
+	fillNoise(points, dst, count, 0.5f, 0.5f);
+}
+
+//--------------------------------------------------
+void ofNoise(const glm::vec3 * points, float * dst, std::size_t count){
+	fillNoise(points, dst, count, 0.5f, 0.5f);
+}
+
+//--------------------------------------------------
+void ofNoise(const glm::vec4 * points, float * dst, std::size_t count){
+	fillNoise(points, dst, count, 0.5f, 0.5f);
+}
+
+//--------------------------------------------------
+void ofNoise(const glm::vec2 & origin, const glm::vec2 & step, std::size_t width, std::size_t height, float * dst){
+	fillNoiseGrid(origin, step, width, height, dst, 0.5f, 0.5f);
+}
+
+//--------------------------------------------------
+void ofNoise(const glm::vec3 & origin, const glm::vec3 & step, std::size_t width, std::size_t height, std::size_t depth, float * dst){
+	fillNoiseGrid(origin, step, width, height, depth, dst, 0.5f, 0.5f);
+}
+
+//--------------------------------------------------
+void ofSignedNoise(const float * x, float * dst, std::size_t count){
+	fillNoise(x, dst, count, 1.f, 0.f);
+}
+
+//--------------------------------------------------
+void ofSignedNoise(const glm::vec2 * points, float * dst, std::size_t count){
+	fillNoise(points, dst, count, 1.f, 0.f);
+}
+
+//--------------------------------------------------
+void ofSignedNoise(const glm::vec3 * points, float * dst, std::size_t count){
+	fillNoise(points, dst, count, 1.f, 0.f);
+}
+
+//--------------------------------------------------
+void ofSignedNoise(const glm::vec4 * points, float * dst, std::size_t count){
+	fillNoise(points, dst, count, 1.f, 0.f);
+}
+
+//--------------------------------------------------
+void ofSignedNoise(const glm::vec2 & origin, const glm::vec2 & step, std::size_t width, std::size_t height, float * dst){
+	fillNoiseGrid(origin, step, width, height, dst, 1.f, 0.f);
+}
+
+//--------------------------------------------------
+void ofSignedNoise(const glm::vec3 & origin, const glm::vec3 & step, std::size_t width, std::size_t height, std::size_t depth, float * dst){
+	fillNoiseGrid(origin, step, width, height, depth, dst, 1.f, 0.f);
+}
+
+//--------------------------------------------------
+glm::mat4 ofMultiplyMatrices(const glm::mat4 & a, const glm::mat4 & b){
+	// every column of the result is the columns of a weighted by the
+	// column of b
+	glm::mat4 r;
+#if defined(OF_MATH_BATCH_SSE)
+	__m128 a0 = _mm_loadu_ps(&a[0][0]);
+	__m128 a1 = _mm_loadu_ps(&a[1][0]);
+	__m128 a2 = _mm_loadu_ps(&a[2][0]);
+	__m128 a3 = _mm_loadu_ps(&a[3][0]);
+	for(int i = 0; i < 4; i++){
+		__m128 c = _mm_mul_ps(a0, _mm_set1_ps(b[i][0]));
+		c = _mm_add_ps(c, _mm_mul_ps(a1, _mm_set1_ps(b[i][1])));
+		c = _mm_add_ps(c, _mm_mul_ps(a2, _mm_set1_ps(b[i][2])));
+		c = _mm_add_ps(c, _mm_mul_ps(a3, _mm_set1_ps(b[i][3])));
+		_mm_storeu_ps(&r[i][0], c);
+	}
+#elif defined(OF_MATH_BATCH_NEON)
+	float32x4_t a0 = vld1q_f32(&a[0][0]);
+	float32x4_t a1 = vld1q_f32(&a[1][0]);
+	float32x4_t a2 = vld1q_f32(&a[2][0]);
+	float32x4_t a3 = vld1q_f32(&a[3][0]);
+	for(int i = 0; i < 4; i++){
+		float32x4_t column = vld1q_f32(&b[i][0]);
+		float32x4_t c = vmulq_lane_f32(a0, vget_low_f32(column), 0);
+		c = vmlaq_lane_f32(c, a1, vget_low_f32(column), 1);
+		c = vmlaq_lane_f32(c, a2, vget_high_f32(column), 0);
+		c = vmlaq_lane_f32(c, a3, vget_high_f32(column), 1);
+		vst1q_f32(&r[i][0], c);
+	}
+#else
+	r = a * b;
+#endif
+	return r;
+}
+
+#if defined(OF_MATH_BATCH_SSE)
+namespace{
+	// 2x2 matrices in one register as (m00, m01, m10, m11), the inverse
+	// is calculated blockwise from the 2x2 corners and their adjugates.
+	// the inverse of the transpose is the transpose of the inverse so the
+	// same code works with glm's columns loaded as rows
+	#define OF_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x))
+	#define OF_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+
+	// a * b
+	inline __m128 mat2Mul(__m128 a, __m128 b){
+		return _mm_add_ps(_mm_mul_ps(a, OF_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(OF_SWIZZLE(a, 1, 0, 3, 2), OF_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+
+	// adjugate(a) * b
+	inline __m128 mat2AdjMul(__m128 a, __m128 b){
+		return _mm_sub_ps(_mm_mul_ps(OF_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(OF_SWIZZLE(a, 1, 1, 2, 2), OF_SWIZZLE(b, 2, 3, 0, 1)));
+	}
+
+	// a * adjugate(b)
+	inline __m128 mat2MulAdj(__m128 a, __m128 b){
+		return _mm_sub_ps(_mm_mul_ps(a, OF_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(OF_SWIZZLE(a, 1, 0, 3, 2), OF_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+}
+#endif
+
+//--------------------------------------------------
+glm::mat4 ofInvertMatrix(const glm::mat4 & m){
+#if defined(OF_MATH_BATCH_SSE)
+	__m128 r0 = _mm_loadu_ps(&m[0][0]);
+	__m128 r1 = _mm_loadu_ps(&m[1][0]);
+	__m128 r2 = _mm_loadu_ps(&m[2][0]);
+	__m128 r3 = _mm_loadu_ps(&m[3][0]);
+
+	__m128 a = _mm_movelh_ps(r0, r1);
+	__m128 b = _mm_movehl_ps(r1, r0);
+	__m128 c = _mm_movelh_ps(r2, r3);
+	__m128 d = _mm_movehl_ps(r3, r2);
+
+	// determinants of a, b, c and d
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(OF_SHUFFLE(r0, r2, 0, 2, 0, 2), OF_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+		_mm_mul_ps(OF_SHUFFLE(r0, r2, 1, 3, 1, 3), OF_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+	__m128 detA = OF_SWIZZLE(detSub, 0, 0, 0, 0);
+	__m128 detB = OF_SWIZZLE(detSub, 1, 1, 1, 1);
+	__m128 detC = OF_SWIZZLE(detSub, 2, 2, 2, 2);
+	__m128 detD = OF_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	__m128 dc = mat2AdjMul(d, c);
+	__m128 ab = mat2AdjMul(a, b);
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mat2Mul(b, dc));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mat2Mul(c, ab));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mat2MulAdj(d, ab));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mat2MulAdj(a, dc));
+
+	// det(m) = detA * detD + detB * detC - trace(ab * dc)
+	__m128 det = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	__m128 trace = _mm_mul_ps(ab, OF_SWIZZLE(dc, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, OF_SWIZZLE(trace, 1, 0, 3, 2));
+	trace = _mm_add_ps(trace, OF_SWIZZLE(trace, 2, 3, 0, 1));
+	det = _mm_sub_ps(det, trace);
+
+	// the signs of the adjugate of each block
+	__m128 invDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+	x = _mm_mul_ps(x, invDet);
+	y = _mm_mul_ps(y, invDet);
+	z = _mm_mul_ps(z, invDet);
+	w = _mm_mul_ps(w, invDet);
+
+	glm::mat4 r;
+	_mm_storeu_ps(&r[0][0], OF_SHUFFLE(x, y, 3, 1, 3, 1));
+	_mm_storeu_ps(&r[1][0], OF_SHUFFLE(x, y, 2, 0, 2, 0));
+	_mm_storeu_ps(&r[2][0], OF_SHUFFLE(z, w, 3, 1, 3, 1));
+	_mm_storeu_ps(&r[3][0], OF_SHUFFLE(z, w, 2, 0, 2, 0));
+	return r;
+#else
+	return glm::inverse(m);
+#endif
+}
+
+namespace{
+	// the arrays are filled in chunks of a fixed size, each by 4
+	// xoshiro128+ generators, one per lane, seeded in order from the engine
+	// so the results only depend on its state and not on the threads
+	const std::size_t randomChunkSize = 16384;
+
+	struct RandomLanes{
+		uint32_t s[4][4]; // s[word][lane]
+	};
+
+	RandomLanes seedLanes(ofRandomEngine & engine){
+		RandomLanes lanes;
+		for(auto & word: lanes.s){
+			for(auto & lane: word){
+				lane = engine();
+			}
+		}
+		for(int lane = 0; lane < 4; lane++){
+			if((lanes.s[0][lane] | lanes.s[1][lane] | lanes.s[2][lane] | lanes.s[3][lane]) == 0){
+				lanes.s[0][lane] = 1;
+			}
+		}
+		return lanes;
+	}
+
+	// count uniform numbers in [0, 1) * scale + offset, clamped below limit
+	void fillUniformChunk(RandomLanes & lanes, float * dst, std::size_t count, float scale, float offset, float limit){
+		std::size_t i = 0;
+#if defined(OF_MATH_BATCH_SSE2)
+		__m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.s[0]));
+		__m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.s[1]));
+		__m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.s[2]));
+		__m128i s3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.s[3]));
+		const __m128 toFloat = _mm_set1_ps(scale / 16777216.f);
+		const __m128 offset4 = _mm_set1_ps(offset);
+		const __m128 limit4 = _mm_set1_ps(limit);
+		for(; i + 4 <= count; i += 4){
+			__m128i result = _mm_add_epi32(s0, s3);
+			__m128i t = _mm_slli_epi32(s1, 9);
+			s2 = _mm_xor_si128(s2, s0);
+			s3 = _mm_xor_si128(s3, s1);
+			s1 = _mm_xor_si128(s1, s2);
+			s0 = _mm_xor_si128(s0, s3);
+			s2 = _mm_xor_si128(s2, t);
+			s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+			// 24 bits fit in a signed int, the conversion is exact
+			__m128 r = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), toFloat), offset4);
+			_mm_storeu_ps(dst + i, _mm_min_ps(r, limit4));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.s[0]), s0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.s[1]), s1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.s[2]), s2);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.s[3]), s3);
+#elif defined(OF_MATH_BATCH_NEON)
+		uint32x4_t s0 = vld1q_u32(lanes.s[0]);
+		uint32x4_t s1 = vld1q_u32(lanes.s[1]);
+		uint32x4_t s2 = vld1q_u32(lanes.s[2]);
+		uint32x4_t s3 = vld1q_u32(lanes.s[3]);
+		const float32x4_t toFloat = vdupq_n_f32(scale / 16777216.f);
+		const float32x4_t offset4 = vdupq_n_f32(offset);
+		const float32x4_t limit4 = vdupq_n_f32(limit);
+		for(; i + 4 <= count; i += 4){
+			uint32x4_t result = vaddq_u32(s0, s3);
+			uint32x4_t t = vshlq_n_u32(s1, 9);
+			s2 = veorq_u32(s2, s0);
+			s3 = veorq_u32(s3, s1);
+			s1 = veorq_u32(s1, s2);
+			s0 = veorq_u32(s0, s3);
+			s2 = veorq_u32(s2, t);
+			s3 = vorrq_u32(vshlq_n_u32(s3, 11), vshrq_n_u32(s3, 21));
+			float32x4_t r = vmlaq_f32(offset4, vcvtq_f32_u32(vshrq_n_u32(result, 8)), toFloat);
+			vst1q_f32(dst + i, vminq_f32(r, limit4));
+		}
+		vst1q_u32(lanes.s[0], s0);
+		vst1q_u32(lanes.s[1], s1);
+		vst1q_u32(lanes.s[2], s2);
+		vst1q_u32(lanes.s[3], s3);
+#endif
+		// the same sequence as the vector versions
+		for(; i < count; i++){
+			int lane = i % 4;
+			uint32_t & s0 = lanes.s[0][lane];
+			uint32_t & s1 = lanes.s[1][lane];
+			uint32_t & s2 = lanes.s[2][lane];
+			uint32_t & s3 = lanes.s[3][lane];
+			uint32_t result = s0 + s3;
+			uint32_t t = s1 << 9;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = (s3 << 11) | (s3 >> 21);
+			dst[i] = std::min(float(result >> 8) * (scale / 16777216.f) + offset, limit);
+		}
+	}
+
+	// the chunks are seeded in order before they are split between threads
+	template<typename F>
+	void fillRandomChunks(float * dst, std::size_t count, ofRandomEngine & engine, F && fillChunk){
+		std::size_t numChunks = (count + randomChunkSize - 1) / randomChunkSize;
+		if(numChunks <= 1){
+			auto lanes = seedLanes(engine);
+			fillChunk(lanes, dst, count);
+			return;
+		}
+		std::vector<RandomLanes> chunks(numChunks);
+		for(auto & lanes: chunks){
+			lanes = seedLanes(engine);
+		}
+		ofGetTaskPool().parallelFor(0, numChunks, [&](std::size_t begin, std::size_t end){
+			for(std::size_t chunk = begin; chunk < end; chunk++){
+				std::size_t start = chunk * randomChunkSize;
+				fillChunk(chunks[chunk], dst + start, std::min(randomChunkSize, count - start));
+			}
+		}, 1);
+	}
+
+	void fillUniform(float * dst, std::size_t count, float min, float max, ofRandomEngine & engine){
+		if(min > max) std::swap(min, max);
+		// rounding could reach max with big ranges
+		float limit = max > min ? std::nextafter(max, min) : min;
+		fillRandomChunks(dst, count, engine, [&](RandomLanes & lanes, float * chunk, std::size_t chunkCount){
+			fillUniformChunk(lanes, chunk, chunkCount, max - min, min, limit);
+		});
+	}
+
+	void fillGaussian(float * dst, std::size_t count, float mean, float stddev, ofRandomEngine & engine){
+		// box muller on pairs of uniform numbers, the chunks have an even size
+		// so only the last number can be left without a pair
+		fillRandomChunks(dst, count, engine, [&](RandomLanes & lanes, float * chunk, std::size_t chunkCount){
+			fillUniformChunk(lanes, chunk, chunkCount, 1.f, 0.f, 1.f);
+			for(std::size_t i = 0; i + 1 < chunkCount; i += 2){
+				float radius = std::sqrt(-2.f * std::log(1.f - chunk[i])) * stddev;
+				float angle = float(TWO_PI) * chunk[i + 1];
+				chunk[i] = mean + radius * std::cos(angle);
+				chunk[i + 1] = mean + radius * std::sin(angle);
+			}
+		});
+		if(count % 2){
+			dst[count - 1] = mean + engine.gaussian() * stddev;
+		}
+	}
+
+	template<typename Vec>
+	void fillUniformVectors(Vec * dst, std::size_t count, const Vec & min, const Vec & max, ofRandomEngine & engine){
+		static_assert(sizeof(Vec) == Vec::length() * sizeof(float), "the batch functions need tightly packed vectors");
+		fillUniform(reinterpret_cast<float*>(dst), count * Vec::length(), 0.f, 1.f, engine);
+		Vec size = max - min;
+		for(std::size_t i = 0; i < count; i++){
+			dst[i] = min + dst[i] * size;
+		}
+	}
+}
+
+//--------------------------------------------------
+void ofRandomFill(float * dst, std::size_t count, float min, float max, ofRandomEngine & engine){
+	fillUniform(dst, count, min, max, engine);
+}
+
+//--------------------------------------------------
+void ofRandomFill(glm::vec2 * dst, std::size_t count, const glm::vec2 & min, const glm::vec2 & max, ofRandomEngine & engine){
+	fillUniformVectors(dst, count, min, max, engine);
+}
+
+//--------------------------------------------------
+void ofRandomFill(glm::vec3 * dst, std::size_t count, const glm::vec3 & min, const glm::vec3 & max, ofRandomEngine & engine){
+	fillUniformVectors(dst, count, min, max, engine);
+}
+
+//--------------------------------------------------
+void ofRandomFill(glm::vec4 * dst, std::size_t count, const glm::vec4 & min, const glm::vec4 & max, ofRandomEngine & engine){
+	fillUniformVectors(dst, count, min, max, engine);
+}
+
+//--------------------------------------------------
+void ofRandomGaussianFill(float * dst, std::size_t count, float mean, float stddev, ofRandomEngine & engine){
+	fillGaussian(dst, count, mean, stddev, engine);
+}
+
+//--------------------------------------------------
+void ofRandomGaussianFill(glm::vec3 * dst, std::size_t count, float mean, float stddev, ofRandomEngine & engine){
+	fillGaussian(reinterpret_cast<float*>(dst), count * 3, mean, stddev, engine);
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofVec3f.h"
+#include "ofMatrix4x4.h"
+#include "ofMath.h"
+
+/// \file
+/// Functions that apply the same operation to a whole array of vectors,
+/// like the positions and velocities of a particle system. They process 4
+/// vectors at a time with SSE or NEON when available and fall back to plain
+/// loops otherwise.
+///
+/// All of them take contiguous arrays, dst can be the same array as any of
+/// the sources to update them in place.
+///
+/// ~~~~{.cpp}
+/// // instead of: for(auto & p: particles) p.position += p.velocity * dt;
+/// ofAddScaledArray(positions.data(), velocities.data(), dt, positions.size());
+/// ofTransformPoints(model, positions.data(), transformed.data(), positions.size());
+/// ~~~~
+
+/// \name Batch Vector Operations
+/// \{
+
+/// \brief Transforms count points by matrix, like matrix * glm::vec4(p, 1)
+///
+/// If the last row of the matrix isn't (0, 0, 0, 1) the results are divided
+/// by w, as ofMatrix4x4::preMult() does.
+void ofTransformPoints(const glm::mat4 & matrix, const glm::vec3 * src, glm::vec3 * dst, std::size_t count);
+
+/// \brief Transforms all the points in place
+void ofTransformPoints(const glm::mat4 & matrix, std::vector<glm::vec3> & points);
+
+/// \brief Transforms count points, the same as calling matrix.preMult() for
+/// each of them
+void ofTransformPoints(const ofMatrix4x4 & matrix, const ofVec3f * src, ofVec3f * dst, std::size_t count);
+
+/// \brief Transforms count directions by matrix, like
+/// matrix * glm::vec4(d, 0), so the translation doesn't affect them
+///
+/// To transform normals pass the inverse transpose of the matrix.
+void ofTransformDirections(const glm::mat4 & matrix, const glm::vec3 * src, glm::vec3 * dst, std::size_t count);
+
+/// \brief Normalizes count vectors, vectors of length 0 stay 0
+void ofNormalizeArray(const glm::vec3 * src, glm::vec3 * dst, std::size_t count);
+
+/// \brief Normalizes all the vectors in place
+void ofNormalizeArray(std::vector<glm::vec3> & vectors);
+
+void ofNormalizeArray(const ofVec3f * src, ofVec3f * dst, std::size_t count);
+
+/// \brief Interpolates linearly between the vectors in from and to:
+/// dst[i] = from[i] + (to[i] - from[i]) * amount
+void ofLerpArray(const glm::vec3 * from, const glm::vec3 * to, float amount, glm::vec3 * dst, std::size_t count);
+
+void ofLerpArray(const ofVec3f * from, const ofVec3f * to, float amount, ofVec3f * dst, std::size_t count);
+
+/// \brief Adds src scaled by scale to dst: dst[i] += src[i] * scale
+///
+/// The usual position += velocity * dt step of a particle system.
+void ofAddScaledArray(glm::vec3 * dst, const glm::vec3 * src, float scale, std::size_t count);
+
+void ofAddScaledArray(ofVec3f * dst, const ofVec3f * src, float scale, std::size_t count);
+
+/// \}
+
+/// \name Matrix Operations
+/// \{
+
+/// \brief a * b, the same as glm's operator* computed with SSE or NEON
+/// when available
+///
+/// Used by ofMatrixStack and the renderers for the matrices derived on
+/// every draw, like the model view projection.
+glm::mat4 ofMultiplyMatrices(const glm::mat4 & a, const glm::mat4 & b);
+
+/// \brief Inverse of a general 4x4 matrix, the same as glm::inverse,
+/// computed with SSE when available
+///
+/// Singular matrices return infinities or NaNs as glm::inverse does.
+glm::mat4 ofInvertMatrix(const glm::mat4 & m);
+
+/// \}
+
+/// \name Batch Noise
+/// \{
+
+/// \brief Fills dst with ofNoise() of each of the count values in x,
+/// between 0.0...1.0
+///
+/// The results are the same as calling ofNoise() for every value but 4 of
+/// them are calculated at a time with SSE2 or NEON and big buffers are
+/// split between the threads of ofGetTaskPool().
+///
+/// ~~~~{.cpp}
+/// // a flow field, one angle per particle
+/// ofNoise(positions.data(), angles.data(), positions.size());
+/// ~~~~
+void ofNoise(const float * x, float * dst, std::size_t count);
+
+/// \brief Fills dst with the 2D noise at each of the count points
+void ofNoise(const glm::vec2 * points, float * dst, std::size_t count);
+
+/// \brief Fills dst with the 3D noise at each of the count points
+void ofNoise(const glm::vec3 * points, float * dst, std::size_t count);
+
+/// \brief Fills dst with the 4D noise at each of the count points
+///
+/// Only split between threads, 4D noise isn't vectorized.
+void ofNoise(const glm::vec4 * points, float * dst, std::size_t count);
+
+/// \brief Fills dst, width * height values row after row, with the 2D
+/// noise at origin + glm::vec2(x, y) * step for every x, y in the grid
+///
+/// ~~~~{.cpp}
+/// ofFloatPixels pixels;
+/// pixels.allocate(w, h, OF_PIXELS_GRAY);
+/// ofNoise({0, ofGetElapsedTimef()}, {0.01, 0.01}, w, h, pixels.getData());
+/// ~~~~
+void ofNoise(const glm::vec2 & origin, const glm::vec2 & step, std::size_t width, std::size_t height, float * dst);
+
+/// \brief Fills dst, width * height * depth values, with the 3D noise at
+/// origin + glm::vec3(x, y, z) * step for every x, y, z in the grid
+void ofNoise(const glm::vec3 & origin, const glm::vec3 & step, std::size_t width, std::size_t height, std::size_t depth, float * dst);
+
+/// \brief Fills dst with ofSignedNoise() of each of the count values in x,
+/// between -1.0...1.0
+void ofSignedNoise(const float * x, float * dst, std::size_t count);
+
+void ofSignedNoise(const glm::vec2 * points, float * dst, std::size_t count);
+
+void ofSignedNoise(const glm::vec3 * points, float * dst, std::size_t count);
+
+void ofSignedNoise(const glm::vec4 * points, float * dst, std::size_t count);
+
+void ofSignedNoise(const glm::vec2 & origin, const glm::vec2 & step, std::size_t width, std::size_t height, float * dst);
+
+void ofSignedNoise(const glm::vec3 & origin, const glm::vec3 & step, std::size_t width, std::size_t height, std::size_t depth, float * dst);
+
+/// \}
+
+/// \name Batch Random
+/// \{
+
+/// \brief Fills dst with count random numbers in [min, max)
+///
+/// Much faster than calling ofRandom() for each of them, 4 generators
+/// run at a time with SSE2 or NEON and big arrays are split between the
+/// threads of ofGetTaskPool(). The results only depend on the state of
+/// engine, they are the same on every platform and with any number of
+/// threads.
+///
+/// ~~~~{.cpp}
+/// ofRandomFill(positions.data(), positions.size(), {-100, -100, -100}, {100, 100, 100});
+/// ofRandomGaussianFill(sizes.data(), sizes.size(), 10, 2);
+/// ~~~~
+void ofRandomFill(float * dst, std::size_t count, float min, float max, ofRandomEngine & engine = ofGetRandomEngine());
+
+/// \brief Fills dst with count vectors with each component in [min, max)
+void ofRandomFill(glm::vec2 * dst, std::size_t count, const glm::vec2 & min, const glm::vec2 & max, ofRandomEngine & engine = ofGetRandomEngine());
+void ofRandomFill(glm::vec3 * dst, std::size_t count, const glm::vec3 & min, const glm::vec3 & max, ofRandomEngine & engine = ofGetRandomEngine());
+void ofRandomFill(glm::vec4 * dst, std::size_t count, const glm::vec4 & min, const glm::vec4 & max, ofRandomEngine & engine = ofGetRandomEngine());
+
+/// \brief Fills dst with count random numbers with a normal distribution
+void ofRandomGaussianFill(float * dst, std::size_t count, float mean = 0, float stddev = 1, ofRandomEngine & engine = ofGetRandomEngine());
+
+/// \brief Fills dst with count vectors with each component following a
+/// normal distribution
+void ofRandomGaussianFill(glm::vec3 * dst, std::size_t count, float mean = 0, float stddev = 1, ofRandomEngine & engine = ofGetRandomEngine());
+
+/// \}
@@ -7,18 +7,28 @@
 #include "ofLog.h"
 #include "ofSystemUtils.h"
 
+#include "ofHttpCache.h"
 #include "ofURLFileLoader.h"
 
 #include "ofUtils.h"
 
-#if !defined(TARGET_EMSCRIPTEN)
+#if !defined(TARGET_NO_THREADS)
 #include "ofThread.h"
 #include "ofThreadChannel.h"
+#include "ofTripleBuffer.h"
+#include "ofTaskPool.h"
+#include "ofFileIOService.h"
+#include "ofDirectoryScanner.h"
 #endif
 
 #include "ofFpsCounter.h"
+#include "ofProfiler.h"
+#include "ofMetrics.h"
+#include "ofAllocationTracker.h"
 #include "ofJson.h"
+#include "ofCsv.h"
 #include "ofXml.h"
+#include "ofBinarySerializer.h"
 
 //--------------------------
 // types
@@ -27,32 +37,55 @@
 #include "ofColor.h"
 #include "ofPoint.h"
 #include "ofRectangle.h"
+#include "ofSpatialGrid.h"
 #include "ofParameter.h"
 #include "ofParameterGroup.h"
+#include "ofAtomicParameter.h"
 
 //--------------------------
 // math
 #include "ofMath.h"
 #include "ofVectorMath.h"
+#include "ofMathBatch.h"
 
 //--------------------------
 // communication
 #if !defined( TARGET_OF_IOS ) & !defined(TARGET_ANDROID) & !defined(TARGET_EMSCRIPTEN)
 	#include "ofSerial.h"
 	#include "ofArduino.h"
+	#include "ofSharedMemory.h"
+	#include "ofSharedFrames.h"
 #endif
 
 //--------------------------
 // gl
+#include "ofCompressedTexture.h"
 #include "ofFbo.h"
+#include "ofFboPool.h"
 #include "ofGLRenderer.h"
 #include "ofGLUtils.h"
+#include "ofGLStateCache.h"
+#include "ofRenderStats.h"
+#include "ofGpuMemory.h"
 #include "ofLight.h"
 #include "ofMaterial.h"
+#include "ofPixelReadback.h"
+#include "ofPixelUploader.h"
 #include "ofShader.h"
+#include "ofSharedTexture.h"
 #include "ofTexture.h"
+#include "ofVideoTexture.h"
+#include "ofVirtualTexture.h"
+#include "ofGpuParticles.h"
+#include "ofGpuStrokes.h"
+#include "ofTextureAtlas.h"
+#include "ofOcclusionQuery.h"
+#include "ofObjectPicker.h"
+#include "ofGLUploadWorker.h"
 #include "ofVbo.h"
 #include "ofVboMesh.h"
+#include "ofInstancedMesh.h"
+#include "ofInterleavedMesh.h"
 #include "ofGLProgrammableRenderer.h"
 #ifndef TARGET_PROGRAMMABLE_GL
 	#include "ofGLRenderer.h"
@@ -65,12 +98,19 @@
 #endif
 #include "ofGraphics.h"
 #include "ofImage.h"
+#include "ofAssetCache.h"
+#include "ofAssetPreloader.h"
+#include "ofImageSequenceRecorder.h"
 #include "ofPath.h"
 #include "ofPixels.h"
+#include "ofPixelsPool.h"
 #include "ofPolyline.h"
 #include "ofRendererCollection.h"
+#include "ofAsyncRenderer.h"
+#include "ofCommandBuffer.h"
 #include "ofTessellator.h"
 #include "ofTrueTypeFont.h"
+#include "ofTextLayout.h"
 
 //--------------------------
 // app
@@ -92,12 +132,21 @@
 	#include "ofSoundStream.h"
 	#include "ofSoundPlayer.h"
 	#include "ofSoundBuffer.h"
+	#include "ofSoundBufferPool.h"
+	#include "ofSoundGraph.h"
+	#include "ofSoundAnalyzer.h"
+	#include "ofSoundSampler.h"
+	#include "ofSoundRecorder.h"
 #endif
 
 //--------------------------
 // video
+#include "ofHapPlayer.h"
 #include "ofVideoGrabber.h"
 #include "ofVideoPlayer.h"
+#include "ofVideoPlayerPool.h"
+#include "ofVideoRecorder.h"
+#include "ofCaptureManager.h"
 
 //--------------------------
 // events
@@ -106,10 +155,14 @@
 //--------------------------
 // 3d
 #include "of3dUtils.h"
+#include "ofBounds.h"
 #include "ofCamera.h"
 #include "ofEasyCam.h"
+#include "ofLodMesh.h"
+#include "ofStaticBatch.h"
 #include "ofMesh.h"
 #include "ofNode.h"
+#include "ofRenderList.h"
 
 //--------------------------
 using namespace std;
@@ -23,6 +23,12 @@ std::string toString(ofSoundDevice::Api api){
 			return "MS ASIO";
 		case ofSoundDevice::MS_DS:
 			return "MS DirectShow";
+		case ofSoundDevice::ANDROID_AAUDIO:
+			return "Android AAudio";
+		case ofSoundDevice::ANDROID_OPENSL:
+			return "Android OpenSL ES";
+		case ofSoundDevice::ANDROID_JAVA:
+			return "Android Java";
 		default:
 			return "Unkown API";
 	}
@@ -21,6 +21,9 @@ public:
 		MS_WASAPI, /*!< The Microsoft WASAPI API. */
 		MS_ASIO,   /*!< The Steinberg Audio Stream I/O API. */
 		MS_DS,     /*!< The Microsoft Direct Sound API. */
+		ANDROID_AAUDIO, /*!< The Android AAudio API, 8.1 and later. */
+		ANDROID_OPENSL, /*!< The Android OpenSL ES API. */
+		ANDROID_JAVA,   /*!< The Android java AudioTrack and AudioRecord API. */
 		NUM_APIS
 	} api = UNSPECIFIED;
 
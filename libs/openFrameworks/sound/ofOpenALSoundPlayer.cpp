@@ -6,7 +6,12 @@
 #include "ofMath.h"
 #include "ofFileUtils.h"
 #include "ofAppRunner.h"
+#include "ofTaskPool.h"
 #include <set>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
 
@@ -103,6 +108,177 @@ static string getMpg123EncodingString(int encoding) {
 
 #define BUFFER_STREAM_SIZE 4096
 
+static std::atomic<size_t> & decodedMemory(){
+	static std::atomic<size_t> * bytes = new std::atomic<size_t>(0);
+	return *bytes;
+}
+
+static std::atomic<size_t> decodedMemoryLimit(0);
+
+//------------------------------------------------------------
+struct ofOpenALSoundPlayer::Stream{
+	// chunks decoded ahead, reused as they are played
+	static const size_t numChunks = 4;
+
+	std::mutex mutex;
+	ofOpenALSoundPlayer * player = nullptr;
+	std::vector<short> chunks[numChunks];
+	size_t first = 0;
+	size_t count = 0;
+	size_t memory = 0;
+	bool finished = false;
+	bool paused = false;
+	std::atomic<bool> playing{false};
+	std::atomic<size_t> aheadSamples{0};
+};
+
+//------------------------------------------------------------
+struct ofOpenALSoundPlayer::MemoryFile{
+	ofBuffer data;
+	sf_count_t position = 0;
+
+	static sf_count_t length(void * user){
+		return static_cast<MemoryFile*>(user)->data.size();
+	}
+
+	static sf_count_t seek(sf_count_t offset, int whence, void * user){
+		auto file = static_cast<MemoryFile*>(user);
+		sf_count_t size = file->data.size();
+		switch(whence){
+			case SEEK_SET: break;
+			case SEEK_CUR: offset += file->position; break;
+			case SEEK_END: offset += size; break;
+			default: return -1;
+		}
+		if(offset < 0 || offset > size) return -1;
+		file->position = offset;
+		return offset;
+	}
+
+	static sf_count_t read(void * ptr, sf_count_t count, void * user){
+		auto file = static_cast<MemoryFile*>(user);
+		count = std::min(count, sf_count_t(file->data.size()) - file->position);
+		memcpy(ptr, file->data.getData() + file->position, count);
+		file->position += count;
+		return count;
+	}
+
+	static sf_count_t write(const void *, sf_count_t, void *){
+		return 0;
+	}
+
+	static sf_count_t tell(void * user){
+		return static_cast<MemoryFile*>(user)->position;
+	}
+
+#ifdef OF_USING_MPG123
+	static ssize_t mpg123Read(void * user, void * ptr, size_t count){
+		return read(ptr, count, user);
+	}
+
+	static off_t mpg123Seek(void * user, off_t offset, int whence){
+		return seek(offset, whence, user);
+	}
+#endif
+};
+
+//------------------------------------------------------------
+// a few threads go over all the streams refilling the ones that need it,
+// the streams that are busy decoding on another thread are skipped
+struct ofOpenALSoundPlayer::StreamingService{
+	std::mutex mutex;
+	std::vector<std::shared_ptr<Stream>> streams;
+	std::vector<std::thread> threads;
+	std::atomic<bool> running{false};
+	size_t numThreads = 2;
+
+	void add(const std::shared_ptr<Stream> & stream){
+		std::unique_lock<std::mutex> lock(mutex);
+		streams.push_back(stream);
+		if(threads.empty()){
+			running = true;
+			for(size_t i = 0; i < std::max(numThreads, size_t(1)); i++){
+				threads.emplace_back([this]{ loop(); });
+			}
+		}
+	}
+
+	void remove(const std::shared_ptr<Stream> & stream){
+		std::vector<std::thread> stopped;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			streams.erase(std::remove(streams.begin(), streams.end(), stream), streams.end());
+			if(streams.empty()){
+				running = false;
+				std::swap(stopped, threads);
+			}
+		}
+		for(auto & thread: stopped){
+			thread.join();
+		}
+	}
+
+	void loop(){
+		std::vector<std::shared_ptr<Stream>> pending;
+		while(running){
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				pending = streams;
+			}
+			bool busy = false;
+			for(auto & stream: pending){
+				std::unique_lock<std::mutex> lock(stream->mutex, std::try_to_lock);
+				if(lock.owns_lock() && stream->player){
+					busy |= stream->player->serviceStream(*stream);
+				}
+			}
+			pending.clear();
+			if(!busy){
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+	}
+};
+
+//------------------------------------------------------------
+ofOpenALSoundPlayer::StreamingService & ofOpenALSoundPlayer::streamingService(){
+	// never destroyed, players can be unloaded by static destructors
+	static StreamingService * service = new StreamingService;
+	return *service;
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::setDecodedMemoryLimit(size_t bytes){
+	decodedMemoryLimit = bytes;
+}
+
+//------------------------------------------------------------
+size_t ofOpenALSoundPlayer::getDecodedMemoryLimit(){
+	return decodedMemoryLimit;
+}
+
+//------------------------------------------------------------
+size_t ofOpenALSoundPlayer::getDecodedMemory(){
+	return decodedMemory();
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::setNumStreamingThreads(size_t numThreads){
+	auto & service = streamingService();
+	std::unique_lock<std::mutex> lock(service.mutex);
+	service.numThreads = numThreads;
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::setMemoryUsed(size_t bytes){
+	if(bytes > memoryUsed){
+		decodedMemory() += bytes - memoryUsed;
+	}else{
+		decodedMemory() -= memoryUsed - bytes;
+	}
+	memoryUsed = bytes;
+}
+
 // now, the individual sound player:
 //------------------------------------------------------------
 ofOpenALSoundPlayer::ofOpenALSoundPlayer(){
@@ -121,12 +297,18 @@ ofOpenALSoundPlayer::ofOpenALSoundPlayer(){
 #ifdef OF_USING_MPG123
 	mp3streamf		= 0;
 #endif
+	stream_end		= false;
+	memoryUsed		= 0;
+	loading			= false;
+	loadId			= 0;
+	alive			= std::make_shared<bool>(true);
 	players().insert(this);
 }
 
 // ----------------------------------------------------------------------------
 ofOpenALSoundPlayer::~ofOpenALSoundPlayer(){
 	unload();
+	alive.reset();
 	kiss_fftr_free(fftCfg);
 	players().erase(this);
 }
@@ -173,7 +355,9 @@ void ofOpenALSoundPlayer::close(){
 }
 
 // ----------------------------------------------------------------------------
-bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, vector<short> & buffer, vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, Decoded & decoded){
+	vector<short> & buffer = decoded.buffer;
+	vector<float> & fftAuxBuffer = decoded.fftAuxBuffer;
 	SF_INFO sfInfo;
 	SNDFILE* f = sf_open(path.c_str(),SFM_READ,&sfInfo);
 	if(!f){
@@ -207,6 +391,7 @@ bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, vector<s
 		if(frames_read<sfInfo.frames){
 			ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from buffer, expected "
 			<< sfInfo.frames << " for \"" << path << "\"";
+			sf_close(f);
 			return false;
 		}
 		sf_seek(f,0,SEEK_SET);
@@ -214,20 +399,23 @@ bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, vector<s
 		if(frames_read<sfInfo.frames){
 			ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from fft buffer, expected "
 			<< sfInfo.frames << " for \"" << path << "\"";
+			sf_close(f);
 			return false;
 		}
 	}
 	sf_close(f);
 
-	channels = sfInfo.channels;
-	duration = float(sfInfo.frames) / float(sfInfo.samplerate);
-	samplerate = sfInfo.samplerate;
+	decoded.channels = sfInfo.channels;
+	decoded.duration = float(sfInfo.frames) / float(sfInfo.samplerate);
+	decoded.samplerate = sfInfo.samplerate;
 	return true;
 }
 
 #ifdef OF_USING_MPG123
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vector<short> & buffer,vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,Decoded & decoded){
+	vector<short> & buffer = decoded.buffer;
+	vector<float> & fftAuxBuffer = decoded.fftAuxBuffer;
 	int err = MPG123_OK;
 	mpg123_handle * f = mpg123_new(nullptr,&err);
 	if(mpg123_open(f,path.c_str())!=MPG123_OK){
@@ -237,13 +425,17 @@ bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vecto
 
 	mpg123_enc_enum encoding;
 	long int rate;
+	int channels;
 	mpg123_getformat(f,&rate,&channels,(int*)&encoding);
 	if(encoding!=MPG123_ENC_SIGNED_16){
 		ofLogError("ofOpenALSoundPlayer") << "mpg123ReadFile(): " << getMpg123EncodingString(encoding)
 			<< " encoding for \"" << path << "\"" << " unsupported, expecting MPG123_ENC_SIGNED_16";
+		mpg123_close(f);
+		mpg123_delete(f);
 		return false;
 	}
-	samplerate = rate;
+	decoded.channels = channels;
+	decoded.samplerate = rate;
 
 	size_t done=0;
 	size_t buffer_size = mpg123_outblock( f );
@@ -259,7 +451,7 @@ bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vecto
 	for(int i=0;i<(int)buffer.size();i++){
 		fftAuxBuffer[i] = float(buffer[i])/32565.f;
 	}
-	duration = float(buffer.size()/channels) / float(samplerate);
+	decoded.duration = float(buffer.size()/channels) / float(rate);
 	return true;
 }
 #endif
@@ -268,7 +460,13 @@ bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vecto
 bool ofOpenALSoundPlayer::sfStream(const std::filesystem::path& path,vector<short> & buffer,vector<float> & fftAuxBuffer){
 	if(!streamf){
 		SF_INFO sfInfo;
-		streamf = sf_open(path.c_str(),SFM_READ,&sfInfo);
+		if(compressed){
+			static SF_VIRTUAL_IO io = {MemoryFile::length, MemoryFile::seek, MemoryFile::read, MemoryFile::write, MemoryFile::tell};
+			compressed->position = 0;
+			streamf = sf_open_virtual(&io,SFM_READ,&sfInfo,compressed.get());
+		}else{
+			streamf = sf_open(path.c_str(),SFM_READ,&sfInfo);
+		}
 		if(!streamf){
 			ofLogError("ofOpenALSoundPlayer") << "sfStream(): couldn't read \"" << path << "\"";
 			return false;
@@ -298,9 +496,7 @@ bool ofOpenALSoundPlayer::sfStream(const std::filesystem::path& path,vector<shor
 		if(samples_read<(int)fftAuxBuffer.size()){
 			fftAuxBuffer.resize(samples_read);
 			buffer.resize(samples_read);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
+			seekStream(0);
 			stream_end = true;
 		}
 		for (int i = 0 ; i < int(fftAuxBuffer.size()) ; i++){
@@ -313,9 +509,7 @@ bool ofOpenALSoundPlayer::sfStream(const std::filesystem::path& path,vector<shor
 		if(frames_read<curr_buffer_size/channels){
 			fftAuxBuffer.resize(frames_read*channels);
 			buffer.resize(frames_read*channels);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
+			seekStream(0);
 			stream_end = true;
 		}
 		for(int i=0;i<(int)buffer.size();i++){
@@ -332,7 +526,14 @@ bool ofOpenALSoundPlayer::mpg123Stream(const std::filesystem::path& path,vector<
 	if(!mp3streamf){
 		int err = MPG123_OK;
 		mp3streamf = mpg123_new(nullptr,&err);
-		if(mpg123_open(mp3streamf,path.c_str())!=MPG123_OK){
+		if(compressed){
+			compressed->position = 0;
+			mpg123_replace_reader_handle(mp3streamf,MemoryFile::mpg123Read,MemoryFile::mpg123Seek,nullptr);
+			err = mpg123_open_handle(mp3streamf,compressed.get());
+		}else{
+			err = mpg123_open(mp3streamf,path.c_str());
+		}
+		if(err!=MPG123_OK){
 			mpg123_close(mp3streamf);
 			mpg123_delete(mp3streamf);
 			ofLogError("ofOpenALSoundPlayer") << "mpg123Stream(): couldn't read \"" << path << "\"";
@@ -362,10 +563,9 @@ bool ofOpenALSoundPlayer::mpg123Stream(const std::filesystem::path& path,vector<
 	fftAuxBuffer.resize(buffer.size());
 	size_t done=0;
 	if(mpg123_read(mp3streamf,(unsigned char*)&buffer[0],curr_buffer_size*2,&done)==MPG123_DONE){
-		setPosition(0);
+		seekStream(0);
 		buffer.resize(done/2);
 		fftAuxBuffer.resize(done/2);
-		if(!bLoop) stopThread();
 		stream_end = true;
 	}
 
@@ -399,26 +599,16 @@ bool ofOpenALSoundPlayer::stream(const std::filesystem::path& fileName, vector<s
 	return true;
 }
 
-bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, vector<short> & buffer){
+bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, Decoded & decoded){
 #ifdef OF_USING_MPG123
 	if(ofFilePath::getFileExt(fileName)!="mp3" && ofFilePath::getFileExt(fileName)!="MP3"){
-		if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
+		return sfReadFile(fileName,decoded);
 	}else{
-		if(!mpg123ReadFile(fileName,buffer,fftAuxBuffer)) return false;
+		return mpg123ReadFile(fileName,decoded);
 	}
 #else
-	if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
+	return sfReadFile(fileName,decoded);
 #endif
-	fftBuffers.resize(channels);
-	int numFrames = buffer.size()/channels;
-
-	for(int i=0;i<channels;i++){
-		fftBuffers[i].resize(numFrames);
-		for(int j=0;j<numFrames;j++){
-			fftBuffers[i][j] = fftAuxBuffer[j*channels+i];
-		}
-	}
-	return true;
 }
 
 //------------------------------------------------------------
@@ -426,10 +616,6 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 
 	std::filesystem::path fileName = ofToDataPath(_fileName);
 
-	bMultiPlay = false;
-	isStreaming = is_stream;
-	int err = AL_NO_ERROR;
-
 	// [1] init sound systems, if necessary
 	initialize();
 
@@ -438,22 +624,167 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 	// if they call "loadSound" repeatedly, for example
 
 	unload();
-	ALenum format=AL_FORMAT_MONO16;
-	bLoadedOk = false;
+	bMultiPlay = false;
+	isStreaming = is_stream;
 
-	if(!isStreaming){
-		readFile(fileName, buffer);
+	if(isStreaming){
+		bLoadedOk = loadStream(fileName);
 	}else{
-		stream(fileName, buffer);
+		Decoded decoded;
+		bLoadedOk = readFile(fileName, decoded) && loadDecoded(fileName, decoded);
 	}
+	return bLoadedOk;
+}
 
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::loadCompressed(const std::filesystem::path& _fileName){
+	std::filesystem::path fileName = ofToDataPath(_fileName);
+	initialize();
+	unload();
+	bMultiPlay = false;
+	isStreaming = true;
+
+	compressed = std::make_shared<MemoryFile>();
+	compressed->data = ofBufferFromFile(fileName, true);
+	if(compressed->data.size() == 0){
+		ofLogError("ofOpenALSoundPlayer") << "loadCompressed(): couldn't read \"" << fileName << "\"";
+		compressed.reset();
+		bLoadedOk = false;
+		return false;
+	}
+
+	bLoadedOk = loadStream(fileName);
+	return bLoadedOk;
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::loadAsync(const std::filesystem::path& _fileName, bool is_stream){
+	std::weak_ptr<bool> weakAlive = alive;
+	if(is_stream){
+		bool loaded = load(_fileName, true);
+		loading = true;
+		uint64_t id = loadId;
+		ofTaskPool::runOnMainThread([this, weakAlive, id, loaded]{
+			if(weakAlive.expired() || id != loadId) return;
+			loading = false;
+			bool result = loaded;
+			ofNotifyEvent(loadedEvent, result, this);
+		});
+		return;
+	}
+
+	std::filesystem::path fileName = ofToDataPath(_fileName);
+	initialize();
+	unload();
+	bMultiPlay = false;
+	isStreaming = false;
+	loading = true;
+
+	// decoded in the task pool, the OpenAL buffers are created in the main
+	// thread, unloading or loading again before it finishes discards it
+	uint64_t id = loadId;
+	ofGetTaskPool().submit([fileName]{
+		auto decoded = std::make_shared<Decoded>();
+		if(!readFile(fileName, *decoded)){
+			decoded->channels = 0;
+		}
+		return decoded;
+	}, [this, weakAlive, id, fileName](std::shared_ptr<Decoded> & decoded){
+		if(weakAlive.expired() || id != loadId) return;
+		loading = false;
+		bLoadedOk = decoded->channels > 0 && loadDecoded(fileName, *decoded);
+		bool result = bLoadedOk;
+		ofNotifyEvent(loadedEvent, result, this);
+	});
+}
+
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::isLoading() const{
+	return loading;
+}
+
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::loadDecoded(const std::filesystem::path& fileName, Decoded & decoded){
+	// only the float copy for the spectrum stays in memory once the
+	// samples are in OpenAL
+	size_t bytes = decoded.fftAuxBuffer.size() * sizeof(float);
+	size_t limit = decodedMemoryLimit;
+	if(limit > 0 && decodedMemory() + bytes > limit){
+		ofLogError("ofOpenALSoundPlayer") << "loadSound(): \"" << fileName << "\" needs " << bytes
+		<< " bytes of decoded audio, over the limit of " << limit;
+		return false;
+	}
+
+	channels = decoded.channels;
+	samplerate = decoded.samplerate;
+	duration = decoded.duration;
+	vector<short> & buffer = decoded.buffer;
 	int numFrames = buffer.size()/channels;
 
-	if(isStreaming){
-		buffers.resize(channels*2);
+	fftBuffers.resize(channels);
+	for(int i=0;i<channels;i++){
+		fftBuffers[i].resize(numFrames);
+		for(int j=0;j<numFrames;j++){
+			fftBuffers[i][j] = decoded.fftAuxBuffer[j*channels+i];
+		}
+	}
+	setMemoryUsed(bytes);
+
+	ALenum format=AL_FORMAT_MONO16;
+	int err = AL_NO_ERROR;
+	buffers.resize(channels);
+	alGenBuffers(buffers.size(), &buffers[0]);
+	if(channels==1){
+		sources.resize(1);
+		alGetError(); // Clear error.
+		alGenSources(1, &sources[0]);
+		err = alGetError();
+		if (err != AL_NO_ERROR){
+			ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't generate source for \"" << fileName << "\": "
+			<< (int) err << " " << getALErrorString(err);
+			return false;
+		}
+
+		alGetError(); // Clear error.
+		alBufferData(buffers[0],format,&buffer[0],buffer.size()*2,samplerate);
+		err = alGetError();
+		if (err != AL_NO_ERROR){
+			ofLogError("ofOpenALSoundPlayer:") << "loadSound(): couldn't create buffer for \"" << fileName << "\": "
+			<< (int) err << " " << getALErrorString(err);
+			return false;
+		}
+		alSourcei (sources[0], AL_BUFFER,   buffers[0]);
 	}else{
-		buffers.resize(channels);
+		multibuffer.resize(channels);
+		sources.resize(channels);
+		alGenSources(channels, &sources[0]);
+		for(int i=0;i<channels;i++){
+			multibuffer[i].resize(numFrames);
+			for(int j=0;j<numFrames;j++){
+				multibuffer[i][j] = buffer[j*channels+i];
+			}
+			alGetError(); // Clear error.
+			alBufferData(buffers[i],format,&multibuffer[i][0],numFrames*2,samplerate);
+			err = alGetError();
+			if (err != AL_NO_ERROR){
+				ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": "
+				<< (int) err << " " << getALErrorString(err);
+				return false;
+			}
+			alSourcei (sources[i], AL_BUFFER,   buffers[i]   );
+		}
+		multibuffer.clear();
 	}
+	return setupSources(fileName);
+}
+
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::loadStream(const std::filesystem::path& fileName){
+	if(!stream(fileName, buffer)) return false;
+
+	ALenum format=AL_FORMAT_MONO16;
+	int err = AL_NO_ERROR;
+	buffers.resize(channels*2);
 	alGenBuffers(buffers.size(), &buffers[0]);
 	if(channels==1){
 		sources.resize(1);
@@ -475,86 +806,73 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 				<< (int) err << " " << getALErrorString(err);
 				return false;
 			}
-			if(isStreaming){
-				stream(fileName,buffer);
-			}
-		}
-		if(isStreaming){
-			alSourceQueueBuffers(sources[0],buffers.size(),&buffers[0]);
-		}else{
-			alSourcei (sources[0], AL_BUFFER,   buffers[0]);
+			stream(fileName,buffer);
 		}
-
-		alSourcef (sources[0], AL_PITCH,    1.0f);
-		alSourcef (sources[0], AL_GAIN,     1.0f);
-	    alSourcef (sources[0], AL_ROLLOFF_FACTOR,  0.0);
-	    alSourcei (sources[0], AL_SOURCE_RELATIVE, AL_TRUE);
+		alSourceQueueBuffers(sources[0],buffers.size(),&buffers[0]);
 	}else{
-		vector<vector<short> > multibuffer;
 		multibuffer.resize(channels);
 		sources.resize(channels);
 		alGenSources(channels, &sources[0]);
-		if(isStreaming){
-			for(int s=0; s<2;s++){
-				for(int i=0;i<channels;i++){
-					multibuffer[i].resize(buffer.size()/channels);
-					for(int j=0;j<numFrames;j++){
-						multibuffer[i][j] = buffer[j*channels+i];
-					}
-					alGetError(); // Clear error.
-					alBufferData(buffers[s*2+i],format,&multibuffer[i][0],buffer.size()/channels*2,samplerate);
-					err = alGetError();
-					if ( err != AL_NO_ERROR){
-						ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": " << (int) err << " " << getALErrorString(err);
-						return false;
-					}
-					alSourceQueueBuffers(sources[i],1,&buffers[s*2+i]);
-					stream(fileName,buffer);
-				}
-			}
-		}else{
+		for(int s=0; s<2;s++){
+			int numFrames = buffer.size()/channels;
 			for(int i=0;i<channels;i++){
-				multibuffer[i].resize(buffer.size()/channels);
+				multibuffer[i].resize(numFrames);
 				for(int j=0;j<numFrames;j++){
 					multibuffer[i][j] = buffer[j*channels+i];
 				}
 				alGetError(); // Clear error.
-				alBufferData(buffers[i],format,&multibuffer[i][0],buffer.size()/channels*2,samplerate);
+				alBufferData(buffers[s*channels+i],format,&multibuffer[i][0],numFrames*2,samplerate);
 				err = alGetError();
-				if (err != AL_NO_ERROR){
-					ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": "
-					<< (int) err << " " << getALErrorString(err);
+				if ( err != AL_NO_ERROR){
+					ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": " << (int) err << " " << getALErrorString(err);
 					return false;
 				}
-				alSourcei (sources[i], AL_BUFFER,   buffers[i]   );
+				alSourceQueueBuffers(sources[i],1,&buffers[s*channels+i]);
 			}
+			stream(fileName,buffer);
 		}
+	}
+	stream_end = false;
+	if(!setupSources(fileName)){
+		return false;
+	}
 
+	streamState = std::make_shared<Stream>();
+	streamState->player = this;
+	streamingService().add(streamState);
+	return true;
+}
 
-		for(int i=0;i<channels;i++){
-			err = alGetError();
-			if (err != AL_NO_ERROR){
-				ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo sources for \"" << fileName << "\": "
-				<< (int) err << " " << getALErrorString(err);
-				return false;
-			}
-
-			// only stereo panning
-			if(i==0){
-				float pos[3] = {-1,0,0};
-				alSourcefv(sources[i],AL_POSITION,pos);
-			}else{
-				float pos[3] = {1,0,0};
-				alSourcefv(sources[i],AL_POSITION,pos);
-			}
-			alSourcef (sources[i], AL_ROLLOFF_FACTOR,  0.0);
-			alSourcei (sources[i], AL_SOURCE_RELATIVE, AL_TRUE);
-		}
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::setupSources(const std::filesystem::path& fileName){
+	if(channels==1){
+		alSourcef (sources[0], AL_PITCH,    1.0f);
+		alSourcef (sources[0], AL_GAIN,     1.0f);
+	    alSourcef (sources[0], AL_ROLLOFF_FACTOR,  0.0);
+	    alSourcei (sources[0], AL_SOURCE_RELATIVE, AL_TRUE);
+		return true;
 	}
 
-	bLoadedOk = true;
-	return bLoadedOk;
+	for(int i=0;i<channels;i++){
+		int err = alGetError();
+		if (err != AL_NO_ERROR){
+			ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo sources for \"" << fileName << "\": "
+			<< (int) err << " " << getALErrorString(err);
+			return false;
+		}
 
+		// only stereo panning
+		if(i==0){
+			float pos[3] = {-1,0,0};
+			alSourcefv(sources[i],AL_POSITION,pos);
+		}else{
+			float pos[3] = {1,0,0};
+			alSourcefv(sources[i],AL_POSITION,pos);
+		}
+		alSourcef (sources[i], AL_ROLLOFF_FACTOR,  0.0);
+		alSourcei (sources[i], AL_SOURCE_RELATIVE, AL_TRUE);
+	}
+	return true;
 }
 
 //------------------------------------------------------------
@@ -563,56 +881,110 @@ bool ofOpenALSoundPlayer::isLoaded() const{
 }
 
 //------------------------------------------------------------
-void ofOpenALSoundPlayer::threadedFunction(){
-	vector<vector<short> > multibuffer;
-	multibuffer.resize(channels);
-	while(isThreadRunning()){
-		std::unique_lock<std::mutex> lock(mutex);
-		for(int i=0; i<int(sources.size())/channels; i++){
-			int processed;
-			alGetSourcei(sources[i*channels], AL_BUFFERS_PROCESSED, &processed);
-
-			while(processed--)
-			{
-				stream("",buffer);
-				int numFrames = buffer.size()/channels;
-				if(channels>1){
-					for(int j=0;j<channels;j++){
-						multibuffer[j].resize(buffer.size()/channels);
-						for(int k=0;k<numFrames;k++){
-							multibuffer[j][k] = buffer[k*channels+j];
-						}
-						ALuint albuffer;
-						alSourceUnqueueBuffers(sources[i*channels+j], 1, &albuffer);
-						alBufferData(albuffer,AL_FORMAT_MONO16,&multibuffer[j][0],buffer.size()*2/channels,samplerate);
-						alSourceQueueBuffers(sources[i*channels+j], 1, &albuffer);
+// called by the streaming threads with the stream locked
+bool ofOpenALSoundPlayer::serviceStream(Stream & stream){
+	bool busy = false;
+	if(stream.playing && !sources.empty()){
+		// refill the buffers that finished playing with the chunks decoded ahead
+		ALint processed = 0;
+		alGetSourcei(sources[0], AL_BUFFERS_PROCESSED, &processed);
+		while(processed > 0 && stream.count > 0){
+			vector<short> & chunk = stream.chunks[stream.first];
+			int numFrames = chunk.size()/channels;
+			if(channels>1){
+				multibuffer.resize(channels);
+				for(int j=0;j<channels;j++){
+					multibuffer[j].resize(numFrames);
+					for(int k=0;k<numFrames;k++){
+						multibuffer[j][k] = chunk[k*channels+j];
 					}
-				}else{
 					ALuint albuffer;
-					alSourceUnqueueBuffers(sources[i], 1, &albuffer);
-					alBufferData(albuffer,AL_FORMAT_MONO16,&buffer[0],buffer.size()*2/channels,samplerate);
-					alSourceQueueBuffers(sources[i], 1, &albuffer);
-				}
-				if(stream_end){
-					break;
+					alSourceUnqueueBuffers(sources[j], 1, &albuffer);
+					alBufferData(albuffer,AL_FORMAT_MONO16,&multibuffer[j][0],numFrames*2,samplerate);
+					alSourceQueueBuffers(sources[j], 1, &albuffer);
 				}
+			}else{
+				ALuint albuffer;
+				alSourceUnqueueBuffers(sources[0], 1, &albuffer);
+				alBufferData(albuffer,AL_FORMAT_MONO16,&chunk[0],chunk.size()*2,samplerate);
+				alSourceQueueBuffers(sources[0], 1, &albuffer);
 			}
-			ALint state;
-			alGetSourcei(sources[i*channels],AL_SOURCE_STATE,&state);
-			bool stream_running=false;
-			#ifdef OF_USING_MPG123
-				stream_running = streamf || mp3streamf;
-			#else
-				stream_running = streamf;
-			#endif
-			if(state != AL_PLAYING && stream_running && !stream_end){
-				alSourcePlayv(channels,&sources[i*channels]);
+			stream.aheadSamples -= chunk.size();
+			stream.first = (stream.first + 1) % Stream::numChunks;
+			stream.count--;
+			processed--;
+			busy = true;
+		}
+
+		ALint state, queued = 0;
+		alGetSourcei(sources[0], AL_SOURCE_STATE, &state);
+		alGetSourcei(sources[0], AL_BUFFERS_QUEUED, &queued);
+		if(state != AL_PLAYING && !stream.paused){
+			if(processed == 0 && queued > 0){
+				// starting, or after running out of decoded chunks, once
+				// every queued buffer has new samples
+				alSourcePlayv(channels,&sources[0]);
+			}else if(stream.finished && stream.count == 0){
+				stream.playing = false;
 			}
+		}
 
-			stream_end = false;
+		// decode one chunk ahead per pass so other streams get their turn,
+		// only one while over the memory limit
+		size_t target = Stream::numChunks;
+		size_t limit = decodedMemoryLimit;
+		if(limit > 0 && decodedMemory() > limit){
+			target = 1;
+		}
+		if(!stream.finished && stream.count < target){
+			vector<short> & chunk = stream.chunks[(stream.first + stream.count) % Stream::numChunks];
+			if(this->stream("", chunk) && !chunk.empty()){
+				stream.count++;
+				stream.aheadSamples += chunk.size();
+			}
+			if(stream_end){
+				stream_end = false;
+				if(!bLoop){
+					stream.finished = true;
+				}
+			}
+
+			size_t memory = 0;
+			for(auto & decoded: stream.chunks){
+				memory += decoded.capacity() * sizeof(short);
+			}
+			if(memory > stream.memory){
+				decodedMemory() += memory - stream.memory;
+			}else{
+				decodedMemory() -= stream.memory - memory;
+			}
+			stream.memory = memory;
+			busy = true;
 		}
-		sleep(1);
 	}
+	return busy;
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::seekStream(int ms){
+#ifdef OF_USING_MPG123
+	if(mp3streamf){
+		mpg123_seek(mp3streamf,float(ms)/1000.f*samplerate,SEEK_SET);
+	}else
+#endif
+	if(streamf){
+        stream_samples_read = sf_seek(streamf,float(ms)/1000.f*samplerate,SEEK_SET) * channels;
+	}
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::rewindStream(Stream & stream, int ms){
+	seekStream(ms);
+	stream.first = 0;
+	stream.count = 0;
+	stream.aheadSamples = 0;
+	stream.finished = false;
+	stream_end = false;
 }
 
 //------------------------------------------------------------
@@ -637,6 +1009,22 @@ void ofOpenALSoundPlayer::unload(){
 	stop();
 	ofRemoveListener(ofEvents().update,this,&ofOpenALSoundPlayer::update);
 
+	// discards any async load still running
+	loadId++;
+	loading = false;
+
+	// the streaming threads don't touch the player once it's unregistered
+	if(streamState){
+		{
+			std::unique_lock<std::mutex> lock(streamState->mutex);
+			streamState->player = nullptr;
+			decodedMemory() -= streamState->memory;
+			streamState->memory = 0;
+		}
+		streamingService().remove(streamState);
+		streamState.reset();
+	}
+
 	// Only lock the thread where necessary.
 	{
 		std::unique_lock<std::mutex> lock(mutex);
@@ -662,14 +1050,17 @@ void ofOpenALSoundPlayer::unload(){
 		sf_close(streamf);
 	}
 	streamf = 0;
+	compressed.reset();
 
+	fftBuffers.clear();
+	setMemoryUsed(0);
 	bLoadedOk = false;
 }
 
 //------------------------------------------------------------
 bool ofOpenALSoundPlayer::isPlaying() const{
 	if(sources.empty()) return false;
-	if(isStreaming) return isThreadRunning();
+	if(isStreaming) return streamState && streamState->playing;
 	ALint state;
 	bool playing=false;
 	for(int i=0;i<(int)sources.size();i++){
@@ -725,13 +1116,11 @@ void ofOpenALSoundPlayer::setPosition(float pct){
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPositionMS(int ms){
 	if(sources.empty()) return;
-#ifdef OF_USING_MPG123
-	if(mp3streamf){
-		mpg123_seek(mp3streamf,float(ms)/1000.f*samplerate,SEEK_SET);
-	}else
-#endif
-	if(streamf){
-        stream_samples_read = sf_seek(streamf,float(ms)/1000.f*samplerate,SEEK_SET) * channels;
+	if(streamState){
+		// the chunks decoded ahead are discarded, the ones already queued
+		// in OpenAL still play
+		std::unique_lock<std::mutex> lock(streamState->mutex);
+		rewindStream(*streamState, ms);
 	}else{
 		for(int i=0;i<(int)channels;i++){
 			alSourcef(sources[sources.size()-channels+i],AL_SEC_OFFSET,float(ms)/1000.f);
@@ -751,13 +1140,15 @@ float ofOpenALSoundPlayer::getPosition() const{
 int ofOpenALSoundPlayer::getPositionMS() const{
 	if(sources.empty()) return 0;
 	float pos;
+	// streams are decoded ahead of what is playing
+	float ahead = streamState ? float(streamState->aheadSamples) / float(channels) : 0;
 #ifdef OF_USING_MPG123
 	if(mp3streamf){
-		pos = float(mpg123_tell(mp3streamf)) / float(samplerate);
+		pos = std::max(float(mpg123_tell(mp3streamf)) - ahead, 0.f) / float(samplerate);
 	}else
 #endif
 	if(streamf){
-		pos = float(stream_samples_read) / float(channels) / float(samplerate);
+		pos = std::max(float(stream_samples_read) / float(channels) - ahead, 0.f) / float(samplerate);
 	}else{
 		alGetSourcef(sources[sources.size()-1],AL_SEC_OFFSET,&pos);
 	}
@@ -795,17 +1186,23 @@ void ofOpenALSoundPlayer::setPan(float p){
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPaused(bool bP){
 	if(sources.empty()) return;
+	if(streamState){
+		std::unique_lock<std::mutex> lock(streamState->mutex);
+		streamState->paused = bP;
+		if(bP){
+			alSourcePausev(sources.size(),&sources[0]);
+		}else{
+			alSourcePlayv(sources.size(),&sources[0]);
+			streamState->playing = true;
+		}
+		bPaused = bP;
+		return;
+	}
 	std::unique_lock<std::mutex> lock(mutex);
 	if(bP){
 		alSourcePausev(sources.size(),&sources[0]);
-		if(isStreaming){
-			stopThread();
-		}
 	}else{
 		alSourcePlayv(sources.size(),&sources[0]);
-		if(isStreaming){
-			startThread();
-		}
 	}
 
 	bPaused = bP;
@@ -848,6 +1245,17 @@ void ofOpenALSoundPlayer::setMultiPlay(bool bMp){
 
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::play(){
+	if(sources.empty()) return;
+	if(streamState){
+		// stopping flushes the queued buffers, the streaming threads refill
+		// them from the start and play once they are all new
+		std::unique_lock<std::mutex> lock(streamState->mutex);
+		alSourceStopv(channels,&sources[0]);
+		rewindStream(*streamState, 0);
+		streamState->paused = false;
+		streamState->playing = true;
+		return;
+	}
 	std::unique_lock<std::mutex> lock(mutex);
 	int err = glGetError();
 
@@ -889,23 +1297,21 @@ void ofOpenALSoundPlayer::play(){
 	if(bMultiPlay){
 		ofAddListener(ofEvents().update,this,&ofOpenALSoundPlayer::update);
 	}
-	if(isStreaming){
-		setPosition(0);
-		stream_end = false;
-		startThread();
-	}
 
 }
 
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::stop(){
 	if(sources.empty()) return;
+	if(streamState){
+		std::unique_lock<std::mutex> lock(streamState->mutex);
+		alSourceStopv(channels,&sources[0]);
+		streamState->playing = false;
+		rewindStream(*streamState, 0);
+		return;
+	}
 	std::unique_lock<std::mutex> lock(mutex);
 	alSourceStopv(channels,&sources[sources.size()-channels]);
-	if(isStreaming){
-		setPosition(0);
-		stopThread();
-	}
 }
 
 // ----------------------------------------------------------------------------
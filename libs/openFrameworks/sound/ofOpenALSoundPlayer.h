@@ -7,6 +7,8 @@
 #include "ofEvents.h"
 #include "ofThread.h"
 #include "ofFileUtils.h"
+#include <atomic>
+#include <memory>
 
 #if defined (TARGET_OF_IOS) || defined (TARGET_OSX)
 #include <OpenAL/al.h>
@@ -44,6 +46,9 @@ float * ofFmodSoundGetSpectrum(int nBands);		// max 512...
 
 
 // --------------------- player functions:
+/// Streams don't have a thread each, a few threads shared by all of them,
+/// see setNumStreamingThreads(), decode every stream ahead into a small ring
+/// of chunks that are reused and refill the OpenAL buffers from it.
 class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 
 	public:
@@ -52,6 +57,41 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		virtual ~ofOpenALSoundPlayer();
 
         bool load(const std::filesystem::path& fileName, bool stream = false);
+
+		/// \brief Decodes the file in the background and creates the sound
+		/// in the main thread, loadedEvent is notified when it's done
+		///
+		/// Streams only decode their first chunks so they are opened right
+		/// away, the event is still notified in the next update.
+		void loadAsync(const std::filesystem::path& fileName, bool stream = false);
+
+		/// \brief Keeps the file encoded in memory and decodes it while it
+		/// plays, like a stream but without reading from disk
+		///
+		/// A sound loaded with load() is decoded whole and held twice, as 16
+		/// bit samples in OpenAL and as floats for the spectrum. Compressed
+		/// sounds only keep the file, a few times smaller for mp3, ogg or
+		/// flac, and the few chunks decoded ahead, so a large library of
+		/// samples can stay loaded:
+		///
+		/// ~~~~{.cpp}
+		/// for(auto & file: ofDirectory("samples").getFiles()){
+		///     samples.emplace_back(std::make_shared<ofOpenALSoundPlayer>());
+		///     samples.back()->loadCompressed(file.path());
+		/// }
+		/// ~~~~
+		///
+		/// They play through the streaming threads so, like streams, they
+		/// can't multiplay and take a chunk to start.
+		bool loadCompressed(const std::filesystem::path& fileName);
+
+		/// \brief true between loadAsync() and loadedEvent
+		bool isLoading() const;
+
+		/// \brief Notified in the main thread when loadAsync() finishes, with
+		/// true if the sound loaded
+		ofEvent<bool> loadedEvent;
+
 		void unload();
 		void play();
 		void stop();
@@ -78,15 +118,55 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		static void initialize();
 		static void close();
 
+		/// \brief Caps the decoded audio kept in memory by all the players, in
+		/// bytes, 0 for no limit
+		///
+		/// Sounds loaded in memory that would go over it fail to load and
+		/// streams only decode one chunk ahead while it's exceeded.
+		static void setDecodedMemoryLimit(std::size_t bytes);
+		static std::size_t getDecodedMemoryLimit();
+
+		/// \brief Decoded audio held in memory by all the players, in bytes
+		static std::size_t getDecodedMemory();
+
+		/// \brief Threads shared by all the streams to decode and refill
+		/// OpenAL, 2 by default, takes effect when the threads next start
+		static void setNumStreamingThreads(std::size_t numThreads);
+
 		float * getSpectrum(int bands);
 
 		static float * getSystemSpectrum(int bands);
 
-	protected:
-		void threadedFunction();
-
 	private:
 		friend void ofOpenALSoundUpdate();
+
+		// decoded samples of a sound loaded in memory
+		struct Decoded{
+			std::vector<short> buffer;
+			std::vector<float> fftAuxBuffer;
+			int channels = 0;
+			int samplerate = 0;
+			float duration = 0;
+		};
+
+		// state shared with the streaming threads, which only touch the player while
+		// holding mutex and player isn't null
+		struct Stream;
+		struct StreamingService;
+
+		// encoded file of a compressed sound, read by the decoders instead of
+		// the disk
+		struct MemoryFile;
+
+		static StreamingService & streamingService();
+		bool serviceStream(Stream & stream);
+		void rewindStream(Stream & stream, int ms);
+		void seekStream(int ms);
+		bool loadStream(const std::filesystem::path& fileName);
+		bool loadDecoded(const std::filesystem::path& fileName, Decoded & decoded);
+		bool setupSources(const std::filesystem::path& fileName);
+		void setMemoryUsed(std::size_t bytes);
+
 		void update(ofEventArgs & args);
 		void initFFT(int bands);
 		float * getCurrentBufferSum(int size);
@@ -95,14 +175,14 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		static void runWindow(std::vector<float> & signal);
 		static void initSystemFFT(int bands);
 
-        bool sfReadFile(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
+        static bool sfReadFile(const std::filesystem::path& path,Decoded & decoded);
         bool sfStream(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
 #ifdef OF_USING_MPG123
-        bool mpg123ReadFile(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
+        static bool mpg123ReadFile(const std::filesystem::path& path,Decoded & decoded);
         bool mpg123Stream(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
 #endif
 
-        bool readFile(const std::filesystem::path& fileName,std::vector<short> & buffer);
+        static bool readFile(const std::filesystem::path& fileName,Decoded & decoded);
         bool stream(const std::filesystem::path& fileName, std::vector<short> & buffer);
 
 		bool isStreaming;
@@ -153,6 +233,14 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		std::vector<float> fftAuxBuffer;
 
 		bool stream_end;
+
+		std::shared_ptr<Stream> streamState;
+		std::shared_ptr<MemoryFile> compressed;
+		std::vector<std::vector<short> > multibuffer;
+		std::size_t memoryUsed;
+		bool loading;
+		uint64_t loadId;
+		std::shared_ptr<bool> alive;
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include "ofMath.h"
 #include "ofUtils.h"
 #include "ofAppRunner.h"
+#include "ofMetrics.h"
 #include "RtAudio.h"
 
 using namespace std;
@@ -59,7 +60,9 @@ ofSoundDevice::Api toOf(RtAudio::Api api){
 }
 
 //------------------------------------------------------------------------------
-ofRtAudioSoundStream::ofRtAudioSoundStream() {
+ofRtAudioSoundStream::ofRtAudioSoundStream()
+:numXRuns(0)
+,xRunsMetric(&ofGetMetrics().getCounter("of_sound_xruns_total", "Buffers the sound devices reported as over or underflowed")){
 	tickCount = 0;
 }
 
@@ -130,6 +133,7 @@ bool ofRtAudioSoundStream::setup(const ofSoundStreamSettings & settings_)
 	this->settings = settings_;
 
 	tickCount = 0;
+	numXRuns = 0;
 	this->settings.bufferSize = ofNextPow2(settings.bufferSize);	// must be pow2
 
 	try {
@@ -168,6 +172,12 @@ bool ofRtAudioSoundStream::setup(const ofSoundStreamSettings & settings_)
 
 	RtAudio::StreamOptions options;
 	options.flags = RTAUDIO_SCHEDULE_REALTIME;
+	if (settings.minimizeLatency) {
+		options.flags |= RTAUDIO_MINIMIZE_LATENCY;
+	}
+	if (settings.exclusive) {
+		options.flags |= RTAUDIO_HOG_DEVICE;
+	}
 	options.numberOfBuffers = settings.numBuffers;
 	options.priority = 1;
 	outputBuffer.setDeviceID(outputParameters.deviceId);
@@ -178,6 +188,16 @@ bool ofRtAudioSoundStream::setup(const ofSoundStreamSettings & settings_)
 	try {
 		audio->openStream((settings.numOutputChannels > 0) ? &outputParameters : nullptr, (settings.numInputChannels > 0) ? &inputParameters : nullptr, RTAUDIO_FLOAT32,
 			settings.sampleRate, &bufferSize, &rtAudioCallback, this, &options);
+		ofLogVerbose("ofRtAudioSoundStream") << "setup(): " << audio->getStreamLatency() << " frames of latency with "
+			<< options.numberOfBuffers << " buffers of " << bufferSize;
+		// the device can change the buffer size, allocate for the final
+		// one so the callback doesn't have to
+		this->settings.bufferSize = bufferSize;
+		this->settings.numBuffers = options.numberOfBuffers;
+		outputBuffer.setNumChannels(std::max<size_t>(settings.numOutputChannels, 1));
+		outputBuffer.resize(bufferSize * settings.numOutputChannels);
+		inputBuffer.setNumChannels(std::max<size_t>(settings.numInputChannels, 1));
+		inputBuffer.resize(bufferSize * settings.numInputChannels);
 		audio->startStream();
 	}
 	catch (std::exception &error) {
@@ -225,6 +245,9 @@ void ofRtAudioSoundStream::close() {
 	catch (std::exception &error) {
 		ofLogError() << error.what();
 	}
+	if (numXRuns > 0) {
+		ofLogWarning("ofRtAudioSoundStream") << "close(): stream over/underflowed " << numXRuns << " times";
+	}
 	settings.outCallback = nullptr;
 	settings.inCallback = nullptr;
 	audio.reset();	// delete
@@ -235,6 +258,30 @@ uint64_t ofRtAudioSoundStream::getTickCount() const {
 	return tickCount;
 }
 
+//------------------------------------------------------------------------------
+uint64_t ofRtAudioSoundStream::getNumXRuns() const {
+	return numXRuns;
+}
+
+//------------------------------------------------------------------------------
+long ofRtAudioSoundStream::getLatency() const {
+	if (audio == nullptr || !audio->isStreamOpen()) return 0;
+
+	try {
+		return audio->getStreamLatency();
+	}
+	catch (std::exception &error) {
+		ofLogError() << error.what();
+		return 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+double ofRtAudioSoundStream::getLatencySeconds() const {
+	if (settings.sampleRate == 0) return 0;
+	return double(getLatency()) / settings.sampleRate;
+}
+
 //------------------------------------------------------------------------------
 int ofRtAudioSoundStream::getNumInputChannels() const {
 	return settings.numInputChannels;
@@ -268,7 +315,8 @@ int ofRtAudioSoundStream::rtAudioCallback(void *outputBuffer, void *inputBuffer,
 	ofRtAudioSoundStream * rtStreamPtr = (ofRtAudioSoundStream *)data;
 
 	if (status) {
-		ofLogWarning("ofRtAudioSoundStream") << "stream over/underflow detected";
+		rtStreamPtr->numXRuns++;
+		rtStreamPtr->xRunsMetric->add();
 	}
 
 	// 	rtAudio uses a system by which the audio
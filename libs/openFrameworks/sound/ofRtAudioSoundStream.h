@@ -6,9 +6,11 @@
 #include "ofSoundStream.h"
 #include "ofTypes.h"
 #include "ofSoundBuffer.h"
+#include <atomic>
 
 typedef unsigned int RtAudioStreamStatus;
 class RtAudio;
+class ofMetricCounter;
 
 class ofRtAudioSoundStream : public ofBaseSoundStream {
 public:
@@ -34,9 +36,25 @@ public:
 	ofSoundDevice getInDevice() const;
 	ofSoundDevice getOutDevice() const;
 
+	/// \brief Number of buffers the device reported as over or underflowed
+	///
+	/// Counted instead of logged, logging from the audio thread can cause
+	/// more of them.
+	uint64_t getNumXRuns() const;
+
+	/// \brief Latency of the open stream in frames, as reported by the api
+	///
+	/// It's the sum of the input and output latencies for streams with
+	/// both, 0 if the api doesn't report it.
+	long getLatency() const;
+
+	/// \brief getLatency() in seconds
+	double getLatencySeconds() const;
 
 private:
 	long unsigned long tickCount;
+	std::atomic<uint64_t> numXRuns;
+	ofMetricCounter * xRunsMetric;
 	std::shared_ptr<RtAudio>	audio;
 
 	ofSoundBuffer inputBuffer;
@@ -0,0 +1,419 @@
+#include "ofSoundAnalyzer.h"
+#include "ofMath.h"
+#include "ofLog.h"
+#include <cmath>
+
+using namespace std;
+
+namespace{
+	const int freshAnalysis = 4;
+
+	float toScale(float frequency, ofSoundAnalyzer::BandScale scale){
+		switch(scale){
+			case ofSoundAnalyzer::LOG: return log(frequency);
+			case ofSoundAnalyzer::MEL: return 2595.f * log10(1.f + frequency / 700.f);
+			default: return frequency;
+		}
+	}
+
+	float fromScale(float value, ofSoundAnalyzer::BandScale scale){
+		switch(scale){
+			case ofSoundAnalyzer::LOG: return exp(value);
+			case ofSoundAnalyzer::MEL: return 700.f * (pow(10.f, value / 2595.f) - 1.f);
+			default: return value;
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofSoundFFT::ofSoundFFT()
+:size(0){
+}
+
+//----------------------------------------------------------
+bool ofSoundFFT::setup(size_t n){
+	if(n < 4 || (n & (n - 1)) != 0){
+		ofLogError("ofSoundFFT") << "setup(): size " << n << " has to be a power of 2 >= 4";
+		return false;
+	}
+	size = n;
+	size_t half = n / 2;
+	bitReversed.resize(half);
+	size_t bits = 0;
+	while((size_t(1) << bits) < half){
+		bits++;
+	}
+	for(size_t i = 0; i < half; i++){
+		size_t r = 0;
+		for(size_t b = 0; b < bits; b++){
+			r |= ((i >> b) & 1) << (bits - 1 - b);
+		}
+		bitReversed[i] = r;
+	}
+	// angles 2 pi k / n, the half size transform uses every other one
+	cosTable.resize(half + 1);
+	sinTable.resize(half + 1);
+	for(size_t k = 0; k <= half; k++){
+		double angle = 2.0 * PI * double(k) / double(n);
+		cosTable[k] = cos(angle);
+		sinTable[k] = sin(angle);
+	}
+	re.resize(half);
+	im.resize(half);
+	imaginary.resize(half + 1);
+	return true;
+}
+
+//----------------------------------------------------------
+size_t ofSoundFFT::getSize() const{
+	return size;
+}
+
+//----------------------------------------------------------
+void ofSoundFFT::transform(float * re, float * im) const{
+	size_t n = size / 2;
+	for(size_t len = 2; len <= n; len <<= 1){
+		size_t half = len / 2;
+		size_t step = 2 * (n / len);
+		for(size_t i = 0; i < n; i += len){
+			for(size_t j = 0; j < half; j++){
+				float c = cosTable[j * step];
+				float s = sinTable[j * step];
+				size_t a = i + j;
+				size_t b = a + half;
+				float vr = re[b] * c + im[b] * s;
+				float vi = im[b] * c - re[b] * s;
+				re[b] = re[a] - vr;
+				im[b] = im[a] - vi;
+				re[a] += vr;
+				im[a] += vi;
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundFFT::forward(const float * samples, float * real, float * imaginary){
+	if(size == 0){
+		return;
+	}
+	// the even samples as the real part and the odd ones as the imaginary,
+	// transformed at half the size and split back into the real spectrum
+	size_t n = size / 2;
+	for(size_t i = 0; i < n; i++){
+		re[bitReversed[i]] = samples[i * 2];
+		im[bitReversed[i]] = samples[i * 2 + 1];
+	}
+	transform(&re[0], &im[0]);
+	for(size_t k = 0; k <= n; k++){
+		size_t a = k % n;
+		size_t b = (n - k) % n;
+		float evenR = (re[a] + re[b]) * 0.5f;
+		float evenI = (im[a] - im[b]) * 0.5f;
+		float oddR = (im[a] + im[b]) * 0.5f;
+		float oddI = (re[b] - re[a]) * 0.5f;
+		float c = cosTable[k];
+		float s = sinTable[k];
+		real[k] = evenR + oddR * c + oddI * s;
+		imaginary[k] = evenI + oddI * c - oddR * s;
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundFFT::magnitudes(const float * samples, float * magnitudes){
+	if(size == 0){
+		return;
+	}
+	forward(samples, magnitudes, &imaginary[0]);
+	for(size_t k = 0; k <= size / 2; k++){
+		magnitudes[k] = sqrt(magnitudes[k] * magnitudes[k] + imaginary[k] * imaginary[k]);
+	}
+}
+
+//----------------------------------------------------------
+ofSoundAnalyzer::ofSoundAnalyzer()
+:sampleRate(0)
+,writePosition(0)
+,untilHop(0)
+,fluxAverage(0)
+,lastOnset(0)
+,windowNormalization(1)
+,middle(1)
+,back(0)
+,front(2)
+,numOnsets(0)
+,numAnalyses(0)
+,lastReadOnsets(0)
+,onset(false){
+}
+
+//----------------------------------------------------------
+bool ofSoundAnalyzer::setup(const Settings & s, unsigned int rate){
+	if(s.hopSize == 0 || s.hopSize > s.fftSize || rate == 0){
+		ofLogError("ofSoundAnalyzer") << "setup(): hop size has to be between 1 and the fft size, and the sample rate > 0";
+		return false;
+	}
+	if(!fft.setup(s.fftSize)){
+		return false;
+	}
+	settings = s;
+	sampleRate = rate;
+
+	size_t n = settings.fftSize;
+	history.assign(n, 0);
+	windowed.assign(n, 0);
+	window.resize(n);
+	double sum = 0;
+	for(size_t i = 0; i < n; i++){
+		double x = double(i) / double(n);
+		switch(settings.window){
+			case HANN: window[i] = 0.5 - 0.5 * cos(2 * PI * x); break;
+			case HAMMING: window[i] = 0.54 - 0.46 * cos(2 * PI * x); break;
+			case BLACKMAN: window[i] = 0.42 - 0.5 * cos(2 * PI * x) + 0.08 * cos(4 * PI * x); break;
+			default: window[i] = 1; break;
+		}
+		sum += window[i];
+	}
+	// a full scale sine has a magnitude of 1 whatever the window
+	windowNormalization = 2.0 / sum;
+
+	previousMagnitudes.assign(n / 2 + 1, 0);
+	for(auto & analysis: analyses){
+		analysis.magnitudes.assign(n / 2 + 1, 0);
+		analysis.bands.assign(settings.numBands, 0);
+		analysis.rms = 0;
+		analysis.flux = 0;
+		analysis.centroid = 0;
+		analysis.index = 0;
+	}
+	setupBands();
+
+	writePosition = 0;
+	untilHop = settings.hopSize;
+	fluxAverage = 0;
+	lastOnset = 0;
+	middle = 1;
+	back = 0;
+	front = 2;
+	numOnsets = 0;
+	numAnalyses = 0;
+	lastReadOnsets = 0;
+	onset = false;
+	return true;
+}
+
+//----------------------------------------------------------
+void ofSoundAnalyzer::setupBands(){
+	// triangular filters spaced evenly on the scale, each one from the
+	// center of the previous to the center of the next
+	float nyquist = sampleRate * 0.5f;
+	float minFrequency = ofClamp(settings.minFrequency, 1.f, nyquist);
+	float maxFrequency = ofClamp(settings.maxFrequency, minFrequency, nyquist);
+	float lo = toScale(minFrequency, settings.bandScale);
+	float hi = toScale(maxFrequency, settings.bandScale);
+	size_t numBands = settings.numBands;
+	size_t numBins = settings.fftSize / 2 + 1;
+	float binWidth = float(sampleRate) / settings.fftSize;
+
+	bandWeights.clear();
+	bandStarts.assign(numBands + 1, 0);
+	bandFrequencies.resize(numBands);
+	for(size_t b = 0; b < numBands; b++){
+		float start = fromScale(ofLerp(lo, hi, float(b) / (numBands + 1)), settings.bandScale);
+		float center = fromScale(ofLerp(lo, hi, float(b + 1) / (numBands + 1)), settings.bandScale);
+		float end = fromScale(ofLerp(lo, hi, float(b + 2) / (numBands + 1)), settings.bandScale);
+		bandFrequencies[b] = center;
+		bandStarts[b] = bandWeights.size();
+
+		float total = 0;
+		for(size_t bin = size_t(start / binWidth); bin < numBins && bin * binWidth < end; bin++){
+			float f = bin * binWidth;
+			float weight = f < center ? (f - start) / (center - start) : (end - f) / (end - center);
+			if(weight > 0){
+				bandWeights.push_back({bin, weight});
+				total += weight;
+			}
+		}
+		if(total == 0){
+			// narrower than a bin, interpolated between the two around it
+			float position = center / binWidth;
+			size_t bin = std::min(size_t(position), numBins - 2);
+			float t = position - bin;
+			bandWeights.push_back({bin, 1 - t});
+			bandWeights.push_back({bin + 1, t});
+		}else{
+			for(size_t i = bandStarts[b]; i < bandWeights.size(); i++){
+				bandWeights[i].weight /= total;
+			}
+		}
+	}
+	bandStarts[numBands] = bandWeights.size();
+}
+
+//----------------------------------------------------------
+const ofSoundAnalyzer::Settings & ofSoundAnalyzer::getSettings() const{
+	return settings;
+}
+
+//----------------------------------------------------------
+unsigned int ofSoundAnalyzer::getSampleRate() const{
+	return sampleRate;
+}
+
+//----------------------------------------------------------
+void ofSoundAnalyzer::audioIn(ofSoundBuffer & buffer){
+	process(buffer);
+}
+
+//----------------------------------------------------------
+void ofSoundAnalyzer::process(const ofSoundBuffer & buffer){
+	if(buffer.size() > 0){
+		process(&buffer[0], buffer.getNumFrames(), buffer.getNumChannels());
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundAnalyzer::process(const float * samples, size_t numFrames, size_t numChannels){
+	if(history.empty() || numChannels == 0){
+		return;
+	}
+	float gain = 1.f / numChannels;
+	size_t n = history.size();
+	for(size_t i = 0; i < numFrames; i++){
+		float sample = 0;
+		for(size_t c = 0; c < numChannels; c++){
+			sample += samples[i * numChannels + c];
+		}
+		history[writePosition] = sample * gain;
+		if(++writePosition == n){
+			writePosition = 0;
+		}
+		if(--untilHop == 0){
+			analyze();
+			untilHop = settings.hopSize;
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundAnalyzer::analyze(){
+	size_t n = history.size();
+	size_t numBins = n / 2 + 1;
+	Analysis & analysis = analyses[back];
+
+	// oldest sample first
+	float sumOfSquares = 0;
+	size_t tail = n - writePosition;
+	for(size_t i = 0; i < tail; i++){
+		float sample = history[writePosition + i];
+		sumOfSquares += sample * sample;
+		windowed[i] = sample * window[i];
+	}
+	for(size_t i = 0; i < writePosition; i++){
+		float sample = history[i];
+		sumOfSquares += sample * sample;
+		windowed[tail + i] = sample * window[tail + i];
+	}
+	analysis.rms = sqrt(sumOfSquares / n);
+
+	auto & magnitudes = analysis.magnitudes;
+	fft.magnitudes(&windowed[0], &magnitudes[0]);
+	float flux = 0;
+	float weighted = 0;
+	float total = 0;
+	float binWidth = float(sampleRate) / n;
+	for(size_t k = 0; k < numBins; k++){
+		float magnitude = magnitudes[k] * windowNormalization;
+		magnitudes[k] = magnitude;
+		flux += std::max(0.f, magnitude - previousMagnitudes[k]);
+		previousMagnitudes[k] = magnitude;
+		weighted += magnitude * k * binWidth;
+		total += magnitude;
+	}
+	analysis.flux = flux;
+	analysis.centroid = total > 0 ? weighted / total : 0;
+
+	for(size_t b = 0; b < settings.numBands; b++){
+		float value = 0;
+		for(size_t i = bandStarts[b]; i < bandStarts[b + 1]; i++){
+			value += magnitudes[bandWeights[i].bin] * bandWeights[i].weight;
+		}
+		analysis.bands[b] = value;
+	}
+
+	uint64_t index = numAnalyses.load(std::memory_order_relaxed) + 1;
+	analysis.index = index;
+	// onsets are peaks of the flux over its recent average, spaced at least
+	// the minimum interval
+	uint64_t minInterval = uint64_t(settings.minOnsetInterval * sampleRate / settings.hopSize);
+	if(index > 1 && flux > fluxAverage * settings.onsetThreshold && flux > 1e-4f && (lastOnset == 0 || index - lastOnset >= minInterval)){
+		lastOnset = index;
+		numOnsets.fetch_add(1, std::memory_order_relaxed);
+	}
+	fluxAverage = fluxAverage * 0.9f + flux * 0.1f;
+
+	back = middle.exchange(back | freshAnalysis, std::memory_order_acq_rel) & 3;
+	numAnalyses.store(index, std::memory_order_release);
+}
+
+//----------------------------------------------------------
+bool ofSoundAnalyzer::update(){
+	uint64_t onsets = numOnsets.load(std::memory_order_relaxed);
+	onset = onsets != lastReadOnsets;
+	lastReadOnsets = onsets;
+	if((middle.load(std::memory_order_relaxed) & freshAnalysis) == 0){
+		return false;
+	}
+	front = middle.exchange(front, std::memory_order_acq_rel) & 3;
+	return true;
+}
+
+//----------------------------------------------------------
+const vector<float> & ofSoundAnalyzer::getMagnitudes() const{
+	return analyses[front].magnitudes;
+}
+
+//----------------------------------------------------------
+const vector<float> & ofSoundAnalyzer::getBands() const{
+	return analyses[front].bands;
+}
+
+//----------------------------------------------------------
+float ofSoundAnalyzer::getBandFrequency(size_t band) const{
+	return band < bandFrequencies.size() ? bandFrequencies[band] : 0;
+}
+
+//----------------------------------------------------------
+float ofSoundAnalyzer::getBinFrequency(size_t bin) const{
+	return settings.fftSize > 0 ? float(bin) * sampleRate / settings.fftSize : 0;
+}
+
+//----------------------------------------------------------
+float ofSoundAnalyzer::getRMS() const{
+	return analyses[front].rms;
+}
+
+//----------------------------------------------------------
+float ofSoundAnalyzer::getSpectralFlux() const{
+	return analyses[front].flux;
+}
+
+//----------------------------------------------------------
+float ofSoundAnalyzer::getSpectralCentroid() const{
+	return analyses[front].centroid;
+}
+
+//----------------------------------------------------------
+bool ofSoundAnalyzer::isOnset() const{
+	return onset;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundAnalyzer::getNumOnsets() const{
+	return numOnsets.load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundAnalyzer::getNumAnalyses() const{
+	return numAnalyses.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "ofBaseTypes.h"
+#include "ofSoundBuffer.h"
+#include <atomic>
+#include <vector>
+
+/// \brief Real FFT of a power of 2 size
+///
+/// Computes the spectrum of size real samples as a complex FFT of half the
+/// size. The tables are allocated by setup(), transforming doesn't allocate
+/// so it can run in the audio thread.
+class ofSoundFFT{
+public:
+	ofSoundFFT();
+
+	/// \brief Allocates the tables for size samples, a power of 2 >= 4
+	bool setup(std::size_t size);
+	std::size_t getSize() const;
+
+	/// \brief Transforms size samples into size / 2 + 1 complex bins, from
+	/// dc to nyquist
+	void forward(const float * samples, float * real, float * imaginary);
+
+	/// \brief Magnitudes of the size / 2 + 1 bins of samples
+	void magnitudes(const float * samples, float * magnitudes);
+
+private:
+	void transform(float * re, float * im) const;
+
+	std::size_t size;
+	std::vector<std::size_t> bitReversed;
+	std::vector<float> cosTable, sinTable;
+	std::vector<float> re, im;
+	std::vector<float> imaginary;
+};
+
+/// \brief Spectrum, bands and features of a sound, computed in the audio
+/// thread and read from any other without blocking
+///
+/// Feed it the audio of a stream by setting it as its input listener, or
+/// calling process() from an audioOut() or an ofSoundMeter in a graph. Every
+/// hop size samples the last fft size samples, mixed to mono, are windowed
+/// and transformed. The results are published through a lock-free triple
+/// buffer, update() in the main thread gets the latest one:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofSoundAnalyzer::Settings analysis;
+///     analysis.numBands = 24;
+///     analyzer.setup(analysis, 44100);
+///
+///     ofSoundStreamSettings settings;
+///     settings.numInputChannels = 1;
+///     settings.sampleRate = 44100;
+///     settings.setInListener(&analyzer);
+///     stream.setup(settings);
+/// }
+///
+/// void ofApp::update(){
+///     analyzer.update();
+///     if(analyzer.isOnset()){
+///         flash = 1;
+///     }
+/// }
+///
+/// void ofApp::draw(){
+///     auto & bands = analyzer.getBands();
+///     for(size_t i = 0; i < bands.size(); i++){
+///         ofDrawRectangle(i * 20, ofGetHeight(), 18, -bands[i] * 1000);
+///     }
+/// }
+/// ~~~~
+class ofSoundAnalyzer: public ofBaseSoundInput{
+public:
+	enum Window{
+		RECTANGULAR,
+		HANN,
+		HAMMING,
+		BLACKMAN,
+	};
+
+	enum BandScale{
+		LINEAR,
+		LOG,
+		MEL,
+	};
+
+	struct Settings{
+		std::size_t fftSize = 1024; //< power of 2
+		std::size_t hopSize = 512; //< samples between analyses, fftSize / hopSize is the overlap
+		Window window = HANN;
+		std::size_t numBands = 32;
+		BandScale bandScale = LOG;
+		float minFrequency = 40;
+		float maxFrequency = 16000;
+		float onsetThreshold = 1.5f; //< spectral flux relative to its recent average to detect an onset
+		float minOnsetInterval = 0.05f; //< seconds
+	};
+
+	ofSoundAnalyzer();
+
+	/// \brief Allocates everything for sampleRate, from the main thread and
+	/// before the audio starts
+	bool setup(const Settings & settings, unsigned int sampleRate);
+	const Settings & getSettings() const;
+	unsigned int getSampleRate() const;
+
+	/// \brief Feeds audio, from the audio thread, doesn't allocate or lock
+	void process(const ofSoundBuffer & buffer);
+	void process(const float * samples, std::size_t numFrames, std::size_t numChannels);
+	void audioIn(ofSoundBuffer & buffer) override;
+
+	/// \brief Gets the latest analysis, from the thread that reads it
+	/// \returns true if there was a new one since the last call
+	bool update();
+
+	/// \brief Magnitude of the fftSize / 2 + 1 bins, a full scale sine is 1
+	const std::vector<float> & getMagnitudes() const;
+
+	/// \brief The magnitudes grouped in numBands between minFrequency and
+	/// maxFrequency, spaced on the band scale
+	const std::vector<float> & getBands() const;
+
+	/// \brief Frequency at the center of band
+	float getBandFrequency(std::size_t band) const;
+
+	/// \brief Frequency of bin
+	float getBinFrequency(std::size_t bin) const;
+
+	/// \brief RMS of the samples in the last analysis window
+	float getRMS() const;
+
+	/// \brief Sum of the increases in magnitude since the previous analysis
+	float getSpectralFlux() const;
+
+	/// \brief Magnitude weighted mean frequency, in Hz
+	float getSpectralCentroid() const;
+
+	/// \brief If there was an onset between the last two calls to update()
+	bool isOnset() const;
+
+	/// \brief Onsets detected since setup()
+	uint64_t getNumOnsets() const;
+
+	/// \brief Analyses done since setup()
+	uint64_t getNumAnalyses() const;
+
+private:
+	struct Analysis{
+		std::vector<float> magnitudes;
+		std::vector<float> bands;
+		float rms = 0;
+		float flux = 0;
+		float centroid = 0;
+		uint64_t index = 0;
+	};
+
+	struct BandWeight{
+		std::size_t bin;
+		float weight;
+	};
+
+	void analyze();
+	void setupBands();
+
+	Settings settings;
+	unsigned int sampleRate;
+	ofSoundFFT fft;
+
+	// audio thread
+	std::vector<float> history;
+	std::vector<float> window;
+	std::vector<float> windowed;
+	std::vector<float> previousMagnitudes;
+	std::size_t writePosition;
+	std::size_t untilHop;
+	float fluxAverage;
+	uint64_t lastOnset;
+	float windowNormalization;
+
+	std::vector<BandWeight> bandWeights;
+	std::vector<std::size_t> bandStarts;
+	std::vector<float> bandFrequencies;
+
+	// written by the audio thread in back, swapped with middle to publish and
+	// read from front, middle carries a flag when it's newer than front
+	Analysis analyses[3];
+	std::atomic<int> middle;
+	int back;
+	int front;
+
+	std::atomic<uint64_t> numOnsets;
+	std::atomic<uint64_t> numAnalyses;
+	uint64_t lastReadOnsets;
+	bool onset;
+};
@@ -10,8 +10,265 @@
 #include "ofLog.h"
 #include <limits>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define OF_SOUND_BUFFER_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define OF_SOUND_BUFFER_NEON
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OF_SOUND_BUFFER_SSE2
+#endif
+
 using namespace std;
 
+namespace{
+	const float shortToFloat = 1.f / float(numeric_limits<short>::max());
+	const float floatToShort = float(numeric_limits<short>::max());
+
+	// 4 samples at a time, the kernels below are written once against these
+	// and fall back to plain loops for the remainder or without simd
+#if defined(OF_SOUND_BUFFER_SSE)
+	typedef __m128 Float4;
+
+	inline Float4 load(const float * p){ return _mm_loadu_ps(p); }
+	inline void store(float * p, Float4 v){ _mm_storeu_ps(p, v); }
+	inline Float4 splat(float v){ return _mm_set1_ps(v); }
+	inline Float4 lanes(float a, float b, float c, float d){ return _mm_setr_ps(a, b, c, d); }
+	inline Float4 zero(){ return _mm_setzero_ps(); }
+	inline Float4 add(Float4 a, Float4 b){ return _mm_add_ps(a, b); }
+	inline Float4 sub(Float4 a, Float4 b){ return _mm_sub_ps(a, b); }
+	inline Float4 mul(Float4 a, Float4 b){ return _mm_mul_ps(a, b); }
+	inline Float4 madd(Float4 a, Float4 b, Float4 c){ return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	inline float sum(Float4 v){
+		Float4 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+		return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+	}
+
+	// a b c d -> a a b b, c c d d
+	inline void duplicate(Float4 v, Float4 & lo, Float4 & hi){
+		lo = _mm_unpacklo_ps(v, v);
+		hi = _mm_unpackhi_ps(v, v);
+	}
+
+	// the first channel of 4 stereo frames
+	inline Float4 firstOfPairs(Float4 a, Float4 b){
+		return _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+	}
+	#define OF_SOUND_BUFFER_SIMD
+#elif defined(OF_SOUND_BUFFER_NEON)
+	typedef float32x4_t Float4;
+
+	inline Float4 load(const float * p){ return vld1q_f32(p); }
+	inline void store(float * p, Float4 v){ vst1q_f32(p, v); }
+	inline Float4 splat(float v){ return vdupq_n_f32(v); }
+	inline Float4 lanes(float a, float b, float c, float d){
+		float v[4] = {a, b, c, d};
+		return vld1q_f32(v);
+	}
+	inline Float4 zero(){ return vdupq_n_f32(0); }
+	inline Float4 add(Float4 a, Float4 b){ return vaddq_f32(a, b); }
+	inline Float4 sub(Float4 a, Float4 b){ return vsubq_f32(a, b); }
+	inline Float4 mul(Float4 a, Float4 b){ return vmulq_f32(a, b); }
+	inline Float4 madd(Float4 a, Float4 b, Float4 c){ return vmlaq_f32(c, a, b); }
+	inline float sum(Float4 v){
+		float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+		return vget_lane_f32(vpadd_f32(s, s), 0);
+	}
+
+	inline void duplicate(Float4 v, Float4 & lo, Float4 & hi){
+		float32x4x2_t z = vzipq_f32(v, v);
+		lo = z.val[0];
+		hi = z.val[1];
+	}
+
+	inline Float4 firstOfPairs(Float4 a, Float4 b){
+		return vuzpq_f32(a, b).val[0];
+	}
+	#define OF_SOUND_BUFFER_SIMD
+#endif
+
+	void scaleSamples(float * dst, std::size_t n, float value){
+		std::size_t i = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+		Float4 v = splat(value);
+		for(; i + 4 <= n; i += 4){
+			store(dst + i, mul(load(dst + i), v));
+		}
+#endif
+		for(; i < n; i++){
+			dst[i] *= value;
+		}
+	}
+
+	void addSamples(float * dst, const float * src, std::size_t n){
+		std::size_t i = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+		for(; i + 4 <= n; i += 4){
+			store(dst + i, add(load(dst + i), load(src + i)));
+		}
+#endif
+		for(; i < n; i++){
+			dst[i] += src[i];
+		}
+	}
+
+	// mono to the 2 channels of stereo, the most common of the upmixes
+	void monoToStereo(float * dst, const float * src, std::size_t frames, bool accumulate){
+		std::size_t i = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+		for(; i + 4 <= frames; i += 4){
+			Float4 lo, hi;
+			duplicate(load(src + i), lo, hi);
+			if(accumulate){
+				lo = add(lo, load(dst + i * 2));
+				hi = add(hi, load(dst + i * 2 + 4));
+			}
+			store(dst + i * 2, lo);
+			store(dst + i * 2 + 4, hi);
+		}
+#endif
+		for(; i < frames; i++){
+			if(accumulate){
+				dst[i * 2] += src[i];
+				dst[i * 2 + 1] += src[i];
+			}else{
+				dst[i * 2] = src[i];
+				dst[i * 2 + 1] = src[i];
+			}
+		}
+	}
+
+	// the left channel of stereo to mono
+	void stereoToMono(float * dst, const float * src, std::size_t frames, bool accumulate){
+		std::size_t i = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+		for(; i + 4 <= frames; i += 4){
+			Float4 v = firstOfPairs(load(src + i * 2), load(src + i * 2 + 4));
+			store(dst + i, accumulate ? add(v, load(dst + i)) : v);
+		}
+#endif
+		for(; i < frames; i++){
+			if(accumulate){
+				dst[i] += src[i * 2];
+			}else{
+				dst[i] = src[i * 2];
+			}
+		}
+	}
+
+	// copies, or mixes when accumulating, frames between interleaved layouts:
+	// the first channels when the source has more, repeating them when it has
+	// fewer. If there are 2 and the destination wants 5 they go 1 2 1 2 1
+	void remapFrames(float * dst, std::size_t dstChannels, const float * src, std::size_t srcChannels, std::size_t frames, bool accumulate){
+		if(srcChannels == dstChannels){
+			if(accumulate){
+				addSamples(dst, src, frames * dstChannels);
+			}else{
+				memcpy(dst, src, frames * dstChannels * sizeof(float));
+			}
+		}else if(srcChannels == 2 && dstChannels == 1){
+			stereoToMono(dst, src, frames, accumulate);
+		}else if(srcChannels == 1 && dstChannels == 2){
+			monoToStereo(dst, src, frames, accumulate);
+		}else if(accumulate){
+			for(std::size_t i = 0; i < frames; i++){
+				for(std::size_t j = 0; j < dstChannels; j++){
+					*dst++ += src[j % srcChannels];
+				}
+				src += srcChannels;
+			}
+		}else{
+			for(std::size_t i = 0; i < frames; i++){
+				for(std::size_t j = 0; j < dstChannels; j++){
+					*dst++ = src[j % srcChannels];
+				}
+				src += srcChannels;
+			}
+		}
+	}
+
+	double sumOfSquares(const float * src, std::size_t n){
+		double acc = 0;
+		std::size_t i = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+		// partial sums in float for short runs, added up in double so long
+		// buffers don't lose precision
+		while(i + 4 <= n){
+			std::size_t end = std::min(n - n % 4, i + 4096);
+			Float4 s = zero();
+			for(; i < end; i += 4){
+				Float4 v = load(src + i);
+				s = madd(v, v, s);
+			}
+			acc += sum(s);
+		}
+#endif
+		for(; i < n; i++){
+			acc += src[i] * src[i];
+		}
+		return acc;
+	}
+
+	void shortsToFloats(const short * src, float * dst, std::size_t n){
+		std::size_t i = 0;
+#if defined(OF_SOUND_BUFFER_SSE2)
+		__m128 scale = _mm_set1_ps(shortToFloat);
+		for(; i + 8 <= n; i += 8){
+			__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			// sign extend by unpacking in the high half and shifting back
+			__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+			__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+#elif defined(OF_SOUND_BUFFER_NEON)
+		float32x4_t scale = vdupq_n_f32(shortToFloat);
+		for(; i + 8 <= n; i += 8){
+			int16x8_t s = vld1q_s16(src + i);
+			vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), scale));
+			vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), scale));
+		}
+#endif
+		for(; i < n; i++){
+			dst[i] = src[i] * shortToFloat;
+		}
+	}
+
+	// clamped to the range of short, values over 1 would wrap around otherwise
+	void floatsToShorts(const float * src, short * dst, std::size_t n){
+		const float minShort = numeric_limits<short>::min();
+		const float maxShort = numeric_limits<short>::max();
+		std::size_t i = 0;
+#if defined(OF_SOUND_BUFFER_SSE2)
+		__m128 scale = _mm_set1_ps(floatToShort);
+		__m128 lowest = _mm_set1_ps(minShort);
+		__m128 highest = _mm_set1_ps(maxShort);
+		for(; i + 8 <= n; i += 8){
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lowest), highest);
+			__m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), lowest), highest);
+			__m128i s = _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+		}
+#elif defined(OF_SOUND_BUFFER_NEON)
+		float32x4_t scale = vdupq_n_f32(floatToShort);
+		float32x4_t lowest = vdupq_n_f32(minShort);
+		float32x4_t highest = vdupq_n_f32(maxShort);
+		for(; i + 8 <= n; i += 8){
+			float32x4_t a = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i), scale), lowest), highest);
+			float32x4_t b = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i + 4), scale), lowest), highest);
+			vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+		}
+#endif
+		for(; i < n; i++){
+			dst[i] = short(std::min(std::max(src[i] * floatToShort, minShort), maxShort));
+		}
+	}
+}
+
 #if !defined(TARGET_ANDROID) && !defined(TARGET_IPHONE) && !defined(TARGET_LINUX_ARM)
 ofSoundBuffer::InterpolationAlgorithm ofSoundBuffer::defaultAlgorithm = ofSoundBuffer::Hermite;
 #else
@@ -35,17 +292,17 @@ ofSoundBuffer::ofSoundBuffer(short * shortBuffer, std::size_t numFrames, std::si
 
 void ofSoundBuffer::copyFrom(const short * shortBuffer, std::size_t numFrames, std::size_t numChannels, unsigned int sampleRate) {
 	this->channels = numChannels;
-	setSampleRate(samplerate);
+	setSampleRate(sampleRate);
 	buffer.resize(numFrames * numChannels);
-	for(std::size_t i = 0; i < size(); i++){
-		buffer[i] = shortBuffer[i]/float(numeric_limits<short>::max());
+	if(!buffer.empty()){
+		shortsToFloats(shortBuffer, &buffer[0], buffer.size());
 	}
 	checkSizeAndChannelsConsistency("copyFrom");
 }
 
 void ofSoundBuffer::copyFrom(const float * floatBuffer, std::size_t numFrames, std::size_t numChannels, unsigned int sampleRate) {
 	this->channels = numChannels;
-	setSampleRate(samplerate);
+	setSampleRate(sampleRate);
 	buffer.assign(floatBuffer, floatBuffer + (numFrames * numChannels));
 	checkSizeAndChannelsConsistency("copyFrom");
 }
@@ -58,16 +315,28 @@ void ofSoundBuffer::copyFrom(const vector<float> & floatBuffer, std::size_t numC
 	copyFrom(&floatBuffer[0],floatBuffer.size()/numChannels,numChannels,sampleRate);
 }
 
+void ofSoundBuffer::copyFrom(const ofConstSoundBufferView & view){
+	copyFrom(view.getData(), view.getNumFrames(), view.getNumChannels(), view.getSampleRate());
+}
+
+ofSoundBufferView ofSoundBuffer::getView(){
+	return ofSoundBufferView(*this);
+}
+
+ofConstSoundBufferView ofSoundBuffer::getView() const{
+	return ofConstSoundBufferView(*this);
+}
+
 void ofSoundBuffer::toShortPCM(vector<short> & dst) const{
 	dst.resize(size());
-	for(std::size_t i = 0; i < size(); i++){
-		dst[i] = buffer[i]*float(numeric_limits<short>::max());
+	if(!dst.empty()){
+		toShortPCM(&dst[0]);
 	}
 }
 
 void ofSoundBuffer::toShortPCM(short * dst) const{
-	for(std::size_t i = 0; i < size(); i++){
-		dst[i] = buffer[i]*float(numeric_limits<short>::max());
+	if(!buffer.empty()){
+		floatsToShorts(&buffer[0], dst, buffer.size());
 	}
 }
 
@@ -110,6 +379,10 @@ void ofSoundBuffer::resize(std::size_t samples, float val){
 	checkSizeAndChannelsConsistency("resize(samples,val)");
 }
 
+void ofSoundBuffer::reserve(std::size_t numFrames, std::size_t numChannels){
+	buffer.reserve(numFrames * numChannels);
+}
+
 void ofSoundBuffer::clear(){
 	buffer.clear();
 }
@@ -119,14 +392,10 @@ void ofSoundBuffer::set(float value){
 	checkSizeAndChannelsConsistency("set");
 }
 
-bool ofSoundBuffer::checkSizeAndChannelsConsistency(const std::string& _function ) {
-	std::string function = _function;
-
-	if ( function.size()!= 0 ){
-		function += ": ";
-	}
+bool ofSoundBuffer::checkSizeAndChannelsConsistency(const char * function) {
+	// called from the audio thread, only builds a message when it fails
 	if ( (size()%channels) != 0 ){
-		ofLogWarning("ofSoundBuffer") << function << "channel count " << channels << " is not consistent with sample count " << size() << " (non-zero remainder)";
+		ofLogWarning("ofSoundBuffer") << function << (function[0] ? ": " : "") << "channel count " << channels << " is not consistent with sample count " << size() << " (non-zero remainder)";
 		return false;
 	}
 	return true;
@@ -163,8 +432,8 @@ ofSoundBuffer ofSoundBuffer::operator*(float value){
 }
 
 ofSoundBuffer & ofSoundBuffer::operator*=(float value){
-	for(std::size_t i=0;i<buffer.size();i++){
-		buffer[i] *= value;
+	if(!buffer.empty()){
+		scaleSamples(&buffer[0], buffer.size(), value);
 	}
 	return *this;
 }
@@ -174,10 +443,17 @@ void ofSoundBuffer::stereoPan(float left, float right){
 		ofLogWarning("ofSoundBuffer") << "stereoPan called on a buffer with " << channels << " channels, only works with 2 channels";
 		return;
 	}
-	float * bufferPtr = &buffer[0];
-	for(std::size_t i=0;i<getNumFrames();i++){
-		*bufferPtr++ *= left;
-		*bufferPtr++ *= right;
+	float * bufferPtr = buffer.empty() ? nullptr : &buffer[0];
+	std::size_t i = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+	Float4 volumes = lanes(left, right, left, right);
+	for(; i + 4 <= buffer.size(); i += 4){
+		store(bufferPtr + i, mul(load(bufferPtr + i), volumes));
+	}
+#endif
+	for(; i < buffer.size(); i += 2){
+		bufferPtr[i] *= left;
+		bufferPtr[i + 1] *= right;
 	}
 }
 
@@ -210,32 +486,8 @@ void ofSoundBuffer::copyTo(float * outBuffer, std::size_t nFrames, std::size_t o
 		nFramesToCopy = this->getNumFrames() - fromFrame;
 	}
 		
-	const float * buffPtr = &buffer[fromFrame * channels];
-	// if channels count matches we can just memcpy
-	if(channels == outChannels){
-		memcpy(outBuffer, buffPtr, nFramesToCopy * channels * sizeof(float));
-		outBuffer += nFramesToCopy * outChannels;
-	} else if(channels > outChannels){
-		// otherwise, if we have more channels than the output is requesting,
-		// we copy the first outChannels channels
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ = *buffPtr++;
-			}
-			// and skip the rest
-			buffPtr += channels - outChannels;
-		}
-	} else {
-		// we have fewer channels than output is requesting. so replicate as many channels as possible then loop.
-		// if we have 2 channels and output wants 5, data is copied from our channels in the following in order:
-		// 1 2 1 2 1
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ = buffPtr[(j%channels)];
-			}
-			buffPtr += channels;
-		}
-	}
+	remapFrames(outBuffer, outChannels, &buffer[fromFrame * channels], channels, nFramesToCopy, false);
+	outBuffer += nFramesToCopy * outChannels;
 
 	// do we have anything left?
 	int framesRemaining = nFrames - (int)nFramesToCopy;
@@ -259,34 +511,8 @@ void ofSoundBuffer::addTo(float * outBuffer, std::size_t nFrames, std::size_t ou
 		nFramesToCopy = this->getNumFrames() - fromFrame;
 	}
 
-	const float * buffPtr = &buffer[fromFrame * channels];
-	// if channels count matches it is easy
-	if(channels == outChannels){
-		for(std::size_t i = 0; i < (nFramesToCopy * outChannels); i++){
-			outBuffer[i] += buffPtr[i];
-		}
-		outBuffer += nFramesToCopy * outChannels;
-	} else if(channels > outChannels){
-		// otherwise, if we have more channels than the output is requesting,
-		// we copy the first outChannels channels
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ += *buffPtr++;
-			}
-			// and skip the rest
-			buffPtr += channels - outChannels;
-		}
-	} else {
-		// we have fewer channels than output is requesting. so replicate as many channels as possible then loop.
-		// if we have 2 channels and output wants 5, data is copied from our channels in the following in order:
-		// 1 2 1 2 1
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ += buffPtr[(j%channels)];
-			}
-			buffPtr += channels;
-		}
-	}
+	remapFrames(outBuffer, outChannels, &buffer[fromFrame * channels], channels, nFramesToCopy, true);
+	outBuffer += nFramesToCopy * outChannels;
 
 	// do we have anything left?
 	int framesRemaining = nFrames - (int)nFramesToCopy;
@@ -320,155 +546,348 @@ static bool prepareBufferForResampling(const ofSoundBuffer &in, ofSoundBuffer &o
 	return true;
 }
 
-// based on maximilian optimized for performance.
-// might lose 1 or 2 samples when it reaches the end of the buffer
+namespace{
+	// a tap of the resamplers outside of the buffer, wrapping around when
+	// looping or silence otherwise
+	inline float edgeSample(const vector<float> & buffer, std::ptrdiff_t frame, std::size_t channel, std::size_t channels, bool loop){
+		std::ptrdiff_t frames = buffer.size() / channels;
+		if(frame < 0 || frame >= frames){
+			if(!loop){
+				return 0;
+			}
+			frame %= frames;
+			if(frame < 0){
+				frame += frames;
+			}
+		}
+		return buffer[frame * channels + channel];
+	}
+
+	// walks the output samples of a run of frames, giving the input index of
+	// the first tap of each one and its fraction to the next
+	struct ResampleCursor{
+		ResampleCursor(double position, double speed, std::size_t channels)
+		:position(position)
+		,speed(speed)
+		,channels(channels)
+		,frame(0)
+		,channel(0){
+			seek();
+		}
+
+		std::size_t index() const{
+			return base + channel;
+		}
+
+		void next(){
+			if(++channel == channels){
+				channel = 0;
+				frame++;
+				seek();
+			}
+		}
+
+		void seek(){
+			double p = position + frame * speed;
+			std::size_t i = p;
+			base = i * channels;
+			fraction = p - i;
+		}
+
+		double position;
+		double speed;
+		std::size_t channels;
+		std::size_t frame;
+		std::size_t channel;
+		std::size_t base;
+		float fraction;
+	};
+
+	// calls interior with the runs of output frames where every tap, from
+	// tapsBefore frames before the position to tapsAfter after it, is inside
+	// the buffer so they can be processed without bounds checks, and edge
+	// with the rest one frame at a time
+	template<typename Interior, typename Edge>
+	void resampleRuns(std::size_t inFrames, std::size_t channels, double position, double speed, std::size_t numFrames, std::ptrdiff_t tapsBefore, std::ptrdiff_t tapsAfter, bool loop, float * out, Interior interior, Edge edge){
+		std::size_t i = 0;
+		while(i < numFrames){
+			std::ptrdiff_t index = std::ptrdiff_t(floor(position));
+			if(index - tapsBefore >= 0 && index + tapsAfter < std::ptrdiff_t(inFrames)){
+				std::size_t n = 1;
+				if(speed > 0){
+					double limit = double(inFrames) - tapsAfter;
+					n = std::min(numFrames - i, std::size_t(ceil((limit - position) / speed)));
+					while(n > 1 && position + (n - 1) * speed >= limit){
+						n--;
+					}
+					n = std::max(n, std::size_t(1));
+				}
+				interior(position, n, out);
+				position += n * speed;
+				out += n * channels;
+				i += n;
+			}else if(!loop && speed >= 0 && index - tapsBefore >= std::ptrdiff_t(inFrames)){
+				// past the end, nothing else to read
+				memset(out, 0, (numFrames - i) * channels * sizeof(float));
+				return;
+			}else{
+				edge(index, float(position - index), out);
+				position += speed;
+				out += channels;
+				i++;
+			}
+			if(loop && (position >= inFrames || position < 0)){
+				position = fmod(position, double(inFrames));
+				if(position < 0){
+					position += inFrames;
+				}
+			}
+		}
+	}
+
+	// band limited interpolation with a kaiser windowed sinc, the kernel is
+	// tabulated for fractions of a sample and interpolated between rows
+	struct SincTable{
+		static const std::size_t phases = 128;
+
+		void setup(std::size_t numTaps, float fc){
+			taps = numTaps;
+			cutoff = fc;
+			rows.resize((phases + 1) * taps);
+			const double beta = 8.6;
+			const double half = taps / 2;
+			for(std::size_t p = 0; p <= phases; p++){
+				float * row = &rows[p * taps];
+				double total = 0;
+				for(std::size_t k = 0; k < taps; k++){
+					double x = (double(k) - (half - 1)) - double(p) / phases;
+					double r = x / half;
+					double window = fabs(r) < 1 ? besselI0(beta * sqrt(1 - r * r)) / besselI0(beta) : 0;
+					double s = x == 0 ? 1 : sin(PI * cutoff * x) / (PI * cutoff * x);
+					row[k] = cutoff * s * window;
+					total += row[k];
+				}
+				// unity gain at every fraction, keeps dc from rippling
+				for(std::size_t k = 0; k < taps; k++){
+					row[k] /= total;
+				}
+			}
+		}
+
+		static double besselI0(double x){
+			double sum = 1, term = 1;
+			for(int k = 1; k < 32; k++){
+				term *= (x / (2 * k)) * (x / (2 * k));
+				sum += term;
+				if(term < 1e-12 * sum){
+					break;
+				}
+			}
+			return sum;
+		}
+
+		// coefficients for fraction, taps of them
+		void coefficients(float fraction, float * dst) const{
+			float p = fraction * phases;
+			std::size_t row = std::min(std::size_t(p), phases - 1);
+			float t = p - row;
+			const float * a = &rows[row * taps];
+			const float * b = a + taps;
+			std::size_t k = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+			Float4 vt = splat(t);
+			for(; k < taps; k += 4){
+				Float4 va = load(a + k);
+				store(dst + k, madd(sub(load(b + k), va), vt, va));
+			}
+#endif
+			for(; k < taps; k++){
+				dst[k] = a[k] + (b[k] - a[k]) * t;
+			}
+		}
+
+		std::size_t taps = 0;
+		float cutoff = 0;
+		std::vector<float> rows;
+	};
+
+	const std::size_t maxSincTaps = 128;
+}
+
 void ofSoundBuffer::linearResampleTo(ofSoundBuffer &outBuffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const {
-	
 	std::size_t inChannels = getNumChannels();
 	std::size_t inFrames = getNumFrames();
-	bool bufferReady = prepareBufferForResampling(*this, outBuffer, numFrames);
-	
-	if(!bufferReady) {
+	if(!prepareBufferForResampling(*this, outBuffer, numFrames)) {
 		outBuffer = *this;
 		return;
 	}
-	
-	std::size_t start = fromFrame;
-	std::size_t end = start*inChannels + double(numFrames*inChannels)*speed;
-	double position = start;
-	std::size_t intPosition = position;
-	float increment = speed;
-	std::size_t copySize = inChannels*sizeof(float);
-	std::size_t to;
-	
-	if(end<size()-2*inChannels){
-		to = numFrames;
-	}else if(fromFrame+2>inFrames){
-		to = 0;
-	}else{
-		to = ceil(float(inFrames-2-fromFrame)/speed);
+	if(inFrames == 0 || numFrames == 0){
+		return;
 	}
-	
-	float remainder = position - intPosition;
-	float * resBufferPtr = &outBuffer[0];
-	float a, b;
-	
-	for(std::size_t i=0;i<to;i++){
-		intPosition *= inChannels;
-		for(std::size_t j=0;j<inChannels;j++){
-			a = buffer[intPosition];
-			b = buffer[intPosition+inChannels];
-			*resBufferPtr++ = ofLerp(a,b,remainder);
-		}
-		position += increment;
-		intPosition = position;
-		remainder = position - intPosition;
-	}
-	if(end>=size()-2*inChannels){
-		to = numFrames-to;
-		if(loop){
-			intPosition %= inFrames;
-			for(std::size_t i=0;i<to;i++){
-				intPosition *= inChannels;
-				for(std::size_t j=0;j<inChannels;j++){
-					a = buffer[intPosition];
-					b = buffer[intPosition+inChannels];
-					*resBufferPtr++ = (b-a)*remainder+a;
-				}
-				resBufferPtr+=inChannels;
-				position += increment;
-				intPosition = position;
+
+	const float * in = &buffer[0];
+	auto interior = [&](double position, std::size_t n, float * out){
+		ResampleCursor cursor(position, speed, inChannels);
+		std::size_t total = n * inChannels;
+		std::size_t s = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+		// the taps are gathered 4 output samples at a time, whatever the
+		// number of channels, and interpolated together
+		for(; s + 4 <= total; s += 4){
+			float a[4], b[4], t[4];
+			for(int l = 0; l < 4; l++){
+				a[l] = in[cursor.index()];
+				b[l] = in[cursor.index() + inChannels];
+				t[l] = cursor.fraction;
+				cursor.next();
 			}
-		}else{
-			memset(resBufferPtr,0,to*copySize);
+			Float4 va = load(a);
+			store(out + s, madd(sub(load(b), va), load(t), va));
 		}
-	}
+#endif
+		for(; s < total; s++){
+			float a = in[cursor.index()];
+			float b = in[cursor.index() + inChannels];
+			out[s] = ofLerp(a, b, cursor.fraction);
+			cursor.next();
+		}
+	};
+	auto edge = [&](std::ptrdiff_t index, float fraction, float * out){
+		for(std::size_t j = 0; j < inChannels; j++){
+			float a = edgeSample(buffer, index, j, inChannels, loop);
+			float b = edgeSample(buffer, index + 1, j, inChannels, loop);
+			out[j] = ofLerp(a, b, fraction);
+		}
+	};
+	resampleRuns(inFrames, inChannels, fromFrame, speed, numFrames, 0, 1, loop, &outBuffer[0], interior, edge);
 }
 
-// based on maximilian optimized for performance.
-// might lose 1 to 3 samples when it reaches the end of the buffer
 void ofSoundBuffer::hermiteResampleTo(ofSoundBuffer &outBuffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const {
-	
 	std::size_t inChannels = getNumChannels();
 	std::size_t inFrames = getNumFrames();
-	bool bufferReady = prepareBufferForResampling(*this, outBuffer, numFrames);
-	
-	if(!bufferReady) {
+	if(!prepareBufferForResampling(*this, outBuffer, numFrames)) {
 		outBuffer = *this;
 		return;
 	}
-	
-	std::size_t start = fromFrame;
-	std::size_t end = start*inChannels + double(numFrames*inChannels)*speed;
-	double position = start;
-	std::size_t intPosition = position;
-	float remainder = position - intPosition;
-	float increment = speed;
-	std::size_t copySize = inChannels*sizeof(float);
-	std::size_t to;
-	
-	if(end<size()-3*inChannels){
-		to = numFrames;
-	}else if(fromFrame+3>inFrames){
-		to = 0;
-	}else{
-		to = double(inFrames-3-fromFrame)/speed;
+	if(inFrames == 0 || numFrames == 0){
+		return;
 	}
-	
-	float * resBufferPtr = &outBuffer[0];
-	float a,b,c,d;
-	std::size_t from = 0;
-	
-	while(intPosition==0){
-		intPosition *= inChannels;
-		for(std::size_t j=0;j<inChannels;++j){
-			a=loop?buffer[j]:0;
-			b=buffer[intPosition+j];
-			c=buffer[intPosition+j+inChannels];
-			d=buffer[intPosition+j+inChannels*2];
-			*resBufferPtr++ = ofInterpolateHermite(a, b, c, d, remainder);
-		}
-		position += increment;
-		intPosition = position;
-		remainder = position - intPosition;
-		from++;
+
+	const float * in = &buffer[0];
+	auto interior = [&](double position, std::size_t n, float * out){
+		ResampleCursor cursor(position, speed, inChannels);
+		std::size_t total = n * inChannels;
+		std::size_t s = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+		Float4 half = splat(0.5f);
+		for(; s + 4 <= total; s += 4){
+			float y0[4], y1[4], y2[4], y3[4], t[4];
+			for(int l = 0; l < 4; l++){
+				std::size_t i = cursor.index();
+				y0[l] = in[i - inChannels];
+				y1[l] = in[i];
+				y2[l] = in[i + inChannels];
+				y3[l] = in[i + inChannels * 2];
+				t[l] = cursor.fraction;
+				cursor.next();
+			}
+			// same as ofInterpolateHermite
+			Float4 v0 = load(y0), v1 = load(y1), v2 = load(y2), v3 = load(y3), vt = load(t);
+			Float4 c = mul(sub(v2, v0), half);
+			Float4 v = sub(v1, v2);
+			Float4 w = add(c, v);
+			Float4 a = madd(sub(v3, v1), half, add(w, v));
+			Float4 bNeg = add(w, a);
+			store(out + s, madd(madd(sub(mul(a, vt), bNeg), vt, c), vt, v1));
+		}
+#endif
+		for(; s < total; s++){
+			std::size_t i = cursor.index();
+			out[s] = ofInterpolateHermite(in[i - inChannels], in[i], in[i + inChannels], in[i + inChannels * 2], cursor.fraction);
+			cursor.next();
+		}
+	};
+	auto edge = [&](std::ptrdiff_t index, float fraction, float * out){
+		for(std::size_t j = 0; j < inChannels; j++){
+			float a = edgeSample(buffer, index - 1, j, inChannels, loop);
+			float b = edgeSample(buffer, index, j, inChannels, loop);
+			float c = edgeSample(buffer, index + 1, j, inChannels, loop);
+			float d = edgeSample(buffer, index + 2, j, inChannels, loop);
+			out[j] = ofInterpolateHermite(a, b, c, d, fraction);
+		}
+	};
+	resampleRuns(inFrames, inChannels, fromFrame, speed, numFrames, 1, 2, loop, &outBuffer[0], interior, edge);
+}
+
+void ofSoundBuffer::sincResampleTo(ofSoundBuffer &outBuffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const {
+	std::size_t inChannels = getNumChannels();
+	std::size_t inFrames = getNumFrames();
+	if(!prepareBufferForResampling(*this, outBuffer, numFrames)) {
+		outBuffer = *this;
+		return;
 	}
-	
-	for(std::size_t i=from;i<to;++i){
-		intPosition *= inChannels;
-		for(std::size_t j=0;j<inChannels;++j){
-			a=buffer[intPosition+j-inChannels];
-			b=buffer[intPosition+j];
-			c=buffer[intPosition+j+inChannels];
-			d=buffer[intPosition+j+inChannels*2];
-			*resBufferPtr++ = ofInterpolateHermite(a, b, c, d, remainder);
-		}
-		position += increment;
-		intPosition = position;
-		remainder = position - intPosition;
+	if(inFrames == 0 || numFrames == 0){
+		return;
 	}
-	
-	if(end>=size()-3*inChannels){
-		to = numFrames-to;
-		if(loop){
-			intPosition %= size();
-			for(std::size_t i=0;i<to;++i){
-				for(std::size_t j=0;j<inChannels;++j){
-					a=buffer[intPosition+j-inChannels];
-					b=buffer[intPosition+j];
-					c=buffer[intPosition+j+inChannels];
-					d=buffer[intPosition+j+inChannels*2];
-					*resBufferPtr++ = ofInterpolateHermite(a, b, c, d, remainder);
+
+	// when reading faster than the original rate the cutoff goes down with
+	// the speed so nothing above the new nyquist aliases, and the kernel
+	// gets longer to keep the same steepness. the speed is quantized so
+	// ramps don't rebuild the table every block
+	float stretch = std::max(1.f, ceilf(fabs(speed) * 16.f) / 16.f);
+	std::size_t taps = std::min(maxSincTaps, std::size_t(ceilf(16 * stretch / 4)) * 4);
+	float cutoff = 0.9f / stretch;
+	thread_local SincTable table;
+	if(table.taps != taps || table.cutoff != cutoff){
+		table.setup(taps, cutoff);
+	}
+
+	std::ptrdiff_t tapsBefore = taps / 2 - 1;
+	std::ptrdiff_t tapsAfter = taps / 2;
+	const float * in = &buffer[0];
+	float coefficients[maxSincTaps];
+	auto interior = [&](double position, std::size_t n, float * out){
+		for(std::size_t i = 0; i < n; i++){
+			double p = position + i * speed;
+			std::size_t index = p;
+			table.coefficients(p - index, coefficients);
+			const float * first = in + (index - tapsBefore) * inChannels;
+			for(std::size_t j = 0; j < inChannels; j++){
+				const float * src = first + j;
+				float acc = 0;
+				std::size_t k = 0;
+#ifdef OF_SOUND_BUFFER_SIMD
+				Float4 s = zero();
+				if(inChannels == 1){
+					for(; k < taps; k += 4){
+						s = madd(load(src + k), load(coefficients + k), s);
+					}
+				}else{
+					for(; k < taps; k += 4){
+						Float4 v = lanes(src[k * inChannels], src[(k + 1) * inChannels], src[(k + 2) * inChannels], src[(k + 3) * inChannels]);
+						s = madd(v, load(coefficients + k), s);
+					}
+				}
+				acc = sum(s);
+#endif
+				for(; k < taps; k++){
+					acc += src[k * inChannels] * coefficients[k];
 				}
-				position += increment;
-				intPosition = position;
-				remainder = position - intPosition;
-				intPosition *= inChannels;
+				*out++ = acc;
 			}
-		}else{
-			memset(resBufferPtr,0,to*copySize);
 		}
-	}
+	};
+	auto edge = [&](std::ptrdiff_t index, float fraction, float * out){
+		table.coefficients(fraction, coefficients);
+		for(std::size_t j = 0; j < inChannels; j++){
+			float acc = 0;
+			for(std::size_t k = 0; k < taps; k++){
+				acc += edgeSample(buffer, index - tapsBefore + k, j, inChannels, loop) * coefficients[k];
+			}
+			out[j] = acc;
+		}
+	};
+	resampleRuns(inFrames, inChannels, fromFrame, speed, numFrames, tapsBefore, tapsAfter, loop, &outBuffer[0], interior, edge);
 }
 
 void ofSoundBuffer::resampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop, InterpolationAlgorithm algorithm) const {
@@ -479,6 +898,9 @@ void ofSoundBuffer::resampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, st
 		case Hermite:
 			hermiteResampleTo(buffer, fromFrame, numFrames, speed, loop);
 			break;
+		case Sinc:
+			sincResampleTo(buffer, fromFrame, numFrames, speed, loop);
+			break;
 	}
 }
 
@@ -500,7 +922,7 @@ void ofSoundBuffer::getChannel(ofSoundBuffer & targetBuffer, std::size_t sourceC
 	targetBuffer.setNumChannels(1);
 	targetBuffer.setSampleRate(samplerate);
 	if(channels == 1){
-		copyTo(targetBuffer, getNumFrames(), 0, 0);
+		copyTo(targetBuffer, getNumFrames(), 1, 0);
 	}else{
 		// fetch samples from only one channel
 		targetBuffer.resize(getNumFrames());
@@ -527,11 +949,10 @@ void ofSoundBuffer::setChannel(const ofSoundBuffer & inBuffer, std::size_t targe
 }
 
 float ofSoundBuffer::getRMSAmplitude() const {
-	double acc = 0;
-	for(size_t i = 0; i < buffer.size(); i++){
-		acc += buffer[i] * buffer[i];
+	if(buffer.empty()){
+		return 0;
 	}
-	return sqrt(acc / (double)buffer.size());
+	return sqrt(sumOfSquares(&buffer[0], buffer.size()) / (double)buffer.size());
 }
 
 float ofSoundBuffer::getRMSAmplitudeChannel(std::size_t channel) const {
@@ -615,3 +1036,47 @@ namespace std{
 	}
 }
 
+template<typename T>
+void ofSoundBufferView_<T>::copyTo(const ofSoundBufferView & out) const{
+	size_t frames = std::min(numFrames, out.getNumFrames());
+	if(frames && out.getData() != samples){
+		remapFrames(out.getData(), out.getNumChannels(), samples, numChannels, frames, false);
+	}
+	std::fill(out.getData() + frames * out.getNumChannels(), out.end(), 0.f);
+}
+
+template<typename T>
+void ofSoundBufferView_<T>::addTo(const ofSoundBufferView & out) const{
+	size_t frames = std::min(numFrames, out.getNumFrames());
+	if(frames){
+		remapFrames(out.getData(), out.getNumChannels(), samples, numChannels, frames, true);
+	}
+}
+
+template<typename T>
+float ofSoundBufferView_<T>::getRMSAmplitude() const{
+	if(empty()){
+		return 0;
+	}
+	return sqrt(sumOfSquares(samples, size()) / (double)size());
+}
+
+template<typename T>
+void ofSoundBufferView_<T>::set(float value) const{
+	std::fill(begin(), end(), value);
+}
+
+template<typename T>
+void ofSoundBufferView_<T>::operator*=(float value) const{
+	scaleSamples(samples, size(), value);
+}
+
+// the read only views can't be modified, only their reading methods exist
+template void ofSoundBufferView_<float>::copyTo(const ofSoundBufferView &) const;
+template void ofSoundBufferView_<float>::addTo(const ofSoundBufferView &) const;
+template float ofSoundBufferView_<float>::getRMSAmplitude() const;
+template void ofSoundBufferView_<float>::set(float) const;
+template void ofSoundBufferView_<float>::operator*=(float) const;
+template void ofSoundBufferView_<const float>::copyTo(const ofSoundBufferView &) const;
+template void ofSoundBufferView_<const float>::addTo(const ofSoundBufferView &) const;
+template float ofSoundBufferView_<const float>::getRMSAmplitude() const;
@@ -9,7 +9,12 @@
 #define OFSOUNDBUFFER_H_
 
 #include "ofConstants.h"
+#include <algorithm>
+#include <type_traits>
 
+template<typename T> class ofSoundBufferView_;
+typedef ofSoundBufferView_<float> ofSoundBufferView;
+typedef ofSoundBufferView_<const float> ofConstSoundBufferView;
 
 /*! 
  
@@ -88,7 +93,8 @@ public:
 
 	enum InterpolationAlgorithm{
 		Linear,
-		Hermite
+		Hermite,
+		Sinc, //< band limited, slower but doesn't alias when changing the speed
 	};
 	static InterpolationAlgorithm defaultAlgorithm;  //defaults to Linear for mobile, Hermite for desktop
 
@@ -148,6 +154,13 @@ public:
 	
 	void copyFrom(const std::vector<float> & floatBuffer, std::size_t numChannels, unsigned int sampleRate);
 
+	/// copy the samples, channels and sample rate of view. doesn't allocate if the buffer already has the capacity.
+	void copyFrom(const ofConstSoundBufferView & view);
+
+	/// a view of the samples, to pass them around without copying.
+	ofSoundBufferView getView();
+	ofConstSoundBufferView getView() const;
+
 	void toShortPCM(std::vector<short> & dst) const;
 	void toShortPCM(short * dst) const;
 
@@ -188,6 +201,8 @@ public:
 	
 	void linearResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
 	void hermiteResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
+	/// windowed sinc interpolation, lowering the cutoff when speed is over 1 so the result doesn't alias
+	void sincResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
 	
 	/// fills the buffer with random noise between -amplitude and amplitude. useful for debugging.
 	void fillWithNoise(float amplitude = 1.0f);
@@ -205,6 +220,11 @@ public:
 	std::size_t size() const { return buffer.size(); }
 	/// resize this buffer to exactly this many samples. it's up to you make sure samples matches the channel count.
 	void resize(std::size_t numSamples, float val = float());
+	/// allocate memory for numFrames of numChannels without changing the size, so later resizes up to it don't allocate.
+	/// resizing, copyFrom, copyTo or getChannel into a buffer with enough capacity are safe in the audio thread.
+	void reserve(std::size_t numFrames, std::size_t numChannels);
+	/// the number of samples the buffer can hold without allocating
+	std::size_t capacity() const { return buffer.capacity(); }
 	/// remove all samples, preserving channel count and sample rate.
 	void clear();
 	/// swap the contents of this buffer with otherBuffer
@@ -219,7 +239,7 @@ public:
 protected:
 
 	// checks that size() and number of channels are consistent, logs a warning if not. returns consistency check result.
-	bool checkSizeAndChannelsConsistency(const std::string& function="" );
+	bool checkSizeAndChannelsConsistency(const char * function = "");
 
 	std::vector<float> buffer;
 	std::size_t channels;
@@ -229,6 +249,129 @@ protected:
 	int soundStreamDeviceID;
 };
 
+/// \brief Samples of one channel of an interleaved view, without copying them
+template<typename T>
+class ofSoundChannelView_{
+public:
+	ofSoundChannelView_()
+	:samples(nullptr)
+	,numFrames(0)
+	,stride(1){}
+
+	ofSoundChannelView_(T * samples, std::size_t numFrames, std::size_t stride)
+	:samples(samples)
+	,numFrames(numFrames)
+	,stride(stride){}
+
+	T & operator[](std::size_t frame) const { return samples[frame * stride]; }
+	std::size_t getNumFrames() const { return numFrames; }
+	/// distance between two samples of the channel, its number of channels
+	std::size_t getStride() const { return stride; }
+
+private:
+	T * samples;
+	std::size_t numFrames;
+	std::size_t stride;
+};
+
+/// \brief Interleaved samples of an ofSoundBuffer or any memory, without
+/// owning or copying them
+///
+/// A view is as cheap to pass and copy as a pointer and none of its methods
+/// allocate, so they can be used in audioIn() and audioOut() instead of
+/// creating buffers. It's only valid while the memory it points to is, a
+/// view of an ofSoundBuffer breaks if the buffer is resized.
+///
+/// ~~~~{.cpp}
+/// void ofApp::audioOut(ofSoundBuffer & buffer){
+///     // the second half of the buffer gets a delayed copy of the first
+///     auto out = buffer.getView();
+///     size_t half = out.getNumFrames() / 2;
+///     out.getFrames(0, half).copyTo(out.getFrames(half, half));
+/// }
+/// ~~~~
+///
+/// ofConstSoundBufferView is the read only version, a view converts to it.
+template<typename T>
+class ofSoundBufferView_{
+public:
+	typedef typename std::conditional<std::is_const<T>::value, const ofSoundBuffer, ofSoundBuffer>::type Buffer;
+
+	ofSoundBufferView_()
+	:samples(nullptr)
+	,numFrames(0)
+	,numChannels(1)
+	,sampleRate(44100){}
+
+	ofSoundBufferView_(T * samples, std::size_t numFrames, std::size_t numChannels, unsigned int sampleRate)
+	:samples(samples)
+	,numFrames(numFrames)
+	,numChannels(numChannels)
+	,sampleRate(sampleRate){}
+
+	ofSoundBufferView_(Buffer & buffer)
+	:samples(buffer.size() ? &buffer[0] : nullptr)
+	,numFrames(buffer.getNumFrames())
+	,numChannels(buffer.getNumChannels())
+	,sampleRate(buffer.getSampleRate()){}
+
+	template<typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	ofSoundBufferView_(const ofSoundBufferView_<U> & view)
+	:samples(view.getData())
+	,numFrames(view.getNumFrames())
+	,numChannels(view.getNumChannels())
+	,sampleRate(view.getSampleRate()){}
+
+	T & operator[](std::size_t samplePos) const { return samples[samplePos]; }
+	T & getSample(std::size_t frameIndex, std::size_t channel) const { return samples[frameIndex * numChannels + channel]; }
+
+	T * getData() const { return samples; }
+	T * begin() const { return samples; }
+	T * end() const { return samples + size(); }
+
+	std::size_t size() const { return numFrames * numChannels; }
+	bool empty() const { return numFrames == 0; }
+	std::size_t getNumFrames() const { return numFrames; }
+	std::size_t getNumChannels() const { return numChannels; }
+	unsigned int getSampleRate() const { return sampleRate; }
+
+	/// a view of numFrames starting at fromFrame, clamped to the frames of this one
+	ofSoundBufferView_ getFrames(std::size_t fromFrame, std::size_t count) const{
+		fromFrame = std::min(fromFrame, numFrames);
+		count = std::min(count, numFrames - fromFrame);
+		return ofSoundBufferView_(samples + fromFrame * numChannels, count, numChannels, sampleRate);
+	}
+
+	/// the samples of channel, strided over the interleaved frames
+	ofSoundChannelView_<T> getChannel(std::size_t channel) const{
+		return ofSoundChannelView_<T>(samples + std::min(channel, numChannels - 1), numFrames, numChannels);
+	}
+
+	/// copy as many frames as fit into out, remapping the channels like
+	/// ofSoundBuffer::copyTo, and fill any left in out with silence
+	void copyTo(const ofSoundBufferView & out) const;
+
+	/// as copyTo but adds the samples to the ones in out
+	void addTo(const ofSoundBufferView & out) const;
+
+	float getRMSAmplitude() const;
+
+	/// set every sample to value
+	void set(float value) const;
+
+	/// multiply every sample by value
+	void operator*=(float value) const;
+
+private:
+	T * samples;
+	std::size_t numFrames;
+	std::size_t numChannels;
+	unsigned int sampleRate;
+};
+
+typedef ofSoundChannelView_<float> ofSoundChannelView;
+typedef ofSoundChannelView_<const float> ofConstSoundChannelView;
+
 namespace std{
 	void swap(ofSoundBuffer & src, ofSoundBuffer & dst);
 }
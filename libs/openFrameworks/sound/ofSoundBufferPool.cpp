@@ -0,0 +1,88 @@
+#include "ofSoundBufferPool.h"
+#include "ofLog.h"
+
+using namespace std;
+
+//----------------------------------------------------------
+void ofSoundBufferPoolReleaser::operator()(ofSoundBuffer * buffer) const{
+	if(pool && buffer){
+		pool->release(buffer);
+	}
+}
+
+//----------------------------------------------------------
+ofSoundBufferPool::ofSoundBufferPool()
+:numFree(0)
+,maxFrames(0)
+,maxChannels(0)
+,sampleRate(44100){
+}
+
+//----------------------------------------------------------
+ofSoundBufferPool::~ofSoundBufferPool(){
+	if(numFree != buffers.size()){
+		ofLogError("ofSoundBufferPool") << "~ofSoundBufferPool(): destroyed with " << buffers.size() - numFree << " buffers still acquired";
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPool::setup(size_t numBuffers, size_t frames, size_t channels, unsigned int rate){
+	if(numFree != buffers.size()){
+		ofLogError("ofSoundBufferPool") << "setup(): can't setup while " << buffers.size() - numFree << " buffers are acquired";
+		return;
+	}
+	maxFrames = frames;
+	maxChannels = std::max<size_t>(channels, 1);
+	sampleRate = rate;
+	buffers.clear();
+	buffers.resize(numBuffers);
+	freeBuffers.reset(new ofThreadChannel<ofSoundBuffer*, ofThreadChannelMPSC>(std::max<size_t>(numBuffers, 1)));
+	for(auto & buffer: buffers){
+		buffer.reserve(maxFrames, maxChannels);
+		buffer.setSampleRate(sampleRate);
+		freeBuffers->send(&buffer);
+	}
+	numFree = numBuffers;
+}
+
+//----------------------------------------------------------
+ofSoundBufferPool::Buffer ofSoundBufferPool::acquire(size_t numFrames, size_t numChannels){
+	ofSoundBuffer * buffer = nullptr;
+	if(!freeBuffers || numChannels == 0 || numFrames * numChannels > maxFrames * maxChannels || !freeBuffers->tryReceive(buffer)){
+		return Buffer(nullptr, ofSoundBufferPoolReleaser{this});
+	}
+	numFree--;
+	// within the capacity nothing here allocates
+	buffer->clear();
+	buffer->setNumChannels(numChannels);
+	buffer->resize(numFrames * numChannels, 0);
+	buffer->setSampleRate(sampleRate);
+	buffer->setTickCount(0);
+	return Buffer(buffer, ofSoundBufferPoolReleaser{this});
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPool::release(ofSoundBuffer * buffer){
+	freeBuffers->send(buffer);
+	numFree++;
+}
+
+//----------------------------------------------------------
+size_t ofSoundBufferPool::getNumBuffers() const{
+	return buffers.size();
+}
+
+//----------------------------------------------------------
+size_t ofSoundBufferPool::getNumFree() const{
+	return numFree;
+}
+
+//----------------------------------------------------------
+size_t ofSoundBufferPool::getMaxFrames() const{
+	return maxFrames;
+}
+
+//----------------------------------------------------------
+size_t ofSoundBufferPool::getMaxChannels() const{
+	return maxChannels;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ofSoundBuffer.h"
+#include "ofThreadChannel.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class ofSoundBufferPool;
+
+/// \brief Returns a buffer to the pool it was acquired from when its
+/// ofSoundBufferPool::Buffer goes out of scope
+struct ofSoundBufferPoolReleaser{
+	ofSoundBufferPool * pool = nullptr;
+	void operator()(ofSoundBuffer * buffer) const;
+};
+
+/// \brief Buffers allocated up front to be used as scratch memory in the
+/// audio thread
+///
+/// Copying an ofSoundBuffer, operator*, append or getChannel into an empty
+/// buffer allocate, which in audioIn() or audioOut() can make the stream
+/// glitch. A pool allocates a fixed number of buffers with the capacity for
+/// the largest block in setup(), acquire() hands one resized to the frames
+/// needed without allocating and it goes back to the pool when released:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     pool.setup(4, settings.bufferSize, 2);
+/// }
+///
+/// void ofApp::audioOut(ofSoundBuffer & buffer){
+///     auto left = pool.acquire(buffer.getNumFrames(), 1);
+///     if(left){
+///         buffer.getChannel(*left, 0);
+///         ...
+///     }
+/// }
+/// ~~~~
+///
+/// Buffers are acquired from one thread, usually the audio one, and can be
+/// released from any other, the free list is lock-free. Resizing an
+/// acquired buffer past the pool's capacity allocates.
+class ofSoundBufferPool{
+public:
+	typedef std::unique_ptr<ofSoundBuffer, ofSoundBufferPoolReleaser> Buffer;
+
+	ofSoundBufferPool();
+	~ofSoundBufferPool();
+
+	ofSoundBufferPool(const ofSoundBufferPool &) = delete;
+	ofSoundBufferPool & operator=(const ofSoundBufferPool &) = delete;
+
+	/// \brief Allocates numBuffers of up to maxFrames of maxChannels, from
+	/// the main thread while none is acquired
+	void setup(std::size_t numBuffers, std::size_t maxFrames, std::size_t maxChannels, unsigned int sampleRate = 44100);
+
+	/// \brief A free buffer of numFrames of numChannels filled with silence
+	/// \returns nullptr if they are all in use or it doesn't fit
+	Buffer acquire(std::size_t numFrames, std::size_t numChannels);
+
+	std::size_t getNumBuffers() const;
+	std::size_t getNumFree() const;
+	std::size_t getMaxFrames() const;
+	std::size_t getMaxChannels() const;
+
+private:
+	friend struct ofSoundBufferPoolReleaser;
+	void release(ofSoundBuffer * buffer);
+
+	std::vector<ofSoundBuffer> buffers;
+	std::unique_ptr<ofThreadChannel<ofSoundBuffer*, ofThreadChannelMPSC>> freeBuffers;
+	std::atomic<std::size_t> numFree;
+	std::size_t maxFrames;
+	std::size_t maxChannels;
+	unsigned int sampleRate;
+};
@@ -0,0 +1,691 @@
+#include "ofSoundGraph.h"
+#include "ofSoundStream.h"
+#include "ofSoundAnalyzer.h"
+#include "ofMath.h"
+#include "ofLog.h"
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define OF_SOUND_GRAPH_FLUSH_DENORMALS
+#endif
+
+using namespace std;
+
+namespace{
+	enum NodeCommand{
+		Connect = -1,
+		Disconnect = -2,
+	};
+
+	// multiplies the block by a gain going linearly from one value to the
+	// other, so gain changes don't click
+	void applyGain(ofSoundBuffer & buffer, float from, float to){
+		auto & samples = buffer.getBuffer();
+		size_t numChannels = buffer.getNumChannels();
+		size_t numFrames = buffer.getNumFrames();
+		if(from == to){
+			if(to != 1){
+				for(auto & sample: samples){
+					sample *= to;
+				}
+			}
+			return;
+		}
+		float step = (to - from) / numFrames;
+		float gain = from;
+		for(size_t i = 0; i < numFrames; i++){
+			for(size_t c = 0; c < numChannels; c++){
+				samples[i * numChannels + c] *= gain;
+			}
+			gain += step;
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofSoundParameter::ofSoundParameter(float value)
+:target(value)
+,current(value){
+}
+
+//----------------------------------------------------------
+void ofSoundParameter::set(float value){
+	target.store(value, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------
+float ofSoundParameter::get() const{
+	return target.load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------
+bool ofSoundParameter::update(float & from, float & to){
+	from = current;
+	to = current = target.load(std::memory_order_relaxed);
+	return from != to;
+}
+
+//----------------------------------------------------------
+ofSoundNode::ofSoundNode()
+:commands(256)
+,lastBlock(std::numeric_limits<uint64_t>::max())
+,processing(false)
+,bSetup(false){
+	// connecting in the audio thread never allocates
+	inputs.reserve(maxInputs);
+}
+
+//----------------------------------------------------------
+ofSoundNode & ofSoundNode::connectTo(ofSoundNode & destination){
+	if(&destination == this){
+		ofLogError("ofSoundNode") << "connectTo(): can't connect a node to itself";
+		return destination;
+	}
+	auto & connected = destination.connectedInputs;
+	if(find(connected.begin(), connected.end(), this) != connected.end()){
+		return destination;
+	}
+	if(connected.size() >= maxInputs){
+		ofLogError("ofSoundNode") << "connectTo(): destination already has " << maxInputs << " inputs";
+		return destination;
+	}
+	if(destination.isSetup()){
+		setup(destination.getNumFrames(), destination.getNumChannels(), destination.getSampleRate());
+	}
+	if(!destination.post(Connect, 0, this)){
+		ofLogError("ofSoundNode") << "connectTo(): destination's command queue is full";
+		return destination;
+	}
+	connected.push_back(this);
+	return destination;
+}
+
+//----------------------------------------------------------
+void ofSoundNode::disconnectFrom(ofSoundNode & destination){
+	auto & connected = destination.connectedInputs;
+	auto it = find(connected.begin(), connected.end(), this);
+	if(it == connected.end()){
+		return;
+	}
+	if(!destination.post(Disconnect, 0, this)){
+		ofLogError("ofSoundNode") << "disconnectFrom(): destination's command queue is full";
+		return;
+	}
+	connected.erase(it);
+}
+
+//----------------------------------------------------------
+void ofSoundNode::setup(size_t numFrames, size_t numChannels, unsigned int sampleRate){
+	if(bSetup && getNumFrames() == numFrames && getNumChannels() == numChannels && getSampleRate() == sampleRate){
+		return;
+	}
+	output.setNumChannels(numChannels);
+	output.resize(numFrames * numChannels, 0);
+	output.setSampleRate(sampleRate);
+	prepare();
+	// before the inputs, a cycle stops here
+	bSetup = true;
+	for(auto input: connectedInputs){
+		input->setup(numFrames, numChannels, sampleRate);
+	}
+}
+
+//----------------------------------------------------------
+bool ofSoundNode::isSetup() const{
+	return bSetup;
+}
+
+//----------------------------------------------------------
+const ofSoundBuffer & ofSoundNode::pull(uint64_t block){
+	if(block != lastBlock && !processing){
+		processing = true;
+		processCommands();
+		process(output, block);
+		lastBlock = block;
+		processing = false;
+	}
+	return output;
+}
+
+//----------------------------------------------------------
+size_t ofSoundNode::getNumFrames() const{
+	return output.getNumFrames();
+}
+
+//----------------------------------------------------------
+size_t ofSoundNode::getNumChannels() const{
+	return output.getNumChannels();
+}
+
+//----------------------------------------------------------
+unsigned int ofSoundNode::getSampleRate() const{
+	return output.getSampleRate();
+}
+
+//----------------------------------------------------------
+bool ofSoundNode::post(int command, float value, void * pointer, uint64_t id){
+	return commands.send({command, value, pointer, id});
+}
+
+//----------------------------------------------------------
+size_t ofSoundNode::getNumInputs() const{
+	return inputs.size();
+}
+
+//----------------------------------------------------------
+const ofSoundBuffer & ofSoundNode::pullInput(size_t input, uint64_t block){
+	return inputs[input]->pull(block);
+}
+
+//----------------------------------------------------------
+void ofSoundNode::mixInputs(ofSoundBuffer & out, uint64_t block){
+	auto & samples = out.getBuffer();
+	if(inputs.empty()){
+		std::fill(samples.begin(), samples.end(), 0.f);
+		return;
+	}
+	// the first input is copied instead of added to silence
+	auto & first = inputs[0]->pull(block).getBuffer();
+	std::copy(first.begin(), first.begin() + std::min(first.size(), samples.size()), samples.begin());
+	for(size_t i = 1; i < inputs.size(); i++){
+		auto & in = inputs[i]->pull(block).getBuffer();
+		size_t size = std::min(in.size(), samples.size());
+		for(size_t j = 0; j < size; j++){
+			samples[j] += in[j];
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundNode::processCommands(){
+	Command command;
+	while(commands.tryReceive(command)){
+		switch(command.type){
+		case Connect:
+			// the main thread checks there's space, the capacity is reserved
+			if(inputs.size() < inputs.capacity()){
+				inputs.push_back((ofSoundNode*)command.pointer);
+			}
+			break;
+		case Disconnect:
+			inputs.erase(std::remove(inputs.begin(), inputs.end(), (ofSoundNode*)command.pointer), inputs.end());
+			break;
+		default:
+			receive(command.type, command.value, command.pointer, command.id);
+			break;
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundMixer::process(ofSoundBuffer & output, uint64_t block){
+	mixInputs(output, block);
+	float from, to;
+	gain.update(from, to);
+	applyGain(output, from, to);
+}
+
+//----------------------------------------------------------
+void ofSoundGain::process(ofSoundBuffer & output, uint64_t block){
+	mixInputs(output, block);
+	float gainFrom, gainTo, panFrom, panTo;
+	gain.update(gainFrom, gainTo);
+	pan.update(panFrom, panTo);
+	if(output.getNumChannels() != 2){
+		applyGain(output, gainFrom, gainTo);
+		return;
+	}
+
+	auto & samples = output.getBuffer();
+	size_t numFrames = output.getNumFrames();
+	float gainStep = (gainTo - gainFrom) / numFrames;
+	float panStep = (panTo - panFrom) / numFrames;
+	float g = gainFrom;
+	float p = panFrom;
+	for(size_t i = 0; i < numFrames; i++){
+		// equal power, both channels at -3dB when centered
+		float angle = (ofClamp(p, -1, 1) + 1) * float(PI) * 0.25f;
+		samples[i * 2] *= g * cos(angle);
+		samples[i * 2 + 1] *= g * sin(angle);
+		g += gainStep;
+		p += panStep;
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundOscillator::setWaveform(Waveform waveform){
+	post(0, waveform);
+}
+
+//----------------------------------------------------------
+void ofSoundOscillator::receive(int, float value, void *, uint64_t){
+	waveform = Waveform(int(value));
+}
+
+//----------------------------------------------------------
+void ofSoundOscillator::process(ofSoundBuffer & output, uint64_t){
+	float frequencyFrom, frequencyTo, amplitudeFrom, amplitudeTo;
+	frequency.update(frequencyFrom, frequencyTo);
+	amplitude.update(amplitudeFrom, amplitudeTo);
+
+	auto & samples = output.getBuffer();
+	size_t numChannels = output.getNumChannels();
+	size_t numFrames = output.getNumFrames();
+	double sampleRate = output.getSampleRate();
+	double increment = frequencyFrom / sampleRate;
+	double incrementStep = (frequencyTo - frequencyFrom) / sampleRate / numFrames;
+	float a = amplitudeFrom;
+	float amplitudeStep = (amplitudeTo - amplitudeFrom) / numFrames;
+	for(size_t i = 0; i < numFrames; i++){
+		float value;
+		switch(waveform){
+		case SAW:
+			value = float(phase * 2 - 1);
+			break;
+		case SQUARE:
+			value = phase < 0.5 ? 1.f : -1.f;
+			break;
+		case TRIANGLE:
+			value = float(phase < 0.5 ? phase * 4 - 1 : 3 - phase * 4);
+			break;
+		case NOISE:
+			// xorshift, rand() can lock
+			noiseState ^= noiseState << 13;
+			noiseState ^= noiseState >> 17;
+			noiseState ^= noiseState << 5;
+			value = noiseState / float(std::numeric_limits<uint32_t>::max()) * 2 - 1;
+			break;
+		case SINE:
+		default:
+			value = float(sin(phase * TWO_PI));
+			break;
+		}
+		value *= a;
+		for(size_t c = 0; c < numChannels; c++){
+			samples[i * numChannels + c] = value;
+		}
+		phase += increment;
+		phase -= floor(phase);
+		increment += incrementStep;
+		a += amplitudeStep;
+	}
+}
+
+//----------------------------------------------------------
+namespace{
+	enum PlayerCommand{
+		PlayerLoad,
+		PlayerPlay,
+		PlayerStop,
+		PlayerLoop,
+		PlayerPosition,
+	};
+}
+
+//----------------------------------------------------------
+ofSoundBufferPlayer::ofSoundBufferPlayer()
+:nextId(1)
+,buffer(nullptr)
+,playhead(0)
+,playing(false)
+,loop(false)
+,currentId(0)
+,playingState(false)
+,positionState(0){
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPlayer::load(shared_ptr<const ofSoundBuffer> newBuffer){
+	// release the buffers replaced before the one the audio thread uses
+	auto id = currentId.load();
+	while(!loaded.empty() && loaded.front().first < id){
+		loaded.pop_front();
+	}
+	if(!post(PlayerLoad, 0, const_cast<ofSoundBuffer*>(newBuffer.get()), nextId)){
+		ofLogError("ofSoundBufferPlayer") << "load(): command queue is full";
+		return;
+	}
+	loaded.emplace_back(nextId++, newBuffer);
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPlayer::play(){
+	post(PlayerPlay);
+	playingState = true;
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPlayer::stop(){
+	post(PlayerStop);
+	playingState = false;
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPlayer::setLoop(bool loop){
+	post(PlayerLoop, loop);
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPlayer::setPosition(float position){
+	post(PlayerPosition, ofClamp(position, 0, 1));
+}
+
+//----------------------------------------------------------
+bool ofSoundBufferPlayer::isPlaying() const{
+	return playingState;
+}
+
+//----------------------------------------------------------
+float ofSoundBufferPlayer::getPosition() const{
+	return positionState;
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPlayer::receive(int command, float value, void * pointer, uint64_t id){
+	switch(command){
+	case PlayerLoad:
+		buffer = (const ofSoundBuffer*)pointer;
+		playhead = 0;
+		currentId = id;
+		break;
+	case PlayerPlay:
+		playing = true;
+		break;
+	case PlayerStop:
+		playing = false;
+		break;
+	case PlayerLoop:
+		loop = value != 0;
+		break;
+	case PlayerPosition:
+		if(buffer){
+			playhead = value * buffer->getNumFrames();
+		}
+		break;
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundBufferPlayer::process(ofSoundBuffer & output, uint64_t){
+	auto & samples = output.getBuffer();
+	std::fill(samples.begin(), samples.end(), 0.f);
+	float volumeFrom, volumeTo, speedFrom, speedTo;
+	volume.update(volumeFrom, volumeTo);
+	speed.update(speedFrom, speedTo);
+	if(!playing || !buffer || buffer->getNumFrames() == 0){
+		playingState = playing && buffer;
+		return;
+	}
+
+	auto & source = buffer->getBuffer();
+	size_t sourceChannels = buffer->getNumChannels();
+	double sourceFrames = buffer->getNumFrames();
+	size_t numChannels = output.getNumChannels();
+	size_t numFrames = output.getNumFrames();
+	double rate = double(buffer->getSampleRate()) / output.getSampleRate();
+	double increment = speedFrom * rate;
+	double incrementStep = (speedTo - speedFrom) * rate / numFrames;
+	float v = volumeFrom;
+	float volumeStep = (volumeTo - volumeFrom) / numFrames;
+
+	for(size_t i = 0; i < numFrames; i++){
+		if(playhead >= sourceFrames || playhead < 0){
+			if(!loop){
+				playing = false;
+				playhead = increment < 0 ? sourceFrames - 1 : 0;
+				break;
+			}
+			playhead = fmod(playhead, sourceFrames);
+			if(playhead < 0){
+				playhead += sourceFrames;
+			}
+		}
+		size_t frame = size_t(playhead);
+		size_t next = frame + 1;
+		if(next >= size_t(sourceFrames)){
+			next = loop ? 0 : frame;
+		}
+		float t = float(playhead - frame);
+		for(size_t c = 0; c < numChannels; c++){
+			size_t sourceChannel = c % sourceChannels;
+			float a = source[frame * sourceChannels + sourceChannel];
+			float b = source[next * sourceChannels + sourceChannel];
+			samples[i * numChannels + c] = (a + (b - a) * t) * v;
+		}
+		playhead += increment;
+		increment += incrementStep;
+		v += volumeStep;
+	}
+	playingState = playing;
+	positionState = float(playhead / sourceFrames);
+}
+
+//----------------------------------------------------------
+void ofSoundFilter::setType(Type type){
+	post(0, type);
+}
+
+//----------------------------------------------------------
+void ofSoundFilter::receive(int, float value, void *, uint64_t){
+	type = Type(int(value));
+	dirty = true;
+}
+
+//----------------------------------------------------------
+void ofSoundFilter::prepare(){
+	z1.assign(getNumChannels(), 0);
+	z2.assign(getNumChannels(), 0);
+	dirty = true;
+}
+
+//----------------------------------------------------------
+void ofSoundFilter::updateCoefficients(float frequency, float resonance){
+	// from the audio eq cookbook by Robert Bristow-Johnson
+	double w0 = TWO_PI * ofClamp(frequency, 10, getSampleRate() * 0.49f) / getSampleRate();
+	double alpha = sin(w0) / (2 * std::max(resonance, 0.01f));
+	double cosw0 = cos(w0);
+	double a0 = 1 + alpha;
+	double nb0, nb1, nb2;
+	switch(type){
+	case HIGH_PASS:
+		nb0 = (1 + cosw0) / 2;
+		nb1 = -(1 + cosw0);
+		nb2 = (1 + cosw0) / 2;
+		break;
+	case BAND_PASS:
+		nb0 = alpha;
+		nb1 = 0;
+		nb2 = -alpha;
+		break;
+	case NOTCH:
+		nb0 = 1;
+		nb1 = -2 * cosw0;
+		nb2 = 1;
+		break;
+	case LOW_PASS:
+	default:
+		nb0 = (1 - cosw0) / 2;
+		nb1 = 1 - cosw0;
+		nb2 = (1 - cosw0) / 2;
+		break;
+	}
+	b0 = nb0 / a0;
+	b1 = nb1 / a0;
+	b2 = nb2 / a0;
+	a1 = -2 * cosw0 / a0;
+	a2 = (1 - alpha) / a0;
+}
+
+//----------------------------------------------------------
+void ofSoundFilter::process(ofSoundBuffer & output, uint64_t block){
+	mixInputs(output, block);
+	float cutoffFrom, cutoffTo, qFrom, qTo;
+	bool changed = cutoff.update(cutoffFrom, cutoffTo);
+	changed |= q.update(qFrom, qTo);
+	if(changed || dirty){
+		updateCoefficients(cutoffTo, qTo);
+		dirty = false;
+	}
+
+	auto & samples = output.getBuffer();
+	size_t numChannels = output.getNumChannels();
+	size_t numFrames = output.getNumFrames();
+	for(size_t c = 0; c < numChannels; c++){
+		// transposed direct form II
+		float s1 = z1[c];
+		float s2 = z2[c];
+		for(size_t i = 0; i < numFrames; i++){
+			float & sample = samples[i * numChannels + c];
+			float in = sample;
+			sample = b0 * in + s1;
+			s1 = b1 * in - a1 * sample + s2;
+			s2 = b2 * in - a2 * sample;
+		}
+		z1[c] = s1;
+		z2[c] = s2;
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundMeter::prepare(){
+	numChannels = getNumChannels();
+	rms.reset(new std::atomic<float>[numChannels]);
+	peaks.reset(new std::atomic<float>[numChannels]);
+	for(size_t c = 0; c < numChannels; c++){
+		rms[c] = 0;
+		peaks[c] = 0;
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundMeter::setAnalyzer(ofSoundAnalyzer * analyzer){
+	post(0, 0, analyzer);
+}
+
+//----------------------------------------------------------
+void ofSoundMeter::receive(int, float, void * pointer, uint64_t){
+	analyzer = static_cast<ofSoundAnalyzer*>(pointer);
+}
+
+//----------------------------------------------------------
+void ofSoundMeter::process(ofSoundBuffer & output, uint64_t block){
+	mixInputs(output, block);
+	if(analyzer){
+		analyzer->process(output);
+	}
+	auto & samples = output.getBuffer();
+	size_t numFrames = output.getNumFrames();
+	for(size_t c = 0; c < numChannels; c++){
+		float sum = 0;
+		float peak = 0;
+		for(size_t i = 0; i < numFrames; i++){
+			float sample = samples[i * numChannels + c];
+			sum += sample * sample;
+			peak = std::max(peak, std::abs(sample));
+		}
+		rms[c].store(sqrt(sum / numFrames), std::memory_order_relaxed);
+		peaks[c].store(peak, std::memory_order_relaxed);
+	}
+}
+
+//----------------------------------------------------------
+float ofSoundMeter::getRMS(size_t channel) const{
+	return channel < numChannels ? rms[channel].load(std::memory_order_relaxed) : 0;
+}
+
+//----------------------------------------------------------
+float ofSoundMeter::getPeak(size_t channel) const{
+	return channel < numChannels ? peaks[channel].load(std::memory_order_relaxed) : 0;
+}
+
+//----------------------------------------------------------
+float ofSoundMeter::getRMS() const{
+	if(numChannels == 0){
+		return 0;
+	}
+	float sum = 0;
+	for(size_t c = 0; c < numChannels; c++){
+		float value = rms[c].load(std::memory_order_relaxed);
+		sum += value * value;
+	}
+	return sqrt(sum / numChannels);
+}
+
+//----------------------------------------------------------
+ofSoundGraph::ofSoundGraph()
+:block(nullptr)
+,blockFrame(0)
+,numBlocks(0)
+,load(0){
+}
+
+//----------------------------------------------------------
+void ofSoundGraph::setup(const ofSoundStreamSettings & settings){
+	setup(settings.bufferSize, settings.numOutputChannels, settings.sampleRate);
+}
+
+//----------------------------------------------------------
+void ofSoundGraph::setup(size_t numFrames, size_t numChannels, unsigned int sampleRate){
+	if(numFrames == 0 || numChannels == 0 || sampleRate == 0){
+		ofLogError("ofSoundGraph") << "setup(): buffer size, channels and sample rate have to be > 0";
+		return;
+	}
+	output.setup(numFrames, numChannels, sampleRate);
+	block = nullptr;
+	blockFrame = 0;
+}
+
+//----------------------------------------------------------
+ofSoundMixer & ofSoundGraph::getOutput(){
+	return output;
+}
+
+//----------------------------------------------------------
+void ofSoundGraph::audioOut(ofSoundBuffer & buffer){
+#ifdef OF_SOUND_GRAPH_FLUSH_DENORMALS
+	// decaying filters and reverbs produce denormals, which are very slow
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+	if(!output.isSetup()){
+		buffer.set(0);
+		return;
+	}
+	auto start = chrono::steady_clock::now();
+
+	auto & samples = buffer.getBuffer();
+	size_t numFrames = buffer.getNumFrames();
+	size_t numChannels = buffer.getNumChannels();
+	size_t blockFrames = output.getNumFrames();
+	size_t blockChannels = output.getNumChannels();
+	size_t written = 0;
+	while(written < numFrames){
+		if(block == nullptr || blockFrame == blockFrames){
+			block = &output.pull(numBlocks++);
+			blockFrame = 0;
+		}
+		auto & blockSamples = block->getBuffer();
+		size_t count = std::min(numFrames - written, blockFrames - blockFrame);
+		for(size_t i = 0; i < count; i++){
+			for(size_t c = 0; c < numChannels; c++){
+				samples[(written + i) * numChannels + c] = c < blockChannels ? blockSamples[(blockFrame + i) * blockChannels + c] : 0;
+			}
+		}
+		written += count;
+		blockFrame += count;
+	}
+
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	load.store(float(elapsed * output.getSampleRate() / std::max<size_t>(numFrames, 1)), std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundGraph::getNumBlocks() const{
+	return numBlocks;
+}
+
+//----------------------------------------------------------
+float ofSoundGraph::getLoad() const{
+	return load.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,353 @@
+#pragma once
+
+#include "ofSoundBuffer.h"
+#include "ofBaseTypes.h"
+#include "ofThreadChannel.h"
+#include <atomic>
+#include <memory>
+#include <deque>
+
+class ofSoundStreamSettings;
+class ofSoundAnalyzer;
+
+/// \brief A value set from any thread and read by a node in the audio
+/// thread, ramped over a block so changes don't click
+///
+/// The value is a lock-free atomic, when it's set several times between
+/// two blocks only the last one is used.
+class ofSoundParameter{
+public:
+	ofSoundParameter(float value = 0);
+
+	/// \brief Sets the value reached by the end of the next block, from any
+	/// thread
+	void set(float value);
+
+	/// \brief The last value set
+	float get() const;
+
+	/// \brief From the audio thread, once per block: from is the value at
+	/// the start of the block and to the value to ramp to by its end
+	/// \returns true if the value changed
+	bool update(float & from, float & to);
+
+private:
+	std::atomic<float> target;
+	float current;
+};
+
+/// \brief A node of an ofSoundGraph, processes one block of audio at a time
+/// pulling it from its inputs
+///
+/// Nodes are connected from the main thread, even while the stream is
+/// running, with connectTo(). All the buffers are allocated by setup(),
+/// which the graph calls on every node connected to it, so process() runs
+/// in the audio thread without allocating or locking. Changes that aren't
+/// a continuous parameter, like starting a player, are posted through a
+/// lock-free queue and handled by receive() before the next block.
+///
+/// When a node is the input of several others it's processed once per
+/// block and its output is shared. Nodes have to outlive the stream, or
+/// be disconnected and the stream stopped before they are destroyed.
+///
+/// To write a new node, inherit from ofSoundNode and implement process()
+/// without calling anything that can allocate, lock or log:
+///
+/// ~~~~{.cpp}
+/// class Distortion: public ofSoundNode{
+/// public:
+///     ofSoundParameter drive{1};
+///
+/// protected:
+///     void process(ofSoundBuffer & output, uint64_t block){
+///         mixInputs(output, block);
+///         float from, to;
+///         drive.update(from, to);
+///         for(auto & sample: output.getBuffer()){
+///             sample = tanh(sample * to);
+///         }
+///     }
+/// };
+/// ~~~~
+class ofSoundNode{
+public:
+	/// \brief Inputs a node can have, their list is reserved up front
+	static const std::size_t maxInputs = 64;
+
+	ofSoundNode();
+	virtual ~ofSoundNode(){}
+
+	ofSoundNode(const ofSoundNode &) = delete;
+	ofSoundNode & operator=(const ofSoundNode &) = delete;
+
+	/// \brief Makes this node an input of destination, from the main thread
+	/// \returns destination, so connections can be chained
+	ofSoundNode & connectTo(ofSoundNode & destination);
+
+	/// \brief Removes this node from the inputs of destination
+	void disconnectFrom(ofSoundNode & destination);
+
+	/// \brief Allocates the buffers of this node and its inputs for blocks of
+	/// numFrames
+	///
+	/// Done by ofSoundGraph::setup() and when connecting to a node that is
+	/// already set up, changing the format of a running node is not safe.
+	void setup(std::size_t numFrames, std::size_t numChannels, unsigned int sampleRate);
+	bool isSetup() const;
+
+	/// \brief The output of this node for block, processing it the first
+	/// time it's requested, from the audio thread
+	///
+	/// A node that pulls itself through a cycle gets its previous block.
+	const ofSoundBuffer & pull(uint64_t block);
+
+	std::size_t getNumFrames() const;
+	std::size_t getNumChannels() const;
+	unsigned int getSampleRate() const;
+
+protected:
+	/// \brief Called by setup() to allocate whatever process() needs, after
+	/// the format is known
+	virtual void prepare(){}
+
+	/// \brief Fills output, already allocated, with this node's block
+	virtual void process(ofSoundBuffer & output, uint64_t block) = 0;
+
+	/// \brief Handles the commands sent with post(), in the audio thread
+	/// before processing
+	virtual void receive(int command, float value, void * pointer, uint64_t id){}
+
+	/// \brief Queues a command for receive(), from any thread
+	/// \returns false if the queue is full
+	bool post(int command, float value = 0, void * pointer = nullptr, uint64_t id = 0);
+
+	/// \brief Number of inputs, from the audio thread
+	std::size_t getNumInputs() const;
+
+	/// \brief Pulls the block of input, from process()
+	const ofSoundBuffer & pullInput(std::size_t input, uint64_t block);
+
+	/// \brief Sums the block of every input into output, silence if there
+	/// are none
+	void mixInputs(ofSoundBuffer & output, uint64_t block);
+
+private:
+	struct Command{
+		int type;
+		float value;
+		void * pointer;
+		uint64_t id;
+	};
+
+	void processCommands();
+
+	ofThreadChannel<Command, ofThreadChannelMPSC> commands;
+	std::vector<ofSoundNode*> inputs;
+	std::vector<ofSoundNode*> connectedInputs;
+	ofSoundBuffer output;
+	uint64_t lastBlock;
+	bool processing;
+	bool bSetup;
+};
+
+/// \brief Sums its inputs with a master gain
+class ofSoundMixer: public ofSoundNode{
+public:
+	ofSoundParameter gain{1};
+
+protected:
+	void process(ofSoundBuffer & output, uint64_t block) override;
+};
+
+/// \brief Applies a gain and, to stereo inputs, an equal power pan
+class ofSoundGain: public ofSoundNode{
+public:
+	ofSoundParameter gain{1};
+	ofSoundParameter pan{0}; //< -1 left to 1 right
+
+protected:
+	void process(ofSoundBuffer & output, uint64_t block) override;
+};
+
+/// \brief Generates a waveform on every channel
+class ofSoundOscillator: public ofSoundNode{
+public:
+	enum Waveform{
+		SINE,
+		SAW,
+		SQUARE,
+		TRIANGLE,
+		NOISE,
+	};
+
+	ofSoundParameter frequency{440};
+	ofSoundParameter amplitude{0.5};
+
+	void setWaveform(Waveform waveform);
+
+protected:
+	void process(ofSoundBuffer & output, uint64_t block) override;
+	void receive(int command, float value, void * pointer, uint64_t id) override;
+
+private:
+	Waveform waveform = SINE;
+	double phase = 0;
+	uint32_t noiseState = 22222;
+};
+
+/// \brief Plays an ofSoundBuffer loaded in memory, resampling it to the
+/// graph's sample rate
+///
+/// The buffer is shared with the audio thread, it can't be modified while
+/// loaded. A replaced buffer is released from the main thread once the
+/// audio thread stops using it.
+class ofSoundBufferPlayer: public ofSoundNode{
+public:
+	ofSoundParameter volume{1};
+	ofSoundParameter speed{1};
+
+	ofSoundBufferPlayer();
+
+	/// \brief Sets the sound to play, from the main thread
+	void load(std::shared_ptr<const ofSoundBuffer> buffer);
+
+	void play();
+	void stop();
+	void setLoop(bool loop);
+
+	/// \brief Moves the playhead, 0 start to 1 end
+	void setPosition(float position);
+
+	bool isPlaying() const;
+	float getPosition() const;
+
+protected:
+	void process(ofSoundBuffer & output, uint64_t block) override;
+	void receive(int command, float value, void * pointer, uint64_t id) override;
+
+private:
+	// main thread, buffers that the audio thread might still use
+	std::deque<std::pair<uint64_t, std::shared_ptr<const ofSoundBuffer>>> loaded;
+	uint64_t nextId;
+
+	// audio thread
+	const ofSoundBuffer * buffer;
+	double playhead;
+	bool playing;
+	bool loop;
+
+	std::atomic<uint64_t> currentId;
+	std::atomic<bool> playingState;
+	std::atomic<float> positionState;
+};
+
+/// \brief Biquad filter applied to every channel
+class ofSoundFilter: public ofSoundNode{
+public:
+	enum Type{
+		LOW_PASS,
+		HIGH_PASS,
+		BAND_PASS,
+		NOTCH,
+	};
+
+	ofSoundParameter cutoff{1000}; //< Hz
+	ofSoundParameter q{0.707f};
+
+	void setType(Type type);
+
+protected:
+	void prepare() override;
+	void process(ofSoundBuffer & output, uint64_t block) override;
+	void receive(int command, float value, void * pointer, uint64_t id) override;
+
+private:
+	void updateCoefficients(float cutoff, float q);
+
+	Type type = LOW_PASS;
+	bool dirty = true;
+	float b0, b1, b2, a1, a2;
+	std::vector<float> z1, z2;
+};
+
+/// \brief Passes its inputs through measuring their level, read from the
+/// main thread, and optionally feeding them to an ofSoundAnalyzer
+class ofSoundMeter: public ofSoundNode{
+public:
+	/// \brief Analyzes the blocks passing through, nullptr to stop. The
+	/// analyzer has to be set up and outlive the stream
+	void setAnalyzer(ofSoundAnalyzer * analyzer);
+
+	/// \brief RMS of channel in the last block
+	float getRMS(std::size_t channel) const;
+
+	/// \brief Highest absolute sample of channel in the last block
+	float getPeak(std::size_t channel) const;
+
+	/// \brief RMS of all the channels in the last block
+	float getRMS() const;
+
+protected:
+	void prepare() override;
+	void process(ofSoundBuffer & output, uint64_t block) override;
+	void receive(int command, float value, void * pointer, uint64_t id) override;
+
+private:
+	ofSoundAnalyzer * analyzer = nullptr;
+	std::unique_ptr<std::atomic<float>[]> rms;
+	std::unique_ptr<std::atomic<float>[]> peaks;
+	std::size_t numChannels = 0;
+};
+
+/// \brief Real-time safe audio processing with a graph of ofSoundNode,
+/// listening to an ofSoundStream
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofSoundStreamSettings settings;
+///     settings.numOutputChannels = 2;
+///     settings.bufferSize = 64;
+///     settings.sampleRate = 48000;
+///     settings.setOutListener(&graph);
+///
+///     // allocates every node connected so far, later connections are
+///     // set up when they are made
+///     graph.setup(settings);
+///     osc.connectTo(filter).connectTo(graph.getOutput());
+///     stream.setup(settings);
+/// }
+///
+/// void ofApp::mouseMoved(int x, int y){
+///     filter.cutoff.set(ofMap(x, 0, ofGetWidth(), 100, 10000));
+/// }
+/// ~~~~
+///
+/// The graph processes blocks of the size it was set up with and adapts
+/// them to the buffers the stream asks for. Denormals are flushed to zero
+/// in the audio thread on SSE.
+class ofSoundGraph: public ofBaseSoundOutput{
+public:
+	ofSoundGraph();
+
+	void setup(const ofSoundStreamSettings & settings);
+	void setup(std::size_t numFrames, std::size_t numChannels, unsigned int sampleRate);
+
+	/// \brief The node the stream pulls from, connect the nodes to play to it
+	ofSoundMixer & getOutput();
+
+	void audioOut(ofSoundBuffer & buffer) override;
+
+	/// \brief Blocks processed so far
+	uint64_t getNumBlocks() const;
+
+	/// \brief Time spent processing the last buffer relative to its
+	/// duration, close to 1 means the stream is about to glitch
+	float getLoad() const;
+
+private:
+	ofSoundMixer output;
+	const ofSoundBuffer * block;
+	std::size_t blockFrame;
+	std::atomic<uint64_t> numBlocks;
+	std::atomic<float> load;
+};
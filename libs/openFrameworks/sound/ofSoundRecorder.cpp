@@ -0,0 +1,398 @@
+#include "ofSoundRecorder.h"
+#include "ofSoundBuffer.h"
+#include "ofMath.h"
+#include "ofLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+// libsndfile is linked where the OpenAL sound player uses it
+#ifdef OF_SOUND_PLAYER_OPENAL
+#define OF_SOUND_RECORDER_SNDFILE
+#include <sndfile.h>
+#endif
+
+using namespace std;
+
+namespace{
+	// how long the writer sleeps when there's nothing to write
+	const auto pollInterval = chrono::milliseconds(5);
+	const auto headerInterval = chrono::seconds(1);
+
+	// frames converted to integers at once by the WAV writer
+	const size_t convertFrames = 4096;
+
+	const size_t wavHeaderSize = 104;
+
+	const unsigned char pcmGuid[16] = {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+	const unsigned char floatGuid[16] = {0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+	void putTag(char *& p, const char * tag){
+		memcpy(p, tag, 4);
+		p += 4;
+	}
+
+	void put16(char *& p, uint16_t v){
+		*p++ = char(v & 0xFF);
+		*p++ = char(v >> 8);
+	}
+
+	void put32(char *& p, uint32_t v){
+		put16(p, uint16_t(v & 0xFFFF));
+		put16(p, uint16_t(v >> 16));
+	}
+
+	void put64(char *& p, uint64_t v){
+		put32(p, uint32_t(v & 0xFFFFFFFF));
+		put32(p, uint32_t(v >> 32));
+	}
+
+	// WAVE_FORMAT_EXTENSIBLE with a JUNK chunk that becomes the ds64 chunk
+	// of an RF64 file once the data doesn't fit in 32 bits
+	void writeWavHeader(ostream & file, const ofSoundRecorderSettings & settings, uint64_t dataBytes, uint64_t padding){
+		uint16_t channels = uint16_t(settings.numChannels);
+		uint16_t blockAlign = uint16_t(settings.bitDepth / 8 * channels);
+		uint64_t riffSize = wavHeaderSize - 8 + dataBytes + padding;
+		bool rf64 = riffSize > 0xFFFFFFFF;
+		uint32_t channelMask = channels == 1 ? 0x4 : channels == 2 ? 0x3 : 0;
+
+		char header[wavHeaderSize];
+		char * p = header;
+		putTag(p, rf64 ? "RF64" : "RIFF");
+		put32(p, rf64 ? 0xFFFFFFFF : uint32_t(riffSize));
+		putTag(p, "WAVE");
+
+		putTag(p, rf64 ? "ds64" : "JUNK");
+		put32(p, 28);
+		put64(p, rf64 ? riffSize : 0);
+		put64(p, rf64 ? dataBytes : 0);
+		put64(p, rf64 ? dataBytes / blockAlign : 0);
+		put32(p, 0);
+
+		putTag(p, "fmt ");
+		put32(p, 40);
+		put16(p, 0xFFFE);
+		put16(p, channels);
+		put32(p, settings.sampleRate);
+		put32(p, settings.sampleRate * blockAlign);
+		put16(p, blockAlign);
+		put16(p, uint16_t(settings.bitDepth));
+		put16(p, 22);
+		put16(p, uint16_t(settings.bitDepth));
+		put32(p, channelMask);
+		memcpy(p, settings.bitDepth == 32 ? floatGuid : pcmGuid, 16);
+		p += 16;
+
+		putTag(p, "data");
+		put32(p, rf64 ? 0xFFFFFFFF : uint32_t(dataBytes));
+
+		file.write(header, wavHeaderSize);
+	}
+}
+
+//----------------------------------------------------------
+ofSoundRecorder::ofSoundRecorder()
+:ringFrames(0)
+,writeFrame(0)
+,readFrame(0)
+,numFramesDropped(0)
+,numOverruns(0)
+,maxQueuedFrames(0)
+,running(false)
+,bError(false)
+,sndFile(nullptr)
+,dataBytes(0){
+}
+
+//----------------------------------------------------------
+ofSoundRecorder::~ofSoundRecorder(){
+	close();
+}
+
+//----------------------------------------------------------
+bool ofSoundRecorder::setup(const ofSoundRecorderSettings & settings){
+	close();
+	if(settings.numChannels == 0 || settings.sampleRate == 0){
+		ofLogError("ofSoundRecorder") << "setup(): needs at least 1 channel and a sample rate";
+		return false;
+	}
+	if(settings.bitDepth != 16 && settings.bitDepth != 24 && settings.bitDepth != 32){
+		ofLogError("ofSoundRecorder") << "setup(): bit depth has to be 16, 24 or 32, not " << settings.bitDepth;
+		return false;
+	}
+	if(settings.format == OF_SOUND_FILE_FLAC && (settings.numChannels > 8 || settings.bitDepth == 32)){
+		ofLogError("ofSoundRecorder") << "setup(): FLAC can only record up to 8 channels of 16 or 24 bits";
+		return false;
+	}
+	this->settings = settings;
+
+	// the whole ring is written here so its pages are already mapped when
+	// the audio thread first touches them
+	ringFrames = std::max<size_t>(size_t(ceil(settings.bufferSeconds * settings.sampleRate)), 1);
+	ring.assign(ringFrames * settings.numChannels, 0);
+	converted.resize(convertFrames * settings.numChannels * 3);
+	writeFrame = 0;
+	readFrame = 0;
+	numFramesDropped = 0;
+	numOverruns = 0;
+	maxQueuedFrames = 0;
+	bError = false;
+	dataBytes = 0;
+
+	if(!openFile()){
+		ring.clear();
+		return false;
+	}
+	running = true;
+	writer = std::thread(&ofSoundRecorder::writeLoop, this);
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofSoundRecorder::openFile(){
+#ifdef OF_SOUND_RECORDER_SNDFILE
+	SF_INFO info;
+	memset(&info, 0, sizeof(info));
+	info.samplerate = settings.sampleRate;
+	info.channels = settings.numChannels;
+	int subtype = settings.bitDepth == 16 ? SF_FORMAT_PCM_16 : settings.bitDepth == 24 ? SF_FORMAT_PCM_24 : SF_FORMAT_FLOAT;
+	info.format = (settings.format == OF_SOUND_FILE_FLAC ? SF_FORMAT_FLAC : SF_FORMAT_RF64) | subtype;
+	sndFile = sf_open(settings.path.c_str(), SFM_WRITE, &info);
+	if(!sndFile){
+		ofLogError("ofSoundRecorder") << "setup(): couldn't create " << settings.path << ": " << sf_strerror(nullptr);
+		return false;
+	}
+	if(settings.format == OF_SOUND_FILE_WAV){
+		// a plain WAV unless it grows past 4GB
+		sf_command(sndFile, SFC_RF64_AUTO_DOWNGRADE, nullptr, SF_TRUE);
+	}
+	sf_command(sndFile, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+	return true;
+#else
+	if(settings.format == OF_SOUND_FILE_FLAC){
+		ofLogError("ofSoundRecorder") << "setup(): FLAC needs libsndfile, only available on linux";
+		return false;
+	}
+	wavFile.open(settings.path, ios::binary | ios::trunc);
+	if(!wavFile.is_open()){
+		ofLogError("ofSoundRecorder") << "setup(): couldn't create " << settings.path;
+		return false;
+	}
+	writeWavHeader(wavFile, settings, 0, 0);
+	return bool(wavFile);
+#endif
+}
+
+//----------------------------------------------------------
+void ofSoundRecorder::closeFile(){
+#ifdef OF_SOUND_RECORDER_SNDFILE
+	if(sndFile){
+		sf_close(sndFile);
+		sndFile = nullptr;
+	}
+#else
+	if(wavFile.is_open()){
+		// chunks are padded to an even size
+		uint64_t padding = dataBytes & 1;
+		if(padding){
+			wavFile.put(0);
+		}
+		wavFile.seekp(0);
+		writeWavHeader(wavFile, settings, dataBytes, padding);
+		wavFile.close();
+	}
+#endif
+}
+
+//----------------------------------------------------------
+bool ofSoundRecorder::writeFrames(const float * samples, size_t numFrames){
+#ifdef OF_SOUND_RECORDER_SNDFILE
+	return sf_writef_float(sndFile, samples, numFrames) == sf_count_t(numFrames);
+#else
+	size_t channels = settings.numChannels;
+	if(settings.bitDepth == 32){
+		// the file is little endian, like every platform this builds on
+		wavFile.write(reinterpret_cast<const char*>(samples), numFrames * channels * sizeof(float));
+		dataBytes += numFrames * channels * sizeof(float);
+		return bool(wavFile);
+	}
+	size_t bytesPerSample = settings.bitDepth / 8;
+	float scale = settings.bitDepth == 16 ? 32767.f : 8388607.f;
+	for(size_t done = 0; done < numFrames;){
+		size_t count = std::min(numFrames - done, convertFrames);
+		char * p = converted.data();
+		const float * src = samples + done * channels;
+		for(size_t i = 0; i < count * channels; i++){
+			int32_t v = int32_t(lrintf(ofClamp(src[i], -1.f, 1.f) * scale));
+			*p++ = char(v & 0xFF);
+			*p++ = char((v >> 8) & 0xFF);
+			if(bytesPerSample == 3){
+				*p++ = char((v >> 16) & 0xFF);
+			}
+		}
+		wavFile.write(converted.data(), p - converted.data());
+		dataBytes += p - converted.data();
+		done += count;
+	}
+	return bool(wavFile);
+#endif
+}
+
+//----------------------------------------------------------
+void ofSoundRecorder::updateHeader(){
+#ifdef OF_SOUND_RECORDER_SNDFILE
+	sf_command(sndFile, SFC_UPDATE_HEADER_NOW, nullptr, 0);
+#else
+	wavFile.seekp(0);
+	writeWavHeader(wavFile, settings, dataBytes, 0);
+	wavFile.seekp(0, ios::end);
+	wavFile.flush();
+#endif
+}
+
+//----------------------------------------------------------
+bool ofSoundRecorder::addBuffer(const ofSoundBuffer & buffer){
+	if(!running || bError){
+		return false;
+	}
+	size_t frames = buffer.getNumFrames();
+	if(frames == 0){
+		return true;
+	}
+	uint64_t w = writeFrame.load(std::memory_order_relaxed);
+	uint64_t r = readFrame.load(std::memory_order_acquire);
+	size_t queued = size_t(w - r);
+	if(queued + frames > ringFrames){
+		numOverruns++;
+		numFramesDropped += frames;
+		return false;
+	}
+
+	size_t channels = settings.numChannels;
+	size_t srcChannels = buffer.getNumChannels();
+	const float * src = buffer.getBuffer().data();
+	for(size_t done = 0; done < frames;){
+		size_t start = size_t((w + done) % ringFrames);
+		size_t count = std::min(frames - done, ringFrames - start);
+		float * dst = &ring[start * channels];
+		if(srcChannels == channels){
+			memcpy(dst, src + done * channels, count * channels * sizeof(float));
+		}else{
+			for(size_t f = 0; f < count; f++){
+				for(size_t c = 0; c < channels; c++){
+					dst[f * channels + c] = c < srcChannels ? src[(done + f) * srcChannels + c] : 0;
+				}
+			}
+		}
+		done += count;
+	}
+	writeFrame.store(w + frames, std::memory_order_release);
+
+	// only this thread writes it
+	if(queued + frames > maxQueuedFrames.load(std::memory_order_relaxed)){
+		maxQueuedFrames.store(queued + frames, std::memory_order_relaxed);
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofSoundRecorder::audioIn(ofSoundBuffer & buffer){
+	addBuffer(buffer);
+}
+
+//----------------------------------------------------------
+size_t ofSoundRecorder::drain(){
+	uint64_t r = readFrame.load(std::memory_order_relaxed);
+	uint64_t w = writeFrame.load(std::memory_order_acquire);
+	size_t total = size_t(w - r);
+	while(r < w && !bError){
+		size_t start = size_t(r % ringFrames);
+		size_t count = size_t(std::min<uint64_t>(w - r, ringFrames - start));
+		if(!writeFrames(&ring[start * settings.numChannels], count)){
+			ofLogError("ofSoundRecorder") << "couldn't write to " << settings.path << ", stopping the recording";
+			bError = true;
+		}
+		r += count;
+		readFrame.store(r, std::memory_order_release);
+	}
+	return total;
+}
+
+//----------------------------------------------------------
+void ofSoundRecorder::writeLoop(){
+	auto lastHeader = chrono::steady_clock::now();
+	while(running){
+		if(drain() == 0){
+			this_thread::sleep_for(pollInterval);
+		}
+		auto now = chrono::steady_clock::now();
+		if(!bError && now - lastHeader > headerInterval){
+			updateHeader();
+			lastHeader = now;
+		}
+	}
+	drain();
+}
+
+//----------------------------------------------------------
+void ofSoundRecorder::close(){
+	if(!writer.joinable()){
+		return;
+	}
+	running = false;
+	writer.join();
+	closeFile();
+	if(numOverruns > 0){
+		ofLogWarning("ofSoundRecorder") << "close(): dropped " << numFramesDropped << " frames in " << numOverruns
+			<< " buffers, the disk couldn't keep up, try a bigger bufferSeconds";
+	}
+}
+
+//----------------------------------------------------------
+bool ofSoundRecorder::isRecording() const{
+	return running && !bError;
+}
+
+//----------------------------------------------------------
+const ofSoundRecorderSettings & ofSoundRecorder::getSettings() const{
+	return settings;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundRecorder::getNumFramesAdded() const{
+	return writeFrame + numFramesDropped;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundRecorder::getNumFramesWritten() const{
+	return readFrame;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundRecorder::getNumFramesDropped() const{
+	return numFramesDropped;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundRecorder::getNumOverruns() const{
+	return numOverruns;
+}
+
+//----------------------------------------------------------
+size_t ofSoundRecorder::getNumQueuedFrames() const{
+	return size_t(writeFrame - readFrame);
+}
+
+//----------------------------------------------------------
+size_t ofSoundRecorder::getMaxQueuedFrames() const{
+	return maxQueuedFrames;
+}
+
+//----------------------------------------------------------
+double ofSoundRecorder::getDuration() const{
+	if(settings.sampleRate == 0){
+		return 0;
+	}
+	return double(writeFrame) / settings.sampleRate;
+}
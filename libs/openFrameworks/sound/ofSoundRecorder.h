@@ -0,0 +1,150 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <fstream>
+
+class ofSoundBuffer;
+typedef struct SNDFILE_tag SNDFILE;
+
+enum ofSoundFileFormat{
+	OF_SOUND_FILE_WAV,  ///< switches to RF64 once it passes 4GB
+	OF_SOUND_FILE_FLAC, ///< up to 8 channels of 16 or 24 bits, needs libsndfile
+};
+
+struct ofSoundRecorderSettings{
+	/// \brief The file to write
+	std::string path;
+
+	ofSoundFileFormat format = OF_SOUND_FILE_WAV;
+
+	/// \brief 16 or 24 bits integer or 32 bits float
+	int bitDepth = 24;
+
+	std::size_t numChannels = 2;
+	unsigned int sampleRate = 44100;
+
+	/// \brief Seconds of audio that can wait to be written while the disk
+	/// is busy, buffers that don't fit are dropped
+	float bufferSeconds = 2;
+};
+
+/// \brief Records the buffers of an ofSoundStream to a file without
+/// touching the disk from the audio thread
+///
+/// addBuffer() copies the samples into a ring allocated in setup() and
+/// returns, it never blocks, allocates or takes a lock. A thread of the
+/// recorder writes the ring to the file, through libsndfile where it's
+/// available, linux, and with its own WAV writer everywhere else:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     ofSoundRecorderSettings recording;
+///     recording.path = ofToDataPath("take.wav");
+///     recording.numChannels = 64;
+///     recording.sampleRate = 96000;
+///     recorder.setup(recording);
+///
+///     ofSoundStreamSettings settings;
+///     settings.numInputChannels = 64;
+///     settings.sampleRate = 96000;
+///     settings.setInListener(this);
+///     stream.setup(settings);
+/// }
+///
+/// void ofApp::audioIn(ofSoundBuffer & buffer){
+///     recorder.addBuffer(buffer);
+/// }
+///
+/// void ofApp::exit(){
+///     stream.close();
+///     recorder.close();
+/// }
+/// ~~~~
+///
+/// The recorder can also be the input listener itself, with
+/// settings.setInListener(&recorder).
+///
+/// If the disk falls behind for longer than bufferSeconds the buffers
+/// that don't fit are dropped whole, getNumOverruns() and
+/// getNumFramesDropped() count them. The header is updated every second
+/// so a crash only loses the last second of the file.
+class ofSoundRecorder{
+public:
+	ofSoundRecorder();
+	~ofSoundRecorder();
+
+	ofSoundRecorder(const ofSoundRecorder &) = delete;
+	ofSoundRecorder & operator=(const ofSoundRecorder &) = delete;
+
+	/// \brief Creates the file and starts the writing thread
+	///
+	/// The ring is reallocated, so the audio thread can't be calling
+	/// addBuffer() at the same time.
+	bool setup(const ofSoundRecorderSettings & settings);
+
+	/// \brief Queues a buffer to be written, from the audio thread
+	///
+	/// Buffers with a different number of channels are written with the
+	/// recorder's, dropping or zeroing the rest.
+	///
+	/// \returns false if the buffer didn't fit in the ring and was dropped
+	bool addBuffer(const ofSoundBuffer & buffer);
+
+	/// \brief Same as addBuffer(), to be used as ofSoundStreamSettings
+	/// input listener
+	void audioIn(ofSoundBuffer & buffer);
+
+	/// \brief Writes the frames still queued and finishes the file,
+	/// blocks until it's written
+	void close();
+
+	bool isRecording() const;
+
+	const ofSoundRecorderSettings & getSettings() const;
+
+	/// \brief Frames passed to addBuffer() since setup()
+	uint64_t getNumFramesAdded() const;
+	uint64_t getNumFramesWritten() const;
+	uint64_t getNumFramesDropped() const;
+
+	/// \brief Buffers dropped because the ring was full
+	uint64_t getNumOverruns() const;
+
+	/// \brief Frames waiting to be written
+	std::size_t getNumQueuedFrames() const;
+
+	/// \brief Most frames that were waiting at once, compared to the ring
+	/// size it tells how close the recording was to overrun
+	std::size_t getMaxQueuedFrames() const;
+
+	/// \brief Seconds of audio recorded
+	double getDuration() const;
+
+private:
+	bool openFile();
+	void closeFile();
+	bool writeFrames(const float * samples, std::size_t numFrames);
+	void updateHeader();
+	void writeLoop();
+	std::size_t drain();
+
+	ofSoundRecorderSettings settings;
+	std::vector<float> ring;
+	std::size_t ringFrames;
+	std::atomic<uint64_t> writeFrame;
+	std::atomic<uint64_t> readFrame;
+	std::atomic<uint64_t> numFramesDropped;
+	std::atomic<uint64_t> numOverruns;
+	std::atomic<std::size_t> maxQueuedFrames;
+	std::atomic<bool> running;
+	std::atomic<bool> bError;
+	std::thread writer;
+
+	SNDFILE * sndFile;
+	std::ofstream wavFile;
+	uint64_t dataBytes;
+	std::vector<char> converted;
+};
@@ -0,0 +1,345 @@
+#include "ofSoundSampler.h"
+#include "ofMath.h"
+#include "ofLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+namespace{
+	enum SamplerCommand{
+		SamplerStop,
+		SamplerStopAll,
+	};
+
+	// frames to fade out stopped voices, stolen ones fade at most this long
+	// but before the end of the block they are stolen in
+	const size_t fadeFrames = 64;
+
+	// the clock isn't extrapolated further than this when the stream stops
+	const double maxExtrapolation = 0.1;
+
+	int64_t nowNanos(){
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+//----------------------------------------------------------
+ofSoundSampler::ofSoundSampler(size_t numVoices, size_t maxSounds)
+:resident(maxSounds, nullptr)
+,numSounds(0)
+,nextId(1)
+,latency(0)
+,triggers(1024)
+,voices(std::max<size_t>(numVoices, 1))
+,frame(0)
+,timeSequence(0)
+,timeFrame(0)
+,timeNanos(0)
+,numActive(0)
+,numStolen(0)
+,numLate(0){
+	sounds.reserve(maxSounds);
+	// triggers wait here until their block, as many as the queue holds
+	pending.reserve(1024);
+}
+
+//----------------------------------------------------------
+int ofSoundSampler::addSound(shared_ptr<const ofSoundBuffer> sound){
+	if(!sound || sound->getNumFrames() == 0 || sound->getNumChannels() == 0){
+		ofLogError("ofSoundSampler") << "addSound(): sound is empty";
+		return -1;
+	}
+	size_t index = numSounds.load(std::memory_order_relaxed);
+	if(index == resident.size()){
+		ofLogError("ofSoundSampler") << "addSound(): can't add more than " << resident.size() << " sounds";
+		return -1;
+	}
+	sounds.push_back(sound);
+	resident[index] = sound.get();
+	numSounds.store(index + 1, std::memory_order_release);
+	return int(index);
+}
+
+//----------------------------------------------------------
+size_t ofSoundSampler::getNumSounds() const{
+	return numSounds.load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundSampler::play(int sound, float volume, float speed, float pan){
+	// 0 plays at the start of the next block
+	size_t frames = latency.load(std::memory_order_relaxed);
+	return playAt(frames ? getFrame() + frames : 0, sound, volume, speed, pan);
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundSampler::playAt(uint64_t frame, int sound, float volume, float speed, float pan){
+	if(sound < 0 || size_t(sound) >= numSounds.load(std::memory_order_acquire)){
+		ofLogError("ofSoundSampler") << "playAt(): sound " << sound << " doesn't exist";
+		return 0;
+	}
+	Trigger trigger;
+	trigger.frame = frame;
+	trigger.id = nextId++;
+	trigger.sound = sound;
+	trigger.volume = volume;
+	trigger.speed = speed;
+	trigger.pan = ofClamp(pan, -1, 1);
+	if(!triggers.send(trigger)){
+		return 0;
+	}
+	return trigger.id;
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::stop(uint64_t voice){
+	post(SamplerStop, 0, nullptr, voice);
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::stopAll(){
+	post(SamplerStopAll);
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::setLatency(size_t frames){
+	latency = frames;
+}
+
+//----------------------------------------------------------
+size_t ofSoundSampler::getLatency() const{
+	return latency;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundSampler::getFrame() const{
+	uint32_t sequence;
+	uint64_t lastFrame;
+	int64_t lastNanos;
+	do{
+		sequence = timeSequence.load(std::memory_order_acquire);
+		lastFrame = timeFrame.load(std::memory_order_relaxed);
+		lastNanos = timeNanos.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}while((sequence & 1) || sequence != timeSequence.load(std::memory_order_relaxed));
+
+	if(lastNanos == 0 || getSampleRate() == 0){
+		return lastFrame;
+	}
+	double elapsed = ofClamp((nowNanos() - lastNanos) / 1e9, 0, maxExtrapolation);
+	return lastFrame + uint64_t(elapsed * getSampleRate());
+}
+
+//----------------------------------------------------------
+size_t ofSoundSampler::getNumVoices() const{
+	return voices.size();
+}
+
+//----------------------------------------------------------
+size_t ofSoundSampler::getNumActiveVoices() const{
+	return numActive;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundSampler::getNumStolen() const{
+	return numStolen;
+}
+
+//----------------------------------------------------------
+uint64_t ofSoundSampler::getNumLate() const{
+	return numLate;
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::prepare(){
+	for(auto & voice: voices){
+		voice = Voice();
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::publishTime(uint64_t frame){
+	uint32_t sequence = timeSequence.load(std::memory_order_relaxed);
+	timeSequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	timeFrame.store(frame, std::memory_order_relaxed);
+	timeNanos.store(nowNanos(), std::memory_order_relaxed);
+	timeSequence.store(sequence + 2, std::memory_order_release);
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::receive(int command, float, void *, uint64_t id){
+	switch(command){
+	case SamplerStop:
+		for(auto & voice: voices){
+			if(voice.sound && voice.id == id){
+				release(voice, fadeFrames);
+			}
+		}
+		// it might not have started yet
+		pending.erase(std::remove_if(pending.begin(), pending.end(), [id](const Trigger & trigger){
+			return trigger.id == id;
+		}), pending.end());
+		break;
+	case SamplerStopAll:
+		for(auto & voice: voices){
+			if(voice.sound){
+				release(voice, fadeFrames);
+			}
+		}
+		pending.clear();
+		break;
+	}
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::start(Voice & voice, const Trigger & trigger, size_t offset){
+	auto sound = resident[trigger.sound];
+	voice.sound = sound;
+	voice.id = trigger.id;
+	voice.start = frame + offset;
+	voice.increment = trigger.speed * double(sound->getSampleRate()) / getSampleRate();
+	voice.position = voice.increment < 0 ? sound->getNumFrames() - 1 : 0;
+	if(getNumChannels() == 2){
+		// equal power, like ofSoundGain
+		float angle = (trigger.pan + 1) * float(PI) * 0.25f;
+		voice.gains[0] = trigger.volume * cos(angle);
+		voice.gains[1] = trigger.volume * sin(angle);
+	}else{
+		voice.gains[0] = voice.gains[1] = trigger.volume;
+	}
+	voice.rendered = offset;
+	voice.fade = 0;
+	voice.fadeLength = 0;
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::release(Voice & voice, size_t length){
+	length = std::max<size_t>(length, 1);
+	if(voice.fadeLength == 0){
+		voice.fade = length;
+		voice.fadeLength = length;
+	}else if(voice.fade > length){
+		// already fading but slower, continues from the same gain
+		voice.fadeLength = std::max<size_t>(voice.fadeLength * length / voice.fade, 1);
+		voice.fade = length;
+	}
+}
+
+//----------------------------------------------------------
+ofSoundSampler::Voice & ofSoundSampler::allocate(size_t offset, ofSoundBuffer & output){
+	Voice * stolen = nullptr;
+	for(auto & voice: voices){
+		if(!voice.sound){
+			return voice;
+		}
+		// prefer the ones already fading, then the oldest
+		bool fading = voice.fadeLength != 0;
+		bool stolenFading = stolen && stolen->fadeLength != 0;
+		if(!stolen || (fading && !stolenFading) || (fading == stolenFading && voice.start < stolen->start)){
+			stolen = &voice;
+		}
+	}
+
+	// play what's left of it in this block fading out, before it's reused
+	render(*stolen, output, offset);
+	if(stolen->sound){
+		release(*stolen, std::min(fadeFrames, output.getNumFrames() - offset));
+		render(*stolen, output, output.getNumFrames());
+	}
+	stolen->sound = nullptr;
+	numStolen++;
+	return *stolen;
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::render(Voice & voice, ofSoundBuffer & output, size_t to){
+	if(!voice.sound || voice.rendered >= to){
+		return;
+	}
+	auto & samples = output.getBuffer();
+	auto & source = voice.sound->getBuffer();
+	size_t numChannels = output.getNumChannels();
+	size_t sourceChannels = voice.sound->getNumChannels();
+	size_t lastFrame = voice.sound->getNumFrames() - 1;
+	bool stereo = numChannels == 2;
+	double position = voice.position;
+
+	for(size_t i = voice.rendered; i < to; i++){
+		if(position < 0 || position > lastFrame){
+			voice.sound = nullptr;
+			break;
+		}
+		float fade = 1;
+		if(voice.fadeLength){
+			if(voice.fade == 0){
+				voice.sound = nullptr;
+				break;
+			}
+			fade = float(voice.fade--) / voice.fadeLength;
+		}
+		size_t current = size_t(position);
+		size_t next = std::min(current + 1, lastFrame);
+		float t = float(position - current);
+		for(size_t c = 0; c < numChannels; c++){
+			size_t sourceChannel = c % sourceChannels;
+			float a = source[current * sourceChannels + sourceChannel];
+			float b = source[next * sourceChannels + sourceChannel];
+			float gain = voice.gains[stereo ? c : 0];
+			samples[i * numChannels + c] += (a + (b - a) * t) * gain * fade;
+		}
+		position += voice.increment;
+	}
+	voice.position = position;
+	voice.rendered = to;
+}
+
+//----------------------------------------------------------
+void ofSoundSampler::process(ofSoundBuffer & output, uint64_t){
+	auto & samples = output.getBuffer();
+	std::fill(samples.begin(), samples.end(), 0.f);
+	size_t numFrames = output.getNumFrames();
+	for(auto & voice: voices){
+		voice.rendered = 0;
+	}
+
+	// the queue is drained every block so the triggers are sorted here,
+	// std::sort doesn't allocate. When there's no space left the newest wait
+	// in the queue
+	Trigger trigger;
+	bool received = false;
+	while(pending.size() < pending.capacity() && triggers.tryReceive(trigger)){
+		pending.push_back(trigger);
+		received = true;
+	}
+	if(received){
+		std::sort(pending.begin(), pending.end(), [](const Trigger & a, const Trigger & b){
+			return a.frame < b.frame;
+		});
+	}
+
+	uint64_t end = frame + numFrames;
+	size_t due = 0;
+	for(; due < pending.size() && pending[due].frame < end; due++){
+		auto & next = pending[due];
+		size_t offset = 0;
+		if(next.frame >= frame){
+			offset = size_t(next.frame - frame);
+		}else if(next.frame != 0){
+			numLate++;
+		}
+		start(allocate(offset, output), next, offset);
+	}
+	pending.erase(pending.begin(), pending.begin() + due);
+
+	size_t active = 0;
+	for(auto & voice: voices){
+		render(voice, output, numFrames);
+		active += voice.sound != nullptr;
+	}
+	numActive = active;
+	frame = end;
+	publishTime(frame);
+}
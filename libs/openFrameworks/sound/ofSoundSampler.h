@@ -0,0 +1,137 @@
+#pragma once
+
+#include "ofSoundGraph.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// \brief Polyphonic sampler playing sounds kept in memory with sample
+/// accurate timing, a node of an ofSoundGraph
+///
+/// The sounds are added once, from the main thread, and stay resident. Each
+/// play() takes one of a fixed pool of voices, stealing the oldest one with
+/// a short fade when they are all busy. Triggers go to the audio thread
+/// through a lock-free queue stamped with the frame they start at, so they
+/// land on the exact sample no matter when the callback runs:
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     kick = sampler.addSound(kickBuffer);
+///     sampler.connectTo(graph.getOutput());
+///     graph.setup(settings);
+///     stream.setup(settings);
+///     // a constant delay of one stream buffer instead of a variable wait
+///     // for the next block
+///     sampler.setLatency(settings.bufferSize);
+/// }
+///
+/// void ofApp::keyPressed(int key){
+///     sampler.play(kick);
+/// }
+///
+/// void ofApp::update(){
+///     // a beat at 120bpm, scheduled ahead on the sampler's clock
+///     uint64_t beat = sampler.getSampleRate() / 2;
+///     if(sampler.getFrame() + beat > nextBeat){
+///         sampler.playAt(nextBeat, kick);
+///         nextBeat += beat;
+///     }
+/// }
+/// ~~~~
+class ofSoundSampler: public ofSoundNode{
+public:
+	/// \brief numVoices play at the same time, at most maxSounds can be added
+	ofSoundSampler(std::size_t numVoices = 32, std::size_t maxSounds = 256);
+
+	/// \brief Keeps sound resident to be played, from the main thread
+	/// \returns the index to play it with or -1 if there's no space left
+	int addSound(std::shared_ptr<const ofSoundBuffer> sound);
+	std::size_t getNumSounds() const;
+
+	/// \brief Plays sound after the latency, from any thread
+	/// \returns the id of the voice, to stop it, or 0 if the queue is full
+	uint64_t play(int sound, float volume = 1, float speed = 1, float pan = 0);
+
+	/// \brief Plays sound starting exactly at frame of the sampler's clock,
+	/// or as soon as possible if it's already past
+	uint64_t playAt(uint64_t frame, int sound, float volume = 1, float speed = 1, float pan = 0);
+
+	/// \brief Fades out the voice returned by play()
+	void stop(uint64_t voice);
+	void stopAll();
+
+	/// \brief Frames play() waits for, 0 starts at the next block. Set it to
+	/// at least the stream buffer size so triggers don't jitter with the
+	/// callbacks
+	void setLatency(std::size_t frames);
+	std::size_t getLatency() const;
+
+	/// \brief The sampler's clock, in frames, interpolated from the time of
+	/// the last block so it advances smoothly between callbacks
+	uint64_t getFrame() const;
+
+	std::size_t getNumVoices() const;
+	std::size_t getNumActiveVoices() const;
+
+	/// \brief Voices cut to play a new one since the start
+	uint64_t getNumStolen() const;
+
+	/// \brief Triggers that arrived after their frame since the start
+	uint64_t getNumLate() const;
+
+protected:
+	void prepare() override;
+	void process(ofSoundBuffer & output, uint64_t block) override;
+	void receive(int command, float value, void * pointer, uint64_t id) override;
+
+private:
+	struct Trigger{
+		uint64_t frame;
+		uint64_t id;
+		int sound;
+		float volume;
+		float speed;
+		float pan;
+	};
+
+	struct Voice{
+		const ofSoundBuffer * sound = nullptr;
+		uint64_t id = 0;
+		uint64_t start = 0;
+		double position = 0;
+		double increment = 1;
+		float gains[2] = {1, 1};
+		std::size_t rendered = 0;
+		std::size_t fade = 0;
+		std::size_t fadeLength = 0;
+	};
+
+	void render(Voice & voice, ofSoundBuffer & output, std::size_t to);
+	void start(Voice & voice, const Trigger & trigger, std::size_t offset);
+	void release(Voice & voice, std::size_t length);
+	Voice & allocate(std::size_t offset, ofSoundBuffer & output);
+	void publishTime(uint64_t frame);
+
+	// main thread, resident is only written past numSounds so the audio
+	// thread can read the sounds before it
+	std::vector<std::shared_ptr<const ofSoundBuffer>> sounds;
+	std::vector<const ofSoundBuffer*> resident;
+	std::atomic<std::size_t> numSounds;
+	std::atomic<uint64_t> nextId;
+	std::atomic<std::size_t> latency;
+	ofThreadChannel<Trigger, ofThreadChannelMPSC> triggers;
+
+	// audio thread
+	std::vector<Trigger> pending;
+	std::vector<Voice> voices;
+	uint64_t frame;
+
+	// the clock, written by the audio thread with a sequence lock
+	std::atomic<uint32_t> timeSequence;
+	std::atomic<uint64_t> timeFrame;
+	std::atomic<int64_t> timeNanos;
+
+	std::atomic<std::size_t> numActive;
+	std::atomic<uint64_t> numStolen;
+	std::atomic<uint64_t> numLate;
+};
@@ -196,9 +196,29 @@ public:
 	virtual ~ofSoundStreamSettings() {}
 	size_t sampleRate = 44100;
 	size_t bufferSize = 256;
+	/// \brief Number of buffers, periods on ALSA, queued by the device
+	///
+	/// Less buffers lower the latency but underflow more easily. Some apis
+	/// choose their own, the number used is in this field of the stream's
+	/// settings after setup().
 	size_t numBuffers = 4;
 	size_t numInputChannels = 0;
 	size_t numOutputChannels = 0;
+
+	/// \brief Asks the api for the lowest latency it can do, which can
+	/// override numBuffers and bufferSize
+	///
+	/// With ASIO it uses the smallest buffer the driver allows and with
+	/// ALSA, DirectSound and CoreAudio the least buffers.
+	bool minimizeLatency = false;
+
+	/// \brief Takes the device for the exclusive use of this stream
+	///
+	/// Hog mode on CoreAudio and the exclusive level on DirectSound. ASIO
+	/// and JACK are already exclusive or low latency by themselves and
+	/// WASAPI is always opened in shared mode, for the lowest latency on
+	/// windows use setApi(ofSoundDevice::MS_ASIO).
+	bool exclusive = false;
 	virtual bool setInDevice(const ofSoundDevice & device);
 	virtual bool setOutDevice(const ofSoundDevice & device);
 	virtual bool setApi(ofSoundDevice::Api api);
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "ofParameter.h"
+#include "ofAppRunner.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace of{
+namespace priv{
+	/// \brief A value that can be read and written from any thread without
+	/// locks
+	///
+	/// Types std::atomic handles natively are stored in one, anything else,
+	/// like vectors or colors, in a seqlock: readers copy the value and
+	/// retry if a writer changed it in the meantime, writers wait for
+	/// each other, which only lasts the copy of the value.
+	template<typename T, bool Native = std::is_arithmetic<T>::value || std::is_enum<T>::value>
+	class AtomicValue{
+	public:
+		static_assert(std::is_trivially_copyable<T>::value, "ofAtomicParameter needs a trivially copyable type");
+
+		AtomicValue(const T & v = T()){
+			store(v);
+		}
+
+		T load() const{
+			uint32_t data[numWords];
+			unsigned before, after;
+			do{
+				before = sequence.load(std::memory_order_acquire);
+				for(size_t i = 0; i < numWords; i++){
+					data[i] = words[i].load(std::memory_order_relaxed);
+				}
+				std::atomic_thread_fence(std::memory_order_acquire);
+				after = sequence.load(std::memory_order_relaxed);
+			}while((before & 1) || before != after);
+
+			T v;
+			std::memcpy(&v, data, sizeof(T));
+			return v;
+		}
+
+		void store(const T & v){
+			uint32_t data[numWords] = {0};
+			std::memcpy(data, &v, sizeof(T));
+
+			// an odd sequence marks a write in progress
+			unsigned seq = sequence.load(std::memory_order_relaxed);
+			while((seq & 1) || !sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)){
+				seq = sequence.load(std::memory_order_relaxed);
+			}
+			for(size_t i = 0; i < numWords; i++){
+				words[i].store(data[i], std::memory_order_relaxed);
+			}
+			sequence.store(seq + 2, std::memory_order_release);
+		}
+
+	private:
+		static const size_t numWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+		std::atomic<unsigned> sequence{0};
+		std::atomic<uint32_t> words[numWords];
+	};
+
+	template<typename T>
+	class AtomicValue<T, true>{
+	public:
+		AtomicValue(const T & v = T())
+		:value(v){}
+
+		T load() const{
+			return value.load(std::memory_order_acquire);
+		}
+
+		void store(const T & v){
+			value.store(v, std::memory_order_release);
+		}
+
+	private:
+		std::atomic<T> value;
+	};
+}
+}
+
+/// \brief An ofParameter that can be read and set from other threads, like
+/// the audio callback, without locks or events
+///
+/// It wraps a normal ofParameter, which is what the gui, groups and
+/// serialization see, and keeps a lock-free copy of its value.
+/// get() reads that copy from any thread. set() called from the thread that
+/// created it, usually the main one, behaves like ofParameter::set(), from
+/// any other thread it only updates the copy and the ofParameter and its
+/// listeners are updated by the main thread before the next update, so
+/// listeners are never called from the audio thread:
+///
+/// ~~~~{.cpp}
+/// // ofApp.h
+/// ofAtomicParameter<float> volume{"volume", 0.5, 0, 1};
+///
+/// // ofApp::setup()
+/// gui.add(volume.getParameter());
+///
+/// // ofApp::audioOut(ofSoundBuffer & buffer)
+/// float gain = volume.get();
+/// for(auto & sample: buffer.getBuffer()){
+///     sample *= gain;
+/// }
+/// ~~~~
+///
+/// ParameterType has to be trivially copyable, numbers, enums, bools,
+/// glm vectors, ofColor... Numbers use std::atomic, bigger types a seqlock,
+/// neither of them ever blocks a reader.
+///
+/// Changes made with ofParameter::setWithoutEventNotifications() or while
+/// its events are disabled aren't seen by get().
+template<typename ParameterType>
+class ofAtomicParameter{
+public:
+	ofAtomicParameter();
+	ofAtomicParameter(const ParameterType & v);
+	ofAtomicParameter(const std::string & name, const ParameterType & v);
+	ofAtomicParameter(const std::string & name, const ParameterType & v, const ParameterType & min, const ParameterType & max);
+
+	/// \brief Mirrors an existing parameter instead of creating a new one
+	ofAtomicParameter(ofParameter<ParameterType> & parameter);
+
+	/// \brief The current value, doesn't lock from any thread
+	ParameterType get() const;
+	operator ParameterType() const;
+
+	/// \brief Sets the value from any thread, see the class description
+	ofAtomicParameter<ParameterType> & set(const ParameterType & v);
+	ofAtomicParameter<ParameterType> & operator=(const ParameterType & v);
+
+	/// \brief Makes this mirror parameter instead of its current one
+	void makeReferenceTo(ofParameter<ParameterType> & parameter);
+
+	/// \brief The wrapped parameter, only to be used from the main thread
+	ofParameter<ParameterType> & getParameter();
+	const ofParameter<ParameterType> & getParameter() const;
+
+private:
+	struct State{
+		State(const ofParameter<ParameterType> & parameter);
+
+		void listen();
+		void listenUpdate();
+		void flush();
+		bool isOwnerThread() const;
+
+		ofParameter<ParameterType> parameter;
+		of::priv::AtomicValue<ParameterType> value;
+		of::priv::AtomicValue<ParameterType> pending;
+		std::atomic<bool> hasPending;
+		std::thread::id ownerThread;
+		bool listeningUpdate;
+		ofEventListener changedListener;
+		ofEventListener updateListener;
+	};
+
+	std::shared_ptr<State> state;
+};
+
+template<typename ParameterType>
+ofAtomicParameter<ParameterType>::State::State(const ofParameter<ParameterType> & parameter)
+:parameter(parameter)
+,value(parameter.get())
+,hasPending(false)
+,ownerThread(std::this_thread::get_id())
+,listeningUpdate(false){
+	listen();
+	listenUpdate();
+}
+
+template<typename ParameterType>
+void ofAtomicParameter<ParameterType>::State::listen(){
+	changedListener = parameter.newListener([this](const ParameterType & v){
+		// a newer value set from another thread wins until it's flushed
+		if(!hasPending.load(std::memory_order_acquire)){
+			value.store(v);
+		}
+	}, OF_EVENT_ORDER_BEFORE_APP);
+}
+
+template<typename ParameterType>
+void ofAtomicParameter<ParameterType>::State::listenUpdate(){
+	// parameters created before the window wait for the first set() from
+	// their thread to find it
+	if(!listeningUpdate && ofGetCurrentWindow()){
+		updateListener = ofEvents().update.newListener([this](ofEventArgs &){
+			flush();
+		}, OF_EVENT_ORDER_BEFORE_APP);
+		listeningUpdate = true;
+	}
+}
+
+template<typename ParameterType>
+void ofAtomicParameter<ParameterType>::State::flush(){
+	if(hasPending.exchange(false, std::memory_order_acq_rel)){
+		parameter.set(pending.load());
+	}
+}
+
+template<typename ParameterType>
+bool ofAtomicParameter<ParameterType>::State::isOwnerThread() const{
+	return std::this_thread::get_id() == ownerThread;
+}
+
+template<typename ParameterType>
+ofAtomicParameter<ParameterType>::ofAtomicParameter()
+:state(std::make_shared<State>(ofParameter<ParameterType>())){}
+
+template<typename ParameterType>
+ofAtomicParameter<ParameterType>::ofAtomicParameter(const ParameterType & v)
+:state(std::make_shared<State>(ofParameter<ParameterType>(v))){}
+
+template<typename ParameterType>
+ofAtomicParameter<ParameterType>::ofAtomicParameter(const std::string & name, const ParameterType & v)
+:state(std::make_shared<State>(ofParameter<ParameterType>(name, v))){}
+
+template<typename ParameterType>
+ofAtomicParameter<ParameterType>::ofAtomicParameter(const std::string & name, const ParameterType & v, const ParameterType & min, const ParameterType & max)
+:state(std::make_shared<State>(ofParameter<ParameterType>(name, v, min, max))){}
+
+template<typename ParameterType>
+ofAtomicParameter<ParameterType>::ofAtomicParameter(ofParameter<ParameterType> & parameter)
+:state(std::make_shared<State>(parameter)){}
+
+template<typename ParameterType>
+inline ParameterType ofAtomicParameter<ParameterType>::get() const{
+	return state->value.load();
+}
+
+template<typename ParameterType>
+inline ofAtomicParameter<ParameterType>::operator ParameterType() const{
+	return get();
+}
+
+template<typename ParameterType>
+ofAtomicParameter<ParameterType> & ofAtomicParameter<ParameterType>::set(const ParameterType & v){
+	if(state->isOwnerThread()){
+		state->listenUpdate();
+		state->hasPending.store(false, std::memory_order_release);
+		state->parameter.set(v);
+	}else{
+		state->value.store(v);
+		state->pending.store(v);
+		state->hasPending.store(true, std::memory_order_release);
+	}
+	return *this;
+}
+
+template<typename ParameterType>
+inline ofAtomicParameter<ParameterType> & ofAtomicParameter<ParameterType>::operator=(const ParameterType & v){
+	return set(v);
+}
+
+template<typename ParameterType>
+void ofAtomicParameter<ParameterType>::makeReferenceTo(ofParameter<ParameterType> & parameter){
+	state->parameter.makeReferenceTo(parameter);
+	state->listen();
+	state->value.store(parameter.get());
+}
+
+template<typename ParameterType>
+inline ofParameter<ParameterType> & ofAtomicParameter<ParameterType>::getParameter(){
+	return state->parameter;
+}
+
+template<typename ParameterType>
+inline const ofParameter<ParameterType> & ofAtomicParameter<ParameterType>::getParameter() const{
+	return state->parameter;
+}
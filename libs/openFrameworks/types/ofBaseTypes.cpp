@@ -110,6 +110,16 @@ void ofBaseVideoPlayer::setFrame(int frame){
 	ofLogWarning("ofBaseVideoPlayer") << "setFrame() not implemented";
 }
 
+//---------------------------------------------------------------------------
+void ofBaseVideoPlayer::setFrameAsync(int frame, ofVideoSeekMode){
+	setFrame(frame);
+}
+
+//---------------------------------------------------------------------------
+bool ofBaseVideoPlayer::isSeeking() const{
+	return false;
+}
+
 //---------------------------------------------------------------------------
 int	ofBaseVideoPlayer::getCurrentFrame() const {
 	ofLogWarning("ofBaseVideoPlayer") << "getCurrentFrame() not implemented";
@@ -48,6 +48,7 @@ class ofVbo;
 class ofVboMesh;
 class ofSoundBuffer;
 class ofFbo;
+class ofHttpCache;
 enum class ofFboBeginMode : short;
 
 
@@ -594,6 +595,19 @@ public:
 	///
 	/// \param frame The frame number to set the new playhead to.
 	virtual void				setFrame(int frame);
+	/// \brief Set the current frame without waiting for it to be decoded.
+	///
+	/// Returns immediately, isSeeking() is true until the frame is ready.
+	/// Calling it again before that replaces the previous request, so it can
+	/// be called every frame while scrubbing. Players that can't seek
+	/// asynchronously call setFrame().
+	///
+	/// \param frame The frame number to set the new playhead to.
+	/// \param mode Whether to land on the exact frame or the nearest keyframe.
+	virtual void				setFrameAsync(int frame, ofVideoSeekMode mode);
+	/// \brief Returns true while the frame requested with setFrameAsync() is
+	/// not ready yet.
+	virtual bool				isSeeking() const;
 
 	/// \brief Get the current playhead position as a frame number.
 	/// \returns The current playhead position as a frame number.
@@ -1871,7 +1885,7 @@ public:
 	virtual void draw(const ofVbo & vbo, GLuint drawMode, int first, int total) const=0;
 	virtual void drawElements(const ofVbo & vbo, GLuint drawMode, int amt, int offsetelements) const=0;
 	virtual void drawInstanced(const ofVbo & vbo, GLuint drawMode, int first, int total, int primCount) const=0;
-	virtual void drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount) const=0;
+	virtual void drawElementsInstanced(const ofVbo & vbo, GLuint drawMode, int amt, int primCount, int offsetelements) const=0;
 	virtual void draw(const ofVboMesh & mesh, ofPolyRenderMode renderType) const=0;
 	virtual void drawInstanced(const ofVboMesh & mesh, ofPolyRenderMode renderType, int primCount) const=0;
 
@@ -1978,6 +1992,19 @@ public:
 	/// \return HTTP response on success or failure
 	virtual ofHttpResponse handleRequest(const ofHttpRequest & request) = 0;
 	virtual int handleRequestAsync(const ofHttpRequest& request)=0; // returns id
+
+	/// \brief limit the number of async requests made to the same host at
+	/// the same time, 0 for no limit. Loaders that can't run requests in
+	/// parallel ignore it
+	virtual void setMaxConnectionsPerHost(std::size_t max){}
+
+	/// \brief limit the number of async requests made at the same time,
+	/// 0 for no limit. Loaders that can't run requests in parallel ignore it
+	virtual void setMaxConnections(std::size_t max){}
+
+	/// \brief answer repeated GET requests from cache instead of the
+	/// network. Loaders that can't use it ignore it
+	virtual void setCache(std::shared_ptr<ofHttpCache> cache){}
 	
 };
 
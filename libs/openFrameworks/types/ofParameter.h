@@ -7,6 +7,7 @@
 #include "ofVectorMath.h"
 #include "ofPoint.h"
 #include <map>
+#include <set>
 
 template<typename ParameterType>
 class ofParameter;
@@ -72,6 +73,8 @@ protected:
 	virtual void setSerializable(bool serializable)=0;
 	virtual std::string escape(const std::string& str) const;
 	virtual const void* getInternalObject() const = 0;
+
+	friend class ofParameterGroup;
 };
 
 
@@ -242,6 +245,24 @@ public:
 
 	ofEvent<ofAbstractParameter> & parameterChangedE();
 
+	/// \brief Holds the notifications of parameterChangedE, here and in
+	/// every parent, until endBatch()
+	///
+	/// Loading a preset sets every parameter and each of them notifies
+	/// this group and all its parents. Between beginBatch() and endBatch()
+	/// the changes are only collected, then parameterChangedE is notified
+	/// once for each parameter that changed, no matter how many times, and
+	/// batchChangedE once with all of them. Calls can be nested, only the
+	/// outermost endBatch() notifies. Listeners of each ofParameter are
+	/// still notified as soon as it changes.
+	void beginBatch();
+	void endBatch();
+	bool isInBatch() const;
+
+	/// \brief Notified by endBatch() with every parameter that changed
+	/// during the batch, in the order they first changed
+	ofEvent<std::vector<std::shared_ptr<ofAbstractParameter>>> & batchChangedE();
+
 	std::vector<std::shared_ptr<ofAbstractParameter> >::iterator begin();
 	std::vector<std::shared_ptr<ofAbstractParameter> >::iterator end();
 	std::vector<std::shared_ptr<ofAbstractParameter> >::const_iterator begin() const;
@@ -258,7 +279,8 @@ private:
 	class Value{
 	public:
 		Value()
-		:serializable(true){}
+		:serializable(true)
+		,batchDepth(0){}
 
 		void notifyParameterChanged(ofAbstractParameter & param);
 
@@ -268,6 +290,11 @@ private:
 		bool serializable;
 		std::vector<std::weak_ptr<Value>> parents;
 		ofEvent<ofAbstractParameter> parameterChangedE;
+
+		int batchDepth;
+		std::vector<std::shared_ptr<ofAbstractParameter>> batchChanges;
+		std::set<const void*> batchChangedObjects;
+		ofEvent<std::vector<std::shared_ptr<ofAbstractParameter>>> batchChangedE;
 	};
 	std::shared_ptr<Value> obj;
 	ofParameterGroup(std::shared_ptr<Value> obj)
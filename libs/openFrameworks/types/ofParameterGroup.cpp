@@ -405,6 +405,13 @@ bool ofParameterGroup::contains(const string& name) const{
 }
 
 void ofParameterGroup::Value::notifyParameterChanged(ofAbstractParameter & param){
+	if(batchDepth > 0){
+		// only remember it, the parents will be notified by endBatch
+		if(batchChangedObjects.insert(param.getInternalObject()).second){
+			batchChanges.push_back(param.newReference());
+		}
+		return;
+	}
 	ofNotifyEvent(parameterChangedE,param);
 	parents.erase(std::remove_if(parents.begin(),parents.end(),[&param](const weak_ptr<Value> & p){
 		auto parent = p.lock();
@@ -426,6 +433,37 @@ ofEvent<ofAbstractParameter> & ofParameterGroup::parameterChangedE(){
 	return obj->parameterChangedE;
 }
 
+void ofParameterGroup::beginBatch(){
+	obj->batchDepth++;
+}
+
+void ofParameterGroup::endBatch(){
+	if(obj->batchDepth == 0){
+		ofLogWarning("ofParameterGroup") << "endBatch(): called without beginBatch() on " << getName();
+		return;
+	}
+	if(--obj->batchDepth > 0){
+		return;
+	}
+	auto changes = std::move(obj->batchChanges);
+	obj->batchChanges.clear();
+	obj->batchChangedObjects.clear();
+	for(auto & param: changes){
+		obj->notifyParameterChanged(*param);
+	}
+	if(!changes.empty()){
+		ofNotifyEvent(obj->batchChangedE,changes);
+	}
+}
+
+bool ofParameterGroup::isInBatch() const{
+	return obj->batchDepth > 0;
+}
+
+ofEvent<std::vector<std::shared_ptr<ofAbstractParameter>>> & ofParameterGroup::batchChangedE(){
+	return obj->batchChangedE;
+}
+
 ofAbstractParameter & ofParameterGroup::back(){
 	return *obj->parameters.back();
 }
@@ -0,0 +1,265 @@
+#include "ofSpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace{
+	// far enough that the coordinates of any cell fit in an int
+	const float maxCellCoord = 1 << 30;
+
+	uint64_t cellKey(int x, int y){
+		return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+	}
+
+	// both include the edges, so items of size 0 are found too
+	bool contains(const ofRectangle & bounds, const glm::vec2 & p){
+		return p.x >= bounds.x && p.x <= bounds.x + bounds.width
+			&& p.y >= bounds.y && p.y <= bounds.y + bounds.height;
+	}
+
+	bool intersects(const ofRectangle & a, const ofRectangle & b){
+		return a.x <= b.x + b.width && a.x + a.width >= b.x
+			&& a.y <= b.y + b.height && a.y + a.height >= b.y;
+	}
+}
+
+//----------------------------------------------------------
+ofSpatialGrid::ofSpatialGrid(float cellSize)
+:cellSize(cellSize > 0 ? cellSize : 64)
+,maxCellsPerItem(64){
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::setCellSize(float cellSize){
+	if(cellSize <= 0 || cellSize == this->cellSize){
+		return;
+	}
+	this->cellSize = cellSize;
+	relist();
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::relist(){
+	cells.clear();
+	large.clear();
+	for(auto & entry: items){
+		auto & item = entry.second;
+		cellRange(item.bounds, item.x0, item.y0, item.x1, item.y1);
+		item.large = uint64_t(item.x1 - item.x0 + 1) * uint64_t(item.y1 - item.y0 + 1) > maxCellsPerItem;
+		list(item);
+	}
+}
+
+//----------------------------------------------------------
+float ofSpatialGrid::getCellSize() const{
+	return cellSize;
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::setMaxCellsPerItem(size_t maxCells){
+	maxCellsPerItem = std::max<size_t>(maxCells, 1);
+	relist();
+}
+
+//----------------------------------------------------------
+size_t ofSpatialGrid::getMaxCellsPerItem() const{
+	return maxCellsPerItem;
+}
+
+//----------------------------------------------------------
+int ofSpatialGrid::cellCoord(float v) const{
+	float cell = std::floor(v / cellSize);
+	if(!(cell > -maxCellCoord)) return -int(maxCellCoord);
+	if(!(cell < maxCellCoord)) return int(maxCellCoord);
+	return int(cell);
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::cellRange(const ofRectangle & bounds, int & x0, int & y0, int & x1, int & y1) const{
+	x0 = cellCoord(bounds.x);
+	y0 = cellCoord(bounds.y);
+	x1 = cellCoord(bounds.x + bounds.width);
+	y1 = cellCoord(bounds.y + bounds.height);
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::list(const Item & item){
+	if(item.large){
+		large.push_back(&item);
+		return;
+	}
+	for(int y = item.y0; y <= item.y1; y++){
+		for(int x = item.x0; x <= item.x1; x++){
+			cells[cellKey(x, y)].push_back(&item);
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::unlist(const Item & item){
+	auto removeFrom = [&item](vector<const Item*> & items){
+		auto it = find(items.begin(), items.end(), &item);
+		if(it != items.end()){
+			*it = items.back();
+			items.pop_back();
+		}
+	};
+	if(item.large){
+		removeFrom(large);
+		return;
+	}
+	for(int y = item.y0; y <= item.y1; y++){
+		for(int x = item.x0; x <= item.x1; x++){
+			auto cell = cells.find(cellKey(x, y));
+			if(cell != cells.end()){
+				removeFrom(cell->second);
+				if(cell->second.empty()){
+					cells.erase(cell);
+				}
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::update(size_t id, const ofRectangle & bounds){
+	Item moved;
+	moved.id = id;
+	moved.bounds = bounds.getStandardized();
+	cellRange(moved.bounds, moved.x0, moved.y0, moved.x1, moved.y1);
+	moved.large = uint64_t(moved.x1 - moved.x0 + 1) * uint64_t(moved.y1 - moved.y0 + 1) > maxCellsPerItem;
+
+	auto it = items.find(id);
+	if(it == items.end()){
+		list(items.emplace(id, moved).first->second);
+		return;
+	}
+	Item & item = it->second;
+	bool sameCells = item.large == moved.large
+		&& (item.large || (item.x0 == moved.x0 && item.y0 == moved.y0 && item.x1 == moved.x1 && item.y1 == moved.y1));
+	if(sameCells){
+		item.bounds = moved.bounds;
+		return;
+	}
+	unlist(item);
+	item = moved;
+	list(item);
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::insert(size_t id, const ofRectangle & bounds){
+	update(id, bounds);
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::remove(size_t id){
+	auto it = items.find(id);
+	if(it == items.end()){
+		return;
+	}
+	unlist(it->second);
+	items.erase(it);
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::clear(){
+	items.clear();
+	cells.clear();
+	large.clear();
+}
+
+//----------------------------------------------------------
+bool ofSpatialGrid::contains(size_t id) const{
+	return items.find(id) != items.end();
+}
+
+//----------------------------------------------------------
+size_t ofSpatialGrid::size() const{
+	return items.size();
+}
+
+//----------------------------------------------------------
+bool ofSpatialGrid::empty() const{
+	return items.empty();
+}
+
+//----------------------------------------------------------
+ofRectangle ofSpatialGrid::getBounds(size_t id) const{
+	auto it = items.find(id);
+	return it == items.end() ? ofRectangle() : it->second.bounds;
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::query(const glm::vec2 & point, vector<size_t> & results) const{
+	results.clear();
+	auto cell = cells.find(cellKey(cellCoord(point.x), cellCoord(point.y)));
+	if(cell != cells.end()){
+		for(auto item: cell->second){
+			if(::contains(item->bounds, point)){
+				results.push_back(item->id);
+			}
+		}
+	}
+	for(auto item: large){
+		if(::contains(item->bounds, point)){
+			results.push_back(item->id);
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSpatialGrid::query(const ofRectangle & area, vector<size_t> & results) const{
+	results.clear();
+	ofRectangle r = area.getStandardized();
+	int x0, y0, x1, y1;
+	cellRange(r, x0, y0, x1, y1);
+	// an item in several of the cells is only reported from the first
+	// one both cover
+	auto test = [&](int x, int y, const vector<const Item*> & items){
+		for(auto item: items){
+			if(x == std::max(item->x0, x0) && y == std::max(item->y0, y0) && intersects(item->bounds, r)){
+				results.push_back(item->id);
+			}
+		}
+	};
+	uint64_t numCells = uint64_t(x1 - x0 + 1) * uint64_t(y1 - y0 + 1);
+	if(numCells > cells.size()){
+		// an area bigger than what's in the grid, like the whole screen
+		for(auto & cell: cells){
+			int x = int(uint32_t(cell.first >> 32));
+			int y = int(uint32_t(cell.first));
+			if(x >= x0 && x <= x1 && y >= y0 && y <= y1){
+				test(x, y, cell.second);
+			}
+		}
+	}else{
+		for(int y = y0; y <= y1; y++){
+			for(int x = x0; x <= x1; x++){
+				auto cell = cells.find(cellKey(x, y));
+				if(cell != cells.end()){
+					test(x, y, cell->second);
+				}
+			}
+		}
+	}
+	for(auto item: large){
+		if(intersects(item->bounds, r)){
+			results.push_back(item->id);
+		}
+	}
+}
+
+//----------------------------------------------------------
+vector<size_t> ofSpatialGrid::query(const glm::vec2 & point) const{
+	vector<size_t> results;
+	query(point, results);
+	return results;
+}
+
+//----------------------------------------------------------
+vector<size_t> ofSpatialGrid::query(const ofRectangle & area) const{
+	vector<size_t> results;
+	query(area, results);
+	return results;
+}
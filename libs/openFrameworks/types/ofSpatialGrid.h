@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofRectangle.h"
+#include <unordered_map>
+
+/// \brief Finds the items under a point or inside an area without testing
+/// every one of them, for the input events and culling of 2D scenes
+///
+/// Every item is an id chosen by the app, usually its index, with its
+/// bounds. The plane is divided in square cells and each item is listed in
+/// the cells its bounds overlap, a query only tests the items of the cells
+/// it touches:
+///
+/// ~~~~{.cpp}
+/// void ofApp::update(){
+///     for(size_t i = 0; i < sprites.size(); i++){
+///         sprites[i].move();
+///         // only relists the sprite if it moved to other cells
+///         grid.update(i, sprites[i].getBounds());
+///     }
+/// }
+///
+/// void ofApp::draw(){
+///     grid.query(ofRectangle(0, 0, ofGetWidth(), ofGetHeight()), visible);
+///     for(auto i: visible){
+///         sprites[i].draw();
+///     }
+/// }
+///
+/// void ofApp::mousePressed(int x, int y, int button){
+///     grid.query(glm::vec2(x, y), hits);
+///     for(auto i: hits){
+///         if(sprites[i].getOutline().inside(x, y)){
+///             sprites[i].select();
+///         }
+///     }
+/// }
+/// ~~~~
+///
+/// The grid has no bounds, cells are only allocated where there are items.
+/// The cell size should be around the size of the usual item: bigger cells
+/// list more items to test, smaller ones list each item in more cells.
+/// Items that would cover more than getMaxCellsPerItem() cells, like a
+/// background, are kept apart and tested by every query.
+///
+/// Queries don't modify the grid and can run from several threads as long
+/// as nothing is inserted, updated or removed at the same time.
+class ofSpatialGrid{
+public:
+	ofSpatialGrid(float cellSize = 64);
+
+	/// \brief Relists every item with the new cell size
+	void setCellSize(float cellSize);
+	float getCellSize() const;
+
+	/// \brief Items covering more cells than this aren't listed in them,
+	/// 64 by default
+	void setMaxCellsPerItem(std::size_t maxCells);
+	std::size_t getMaxCellsPerItem() const;
+
+	/// \brief Adds an item or moves it if the id is already in the grid
+	///
+	/// Moving an item whose bounds stay in the same cells only updates its
+	/// bounds.
+	void update(std::size_t id, const ofRectangle & bounds);
+
+	/// \brief Same as update()
+	void insert(std::size_t id, const ofRectangle & bounds);
+
+	void remove(std::size_t id);
+	void clear();
+
+	bool contains(std::size_t id) const;
+	std::size_t size() const;
+	bool empty() const;
+
+	/// \brief Bounds of an item, an empty rectangle if it isn't in the grid
+	ofRectangle getBounds(std::size_t id) const;
+
+	/// \brief Replaces results with the items whose bounds contain point
+	///
+	/// The results aren't in any particular order, sort them if the order
+	/// of the items matters.
+	void query(const glm::vec2 & point, std::vector<std::size_t> & results) const;
+
+	/// \brief Replaces results with the items whose bounds intersect area
+	void query(const ofRectangle & area, std::vector<std::size_t> & results) const;
+
+	std::vector<std::size_t> query(const glm::vec2 & point) const;
+	std::vector<std::size_t> query(const ofRectangle & area) const;
+
+private:
+	struct Item{
+		std::size_t id;
+		ofRectangle bounds;
+		// cells covered, inclusive, unused by the large ones
+		int x0, y0, x1, y1;
+		bool large;
+	};
+
+	void cellRange(const ofRectangle & bounds, int & x0, int & y0, int & x1, int & y1) const;
+	int cellCoord(float v) const;
+	void relist();
+	void list(const Item & item);
+	void unlist(const Item & item);
+
+	float cellSize;
+	std::size_t maxCellsPerItem;
+	// the cells point to the items, they don't move when the map grows
+	std::unordered_map<std::size_t, Item> items;
+	std::unordered_map<uint64_t, std::vector<const Item*>> cells;
+	std::vector<const Item*> large;
+};
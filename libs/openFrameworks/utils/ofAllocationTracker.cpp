@@ -0,0 +1,201 @@
+#include "ofAllocationTracker.h"
+#include "ofLog.h"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+const size_t ofAllocationTracker::maxThreads;
+
+namespace{
+	struct ThreadCounter{
+		atomic<uint64_t> allocations{0};
+		atomic<uint64_t> bytes{0};
+	};
+
+	// all constant initialized so they can be used from operator new
+	// before and after main
+	atomic<bool> enabled{false};
+	ThreadCounter threadCounters[ofAllocationTracker::maxThreads];
+	atomic<size_t> numThreads{0};
+	thread_local int threadSlot = -1;
+	thread_local uint64_t threadAllocations = 0;
+	thread_local uint64_t threadBytes = 0;
+
+	inline void countAllocation(size_t size){
+		if(!enabled.load(memory_order_relaxed)){
+			return;
+		}
+		if(threadSlot < 0){
+			threadSlot = min(numThreads.fetch_add(1, memory_order_relaxed), ofAllocationTracker::maxThreads - 1);
+		}
+		threadCounters[threadSlot].allocations.fetch_add(1, memory_order_relaxed);
+		threadCounters[threadSlot].bytes.fetch_add(size, memory_order_relaxed);
+		threadAllocations++;
+		threadBytes += size;
+	}
+
+	size_t usedThreadSlots(){
+		return min(numThreads.load(memory_order_relaxed), ofAllocationTracker::maxThreads);
+	}
+}
+
+#ifdef OF_ALLOCATION_TRACKING
+//----------------------------------------------------------
+void * operator new(size_t size){
+	countAllocation(size);
+	if(void * ptr = malloc(size ? size : 1)){
+		return ptr;
+	}
+	throw bad_alloc();
+}
+
+void * operator new[](size_t size){
+	return ::operator new(size);
+}
+
+void * operator new(size_t size, const nothrow_t &) noexcept{
+	countAllocation(size);
+	return malloc(size ? size : 1);
+}
+
+void * operator new[](size_t size, const nothrow_t &) noexcept{
+	return ::operator new(size, nothrow);
+}
+
+void operator delete(void * ptr) noexcept{
+	free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept{
+	free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept{
+	free(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept{
+	free(ptr);
+}
+
+void operator delete(void * ptr, const nothrow_t &) noexcept{
+	free(ptr);
+}
+
+void operator delete[](void * ptr, const nothrow_t &) noexcept{
+	free(ptr);
+}
+#endif
+
+//----------------------------------------------------------
+ofAllocationTracker::ofAllocationTracker()
+:lastFramePerThread(maxThreads)
+,frameStart(maxThreads)
+,frameBudget(0)
+,framesOverBudget(0){
+}
+
+//----------------------------------------------------------
+bool ofAllocationTracker::isSupported(){
+#ifdef OF_ALLOCATION_TRACKING
+	return true;
+#else
+	return false;
+#endif
+}
+
+//----------------------------------------------------------
+void ofAllocationTracker::setEnabled(bool enable){
+	if(enable && !isSupported()){
+		ofLogWarning("ofAllocationTracker") << "setEnabled(): openFrameworks wasn't built with OF_ALLOCATION_TRACKING, no allocations will be counted";
+	}
+	enabled = enable;
+}
+
+//----------------------------------------------------------
+bool ofAllocationTracker::isEnabled() const{
+	return enabled.load(memory_order_relaxed);
+}
+
+//----------------------------------------------------------
+void ofAllocationTracker::setFrameBudget(uint64_t allocations){
+	lock_guard<std::mutex> lock(mutex);
+	frameBudget = allocations;
+	framesOverBudget = 0;
+}
+
+//----------------------------------------------------------
+uint64_t ofAllocationTracker::getFrameBudget() const{
+	lock_guard<std::mutex> lock(mutex);
+	return frameBudget;
+}
+
+//----------------------------------------------------------
+void ofAllocationTracker::newFrame(){
+	if(!isEnabled()){
+		return;
+	}
+	lock_guard<std::mutex> lock(mutex);
+	lastFrame = Counts();
+	auto threads = usedThreadSlots();
+	for(size_t i = 0; i < threads; i++){
+		Counts total;
+		total.allocations = threadCounters[i].allocations.load(memory_order_relaxed);
+		total.bytes = threadCounters[i].bytes.load(memory_order_relaxed);
+		lastFramePerThread[i].allocations = total.allocations - frameStart[i].allocations;
+		lastFramePerThread[i].bytes = total.bytes - frameStart[i].bytes;
+		lastFrame.allocations += lastFramePerThread[i].allocations;
+		lastFrame.bytes += lastFramePerThread[i].bytes;
+		frameStart[i] = total;
+	}
+
+	if(frameBudget > 0 && lastFrame.allocations > frameBudget){
+		framesOverBudget++;
+		auto now = chrono::steady_clock::now();
+		if(now - lastWarning > chrono::seconds(1)){
+			ofLogWarning("ofAllocationTracker") << "last frame allocated " << lastFrame.allocations << " times, "
+				<< lastFrame.bytes << " bytes, over the budget of " << frameBudget << " allocations. "
+				<< framesOverBudget << " frames over budget since the last warning";
+			framesOverBudget = 0;
+			lastWarning = now;
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofAllocationTracker::Counts ofAllocationTracker::getLastFrame() const{
+	lock_guard<std::mutex> lock(mutex);
+	return lastFrame;
+}
+
+//----------------------------------------------------------
+vector<ofAllocationTracker::Counts> ofAllocationTracker::getLastFramePerThread() const{
+	lock_guard<std::mutex> lock(mutex);
+	return vector<Counts>(lastFramePerThread.begin(), lastFramePerThread.begin() + usedThreadSlots());
+}
+
+//----------------------------------------------------------
+ofAllocationTracker::Counts ofAllocationTracker::getTotal() const{
+	Counts total;
+	auto threads = usedThreadSlots();
+	for(size_t i = 0; i < threads; i++){
+		total.allocations += threadCounters[i].allocations.load(memory_order_relaxed);
+		total.bytes += threadCounters[i].bytes.load(memory_order_relaxed);
+	}
+	return total;
+}
+
+//----------------------------------------------------------
+ofAllocationTracker::Counts ofAllocationTracker::getThreadTotal(){
+	Counts total;
+	total.allocations = threadAllocations;
+	total.bytes = threadBytes;
+	return total;
+}
+
+//----------------------------------------------------------
+ofAllocationTracker & ofGetAllocationTracker(){
+	static ofAllocationTracker tracker;
+	return tracker;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <vector>
+
+/// \brief Counts the heap allocations of each frame and of each thread.
+///
+/// The counting replaces the global operator new and delete, so it's only
+/// compiled in when openFrameworks is built with OF_ALLOCATION_TRACKING
+/// defined, isSupported() tells if it was. Even then it's disabled until
+/// setEnabled(true):
+///
+/// ~~~~{.cpp}
+/// ofGetAllocationTracker().setEnabled(true);
+/// // warn when a frame allocates more than 100 times
+/// ofGetAllocationTracker().setFrameBudget(100);
+/// ~~~~
+///
+/// While enabled, ofProfiler scopes also record the allocations done by
+/// their thread inside them, so the overlay and the traces show where the
+/// allocations of a frame come from.
+///
+/// Counting is a few relaxed atomic increments per allocation, nothing is
+/// allocated or locked inside operator new. Threads are counted separately
+/// up to maxThreads, any thread after that is counted with the last one.
+class ofAllocationTracker{
+public:
+	static const std::size_t maxThreads = 64;
+
+	struct Counts{
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;	///< bytes requested, frees aren't subtracted
+	};
+
+	ofAllocationTracker();
+
+	ofAllocationTracker(const ofAllocationTracker &) = delete;
+	ofAllocationTracker & operator=(const ofAllocationTracker &) = delete;
+
+	/// \brief If the allocation hooks were compiled in with
+	/// OF_ALLOCATION_TRACKING
+	static bool isSupported();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	/// \brief Warn when a frame allocates more times than this, over all
+	/// the threads, 0, the default, disables the warning
+	///
+	/// The warning is logged at most once per second with the number of
+	/// frames over the budget since the last one.
+	void setFrameBudget(uint64_t allocations);
+	uint64_t getFrameBudget() const;
+
+	/// \brief Marks the start of a new frame, called by ofMainLoop
+	void newFrame();
+
+	/// \brief Allocations of all the threads during the last frame
+	Counts getLastFrame() const;
+
+	/// \brief Allocations of each thread during the last frame, indexed by
+	/// the order in which the threads first allocated while enabled
+	std::vector<Counts> getLastFramePerThread() const;
+
+	/// \brief Allocations of all the threads while enabled
+	Counts getTotal() const;
+
+	/// \brief Allocations of the calling thread while enabled
+	static Counts getThreadTotal();
+
+private:
+	mutable std::mutex mutex;
+	Counts lastFrame;
+	std::vector<Counts> lastFramePerThread;
+	std::vector<Counts> frameStart;	///< totals of each thread at the start of the frame
+	uint64_t frameBudget;
+	uint64_t framesOverBudget;
+	std::chrono::steady_clock::time_point lastWarning;
+};
+
+/// \brief The allocation tracker used by ofMainLoop
+ofAllocationTracker & ofGetAllocationTracker();
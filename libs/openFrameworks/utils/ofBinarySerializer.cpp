@@ -0,0 +1,356 @@
+#include "ofBinarySerializer.h"
+#include "ofLog.h"
+#include <cstring>
+
+using namespace std;
+
+namespace{
+	// 'ofPB' in the byte order of the machine that saved the data, reads
+	// back reversed on a machine with the other order
+	const uint32_t magic = uint32_t('o') | uint32_t('f') << 8 | uint32_t('P') << 16 | uint32_t('B') << 24;
+	const uint32_t swappedMagic = uint32_t('B') | uint32_t('P') << 8 | uint32_t('f') << 16 | uint32_t('o') << 24;
+	const uint8_t version = 1;
+
+	// the type of each value in the data, never change the existing ones
+	enum Kind: uint8_t{
+		Group = 0,
+		Int = 1,
+		Int64 = 2,
+		Float = 3,
+		Double = 4,
+		Bool = 5,
+		Vec2 = 6,
+		Vec3 = 7,
+		Vec4 = 8,
+		Color = 9,
+		ShortColor = 10,
+		FloatColor = 11,
+		String = 12, // std::string and any other type as its toString()
+		NumKinds
+	};
+
+	Kind kindOf(const ofAbstractParameter & parameter){
+		auto type = parameter.type();
+		if(type == typeid(ofParameterGroup).name()) return Group;
+		if(type == typeid(ofParameter<int>).name()) return Int;
+		if(type == typeid(ofParameter<int64_t>).name()) return Int64;
+		if(type == typeid(ofParameter<float>).name()) return Float;
+		if(type == typeid(ofParameter<double>).name()) return Double;
+		if(type == typeid(ofParameter<bool>).name()) return Bool;
+		if(type == typeid(ofParameter<glm::vec2>).name()) return Vec2;
+		if(type == typeid(ofParameter<glm::vec3>).name()) return Vec3;
+		if(type == typeid(ofParameter<glm::vec4>).name()) return Vec4;
+		if(type == typeid(ofParameter<ofColor>).name()) return Color;
+		if(type == typeid(ofParameter<ofShortColor>).name()) return ShortColor;
+		if(type == typeid(ofParameter<ofFloatColor>).name()) return FloatColor;
+		return String;
+	}
+
+	size_t sizeOf(Kind kind){
+		switch(kind){
+		case Int: return sizeof(int32_t);
+		case Int64: return sizeof(int64_t);
+		case Float: return sizeof(float);
+		case Double: return sizeof(double);
+		case Bool: return sizeof(uint8_t);
+		case Vec2: return sizeof(float) * 2;
+		case Vec3: return sizeof(float) * 3;
+		case Vec4: return sizeof(float) * 4;
+		case Color: return sizeof(unsigned char) * 4;
+		case ShortColor: return sizeof(unsigned short) * 4;
+		case FloatColor: return sizeof(float) * 4;
+		default: return 0;
+		}
+	}
+
+	template<typename T>
+	void write(ofBuffer & buffer, const T & value){
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	void writeValue(ofBuffer & buffer, const ofAbstractParameter & parameter){
+		write(buffer, parameter.cast<T>().get());
+	}
+
+	template<typename Color>
+	void writeColor(ofBuffer & buffer, const ofAbstractParameter & parameter){
+		const Color & color = parameter.cast<Color>().get();
+		write(buffer, color.r);
+		write(buffer, color.g);
+		write(buffer, color.b);
+		write(buffer, color.a);
+	}
+
+	void serialize(ofBuffer & buffer, const ofAbstractParameter & parameter){
+		Kind kind = kindOf(parameter);
+		string name = parameter.getEscapedName();
+		if(name.size() > numeric_limits<uint16_t>::max()){
+			name.resize(numeric_limits<uint16_t>::max());
+		}
+		write(buffer, uint8_t(kind));
+		write(buffer, uint16_t(name.size()));
+		buffer.append(name.data(), name.size());
+
+		switch(kind){
+		case Group:{
+			const ofParameterGroup & group = static_cast<const ofParameterGroup &>(parameter);
+			uint32_t numSerializable = 0;
+			for(auto & p: group){
+				numSerializable += p->isSerializable();
+			}
+			write(buffer, numSerializable);
+			for(auto & p: group){
+				if(p->isSerializable()){
+					serialize(buffer, *p);
+				}
+			}
+		}break;
+		case Int: write(buffer, int32_t(parameter.cast<int>().get())); break;
+		case Int64: writeValue<int64_t>(buffer, parameter); break;
+		case Float: writeValue<float>(buffer, parameter); break;
+		case Double: writeValue<double>(buffer, parameter); break;
+		case Bool: write(buffer, uint8_t(parameter.cast<bool>().get())); break;
+		case Vec2: writeValue<glm::vec2>(buffer, parameter); break;
+		case Vec3: writeValue<glm::vec3>(buffer, parameter); break;
+		case Vec4: writeValue<glm::vec4>(buffer, parameter); break;
+		case Color: writeColor<ofColor>(buffer, parameter); break;
+		case ShortColor: writeColor<ofShortColor>(buffer, parameter); break;
+		case FloatColor: writeColor<ofFloatColor>(buffer, parameter); break;
+		default:{
+			string value;
+			if(parameter.type() == typeid(ofParameter<string>).name()){
+				value = parameter.cast<string>().get();
+			}else{
+				value = parameter.toString();
+			}
+			write(buffer, uint32_t(value.size()));
+			buffer.append(value.data(), value.size());
+		}break;
+		}
+	}
+
+	struct Reader{
+		const char * data;
+		size_t size;
+		size_t pos;
+
+		template<typename T>
+		bool read(T & value){
+			if(size - pos < sizeof(T)){
+				return false;
+			}
+			memcpy(&value, data + pos, sizeof(T));
+			pos += sizeof(T);
+			return true;
+		}
+
+		bool read(string & value, size_t length){
+			if(size - pos < length){
+				return false;
+			}
+			value.assign(data + pos, length);
+			pos += length;
+			return true;
+		}
+
+		bool skip(size_t length){
+			if(size - pos < length){
+				return false;
+			}
+			pos += length;
+			return true;
+		}
+	};
+
+	bool readHeader(Reader & reader, Kind & kind, string & name){
+		uint8_t k;
+		uint16_t nameSize;
+		if(!reader.read(k) || !reader.read(nameSize) || !reader.read(name, nameSize) || k >= NumKinds){
+			return false;
+		}
+		kind = Kind(k);
+		return true;
+	}
+
+	bool skip(Reader & reader, Kind kind){
+		if(kind == Group){
+			uint32_t numChildren;
+			if(!reader.read(numChildren)){
+				return false;
+			}
+			string name;
+			for(uint32_t i = 0; i < numChildren; i++){
+				Kind childKind;
+				if(!readHeader(reader, childKind, name) || !skip(reader, childKind)){
+					return false;
+				}
+			}
+			return true;
+		}else if(kind == String){
+			uint32_t length;
+			return reader.read(length) && reader.skip(length);
+		}else{
+			return reader.skip(sizeOf(kind));
+		}
+	}
+
+	// only sets parameters whose value changed so listeners aren't
+	// notified for every parameter on each snapshot
+	template<typename T, typename Stored = T>
+	bool readValue(Reader & reader, ofAbstractParameter & parameter){
+		Stored value;
+		if(!reader.read(value)){
+			return false;
+		}
+		auto & p = parameter.cast<T>();
+		if(p.get() != T(value)){
+			p.set(T(value));
+		}
+		return true;
+	}
+
+	template<typename Color>
+	bool readColor(Reader & reader, ofAbstractParameter & parameter){
+		Color color;
+		if(!reader.read(color.r) || !reader.read(color.g) || !reader.read(color.b) || !reader.read(color.a)){
+			return false;
+		}
+		auto & p = parameter.cast<Color>();
+		if(p.get() != color){
+			p.set(color);
+		}
+		return true;
+	}
+
+	bool deserialize(Reader & reader, Kind kind, ofAbstractParameter * parameter){
+		if(!parameter || !parameter->isSerializable()){
+			return skip(reader, kind);
+		}
+		Kind parameterKind = kindOf(*parameter);
+		if(kind != parameterKind && !(kind == String && parameterKind != Group)){
+			ofLogVerbose("ofDeserialize") << "skipping " << parameter->getName() << ", its type changed since it was saved";
+			return skip(reader, kind);
+		}
+
+		switch(kind){
+		case Group:{
+			ofParameterGroup & group = static_cast<ofParameterGroup &>(*parameter);
+			uint32_t numChildren;
+			if(!reader.read(numChildren)){
+				return false;
+			}
+			bool ok = true;
+			string name;
+			group.beginBatch();
+			for(uint32_t i = 0; i < numChildren && ok; i++){
+				Kind childKind;
+				if(!readHeader(reader, childKind, name)){
+					ok = false;
+					break;
+				}
+				// most of the time the group hasn't changed since it was
+				// saved and the child is at the same position
+				ofAbstractParameter * child = nullptr;
+				if(i < group.size() && group.get(i).getEscapedName() == name){
+					child = &group.get(i);
+				}else{
+					int position = group.getPosition(name);
+					if(position >= 0){
+						child = &group.get(position);
+					}
+				}
+				ok = deserialize(reader, childKind, child);
+			}
+			group.endBatch();
+			return ok;
+		}
+		case Int: return readValue<int, int32_t>(reader, *parameter);
+		case Int64: return readValue<int64_t>(reader, *parameter);
+		case Float: return readValue<float>(reader, *parameter);
+		case Double: return readValue<double>(reader, *parameter);
+		case Vec2: return readValue<glm::vec2>(reader, *parameter);
+		case Vec3: return readValue<glm::vec3>(reader, *parameter);
+		case Vec4: return readValue<glm::vec4>(reader, *parameter);
+		case Color: return readColor<ofColor>(reader, *parameter);
+		case ShortColor: return readColor<ofShortColor>(reader, *parameter);
+		case FloatColor: return readColor<ofFloatColor>(reader, *parameter);
+		case Bool:{
+			uint8_t value;
+			if(!reader.read(value)){
+				return false;
+			}
+			auto & p = parameter->cast<bool>();
+			if(p.get() != (value != 0)){
+				p.set(value != 0);
+			}
+			return true;
+		}
+		default:{
+			uint32_t length;
+			string value;
+			if(!reader.read(length) || !reader.read(value, length)){
+				return false;
+			}
+			if(parameterKind != String){
+				// a type this version doesn't store as binary yet
+				parameter->fromString(value);
+			}else if(parameter->type() == typeid(ofParameter<string>).name()){
+				auto & p = parameter->cast<string>();
+				if(p.get() != value){
+					p.set(value);
+				}
+			}else if(parameter->toString() != value){
+				parameter->fromString(value);
+			}
+			return true;
+		}
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofSerialize(ofBuffer & buffer, const ofAbstractParameter & parameter){
+	buffer.clear();
+	write(buffer, magic);
+	write(buffer, version);
+	serialize(buffer, parameter);
+}
+
+//----------------------------------------------------------
+bool ofDeserialize(const ofBuffer & buffer, ofAbstractParameter & parameter){
+	return ofDeserialize(buffer.getData(), buffer.size(), parameter);
+}
+
+//----------------------------------------------------------
+bool ofDeserialize(const char * data, size_t size, ofAbstractParameter & parameter){
+	Reader reader{data, size, 0};
+	uint32_t dataMagic;
+	uint8_t dataVersion;
+	if(!reader.read(dataMagic) || (dataMagic != magic && dataMagic != swappedMagic)){
+		ofLogError("ofDeserialize") << "not a binary parameters snapshot";
+		return false;
+	}
+	if(dataMagic == swappedMagic){
+		ofLogError("ofDeserialize") << "the parameters were saved on a machine with a different byte order";
+		return false;
+	}
+	if(!reader.read(dataVersion)){
+		ofLogError("ofDeserialize") << "parameters snapshot is truncated or corrupt";
+		return false;
+	}
+	if(dataVersion > version){
+		ofLogError("ofDeserialize") << "unsupported parameters snapshot version " << int(dataVersion);
+		return false;
+	}
+
+	// the name of the root isn't checked so a snapshot can be loaded into
+	// a group with a different name
+	Kind kind;
+	string name;
+	if(!readHeader(reader, kind, name) || !deserialize(reader, kind, &parameter)){
+		ofLogError("ofDeserialize") << "parameters snapshot is truncated or corrupt";
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofFileUtils.h"
+#include "ofParameter.h"
+
+/// \brief Compact binary serialization of parameters
+///
+/// Meant for snapshots that are taken very often, every frame for undo or
+/// to send the state over the network, where ofXml and ofJson are too slow
+/// and too big. Numbers, vectors and colors are stored as their raw bytes
+/// in the byte order of the machine that saved them, any other type as its
+/// toString(). The format is versioned and values are looked up by name
+/// when loading, so parameters added or removed since the snapshot was
+/// taken are skipped:
+///
+/// ~~~~{.cpp}
+/// ofBuffer snapshot;
+/// ofSerialize(snapshot, parameters);
+/// ...
+/// ofDeserialize(snapshot, parameters);
+/// ~~~~
+///
+/// The buffer is cleared first so it can be reused for every snapshot
+/// without allocating.
+void ofSerialize(ofBuffer & buffer, const ofAbstractParameter & parameter);
+
+/// \brief Loads a snapshot saved with ofSerialize(ofBuffer&,...)
+///
+/// Groups are loaded inside a beginBatch()/endBatch() so their listeners
+/// are notified once for the whole snapshot.
+/// \returns false if the data is not a valid snapshot or was saved on a
+/// machine with a different byte order
+bool ofDeserialize(const ofBuffer & buffer, ofAbstractParameter & parameter);
+
+/// \brief Same as ofDeserialize(const ofBuffer&,...) for data from
+/// anywhere else, like an ofMappedBuffer or a network packet
+bool ofDeserialize(const char * data, std::size_t size, ofAbstractParameter & parameter);
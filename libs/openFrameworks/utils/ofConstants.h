@@ -22,6 +22,16 @@ enum ofLoopType{
 	OF_LOOP_NORMAL=0x03
 };
 
+/// \brief How precise an asynchronous seek is.
+///
+/// \sa ofVideoPlayer::setFrameAsync()
+enum ofVideoSeekMode{
+	/// \brief Decodes up to the exact frame requested.
+	OF_VIDEO_SEEK_ACCURATE,
+	/// \brief Lands on the closest keyframe, much faster but not exact.
+	OF_VIDEO_SEEK_KEYFRAME
+};
+
 /// \brief This enumerates the targeted operating systems or platforms.
 enum ofTargetPlatform{
 	/// \brief 32- and 64-bit x86 architecture on Mac OSX.
@@ -138,7 +148,10 @@ enum ofTargetPlatform{
 #elif defined(__EMSCRIPTEN__)
 	#define TARGET_EMSCRIPTEN
 	#define TARGET_OPENGLES
-	#define TARGET_NO_THREADS
+	// EMSCRIPTEN_THREADS=1 builds with -pthread
+	#ifndef __EMSCRIPTEN_PTHREADS__
+		#define TARGET_NO_THREADS
+	#endif
 	#define TARGET_PROGRAMMABLE_GL
 	#define TARGET_IMPLEMENTS_URL_LOADER
 #else
@@ -279,6 +292,9 @@ enum ofTargetPlatform{
 #ifdef TARGET_EMSCRIPTEN
 	#include <GLES2/gl2.h>
 	#include <GLES2/gl2ext.h>
+	// WebGL 2, its functions can only be called once the window
+	// created an OpenGL ES 3 context
+	#include <GLES3/gl3.h>
 	#include "EGL/egl.h"
 	#include "EGL/eglext.h"
 
@@ -348,7 +364,7 @@ typedef TESSindex ofIndexType;
 
 //------------------------------------------------  video player
 // check if any video player system is already defined from the compiler
-#if !defined(OF_VIDEO_PLAYER_GSTREAMER) && !defined(OF_VIDEO_PLAYER_IOS) && !defined(OF_VIDEO_PLAYER_DIRECTSHOW) && !defined(OF_VIDEO_PLAYER_QUICKTIME) && !defined(OF_VIDEO_PLAYER_AVFOUNDATION) && !defined(OF_VIDEO_PLAYER_EMSCRIPTEN)
+#if !defined(OF_VIDEO_PLAYER_GSTREAMER) && !defined(OF_VIDEO_PLAYER_IOS) && !defined(OF_VIDEO_PLAYER_DIRECTSHOW) && !defined(OF_VIDEO_PLAYER_MEDIA_FOUNDATION) && !defined(OF_VIDEO_PLAYER_QUICKTIME) && !defined(OF_VIDEO_PLAYER_AVFOUNDATION) && !defined(OF_VIDEO_PLAYER_EMSCRIPTEN)
     #ifdef TARGET_LINUX
         #define OF_VIDEO_PLAYER_GSTREAMER
     #elif defined(TARGET_ANDROID)
@@ -356,7 +372,7 @@ typedef TESSindex ofIndexType;
     #elif defined(TARGET_OF_IOS)
         #define OF_VIDEO_PLAYER_IOS
 	#elif defined(TARGET_WIN32)
-        #define OF_VIDEO_PLAYER_DIRECTSHOW
+        #define OF_VIDEO_PLAYER_MEDIA_FOUNDATION
     #elif defined(TARGET_OSX)
         //for 10.8 and 10.9 users we use AVFoundation, for 10.7 we use QTKit, for 10.6 users we use QuickTime
         #ifndef MAC_OS_X_VERSION_10_7
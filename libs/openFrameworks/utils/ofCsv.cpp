@@ -0,0 +1,350 @@
+#include "ofCsv.h"
+#include "ofLog.h"
+#ifndef TARGET_NO_THREADS
+#include "ofTaskPool.h"
+#endif
+
+using namespace std;
+
+namespace{
+	// files smaller than this are parsed in the calling thread
+	const size_t minParallelSize = 1 << 20;
+}
+
+struct ofCsvTable::Chunk{
+	vector<ofStringRange> fields;
+	vector<vector<double>> numbers;
+	vector<bool> numeric;
+	size_t numRows = 0;
+};
+
+//----------------------------------------------------------
+ofCsvTable::Settings::Settings()
+:delimiter(',')
+,quote('"')
+,header(true)
+,parallel(true){}
+
+//----------------------------------------------------------
+ofCsvTable::ofCsvTable()
+:data(nullptr)
+,length(0)
+,numColumns(0)
+,numRows(0){}
+
+//----------------------------------------------------------
+bool ofCsvTable::load(const std::filesystem::path & file, bool bRelativeToData){
+	Settings settings;
+	if(ofToLower(file.extension().string()) == ".tsv"){
+		settings.delimiter = '\t';
+	}
+	return load(file, settings, bRelativeToData);
+}
+
+//----------------------------------------------------------
+bool ofCsvTable::load(const std::filesystem::path & file, const Settings & settings, bool bRelativeToData){
+	clear();
+	if(!this->file.open(file, bRelativeToData)){
+		ofLogError("ofCsvTable") << "load(): couldn't open " << file;
+		return false;
+	}
+	data = this->file.getData();
+	length = this->file.size();
+	this->settings = settings;
+	return parseTable();
+}
+
+//----------------------------------------------------------
+bool ofCsvTable::parse(const ofBuffer & buffer, const Settings & settings){
+	return parse(buffer.getData(), buffer.size(), settings);
+}
+
+//----------------------------------------------------------
+bool ofCsvTable::parse(const char * data, size_t size, const Settings & settings){
+	clear();
+	this->data = data;
+	length = data ? size : 0;
+	this->settings = settings;
+	return parseTable();
+}
+
+//----------------------------------------------------------
+void ofCsvTable::clear(){
+	file.close();
+	data = nullptr;
+	length = 0;
+	numColumns = 0;
+	numRows = 0;
+	names.clear();
+	columns.clear();
+	fields.clear();
+}
+
+//----------------------------------------------------------
+const char * ofCsvTable::parseRow(const char * pos, const char * end, vector<ofStringRange> & row) const{
+	row.clear();
+	char delimiter = settings.delimiter;
+	char quote = settings.quote;
+	while(true){
+		const char * fieldBegin;
+		const char * fieldEnd;
+		if(quote && pos < end && *pos == quote){
+			fieldBegin = ++pos;
+			for(; pos < end; pos++){
+				if(*pos == quote){
+					if(pos + 1 < end && pos[1] == quote){
+						pos++;
+					}else{
+						break;
+					}
+				}
+			}
+			fieldEnd = pos;
+			// anything between the closing quote and the delimiter is ignored
+			for(; pos < end && *pos != delimiter && *pos != '\n'; pos++);
+		}else{
+			fieldBegin = pos;
+			for(; pos < end && *pos != delimiter && *pos != '\n'; pos++);
+			fieldEnd = pos;
+			if(fieldEnd != fieldBegin && *(fieldEnd - 1) == '\r' && (pos == end || *pos == '\n')){
+				fieldEnd--;
+			}
+		}
+		row.emplace_back(fieldBegin, fieldEnd - fieldBegin);
+		if(pos < end && *pos == delimiter){
+			pos++;
+			continue;
+		}
+		return pos < end ? pos + 1 : end;
+	}
+}
+
+//----------------------------------------------------------
+void ofCsvTable::parseChunk(const char * begin, const char * end, Chunk & chunk) const{
+	chunk.numbers.resize(numColumns);
+	chunk.numeric.assign(numColumns, true);
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	vector<ofStringRange> row;
+	const char * pos = begin;
+	while(pos < end){
+		// empty lines aren't rows
+		if(*pos == '\n' || (*pos == '\r' && pos + 1 < end && pos[1] == '\n')){
+			pos += *pos == '\n' ? 1 : 2;
+			continue;
+		}
+		pos = parseRow(pos, end, row);
+		row.resize(numColumns);
+		for(size_t column = 0; column < numColumns; column++){
+			const ofStringRange & field = row[column];
+			chunk.fields.push_back(field);
+			if(!chunk.numeric[column]){
+				continue;
+			}
+			double value;
+			if(field.trimmed().empty()){
+				chunk.numbers[column].push_back(nan);
+			}else if(ofParse(field, value)){
+				chunk.numbers[column].push_back(value);
+			}else{
+				chunk.numeric[column] = false;
+				vector<double>().swap(chunk.numbers[column]);
+			}
+		}
+		chunk.numRows++;
+	}
+}
+
+//----------------------------------------------------------
+vector<const char *> ofCsvTable::findChunks(const char * begin, const char * end, size_t numChunks) const{
+	// chunks have to start at the beginning of a row, a new line inside
+	// quotes isn't one so if there are any quotes they have to be counted
+	// from the start
+	vector<const char *> chunks{begin};
+	size_t chunkSize = (end - begin) / numChunks;
+	bool quoted = settings.quote && memchr(begin, settings.quote, end - begin);
+	if(!quoted){
+		for(size_t i = 1; i < numChunks; i++){
+			const char * target = max(begin + i * chunkSize, chunks.back());
+			auto newline = static_cast<const char*>(memchr(target, '\n', end - target));
+			if(!newline){
+				break;
+			}
+			if(newline + 1 < end){
+				chunks.push_back(newline + 1);
+			}
+		}
+	}else{
+		bool inQuotes = false;
+		const char * target = begin + chunkSize;
+		for(const char * pos = begin; pos < end; pos++){
+			if(*pos == settings.quote){
+				inQuotes = !inQuotes;
+			}else if(*pos == '\n' && !inQuotes && pos >= target && pos + 1 < end){
+				chunks.push_back(pos + 1);
+				target = pos + 1 + chunkSize;
+			}
+		}
+	}
+	chunks.push_back(end);
+	return chunks;
+}
+
+//----------------------------------------------------------
+bool ofCsvTable::parseTable(){
+	const char * pos = data;
+	const char * end = data + length;
+	// utf8 byte order mark
+	if(length >= 3 && memcmp(pos, "\xEF\xBB\xBF", 3) == 0){
+		pos += 3;
+	}
+	for(; pos < end && (*pos == '\n' || *pos == '\r'); pos++);
+	if(pos == end){
+		return true;
+	}
+
+	// the first row sets the number of columns
+	vector<ofStringRange> row;
+	const char * firstRow = pos;
+	pos = parseRow(pos, end, row);
+	numColumns = row.size();
+	if(settings.header){
+		for(auto & field : row){
+			names.push_back(unescape(field));
+		}
+	}else{
+		pos = firstRow;
+	}
+
+	size_t numChunks = 1;
+#ifndef TARGET_NO_THREADS
+	if(settings.parallel && size_t(end - pos) >= minParallelSize){
+		numChunks = (ofGetTaskPool().getNumThreads() + 1) * 4;
+	}
+#endif
+	auto boundaries = findChunks(pos, end, numChunks);
+	vector<Chunk> chunks(boundaries.size() - 1);
+#ifndef TARGET_NO_THREADS
+	if(chunks.size() > 1){
+		ofGetTaskPool().parallelFor(0, chunks.size(), [&](size_t first, size_t last){
+			for(size_t i = first; i < last; i++){
+				parseChunk(boundaries[i], boundaries[i + 1], chunks[i]);
+			}
+		}, 1);
+	}else
+#endif
+	if(!chunks.empty()){
+		parseChunk(boundaries[0], boundaries[1], chunks[0]);
+	}
+
+	for(auto & chunk : chunks){
+		numRows += chunk.numRows;
+	}
+	fields.reserve(numRows * numColumns);
+	for(auto & chunk : chunks){
+		fields.insert(fields.end(), chunk.fields.begin(), chunk.fields.end());
+		vector<ofStringRange>().swap(chunk.fields);
+	}
+	columns.resize(numColumns);
+	for(size_t column = 0; column < numColumns; column++){
+		Column & dst = columns[column];
+		dst.numeric = true;
+		for(auto & chunk : chunks){
+			dst.numeric &= chunk.numeric[column];
+		}
+		if(!dst.numeric){
+			continue;
+		}
+		dst.numbers.reserve(numRows);
+		for(auto & chunk : chunks){
+			dst.numbers.insert(dst.numbers.end(), chunk.numbers[column].begin(), chunk.numbers[column].end());
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+size_t ofCsvTable::getNumRows() const{
+	return numRows;
+}
+
+//----------------------------------------------------------
+size_t ofCsvTable::getNumColumns() const{
+	return numColumns;
+}
+
+//----------------------------------------------------------
+const vector<string> & ofCsvTable::getColumnNames() const{
+	return names;
+}
+
+//----------------------------------------------------------
+int ofCsvTable::getColumnIndex(const string & name) const{
+	auto it = find(names.begin(), names.end(), name);
+	return it == names.end() ? -1 : int(it - names.begin());
+}
+
+//----------------------------------------------------------
+bool ofCsvTable::isNumeric(size_t column) const{
+	return column < columns.size() && columns[column].numeric;
+}
+
+//----------------------------------------------------------
+const vector<double> & ofCsvTable::getNumbers(size_t column) const{
+	static const vector<double> empty;
+	return isNumeric(column) ? columns[column].numbers : empty;
+}
+
+//----------------------------------------------------------
+const vector<double> & ofCsvTable::getNumbers(const string & name) const{
+	int column = getColumnIndex(name);
+	if(column < 0){
+		ofLogError("ofCsvTable") << "getNumbers(): no column called " << name;
+	}
+	return getNumbers(size_t(column));
+}
+
+//----------------------------------------------------------
+vector<float> ofCsvTable::getFloats(size_t column) const{
+	auto & numbers = getNumbers(column);
+	return vector<float>(numbers.begin(), numbers.end());
+}
+
+//----------------------------------------------------------
+ofStringRange ofCsvTable::getField(size_t row, size_t column) const{
+	if(row >= numRows || column >= numColumns){
+		return ofStringRange();
+	}
+	return fields[row * numColumns + column];
+}
+
+//----------------------------------------------------------
+string ofCsvTable::getString(size_t row, size_t column) const{
+	return unescape(getField(row, column));
+}
+
+//----------------------------------------------------------
+string ofCsvTable::unescape(const ofStringRange & field) const{
+	// only quoted fields start after a quote and can have escaped ones
+	if(!settings.quote || field.data() == data || field.empty() || *(field.data() - 1) != settings.quote){
+		return field.toString();
+	}
+	string str;
+	str.reserve(field.size());
+	for(size_t i = 0; i < field.size(); i++){
+		str += field[i];
+		if(field[i] == settings.quote && i + 1 < field.size() && field[i + 1] == settings.quote){
+			i++;
+		}
+	}
+	return str;
+}
+
+//----------------------------------------------------------
+double ofCsvTable::getNumber(size_t row, size_t column, double defaultValue) const{
+	if(isNumeric(column) && row < numRows){
+		double value = columns[column].numbers[row];
+		return std::isnan(value) ? defaultValue : value;
+	}
+	double value;
+	return ofParse(getField(row, column), value) ? value : defaultValue;
+}
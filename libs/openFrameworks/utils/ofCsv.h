@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ofFileUtils.h"
+#include "ofUtils.h"
+
+/// \brief A table of comma or tab separated values, parsed in place
+///
+/// The file is memory mapped and its fields are kept as ranges pointing
+/// into it, so loading it doesn't allocate a string per field like
+/// ofSplitString on every line of getLines() would. The columns where every
+/// field is a number are converted once to a contiguous vector of doubles:
+///
+/// ~~~~{.cpp}
+/// ofCsvTable table;
+/// if(table.load("weather.csv")){
+///     auto & temperatures = table.getNumbers("temperature");
+///     for(size_t row = 0; row < table.getNumRows(); row++){
+///         plot.addVertex(row, temperatures[row]);
+///         labels.push_back(table.getString(row, 0));
+///     }
+/// }
+/// ~~~~
+///
+/// Big files are split in chunks of rows parsed in parallel by the
+/// ofTaskPool. Fields can be quoted, with "" for a quote and new lines in
+/// them, rows with less fields than the header are filled with empty ones
+/// and the fields past it are ignored.
+class ofCsvTable{
+public:
+	struct Settings{
+		Settings();
+		char delimiter;	///< ',' by default, '\t' for TSV
+		char quote;		///< '"' by default, 0 if the fields are never quoted
+		bool header;	///< true if the first row names the columns, by default
+		bool parallel;	///< parse big files on the ofTaskPool, true by default
+	};
+
+	ofCsvTable();
+
+	ofCsvTable(const ofCsvTable &) = delete;
+	ofCsvTable & operator=(const ofCsvTable &) = delete;
+	ofCsvTable(ofCsvTable &&) = default;
+	ofCsvTable & operator=(ofCsvTable &&) = default;
+
+	/// \brief Memory maps file, relative to the data folder by default, and
+	/// parses it, files ending in .tsv are tab separated
+	bool load(const std::filesystem::path & file, bool bRelativeToData = true);
+	bool load(const std::filesystem::path & file, const Settings & settings, bool bRelativeToData = true);
+
+	/// \brief Parses buffer, which has to stay alive and unchanged while the
+	/// table is used
+	bool parse(const ofBuffer & buffer, const Settings & settings = Settings());
+	bool parse(const char * data, std::size_t size, const Settings & settings = Settings());
+	void clear();
+
+	std::size_t getNumRows() const;
+	std::size_t getNumColumns() const;
+
+	/// \brief The fields of the header, or empty if there's none
+	const std::vector<std::string> & getColumnNames() const;
+	/// \returns the index of the column called name or -1
+	int getColumnIndex(const std::string & name) const;
+
+	/// \brief true if every field of the column is a number or empty
+	bool isNumeric(std::size_t column) const;
+
+	/// \brief Every value of a numeric column, NaN for the empty fields, or
+	/// an empty vector if the column has text or doesn't exist
+	const std::vector<double> & getNumbers(std::size_t column) const;
+	const std::vector<double> & getNumbers(const std::string & name) const;
+	/// \brief A copy of the numbers of a column as floats, to upload them
+	std::vector<float> getFloats(std::size_t column) const;
+
+	/// \brief The field as it is in the file, without the quotes around it
+	ofStringRange getField(std::size_t row, std::size_t column) const;
+	/// \brief The field with its escaped quotes decoded
+	std::string getString(std::size_t row, std::size_t column) const;
+	/// \brief The field as a number, defaultValue if it isn't one
+	double getNumber(std::size_t row, std::size_t column, double defaultValue = 0) const;
+
+private:
+	struct Column{
+		bool numeric;
+		std::vector<double> numbers;
+	};
+	struct Chunk;
+
+	bool parseTable();
+	const char * parseRow(const char * pos, const char * end, std::vector<ofStringRange> & row) const;
+	void parseChunk(const char * begin, const char * end, Chunk & chunk) const;
+	std::string unescape(const ofStringRange & field) const;
+	std::vector<const char *> findChunks(const char * begin, const char * end, std::size_t numChunks) const;
+
+	ofMappedBuffer file;
+	const char * data;
+	std::size_t length;
+	Settings settings;
+
+	std::size_t numColumns;
+	std::size_t numRows;
+	std::vector<std::string> names;
+	std::vector<Column> columns;
+	// row by row, numColumns per row
+	std::vector<ofStringRange> fields;
+};
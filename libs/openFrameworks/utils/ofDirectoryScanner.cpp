@@ -0,0 +1,193 @@
+#include "ofDirectoryScanner.h"
+#include "ofTaskPool.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------------------------------------------
+ofFile ofDirectoryScanner::Entry::getFile(ofFile::Mode mode, bool binary) const{
+	ofFile file;
+	file.openFromCWD(path, mode, binary);
+	return file;
+}
+
+//------------------------------------------------------------------------------------------------------------
+ofDirectoryScanner::~ofDirectoryScanner(){
+	for(auto & scan: pending){
+		scan.wait();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------
+void ofDirectoryScanner::addPending(std::shared_future<void> scan){
+	pending.erase(remove_if(pending.begin(), pending.end(), [](const std::shared_future<void> & scan){
+		return scan.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}), pending.end());
+	pending.push_back(scan);
+}
+
+//------------------------------------------------------------------------------------------------------------
+void ofDirectoryScanner::setup(const Settings & _settings){
+	std::unique_lock<std::mutex> lock(mutex);
+	settings = _settings;
+	if(settings.relativeToData){
+		settings.path = ofToDataPath(settings.path, true);
+	}
+	for(auto & extension: settings.extensions){
+		extension = ofToLower(extension);
+		if(!extension.empty() && extension[0] == '.'){
+			extension = extension.substr(1);
+		}
+	}
+	cache.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------
+const ofDirectoryScanner::Settings & ofDirectoryScanner::getSettings() const{
+	return settings;
+}
+
+//------------------------------------------------------------------------------------------------------------
+bool ofDirectoryScanner::accept(const Entry & entry) const{
+	return !settings.filter || settings.filter(entry);
+}
+
+//------------------------------------------------------------------------------------------------------------
+ofDirectoryScanner::Directory ofDirectoryScanner::listDirectory(const std::filesystem::path & path, const Directory * cached) const{
+	Directory directory;
+	try{
+		directory.lastWriteTime = std::filesystem::last_write_time(path);
+	}catch(std::exception & e){
+		ofLogError("ofDirectoryScanner") << "couldn't read \"" << path.string() << "\": " << e.what();
+		return directory;
+	}
+	if(cached && cached->lastWriteTime == directory.lastWriteTime){
+		return *cached;
+	}
+
+	try{
+		for(std::filesystem::directory_iterator it(path), end; it != end; ++it){
+			auto & entryPath = it->path();
+			auto name = entryPath.filename().string();
+#ifndef TARGET_WIN32
+			if(!settings.showHidden && !name.empty() && name[0] == '.'){
+				continue;
+			}
+#endif
+			Entry entry;
+			entry.path = entryPath;
+			try{
+				auto status = it->symlink_status();
+				if(std::filesystem::is_symlink(status)){
+					status = it->status();
+					if(std::filesystem::is_directory(status)){
+						continue;
+					}
+				}
+				entry.isDirectory = std::filesystem::is_directory(status);
+				if(entry.isDirectory){
+					if(settings.recursive){
+						directory.subdirectories.push_back(entryPath);
+					}
+					if(!settings.includeDirectories){
+						continue;
+					}
+				}else{
+					if(!std::filesystem::is_regular_file(status)){
+						continue;
+					}
+					entry.extension = ofToLower(ofFilePath::getFileExt(entryPath));
+					if(!settings.extensions.empty() &&
+					   find(settings.extensions.begin(), settings.extensions.end(), entry.extension) == settings.extensions.end()){
+						// rejected before touching the file's metadata
+						continue;
+					}
+					entry.size = std::filesystem::file_size(entryPath);
+				}
+				entry.lastWriteTime = std::filesystem::last_write_time(entryPath);
+			}catch(std::exception & e){
+				ofLogWarning("ofDirectoryScanner") << "skipping \"" << entryPath.string() << "\": " << e.what();
+				continue;
+			}
+			if(accept(entry)){
+				directory.entries.push_back(std::move(entry));
+			}
+		}
+	}catch(std::exception & e){
+		ofLogError("ofDirectoryScanner") << "couldn't list \"" << path.string() << "\": " << e.what();
+	}
+	return directory;
+}
+
+//------------------------------------------------------------------------------------------------------------
+vector<ofDirectoryScanner::Entry> ofDirectoryScanner::scan(){
+	std::unique_lock<std::mutex> lock(mutex);
+	numScanning++;
+	vector<Entry> entries;
+	if(!std::filesystem::is_directory(settings.path)){
+		ofLogError("ofDirectoryScanner") << "scan(): \"" << settings.path.string() << "\" is not a directory";
+		numScanning--;
+		return entries;
+	}
+
+	// breadth first, all the directories of a level at once. the cache is
+	// rebuilt with the directories found so removed ones are dropped
+	unordered_map<string, Directory> nextCache;
+	vector<std::filesystem::path> level{settings.path};
+	while(!level.empty()){
+		vector<Directory> listed(level.size());
+		ofGetTaskPool().parallelFor(0, level.size(), [&](size_t begin, size_t end){
+			for(size_t i = begin; i < end; i++){
+				auto cached = cache.find(level[i].string());
+				listed[i] = listDirectory(level[i], cached != cache.end() ? &cached->second : nullptr);
+			}
+		}, 1);
+
+		vector<std::filesystem::path> nextLevel;
+		for(size_t i = 0; i < level.size(); i++){
+			entries.insert(entries.end(), listed[i].entries.begin(), listed[i].entries.end());
+			nextLevel.insert(nextLevel.end(), listed[i].subdirectories.begin(), listed[i].subdirectories.end());
+			nextCache[level[i].string()] = std::move(listed[i]);
+		}
+		level.swap(nextLevel);
+	}
+	cache.swap(nextCache);
+
+	ofSort(entries, [](const Entry & a, const Entry & b){
+		return a.path.native() < b.path.native();
+	});
+	numScanning--;
+	return entries;
+}
+
+//------------------------------------------------------------------------------------------------------------
+std::future<vector<ofDirectoryScanner::Entry>> ofDirectoryScanner::scanAsync(){
+	auto promise = make_shared<std::promise<vector<Entry>>>();
+	auto future = promise->get_future();
+	addPending(ofGetTaskPool().submit([this, promise]{
+		promise->set_value(scan());
+	}).share());
+	return future;
+}
+
+//------------------------------------------------------------------------------------------------------------
+void ofDirectoryScanner::scanAsync(std::function<void(vector<Entry> & entries)> done){
+	addPending(ofGetTaskPool().submit([this, done]{
+		auto entries = make_shared<vector<Entry>>(scan());
+		ofTaskPool::runOnMainThread([done, entries]{
+			done(*entries);
+		});
+	}).share());
+}
+
+//------------------------------------------------------------------------------------------------------------
+bool ofDirectoryScanner::isScanning() const{
+	return numScanning > 0;
+}
+
+//------------------------------------------------------------------------------------------------------------
+void ofDirectoryScanner::clearCache(){
+	std::unique_lock<std::mutex> lock(mutex);
+	cache.clear();
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "ofFileUtils.h"
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+/// \brief Lists a whole directory tree in parallel, keeping the metadata
+/// of every file
+///
+/// The directories of each level of the tree are listed at the same time
+/// over the threads of ofGetTaskPool(), which mostly helps with slow or
+/// network drives where every listing waits on the disk. Files are
+/// filtered while traversing, so rejected files are never turned into
+/// ofFile objects.
+///
+/// ~~~~{.cpp}
+/// ofDirectoryScanner::Settings settings;
+/// settings.path = "/media/library";
+/// settings.relativeToData = false;
+/// settings.extensions = {"jpg", "png", "mov"};
+/// scanner.setup(settings);
+///
+/// scanner.scanAsync([this](std::vector<ofDirectoryScanner::Entry> & entries){
+///     // in the main thread
+///     library = std::move(entries);
+/// });
+/// ~~~~
+///
+/// The scanner remembers the modification time of every directory it
+/// listed. Scanning again only lists the directories that changed since,
+/// the files of the rest come from the last scan. Adding, removing or
+/// renaming a file changes its directory's modification time but writing
+/// to an existing file doesn't, so the size and time of modified files
+/// are only updated when their directory changes or after clearCache().
+///
+/// Symbolic links to directories aren't followed, to avoid loops.
+class ofDirectoryScanner{
+public:
+	struct Entry{
+		std::filesystem::path path;	///< absolute path
+		std::string extension;		///< in lower case, without the dot
+		uint64_t size = 0;				///< in bytes, 0 for directories
+		std::time_t lastWriteTime = 0;
+		bool isDirectory = false;
+
+		/// \brief Opens the entry as an ofFile
+		ofFile getFile(ofFile::Mode mode = ofFile::Reference, bool binary = true) const;
+	};
+
+	struct Settings{
+		std::filesystem::path path;
+		bool relativeToData = true;		///< path is relative to the data folder
+		bool recursive = true;			///< list the subdirectories too
+		bool showHidden = false;			///< list hidden files and directories
+		bool includeDirectories = false;	///< add an entry for every directory
+		/// extensions to keep, without the dot, all the files if empty
+		std::vector<std::string> extensions;
+		/// called for every file, or directory with includeDirectories,
+		/// that passes the other checks, returning false skips it. It's
+		/// called from several threads at once
+		std::function<bool(const Entry & entry)> filter;
+	};
+
+	ofDirectoryScanner() = default;
+	~ofDirectoryScanner();
+
+	ofDirectoryScanner(const ofDirectoryScanner &) = delete;
+	ofDirectoryScanner & operator=(const ofDirectoryScanner &) = delete;
+
+	/// \brief Sets what to scan, clears the cache of the previous scans
+	void setup(const Settings & settings);
+	const Settings & getSettings() const;
+
+	/// \brief Scans the tree, blocking until it's done
+	/// \returns the entries sorted by path
+	std::vector<Entry> scan();
+
+	/// \brief Scans the tree in the background
+	/// \returns a future with the entries sorted by path
+	std::future<std::vector<Entry>> scanAsync();
+
+	/// \brief Scans the tree in the background and calls done with the
+	/// entries in the main thread, see ofTaskPool::runOnMainThread()
+	void scanAsync(std::function<void(std::vector<Entry> & entries)> done);
+
+	/// \brief true while a scan is running
+	bool isScanning() const;
+
+	/// \brief Forgets the directories listed by the previous scans so the
+	/// next one lists everything again
+	void clearCache();
+
+private:
+	struct Directory{
+		std::time_t lastWriteTime = 0;
+		std::vector<Entry> entries;
+		std::vector<std::filesystem::path> subdirectories;
+	};
+
+	Directory listDirectory(const std::filesystem::path & path, const Directory * cached) const;
+	bool accept(const Entry & entry) const;
+	void addPending(std::shared_future<void> scan);
+
+	Settings settings;
+	std::unordered_map<std::string, Directory> cache;
+	std::mutex mutex;	///< held during a scan, one at a time
+	std::atomic<int> numScanning{0};
+	std::vector<std::shared_future<void>> pending;	///< async scans, waited for on destruction
+};
@@ -0,0 +1,357 @@
+#include "ofFileIOService.h"
+#include "ofTaskPool.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+
+#if defined(TARGET_LINUX) && defined(OF_USE_IO_URING)
+	#include <liburing.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/stat.h>
+	#include <cstring>
+	#define OF_HAS_IO_URING
+#endif
+
+using namespace std;
+
+#ifdef OF_HAS_IO_URING
+namespace{
+	const unsigned queueDepth = 8;
+
+	// one ring per thread, rings can't be shared without locking
+	struct Ring{
+		Ring(){
+			valid = io_uring_queue_init(queueDepth, &ring, 0) == 0;
+		}
+		~Ring(){
+			if(valid){
+				io_uring_queue_exit(&ring);
+			}
+		}
+		io_uring ring;
+		bool valid;
+	};
+
+	Ring & getRing(){
+		thread_local Ring ring;
+		return ring;
+	}
+
+	bool isIOUringSupported(){
+		io_uring ring;
+		if(io_uring_queue_init(1, &ring, 0) != 0){
+			return false;
+		}
+		io_uring_queue_exit(&ring);
+		return true;
+	}
+
+	// reads or writes size bytes at data from the start of fd, keeping
+	// several blocks in flight
+	bool transfer(int fd, char * data, size_t size, size_t blockSize, bool write){
+		auto & ring = getRing().ring;
+		struct Block{
+			size_t offset;
+			size_t length;
+		};
+		vector<Block> blocks;
+		for(size_t offset = 0; offset < size; offset += blockSize){
+			blocks.push_back({offset, std::min(blockSize, size - offset)});
+		}
+
+		size_t next = 0;
+		size_t inFlight = 0;
+		bool ok = true;
+		while(inFlight > 0 || (ok && next < blocks.size())){
+			while(ok && inFlight < queueDepth && next < blocks.size()){
+				auto sqe = io_uring_get_sqe(&ring);
+				if(!sqe){
+					break;
+				}
+				auto & block = blocks[next++];
+				if(write){
+					io_uring_prep_write(sqe, fd, data + block.offset, block.length, block.offset);
+				}else{
+					io_uring_prep_read(sqe, fd, data + block.offset, block.length, block.offset);
+				}
+				io_uring_sqe_set_data(sqe, &block);
+				inFlight++;
+			}
+			io_uring_submit(&ring);
+
+			io_uring_cqe * cqe;
+			if(io_uring_wait_cqe(&ring, &cqe) < 0){
+				// the ring is unusable, the blocks in flight can't be waited for
+				return false;
+			}
+			auto block = (Block*)io_uring_cqe_get_data(cqe);
+			int result = cqe->res;
+			io_uring_cqe_seen(&ring, cqe);
+			inFlight--;
+
+			if(result < 0){
+				ofLogError("ofFileIOService") << "transfer(): " << (write ? "write" : "read") << " failed: " << strerror(-result);
+				ok = false;
+			}else if(result == 0 && !write){
+				// the file got shorter since it was opened
+				ok = false;
+			}else if(size_t(result) < block->length){
+				// short transfer, queue the rest again
+				block->offset += result;
+				block->length -= result;
+				auto sqe = io_uring_get_sqe(&ring);
+				if(sqe){
+					if(write){
+						io_uring_prep_write(sqe, fd, data + block->offset, block->length, block->offset);
+					}else{
+						io_uring_prep_read(sqe, fd, data + block->offset, block->length, block->offset);
+					}
+					io_uring_sqe_set_data(sqe, block);
+					inFlight++;
+				}else{
+					ok = false;
+				}
+			}
+		}
+		return ok;
+	}
+}
+#endif
+
+//----------------------------------------------------------
+ofFileIOService::ofFileIOService(size_t numThreads, size_t maxQueued, size_t blockSize)
+:maxQueued(std::max<size_t>(maxQueued, 1))
+,blockSize(std::max<size_t>(blockSize, 4096))
+,numRunning(0)
+,closing(false)
+,useIOUring(false){
+#ifdef OF_HAS_IO_URING
+	useIOUring = isIOUringSupported();
+	if(!useIOUring){
+		ofLogNotice("ofFileIOService") << "io_uring not supported by this kernel, using blocking reads and writes";
+	}
+#endif
+#ifndef TARGET_NO_THREADS
+	for(size_t i = 0; i < std::max<size_t>(numThreads, 1); i++){
+		threads.emplace_back(&ofFileIOService::workerLoop, this);
+	}
+#endif
+}
+
+//----------------------------------------------------------
+ofFileIOService::~ofFileIOService(){
+	{
+		unique_lock<std::mutex> lock(mutex);
+		closing = true;
+	}
+	// the queued writes still happen, files are not left half written
+	jobAvailable.notify_all();
+	spaceAvailable.notify_all();
+	for(auto & thread: threads){
+		thread.join();
+	}
+}
+
+//----------------------------------------------------------
+future<ofBuffer> ofFileIOService::read(const std::filesystem::path & path, bool binary){
+	auto fullPath = std::filesystem::path(ofToDataPath(path, true));
+	auto task = make_shared<packaged_task<ofBuffer()>>([this, fullPath, binary]{
+		return readFile(fullPath, binary);
+	});
+	auto future = task->get_future();
+	push([task]{ (*task)(); });
+	return future;
+}
+
+//----------------------------------------------------------
+void ofFileIOService::read(const std::filesystem::path & path, function<void(ofBuffer &)> done, bool binary){
+	auto fullPath = std::filesystem::path(ofToDataPath(path, true));
+	push([this, fullPath, binary, done]{
+		auto buffer = make_shared<ofBuffer>(readFile(fullPath, binary));
+		ofTaskPool::runOnMainThread([done, buffer]{
+			done(*buffer);
+		});
+	});
+}
+
+//----------------------------------------------------------
+future<bool> ofFileIOService::write(const std::filesystem::path & path, ofBuffer && buffer, bool binary){
+	auto fullPath = std::filesystem::path(ofToDataPath(path, true));
+	auto data = make_shared<ofBuffer>(std::move(buffer));
+	auto task = make_shared<packaged_task<bool()>>([this, fullPath, data, binary]{
+		return writeFile(fullPath, *data, binary);
+	});
+	auto future = task->get_future();
+	push([task]{ (*task)(); });
+	return future;
+}
+
+//----------------------------------------------------------
+future<bool> ofFileIOService::copy(const std::filesystem::path & src, const std::filesystem::path & dst, bool overwrite, const ofFile::CopyProgress & progress){
+	auto fullSrc = std::filesystem::path(ofToDataPath(src, true));
+	auto fullDst = std::filesystem::path(ofToDataPath(dst, true));
+	auto task = make_shared<packaged_task<bool()>>([fullSrc, fullDst, overwrite, progress]{
+		ofFile file(fullSrc, ofFile::Reference);
+		return file.copyTo(fullDst, false, overwrite, progress);
+	});
+	auto future = task->get_future();
+	push([task]{ (*task)(); });
+	return future;
+}
+
+//----------------------------------------------------------
+void ofFileIOService::flush(){
+	unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this]{ return jobs.empty() && numRunning == 0; });
+}
+
+//----------------------------------------------------------
+size_t ofFileIOService::getNumQueued() const{
+	unique_lock<std::mutex> lock(mutex);
+	return jobs.size();
+}
+
+//----------------------------------------------------------
+size_t ofFileIOService::getNumPending() const{
+	unique_lock<std::mutex> lock(mutex);
+	return jobs.size() + numRunning;
+}
+
+//----------------------------------------------------------
+bool ofFileIOService::isUsingIOUring() const{
+	return useIOUring;
+}
+
+//----------------------------------------------------------
+void ofFileIOService::push(function<void()> && job){
+	if(threads.empty()){
+		// no threads on this platform, run it right away
+		job();
+		return;
+	}
+	unique_lock<std::mutex> lock(mutex);
+	spaceAvailable.wait(lock, [this]{ return jobs.size() < maxQueued || closing; });
+	jobs.push_back(std::move(job));
+	jobAvailable.notify_one();
+}
+
+//----------------------------------------------------------
+void ofFileIOService::workerLoop(){
+	while(true){
+		function<void()> job;
+		{
+			unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this]{ return !jobs.empty() || closing; });
+			if(jobs.empty()){
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			numRunning++;
+		}
+		spaceAvailable.notify_one();
+
+		job();
+
+		{
+			unique_lock<std::mutex> lock(mutex);
+			numRunning--;
+			if(jobs.empty() && numRunning == 0){
+				idle.notify_all();
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofBuffer ofFileIOService::readFile(const std::filesystem::path & path, bool binary){
+	if(!binary){
+		// text mode can translate line endings, the size isn't known
+		return ofBufferFromFile(path, false);
+	}
+
+#ifdef OF_HAS_IO_URING
+	if(useIOUring && getRing().valid){
+		int fd = ::open(path.string().c_str(), O_RDONLY);
+		if(fd == -1){
+			ofLogError("ofFileIOService") << "read(): couldn't open " << path << ": " << strerror(errno);
+			return ofBuffer();
+		}
+		struct stat info;
+		ofBuffer buffer;
+		if(fstat(fd, &info) == 0){
+			buffer.allocate(info.st_size);
+			if(!transfer(fd, buffer.getData(), buffer.size(), blockSize, false)){
+				ofLogError("ofFileIOService") << "read(): couldn't read " << path;
+				buffer.clear();
+			}
+		}
+		::close(fd);
+		return buffer;
+	}
+#endif
+
+	ofFile file(path, ofFile::ReadOnly, true);
+	if(!file.is_open()){
+		return ofBuffer();
+	}
+	ofBuffer buffer;
+	buffer.allocate(file.getSize());
+	size_t offset = 0;
+	while(offset < buffer.size() && file.good()){
+		file.read(buffer.getData() + offset, std::min(blockSize, buffer.size() - offset));
+		offset += file.gcount();
+	}
+	buffer.resize(offset);
+	return buffer;
+}
+
+//----------------------------------------------------------
+bool ofFileIOService::writeFile(const std::filesystem::path & path, const ofBuffer & buffer, bool binary){
+#ifdef OF_HAS_IO_URING
+	if(binary && useIOUring && getRing().valid){
+		int fd = ::open(path.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if(fd == -1){
+			ofLogError("ofFileIOService") << "write(): couldn't open " << path << ": " << strerror(errno);
+			return false;
+		}
+		bool ok = transfer(fd, const_cast<char*>(buffer.getData()), buffer.size(), blockSize, true);
+		if(!ok){
+			ofLogError("ofFileIOService") << "write(): couldn't write " << path;
+		}
+		::close(fd);
+		return ok;
+	}
+#endif
+
+	ofFile file(path, ofFile::WriteOnly, binary);
+	if(!file.is_open()){
+		return false;
+	}
+	for(size_t offset = 0; offset < buffer.size() && file.good(); offset += blockSize){
+		file.write(buffer.getData() + offset, std::min(blockSize, buffer.size() - offset));
+	}
+	return file.good();
+}
+
+//----------------------------------------------------------
+ofFileIOService & ofGetFileIOService(){
+	// destroyed at exit, after finishing the queued writes
+	static ofFileIOService service;
+	return service;
+}
+
+//----------------------------------------------------------
+future<ofBuffer> ofBufferFromFileAsync(const std::filesystem::path & path, bool binary){
+	return ofGetFileIOService().read(path, binary);
+}
+
+//----------------------------------------------------------
+void ofBufferFromFileAsync(const std::filesystem::path & path, function<void(ofBuffer &)> done, bool binary){
+	ofGetFileIOService().read(path, done, binary);
+}
+
+//----------------------------------------------------------
+future<bool> ofBufferToFileAsync(const std::filesystem::path & path, ofBuffer && buffer, bool binary){
+	return ofGetFileIOService().write(path, std::move(buffer), binary);
+}
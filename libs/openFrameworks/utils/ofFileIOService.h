@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ofFileUtils.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <functional>
+
+/// \brief Reads and writes whole files in background threads
+///
+/// Files are transferred in large blocks straight into the buffer, several
+/// blocks in flight at once with io_uring on Linux when openFrameworks is
+/// built with OF_USE_IO_URING (linking liburing), with plain blocking
+/// reads and writes from the service's threads otherwise.
+///
+/// The queue is bounded: once maxQueued transfers are waiting, read() and
+/// write() block until one finishes, so a recorder producing frames
+/// faster than the disk can take them slows down instead of running out
+/// of memory. getNumQueued() can be used to drop frames instead.
+///
+/// ~~~~{.cpp}
+/// void ofApp::update(){
+///     ofBuffer png;
+///     ofSaveImage(grabber.getPixels(), png);
+///     ofBufferToFileAsync("frames/" + ofToString(ofGetFrameNum()) + ".png", std::move(png));
+/// }
+///
+/// void ofApp::exit(){
+///     ofGetFileIOService().flush();
+/// }
+/// ~~~~
+class ofFileIOService{
+public:
+	/// \param numThreads threads doing the transfers
+	/// \param maxQueued transfers that can wait before read() and write()
+	/// block
+	/// \param blockSize size in bytes of each read or write
+	ofFileIOService(std::size_t numThreads = 2, std::size_t maxQueued = 64, std::size_t blockSize = 1024 * 1024);
+	~ofFileIOService();
+
+	ofFileIOService(const ofFileIOService &) = delete;
+	ofFileIOService & operator=(const ofFileIOService &) = delete;
+
+	/// \brief Reads the file at path, relative to the data folder
+	/// \returns a future with the contents, empty if it couldn't be read
+	std::future<ofBuffer> read(const std::filesystem::path & path, bool binary = true);
+
+	/// \brief Reads the file at path and calls done with its contents in the
+	/// main thread, see ofTaskPool::runOnMainThread()
+	void read(const std::filesystem::path & path, std::function<void(ofBuffer & buffer)> done, bool binary = true);
+
+	/// \brief Writes buffer to the file at path, relative to the data
+	/// folder, replacing it
+	/// \returns a future that is true once the file is written
+	std::future<bool> write(const std::filesystem::path & path, ofBuffer && buffer, bool binary = true);
+
+	/// \brief Copies the file at src to dst, relative to the data folder,
+	/// with ofFile::copyTo() so the data is moved by the kernel
+	///
+	/// progress is called from the service's thread and can cancel the copy
+	/// by returning false.
+	/// \returns a future that is true once the file is copied
+	std::future<bool> copy(const std::filesystem::path & src, const std::filesystem::path & dst, bool overwrite = false, const ofFile::CopyProgress & progress = nullptr);
+
+	/// \brief Blocks until all the queued transfers have finished
+	void flush();
+
+	/// \brief Transfers waiting for a thread
+	std::size_t getNumQueued() const;
+
+	/// \brief Transfers waiting or running
+	std::size_t getNumPending() const;
+
+	/// \brief Whether the transfers are done with io_uring
+	bool isUsingIOUring() const;
+
+private:
+	void push(std::function<void()> && job);
+	void workerLoop();
+	ofBuffer readFile(const std::filesystem::path & path, bool binary);
+	bool writeFile(const std::filesystem::path & path, const ofBuffer & buffer, bool binary);
+
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> jobs;
+	std::size_t maxQueued;
+	std::size_t blockSize;
+	std::size_t numRunning;
+	bool closing;
+	bool useIOUring;
+	mutable std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable spaceAvailable;
+	std::condition_variable idle;
+};
+
+/// \brief The file service shared by the whole app, created the first time
+/// it's used
+ofFileIOService & ofGetFileIOService();
+
+/// \brief Reads the file at path in the background, see ofFileIOService
+std::future<ofBuffer> ofBufferFromFileAsync(const std::filesystem::path & path, bool binary = true);
+
+/// \brief Reads the file at path in the background and calls done with its
+/// contents in the main thread
+void ofBufferFromFileAsync(const std::filesystem::path & path, std::function<void(ofBuffer & buffer)> done, bool binary = true);
+
+/// \brief Writes buffer to the file at path in the background, the buffer
+/// is moved so the caller can't modify it while it's written
+std::future<bool> ofBufferToFileAsync(const std::filesystem::path & path, ofBuffer && buffer, bool binary = true);
@@ -2,14 +2,26 @@
 #ifndef TARGET_WIN32
 	#include <pwd.h>
 	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+	#include <cstring>
 #endif
 
 #include "ofUtils.h"
+#include "ofFileIOService.h"
 
 
 #ifdef TARGET_OSX
 	#include <mach-o/dyld.h>       /* _NSGetExecutablePath */
 	#include <limits.h>        /* PATH_MAX */
+	#include <copyfile.h>
+#endif
+
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+	#include <sys/sendfile.h>
+	#include <sys/syscall.h>
 #endif
 
 using namespace std;
@@ -386,6 +398,66 @@ ofBuffer::RLines ofBuffer::getReverseLines(){
 	return ofBuffer::RLines(rbegin(), rend());
 }
 
+//--------------------------------------------------
+ofBuffer::LineRanges::iterator::iterator(const char * begin, const char * end)
+	:_begin(begin)
+	,_next(begin)
+	,_end(end){
+	if(_begin != _end){
+		auto newline = static_cast<const char*>(memchr(_begin, '\n', _end - _begin));
+		_next = newline ? newline + 1 : _end;
+	}
+}
+
+//--------------------------------------------------
+ofStringRange ofBuffer::LineRanges::iterator::operator*() const{
+	auto lineEnd = _next;
+	if(lineEnd != _begin && *(lineEnd - 1) == '\n'){
+		lineEnd--;
+		if(lineEnd != _begin && *(lineEnd - 1) == '\r'){
+			lineEnd--;
+		}
+	}
+	return ofStringRange(_begin, lineEnd - _begin);
+}
+
+//--------------------------------------------------
+ofBuffer::LineRanges::iterator & ofBuffer::LineRanges::iterator::operator++(){
+	*this = iterator(_next, _end);
+	return *this;
+}
+
+//--------------------------------------------------
+bool ofBuffer::LineRanges::iterator::operator!=(const iterator & rhs) const{
+	return _begin != rhs._begin;
+}
+
+//--------------------------------------------------
+bool ofBuffer::LineRanges::iterator::operator==(const iterator & rhs) const{
+	return _begin == rhs._begin;
+}
+
+//--------------------------------------------------
+ofBuffer::LineRanges::LineRanges(const char * begin, const char * end)
+	:_begin(begin)
+	,_end(end){
+}
+
+//--------------------------------------------------
+ofBuffer::LineRanges::iterator ofBuffer::LineRanges::begin() const{
+	return iterator(_begin, _end);
+}
+
+//--------------------------------------------------
+ofBuffer::LineRanges::iterator ofBuffer::LineRanges::end() const{
+	return iterator(_end, _end);
+}
+
+//--------------------------------------------------
+ofBuffer::LineRanges ofBuffer::getLineRanges() const{
+	return LineRanges(getData(), getData() + size());
+}
+
 //--------------------------------------------------
 ostream & operator<<(ostream & ostr, const ofBuffer & buf){
 	buf.writeTo(ostr);
@@ -401,6 +473,14 @@ istream & operator>>(istream & istr, ofBuffer & buf){
 //--------------------------------------------------
 ofBuffer ofBufferFromFile(const std::filesystem::path & path, bool binary){
 	ofFile f(path,ofFile::ReadOnly, binary);
+	if(binary && f.is_open()){
+		// the size is known, read it in one go instead of in small blocks
+		ofBuffer buffer;
+		buffer.allocate(f.getSize());
+		f.read(buffer.getData(), buffer.size());
+		buffer.resize(f.gcount());
+		return buffer;
+	}
 	return ofBuffer(f);
 }
 
@@ -410,6 +490,180 @@ bool ofBufferToFile(const std::filesystem::path & path, const ofBuffer& buffer,
 	return buffer.writeTo(f);
 }
 
+//------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------
+// -- ofMappedBuffer
+//------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------
+ofMappedBuffer::ofMappedBuffer()
+:data(nullptr)
+,length(0)
+,opened(false)
+#ifdef TARGET_WIN32
+,file(INVALID_HANDLE_VALUE)
+,mapping(nullptr)
+#endif
+{
+}
+
+//--------------------------------------------------
+ofMappedBuffer::ofMappedBuffer(const std::filesystem::path & path, bool bRelativeToData)
+:ofMappedBuffer(){
+	open(path, bRelativeToData);
+}
+
+//--------------------------------------------------
+ofMappedBuffer::~ofMappedBuffer(){
+	close();
+}
+
+//--------------------------------------------------
+ofMappedBuffer::ofMappedBuffer(ofMappedBuffer && other)
+:ofMappedBuffer(){
+	*this = std::move(other);
+}
+
+//--------------------------------------------------
+ofMappedBuffer & ofMappedBuffer::operator=(ofMappedBuffer && other){
+	if(&other == this){
+		return *this;
+	}
+	close();
+	std::swap(data, other.data);
+	std::swap(length, other.length);
+	std::swap(opened, other.opened);
+#ifdef TARGET_WIN32
+	std::swap(file, other.file);
+	std::swap(mapping, other.mapping);
+#endif
+	return *this;
+}
+
+//--------------------------------------------------
+bool ofMappedBuffer::open(const std::filesystem::path & path, bool bRelativeToData){
+	close();
+	auto fullPath = bRelativeToData ? std::filesystem::path(ofToDataPath(path)) : path;
+#ifdef TARGET_WIN32
+	file = CreateFileW(fullPath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE){
+		ofLogError("ofMappedBuffer") << "open(): couldn't open " << fullPath;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize)){
+		ofLogError("ofMappedBuffer") << "open(): couldn't get the size of " << fullPath;
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+		return false;
+	}
+	length = size_t(fileSize.QuadPart);
+	// empty files can't be mapped
+	if(length > 0){
+		mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(mapping){
+			data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		}
+		if(!data){
+			ofLogError("ofMappedBuffer") << "open(): couldn't map " << fullPath;
+			close();
+			return false;
+		}
+	}
+#else
+	int fd = ::open(fullPath.string().c_str(), O_RDONLY);
+	if(fd == -1){
+		ofLogError("ofMappedBuffer") << "open(): couldn't open " << fullPath << ": " << strerror(errno);
+		return false;
+	}
+	struct stat fileInfo;
+	if(fstat(fd, &fileInfo) == -1){
+		ofLogError("ofMappedBuffer") << "open(): couldn't get the size of " << fullPath << ": " << strerror(errno);
+		::close(fd);
+		return false;
+	}
+	length = size_t(fileInfo.st_size);
+	// empty files can't be mapped
+	if(length > 0){
+		void * mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapped == MAP_FAILED){
+			ofLogError("ofMappedBuffer") << "open(): couldn't map " << fullPath << ": " << strerror(errno);
+			::close(fd);
+			length = 0;
+			return false;
+		}
+		data = (const char*)mapped;
+	}
+	// the mapping keeps the file alive
+	::close(fd);
+#endif
+	opened = true;
+	return true;
+}
+
+//--------------------------------------------------
+void ofMappedBuffer::close(){
+#ifdef TARGET_WIN32
+	if(data){
+		UnmapViewOfFile(data);
+	}
+	if(mapping){
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if(file != INVALID_HANDLE_VALUE){
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if(data){
+		munmap((void*)data, length);
+	}
+#endif
+	data = nullptr;
+	length = 0;
+	opened = false;
+}
+
+//--------------------------------------------------
+bool ofMappedBuffer::isOpen() const{
+	return opened;
+}
+
+//--------------------------------------------------
+const char * ofMappedBuffer::getData() const{
+	return data;
+}
+
+//--------------------------------------------------
+std::size_t ofMappedBuffer::size() const{
+	return length;
+}
+
+//--------------------------------------------------
+string ofMappedBuffer::getText() const{
+	return string(begin(), end());
+}
+
+//--------------------------------------------------
+ofBuffer ofMappedBuffer::getBuffer(std::size_t offset, std::size_t count) const{
+	if(offset >= length){
+		return ofBuffer();
+	}
+	return ofBuffer(data + offset, std::min(count, length - offset));
+}
+
+//--------------------------------------------------
+const char * ofMappedBuffer::begin() const{
+	return data;
+}
+
+//--------------------------------------------------
+const char * ofMappedBuffer::end() const{
+	return data + length;
+}
+
 //------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------
 // -- ofFile
@@ -570,6 +824,19 @@ ofBuffer ofFile::readToBuffer(){
 	return ofBuffer(*this);
 }
 
+//------------------------------------------------------------------------------------------------------------
+ofMappedBuffer ofFile::mapToBuffer() const{
+	if(myFile.string().empty()){
+		return ofMappedBuffer();
+	}
+	return ofMappedBuffer(myFile, false);
+}
+
+//------------------------------------------------------------------------------------------------------------
+std::future<ofBuffer> ofFile::readAsync() const{
+	return ofGetFileIOService().read(myFile, binary);
+}
+
 //------------------------------------------------------------------------------------------------------------
 bool ofFile::writeFromBuffer(const ofBuffer & buffer){
 	if(myFile.string().empty()){
@@ -772,8 +1039,220 @@ void ofFile::setExecutable(bool flag){
 	}
 }
 
+//------------------------------------------------------------------------------------------------------------
+namespace{
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+	// copies the file with copy_file_range so the kernel moves the data,
+	// or the filesystem clones or copies it on the device itself, falling
+	// back to sendfile and then to read and write when they aren't supported
+	// between the two files
+	bool copyFileData(const std::filesystem::path & src, const std::filesystem::path & dst, const ofFile::CopyProgress & progress){
+		int in = ::open(src.string().c_str(), O_RDONLY | O_CLOEXEC);
+		if(in == -1){
+			ofLogError("ofFile") << "copyTo(): couldn't open " << src << ": " << strerror(errno);
+			return false;
+		}
+		struct stat info;
+		if(fstat(in, &info) != 0){
+			ofLogError("ofFile") << "copyTo(): couldn't stat " << src << ": " << strerror(errno);
+			::close(in);
+			return false;
+		}
+		int out = ::open(dst.string().c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, info.st_mode & 07777);
+		if(out == -1){
+			ofLogError("ofFile") << "copyTo(): couldn't create " << dst << ": " << strerror(errno);
+			::close(in);
+			return false;
+		}
+
+		// in chunks to report the progress and cancel regularly
+		const size_t chunkSize = 64 * 1024 * 1024;
+		enum{
+			CopyRange,
+			SendFile,
+			ReadWrite,
+		} method = CopyRange;
+		vector<char> buffer;
+		uint64_t total = info.st_size;
+		uint64_t copied = 0;
+		bool ok = true;
+		while(true){
+			if(progress && !progress(copied, total)){
+				ok = false;
+				break;
+			}
+			ssize_t result = -1;
+			if(method == CopyRange){
+#ifdef SYS_copy_file_range
+				result = syscall(SYS_copy_file_range, in, nullptr, out, nullptr, chunkSize, 0);
+				if(result == -1 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)){
+					method = SendFile;
+					continue;
+				}
+#else
+				method = SendFile;
+				continue;
+#endif
+			}else if(method == SendFile){
+				result = sendfile(out, in, nullptr, chunkSize);
+				if(result == -1 && (errno == ENOSYS || errno == EINVAL)){
+					method = ReadWrite;
+					continue;
+				}
+			}else{
+				buffer.resize(1024 * 1024);
+				result = ::read(in, buffer.data(), buffer.size());
+				for(ssize_t written = 0; result > 0 && written < result;){
+					ssize_t n = ::write(out, buffer.data() + written, result - written);
+					if(n == -1 && errno != EINTR){
+						result = -1;
+					}else if(n > 0){
+						written += n;
+					}
+				}
+			}
+			if(result == -1){
+				if(errno == EINTR){
+					continue;
+				}
+				ofLogError("ofFile") << "copyTo(): couldn't copy " << src << " to " << dst << ": " << strerror(errno);
+				ok = false;
+				break;
+			}
+			if(result == 0){
+				break;
+			}
+			copied += result;
+		}
+
+		::close(in);
+		if(::close(out) != 0){
+			ok = false;
+		}
+		if(!ok){
+			::unlink(dst.string().c_str());
+		}
+		return ok;
+	}
+
+#elif defined(TARGET_OSX)
+	struct CopyContext{
+		const ofFile::CopyProgress * progress;
+		uint64_t total;
+	};
+
+	int copyFileCallback(int what, int stage, copyfile_state_t state, const char *, const char *, void * data){
+		auto context = static_cast<CopyContext*>(data);
+		if(what == COPYFILE_COPY_DATA && stage == COPYFILE_PROGRESS){
+			off_t copied = 0;
+			copyfile_state_get(state, COPYFILE_STATE_COPIED, &copied);
+			if(!(*context->progress)(copied, context->total)){
+				return COPYFILE_QUIT;
+			}
+		}
+		return COPYFILE_CONTINUE;
+	}
+
+	// clones the file on APFS, copyfile copies it in the kernel otherwise
+	bool copyFileData(const std::filesystem::path & src, const std::filesystem::path & dst, const ofFile::CopyProgress & progress){
+		CopyContext context{&progress, 0};
+		copyfile_state_t state = copyfile_state_alloc();
+		if(progress){
+			struct stat info;
+			if(stat(src.string().c_str(), &info) == 0){
+				context.total = info.st_size;
+			}
+			copyfile_state_set(state, COPYFILE_STATE_STATUS_CB, (void*)&copyFileCallback);
+			copyfile_state_set(state, COPYFILE_STATE_STATUS_CTX, &context);
+			if(!progress(0, context.total)){
+				copyfile_state_free(state);
+				return false;
+			}
+		}
+		int result = copyfile(src.string().c_str(), dst.string().c_str(), state, COPYFILE_ALL | COPYFILE_CLONE | COPYFILE_EXCL);
+		int error = errno;
+		copyfile_state_free(state);
+		if(result != 0){
+			if(error != ECANCELED){
+				ofLogError("ofFile") << "copyTo(): couldn't copy " << src << " to " << dst << ": " << strerror(error);
+			}
+			if(error != EEXIST){
+				::unlink(dst.string().c_str());
+			}
+			return false;
+		}
+		if(progress){
+			progress(context.total, context.total);
+		}
+		return true;
+	}
+
+#elif defined(TARGET_WIN32)
+	DWORD CALLBACK copyFileCallback(LARGE_INTEGER total, LARGE_INTEGER copied, LARGE_INTEGER, LARGE_INTEGER, DWORD, DWORD, HANDLE, HANDLE, LPVOID data){
+		auto progress = static_cast<const ofFile::CopyProgress*>(data);
+		return (*progress)(copied.QuadPart, total.QuadPart) ? PROGRESS_CONTINUE : PROGRESS_CANCEL;
+	}
+
+	// CopyFileEx copies in the kernel, on the server for network shares
+	bool copyFileData(const std::filesystem::path & src, const std::filesystem::path & dst, const ofFile::CopyProgress & progress){
+		DWORD flags = COPY_FILE_FAIL_IF_EXISTS;
+		auto callback = progress ? &copyFileCallback : nullptr;
+		BOOL ok = CopyFileExW(src.wstring().c_str(), dst.wstring().c_str(), callback, (LPVOID)&progress, nullptr, flags);
+		if(!ok){
+			DWORD error = GetLastError();
+			if(error != ERROR_REQUEST_ABORTED){
+				ofLogError("ofFile") << "copyTo(): couldn't copy " << src << " to " << dst << ": error " << error;
+			}
+			return false;
+		}
+		return true;
+	}
+
+#else
+	bool copyFileData(const std::filesystem::path & src, const std::filesystem::path & dst, const ofFile::CopyProgress & progress){
+		std::ifstream in(src.string(), std::ios::binary);
+		if(!in.is_open()){
+			ofLogError("ofFile") << "copyTo(): couldn't open " << src;
+			return false;
+		}
+		if(ofFile::doesFileExist(dst, false)){
+			ofLogError("ofFile") << "copyTo(): " << dst << " already exists";
+			return false;
+		}
+		std::ofstream out(dst.string(), std::ios::binary);
+		uint64_t total = std::filesystem::file_size(src);
+		uint64_t copied = 0;
+		vector<char> buffer(1024 * 1024);
+		bool ok = out.is_open();
+		while(ok && in){
+			if(progress && !progress(copied, total)){
+				ok = false;
+				break;
+			}
+			in.read(buffer.data(), buffer.size());
+			out.write(buffer.data(), in.gcount());
+			copied += in.gcount();
+			ok = out.good();
+		}
+		if(ok && progress){
+			progress(copied, total);
+		}
+		out.close();
+		if(!ok){
+			std::filesystem::remove(dst);
+		}
+		return ok;
+	}
+#endif
+}
+
 //------------------------------------------------------------------------------------------------------------
 bool ofFile::copyTo(const filesystem::path& _path, bool bRelativeToData, bool overwrite) const{
+	return copyTo(_path, bRelativeToData, overwrite, nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------
+bool ofFile::copyTo(const filesystem::path& _path, bool bRelativeToData, bool overwrite, const CopyProgress & progress) const{
 	auto path = _path;
 
 	if(path.empty()){
@@ -819,13 +1298,19 @@ bool ofFile::copyTo(const filesystem::path& _path, bool bRelativeToData, bool ov
 		if(!destDir.exists()){
 			ofFilePath::createEnclosingDirectory(path, false);
 		}
-		std::filesystem::copy_file(myFile,path);
 	}catch(std::exception & except){
 		ofLogError("ofFile") <<  "copyTo(): unable to copy \"" << path << "\":" << except.what();
 		return false;
 	}
 
-	return true;
+	return copyFileData(myFile, path, progress);
+}
+
+//------------------------------------------------------------------------------------------------------------
+std::future<bool> ofFile::copyToAsync(const std::filesystem::path& path, bool bRelativeToData, bool overwrite, const CopyProgress & progress) const{
+	// the service takes paths relative to the data folder
+	auto dst = bRelativeToData ? path : std::filesystem::absolute(path);
+	return ofGetFileIOService().copy(std::filesystem::absolute(myFile), dst, overwrite, progress);
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -872,7 +1357,15 @@ bool ofFile::moveTo(const filesystem::path& _path, bool bRelativeToData, bool ov
 		if(!destDir.exists()){
 			ofFilePath::createEnclosingDirectory(path,false);
 		}
-		std::filesystem::rename(myFile,path);
+		try{
+			std::filesystem::rename(myFile,path);
+		}catch(std::exception &){
+			// rename can't move files to another device, copy and remove them
+			if(!isFile() || !copyFileData(myFile, path, nullptr)){
+				throw;
+			}
+			std::filesystem::remove(myFile);
+		}
 		myFile = path;
 		if(mode != ofFile::Reference){
 			changeMode(mode, binary);
@@ -1251,27 +1744,29 @@ std::size_t ofDirectory::listDir(){
 	
 	std::filesystem::directory_iterator end_iter;
 	if ( std::filesystem::exists(myDir) && std::filesystem::is_directory(myDir)){
+		// filter on the path before creating the ofFile, which resolves
+		// the path again for every entry
+		bool filterExtensions = !extensions.empty() && !ofContains(extensions, (string)"*");
 		for( std::filesystem::directory_iterator dir_iter(myDir) ; dir_iter != end_iter ; ++dir_iter){
-			files.emplace_back(dir_iter->path().string(), ofFile::Reference);
+			auto & entryPath = dir_iter->path();
+#ifndef TARGET_WIN32
+			if(!showHidden){
+				auto name = entryPath.filename().string();
+				if(name != "." && name != ".." && !name.empty() && name[0] == '.'){
+					continue;
+				}
+			}
+#endif
+			if(filterExtensions && std::find(extensions.begin(), extensions.end(), ofToLower(ofFilePath::getFileExt(entryPath))) == extensions.end()){
+				continue;
+			}
+			files.emplace_back(entryPath.string(), ofFile::Reference);
 		}
 	}else{
 		ofLogError("ofDirectory") << "listDir:() source directory does not exist: \"" << myDir << "\"";
 		return 0;
 	}
 
-	if(!showHidden){
-		ofRemove(files, [](ofFile & file){
-			return file.isHidden();
-		});
-	}
-
-
-	if(!extensions.empty() && !ofContains(extensions, (string)"*")){
-		ofRemove(files, [&](ofFile & file){
-			return std::find(extensions.begin(), extensions.end(), ofToLower(file.getExtension())) == extensions.end();
-		});
-	}        
-
 	if(ofGetLogLevel() == OF_LOG_VERBOSE){
 		for(int i = 0; i < (int)size(); i++){
 			ofLogVerbose() << "\t" << getName(i);
@@ -1327,20 +1822,56 @@ void ofDirectory::reset(){
 }
 
 //------------------------------------------------------------------------------------------------------------
-static bool natural(const ofFile& a, const ofFile& b) {
-	string aname = a.getBaseName(), bname = b.getBaseName();
-	int aint = ofToInt(aname), bint = ofToInt(bname);
-	if(ofToString(aint) == aname && ofToString(bint) == bname) {
-		return aint < bint;
+// sorts the files by a key computed once per file instead of on every
+// comparison, then moves them to their sorted position with one copy each
+template<typename Key, typename Less>
+static void sortByKey(vector<ofFile> & files, std::function<Key(const ofFile&)> key, Less less){
+	vector<pair<Key, std::size_t>> keys;
+	keys.reserve(files.size());
+	for(std::size_t i = 0; i < files.size(); i++){
+		keys.emplace_back(key(files[i]), i);
+	}
+	std::sort(keys.begin(), keys.end(), [&](const pair<Key, std::size_t> & a, const pair<Key, std::size_t> & b){
+		return less(a.first, files[a.second], b.first, files[b.second]);
+	});
+	vector<ofFile> sorted;
+	sorted.reserve(files.size());
+	for(auto & k: keys){
+		sorted.push_back(files[k.second]);
+	}
+	std::swap(files, sorted);
+}
+
+//------------------------------------------------------------------------------------------------------------
+struct NaturalKey{
+	bool isInt;
+	int value;
+};
+
+static NaturalKey naturalKey(const ofFile & file){
+	string name = file.getBaseName();
+	int value = ofToInt(name);
+	return {ofToString(value) == name, value};
+}
+
+static bool natural(const NaturalKey & ka, const ofFile& a, const NaturalKey & kb, const ofFile& b) {
+	if(ka.isInt && kb.isInt) {
+		return ka.value < kb.value;
 	} else {
 		return a < b;
 	}
 }
 
 //------------------------------------------------------------------------------------------------------------
-static bool byDate(const ofFile& a, const ofFile& b) {
-	auto ta = std::filesystem::last_write_time(a);
-	auto tb = std::filesystem::last_write_time(b);
+static std::time_t lastWriteTime(const ofFile & file){
+	try{
+		return std::filesystem::last_write_time(file);
+	}catch(std::exception &){
+		return 0;
+	}
+}
+
+static bool byDate(std::time_t ta, const ofFile&, std::time_t tb, const ofFile&) {
 	return ta < tb;
 }
 
@@ -1349,7 +1880,7 @@ void ofDirectory::sortByDate() {
 	if (files.empty() && !myDir.empty()) {
 		listDir();
 	}
-	ofSort(files, byDate);
+	sortByKey<std::time_t>(files, lastWriteTime, byDate);
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1357,7 +1888,7 @@ void ofDirectory::sort(){
 	if(files.empty() && !myDir.empty()){
 		listDir();
 	}
-	ofSort(files, natural);
+	sortByKey<NaturalKey>(files, naturalKey, natural);
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ofConstants.h"
+#include <limits>
+#include <future>
+#include <functional>
 #if !_MSC_VER
 #define BOOST_NO_CXX11_SCOPED_ENUMS
 #define BOOST_NO_SCOPED_ENUMS
@@ -10,6 +13,8 @@ namespace std {
 	namespace filesystem = boost::filesystem;
 }
 
+class ofStringRange;
+
 //----------------------------------------------------------
 // ofBuffer
 //----------------------------------------------------------
@@ -241,6 +246,51 @@ public:
 	/// \returns buffer text lines
 	Lines getLines();
 
+	/// The lines of the buffer as ranges pointing into it.
+	///
+	/// Unlike getLines() nothing is copied, each line is an ofStringRange
+	/// without the '\n' or '\r\n' and is valid while the buffer isn't
+	/// modified. Together with ofStringSplitter and ofParse() text data can
+	/// be read without allocating:
+	///
+	/// ~~~~{.cpp}
+	/// for(auto line: buffer.getLineRanges()){
+	///     for(auto field: ofStringSplitter(line, ",")){
+	///         float value;
+	///         if(ofParse(field, value)){
+	///             ...
+	///         }
+	///     }
+	/// }
+	/// ~~~~
+	///
+	/// See ofCsvTable to read whole tables of numbers.
+	struct LineRanges{
+		LineRanges(const char * begin, const char * end);
+
+		struct iterator{
+			ofStringRange operator*() const;
+			iterator & operator++();
+			bool operator!=(const iterator & rhs) const;
+			bool operator==(const iterator & rhs) const;
+
+		private:
+			friend struct LineRanges;
+			iterator(const char * begin, const char * end);
+			const char * _begin;	///< start of the current line
+			const char * _next;		///< start of the next one
+			const char * _end;
+		};
+
+		iterator begin() const;
+		iterator end() const;
+
+	private:
+		const char * _begin, * _end;
+	};
+
+	LineRanges getLineRanges() const;
+
 	/// Access the contents of the buffer as a series of text lines in reverse
 	/// order
 	///
@@ -276,6 +326,77 @@ ofBuffer ofBufferFromFile(const std::filesystem::path & path, bool binary=true);
 /// split at endline characters automatically
 bool ofBufferToFile(const std::filesystem::path & path, const ofBuffer& buffer, bool binary=true);
 
+//--------------------------------------------------
+/// \class ofMappedBuffer
+///
+/// A read only view of a file's contents mapped into memory.
+///
+/// Unlike ofBufferFromFile nothing is read or copied when the file is
+/// opened, the operating system loads its pages the first time they are
+/// accessed and can drop them again when memory is needed, which makes it
+/// a better fit for files of several GB:
+///
+/// ~~~~{.cpp}
+/// ofMappedBuffer file("frames/0001.png");
+/// ofImage img;
+/// img.load(file);
+/// ~~~~
+///
+/// The data stays valid until the buffer is closed or destroyed.
+class ofMappedBuffer{
+public:
+	ofMappedBuffer();
+
+	/// Map the file at path, relative to the data folder by default.
+	ofMappedBuffer(const std::filesystem::path & path, bool bRelativeToData = true);
+	~ofMappedBuffer();
+
+	ofMappedBuffer(const ofMappedBuffer &) = delete;
+	ofMappedBuffer & operator=(const ofMappedBuffer &) = delete;
+	ofMappedBuffer(ofMappedBuffer && other);
+	ofMappedBuffer & operator=(ofMappedBuffer && other);
+
+	/// Map the file at path, relative to the data folder by default.
+	///
+	/// 
+eturns false if the file doesn't exist or can't be mapped
+	bool open(const std::filesystem::path & path, bool bRelativeToData = true);
+
+	/// Unmap the file, invalidating the pointers returned by getData().
+	void close();
+
+	/// 
+eturns true while a file is mapped, even if it's empty
+	bool isOpen() const;
+
+	/// 
+eturns const pointer to the file's bytes, nullptr for an empty
+	/// file
+	const char * getData() const;
+
+	/// 
+eturns the size of the file in bytes
+	std::size_t size() const;
+
+	/// Copy the contents to a string.
+	std::string getText() const;
+
+	/// Copy the contents, or part of them, into an ofBuffer.
+	ofBuffer getBuffer(std::size_t offset = 0, std::size_t length = std::numeric_limits<std::size_t>::max()) const;
+
+	const char * begin() const;
+	const char * end() const;
+
+private:
+	const char * data;
+	std::size_t length;
+	bool opened;
+#ifdef TARGET_WIN32
+	void * file;
+	void * mapping;
+#endif
+};
+
 //--------------------------------------------------
 /// \class ofFilePath
 ///
@@ -654,6 +775,35 @@ public:
 	/// directory at the new path
 	/// \returns true if the copy was successful
 	bool copyTo(const std::filesystem::path& path, bool bRelativeToData = true, bool overwrite = false) const;
+
+	/// Called while a file is copied with the bytes copied so far and the
+	/// size of the file, returning false cancels the copy.
+	typedef std::function<bool(uint64_t bytesCopied, uint64_t totalBytes)> CopyProgress;
+
+	/// Copy the file reporting the progress.
+	///
+	/// Files are copied by the kernel, with copy_file_range on Linux,
+	/// copyfile on macOS, which clones them on APFS, and CopyFileEx on
+	/// Windows, so the data doesn't go through the app. progress is called
+	/// from the copying thread every 64MB or so, a cancelled copy is
+	/// removed. Directories are copied without reporting progress.
+	///
+	/// \returns true if the copy was successful
+	bool copyTo(const std::filesystem::path& path, bool bRelativeToData, bool overwrite, const CopyProgress & progress) const;
+
+	/// Copy the file in a background thread of the ofFileIOService.
+	///
+	/// ~~~~{.cpp}
+	/// std::atomic<float> done{0};
+	/// std::atomic<bool> cancel{false};
+	/// auto copied = clip.copyToAsync("/media/backup/" + clip.getFileName(), false, false, [&](uint64_t copied, uint64_t total){
+	///     done = total > 0 ? float(copied) / total : 1.f;
+	///     return !cancel;
+	/// });
+	/// ~~~~
+	///
+	/// \returns a future that is true once the file is copied
+	std::future<bool> copyToAsync(const std::filesystem::path& path, bool bRelativeToData = true, bool overwrite = false, const CopyProgress & progress = nullptr) const;
 	
 	/// Move the current file or directory path to a new path.
 	///
@@ -667,6 +817,8 @@ public:
 	/// \param overwrite set to true if you want to overwrite the file or
 	/// directory at the new path
 	/// \returns true if the copy was successful
+	///
+	/// Files moved to another device are copied like copyTo() and removed.
 	bool moveTo(const std::filesystem::path& path, bool bRelativeToData = true, bool overwrite = false);
 	
 	/// Rename the current file or directory path to a new path.
@@ -718,6 +870,18 @@ public:
 	///
 	/// \returns buffer with file contents
 	ofBuffer readToBuffer();
+
+	/// Map the file at the current path into memory instead of reading
+	/// it, see ofMappedBuffer.
+	///
+	/// \returns read only view of the file contents
+	ofMappedBuffer mapToBuffer() const;
+
+	/// Read the contents of the file at the current path into a buffer
+	/// in a background thread, see ofFileIOService.
+	///
+	/// \returns future with the file contents
+	std::future<ofBuffer> readAsync() const;
 	
 	/// Write the contents of a buffer into a file at the current path.
 	///
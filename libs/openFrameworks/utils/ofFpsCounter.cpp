@@ -1,4 +1,5 @@
 #include "ofFpsCounter.h"
+#include <algorithm>
 
 ofFpsCounter::ofFpsCounter()
 :nFrameCount(0)
@@ -6,7 +7,13 @@ ofFpsCounter::ofFpsCounter()
 ,fps(0)
 ,lastFrameTime(0)
 ,filteredTime(0)
-,filterAlpha(0.9){}
+,filterAlpha(0.9)
+,historySize(600)
+,historyPos(0)
+,bSortedHistoryDirty(false)
+,spikeThreshold(0)
+,bCaptureProfile(false)
+,numSpikes(0){}
 
 
 
@@ -16,7 +23,13 @@ ofFpsCounter::ofFpsCounter(double targetFPS)
 ,fps(targetFPS)
 ,lastFrameTime(0)
 ,filteredTime(0)
-,filterAlpha(0.9){}
+,filterAlpha(0.9)
+,historySize(600)
+,historyPos(0)
+,bSortedHistoryDirty(false)
+,spikeThreshold(0)
+,bCaptureProfile(false)
+,numSpikes(0){}
 
 void ofFpsCounter::newFrame(){
 	auto now = ofGetCurrentTime();
@@ -27,6 +40,34 @@ void ofFpsCounter::newFrame(){
 	uint64_t filtered = filteredTime.count() * filterAlpha + lastFrameTime.count() * (1-filterAlpha);
 	filteredTime = std::chrono::nanoseconds(filtered);
 	then = now;
+
+	// the first frame has no previous one to measure from
+	if(nFrameCount > 0){
+		uint64_t nanos = lastFrameTime.count();
+		if(history.size() < historySize){
+			history.push_back(nanos);
+		}else{
+			history[historyPos] = nanos;
+		}
+		historyPos = (historyPos + 1) % historySize;
+		bSortedHistoryDirty = true;
+
+		if(spikeThreshold > 0 && nanos > spikeThreshold){
+			numSpikes++;
+			lastSpike.frameNum = nFrameCount;
+			lastSpike.nanos = nanos;
+			auto & sorted = getSortedHistory();
+			lastSpike.medianNanos = sorted[sorted.size() / 2];
+			if(bCaptureProfile && ofGetProfiler().isEnabled()){
+				lastSpike.profile = ofGetProfiler().getLastFrame();
+			}else{
+				lastSpike.profile.clear();
+			}
+			if(spikeCallback){
+				spikeCallback(lastSpike);
+			}
+		}
+	}
 	nFrameCount++;
 }
 
@@ -68,7 +109,7 @@ double ofFpsCounter::getLastFrameSecs() const{
 }
 
 uint64_t ofFpsCounter::getLastFrameFilteredNanos() const{
-	return lastFrameTime.count();
+	return filteredTime.count();
 }
 
 double ofFpsCounter::getLastFrameFilteredSecs() const{
@@ -78,3 +119,106 @@ double ofFpsCounter::getLastFrameFilteredSecs() const{
 void ofFpsCounter::setFilterAlpha(float alpha){
 	filterAlpha = alpha;
 }
+
+void ofFpsCounter::reset(double targetFps){
+	nFrameCount = 0;
+	then = ofGetCurrentTime();
+	fps = targetFps;
+	lastFrameTime = std::chrono::nanoseconds(0);
+	filteredTime = std::chrono::nanoseconds(0);
+	timestamps = std::queue<double>();
+	history.clear();
+	historyPos = 0;
+	bSortedHistoryDirty = true;
+	numSpikes = 0;
+	lastSpike = ofFrameSpike();
+}
+
+void ofFpsCounter::setHistorySize(std::size_t frames){
+	frames = std::max<std::size_t>(frames, 1);
+	// keep the newest frames, oldest first
+	std::vector<uint64_t> ordered;
+	if(history.size() < historySize){
+		ordered = history;
+	}else{
+		ordered.insert(ordered.end(), history.begin() + historyPos, history.end());
+		ordered.insert(ordered.end(), history.begin(), history.begin() + historyPos);
+	}
+	if(ordered.size() > frames){
+		ordered.erase(ordered.begin(), ordered.end() - frames);
+	}
+	history = std::move(ordered);
+	historySize = frames;
+	historyPos = history.size() % historySize;
+	bSortedHistoryDirty = true;
+}
+
+const std::vector<uint64_t> & ofFpsCounter::getSortedHistory() const{
+	if(bSortedHistoryDirty){
+		sortedHistory = history;
+		std::sort(sortedHistory.begin(), sortedHistory.end());
+		bSortedHistoryDirty = false;
+	}
+	return sortedHistory;
+}
+
+double ofFpsCounter::getFrameTimePercentile(double percentile) const{
+	auto & sorted = getSortedHistory();
+	if(sorted.empty()){
+		return 0;
+	}
+	percentile = std::min(std::max(percentile, 0.0), 100.0);
+	std::size_t index = std::min(sorted.size() - 1, std::size_t(percentile / 100.0 * sorted.size()));
+	return sorted[index] / 1e9;
+}
+
+ofFrameTimeStats ofFpsCounter::getFrameTimeStats() const{
+	ofFrameTimeStats stats;
+	auto & sorted = getSortedHistory();
+	if(sorted.empty()){
+		return stats;
+	}
+	stats.p50 = getFrameTimePercentile(50);
+	stats.p95 = getFrameTimePercentile(95);
+	stats.p99 = getFrameTimePercentile(99);
+	stats.max = sorted.back() / 1e9;
+	uint64_t sum = 0;
+	for(auto nanos : sorted){
+		sum += nanos;
+	}
+	stats.mean = sum / 1e9 / sorted.size();
+	stats.numFrames = sorted.size();
+	return stats;
+}
+
+std::vector<std::size_t> ofFpsCounter::getFrameTimeHistogram(std::size_t numBins, double maxSecs) const{
+	std::vector<std::size_t> bins(numBins, 0);
+	if(numBins == 0 || maxSecs <= 0){
+		return bins;
+	}
+	for(auto nanos : history){
+		std::size_t bin = std::size_t(nanos / 1e9 / maxSecs * numBins);
+		bins[std::min(bin, numBins - 1)]++;
+	}
+	return bins;
+}
+
+void ofFpsCounter::setSpikeThreshold(double thresholdSecs){
+	spikeThreshold = thresholdSecs > 0 ? uint64_t(thresholdSecs * 1e9) : 0;
+}
+
+void ofFpsCounter::setSpikeCallback(std::function<void(const ofFrameSpike &)> callback){
+	spikeCallback = callback;
+}
+
+void ofFpsCounter::setCaptureProfileOnSpike(bool capture){
+	bCaptureProfile = capture;
+}
+
+uint64_t ofFpsCounter::getNumSpikes() const{
+	return numSpikes;
+}
+
+const ofFrameSpike & ofFpsCounter::getLastSpike() const{
+	return lastSpike;
+}
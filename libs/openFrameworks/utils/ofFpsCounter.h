@@ -2,8 +2,31 @@
 
 #include "ofConstants.h"
 #include "ofUtils.h"
+#include "ofProfiler.h"
 #include <queue>
 
+/// \brief A frame that took longer than the spike threshold of an
+/// ofFpsCounter
+struct ofFrameSpike{
+	uint64_t frameNum = 0;
+	uint64_t nanos = 0;			///< duration of the frame
+	uint64_t medianNanos = 0;	///< median of the frames in the history
+	/// scopes of the last frame ofProfiler completed, if capturing them
+	/// was enabled and so was the profiler
+	std::vector<ofProfiler::Event> profile;
+};
+
+/// \brief Percentiles of the frame times in the history of an
+/// ofFpsCounter, in seconds
+struct ofFrameTimeStats{
+	double p50 = 0;
+	double p95 = 0;
+	double p99 = 0;
+	double max = 0;
+	double mean = 0;
+	std::size_t numFrames = 0;
+};
+
 class ofFpsCounter {
 public:
 	ofFpsCounter();
@@ -24,8 +47,43 @@ public:
 	double getLastFrameFilteredSecs() const;
 	void setFilterAlpha(float alpha);
 
+	// starts measuring again from targetFps, keeping the
+	// settings and the spike callback
+	void reset(double targetFps);
+
+	// number of frames the percentiles and the histogram
+	// are computed from, 600 by default
+	void setHistorySize(std::size_t frames);
+
+	// p50, p95, p99, max and mean of the frames in the
+	// history, the average hides the rare hitches these
+	// show up in
+	ofFrameTimeStats getFrameTimeStats() const;
+	double getFrameTimePercentile(double percentile) const;
+
+	// frames in the history counted in numBins bins
+	// from 0 to maxSecs, longer ones go in the last bin
+	std::vector<std::size_t> getFrameTimeHistogram(std::size_t numBins, double maxSecs) const;
+
+	// frames longer than thresholdSecs call the spike
+	// callback from newFrame(), 0 disables it
+	//
+	//     ofEvents().getFpsCounter().setSpikeThreshold(0.05);
+	//     ofEvents().getFpsCounter().setCaptureProfileOnSpike(true);
+	//     ofEvents().getFpsCounter().setSpikeCallback([](const ofFrameSpike & spike){
+	//         ofLogWarning() << "frame " << spike.frameNum << " took " << spike.nanos / 1000000 << "ms";
+	//     });
+	void setSpikeThreshold(double thresholdSecs);
+	void setSpikeCallback(std::function<void(const ofFrameSpike &)> callback);
+	// copies the scopes of the frame ofProfiler finished
+	// last into each spike, while the profiler is enabled
+	void setCaptureProfileOnSpike(bool capture);
+	uint64_t getNumSpikes() const;
+	const ofFrameSpike & getLastSpike() const;
+
 private:
 	void update(double now);
+	const std::vector<uint64_t> & getSortedHistory() const;
 	uint64_t nFrameCount;
 	ofTime then;
 	double fps;
@@ -33,4 +91,16 @@ private:
 	std::chrono::nanoseconds filteredTime;
 	double filterAlpha;
 	std::queue<double> timestamps;
+
+	std::vector<uint64_t> history;
+	std::size_t historySize;
+	std::size_t historyPos;
+	mutable std::vector<uint64_t> sortedHistory;
+	mutable bool bSortedHistoryDirty;
+
+	uint64_t spikeThreshold;
+	std::function<void(const ofFrameSpike &)> spikeCallback;
+	bool bCaptureProfile;
+	uint64_t numSpikes;
+	ofFrameSpike lastSpike;
 };
@@ -0,0 +1,339 @@
+#include "ofHttpCache.h"
+#include "ofURLFileLoader.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include <ctime>
+
+using namespace std;
+
+namespace{
+	struct CacheControl{
+		bool noStore = false;
+		bool noCache = false;
+		int64_t maxAge = -1;
+	};
+
+	CacheControl parseCacheControl(const map<string,string> & headers){
+		CacheControl cacheControl;
+		auto it = headers.find("cache-control");
+		if(it != headers.end()){
+			for(auto & directive: ofSplitString(ofToLower(it->second), ",", true, true)){
+				if(directive == "no-store"){
+					cacheControl.noStore = true;
+				}else if(directive == "no-cache"){
+					cacheControl.noCache = true;
+				}else if(directive.compare(0, 8, "max-age=") == 0){
+					cacheControl.maxAge = ofToInt64(directive.substr(8));
+				}
+			}
+		}
+		return cacheControl;
+	}
+
+	string getHeader(const map<string,string> & headers, const string & key){
+		auto it = headers.find(key);
+		return it == headers.end() ? "" : it->second;
+	}
+
+	int64_t now(){
+		return int64_t(time(nullptr));
+	}
+
+	const string indexFileName = "index.txt";
+}
+
+//----------------------------------------------------------
+ofHttpCache::ofHttpCache()
+:maxDiskSize(0)
+,maxMemorySize(0)
+,diskSize(0)
+,memorySize(0)
+,indexDirty(false){
+}
+
+//----------------------------------------------------------
+ofHttpCache::~ofHttpCache(){
+	std::lock_guard<std::mutex> lock(mutex);
+	if(indexDirty){
+		saveIndex();
+	}
+}
+
+//----------------------------------------------------------
+bool ofHttpCache::setup(const std::filesystem::path & dir, size_t maxDisk, size_t maxMemory){
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+	lru.clear();
+	diskSize = 0;
+	memorySize = 0;
+	directory = ofToDataPath(dir, true);
+	maxDiskSize = maxDisk;
+	maxMemorySize = maxMemory;
+	if(!ofDirectory::doesDirectoryExist(directory, false) && !ofDirectory::createDirectory(directory, false, true)){
+		ofLogError("ofHttpCache") << "setup(): couldn't create cache directory " << directory;
+		directory.clear();
+		return false;
+	}
+
+	// the index lists the responses from the most to the least recently
+	// used: file, expires, size, etag, last modified, url
+	auto indexPath = getPath(indexFileName);
+	if(ofFile::doesFileExist(indexPath, false)){
+		auto index = ofBufferFromFile(indexPath, false);
+		for(auto line: index.getLines()){
+			auto fields = ofSplitString(line, "\t");
+			if(fields.size() != 6 || entries.find(fields[5]) != entries.end()){
+				continue;
+			}
+			Entry entry;
+			entry.file = fields[0];
+			entry.expires = ofToInt64(fields[1]);
+			entry.size = ofToInt64(fields[2]);
+			entry.etag = fields[3];
+			entry.lastModified = fields[4];
+			ofFile body(getPath(entry.file), ofFile::Reference, true);
+			if(!body.exists() || body.getSize() != entry.size){
+				continue;
+			}
+			entry.lru = lru.insert(lru.end(), fields[5]);
+			diskSize += entry.size;
+			entries[fields[5]] = entry;
+		}
+	}
+	indexDirty = false;
+
+	// the limit might be smaller than on the last run
+	while(diskSize > maxDiskSize && !lru.empty()){
+		remove(lru.back());
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofHttpCache::clear(){
+	std::lock_guard<std::mutex> lock(mutex);
+	while(!lru.empty()){
+		remove(lru.back());
+	}
+	if(!directory.empty()){
+		saveIndex();
+	}
+}
+
+//----------------------------------------------------------
+ofHttpCache::Stats ofHttpCache::getStats() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+//----------------------------------------------------------
+void ofHttpCache::resetStats(){
+	std::lock_guard<std::mutex> lock(mutex);
+	stats = Stats();
+}
+
+//----------------------------------------------------------
+size_t ofHttpCache::size() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return entries.size();
+}
+
+//----------------------------------------------------------
+size_t ofHttpCache::getDiskSize() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return diskSize;
+}
+
+//----------------------------------------------------------
+size_t ofHttpCache::getMemorySize() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return memorySize;
+}
+
+//----------------------------------------------------------
+bool ofHttpCache::isCacheable(const ofHttpRequest & request) const{
+	return request.method == ofHttpRequest::GET
+		&& request.body.empty()
+		&& !request.saveTo
+		&& !request.chunkReceived;
+}
+
+//----------------------------------------------------------
+bool ofHttpCache::getFresh(const ofHttpRequest & request, ofHttpResponse & response){
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = entries.find(request.url);
+	if(it == entries.end() || it->second.expires <= now()){
+		return false;
+	}
+	touch(it->second);
+	auto data = load(request.url, it->second);
+	if(!data){
+		return false;
+	}
+	response = ofHttpResponse(request, *data, 200, "");
+	stats.hits++;
+	return true;
+}
+
+//----------------------------------------------------------
+map<string, string> ofHttpCache::getValidators(const ofHttpRequest & request) const{
+	std::lock_guard<std::mutex> lock(mutex);
+	map<string, string> validators;
+	auto it = entries.find(request.url);
+	if(it != entries.end()){
+		if(!it->second.etag.empty()){
+			validators["If-None-Match"] = it->second.etag;
+		}
+		if(!it->second.lastModified.empty()){
+			validators["If-Modified-Since"] = it->second.lastModified;
+		}
+	}
+	return validators;
+}
+
+//----------------------------------------------------------
+void ofHttpCache::update(ofHttpResponse & response){
+	std::lock_guard<std::mutex> lock(mutex);
+	if(directory.empty() || response.status <= 0){
+		return;
+	}
+	const auto & url = response.request.url;
+	auto cacheControl = parseCacheControl(response.headers);
+	int64_t expires = cacheControl.noCache || cacheControl.maxAge < 0 ? 0 : now() + cacheControl.maxAge;
+
+	if(response.status == 304){
+		auto it = entries.find(url);
+		if(it == entries.end()){
+			return;
+		}
+		touch(it->second);
+		it->second.expires = expires;
+		auto data = load(url, it->second);
+		if(data){
+			response.data = *data;
+			response.status = 200;
+			stats.revalidations++;
+			indexDirty = true;
+		}
+		return;
+	}
+
+	stats.misses++;
+	if(response.status != 200){
+		return;
+	}
+
+	Entry entry;
+	entry.etag = getHeader(response.headers, "etag");
+	entry.lastModified = getHeader(response.headers, "last-modified");
+	entry.expires = expires;
+	bool storable = !cacheControl.noStore
+		&& (expires > 0 || !entry.etag.empty() || !entry.lastModified.empty())
+		&& response.data.size() <= maxDiskSize;
+	if(storable){
+		store(url, entry, response.data);
+	}else if(entries.find(url) != entries.end()){
+		remove(url);
+		saveIndex();
+	}
+}
+
+//----------------------------------------------------------
+void ofHttpCache::touch(Entry & entry){
+	lru.splice(lru.begin(), lru, entry.lru);
+	indexDirty = true;
+}
+
+//----------------------------------------------------------
+shared_ptr<ofBuffer> ofHttpCache::load(const string & url, Entry & entry){
+	auto data = entry.data;
+	if(!data){
+		data = make_shared<ofBuffer>(ofBufferFromFile(getPath(entry.file), true));
+		if(data->size() != entry.size){
+			ofLogWarning("ofHttpCache") << "load(): stored response for " << url << " is missing or truncated, removing it";
+			remove(url);
+			return nullptr;
+		}
+		entry.data = data;
+		memorySize += entry.size;
+		trimMemory();
+	}
+	return data;
+}
+
+//----------------------------------------------------------
+void ofHttpCache::store(const string & url, Entry entry, const ofBuffer & data){
+	remove(url);
+	entry.file = ofToHex(std::hash<string>()(url));
+	// another url with the same hash would share the file
+	for(auto & other: entries){
+		if(other.second.file == entry.file){
+			auto otherUrl = other.first;
+			remove(otherUrl);
+			break;
+		}
+	}
+	if(!ofBufferToFile(getPath(entry.file), data, true)){
+		ofLogError("ofHttpCache") << "store(): couldn't write response for " << url;
+		return;
+	}
+	entry.size = data.size();
+	entry.data = make_shared<ofBuffer>(data);
+	entry.lru = lru.insert(lru.begin(), url);
+	entries[url] = entry;
+	diskSize += entry.size;
+	memorySize += entry.size;
+
+	while(diskSize > maxDiskSize && lru.size() > 1){
+		remove(lru.back());
+	}
+	trimMemory();
+	saveIndex();
+}
+
+//----------------------------------------------------------
+void ofHttpCache::remove(const string & url){
+	auto it = entries.find(url);
+	if(it == entries.end()){
+		return;
+	}
+	auto & entry = it->second;
+	ofFile::removeFile(getPath(entry.file), false);
+	diskSize -= entry.size;
+	if(entry.data){
+		memorySize -= entry.size;
+	}
+	lru.erase(entry.lru);
+	entries.erase(it);
+	indexDirty = true;
+}
+
+//----------------------------------------------------------
+void ofHttpCache::trimMemory(){
+	for(auto it = lru.rbegin(); it != lru.rend() && memorySize > maxMemorySize; ++it){
+		auto & entry = entries[*it];
+		if(entry.data){
+			entry.data.reset();
+			memorySize -= entry.size;
+		}
+	}
+}
+
+//----------------------------------------------------------
+void ofHttpCache::saveIndex(){
+	ofBuffer index;
+	for(auto & url: lru){
+		auto & entry = entries[url];
+		index.append(entry.file + "\t" + ofToString(entry.expires) + "\t" + ofToString(entry.size) + "\t" +
+			entry.etag + "\t" + entry.lastModified + "\t" + url + "\n");
+	}
+	if(!ofBufferToFile(getPath(indexFileName), index, false)){
+		ofLogError("ofHttpCache") << "saveIndex(): couldn't write cache index";
+	}
+	indexDirty = false;
+}
+
+//----------------------------------------------------------
+std::filesystem::path ofHttpCache::getPath(const string & file) const{
+	return directory / file;
+}
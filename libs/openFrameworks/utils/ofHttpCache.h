@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ofFileUtils.h"
+#include <list>
+#include <mutex>
+
+class ofHttpRequest;
+class ofHttpResponse;
+
+/// \brief Keeps the responses to GET requests on disk so repeating them
+/// doesn't need to go to the network
+///
+/// ~~~~{.cpp}
+/// void ofApp::setup(){
+///     auto cache = std::make_shared<ofHttpCache>();
+///     cache->setup("http_cache", 200 * 1024 * 1024);
+///     ofSetURLCache(cache);
+///     ofLoadURLAsync("http://example.com/tiles/0_0.png");
+/// }
+/// ~~~~
+///
+/// Responses are stored following their Cache-Control, ETag and
+/// Last-Modified headers: while they are fresh they are returned
+/// straight from the cache, once stale they are revalidated with the
+/// server and only downloaded again if they changed. When the cache grows
+/// over its maximum size the least recently used responses are removed,
+/// the most recently used are also kept in memory.
+///
+/// Requests with a body, saved to a file or streamed with chunkReceived
+/// always go to the network.
+class ofHttpCache{
+public:
+	struct Stats{
+		std::size_t hits = 0; //< requests answered without going to the network
+		std::size_t revalidations = 0; //< stale responses the server confirmed hadn't changed
+		std::size_t misses = 0; //< responses downloaded from the server
+	};
+
+	ofHttpCache();
+	~ofHttpCache();
+
+	/// \brief Loads the responses stored in directory by a previous run
+	/// \param directory where to store the responses, created if needed
+	/// \param maxDiskSize maximum size in bytes of the stored responses
+	/// \param maxMemorySize maximum size in bytes of the responses kept
+	/// in memory
+	/// \returns false if the directory can't be created
+	bool setup(const std::filesystem::path & directory, std::size_t maxDiskSize = 100 * 1024 * 1024, std::size_t maxMemorySize = 16 * 1024 * 1024);
+
+	/// \brief Removes all the stored responses from disk and memory
+	void clear();
+
+	Stats getStats() const;
+	void resetStats();
+
+	/// \brief Number of stored responses
+	std::size_t size() const;
+	std::size_t getDiskSize() const;
+	std::size_t getMemorySize() const;
+
+	/// \brief Whether request can be answered from the cache
+	bool isCacheable(const ofHttpRequest & request) const;
+
+	/// \brief Fills response with the stored one if it's still fresh
+	/// \returns false if the request has to go to the network
+	bool getFresh(const ofHttpRequest & request, ofHttpResponse & response);
+
+	/// \brief Headers to add to request so the server only sends the
+	/// response if it changed since it was stored
+	std::map<std::string, std::string> getValidators(const ofHttpRequest & request) const;
+
+	/// \brief Stores a response from the server, a 304 Not Modified is
+	/// replaced with the stored response
+	void update(ofHttpResponse & response);
+
+private:
+	struct Entry{
+		std::string file;
+		std::string etag;
+		std::string lastModified;
+		int64_t expires = 0;
+		std::size_t size = 0;
+		std::shared_ptr<ofBuffer> data;
+		std::list<std::string>::iterator lru;
+	};
+
+	void touch(Entry & entry);
+	std::shared_ptr<ofBuffer> load(const std::string & url, Entry & entry);
+	void store(const std::string & url, Entry entry, const ofBuffer & data);
+	void remove(const std::string & url);
+	void trimMemory();
+	void saveIndex();
+	std::filesystem::path getPath(const std::string & file) const;
+
+	std::filesystem::path directory;
+	std::size_t maxDiskSize;
+	std::size_t maxMemorySize;
+	std::size_t diskSize;
+	std::size_t memorySize;
+	std::map<std::string, Entry> entries;
+	std::list<std::string> lru;
+	Stats stats;
+	bool indexDirty;
+	mutable std::mutex mutex;
+};
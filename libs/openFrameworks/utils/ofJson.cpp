@@ -0,0 +1,934 @@
+#include "ofJson.h"
+#include "ofUtils.h"
+#include <cstring>
+#include <cerrno>
+
+using namespace std;
+
+namespace{
+	bool isJsonSpace(char c){
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	int hexValue(char c){
+		if(c >= '0' && c <= '9') return c - '0';
+		if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+}
+
+ofJsonStreamReader::ofJsonStreamReader(){
+	close();
+}
+
+bool ofJsonStreamReader::open(const std::filesystem::path & file, bool bRelativeToData){
+	close();
+	if(!this->file.open(file, bRelativeToData)){
+		setError("couldn't open " + file.string());
+		return false;
+	}
+	data = this->file.getData();
+	length = this->file.size();
+	return true;
+}
+
+bool ofJsonStreamReader::open(const ofBuffer & buffer){
+	return open(buffer.getData(), buffer.size());
+}
+
+bool ofJsonStreamReader::open(const char * data, size_t size){
+	close();
+	this->data = data;
+	length = data ? size : 0;
+	return true;
+}
+
+void ofJsonStreamReader::close(){
+	file.close();
+	data = nullptr;
+	length = 0;
+	pos = 0;
+	tokenStart = 0;
+	event = None;
+	state = ExpectValue;
+	key.clear();
+	value = nullptr;
+	containers.clear();
+	bInObject = false;
+	error.clear();
+}
+
+bool ofJsonStreamReader::setError(const string & error){
+	this->error = error;
+	event = None;
+	ofLogError("ofJsonStreamReader") << error;
+	return false;
+}
+
+bool ofJsonStreamReader::next(){
+	if(!error.empty()){
+		return false;
+	}
+	while(true){
+		for(; pos < length && isJsonSpace(data[pos]); pos++);
+		if(state == Done){
+			if(pos < length){
+				return setError("unexpected characters after the end of the document at " + ofToString(pos));
+			}
+			event = None;
+			return false;
+		}
+		if(pos == length){
+			return setError("unexpected end of the document");
+		}
+
+		char c = data[pos];
+		switch(state){
+		case ExpectCommaOrEnd:
+			if(c == ','){
+				pos++;
+				state = containers.back() == '{' ? ExpectKey : ExpectValue;
+				continue;
+			}
+			if(c == '}' || c == ']'){
+				return endContainer();
+			}
+			return setError("expected , or the end of the " + string(containers.back() == '{' ? "object" : "array") + " at " + ofToString(pos));
+
+		case ExpectKeyOrEnd:
+			if(c == '}'){
+				return endContainer();
+			}
+			// fallthrough
+		case ExpectKey:
+			if(c != '"' || !parseString(key)){
+				return error.empty() ? setError("expected a key at " + ofToString(pos)) : false;
+			}
+			for(; pos < length && isJsonSpace(data[pos]); pos++);
+			if(pos == length || data[pos] != ':'){
+				return setError("expected : after \"" + key + "\" at " + ofToString(pos));
+			}
+			pos++;
+			bInObject = true;
+			state = ExpectValue;
+			continue;
+
+		case ExpectValueOrEnd:
+			if(c == ']'){
+				return endContainer();
+			}
+			// fallthrough
+		case ExpectValue:
+			if(containers.empty() || containers.back() == '['){
+				key.clear();
+				bInObject = false;
+			}
+			return parseValue();
+
+		case Done:
+			break;
+		}
+	}
+}
+
+bool ofJsonStreamReader::endContainer(){
+	char c = data[pos];
+	if((c == '}') != (containers.back() == '{')){
+		return setError(string("unexpected ") + c + " at " + ofToString(pos));
+	}
+	pos++;
+	containers.pop_back();
+	event = c == '}' ? EndObject : EndArray;
+	state = containers.empty() ? Done : ExpectCommaOrEnd;
+	return true;
+}
+
+bool ofJsonStreamReader::parseValue(){
+	tokenStart = pos;
+	char c = data[pos];
+	if(c == '{' || c == '['){
+		pos++;
+		containers.push_back(c);
+		event = c == '{' ? StartObject : StartArray;
+		state = c == '{' ? ExpectKeyOrEnd : ExpectValueOrEnd;
+		return true;
+	}
+
+	if(c == '"'){
+		if(!parseString(text)){
+			return false;
+		}
+		value = text;
+	}else if(c == 't' && length - pos >= 4 && memcmp(data + pos, "true", 4) == 0){
+		value = true;
+		pos += 4;
+	}else if(c == 'f' && length - pos >= 5 && memcmp(data + pos, "false", 5) == 0){
+		value = false;
+		pos += 5;
+	}else if(c == 'n' && length - pos >= 4 && memcmp(data + pos, "null", 4) == 0){
+		value = nullptr;
+		pos += 4;
+	}else if(c == '-' || (c >= '0' && c <= '9')){
+		bool isFloat = false;
+		size_t end = pos;
+		for(; end < length; end++){
+			char n = data[end];
+			if(n == '.' || n == 'e' || n == 'E'){
+				isFloat = true;
+			}else if(!(n >= '0' && n <= '9') && n != '-' && n != '+'){
+				break;
+			}
+		}
+		text.assign(data + pos, end - pos);
+		char * parsedEnd;
+		errno = 0;
+		if(!isFloat && c == '-'){
+			value = int64_t(strtoll(text.c_str(), &parsedEnd, 10));
+		}else if(!isFloat){
+			value = uint64_t(strtoull(text.c_str(), &parsedEnd, 10));
+		}
+		if(isFloat || errno == ERANGE){
+			value = strtod(text.c_str(), &parsedEnd);
+		}
+		if(parsedEnd != text.c_str() + text.size()){
+			return setError("invalid number " + text + " at " + ofToString(pos));
+		}
+		pos = end;
+	}else{
+		return setError(string("unexpected ") + c + " at " + ofToString(pos));
+	}
+	event = Value;
+	state = containers.empty() ? Done : ExpectCommaOrEnd;
+	return true;
+}
+
+bool ofJsonStreamReader::parseString(string & dst){
+	size_t begin = pos++;
+	dst.clear();
+	while(pos < length){
+		size_t run = pos;
+		for(; pos < length && data[pos] != '"' && data[pos] != '\\'; pos++){
+			if((unsigned char)data[pos] < 0x20){
+				return setError("control character in string at " + ofToString(pos));
+			}
+		}
+		dst.append(data + run, pos - run);
+		if(pos == length){
+			break;
+		}
+		if(data[pos] == '"'){
+			pos++;
+			return true;
+		}
+
+		// escape sequence
+		if(length - pos < 2){
+			break;
+		}
+		char escaped = data[pos + 1];
+		pos += 2;
+		switch(escaped){
+		case '"': dst += '"'; break;
+		case '\\': dst += '\\'; break;
+		case '/': dst += '/'; break;
+		case 'b': dst += '\b'; break;
+		case 'f': dst += '\f'; break;
+		case 'n': dst += '\n'; break;
+		case 'r': dst += '\r'; break;
+		case 't': dst += '\t'; break;
+		case 'u':{
+			auto readCodeUnit = [this](uint32_t & unit){
+				if(length - pos < 4){
+					return false;
+				}
+				unit = 0;
+				for(int i = 0; i < 4; i++){
+					int digit = hexValue(data[pos + i]);
+					if(digit < 0){
+						return false;
+					}
+					unit = unit * 16 + digit;
+				}
+				pos += 4;
+				return true;
+			};
+			uint32_t codepoint;
+			if(!readCodeUnit(codepoint)){
+				return setError("invalid unicode escape at " + ofToString(pos));
+			}
+			if(codepoint >= 0xD800 && codepoint <= 0xDBFF){
+				// utf16 surrogate pair
+				uint32_t low;
+				if(length - pos < 2 || data[pos] != '\\' || data[pos + 1] != 'u'){
+					return setError("unpaired surrogate at " + ofToString(pos));
+				}
+				pos += 2;
+				if(!readCodeUnit(low) || low < 0xDC00 || low > 0xDFFF){
+					return setError("unpaired surrogate at " + ofToString(pos));
+				}
+				codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+			}else if(codepoint >= 0xDC00 && codepoint <= 0xDFFF){
+				return setError("unpaired surrogate at " + ofToString(pos));
+			}
+			utf8::append(codepoint, back_inserter(dst));
+		}break;
+		default:
+			return setError("invalid escape sequence at " + ofToString(pos - 2));
+		}
+	}
+	return setError("unclosed string at " + ofToString(begin));
+}
+
+bool ofJsonStreamReader::nextKey(const string & key){
+	while(next()){
+		if(event != EndObject && event != EndArray && bInObject && this->key == key){
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ofJsonStreamReader::findEndOfContainer(){
+	if(event != StartObject && event != StartArray){
+		return false;
+	}
+	// only brackets and strings matter to find the end, readValue
+	// validates the rest when parsing
+	size_t depth = 1;
+	bool inString = false;
+	for(; pos < length && depth > 0; pos++){
+		char c = data[pos];
+		if(inString){
+			if(c == '\\'){
+				pos++;
+			}else if(c == '"'){
+				inString = false;
+			}
+		}else if(c == '"'){
+			inString = true;
+		}else if(c == '{' || c == '['){
+			depth++;
+		}else if(c == '}' || c == ']'){
+			depth--;
+		}
+	}
+	if(depth > 0){
+		return setError("unexpected end of the document");
+	}
+	pos--;
+	return endContainer();
+}
+
+ofJson ofJsonStreamReader::readValue(){
+	if(event == Value){
+		return value;
+	}
+	size_t begin = tokenStart;
+	if(!findEndOfContainer()){
+		return ofJson();
+	}
+	try{
+		return ofJson::parse(data + begin, data + pos);
+	}catch(std::exception & e){
+		ofLogError("ofJsonStreamReader") << "readValue(): couldn't parse the value at " << begin << ": " << e.what();
+		return ofJson();
+	}
+}
+
+void ofJsonStreamReader::skipValue(){
+	findEndOfContainer();
+}
+
+ofJsonStreamReader::Event ofJsonStreamReader::getEvent() const{
+	return event;
+}
+
+const string & ofJsonStreamReader::getKey() const{
+	return key;
+}
+
+size_t ofJsonStreamReader::getDepth() const{
+	return containers.size() + (event == EndObject || event == EndArray ? 1 : 0);
+}
+
+const ofJson & ofJsonStreamReader::getValue() const{
+	return value;
+}
+
+bool ofJsonStreamReader::hasError() const{
+	return !error.empty();
+}
+
+const string & ofJsonStreamReader::getError() const{
+	return error;
+}
+
+size_t ofJsonStreamReader::getPosition() const{
+	return pos;
+}
+
+size_t ofJsonStreamReader::size() const{
+	return length;
+}
+
+namespace{
+	const uint32_t noIndex = ~uint32_t(0);
+	const uint64_t typeMask = 7;
+	const uint64_t escapedFlag = 8;
+	const int offsetShift = 8;
+}
+
+ofJsonView::ofJsonView()
+:doc(nullptr)
+,index(noIndex)
+,keyIndex(noIndex){}
+
+ofJsonView::ofJsonView(const ofJsonDocument * doc, uint32_t index, uint32_t keyIndex)
+:doc(doc)
+,index(index)
+,keyIndex(keyIndex){}
+
+ofJsonView::Type ofJsonView::getType() const{
+	return isValid() ? doc->getType(index) : Invalid;
+}
+
+bool ofJsonView::isValid() const{
+	return doc && index < doc->nodes.size();
+}
+
+bool ofJsonView::isNull() const{
+	return getType() == Null;
+}
+
+bool ofJsonView::isBool() const{
+	return getType() == Boolean;
+}
+
+bool ofJsonView::isNumber() const{
+	return getType() == Number;
+}
+
+bool ofJsonView::isString() const{
+	return getType() == String;
+}
+
+bool ofJsonView::isArray() const{
+	return getType() == Array;
+}
+
+bool ofJsonView::isObject() const{
+	return getType() == Object;
+}
+
+size_t ofJsonView::size() const{
+	auto type = getType();
+	return type == Array || type == Object ? doc->nodes[index].size : 0;
+}
+
+ofJsonView ofJsonView::operator[](const string & key) const{
+	if(!isObject()){
+		return ofJsonView();
+	}
+	uint32_t end = doc->nodes[index].next;
+	for(uint32_t i = index + 1; i < end; i = doc->nodes[i + 1].next){
+		if(doc->keyEquals(i, key.data(), key.size())){
+			return ofJsonView(doc, i + 1, i);
+		}
+	}
+	return ofJsonView();
+}
+
+ofJsonView ofJsonView::operator[](const char * key) const{
+	return (*this)[string(key)];
+}
+
+ofJsonView ofJsonView::operator[](size_t n) const{
+	if(!isArray() || n >= doc->nodes[index].size){
+		return ofJsonView();
+	}
+	uint32_t i = index + 1;
+	for(; n > 0; n--){
+		i = doc->nodes[i].next;
+	}
+	return ofJsonView(doc, i);
+}
+
+ofJsonView ofJsonView::operator[](int n) const{
+	return n < 0 ? ofJsonView() : (*this)[size_t(n)];
+}
+
+bool ofJsonView::contains(const string & key) const{
+	return (*this)[key].isValid();
+}
+
+string ofJsonView::getKey() const{
+	return isValid() && keyIndex != noIndex ? doc->getString(keyIndex) : string();
+}
+
+bool ofJsonView::getBool(bool defaultValue) const{
+	if(!isBool()){
+		return defaultValue;
+	}
+	return doc->data[doc->getOffset(index)] == 't';
+}
+
+int64_t ofJsonView::getInt(int64_t defaultValue) const{
+	double value;
+	int64_t integer;
+	bool bInteger;
+	if(!isNumber() || !doc->getNumber(index, value, integer, bInteger)){
+		return defaultValue;
+	}
+	return bInteger ? integer : int64_t(value);
+}
+
+double ofJsonView::getDouble(double defaultValue) const{
+	double value;
+	int64_t integer;
+	bool bInteger;
+	if(!isNumber() || !doc->getNumber(index, value, integer, bInteger)){
+		return defaultValue;
+	}
+	return bInteger ? double(integer) : value;
+}
+
+float ofJsonView::getFloat(float defaultValue) const{
+	return float(getDouble(defaultValue));
+}
+
+string ofJsonView::getString(const string & defaultValue) const{
+	return isString() ? doc->getString(index) : defaultValue;
+}
+
+ofJson ofJsonView::toJson() const{
+	return isValid() ? doc->toJson(index) : ofJson();
+}
+
+ofJsonView::const_iterator ofJsonView::begin() const{
+	auto type = getType();
+	if(type != Array && type != Object){
+		return end();
+	}
+	return const_iterator(doc, index + 1, type == Object);
+}
+
+ofJsonView::const_iterator ofJsonView::end() const{
+	auto type = getType();
+	if(type != Array && type != Object){
+		return const_iterator(doc, noIndex, false);
+	}
+	return const_iterator(doc, doc->nodes[index].next, type == Object);
+}
+
+ofJsonView::const_iterator::const_iterator(const ofJsonDocument * doc, uint32_t index, bool bObject)
+:doc(doc)
+,index(index)
+,bObject(bObject){}
+
+ofJsonView ofJsonView::const_iterator::operator*() const{
+	return bObject ? ofJsonView(doc, index + 1, index) : ofJsonView(doc, index);
+}
+
+ofJsonView::const_iterator & ofJsonView::const_iterator::operator++(){
+	// the key of a member is followed by its value
+	index = doc->nodes[bObject ? index + 1 : index].next;
+	return *this;
+}
+
+bool ofJsonView::const_iterator::operator==(const const_iterator & other) const{
+	return doc == other.doc && index == other.index;
+}
+
+bool ofJsonView::const_iterator::operator!=(const const_iterator & other) const{
+	return !(*this == other);
+}
+
+ofJsonDocument::ofJsonDocument()
+:data(nullptr)
+,length(0){}
+
+bool ofJsonDocument::load(const std::filesystem::path & file, bool bRelativeToData){
+	clear();
+	if(!this->file.open(file, bRelativeToData)){
+		return setError("couldn't open " + file.string());
+	}
+	data = this->file.getData();
+	length = this->file.size();
+	return index();
+}
+
+bool ofJsonDocument::parse(const ofBuffer & buffer){
+	return parse(buffer.getData(), buffer.size());
+}
+
+bool ofJsonDocument::parse(const char * data, size_t size){
+	clear();
+	this->data = data;
+	length = data ? size : 0;
+	return index();
+}
+
+void ofJsonDocument::clear(){
+	file.close();
+	data = nullptr;
+	length = 0;
+	nodes.clear();
+	error.clear();
+}
+
+ofJsonView ofJsonDocument::getRoot() const{
+	return nodes.empty() ? ofJsonView() : ofJsonView(this, 0);
+}
+
+bool ofJsonDocument::hasError() const{
+	return !error.empty();
+}
+
+const string & ofJsonDocument::getError() const{
+	return error;
+}
+
+size_t ofJsonDocument::getNumValues() const{
+	return nodes.size();
+}
+
+bool ofJsonDocument::setError(const string & error){
+	this->error = error;
+	nodes.clear();
+	ofLogError("ofJsonDocument") << error;
+	return false;
+}
+
+bool ofJsonDocument::index(){
+	enum State{
+		ExpectValue,
+		ExpectValueOrEnd,
+		ExpectKey,
+		ExpectKeyOrEnd,
+		ExpectCommaOrEnd,
+		Done,
+	};
+
+	// a rough guess that avoids most of the reallocations, a value every
+	// 8 bytes is typical of numeric data
+	nodes.reserve(length / 8 + 1);
+	vector<uint32_t> containers;
+	State state = ExpectValue;
+	size_t pos = 0;
+
+	auto addNode = [&](size_t offset, ofJsonView::Type type, bool bEscaped, uint32_t size){
+		Node node;
+		node.offsetAndType = (uint64_t(offset) << offsetShift) | uint64_t(type) | (bEscaped ? escapedFlag : 0);
+		node.next = uint32_t(nodes.size() + 1);
+		node.size = size;
+		nodes.push_back(node);
+	};
+
+	// finds the closing quote of the string starting at pos
+	auto scanString = [&](size_t & end, bool & bEscaped){
+		bEscaped = false;
+		for(end = pos + 1; end < length; end++){
+			char c = data[end];
+			if(c == '"'){
+				return true;
+			}
+			if(c == '\\'){
+				bEscaped = true;
+				end++;
+			}else if((unsigned char)c < 0x20){
+				return setError("control character in string at " + ofToString(end));
+			}
+		}
+		return setError("unclosed string at " + ofToString(pos));
+	};
+
+	if(length >= uint64_t(1) << (64 - offsetShift) || length / 2 >= noIndex){
+		return setError("the document is too big");
+	}
+
+	while(true){
+		for(; pos < length && isJsonSpace(data[pos]); pos++);
+		if(state == Done){
+			if(pos < length){
+				return setError("unexpected characters after the end of the document at " + ofToString(pos));
+			}
+			nodes.shrink_to_fit();
+			return true;
+		}
+		if(pos == length){
+			return setError("unexpected end of the document");
+		}
+
+		char c = data[pos];
+		switch(state){
+		case ExpectCommaOrEnd:
+			if(c == ','){
+				pos++;
+				state = getType(containers.back()) == ofJsonView::Object ? ExpectKey : ExpectValue;
+				continue;
+			}
+			if(c != '}' && c != ']'){
+				return setError("expected , or the end of the " + string(getType(containers.back()) == ofJsonView::Object ? "object" : "array") + " at " + ofToString(pos));
+			}
+			break;
+
+		case ExpectKeyOrEnd:
+			if(c == '}'){
+				break;
+			}
+			// fallthrough
+		case ExpectKey:{
+			size_t end;
+			bool bEscaped;
+			if(c != '"'){
+				return setError("expected a key at " + ofToString(pos));
+			}
+			if(!scanString(end, bEscaped)){
+				return false;
+			}
+			addNode(pos + 1, ofJsonView::String, bEscaped, uint32_t(end - pos - 1));
+			nodes[containers.back()].size++;
+			for(pos = end + 1; pos < length && isJsonSpace(data[pos]); pos++);
+			if(pos == length || data[pos] != ':'){
+				return setError("expected : after the key at " + ofToString(end + 1));
+			}
+			pos++;
+			state = ExpectValue;
+			continue;
+		}
+
+		case ExpectValueOrEnd:
+			if(c == ']'){
+				break;
+			}
+			// fallthrough
+		case ExpectValue:{
+			if(!containers.empty() && getType(containers.back()) == ofJsonView::Array){
+				nodes[containers.back()].size++;
+			}
+			if(c == '{' || c == '['){
+				containers.push_back(uint32_t(nodes.size()));
+				addNode(pos, c == '{' ? ofJsonView::Object : ofJsonView::Array, false, 0);
+				pos++;
+				state = c == '{' ? ExpectKeyOrEnd : ExpectValueOrEnd;
+				continue;
+			}
+			if(c == '"'){
+				size_t end;
+				bool bEscaped;
+				if(!scanString(end, bEscaped)){
+					return false;
+				}
+				addNode(pos + 1, ofJsonView::String, bEscaped, uint32_t(end - pos - 1));
+				pos = end + 1;
+			}else if(c == 't' && length - pos >= 4 && memcmp(data + pos, "true", 4) == 0){
+				addNode(pos, ofJsonView::Boolean, false, 4);
+				pos += 4;
+			}else if(c == 'f' && length - pos >= 5 && memcmp(data + pos, "false", 5) == 0){
+				addNode(pos, ofJsonView::Boolean, false, 5);
+				pos += 5;
+			}else if(c == 'n' && length - pos >= 4 && memcmp(data + pos, "null", 4) == 0){
+				addNode(pos, ofJsonView::Null, false, 4);
+				pos += 4;
+			}else if(c == '-' || (c >= '0' && c <= '9')){
+				size_t end = pos + 1;
+				for(; end < length; end++){
+					char n = data[end];
+					if(!(n >= '0' && n <= '9') && n != '.' && n != 'e' && n != 'E' && n != '-' && n != '+'){
+						break;
+					}
+				}
+				addNode(pos, ofJsonView::Number, false, uint32_t(end - pos));
+				pos = end;
+			}else{
+				return setError(string("unexpected ") + c + " at " + ofToString(pos));
+			}
+			state = containers.empty() ? Done : ExpectCommaOrEnd;
+			continue;
+		}
+
+		case Done:
+			continue;
+		}
+
+		// end of the current container
+		if((c == '}') != (getType(containers.back()) == ofJsonView::Object)){
+			return setError(string("unexpected ") + c + " at " + ofToString(pos));
+		}
+		pos++;
+		nodes[containers.back()].next = uint32_t(nodes.size());
+		containers.pop_back();
+		state = containers.empty() ? Done : ExpectCommaOrEnd;
+	}
+}
+
+uint64_t ofJsonDocument::getOffset(uint32_t index) const{
+	return nodes[index].offsetAndType >> offsetShift;
+}
+
+ofJsonView::Type ofJsonDocument::getType(uint32_t index) const{
+	return ofJsonView::Type(nodes[index].offsetAndType & typeMask);
+}
+
+bool ofJsonDocument::isEscaped(uint32_t index) const{
+	return (nodes[index].offsetAndType & escapedFlag) != 0;
+}
+
+bool ofJsonDocument::keyEquals(uint32_t index, const char * key, size_t keyLength) const{
+	if(!isEscaped(index)){
+		return nodes[index].size == keyLength && memcmp(data + getOffset(index), key, keyLength) == 0;
+	}
+	return getString(index) == string(key, keyLength);
+}
+
+string ofJsonDocument::getString(uint32_t index) const{
+	const char * str = data + getOffset(index);
+	size_t size = nodes[index].size;
+	if(!isEscaped(index)){
+		return string(str, size);
+	}
+
+	string dst;
+	dst.reserve(size);
+	size_t pos = 0;
+	auto invalid = [&](const char * what){
+		ofLogError("ofJsonDocument") << "getString(): " << what << " at " << getOffset(index) + pos;
+		return dst;
+	};
+	while(pos < size){
+		size_t run = pos;
+		for(; pos < size && str[pos] != '\\'; pos++);
+		dst.append(str + run, pos - run);
+		if(pos == size){
+			break;
+		}
+
+		// escape sequence, the index made sure there's a character after it
+		char escaped = str[pos + 1];
+		pos += 2;
+		switch(escaped){
+		case '"': dst += '"'; break;
+		case '\\': dst += '\\'; break;
+		case '/': dst += '/'; break;
+		case 'b': dst += '\b'; break;
+		case 'f': dst += '\f'; break;
+		case 'n': dst += '\n'; break;
+		case 'r': dst += '\r'; break;
+		case 't': dst += '\t'; break;
+		case 'u':{
+			auto readCodeUnit = [&](uint32_t & unit){
+				if(size - pos < 4){
+					return false;
+				}
+				unit = 0;
+				for(int i = 0; i < 4; i++){
+					int digit = hexValue(str[pos + i]);
+					if(digit < 0){
+						return false;
+					}
+					unit = unit * 16 + digit;
+				}
+				pos += 4;
+				return true;
+			};
+			uint32_t codepoint;
+			if(!readCodeUnit(codepoint)){
+				return invalid("invalid unicode escape");
+			}
+			if(codepoint >= 0xD800 && codepoint <= 0xDBFF){
+				// utf16 surrogate pair
+				uint32_t low;
+				if(size - pos < 2 || str[pos] != '\\' || str[pos + 1] != 'u'){
+					return invalid("unpaired surrogate");
+				}
+				pos += 2;
+				if(!readCodeUnit(low) || low < 0xDC00 || low > 0xDFFF){
+					return invalid("unpaired surrogate");
+				}
+				codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+			}else if(codepoint >= 0xDC00 && codepoint <= 0xDFFF){
+				return invalid("unpaired surrogate");
+			}
+			utf8::append(codepoint, back_inserter(dst));
+		}break;
+		default:
+			pos -= 2;
+			return invalid("invalid escape sequence");
+		}
+	}
+	return dst;
+}
+
+bool ofJsonDocument::getNumber(uint32_t index, double & value, int64_t & integer, bool & bInteger) const{
+	const char * str = data + getOffset(index);
+	size_t size = nodes[index].size;
+
+	// strtod needs the number to be null terminated, and the last one in a
+	// file might not be followed by anything
+	char local[64];
+	string copy;
+	const char * text;
+	if(size < sizeof(local)){
+		memcpy(local, str, size);
+		local[size] = 0;
+		text = local;
+	}else{
+		copy.assign(str, size);
+		text = copy.c_str();
+	}
+
+	bInteger = strpbrk(text, ".eE") == nullptr;
+	char * parsedEnd;
+	errno = 0;
+	if(bInteger){
+		integer = strtoll(text, &parsedEnd, 10);
+		if(errno == ERANGE){
+			bInteger = false;
+		}
+	}
+	if(!bInteger){
+		value = strtod(text, &parsedEnd);
+	}
+	if(parsedEnd != text + size){
+		ofLogError("ofJsonDocument") << "invalid number " << text << " at " << getOffset(index);
+		return false;
+	}
+	return true;
+}
+
+ofJson ofJsonDocument::toJson(uint32_t index) const{
+	switch(getType(index)){
+	case ofJsonView::Null:
+		return ofJson();
+	case ofJsonView::Boolean:
+		return data[getOffset(index)] == 't';
+	case ofJsonView::Number:{
+		double value;
+		int64_t integer;
+		bool bInteger;
+		if(!getNumber(index, value, integer, bInteger)){
+			return ofJson();
+		}
+		return bInteger ? ofJson(integer) : ofJson(value);
+	}
+	case ofJsonView::String:
+		return getString(index);
+	case ofJsonView::Array:{
+		ofJson array = ofJson::array();
+		for(uint32_t i = index + 1; i < nodes[index].next; i = nodes[i].next){
+			array.push_back(toJson(i));
+		}
+		return array;
+	}
+	case ofJsonView::Object:{
+		ofJson object = ofJson::object();
+		for(uint32_t i = index + 1; i < nodes[index].next; i = nodes[i + 1].next){
+			object[getString(i)] = toJson(i + 1);
+		}
+		return object;
+	}
+	default:
+		return ofJson();
+	}
+}
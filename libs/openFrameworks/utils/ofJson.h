@@ -9,6 +9,8 @@ using ofJson = nlohmann::json;
 
 
 /// \brief Load Json from the given path.
+///
+/// For big files that are only read see ofJsonDocument.
 /// \param filename The file to load from.
 /// \returns loaded json, or an empty json object on failure.
 inline ofJson ofLoadJson(const std::filesystem::path& filename){
@@ -93,9 +95,11 @@ inline void ofDeserialize(const ofJson & json, ofAbstractParameter & parameter){
 	if(json.find(name) != json.end()){
 		if(parameter.type() == typeid(ofParameterGroup).name()){
 			ofParameterGroup & group = static_cast <ofParameterGroup &>(parameter);
+			group.beginBatch();
 			for(auto & p: group){
 				ofDeserialize(json[name], *p);
 			}
+			group.endBatch();
 		}else{
 			if(parameter.type() == typeid(ofParameter <int> ).name() && json[name].is_number_integer()){
 				parameter.cast <int>() = json[name].get<int>();
@@ -113,3 +117,282 @@ inline void ofDeserialize(const ofJson & json, ofAbstractParameter & parameter){
 		}
 	}
 }
+
+/// \brief Reads a json document one value at a time without loading it
+///
+/// ofLoadJson parses the whole document in memory, which for files of
+/// hundreds of MB takes seconds and several times their size in memory.
+/// This pull parser goes through the document in place, from an ofBuffer
+/// or a memory mapped file, and only builds an ofJson for the values asked
+/// for:
+///
+/// ~~~~{.cpp}
+/// ofJsonStreamReader reader;
+/// reader.open("cues.json");
+/// while(reader.next()){
+///     if(reader.getEvent() == ofJsonStreamReader::StartObject && reader.getDepth() == 2){
+///         ofJson cue = reader.readValue();
+///         ...
+///     }
+/// }
+/// ~~~~
+class ofJsonStreamReader{
+public:
+	enum Event{
+		None,
+		StartObject,
+		EndObject,
+		StartArray,
+		EndArray,
+		Value,		///< a string, number, boolean or null
+	};
+
+	ofJsonStreamReader();
+
+	/// \brief Memory maps file, relative to the data folder by default
+	bool open(const std::filesystem::path & file, bool bRelativeToData = true);
+
+	/// \brief Reads from buffer, which has to stay alive and unchanged
+	/// while the reader is used
+	bool open(const ofBuffer & buffer);
+	bool open(const char * data, std::size_t size);
+	void close();
+
+	/// \brief Advances to the next value or the start or end of the next
+	/// object or array
+	/// \returns false at the end of the document or on errors
+	bool next();
+
+	/// \brief Advances to the next value, object or array that is a member
+	/// called key of an object at any depth, skipping everything in between
+	bool nextKey(const std::string & key);
+
+	Event getEvent() const;
+
+	/// \brief Name of the current value, object or array if it's a member of
+	/// an object, empty in arrays
+	const std::string & getKey() const;
+
+	/// \brief Number of objects and arrays the current event is in, counting
+	/// the one that starts or ends
+	std::size_t getDepth() const;
+
+	/// \brief The value of a Value event
+	const ofJson & getValue() const;
+
+	/// \brief Parses the object or array that just started, or returns the
+	/// current value, and advances to its end
+	/// \returns the value or a null ofJson on errors
+	ofJson readValue();
+
+	/// \brief Advances to the end of the object or array that just started
+	/// without decoding any of its contents
+	void skipValue();
+
+	bool hasError() const;
+	const std::string & getError() const;
+
+	/// \brief Offset in bytes of the parser in the document, together with
+	/// size() it can be used to show the loading progress
+	std::size_t getPosition() const;
+	std::size_t size() const;
+
+private:
+	enum State{
+		ExpectValue,
+		ExpectValueOrEnd,
+		ExpectKey,
+		ExpectKeyOrEnd,
+		ExpectCommaOrEnd,
+		Done,
+	};
+
+	bool setError(const std::string & error);
+	bool parseString(std::string & dst);
+	bool parseValue();
+	bool endContainer();
+	bool findEndOfContainer();
+
+	ofMappedBuffer file;
+	const char * data;
+	std::size_t length;
+	std::size_t pos;
+	std::size_t tokenStart;
+
+	Event event;
+	State state;
+	std::string key;
+	std::string text;
+	ofJson value;
+	std::vector<char> containers;
+	bool bInObject;
+	std::string error;
+};
+
+class ofJsonDocument;
+
+/// \brief A value in an ofJsonDocument, a small handle that is cheap to copy
+///
+/// Views on missing members or out of range indices are invalid, their
+/// getters return the default value, so chains like
+/// `doc.getRoot()["features"][0]["id"].getInt()` never throw. The view is
+/// only valid while its document is alive and not moved.
+class ofJsonView{
+public:
+	enum Type{
+		Invalid,	///< a missing member or index
+		Null,
+		Boolean,
+		Number,
+		String,
+		Array,
+		Object,
+	};
+
+	ofJsonView();
+
+	Type getType() const;
+	bool isValid() const;
+	bool isNull() const;
+	bool isBool() const;
+	bool isNumber() const;
+	bool isString() const;
+	bool isArray() const;
+	bool isObject() const;
+
+	/// \brief Number of elements of an array or members of an object, 0
+	/// for anything else
+	std::size_t size() const;
+
+	/// \brief The member called key of an object, searched member by member
+	ofJsonView operator[](const std::string & key) const;
+	ofJsonView operator[](const char * key) const;
+
+	/// \brief The element at index of an array, found by skipping the
+	/// previous ones, iterate to go through all of them
+	ofJsonView operator[](std::size_t index) const;
+	ofJsonView operator[](int index) const;
+
+	bool contains(const std::string & key) const;
+
+	/// \brief Name of the value if it was reached iterating an object
+	std::string getKey() const;
+
+	bool getBool(bool defaultValue = false) const;
+	int64_t getInt(int64_t defaultValue = 0) const;
+	double getDouble(double defaultValue = 0) const;
+	float getFloat(float defaultValue = 0) const;
+	/// \brief Decodes the string, escapes included
+	std::string getString(const std::string & defaultValue = "") const;
+
+	/// \brief Builds an ofJson with this value and everything in it, to
+	/// modify it or pass it to code that uses ofJson
+	ofJson toJson() const;
+
+	/// \brief Goes through the elements of an array or the values of the
+	/// members of an object, getKey() returns their names
+	class const_iterator{
+	public:
+		ofJsonView operator*() const;
+		const_iterator & operator++();
+		bool operator==(const const_iterator & other) const;
+		bool operator!=(const const_iterator & other) const;
+	private:
+		const_iterator(const ofJsonDocument * doc, uint32_t index, bool bObject);
+		const ofJsonDocument * doc;
+		uint32_t index;
+		bool bObject;
+		friend class ofJsonView;
+	};
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	ofJsonView(const ofJsonDocument * doc, uint32_t index, uint32_t keyIndex = ~uint32_t(0));
+
+	const ofJsonDocument * doc;
+	uint32_t index;
+	uint32_t keyIndex;
+	friend class ofJsonDocument;
+};
+
+/// \brief Read only json document for big files, parsed in place
+///
+/// ofLoadJson builds a tree of ofJson that takes several times the size of
+/// the file in memory and as long to allocate as to parse. This document
+/// memory maps the file and only indexes it in one pass. That index is 16
+/// bytes per value and finds where each value and the end of each object
+/// and array are. Nothing is decoded until it's read, numbers and strings
+/// are converted by the typed getters of ofJsonView and whole objects and
+/// arrays are skipped without looking at their contents:
+///
+/// ~~~~{.cpp}
+/// ofJsonDocument doc;
+/// if(doc.load("countries.geojson")){
+///     for(auto feature: doc.getRoot()["features"]){
+///         std::string name = feature["properties"]["name"].getString();
+///         for(auto point: feature["geometry"]["coordinates"][0]){
+///             line.addVertex(point[0].getDouble(), point[1].getDouble());
+///         }
+///     }
+/// }
+/// ~~~~
+///
+/// The structure of the document is validated when it's loaded, the
+/// contents of strings and numbers when they are read. Use ofJson to
+/// modify a document, ofJsonView::toJson() converts a part of it.
+class ofJsonDocument{
+public:
+	ofJsonDocument();
+
+	ofJsonDocument(const ofJsonDocument &) = delete;
+	ofJsonDocument & operator=(const ofJsonDocument &) = delete;
+	ofJsonDocument(ofJsonDocument &&) = default;
+	ofJsonDocument & operator=(ofJsonDocument &&) = default;
+
+	/// \brief Memory maps file, relative to the data folder by default, and
+	/// indexes it
+	bool load(const std::filesystem::path & file, bool bRelativeToData = true);
+
+	/// \brief Indexes buffer, which has to stay alive and unchanged while
+	/// the document is used
+	bool parse(const ofBuffer & buffer);
+	bool parse(const char * data, std::size_t size);
+	void clear();
+
+	/// \brief The top level value, invalid if nothing was loaded
+	ofJsonView getRoot() const;
+
+	bool hasError() const;
+	const std::string & getError() const;
+
+	/// \brief Number of values in the document, keys included
+	std::size_t getNumValues() const;
+
+private:
+	// one per value in document order, the children of objects and
+	// arrays follow them, the members of objects as a key and a value
+	struct Node{
+		uint64_t offsetAndType;	///< offset in the document << 8 | type, escaped flag
+		uint32_t next;			///< index of the next sibling, past the children
+		uint32_t size;			///< children of containers, bytes of strings and numbers
+	};
+
+	bool index();
+	bool setError(const std::string & error);
+	uint64_t getOffset(uint32_t index) const;
+	ofJsonView::Type getType(uint32_t index) const;
+	bool isEscaped(uint32_t index) const;
+	bool keyEquals(uint32_t index, const char * key, std::size_t length) const;
+	std::string getString(uint32_t index) const;
+	bool getNumber(uint32_t index, double & value, int64_t & integer, bool & bInteger) const;
+	ofJson toJson(uint32_t index) const;
+
+	ofMappedBuffer file;
+	const char * data;
+	std::size_t length;
+	std::vector<Node> nodes;
+	std::string error;
+	friend class ofJsonView;
+};
@@ -2,6 +2,7 @@
 #include "ofConstants.h"
 #include <ofUtils.h>
 #include <map>
+#include <chrono>
 #ifdef TARGET_ANDROID
 	#include "ofxAndroidLogChannel.h"
 #endif
@@ -9,6 +10,9 @@
 using namespace std;
 
 static ofLogLevel currentLogLevel =  OF_LOG_NOTICE;
+// the lowest of the global and every module level, anything below can be
+// rejected without looking up the module
+static ofLogLevel lowestLogLevel = OF_LOG_NOTICE;
 
 bool ofLog::bAutoSpace = false;
 string & ofLog::getPadding() {
@@ -35,14 +39,41 @@ shared_ptr<ofBaseLoggerChannel> & ofLog::channel(){
 	return channel;
 }
 
+//--------------------------------------------------
+static void updateLowestLogLevel(){
+	lowestLogLevel = currentLogLevel;
+	for(auto & module: getModules()){
+		lowestLogLevel = std::min(lowestLogLevel, module.second);
+	}
+}
+
+//--------------------------------------------------
+bool ofLogEnabled(ofLogLevel level, const char * module){
+	if(level < OF_LOG_MIN_LEVEL || level < lowestLogLevel){
+		return false;
+	}
+	return ofLogEnabled(level, string(module));
+}
+
+//--------------------------------------------------
+bool ofLogEnabled(ofLogLevel level, const string & module){
+	if(level < OF_LOG_MIN_LEVEL || level < lowestLogLevel){
+		return false;
+	}
+	auto it = getModules().find(module);
+	return level >= (it == getModules().end() ? currentLogLevel : it->second);
+}
+
 //--------------------------------------------------
 void ofSetLogLevel(ofLogLevel level){
 	currentLogLevel = level;
+	updateLowestLogLevel();
 }
 
 //--------------------------------------------------
 void ofSetLogLevel(string module, ofLogLevel level){
 	getModules()[module] = level;
+	updateLowestLogLevel();
 }
 
 //--------------------------------------------------
@@ -79,14 +110,14 @@ void ofLogToDebugView() {
 ofLog::ofLog(){
 	level = OF_LOG_NOTICE;
 	module = "";
-	bPrinted = false;
+	bPrinted = !checkLog(level, module);
 }
 		
 //--------------------------------------------------
 ofLog::ofLog(ofLogLevel _level){
 	level = _level;
 	module = "";
-	bPrinted = false;
+	bPrinted = !checkLog(level, module);
 }
 
 //--------------------------------------------------
@@ -126,12 +157,7 @@ ofLog::~ofLog(){
 }
 
 bool ofLog::checkLog(ofLogLevel level, const string & module){
-	if(getModules().find(module)==getModules().end()){
-		if(level >= currentLogLevel) return true;
-	}else{
-		if(level >= getModules()[module]) return true;
-	}
-	return false;
+	return ofLogEnabled(level, module);
 }
 
 //-------------------------------------------------------
@@ -145,7 +171,7 @@ void ofLog::_log(ofLogLevel level, const string & module, const string & message
 ofLogVerbose::ofLogVerbose(const string & _module){
 	level = OF_LOG_VERBOSE;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogVerbose::ofLogVerbose(const string & _module, const string & _message){
@@ -167,7 +193,7 @@ ofLogVerbose::ofLogVerbose(const string & module, const char* format, ...){
 ofLogNotice::ofLogNotice(const string & _module){
 	level = OF_LOG_NOTICE;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogNotice::ofLogNotice(const string & _module, const string & _message){
@@ -189,7 +215,7 @@ ofLogNotice::ofLogNotice(const string & module, const char* format, ...){
 ofLogWarning::ofLogWarning(const string & _module){
 	level = OF_LOG_WARNING;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogWarning::ofLogWarning(const string & _module, const string & _message){
@@ -211,7 +237,7 @@ ofLogWarning::ofLogWarning(const string & module, const char* format, ...){
 ofLogError::ofLogError(const string & _module){
 	level = OF_LOG_ERROR;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogError::ofLogError(const string & _module, const string & _message){
@@ -233,7 +259,7 @@ ofLogError::ofLogError(const string & module, const char* format, ...){
 ofLogFatalError::ofLogFatalError(const string &  _module){
 	level = OF_LOG_FATAL_ERROR;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogFatalError::ofLogFatalError(const string & _module, const string & _message){
@@ -398,3 +424,262 @@ void ofFileLoggerChannel::log(ofLogLevel level, const string & module, const cha
 	}
 	file << ofVAArgsToString(format,args) << endl;
 }
+
+//--------------------------------------------------
+static uint64_t asyncLoggerNowMillis(){
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(shared_ptr<ofBaseLoggerChannel> channel, size_t capacity)
+:channel(channel)
+,pushPos(0)
+,popPos(0)
+,numProcessed(0)
+,numDropped(0)
+,numDroppedFull(0)
+,dropPolicy(DropNewest)
+,rateLimits(make_shared<RateLimits>())
+,running(true){
+	size_t size = 2;
+	while(size < capacity){
+		size *= 2;
+	}
+	mask = size - 1;
+	records.reset(new Record[size]);
+	for(size_t i = 0; i < size; i++){
+		records[i].sequence.store(i, memory_order_relaxed);
+	}
+#ifndef TARGET_NO_THREADS
+	thread = std::thread(&ofAsyncLoggerChannel::threadedFunction, this);
+#endif
+}
+
+ofAsyncLoggerChannel::~ofAsyncLoggerChannel(){
+	{
+		unique_lock<std::mutex> lock(mutex);
+		running = false;
+	}
+	condition.notify_one();
+	if(thread.joinable()){
+		thread.join();
+	}
+	while(pop(true));
+	reportDropped();
+}
+
+void ofAsyncLoggerChannel::setDropPolicy(DropPolicy policy){
+	dropPolicy = policy;
+}
+
+ofAsyncLoggerChannel::DropPolicy ofAsyncLoggerChannel::getDropPolicy() const{
+	return DropPolicy(dropPolicy.load());
+}
+
+void ofAsyncLoggerChannel::setRateLimit(const string & module, size_t messagesPerSecond){
+	// the map is copied and replaced so logging can read it without a lock
+	unique_lock<std::mutex> lock(rateLimitsMutex);
+	auto limits = make_shared<RateLimits>(*atomic_load(&rateLimits));
+	if(messagesPerSecond == 0){
+		limits->erase(module);
+	}else{
+		auto limit = make_shared<RateLimit>();
+		limit->messagesPerSecond = messagesPerSecond;
+		limit->windowStart = asyncLoggerNowMillis();
+		limit->count = 0;
+		limit->dropped = 0;
+		(*limits)[module] = limit;
+	}
+	atomic_store(&rateLimits, shared_ptr<const RateLimits>(limits));
+}
+
+uint64_t ofAsyncLoggerChannel::getNumDropped() const{
+	return numDropped;
+}
+
+bool ofAsyncLoggerChannel::checkRateLimit(const string & module){
+	auto limits = atomic_load(&rateLimits);
+	auto it = limits->find(module);
+	if(it == limits->end()){
+		return true;
+	}
+	RateLimit & limit = *it->second;
+	uint64_t now = asyncLoggerNowMillis();
+	uint64_t windowStart = limit.windowStart.load(memory_order_relaxed);
+	if(now - windowStart >= 1000 && limit.windowStart.compare_exchange_strong(windowStart, now, memory_order_relaxed)){
+		limit.count.store(0, memory_order_relaxed);
+	}
+	if(limit.count.fetch_add(1, memory_order_relaxed) >= limit.messagesPerSecond){
+		limit.dropped++;
+		numDropped++;
+		return false;
+	}
+	return true;
+}
+
+ofAsyncLoggerChannel::Record * ofAsyncLoggerChannel::beginPush(size_t & pos){
+	pos = pushPos.load(memory_order_relaxed);
+	while(true){
+		Record * record = &records[pos & mask];
+		size_t sequence = record->sequence.load(memory_order_acquire);
+		intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+		if(diff == 0){
+			if(pushPos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)){
+				return record;
+			}
+		}else if(diff < 0){
+			// full
+			switch(getDropPolicy()){
+				case DropNewest:
+					numDropped++;
+					numDroppedFull++;
+					return nullptr;
+				case DropOldest:
+					if(pop(false)){
+						numDropped++;
+						numDroppedFull++;
+					}
+					break;
+				case Block:
+					condition.notify_one();
+					std::this_thread::yield();
+					break;
+			}
+			pos = pushPos.load(memory_order_relaxed);
+		}else{
+			pos = pushPos.load(memory_order_relaxed);
+		}
+	}
+}
+
+void ofAsyncLoggerChannel::endPush(Record * record, size_t pos){
+	record->sequence.store(pos + 1, memory_order_release);
+}
+
+bool ofAsyncLoggerChannel::pop(bool write){
+	size_t pos = popPos.load(memory_order_relaxed);
+	Record * record;
+	while(true){
+		record = &records[pos & mask];
+		size_t sequence = record->sequence.load(memory_order_acquire);
+		intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+		if(diff == 0){
+			if(popPos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)){
+				break;
+			}
+		}else if(diff < 0){
+			return false;
+		}else{
+			pos = popPos.load(memory_order_relaxed);
+		}
+	}
+	if(write){
+		// as strings, as char pointers the message would be taken as a format
+		channel->log(record->level, string(record->module), string(record->message));
+	}
+	record->sequence.store(pos + mask + 1, memory_order_release);
+	numProcessed++;
+	return true;
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const string & message){
+	if(!checkRateLimit(module)){
+		return;
+	}
+	size_t pos;
+	Record * record = beginPush(pos);
+	if(record == nullptr){
+		return;
+	}
+	record->level = level;
+	size_t moduleLength = min(module.size(), maxModuleLength);
+	memcpy(record->module, module.data(), moduleLength);
+	record->module[moduleLength] = 0;
+	size_t messageLength = min(message.size(), maxMessageLength);
+	memcpy(record->message, message.data(), messageLength);
+	record->message[messageLength] = 0;
+	endPush(record, pos);
+#ifdef TARGET_NO_THREADS
+	while(pop(true));
+#endif
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const char* format, ...){
+	va_list args;
+	va_start(args, format);
+	log(level, module, format, args);
+	va_end(args);
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const char* format, va_list args){
+	if(!checkRateLimit(module)){
+		return;
+	}
+	size_t pos;
+	Record * record = beginPush(pos);
+	if(record == nullptr){
+		return;
+	}
+	record->level = level;
+	size_t moduleLength = min(module.size(), maxModuleLength);
+	memcpy(record->module, module.data(), moduleLength);
+	record->module[moduleLength] = 0;
+	// formatted straight into the record, vsnprintf truncates
+	vsnprintf(record->message, maxMessageLength + 1, format, args);
+	endPush(record, pos);
+#ifdef TARGET_NO_THREADS
+	while(pop(true));
+#endif
+}
+
+void ofAsyncLoggerChannel::flush(){
+	size_t target = pushPos.load();
+#ifndef TARGET_NO_THREADS
+	if(thread.joinable() && std::this_thread::get_id() != thread.get_id()){
+		while(numProcessed.load() < target){
+			condition.notify_one();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return;
+	}
+#endif
+	while(numProcessed.load() < target && pop(true));
+}
+
+void ofAsyncLoggerChannel::reportDropped(){
+	uint64_t full = numDroppedFull.exchange(0);
+	if(full > 0){
+		channel->log(OF_LOG_WARNING, "ofAsyncLoggerChannel", "dropped " + ofToString(full) + " messages, the queue was full");
+	}
+	auto limits = atomic_load(&rateLimits);
+	for(auto & limit: *limits){
+		uint64_t dropped = limit.second->dropped.exchange(0);
+		if(dropped > 0){
+			channel->log(OF_LOG_WARNING, "ofAsyncLoggerChannel", "dropped " + ofToString(dropped) + " messages from " + (limit.first.empty() ? string("no module") : limit.first) + " over its rate limit");
+		}
+	}
+}
+
+void ofAsyncLoggerChannel::threadedFunction(){
+	uint64_t lastReport = asyncLoggerNowMillis();
+	while(running){
+		bool written = false;
+		while(pop(true)){
+			written = true;
+		}
+		// the dropped messages are summarized once per second at most
+		uint64_t now = asyncLoggerNowMillis();
+		if(now - lastReport >= 1000){
+			reportDropped();
+			lastReport = now;
+		}
+		if(!written){
+			// producers never lock, so they can't reliably wake this
+			// thread up, waiting with a timeout polls the queue instead
+			unique_lock<std::mutex> lock(mutex);
+			if(running){
+				condition.wait_for(lock, std::chrono::milliseconds(10));
+			}
+		}
+	}
+}
+
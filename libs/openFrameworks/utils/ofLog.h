@@ -3,6 +3,10 @@
 #include "ofConstants.h"
 #include "ofFileUtils.h"
 #include "ofTypes.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 /// \file
 /// ofLog provides an interface for writing text output from your app.
@@ -195,6 +199,45 @@ ofLogLevel ofGetLogLevel(std::string module);
 /// \returns The log level name as a string.
 std::string ofGetLogLevelName(ofLogLevel level, bool pad=false);
 
+/// \brief The lowest level compiled in, messages below it are never logged.
+///
+/// Define it in the build flags, for example `-DOF_LOG_MIN_LEVEL=OF_LOG_NOTICE`,
+/// to remove the verbose messages logged with the OFLOG_ macros from the
+/// binary.
+#ifndef OF_LOG_MIN_LEVEL
+#define OF_LOG_MIN_LEVEL OF_LOG_VERBOSE
+#endif
+
+/// \brief Check if a message would be logged, without building it.
+///
+/// Rejecting a level below every level set is a comparison, only levels at
+/// or above it look up the module.
+/// \param level The log level.
+/// \param module The target module.
+/// \returns True if a message for this level and module would be logged.
+bool ofLogEnabled(ofLogLevel level, const char * module = "");
+bool ofLogEnabled(ofLogLevel level, const std::string & module);
+
+/// \brief Stream logging that doesn't evaluate what's streamed unless the
+/// message is logged.
+///
+/// `ofLogVerbose("module") << expensive()` calls expensive() even if
+/// verbose messages are disabled. These macros skip the whole statement
+/// instead, and below OF_LOG_MIN_LEVEL they compile to nothing:
+///
+/// ~~~~{.cpp}
+/// OFLOG_VERBOSE("ofGstUtils") << "position " << getPosition();
+/// ~~~~
+///
+/// The module is required, use "" for none.
+#define OFLOG_LEVEL(level, logClass, module) \
+	if((level) < OF_LOG_MIN_LEVEL || !ofLogEnabled((level), (module))){}else logClass(module)
+#define OFLOG_VERBOSE(module) OFLOG_LEVEL(OF_LOG_VERBOSE, ofLogVerbose, module)
+#define OFLOG_NOTICE(module) OFLOG_LEVEL(OF_LOG_NOTICE, ofLogNotice, module)
+#define OFLOG_WARNING(module) OFLOG_LEVEL(OF_LOG_WARNING, ofLogWarning, module)
+#define OFLOG_ERROR(module) OFLOG_LEVEL(OF_LOG_ERROR, ofLogError, module)
+#define OFLOG_FATAL_ERROR(module) OFLOG_LEVEL(OF_LOG_FATAL_ERROR, ofLogFatalError, module)
+
 /// \}
 
 //--------------------------------------------------
@@ -448,7 +491,9 @@ class ofLog{
 		/// \returns A reference to itself.
 		template <class T> 
 			ofLog& operator<<(const T& value){
-			message << value << getPadding();
+			if(!bPrinted){
+				message << value << getPadding();
+			}
 			return *this;
 		}
 	
@@ -460,7 +505,9 @@ class ofLog{
 		/// \param func A function pointer that takes a std::ostream as an argument.
 		/// \returns A reference to itself.
 		ofLog& operator<<(std::ostream& (*func)(std::ostream&)){
-			func(message);
+			if(!bPrinted){
+				func(message);
+			}
 			return *this;
 		}
 	
@@ -473,7 +520,7 @@ class ofLog{
 		/// \cond INTERNAL
 
 		ofLogLevel level; ///< Log level.
-		bool bPrinted;	  ///< Has the message been printed in the constructor?
+		bool bPrinted;	  ///< Has the message been printed in the constructor or been filtered out?
 		std::string module;    ///< The destination module for this message.
 		
 		/// \brief Print a log line.
@@ -691,4 +738,106 @@ private:
 	
 };
 
+/// \brief A logger channel that hands its messages to a background thread
+/// which writes them to another channel.
+///
+/// Logging to the console or a file waits for the output, which can make a
+/// thread miss its deadline, for example the audio callback. The messages
+/// are copied to a fixed size record in a lock-free queue instead and
+/// written from a background thread, logging never allocates, locks or
+/// waits for I/O unless the drop policy is Block:
+///
+/// ~~~~{.cpp}
+/// auto async = std::make_shared<ofAsyncLoggerChannel>();
+/// async->setRateLimit("ofSoundStream", 10);
+/// ofSetLoggerChannel(async);
+/// ~~~~
+///
+/// Messages longer than maxMessageLength are truncated.
+class ofAsyncLoggerChannel: public ofBaseLoggerChannel{
+public:
+	/// \brief What to do with a message when the queue is full.
+	enum DropPolicy{
+		DropNewest,	///< Discard the new message, the default.
+		DropOldest,	///< Discard the oldest message waiting to be written.
+		Block,		///< Wait for the background thread to make space.
+	};
+
+	static const std::size_t maxModuleLength = 63;
+	static const std::size_t maxMessageLength = 1023;
+
+	/// \brief Create an ofAsyncLoggerChannel.
+	/// \param channel The channel the messages are written to, by default
+	/// the current one.
+	/// \param capacity The number of messages the queue can hold, rounded
+	/// up to a power of 2.
+	ofAsyncLoggerChannel(std::shared_ptr<ofBaseLoggerChannel> channel = ofGetLoggerChannel(), std::size_t capacity = 1024);
+
+	/// \brief Write any message still in the queue and stop the thread.
+	virtual ~ofAsyncLoggerChannel();
+
+	ofAsyncLoggerChannel(const ofAsyncLoggerChannel &) = delete;
+	ofAsyncLoggerChannel & operator=(const ofAsyncLoggerChannel &) = delete;
+
+	void log(ofLogLevel level, const std::string & module, const std::string & message);
+	void log(ofLogLevel level, const std::string & module, const char* format, ...) OF_PRINTF_ATTR(4, 5);
+	void log(ofLogLevel level, const std::string & module, const char* format, va_list args);
+
+	void setDropPolicy(DropPolicy policy);
+	DropPolicy getDropPolicy() const;
+
+	/// \brief Limit the messages of a module to a number per second, the
+	/// rest are dropped and counted in a summary message.
+	/// \param module The module, "" for messages without one.
+	/// \param messagesPerSecond The maximum, 0 removes the limit.
+	void setRateLimit(const std::string & module, std::size_t messagesPerSecond);
+
+	/// \brief Number of messages dropped because the queue was full or
+	/// over their rate limit, since the channel was created.
+	uint64_t getNumDropped() const;
+
+	/// \brief Wait until every message logged before the call is written.
+	void flush();
+
+private:
+	struct Record{
+		std::atomic<std::size_t> sequence;
+		ofLogLevel level;
+		char module[maxModuleLength + 1];
+		char message[maxMessageLength + 1];
+	};
+	struct RateLimit{
+		std::size_t messagesPerSecond;
+		std::atomic<uint64_t> windowStart;
+		std::atomic<std::size_t> count;
+		std::atomic<uint64_t> dropped;
+	};
+	typedef std::map<std::string, std::shared_ptr<RateLimit>> RateLimits;
+
+	bool checkRateLimit(const std::string & module);
+	Record * beginPush(std::size_t & pos);
+	void endPush(Record * record, std::size_t pos);
+	bool pop(bool write);
+	void threadedFunction();
+	void reportDropped();
+
+	std::shared_ptr<ofBaseLoggerChannel> channel;
+	std::unique_ptr<Record[]> records;
+	std::size_t mask;
+	std::atomic<std::size_t> pushPos;
+	std::atomic<std::size_t> popPos;
+	std::atomic<std::size_t> numProcessed;
+	std::atomic<uint64_t> numDropped;
+	std::atomic<uint64_t> numDroppedFull;
+	std::atomic<int> dropPolicy;
+
+	std::shared_ptr<const RateLimits> rateLimits;
+	std::mutex rateLimitsMutex;
+
+	std::atomic<bool> running;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::thread thread;
+};
+
 /// \endcond
@@ -8,6 +8,7 @@
 #include "ofMatrixStack.h"
 #include "ofAppBaseWindow.h"
 #include "ofBaseTypes.h"
+#include "ofMathBatch.h"
 
 using namespace std;
 
@@ -19,6 +20,9 @@ ofMatrixStack::ofMatrixStack(const ofAppBaseWindow * window)
 ,currentWindow(const_cast<ofAppBaseWindow*>(window))
 ,currentMatrixMode(OF_MATRIX_MODELVIEW)
 ,currentMatrix(&modelViewMatrix)
+,modelViewProjectionDirty(true)
+,orientedProjectionDirty(true)
+,normalMatrixDirty(true)
 ,flipRenderSurfaceMatrix(true)
 {
 
@@ -79,9 +83,9 @@ void ofMatrixStack::setOrientation(ofOrientation _orientation, bool vFlip){
 		}
 	}
 
-	orientationMatrixInverse = glm::inverse(orientationMatrix);
-	orientedProjectionMatrix = orientationMatrix * projectionMatrix;
-	modelViewProjectionMatrix = orientedProjectionMatrix * modelViewMatrix;
+	orientationMatrixInverse = ofInvertMatrix(orientationMatrix);
+	orientedProjectionDirty = true;
+	modelViewProjectionDirty = true;
 }
 
 ofOrientation ofMatrixStack::getOrientation() const{
@@ -184,6 +188,10 @@ const glm::mat4 & ofMatrixStack::getViewMatrix() const{
 }
 
 const glm::mat4 & ofMatrixStack::getProjectionMatrix() const{
+	if(orientedProjectionDirty){
+		orientedProjectionMatrix = ofMultiplyMatrices(orientationMatrix, projectionMatrix);
+		orientedProjectionDirty = false;
+	}
 	return orientedProjectionMatrix;
 }
 
@@ -192,6 +200,10 @@ const glm::mat4 & ofMatrixStack::getModelViewMatrix() const{
 }
 
 const glm::mat4 & ofMatrixStack::getModelViewProjectionMatrix() const{
+	if(modelViewProjectionDirty){
+		modelViewProjectionMatrix = ofMultiplyMatrices(getProjectionMatrix(), modelViewMatrix);
+		modelViewProjectionDirty = false;
+	}
 	return modelViewProjectionMatrix;
 }
 
@@ -215,6 +227,14 @@ const glm::mat4 & ofMatrixStack::getOrientationMatrixInverse() const{
 	return orientationMatrixInverse;
 }
 
+const glm::mat4 & ofMatrixStack::getNormalMatrix() const{
+	if(normalMatrixDirty){
+		normalMatrix = glm::transpose(ofInvertMatrix(modelViewMatrix));
+		normalMatrixDirty = false;
+	}
+	return normalMatrix;
+}
+
 void ofMatrixStack::pushView(){
 	viewportHistory.push(currentViewport);
 
@@ -412,11 +432,12 @@ void ofMatrixStack::multViewMatrix(const glm::mat4 & matrix){
 void ofMatrixStack::updatedRelatedMatrices(){
 	switch(currentMatrixMode){
 	case OF_MATRIX_MODELVIEW:
-		modelViewProjectionMatrix = orientedProjectionMatrix * modelViewMatrix;
+		modelViewProjectionDirty = true;
+		normalMatrixDirty = true;
 		break;
 	case OF_MATRIX_PROJECTION:
-		orientedProjectionMatrix = orientationMatrix * projectionMatrix;
-		modelViewProjectionMatrix = orientedProjectionMatrix * modelViewMatrix;
+		orientedProjectionDirty = true;
+		modelViewProjectionDirty = true;
 		break;
 	default:
 		break;
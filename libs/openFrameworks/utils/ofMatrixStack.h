@@ -44,6 +44,10 @@ public:
 	const glm::mat4 & getOrientationMatrix() const;
 	const glm::mat4 & getOrientationMatrixInverse() const;
 
+	/// \brief Inverse transpose of the model view matrix, to transform
+	/// normals to eye space
+	const glm::mat4 & getNormalMatrix() const;
+
 	ofMatrixMode getCurrentMatrixMode() const;
 
 	ofHandednessType getHandedness() const;
@@ -85,11 +89,19 @@ private:
 	glm::mat4 modelViewMatrix;
 	glm::mat4 projectionMatrix;
 	glm::mat4 textureMatrix;
-	glm::mat4 modelViewProjectionMatrix;
-	glm::mat4 orientedProjectionMatrix;
 	glm::mat4 orientationMatrix;
 	glm::mat4 orientationMatrixInverse;
 
+	// derived from the matrices above, only recalculated when requested
+	// after any of them changed, transformations and push / pop don't
+	// multiply or invert anything
+	mutable glm::mat4 modelViewProjectionMatrix;
+	mutable glm::mat4 orientedProjectionMatrix;
+	mutable glm::mat4 normalMatrix;
+	mutable bool modelViewProjectionDirty;
+	mutable bool orientedProjectionDirty;
+	mutable bool normalMatrixDirty;
+
 	glm::mat4 * currentMatrix;
 
 	std::stack <ofRectangle> viewportHistory;
@@ -0,0 +1,314 @@
+#include "ofMetrics.h"
+#include "ofAppRunner.h"
+#include "ofRenderStats.h"
+#include "ofGpuMemory.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include "ofMath.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace{
+	// splits name{labels} into name and the labels without the braces
+	void splitName(const string & fullName, string & name, string & labels){
+		auto brace = fullName.find('{');
+		if(brace == string::npos){
+			name = fullName;
+			labels.clear();
+		}else{
+			name = fullName.substr(0, brace);
+			labels = fullName.substr(brace + 1, fullName.size() - brace - 2);
+		}
+	}
+
+	string withLabels(const string & name, const string & labels, const string & extra = ""){
+		if(labels.empty() && extra.empty()){
+			return name;
+		}
+		if(labels.empty()){
+			return name + "{" + extra + "}";
+		}
+		if(extra.empty()){
+			return name + "{" + labels + "}";
+		}
+		return name + "{" + labels + "," + extra + "}";
+	}
+
+	const char * gpuMemoryTypeName(ofGpuMemoryType type){
+		switch(type){
+			case OF_GPU_MEMORY_TEXTURE: return "texture";
+			case OF_GPU_MEMORY_RENDERBUFFER: return "renderbuffer";
+			case OF_GPU_MEMORY_BUFFER: return "buffer";
+			default: return "unknown";
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofMetricHistogram::ofMetricHistogram(const vector<double> & bounds)
+:bounds(bounds)
+,buckets(new atomic<uint64_t>[bounds.size() + 1]){
+	sort(this->bounds.begin(), this->bounds.end());
+	reset();
+}
+
+//----------------------------------------------------------
+void ofMetricHistogram::observe(double value){
+	size_t bucket = lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+	buckets[bucket].fetch_add(1, memory_order_relaxed);
+	sum.add(value);
+}
+
+//----------------------------------------------------------
+const vector<double> & ofMetricHistogram::getBounds() const{
+	return bounds;
+}
+
+//----------------------------------------------------------
+vector<uint64_t> ofMetricHistogram::getBucketCounts() const{
+	vector<uint64_t> counts(bounds.size() + 1);
+	for(size_t i = 0; i < counts.size(); i++){
+		counts[i] = buckets[i].load(memory_order_relaxed);
+	}
+	return counts;
+}
+
+//----------------------------------------------------------
+uint64_t ofMetricHistogram::getCount() const{
+	uint64_t count = 0;
+	for(size_t i = 0; i <= bounds.size(); i++){
+		count += buckets[i].load(memory_order_relaxed);
+	}
+	return count;
+}
+
+//----------------------------------------------------------
+double ofMetricHistogram::getSum() const{
+	return sum.get();
+}
+
+//----------------------------------------------------------
+double ofMetricHistogram::getQuantile(double q) const{
+	auto counts = getBucketCounts();
+	uint64_t count = 0;
+	for(auto c : counts){
+		count += c;
+	}
+	if(count == 0 || bounds.empty()){
+		return 0;
+	}
+	double rank = ofClamp(q, 0, 1) * count;
+	uint64_t below = 0;
+	for(size_t i = 0; i < counts.size(); i++){
+		if(counts[i] > 0 && below + counts[i] >= rank){
+			// the last bucket has no upper bound, its values are at least
+			// the last bound
+			if(i == bounds.size()){
+				return bounds.back();
+			}
+			double lower = i == 0 ? min(0.0, bounds[0]) : bounds[i - 1];
+			return lower + (bounds[i] - lower) * (rank - below) / counts[i];
+		}
+		below += counts[i];
+	}
+	return bounds.back();
+}
+
+//----------------------------------------------------------
+void ofMetricHistogram::reset(){
+	for(size_t i = 0; i <= bounds.size(); i++){
+		buckets[i].store(0, memory_order_relaxed);
+	}
+	sum.set(0);
+}
+
+//----------------------------------------------------------
+ofMetrics::ofMetrics()
+:enabled(false)
+,sampleInterval(1)
+,lastSample(0){
+	frames = &getCounter("of_frames_total", "Frames drawn");
+	fps = &getGauge("of_fps", "Frame rate");
+	frameTimes = &getHistogram("of_frame_time_seconds", "Time between frames",
+		{0.004, 0.008, 0.0125, 0.0167, 0.02, 0.025, 0.0333, 0.05, 0.1, 0.25, 1});
+}
+
+//----------------------------------------------------------
+void ofMetrics::setEnabled(bool enabled){
+	this->enabled = enabled;
+}
+
+//----------------------------------------------------------
+bool ofMetrics::isEnabled() const{
+	return enabled;
+}
+
+//----------------------------------------------------------
+void ofMetrics::setSampleInterval(float seconds){
+	sampleInterval = seconds;
+}
+
+//----------------------------------------------------------
+ofMetrics::Metric & ofMetrics::getMetric(const string & name, const string & help, Type type){
+	auto it = metrics.find(name);
+	if(it == metrics.end()){
+		it = metrics.emplace(name, Metric()).first;
+		it->second.type = type;
+		it->second.help = help;
+	}else if(it->second.type != type){
+		ofLogError("ofMetrics") << "metric " << name << " already exists with another type";
+	}
+	return it->second;
+}
+
+//----------------------------------------------------------
+ofMetricCounter & ofMetrics::getCounter(const string & name, const string & help){
+	std::unique_lock<std::mutex> lock(mutex);
+	auto & metric = getMetric(name, help, Counter);
+	if(!metric.counter){
+		metric.counter.reset(new ofMetricCounter);
+	}
+	return *metric.counter;
+}
+
+//----------------------------------------------------------
+ofMetricGauge & ofMetrics::getGauge(const string & name, const string & help){
+	std::unique_lock<std::mutex> lock(mutex);
+	auto & metric = getMetric(name, help, Gauge);
+	if(!metric.gauge){
+		metric.gauge.reset(new ofMetricGauge);
+	}
+	return *metric.gauge;
+}
+
+//----------------------------------------------------------
+ofMetricHistogram & ofMetrics::getHistogram(const string & name, const string & help, const vector<double> & bounds){
+	std::unique_lock<std::mutex> lock(mutex);
+	auto & metric = getMetric(name, help, Histogram);
+	if(!metric.histogram){
+		metric.histogram.reset(new ofMetricHistogram(bounds));
+	}
+	return *metric.histogram;
+}
+
+//----------------------------------------------------------
+void ofMetrics::setGaugeFunction(const string & name, const string & help, function<double()> read){
+	std::unique_lock<std::mutex> lock(mutex);
+	auto & metric = getMetric(name, help, Gauge);
+	if(!metric.gauge){
+		metric.gauge.reset(new ofMetricGauge);
+	}
+	metric.read = read;
+}
+
+//----------------------------------------------------------
+void ofMetrics::update(){
+	if(!enabled){
+		return;
+	}
+	frames->add();
+	fps->set(ofGetFrameRate());
+	double frameTime = ofGetLastFrameTime();
+	if(frameTime > 0){
+		frameTimes->observe(frameTime);
+	}
+
+	auto now = ofGetElapsedTimeMicros();
+	if(lastSample == 0 || now - lastSample >= sampleInterval * 1000000){
+		lastSample = now;
+		sample();
+	}
+}
+
+//----------------------------------------------------------
+void ofMetrics::sample(){
+	auto & stats = ofGetRenderStats();
+	getGauge("of_render_draw_calls", "Draw calls in the last frame").set(stats.drawCalls);
+	getGauge("of_render_triangles", "Triangles drawn in the last frame").set(stats.triangles);
+	getGauge("of_render_state_changes", "GL state changes in the last frame").set(stats.stateChanges);
+	getGauge("of_render_texture_upload_bytes", "Bytes uploaded to textures in the last frame").set(stats.textureUploadBytes);
+	getGauge("of_render_buffer_upload_bytes", "Bytes uploaded to buffers in the last frame").set(stats.bufferUploadBytes);
+
+	for(int i = 0; i < OF_GPU_MEMORY_NUM_TYPES; i++){
+		auto type = ofGpuMemoryType(i);
+		auto usage = ofGetGpuMemoryUsage(type);
+		string labels = string("{type=\"") + gpuMemoryTypeName(type) + "\"}";
+		getGauge("of_gpu_memory_bytes" + labels, "GPU memory allocated by ofTexture, ofFbo and ofBufferObject").set(usage.bytes);
+		getGauge("of_gpu_memory_peak_bytes" + labels, "Most GPU memory ever allocated").set(usage.peakBytes);
+	}
+
+	// the functions are called without the lock, they might create metrics
+	vector<pair<function<double()>, ofMetricGauge*>> reads;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for(auto & metric : metrics){
+			if(metric.second.read){
+				reads.emplace_back(metric.second.read, metric.second.gauge.get());
+			}
+		}
+	}
+	for(auto & read : reads){
+		read.second->set(read.first());
+	}
+}
+
+//----------------------------------------------------------
+string ofMetrics::getPrometheusText() const{
+	ostringstream text;
+	text << setprecision(15);
+	string lastName;
+	string name, labels;
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto & entry : metrics){
+		auto & metric = entry.second;
+		splitName(entry.first, name, labels);
+		if(name != lastName){
+			if(!metric.help.empty()){
+				text << "# HELP " << name << " " << metric.help << "\n";
+			}
+			text << "# TYPE " << name << " ";
+			switch(metric.type){
+				case Counter: text << "counter\n"; break;
+				case Gauge: text << "gauge\n"; break;
+				case Histogram: text << "histogram\n"; break;
+			}
+			lastName = name;
+		}
+		switch(metric.type){
+			case Counter:
+				text << entry.first << " " << metric.counter->get() << "\n";
+				break;
+			case Gauge:
+				text << entry.first << " " << metric.gauge->get() << "\n";
+				break;
+			case Histogram:{
+				auto & bounds = metric.histogram->getBounds();
+				auto counts = metric.histogram->getBucketCounts();
+				// prometheus buckets count everything up to their bound
+				uint64_t count = 0;
+				for(size_t i = 0; i < counts.size(); i++){
+					count += counts[i];
+					ostringstream bound;
+					if(i < bounds.size()){
+						bound << setprecision(15) << bounds[i];
+					}else{
+						bound << "+Inf";
+					}
+					text << withLabels(name + "_bucket", labels, "le=\"" + bound.str() + "\"") << " " << count << "\n";
+				}
+				text << withLabels(name + "_sum", labels) << " " << metric.histogram->getSum() << "\n";
+				text << withLabels(name + "_count", labels) << " " << count << "\n";
+			}break;
+		}
+	}
+	return text.str();
+}
+
+//----------------------------------------------------------
+ofMetrics & ofGetMetrics(){
+	static ofMetrics metrics;
+	return metrics;
+}
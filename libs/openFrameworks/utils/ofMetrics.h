@@ -0,0 +1,159 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
+/// \brief A value that only goes up, like the number of frames dropped
+class ofMetricCounter{
+public:
+	ofMetricCounter():value(0){}
+	void add(uint64_t n = 1){ value.fetch_add(n, std::memory_order_relaxed); }
+	uint64_t get() const{ return value.load(std::memory_order_relaxed); }
+private:
+	std::atomic<uint64_t> value;
+};
+
+/// \brief A value that goes up and down, like the bytes in a queue
+class ofMetricGauge{
+public:
+	ofMetricGauge():value(0){}
+	void set(double v){ value.store(v, std::memory_order_relaxed); }
+	void add(double v){
+		double current = value.load(std::memory_order_relaxed);
+		while(!value.compare_exchange_weak(current, current + v, std::memory_order_relaxed));
+	}
+	double get() const{ return value.load(std::memory_order_relaxed); }
+private:
+	std::atomic<double> value;
+};
+
+/// \brief Counts the values observed in buckets, like the frame times
+///
+/// Each bucket counts the values up to its bound, the last one everything
+/// bigger. Observing a value is a search in the bounds and an atomic add.
+class ofMetricHistogram{
+public:
+	ofMetricHistogram(const std::vector<double> & bounds);
+
+	void observe(double value);
+
+	/// \brief Upper bounds of the buckets, sorted
+	const std::vector<double> & getBounds() const;
+	/// \brief Count of each bucket, one more than the bounds
+	std::vector<uint64_t> getBucketCounts() const;
+	uint64_t getCount() const;
+	double getSum() const;
+
+	/// \brief Estimates the value below which a fraction q of the values
+	/// are, interpolating inside the bucket it falls in
+	double getQuantile(double q) const;
+
+	/// \brief Empties every bucket
+	void reset();
+
+private:
+	std::vector<double> bounds;
+	std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+	ofMetricGauge sum;
+};
+
+/// \brief Registry of the counters, gauges and histograms an app exports to
+/// its monitoring
+///
+/// Once enabled, ofMainLoop records the frame rate and the frame times
+/// every frame, and samples the renderer stats and the GPU memory
+/// regularly. The sound streams and video capture and recording count
+/// their xruns and dropped frames in it even when it's disabled.
+///
+/// Metrics are created the first time they are asked for and live as long
+/// as the app, so the references can be kept and updated from any thread
+/// without looking them up again:
+///
+/// ~~~~{.cpp}
+/// ofMetricCounter & received = ofGetMetrics().getCounter("app_messages_received_total", "Messages received");
+///
+/// void ofApp::setup(){
+///     ofGetMetrics().setEnabled(true);
+///     // read from the main thread every second
+///     ofGetMetrics().setGaugeFunction("app_tcp_queue_bytes", "Bytes waiting to be sent", [this]{
+///         return client.getSendQueueSize();
+///     });
+/// }
+///
+/// void ofApp::onMessage(){
+///     received.add();
+/// }
+/// ~~~~
+///
+/// Names follow the Prometheus conventions and can have labels,
+/// `of_video_capture_dropped_frames_total{device="0"}`. getPrometheusText()
+/// formats them all to be served by an exporter like ofxMetricsServer.
+class ofMetrics{
+public:
+	ofMetrics();
+
+	ofMetrics(const ofMetrics &) = delete;
+	ofMetrics & operator=(const ofMetrics &) = delete;
+
+	/// \brief Records the frames and samples the gauge functions, disabled
+	/// by default
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	/// \brief Seconds between calls to the gauge functions, 1 by default
+	void setSampleInterval(float seconds);
+
+	ofMetricCounter & getCounter(const std::string & name, const std::string & help = "");
+	ofMetricGauge & getGauge(const std::string & name, const std::string & help = "");
+	/// \brief The bounds are only used the first time the histogram is
+	/// asked for
+	ofMetricHistogram & getHistogram(const std::string & name, const std::string & help, const std::vector<double> & bounds);
+
+	/// \brief A gauge set to what read returns, called from the main thread
+	/// every sample interval so it can query GL or objects that aren't
+	/// thread safe. nullptr stops calling the previous one
+	void setGaugeFunction(const std::string & name, const std::string & help, std::function<double()> read);
+
+	/// \brief Every metric in the Prometheus text format, from any thread
+	std::string getPrometheusText() const;
+
+	/// \brief Called by ofMainLoop every frame
+	void update();
+
+private:
+	enum Type{
+		Counter,
+		Gauge,
+		Histogram,
+	};
+	struct Metric{
+		Type type;
+		std::string help;
+		std::unique_ptr<ofMetricCounter> counter;
+		std::unique_ptr<ofMetricGauge> gauge;
+		std::unique_ptr<ofMetricHistogram> histogram;
+		std::function<double()> read;
+	};
+
+	Metric & getMetric(const std::string & name, const std::string & help, Type type);
+	void sample();
+
+	std::atomic<bool> enabled;
+	float sampleInterval;
+	uint64_t lastSample;
+
+	mutable std::mutex mutex;
+	// sorted by name so the labels of a metric are next to each other
+	std::map<std::string, Metric> metrics;
+
+	// only used from the main thread
+	ofMetricCounter * frames;
+	ofMetricGauge * fps;
+	ofMetricHistogram * frameTimes;
+};
+
+/// \brief The registry ofMainLoop and the core subsystems record to
+ofMetrics & ofGetMetrics();
@@ -0,0 +1,410 @@
+#include "ofProfiler.h"
+#include "ofAllocationTracker.h"
+#include "ofGraphics.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include "ofMath.h"
+#include <map>
+
+using namespace std;
+
+thread_local ofProfiler::ThreadData * ofProfiler::currentThread = nullptr;
+
+namespace{
+	const uint32_t noThread = numeric_limits<uint32_t>::max();
+
+	string escapeJson(const char * str){
+		string escaped;
+		for(; *str; str++){
+			switch(*str){
+				case '"': escaped += "\\\""; break;
+				case '\\': escaped += "\\\\"; break;
+				case '\n': escaped += "\\n"; break;
+				case '\t': escaped += "\\t"; break;
+				default:
+					if((unsigned char)*str < 0x20){
+						escaped += ' ';
+					}else{
+						escaped += *str;
+					}
+			}
+		}
+		return escaped;
+	}
+}
+
+//----------------------------------------------------------
+ofProfiler::ofProfiler()
+:enabled(false)
+,startTime(chrono::steady_clock::now())
+,mainThread(noThread)
+,historySize(120)
+,bCapturing(false)
+,frameStart(0)
+,gpuOffset(0)
+,gpuCalibrationTime(0)
+,gpuSupported(-1){
+	gpuThread = addThread("GPU").index;
+}
+
+//----------------------------------------------------------
+ofProfiler::~ofProfiler(){
+	// the GL context might not exist anymore at exit, so the queries
+	// aren't deleted, they go with it
+}
+
+//----------------------------------------------------------
+void ofProfiler::setEnabled(bool enabled){
+	this->enabled = enabled;
+}
+
+//----------------------------------------------------------
+bool ofProfiler::isEnabled() const{
+	return enabled.load(memory_order_relaxed);
+}
+
+//----------------------------------------------------------
+uint64_t ofProfiler::now() const{
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count();
+}
+
+//----------------------------------------------------------
+ofProfiler::ThreadData & ofProfiler::addThread(const string & name){
+	unique_ptr<ThreadData> thread(new ThreadData);
+	thread->profiler = this;
+	thread->name = name;
+	lock_guard<std::mutex> lock(mutex);
+	thread->index = threads.size();
+	threads.push_back(move(thread));
+	return *threads.back();
+}
+
+//----------------------------------------------------------
+ofProfiler::ThreadData & ofProfiler::getThreadData(){
+	if(currentThread == nullptr || currentThread->profiler != this){
+		size_t index;
+		{
+			lock_guard<std::mutex> lock(mutex);
+			index = threads.size();
+		}
+		currentThread = &addThread("thread " + ofToString(index));
+	}
+	return *currentThread;
+}
+
+//----------------------------------------------------------
+void ofProfiler::setThreadName(const string & name){
+	ThreadData & thread = getThreadData();
+	lock_guard<std::mutex> lock(mutex);
+	thread.name = name;
+}
+
+//----------------------------------------------------------
+void ofProfiler::begin(const char * name){
+	ThreadData & thread = getThreadData();
+	lock_guard<std::mutex> lock(thread.mutex);
+	thread.open.push_back(thread.events.size());
+	// the allocations so far, end() keeps the difference
+	thread.events.push_back({name, now(), 0, thread.index, uint32_t(thread.open.size() - 1), ofAllocationTracker::getThreadTotal().allocations});
+}
+
+//----------------------------------------------------------
+void ofProfiler::end(){
+	ThreadData & thread = getThreadData();
+	lock_guard<std::mutex> lock(thread.mutex);
+	if(thread.open.empty()){
+		return;
+	}
+	Event & event = thread.events[thread.open.back()];
+	event.end = now();
+	event.allocations = ofAllocationTracker::getThreadTotal().allocations - event.allocations;
+	thread.open.pop_back();
+}
+
+//----------------------------------------------------------
+void ofProfiler::beginGpu(const char * name){
+#ifndef TARGET_OPENGLES
+	if(gpuSupported < 0){
+		gpuSupported = (GLEW_VERSION_3_3 || GLEW_ARB_timer_query) ? 1 : 0;
+		if(!gpuSupported){
+			ofLogWarning("ofProfiler") << "beginGpu(): timer queries not supported, GPU scopes will be empty";
+		}
+	}
+	if(!gpuSupported){
+		return;
+	}
+	GpuQuery query;
+	query.name = name;
+	query.depth = openGpuQueries.size();
+	query.ended = false;
+	for(auto id: {&query.begin, &query.end}){
+		if(freeGpuQueries.empty()){
+			glGenQueries(1, id);
+		}else{
+			*id = freeGpuQueries.back();
+			freeGpuQueries.pop_back();
+		}
+	}
+	glQueryCounter(query.begin, GL_TIMESTAMP);
+	openGpuQueries.push_back(gpuQueries.size());
+	gpuQueries.push_back(query);
+#endif
+}
+
+//----------------------------------------------------------
+void ofProfiler::endGpu(){
+#ifndef TARGET_OPENGLES
+	if(gpuSupported != 1 || openGpuQueries.empty()){
+		return;
+	}
+	GpuQuery & query = gpuQueries[openGpuQueries.back()];
+	glQueryCounter(query.end, GL_TIMESTAMP);
+	query.ended = true;
+	openGpuQueries.pop_back();
+#endif
+}
+
+//----------------------------------------------------------
+void ofProfiler::collectGpuQueries(vector<Event> & events){
+#ifndef TARGET_OPENGLES
+	if(gpuSupported != 1){
+		return;
+	}
+	// the GL clock is converted to the profiler's, recalibrating once in
+	// a while in case they drift apart
+	uint64_t cpuNow = now();
+	if(gpuCalibrationTime == 0 || cpuNow - gpuCalibrationTime > 1000000000){
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		gpuOffset = int64_t(cpuNow) - int64_t(gpuNow);
+		gpuCalibrationTime = cpuNow;
+	}
+
+	// the results arrive in order, stop at the first one that isn't ready
+	while(!gpuQueries.empty() && gpuQueries.front().ended){
+		GpuQuery & query = gpuQueries.front();
+		GLint available = 0;
+		glGetQueryObjectiv(query.end, GL_QUERY_RESULT_AVAILABLE, &available);
+		if(!available){
+			break;
+		}
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+		events.push_back({query.name, uint64_t(int64_t(begin) + gpuOffset), uint64_t(int64_t(end) + gpuOffset), gpuThread, query.depth, 0});
+		freeGpuQueries.push_back(query.begin);
+		freeGpuQueries.push_back(query.end);
+		gpuQueries.pop_front();
+	}
+#endif
+}
+
+//----------------------------------------------------------
+void ofProfiler::newFrame(){
+	uint64_t frameEnd = now();
+	if(!isEnabled()){
+		frameStart = frameEnd;
+		return;
+	}
+	ThreadData & caller = getThreadData();
+
+	Frame frame;
+	frame.start = frameStart;
+	frame.end = frameEnd;
+	collectGpuQueries(frame.events);
+
+	lock_guard<std::mutex> lock(mutex);
+	if(mainThread == noThread){
+		mainThread = caller.index;
+		caller.name = "main";
+	}
+	for(auto & thread: threads){
+		lock_guard<std::mutex> threadLock(thread->mutex);
+		// scopes still open stay, with everything nested in them
+		size_t complete = thread->open.empty() ? thread->events.size() : thread->open.front();
+		frame.events.insert(frame.events.end(), thread->events.begin(), thread->events.begin() + complete);
+		thread->events.erase(thread->events.begin(), thread->events.begin() + complete);
+		for(auto & index: thread->open){
+			index -= complete;
+		}
+	}
+
+	if(bCapturing){
+		capture.push_back({"frame", frame.start, frame.end, mainThread, 0, 0});
+		capture.insert(capture.end(), frame.events.begin(), frame.events.end());
+	}
+	history.push_back(move(frame));
+	while(history.size() > historySize){
+		history.pop_front();
+	}
+	frameStart = frameEnd;
+}
+
+//----------------------------------------------------------
+void ofProfiler::setHistorySize(size_t frames){
+	lock_guard<std::mutex> lock(mutex);
+	historySize = max(frames, size_t(1));
+	while(history.size() > historySize){
+		history.pop_front();
+	}
+}
+
+//----------------------------------------------------------
+void ofProfiler::startCapture(){
+	lock_guard<std::mutex> lock(mutex);
+	capture.clear();
+	bCapturing = true;
+}
+
+//----------------------------------------------------------
+void ofProfiler::stopCapture(){
+	lock_guard<std::mutex> lock(mutex);
+	bCapturing = false;
+}
+
+//----------------------------------------------------------
+bool ofProfiler::isCapturing() const{
+	lock_guard<std::mutex> lock(mutex);
+	return bCapturing;
+}
+
+//----------------------------------------------------------
+vector<ofProfiler::Event> ofProfiler::getLastFrame() const{
+	lock_guard<std::mutex> lock(mutex);
+	if(history.empty()){
+		return vector<Event>();
+	}
+	return history.back().events;
+}
+
+//----------------------------------------------------------
+uint32_t ofProfiler::getGpuThread() const{
+	return gpuThread;
+}
+
+//----------------------------------------------------------
+vector<string> ofProfiler::getThreadNames() const{
+	lock_guard<std::mutex> lock(mutex);
+	vector<string> names;
+	for(auto & thread: threads){
+		names.push_back(thread->name);
+	}
+	return names;
+}
+
+//----------------------------------------------------------
+bool ofProfiler::saveChromeTrace(const std::filesystem::path & path) const{
+	ofFile file(path, ofFile::WriteOnly);
+	if(!file.is_open()){
+		ofLogError("ofProfiler") << "saveChromeTrace(): couldn't open " << path;
+		return false;
+	}
+	lock_guard<std::mutex> lock(mutex);
+	file << "{\"traceEvents\":[\n";
+	for(auto & thread: threads){
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->index
+			<< ",\"args\":{\"name\":\"" << escapeJson(thread->name.c_str()) << "\"}},\n";
+	}
+	file << std::fixed << std::setprecision(3);
+	for(size_t i = 0; i < capture.size(); i++){
+		const Event & event = capture[i];
+		// complete events, in microseconds
+		file << "{\"name\":\"" << escapeJson(event.name) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+			<< ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0
+			<< ",\"args\":{\"allocations\":" << event.allocations << "}}"
+			<< (i + 1 < capture.size() ? ",\n" : "\n");
+	}
+	file << "]}\n";
+	return true;
+}
+
+//----------------------------------------------------------
+void ofProfiler::draw(float x, float y) const{
+	struct Scope{
+		string name;
+		uint32_t thread;
+		uint64_t total;
+		uint64_t allocations;
+	};
+	vector<Scope> scopes;
+	vector<uint64_t> frameTimes;
+	uint64_t totalFrameTime = 0;
+	{
+		lock_guard<std::mutex> lock(mutex);
+		if(history.empty()){
+			return;
+		}
+		// the outermost scopes of the main thread and the GPU, in the order
+		// they appeared in the last frame
+		map<pair<string, uint32_t>, size_t> indices;
+		for(auto it = history.rbegin(); it != history.rend(); ++it){
+			for(auto & event: it->events){
+				if(event.depth != 0 || (event.thread != mainThread && event.thread != gpuThread)){
+					continue;
+				}
+				auto key = make_pair(string(event.name), event.thread);
+				auto index = indices.find(key);
+				if(index == indices.end()){
+					index = indices.insert(make_pair(key, scopes.size())).first;
+					scopes.push_back({key.first, event.thread, 0, 0});
+				}
+				scopes[index->second].total += event.end - event.start;
+				scopes[index->second].allocations += event.allocations;
+			}
+		}
+		for(auto & frame: history){
+			frameTimes.push_back(frame.end - frame.start);
+			totalFrameTime += frame.end - frame.start;
+		}
+	}
+
+	double frames = frameTimes.size();
+	double frameMs = totalFrameTime / frames / 1000000.0;
+	const float lineHeight = 14;
+	const float barWidth = 120;
+	const float graphHeight = 40;
+	bool showAllocations = ofGetAllocationTracker().isEnabled();
+	float width = showAllocations ? 330 : 250;
+	float height = (scopes.size() + 1) * lineHeight + graphHeight + 16;
+
+	ofPushStyle();
+	ofFill();
+	ofSetColor(0, 180);
+	ofDrawRectangle(x, y, width, height);
+
+	float lineY = y + lineHeight;
+	ofSetColor(255);
+	ofDrawBitmapString("frame " + ofToString(frameMs, 2) + "ms", x + 4, lineY);
+	for(auto & scope: scopes){
+		lineY += lineHeight;
+		double ms = scope.total / frames / 1000000.0;
+		ofSetColor(scope.thread == gpuThread ? ofColor(200, 120, 60) : ofColor(60, 160, 220));
+		ofDrawRectangle(x + 4, lineY - lineHeight + 4, barWidth * ofClamp(ms / frameMs, 0, 1), lineHeight - 3);
+		ofSetColor(255);
+		string label = (scope.thread == gpuThread ? "gpu " : "") + scope.name + " " + ofToString(ms, 2) + "ms";
+		if(showAllocations && scope.thread != gpuThread){
+			label += " " + ofToString(scope.allocations / frames, 0) + " allocs";
+		}
+		ofDrawBitmapString(label, x + 8, lineY);
+	}
+
+	// frame times, the line is the 60fps budget
+	float graphY = lineY + 8 + graphHeight;
+	float step = (width - 8) / frameTimes.size();
+	double maxNanos = max(*max_element(frameTimes.begin(), frameTimes.end()), uint64_t(1000000000 / 30));
+	ofSetColor(120, 220, 120);
+	for(size_t i = 0; i < frameTimes.size(); i++){
+		float h = frameTimes[i] / maxNanos * graphHeight;
+		ofDrawRectangle(x + 4 + i * step, graphY - h, max(step - 1, 1.f), h);
+	}
+	ofSetColor(255, 80, 80);
+	float budgetY = graphY - 1000000000 / 60 / maxNanos * graphHeight;
+	ofDrawLine(x + 4, budgetY, x + width - 4, budgetY);
+	ofPopStyle();
+}
+
+//----------------------------------------------------------
+ofProfiler & ofGetProfiler(){
+	static ofProfiler profiler;
+	return profiler;
+}
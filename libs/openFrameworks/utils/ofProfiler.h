@@ -0,0 +1,195 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofFileUtils.h"
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <chrono>
+
+/// \brief Measures where the time of each frame goes, on the CPU and on the
+/// GPU.
+///
+/// Disabled by default, once enabled ofMainLoop measures each phase of the
+/// frame (tasks, update, draw, swap and events) and scopes can be added
+/// anywhere, from any thread:
+///
+/// ~~~~{.cpp}
+/// ofGetProfiler().setEnabled(true);
+///
+/// void ofApp::update(){
+///     OF_PROFILE_SCOPE("physics");
+///     world.step();
+/// }
+///
+/// void ofApp::draw(){
+///     OF_PROFILE_GPU_SCOPE("particles");
+///     particles.draw();
+///     ofGetProfiler().draw(10, 10);
+/// }
+/// ~~~~
+///
+/// The last frames are kept for the overlay drawn by draw(), and all the
+/// frames between startCapture() and stopCapture() can be saved as a
+/// Chrome trace, which opens in chrome://tracing or ui.perfetto.dev.
+///
+/// When ofAllocationTracker is enabled, each CPU scope also records how
+/// many allocations its thread did inside it.
+///
+/// Scope names aren't copied, they have to outlive the profiler, usually
+/// they are string literals. A scope costs a couple of clock reads and
+/// appending to a vector only its thread uses, when disabled it's a load of
+/// an atomic.
+class ofProfiler{
+public:
+	ofProfiler();
+	~ofProfiler();
+
+	ofProfiler(const ofProfiler &) = delete;
+	ofProfiler & operator=(const ofProfiler &) = delete;
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	/// \brief Start a scope in the calling thread, scopes nest
+	void begin(const char * name);
+	/// \brief End the last scope started in the calling thread
+	void end();
+
+	/// \brief Start a scope measured on the GPU with GL_TIMESTAMP queries,
+	/// from the thread with the GL context
+	///
+	/// The results arrive a few frames later, the queries are never
+	/// waited for. Does nothing where timer queries aren't supported.
+	void beginGpu(const char * name);
+	void endGpu();
+
+	/// \brief Name the calling thread in the overlay and the traces
+	void setThreadName(const std::string & name);
+
+	/// \brief Marks the start of a new frame, called by ofMainLoop
+	void newFrame();
+
+	/// \brief Number of frames kept for the overlay, 120 by default
+	void setHistorySize(std::size_t frames);
+
+	/// \brief Draws the time of each scope of the main thread and the GPU
+	/// in the last frame, averaged over the history, and a graph of the
+	/// frame times
+	void draw(float x, float y) const;
+
+	/// \brief Keep every frame from now on, until stopCapture()
+	void startCapture();
+	void stopCapture();
+	bool isCapturing() const;
+
+	/// \brief Save the captured frames in the Chrome trace event format
+	bool saveChromeTrace(const std::filesystem::path & path) const;
+
+	struct Event{
+		const char * name;
+		uint64_t start;		///< nanoseconds since the profiler was created
+		uint64_t end;
+		uint32_t thread;	///< index in getThreadNames()
+		uint32_t depth;
+		uint64_t allocations;	///< only counted while ofAllocationTracker is enabled
+	};
+
+	/// \brief The events of the last complete frame
+	std::vector<Event> getLastFrame() const;
+	/// \brief Index of the thread the GPU events are in
+	uint32_t getGpuThread() const;
+	std::vector<std::string> getThreadNames() const;
+
+private:
+	struct ThreadData{
+		ofProfiler * profiler;
+		std::mutex mutex;
+		std::vector<Event> events;
+		std::vector<std::size_t> open;	///< indices of the scopes not ended yet
+		std::string name;
+		uint32_t index;
+	};
+	struct GpuQuery{
+		const char * name;
+		uint32_t depth;
+		unsigned int begin;
+		unsigned int end;
+		bool ended;
+	};
+	struct Frame{
+		uint64_t start;
+		uint64_t end;
+		std::vector<Event> events;
+	};
+
+	uint64_t now() const;
+	ThreadData & getThreadData();
+	ThreadData & addThread(const std::string & name);
+	void collectGpuQueries(std::vector<Event> & events);
+
+	std::atomic<bool> enabled;
+	std::chrono::steady_clock::time_point startTime;
+
+	static thread_local ThreadData * currentThread;
+
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<ThreadData>> threads;
+	uint32_t gpuThread;
+	uint32_t mainThread;
+	std::deque<Frame> history;
+	std::size_t historySize;
+	std::vector<Event> capture;
+	bool bCapturing;
+	uint64_t frameStart;
+
+	// only used from the thread with the GL context
+	std::deque<GpuQuery> gpuQueries;
+	std::vector<std::size_t> openGpuQueries;
+	std::vector<unsigned int> freeGpuQueries;
+	int64_t gpuOffset;				///< profiler time - GL time
+	uint64_t gpuCalibrationTime;
+	int gpuSupported;	///< -1 until checked
+};
+
+/// \brief The profiler used by ofMainLoop
+ofProfiler & ofGetProfiler();
+
+/// \brief Measures a CPU scope from its construction to its destruction
+class ofProfilerScope{
+public:
+	ofProfilerScope(const char * name)
+	:active(ofGetProfiler().isEnabled()){
+		if(active) ofGetProfiler().begin(name);
+	}
+	~ofProfilerScope(){
+		if(active) ofGetProfiler().end();
+	}
+	ofProfilerScope(const ofProfilerScope &) = delete;
+	ofProfilerScope & operator=(const ofProfilerScope &) = delete;
+private:
+	bool active;
+};
+
+/// \brief Measures a GPU scope from its construction to its destruction
+class ofGpuProfilerScope{
+public:
+	ofGpuProfilerScope(const char * name)
+	:active(ofGetProfiler().isEnabled()){
+		if(active) ofGetProfiler().beginGpu(name);
+	}
+	~ofGpuProfilerScope(){
+		if(active) ofGetProfiler().endGpu();
+	}
+	ofGpuProfilerScope(const ofGpuProfilerScope &) = delete;
+	ofGpuProfilerScope & operator=(const ofGpuProfilerScope &) = delete;
+private:
+	bool active;
+};
+
+#define OF_PROFILE_CONCAT_(a, b) a##b
+#define OF_PROFILE_CONCAT(a, b) OF_PROFILE_CONCAT_(a, b)
+/// \brief Measures the rest of the enclosing block
+#define OF_PROFILE_SCOPE(name) ofProfilerScope OF_PROFILE_CONCAT(ofProfilerScope_, __LINE__)(name)
+/// \brief Measures the rest of the enclosing block on the GPU
+#define OF_PROFILE_GPU_SCOPE(name) ofGpuProfilerScope OF_PROFILE_CONCAT(ofGpuProfilerScope_, __LINE__)(name)
@@ -0,0 +1,203 @@
+#include "ofTaskPool.h"
+#include "ofLog.h"
+
+namespace{
+	// the worker running in this thread, to push tasks submitted from a
+	// task to its own queue
+	thread_local ofTaskPool * currentPool = nullptr;
+	thread_local std::size_t currentWorker = 0;
+
+	std::mutex mainThreadMutex;
+	std::vector<std::function<void()>> mainThreadTasks;
+}
+
+//----------------------------------------------------------
+ofTaskPool::ofTaskPool(std::size_t numThreads)
+:numQueued(0)
+,nextWorker(0)
+,closing(false){
+#ifndef TARGET_NO_THREADS
+	if(numThreads == 0){
+		numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+	for(std::size_t i = 0; i < numThreads; i++){
+		workers.emplace_back(new Worker);
+	}
+	// start the threads once all the queues exist, they steal from each other
+	for(std::size_t i = 0; i < numThreads; i++){
+		workers[i]->thread = std::thread(&ofTaskPool::workerLoop, this, i);
+	}
+#endif
+}
+
+//----------------------------------------------------------
+ofTaskPool::~ofTaskPool(){
+	{
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		closing = true;
+	}
+	sleepCondition.notify_all();
+	for(auto & worker: workers){
+		if(worker->thread.joinable()){
+			worker->thread.join();
+		}
+	}
+}
+
+//----------------------------------------------------------
+std::size_t ofTaskPool::getNumThreads() const{
+	return workers.size();
+}
+
+//----------------------------------------------------------
+std::size_t ofTaskPool::getNumQueued() const{
+	return numQueued;
+}
+
+//----------------------------------------------------------
+void ofTaskPool::push(std::function<void()> && task){
+	if(workers.empty()){
+		// no threads on this platform, run it right away
+		task();
+		return;
+	}
+
+	std::size_t index = currentPool == this ? currentWorker : nextWorker++ % workers.size();
+	{
+		std::unique_lock<std::mutex> lock(workers[index]->mutex);
+		workers[index]->tasks.push_back(std::move(task));
+	}
+	numQueued++;
+	// lock so a worker can't check numQueued and go to sleep in between
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	sleepCondition.notify_one();
+}
+
+//----------------------------------------------------------
+bool ofTaskPool::pop(std::function<void()> & task){
+	if(numQueued == 0) return false;
+
+	// workers take the newest task from their own queue, it's the most
+	// likely to still be in cache, and steal the oldest from the others
+	bool isWorker = currentPool == this;
+	std::size_t first = isWorker ? currentWorker : 0;
+	if(isWorker){
+		Worker & worker = *workers[first];
+		std::unique_lock<std::mutex> lock(worker.mutex);
+		if(!worker.tasks.empty()){
+			task = std::move(worker.tasks.back());
+			worker.tasks.pop_back();
+			numQueued--;
+			return true;
+		}
+	}
+	for(std::size_t i = 0; i < workers.size(); i++){
+		std::size_t index = (first + i) % workers.size();
+		if(isWorker && index == first) continue;
+		Worker & worker = *workers[index];
+		std::unique_lock<std::mutex> lock(worker.mutex);
+		if(!worker.tasks.empty()){
+			task = std::move(worker.tasks.front());
+			worker.tasks.pop_front();
+			numQueued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------
+bool ofTaskPool::runPendingTask(){
+	std::function<void()> task;
+	if(!pop(task)) return false;
+	try{
+		task();
+	}catch(std::exception & e){
+		ofLogError("ofTaskPool") << "task threw an exception: " << e.what();
+	}catch(...){
+		ofLogError("ofTaskPool") << "task threw an unknown exception";
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofTaskPool::workerLoop(std::size_t index){
+	currentPool = this;
+	currentWorker = index;
+	while(!closing){
+		if(runPendingTask()) continue;
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCondition.wait(lock, [this]{ return closing || numQueued > 0; });
+	}
+}
+
+//----------------------------------------------------------
+void ofTaskPool::parallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t, std::size_t)> & body, std::size_t grainSize){
+	if(end <= begin) return;
+	std::size_t total = end - begin;
+	if(grainSize == 0){
+		grainSize = std::max<std::size_t>(total / ((workers.size() + 1) * 4), 1);
+	}
+	std::size_t numChunks = (total + grainSize - 1) / grainSize;
+	if(numChunks <= 1 || workers.empty()){
+		body(begin, end);
+		return;
+	}
+
+	std::atomic<std::size_t> remaining(numChunks - 1);
+	std::mutex exceptionMutex;
+	std::exception_ptr exception;
+	auto runChunk = [&](std::size_t chunk){
+		std::size_t chunkBegin = begin + chunk * grainSize;
+		std::size_t chunkEnd = std::min(chunkBegin + grainSize, end);
+		try{
+			body(chunkBegin, chunkEnd);
+		}catch(...){
+			std::unique_lock<std::mutex> lock(exceptionMutex);
+			if(!exception) exception = std::current_exception();
+		}
+	};
+	for(std::size_t chunk = 1; chunk < numChunks; chunk++){
+		push([&runChunk, &remaining, chunk]{
+			runChunk(chunk);
+			remaining--;
+		});
+	}
+	runChunk(0);
+
+	// help with any queued task instead of just waiting, this also
+	// avoids deadlocks when parallelFor is called from a task
+	while(remaining > 0){
+		if(!runPendingTask()){
+			std::this_thread::yield();
+		}
+	}
+	if(exception){
+		std::rethrow_exception(exception);
+	}
+}
+
+//----------------------------------------------------------
+void ofTaskPool::runOnMainThread(std::function<void()> function){
+	std::unique_lock<std::mutex> lock(mainThreadMutex);
+	mainThreadTasks.push_back(std::move(function));
+}
+
+//----------------------------------------------------------
+void ofTaskPool::processMainThreadTasks(){
+	std::vector<std::function<void()>> tasks;
+	{
+		std::unique_lock<std::mutex> lock(mainThreadMutex);
+		if(mainThreadTasks.empty()) return;
+		std::swap(tasks, mainThreadTasks);
+	}
+	for(auto & task: tasks){
+		task();
+	}
+}
+
+//----------------------------------------------------------
+ofTaskPool & ofGetTaskPool(){
+	static ofTaskPool pool;
+	return pool;
+}
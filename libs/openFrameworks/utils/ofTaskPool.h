@@ -0,0 +1,169 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <functional>
+
+/// \brief A pool of threads that run short tasks, shared by the whole app
+///
+/// Every worker has its own queue of tasks. Tasks submitted from a worker
+/// go to its own queue and workers that run out of tasks steal them from
+/// the others, so recursive or uneven work gets balanced without every
+/// task going through a single lock.
+///
+/// ~~~~{.cpp}
+/// // run something in the background and get the result later
+/// std::future<ofPixels> future = ofGetTaskPool().submit([path]{
+///     ofPixels pixels;
+///     ofLoadImage(pixels, path);
+///     return pixels;
+/// });
+///
+/// // or get it in the main thread, before the next update()
+/// ofGetTaskPool().submit([path]{
+///     ofPixels pixels;
+///     ofLoadImage(pixels, path);
+///     return pixels;
+/// }, [this](ofPixels & pixels){
+///     image.setFromPixels(pixels);
+/// });
+///
+/// // split a loop in chunks over all the threads
+/// ofGetTaskPool().parallelFor(0, mesh.getNumVertices(), [&](size_t begin, size_t end){
+///     for(size_t i = begin; i < end; i++){
+///         mesh.getVertices()[i] += offsets[i];
+///     }
+/// });
+/// ~~~~
+///
+/// Tasks should be short and not block waiting for other threads, long
+/// running jobs that have to wait on IO are better in their own ofThread.
+class ofTaskPool{
+public:
+	/// \brief Creates a pool with numThreads workers, 0 to use one less
+	/// than the number of hardware threads, the main thread being the other
+	ofTaskPool(std::size_t numThreads = 0);
+	~ofTaskPool();
+
+	ofTaskPool(const ofTaskPool &) = delete;
+	ofTaskPool & operator=(const ofTaskPool &) = delete;
+
+	/// \brief Runs task in one of the workers
+	/// \returns a future with the value returned by task, or the exception
+	/// it threw
+	template<typename F>
+	std::future<typename std::result_of<F()>::type> submit(F && task);
+
+	/// \brief Runs task in one of the workers and then continuation in the
+	/// main thread, with the value returned by task if it isn't void
+	///
+	/// Continuations run from the main loop, before the windows are
+	/// updated, see processMainThreadTasks().
+	template<typename F, typename C>
+	void submit(F && task, C && continuation);
+
+	/// \brief Calls body with consecutive ranges [begin, end) covering the
+	/// whole range, in parallel, and returns once all of them have finished
+	///
+	/// The calling thread runs chunks too. grainSize is the minimum size of
+	/// a chunk, 0 to split the range in a few chunks per thread.
+	void parallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t, std::size_t)> & body, std::size_t grainSize = 0);
+
+	/// \brief Number of worker threads
+	std::size_t getNumThreads() const;
+
+	/// \brief Number of tasks submitted that haven't started yet
+	std::size_t getNumQueued() const;
+
+	/// \brief Queues function to be called in the main thread
+	///
+	/// Can be called from any thread. The functions are called, in the same
+	/// order they were queued, the next time processMainThreadTasks() runs.
+	static void runOnMainThread(std::function<void()> function);
+
+	/// \brief Calls the functions queued with runOnMainThread()
+	///
+	/// Called by ofMainLoop once per loop, before updating the windows, so
+	/// continuations see a current GL context.
+	static void processMainThreadTasks();
+
+private:
+	struct Worker{
+		std::deque<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::thread thread;
+	};
+
+	void push(std::function<void()> && task);
+	bool pop(std::function<void()> & task);
+	bool runPendingTask();
+	void workerLoop(std::size_t index);
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<std::size_t> numQueued;
+	std::atomic<std::size_t> nextWorker;
+	std::atomic<bool> closing;
+	std::mutex sleepMutex;
+	std::condition_variable sleepCondition;
+};
+
+/// \brief The task pool shared by the whole app, created the first time
+/// it's used
+ofTaskPool & ofGetTaskPool();
+
+namespace of{
+namespace priv{
+	template<typename R>
+	struct TaskContinuation{
+		template<typename F, typename C>
+		static std::function<void()> make(F && task, C && continuation){
+			auto f = std::make_shared<typename std::decay<F>::type>(std::forward<F>(task));
+			auto c = std::make_shared<typename std::decay<C>::type>(std::forward<C>(continuation));
+			return [f, c]{
+				auto result = std::make_shared<R>((*f)());
+				ofTaskPool::runOnMainThread([c, result]{
+					(*c)(*result);
+				});
+			};
+		}
+	};
+
+	template<>
+	struct TaskContinuation<void>{
+		template<typename F, typename C>
+		static std::function<void()> make(F && task, C && continuation){
+			auto f = std::make_shared<typename std::decay<F>::type>(std::forward<F>(task));
+			auto c = std::make_shared<typename std::decay<C>::type>(std::forward<C>(continuation));
+			return [f, c]{
+				(*f)();
+				ofTaskPool::runOnMainThread([c]{
+					(*c)();
+				});
+			};
+		}
+	};
+}
+}
+
+//----------------------------------------------------------
+template<typename F>
+std::future<typename std::result_of<F()>::type> ofTaskPool::submit(F && task){
+	typedef typename std::result_of<F()>::type R;
+	// std::function needs copyable functions, share the packaged task
+	auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+	std::future<R> future = packaged->get_future();
+	push([packaged]{ (*packaged)(); });
+	return future;
+}
+
+//----------------------------------------------------------
+template<typename F, typename C>
+void ofTaskPool::submit(F && task, C && continuation){
+	typedef typename std::result_of<F()>::type R;
+	push(of::priv::TaskContinuation<R>::make(std::forward<F>(task), std::forward<C>(continuation)));
+}
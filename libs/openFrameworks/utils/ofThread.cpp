@@ -7,12 +7,184 @@
 #include "ofxAndroidUtils.h"
 #endif
 
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#elif defined(TARGET_OSX) || defined(TARGET_OF_IOS)
+#include <pthread.h>
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#endif
+
+//-------------------------------------------------
+bool ofSetCurrentThreadPriority(ofThreadPriority priority){
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+	sched_param param;
+	if(priority == OF_THREAD_PRIORITY_REALTIME){
+		// above the kernel's irq threads, below its own watchdogs
+		param.sched_priority = std::min(80, sched_get_priority_max(SCHED_FIFO));
+		int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if(err != 0){
+			ofLogWarning("ofThread") << "setThreadPriority(): couldn't set realtime scheduling: " << strerror(err)
+				<< ", it needs CAP_SYS_NICE or an rtprio limit";
+			return false;
+		}
+		return true;
+	}
+
+	param.sched_priority = 0;
+	pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+	// on linux the nice value belongs to each thread, not the process
+	static const int nices[] = { 19, 10, 0, -10, -20 };
+	if(setpriority(PRIO_PROCESS, syscall(SYS_gettid), nices[priority]) != 0){
+		ofLogWarning("ofThread") << "setThreadPriority(): couldn't set nice " << nices[priority] << ": " << strerror(errno)
+			<< ", raising it needs CAP_SYS_NICE";
+		return false;
+	}
+	return true;
+#elif defined(TARGET_WIN32)
+	static const int priorities[] = {
+		THREAD_PRIORITY_LOWEST,
+		THREAD_PRIORITY_BELOW_NORMAL,
+		THREAD_PRIORITY_NORMAL,
+		THREAD_PRIORITY_ABOVE_NORMAL,
+		THREAD_PRIORITY_HIGHEST,
+		THREAD_PRIORITY_TIME_CRITICAL,
+	};
+	// MMCSS boosts the thread over the rest of the system without raising
+	// the whole process. avrt is loaded at runtime so apps don't need to
+	// link it
+	static thread_local HANDLE mmcssTask = nullptr;
+	if(priority == OF_THREAD_PRIORITY_REALTIME && !mmcssTask){
+		typedef HANDLE (WINAPI * AvSetMmThreadCharacteristicsFn)(LPCWSTR, LPDWORD);
+		HMODULE avrt = LoadLibraryA("avrt.dll");
+		auto setCharacteristics = avrt ? (AvSetMmThreadCharacteristicsFn)GetProcAddress(avrt, "AvSetMmThreadCharacteristicsW") : nullptr;
+		DWORD taskIndex = 0;
+		if(setCharacteristics){
+			mmcssTask = setCharacteristics(L"Pro Audio", &taskIndex);
+		}
+		if(!mmcssTask){
+			ofLogWarning("ofThread") << "setThreadPriority(): couldn't register the thread with MMCSS, using time critical priority only";
+		}
+	}else if(priority != OF_THREAD_PRIORITY_REALTIME && mmcssTask){
+		typedef BOOL (WINAPI * AvRevertMmThreadCharacteristicsFn)(HANDLE);
+		auto revertCharacteristics = (AvRevertMmThreadCharacteristicsFn)GetProcAddress(GetModuleHandleA("avrt.dll"), "AvRevertMmThreadCharacteristics");
+		if(revertCharacteristics){
+			revertCharacteristics(mmcssTask);
+		}
+		mmcssTask = nullptr;
+	}
+	if(!SetThreadPriority(GetCurrentThread(), priorities[priority])){
+		ofLogWarning("ofThread") << "setThreadPriority(): couldn't set thread priority, error " << GetLastError();
+		return false;
+	}
+	return true;
+#elif defined(TARGET_OSX) || defined(TARGET_OF_IOS)
+	auto machThread = pthread_mach_thread_np(pthread_self());
+	if(priority == OF_THREAD_PRIORITY_REALTIME){
+		mach_timebase_info_data_t timebase;
+		mach_timebase_info(&timebase);
+		auto msToAbsolute = [&](double ms){
+			return uint32_t(ms * 1000000.0 * timebase.denom / timebase.numer);
+		};
+		// not periodic, up to 5ms of work that has to be done within 10ms
+		// of being woken up, same as a core audio render thread
+		thread_time_constraint_policy_data_t policy;
+		policy.period = 0;
+		policy.computation = msToAbsolute(5);
+		policy.constraint = msToAbsolute(10);
+		policy.preemptible = true;
+		if(thread_policy_set(machThread, THREAD_TIME_CONSTRAINT_POLICY, (thread_policy_t)&policy, THREAD_TIME_CONSTRAINT_POLICY_COUNT) != KERN_SUCCESS){
+			ofLogWarning("ofThread") << "setThreadPriority(): couldn't set the time constraint policy";
+			return false;
+		}
+		return true;
+	}
+
+	thread_standard_policy_data_t standard;
+	thread_policy_set(machThread, THREAD_STANDARD_POLICY, (thread_policy_t)&standard, THREAD_STANDARD_POLICY_COUNT);
+	static const qos_class_t classes[] = {
+		QOS_CLASS_BACKGROUND,
+		QOS_CLASS_UTILITY,
+		QOS_CLASS_DEFAULT,
+		QOS_CLASS_USER_INITIATED,
+		QOS_CLASS_USER_INTERACTIVE,
+	};
+	if(pthread_set_qos_class_self_np(classes[priority], 0) != 0){
+		ofLogWarning("ofThread") << "setThreadPriority(): couldn't set the QoS class";
+		return false;
+	}
+	return true;
+#else
+	ofLogWarning("ofThread") << "setThreadPriority(): not supported on this platform";
+	return false;
+#endif
+}
+
+//-------------------------------------------------
+bool ofSetCurrentThreadAffinity(const std::vector<int> & cpus){
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if(cpus.empty()){
+		// the kernel keeps the ones that are online and in the process' cpuset
+		for(int cpu = 0; cpu < CPU_SETSIZE; cpu++){
+			CPU_SET(cpu, &set);
+		}
+	}
+	for(auto cpu: cpus){
+		if(cpu < 0 || cpu >= CPU_SETSIZE){
+			ofLogWarning("ofThread") << "setThreadAffinity(): cpu " << cpu << " out of range";
+			return false;
+		}
+		CPU_SET(cpu, &set);
+	}
+	if(sched_setaffinity(syscall(SYS_gettid), sizeof(set), &set) != 0){
+		ofLogWarning("ofThread") << "setThreadAffinity(): couldn't set the thread affinity: " << strerror(errno);
+		return false;
+	}
+	return true;
+#elif defined(TARGET_WIN32)
+	DWORD_PTR mask = 0;
+	if(cpus.empty()){
+		DWORD_PTR systemMask;
+		GetProcessAffinityMask(GetCurrentProcess(), &mask, &systemMask);
+	}
+	for(auto cpu: cpus){
+		if(cpu < 0 || cpu >= int(sizeof(DWORD_PTR) * 8)){
+			ofLogWarning("ofThread") << "setThreadAffinity(): cpu " << cpu << " out of range, only the first processor group can be used";
+			return false;
+		}
+		mask |= DWORD_PTR(1) << cpu;
+	}
+	if(SetThreadAffinityMask(GetCurrentThread(), mask) == 0){
+		ofLogWarning("ofThread") << "setThreadAffinity(): couldn't set the thread affinity, error " << GetLastError();
+		return false;
+	}
+	return true;
+#else
+	if(cpus.empty()){
+		return true;
+	}
+	ofLogWarning("ofThread") << "setThreadAffinity(): threads can't be pinned to cpus on this platform";
+	return false;
+#endif
+}
+
 //-------------------------------------------------
 ofThread::ofThread()
 :threadRunning(false)
 ,threadDone(true)
 ,mutexBlocks(true)
-,name(""){
+,name("")
+,priority(OF_THREAD_PRIORITY_NORMAL){
 }
 
 //-------------------------------------------------
@@ -145,6 +317,43 @@ const std::thread & ofThread::getNativeThread() const{
 	return thread;
 }
 
+//-------------------------------------------------
+bool ofThread::setThreadPriority(ofThreadPriority priority){
+	this->priority = priority;
+	if(isCurrentThread()){
+		return ofSetCurrentThreadPriority(priority);
+	}
+	if(threadDone){
+		// applied by run()
+		return true;
+	}
+	ofLogWarning("ofThread") << "- name: " << getThreadName() << " - setThreadPriority(): call it before startThread() or from threadedFunction()";
+	return false;
+}
+
+//-------------------------------------------------
+ofThreadPriority ofThread::getThreadPriority() const{
+	return priority;
+}
+
+//-------------------------------------------------
+bool ofThread::setThreadAffinity(const std::vector<int> & cpus){
+	affinity = cpus;
+	if(isCurrentThread()){
+		return ofSetCurrentThreadAffinity(cpus);
+	}
+	if(threadDone){
+		return true;
+	}
+	ofLogWarning("ofThread") << "- name: " << getThreadName() << " - setThreadAffinity(): call it before startThread() or from threadedFunction()";
+	return false;
+}
+
+//-------------------------------------------------
+const std::vector<int> & ofThread::getThreadAffinity() const{
+	return affinity;
+}
+
 //-------------------------------------------------
 void ofThread::threadedFunction(){
 	ofLogWarning("ofThread") << "- name: " << getThreadName() << " - Override ofThread::threadedFunction() in your ofThread subclass.";
@@ -160,6 +369,13 @@ void ofThread::run(){
 	}
 #endif
 
+	if(priority != OF_THREAD_PRIORITY_NORMAL){
+		ofSetCurrentThreadPriority(priority);
+	}
+	if(!affinity.empty()){
+		ofSetCurrentThreadAffinity(affinity);
+	}
+
 	// user function
     // should loop endlessly.
 	try{
@@ -6,8 +6,46 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 #include "ofTypes.h"
 
+/// \brief How a thread is scheduled against the others, see
+/// ofThread::setThreadPriority()
+enum ofThreadPriority{
+	OF_THREAD_PRIORITY_LOWEST,
+	OF_THREAD_PRIORITY_LOW,
+	OF_THREAD_PRIORITY_NORMAL,
+	OF_THREAD_PRIORITY_HIGH,
+	OF_THREAD_PRIORITY_HIGHEST,
+	/// For audio and capture threads that have to run as soon as their
+	/// data is ready, they can starve every other thread if they never wait
+	OF_THREAD_PRIORITY_REALTIME,
+};
+
+/// \brief Sets the priority of the calling thread, also the main one
+///
+/// On linux and android the priorities map to nice values and realtime to
+/// SCHED_FIFO, raising a thread over normal needs CAP_SYS_NICE or an
+/// rtprio limit in /etc/security/limits.conf. On windows they map to the
+/// thread priorities and realtime also registers the thread with MMCSS
+/// as "Pro Audio". On macOS and iOS they map to the QoS classes, from
+/// background to user interactive, and realtime to a time constraint
+/// policy.
+///
+/// \returns false, with a warning, if the system refused it
+bool ofSetCurrentThreadPriority(ofThreadPriority priority);
+
+/// \brief Pins the calling thread to the cpus whose indices are passed, or
+/// lets it run on any of them if cpus is empty
+///
+/// Supported on linux, android and windows, where only the first 64 cpus
+/// can be used. macOS and iOS don't allow pinning threads to cores, use a
+/// priority instead. Pinned threads can be isolated from the rest of the
+/// system by booting linux with isolcpus= for the same cpus.
+///
+/// \returns false, with a warning, if the system refused it
+bool ofSetCurrentThreadAffinity(const std::vector<int> & cpus);
+
 
 /// \class ofThread
 /// \brief A threaded base class with a built in mutex for convenience.
@@ -267,6 +305,33 @@ public:
     /// \returns A reference to the backing Poco thread.
     const std::thread & getNativeThread() const;
 
+    /// \brief Set how the thread is scheduled against the others, normal by
+    /// default
+    ///
+    /// Some systems only allow a thread to change its own scheduling so
+    /// it has to be called before startThread(), to be applied as soon as
+    /// the thread starts, or from the threadedFunction():
+    ///
+    ///     audioThread.setThreadPriority(OF_THREAD_PRIORITY_REALTIME);
+    ///     audioThread.setThreadAffinity({3});
+    ///     audioThread.startThread();
+    ///
+    /// \returns false if the thread is running and it's not called from
+    ///     it, or if it's called from it and the system refused it.
+    /// \sa ofSetCurrentThreadPriority()
+    bool setThreadPriority(ofThreadPriority priority);
+    ofThreadPriority getThreadPriority() const;
+
+    /// \brief Pin the thread to the cpus whose indices are passed, or let it
+    /// run on any of them if cpus is empty, the default
+    ///
+    /// Like the priority it has to be set before startThread() or from the
+    /// threadedFunction().
+    ///
+    /// \sa ofSetCurrentThreadAffinity()
+    bool setThreadAffinity(const std::vector<int> & cpus);
+    const std::vector<int> & getThreadAffinity() const;
+
 
     enum {
         INFINITE_JOIN_TIMEOUT = -1
@@ -338,6 +403,9 @@ private:
     std::string name;
     std::condition_variable condition;
 
+    ofThreadPriority priority;
+    std::vector<int> affinity;
+
 
 };
 
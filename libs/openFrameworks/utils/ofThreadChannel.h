@@ -4,9 +4,32 @@
 #include <mutex>
 #include <queue>
 #include <condition_variable>
+#include <atomic>
+#include <thread>
 #include "ofUtils.h"
 
 
+/// \brief Mode tags for ofThreadChannel
+///
+/// ofThreadChannelLocking, the default, uses a mutex and has no size limit.
+/// The lock-free modes use a bounded ring buffer, send() returns false
+/// instead of blocking when it's full, and receivers only take a lock if
+/// they have to sleep waiting for data:
+///
+/// ~~~~{.cpp}
+/// // one osc thread sending to the main thread
+/// ofThreadChannel<ofxOscMessage, ofThreadChannelSPSC> messages(4096);
+/// ~~~~
+struct ofThreadChannelLocking{};
+
+/// \brief Lock-free mode for one sending and one receiving thread
+struct ofThreadChannelSPSC{};
+
+/// \brief Lock-free mode for any number of sending threads and one
+/// receiving thread
+struct ofThreadChannelMPSC{};
+
+
 /// \brief Safely send data between threads without additional synchronization.
 ///
 /// ofThreadChannel makes it easy to safely and efficiently share data between
@@ -28,7 +51,8 @@
 ///
 /// \sa https://github.com/openframeworks/ofBook/blob/master/chapters/threads/chapter.md
 /// \tparam T The data type sent by the ofThreadChannel.
-template<typename T>
+/// \tparam Mode ofThreadChannelLocking, ofThreadChannelSPSC or ofThreadChannelMPSC
+template<typename T, typename Mode = ofThreadChannelLocking>
 class ofThreadChannel{
 public:
 	/// \brief Create a default ofThreadChannel.
@@ -293,3 +317,209 @@ private:
 	bool closed;
 
 };
+
+namespace of{
+namespace priv{
+	/// \brief Bounded ring buffer shared by the lock-free ofThreadChannel modes
+	///
+	/// Every cell has a sequence number that tells if it's free to write or
+	/// has a value to read for the current lap around the buffer, so senders
+	/// and the receiver never touch the same cell at the same time (see
+	/// Dmitry Vyukov's bounded MPMC queue). With a single sender the write
+	/// position doesn't need a compare and swap.
+	///
+	/// Receivers spin for a while before going to sleep, senders only take
+	/// the lock to wake them if there's one sleeping.
+	template<typename T, bool MultiProducer>
+	class LockFreeChannel{
+	public:
+		LockFreeChannel(std::size_t capacity)
+		:closed(false)
+		,receiverWaiting(false)
+		,writePos(0)
+		,readPos(0)
+		,spinCount(1000){
+			std::size_t size = 2;
+			while(size < capacity) size *= 2;
+			mask = size - 1;
+			cells.reset(new Cell[size]);
+			for(std::size_t i = 0; i < size; i++){
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		LockFreeChannel(const LockFreeChannel &) = delete;
+		LockFreeChannel & operator=(const LockFreeChannel &) = delete;
+
+		bool receive(T & sentValue){
+			while(!closed.load(std::memory_order_acquire)){
+				if(pop(sentValue) || (spinUntilReady() && pop(sentValue))){
+					return true;
+				}
+				std::unique_lock<std::mutex> lock(mutex);
+				receiverWaiting.store(true);
+				if(!ready() && !closed.load()){
+					condition.wait(lock);
+				}
+				receiverWaiting.store(false);
+			}
+			return false;
+		}
+
+		bool tryReceive(T & sentValue){
+			if(closed.load(std::memory_order_acquire)){
+				return false;
+			}
+			return pop(sentValue);
+		}
+
+		bool tryReceive(T & sentValue, int64_t timeoutMs){
+			if(closed.load(std::memory_order_acquire)){
+				return false;
+			}
+			if(pop(sentValue) || (spinUntilReady() && pop(sentValue))){
+				return true;
+			}
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				receiverWaiting.store(true);
+				if(!ready() && !closed.load()){
+					condition.wait_for(lock, std::chrono::milliseconds(timeoutMs));
+				}
+				receiverWaiting.store(false);
+			}
+			return !closed.load(std::memory_order_acquire) && pop(sentValue);
+		}
+
+		bool send(const T & value){
+			T copy(value);
+			return send(std::move(copy));
+		}
+
+		bool send(T && value){
+			if(closed.load(std::memory_order_acquire)){
+				return false;
+			}
+			std::size_t pos = writePos.load(std::memory_order_relaxed);
+			Cell * cell;
+			while(true){
+				cell = &cells[pos & mask];
+				std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+				if(diff == 0){
+					if(!MultiProducer){
+						writePos.store(pos + 1, std::memory_order_relaxed);
+						break;
+					}else if(writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+						break;
+					}
+				}else if(diff < 0){
+					// full
+					return false;
+				}else{
+					pos = writePos.load(std::memory_order_relaxed);
+				}
+			}
+			cell->value = std::move(value);
+			cell->sequence.store(pos + 1, std::memory_order_release);
+
+			// seq_cst load, pairs with the store in receive() so either
+			// the receiver sees the value or the sender sees it waiting
+			if(receiverWaiting.load()){
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.notify_one();
+			}
+			return true;
+		}
+
+		void close(){
+			closed.store(true);
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.notify_all();
+		}
+
+		bool empty() const{
+			return !ready();
+		}
+
+		std::size_t capacity() const{
+			return mask + 1;
+		}
+
+		void setSpinCount(int spinCount){
+			this->spinCount = spinCount;
+		}
+
+		int getSpinCount() const{
+			return spinCount;
+		}
+
+	private:
+		struct Cell{
+			std::atomic<std::size_t> sequence;
+			T value;
+		};
+
+		bool ready() const{
+			std::size_t pos = readPos.load(std::memory_order_relaxed);
+			return cells[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+		}
+
+		bool pop(T & sentValue){
+			std::size_t pos = readPos.load(std::memory_order_relaxed);
+			Cell & cell = cells[pos & mask];
+			if(cell.sequence.load(std::memory_order_acquire) != pos + 1){
+				return false;
+			}
+			std::swap(sentValue, cell.value);
+			cell.sequence.store(pos + mask + 1, std::memory_order_release);
+			readPos.store(pos + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		bool spinUntilReady() const{
+			for(int i = 0; i < spinCount; i++){
+				if(ready() || closed.load(std::memory_order_relaxed)){
+					return true;
+				}
+				std::this_thread::yield();
+			}
+			return false;
+		}
+
+		std::unique_ptr<Cell[]> cells;
+		std::size_t mask;
+		std::atomic<bool> closed;
+		std::atomic<bool> receiverWaiting;
+		std::atomic<std::size_t> writePos;
+		std::atomic<std::size_t> readPos;
+		int spinCount;
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+}
+}
+
+/// \brief Lock-free ofThreadChannel for one sender and one receiver
+///
+/// Has the same interface as the default ofThreadChannel but holds at most
+/// capacity values, rounded up to a power of 2, send() returns false when
+/// it's full. receive() and the tryReceive() version with a timeout spin
+/// for setSpinCount() iterations before sleeping, tryReceive() never locks.
+template<typename T>
+class ofThreadChannel<T, ofThreadChannelSPSC>: public of::priv::LockFreeChannel<T, false>{
+public:
+	ofThreadChannel(std::size_t capacity = 1024)
+	:of::priv::LockFreeChannel<T, false>(capacity){}
+};
+
+/// \brief Lock-free ofThreadChannel for many senders and one receiver
+///
+/// Same as ofThreadChannel<T, ofThreadChannelSPSC> but send() can be
+/// called from any number of threads at the same time.
+template<typename T>
+class ofThreadChannel<T, ofThreadChannelMPSC>: public of::priv::LockFreeChannel<T, true>{
+public:
+	ofThreadChannel(std::size_t capacity = 1024)
+	:of::priv::LockFreeChannel<T, true>(capacity){}
+};
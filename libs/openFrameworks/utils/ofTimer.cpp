@@ -1,4 +1,5 @@
 #include "ofTimer.h"
+#include <thread>
 
 #define NANOS_PER_SEC 1000000000ll
 
@@ -9,6 +10,10 @@ ofTimer::ofTimer()
 #ifdef TARGET_WIN32
 ,hTimer(CreateWaitableTimer(nullptr, TRUE, nullptr))
 #endif
+,spinThreshold(0)
+,lastLateness(0)
+,numLateEvents(0)
+,bSkipLateEvents(true)
 {
 
 }
@@ -19,49 +24,101 @@ void ofTimer::reset(){
 #else
 	nextWakeTime = ofGetCurrentTime();
 #endif
+	nextDeadline = std::chrono::steady_clock::now();
 	calculateNextPeriod();
 }
 
 void ofTimer::setPeriodicEvent(uint64_t nanoseconds){
 	nanosPerPeriod = std::chrono::nanoseconds(nanoseconds);
+	numLateEvents = 0;
 	reset();
 }
 
+void ofTimer::setSpinThreshold(uint64_t nanoseconds){
+	spinThreshold = std::chrono::nanoseconds(nanoseconds);
+}
+
+uint64_t ofTimer::getSpinThreshold() const{
+	return spinThreshold.count();
+}
+
+void ofTimer::setSkipLateEvents(bool skip){
+	bSkipLateEvents = skip;
+}
+
+bool ofTimer::isSkippingLateEvents() const{
+	return bSkipLateEvents;
+}
+
+std::chrono::nanoseconds ofTimer::getLastLateness() const{
+	return lastLateness;
+}
+
+uint64_t ofTimer::getNumLateEvents() const{
+	return numLateEvents;
+}
+
 void ofTimer::waitNext(){
+	if(std::chrono::steady_clock::now() > nextDeadline){
+		numLateEvents++;
+	}
+	if(spinThreshold.count() > 0 || !bSkipLateEvents){
+		waitHybrid();
+	}else{
 #if (defined(TARGET_LINUX) && !defined(TARGET_RASPBERRY_PI))
-	timespec remainder = {0,0};
-	timespec wakeTime = nextWakeTime.getAsTimespec();
-	clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&wakeTime,&remainder);
+		timespec remainder = {0,0};
+		timespec wakeTime = nextWakeTime.getAsTimespec();
+		clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&wakeTime,&remainder);
 #elif defined(TARGET_WIN32)
-	WaitForSingleObject(hTimer, INFINITE);
+		WaitForSingleObject(hTimer, INFINITE);
 #else
-	auto now = ofGetCurrentTime();
-	auto waitNanos = nextWakeTime - now;
-	if(waitNanos > std::chrono::nanoseconds(0)){
-		timespec waittime = (ofTime() + waitNanos).getAsTimespec();
-		timespec remainder;
-		nanosleep(&waittime,&remainder);
-	}
+		auto now = ofGetCurrentTime();
+		auto waitNanos = nextWakeTime - now;
+		if(waitNanos > std::chrono::nanoseconds(0)){
+			timespec waittime = (ofTime() + waitNanos).getAsTimespec();
+			timespec remainder;
+			nanosleep(&waittime,&remainder);
+		}
 #endif
+	}
+	lastLateness = std::max(std::chrono::nanoseconds(0), std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - nextDeadline));
 	calculateNextPeriod();
 }
 
+void ofTimer::waitHybrid(){
+	auto sleepUntil = nextDeadline - spinThreshold;
+	if(std::chrono::steady_clock::now() < sleepUntil){
+		std::this_thread::sleep_until(sleepUntil);
+	}
+	while(std::chrono::steady_clock::now() < nextDeadline){
+		std::this_thread::yield();
+	}
+}
+
 
 void ofTimer::calculateNextPeriod(){
+	nextDeadline += nanosPerPeriod;
+	auto nowDeadline = std::chrono::steady_clock::now();
+	// catching up stops after a second behind, a stall that long would
+	// otherwise be followed by a second of events without any wait
+	if(nextDeadline < nowDeadline && (bSkipLateEvents || nowDeadline - nextDeadline > std::chrono::seconds(1))){
+		nextDeadline = nowDeadline + nanosPerPeriod;
+	}
+
 #if defined(TARGET_WIN32)
 	nextWakeTime.QuadPart += nanosPerPeriod.count()/100;
     LARGE_INTEGER now;
     GetSystemTimeAsFileTime((LPFILETIME)&now);
 	if(nextWakeTime.QuadPart<now.QuadPart){
-	    reset();
-	}else{
-	    SetWaitableTimer(hTimer, &nextWakeTime, 0, nullptr, nullptr, 0);
+	    GetSystemTimeAsFileTime((LPFILETIME)&nextWakeTime);
+	    nextWakeTime.QuadPart += nanosPerPeriod.count()/100;
 	}
+	SetWaitableTimer(hTimer, &nextWakeTime, 0, nullptr, nullptr, 0);
 #else
 	nextWakeTime += nanosPerPeriod;
 	auto now = ofGetCurrentTime();
     if(nextWakeTime<now){
-        reset();
+        nextWakeTime = now + nanosPerPeriod;
     }
 #endif
 }
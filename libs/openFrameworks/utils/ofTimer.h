@@ -20,8 +20,38 @@ public:
 	
 	/// \brief Sleep this thread until the next periodic event.
 	void waitNext();
+
+	/// \brief Sleep until \p nanoseconds before each event and spin for
+	/// the rest, 0 by default.
+	///
+	/// OS sleeps can wake up a millisecond late or more, which is a lot at
+	/// 120 or 144Hz. Spinning the last part of the wait makes it precise at
+	/// the cost of using a core for that time, 1 to 2ms is usually enough.
+	/// \param nanoseconds Time to spin before each event, 0 only sleeps.
+	void setSpinThreshold(uint64_t nanoseconds);
+	uint64_t getSpinThreshold() const;
+
+	/// \brief What to do when waitNext() is called after an event already
+	/// passed.
+	///
+	/// By default the late events are skipped and the next one is a period
+	/// from now. Without skipping, waitNext() returns right away until the
+	/// timer catches up with the events it missed, which keeps the average
+	/// rate at the cost of a burst of events after a stall.
+	void setSkipLateEvents(bool skip);
+	bool isSkippingLateEvents() const;
+
+	/// \brief How late the last waitNext() returned after its event, either
+	/// because it was called too late or because the sleep overshot.
+	std::chrono::nanoseconds getLastLateness() const;
+
+	/// \brief Number of times waitNext() was called after its event since
+	/// the timer was reset.
+	uint64_t getNumLateEvents() const;
+
 private:
 	void calculateNextPeriod();
+	void waitHybrid();
 	std::chrono::nanoseconds nanosPerPeriod;
 #if defined(TARGET_WIN32)
 	LARGE_INTEGER nextWakeTime;
@@ -29,5 +59,10 @@ private:
 #else
 	ofTime nextWakeTime;
 #endif
+	// the hybrid wait and the lateness use a monotonic clock on every platform
+	std::chrono::steady_clock::time_point nextDeadline;
+	std::chrono::nanoseconds spinThreshold;
+	std::chrono::nanoseconds lastLateness;
+	uint64_t numLateEvents;
+	bool bSkipLateEvents;
 };
-
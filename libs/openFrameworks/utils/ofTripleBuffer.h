@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+
+/// \brief Lock-free handoff of the newest value from one producer thread to
+/// one consumer thread.
+///
+/// Holds three values: the producer writes to the back one, the consumer
+/// reads the front one and the middle one is the last complete value that
+/// neither of them is using. Publishing and updating only exchange the
+/// index of the middle value, so nothing is copied and neither thread ever
+/// waits for the other. If the producer publishes faster than the consumer
+/// updates, the older values are overwritten and the consumer always gets
+/// the newest one.
+///
+/// ~~~~{.cpp}
+/// ofTripleBuffer<ofPixels> frames;
+///
+/// // producer thread
+/// fillFrame(frames.getBack());
+/// frames.publish();
+///
+/// // consumer thread
+/// if(frames.update()){
+/// 	image.setFromPixels(frames.getFront());
+/// }
+/// ~~~~
+///
+/// The values are reused, the back one still contains whatever the
+/// consumer left in it last, which allows allocating them once or swapping
+/// memory in and out of them without any allocation per value.
+///
+/// \tparam T The type of the values.
+template<typename T>
+class ofTripleBuffer{
+public:
+	ofTripleBuffer(){
+		reset();
+	}
+
+	/// \brief The value the producer is writing to.
+	///
+	/// Only call from the producer thread.
+	T & getBack(){
+		return values[back];
+	}
+
+	/// \brief Make the back value the newest one.
+	///
+	/// The producer gets the previous middle value as its new back value.
+	/// Only call from the producer thread, never blocks.
+	void publish(){
+		back = middle.exchange(back | newBit, std::memory_order_acq_rel) & indexMask;
+	}
+
+	/// \brief Get the newest published value if there's one.
+	///
+	/// Only call from the consumer thread, never blocks.
+	/// \returns true if the front value changed since the last call.
+	bool update(){
+		if((middle.load(std::memory_order_acquire) & newBit) == 0){
+			return false;
+		}
+		front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+
+	/// \brief The newest value since the last call to update().
+	///
+	/// Only call from the consumer thread.
+	T & getFront(){
+		return values[front];
+	}
+
+	const T & getFront() const{
+		return values[front];
+	}
+
+	/// \brief Access each of the three values, for example to allocate
+	/// them before starting the producer.
+	///
+	/// Not thread safe, only use while the producer isn't running.
+	T & operator[](std::size_t i){
+		return values[i];
+	}
+
+	/// \brief Forget any published value that wasn't read yet.
+	///
+	/// Not thread safe, only use while the producer isn't running.
+	void reset(){
+		back = 0;
+		middle.store(1, std::memory_order_release);
+		front = 2;
+	}
+
+private:
+	static const uint8_t newBit = 4;
+	static const uint8_t indexMask = 3;
+
+	T values[3];
+	uint8_t back;
+	std::atomic<uint8_t> middle;
+	uint8_t front;
+};
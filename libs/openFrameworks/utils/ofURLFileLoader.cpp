@@ -1,7 +1,9 @@
 #include "ofURLFileLoader.h"
+#include "ofHttpCache.h"
 #include "ofBaseTypes.h"
 #include "ofAppRunner.h"
 #include "ofUtils.h"
+#include "ofJson.h"
 
 #include "ofConstants.h"
 
@@ -11,7 +13,12 @@ using namespace std;
 	#include <curl/curl.h>
 	#include "ofThreadChannel.h"
 	#include "ofThread.h"
+	#include <atomic>
+	#include <algorithm>
+	#include <cstring>
 	static bool curlInited = false;
+#elif defined(TARGET_EMSCRIPTEN)
+	#include "ofxEmscriptenURLFileLoader.h"
 #endif
 
 int	ofHttpRequest::nextID = 0;
@@ -35,6 +42,9 @@ public:
 	void stop();
 	ofHttpResponse handleRequest(const ofHttpRequest & request);
 	int handleRequestAsync(const ofHttpRequest& request); // returns id
+	void setMaxConnectionsPerHost(size_t max);
+	void setMaxConnections(size_t max);
+	void setCache(std::shared_ptr<ofHttpCache> cache);
 
 protected:
 	// threading -----------------------------------------------
@@ -43,21 +53,104 @@ protected:
 	void update(ofEventArgs & args);  // notify in update so the notification is thread safe
 
 private:
+	struct Download;
+
+	// the state of a request while it's running, the callbacks write to it
+	struct Transfer{
+		Transfer(const ofHttpRequest & request);
+		~Transfer();
+		ofHttpResponse response;
+		std::string body;
+		curl_slist * headers = nullptr;
+		std::unique_ptr<ofFile> saveTo;
+		std::shared_ptr<ofHttpCache> cache;
+		CURL * curl = nullptr;
+
+		// set for the requests of a segmented download
+		Download * download = nullptr;
+		size_t segment = 0;
+		bool probe = false;
+		long rangeStatus = 0; // status of a segment once its body arrives
+	};
+
+	// a saveTo request split in ranges downloaded at the same time, see
+	// ofHttpRequest::numSegments. a HEAD request finds the size first, then
+	// every segment is written at its offset in the .part file
+	struct Download{
+		struct Segment{
+			uint64_t begin;
+			uint64_t end; // exclusive
+			uint64_t written;
+			uint64_t writtenAtStart; // to only count retries without progress
+			int retries;
+			bool running;
+		};
+		ofHttpRequest request;
+		std::filesystem::path path;
+		std::filesystem::path partPath;
+		std::filesystem::path statePath;
+		ofFile file;
+		uint64_t size = 0;
+		std::string validator; // etag or last modified date of the file
+		std::map<std::string,std::string> headers;
+		std::vector<Segment> segments;
+		uint64_t unsavedBytes = 0;
+		std::string error;
+	};
+
+	void prepare(CURL * curl, Transfer & transfer);
+	void setStatus(Transfer & transfer, CURLcode err);
+
 	// perform the requests on the thread
+	void startTransfer(const ofHttpRequest & request);
+	void addTransfer(const ofHttpRequest & request);
+	bool finishTransfer(CURL * curl, CURLcode err);
+	void cancelTransfer(int id);
+
+	// segmented downloads
+	bool isDownload(const ofHttpRequest & request) const;
+	void startDownload(const ofHttpRequest & request);
+	bool startSegments(Download & download);
+	void startSegment(Download & download, size_t segment);
+	bool finishDownloadTransfer(Transfer & transfer, CURLcode err);
+	bool finishDownload(Download & download);
+	void stopSegments(int id);
+	bool loadDownloadState(Download & download);
+	void saveDownloadState(Download & download);
+	std::map<int, std::unique_ptr<Download>> downloads;
+	void wakeUp();
+	std::shared_ptr<ofHttpCache> getCache(const ofHttpRequest & request);
 
 	ofThreadChannel<ofHttpRequest> requests;
 	ofThreadChannel<ofHttpResponse> responses;
 	ofThreadChannel<int> cancelRequestQueue;
 	set<int> cancelledRequests;
 	std::unique_ptr<CURL, void(*)(CURL*)> curl;
+	std::unique_ptr<CURLM, CURLMcode(*)(CURLM*)> multi;
+	std::map<CURL*, std::unique_ptr<Transfer>> transfers;
+	std::atomic<size_t> maxConnectionsPerHost;
+	std::atomic<size_t> maxConnections;
+	std::atomic<bool> connectionLimitsChanged;
+	std::shared_ptr<ofHttpCache> cache;
+	std::mutex cacheMutex;
 };
 
 ofURLFileLoaderImpl::ofURLFileLoaderImpl()
-:curl(nullptr, nullptr){
+:curl(nullptr, nullptr)
+,multi(nullptr, nullptr)
+,maxConnectionsPerHost(6)
+,maxConnections(0)
+,connectionLimitsChanged(true){
 	if(!curlInited){
 		 curl_global_init(CURL_GLOBAL_ALL);
 	}
 	curl = std::unique_ptr<CURL, void(*)(CURL*)>(curl_easy_init(), curl_easy_cleanup);
+	multi = std::unique_ptr<CURLM, CURLMcode(*)(CURLM*)>(curl_multi_init(), curl_multi_cleanup);
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	// send requests to the same host over one HTTP/2 connection when the
+	// server supports it
+	curl_multi_setopt(multi.get(), CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
 }
 
 ofURLFileLoaderImpl::~ofURLFileLoaderImpl(){
@@ -73,9 +166,7 @@ ofHttpResponse ofURLFileLoaderImpl::get(const string& url) {
 
 int ofURLFileLoaderImpl::getAsync(const string& url, const string& name){
 	ofHttpRequest request(url, name.empty() ? url : name);
-	requests.send(request);
-	start();
-	return request.getId();
+	return handleRequestAsync(request);
 }
 
 
@@ -86,13 +177,12 @@ ofHttpResponse ofURLFileLoaderImpl::saveTo(const string& url, const std::filesys
 
 int ofURLFileLoaderImpl::saveAsync(const string& url, const std::filesystem::path& path){
 	ofHttpRequest request(url,path.string(),true);
-	requests.send(request);
-	start();
-	return request.getId();
+	return handleRequestAsync(request);
 }
 
 void ofURLFileLoaderImpl::remove(int id){
 	cancelRequestQueue.send(id);
+	wakeUp();
 }
 
 void ofURLFileLoaderImpl::clear(){
@@ -113,35 +203,143 @@ void ofURLFileLoaderImpl::stop() {
 	stopThread();
 	requests.close();
 	responses.close();
+	wakeUp();
 	waitForThread();
 }
 
+void ofURLFileLoaderImpl::setMaxConnectionsPerHost(size_t max){
+	maxConnectionsPerHost = max;
+	connectionLimitsChanged = true;
+	wakeUp();
+}
+
+void ofURLFileLoaderImpl::setMaxConnections(size_t max){
+	maxConnections = max;
+	connectionLimitsChanged = true;
+	wakeUp();
+}
+
+void ofURLFileLoaderImpl::setCache(std::shared_ptr<ofHttpCache> cache){
+	std::unique_lock<std::mutex> lock(cacheMutex);
+	this->cache = cache;
+}
+
+std::shared_ptr<ofHttpCache> ofURLFileLoaderImpl::getCache(const ofHttpRequest & request){
+	std::unique_lock<std::mutex> lock(cacheMutex);
+	if(cache && cache->isCacheable(request)){
+		return cache;
+	}else{
+		return nullptr;
+	}
+}
+
+void ofURLFileLoaderImpl::wakeUp(){
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(multi.get());
+#endif
+}
+
 void ofURLFileLoaderImpl::threadedFunction() {
 	setThreadName("ofURLFileLoader " + ofToString(getThreadId()));
+	vector<ofHttpRequest> newRequests;
 	while( isThreadRunning() ){
+		// with nothing running wait for a new request, otherwise take the
+		// ones that arrived while the others were running and carry on
+		ofHttpRequest request;
+		if(transfers.empty()){
+			if(!requests.receive(request)){
+				break;
+			}
+			newRequests.push_back(request);
+		}
+		while(requests.tryReceive(request)){
+			newRequests.push_back(request);
+		}
+
 		int cancelled;
 		while(cancelRequestQueue.tryReceive(cancelled)){
-			cancelledRequests.insert(cancelled);
+			cancelTransfer(cancelled);
 		}
-		ofHttpRequest request;
-		if(requests.receive(request)){
-			if(cancelledRequests.find(request.getId())==cancelledRequests.end()){
-				ofHttpResponse response(handleRequest(request));
-				int status = response.status;
-				if(!responses.send(move(response))){
+		bool closed = false;
+		for(auto & newRequest: newRequests){
+			auto it = cancelledRequests.find(newRequest.getId());
+			if(it!=cancelledRequests.end()){
+				cancelledRequests.erase(it);
+				continue;
+			}
+			auto cache = getCache(newRequest);
+			ofHttpResponse cached;
+			if(cache && cache->getFresh(newRequest, cached)){
+				if(!responses.send(move(cached))){
+					closed = true;
 					break;
 				}
-				if(status==-1){
-					// retry
-					requests.send(request);
-				}
 			}else{
-				cancelledRequests.erase(cancelled);
+				startTransfer(newRequest);
 			}
-		}else{
+		}
+		newRequests.clear();
+		if(closed){
+			break;
+		}
+
+		if(connectionLimitsChanged.exchange(false)){
+			curl_multi_setopt(multi.get(), CURLMOPT_MAX_HOST_CONNECTIONS, long(maxConnectionsPerHost));
+			curl_multi_setopt(multi.get(), CURLMOPT_MAX_TOTAL_CONNECTIONS, long(maxConnections));
+		}
+
+		int running = 0;
+		curl_multi_perform(multi.get(), &running);
+
+		// often enough that an interrupted download loses little
+		for(auto & download: downloads){
+			if(download.second->unsavedBytes >= 16 * 1024 * 1024){
+				saveDownloadState(*download.second);
+			}
+		}
+
+		int remaining = 0;
+		while(auto msg = curl_multi_info_read(multi.get(), &remaining)){
+			if(msg->msg == CURLMSG_DONE){
+				// msg is invalid once the handle is removed
+				CURL * done = msg->easy_handle;
+				CURLcode err = msg->data.result;
+				if(!finishTransfer(done, err)){
+					closed = true;
+					break;
+				}
+			}
+		}
+		if(closed){
 			break;
 		}
+
+		if(!transfers.empty()){
+			// waits for data on any of the connections, a new request
+			// wakes it up on versions that support it, the timeout
+			// bounds how long it takes to notice one on the rest
+#if LIBCURL_VERSION_NUM >= 0x074400
+			curl_multi_poll(multi.get(), nullptr, 0, 100, nullptr);
+#else
+			curl_multi_wait(multi.get(), nullptr, 0, 10, nullptr);
+#endif
+		}
+	}
+
+	for(auto & transfer: transfers){
+		curl_multi_remove_handle(multi.get(), transfer.first);
+		curl_easy_cleanup(transfer.first);
 	}
+	transfers.clear();
+	// resumable downloads continue from here next time
+	for(auto & download: downloads){
+		saveDownloadState(*download.second);
+		download.second->file.close();
+		if(!download.second->request.resume && ofFile::doesFileExist(download.second->partPath, false)){
+			ofFile::removeFile(download.second->partPath, false);
+		}
+	}
+	downloads.clear();
 }
 
 namespace{
@@ -151,12 +349,190 @@ namespace{
 		return size * nmemb;
 	}
 
+	template<class Transfer>
+	size_t saveSegment_cb(void *buffer, size_t size, size_t nmemb, void *userdata){
+		auto transfer = (Transfer*)userdata;
+		if(transfer->rangeStatus == 0){
+			// a server ignoring the range would send the whole file
+			curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &transfer->rangeStatus);
+		}
+		if(transfer->rangeStatus != 206){
+			return 0;
+		}
+		auto & download = *transfer->download;
+		auto & segment = download.segments[transfer->segment];
+		size_t bytes = size * nmemb;
+		uint64_t offset = segment.begin + segment.written;
+		if(offset + bytes > segment.end){
+			return 0;
+		}
+		download.file.seekp(offset);
+		download.file.write((const char*)buffer, bytes);
+		if(!download.file){
+			return 0;
+		}
+		segment.written += bytes;
+		download.unsavedBytes += bytes;
+		return bytes;
+	}
+
+	// FIPS 180-4
+	class Sha256{
+	public:
+		Sha256(){
+			const uint32_t initial[8] = {
+				0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+			};
+			std::copy(initial, initial + 8, state);
+		}
+
+		void update(const unsigned char * data, size_t size){
+			length += size;
+			while(size > 0){
+				size_t n = std::min(size, sizeof(block) - used);
+				memcpy(block + used, data, n);
+				used += n;
+				data += n;
+				size -= n;
+				if(used == sizeof(block)){
+					compress();
+					used = 0;
+				}
+			}
+		}
+
+		std::string hex(){
+			uint64_t bits = length * 8;
+			unsigned char padding = 0x80;
+			update(&padding, 1);
+			padding = 0;
+			while(used != 56){
+				update(&padding, 1);
+			}
+			unsigned char size[8];
+			for(int i = 0; i < 8; i++){
+				size[i] = (unsigned char)(bits >> (56 - i * 8));
+			}
+			update(size, 8);
+			std::string digest;
+			const char * digits = "0123456789abcdef";
+			for(auto word: state){
+				for(int shift = 28; shift >= 0; shift -= 4){
+					digest += digits[(word >> shift) & 0xf];
+				}
+			}
+			return digest;
+		}
+
+	private:
+		static uint32_t rotate(uint32_t x, int n){
+			return (x >> n) | (x << (32 - n));
+		}
+
+		void compress(){
+			static const uint32_t k[64] = {
+				0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+				0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+				0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+				0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+				0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+				0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+				0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+				0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+			};
+			uint32_t w[64];
+			for(int i = 0; i < 16; i++){
+				w[i] = uint32_t(block[i * 4]) << 24 | uint32_t(block[i * 4 + 1]) << 16 | uint32_t(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+			}
+			for(int i = 16; i < 64; i++){
+				uint32_t s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+				uint32_t s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+				w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+			}
+			uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+			uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+			for(int i = 0; i < 64; i++){
+				uint32_t s1 = rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25);
+				uint32_t ch = (e & f) ^ (~e & g);
+				uint32_t t1 = h + s1 + ch + k[i] + w[i];
+				uint32_t s0 = rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22);
+				uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+				uint32_t t2 = s0 + maj;
+				h = g; g = f; f = e; e = d + t1;
+				d = c; c = b; b = a; a = t1 + t2;
+			}
+			state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+			state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+		}
+
+		uint32_t state[8];
+		unsigned char block[64];
+		size_t used = 0;
+		uint64_t length = 0;
+	};
+
+	std::string sha256File(const std::filesystem::path & path){
+		ofFile file(path, ofFile::ReadOnly, true);
+		if(!file.is_open()){
+			return "";
+		}
+		Sha256 sha;
+		std::vector<char> buffer(1024 * 1024);
+		while(file.read(buffer.data(), buffer.size()) || file.gcount() > 0){
+			sha.update((const unsigned char*)buffer.data(), size_t(file.gcount()));
+		}
+		return sha.hex();
+	}
+
+	void removeIfExists(const std::filesystem::path & path){
+		if(ofFile::doesFileExist(path, false)){
+			ofFile::removeFile(path, false);
+		}
+	}
+
+	template<class Transfer>
 	size_t saveToMemory_cb(void *buffer, size_t size, size_t nmemb, void *userdata){
-		auto response = (ofHttpResponse*)userdata;
-		response->data.append((const char*)buffer, size * nmemb);
+		auto transfer = (Transfer*)userdata;
+		auto & response = transfer->response;
+		if(response.request.chunkReceived){
+			response.request.chunkReceived(ofBuffer((const char*)buffer, size * nmemb));
+			return size * nmemb;
+		}
+
+		// allocate the whole body on the first chunk if the size is known
+		if(response.data.size()==0){
+#if LIBCURL_VERSION_NUM >= 0x073700
+			curl_off_t length = -1;
+			curl_easy_getinfo(transfer->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+#else
+			double length = -1;
+			curl_easy_getinfo(transfer->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length);
+#endif
+			if(length>0){
+				response.data.reserve(size_t(length));
+			}
+		}
+		response.data.append((const char*)buffer, size * nmemb);
 		return size * nmemb;
 	}
 
+	template<class Transfer>
+	size_t saveHeader_cb(char *buffer, size_t size, size_t nitems, void *userdata){
+		auto transfer = (Transfer*)userdata;
+		auto & headers = transfer->response.headers;
+		std::string line(buffer, size * nitems);
+		if(line.compare(0, 5, "HTTP/")==0){
+			// a new response, after a redirection or a 100 Continue
+			headers.clear();
+		}else{
+			auto colon = line.find(':');
+			if(colon!=std::string::npos){
+				headers[ofToLower(ofTrim(line.substr(0, colon)))] = ofTrim(line.substr(colon + 1));
+			}
+		}
+		return size * nitems;
+	}
+
     size_t readBody_cb(void *ptr, size_t size, size_t nmemb, void *userdata){
         auto body = (std::string*)userdata;
 
@@ -175,81 +551,467 @@ namespace{
     }
 }
 
-ofHttpResponse ofURLFileLoaderImpl::handleRequest(const ofHttpRequest & request) {
-	curl_slist *headers = nullptr;
-	curl_easy_setopt(curl.get(), CURLOPT_URL, request.url.c_str());
+ofURLFileLoaderImpl::Transfer::Transfer(const ofHttpRequest & request)
+:response(request, 0, "")
+,body(request.body){
+}
+
+ofURLFileLoaderImpl::Transfer::~Transfer(){
+	if(headers){
+		curl_slist_free_all(headers);
+	}
+}
+
+void ofURLFileLoaderImpl::prepare(CURL * curl, Transfer & transfer){
+	const ofHttpRequest & request = transfer.response.request;
+	transfer.curl = curl;
+	// the parts of a download aren't the responses the cache knows
+	transfer.cache = transfer.download ? nullptr : getCache(request);
+	curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
 
 	// always follow redirections
-	curl_easy_setopt(curl.get(), CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+	// keep idle connections alive so later requests to the same host
+	// can reuse them
+	curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+#if LIBCURL_VERSION_NUM >= 0x072f00
+	curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
 
 	// Set content type and any other header
 	if(request.contentType!=""){
-		headers = curl_slist_append(headers, ("Content-Type: " + request.contentType).c_str());
+		transfer.headers = curl_slist_append(transfer.headers, ("Content-Type: " + request.contentType).c_str());
 	}
 	for(map<string,string>::const_iterator it = request.headers.cbegin(); it!=request.headers.cend(); it++){
-		headers = curl_slist_append(headers, (it->first + ": " +it->second).c_str());
+		transfer.headers = curl_slist_append(transfer.headers, (it->first + ": " +it->second).c_str());
+	}
+	// only download the response again if it changed since it was cached
+	if(transfer.cache){
+		for(auto & validator: transfer.cache->getValidators(request)){
+			transfer.headers = curl_slist_append(transfer.headers, (validator.first + ": " + validator.second).c_str());
+		}
 	}
 
-	curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, headers);
-
-    std::string body = request.body;
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.headers);
 
 	// set body if there's any
 	if(request.body!=""){
-		curl_easy_setopt(curl.get(), CURLOPT_UPLOAD, 1L);
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, request.body.size());
-        //curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, request.body.c_str());
-        curl_easy_setopt(curl.get(), CURLOPT_READFUNCTION, readBody_cb);
-        curl_easy_setopt(curl.get(), CURLOPT_READDATA, &body);
+		curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, request.body.size());
+        //curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
+        curl_easy_setopt(curl, CURLOPT_READFUNCTION, readBody_cb);
+        curl_easy_setopt(curl, CURLOPT_READDATA, &transfer.body);
 	}else{
-		curl_easy_setopt(curl.get(), CURLOPT_UPLOAD, 0L);
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, 0);
-        //curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, nullptr);
-        curl_easy_setopt(curl.get(), CURLOPT_READFUNCTION, nullptr);
-        curl_easy_setopt(curl.get(), CURLOPT_READDATA, nullptr);
+		curl_easy_setopt(curl, CURLOPT_UPLOAD, 0L);
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, 0);
+        //curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+        curl_easy_setopt(curl, CURLOPT_READFUNCTION, nullptr);
+        curl_easy_setopt(curl, CURLOPT_READDATA, nullptr);
 	}
 	if(request.method == ofHttpRequest::GET){
-		curl_easy_setopt(curl.get(), CURLOPT_HTTPGET, 1);
+		curl_easy_setopt(curl, CURLOPT_HTTPGET, 1);
 	}else{
-		curl_easy_setopt(curl.get(), CURLOPT_POST, 1);
+		curl_easy_setopt(curl, CURLOPT_POST, 1);
 	}
 
     if(request.timeoutSeconds>0){
-        curl_easy_setopt(curl.get(), CURLOPT_TIMEOUT, request.timeoutSeconds);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, request.timeoutSeconds);
     }
 
-	// start request and receive response
-	ofHttpResponse response(request, 0, "");
-	auto err = 0;
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, saveHeader_cb<Transfer>);
+
 	if(request.saveTo){
-		ofFile saveTo(request.name, ofFile::WriteOnly, true);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &saveTo);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, saveToFile_cb);
-		err = curl_easy_perform(curl.get());
+		transfer.saveTo.reset(new ofFile(request.name, ofFile::WriteOnly, true));
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer.saveTo.get());
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, saveToFile_cb);
 	}else{
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &response);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, saveToMemory_cb);
-		err = curl_easy_perform(curl.get());
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, saveToMemory_cb<Transfer>);
 	}
-	if(err==0){
+}
+
+void ofURLFileLoaderImpl::setStatus(Transfer & transfer, CURLcode err){
+	if(err==CURLE_OK){
 		long http_code = 0;
-		curl_easy_getinfo (curl.get(), CURLINFO_RESPONSE_CODE, &http_code);
-		response.status = http_code;
+		curl_easy_getinfo (transfer.curl, CURLINFO_RESPONSE_CODE, &http_code);
+		transfer.response.status = http_code;
+	}else{
+		transfer.response.status = -1;
+		transfer.response.error = curl_easy_strerror(err);
+	}
+	// close the file before anyone tries to read it
+	transfer.saveTo.reset();
+	if(transfer.cache){
+		transfer.cache->update(transfer.response);
+	}
+}
+
+ofHttpResponse ofURLFileLoaderImpl::handleRequest(const ofHttpRequest & request) {
+	auto cache = getCache(request);
+	ofHttpResponse cached;
+	if(cache && cache->getFresh(request, cached)){
+		return cached;
+	}
+
+	// reset clears the options of the last request but keeps its
+	// connection open
+	curl_easy_reset(curl.get());
+	Transfer transfer(request);
+	prepare(curl.get(), transfer);
+	setStatus(transfer, curl_easy_perform(curl.get()));
+	return transfer.response;
+}
+
+void ofURLFileLoaderImpl::startTransfer(const ofHttpRequest & request){
+	if(isDownload(request)){
+		startDownload(request);
+	}else{
+		addTransfer(request);
+	}
+}
+
+void ofURLFileLoaderImpl::addTransfer(const ofHttpRequest & request){
+	auto easy = curl_easy_init();
+	std::unique_ptr<Transfer> transfer(new Transfer(request));
+	prepare(easy, *transfer);
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	// rather wait for a connection that can be multiplexed than open a new one
+	curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+#endif
+	transfers[easy] = std::move(transfer);
+	curl_multi_add_handle(multi.get(), easy);
+}
+
+bool ofURLFileLoaderImpl::finishTransfer(CURL * easy, CURLcode err){
+	auto it = transfers.find(easy);
+	if(it==transfers.end()){
+		return true;
+	}
+	auto transfer = std::move(it->second);
+	transfers.erase(it);
+	curl_multi_remove_handle(multi.get(), easy);
+	if(transfer->download){
+		bool ok = finishDownloadTransfer(*transfer, err);
+		curl_easy_cleanup(easy);
+		return ok;
+	}
+	setStatus(*transfer, err);
+	curl_easy_cleanup(easy);
+
+	ofHttpRequest request = transfer->response.request;
+	if(request.saveTo && !request.sha256.empty() && transfer->response.status>=200 && transfer->response.status<300){
+		// servers that don't accept ranges are downloaded in one go,
+		// setStatus already closed the file
+		auto path = ofToDataPath(request.name, true);
+		if(ofToLower(request.sha256) != sha256File(path)){
+			removeIfExists(path);
+			transfer->response.status = -1;
+			transfer->response.error = "the checksum doesn't match";
+			return responses.send(move(transfer->response));
+		}
+	}
+	int status = transfer->response.status;
+	if(!responses.send(move(transfer->response))){
+		return false;
+	}
+	if(status==-1){
+		// retry
+		requests.send(request);
+	}
+	return true;
+}
+
+void ofURLFileLoaderImpl::cancelTransfer(int id){
+	auto download = downloads.find(id);
+	if(download!=downloads.end()){
+		stopSegments(id);
+		// kept to be resumed, or deleted
+		saveDownloadState(*download->second);
+		download->second->file.close();
+		if(!download->second->request.resume){
+			removeIfExists(download->second->partPath);
+		}
+		downloads.erase(download);
+		return;
+	}
+	for(auto it = transfers.begin(); it!=transfers.end(); ++it){
+		if(it->second->response.request.getId()==id){
+			curl_multi_remove_handle(multi.get(), it->first);
+			curl_easy_cleanup(it->first);
+			transfers.erase(it);
+			return;
+		}
+	}
+	// not started yet, skip it once it arrives
+	cancelledRequests.insert(id);
+}
+
+bool ofURLFileLoaderImpl::isDownload(const ofHttpRequest & request) const{
+	return request.saveTo && request.method == ofHttpRequest::GET && request.body.empty()
+		&& (request.numSegments > 1 || request.resume || !request.sha256.empty());
+}
+
+void ofURLFileLoaderImpl::startDownload(const ofHttpRequest & request){
+	std::unique_ptr<Download> download(new Download);
+	download->request = request;
+	download->path = ofToDataPath(request.name, true);
+	download->partPath = download->path.string() + ".part";
+	download->statePath = download->path.string() + ".part.json";
+
+	// only the headers, for the size and whether ranges are accepted
+	ofHttpRequest probe = request;
+	probe.saveTo = false;
+	auto easy = curl_easy_init();
+	std::unique_ptr<Transfer> transfer(new Transfer(probe));
+	transfer->download = download.get();
+	transfer->probe = true;
+	prepare(easy, *transfer);
+	curl_easy_setopt(easy, CURLOPT_NOBODY, 1L);
+	downloads[request.getId()] = std::move(download);
+	transfers[easy] = std::move(transfer);
+	curl_multi_add_handle(multi.get(), easy);
+}
+
+bool ofURLFileLoaderImpl::startSegments(Download & download){
+	const ofHttpRequest & request = download.request;
+	if(!loadDownloadState(download)){
+		download.segments.clear();
+		uint64_t minSize = std::max<uint64_t>(request.minSegmentSize, 1);
+		uint64_t numSegments = std::max<uint64_t>(1, std::min<uint64_t>(request.numSegments, download.size / minSize));
+		uint64_t step = download.size / numSegments;
+		for(uint64_t i = 0; i < numSegments; i++){
+			uint64_t end = i + 1 == numSegments ? download.size : (i + 1) * step;
+			download.segments.push_back({i * step, end, 0, 0, 0, false});
+		}
+		try{
+			removeIfExists(download.partPath);
+			ofFile part(download.partPath, ofFile::WriteOnly, true);
+			part.close();
+			std::filesystem::resize_file(download.partPath, download.size);
+		}catch(std::exception & e){
+			download.error = e.what();
+			return false;
+		}
+	}
+	if(!download.file.open(download.partPath, ofFile::ReadWrite, true)){
+		download.error = "couldn't open " + download.partPath.string();
+		return false;
+	}
+	saveDownloadState(download);
+	for(size_t i = 0; i < download.segments.size(); i++){
+		auto & segment = download.segments[i];
+		if(segment.begin + segment.written < segment.end){
+			startSegment(download, i);
+		}
+	}
+	return true;
+}
+
+void ofURLFileLoaderImpl::startSegment(Download & download, size_t index){
+	auto & segment = download.segments[index];
+	ofHttpRequest request = download.request;
+	request.saveTo = false;
+	auto easy = curl_easy_init();
+	std::unique_ptr<Transfer> transfer(new Transfer(request));
+	transfer->download = &download;
+	transfer->segment = index;
+	prepare(easy, *transfer);
+	string range = ofToString(segment.begin + segment.written) + "-" + ofToString(segment.end - 1);
+	curl_easy_setopt(easy, CURLOPT_RANGE, range.c_str());
+	curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer.get());
+	curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, saveSegment_cb<Transfer>);
+#if LIBCURL_VERSION_NUM >= 0x072f00
+	// a connection per segment, multiplexed in one HTTP/2 connection they
+	// would share the same TCP stream
+	curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+#endif
+	segment.running = true;
+	segment.writtenAtStart = segment.written;
+	transfers[easy] = std::move(transfer);
+	curl_multi_add_handle(multi.get(), easy);
+}
+
+bool ofURLFileLoaderImpl::finishDownloadTransfer(Transfer & transfer, CURLcode err){
+	int id = transfer.response.request.getId();
+	auto it = downloads.find(id);
+	if(it==downloads.end()){
+		return true;
+	}
+	Download & download = *it->second;
+	setStatus(transfer, err);
+	int status = transfer.response.status;
+
+	if(transfer.probe){
+		auto & headers = transfer.response.headers;
+		download.headers = headers;
+		uint64_t size = 0;
+		auto length = headers.find("content-length");
+		if(length!=headers.end()){
+			size = ofFromString<uint64_t>(length->second);
+		}
+		auto ranges = headers.find("accept-ranges");
+		bool acceptsRanges = ranges!=headers.end() && ofIsStringInString(ofToLower(ranges->second), "bytes");
+		if(status==-1){
+			// retried like any other request
+			ofHttpRequest request = download.request;
+			downloads.erase(it);
+			if(!responses.send(ofHttpResponse(request, status, transfer.response.error))){
+				return false;
+			}
+			requests.send(request);
+			return true;
+		}
+		if(status<200 || status>=300 || !acceptsRanges || size==0){
+			// a single connection straight to the file
+			ofHttpRequest request = download.request;
+			downloads.erase(it);
+			addTransfer(request);
+			return true;
+		}
+		download.size = size;
+		auto etag = headers.find("etag");
+		auto modified = headers.find("last-modified");
+		download.validator = etag!=headers.end() ? etag->second : modified!=headers.end() ? modified->second : "";
+		if(!startSegments(download)){
+			return finishDownload(download);
+		}
 	}else{
+		auto & segment = download.segments[transfer.segment];
+		segment.running = false;
+		if(segment.begin + segment.written < segment.end && download.error.empty()){
+			if(transfer.rangeStatus!=0 && transfer.rangeStatus!=206){
+				download.error = "range request answered with status " + ofToString(transfer.rangeStatus);
+			}else{
+				// interrupted, continue from where it stopped unless it
+				// keeps failing without progress
+				if(segment.written > segment.writtenAtStart){
+					segment.retries = 0;
+				}
+				if(segment.retries++ < 3){
+					startSegment(download, transfer.segment);
+				}else{
+					download.error = transfer.response.error.empty() ? "segment failed" : transfer.response.error;
+				}
+			}
+			if(!download.error.empty()){
+				stopSegments(id);
+			}
+		}
+		saveDownloadState(download);
+	}
+
+	for(auto & segment: download.segments){
+		if(segment.running){
+			return true;
+		}
+	}
+	return finishDownload(download);
+}
+
+bool ofURLFileLoaderImpl::finishDownload(Download & download){
+	download.file.close();
+	ofHttpResponse response(download.request, 200, "");
+	response.headers = download.headers;
+	if(download.error.empty()){
+		for(auto & segment: download.segments){
+			if(segment.begin + segment.written < segment.end){
+				download.error = "incomplete";
+			}
+		}
+	}
+	if(download.error.empty() && !download.request.sha256.empty()){
+		if(ofToLower(download.request.sha256) != sha256File(download.partPath)){
+			download.error = "the checksum doesn't match";
+			// corrupted, resuming it would be corrupted too
+			removeIfExists(download.partPath);
+			removeIfExists(download.statePath);
+		}
+	}
+	if(download.error.empty()){
+		try{
+			std::filesystem::rename(download.partPath, download.path);
+			removeIfExists(download.statePath);
+		}catch(std::exception & e){
+			download.error = e.what();
+		}
+	}else if(!download.request.resume){
+		removeIfExists(download.partPath);
+		removeIfExists(download.statePath);
+	}
+	if(!download.error.empty()){
 		response.status = -1;
+		response.error = download.error;
 	}
+	downloads.erase(download.request.getId());
+	return responses.send(move(response));
+}
 
-	if(headers){
-		curl_slist_free_all(headers);
+void ofURLFileLoaderImpl::stopSegments(int id){
+	for(auto it = transfers.begin(); it!=transfers.end();){
+		if(it->second->download && it->second->response.request.getId()==id){
+			if(!it->second->probe){
+				it->second->download->segments[it->second->segment].running = false;
+			}
+			curl_multi_remove_handle(multi.get(), it->first);
+			curl_easy_cleanup(it->first);
+			it = transfers.erase(it);
+		}else{
+			++it;
+		}
 	}
+}
 
-	return response;
+bool ofURLFileLoaderImpl::loadDownloadState(Download & download){
+	if(!download.request.resume || !ofFile::doesFileExist(download.statePath, false) || !ofFile::doesFileExist(download.partPath, false)){
+		return false;
+	}
+	download.segments.clear();
+	try{
+		ofJson state = ofLoadJson(download.statePath);
+		// the file changed on the server since
+		if(state.value("url", "") != download.request.url || state.value("size", uint64_t(0)) != download.size
+			|| state.value("validator", "") != download.validator
+			|| std::filesystem::file_size(download.partPath) != download.size){
+			return false;
+		}
+		for(auto & saved: state["segments"]){
+			Download::Segment segment{saved[0].get<uint64_t>(), saved[1].get<uint64_t>(), saved[2].get<uint64_t>(), 0, 0, false};
+			if(segment.begin > segment.end || segment.end > download.size || segment.written > segment.end - segment.begin){
+				download.segments.clear();
+				return false;
+			}
+			download.segments.push_back(segment);
+		}
+	}catch(std::exception &){
+		download.segments.clear();
+	}
+	return !download.segments.empty();
 }
 
+void ofURLFileLoaderImpl::saveDownloadState(Download & download){
+	download.unsavedBytes = 0;
+	if(!download.request.resume || download.segments.empty()){
+		return;
+	}
+	// what the state says is written has to be in the file
+	download.file.flush();
+	ofJson state;
+	state["url"] = download.request.url;
+	state["size"] = download.size;
+	state["validator"] = download.validator;
+	state["segments"] = ofJson::array();
+	for(auto & segment: download.segments){
+		state["segments"].push_back({segment.begin, segment.end, segment.written});
+	}
+	ofSaveJson(download.statePath, state);
+}
 
 int ofURLFileLoaderImpl::handleRequestAsync(const ofHttpRequest& request){
 	requests.send(request);
 	start();
+	wakeUp();
 	return request.getId();
 }
 
@@ -269,6 +1031,9 @@ void ofURLFileLoaderImpl::update(ofEventArgs & args){
 
 ofURLFileLoader::ofURLFileLoader()
 :impl(new ofURLFileLoaderImpl){}
+#elif defined(TARGET_EMSCRIPTEN)
+ofURLFileLoader::ofURLFileLoader()
+:impl(new ofxEmscriptenURLFileLoader){}
 #endif
 
 ofHttpResponse ofURLFileLoader::get(const string& url){
@@ -307,6 +1072,18 @@ int ofURLFileLoader::handleRequestAsync(const ofHttpRequest& request){
 	return impl->handleRequestAsync(request);
 }
 
+void ofURLFileLoader::setMaxConnectionsPerHost(size_t max){
+	impl->setMaxConnectionsPerHost(max);
+}
+
+void ofURLFileLoader::setMaxConnections(size_t max){
+	impl->setMaxConnections(max);
+}
+
+void ofURLFileLoader::setCache(std::shared_ptr<ofHttpCache> cache){
+	impl->setCache(cache);
+}
+
 static bool initialized = false;
 static ofURLFileLoader & getFileLoader(){
 	static ofURLFileLoader * fileLoader = new ofURLFileLoader;
@@ -394,6 +1171,18 @@ void ofStopURLLoader(){
 	getFileLoader().stop();
 }
 
+void ofSetURLLoaderMaxConnectionsPerHost(size_t max){
+	getFileLoader().setMaxConnectionsPerHost(max);
+}
+
+void ofSetURLLoaderMaxConnections(size_t max){
+	getFileLoader().setMaxConnections(max);
+}
+
+void ofSetURLCache(std::shared_ptr<ofHttpCache> cache){
+	getFileLoader().setCache(cache);
+}
+
 void ofURLFileLoaderShutdown(){
 	if(initialized){
 		ofRemoveAllURLRequests();
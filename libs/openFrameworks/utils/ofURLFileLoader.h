@@ -3,6 +3,7 @@
 #include "ofFileUtils.h"
 #include "ofTypes.h"
 class ofHttpResponse;
+class ofHttpCache;
 
 /// \class ofHttpRequest
 /// \brief an HTTP GET or POST request
@@ -18,8 +19,38 @@ public:
 	std::string				body; //< POST body data
 	std::string				contentType; //< POST data mime type
 	std::function<void(const ofHttpResponse&)> done;
+	/// if set, called from the loader's thread with each piece of the body
+	/// as it arrives, the response data is left empty
+	std::function<void(const ofBuffer & chunk)> chunkReceived;
     size_t              timeoutSeconds = 0;
 
+	/// asynchronous saveTo requests bigger than minSegmentSize are split in
+	/// up to numSegments ranges downloaded in parallel, each over its own
+	/// connection, when the server accepts ranges. 1 by default
+	///
+	/// ~~~~{.cpp}
+	/// ofHttpRequest request("http://example.com/content.zip", "content.zip", true);
+	/// request.numSegments = 8;
+	/// request.resume = true;
+	/// request.sha256 = "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08";
+	/// ofURLFileLoader loader;
+	/// loader.handleRequestAsync(request);
+	/// ~~~~
+	///
+	/// Segmented and resumable downloads are written to name.part and
+	/// moved to name once complete.
+	size_t              numSegments = 1;
+	uint64_t            minSegmentSize = 16 * 1024 * 1024;
+	/// asynchronous saveTo requests keep what they downloaded if they fail
+	/// or are cancelled and continue from there when requested again, as
+	/// long as the file didn't change on the server. the progress is saved
+	/// to name.part.json
+	bool                resume = false;
+	/// hex SHA-256 of the file saved by an asynchronous saveTo request,
+	/// the response fails with status -1 and the file is deleted if it
+	/// doesn't match
+	std::string         sha256;
+
 	/// \return the unique id for this request
 	int getId() const;
 	OF_DEPRECATED_MSG("Use getId().", int getID());
@@ -49,6 +80,7 @@ public:
 	ofBuffer		    data; //< response raw data
 	int					status; //< HTTP response status (200: OK, 404: Not Found, etc)
 	std::string				error; //< HTTP error string, if any (OK, Not Found, etc)
+	std::map<std::string,std::string>	headers; //< HTTP response header keys, in lower case, & values
 };
 
 /// \brief make an HTTP GET request
@@ -91,6 +123,21 @@ void ofRemoveAllURLRequests();
 /// \brief stop & remove all active and waiting HTTP requests
 void ofStopURLLoader();
 
+/// \brief limit the number of async requests made to the same host at the
+/// same time, 0 for no limit
+/// \param max maximum number of connections to a host, 6 by default like
+/// most browsers
+void ofSetURLLoaderMaxConnectionsPerHost(std::size_t max);
+
+/// \brief limit the number of async requests made at the same time, 0 for
+/// no limit
+/// \param max maximum number of connections, 0 by default
+void ofSetURLLoaderMaxConnections(std::size_t max);
+
+/// \brief answer repeated GET requests from cache instead of the network,
+/// nullptr to stop caching
+void ofSetURLCache(std::shared_ptr<ofHttpCache> cache);
+
 ofEvent<ofHttpResponse> & ofURLResponseEvent();
 
 template<class T>
@@ -159,6 +206,18 @@ class ofURLFileLoader  {
 		/// \return unique id of the active HTTP request
         int handleRequestAsync(const ofHttpRequest& request);
 
+		/// \brief limit the number of async requests made to the same host
+		/// at the same time, 0 for no limit
+		void setMaxConnectionsPerHost(std::size_t max);
+
+		/// \brief limit the number of async requests made at the same
+		/// time, 0 for no limit
+		void setMaxConnections(std::size_t max);
+
+		/// \brief answer repeated GET requests from cache instead of the
+		/// network, nullptr to stop caching
+		void setCache(std::shared_ptr<ofHttpCache> cache);
+
     private:
 	std::shared_ptr<ofBaseURLFileLoader> impl;
 };
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <numeric>
 #include <locale>
+#include <limits>
 #include "uriparser/Uri.h"
 
 #ifdef TARGET_WIN32	 // For ofLaunchBrowser.
@@ -693,6 +694,86 @@ int64_t ofToInt64(const string& intString) {
 	return ofTo<int64_t>(intString);
 }
 
+//----------------------------------------
+template<typename T>
+static bool parseInteger(const ofStringRange & range, T & value){
+	auto str = range.trimmed();
+	auto c = str.begin();
+	bool negative = c != str.end() && *c == '-';
+	if(c != str.end() && (*c == '-' || *c == '+')) c++;
+	if(c == str.end()) return false;
+	// accumulate negated so the most negative value fits
+	T result = 0;
+	for(; c != str.end(); c++){
+		if(*c < '0' || *c > '9') return false;
+		T digit = *c - '0';
+		if(result < (std::numeric_limits<T>::min() + digit) / 10) return false;
+		result = result * 10 - digit;
+	}
+	if(!negative){
+		if(result == std::numeric_limits<T>::min()) return false;
+		result = -result;
+	}
+	value = result;
+	return true;
+}
+
+//----------------------------------------
+template<typename T>
+static bool parseFloat(const ofStringRange & range, T & value){
+	// strtod needs a null terminated string, copy to the stack
+	auto str = range.trimmed();
+	char buffer[64];
+	if(str.empty() || str.size() >= sizeof(buffer)) return false;
+	std::copy(str.begin(), str.end(), buffer);
+	buffer[str.size()] = '\0';
+	char * end;
+	double result = strtod(buffer, &end);
+	if(end != buffer + str.size()) return false;
+	value = T(result);
+	return true;
+}
+
+//----------------------------------------
+bool ofParse(const ofStringRange & str, int & value){
+	return parseInteger(str, value);
+}
+
+//----------------------------------------
+bool ofParse(const ofStringRange & str, int64_t & value){
+	return parseInteger(str, value);
+}
+
+//----------------------------------------
+bool ofParse(const ofStringRange & str, float & value){
+	return parseFloat(str, value);
+}
+
+//----------------------------------------
+bool ofParse(const ofStringRange & str, double & value){
+	return parseFloat(str, value);
+}
+
+//----------------------------------------
+std::size_t ofToChars(char * buffer, std::size_t size, double value){
+	int length = snprintf(buffer, size, "%g", value);
+	if(length < 0 || std::size_t(length) >= size){
+		if(size > 0) buffer[0] = '\0';
+		return 0;
+	}
+	return length;
+}
+
+//----------------------------------------
+std::size_t ofToChars(char * buffer, std::size_t size, double value, int precision){
+	int length = snprintf(buffer, size, "%.*f", precision, value);
+	if(length < 0 || std::size_t(length) >= size){
+		if(size > 0) buffer[0] = '\0';
+		return 0;
+	}
+	return length;
+}
+
 //----------------------------------------
 bool ofToBool(const string& boolString) {
 	auto lower = ofToLower(boolString);
@@ -776,22 +857,62 @@ vector <string> ofSplitString(const string & source, const string & delimiter, b
 		result.push_back(source);
 		return result;
 	}
-	string::const_iterator substart = source.begin(), subend;
-	while (true) {
-		subend = search(substart, source.end(), delimiter.begin(), delimiter.end());
-		string sub(substart, subend);
-		if(trim) {
-			sub = ofTrim(sub);
-		}
-		if (!ignoreEmpty || !sub.empty()) {
-			result.push_back(sub);
+	for(auto token: ofStringSplitter(source, delimiter, ignoreEmpty, trim)){
+		result.emplace_back(token.begin(), token.end());
+	}
+	return result;
+}
+
+//--------------------------------------------------
+static bool isAsciiSpace(char c){
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+//--------------------------------------------------
+ofStringRange ofStringRange::trimmed() const{
+	auto first = begin();
+	auto last = end();
+	while(first != last && isAsciiSpace(*first)) first++;
+	while(last != first && isAsciiSpace(*(last - 1))) last--;
+	return ofStringRange(first, last - first);
+}
+
+//--------------------------------------------------
+ofStringRange ofStringRange::substr(std::size_t pos, std::size_t count) const{
+	pos = std::min(pos, length);
+	return ofStringRange(ptr + pos, std::min(count, length - pos));
+}
+
+//--------------------------------------------------
+ofStringSplitter::iterator::iterator(const ofStringSplitter * splitter, bool atEnd)
+:splitter(splitter)
+,next(splitter->source.begin())
+,atEnd(atEnd)
+,lastToken(false){
+	if(!atEnd){
+		advance();
+	}
+}
+
+//--------------------------------------------------
+void ofStringSplitter::iterator::advance(){
+	auto & source = splitter->source;
+	auto & delimiter = splitter->delimiter;
+	while(!lastToken){
+		auto start = next;
+		auto stop = delimiter.empty() ? source.end() : std::search(start, source.end(), delimiter.begin(), delimiter.end());
+		lastToken = stop == source.end();
+		next = lastToken ? stop : stop + delimiter.size();
+		ofStringRange token(start, stop - start);
+		if(splitter->trim){
+			token = token.trimmed();
 		}
-		if (subend == source.end()) {
-			break;
+		if(!splitter->ignoreEmpty || !token.empty()){
+			current = token;
+			return;
 		}
-		substart = subend + delimiter.size();
 	}
-	return result;
+	atEnd = true;
 }
 
 //--------------------------------------------------
@@ -4,6 +4,7 @@
 #include "utf8.h"
 #include <bitset> // For ofToBinary.
 #include <chrono>
+#include <type_traits>
 
 #include "ofLog.h"
 
@@ -415,6 +416,109 @@ bool ofContains(const std::vector<T>& values, const T& target) {
 /// \returns A vector of strings split with the delimiter.
 std::vector<std::string> ofSplitString(const std::string& source, const std::string& delimiter, bool ignoreEmpty = false, bool trim = false);
 
+/// \brief A piece of a string that points into it instead of copying it.
+///
+/// Used by ofStringSplitter and ofParse() to work on parts of a string
+/// without allocating. It's only valid while the string it points to is
+/// alive and unmodified, so it shouldn't be created from a temporary
+/// std::string.
+class ofStringRange{
+public:
+	ofStringRange(){}
+	ofStringRange(const std::string & str)
+	:ptr(str.data()), length(str.size()){}
+	ofStringRange(const char * str)
+	:ptr(str), length(str ? strlen(str) : 0){}
+	ofStringRange(const char * data, std::size_t size)
+	:ptr(data), length(size){}
+
+	const char * data() const{ return ptr; }
+	std::size_t size() const{ return length; }
+	bool empty() const{ return length == 0; }
+	const char * begin() const{ return ptr; }
+	const char * end() const{ return ptr + length; }
+	char operator[](std::size_t i) const{ return ptr[i]; }
+
+	/// \brief The range without leading and trailing ASCII whitespace
+	ofStringRange trimmed() const;
+
+	/// \brief count characters starting at pos, or up to the end
+	ofStringRange substr(std::size_t pos, std::size_t count = std::string::npos) const;
+
+	/// \brief Copies the range to a new string
+	std::string toString() const{ return std::string(ptr, length); }
+
+	bool operator==(const ofStringRange & other) const{
+		return length == other.length && std::equal(begin(), end(), other.begin());
+	}
+	bool operator!=(const ofStringRange & other) const{
+		return !(*this == other);
+	}
+
+private:
+	const char * ptr = nullptr;
+	std::size_t length = 0;
+};
+
+/// \brief Iterates over the tokens of a string like ofSplitString, without
+/// allocating.
+///
+/// The tokens are ofStringRange pointing into the source, so parsing a line
+/// of a text protocol doesn't need to copy it:
+///
+/// ~~~~{.cpp}
+/// // line is "x,12,3.5"
+/// for(auto token: ofStringSplitter(line, ",")){
+///     float value;
+///     if(ofParse(token, value)){
+///         ...
+///     }
+/// }
+/// ~~~~
+///
+/// The source and delimiter aren't copied, they need to stay alive while
+/// iterating.
+class ofStringSplitter{
+public:
+	/// \param source The string to split.
+	/// \param delimiter The delimiter string.
+	/// \param ignoreEmpty Set to true to skip empty tokens.
+	/// \param trim Set to true to trim the resulting tokens.
+	ofStringSplitter(ofStringRange source, ofStringRange delimiter, bool ignoreEmpty = false, bool trim = false)
+	:source(source), delimiter(delimiter), ignoreEmpty(ignoreEmpty), trim(trim){}
+
+	class iterator{
+	public:
+		ofStringRange operator*() const{ return current; }
+		const ofStringRange * operator->() const{ return &current; }
+		iterator & operator++(){ advance(); return *this; }
+		bool operator==(const iterator & other) const{
+			return atEnd == other.atEnd && (atEnd || current.data() == other.current.data());
+		}
+		bool operator!=(const iterator & other) const{ return !(*this == other); }
+
+	private:
+		friend class ofStringSplitter;
+		iterator(const ofStringSplitter * splitter, bool atEnd);
+		void advance();
+
+		const ofStringSplitter * splitter;
+		const char * next;	///< start of the next token
+		ofStringRange current;
+		bool atEnd;
+		bool lastToken;	///< current is the last token of the source
+	};
+
+	iterator begin() const{ return iterator(this, false); }
+	iterator end() const{ return iterator(this, true); }
+
+private:
+	ofStringRange source;
+	ofStringRange delimiter;
+	bool ignoreEmpty;
+	bool trim;
+};
+
 /// \brief Join a vector of strings together into one string.
 /// \param stringElements The vector of strings to join.
 /// \param delimiter The delimiter to put betweeen each string.
@@ -570,6 +674,60 @@ std::string ofToString(const T& value, int precision, int width, char fill ){
 	return out.str();
 }
 
+/// \brief Format an integer into a buffer, without allocating.
+///
+/// ~~~~{.cpp}
+/// char line[64];
+/// auto length = ofToChars(line, sizeof(line), sensorValue);
+/// serial.writeBytes(line, length);
+/// ~~~~
+///
+/// \param buffer Where to write the characters, followed by a null.
+/// \param size The size of the buffer.
+/// \param value The value to format.
+/// \returns The number of characters written, not counting the null, or 0
+/// and nothing written if they don't fit.
+template <class T>
+typename std::enable_if<std::is_integral<T>::value, std::size_t>::type
+ofToChars(char * buffer, std::size_t size, T value){
+	char digits[24];
+	std::size_t numDigits = 0;
+	bool negative = value < T(0);
+	auto magnitude = static_cast<unsigned long long>(value);
+	if(negative){
+		magnitude = 0ull - magnitude;
+	}
+	do{
+		digits[numDigits++] = char('0' + magnitude % 10);
+		magnitude /= 10;
+	}while(magnitude);
+	std::size_t length = numDigits + (negative ? 1 : 0);
+	if(length + 1 > size){
+		return 0;
+	}
+	char * out = buffer;
+	if(negative){
+		*out++ = '-';
+	}
+	while(numDigits){
+		*out++ = digits[--numDigits];
+	}
+	*out = '\0';
+	return length;
+}
+
+/// \brief Format a floating point number into a buffer, without
+/// allocating, like ofToString(value).
+/// \returns The number of characters written, not counting the null, or 0
+/// if they don't fit.
+std::size_t ofToChars(char * buffer, std::size_t size, double value);
+
+/// \brief Format a floating point number into a buffer with a fixed number
+/// of decimals, without allocating, like ofToString(value, precision).
+/// \returns The number of characters written, not counting the null, or 0
+/// if they don't fit.
+std::size_t ofToChars(char * buffer, std::size_t size, double value, int precision);
+
 /// \brief Convert a vector of values to a comma-delimited string.
 ///
 /// This method will take any vector of values and output a list of the values
@@ -678,6 +836,27 @@ double ofToDouble(const std::string& doubleString);
 /// \returns the boolean represented by the string or 0 on failure.
 bool ofToBool(const std::string& boolString);
 
+/// \brief Parse a number from a part of a string, without allocating.
+///
+/// Unlike ofToInt() and friends the whole range has to be the number,
+/// other than leading and trailing whitespace, so "12" and " 12 " parse
+/// but "12px" doesn't. Integers have to be decimal and fit in the type.
+///
+/// ~~~~{.cpp}
+/// int port;
+/// if(!ofParse(ofStringRange(buffer, length), port)){
+///     ofLogError() << "invalid port";
+/// }
+/// ~~~~
+///
+/// \param str The range of characters to parse.
+/// \param value Set to the parsed number, unchanged on failure.
+/// \returns true if the range was a valid number.
+bool ofParse(const ofStringRange & str, int & value);
+bool ofParse(const ofStringRange & str, int64_t & value);
+bool ofParse(const ofStringRange & str, float & value);
+bool ofParse(const ofStringRange & str, double & value);
+
 /// \brief Converts any value to its equivalent hexadecimal representation.
 ///
 /// The hexadecimal representation corresponds to the way a number is stored in
@@ -1,5 +1,6 @@
 #include "ofXml.h"
 #include "ofUtils.h"
+#include <cstring>
 
 using namespace std;
 
@@ -26,7 +27,14 @@ bool ofXml::load(const std::filesystem::path & file){
 }
 
 bool ofXml::load(const ofBuffer & buffer){
-	return parse(buffer.getText());
+	auto auxDoc = std::make_shared<pugi::xml_document>();
+	if(auxDoc->load_buffer(buffer.getData(), buffer.size())){
+		doc = auxDoc;
+		xml = doc->root();
+		return true;
+	}else{
+		return false;
+	}
 }
 
 bool ofXml::parse(const std::string & xmlStr){
@@ -375,6 +383,377 @@ ofXmlSearchIterator ofXmlSearchIterator::operator--(int){
 	}
 }
 
+namespace{
+	bool isXmlSpace(char c){
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	bool isXmlNameEnd(char c){
+		return isXmlSpace(c) || c == '/' || c == '>' || c == '=';
+	}
+
+	bool startsWith(const char * data, size_t length, size_t pos, const char * prefix){
+		size_t prefixLength = strlen(prefix);
+		return length - pos >= prefixLength && memcmp(data + pos, prefix, prefixLength) == 0;
+	}
+
+	// position right after the first occurrence of str from pos or npos
+	size_t findAfter(const char * data, size_t length, size_t pos, const char * str){
+		size_t strLength = strlen(str);
+		for(; length - pos >= strLength; pos++){
+			if(data[pos] == str[0] && memcmp(data + pos, str, strLength) == 0){
+				return pos + strLength;
+			}
+		}
+		return string::npos;
+	}
+}
+
+ofXmlStreamReader::ofXmlStreamReader(){
+	close();
+}
+
+bool ofXmlStreamReader::open(const std::filesystem::path & file, bool bRelativeToData){
+	close();
+	if(!this->file.open(file, bRelativeToData)){
+		setError("couldn't open " + file.string());
+		return false;
+	}
+	data = this->file.getData();
+	length = this->file.size();
+	return true;
+}
+
+bool ofXmlStreamReader::open(const ofBuffer & buffer){
+	return open(buffer.getData(), buffer.size());
+}
+
+bool ofXmlStreamReader::open(const char * data, size_t size){
+	close();
+	this->data = data;
+	length = data ? size : 0;
+	return true;
+}
+
+void ofXmlStreamReader::close(){
+	file.close();
+	data = nullptr;
+	length = 0;
+	pos = 0;
+	tagStart = 0;
+	event = None;
+	name.clear();
+	text.clear();
+	numAttributes = 0;
+	openElements.clear();
+	bPendingEnd = false;
+	bSkipping = false;
+	error.clear();
+}
+
+bool ofXmlStreamReader::setError(const string & error){
+	this->error = error;
+	event = None;
+	ofLogError("ofXmlStreamReader") << error;
+	return false;
+}
+
+bool ofXmlStreamReader::next(){
+	if(!error.empty()){
+		return false;
+	}
+	if(event == EndElement){
+		openElements.pop_back();
+	}
+	if(bPendingEnd){
+		// self closing element
+		bPendingEnd = false;
+		numAttributes = 0;
+		event = EndElement;
+		return true;
+	}
+	while(pos < length){
+		if(data[pos] != '<'){
+			size_t end = pos;
+			bool whitespace = true;
+			for(; end < length && data[end] != '<'; end++){
+				whitespace &= isXmlSpace(data[end]);
+			}
+			size_t begin = pos;
+			pos = end;
+			if(whitespace){
+				continue;
+			}
+			if(openElements.empty()){
+				return setError("text outside of the root element at " + ofToString(begin));
+			}
+			text.clear();
+			if(!bSkipping){
+				appendDecoded(text, data + begin, data + end);
+			}
+			numAttributes = 0;
+			event = Text;
+			return true;
+		}
+
+		if(startsWith(data, length, pos, "<?")){
+			pos = findAfter(data, length, pos + 2, "?>");
+		}else if(startsWith(data, length, pos, "<!--")){
+			pos = findAfter(data, length, pos + 4, "-->");
+		}else if(startsWith(data, length, pos, "<![CDATA[")){
+			size_t begin = pos + 9;
+			pos = findAfter(data, length, begin, "]]>");
+			if(pos == string::npos){
+				return setError("unclosed CDATA section at " + ofToString(begin - 9));
+			}
+			text.clear();
+			if(!bSkipping){
+				text.assign(data + begin, pos - 3 - begin);
+			}
+			numAttributes = 0;
+			event = Text;
+			return true;
+		}else if(startsWith(data, length, pos, "<!")){
+			// doctype, with an optional internal subset in []
+			int brackets = 0;
+			for(pos += 2; pos < length && (data[pos] != '>' || brackets > 0); pos++){
+				if(data[pos] == '[') brackets++;
+				else if(data[pos] == ']') brackets--;
+			}
+			pos = pos < length ? pos + 1 : string::npos;
+		}else if(startsWith(data, length, pos, "</")){
+			return parseEndTag();
+		}else{
+			return parseStartTag();
+		}
+		if(pos == string::npos){
+			return setError("unexpected end of the document");
+		}
+	}
+	if(!openElements.empty()){
+		return setError("unexpected end of the document, <" + openElements.back() + "> is not closed");
+	}
+	event = None;
+	return false;
+}
+
+bool ofXmlStreamReader::parseStartTag(){
+	tagStart = pos;
+	size_t begin = ++pos;
+	for(; pos < length && !isXmlNameEnd(data[pos]); pos++);
+	if(pos == begin || pos == length){
+		return setError("invalid element at " + ofToString(tagStart));
+	}
+	if(openElements.empty() && event != None){
+		return setError("more than one root element at " + ofToString(tagStart));
+	}
+	openElements.emplace_back(data + begin, pos - begin);
+	name = openElements.back();
+	numAttributes = 0;
+
+	while(true){
+		for(; pos < length && isXmlSpace(data[pos]); pos++);
+		if(pos == length){
+			return setError("unexpected end of the document in <" + name + ">");
+		}
+		if(data[pos] == '>'){
+			pos++;
+			break;
+		}
+		if(data[pos] == '/'){
+			if(pos + 1 == length || data[pos + 1] != '>'){
+				return setError("invalid element <" + name + "> at " + ofToString(tagStart));
+			}
+			pos += 2;
+			bPendingEnd = true;
+			break;
+		}
+
+		size_t nameBegin = pos;
+		for(; pos < length && !isXmlNameEnd(data[pos]); pos++);
+		size_t nameEnd = pos;
+		for(; pos < length && isXmlSpace(data[pos]); pos++);
+		if(nameBegin == nameEnd || pos == length || data[pos] != '='){
+			return setError("invalid attribute in <" + name + "> at " + ofToString(nameBegin));
+		}
+		for(pos++; pos < length && isXmlSpace(data[pos]); pos++);
+		if(pos == length || (data[pos] != '"' && data[pos] != '\'')){
+			return setError("invalid attribute in <" + name + "> at " + ofToString(nameBegin));
+		}
+		char quote = data[pos];
+		size_t valueBegin = ++pos;
+		for(; pos < length && data[pos] != quote; pos++);
+		if(pos == length){
+			return setError("unclosed attribute in <" + name + "> at " + ofToString(nameBegin));
+		}
+		if(!bSkipping){
+			// the strings are reused from element to element
+			if(numAttributes == attributes.size()){
+				attributes.emplace_back();
+			}
+			auto & attribute = attributes[numAttributes++];
+			attribute.first.assign(data + nameBegin, nameEnd - nameBegin);
+			attribute.second.clear();
+			appendDecoded(attribute.second, data + valueBegin, data + pos);
+		}
+		pos++;
+	}
+	event = StartElement;
+	return true;
+}
+
+bool ofXmlStreamReader::parseEndTag(){
+	size_t begin = pos + 2;
+	for(pos = begin; pos < length && !isXmlNameEnd(data[pos]); pos++);
+	size_t end = pos;
+	for(; pos < length && isXmlSpace(data[pos]); pos++);
+	if(pos == length || data[pos] != '>'){
+		return setError("invalid end of element at " + ofToString(begin - 2));
+	}
+	pos++;
+	if(openElements.empty() || openElements.back().compare(0, string::npos, data + begin, end - begin) != 0){
+		return setError("unexpected </" + string(data + begin, end - begin) + "> at " + ofToString(begin - 2));
+	}
+	name = openElements.back();
+	numAttributes = 0;
+	event = EndElement;
+	return true;
+}
+
+bool ofXmlStreamReader::nextElement(const string & name){
+	while(next()){
+		if(event == StartElement && this->name == name){
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ofXmlStreamReader::findEndOfElement(){
+	if(event != StartElement){
+		return false;
+	}
+	size_t depth = openElements.size();
+	bSkipping = true;
+	while(next() && !(event == EndElement && openElements.size() == depth));
+	bSkipping = false;
+	return error.empty();
+}
+
+ofXml ofXmlStreamReader::readElement(){
+	size_t begin = tagStart;
+	if(!findEndOfElement()){
+		return ofXml();
+	}
+	auto doc = std::make_shared<pugi::xml_document>();
+	auto result = doc->load_buffer(data + begin, pos - begin);
+	if(!result){
+		ofLogError("ofXmlStreamReader") << "readElement(): couldn't parse <" << name << ">: " << result.description();
+		return ofXml();
+	}
+	return ofXml(doc, doc->first_child());
+}
+
+void ofXmlStreamReader::skipElement(){
+	findEndOfElement();
+}
+
+void ofXmlStreamReader::appendDecoded(string & dst, const char * begin, const char * end) const{
+	while(begin < end){
+		const char * amp = static_cast<const char*>(memchr(begin, '&', end - begin));
+		if(!amp){
+			dst.append(begin, end);
+			return;
+		}
+		dst.append(begin, amp);
+		const char * semicolon = static_cast<const char*>(memchr(amp, ';', end - amp));
+		if(!semicolon){
+			dst.append(amp, end);
+			return;
+		}
+		string entity(amp + 1, semicolon);
+		if(entity == "lt") dst += '<';
+		else if(entity == "gt") dst += '>';
+		else if(entity == "amp") dst += '&';
+		else if(entity == "quot") dst += '"';
+		else if(entity == "apos") dst += '\'';
+		else if(entity.size() > 1 && entity[0] == '#'){
+			uint32_t codepoint = entity[1] == 'x' ?
+				strtoul(entity.c_str() + 2, nullptr, 16) :
+				strtoul(entity.c_str() + 1, nullptr, 10);
+			if(codepoint <= 0x10FFFF && (codepoint < 0xD800 || codepoint > 0xDFFF)){
+				utf8::append(codepoint, back_inserter(dst));
+			}
+		}else{
+			// unknown entity, keep it as is
+			dst.append(amp, semicolon + 1);
+		}
+		begin = semicolon + 1;
+	}
+}
+
+ofXmlStreamReader::Event ofXmlStreamReader::getEvent() const{
+	return event;
+}
+
+const string & ofXmlStreamReader::getName() const{
+	return name;
+}
+
+const string & ofXmlStreamReader::getText() const{
+	return text;
+}
+
+size_t ofXmlStreamReader::getDepth() const{
+	return openElements.size();
+}
+
+size_t ofXmlStreamReader::getNumAttributes() const{
+	return numAttributes;
+}
+
+const string & ofXmlStreamReader::getAttributeName(size_t i) const{
+	return attributes[i].first;
+}
+
+const string & ofXmlStreamReader::getAttributeValue(size_t i) const{
+	return attributes[i].second;
+}
+
+bool ofXmlStreamReader::hasAttribute(const string & name) const{
+	for(size_t i = 0; i < numAttributes; i++){
+		if(attributes[i].first == name){
+			return true;
+		}
+	}
+	return false;
+}
+
+string ofXmlStreamReader::getAttribute(const string & name) const{
+	for(size_t i = 0; i < numAttributes; i++){
+		if(attributes[i].first == name){
+			return attributes[i].second;
+		}
+	}
+	return "";
+}
+
+bool ofXmlStreamReader::hasError() const{
+	return !error.empty();
+}
+
+const string & ofXmlStreamReader::getError() const{
+	return error;
+}
+
+size_t ofXmlStreamReader::getPosition() const{
+	return pos;
+}
+
+size_t ofXmlStreamReader::size() const{
+	return length;
+}
+
 void ofSerialize(ofXml & xml, const ofAbstractParameter & parameter){
 	if(!parameter.isSerializable()){
 		return;
@@ -414,9 +793,11 @@ void ofDeserialize(const ofXml & xml, ofAbstractParameter & parameter){
 	if(child){
 		if(parameter.type() == typeid(ofParameterGroup).name()){
 			ofParameterGroup & group = static_cast <ofParameterGroup &>(parameter);
+			group.beginBatch();
 			for(auto & p: group){
 				ofDeserialize(child, *p);
 			}
+			group.endBatch();
 		}else{
 			if(parameter.type() == typeid(ofParameter <int> ).name()){
 				parameter.cast <int>() = child.getIntValue();
@@ -202,6 +202,7 @@ private:
 	template<class It>
 	friend class ofXmlIterator;
 	friend class ofXmlSearchIterator;
+	friend class ofXmlStreamReader;
 };
 
 template<class It>
@@ -289,6 +290,117 @@ private:
 	mutable ofXml xml;
 	friend ofXml::Search;
 };
+/// \brief Reads an xml document one element at a time without loading it
+///
+/// ofXml parses the whole document in memory, which for files of hundreds
+/// of MB takes seconds and several times their size in memory. This pull
+/// parser goes through the document in place, from an ofBuffer or a memory
+/// mapped file, and only builds an ofXml for the elements asked for:
+///
+/// ~~~~{.cpp}
+/// ofXmlStreamReader reader;
+/// reader.open("cues.xml");
+/// while(reader.nextElement("cue")){
+///     auto time = ofToFloat(reader.getAttribute("time"));
+///     if(time > now){
+///         ofXml cue = reader.readElement();
+///         ...
+///     }
+/// }
+/// ~~~~
+///
+/// Entities and character references are decoded in texts and attributes,
+/// whitespace only texts, comments, processing instructions and the
+/// doctype are skipped.
+class ofXmlStreamReader{
+public:
+	enum Event{
+		None,
+		StartElement,
+		EndElement,
+		Text,
+	};
+
+	ofXmlStreamReader();
+
+	/// \brief Memory maps file, relative to the data folder by default
+	bool open(const std::filesystem::path & file, bool bRelativeToData = true);
+
+	/// \brief Reads from buffer, which has to stay alive and unchanged
+	/// while the reader is used
+	bool open(const ofBuffer & buffer);
+	bool open(const char * data, std::size_t size);
+	void close();
+
+	/// \brief Advances to the next element start, element end or text
+	/// \returns false at the end of the document or on errors
+	bool next();
+
+	/// \brief Advances to the start of the next element called name at any
+	/// depth, skipping everything in between
+	bool nextElement(const std::string & name);
+
+	Event getEvent() const;
+
+	/// \brief Name of the element that started or ended
+	const std::string & getName() const;
+
+	/// \brief Decoded contents of a Text event, CDATA sections included
+	const std::string & getText() const;
+
+	/// \brief Depth of the current element, 1 for the root
+	std::size_t getDepth() const;
+
+	/// \brief Attributes of the element that just started
+	std::size_t getNumAttributes() const;
+	const std::string & getAttributeName(std::size_t i) const;
+	const std::string & getAttributeValue(std::size_t i) const;
+	bool hasAttribute(const std::string & name) const;
+	/// \returns the value of attribute name or an empty string
+	std::string getAttribute(const std::string & name) const;
+
+	/// \brief Parses the element that just started, with all its children,
+	/// into an ofXml and advances to its end
+	/// \returns the element, or an empty ofXml if the event is not
+	/// StartElement or the element is not valid
+	ofXml readElement();
+
+	/// \brief Advances to the end of the element that just started without
+	/// decoding any of its contents
+	void skipElement();
+
+	bool hasError() const;
+	const std::string & getError() const;
+
+	/// \brief Offset in bytes of the parser in the document, together with
+	/// size() it can be used to show the loading progress
+	std::size_t getPosition() const;
+	std::size_t size() const;
+
+private:
+	bool setError(const std::string & error);
+	bool parseStartTag();
+	bool parseEndTag();
+	bool findEndOfElement();
+	void appendDecoded(std::string & dst, const char * begin, const char * end) const;
+
+	ofMappedBuffer file;
+	const char * data;
+	std::size_t length;
+	std::size_t pos;
+	std::size_t tagStart;
+
+	Event event;
+	std::string name;
+	std::string text;
+	std::vector<std::pair<std::string, std::string>> attributes;
+	std::size_t numAttributes;
+	std::vector<std::string> openElements;
+	bool bPendingEnd;
+	bool bSkipping;
+	std::string error;
+};
+
 // serializer
 void ofSerialize(ofXml & xml, const ofAbstractParameter & parameter);
 void ofDeserialize(const ofXml & xml, ofAbstractParameter & parameter);
@@ -0,0 +1,374 @@
+#include "ofCaptureManager.h"
+
+#ifdef OF_VIDEO_CAPTURE_GSTREAMER
+
+#include "ofImage.h"
+#include "ofTaskPool.h"
+#include "ofGLUtils.h"
+#include "ofMetrics.h"
+#include <gst/app/gstappsink.h>
+
+using namespace std;
+
+//-------------------------------------------------
+//----------------------------------------- device
+//-------------------------------------------------
+
+ofCaptureManager::Device::Device()
+:width(0)
+,height(0)
+,framerate(0)
+,bMjpeg(true)
+,bDecoding(false)
+,numDropped(0)
+,droppedMetric(nullptr)
+,bCurrentNew(false){
+}
+
+#if GST_VERSION_MAJOR>0
+GstFlowReturn ofCaptureManager::Device::on_buffer(shared_ptr<GstSample> sample){
+	// still decoding the last frame, a newer one will come
+	if(bDecoding.exchange(true, memory_order_acq_rel)){
+		numDropped++;
+		droppedMetric->add();
+		return GST_FLOW_OK;
+	}
+	if(bMjpeg){
+		ofGetTaskPool().submit([this, sample]{
+			decode(sample);
+		});
+	}else{
+		// raw frames are only copied, not worth a task
+		decode(sample);
+	}
+	return GST_FLOW_OK;
+}
+
+GstFlowReturn ofCaptureManager::Device::on_preroll(shared_ptr<GstSample> sample){
+	return GST_FLOW_OK;
+}
+
+void ofCaptureManager::Device::decode(shared_ptr<GstSample> sample){
+	GstBuffer * buffer = gst_sample_get_buffer(sample.get());
+	Frame & back = frames.getBack();
+
+	// every pipeline has the same clock and base time, so the running
+	// time the source stamped on the buffer is comparable between them
+	if(GST_BUFFER_PTS_IS_VALID(buffer)){
+		back.timestamp = GST_BUFFER_PTS(buffer);
+	}else{
+		GstClock * clock = gst_element_get_clock(gst.getPipeline());
+		if(clock){
+			back.timestamp = gst_clock_get_time(clock) - gst_element_get_base_time(gst.getPipeline());
+			gst_object_unref(clock);
+		}
+	}
+
+	bool ok = false;
+	GstMapInfo info;
+	if(gst_buffer_map(buffer, &info, GST_MAP_READ)){
+		if(bMjpeg){
+			jpeg.set((const char*)info.data, info.size);
+			ok = ofLoadImage(back.pixels, jpeg);
+		}else{
+			GstVideoInfo vinfo;
+			GstCaps * caps = gst_sample_get_caps(sample.get());
+			if(caps && gst_video_info_from_caps(&vinfo, caps)){
+				back.pixels.setFromAlignedPixels(info.data, vinfo.width, vinfo.height, OF_PIXELS_RGB, vinfo.stride[0]);
+				ok = true;
+			}
+		}
+		gst_buffer_unmap(buffer, &info);
+	}
+
+	if(ok){
+		frames.publish();
+	}else{
+		ofLogError("ofCaptureManager") << "couldn't decode frame from " << pipeline;
+	}
+	bDecoding.store(false, memory_order_release);
+}
+#endif
+
+
+//-------------------------------------------------
+//----------------------------------------- capture manager
+//-------------------------------------------------
+
+ofCaptureManager::ofCaptureManager()
+:clock(nullptr)
+,syncTolerance(-1)
+,frameSetTimestamp(0)
+,bStarted(false)
+,bFrameNew(false)
+,bUseTexture(true)
+,bTextureArray(false)
+,textureArray(0){
+}
+
+ofCaptureManager::~ofCaptureManager(){
+	close();
+}
+
+size_t ofCaptureManager::addDevice(int deviceID, int w, int h, int framerate, bool mjpeg){
+	return addDevice("/dev/video" + ofToString(deviceID), w, h, framerate, mjpeg);
+}
+
+size_t ofCaptureManager::addDevice(const string & device, int w, int h, int framerate, bool mjpeg){
+	if(bStarted){
+		ofLogError("ofCaptureManager") << "addDevice(): can't add devices once started, close first";
+		return devices.size();
+	}
+	unique_ptr<Device> d(new Device);
+	d->width = w;
+	d->height = h;
+	d->framerate = framerate;
+	d->bMjpeg = mjpeg;
+	d->droppedMetric = &ofGetMetrics().getCounter("of_video_capture_dropped_frames_total{device=\"" + ofToString(devices.size()) + "\"}",
+		"Frames captured but never decoded by ofCaptureManager");
+	string caps = ",width=" + ofToString(w) + ",height=" + ofToString(h) + ",framerate=" + ofToString(framerate) + "/1";
+	if(mjpeg){
+		// the jpegs go to the app as they are, decoded in the task pool
+		d->pipeline = "v4l2src device=" + device + " ! image/jpeg" + caps +
+			" ! appsink name=sink enable-last-sample=0 max-buffers=1 drop=true";
+	}else{
+		d->pipeline = "v4l2src device=" + device + " ! video/x-raw" + caps +
+			" ! videoconvert ! video/x-raw,format=RGB ! appsink name=sink enable-last-sample=0 max-buffers=1 drop=true";
+	}
+	devices.push_back(move(d));
+	return devices.size() - 1;
+}
+
+size_t ofCaptureManager::getNumDevices() const{
+	return devices.size();
+}
+
+void ofCaptureManager::setSyncTolerance(float seconds){
+	syncTolerance = max(seconds, 0.f) * GST_SECOND;
+}
+
+float ofCaptureManager::getSyncTolerance() const{
+	return float(syncTolerance) / GST_SECOND;
+}
+
+void ofCaptureManager::setUseTexture(bool use){
+	bUseTexture = use;
+}
+
+bool ofCaptureManager::isUsingTextureArray() const{
+	return bTextureArray;
+}
+
+bool ofCaptureManager::start(){
+#if GST_VERSION_MAJOR==0
+	ofLogError("ofCaptureManager") << "start(): needs gstreamer 1.0";
+	return false;
+#else
+	if(bStarted){
+		return true;
+	}
+	if(devices.empty()){
+		ofLogError("ofCaptureManager") << "start(): no devices added";
+		return false;
+	}
+
+	int minFramerate = devices[0]->framerate;
+	bool sameSize = true;
+	for(auto & device: devices){
+		minFramerate = min(minFramerate, device->framerate);
+		sameSize &= device->width == devices[0]->width && device->height == devices[0]->height;
+	}
+	if(syncTolerance < 0){
+		syncTolerance = GST_SECOND / max(minFramerate, 1);
+	}
+#ifndef TARGET_OPENGLES
+	bTextureArray = bUseTexture && sameSize && devices.size() > 1;
+#else
+	bTextureArray = false;
+#endif
+
+	clock = gst_system_clock_obtain();
+	for(auto & device: devices){
+		if(!device->gst.setPipelineWithSink(device->pipeline, "sink", false)){
+			close();
+			return false;
+		}
+		device->gst.setSinkListener(device.get());
+		device->gst.setSyncClock(clock);
+	}
+
+	// the base time is set before going to playing so the timestamps of
+	// the frames of every device start counting at the same time
+	GstClockTime baseTime = gst_clock_get_time(clock);
+	for(auto & device: devices){
+		device->gst.setBaseTime(baseTime);
+		if(!device->gst.startPipeline()){
+			ofLogError("ofCaptureManager") << "start(): couldn't start " << device->pipeline;
+			close();
+			return false;
+		}
+		// the frames are timestamped by the source, waiting for the
+		// clock in the sink would only add latency
+		g_object_set(G_OBJECT(device->gst.getSink()), "sync", FALSE, (void*)NULL);
+		device->gst.play();
+	}
+	bStarted = true;
+	return true;
+#endif
+}
+
+void ofCaptureManager::close(){
+	for(auto & device: devices){
+		device->gst.close();
+	}
+	// the pipelines are stopped, wait for any decode still running
+	for(auto & device: devices){
+		while(device->bDecoding.load(memory_order_acquire)){
+			this_thread::yield();
+		}
+	}
+	devices.clear();
+	if(textureArray){
+		glDeleteTextures(1, &textureArray);
+		textureArray = 0;
+	}
+	if(clock){
+		gst_object_unref(clock);
+		clock = nullptr;
+	}
+	bStarted = false;
+	bFrameNew = false;
+	bTextureArray = false;
+	frameSetTimestamp = 0;
+}
+
+bool ofCaptureManager::isStarted() const{
+	return bStarted;
+}
+
+bool ofCaptureManager::update(){
+	bFrameNew = false;
+	if(!bStarted){
+		return false;
+	}
+
+	// the previous current frame goes back to the decoder, nothing is copied
+	uint64_t newest = 0;
+	bool complete = true;
+	for(auto & device: devices){
+		if(device->frames.update()){
+			swap(device->current, device->frames.getFront());
+			device->bCurrentNew = true;
+		}
+		complete &= device->bCurrentNew;
+		newest = max(newest, device->current.timestamp);
+	}
+	if(!complete){
+		return false;
+	}
+
+	// frames too old for the newest one wait for their next frame
+	for(auto & device: devices){
+		if(device->current.timestamp + syncTolerance < newest){
+			device->bCurrentNew = false;
+			complete = false;
+		}
+	}
+	if(!complete){
+		return false;
+	}
+
+	frameSetTimestamp = newest;
+	for(auto & device: devices){
+		device->bCurrentNew = false;
+		frameSetTimestamp = min(frameSetTimestamp, device->current.timestamp);
+	}
+	if(bUseTexture){
+		uploadTextures();
+	}
+	bFrameNew = true;
+	return true;
+}
+
+void ofCaptureManager::uploadTextures(){
+#ifndef TARGET_OPENGLES
+	if(bTextureArray){
+		const ofPixels & first = devices[0]->current.pixels;
+		for(auto & device: devices){
+			const ofPixels & pixels = device->current.pixels;
+			if(pixels.getWidth() != first.getWidth() || pixels.getHeight() != first.getHeight() || pixels.getPixelFormat() != first.getPixelFormat()){
+				ofLogWarning("ofCaptureManager") << "update(): devices delivered frames of different sizes, using a texture per device";
+				bTextureArray = false;
+				if(textureArray){
+					glDeleteTextures(1, &textureArray);
+					textureArray = 0;
+				}
+				uploadTextures();
+				return;
+			}
+		}
+
+		GLenum glFormat = ofGetGLFormatFromPixelFormat(first.getPixelFormat());
+		if(!textureArray){
+			glGenTextures(1, &textureArray);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, ofGetGLInternalFormatFromPixelFormat(first.getPixelFormat()),
+				first.getWidth(), first.getHeight(), devices.size(), 0, glFormat, GL_UNSIGNED_BYTE, nullptr);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}else{
+			glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+		}
+		ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT, first.getWidth(), first.getBytesPerChannel(), first.getNumChannels());
+		for(size_t i = 0; i < devices.size(); i++){
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, first.getWidth(), first.getHeight(), 1,
+				glFormat, GL_UNSIGNED_BYTE, devices[i]->current.pixels.getData());
+		}
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+		return;
+	}
+#endif
+	for(auto & device: devices){
+		const ofPixels & pixels = device->current.pixels;
+		if(!device->texture.isAllocated() || device->texture.getWidth() != pixels.getWidth() || device->texture.getHeight() != pixels.getHeight()){
+			device->texture.allocate(pixels);
+		}
+		device->texture.loadData(pixels);
+	}
+}
+
+bool ofCaptureManager::isFrameNew() const{
+	return bFrameNew;
+}
+
+const ofPixels & ofCaptureManager::getPixels(size_t device) const{
+	return devices[device]->current.pixels;
+}
+
+uint64_t ofCaptureManager::getTimestamp(size_t device) const{
+	return devices[device]->current.timestamp;
+}
+
+uint64_t ofCaptureManager::getFrameSetTimestamp() const{
+	return frameSetTimestamp;
+}
+
+uint64_t ofCaptureManager::getNumDroppedFrames(size_t device) const{
+	return devices[device]->numDropped;
+}
+
+GLuint ofCaptureManager::getTextureArrayID() const{
+	return textureArray;
+}
+
+const ofTexture & ofCaptureManager::getTexture(size_t device) const{
+	return devices[device]->texture;
+}
+
+GstClock * ofCaptureManager::getClock() const{
+	return clock;
+}
+
+#endif
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "ofConstants.h"
+
+#ifdef OF_VIDEO_CAPTURE_GSTREAMER
+
+#include "ofGstUtils.h"
+#include "ofTripleBuffer.h"
+#include "ofFileUtils.h"
+#include <atomic>
+
+class ofMetricCounter;
+
+// captures from several cameras at once and delivers their frames in
+// synchronized sets:
+//
+//	capture.addDevice(0, 1280, 720, 30);
+//	capture.addDevice(1, 1280, 720, 30);
+//	capture.start();
+//	...
+//	if(capture.update()){
+//		// one frame of every camera, captured within the sync tolerance
+//		shader.setUniformTexture("cameras", GL_TEXTURE_2D_ARRAY, capture.getTextureArrayID(), 0);
+//	}
+//
+// the cameras are read as MJPEG and decoded in ofGetTaskPool() instead of
+// a decoder and a thread per camera, all the pipelines run on one clock
+// and base time so the timestamps of every camera can be compared. if a
+// camera delivers frames faster than they are decoded the newest one is
+// kept and the rest are dropped
+class ofCaptureManager{
+public:
+	ofCaptureManager();
+	~ofCaptureManager();
+
+	ofCaptureManager(const ofCaptureManager &) = delete;
+	ofCaptureManager & operator=(const ofCaptureManager &) = delete;
+
+	// adds /dev/video<deviceID> or a device path, before start().
+	// mjpeg false captures raw frames instead, for cameras that don't
+	// support it. returns the index of the device in the frame sets
+	std::size_t	addDevice(int deviceID, int w, int h, int framerate = 30, bool mjpeg = true);
+	std::size_t	addDevice(const std::string & device, int w, int h, int framerate = 30, bool mjpeg = true);
+	std::size_t	getNumDevices() const;
+
+	// frames further apart than this aren't put in the same set. by
+	// default one frame at the lowest framerate, which only groups the
+	// last frame of every camera, hardware synced cameras allow a lot less
+	void	setSyncTolerance(float seconds);
+	float	getSyncTolerance() const;
+
+	// upload each set to a texture, true by default. if all the devices
+	// have the same size, on desktop GL, it's a GL_TEXTURE_2D_ARRAY with
+	// one layer per device, otherwise one texture per device
+	void	setUseTexture(bool bUseTexture);
+	bool	isUsingTextureArray() const;
+
+	bool	start();
+	void	close();
+	bool	isStarted() const;
+
+	// takes the newest decoded frames, true if they make a new set
+	bool	update();
+	bool	isFrameNew() const;
+
+	// the frames of the last set
+	const ofPixels &	getPixels(std::size_t device) const;
+	// the capture time of each frame in the last set, in nanoseconds on
+	// the clock shared by all the devices
+	uint64_t	getTimestamp(std::size_t device) const;
+	// the capture time of the oldest frame in the last set
+	uint64_t	getFrameSetTimestamp() const;
+	// frames captured but never decoded, because an older one was still
+	// being decoded
+	uint64_t	getNumDroppedFrames(std::size_t device) const;
+
+	GLuint		getTextureArrayID() const;
+	// only allocated if not using a texture array
+	const ofTexture &	getTexture(std::size_t device) const;
+
+	GstClock *	getClock() const;
+
+private:
+	struct Frame{
+		ofPixels pixels;
+		uint64_t timestamp = 0;
+	};
+
+	class Device: public ofGstAppSink{
+	public:
+		std::string	pipeline;
+		int			width;
+		int			height;
+		int			framerate;
+		bool		bMjpeg;
+		ofGstUtils	gst;
+
+		// the streaming thread only submits a decode if the last one
+		// finished, so there's never more than one producer per device
+		std::atomic<bool>		bDecoding;
+		std::atomic<uint64_t>	numDropped;
+		ofMetricCounter *		droppedMetric;
+		ofBuffer				jpeg;
+		ofTripleBuffer<Frame>	frames;
+
+		// the newest decoded frame, waiting for the others of its set
+		Frame		current;
+		bool		bCurrentNew;
+		ofTexture	texture;
+
+		Device();
+#if GST_VERSION_MAJOR>0
+		GstFlowReturn on_buffer(std::shared_ptr<GstSample> sample);
+		GstFlowReturn on_preroll(std::shared_ptr<GstSample> sample);
+		void decode(std::shared_ptr<GstSample> sample);
+#endif
+	};
+
+	void	uploadTextures();
+
+	std::vector<std::unique_ptr<Device>> devices;
+	GstClock *	clock;
+	int64_t		syncTolerance;		// nanoseconds, -1 until set or started
+	uint64_t	frameSetTimestamp;
+	bool		bStarted;
+	bool		bFrameNew;
+	bool		bUseTexture;
+	bool		bTextureArray;
+	GLuint		textureArray;
+};
+
+#endif
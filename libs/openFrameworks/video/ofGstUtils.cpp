@@ -13,6 +13,10 @@
 #include <gst/gl/gl.h>
 #endif
 
+#if GST_VERSION_MAJOR>0
+#include <gst/net/gstnet.h>
+#endif
+
 #include <glib-object.h>
 #include <glib.h>
 #include <algorithm>
@@ -118,6 +122,10 @@ ofGstUtils::ofGstUtils() {
 
 	busWatchID					= 0;
 
+	bSeeking					= false;
+	pendingSeekNanos			= -1;
+	bPendingSeekAccurate		= true;
+
 #if GLIB_MINOR_VERSION<32
 	if(!g_thread_supported()){
 		g_thread_init(NULL);
@@ -240,6 +248,81 @@ bool ofGstUtils::isFrameByFrame() const{
 	return bFrameByFrame;
 }
 
+void ofGstUtils::seekAsync(int64_t nanos, bool accurate){
+	{
+		std::unique_lock<std::mutex> lock(seekMutex);
+		if(bSeeking){
+			pendingSeekNanos = nanos;
+			bPendingSeekAccurate = accurate;
+			return;
+		}
+		bSeeking = true;
+	}
+	if(!seek(nanos, accurate)){
+		std::unique_lock<std::mutex> lock(seekMutex);
+		bSeeking = false;
+	}
+}
+
+bool ofGstUtils::isSeeking() const{
+	std::unique_lock<std::mutex> lock(seekMutex);
+	return bSeeking;
+}
+
+bool ofGstUtils::seek(int64_t nanos, bool accurate){
+	GstSeekFlags flags = GST_SEEK_FLAG_FLUSH;
+	if(accurate){
+		flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_ACCURATE);
+	}else{
+		flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_KEY_UNIT);
+#if GST_VERSION_MAJOR==1
+		flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_SNAP_NEAREST);
+#endif
+	}
+	if(speed > 1 || speed < -1){
+		flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_SKIP);
+	}
+	bool ok;
+	if(speed>0){
+		ok = gst_element_seek(GST_ELEMENT(gstPipeline), speed, GST_FORMAT_TIME, flags,
+				GST_SEEK_TYPE_SET, nanos,
+				GST_SEEK_TYPE_SET, -1);
+	}else{
+		ok = gst_element_seek(GST_ELEMENT(gstPipeline), speed, GST_FORMAT_TIME, flags,
+				GST_SEEK_TYPE_SET, 0,
+				GST_SEEK_TYPE_SET, nanos);
+	}
+	if(!ok){
+		ofLogWarning("ofGstUtils") << "seekAsync(): unable to seek";
+	}
+	return ok;
+}
+
+void ofGstUtils::setSyncClock(GstClock * clock){
+	if(!gstPipeline || !GST_IS_PIPELINE(gstPipeline)){
+		ofLogError("ofGstUtils") << "setSyncClock(): needs a loaded pipeline";
+		return;
+	}
+	if(clock){
+		gst_pipeline_use_clock(GST_PIPELINE(gstPipeline), clock);
+	}else{
+		gst_pipeline_auto_clock(GST_PIPELINE(gstPipeline));
+	}
+	// with no start time the base time is only changed by setBaseTime
+	GstClockTime startTime = clock ? GST_CLOCK_TIME_NONE : 0;
+#if GST_VERSION_MAJOR==0
+	gst_pipeline_set_new_stream_time(GST_PIPELINE(gstPipeline), startTime);
+#else
+	gst_element_set_start_time(gstPipeline, startTime);
+#endif
+}
+
+void ofGstUtils::setBaseTime(GstClockTime baseTime){
+	if(gstPipeline){
+		gst_element_set_base_time(gstPipeline, baseTime);
+	}
+}
+
 bool ofGstUtils::startPipeline(){
 
 	bPaused 			= true;
@@ -369,12 +452,12 @@ float ofGstUtils::getPosition() const{
 #if GST_VERSION_MAJOR==0
 		GstFormat format=GST_FORMAT_TIME;
 		if(!gst_element_query_position(GST_ELEMENT(gstPipeline),&format,&pos)){
-			ofLogVerbose("ofGstUtils") << "getPosition(): couldn't query position";
+			OFLOG_VERBOSE("ofGstUtils") << "getPosition(): couldn't query position";
 			return -1;
 		}
 #else
 		if(!gst_element_query_position(GST_ELEMENT(gstPipeline),GST_FORMAT_TIME,&pos)){
-			ofLogVerbose("ofGstUtils") << "getPosition(): couldn't query position";
+			OFLOG_VERBOSE("ofGstUtils") << "getPosition(): couldn't query position";
 			return -1;
 		}
 #endif
@@ -422,6 +505,11 @@ void ofGstUtils::setPosition(float pct){
 		flags = (GstSeekFlags)(flags | GST_SEEK_FLAG_SKIP);
 	}
 	gint64 pos = (guint64)((double)pct*(double)durationNanos);
+	{
+		// this one replaces any async seek still waiting
+		std::unique_lock<std::mutex> lock(seekMutex);
+		pendingSeekNanos = -1;
+	}
 
 	/*if(bPaused){
 		seek_lock();
@@ -530,6 +618,12 @@ void ofGstUtils::close(){
 	}
 	stop();
 
+	{
+		std::unique_lock<std::mutex> lock(seekMutex);
+		bSeeking = false;
+		pendingSeekNanos = -1;
+	}
+
 	if(bLoaded){
 		gst_element_set_state(GST_ELEMENT(gstPipeline), GST_STATE_NULL);
 		gst_element_get_state(gstPipeline,NULL,NULL,2*GST_SECOND);
@@ -576,7 +670,7 @@ bool ofGstUtils::gstHandleMessage(GstBus * bus, GstMessage * msg){
 		case GST_MESSAGE_BUFFERING:
 			gint pctBuffered;
 			gst_message_parse_buffering(msg,&pctBuffered);
-			ofLogVerbose("ofGstUtils") << "gstHandleMessage(): buffering " << pctBuffered;
+			OFLOG_VERBOSE("ofGstUtils") << "gstHandleMessage(): buffering " << pctBuffered;
 			if(pctBuffered<100){
 				gst_element_set_state (gstPipeline, GST_STATE_PAUSED);
 			}else if(!bPaused){
@@ -612,9 +706,23 @@ bool ofGstUtils::gstHandleMessage(GstBus * bus, GstMessage * msg){
 					<< getName(oldstate) << " to " << getName(newstate) << " (" + getName(pendstate) << ")";*/
 		}break;
 
-		case GST_MESSAGE_ASYNC_DONE:
-			ofLogVerbose("ofGstUtils") << "gstHandleMessage(): async done";
-		break;
+		case GST_MESSAGE_ASYNC_DONE:{
+			OFLOG_VERBOSE("ofGstUtils") << "gstHandleMessage(): async done";
+			// the last seek prerolled, do the newest one requested meanwhile
+			std::unique_lock<std::mutex> lock(seekMutex);
+			int64_t nanos = pendingSeekNanos;
+			bool accurate = bPendingSeekAccurate;
+			pendingSeekNanos = -1;
+			if(nanos >= 0){
+				lock.unlock();
+				if(!seek(nanos, accurate)){
+					lock.lock();
+					bSeeking = false;
+				}
+			}else{
+				bSeeking = false;
+			}
+		}break;
 
 		case GST_MESSAGE_ERROR: {
 			GError *err;
@@ -735,7 +843,7 @@ bool ofGstUtils::gstHandleMessage(GstBus * bus, GstMessage * msg){
 		}
 #endif
 		default:
-			ofLogVerbose("ofGstUtils") << "gstHandleMessage(): unhandled message from " << GST_MESSAGE_SRC_NAME(msg);
+			OFLOG_VERBOSE("ofGstUtils") << "gstHandleMessage(): unhandled message from " << GST_MESSAGE_SRC_NAME(msg);
 		break;
 	}
 
@@ -791,7 +899,7 @@ uint64_t ofGstUtils::getMaxLatencyNanos() const{
 ofGstVideoUtils::ofGstVideoUtils(){
 	bIsFrameNew					= false;
 	bHavePixelsChanged			= false;
-	bBackPixelsChanged			= false;
+	bCachedFrameChanged			= false;
 #if GST_VERSION_MAJOR==1
 	GstMapInfo initMapinfo		= {0,};
 	mapinfo 					= initMapinfo;
@@ -800,8 +908,11 @@ ofGstVideoUtils::ofGstVideoUtils(){
 #ifdef OF_USE_GST_GL
 	glDisplay = NULL;
 	glContext = NULL;
+	bUseGLMemory = true;
+	bPixelsNeedDownload = false;
 #endif
 	copyPixels = false;
+	nextCachedFrame = 0;
 }
 
 ofGstVideoUtils::~ofGstVideoUtils(){
@@ -812,17 +923,32 @@ void ofGstVideoUtils::close(){
 	ofGstUtils::close();
 	std::unique_lock<std::mutex> lock(mutex);
 	pixels.clear();
-	backPixels.clear();
 	eventPixels.clear();
 	bIsFrameNew					= false;
 	bHavePixelsChanged			= false;
-	bBackPixelsChanged			= false;
+	bCachedFrameChanged			= false;
 	frontBuffer.reset();
-	backBuffer.reset();
+	clearFrames();
+	for(auto & cached: frameCache){
+		cached.nanos = -1;
+	}
 	
 #if GST_VERSION_MAJOR==1
 	while(!bufferQueue.empty()) bufferQueue.pop();
 #endif
+#ifdef OF_USE_GST_GL
+	// the textures belong to the gstreamer samples released above
+	frontTexture.clear();
+	bPixelsNeedDownload = false;
+	if(glContext){
+		gst_object_unref(glContext);
+		glContext = NULL;
+	}
+	if(glDisplay){
+		gst_object_unref(glDisplay);
+		glDisplay = NULL;
+	}
+#endif
 }
 
 bool ofGstVideoUtils::isInitialized() const{
@@ -834,10 +960,16 @@ bool ofGstVideoUtils::isFrameNew() const{
 }
 
 ofPixels& ofGstVideoUtils::getPixels(){
+#ifdef OF_USE_GST_GL
+	downloadGLMemory();
+#endif
 	return pixels;
 }
 
 const ofPixels & ofGstVideoUtils::getPixels() const{
+#ifdef OF_USE_GST_GL
+	const_cast<ofGstVideoUtils*>(this)->downloadGLMemory();
+#endif
 	return pixels;
 }
 
@@ -856,20 +988,30 @@ ofTexture * ofGstVideoUtils::getTexture(){
 void ofGstVideoUtils::update(){
 	if (isLoaded()){
 		if(!isFrameByFrame()){
-			std::unique_lock<std::mutex> lock(mutex);
-			bHavePixelsChanged = bBackPixelsChanged;
-			if (bHavePixelsChanged){
-				bBackPixelsChanged=false;
-				swap(pixels,backPixels);
+			// never waits for the streaming thread
+			bHavePixelsChanged = bCachedFrameChanged;
+			bCachedFrameChanged = false;
+			if (frames.update()){
+				bHavePixelsChanged = true;
+				// the front frame belongs to this thread until the next
+				// update, swapping leaves the previous pixels and their
+				// buffer alive in it until the streaming thread reuses it
+				Frame & front = frames.getFront();
 				#ifdef OF_USE_GST_GL
-				if(backTexture.isAllocated()){
-					frontTexture.getTextureData() = backTexture.getTextureData();
+				if(front.bTexture){
+					frontTexture.getTextureData() = front.texture;
 					frontTexture.setTextureMinMagFilter(GL_LINEAR,GL_LINEAR);
 					frontTexture.setTextureWrap(GL_CLAMP_TO_EDGE,GL_CLAMP_TO_EDGE);
-				}
+					// the sample owns the texture, keep it alive while
+					// it's the front one and download pixels from it
+					// only if they are requested
+					swap(frontBuffer,front.buffer);
+					bPixelsNeedDownload = true;
+				}else
 				#endif
-				if(!copyPixels){
-					frontBuffer = backBuffer;
+				{
+					swap(pixels,front.pixels);
+					swap(frontBuffer,front.buffer);
 				}
 			}
 		}else{
@@ -892,7 +1034,7 @@ void ofGstVideoUtils::update(){
 					gst_buffer_map (buffer, &mapinfo, GST_MAP_READ);
 					//TODO: stride = mapinfo.size / height;
 					pixels.setFromExternalPixels(mapinfo.data,pixels.getWidth(),pixels.getHeight(),pixels.getNumChannels());
-					backBuffer = shared_ptr<GstSample>(sample,gst_sample_unref);
+					frontBuffer = shared_ptr<GstSample>(sample,gst_sample_unref);
 					bHavePixelsChanged=true;
 					gst_buffer_unmap(buffer,&mapinfo);
 				}
@@ -1034,48 +1176,64 @@ ofPixelFormat ofGstVideoUtils::getOFFormat(GstVideoFormat format){
 }
 #endif
 
-/*
-gboolean ofGstVideoUtils::sync_bus_call (GstBus * bus, GstMessage * msg, gpointer data)
-{
-	switch (GST_MESSAGE_TYPE (msg)) {
-		case GST_MESSAGE_NEED_CONTEXT:
-		{
-			ofGstVideoPlayer * player = (ofGstVideoPlayer*)data;
-			const gchar *context_type;
+#ifdef OF_USE_GST_GL
+void ofGstVideoUtils::sync_bus_call (GstBus * bus, GstMessage * msg, gpointer data){
+	// gl elements ask for the display and the context to share textures
+	// with from the streaming threads, answer with the ones wrapping ours
+	if(GST_MESSAGE_TYPE (msg) != GST_MESSAGE_NEED_CONTEXT){
+		return;
+	}
 
-			gst_message_parse_context_type (msg, &context_type);
-			ofLogNotice("ofGstVideoPlayer","got need context %s\n", context_type);
-
-			if (g_strcmp0 (context_type, GST_GL_DISPLAY_CONTEXT_TYPE) == 0) {
-				GstContext *display_context =
-				gst_context_new (GST_GL_DISPLAY_CONTEXT_TYPE, TRUE);
-				gst_context_set_gl_display (display_context, player->glDisplay);
-				//GstStructure *s = gst_context_writable_structure (display_context);
-				//gst_structure_set (s, "context", GST_GL_TYPE_CONTEXT, player->glContext,	NULL);
-				gst_element_set_context (GST_ELEMENT (msg->src), display_context);
-				return TRUE;
-			} else if (g_strcmp0 (context_type, "gst.gl.app_context") == 0) {
-				GstContext *app_context = gst_context_new ("gst.gl.app_context", TRUE);
-				GstStructure *s = gst_context_writable_structure (app_context);
-				gst_structure_set (s, "context", GST_GL_TYPE_CONTEXT, player->glContext,	NULL);
-				gst_element_set_context (GST_ELEMENT (msg->src), app_context);
-				return TRUE;
-			}
-			break;
-		}
-		default:
-		break;
+	ofGstVideoUtils * videoUtils = (ofGstVideoUtils*)data;
+	const gchar *context_type;
+	gst_message_parse_context_type (msg, &context_type);
+	OFLOG_VERBOSE("ofGstVideoUtils") << "sync_bus_call(): got need context " << context_type;
+
+	if (g_strcmp0 (context_type, GST_GL_DISPLAY_CONTEXT_TYPE) == 0) {
+		GstContext *display_context = gst_context_new (GST_GL_DISPLAY_CONTEXT_TYPE, TRUE);
+		gst_context_set_gl_display (display_context, videoUtils->glDisplay);
+		gst_element_set_context (GST_ELEMENT (msg->src), display_context);
+		gst_context_unref (display_context);
+	} else if (g_strcmp0 (context_type, "gst.gl.app_context") == 0) {
+		GstContext *app_context = gst_context_new ("gst.gl.app_context", TRUE);
+		GstStructure *s = gst_context_writable_structure (app_context);
+		gst_structure_set (s, "context", GST_GL_TYPE_CONTEXT, videoUtils->glContext, NULL);
+		gst_element_set_context (GST_ELEMENT (msg->src), app_context);
+		gst_context_unref (app_context);
 	}
-	return FALSE;
-}*/
+}
+#endif
 
 void ofGstVideoUtils::setCopyPixels(bool copy){
 	copyPixels = copy;
 }
 
+void ofGstVideoUtils::setUseGLMemory(bool useGLMemory){
+#ifdef OF_USE_GST_GL
+	bUseGLMemory = useGLMemory;
+#else
+	if(useGLMemory){
+		ofLogWarning("ofGstVideoUtils") << "setUseGLMemory(): OF was built without OF_USE_GST_GL, frames will be copied to pixels";
+	}
+#endif
+}
+
+bool ofGstVideoUtils::isUsingGLMemory() const{
+#ifdef OF_USE_GST_GL
+	return bUseGLMemory;
+#else
+	return false;
+#endif
+}
+
 bool ofGstVideoUtils::setPipeline(string pipeline, ofPixelFormat pixelFormat, bool isStream, int w, int h){
 	internalPixelFormat = pixelFormat;
-#ifndef OF_USE_GST_GL
+#ifdef OF_USE_GST_GL
+	if(bUseGLMemory){
+		return setGLPipeline(pipeline,isStream,w,h);
+	}
+#endif
+
 	string caps;
 #if GST_VERSION_MAJOR==0
 	switch(pixelFormat){
@@ -1113,18 +1271,21 @@ bool ofGstVideoUtils::setPipeline(string pipeline, ofPixelFormat pixelFormat, bo
 	}else{
 		return false;
 	}
-#else
-	string pipeline_string =
-		pipeline + " ! glcolorscale name=gl_filter ! appsink name=ofappsink enable-last-sample=0 caps=\"video/x-raw,format=RGBA\"";
+}
 
-	bool ret;
-	if((w==-1 || h==-1) || pixelFormat==OF_PIXELS_NATIVE || allocate(w,h,pixelFormat)){
-		ret = setPipelineWithSink(pipeline_string,"ofappsink",isStream);
-	}else{
-		ret = false;
+#ifdef OF_USE_GST_GL
+bool ofGstVideoUtils::setGLPipeline(string pipeline, bool isStream, int w, int h){
+	// glupload imports DMA-BUF frames on EGL and uploads any other memory,
+	// glcolorconvert does the conversion to RGBA in the GPU, so the appsink
+	// only negotiates GL memory and frames never go through the CPU
+	internalPixelFormat = OF_PIXELS_RGBA;
+	string caps = "video/x-raw(memory:GLMemory),format=RGBA,texture-target=2D";
+	if(w!=-1 && h!=-1){
+		caps+=", width=" + ofToString(w) + ", height=" + ofToString(h);
 	}
 
-	auto glfilter = gst_bin_get_by_name(GST_BIN(getPipeline()),"gl_filter");
+	string pipeline_string =
+		pipeline + " ! glupload ! glcolorconvert ! appsink name=ofappsink enable-last-sample=0 caps=\"" + caps + "\"";
 
 #if defined(TARGET_LINUX) && !defined(TARGET_OPENGLES)
 	glXMakeCurrent (ofGetX11Display(), None, 0);
@@ -1132,37 +1293,31 @@ bool ofGstVideoUtils::setPipeline(string pipeline, ofPixelFormat pixelFormat, bo
 	glContext = gst_gl_context_new_wrapped (glDisplay, (guintptr) ofGetGLXContext(),
 	    		  GST_GL_PLATFORM_GLX, GST_GL_API_OPENGL);
 
-	g_object_set (G_OBJECT (glfilter), "other-context", glContext, NULL);
-	// FIXME: this seems to be the way to add the context in 1.4.5
-	//
-	// GstBus * bus = gst_pipeline_get_bus (GST_PIPELINE(gstPipeline));
-	// gst_bus_enable_sync_message_emission (bus);
-	// g_signal_connect (bus, "sync-message", G_CALLBACK (sync_bus_call), this);
-	// gst_object_unref(bus);
-
 	glXMakeCurrent (ofGetX11Display(), ofGetX11Window(), ofGetGLXContext());
 #elif defined(TARGET_OPENGLES)
-	cout << "current display " << ofGetEGLDisplay() << endl;
-	eglMakeCurrent (eglGetDisplay(EGL_DEFAULT_DISPLAY), 0,0, 0);
-	glDisplay = (GstGLDisplay *)gst_gl_display_egl_new_with_egl_display(eglGetDisplay(EGL_DEFAULT_DISPLAY));
+	// wrap the display the window was created on so textures can be
+	// shared with it and DMA-BUF imported on the same device
+	eglMakeCurrent (ofGetEGLDisplay(), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	glDisplay = (GstGLDisplay *)gst_gl_display_egl_new_with_egl_display(ofGetEGLDisplay());
 	glContext = gst_gl_context_new_wrapped (glDisplay, (guintptr) ofGetEGLContext(),
 	    		  GST_GL_PLATFORM_EGL, GST_GL_API_GLES2);
-
-	g_object_set (G_OBJECT (glfilter), "other-context", glContext, NULL);
-	// FIXME: this seems to be the way to add the context in 1.4.5
-	//
-	// GstBus * bus = gst_pipeline_get_bus (GST_PIPELINE(gstPipeline));
-	// gst_bus_enable_sync_message_emission (bus);
-	// g_signal_connect (bus, "sync-message", G_CALLBACK (sync_bus_call), this);
-	// gst_object_unref(bus);
-
 	eglMakeCurrent (ofGetEGLDisplay(), ofGetEGLSurface(), ofGetEGLSurface(), ofGetEGLContext());
-
 #endif
 
-	return ret;
-#endif
+	if((w!=-1 && h!=-1) && !allocate(w,h,OF_PIXELS_RGBA)){
+		return false;
+	}
+	if(!setPipelineWithSink(pipeline_string,"ofappsink",isStream)){
+		return false;
+	}
+
+	GstBus * bus = gst_pipeline_get_bus (GST_PIPELINE(getPipeline()));
+	gst_bus_enable_sync_message_emission (bus);
+	g_signal_connect (bus, "sync-message", G_CALLBACK (sync_bus_call), this);
+	gst_object_unref(bus);
+	return true;
 }
+#endif
 
 bool ofGstVideoUtils::setPixelFormat(ofPixelFormat pixelFormat){
 	internalPixelFormat = pixelFormat;
@@ -1181,12 +1336,20 @@ bool ofGstVideoUtils::allocate(int w, int h, ofPixelFormat pixelFormat){
 	}
 #endif
 	pixels.allocate(w,h,pixelFormat);
-	backPixels.allocate(w,h,pixelFormat);
 	pixels.set(0);
-	backPixels.set(0);
+	// the streaming thread takes the size and format from its back frame
+	frames.reset();
+	for(int i=0;i<3;i++){
+		frames[i].buffer.reset();
+		frames[i].pixels.allocate(w,h,pixelFormat);
+		frames[i].pixels.set(0);
+	}
+	frames.publish();
 
 	bHavePixelsChanged = false;
-	bBackPixelsChanged = true;
+	for(auto & cached: frameCache){
+		cached.nanos = -1;
+	}
 
 	internalPixelFormat = pixelFormat;
 	return pixels.isAllocated();
@@ -1195,40 +1358,77 @@ bool ofGstVideoUtils::allocate(int w, int h, ofPixelFormat pixelFormat){
 void ofGstVideoUtils::reallocateOnNextFrame(){
 	std::unique_lock<std::mutex> lock(mutex);
 	pixels.clear();
-	backPixels.clear();
 	bIsFrameNew					= false;
 	bHavePixelsChanged			= false;
-	bBackPixelsChanged			= false;
+	bCachedFrameChanged			= false;
 	frontBuffer.reset();
-	backBuffer.reset();
+	clearFrames();
+	for(auto & cached: frameCache){
+		cached.nanos = -1;
+	}
 #if GST_VERSION_MAJOR==1
 	while(!bufferQueue.empty()) bufferQueue.pop();
 #endif
 }
 
+void ofGstVideoUtils::setFrameCacheSize(size_t numFrames){
+	std::unique_lock<std::mutex> lock(mutex);
+	frameCache.assign(numFrames, CachedFrame());
+	nextCachedFrame = 0;
+}
+
+size_t ofGstVideoUtils::getFrameCacheSize() const{
+	return frameCache.size();
+}
+
+bool ofGstVideoUtils::showCachedFrame(int64_t nanos, int64_t tolerance){
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto & cached: frameCache){
+		if(cached.nanos >= 0 && std::abs(cached.nanos - nanos) <= tolerance){
+			// the pixels might point to the memory of a sample,
+			// the cached frame is copied to memory of their own
+			pixels.clear();
+			pixels = cached.pixels;
+			frontBuffer.reset();
+			bCachedFrameChanged = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ofGstVideoUtils::clearFrames(){
+	for(int i=0;i<3;i++){
+		frames[i] = Frame();
+	}
+	frames.reset();
+}
+
 #if GST_VERSION_MAJOR==0
 GstFlowReturn ofGstVideoUtils::process_buffer(shared_ptr<GstBuffer> _buffer){
+	// the back frame has the allocated size and format, the pixels
+	// belong to the main thread
+	Frame & back = frames.getBack();
+	ofPixels & format = back.pixels;
 	guint size = GST_BUFFER_SIZE (_buffer.get());
 	int stride = 0;
-	if(pixels.isAllocated() && pixels.getTotalBytes()!=(int)size){
-        stride = gst_video_format_get_row_stride( GST_VIDEO_FORMAT_RGB,0, pixels.getWidth());
-        if(stride == (pixels.getWidth() * pixels.getHeight() *  pixels.getBytesPerPixel())) {
-            ofLogError("ofGstVideoUtils") << "buffer_cb(): error on new buffer, buffer size: " << size << "!= init size: " << pixels.getTotalBytes();
+	if(format.isAllocated() && format.getTotalBytes()!=(int)size){
+        stride = gst_video_format_get_row_stride( GST_VIDEO_FORMAT_RGB,0, format.getWidth());
+        if(stride == (format.getWidth() * format.getHeight() *  format.getBytesPerPixel())) {
+            ofLogError("ofGstVideoUtils") << "buffer_cb(): error on new buffer, buffer size: " << size << "!= init size: " << format.getTotalBytes();
             return GST_FLOW_ERROR;
         }
 	}
-	mutex.lock();
-	if(pixels.isAllocated()){
-		backBuffer = _buffer;
+	if(format.isAllocated()){
+		back.buffer = _buffer;
         if(stride > 0) {
-            backPixels.setFromAlignedPixels(GST_BUFFER_DATA (backBuffer.get()),pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat(),stride);
+            back.pixels.setFromAlignedPixels(GST_BUFFER_DATA (back.buffer.get()),format.getWidth(),format.getHeight(),format.getPixelFormat(),stride);
         }
         else {
-            backPixels.setFromExternalPixels(GST_BUFFER_DATA (backBuffer.get()),pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat());
-            eventPixels.setFromExternalPixels(GST_BUFFER_DATA (backBuffer.get()),pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat());
+            back.pixels.setFromExternalPixels(GST_BUFFER_DATA (back.buffer.get()),format.getWidth(),format.getHeight(),format.getPixelFormat());
+            eventPixels.setFromExternalPixels(GST_BUFFER_DATA (back.buffer.get()),format.getWidth(),format.getHeight(),format.getPixelFormat());
         }
-		bBackPixelsChanged=true;
-		mutex.unlock();
+		frames.publish();
         if(stride == 0) {
         	ofNotifyEvent(prerollEvent,eventPixels);
         }
@@ -1238,7 +1438,6 @@ GstFlowReturn ofGstVideoUtils::process_buffer(shared_ptr<GstBuffer> _buffer){
 		}else{
 			ofLogError("ofGstVideoUtils") << "preroll_cb(): received a preroll without allocation";
 		}
-		mutex.unlock();
 	}
 	return GST_FLOW_OK;
 }
@@ -1255,6 +1454,40 @@ static GstVideoInfo getVideoInfo(GstSample * sample){
     return vinfo;
 }
 
+static int64_t getStreamTime(GstSample * sample){
+	GstBuffer * buffer = gst_sample_get_buffer(sample);
+	if(!buffer || !GST_BUFFER_PTS_IS_VALID(buffer)){
+		return -1;
+	}
+	GstSegment * segment = gst_sample_get_segment(sample);
+	if(segment && segment->format == GST_FORMAT_TIME){
+		guint64 time = gst_segment_to_stream_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+		if(time != GST_CLOCK_TIME_NONE){
+			return time;
+		}
+	}
+	return GST_BUFFER_PTS(buffer);
+}
+
+#ifdef OF_USE_GST_GL
+void ofGstVideoUtils::downloadGLMemory(){
+	if(!bPixelsNeedDownload || !frontBuffer) return;
+	bPixelsNeedDownload = false;
+
+	// mapping GL memory without GST_MAP_GL makes gstreamer download
+	// the texture to system memory
+	GstBuffer * buffer = gst_sample_get_buffer(frontBuffer.get());
+	GstMapInfo info;
+	if(gst_buffer_map (buffer, &info, GST_MAP_READ)){
+		GstVideoInfo v_info = getVideoInfo(frontBuffer.get());
+		pixels.setFromAlignedPixels(info.data,v_info.width,v_info.height,OF_PIXELS_RGBA,v_info.stride[0]);
+		gst_buffer_unmap(buffer,&info);
+	}else{
+		ofLogError("ofGstVideoUtils") << "getPixels(): couldn't download frame from GL memory";
+	}
+}
+#endif
+
 GstFlowReturn ofGstVideoUtils::process_sample(shared_ptr<GstSample> sample){
 	GstBuffer * _buffer = gst_sample_get_buffer(sample.get());
 
@@ -1264,35 +1497,36 @@ GstFlowReturn ofGstVideoUtils::process_sample(shared_ptr<GstSample> sample){
 			bufferQueue.push(sample);
 			gst_buffer_unmap(_buffer, &mapinfo);
 			bool newTexture=false;
-			std::unique_lock<std::mutex> lock(mutex);
+			Frame & back = frames.getBack();
 			while(bufferQueue.size()>2){
-				backBuffer = bufferQueue.front();
+				back.buffer = bufferQueue.front();
 				bufferQueue.pop();
 				newTexture = true;
 			}
 			if(newTexture){
-				GstBuffer * _buffer = gst_sample_get_buffer(backBuffer.get());
+				GstBuffer * _buffer = gst_sample_get_buffer(back.buffer.get());
 				gst_buffer_map (_buffer, &mapinfo, (GstMapFlags)(GST_MAP_READ | GST_MAP_GL));
 				auto texId = *(guint*)mapinfo.data;
-				backTexture.setUseExternalTextureID(texId);
-				ofTextureData & texData = backTexture.getTextureData();
+				ofTextureData & texData = back.texture;
+				back.bTexture = true;
+				texData.bUseExternalTextureID = true;
 				texData.bAllocated = true;
 				texData.bFlipTexture = false;
 				texData.glInternalFormat = GL_RGBA;
-				texData.height = getHeight();
-				texData.width = getWidth();
+				texData.height = back.pixels.getHeight();
+				texData.width = back.pixels.getWidth();
 				texData.magFilter = GL_LINEAR;
 				texData.minFilter = GL_LINEAR;
-				texData.tex_h = getHeight();
-				texData.tex_w = getWidth();
+				texData.tex_h = back.pixels.getHeight();
+				texData.tex_w = back.pixels.getWidth();
 				texData.tex_u = 1;
 				texData.tex_t = 1;
 				texData.textureID = texId;
 				texData.textureTarget = GL_TEXTURE_2D;
 				texData.wrapModeHorizontal = GL_CLAMP_TO_EDGE;
 				texData.wrapModeVertical = GL_CLAMP_TO_EDGE;
-				bBackPixelsChanged=true;
 				gst_buffer_unmap(_buffer,&mapinfo);
+				frames.publish();
 			}
 			return GST_FLOW_OK;
 		}
@@ -1303,44 +1537,69 @@ GstFlowReturn ofGstVideoUtils::process_sample(shared_ptr<GstSample> sample){
 	gst_buffer_map (_buffer, &mapinfo, GST_MAP_READ);
 	guint size = mapinfo.size;
 
+	// the back frame has the allocated size and format, the pixels
+	// belong to the main thread
+	Frame & back = frames.getBack();
+	const size_t width = back.pixels.getWidth();
+	const size_t height = back.pixels.getHeight();
+	const ofPixelFormat format = back.pixels.getPixelFormat();
+	const bool allocated = back.pixels.isAllocated();
+
 	size_t stride = 0;
-	if(pixels.isAllocated() && (pixels.getTotalBytes() != size_t(size))){
+	if(allocated && (back.pixels.getTotalBytes() != size_t(size))){
 		GstVideoInfo v_info = getVideoInfo(sample.get());
 		stride = v_info.stride[0];
 
-		if(stride == (pixels.getWidth() * pixels.getBytesPerPixel())) {
-			ofLogError("ofGstVideoUtils") << "buffer_cb(): error on new buffer, buffer size: " << size << "!= init size: " << pixels.getTotalBytes();
+		if(stride == (width * back.pixels.getBytesPerPixel())) {
+			ofLogError("ofGstVideoUtils") << "buffer_cb(): error on new buffer, buffer size: " << size << "!= init size: " << back.pixels.getTotalBytes();
+			gst_buffer_unmap(_buffer, &mapinfo);
 			return GST_FLOW_ERROR;
 		}
 	}
-	mutex.lock();
-	if(!copyPixels){
-		backBuffer = sample;
-	}
 
-	if(pixels.isAllocated()){
+	if(allocated){
+		if(!copyPixels){
+			back.buffer = sample;
+		}else{
+			back.buffer.reset();
+		}
 		if(stride > 0) {
-			if(pixels.getPixelFormat() == OF_PIXELS_I420){
+			if(format == OF_PIXELS_I420){
 				GstVideoInfo v_info = getVideoInfo(sample.get());
 				std::vector<size_t> strides{size_t(v_info.stride[0]),size_t(v_info.stride[1]),size_t(v_info.stride[2])};
-				backPixels.setFromAlignedPixels(mapinfo.data,pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat(),strides);
+				back.pixels.setFromAlignedPixels(mapinfo.data,width,height,format,strides);
 			} else {
-				backPixels.setFromAlignedPixels(mapinfo.data,pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat(),stride);
+				back.pixels.setFromAlignedPixels(mapinfo.data,width,height,format,stride);
 			}
 		} else if(!copyPixels){
-			backPixels.setFromExternalPixels(mapinfo.data,pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat());
-			eventPixels.setFromExternalPixels(mapinfo.data,pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat());
+			back.pixels.setFromExternalPixels(mapinfo.data,width,height,format);
+			eventPixels.setFromExternalPixels(mapinfo.data,width,height,format);
 		}else{
-			backPixels.setFromPixels(mapinfo.data,pixels.getWidth(),pixels.getHeight(),pixels.getPixelFormat());
+			back.pixels.setFromPixels(mapinfo.data,width,height,format);
+		}
+
+		// only waits if the main thread is resizing or reading the cache
+		std::unique_lock<std::mutex> lock(mutex);
+		if(!frameCache.empty()){
+			int64_t nanos = getStreamTime(sample.get());
+			bool cached = nanos < 0;
+			for(auto & frame: frameCache){
+				// seeking back to a frame decodes it again
+				cached |= frame.nanos == nanos;
+			}
+			if(!cached){
+				frameCache[nextCachedFrame].pixels = back.pixels;
+				frameCache[nextCachedFrame].nanos = nanos;
+				nextCachedFrame = (nextCachedFrame + 1) % frameCache.size();
+			}
 		}
+		lock.unlock();
 
-		bBackPixelsChanged=true;
-		mutex.unlock();
+		frames.publish();
 		if(stride == 0) {
 			ofNotifyEvent(prerollEvent,eventPixels);
 		}
 	}else{
-		mutex.unlock();
 		if(appsink){
 			appsink->on_stream_prepared();
 		}else{
@@ -1399,4 +1658,253 @@ void ofGstVideoUtils::eos_cb(){
 	ofNotifyEvent(eosEvent,args);
 }
 
+
+
+//-------------------------------------------------
+//----------------------------------------- sync group
+//-------------------------------------------------
+
+ofGstSyncGroup::ofGstSyncGroup(){
+	// the clock is obtained with the first video, gstreamer might not be
+	// initialized yet
+	clock			= NULL;
+	timeProvider	= NULL;
+	baseTime		= 0;
+	pauseTime		= 0;
+	latency			= 100 * GST_MSECOND;
+	loopState		= OF_LOOP_NONE;
+	bPlaying		= false;
+	bPaused			= false;
+	bFrameNew		= false;
+	bNeedsBaseTime	= false;
+}
+
+ofGstSyncGroup::~ofGstSyncGroup(){
+	// the pipelines keep their own reference to the clock
+	if(timeProvider) gst_object_unref(timeProvider);
+	if(clock) gst_object_unref(clock);
+}
+
+void ofGstSyncGroup::add(ofGstVideoUtils & video){
+	if(!video.isLoaded()){
+		ofLogError("ofGstSyncGroup") << "add(): video has to be loaded first";
+		return;
+	}
+	if(std::find(videos.begin(), videos.end(), &video) != videos.end()){
+		return;
+	}
+	if(!clock){
+		clock = gst_system_clock_obtain();
+	}
+	// the group loops all the videos together
+	video.setLoopState(OF_LOOP_NONE);
+	video.setSyncClock(clock);
+	videos.push_back(&video);
+}
+
+void ofGstSyncGroup::remove(ofGstVideoUtils & video){
+	auto it = std::find(videos.begin(), videos.end(), &video);
+	if(it != videos.end()){
+		video.setSyncClock(NULL);
+		videos.erase(it);
+	}
+}
+
+void ofGstSyncGroup::clear(){
+	for(auto video: videos){
+		video->setSyncClock(NULL);
+	}
+	videos.clear();
+	bPlaying = false;
+	bPaused = false;
+}
+
+#if GST_VERSION_MAJOR>0
+bool ofGstSyncGroup::publishClock(int port){
+	if(!clock){
+		clock = gst_system_clock_obtain();
+	}
+	if(timeProvider){
+		gst_object_unref(timeProvider);
+	}
+	timeProvider = GST_OBJECT(gst_net_time_provider_new(clock, NULL, port));
+	if(!timeProvider){
+		ofLogError("ofGstSyncGroup") << "publishClock(): couldn't publish the clock on port " << port;
+		return false;
+	}
+	return true;
+}
+
+bool ofGstSyncGroup::setupNetworkClock(const std::string & address, int port, float syncTimeoutSeconds){
+	GstClock * netClock = gst_net_client_clock_new("ofGstSyncGroup", address.c_str(), port, 0);
+	if(!netClock){
+		ofLogError("ofGstSyncGroup") << "setupNetworkClock(): couldn't create a clock for " << address << ":" << port;
+		return false;
+	}
+	if(!gst_clock_wait_for_sync(netClock, GstClockTime(syncTimeoutSeconds * GST_SECOND))){
+		ofLogError("ofGstSyncGroup") << "setupNetworkClock(): couldn't sync with " << address << ":" << port
+			<< " in " << syncTimeoutSeconds << "s";
+		gst_object_unref(netClock);
+		return false;
+	}
+	setClock(netClock);
+	return true;
+}
+#endif
+
+void ofGstSyncGroup::setClock(GstClock * newClock){
+	if(clock) gst_object_unref(clock);
+	clock = newClock;
+	for(auto video: videos){
+		video->setSyncClock(clock);
+	}
+	// the base time is relative to the old clock
+	if(bPlaying){
+		bNeedsBaseTime = true;
+		if(!bPaused){
+			start(gst_clock_get_time(clock) + latency);
+		}
+	}
+}
+
+void ofGstSyncGroup::setLatency(float seconds){
+	latency = GstClockTime(std::max(seconds, 0.f) * GST_SECOND);
+}
+
+float ofGstSyncGroup::getLatency() const{
+	return float(latency) / GST_SECOND;
+}
+
+void ofGstSyncGroup::preroll(){
+	// the first frames are ready when all are in paused, they only have to
+	// wait for the base time after going to playing
+	for(auto video: videos){
+		video->setPaused(true);
+	}
+	for(auto video: videos){
+		gst_element_get_state(video->getPipeline(), NULL, NULL, 2 * GST_SECOND);
+	}
+}
+
+void ofGstSyncGroup::start(GstClockTime base){
+	baseTime = base;
+	for(auto video: videos){
+		video->setBaseTime(baseTime);
+		video->setPaused(false);
+	}
+	bPlaying = true;
+	bPaused = false;
+	bNeedsBaseTime = false;
+}
+
+void ofGstSyncGroup::play(){
+	if(!clock || videos.empty()){
+		return;
+	}
+	if(bPlaying){
+		setPaused(false);
+		return;
+	}
+	preroll();
+	start(gst_clock_get_time(clock) + latency);
+}
+
+void ofGstSyncGroup::playAt(GstClockTime base){
+	if(!clock || videos.empty()){
+		return;
+	}
+	preroll();
+	start(base);
+}
+
+void ofGstSyncGroup::setPaused(bool paused){
+	if(!bPlaying){
+		if(!paused) play();
+		return;
+	}
+	if(paused == bPaused){
+		return;
+	}
+	if(paused){
+		pauseTime = gst_clock_get_time(clock);
+		for(auto video: videos){
+			video->setPaused(true);
+		}
+		bPaused = true;
+	}else if(bNeedsBaseTime){
+		start(gst_clock_get_time(clock) + latency);
+	}else{
+		// continues from where it was paused
+		start(baseTime + gst_clock_get_time(clock) - pauseTime);
+	}
+}
+
+bool ofGstSyncGroup::isPaused() const{
+	return bPaused;
+}
+
+void ofGstSyncGroup::stop(){
+	for(auto video: videos){
+		video->stop();
+	}
+	bPlaying = false;
+	bPaused = false;
+}
+
+void ofGstSyncGroup::setPosition(float pct){
+	bool wasPlaying = bPlaying && !bPaused;
+	if(wasPlaying){
+		pauseTime = gst_clock_get_time(clock);
+	}
+	for(auto video: videos){
+		video->setPaused(true);
+		video->setPosition(pct);
+	}
+	preroll();
+	// a flushing seek starts the running time again from 0
+	if(wasPlaying){
+		start(gst_clock_get_time(clock) + latency);
+	}else{
+		bPaused = bPlaying;
+		bNeedsBaseTime = bPlaying;
+	}
+}
+
+void ofGstSyncGroup::setLoopState(ofLoopType loop){
+	if(loop == OF_LOOP_PALINDROME){
+		ofLogWarning("ofGstSyncGroup") << "setLoopState(): palindrome isn't supported, using OF_LOOP_NORMAL";
+		loop = OF_LOOP_NORMAL;
+	}
+	loopState = loop;
+}
+
+ofLoopType ofGstSyncGroup::getLoopState() const{
+	return loopState;
+}
+
+GstClock * ofGstSyncGroup::getClock() const{
+	return clock;
+}
+
+GstClockTime ofGstSyncGroup::getBaseTime() const{
+	return baseTime;
+}
+
+void ofGstSyncGroup::update(){
+	bFrameNew = false;
+	bool allDone = !videos.empty();
+	for(auto video: videos){
+		video->update();
+		bFrameNew |= video->isFrameNew();
+		allDone &= video->getIsMovieDone();
+	}
+	if(allDone && loopState != OF_LOOP_NONE && bPlaying && !bPaused){
+		setPosition(0);
+	}
+}
+
+bool ofGstSyncGroup::isFrameNew() const{
+	return bFrameNew;
+}
+
 #endif
@@ -8,6 +8,7 @@
 #include "ofTypes.h"
 #include "ofEvents.h"
 #include "ofThread.h"
+#include "ofTripleBuffer.h"
 #define GST_DISABLE_DEPRECATED
 #include <gst/gst.h>
 #include <gst/gstpad.h>
@@ -63,6 +64,21 @@ public:
 	void 	setFrameByFrame(bool bFrameByFrame);
 	bool	isFrameByFrame() const;
 
+	// seeks without waiting for the new position to preroll. while a seek
+	// is in flight new ones are coalesced, only the last one is done when it
+	// finishes, so scrubbing never queues more seeks than the decoder can do.
+	// accurate decodes up to the exact frame, otherwise it snaps to the
+	// nearest keyframe which is much faster
+	void 	seekAsync(int64_t nanos, bool accurate);
+	bool	isSeeking() const;
+
+	// makes the pipeline run on clock, instead of the one it selects, and
+	// keep the base time set with setBaseTime() instead of taking a new
+	// one when going to playing. nullptr goes back to its own clock.
+	// used by ofGstSyncGroup to present frames of several pipelines in sync
+	void	setSyncClock(GstClock * clock);
+	void	setBaseTime(GstClockTime baseTime);
+
 	GstElement 	* getPipeline() const;
 	GstElement 	* getSink() const;
 	GstElement 	* getGstElementByName(const std::string & name) const;
@@ -94,6 +110,7 @@ protected:
 private:
 	static bool			busFunction(GstBus * bus, GstMessage * message, ofGstUtils * app);
 	bool				gstHandleMessage(GstBus * bus, GstMessage * message);
+	bool				seek(int64_t nanos, bool accurate);
 
 	bool 				bPlaying;
 	bool 				bPaused;
@@ -112,6 +129,11 @@ private:
 	std::mutex			eosMutex;
 	guint				busWatchID;
 
+	mutable std::mutex	seekMutex;
+	bool				bSeeking;
+	int64_t				pendingSeekNanos;
+	bool				bPendingSeekAccurate;
+
 	class ofGstMainLoopThread: public ofThread{
 	public:
 		ofGstMainLoopThread()
@@ -190,6 +212,23 @@ public:
 	// https://bugzilla.gnome.org/show_bug.cgi?id=737427
 	void setCopyPixels(bool copy);
 
+	// when built with OF_USE_GST_GL, decoded frames stay in GPU memory:
+	// they are uploaded, or imported as DMA-BUF on EGL, by glupload and
+	// getTexture() returns them directly as textures in RGBA, no pixels
+	// are produced unless getPixels() is called, which downloads the
+	// current frame on demand. enabled by default when available,
+	// has to be set before setPipeline()
+	void setUseGLMemory(bool useGLMemory);
+	bool isUsingGLMemory() const;
+
+	// keeps a copy of the last numFrames frames decoded, 0 by default.
+	// showCachedFrame makes the one at nanos, within tolerance, the next
+	// frame returned by update() without waiting for the decoder, so short
+	// scrubs back and forth around the playhead are served from memory
+	void setFrameCacheSize(std::size_t numFrames);
+	std::size_t getFrameCacheSize() const;
+	bool showCachedFrame(int64_t nanos, int64_t tolerance);
+
 	// this events happen in a different thread
 	// do not use them for opengl stuff
 	ofEvent<ofPixels> prerollEvent;
@@ -210,27 +249,57 @@ protected:
 
 
 	ofPixels		pixels;				// 24 bit: rgb
-	ofPixels		backPixels;
 	ofPixels		eventPixels;
 private:
-	static gboolean	sync_bus_call (GstBus * bus, GstMessage * msg, gpointer data);
+	void			clearFrames();
+#ifdef OF_USE_GST_GL
+	static void		sync_bus_call (GstBus * bus, GstMessage * msg, gpointer data);
+	bool			setGLPipeline(std::string pipeline, bool isStream, int w, int h);
+	void			downloadGLMemory();
+	bool			bUseGLMemory;
+	bool			bPixelsNeedDownload;
+#endif
 	bool			bIsFrameNew;			// if we are new
 	bool			bHavePixelsChanged;
-	bool			bBackPixelsChanged;
-	std::mutex		mutex;
+	bool			bCachedFrameChanged;
+	std::mutex		mutex;					// allocation and the frame cache, update() never takes it
+
+	// a decoded frame, the pixels usually point to the memory of the
+	// buffer which is kept alive with them
+	struct Frame{
 #if GST_VERSION_MAJOR==0
-	std::shared_ptr<GstBuffer> 	frontBuffer, backBuffer;
+		std::shared_ptr<GstBuffer> buffer;
 #else
-	std::shared_ptr<GstSample> 	frontBuffer, backBuffer;
+		std::shared_ptr<GstSample> buffer;
+	#ifdef OF_USE_GST_GL
+		ofTextureData texture;
+		bool bTexture = false;
+	#endif
+#endif
+		ofPixels pixels;
+	};
+	// frames handed from the streaming thread to update() without locking
+	ofTripleBuffer<Frame> frames;
+#if GST_VERSION_MAJOR==0
+	std::shared_ptr<GstBuffer> 	frontBuffer;
+#else
+	std::shared_ptr<GstSample> 	frontBuffer;
 	std::queue<std::shared_ptr<GstSample> > bufferQueue;
 	GstMapInfo mapinfo;
 	#ifdef OF_USE_GST_GL
-		ofTexture		frontTexture, backTexture;
+		ofTexture		frontTexture;
 	#endif
 #endif
 	ofPixelFormat	internalPixelFormat;
 	bool copyPixels; // fix for certain versions bug with v4l2
 
+	struct CachedFrame{
+		ofPixels pixels;
+		int64_t nanos = -1;
+	};
+	std::vector<CachedFrame> frameCache;
+	std::size_t		nextCachedFrame;
+
 #ifdef OF_USE_GST_GL
 	GstGLDisplay *		glDisplay;
 	GstGLContext *		glContext;
@@ -238,6 +307,88 @@ private:
 };
 
 
+//-------------------------------------------------
+//----------------------------------------- sync group
+//-------------------------------------------------
+
+// plays several videos on the same clock and base time, so a video wall
+// presents the frames of every player at the same time instead of each
+// one drifting on its own clock:
+//
+//	group.add(*player.getPlayer<ofGstVideoPlayer>()->getGstVideoUtils());
+//	group.play();
+//	...
+//	group.update(); // instead of updating each player
+//
+// play, pause, seek and loop are done for all the videos at once, the
+// players shouldn't be controlled on their own while in a group. across
+// machines one of them shares its clock with publishClock(), the rest
+// follow it with setupNetworkClock() and all start with playAt() and the
+// base time of the first, getBaseTime(), sent by the app
+class ofGstSyncGroup{
+public:
+	ofGstSyncGroup();
+	~ofGstSyncGroup();
+
+	ofGstSyncGroup(const ofGstSyncGroup &) = delete;
+	ofGstSyncGroup & operator=(const ofGstSyncGroup &) = delete;
+
+	// videos have to be loaded
+	void	add(ofGstVideoUtils & video);
+	void	remove(ofGstVideoUtils & video);
+	void	clear();
+
+#if GST_VERSION_MAJOR>0
+	// shares this group's clock on port for others to follow
+	bool	publishClock(int port);
+	// follows the clock published by another machine on address:port
+	bool	setupNetworkClock(const std::string & address, int port, float syncTimeoutSeconds = 5);
+#endif
+
+	// time from play() until the first frame is presented, to give every
+	// video time to get to playing. 100ms by default
+	void	setLatency(float seconds);
+	float	getLatency() const;
+
+	void	play();
+	// starts playing with a base time shared by another group
+	void	playAt(GstClockTime baseTime);
+	void	setPaused(bool paused);
+	bool	isPaused() const;
+	void	stop();
+
+	// seeks every video and restarts them together
+	void	setPosition(float pct);
+	// OF_LOOP_NONE or OF_LOOP_NORMAL, rewinds all when the last one ends
+	void	setLoopState(ofLoopType loop);
+	ofLoopType	getLoopState() const;
+
+	GstClock *		getClock() const;
+	GstClockTime	getBaseTime() const;
+
+	// updates every video, isFrameNew() is true if any of them has one
+	void	update();
+	bool	isFrameNew() const;
+
+private:
+	void	preroll();
+	void	start(GstClockTime baseTime);
+	void	setClock(GstClock * clock);
+
+	std::vector<ofGstVideoUtils*> videos;
+	GstClock *		clock;
+	GstObject *		timeProvider;
+	GstClockTime	baseTime;
+	GstClockTime	pauseTime;
+	GstClockTime	latency;
+	ofLoopType		loopState;
+	bool			bPlaying;
+	bool			bPaused;
+	bool			bFrameNew;
+	bool			bNeedsBaseTime;
+};
+
+
 //-------------------------------------------------
 //----------------------------------------- appsink listener
 //-------------------------------------------------
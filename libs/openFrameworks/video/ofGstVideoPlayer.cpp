@@ -11,9 +11,60 @@
 #include <gst/app/gstappsink.h>
 #include "ofConstants.h"
 #include "ofGstUtils.h"
+#include <algorithm>
 
 using namespace std;
 
+#if GST_VERSION_MAJOR>0
+// GstAutoplugSelectResult, from decodebin's private headers
+enum{
+	OF_GST_AUTOPLUG_SELECT_TRY,
+	OF_GST_AUTOPLUG_SELECT_EXPOSE,
+	OF_GST_AUTOPLUG_SELECT_SKIP,
+};
+
+// GST_PLAY_FLAG_NATIVE_VIDEO, from playbin's private headers: no
+// videoconvert or videoscale after the decoder
+#define OF_GST_PLAY_FLAG_NATIVE_VIDEO (1 << 6)
+
+static bool isVideoDecoder(GstElementFactory * factory){
+	return gst_element_factory_list_is_type(factory, GST_ELEMENT_FACTORY_TYPE_DECODER | GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO);
+}
+
+// hardware decoders are recognized by the prefix of their element name,
+// va is the plugin that replaces vaapi in recent versions
+static ofGstVideoDecoder getDecoderType(GstElementFactory * factory){
+	string name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+	auto startsWith = [&name](const string & prefix){
+		return name.compare(0, prefix.size(), prefix) == 0;
+	};
+	if(startsWith("vaapi") || startsWith("va")){
+		return OF_GST_DECODER_VAAPI;
+	}else if(startsWith("nv")){
+		return OF_GST_DECODER_NVDEC;
+	}else if(startsWith("v4l2")){
+		return OF_GST_DECODER_V4L2;
+	}else if(startsWith("omx")){
+		return OF_GST_DECODER_OMX;
+	}else{
+		return OF_GST_DECODER_SOFTWARE;
+	}
+}
+
+static bool isPreferred(ofGstVideoDecoder preferred, ofGstVideoDecoder type){
+	switch(preferred){
+	case OF_GST_DECODER_DEFAULT:
+		return false;
+	case OF_GST_DECODER_SOFTWARE:
+		return type == OF_GST_DECODER_SOFTWARE;
+	case OF_GST_DECODER_HARDWARE:
+		return type != OF_GST_DECODER_SOFTWARE;
+	default:
+		return type == preferred;
+	}
+}
+#endif
+
 ofGstVideoPlayer::ofGstVideoPlayer(){
 	nFrames						= 0;
 	internalPixelFormat			= OF_PIXELS_RGB;
@@ -21,9 +72,11 @@ ofGstVideoPlayer::ofGstVideoPlayer(){
 	bIsAllocated				= false;
 	threadAppSink				= false;
 	bAsyncLoad					= false;
+	bSeekFromCache				= false;
 	videoUtils.setSinkListener(this);
 	fps_d = 1;
 	fps_n = 1;
+	decoder = OF_GST_DECODER_DEFAULT;
 }
 
 ofGstVideoPlayer::~ofGstVideoPlayer(){
@@ -122,6 +175,17 @@ bool ofGstVideoPlayer::createPipeline(string name){
 	g_object_ref_sink(gstPipeline);
 	g_object_set(G_OBJECT(gstPipeline), "uri", name.c_str(), (void*)NULL);
 
+	#if GST_VERSION_MAJOR>0
+		connectDecoderSelection(gstPipeline);
+		if(internalPixelFormat==OF_PIXELS_NATIVE){
+			// the frames reach the appsink as the decoder outputs them, NV12
+			// for most hardware decoders, instead of going through videoconvert
+			gint flags;
+			g_object_get(G_OBJECT(gstPipeline), "flags", &flags, (void*)NULL);
+			g_object_set(G_OBJECT(gstPipeline), "flags", flags | OF_GST_PLAY_FLAG_NATIVE_VIDEO, (void*)NULL);
+		}
+	#endif
+
 	// create the oF appsink for video rgb without sync to clock
 	GstElement * gstSink = gst_element_factory_make("appsink", "app_sink");
 	gst_app_sink_set_caps(GST_APP_SINK(gstSink), caps);
@@ -177,7 +241,11 @@ bool ofGstVideoPlayer::createPipeline(string name){
 	glXMakeCurrent (ofGetX11Display(), ofGetX11Window(), ofGetGLXContext());
 	return ret;*/
 
-	return videoUtils.setPipeline("uridecodebin uri=" + name,internalPixelFormat,bIsStream,-1,-1);
+	if(!videoUtils.setPipeline("uridecodebin uri=" + name,internalPixelFormat,bIsStream,-1,-1)){
+		return false;
+	}
+	connectDecoderSelection(videoUtils.getPipeline());
+	return true;
 	//return videoUtils.setPipeline("filesrc location=" + name + " ! qtdemux ",internalPixelFormat,bIsStream,-1,-1);
 #endif
 }
@@ -202,6 +270,10 @@ bool ofGstVideoPlayer::load(string name){
 		bIsStream = true;
 	}
 	ofLogVerbose("ofGstVideoPlayer") << "loadMovie(): loading \"" << name << "\"";
+	{
+		std::unique_lock<std::mutex> lock(decoderMutex);
+		decoderName.clear();
+	}
 
 	if(isInitialized()){
 		gst_element_set_state (videoUtils.getPipeline(), GST_STATE_READY);
@@ -341,6 +413,25 @@ void ofGstVideoPlayer::setFrame(int frame){ // frame 0 = first frame...
 	setPosition(pct);
 }
 
+void ofGstVideoPlayer::setFrameAsync(int frame, ofVideoSeekMode mode){
+	if(nFrames==0 || fps_n<=0 || fps_d<=0){
+		ofLogWarning("ofGstVideoPlayer") << "setFrameAsync(): unknown number of frames, can't seek by frame";
+		return;
+	}
+	frame = std::max(0, std::min(frame, int(nFrames) - 1));
+	int64_t nanos = gst_util_uint64_scale(frame, GST_SECOND * fps_d, fps_n);
+	int64_t frameNanos = gst_util_uint64_scale(GST_SECOND, fps_d, fps_n);
+
+	// a cached frame is shown in the next update, the pipeline still seeks
+	// to it so playback continues from there
+	bSeekFromCache = videoUtils.showCachedFrame(nanos, frameNanos / 2);
+	videoUtils.seekAsync(nanos, bSeekFromCache || mode==OF_VIDEO_SEEK_ACCURATE);
+}
+
+bool ofGstVideoPlayer::isSeeking() const{
+	return !bSeekFromCache && videoUtils.isSeeking();
+}
+
 bool ofGstVideoPlayer::isStream() const {
 	return bIsStream;
 }
@@ -442,6 +533,14 @@ ofGstVideoUtils * ofGstVideoPlayer::getGstVideoUtils(){
 	return &videoUtils;
 }
 
+void ofGstVideoPlayer::setFrameCacheSize(size_t numFrames){
+	videoUtils.setFrameCacheSize(numFrames);
+}
+
+size_t ofGstVideoPlayer::getFrameCacheSize() const{
+	return videoUtils.getFrameCacheSize();
+}
+
 void ofGstVideoPlayer::setFrameByFrame(bool frameByFrame){
 	videoUtils.setFrameByFrame(frameByFrame);
 }
@@ -453,3 +552,107 @@ bool ofGstVideoPlayer::isThreadedAppSink() const{
 bool ofGstVideoPlayer::isFrameByFrame() const{
 	return videoUtils.isFrameByFrame();
 }
+
+void ofGstVideoPlayer::setDecoder(ofGstVideoDecoder decoder){
+#if GST_VERSION_MAJOR==0
+	if(decoder!=OF_GST_DECODER_DEFAULT){
+		ofLogWarning("ofGstVideoPlayer") << "setDecoder(): decoder selection needs gstreamer 1.x";
+	}
+#endif
+	if(isInitialized() && decoder!=this->decoder){
+		ofLogWarning("ofGstVideoPlayer") << "setDecoder(): the decoder will change on the next load";
+	}
+	this->decoder = decoder;
+}
+
+ofGstVideoDecoder ofGstVideoPlayer::getDecoder() const{
+	return decoder;
+}
+
+string ofGstVideoPlayer::getDecoderName() const{
+	std::unique_lock<std::mutex> lock(decoderMutex);
+	return decoderName;
+}
+
+bool ofGstVideoPlayer::isDecoderAvailable(ofGstVideoDecoder decoder){
+#if GST_VERSION_MAJOR>0
+	if(decoder==OF_GST_DECODER_DEFAULT){
+		return true;
+	}
+	ofGstUtils::startGstMainLoop();
+	bool found = false;
+	GList * factories = gst_element_factory_list_get_elements(GST_ELEMENT_FACTORY_TYPE_DECODER | GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO, GST_RANK_NONE);
+	for(GList * f = factories; f && !found; f = f->next){
+		found = isPreferred(decoder, getDecoderType(GST_ELEMENT_FACTORY(f->data)));
+	}
+	gst_plugin_feature_list_free(factories);
+	return found;
+#else
+	return decoder==OF_GST_DECODER_DEFAULT;
+#endif
+}
+
+#if GST_VERSION_MAJOR>0
+void ofGstVideoPlayer::connectDecoderSelection(GstElement * pipeline){
+#if GST_CHECK_VERSION(1,10,0)
+	// decodebin is created inside playbin or uridecodebin once the pipeline
+	// starts, it's found when it's added to any bin in the pipeline
+	g_signal_connect(pipeline, "deep-element-added", G_CALLBACK(on_element_added), this);
+#else
+	if(decoder!=OF_GST_DECODER_DEFAULT){
+		ofLogWarning("ofGstVideoPlayer") << "setDecoder(): decoder selection needs gstreamer 1.10";
+	}
+#endif
+}
+
+void ofGstVideoPlayer::on_element_added(GstBin *, GstBin *, GstElement * element, ofGstVideoPlayer * player){
+	GstElementFactory * factory = gst_element_get_factory(element);
+	if(!factory){
+		return;
+	}
+	string name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+	if(name=="decodebin"){
+		if(player->decoder!=OF_GST_DECODER_DEFAULT){
+			g_signal_connect(element, "autoplug-sort", G_CALLBACK(on_autoplug_sort), player);
+			g_signal_connect(element, "autoplug-select", G_CALLBACK(on_autoplug_select), player);
+		}
+	}else if(isVideoDecoder(factory)){
+		ofLogVerbose("ofGstVideoPlayer") << "decoding video with " << name;
+		std::unique_lock<std::mutex> lock(player->decoderMutex);
+		player->decoderName = name;
+	}
+}
+
+GValueArray * ofGstVideoPlayer::on_autoplug_sort(GstElement *, GstPad *, GstCaps *, GValueArray * factories, ofGstVideoPlayer * player){
+	// the preferred decoders go first, keeping the rank order otherwise.
+	// decodebin still passes the factories as a deprecated GValueArray
+	G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+	GValueArray * sorted = g_value_array_new(factories->n_values);
+	for(int preferred = 1; preferred >= 0; preferred--){
+		for(guint i = 0; i < factories->n_values; i++){
+			GValue * value = g_value_array_get_nth(factories, i);
+			auto factory = GST_ELEMENT_FACTORY(g_value_get_object(value));
+			bool isPreferredDecoder = isVideoDecoder(factory) && isPreferred(player->decoder, getDecoderType(factory));
+			if(isPreferredDecoder == bool(preferred)){
+				g_value_array_append(sorted, value);
+			}
+		}
+	}
+	G_GNUC_END_IGNORE_DEPRECATIONS
+	return sorted;
+}
+
+gint ofGstVideoPlayer::on_autoplug_select(GstElement *, GstPad *, GstCaps *, GstElementFactory * factory, ofGstVideoPlayer * player){
+	if(!isVideoDecoder(factory)){
+		return OF_GST_AUTOPLUG_SELECT_TRY;
+	}
+	// software is the fallback for everything but a given hardware decoder
+	// doesn't pick a different one
+	ofGstVideoDecoder type = getDecoderType(factory);
+	if(type==OF_GST_DECODER_SOFTWARE || isPreferred(player->decoder, type)){
+		return OF_GST_AUTOPLUG_SELECT_TRY;
+	}else{
+		return OF_GST_AUTOPLUG_SELECT_SKIP;
+	}
+}
+#endif
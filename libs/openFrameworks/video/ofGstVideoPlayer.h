@@ -1,6 +1,23 @@
 #pragma once
 
 #include "ofGstUtils.h"
+#include <mutex>
+
+/// \brief Video decoders ofGstVideoPlayer can be restricted to
+///
+/// The hardware ones decode in the GPU or a dedicated unit and, with the
+/// player set to OF_PIXELS_NATIVE or a YUV format, hand NV12 or I420 frames
+/// that the programmable renderer converts to RGB in a shader when drawing,
+/// so the CPU never touches the pixels.
+enum ofGstVideoDecoder{
+	OF_GST_DECODER_DEFAULT,		///< whatever GStreamer ranks first
+	OF_GST_DECODER_SOFTWARE,	///< never a hardware decoder
+	OF_GST_DECODER_HARDWARE,	///< any hardware decoder available, falling back to software
+	OF_GST_DECODER_VAAPI,		///< VA-API, Intel and AMD
+	OF_GST_DECODER_NVDEC,		///< NVIDIA
+	OF_GST_DECODER_V4L2,		///< V4L2 memory to memory, Raspberry Pi and most ARM boards
+	OF_GST_DECODER_OMX,			///< OpenMAX IL, older embedded boards
+};
 
 
 class ofGstVideoPlayer: public ofBaseVideoPlayer, public ofGstAppSink{
@@ -25,6 +42,8 @@ public:
 	void 	nextFrame();
 	void 	previousFrame();
 	void 	setFrame(int frame);  // frame 0 = first frame...
+	void 	setFrameAsync(int frame, ofVideoSeekMode mode);
+	bool 	isSeeking() const;
 
 	bool	isStream() const;
 
@@ -63,6 +82,28 @@ public:
 
 	ofGstVideoUtils * getGstVideoUtils();
 
+	/// \brief Keeps the last numFrames decoded in memory, none by default
+	///
+	/// setFrameAsync() to one of them shows it without waiting for the
+	/// decoder, so scrubbing a few frames back and forth around the playhead
+	/// is immediate. Every frame is copied once more while playing and
+	/// numFrames frames of getWidth() x getHeight() stay allocated
+	void setFrameCacheSize(std::size_t numFrames);
+	std::size_t getFrameCacheSize() const;
+
+	/// \brief Prefers decoder for the video stream, needs to be called before
+	/// load. Hardware decoders are tried first and the player falls back to
+	/// software if none of them can decode the file
+	void setDecoder(ofGstVideoDecoder decoder);
+	ofGstVideoDecoder getDecoder() const;
+
+	/// \brief Name of the GStreamer element decoding the video, to check
+	/// which one was picked, empty until the file is prerolled
+	std::string getDecoderName() const;
+
+	/// \brief If a decoder of type is installed
+	static bool isDecoderAvailable(ofGstVideoDecoder decoder);
+
 protected:
 	bool allocate();
 	bool createPipeline(std::string uri);
@@ -79,5 +120,16 @@ private:
 	bool				bIsAllocated;
 	bool				bAsyncLoad;
 	bool				threadAppSink;
+	bool				bSeekFromCache;
 	ofGstVideoUtils		videoUtils;
+	ofGstVideoDecoder	decoder;
+	std::string			decoderName;
+	mutable std::mutex	decoderMutex;
+
+#if GST_VERSION_MAJOR>0
+	static void on_element_added(GstBin * pipeline, GstBin * bin, GstElement * element, ofGstVideoPlayer * player);
+	static GValueArray * on_autoplug_sort(GstElement * bin, GstPad * pad, GstCaps * caps, GValueArray * factories, ofGstVideoPlayer * player);
+	static gint on_autoplug_select(GstElement * bin, GstPad * pad, GstCaps * caps, GstElementFactory * factory, ofGstVideoPlayer * player);
+	void connectDecoderSelection(GstElement * pipeline);
+#endif
 };
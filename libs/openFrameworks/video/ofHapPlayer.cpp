@@ -0,0 +1,1097 @@
+#include "ofHapPlayer.h"
+
+#ifndef TARGET_NO_THREADS
+
+#include "ofUtils.h"
+#include "ofLog.h"
+#include "ofGLUtils.h"
+#include "ofMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace{
+	const intptr_t invalidFile = -1;
+
+	intptr_t openFile(const string & path){
+#ifdef TARGET_WIN32
+		HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		return handle == INVALID_HANDLE_VALUE ? invalidFile : intptr_t(handle);
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+	#ifdef POSIX_FADV_SEQUENTIAL
+		if(fd >= 0){
+			// doubles the kernel's read ahead, frames are read in order
+			posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+		}
+	#endif
+		return fd < 0 ? invalidFile : intptr_t(fd);
+#endif
+	}
+
+	void closeFile(intptr_t file){
+#ifdef TARGET_WIN32
+		CloseHandle(HANDLE(file));
+#else
+		close(int(file));
+#endif
+	}
+
+	// positional reads don't share a file offset so every worker can read
+	// its own frame from the same file at the same time
+	bool readAt(intptr_t file, uint64_t offset, void * dst, size_t size){
+		auto data = static_cast<uint8_t*>(dst);
+		while(size > 0){
+#ifdef TARGET_WIN32
+			OVERLAPPED overlapped = {};
+			overlapped.Offset = DWORD(offset & 0xFFFFFFFF);
+			overlapped.OffsetHigh = DWORD(offset >> 32);
+			DWORD read = 0;
+			DWORD toRead = DWORD(std::min<size_t>(size, 1 << 30));
+			if(!ReadFile(HANDLE(file), data, toRead, &read, &overlapped) || read == 0){
+				return false;
+			}
+#else
+			ssize_t read = pread(int(file), data, size, offset);
+			if(read <= 0){
+				return false;
+			}
+#endif
+			data += read;
+			offset += read;
+			size -= read;
+		}
+		return true;
+	}
+
+	uint16_t be16(const uint8_t * p){
+		return (uint16_t(p[0]) << 8) | p[1];
+	}
+
+	uint32_t be32(const uint8_t * p){
+		return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+	}
+
+	uint64_t be64(const uint8_t * p){
+		return (uint64_t(be32(p)) << 32) | be32(p + 4);
+	}
+
+	uint32_t le24(const uint8_t * p){
+		return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+	}
+
+	uint32_t le32(const uint8_t * p){
+		return le24(p) | (uint32_t(p[3]) << 24);
+	}
+
+	//--------------------------------------------------------------
+	// QuickTime atoms
+	struct Atom{
+		const uint8_t * data = nullptr;
+		size_t size = 0;
+	};
+
+	bool findAtom(const Atom & parent, const char * type, Atom & atom){
+		size_t offset = 0;
+		while(offset + 8 <= parent.size){
+			const uint8_t * header = parent.data + offset;
+			uint64_t size = be32(header);
+			size_t headerSize = 8;
+			if(size == 1 && offset + 16 <= parent.size){
+				size = be64(header + 8);
+				headerSize = 16;
+			}else if(size == 0){
+				size = parent.size - offset;
+			}
+			if(size < headerSize || offset + size > parent.size){
+				return false;
+			}
+			if(memcmp(header + 4, type, 4) == 0){
+				atom.data = header + headerSize;
+				atom.size = size - headerSize;
+				return true;
+			}
+			offset += size;
+		}
+		return false;
+	}
+
+	bool findAtom(const Atom & parent, std::initializer_list<const char*> path, Atom & atom){
+		atom = parent;
+		for(auto type: path){
+			if(!findAtom(atom, type, atom)){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// the moov atom can be before or after the media data, only the atom
+	// headers are read to find it
+	bool readMoov(intptr_t file, vector<uint8_t> & moov){
+		uint64_t offset = 0;
+		uint8_t header[16];
+		while(readAt(file, offset, header, 8)){
+			uint64_t size = be32(header);
+			uint64_t headerSize = 8;
+			if(size == 1){
+				if(!readAt(file, offset + 8, header + 8, 8)){
+					return false;
+				}
+				size = be64(header + 8);
+				headerSize = 16;
+			}
+			if(size < headerSize){
+				return false;
+			}
+			if(memcmp(header + 4, "moov", 4) == 0){
+				moov.resize(size - headerSize);
+				return readAt(file, offset + headerSize, moov.data(), moov.size());
+			}
+			offset += size;
+		}
+		return false;
+	}
+
+	struct HapFormat{
+		const char * codec;
+		GLint glInternalFormat;
+		bool yCoCg;
+	};
+
+	const HapFormat hapFormats[] = {
+		{ "Hap1", GL_COMPRESSED_RGB_S3TC_DXT1_EXT, false },
+		{ "Hap5", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, false },
+		{ "HapY", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, true },
+		{ "HapA", GL_COMPRESSED_RED_RGTC1, false },
+		{ "Hap7", GL_COMPRESSED_RGBA_BPTC_UNORM, false },
+		{ "HapH", GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, false },
+	};
+
+	struct HapTrack{
+		const HapFormat * format = nullptr;
+		string codec;
+		int width = 0;
+		int height = 0;
+		uint32_t timescale = 0;
+		Atom stts, stsc, stsz, stco;
+		bool co64 = false;
+	};
+
+	bool findHapTrack(const vector<uint8_t> & moovData, HapTrack & track){
+		Atom moov{moovData.data(), moovData.size()};
+		size_t offset = 0;
+		while(offset < moov.size){
+			Atom rest{moov.data + offset, moov.size - offset};
+			Atom trak;
+			if(!findAtom(rest, "trak", trak)){
+				return false;
+			}
+			offset = trak.data + trak.size - moov.data;
+
+			Atom hdlr, mdhd, stbl, stsd;
+			if(!findAtom(trak, {"mdia", "hdlr"}, hdlr) || hdlr.size < 12 || memcmp(hdlr.data + 8, "vide", 4) != 0){
+				continue;
+			}
+			if(!findAtom(trak, {"mdia", "mdhd"}, mdhd) || mdhd.size < 24){
+				continue;
+			}
+			if(!findAtom(trak, {"mdia", "minf", "stbl"}, stbl) || !findAtom(stbl, "stsd", stsd) || stsd.size < 8 + 36){
+				continue;
+			}
+			// first sample description: size, codec, 6 reserved, data reference,
+			// version, revision, vendor, temporal and spatial quality, width, height
+			const uint8_t * entry = stsd.data + 8;
+			track.codec = string((const char*)entry + 4, 4);
+			track.width = be16(entry + 32);
+			track.height = be16(entry + 34);
+			track.timescale = mdhd.data[0] == 1 ? be32(mdhd.data + 20) : be32(mdhd.data + 12);
+			track.format = nullptr;
+			for(auto & format: hapFormats){
+				if(track.codec == format.codec){
+					track.format = &format;
+				}
+			}
+			if(track.codec.substr(0, 3) != "Hap"){
+				continue;
+			}
+			if(!findAtom(stbl, "stts", track.stts) || !findAtom(stbl, "stsc", track.stsc) || !findAtom(stbl, "stsz", track.stsz)){
+				return false;
+			}
+			track.co64 = !findAtom(stbl, "stco", track.stco);
+			if(track.co64 && !findAtom(stbl, "co64", track.stco)){
+				return false;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	// Snappy, https://github.com/google/snappy/blob/master/format_description.txt
+	bool snappyUncompress(const uint8_t * src, size_t size, vector<uint8_t> & dst){
+		const uint8_t * end = src + size;
+		uint64_t length = 0;
+		for(int shift = 0; ; shift += 7){
+			if(src == end || shift > 32){
+				return false;
+			}
+			uint8_t byte = *src++;
+			length |= uint64_t(byte & 0x7F) << shift;
+			if(!(byte & 0x80)){
+				break;
+			}
+		}
+
+		size_t start = dst.size();
+		dst.resize(start + length);
+		uint8_t * out = dst.data() + start;
+		uint8_t * outEnd = out + length;
+		uint8_t * op = out;
+		while(src < end){
+			uint8_t tag = *src++;
+			size_t len, copyOffset;
+			switch(tag & 3){
+			case 0:{
+				len = tag >> 2;
+				if(len >= 60){
+					size_t numBytes = len - 59;
+					if(size_t(end - src) < numBytes){
+						return false;
+					}
+					len = 0;
+					for(size_t i = 0; i < numBytes; i++){
+						len |= size_t(src[i]) << (8 * i);
+					}
+					src += numBytes;
+				}
+				len += 1;
+				if(size_t(end - src) < len || size_t(outEnd - op) < len){
+					return false;
+				}
+				memcpy(op, src, len);
+				src += len;
+				op += len;
+				continue;
+			}
+			case 1:
+				if(src == end){
+					return false;
+				}
+				len = 4 + ((tag >> 2) & 7);
+				copyOffset = (size_t(tag >> 5) << 8) | *src++;
+				break;
+			case 2:
+				if(end - src < 2){
+					return false;
+				}
+				len = (tag >> 2) + 1;
+				copyOffset = src[0] | (size_t(src[1]) << 8);
+				src += 2;
+				break;
+			default:
+				if(end - src < 4){
+					return false;
+				}
+				len = (tag >> 2) + 1;
+				copyOffset = le32(src);
+				src += 4;
+				break;
+			}
+			if(copyOffset == 0 || copyOffset > size_t(op - out) || size_t(outEnd - op) < len){
+				return false;
+			}
+			// the copy can overlap its own output to repeat short patterns
+			const uint8_t * from = op - copyOffset;
+			for(size_t i = 0; i < len; i++){
+				op[i] = from[i];
+			}
+			op += len;
+		}
+		return op == outEnd;
+	}
+
+	//--------------------------------------------------------------
+	// HAP frames, https://github.com/Vidvox/hap/blob/master/documentation/HapVideoDRAFT.md
+	bool readSection(const uint8_t * data, size_t size, size_t & headerSize, size_t & sectionSize, uint8_t & type){
+		if(size < 4){
+			return false;
+		}
+		sectionSize = le24(data);
+		type = data[3];
+		headerSize = 4;
+		if(sectionSize == 0){
+			if(size < 8){
+				return false;
+			}
+			sectionSize = le32(data + 4);
+			headerSize = 8;
+		}
+		return headerSize + sectionSize <= size;
+	}
+
+	bool uncompressChunk(uint8_t compressor, const uint8_t * data, size_t size, vector<uint8_t> & out){
+		switch(compressor){
+		case 0x0A:
+			out.insert(out.end(), data, data + size);
+			return true;
+		case 0x0B:
+			return snappyUncompress(data, size, out);
+		default:
+			return false;
+		}
+	}
+
+	bool decodeHapFrame(const uint8_t * data, size_t size, vector<uint8_t> & out){
+		size_t headerSize, sectionSize;
+		uint8_t type;
+		if(!readSection(data, size, headerSize, sectionSize, type)){
+			return false;
+		}
+		data += headerSize;
+		out.clear();
+
+		uint8_t compressor = type >> 4;
+		if(compressor == 0x0A || compressor == 0x0B){
+			return uncompressChunk(compressor, data, sectionSize, out);
+		}
+		if(compressor != 0x0C){
+			return false;
+		}
+
+		// frames encoded in chunks start with their decode instructions
+		size_t instructionsHeader, instructionsSize;
+		uint8_t instructionsType;
+		if(!readSection(data, sectionSize, instructionsHeader, instructionsSize, instructionsType) || instructionsType != 0x01){
+			return false;
+		}
+		const uint8_t * compressors = nullptr;
+		const uint8_t * sizes = nullptr;
+		const uint8_t * offsets = nullptr;
+		size_t numChunks = 0;
+		size_t offset = instructionsHeader;
+		while(offset < instructionsHeader + instructionsSize){
+			size_t innerHeader, innerSize;
+			uint8_t innerType;
+			if(!readSection(data + offset, instructionsHeader + instructionsSize - offset, innerHeader, innerSize, innerType)){
+				return false;
+			}
+			const uint8_t * inner = data + offset + innerHeader;
+			switch(innerType){
+			case 0x02:
+				compressors = inner;
+				numChunks = innerSize;
+				break;
+			case 0x03:
+				sizes = inner;
+				break;
+			case 0x04:
+				offsets = inner;
+				break;
+			}
+			offset += innerHeader + innerSize;
+		}
+		if(!compressors || !sizes){
+			return false;
+		}
+
+		const uint8_t * chunks = data + instructionsHeader + instructionsSize;
+		size_t chunksSize = sectionSize - instructionsHeader - instructionsSize;
+		size_t chunkOffset = 0;
+		for(size_t i = 0; i < numChunks; i++){
+			size_t chunkSize = le32(sizes + i * 4);
+			if(offsets){
+				chunkOffset = le32(offsets + i * 4);
+			}
+			if(chunkOffset + chunkSize > chunksSize || !uncompressChunk(compressors[i], chunks + chunkOffset, chunkSize, out)){
+				return false;
+			}
+			chunkOffset += chunkSize;
+		}
+		return true;
+	}
+
+	const char * hapQVertexShader150 = R"(#version 150
+uniform mat4 modelViewProjectionMatrix;
+in vec4 position;
+in vec2 texcoord;
+out vec2 texCoordVarying;
+void main(){
+	texCoordVarying = texcoord;
+	gl_Position = modelViewProjectionMatrix * position;
+})";
+
+	const char * hapQFragmentShader150 = R"(#version 150
+uniform sampler2D tex0;
+in vec2 texCoordVarying;
+out vec4 fragColor;
+void main(){
+	vec4 cocgsy = texture(tex0, texCoordVarying) - vec4(0.50196078431373, 0.50196078431373, 0.0, 0.0);
+	float scale = cocgsy.z * (255.0 / 8.0) + 1.0;
+	float co = cocgsy.x / scale;
+	float cg = cocgsy.y / scale;
+	float y = cocgsy.w;
+	fragColor = vec4(y + co - cg, y + cg, y - co - cg, 1.0);
+})";
+
+	const char * hapQVertexShaderES = R"(
+uniform mat4 modelViewProjectionMatrix;
+attribute vec4 position;
+attribute vec2 texcoord;
+varying vec2 texCoordVarying;
+void main(){
+	texCoordVarying = texcoord;
+	gl_Position = modelViewProjectionMatrix * position;
+})";
+
+	const char * hapQFragmentShaderES = R"(
+precision mediump float;
+uniform sampler2D tex0;
+varying vec2 texCoordVarying;
+void main(){
+	vec4 cocgsy = texture2D(tex0, texCoordVarying) - vec4(0.50196078431373, 0.50196078431373, 0.0, 0.0);
+	float scale = cocgsy.z * (255.0 / 8.0) + 1.0;
+	float co = cocgsy.x / scale;
+	float cg = cocgsy.y / scale;
+	float y = cocgsy.w;
+	gl_FragColor = vec4(y + co - cg, y + cg, y - co - cg, 1.0);
+})";
+
+	const char * hapQVertexShader120 = R"(#version 120
+void main(){
+	gl_TexCoord[0] = gl_MultiTexCoord0;
+	gl_Position = ftransform();
+})";
+
+	const char * hapQFragmentShader120 = R"(#version 120
+uniform sampler2D tex0;
+void main(){
+	vec4 cocgsy = texture2D(tex0, gl_TexCoord[0].xy) - vec4(0.50196078431373, 0.50196078431373, 0.0, 0.0);
+	float scale = cocgsy.z * (255.0 / 8.0) + 1.0;
+	float co = cocgsy.x / scale;
+	float cg = cocgsy.y / scale;
+	float y = cocgsy.w;
+	gl_FragColor = vec4(y + co - cg, y + cg, y - co - cg, 1.0);
+})";
+}
+
+//--------------------------------------------------------------
+ofHapPlayer::ofHapPlayer()
+:duration(0)
+,width(0)
+,height(0)
+,glInternalFormat(0)
+,bYCoCg(false)
+,pixelFormat(OF_PIXELS_RGB)
+,bLoaded(false)
+,bPlaying(false)
+,bPaused(false)
+,bFrameNew(false)
+,bDone(false)
+,bSeeking(false)
+,speed(1)
+,loopState(OF_LOOP_NORMAL)
+,currentFrame(0)
+,uploadedFrame(-1)
+,playheadOffset(0)
+,playheadStartMicros(0)
+,file(invalidFile)
+,numThreads(std::min<size_t>(4, std::max<size_t>(1, std::thread::hardware_concurrency() / 2)))
+,readAhead(4)
+,bStopWorkers(false){
+}
+
+//--------------------------------------------------------------
+ofHapPlayer::~ofHapPlayer(){
+	close();
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::isHapFile(const string & path){
+	auto file = openFile(ofToDataPath(path));
+	if(file == invalidFile){
+		return false;
+	}
+	vector<uint8_t> moov;
+	HapTrack track;
+	bool isHap = readMoov(file, moov) && findHapTrack(moov, track);
+	closeFile(file);
+	return isHap;
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::load(string name){
+	close();
+
+	path = ofToDataPath(name);
+	file = openFile(path);
+	if(file == invalidFile){
+		ofLogError("ofHapPlayer") << "load(): couldn't open \"" << path << "\"";
+		return false;
+	}
+
+	vector<uint8_t> moov;
+	HapTrack track;
+	if(!readMoov(file, moov) || !findHapTrack(moov, track)){
+		ofLogError("ofHapPlayer") << "load(): \"" << path << "\" has no HAP video track";
+		close();
+		return false;
+	}
+	if(!track.format){
+		ofLogError("ofHapPlayer") << "load(): HAP variant " << track.codec << " not supported";
+		close();
+		return false;
+	}
+
+	// sample sizes
+	if(track.stsz.size < 12){
+		close();
+		return false;
+	}
+	uint32_t sampleSize = be32(track.stsz.data + 4);
+	size_t numFrames = be32(track.stsz.data + 8);
+	if(sampleSize == 0 && track.stsz.size < 12 + numFrames * 4){
+		close();
+		return false;
+	}
+	frames.resize(numFrames);
+	for(size_t i = 0; i < numFrames; i++){
+		frames[i].size = sampleSize ? sampleSize : be32(track.stsz.data + 12 + i * 4);
+	}
+
+	// offsets, samples are stored in chunks of consecutive samples
+	size_t numChunks = track.stco.size >= 8 ? be32(track.stco.data + 4) : 0;
+	size_t numRuns = track.stsc.size >= 8 ? be32(track.stsc.data + 4) : 0;
+	if(track.stco.size < 8 + numChunks * (track.co64 ? 8 : 4) || track.stsc.size < 8 + numRuns * 12){
+		close();
+		return false;
+	}
+	size_t frame = 0;
+	for(size_t run = 0; run < numRuns && frame < numFrames; run++){
+		const uint8_t * entry = track.stsc.data + 8 + run * 12;
+		size_t firstChunk = be32(entry) - 1;
+		size_t lastChunk = run + 1 < numRuns ? be32(entry + 12) - 1 : numChunks;
+		size_t samplesPerChunk = be32(entry + 4);
+		for(size_t chunk = firstChunk; chunk < lastChunk && chunk < numChunks && frame < numFrames; chunk++){
+			uint64_t offset = track.co64 ? be64(track.stco.data + 8 + chunk * 8) : be32(track.stco.data + 8 + chunk * 4);
+			for(size_t i = 0; i < samplesPerChunk && frame < numFrames; i++, frame++){
+				frames[frame].offset = offset;
+				offset += frames[frame].size;
+			}
+		}
+	}
+	frames.resize(frame);
+
+	// timestamps
+	size_t numDurations = track.stts.size >= 8 ? be32(track.stts.data + 4) : 0;
+	if(track.stts.size < 8 + numDurations * 8 || track.timescale == 0 || frames.empty()){
+		close();
+		return false;
+	}
+	uint64_t time = 0;
+	frame = 0;
+	for(size_t i = 0; i < numDurations; i++){
+		const uint8_t * entry = track.stts.data + 8 + i * 8;
+		uint32_t count = be32(entry);
+		uint32_t delta = be32(entry + 4);
+		for(uint32_t j = 0; j < count && frame < frames.size(); j++, frame++){
+			frames[frame].time = double(time) / track.timescale;
+			time += delta;
+		}
+	}
+	for(; frame < frames.size(); frame++){
+		frames[frame].time = double(time) / track.timescale;
+	}
+	duration = double(time) / track.timescale;
+
+	width = track.width;
+	height = track.height;
+	glInternalFormat = track.format->glInternalFormat;
+	bYCoCg = track.format->yCoCg;
+	// hap frames are padded to whole 4x4 blocks
+	if(!texture.allocateCompressed((width + 3) / 4 * 4, (height + 3) / 4 * 4, glInternalFormat)){
+		close();
+		return false;
+	}
+	texture.getTextureData().width = width;
+	texture.getTextureData().height = height;
+	texture.getTextureData().tex_t = float(width) / texture.getTextureData().tex_w;
+	texture.getTextureData().tex_u = float(height) / texture.getTextureData().tex_h;
+
+	bLoaded = true;
+	startWorkers();
+	setFrame(0);
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::close(){
+	stopWorkers();
+	if(file != invalidFile){
+		closeFile(file);
+		file = invalidFile;
+	}
+	frames.clear();
+	decoded.clear();
+	requested.clear();
+	freeBuffers.clear();
+	texture.clear();
+	bLoaded = false;
+	bPlaying = false;
+	bPaused = false;
+	bFrameNew = false;
+	bDone = false;
+	bSeeking = false;
+	currentFrame = 0;
+	uploadedFrame = -1;
+	duration = 0;
+	width = height = 0;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::startWorkers(){
+	bStopWorkers = false;
+	for(size_t i = 0; i < numThreads; i++){
+		workers.emplace_back(&ofHapPlayer::workerFunction, this);
+	}
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::stopWorkers(){
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		bStopWorkers = true;
+	}
+	condition.notify_all();
+	for(auto & worker: workers){
+		worker.join();
+	}
+	workers.clear();
+	inFlight.clear();
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::workerFunction(){
+	vector<uint8_t> compressed;
+	while(true){
+		int frame = -1;
+		vector<uint8_t> buffer;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [&]{
+				if(bStopWorkers){
+					return true;
+				}
+				// the frames are requested in the order they'll be needed
+				for(auto f: requested){
+					if(!decoded.count(f) && std::find(inFlight.begin(), inFlight.end(), f) == inFlight.end()){
+						frame = f;
+						return true;
+					}
+				}
+				return false;
+			});
+			if(bStopWorkers){
+				return;
+			}
+			inFlight.push_back(frame);
+			if(!freeBuffers.empty()){
+				buffer = std::move(freeBuffers.back());
+				freeBuffers.pop_back();
+			}
+		}
+
+		compressed.resize(frames[frame].size);
+		bool ok = readAt(file, frames[frame].offset, compressed.data(), compressed.size())
+			&& decodeHapFrame(compressed.data(), compressed.size(), buffer);
+		if(!ok){
+			ofLogError("ofHapPlayer") << "couldn't decode frame " << frame << " of \"" << path << "\"";
+			buffer.clear();
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			inFlight.erase(std::find(inFlight.begin(), inFlight.end(), frame));
+			// a broken frame is stored empty so it isn't retried
+			if(std::find(requested.begin(), requested.end(), frame) != requested.end()){
+				decoded[frame] = std::move(buffer);
+			}else{
+				freeBuffers.push_back(std::move(buffer));
+			}
+		}
+		condition.notify_all();
+	}
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::requestFrames(int from){
+	int numFrames = frames.size();
+	int direction = speed < 0 ? -1 : 1;
+	std::unique_lock<std::mutex> lock(mutex);
+	requested.clear();
+	for(size_t i = 0; i < readAhead; i++){
+		int frame = from + direction * int(i);
+		if(loopState == OF_LOOP_NONE){
+			if(frame < 0 || frame >= numFrames){
+				break;
+			}
+		}else{
+			frame = (frame % numFrames + numFrames) % numFrames;
+		}
+		if(std::find(requested.begin(), requested.end(), frame) == requested.end()){
+			requested.push_back(frame);
+		}
+	}
+	for(auto it = decoded.begin(); it != decoded.end();){
+		if(std::find(requested.begin(), requested.end(), it->first) == requested.end()){
+			freeBuffers.push_back(std::move(it->second));
+			it = decoded.erase(it);
+		}else{
+			++it;
+		}
+	}
+	lock.unlock();
+	condition.notify_all();
+}
+
+//--------------------------------------------------------------
+int ofHapPlayer::frameAt(double time) const{
+	auto it = std::upper_bound(frames.begin(), frames.end(), time, [](double t, const Frame & frame){
+		return t < frame.time;
+	});
+	return std::max(int(it - frames.begin()) - 1, 0);
+}
+
+//--------------------------------------------------------------
+double ofHapPlayer::getPlayheadTime(uint64_t nowMicros) const{
+	if(!bPlaying || bPaused){
+		return playheadOffset;
+	}
+	return playheadOffset + double(nowMicros - playheadStartMicros) / 1000000.0 * speed;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setPlayheadFrame(int frame){
+	currentFrame = ofClamp(frame, 0, int(frames.size()) - 1);
+	playheadOffset = frames[currentFrame].time;
+	playheadStartMicros = ofGetElapsedTimeMicros();
+	bDone = false;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::update(){
+	bFrameNew = false;
+	if(!bLoaded){
+		return;
+	}
+
+	if(bPlaying && !bPaused && !bSeeking){
+		double time = getPlayheadTime(ofGetElapsedTimeMicros());
+		switch(loopState){
+		case OF_LOOP_NONE:
+			if(time >= duration || time < 0){
+				time = ofClamp(time, 0, duration);
+				bDone = true;
+				bPlaying = false;
+				playheadOffset = time;
+			}
+			break;
+		case OF_LOOP_NORMAL:
+			time = fmod(time, duration);
+			if(time < 0){
+				time += duration;
+			}
+			break;
+		case OF_LOOP_PALINDROME:
+			time = fmod(fabs(time), 2 * duration);
+			if(time > duration){
+				time = 2 * duration - time;
+			}
+			break;
+		}
+		currentFrame = frameAt(time);
+	}
+
+	requestFrames(currentFrame);
+	if(currentFrame == uploadedFrame){
+		return;
+	}
+
+	vector<uint8_t> data;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto it = decoded.find(currentFrame);
+		if(it == decoded.end()){
+			// not ready yet, the previous frame stays on screen
+			return;
+		}
+		data = std::move(it->second);
+		decoded.erase(it);
+	}
+
+	size_t expected = ofGLGetCompressedBlockSize(glInternalFormat) * ((width + 3) / 4) * ((height + 3) / 4);
+	if(data.size() >= expected){
+		texture.loadCompressedData(data.data(), expected);
+		bFrameNew = true;
+	}
+	uploadedFrame = currentFrame;
+	if(bSeeking){
+		// playback continues from the frame that was sought
+		playheadOffset = frames[currentFrame].time;
+		playheadStartMicros = ofGetElapsedTimeMicros();
+		bSeeking = false;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	freeBuffers.push_back(std::move(data));
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::play(){
+	if(!bLoaded){
+		return;
+	}
+	if(bDone){
+		setPlayheadFrame(speed < 0 ? frames.size() - 1 : 0);
+	}
+	playheadOffset = frames[currentFrame].time;
+	playheadStartMicros = ofGetElapsedTimeMicros();
+	bPlaying = true;
+	bPaused = false;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::stop(){
+	bPlaying = false;
+	bPaused = false;
+	if(bLoaded){
+		setPlayheadFrame(0);
+	}
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::isFrameNew() const{
+	return bFrameNew;
+}
+
+//--------------------------------------------------------------
+const ofPixels & ofHapPlayer::getPixels() const{
+	return pixels;
+}
+
+//--------------------------------------------------------------
+ofPixels & ofHapPlayer::getPixels(){
+	return pixels;
+}
+
+//--------------------------------------------------------------
+ofTexture * ofHapPlayer::getTexturePtr(){
+	return bLoaded ? &texture : nullptr;
+}
+
+//--------------------------------------------------------------
+float ofHapPlayer::getWidth() const{
+	return width;
+}
+
+//--------------------------------------------------------------
+float ofHapPlayer::getHeight() const{
+	return height;
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::isPaused() const{
+	return bPaused;
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::isLoaded() const{
+	return bLoaded;
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::isPlaying() const{
+	return bPlaying && !bPaused;
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::setPixelFormat(ofPixelFormat pixelFormat){
+	// frames go straight to the texture in their compressed format, the
+	// format is only kept for ofVideoPlayer to give it to other players
+	this->pixelFormat = pixelFormat;
+	return true;
+}
+
+//--------------------------------------------------------------
+ofPixelFormat ofHapPlayer::getPixelFormat() const{
+	return pixelFormat;
+}
+
+//--------------------------------------------------------------
+float ofHapPlayer::getPosition() const{
+	return duration > 0 ? frames[currentFrame].time / duration : 0;
+}
+
+//--------------------------------------------------------------
+float ofHapPlayer::getSpeed() const{
+	return speed;
+}
+
+//--------------------------------------------------------------
+float ofHapPlayer::getDuration() const{
+	return duration;
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::getIsMovieDone() const{
+	return bDone;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setPaused(bool bPause){
+	if(bPause == bPaused || !bLoaded){
+		return;
+	}
+	if(bPause){
+		playheadOffset = frames[currentFrame].time;
+	}else{
+		playheadStartMicros = ofGetElapsedTimeMicros();
+	}
+	bPaused = bPause;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setPosition(float pct){
+	if(bLoaded){
+		setFrame(frameAt(ofClamp(pct, 0, 1) * duration));
+	}
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setLoopState(ofLoopType state){
+	loopState = state;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setSpeed(float speed){
+	if(bLoaded && bPlaying){
+		playheadOffset = frames[currentFrame].time;
+		playheadStartMicros = ofGetElapsedTimeMicros();
+	}
+	this->speed = speed;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setFrame(int frame){
+	if(!bLoaded){
+		return;
+	}
+	setPlayheadFrame(frame);
+	requestFrames(currentFrame);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [&]{
+			return decoded.count(currentFrame) > 0;
+		});
+	}
+	bSeeking = true;
+	update();
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setFrameAsync(int frame, ofVideoSeekMode){
+	if(!bLoaded){
+		return;
+	}
+	// every hap frame is a keyframe, both modes land on the exact frame
+	setPlayheadFrame(frame);
+	bSeeking = true;
+	requestFrames(currentFrame);
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::isSeeking() const{
+	return bSeeking;
+}
+
+//--------------------------------------------------------------
+int ofHapPlayer::getCurrentFrame() const{
+	return currentFrame;
+}
+
+//--------------------------------------------------------------
+int ofHapPlayer::getTotalNumFrames() const{
+	return frames.size();
+}
+
+//--------------------------------------------------------------
+ofLoopType ofHapPlayer::getLoopState() const{
+	return loopState;
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::firstFrame(){
+	setFrame(0);
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::nextFrame(){
+	setFrame(currentFrame + 1);
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::previousFrame(){
+	setFrame(currentFrame - 1);
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setNumThreads(size_t numThreads){
+	if(bLoaded){
+		ofLogWarning("ofHapPlayer") << "setNumThreads(): has to be called before load()";
+		return;
+	}
+	this->numThreads = std::max<size_t>(1, numThreads);
+}
+
+//--------------------------------------------------------------
+void ofHapPlayer::setReadAhead(size_t numFrames){
+	readAhead = std::max<size_t>(1, numFrames);
+}
+
+//--------------------------------------------------------------
+bool ofHapPlayer::isYCoCg() const{
+	return bYCoCg;
+}
+
+//--------------------------------------------------------------
+ofShader & ofHapPlayer::getShader(){
+	if(!shader.isLoaded()){
+		if(ofIsGLProgrammableRenderer()){
+#ifdef TARGET_OPENGLES
+			shader.setupShaderFromSource(GL_VERTEX_SHADER, hapQVertexShaderES);
+			shader.setupShaderFromSource(GL_FRAGMENT_SHADER, hapQFragmentShaderES);
+#else
+			shader.setupShaderFromSource(GL_VERTEX_SHADER, hapQVertexShader150);
+			shader.setupShaderFromSource(GL_FRAGMENT_SHADER, hapQFragmentShader150);
+#endif
+			shader.bindDefaults();
+		}else{
+			shader.setupShaderFromSource(GL_VERTEX_SHADER, hapQVertexShader120);
+			shader.setupShaderFromSource(GL_FRAGMENT_SHADER, hapQFragmentShader120);
+		}
+		shader.linkProgram();
+	}
+	return shader;
+}
+
+#endif
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofBaseTypes.h"
+#include "ofPixels.h"
+#include "ofTexture.h"
+#include "ofShader.h"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#ifndef TARGET_NO_THREADS
+
+/// \brief Plays HAP movies, frames compressed with DXT/BC textures inside
+/// a QuickTime container, straight into a compressed texture
+///
+/// Other players decode each frame to RGB pixels on the CPU and upload
+/// them uncompressed. HAP frames are already in a format the graphics card
+/// samples directly so they only need reading, a fast Snappy decompression
+/// and a compressed upload, which is what allows several 4K streams at once.
+///
+/// Frames are read with positional reads and decompressed by a pool of
+/// worker threads a few frames ahead of the playhead, update() only
+/// uploads the current one with glCompressedTexSubImage2D. ofVideoPlayer
+/// uses this player automatically for HAP files when no other player was
+/// set:
+///
+/// ~~~~{.cpp}
+/// ofVideoPlayer movie;
+/// movie.load("clip_hap.mov");
+/// movie.play();
+/// ~~~~
+///
+/// Hap, Hap Alpha, Hap R (BC7), Hap HDR (BC6H) and Hap Q are supported, Hap Q
+/// stores scaled YCoCg and has to be drawn with getShader() bound. Frames
+/// never exist as pixels so getPixels() is always empty, and there's no
+/// sound.
+class ofHapPlayer: public ofBaseVideoPlayer{
+public:
+	ofHapPlayer();
+	~ofHapPlayer();
+
+	ofHapPlayer(const ofHapPlayer&) = delete;
+	ofHapPlayer & operator=(const ofHapPlayer&) = delete;
+
+	/// \brief Whether path is a QuickTime movie with a HAP video track,
+	/// only reads the file's headers
+	static bool isHapFile(const std::string & path);
+
+	bool load(std::string name);
+	void update();
+	void close();
+
+	void play();
+	void stop();
+
+	bool isFrameNew() const;
+	const ofPixels & getPixels() const;
+	ofPixels & getPixels();
+	ofTexture * getTexturePtr();
+
+	float getWidth() const;
+	float getHeight() const;
+
+	bool isPaused() const;
+	bool isLoaded() const;
+	bool isPlaying() const;
+
+	bool setPixelFormat(ofPixelFormat pixelFormat);
+	ofPixelFormat getPixelFormat() const;
+
+	float getPosition() const;
+	float getSpeed() const;
+	float getDuration() const;
+	bool getIsMovieDone() const;
+
+	void setPaused(bool bPause);
+	void setPosition(float pct);
+	void setLoopState(ofLoopType state);
+	void setSpeed(float speed);
+	void setFrame(int frame);
+	void setFrameAsync(int frame, ofVideoSeekMode mode);
+	bool isSeeking() const;
+
+	int getCurrentFrame() const;
+	int getTotalNumFrames() const;
+	ofLoopType getLoopState() const;
+
+	void firstFrame();
+	void nextFrame();
+	void previousFrame();
+
+	/// \brief Number of threads decompressing frames, by default half the
+	/// cores up to 4, has to be set before load()
+	void setNumThreads(std::size_t numThreads);
+
+	/// \brief Frames decompressed ahead of the playhead, 4 by default
+	void setReadAhead(std::size_t numFrames);
+
+	/// \brief Whether the movie is Hap Q and needs getShader() to be drawn
+	bool isYCoCg() const;
+
+	/// \brief Converts the scaled YCoCg of Hap Q textures to RGB, bind it
+	/// while drawing the texture
+	ofShader & getShader();
+
+private:
+	struct Frame{
+		uint64_t offset;
+		uint32_t size;
+		double time;
+	};
+
+	void startWorkers();
+	void stopWorkers();
+	void workerFunction();
+	void requestFrames(int from);
+	int frameAt(double time) const;
+	double getPlayheadTime(uint64_t nowMicros) const;
+	void setPlayheadFrame(int frame);
+
+	std::string path;
+	std::vector<Frame> frames;
+	double duration;
+	int width, height;
+	GLint glInternalFormat;
+	bool bYCoCg;
+
+	ofTexture texture;
+	ofShader shader;
+	ofPixels pixels;
+	ofPixelFormat pixelFormat;
+
+	bool bLoaded;
+	bool bPlaying;
+	bool bPaused;
+	bool bFrameNew;
+	bool bDone;
+	bool bSeeking;
+	float speed;
+	ofLoopType loopState;
+	int currentFrame;
+	int uploadedFrame;
+	double playheadOffset;
+	uint64_t playheadStartMicros;
+
+	// a file descriptor, or a HANDLE on windows
+	intptr_t file;
+	std::size_t numThreads;
+	std::size_t readAhead;
+	std::vector<std::thread> workers;
+	mutable std::mutex mutex;
+	std::condition_variable condition;
+	std::vector<int> requested;
+	std::map<int, std::vector<uint8_t>> decoded;
+	std::vector<int> inFlight;
+	std::vector<std::vector<uint8_t>> freeBuffers;
+	bool bStopWorkers;
+};
+
+#endif
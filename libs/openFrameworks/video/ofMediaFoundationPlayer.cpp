@@ -0,0 +1,618 @@
+#include "ofMediaFoundationPlayer.h"
+
+#ifdef TARGET_WIN32
+#include "ofUtils.h"
+#include "ofLog.h"
+#include "ofMath.h"
+#include <mfapi.h>
+#include <mfmediaengine.h>
+#include <mfreadwrite.h>
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+// winbase.h maps it to GetTickCount()
+#undef GetCurrentTime
+
+using namespace std;
+using Microsoft::WRL::ComPtr;
+
+namespace{
+	// written from Media Foundation's threads
+	struct EngineState{
+		std::atomic<bool> loaded{false};
+		std::atomic<bool> ended{false};
+		std::atomic<bool> error{false};
+	};
+
+	class EngineNotify: public IMFMediaEngineNotify{
+	public:
+		EngineNotify(const shared_ptr<EngineState> & state)
+		:refCount(1)
+		,state(state){}
+
+		STDMETHODIMP QueryInterface(REFIID riid, void ** ppv){
+			if(riid == __uuidof(IMFMediaEngineNotify) || riid == __uuidof(IUnknown)){
+				*ppv = static_cast<IMFMediaEngineNotify*>(this);
+				AddRef();
+				return S_OK;
+			}
+			*ppv = nullptr;
+			return E_NOINTERFACE;
+		}
+
+		STDMETHODIMP_(ULONG) AddRef(){
+			return ++refCount;
+		}
+
+		STDMETHODIMP_(ULONG) Release(){
+			ULONG count = --refCount;
+			if(count == 0){
+				delete this;
+			}
+			return count;
+		}
+
+		STDMETHODIMP EventNotify(DWORD event, DWORD_PTR param1, DWORD param2){
+			switch(event){
+			case MF_MEDIA_ENGINE_EVENT_LOADEDMETADATA:
+				state->loaded = true;
+				break;
+			case MF_MEDIA_ENGINE_EVENT_PLAYING:
+				state->ended = false;
+				break;
+			case MF_MEDIA_ENGINE_EVENT_ENDED:
+				state->ended = true;
+				break;
+			case MF_MEDIA_ENGINE_EVENT_ERROR:
+				ofLogError("ofMediaFoundationPlayer") << "media engine error " << param1 << ", hresult 0x" << ofToHex(uint32_t(param2));
+				state->error = true;
+				break;
+			}
+			return S_OK;
+		}
+
+	private:
+		std::atomic<ULONG> refCount;
+		shared_ptr<EngineState> state;
+	};
+
+	bool startMediaFoundation(){
+		// like gstreamer it's never shut down, other players might
+		// still be using it while the app exits
+		static bool started = [](){
+			CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+			return SUCCEEDED(MFStartup(MF_VERSION));
+		}();
+		return started;
+	}
+
+	std::wstring toWide(const string & str){
+		int length = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.size(), nullptr, 0);
+		std::wstring wide(length, 0);
+		MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.size(), &wide[0], length);
+		return wide;
+	}
+
+	// the media engine doesn't expose the frame rate, a source reader
+	// only parses the headers to get it
+	double getFrameRate(const std::wstring & url){
+		ComPtr<IMFSourceReader> reader;
+		ComPtr<IMFMediaType> type;
+		UINT32 num = 0, den = 0;
+		if(SUCCEEDED(MFCreateSourceReaderFromURL(url.c_str(), nullptr, &reader)) &&
+		   SUCCEEDED(reader->GetNativeMediaType(MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, &type)) &&
+		   SUCCEEDED(MFGetAttributeRatio(type.Get(), MF_MT_FRAME_RATE, &num, &den)) && den != 0){
+			return double(num) / den;
+		}
+		return 0;
+	}
+}
+
+struct ofMediaFoundationPlayer::Engine{
+	shared_ptr<EngineState> state;
+	ComPtr<ID3D11Device> device;
+	ComPtr<ID3D11DeviceContext> context;
+	ComPtr<IMFDXGIDeviceManager> deviceManager;
+	ComPtr<IMFMediaEngine> mediaEngine;
+	ComPtr<IMFMediaEngineEx> mediaEngineEx;
+
+	// the engine converts each frame into it, it's shared with GL or
+	// copied to the staging texture to read it back
+	ComPtr<ID3D11Texture2D> frameTexture;
+	ComPtr<ID3D11Texture2D> stagingTexture;
+
+	HANDLE interopDevice = nullptr;
+	HANDLE interopTexture = nullptr;
+	bool bInteropLocked = false;
+};
+
+//----------------------------------------------------------
+ofMediaFoundationPlayer::ofMediaFoundationPlayer()
+:pixelFormat(OF_PIXELS_BGRA)
+,width(0)
+,height(0)
+,frameRate(0)
+,speed(1)
+,loopState(OF_LOOP_NORMAL)
+,bLoaded(false)
+,bPlaying(false)
+,bPaused(false)
+,bFrameNew(false)
+,bInterop(false){
+}
+
+//----------------------------------------------------------
+ofMediaFoundationPlayer::~ofMediaFoundationPlayer(){
+	close();
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::startLoad(const string & name){
+	close();
+	if(!startMediaFoundation()){
+		ofLogError("ofMediaFoundationPlayer") << "load(): couldn't start Media Foundation";
+		return false;
+	}
+
+	engine.reset(new Engine);
+	engine->state = make_shared<EngineState>();
+
+	UINT flags = D3D11_CREATE_DEVICE_VIDEO_SUPPORT | D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+	if(FAILED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, flags, nullptr, 0, D3D11_SDK_VERSION, &engine->device, nullptr, &engine->context))){
+		ofLogError("ofMediaFoundationPlayer") << "load(): couldn't create a D3D11 device with video support";
+		engine.reset();
+		return false;
+	}
+	// the decoder uses the device from its own threads
+	ComPtr<ID3D10Multithread> multithread;
+	if(SUCCEEDED(engine->device.As(&multithread))){
+		multithread->SetMultithreadProtected(TRUE);
+	}
+
+	UINT resetToken;
+	MFCreateDXGIDeviceManager(&resetToken, &engine->deviceManager);
+	engine->deviceManager->ResetDevice(engine->device.Get(), resetToken);
+
+	ComPtr<IMFMediaEngineClassFactory> factory;
+	ComPtr<IMFAttributes> attributes;
+	auto notify = new EngineNotify(engine->state);
+	MFCreateAttributes(&attributes, 3);
+	attributes->SetUnknown(MF_MEDIA_ENGINE_DXGI_MANAGER, engine->deviceManager.Get());
+	attributes->SetUnknown(MF_MEDIA_ENGINE_CALLBACK, notify);
+	attributes->SetUINT32(MF_MEDIA_ENGINE_VIDEO_OUTPUT_FORMAT, DXGI_FORMAT_B8G8R8A8_UNORM);
+	HRESULT hr = CoCreateInstance(CLSID_MFMediaEngineClassFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+	if(SUCCEEDED(hr)){
+		hr = factory->CreateInstance(0, attributes.Get(), &engine->mediaEngine);
+	}
+	notify->Release();
+	if(FAILED(hr)){
+		ofLogError("ofMediaFoundationPlayer") << "load(): couldn't create the media engine, hresult 0x" << ofToHex(uint32_t(hr));
+		engine.reset();
+		return false;
+	}
+	engine->mediaEngine.As(&engine->mediaEngineEx);
+
+	string url = name.find("://") == string::npos ? ofToDataPath(name, true) : name;
+	auto wideUrl = toWide(url);
+	frameRate = getFrameRate(wideUrl);
+
+	engine->mediaEngine->SetAutoPlay(FALSE);
+	engine->mediaEngine->SetPreload(MF_MEDIA_ENGINE_PRELOAD_AUTOMATIC);
+	engine->mediaEngine->SetLoop(loopState != OF_LOOP_NONE);
+	engine->mediaEngine->SetDefaultPlaybackRate(speed);
+	BSTR source = SysAllocString(wideUrl.c_str());
+	hr = engine->mediaEngine->SetSource(source);
+	SysFreeString(source);
+	if(FAILED(hr)){
+		ofLogError("ofMediaFoundationPlayer") << "load(): couldn't open \"" << url << "\"";
+		close();
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::load(string name){
+	if(!startLoad(name)){
+		return false;
+	}
+	auto start = std::chrono::steady_clock::now();
+	while(!engine->state->loaded && !engine->state->error){
+		if(std::chrono::steady_clock::now() - start > std::chrono::seconds(10)){
+			ofLogError("ofMediaFoundationPlayer") << "load(): timed out loading \"" << name << "\"";
+			close();
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if(engine->state->error || !setupFrames()){
+		ofLogError("ofMediaFoundationPlayer") << "load(): couldn't load \"" << name << "\"";
+		close();
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::loadAsync(string name){
+	startLoad(name);
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::setupFrames(){
+	DWORD w, h;
+	if(FAILED(engine->mediaEngine->GetNativeVideoSize(&w, &h)) || w == 0 || h == 0){
+		ofLogError("ofMediaFoundationPlayer") << "load(): the file has no video";
+		return false;
+	}
+	width = w;
+	height = h;
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = w;
+	desc.Height = h;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	if(FAILED(engine->device->CreateTexture2D(&desc, nullptr, &engine->frameTexture))){
+		return false;
+	}
+
+	bInterop = false;
+	if(WGLEW_NV_DX_interop2){
+		engine->interopDevice = wglDXOpenDeviceNV(engine->device.Get());
+		if(engine->interopDevice){
+			texture.allocate(width, height, GL_RGBA);
+			auto & texData = texture.getTextureData();
+			engine->interopTexture = wglDXRegisterObjectNV(engine->interopDevice, engine->frameTexture.Get(),
+				texData.textureID, texData.textureTarget, WGL_ACCESS_READ_ONLY_NV);
+			bInterop = engine->interopTexture != nullptr;
+		}
+		if(!bInterop){
+			ofLogWarning("ofMediaFoundationPlayer") << "load(): couldn't share the D3D11 texture with GL, copying frames through the cpu";
+			if(engine->interopDevice){
+				wglDXCloseDeviceNV(engine->interopDevice);
+				engine->interopDevice = nullptr;
+			}
+			texture.clear();
+		}
+	}
+
+	if(!bInterop){
+		desc.Usage = D3D11_USAGE_STAGING;
+		desc.BindFlags = 0;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+		if(FAILED(engine->device->CreateTexture2D(&desc, nullptr, &engine->stagingTexture))){
+			return false;
+		}
+		pixels.allocate(width, height, pixelFormat);
+	}
+
+	bLoaded = true;
+	if(bPlaying && !bPaused){
+		engine->mediaEngine->Play();
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::copyFrameToPixels(){
+	engine->context->CopyResource(engine->stagingTexture.Get(), engine->frameTexture.Get());
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	if(FAILED(engine->context->Map(engine->stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mapped))){
+		return;
+	}
+	auto dst = pixels.getData();
+	auto channels = pixels.getNumChannels();
+	for(int y = 0; y < height; y++){
+		auto src = static_cast<const unsigned char*>(mapped.pData) + y * mapped.RowPitch;
+		if(pixelFormat == OF_PIXELS_BGRA){
+			memcpy(dst, src, width * 4);
+		}else{
+			for(int x = 0; x < width; x++){
+				dst[x * channels + 0] = src[x * 4 + 2];
+				dst[x * channels + 1] = src[x * 4 + 1];
+				dst[x * channels + 2] = src[x * 4 + 0];
+				if(channels == 4){
+					dst[x * channels + 3] = src[x * 4 + 3];
+				}
+			}
+		}
+		dst += width * channels;
+	}
+	engine->context->Unmap(engine->stagingTexture.Get(), 0);
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::update(){
+	bFrameNew = false;
+	if(!engine) return;
+	if(!bLoaded){
+		if(engine->state->error){
+			close();
+		}else if(engine->state->loaded && !setupFrames()){
+			close();
+		}
+		if(!bLoaded) return;
+	}
+
+	LONGLONG pts;
+	if(engine->mediaEngine->OnVideoStreamTick(&pts) != S_OK){
+		return;
+	}
+
+	// the texture can only be written by D3D while it's unlocked
+	if(engine->bInteropLocked){
+		wglDXUnlockObjectsNV(engine->interopDevice, 1, &engine->interopTexture);
+		engine->bInteropLocked = false;
+	}
+	MFVideoNormalizedRect srcRect = {0, 0, 1, 1};
+	RECT dstRect = {0, 0, width, height};
+	MFARGB border = {0, 0, 0, 255};
+	if(SUCCEEDED(engine->mediaEngine->TransferVideoFrame(engine->frameTexture.Get(), &srcRect, &dstRect, &border))){
+		if(!bInterop){
+			copyFrameToPixels();
+		}
+		bFrameNew = true;
+	}
+	if(bInterop){
+		engine->bInteropLocked = wglDXLockObjectsNV(engine->interopDevice, 1, &engine->interopTexture);
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::close(){
+	if(engine){
+		if(engine->bInteropLocked){
+			wglDXUnlockObjectsNV(engine->interopDevice, 1, &engine->interopTexture);
+		}
+		if(engine->interopTexture){
+			wglDXUnregisterObjectNV(engine->interopDevice, engine->interopTexture);
+		}
+		if(engine->interopDevice){
+			wglDXCloseDeviceNV(engine->interopDevice);
+		}
+		if(engine->mediaEngine){
+			engine->mediaEngine->Shutdown();
+		}
+		engine.reset();
+	}
+	texture.clear();
+	pixels.clear();
+	width = 0;
+	height = 0;
+	frameRate = 0;
+	bLoaded = false;
+	bPlaying = false;
+	bPaused = false;
+	bFrameNew = false;
+	bInterop = false;
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::play(){
+	bPlaying = true;
+	bPaused = false;
+	if(bLoaded){
+		engine->mediaEngine->Play();
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::stop(){
+	bPlaying = false;
+	if(bLoaded){
+		engine->mediaEngine->Pause();
+		engine->mediaEngine->SetCurrentTime(0);
+	}
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::isFrameNew() const{
+	return bFrameNew;
+}
+
+//----------------------------------------------------------
+const ofPixels & ofMediaFoundationPlayer::getPixels() const{
+	return pixels;
+}
+
+//----------------------------------------------------------
+ofPixels & ofMediaFoundationPlayer::getPixels(){
+	return pixels;
+}
+
+//----------------------------------------------------------
+ofTexture * ofMediaFoundationPlayer::getTexturePtr(){
+	return bInterop ? &texture : nullptr;
+}
+
+//----------------------------------------------------------
+float ofMediaFoundationPlayer::getWidth() const{
+	return width;
+}
+
+//----------------------------------------------------------
+float ofMediaFoundationPlayer::getHeight() const{
+	return height;
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::isPaused() const{
+	return bPaused;
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::isLoaded() const{
+	return bLoaded;
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::isPlaying() const{
+	return bPlaying;
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::setPixelFormat(ofPixelFormat pixelFormat){
+	switch(pixelFormat){
+	case OF_PIXELS_RGB:
+	case OF_PIXELS_RGBA:
+	case OF_PIXELS_BGRA:
+		this->pixelFormat = pixelFormat;
+		if(bLoaded && !bInterop){
+			pixels.allocate(width, height, pixelFormat);
+		}
+		return true;
+	default:
+		ofLogWarning("ofMediaFoundationPlayer") << "setPixelFormat(): " << ofToString(pixelFormat) << " not supported";
+		return false;
+	}
+}
+
+//----------------------------------------------------------
+ofPixelFormat ofMediaFoundationPlayer::getPixelFormat() const{
+	return pixelFormat;
+}
+
+//----------------------------------------------------------
+float ofMediaFoundationPlayer::getPosition() const{
+	auto duration = getDuration();
+	return duration > 0 ? engine->mediaEngine->GetCurrentTime() / duration : 0;
+}
+
+//----------------------------------------------------------
+float ofMediaFoundationPlayer::getSpeed() const{
+	return speed;
+}
+
+//----------------------------------------------------------
+float ofMediaFoundationPlayer::getDuration() const{
+	if(!bLoaded) return 0;
+	// infinite for live streams and NaN while it's unknown
+	double duration = engine->mediaEngine->GetDuration();
+	return std::isfinite(duration) ? duration : 0;
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::getIsMovieDone() const{
+	return engine && engine->state->ended;
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::setPaused(bool bPause){
+	bPaused = bPause;
+	if(!bLoaded) return;
+	if(bPaused){
+		engine->mediaEngine->Pause();
+	}else if(bPlaying){
+		engine->mediaEngine->Play();
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::setPosition(float pct){
+	if(bLoaded){
+		engine->mediaEngine->SetCurrentTime(ofClamp(pct, 0, 1) * getDuration());
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::setVolume(float volume){
+	if(engine){
+		engine->mediaEngine->SetVolume(ofClamp(volume, 0, 1));
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::setLoopState(ofLoopType state){
+	if(state == OF_LOOP_PALINDROME){
+		ofLogWarning("ofMediaFoundationPlayer") << "setLoopState(): palindrome looping isn't supported, looping normally";
+		state = OF_LOOP_NORMAL;
+	}
+	loopState = state;
+	if(engine){
+		engine->mediaEngine->SetLoop(loopState != OF_LOOP_NONE);
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::setSpeed(float speed){
+	this->speed = speed;
+	if(engine){
+		engine->mediaEngine->SetDefaultPlaybackRate(speed);
+		engine->mediaEngine->SetPlaybackRate(speed);
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::setFrame(int frame){
+	if(bLoaded && frameRate > 0){
+		engine->mediaEngine->SetCurrentTime(frame / frameRate);
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::setFrameAsync(int frame, ofVideoSeekMode mode){
+	if(!bLoaded || frameRate <= 0) return;
+	if(engine->mediaEngineEx){
+		auto seekMode = mode == OF_VIDEO_SEEK_KEYFRAME ? MF_MEDIA_ENGINE_SEEK_MODE_APPROXIMATE : MF_MEDIA_ENGINE_SEEK_MODE_NORMAL;
+		engine->mediaEngineEx->SetCurrentTimeEx(frame / frameRate, seekMode);
+	}else{
+		engine->mediaEngine->SetCurrentTime(frame / frameRate);
+	}
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::isSeeking() const{
+	return bLoaded && engine->mediaEngine->IsSeeking();
+}
+
+//----------------------------------------------------------
+int ofMediaFoundationPlayer::getCurrentFrame() const{
+	if(!bLoaded) return 0;
+	return int(engine->mediaEngine->GetCurrentTime() * frameRate + 0.5);
+}
+
+//----------------------------------------------------------
+int ofMediaFoundationPlayer::getTotalNumFrames() const{
+	return int(getDuration() * frameRate + 0.5);
+}
+
+//----------------------------------------------------------
+ofLoopType ofMediaFoundationPlayer::getLoopState() const{
+	return loopState;
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::firstFrame(){
+	setFrame(0);
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::nextFrame(){
+	if(bLoaded && engine->mediaEngineEx){
+		engine->mediaEngineEx->FrameStep(TRUE);
+	}
+}
+
+//----------------------------------------------------------
+void ofMediaFoundationPlayer::previousFrame(){
+	if(bLoaded && engine->mediaEngineEx){
+		engine->mediaEngineEx->FrameStep(FALSE);
+	}
+}
+
+//----------------------------------------------------------
+bool ofMediaFoundationPlayer::isUsingInterop() const{
+	return bInterop;
+}
+
+#endif
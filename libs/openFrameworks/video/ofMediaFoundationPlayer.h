@@ -0,0 +1,108 @@
+#pragma once
+
+#include "ofConstants.h"
+
+#ifdef TARGET_WIN32
+#include "ofBaseTypes.h"
+#include "ofPixels.h"
+#include "ofTexture.h"
+#include <memory>
+
+/// \brief Plays videos with Media Foundation and hardware decoding
+///
+/// Videos are decoded by the graphics card through DXVA into D3D11
+/// textures, Media Foundation converts each frame from the decoder's NV12
+/// to RGB on the GPU. When the driver supports WGL_NV_DX_interop2, which
+/// all current NVIDIA, AMD and Intel drivers do, that D3D texture is
+/// shared with OpenGL as the player's ofTexture, so frames never go
+/// through the CPU and several 4K streams can play at once. Without it
+/// frames are copied back to the pixels and uploaded by ofVideoPlayer.
+///
+/// It's the default player on windows, to use the DirectShow one define
+/// OF_VIDEO_PLAYER_DIRECTSHOW in the project.
+///
+/// Needs windows 8 or later.
+class ofMediaFoundationPlayer: public ofBaseVideoPlayer{
+public:
+	ofMediaFoundationPlayer();
+	~ofMediaFoundationPlayer();
+
+	ofMediaFoundationPlayer(const ofMediaFoundationPlayer&) = delete;
+	ofMediaFoundationPlayer & operator=(const ofMediaFoundationPlayer&) = delete;
+
+	bool load(std::string name);
+	void loadAsync(std::string name);
+	void update();
+	void close();
+
+	void play();
+	void stop();
+
+	bool isFrameNew() const;
+
+	/// \brief Empty when the frames are shared through WGL_NV_DX_interop,
+	/// see isUsingInterop()
+	const ofPixels & getPixels() const;
+	ofPixels & getPixels();
+	ofTexture * getTexturePtr();
+
+	float getWidth() const;
+	float getHeight() const;
+
+	bool isPaused() const;
+	bool isLoaded() const;
+	bool isPlaying() const;
+
+	/// \brief The format of the pixels when they are copied back, RGB,
+	/// RGBA or BGRA, BGRA is the one that doesn't need a conversion
+	bool setPixelFormat(ofPixelFormat pixelFormat);
+	ofPixelFormat getPixelFormat() const;
+
+	float getPosition() const;
+	float getSpeed() const;
+	float getDuration() const;
+	bool getIsMovieDone() const;
+
+	void setPaused(bool bPause);
+	void setPosition(float pct);
+	void setVolume(float volume);
+	void setLoopState(ofLoopType state);
+	void setSpeed(float speed);
+	void setFrame(int frame);
+	void setFrameAsync(int frame, ofVideoSeekMode mode);
+	bool isSeeking() const;
+
+	int getCurrentFrame() const;
+	int getTotalNumFrames() const;
+	ofLoopType getLoopState() const;
+
+	void firstFrame();
+	void nextFrame();
+	void previousFrame();
+
+	/// \brief Whether the decoded frames are shared with OpenGL instead of
+	/// copied to the pixels, only known once the video is loaded
+	bool isUsingInterop() const;
+
+private:
+	struct Engine;
+
+	bool startLoad(const std::string & name);
+	bool setupFrames();
+	void copyFrameToPixels();
+
+	std::unique_ptr<Engine> engine;
+	ofTexture texture;
+	ofPixels pixels;
+	ofPixelFormat pixelFormat;
+	int width, height;
+	double frameRate;
+	float speed;
+	ofLoopType loopState;
+	bool bLoaded;
+	bool bPlaying;
+	bool bPaused;
+	bool bFrameNew;
+	bool bInterop;
+};
+#endif
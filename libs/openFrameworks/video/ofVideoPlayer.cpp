@@ -1,6 +1,7 @@
 #include "ofVideoPlayer.h"
 #include "ofUtils.h"
 #include "ofAppRunner.h"
+#include "ofHapPlayer.h"
 #include <algorithm>
 
 using namespace std;
@@ -10,12 +11,38 @@ ofVideoPlayer::ofVideoPlayer (){
 	bUseTexture			= true;
 	playerTex			= nullptr;
 	internalPixelFormat = OF_PIXELS_RGB;
+	bWaitingForFrame	= false;
+	bDefaultPlayer		= false;
 	tex.resize(1);
 }
 
+//---------------------------------------------------------------------------
+void ofVideoPlayer::initDefaultPlayer(const string & name){
+	if(player && !bDefaultPlayer){
+		return;
+	}
+#ifndef TARGET_NO_THREADS
+	// compressed frames are uploaded as they are, the platform player would
+	// decode them to pixels on the cpu
+	bool isHap = ofHapPlayer::isHapFile(name);
+	if(isHap && !dynamic_pointer_cast<ofHapPlayer>(player)){
+		setPlayer(std::make_shared<ofHapPlayer>());
+	}else if(!isHap && (!player || dynamic_pointer_cast<ofHapPlayer>(player))){
+		setPlayer(std::make_shared<OF_VID_PLAYER_TYPE>());
+	}
+#else
+	if(!player){
+		setPlayer(std::make_shared<OF_VID_PLAYER_TYPE>());
+	}
+#endif
+	player->setPixelFormat(internalPixelFormat);
+	bDefaultPlayer = true;
+}
+
 //---------------------------------------------------------------------------
 void ofVideoPlayer::setPlayer(shared_ptr<ofBaseVideoPlayer> newPlayer){
 	player = newPlayer;
+	bDefaultPlayer = false;
 	setPixelFormat(internalPixelFormat);	//this means that it will try to set the pixel format you have been using before. 
 											//if the format is not supported ofVideoPlayer's internalPixelFormat will be updated to that of the player's
 }
@@ -24,6 +51,7 @@ void ofVideoPlayer::setPlayer(shared_ptr<ofBaseVideoPlayer> newPlayer){
 shared_ptr<ofBaseVideoPlayer> ofVideoPlayer::getPlayer(){
 	if( !player ){
 		setPlayer(std::make_shared<OF_VID_PLAYER_TYPE>());
+		bDefaultPlayer = true;
 	}
 	return player;
 }
@@ -66,10 +94,7 @@ ofPixelFormat ofVideoPlayer::getPixelFormat() const{
 
 //---------------------------------------------------------------------------
 bool ofVideoPlayer::load(string name){
-	if( !player ){
-		setPlayer(std::make_shared<OF_VID_PLAYER_TYPE>());
-		player->setPixelFormat(internalPixelFormat);
-	}
+	initDefaultPlayer(name);
 	
 	bool bOk = player->load(name);
 
@@ -77,6 +102,7 @@ bool ofVideoPlayer::load(string name){
         moviePath = name;
         if(bUseTexture){
         	if(player->getTexturePtr()==nullptr){
+				playerTex = nullptr;
 				if(tex.empty()) {
 					tex.resize(std::max(player->getPixels().getNumPlanes(),static_cast<size_t>(1)));
 					for(std::size_t i=0;i<player->getPixels().getNumPlanes();i++){
@@ -99,10 +125,7 @@ bool ofVideoPlayer::load(string name){
 
 //---------------------------------------------------------------------------
 void ofVideoPlayer::loadAsync(string name){
-	if( !player ){
-		setPlayer(std::make_shared<OF_VID_PLAYER_TYPE>());
-		player->setPixelFormat(internalPixelFormat);
-	}
+	initDefaultPlayer(name);
 	
 	player->loadAsync(name);
 	moviePath = name;
@@ -220,6 +243,12 @@ void ofVideoPlayer::update(){
 				}
 			}
 		}
+
+		if( bWaitingForFrame && !player->isSeeking() ){
+			bWaitingForFrame = false;
+			int frame = player->getCurrentFrame();
+			ofNotifyEvent(frameReadyEvent, frame, this);
+		}
 	}
 }
 
@@ -291,6 +320,22 @@ void ofVideoPlayer::setFrame(int frame){
 	}
 }
 
+//---------------------------------------------------------------------------
+void ofVideoPlayer::setFrameAsync(int frame, ofVideoSeekMode mode){
+	if( player ){
+		player->setFrameAsync(frame, mode);
+		bWaitingForFrame = true;
+	}
+}
+
+//---------------------------------------------------------------------------
+bool ofVideoPlayer::isSeeking() const{
+	if( player ){
+		return player->isSeeking();
+	}
+	return false;
+}
+
 
 //---------------------------------------------------------------------------
 float ofVideoPlayer::getDuration() const{
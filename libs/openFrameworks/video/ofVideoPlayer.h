@@ -4,6 +4,7 @@
 #include "ofTexture.h"
 #include "ofBaseTypes.h"
 #include "ofTypes.h"
+#include "ofEvents.h"
 
 #ifdef OF_VIDEO_PLAYER_GSTREAMER
 	#include "ofGstVideoPlayer.h"
@@ -30,6 +31,11 @@
     #define OF_VID_PLAYER_TYPE ofDirectShowPlayer
 #endif
 
+#ifdef OF_VIDEO_PLAYER_MEDIA_FOUNDATION
+    #include "ofMediaFoundationPlayer.h"
+    #define OF_VID_PLAYER_TYPE ofMediaFoundationPlayer
+#endif
+
 #ifdef OF_VIDEO_PLAYER_IOS
 	#include "ofxiOSVideoPlayer.h"
 	#define OF_VID_PLAYER_TYPE ofxiOSVideoPlayer
@@ -105,6 +111,20 @@ class ofVideoPlayer : public ofBaseVideoPlayer,public ofBaseVideoDraws{
 		ofLoopType			getLoopState() const;
 		void   				setSpeed(float speed);
 		void				setFrame(int frame);
+		/// \brief Seeks to frame without blocking, frameReadyEvent is
+		/// notified from update() once it's decoded
+		///
+		/// Meant for scrubbing: calling it again before the frame is ready
+		/// replaces the previous request instead of queueing it.
+		/// OF_VIDEO_SEEK_KEYFRAME lands on the nearest keyframe, which is
+		/// faster but not exact.
+		void				setFrameAsync(int frame, ofVideoSeekMode mode = OF_VIDEO_SEEK_ACCURATE);
+		/// \brief True until the frame requested with setFrameAsync() is ready
+		bool				isSeeking() const;
+
+		/// \brief Notified from update() with the current frame when a seek
+		/// requested with setFrameAsync() is ready to be drawn
+		ofEvent<int>		frameReadyEvent;
 
 		void 				setUseTexture(bool bUse);
 		bool 				isUsingTexture() const;
@@ -207,8 +227,12 @@ class ofVideoPlayer : public ofBaseVideoPlayer,public ofBaseVideoDraws{
 		}
 
 	private:
-		/// \brief Initialize the default player implementations.
-		void initDefaultPlayer();
+		/// \brief Initialize the default player implementation for name,
+		/// ofHapPlayer for HAP movies, OF_VID_PLAYER_TYPE for anything else,
+		/// unless a player was set with setPlayer().
+		void initDefaultPlayer(const std::string & name);
+		/// \brief True if the player wasn't set with setPlayer().
+		bool bDefaultPlayer;
 		/// \brief A pointer to the internal video player implementation.
 		std::shared_ptr<ofBaseVideoPlayer>		player;
 		/// \brief A collection of texture planes used by the video player.
@@ -226,4 +250,6 @@ class ofVideoPlayer : public ofBaseVideoPlayer,public ofBaseVideoDraws{
 		mutable ofPixelFormat internalPixelFormat;
 		/// \brief The stored path to the video's path.
 		std::string moviePath;
+		/// \brief True while waiting for a setFrameAsync() frame.
+		bool bWaitingForFrame;
 };
@@ -0,0 +1,148 @@
+#include "ofVideoPlayerPool.h"
+#include "ofLog.h"
+#include <algorithm>
+
+using namespace std;
+
+//----------------------------------------------------------
+ofVideoPlayerPool::ofVideoPlayerPool()
+:maxPlayers(4)
+,useCount(0){
+	updateListener = ofEvents().update.newListener(this, &ofVideoPlayerPool::update, OF_EVENT_ORDER_BEFORE_APP);
+}
+
+//----------------------------------------------------------
+void ofVideoPlayerPool::setMaxPlayers(std::size_t maxPlayers){
+	this->maxPlayers = std::max<std::size_t>(maxPlayers, 1);
+	trim();
+}
+
+//----------------------------------------------------------
+std::size_t ofVideoPlayerPool::getMaxPlayers() const{
+	return maxPlayers;
+}
+
+//----------------------------------------------------------
+ofVideoPlayerPool::Clip * ofVideoPlayerPool::find(const string & path){
+	auto it = std::find_if(clips.begin(), clips.end(), [&](const Clip & clip){
+		return clip.path == path;
+	});
+	return it == clips.end() ? nullptr : &*it;
+}
+
+//----------------------------------------------------------
+const ofVideoPlayerPool::Clip * ofVideoPlayerPool::find(const string & path) const{
+	auto it = std::find_if(clips.begin(), clips.end(), [&](const Clip & clip){
+		return clip.path == path;
+	});
+	return it == clips.end() ? nullptr : &*it;
+}
+
+//----------------------------------------------------------
+ofVideoPlayerPool::Clip * ofVideoPlayerPool::getIdleClip(){
+	Clip * oldest = nullptr;
+	for(auto & clip: clips){
+		if(clip.player.use_count() == 1 && (!oldest || clip.lastUsed < oldest->lastUsed)){
+			oldest = &clip;
+		}
+	}
+	return oldest;
+}
+
+//----------------------------------------------------------
+void ofVideoPlayerPool::trim(){
+	while(clips.size() > maxPlayers){
+		auto clip = getIdleClip();
+		if(!clip) break;
+		clip->player->close();
+		clips.erase(clips.begin() + (clip - clips.data()));
+	}
+}
+
+//----------------------------------------------------------
+bool ofVideoPlayerPool::preload(const string & path){
+	auto clip = find(path);
+	if(clip){
+		clip->lastUsed = ++useCount;
+		return true;
+	}
+
+	if(clips.size() < maxPlayers){
+		clips.emplace_back();
+		clip = &clips.back();
+		clip->player = make_shared<ofVideoPlayer>();
+	}else{
+		clip = getIdleClip();
+		if(!clip){
+			ofLogWarning("ofVideoPlayerPool") << "preload(): all the " << maxPlayers << " players are in use, can't load \"" << path << "\"";
+			return false;
+		}
+	}
+	clip->path = path;
+	clip->lastUsed = ++useCount;
+	clip->bInUse = false;
+	clip->player->loadAsync(path);
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofVideoPlayerPool::isReady(const string & path) const{
+	auto clip = find(path);
+	return clip && clip->player->isLoaded() && clip->player->getTexture().isAllocated();
+}
+
+//----------------------------------------------------------
+shared_ptr<ofVideoPlayer> ofVideoPlayerPool::play(const string & path){
+	if(!preload(path)){
+		return nullptr;
+	}
+	auto clip = find(path);
+	if(clip->bInUse){
+		ofLogWarning("ofVideoPlayerPool") << "play(): \"" << path << "\" is already playing";
+		return clip->player;
+	}
+	clip->bInUse = true;
+	clip->player->play();
+	return clip->player;
+}
+
+//----------------------------------------------------------
+void ofVideoPlayerPool::unload(const string & path){
+	auto clip = find(path);
+	if(!clip) return;
+	if(clip->player.use_count() > 1){
+		ofLogWarning("ofVideoPlayerPool") << "unload(): \"" << path << "\" is in use";
+		return;
+	}
+	clip->player->close();
+	clips.erase(clips.begin() + (clip - clips.data()));
+}
+
+//----------------------------------------------------------
+void ofVideoPlayerPool::clear(){
+	auto maxPlayers = this->maxPlayers;
+	this->maxPlayers = 0;
+	trim();
+	this->maxPlayers = maxPlayers;
+}
+
+//----------------------------------------------------------
+std::size_t ofVideoPlayerPool::getNumPlayers() const{
+	return clips.size();
+}
+
+//----------------------------------------------------------
+void ofVideoPlayerPool::update(ofEventArgs &){
+	for(auto & clip: clips){
+		// released by the app, rewind it while it's not needed so it's
+		// ready to play again
+		if(clip.bInUse && clip.player.use_count() == 1){
+			clip.bInUse = false;
+			clip.player->setPaused(true);
+			if(clip.player->isLoaded()){
+				clip.player->setFrameAsync(0);
+			}
+		}
+		clip.player->update();
+	}
+}
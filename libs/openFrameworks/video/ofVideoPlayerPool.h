@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ofVideoPlayer.h"
+#include "ofEvents.h"
+#include <memory>
+
+/// \brief Keeps upcoming clips loaded so they start playing instantly
+///
+/// Loading a movie takes from some to hundreds of milliseconds while the
+/// backend builds and prerolls its pipeline. The pool loads clips in the
+/// background with ofVideoPlayer::loadAsync() before they are needed and
+/// keeps them paused on their first frame, already in a texture, so play()
+/// only has to unpause them:
+///
+/// ~~~~{.cpp}
+/// // ofApp::setup()
+/// pool.setMaxPlayers(3);
+/// pool.preload("intro.mov");
+/// pool.preload("loop.mov");
+///
+/// // on the cue
+/// current = pool.play("intro.mov");
+/// pool.preload("outro.mov");
+///
+/// // ofApp::draw()
+/// if(current) current->draw(0, 0);
+/// ~~~~
+///
+/// A player is in use while the app holds the pointer returned by play(),
+/// once it's released the player pauses and goes back to its first frame,
+/// ready to be played again. When all the players are loaded preload()
+/// reuses the one that was used the longest time ago and isn't in use,
+/// which with most backends also reuses its pipeline.
+///
+/// The pool updates all its players before ofApp::update(), don't call
+/// update() on them.
+class ofVideoPlayerPool{
+public:
+	ofVideoPlayerPool();
+
+	ofVideoPlayerPool(const ofVideoPlayerPool &) = delete;
+	ofVideoPlayerPool & operator=(const ofVideoPlayerPool &) = delete;
+
+	/// \brief Maximum number of players, in use or not, 4 by default
+	void setMaxPlayers(std::size_t maxPlayers);
+	std::size_t getMaxPlayers() const;
+
+	/// \brief Starts loading path in the background if it isn't already
+	/// \returns false if all the players are in use
+	bool preload(const std::string & path);
+
+	/// \brief Whether path is loaded and its first frame is in a texture
+	bool isReady(const std::string & path) const;
+
+	/// \brief Starts playing path, instantly if it was preloaded or
+	/// as soon as it loads otherwise
+	/// \returns the player, which stays in use while the pointer is
+	/// held, or nullptr if all the players are in use
+	std::shared_ptr<ofVideoPlayer> play(const std::string & path);
+
+	/// \brief Closes path and frees its player, if it isn't in use
+	void unload(const std::string & path);
+
+	/// \brief Closes all the players not in use
+	void clear();
+
+	std::size_t getNumPlayers() const;
+
+private:
+	struct Clip{
+		std::string path;
+		std::shared_ptr<ofVideoPlayer> player;
+		uint64_t lastUsed = 0;
+		bool bInUse = false;
+	};
+
+	void update(ofEventArgs &);
+	Clip * find(const std::string & path);
+	const Clip * find(const std::string & path) const;
+	Clip * getIdleClip();
+	void trim();
+
+	std::vector<Clip> clips;
+	std::size_t maxPlayers;
+	uint64_t useCount;
+	ofEventListener updateListener;
+};
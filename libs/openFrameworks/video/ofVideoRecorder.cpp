@@ -0,0 +1,364 @@
+#include "ofVideoRecorder.h"
+
+#if defined(OF_VIDEO_PLAYER_GSTREAMER) && !defined(TARGET_OPENGLES)
+#include "ofGstUtils.h"
+#include "ofFbo.h"
+#include "ofTexture.h"
+#include "ofFileUtils.h"
+#include "ofUtils.h"
+#include "ofLog.h"
+#include "ofMetrics.h"
+#include <gst/app/gstappsrc.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+namespace{
+	struct Encoder{
+		const char * name;
+		bool hardware;
+		const char * options;
+	};
+
+	// in order of preference, all of them take the bitrate in kbit/s
+	const Encoder h264Encoders[] = {
+		{"nvh264enc", true, ""},
+		{"vah264enc", true, " rate-control=cbr"},
+		{"vaapih264enc", true, " rate-control=cbr"},
+		{"vtenc_h264_hw", true, ""},
+		{"x264enc", false, " speed-preset=superfast"},
+	};
+
+	const Encoder h265Encoders[] = {
+		{"nvh265enc", true, ""},
+		{"vah265enc", true, " rate-control=cbr"},
+		{"vaapih265enc", true, " rate-control=cbr"},
+		{"vtenc_h265_hw", true, ""},
+		{"x265enc", false, " speed-preset=superfast"},
+	};
+
+	bool hasElement(const string & name){
+		GstElementFactory * factory = gst_element_factory_find(name.c_str());
+		if(factory){
+			gst_object_unref(factory);
+			return true;
+		}
+		return false;
+	}
+
+	const Encoder * findKnownEncoder(const string & encoderName){
+		for(auto & encoder: h264Encoders){
+			if(encoderName == encoder.name) return &encoder;
+		}
+		for(auto & encoder: h265Encoders){
+			if(encoderName == encoder.name) return &encoder;
+		}
+		return nullptr;
+	}
+
+	string getMuxer(const string & path){
+		auto ext = ofToLower(ofFilePath::getFileExt(path));
+		if(ext == "mov"){
+			return "qtmux";
+		}else if(ext == "mkv"){
+			return "matroskamux";
+		}else{
+			return "mp4mux";
+		}
+	}
+}
+
+//----------------------------------------------------------
+ofVideoRecorder::ofVideoRecorder()
+:bHardwareEncoder(false)
+,bSetup(false)
+,bError(false)
+,appsrc(nullptr)
+,width(0)
+,height(0)
+,numChannels(0)
+,frameBytes(0)
+,numFramesAdded(0)
+,numFramesRecorded(0)
+,numFramesDropped(0){
+}
+
+//----------------------------------------------------------
+ofVideoRecorder::~ofVideoRecorder(){
+	close();
+}
+
+//----------------------------------------------------------
+string ofVideoRecorder::findEncoder(ofVideoRecorderCodec codec, bool allowSoftware, bool & hardware){
+	const Encoder * begin = codec == OF_VIDEO_CODEC_HEVC ? std::begin(h265Encoders) : std::begin(h264Encoders);
+	const Encoder * end = codec == OF_VIDEO_CODEC_HEVC ? std::end(h265Encoders) : std::end(h264Encoders);
+	for(auto encoder = begin; encoder != end; ++encoder){
+		if((encoder->hardware || allowSoftware) && hasElement(encoder->name)){
+			hardware = encoder->hardware;
+			return encoder->name;
+		}
+	}
+	return "";
+}
+
+//----------------------------------------------------------
+bool ofVideoRecorder::setup(const ofVideoRecorderSettings & settings){
+	close();
+	if(settings.path.empty() || settings.fps <= 0){
+		ofLogError("ofVideoRecorder") << "setup(): needs a path and a positive fps";
+		return false;
+	}
+
+	// creating the utils initializes gstreamer
+	gstUtils.reset(new ofGstUtils);
+	if(!settings.encoder.empty()){
+		if(!hasElement(settings.encoder)){
+			ofLogError("ofVideoRecorder") << "setup(): couldn't find encoder " << settings.encoder;
+			gstUtils.reset();
+			return false;
+		}
+		encoderName = settings.encoder;
+		auto known = findKnownEncoder(encoderName);
+		bHardwareEncoder = known && known->hardware;
+	}else{
+		encoderName = findEncoder(settings.codec, settings.allowSoftwareEncoder, bHardwareEncoder);
+		if(encoderName.empty()){
+			ofLogError("ofVideoRecorder") << "setup(): couldn't find a" << (settings.allowSoftwareEncoder ? "n" : " hardware")
+				<< " encoder for " << (settings.codec == OF_VIDEO_CODEC_HEVC ? "HEVC" : "H.264");
+			gstUtils.reset();
+			return false;
+		}
+		if(!bHardwareEncoder){
+			ofLogWarning("ofVideoRecorder") << "setup(): no hardware encoder found, using " << encoderName;
+		}
+	}
+	ofLogVerbose("ofVideoRecorder") << "setup(): encoding with " << encoderName;
+
+	this->settings = settings;
+	readback.setNumBuffers(std::max<std::size_t>(settings.numReadbackBuffers, 1));
+	numFramesAdded = 0;
+	numFramesRecorded = 0;
+	numFramesDropped = 0;
+	bError = false;
+	bSetup = true;
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofVideoRecorder::startPipeline(int w, int h, int channels){
+	string format;
+	switch(channels){
+	case 1: format = "GRAY8"; break;
+	case 3: format = "RGB"; break;
+	case 4: format = "RGBA"; break;
+	default:
+		ofLogError("ofVideoRecorder") << "addFrame(): can't record frames with " << channels << " channels";
+		return false;
+	}
+
+	auto known = findKnownEncoder(encoderName);
+	auto parser = settings.codec == OF_VIDEO_CODEC_HEVC ? "h265parse" : "h264parse";
+	string pipeline = "appsrc name=ofvideorecordersrc format=time block=false"
+		" ! videoconvert ! queue ! " + encoderName + " bitrate=" + ofToString(settings.bitrate) + (known ? known->options : "") +
+		" ! " + parser + " ! " + getMuxer(settings.path) + " ! filesink name=ofvideorecordersink";
+
+	// as a stream startPipeline() doesn't wait for a preroll that would
+	// only happen once the first frame arrives
+	if(!gstUtils->setPipelineWithSink(pipeline, "", true)){
+		return false;
+	}
+	GstElement * filesink = gstUtils->getGstElementByName("ofvideorecordersink");
+	g_object_set(G_OBJECT(filesink), "location", settings.path.c_str(), (void*)NULL);
+	gst_object_unref(filesink);
+
+	width = w;
+	height = h;
+	numChannels = channels;
+	frameBytes = std::size_t(w) * h * channels;
+
+	int fpsN, fpsD;
+	gst_util_double_to_fraction(settings.fps, &fpsN, &fpsD);
+	appsrc = gstUtils->getGstElementByName("ofvideorecordersrc");
+	GstCaps * caps = gst_caps_new_simple("video/x-raw",
+		"format", G_TYPE_STRING, format.c_str(),
+		"width", G_TYPE_INT, w,
+		"height", G_TYPE_INT, h,
+		"framerate", GST_TYPE_FRACTION, fpsN, fpsD,
+		(void*)NULL);
+	gst_app_src_set_caps(GST_APP_SRC(appsrc), caps);
+	gst_caps_unref(caps);
+	gst_app_src_set_max_bytes(GST_APP_SRC(appsrc), std::max<std::size_t>(settings.maxQueuedFrames, 1) * frameBytes);
+
+	if(!gstUtils->startPipeline()){
+		return false;
+	}
+	gst_element_set_state(gstUtils->getPipeline(), GST_STATE_PLAYING);
+	return true;
+}
+
+//----------------------------------------------------------
+void ofVideoRecorder::pushFrame(const void * data, uint64_t frameNum){
+	int fpsN, fpsD;
+	gst_util_double_to_fraction(settings.fps, &fpsN, &fpsD);
+	GstBuffer * buffer = gst_buffer_new_allocate(NULL, frameBytes, NULL);
+	gst_buffer_fill(buffer, 0, data, frameBytes);
+	GST_BUFFER_PTS(buffer) = gst_util_uint64_scale(frameNum, GST_SECOND * fpsD, fpsN);
+	GST_BUFFER_DURATION(buffer) = gst_util_uint64_scale(GST_SECOND, fpsD, fpsN);
+	gst_app_src_push_buffer(GST_APP_SRC(appsrc), buffer);
+}
+
+//----------------------------------------------------------
+void ofVideoRecorder::collectFrames(bool wait){
+	while(readback.getNumPending()){
+		if(!readback.isFrameReady()){
+			if(!wait) break;
+			glFinish();
+			continue;
+		}
+		auto frameNum = pendingFrameNums.front();
+		pendingFrameNums.pop();
+
+		auto w = readback.getFrameWidth();
+		auto h = readback.getFrameHeight();
+		auto channels = readback.getFrameNumChannels();
+		if(!appsrc && !bError){
+			if(readback.getFrameBytesPerChannel() != 1){
+				ofLogError("ofVideoRecorder") << "addFrame(): can only record 8 bit textures";
+				bError = true;
+			}else if(!startPipeline(w, h, channels)){
+				ofLogError("ofVideoRecorder") << "addFrame(): couldn't start the recording";
+				bError = true;
+			}
+		}
+
+		auto data = readback.mapFrame();
+		if(!data){
+			break;
+		}
+		if(bError){
+			frameDropped();
+		}else if(w != width || h != height || channels != numChannels){
+			ofLogWarning("ofVideoRecorder") << "addFrame(): frame is " << w << "x" << h << " with " << channels
+				<< " channels but the video " << width << "x" << height << " with " << numChannels << ", dropping it";
+			frameDropped();
+		}else if(getNumQueuedFrames() >= settings.maxQueuedFrames){
+			frameDropped();
+		}else{
+			pushFrame(data, frameNum);
+			numFramesRecorded++;
+		}
+		readback.unmapFrame();
+	}
+}
+
+//----------------------------------------------------------
+bool ofVideoRecorder::addFrame(const ofFbo & fbo, int attachmentPoint){
+	if(!bSetup){
+		ofLogError("ofVideoRecorder") << "addFrame(): call setup() first";
+		return false;
+	}
+	collectFrames(false);
+	auto frameNum = numFramesAdded++;
+	if(!bError && readback.read(fbo, attachmentPoint)){
+		pendingFrameNums.push(frameNum);
+		return true;
+	}
+	frameDropped();
+	return false;
+}
+
+//----------------------------------------------------------
+bool ofVideoRecorder::addFrame(const ofTexture & texture){
+	if(!bSetup){
+		ofLogError("ofVideoRecorder") << "addFrame(): call setup() first";
+		return false;
+	}
+	collectFrames(false);
+	auto frameNum = numFramesAdded++;
+	if(!bError && readback.read(texture)){
+		pendingFrameNums.push(frameNum);
+		return true;
+	}
+	frameDropped();
+	return false;
+}
+
+//----------------------------------------------------------
+void ofVideoRecorder::close(){
+	if(!bSetup) return;
+	collectFrames(true);
+	readback.clear();
+	pendingFrameNums = std::queue<uint64_t>();
+
+	if(appsrc){
+		// the muxer only writes the file's index once it gets the end of
+		// the stream, after the encoder is done with all the queued frames
+		gst_app_src_end_of_stream(GST_APP_SRC(appsrc));
+		auto start = std::chrono::steady_clock::now();
+		while(!gstUtils->getIsMovieDone()){
+			if(std::chrono::steady_clock::now() - start > std::chrono::seconds(10)){
+				ofLogWarning("ofVideoRecorder") << "close(): the encoder didn't finish in 10s, " << settings.path << " might be incomplete";
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		gst_object_unref(appsrc);
+		appsrc = nullptr;
+	}
+	gstUtils.reset();
+
+	ofLogVerbose("ofVideoRecorder") << "close(): recorded " << numFramesRecorded << " of " << numFramesAdded
+		<< " frames to " << settings.path << ", " << numFramesDropped << " dropped";
+	width = 0;
+	height = 0;
+	numChannels = 0;
+	frameBytes = 0;
+	bSetup = false;
+}
+
+//----------------------------------------------------------
+bool ofVideoRecorder::isRecording() const{
+	return bSetup && !bError;
+}
+
+//----------------------------------------------------------
+string ofVideoRecorder::getEncoderName() const{
+	return encoderName;
+}
+
+//----------------------------------------------------------
+bool ofVideoRecorder::isHardwareEncoder() const{
+	return bHardwareEncoder;
+}
+
+//----------------------------------------------------------
+uint64_t ofVideoRecorder::getNumFramesAdded() const{
+	return numFramesAdded;
+}
+
+//----------------------------------------------------------
+uint64_t ofVideoRecorder::getNumFramesRecorded() const{
+	return numFramesRecorded;
+}
+
+//----------------------------------------------------------
+void ofVideoRecorder::frameDropped(){
+	static ofMetricCounter & dropped = ofGetMetrics().getCounter("of_video_recorder_dropped_frames_total", "Frames ofVideoRecorder couldn't encode");
+	numFramesDropped++;
+	dropped.add();
+}
+
+//----------------------------------------------------------
+uint64_t ofVideoRecorder::getNumFramesDropped() const{
+	return numFramesDropped;
+}
+
+//----------------------------------------------------------
+std::size_t ofVideoRecorder::getNumQueuedFrames() const{
+	if(!appsrc || !frameBytes) return 0;
+	return gst_app_src_get_current_level_bytes(GST_APP_SRC(appsrc)) / frameBytes;
+}
+
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "ofConstants.h"
+
+#if defined(OF_VIDEO_PLAYER_GSTREAMER) && !defined(TARGET_OPENGLES)
+#include "ofPixelReadback.h"
+#include <memory>
+#include <queue>
+
+class ofFbo;
+class ofTexture;
+class ofGstUtils;
+typedef struct _GstElement GstElement;
+
+enum ofVideoRecorderCodec{
+	OF_VIDEO_CODEC_H264,
+	OF_VIDEO_CODEC_HEVC,
+};
+
+struct ofVideoRecorderSettings{
+	/// \brief The file to write, .mp4, .mov or .mkv
+	std::string path;
+
+	/// \brief Frames per second the video is encoded at, every frame
+	/// added advances the video 1/fps even if it was dropped
+	float fps = 60;
+
+	ofVideoRecorderCodec codec = OF_VIDEO_CODEC_H264;
+
+	/// \brief Bitrate of the encoded video in kbit/s
+	int bitrate = 20000;
+
+	/// \brief Use the software encoder if there's no hardware one, if
+	/// false setup() fails instead
+	bool allowSoftwareEncoder = true;
+
+	/// \brief Name of a gstreamer element to use as encoder instead of
+	/// looking for one, it has to have a bitrate property in kbit/s
+	std::string encoder;
+
+	/// \brief Frames that can wait to be encoded before new ones are
+	/// dropped
+	std::size_t maxQueuedFrames = 8;
+
+	/// \brief Frames that can be reading back from the GPU at once
+	std::size_t numReadbackBuffers = 3;
+};
+
+/// \brief Records fbos or textures to a video file
+///
+/// Frames are read back from the GPU asynchronously with an
+/// ofPixelReadback, so addFrame() never waits for the GPU, and are passed
+/// to a gstreamer pipeline that converts, encodes and muxes them in its own
+/// threads. A hardware H.264 or HEVC encoder is used when there's one,
+/// NVENC, VA-API or VideoToolbox, the software x264 or x265 otherwise:
+///
+/// ~~~~{.cpp}
+/// // ofApp::setup()
+/// ofVideoRecorderSettings settings;
+/// settings.path = ofToDataPath("capture.mp4");
+/// settings.fps = 60;
+/// recorder.setup(settings);
+///
+/// // ofApp::draw()
+/// fbo.begin();
+/// // draw the scene
+/// fbo.end();
+/// fbo.draw(0, 0);
+/// recorder.addFrame(fbo);
+///
+/// // ofApp::exit()
+/// recorder.close();
+/// ~~~~
+///
+/// If the encoder can't keep up frames wait in a queue of up to
+/// maxQueuedFrames, once it's full new frames are dropped instead of
+/// slowing down the app, getNumFramesDropped() tells how many.
+class ofVideoRecorder{
+public:
+	ofVideoRecorder();
+	~ofVideoRecorder();
+
+	ofVideoRecorder(const ofVideoRecorder &) = delete;
+	ofVideoRecorder & operator=(const ofVideoRecorder &) = delete;
+
+	/// \brief Chooses the encoder and prepares the recording, the
+	/// pipeline starts with the first frame, once its size is known
+	/// \returns false if there's no encoder for the codec
+	bool setup(const ofVideoRecorderSettings & settings);
+
+	/// \brief Starts reading the fbo back to add it to the video
+	///
+	/// All the frames have to be the same size, and 8 bits RGB, RGBA or
+	/// luminance.
+	///
+	/// \returns false if the frame was dropped
+	bool addFrame(const ofFbo & fbo, int attachmentPoint = 0);
+	bool addFrame(const ofTexture & texture);
+
+	/// \brief Encodes the frames still pending and finishes the file,
+	/// blocks until it's written
+	void close();
+
+	bool isRecording() const;
+
+	/// \brief Name of the gstreamer element encoding the video
+	std::string getEncoderName() const;
+	bool isHardwareEncoder() const;
+
+	/// \brief Frames passed to addFrame() since setup()
+	uint64_t getNumFramesAdded() const;
+
+	/// \brief Frames passed to the encoder
+	uint64_t getNumFramesRecorded() const;
+
+	/// \brief Frames dropped because all the readback buffers were in
+	/// use or the encoder queue was full
+	uint64_t getNumFramesDropped() const;
+
+	/// \brief Frames waiting to be encoded
+	std::size_t getNumQueuedFrames() const;
+
+private:
+	void collectFrames(bool wait);
+	bool startPipeline(int width, int height, int numChannels);
+	void pushFrame(const void * data, uint64_t frameNum);
+	void frameDropped();
+	static std::string findEncoder(ofVideoRecorderCodec codec, bool allowSoftware, bool & hardware);
+
+	ofVideoRecorderSettings settings;
+	std::string encoderName;
+	bool bHardwareEncoder;
+	bool bSetup;
+	bool bError;
+
+	ofPixelReadback readback;
+	std::queue<uint64_t> pendingFrameNums;
+	std::unique_ptr<ofGstUtils> gstUtils;
+	GstElement * appsrc;
+	int width, height, numChannels;
+	std::size_t frameBytes;
+
+	uint64_t numFramesAdded;
+	uint64_t numFramesRecorded;
+	uint64_t numFramesDropped;
+};
+#endif
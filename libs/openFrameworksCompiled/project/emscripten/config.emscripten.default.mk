@@ -14,11 +14,40 @@
 #   ifdefs within the openFrameworks core source code.
 ################################################################################
 
+# Optional build modes, set them in the project's config.make or in the
+# command line, the core library is built separately for each combination:
+#
+#   EMSCRIPTEN_THREADS=1 builds with -pthread, ofThread, ofTaskPool and the
+#       rest of the threaded classes run in web workers sharing the memory
+#       through a SharedArrayBuffer. The page has to be served with the
+#       Cross-Origin-Opener-Policy: same-origin and
+#       Cross-Origin-Embedder-Policy: require-corp headers
+#
+#   EMSCRIPTEN_SIMD=1 builds with -msimd128, the SSE code paths of the
+#       core (pixels, sound buffers, math batches...) are compiled to
+#       WebAssembly SIMD instructions
+#
+#   e.g: emmake make EMSCRIPTEN_THREADS=1 EMSCRIPTEN_SIMD=1
+export EMSCRIPTEN_THREADS
+export EMSCRIPTEN_SIMD
+
+PLATFORM_EMSCRIPTEN_LIB_SUFFIX =
+ifeq ($(EMSCRIPTEN_THREADS),1)
+	PLATFORM_EMSCRIPTEN_LIB_SUFFIX := $(PLATFORM_EMSCRIPTEN_LIB_SUFFIX)Threads
+endif
+ifeq ($(EMSCRIPTEN_SIMD),1)
+	PLATFORM_EMSCRIPTEN_LIB_SUFFIX := $(PLATFORM_EMSCRIPTEN_LIB_SUFFIX)Simd
+endif
+ifneq ($(PLATFORM_EMSCRIPTEN_LIB_SUFFIX),)
+	# keeps the objects of each mode apart, they can't be linked together
+	ABI = wasm$(PLATFORM_EMSCRIPTEN_LIB_SUFFIX)
+endif
+
 PLATFORM_PROJECT_RELEASE_TARGET = bin/$(BIN_NAME).html
 PLATFORM_PROJECT_DEBUG_TARGET = bin/$(BIN_NAME).html
 BYTECODECORE=1
-PLATFORM_CORELIB_DEBUG_TARGET = $(OF_CORE_LIB_PATH)/libopenFrameworksDebug.bc
-PLATFORM_CORELIB_RELEASE_TARGET = $(OF_CORE_LIB_PATH)/libopenFrameworks.bc
+PLATFORM_CORELIB_DEBUG_TARGET = $(OF_CORE_LIB_PATH)/libopenFrameworks$(PLATFORM_EMSCRIPTEN_LIB_SUFFIX)Debug.bc
+PLATFORM_CORELIB_RELEASE_TARGET = $(OF_CORE_LIB_PATH)/libopenFrameworks$(PLATFORM_EMSCRIPTEN_LIB_SUFFIX).bc
 
 ################################################################################
 # PLATFORM DEFINES
@@ -66,6 +95,14 @@ PLATFORM_REQUIRED_ADDONS = ofxEmscripten
 # Code Generation Option Flags (http://gcc.gnu.org/onlinedocs/gcc/Code-Gen-Options.html)
 PLATFORM_CFLAGS = -Wall -std=c++14 -Wno-warn-absolute-paths
 
+ifeq ($(EMSCRIPTEN_THREADS),1)
+	PLATFORM_CFLAGS += -pthread
+endif
+
+ifeq ($(EMSCRIPTEN_SIMD),1)
+	# emscripten implements the SSE intrinsics with WebAssembly SIMD
+	PLATFORM_CFLAGS += -msimd128 -msse -msse2
+endif
 
 ################################################################################
 # PLATFORM LDFLAGS
@@ -82,8 +119,30 @@ else
 endif
 
 PLATFORM_LDFLAGS = -Wl,--as-needed -Wl,--gc-sections --preload-file bin/data@data --emrun
+# links the WebGL 2 functions, the context is WebGL 2 only if the app asks
+# for glesVersion 3 and the browser supports it
+PLATFORM_LDFLAGS += -s MAX_WEBGL_VERSION=2
 PLATFORM_LDFLAGS += --js-library $(OF_ADDONS_PATH)/ofxEmscripten/libs/html5video/lib/emscripten/library_html5video.js
 PLATFORM_LDFLAGS += --js-library $(OF_ADDONS_PATH)/ofxEmscripten/libs/html5audio/lib/emscripten/library_html5audio.js
+PLATFORM_LDFLAGS += --js-library $(OF_ADDONS_PATH)/ofxEmscripten/libs/html5fetch/lib/emscripten/library_html5fetch.js
+
+ifdef PROJECT_EMSCRIPTEN_PTHREAD_POOL_SIZE
+	PLATFORM_EMSCRIPTEN_PTHREAD_POOL_SIZE=$(PROJECT_EMSCRIPTEN_PTHREAD_POOL_SIZE)
+else
+	# the task pool starts one thread per core, the rest is for ofThreads,
+	# the logger and the file io threads
+	PLATFORM_EMSCRIPTEN_PTHREAD_POOL_SIZE=navigator.hardwareConcurrency+4
+endif
+
+ifeq ($(EMSCRIPTEN_THREADS),1)
+	# the workers are created before main() runs, threads started from the
+	# main loop would otherwise wait for it to return to the browser
+	PLATFORM_LDFLAGS += -pthread -s PTHREAD_POOL_SIZE=$(PLATFORM_EMSCRIPTEN_PTHREAD_POOL_SIZE)
+endif
+
+ifeq ($(EMSCRIPTEN_SIMD),1)
+	PLATFORM_LDFLAGS += -msimd128
+endif
 
 ifdef PROJECT_EMSCRIPTEN_TEMPLATE
 	PLATFORM_LDFLAGS += --shell-file $(PROJECT_EMSCRIPTEN_TEMPLATE)
@@ -145,6 +204,7 @@ PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/video/ofDirectShowPla
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/video/ofGstUtils.cpp
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/video/ofGstVideoGrabber.cpp
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/video/ofGstVideoPlayer.cpp
+PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/video/ofCaptureManager.cpp
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/communication/%.cpp
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/sound/ofFmodSoundPlayer.cpp
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/sound/ofOpenALSoundPlayer.cpp
@@ -154,8 +214,10 @@ PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/app/ofAppGLFWWindow.c
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/app/ofAppEGLWindow.cpp
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/graphics/ofCairoRenderer.cpp
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/gl/ofGLRenderer.cpp
-PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/utils/ofThread.cpp
-PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/utils/ofThreadChannel.cpp
+ifneq ($(EMSCRIPTEN_THREADS),1)
+	PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/utils/ofThread.cpp
+	PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/openFrameworks/utils/ofThreadChannel.cpp
+endif
 
 # third party
 PLATFORM_CORE_EXCLUSIONS += $(OF_LIBS_PATH)/glew/%
@@ -93,6 +93,12 @@ ifdef USE_GST_GL
 	PLATFORM_DEFINES += OF_USE_GST_GL
 endif
 
+# add OF_USE_KMS if requested, ofAppEGLWindow can then output straight
+# to the display through DRM/KMS with OF_APP_WINDOW_KMS
+ifdef USE_KMS
+	PLATFORM_DEFINES += OF_USE_KMS
+endif
+
 
 ################################################################################
 # PLATFORM REQUIRED ADDON
@@ -314,6 +320,8 @@ PLATFORM_LIBRARIES += boost_filesystem
 PLATFORM_LIBRARIES += boost_system
 PLATFORM_LIBRARIES += pugixml
 PLATFORM_LIBRARIES += uriparser
+# shm_open for ofSharedMemory
+PLATFORM_LIBRARIES += rt
 
 #static libraries (fully qualified paths)
 PLATFORM_STATIC_LIBRARIES =
@@ -330,6 +338,7 @@ PLATFORM_PKG_CONFIG_LIBRARIES += gstreamer-app-$(GST_VERSION)
 PLATFORM_PKG_CONFIG_LIBRARIES += gstreamer-$(GST_VERSION)
 PLATFORM_PKG_CONFIG_LIBRARIES += gstreamer-video-$(GST_VERSION)
 PLATFORM_PKG_CONFIG_LIBRARIES += gstreamer-base-$(GST_VERSION)
+PLATFORM_PKG_CONFIG_LIBRARIES += gstreamer-net-$(GST_VERSION)
 PLATFORM_PKG_CONFIG_LIBRARIES += libudev
 PLATFORM_PKG_CONFIG_LIBRARIES += freetype2
 PLATFORM_PKG_CONFIG_LIBRARIES += fontconfig
@@ -378,6 +387,12 @@ ifdef USE_GST_GL
 	PLATFORM_PKG_CONFIG_LIBRARIES += gstreamer-gl-$(GST_VERSION)
 endif
 
+# conditionally add drm and gbm
+ifdef USE_KMS
+	PLATFORM_PKG_CONFIG_LIBRARIES += libdrm
+	PLATFORM_PKG_CONFIG_LIBRARIES += gbm
+endif
+
 ################################################################################
 # PLATFORM LIBRARY SEARCH PATHS
 #   These are library search paths that are platform specific and are specified
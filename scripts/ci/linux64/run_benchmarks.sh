@@ -0,0 +1,21 @@
+#!/bin/bash
+set -ev
+ROOT=${TRAVIS_BUILD_DIR:-"$( cd "$(dirname "$0")/../../.." ; pwd -P )"}
+
+echo "**** Running benchmarks ****"
+cd $ROOT/tests/benchmarks
+for benchmark in *; do
+	if [ -d $benchmark ]; then
+		cd $benchmark
+		cp ../../../scripts/templates/linux/Makefile .
+		cp ../../../scripts/templates/linux/config.make .
+		make Release
+		cd bin
+		./${benchmark} ${1:-results.json}
+		errorcode=$?
+		if [[ $errorcode -ne 0 ]]; then
+			exit $errorcode
+		fi
+		cd $ROOT/tests/benchmarks
+	fi
+done
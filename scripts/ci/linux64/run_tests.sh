@@ -5,7 +5,8 @@ ROOT=${TRAVIS_BUILD_DIR:-"$( cd "$(dirname "$0")/../../.." ; pwd -P )"}
 echo "**** Running unit tests ****"
 cd $ROOT/tests
 for group in *; do
-	if [ -d $group ]; then
+	# benchmarks are run from run_benchmarks.sh in release
+	if [ -d $group ] && [ "$group" != "benchmarks" ]; then
 		for test in $group/*; do
 			if [ -d $test ]; then
 				cd $test
@@ -0,0 +1,300 @@
+#include "ofMain.h"
+#include "ofAppGLFWWindow.h"
+#define OFX_UNIT_TESTS_COUNT_ALLOCATIONS
+#include "ofxUnitTests.h"
+
+// Times the core hot paths and saves the results to bin/data/results.json
+// or to the path passed as first argument, so they can be compared between
+// commits. If a second argument is passed, it's loaded as baseline and any
+// benchmark slower than it by more than 10% fails.
+class ofApp: public ofxUnitTestsApp{
+public:
+	ofApp(const std::string & resultsPath, const std::string & baselinePath)
+	:resultsPath(resultsPath)
+	,baselinePath(baselinePath){}
+
+private:
+	std::string resultsPath;
+	std::string baselinePath;
+
+	void run(){
+		if(!baselinePath.empty()){
+			loadBenchmarkBaseline(baselinePath);
+		}
+		setBenchmarkTimeBudget(std::chrono::milliseconds(300));
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofPixels";
+		{
+			ofPixels src, dst;
+			src.allocate(1920, 1080, OF_PIXELS_RGB);
+			for(auto & p: src){
+				p = ofRandom(255);
+			}
+			benchmark("ofPixels::resizeTo 1080p to 720p bilinear", [&]{
+				dst.allocate(1280, 720, OF_PIXELS_RGB);
+				src.resizeTo(dst, OF_INTERPOLATE_BILINEAR);
+			});
+			benchmark("ofPixels::setImageType rgb to grayscale 1080p", [&]{
+				dst = src;
+				dst.setImageType(OF_IMAGE_GRAYSCALE);
+			});
+			benchmark("ofPixels::mirrorTo 1080p", [&]{
+				src.mirrorTo(dst, true, true);
+			});
+			ofPixels rgba = src;
+			rgba.setImageType(OF_IMAGE_COLOR_ALPHA);
+			benchmark("ofPixels::halveTo rgba 1080p", [&]{
+				rgba.halveTo(dst);
+			});
+			ofPixels nv12;
+			src.convertRgbToNv12(nv12);
+			benchmark("ofPixels::convertYuvToRgb nv12 1080p", [&]{
+				nv12.convertYuvToRgb(dst);
+			});
+			ofFloatPixels floats;
+			benchmark("ofPixels to ofFloatPixels 1080p", [&]{
+				floats = src;
+			});
+			benchmark("ofPixels::allocate and clear 4K rgba", [&]{
+				ofPixels frame;
+				frame.allocate(3840, 2160, OF_PIXELS_RGBA);
+				frame.getData()[frame.size() - 1] = 0;
+			});
+			ofPixelsPool pool;
+			benchmark("ofPixels::allocate and clear 4K rgba pooled", [&]{
+				ofPixels frame;
+				frame.allocate(3840, 2160, OF_PIXELS_RGBA, pool);
+				frame.getData()[frame.size() - 1] = 0;
+			});
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofMesh";
+		{
+			auto mesh = ofMesh::icosphere(100, 4);
+			benchmark("ofMesh::smoothNormals icosphere 4 iterations", [&]{
+				mesh.smoothNormals(60);
+			});
+			auto plane = ofMesh::plane(100, 100, 200, 200);
+			benchmark("ofMesh::getSimplifiedIndices plane 200x200 to 10%", [&]{
+				plane.getSimplifiedIndices(plane.getNumIndices() / 3 / 10);
+			});
+			benchmark("ofMesh::optimize plane 200x200", [&]{
+				auto optimized = plane;
+				optimized.optimize();
+			});
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofRandom";
+		{
+			std::vector<float> values(1000000);
+			benchmark("ofRandom 1M", [&]{
+				for(auto & v: values){
+					v = ofRandom(-1, 1);
+				}
+			});
+			benchmark("ofRandomFill 1M", [&]{
+				ofRandomFill(values.data(), values.size(), -1, 1);
+			});
+			benchmark("ofRandomGaussianFill 1M", [&]{
+				ofRandomGaussianFill(values.data(), values.size());
+			});
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofTessellator";
+		{
+			ofPolyline star;
+			for(int i = 0; i < 200; i++){
+				auto radius = i % 2 ? 50.f : 100.f;
+				star.addVertex(glm::vec3(radius * cos(i * TWO_PI / 200), radius * sin(i * TWO_PI / 200), 0));
+			}
+			star.close();
+			ofTessellator tessellator;
+			ofMesh mesh;
+			benchmark("ofTessellator::tessellateToMesh 200 point star", [&]{
+				tessellator.tessellateToMesh(star, OF_POLY_WINDING_ODD, mesh, true);
+			});
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofPolyline";
+		{
+			std::vector<ofPolyline> contours(100);
+			for(auto & contour: contours){
+				for(int i = 0; i < 500; i++){
+					contour.addVertex(glm::vec3(ofRandom(100) + i, ofRandom(100), 0));
+				}
+			}
+			benchmark("ofPolyline::getResampledBySpacing 100 contours", [&]{
+				for(auto & contour: contours){
+					auto resampled = contour.getResampledBySpacing(5);
+				}
+			});
+			std::vector<ofPolyline> resampled;
+			benchmark("ofGetResampledBySpacing 100 contours reused", [&]{
+				ofGetResampledBySpacing(contours, 5.f, resampled);
+			});
+			test_eq(resampled[0].size(), contours[0].getResampledBySpacing(5).size(), "batch resampling matches getResampledBySpacing");
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofEvent";
+		{
+			ofEvent<int> event;
+			std::vector<ofEventListener> listeners;
+			int sum = 0;
+			for(int i = 0; i < 100; i++){
+				listeners.push_back(event.newListener([&sum](int & value){
+					sum += value;
+				}));
+			}
+			int value = 1;
+			benchmark("ofEvent::notify 100 listeners", [&]{
+				event.notify(value);
+			});
+			test_gt(sum, 0, "ofEvent listeners were called");
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofThreadChannel";
+		{
+			const int numMessages = 10000;
+			auto channelThroughput = [&](auto & channel){
+				std::thread producer([&]{
+					for(int i = 0; i < numMessages; i++){
+						while(!channel.send(i)){
+							std::this_thread::yield();
+						}
+					}
+				});
+				int value;
+				for(int i = 0; i < numMessages; i++){
+					channel.receive(value);
+				}
+				producer.join();
+			};
+			benchmark("ofThreadChannel locking 10000 messages", [&]{
+				ofThreadChannel<int> channel;
+				channelThroughput(channel);
+			});
+			benchmark("ofThreadChannel spsc 10000 messages", [&]{
+				ofThreadChannel<int, ofThreadChannelSPSC> channel(1024);
+				channelThroughput(channel);
+			});
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofBuffer";
+		{
+			ofBuffer data;
+			data.allocate(16 * 1024 * 1024);
+			for(auto & c: data){
+				c = ofRandom(255);
+			}
+			ofBufferToFile("benchmark.bin", data, true);
+			benchmark("ofBufferFromFile 16MB", [&]{
+				auto buffer = ofBufferFromFile("benchmark.bin", true);
+			});
+			ofFile::removeFile("benchmark.bin");
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "ofTrueTypeFont";
+		{
+			ofTrueTypeFont font;
+			if(test(font.load(OF_TTF_SANS, 14), "load font")){
+				std::string text = "The quick brown fox jumps over the lazy dog 0123456789";
+				benchmark("ofTrueTypeFont::drawString 53 characters", [&]{
+					font.drawString(text, 10, 20);
+				});
+				glFinish();
+			}
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "renderer";
+		{
+			ofVboMesh mesh = ofMesh::box(10, 10, 10, 1, 1, 1);
+			benchmark("ofVboMesh::draw 1000 draw calls", [&]{
+				for(int i = 0; i < 1000; i++){
+					mesh.draw();
+				}
+				glFinish();
+			});
+			ofStaticBatch batch;
+			ofBoxPrimitive box(10, 10, 10, 1, 1, 1);
+			for(int i = 0; i < 1000; i++){
+				box.setPosition(i % 100 * 20, i / 100 * 20, 0);
+				batch.add(box);
+			}
+			benchmark("ofStaticBatch::build 1000 boxes", [&]{
+				batch.build();
+				glFinish();
+			});
+			benchmark("ofStaticBatch::draw 1000 boxes", [&]{
+				batch.draw();
+				glFinish();
+			});
+			benchmark("ofDrawRectangle 1000 draw calls", [&]{
+				for(int i = 0; i < 1000; i++){
+					ofDrawRectangle(i % 100, i / 100, 10, 10);
+				}
+				glFinish();
+			});
+			ofTexture srcTexture, dstTexture;
+			srcTexture.allocate(1920, 1080, GL_RGBA8);
+			dstTexture.allocate(1920, 1080, GL_RGBA8);
+			benchmark("ofTexture::copyTo 512x512 region", [&]{
+				srcTexture.copyTo(dstTexture, ofRectangle(0, 0, 512, 512), glm::vec2(256, 256));
+				glFinish();
+			});
+			ofPixels region;
+			benchmark("ofTexture::readToPixels 512x512 region", [&]{
+				srcTexture.readToPixels(region, ofRectangle(0, 0, 512, 512));
+			});
+			auto sphere = ofMesh::icosphere(100, 5);
+			ofVbo floats, compact;
+			compact.setFormat(ofVboFormat::compact());
+			benchmark("ofVbo::setMesh icosphere 5 iterations", [&]{
+				floats.setMesh(sphere, GL_STATIC_DRAW);
+				glFinish();
+			});
+			benchmark("ofVbo::setMesh icosphere 5 iterations compact format", [&]{
+				compact.setMesh(sphere, GL_STATIC_DRAW);
+				glFinish();
+			});
+			ofGpuParticles particles;
+			if(ofGpuParticles::isSupported() && test(particles.setup(1000000), "ofGpuParticles setup")){
+				particles.setNoise(100, 0.01, 0.1);
+				benchmark("ofGpuParticles::update 1M particles", [&]{
+					particles.update(1.f / 60.f);
+					glFinish();
+				});
+			}
+		}
+
+		ofJson info;
+		info["renderer"] = ofGetCurrentRenderer()->getType();
+		info["gl_renderer"] = std::string((const char*)glGetString(GL_RENDERER));
+		info["build"] = ofToString(OF_VERSION_MAJOR) + "." + ofToString(OF_VERSION_MINOR) + "." + ofToString(OF_VERSION_PATCH);
+		test(saveBenchmarkResults(resultsPath, info), "results saved to " + resultsPath);
+	}
+};
+
+//========================================================================
+int main(int argc, char ** argv){
+	ofGLFWWindowSettings settings;
+	settings.setGLVersion(3, 2);
+	settings.setSize(1024, 768);
+	settings.visible = false;
+	auto window = ofCreateWindow(settings);
+	// no vsync or frame rate limit, draw calls are timed in setup
+	ofSetVerticalSync(false);
+	auto app = make_shared<ofApp>(argc > 1 ? std::string(argv[1]) : std::string("results.json"),
+	                              argc > 2 ? std::string(argv[2]) : std::string());
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
@@ -177,6 +177,38 @@ class ofApp: public ofxUnitTestsApp{
 
 			});
 		}
+
+		{
+			ofCoreEvents events;
+			events.setCoalesceMotionEvents(true);
+			std::vector<ofMouseEventArgs> moved;
+			std::vector<std::string> order;
+			auto movedListener = events.mouseMoved.newListener([&](ofMouseEventArgs & mouse){
+				moved.push_back(mouse);
+				order.push_back("moved");
+			});
+			auto pressedListener = events.mousePressed.newListener([&](ofMouseEventArgs &){
+				order.push_back("pressed");
+			});
+
+			events.notifyMouseMoved(10, 10);
+			events.notifyMouseMoved(20, 20);
+			events.notifyMouseMoved(30, 30);
+			test_eq(moved.size(), 0u, "Coalesced mouse moves are held until flushed");
+			test_eq(events.getMouseX(), 30, "Coalesced mouse moves update the mouse position");
+
+			events.flushMotionEvents();
+			test_eq(moved.size(), 1u, "Coalesced mouse moves are notified once");
+			test_eq(moved.back().x, 30.f, "Coalesced mouse move has the last position");
+			test_eq(moved.back().history.size(), 3u, "Coalesced mouse move has every position in its history");
+			test_eq(moved.back().history.front().position.x, 10.f, "Coalesced mouse move history is oldest first");
+
+			order.clear();
+			events.notifyMouseMoved(40, 40);
+			events.notifyMousePressed(40, 40, 0);
+			test_eq(order.size(), 2u, "Mouse press flushes the coalesced move");
+			test_eq(order.front(), std::string("moved"), "Coalesced mouse move is notified before the press");
+		}
 	}
 };
 
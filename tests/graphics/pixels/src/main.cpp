@@ -309,6 +309,121 @@ class ofApp: public ofxUnitTestsApp{
                 test_eq((uint64_t)&pixels.getLine(0).getPixel(10)[0], (uint64_t)pixels.getData()+(10*bpp/8),"getLine(0).getPixel(10)[0]==pixels.getData()+(10*bpp/8)");
 			}
 		}
+
+		ofPixels gradient;
+		gradient.allocate(w,h,OF_PIXELS_RGB);
+		for(int y=0;y<h;y++){
+			for(int x=0;x<w;x++){
+				gradient.setColor(x,y,ofColor(x * 255 / (w-1)));
+			}
+		}
+		for(auto method: {OF_INTERPOLATE_BILINEAR, OF_INTERPOLATE_BICUBIC, OF_INTERPOLATE_AREA}){
+			string name = "method " + ofToString(method);
+			ofPixels same;
+			same.allocate(w,h,OF_PIXELS_RGB);
+			test(gradient.resizeTo(same,method),"resizeTo() to same size " + name);
+			test(same.getData()[w*3/2] == gradient.getData()[w*3/2],"resizeTo() to same size keeps pixels " + name);
+
+			ofPixels half;
+			half.allocate(w/2,h/2,OF_PIXELS_RGB);
+			test(gradient.resizeTo(half,method,4),"resizeTo() half size with threads " + name);
+			test(half.getColor(0,0).r < 8 && half.getColor(w/2-1,h/2-1).r > 247,"resizeTo() half size keeps range " + name);
+
+			ofFloatPixels flat;
+			flat.allocate(w,h,OF_PIXELS_GRAY);
+			flat.set(0.5f);
+			test(flat.resize(w*2+1,h/3,method),"resize() float " + name);
+			test(std::abs(flat.getColor(w,h/6).r - 0.5f) < 0.0001f,"resize() float keeps constant color " + name);
+		}
+
+		// the same operations split across the task pool have to give the
+		// same result as running them in one thread
+		ofPixels noise;
+		noise.allocate(w,h,OF_PIXELS_RGBA);
+		for(auto & v: noise){
+			v = ofRandom(255);
+		}
+		auto applyAll = [&](){
+			vector<ofPixels> results(5);
+			noise.mirrorTo(results[0],true,true);
+			noise.rotate90To(results[1],1);
+			noise.rotate90To(results[2],3);
+			results[3] = noise;
+			results[3].swapRgb();
+			results[4] = noise;
+			results[3].blendInto(results[4],0,0);
+			return results;
+		};
+		size_t threshold = ofGetPixelsParallelThreshold();
+		ofSetPixelsParallelThreshold(0);
+		auto single = applyAll();
+		ofSetPixelsParallelThreshold(1);
+		auto parallel = applyAll();
+		ofSetPixelsParallelThreshold(threshold);
+		for(size_t i = 0; i < single.size(); i++){
+			test(std::equal(single[i].begin(),single[i].end(),parallel[i].begin()),"parallel operation " + ofToString(i) + " same as single threaded");
+		}
+		test_eq(single[1].getColor(0,0),noise.getColor(0,h-1),"rotate90To(1) moves bottom left to top left");
+		test_eq(single[2].getColor(0,0),noise.getColor(w-1,0),"rotate90To(3) moves top right to top left");
+
+		// color conversions
+		ofPixels hsb = noise;
+		hsb.convertRgbToHsb();
+		float hue, saturation, brightness;
+		noise.getColor(3,5).getHsb(hue,saturation,brightness);
+		test_eq(int(hsb.getColor(3,5).r),int(ofColor(hue,saturation,brightness).r),"convertRgbToHsb() hue same as ofColor");
+		test_eq(hsb.getColor(3,5).b,noise.getColor(3,5).getBrightness(),"convertRgbToHsb() brightness same as ofColor");
+		hsb.convertHsbToRgb();
+		test_eq(hsb.getColor(3,5),ofColor::fromHsb(hue,saturation,brightness,noise.getColor(3,5).a),"convertHsbToRgb() same as ofColor::setHsb");
+
+		ofPixels premultiplied = noise;
+		premultiplied.premultiplyAlpha();
+		auto original = noise.getColor(7,2);
+		test_eq(int(premultiplied.getColor(7,2).g),int(round(original.g * original.a / 255.f)),"premultiplyAlpha()");
+		test_eq(premultiplied.getColor(7,2).a,original.a,"premultiplyAlpha() keeps alpha");
+
+		// mipmap levels
+		ofPixels halved, expected;
+		test(noise.halveTo(halved),"halveTo()");
+		test_eq(halved.getWidth(),size_t(w/2),"halveTo() halves the width");
+		test_eq(halved.getHeight(),size_t(h/2),"halveTo() halves the height");
+		int average = (noise.getColor(2,4).g + noise.getColor(3,4).g + noise.getColor(2,5).g + noise.getColor(3,5).g + 2) / 4;
+		test_eq(int(halved.getColor(1,2).g),average,"halveTo() averages 2x2 pixels");
+		ofPixels gray = noise;
+		gray.setImageType(OF_IMAGE_GRAYSCALE);
+		gray.halveTo(halved);
+		average = (gray[w*4+2] + gray[w*4+3] + gray[w*5+2] + gray[w*5+3] + 2) / 4;
+		test_eq(int(halved[w/2*2+1]),average,"halveTo() averages 2x2 gray pixels");
+		ofPixels line;
+		line.allocate(5,1,OF_PIXELS_RGBA);
+		line.halveTo(halved);
+		test_eq(halved.getWidth(),size_t(2),"halveTo() rounds the width down");
+		test_eq(halved.getHeight(),size_t(1),"halveTo() keeps at least 1 row");
+
+		ofPixels srgb;
+		srgb.allocate(2,1,OF_PIXELS_RGB);
+		srgb.set(188);
+		srgb.convertSrgbToLinear();
+		test_eq(int(srgb[0]),128,"convertSrgbToLinear()");
+		srgb.convertLinearToSrgb();
+		test_eq(int(srgb[0]),188,"convertLinearToSrgb()");
+
+		ofPixels solid, nv12, rgb;
+		solid.allocate(w,h,OF_PIXELS_RGB);
+		solid.setColor(ofColor(200,100,50));
+		test(solid.convertRgbToNv12(nv12),"convertRgbToNv12()");
+		test(nv12.convertYuvToRgb(rgb),"convertYuvToRgb()");
+		auto roundTrip = rgb.getColor(10,10);
+		test(std::abs(roundTrip.r - 200) < 4 && std::abs(roundTrip.g - 100) < 4 && std::abs(roundTrip.b - 50) < 4,"nv12 round trip");
+
+		ofFloatPixels floats = noise;
+		ofShortPixels shorts = noise;
+		ofPixels fromFloats = floats;
+		ofPixels fromShorts = shorts;
+		test(std::equal(noise.begin(),noise.end(),fromShorts.begin()),"8 to 16 bit round trip");
+		test_eq(int(shorts[13]),noise[13] * 257,"8 to 16 bit scales by 257");
+		test_eq(floats[13],noise[13] / 255.f,"8 bit to float");
+		test(std::abs(int(fromFloats[13]) - int(noise[13])) <= 1,"8 bit to float round trip");
 	}
 };
 
@@ -175,6 +175,23 @@ class ofApp: public ofxUnitTestsApp{
 			test_eq(numLines,lines.size(),"lines iterator correct numLines");
 		}
 
+		{
+			ofLogNotice() << "-------------------";
+			ofLogNotice() << "line ranges iterator";
+			ofBuffer buffer;
+			buffer.set("one\r\n\nthree,3\nfour");
+			std::vector<std::string> lines{"one", "", "three,3", "four"};
+			std::vector<std::string> ranges;
+			for(auto line: buffer.getLineRanges()){
+				ranges.push_back(line.toString());
+			}
+			test(ranges == lines, "line ranges without the line endings");
+			auto it = buffer.getLineRanges().begin();
+			++it;
+			++it;
+			test((*it).data() == buffer.getData() + 6, "line ranges point into the buffer");
+		}
+
 		{
 			ofLogNotice() << "-------------------";
 			ofLogNotice() << "lines reverse iterator";
@@ -70,6 +70,30 @@ class ofApp: public ofxUnitTestsApp{
 		strs.push_back("join");
 		strs.push_back("test");
 		test_eq(ofJoinString(strs,","),"hi,this,is,a,join,test","test #4363");
+
+		std::string line = " x, 12 ,,3.5 ";
+		std::vector<std::string> tokens;
+		for(auto token: ofStringSplitter(line, ",", true, true)){
+			tokens.push_back(token.toString());
+		}
+		test_eq(tokens.size(),3u,"splitter size");
+		test_eq(tokens[0],"x","splitter 0");
+		test_eq(tokens[1],"12","splitter 1");
+		test_eq(tokens[2],"3.5","splitter 2");
+
+		int intValue = 0;
+		test(ofParse(ofStringRange(" -12 "), intValue) && intValue == -12, "parse int");
+		test(!ofParse(ofStringRange("12px"), intValue), "parse int rejects trailing characters");
+		test(!ofParse(ofStringRange("2147483648"), intValue), "parse int rejects overflow");
+		double doubleValue = 0;
+		test(ofParse(ofStringRange("3.5"), doubleValue) && doubleValue == 3.5, "parse double");
+
+		char buffer[16];
+		test_eq(ofToChars(buffer, sizeof(buffer), -1234), 5u, "to chars int length");
+		test_eq(std::string(buffer), "-1234", "to chars int");
+		test_eq(ofToChars(buffer, 4, -1234), 0u, "to chars doesn't fit");
+		ofToChars(buffer, sizeof(buffer), 3.14159, 2);
+		test_eq(std::string(buffer), ofToString(3.14159, 2), "to chars precision");
 	}
 };
 